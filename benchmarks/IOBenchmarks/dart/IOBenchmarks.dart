@@ -0,0 +1,320 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Benchmarks of the native I/O paths behind dart:io: loopback TCP and UDP
+// sockets, files, zlib filters and TLS.
+//
+// Usage: dart IOBenchmarks.dart [--runs=N] [--warmup=N] [--json=FILE]
+//                               [name filter]
+//
+// Every score is the time in microseconds to do a fixed amount of work, so
+// lower is better. Like run_vm_tests, each benchmark prints a
+// "Name(RunTime): median" line, and --json appends a line per benchmark in
+// the format of --benchmark_json, which run_vm_tests --benchmark_baseline
+// can compare against.
+
+import 'dart:async';
+import 'dart:io';
+import 'dart:math';
+import 'dart:typed_data';
+
+const int kTransferBytes = 16 * 1024 * 1024;
+
+String localFile(String path) => Platform.script.resolve(path).toFilePath();
+
+final String certificates = '../../../tests/standalone_2/io/certificates/';
+
+SecurityContext serverContext = SecurityContext()
+  ..useCertificateChain(localFile('${certificates}server_chain.pem'))
+  ..usePrivateKey(localFile('${certificates}server_key.pem'),
+      password: 'dartdart');
+
+SecurityContext clientContext = SecurityContext()
+  ..setTrustedCertificates(localFile('${certificates}trusted_certs.pem'));
+
+typedef Future<void> Work();
+
+class Benchmark {
+  final String name;
+  final Work work;
+
+  Benchmark(this.name, this.work);
+
+  Future<int> measure() async {
+    final watch = Stopwatch()..start();
+    await work();
+    return watch.elapsedMicroseconds;
+  }
+}
+
+Uint8List makeData(int size) {
+  final data = Uint8List(size);
+  final random = Random(42);
+  for (int i = 0; i < size; i++) {
+    // Text-like data that zlib compresses to about a third.
+    data[i] = 97 + random.nextInt(8);
+  }
+  return data;
+}
+
+// Sends kTransferBytes in messages of the given size over each of
+// 'connections' loopback connections split evenly, and waits until the
+// server has received all of them.
+Future<void> tcpTransfer(int messageSize, int connections,
+    {bool secure = false}) async {
+  final message = makeData(messageSize);
+  final perConnection = kTransferBytes ~/ connections;
+  // A SecureServerSocket or a ServerSocket.
+  final dynamic server = secure
+      ? await SecureServerSocket.bind('localhost', 0, serverContext)
+      : await ServerSocket.bind(InternetAddress.loopbackIPv4, 0);
+  int received = 0;
+  final done = Completer<void>();
+  final subscription = (server as Stream<Socket>).listen((socket) {
+    socket.listen((data) {
+      received += data.length;
+      if (received == perConnection * connections) done.complete();
+    }, onDone: () => socket.close());
+  });
+  final clients = <Socket>[];
+  for (int i = 0; i < connections; i++) {
+    clients.add(secure
+        ? await SecureSocket.connect('localhost', server.port,
+            context: clientContext)
+        : await Socket.connect(InternetAddress.loopbackIPv4, server.port));
+  }
+  for (final client in clients) {
+    for (int sent = 0; sent < perConnection; sent += messageSize) {
+      client.add(sent + messageSize <= perConnection
+          ? message
+          : Uint8List.view(message.buffer, 0, perConnection - sent));
+    }
+  }
+  await done.future;
+  for (final client in clients) {
+    await client.close();
+  }
+  await subscription.cancel();
+  await server.close();
+}
+
+// Bounces a small message between a client and an echo server.
+Future<void> tcpLatency() async {
+  const int kRoundTrips = 2000;
+  final server = await ServerSocket.bind(InternetAddress.loopbackIPv4, 0);
+  server.listen((socket) {
+    socket.listen(socket.add, onDone: () => socket.close());
+  });
+  final client =
+      await Socket.connect(InternetAddress.loopbackIPv4, server.port);
+  final message = makeData(64);
+  int received = 0;
+  int roundTrips = 0;
+  final done = Completer<void>();
+  client.listen((data) {
+    received += data.length;
+    if (received < message.length) return;
+    received = 0;
+    if (++roundTrips == kRoundTrips) {
+      done.complete();
+    } else {
+      client.add(message);
+    }
+  });
+  client.add(message);
+  await done.future;
+  await client.close();
+  await server.close();
+}
+
+// Bounces datagrams between two sockets. Lost datagrams are resent.
+Future<void> udpPacketRate() async {
+  const int kRoundTrips = 10000;
+  final echo = await RawDatagramSocket.bind(InternetAddress.loopbackIPv4, 0);
+  final client =
+      await RawDatagramSocket.bind(InternetAddress.loopbackIPv4, 0);
+  echo.listen((event) {
+    if (event != RawSocketEvent.read) return;
+    final datagram = echo.receive();
+    if (datagram != null) {
+      echo.send(datagram.data, datagram.address, datagram.port);
+    }
+  });
+  final message = makeData(512);
+  int roundTrips = 0;
+  final done = Completer<void>();
+  void send() {
+    client.send(message, InternetAddress.loopbackIPv4, echo.port);
+  }
+
+  final resend =
+      Timer.periodic(const Duration(milliseconds: 100), (_) => send());
+  client.listen((event) {
+    if (event != RawSocketEvent.read || client.receive() == null) return;
+    if (++roundTrips == kRoundTrips) {
+      done.complete();
+    } else {
+      send();
+    }
+  });
+  send();
+  await done.future;
+  resend.cancel();
+  echo.close();
+  client.close();
+}
+
+File dataFile;
+
+Future<void> fileSequentialRead() async {
+  const int kChunkSize = 64 * 1024;
+  final file = await dataFile.open();
+  while ((await file.read(kChunkSize)).isNotEmpty) {}
+  await file.close();
+}
+
+Future<void> fileRandomRead() async {
+  const int kReads = 4096;
+  const int kChunkSize = 4096;
+  final random = Random(42);
+  final file = await dataFile.open();
+  for (int i = 0; i < kReads; i++) {
+    await file.setPosition(random.nextInt(kTransferBytes ~/ kChunkSize) *
+        kChunkSize);
+    await file.read(kChunkSize);
+  }
+  await file.close();
+}
+
+Uint8List zlibInput;
+List<int> zlibCompressed;
+
+Future<void> zlibEncode() async {
+  zlib.encode(zlibInput);
+}
+
+Future<void> zlibDecode() async {
+  zlib.decode(zlibCompressed);
+}
+
+Future<void> tlsHandshakes() async {
+  const int kHandshakes = 100;
+  final server = await SecureServerSocket.bind('localhost', 0, serverContext);
+  server.listen((socket) => socket.close());
+  for (int i = 0; i < kHandshakes; i++) {
+    final client = await SecureSocket.connect('localhost', server.port,
+        context: clientContext);
+    await client.close();
+  }
+  await server.close();
+}
+
+List<Benchmark> benchmarks() {
+  final result = <Benchmark>[];
+  for (final size in [64, 4096, 65536]) {
+    result.add(Benchmark('TcpThroughput.$size', () => tcpTransfer(size, 1)));
+  }
+  result.add(Benchmark('TcpLatency', tcpLatency));
+  for (final connections in [1, 16, 256]) {
+    result.add(Benchmark('TcpConnections.$connections',
+        () => tcpTransfer(4096, connections)));
+  }
+  result.add(Benchmark('UdpPacketRate', udpPacketRate));
+  result.add(Benchmark('FileSequentialRead', fileSequentialRead));
+  result.add(Benchmark('FileRandomRead', fileRandomRead));
+  result.add(Benchmark('ZlibEncode', zlibEncode));
+  result.add(Benchmark('ZlibDecode', zlibDecode));
+  result.add(Benchmark('TlsHandshake', tlsHandshakes));
+  result.add(Benchmark(
+      'TlsThroughput', () => tcpTransfer(65536, 1, secure: true)));
+  return result;
+}
+
+class Summary {
+  final int runs;
+  final int min;
+  final int max;
+  final double median;
+  final double stddev;
+
+  Summary._(this.runs, this.min, this.max, this.median, this.stddev);
+
+  factory Summary(List<int> scores) {
+    scores.sort();
+    final runs = scores.length;
+    final median = runs.isOdd
+        ? scores[runs ~/ 2].toDouble()
+        : (scores[runs ~/ 2 - 1] + scores[runs ~/ 2]) / 2;
+    final mean = scores.reduce((a, b) => a + b) / runs;
+    double variance = 0.0;
+    for (final score in scores) {
+      variance += (score - mean) * (score - mean);
+    }
+    final stddev = runs > 1 ? sqrt(variance / (runs - 1)) : 0.0;
+    return Summary._(runs, scores.first, scores.last, median, stddev);
+  }
+
+  // The format written by run_vm_tests --benchmark_json.
+  String toJson(String name) {
+    final match = RegExp(r'on "(\w+)_(\w+)"').firstMatch(Platform.version);
+    final cpu = match != null ? match.group(2) : 'unknown';
+    final version = Platform.version.split(' ').first;
+    return '{"name": "$name", "kind": "RunTime", "runs": $runs, '
+        '"min": $min, "max": $max, "median": ${median.toStringAsFixed(1)}, '
+        '"stddev": ${stddev.toStringAsFixed(2)}, '
+        '"os": "${Platform.operatingSystem}", "cpu": "$cpu", '
+        '"processors": ${Platform.numberOfProcessors}, '
+        '"version": "$version"}';
+  }
+}
+
+int intOption(List<String> args, String name, int defaultValue) {
+  final prefix = '--$name=';
+  for (final arg in args) {
+    if (arg.startsWith(prefix)) return int.parse(arg.substring(prefix.length));
+  }
+  return defaultValue;
+}
+
+main(List<String> args) async {
+  final runs = max(1, intOption(args, 'runs', 1));
+  final warmup = intOption(args, 'warmup', 1);
+  final jsonArg = args.firstWhere((arg) => arg.startsWith('--json='),
+      orElse: () => null);
+  final json = jsonArg != null ? File(jsonArg.substring(7)) : null;
+  final filter = args.firstWhere((arg) => !arg.startsWith('--'),
+      orElse: () => '');
+
+  final temp = await Directory.systemTemp.createTemp('io_benchmarks');
+  dataFile = File('${temp.path}/data');
+  await dataFile.writeAsBytes(makeData(kTransferBytes));
+  zlibInput = makeData(kTransferBytes);
+  zlibCompressed = zlib.encode(zlibInput);
+
+  try {
+    for (final benchmark in benchmarks()) {
+      if (!benchmark.name.contains(filter)) continue;
+      for (int i = 0; i < warmup; i++) {
+        await benchmark.measure();
+      }
+      final scores = <int>[];
+      for (int i = 0; i < runs; i++) {
+        scores.add(await benchmark.measure());
+      }
+      final summary = Summary(scores);
+      print('${benchmark.name}(RunTime): ${summary.median.round()}');
+      if (runs > 1) {
+        print('${benchmark.name}(RunTime) min: ${summary.min}, '
+            'max: ${summary.max}, '
+            'stddev: ${summary.stddev.toStringAsFixed(2)}, runs: $runs');
+      }
+      if (json != null) {
+        json.writeAsStringSync('${summary.toJson(benchmark.name)}\n',
+            mode: FileMode.append);
+      }
+    }
+  } finally {
+    await temp.delete(recursive: true);
+  }
+}
@@ -59,11 +59,17 @@ class BytecodeAssembler {
   bool isUnreachable = false;
   int currentSourcePosition = TreeNode.noOffset;
 
+  // Offset of the last int comparison which can be fused with a subsequent
+  // conditional jump, or -1 if there is no such comparison.
+  int _fusibleComparisonOffset = -1;
+
   BytecodeAssembler();
 
   int get offset => bytecode.length;
 
   void bind(Label label) {
+    // Instructions can't be fused across a jump target.
+    _fusibleComparisonOffset = -1;
     final List<int> jumps = label.bind(offset);
     for (int jumpOffset in jumps) {
       _patchJump(jumpOffset, label.jumpOperand(jumpOffset));
@@ -242,9 +248,30 @@ class BytecodeAssembler {
   void emitSpecializedBytecode(Opcode opcode) {
     assert(BytecodeFormats[opcode].encoding == Encoding.k0);
     emitSourcePosition();
+    if (!isUnreachable && _fusedJumpIfFalse(opcode) != null) {
+      _fusibleComparisonOffset = offset;
+    }
     _emitInstruction0(opcode);
   }
 
+  /// Returns superinstruction which is equivalent to the given int
+  /// comparison followed by JumpIfFalse, or null if there is no such
+  /// superinstruction.
+  static Opcode _fusedJumpIfFalse(Opcode comparison) {
+    switch (comparison) {
+      case Opcode.kCompareIntGt:
+        return Opcode.kJumpIfNotIntGt;
+      case Opcode.kCompareIntLt:
+        return Opcode.kJumpIfNotIntLt;
+      case Opcode.kCompareIntGe:
+        return Opcode.kJumpIfNotIntGe;
+      case Opcode.kCompareIntLe:
+        return Opcode.kJumpIfNotIntLe;
+      default:
+        return null;
+    }
+  }
+
   void _emitJumpInstruction(Opcode opcode, Label label) {
     assert(isJump(opcode));
     if (isUnreachable) {
@@ -308,6 +335,16 @@ class BytecodeAssembler {
   }
 
   void emitJumpIfFalse(Label label) {
+    // Replace int comparison immediately followed by JumpIfFalse with
+    // a superinstruction. Comparison is the last emitted instruction
+    // if it occupies the last byte of bytecode. Source position of the
+    // comparison (if any) is already recorded at the same offset.
+    if (!isUnreachable && (_fusibleComparisonOffset == offset - 1)) {
+      final Opcode comparison = Opcode.values[bytecode.removeLast()];
+      _fusibleComparisonOffset = -1;
+      _emitJumpInstruction(_fusedJumpIfFalse(comparison), label);
+      return;
+    }
     _emitJumpInstruction(Opcode.kJumpIfFalse, label);
   }
 
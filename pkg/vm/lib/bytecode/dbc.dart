@@ -10,7 +10,7 @@ library vm.bytecode.dbc;
 /// Before bumping current bytecode version format, make sure that
 /// all users have switched to a VM which is able to consume new
 /// version of bytecode.
-const int currentBytecodeFormatVersion = 11;
+const int currentBytecodeFormatVersion = 12;
 
 enum Opcode {
   kUnusedOpcode000,
@@ -89,14 +89,17 @@ enum Opcode {
   kUnusedOpcode073,
   kUnusedOpcode074,
   kUnusedOpcode075,
-  kUnusedOpcode076,
-  kUnusedOpcode077,
-  kUnusedOpcode078,
-  kUnusedOpcode079,
-  kUnusedOpcode080,
-  kUnusedOpcode081,
-  kUnusedOpcode082,
-  kUnusedOpcode083,
+
+  // Superinstructions since bytecode format v12:
+  kJumpIfNotIntGt,
+  kJumpIfNotIntGt_Wide,
+  kJumpIfNotIntLt,
+  kJumpIfNotIntLt_Wide,
+  kJumpIfNotIntGe,
+  kJumpIfNotIntGe_Wide,
+  kJumpIfNotIntLe,
+  kJumpIfNotIntLe_Wide,
+
   kUnusedOpcode084,
 
   // Bytecode instructions since bytecode format v7:
@@ -522,6 +525,14 @@ const Map<Opcode, Format> BytecodeFormats = const {
       Encoding.k0, const [Operand.none, Operand.none, Operand.none]),
   Opcode.kCompareDoubleLe: const Format(
       Encoding.k0, const [Operand.none, Operand.none, Operand.none]),
+  Opcode.kJumpIfNotIntGt: const Format(
+      Encoding.kT, const [Operand.tgt, Operand.none, Operand.none]),
+  Opcode.kJumpIfNotIntLt: const Format(
+      Encoding.kT, const [Operand.tgt, Operand.none, Operand.none]),
+  Opcode.kJumpIfNotIntGe: const Format(
+      Encoding.kT, const [Operand.tgt, Operand.none, Operand.none]),
+  Opcode.kJumpIfNotIntLe: const Format(
+      Encoding.kT, const [Operand.tgt, Operand.none, Operand.none]),
 };
 
 // Should match constant in runtime/vm/stack_frame_dbc.h.
@@ -90,6 +90,7 @@ class FfiTransformer extends Transformer {
   final Class nativeFunctionClass;
   final Class pointerClass;
   final Class structClass;
+  final Class byValueClass;
   final Procedure castMethod;
   final Procedure loadMethod;
   final Procedure storeMethod;
@@ -112,6 +113,7 @@ class FfiTransformer extends Transformer {
         nativeFunctionClass = index.getClass('dart:ffi', 'NativeFunction'),
         pointerClass = index.getClass('dart:ffi', 'Pointer'),
         structClass = index.getClass('dart:ffi', 'Struct'),
+        byValueClass = index.getClass('dart:ffi', 'ByValue'),
         castMethod = index.getMember('dart:ffi', 'Pointer', 'cast'),
         loadMethod = index.getMember('dart:ffi', 'Pointer', 'load'),
         storeMethod = index.getMember('dart:ffi', 'Pointer', 'store'),
@@ -143,6 +145,7 @@ class FfiTransformer extends Transformer {
   /// [Void]                               -> [void]
   /// [Pointer]<T>                         -> [Pointer]<T>
   /// T extends [Pointer]                  -> T
+  /// [ByValue]<T>                         -> T
   /// [NativeFunction]<T1 Function(T2, T3) -> S1 Function(S2, S3)
   ///    where DartRepresentationOf(Tn) -> Sn
   DartType convertNativeTypeToDartType(DartType nativeType) {
@@ -154,6 +157,14 @@ class FfiTransformer extends Transformer {
         InterfaceType(nativeClass), InterfaceType(pointerClass))) {
       return nativeType;
     }
+    if (nativeClass == byValueClass) {
+      DartType struct = (nativeType as InterfaceType).typeArguments[0];
+      if (struct is! InterfaceType ||
+          !env.isSubtypeOf(struct, InterfaceType(pointerClass))) {
+        return null;
+      }
+      return struct;
+    }
     NativeType nativeType_ = getType(nativeClass);
     if (nativeType_ == null) {
       return null;
@@ -86,6 +86,7 @@ class _FfiDefinitionTransformer extends FfiTransformer {
   final LibraryIndex index;
   final Field _internalIs64Bit;
   final Constructor _unimplementedErrorCtor;
+  final Class _typeClass;
   static const String _errorOn32BitMessage =
       "Code-gen for FFI structs is not supported on 32-bit platforms.";
 
@@ -97,6 +98,7 @@ class _FfiDefinitionTransformer extends FfiTransformer {
       : _internalIs64Bit = index.getTopLevelMember('dart:_internal', 'is64Bit'),
         _unimplementedErrorCtor =
             index.getMember('dart:core', 'UnimplementedError', ''),
+        _typeClass = coreTypes.typeClass,
         super(index, coreTypes, hierarchy, diagnosticReporter) {}
 
   Statement guardOn32Bit(Statement body) {
@@ -214,6 +216,8 @@ class _FfiDefinitionTransformer extends FfiTransformer {
     List<int> offsets = _calculateOffsets(types);
     int size = _calculateSize(offsets, types);
 
+    _recordFieldTypes(node, types);
+
     for (int i = 0; i < fields.length; i++) {
       List<Procedure> methods =
           _generateMethodsForField(fields[i], types[i], offsets[i]);
@@ -229,6 +233,27 @@ class _FfiDefinitionTransformer extends FfiTransformer {
     return size;
   }
 
+  /// Records the native types of the fields for the VM, which needs the layout
+  /// of structs which are passed by value (see `ffi.ByValue`).
+  ///
+  /// Sample output:
+  /// @pragma('vm:ffi:struct-fields', [ffi.Double, ffi.Double, ffi.Pointer])
+  void _recordFieldTypes(Class node, List<NativeType> types) {
+    DartType typeType = InterfaceType(_typeClass);
+    node.addAnnotation(ConstructorInvocation(
+        pragmaConstructor,
+        Arguments([
+          StringLiteral("vm:ffi:struct-fields"),
+          ListLiteral(
+              types
+                  .map((t) =>
+                      TypeLiteral(InterfaceType(nativeTypesClasses[t.index])))
+                  .toList(),
+              typeArgument: typeType,
+              isConst: true)
+        ])));
+  }
+
   /// Sample output:
   /// ffi.Pointer<ffi.Double> get _xPtr => cast();
   /// double get x => _xPtr.load();
@@ -17,6 +17,7 @@
 #include "bin/file.h"
 #include "bin/io_natives.h"
 #include "bin/platform.h"
+#include "bin/stdio.h"
 
 namespace dart {
 namespace bin {
@@ -91,11 +92,17 @@ void FUNCTION_NAME(Builtin_PrintString)(Dart_NativeArguments args) {
     Dart_PropagateError(result);
   }
 
-  // Uses fwrite to support printing NUL bytes.
-  intptr_t res = fwrite(chars, 1, length, stdout);
-  ASSERT(res == length);
-  fputs("\n", stdout);
-  fflush(stdout);
+  StdioWriter* writer = StdioWriter::ForFd(1);
+  if (writer != NULL) {
+    writer->Write(chars, length);
+    writer->Write("\n", 1);
+  } else {
+    // Uses fwrite to support printing NUL bytes.
+    intptr_t res = fwrite(chars, 1, length, stdout);
+    ASSERT(res == length);
+    fputs("\n", stdout);
+    fflush(stdout);
+  }
   if (ShouldCaptureStdout()) {
     // For now we report print output on the Stdout stream.
     uint8_t newline[] = {'\n'};
@@ -4,17 +4,23 @@
 
 #include "bin/dfe.h"
 
+#include <inttypes.h>
+#include <time.h>
+
 #include <memory>
 
 #include "bin/abi_version.h"
+#include "bin/crypto.h"
 #include "bin/dartutils.h"
 #include "bin/directory.h"
 #include "bin/error_exit.h"
 #include "bin/file.h"
+#include "bin/lockers.h"
 #include "bin/main_options.h"
 #include "bin/platform.h"
 #include "bin/utils.h"
 #include "include/dart_tools_api.h"
+#include "platform/growable_array.h"
 #include "platform/utils.h"
 
 extern "C" {
@@ -38,6 +44,8 @@ namespace bin {
 DFE dfe;
 #endif
 
+bool DFE::map_kernel_files_ = false;
+
 const char kKernelServiceSnapshot[] = "kernel-service.dart.snapshot";
 const char kSnapshotsDirectory[] = "snapshots";
 
@@ -66,6 +74,8 @@ DFE::DFE()
     : use_dfe_(false),
       use_incremental_compiler_(false),
       frontend_filename_(NULL),
+      kernel_cache_dir_(NULL),
+      kernel_cache_key_hash_(0),
       application_kernel_buffer_(NULL),
       application_kernel_buffer_size_(0) {
   // The run_vm_tests binary has the DART_PRECOMPILER set in order to allow unit
@@ -93,7 +103,10 @@ DFE::~DFE() {
   }
   frontend_filename_ = NULL;
 
-  free(application_kernel_buffer_);
+  free(kernel_cache_dir_);
+  kernel_cache_dir_ = NULL;
+
+  FreeKernelBuffer(application_kernel_buffer_);
   application_kernel_buffer_ = NULL;
   application_kernel_buffer_size_ = 0;
 }
@@ -256,12 +269,314 @@ Dart_KernelCompilationResult DFE::CompileScript(const char* script_uri,
                               package_config);
 }
 
+// 64-bit FNV-1a. Kernel cache entries are named and validated with it; it
+// only needs to tell changed sources apart, not resist tampering.
+static const uint64_t kHashSeed = 14695981039346656037ULL;
+
+static uint64_t HashBytes(uint64_t hash, const void* data, intptr_t length) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  for (intptr_t i = 0; i < length; i++) {
+    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+static uint64_t HashString(uint64_t hash, const char* string) {
+  if (string == NULL) {
+    string = "";
+  }
+  // Include the terminator so that consecutive strings cannot run together.
+  return HashBytes(hash, string, strlen(string) + 1);
+}
+
+static bool ReadWholeFile(const char* path, uint8_t** buffer, intptr_t* size) {
+  void* file = DartUtils::OpenFile(path, false);
+  if (file == NULL) {
+    return false;
+  }
+  DartUtils::ReadFile(buffer, size, file);
+  DartUtils::CloseFile(file);
+  return *buffer != NULL;
+}
+
+static bool HashFileContents(const char* path, uint64_t* hash) {
+  uint8_t* contents = NULL;
+  intptr_t size = 0;
+  if (!ReadWholeFile(path, &contents, &size)) {
+    return false;
+  }
+  *hash = HashBytes(kHashSeed, contents, size);
+  free(contents);
+  return true;
+}
+
+// Writes a cache file under a unique temporary name and renames it into
+// place, so that concurrent runs never read a partially written file.
+class CacheFileWriter {
+ public:
+  explicit CacheFileWriter(const char* path)
+      : path_(path), temp_path_(NULL), file_(NULL) {
+    uint64_t suffix = 0;
+    if (!Crypto::GetRandomBytes(sizeof(suffix),
+                                reinterpret_cast<uint8_t*>(&suffix))) {
+      suffix = static_cast<uint64_t>(Dart_TimelineGetMicros());
+    }
+    temp_path_ = Utils::SCreate("%s.%016" Px64 ".tmp", path, suffix);
+    file_ = File::Open(NULL, temp_path_, File::kWriteTruncate);
+  }
+
+  ~CacheFileWriter() {
+    if (file_ != NULL) {
+      file_->Release();
+      File::Delete(NULL, temp_path_);
+    }
+    free(temp_path_);
+  }
+
+  File* file() const { return file_; }
+
+  bool Commit() {
+    if (file_ == NULL) {
+      return false;
+    }
+    file_->Release();
+    file_ = NULL;
+    if (!File::Rename(NULL, temp_path_, path_)) {
+      File::Delete(NULL, temp_path_);
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  const char* path_;
+  char* temp_path_;
+  File* file_;
+
+  DISALLOW_COPY_AND_ASSIGN(CacheFileWriter);
+};
+
+static const char kKernelCacheHeader[] = "dart-kernel-cache 1";
+
+// Sources modified this recently might change again within the resolution
+// of their modification time, so their entries always compare contents.
+static const int64_t kRecentlyModifiedMillis = 2000;
+
+void DFE::SetKernelCacheKey(int target_abi_version,
+                            int flag_count,
+                            const char** flags) {
+  uint64_t hash =
+      HashBytes(kHashSeed, &target_abi_version, sizeof(target_abi_version));
+  for (int i = 0; i < flag_count; i++) {
+    hash = HashString(hash, flags[i]);
+  }
+  kernel_cache_key_hash_ = hash;
+}
+
+char* DFE::KernelCacheManifestPath(const char* script_uri,
+                                   const char* package_config) const {
+  uint64_t hash = kHashSeed;
+  hash = HashString(hash, Dart_VersionString());
+  hash = HashBytes(hash, &kernel_cache_key_hash_,
+                   sizeof(kernel_cache_key_hash_));
+  char* current_directory = Directory::CurrentNoScope();
+  hash = HashString(hash, current_directory);
+  free(current_directory);
+  hash = HashString(hash, script_uri);
+  hash = HashString(hash, package_config);
+  return Utils::SCreate("%s%s%016" Px64 ".manifest", kernel_cache_dir_,
+                        File::PathSeparator(), hash);
+}
+
+bool DFE::ReadCachedKernel(const char* script_uri,
+                           const char* package_config,
+                           uint8_t** kernel_buffer,
+                           intptr_t* kernel_buffer_size) const {
+  char* manifest_path = KernelCacheManifestPath(script_uri, package_config);
+  uint8_t* manifest = NULL;
+  intptr_t manifest_size = 0;
+  const bool found = ReadWholeFile(manifest_path, &manifest, &manifest_size);
+  free(manifest_path);
+  if (!found) {
+    return false;
+  }
+  char* text = Utils::StrNDup(reinterpret_cast<char*>(manifest), manifest_size);
+  free(manifest);
+
+  bool valid = true;
+  char* kernel_name = NULL;
+  intptr_t line_number = 0;
+  for (char* line = text; valid && (*line != '\0'); line_number++) {
+    char* end = strchr(line, '\n');
+    if (end == NULL) {
+      valid = false;
+      break;
+    }
+    *end = '\0';
+    if (line_number == 0) {
+      valid = strcmp(line, kKernelCacheHeader) == 0;
+    } else if (line_number == 1) {
+      valid = strncmp(line, "kernel ", 7) == 0;
+      kernel_name = line + 7;
+    } else {
+      int64_t mtime = 0;
+      int64_t size = 0;
+      uint64_t hash = 0;
+      int path_offset = 0;
+      if (sscanf(line, "%" SCNd64 " %" SCNd64 " %" SCNx64 " %n", &mtime,
+                 &size, &hash, &path_offset) != 3) {
+        valid = false;
+        break;
+      }
+      const char* path = line + path_offset;
+      int64_t stat[File::kStatSize];
+      File::Stat(NULL, path, stat);
+      if ((stat[File::kType] == File::kDoesNotExist) ||
+          (stat[File::kSize] != size)) {
+        valid = false;
+      } else if (stat[File::kModifiedTime] != mtime) {
+        uint64_t current_hash = 0;
+        valid = HashFileContents(path, &current_hash) && (current_hash == hash);
+      }
+    }
+    line = end + 1;
+  }
+  valid = valid && (kernel_name != NULL);
+
+  if (valid) {
+    char* kernel_path = Utils::SCreate("%s%s%s", kernel_cache_dir_,
+                                       File::PathSeparator(), kernel_name);
+    valid = ReadWholeFile(kernel_path, kernel_buffer, kernel_buffer_size);
+    free(kernel_path);
+    if (valid && !Dart_IsKernel(*kernel_buffer, *kernel_buffer_size)) {
+      free(*kernel_buffer);
+      valid = false;
+    }
+    if (!valid) {
+      *kernel_buffer = NULL;
+      *kernel_buffer_size = 0;
+    }
+  }
+  free(text);
+  return valid;
+}
+
+// Splits the space separated, backslash escaped list of paths returned by
+// Dart_KernelListDependencies.
+static void ParseDependencies(const uint8_t* buffer,
+                              intptr_t size,
+                              MallocGrowableArray<char*>* paths) {
+  char* path = reinterpret_cast<char*>(malloc(size + 1));
+  intptr_t length = 0;
+  for (intptr_t i = 0; i <= size; i++) {
+    if ((i == size) || (buffer[i] == ' ')) {
+      if (length > 0) {
+        paths->Add(Utils::StrNDup(path, length));
+      }
+      length = 0;
+      continue;
+    }
+    if ((buffer[i] == '\\') && (i + 1 < size)) {
+      i++;
+    }
+    path[length++] = buffer[i];
+  }
+  free(path);
+}
+
+void DFE::WriteCachedKernel(const char* script_uri,
+                            const char* package_config,
+                            const uint8_t* kernel_buffer,
+                            intptr_t kernel_buffer_size) const {
+  Dart_KernelCompilationResult result = Dart_KernelListDependencies();
+  if (result.status != Dart_KernelCompilationStatus_Ok) {
+    free(result.error);
+    free(result.kernel);
+    return;
+  }
+  MallocGrowableArray<char*> paths;
+  ParseDependencies(result.kernel, result.kernel_size, &paths);
+  free(result.kernel);
+
+  struct Source {
+    int64_t mtime;
+    int64_t size;
+    uint64_t hash;
+  };
+  MallocGrowableArray<Source> sources(paths.length());
+  const int64_t now_millis = static_cast<int64_t>(time(NULL)) * 1000;
+  uint64_t closure_hash = HashString(kHashSeed, Dart_VersionString());
+  bool valid = paths.length() > 0;
+  for (intptr_t i = 0; valid && (i < paths.length()); i++) {
+    int64_t stat[File::kStatSize];
+    File::Stat(NULL, paths[i], stat);
+    Source source;
+    if ((stat[File::kType] == File::kDoesNotExist) ||
+        !HashFileContents(paths[i], &source.hash)) {
+      valid = false;
+      break;
+    }
+    source.mtime = stat[File::kModifiedTime];
+    if (now_millis - source.mtime < kRecentlyModifiedMillis) {
+      source.mtime = -1;
+    }
+    source.size = stat[File::kSize];
+    sources.Add(source);
+    closure_hash = HashString(closure_hash, paths[i]);
+    closure_hash = HashBytes(closure_hash, &source.hash, sizeof(source.hash));
+  }
+
+  if (valid) {
+    Directory::Create(NULL, kernel_cache_dir_);
+    char* kernel_name = Utils::SCreate("%016" Px64 ".dill", closure_hash);
+    char* kernel_path = Utils::SCreate("%s%s%s", kernel_cache_dir_,
+                                       File::PathSeparator(), kernel_name);
+    if (!File::Exists(NULL, kernel_path)) {
+      CacheFileWriter writer(kernel_path);
+      valid = (writer.file() != NULL) &&
+              writer.file()->WriteFully(kernel_buffer, kernel_buffer_size) &&
+              writer.Commit();
+    }
+    if (valid) {
+      char* manifest_path = KernelCacheManifestPath(script_uri, package_config);
+      CacheFileWriter writer(manifest_path);
+      File* file = writer.file();
+      valid = (file != NULL) &&
+              file->Print("%s\nkernel %s\n", kKernelCacheHeader, kernel_name);
+      for (intptr_t i = 0; valid && (i < paths.length()); i++) {
+        valid = file->Print("%" Pd64 " %" Pd64 " %016" Px64 " %s\n",
+                            sources[i].mtime, sources[i].size, sources[i].hash,
+                            paths[i]);
+      }
+      if (valid) {
+        writer.Commit();
+      }
+      free(manifest_path);
+    }
+    free(kernel_path);
+    free(kernel_name);
+  }
+  for (intptr_t i = 0; i < paths.length(); i++) {
+    free(paths[i]);
+  }
+}
+
 void DFE::CompileAndReadScript(const char* script_uri,
                                uint8_t** kernel_buffer,
                                intptr_t* kernel_buffer_size,
                                char** error,
                                int* exit_code,
                                const char* package_config) {
+  // Incremental recompilation relies on the kernel service having compiled
+  // the script, so the cache is not used with the incremental compiler.
+  const bool use_cache =
+      (kernel_cache_dir_ != NULL) && !use_incremental_compiler();
+  if (use_cache && ReadCachedKernel(script_uri, package_config, kernel_buffer,
+                                    kernel_buffer_size)) {
+    *error = NULL;
+    *exit_code = 0;
+    return;
+  }
   Dart_KernelCompilationResult result =
       CompileScript(script_uri, use_incremental_compiler(), package_config);
   switch (result.status) {
@@ -270,6 +585,10 @@ void DFE::CompileAndReadScript(const char* script_uri,
       *kernel_buffer_size = result.kernel_size;
       *error = NULL;
       *exit_code = 0;
+      if (use_cache) {
+        WriteCachedKernel(script_uri, package_config, result.kernel,
+                          result.kernel_size);
+      }
       break;
     case Dart_KernelCompilationStatus_Error:
       free(result.kernel);
@@ -297,7 +616,7 @@ void DFE::ReadScript(const char* script_uri,
     return;
   }
   if (!Dart_IsKernel(*kernel_buffer, *kernel_buffer_size)) {
-    free(*kernel_buffer);
+    FreeKernelBuffer(*kernel_buffer);
     *kernel_buffer = NULL;
     *kernel_buffer_size = -1;
   }
@@ -478,12 +797,115 @@ static bool TryReadKernelListBuffer(const char* script_uri,
   return true;
 }
 
+// The kernel files mapped by TryMapKernelFile, so that FreeKernelBuffer can
+// tell them from malloc()ed buffers.
+class MappedKernelNode {
+ public:
+  static void Add(MappedMemory* mapping) {
+    MutexLocker ml(mutex_);
+    head_ = new MappedKernelNode(mapping, head_);
+  }
+
+  // Unmaps [buffer] and returns true if it is a mapped kernel file.
+  static bool Remove(const uint8_t* buffer) {
+    MutexLocker ml(mutex_);
+    for (MappedKernelNode** p = &head_; *p != NULL; p = &(*p)->next_) {
+      MappedKernelNode* node = *p;
+      if (node->mapping_->address() == buffer) {
+        *p = node->next_;
+        delete node;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static void Advise(const uint8_t* buffer, MappedMemory::Advice advice) {
+    MutexLocker ml(mutex_);
+    for (MappedKernelNode* node = head_; node != NULL; node = node->next_) {
+      if (node->mapping_->address() == buffer) {
+        node->mapping_->Advise(advice);
+        return;
+      }
+    }
+  }
+
+ private:
+  MappedKernelNode(MappedMemory* mapping, MappedKernelNode* next)
+      : mapping_(mapping), next_(next) {}
+
+  ~MappedKernelNode() { delete mapping_; }
+
+  static Mutex* mutex_;
+  static MappedKernelNode* head_;
+
+  MappedMemory* mapping_;
+  MappedKernelNode* next_;
+
+  DISALLOW_COPY_AND_ASSIGN(MappedKernelNode);
+};
+
+Mutex* MappedKernelNode::mutex_ = new Mutex();
+MappedKernelNode* MappedKernelNode::head_ = NULL;
+
+/// Maps [script_uri] read-only if it is a kernel file, returns [true] if
+/// successful, [false] otherwise, e.g. for a kernel list file.
+static bool TryMapKernelFile(const char* script_uri,
+                             uint8_t** kernel_ir,
+                             intptr_t* kernel_ir_size) {
+  File* file = File::OpenUri(NULL, script_uri, File::kRead);
+  if (file == NULL) {
+    return false;
+  }
+  RefCntReleaseScope<File> rs(file);
+  int64_t length = file->Length();
+  if ((length <= 0) || (length > kIntptrMax)) {
+    return false;
+  }
+  MappedMemory* mapping = file->Map(File::kReadOnly, 0, length);
+  if (mapping == NULL) {
+    return false;
+  }
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(mapping->address());
+  if (DartUtils::SniffForMagicNumber(buffer, length) !=
+      DartUtils::kKernelMagicNumber) {
+    delete mapping;
+    return false;
+  }
+  // Loading reads the component from start to end; read ahead aggressively
+  // until DFE::KernelBufferLoaded.
+  mapping->Advise(MappedMemory::kSequential);
+  MappedKernelNode::Add(mapping);
+  *kernel_ir = buffer;
+  *kernel_ir_size = static_cast<intptr_t>(length);
+  return true;
+}
+
+void DFE::FreeKernelBuffer(uint8_t* kernel_buffer) {
+  if ((kernel_buffer != NULL) && !MappedKernelNode::Remove(kernel_buffer)) {
+    free(kernel_buffer);
+  }
+}
+
+void DFE::KernelBufferLoaded(const uint8_t* kernel_buffer) {
+  if (map_kernel_files_ && (kernel_buffer != NULL)) {
+    MappedKernelNode::Advise(kernel_buffer, MappedMemory::kNormal);
+  }
+}
+
 bool DFE::TryReadKernelFile(const char* script_uri,
                             uint8_t** kernel_ir,
                             intptr_t* kernel_ir_size) {
   *kernel_ir = NULL;
   *kernel_ir_size = -1;
 
+  // Kernel list files are still read, since their kernels are concatenated
+  // into one buffer.
+  if (map_kernel_files_ &&
+      TryMapKernelFile(script_uri, kernel_ir, kernel_ir_size)) {
+    return true;
+  }
+
   uint8_t* buffer;
   if (!TryReadFile(script_uri, &buffer, kernel_ir_size)) {
     return false;
@@ -40,6 +40,20 @@ class DFE {
   }
   bool use_incremental_compiler() const { return use_incremental_compiler_; }
 
+  // Directory in which CompileAndReadScript caches compiled kernel, or NULL.
+  void set_kernel_cache_dir(const char* dir) {
+    free(kernel_cache_dir_);
+    kernel_cache_dir_ = (dir != NULL) ? strdup(dir) : NULL;
+  }
+  const char* kernel_cache_dir() const { return kernel_cache_dir_; }
+
+  // Makes the target ABI version and the VM flags part of the kernel cache
+  // key, since they (e.g. --enable-experiment) change the kernel the front
+  // end produces.
+  void SetKernelCacheKey(int target_abi_version,
+                         int flag_count,
+                         const char** flags);
+
   // Returns the platform binary file name if the path to
   // kernel binaries was set using SetKernelBinaries.
   const char* GetPlatformBinaryFilename();
@@ -65,6 +79,8 @@ class DFE {
   // If the compilation is successful, returns a valid in memory kernel
   // representation of the script, NULL otherwise
   // 'error' and 'exit_code' have the error values in case of errors.
+  // With a kernel cache directory, kernel compiled earlier for the same
+  // script is reused as long as none of its sources have changed.
   void CompileAndReadScript(const char* script_uri,
                             uint8_t** kernel_buffer,
                             intptr_t* kernel_buffer_size,
@@ -90,6 +106,21 @@ class DFE {
                                 uint8_t** kernel_buffer,
                                 intptr_t* kernel_buffer_size);
 
+  // Whether TryReadKernelFile maps kernel files read-only instead of reading
+  // them into malloc()ed buffers. The clean pages of a mapped file are shared
+  // by the isolate groups and processes that load it, but the file must not
+  // be truncated or rewritten in place while it is mapped.
+  static bool map_kernel_files() { return map_kernel_files_; }
+  static void set_map_kernel_files(bool value) { map_kernel_files_ = value; }
+
+  // Releases a buffer returned by ReadScript or TryReadKernelFile, which may
+  // be a mapped file rather than a malloc()ed buffer.
+  static void FreeKernelBuffer(uint8_t* kernel_buffer);
+
+  // Tells that the kernel in [kernel_buffer] has been loaded. A mapped file
+  // is read sequentially until then, and lazily in no particular order after.
+  static void KernelBufferLoaded(const uint8_t* kernel_buffer);
+
   // We distinguish between "intent to use Dart frontend" vs "can actually
   // use Dart frontend". The method UseDartFrontend tells us about the
   // intent to use DFE. This method tells us if Dart frontend can actually
@@ -105,6 +136,8 @@ class DFE {
   bool use_dfe_;
   bool use_incremental_compiler_;
   char* frontend_filename_;
+  char* kernel_cache_dir_;
+  uint64_t kernel_cache_key_hash_;
   const uint8_t* kernel_service_dill_;
   intptr_t kernel_service_dill_size_;
   const uint8_t* platform_strong_dill_;
@@ -114,8 +147,27 @@ class DFE {
   uint8_t* application_kernel_buffer_;
   intptr_t application_kernel_buffer_size_;
 
+  static bool map_kernel_files_;
+
   bool InitKernelServiceAndPlatformDills(int target_abi_version);
 
+  // Kernel cache entries are found through a manifest named after a hash of
+  // the script, package config, working directory, SDK version, target ABI
+  // version and VM flags. The manifest lists the sources the kernel was
+  // compiled from with their modification time, size and content hash, and
+  // names the kernel file, which is itself named after the hash of those
+  // sources.
+  char* KernelCacheManifestPath(const char* script_uri,
+                                const char* package_config) const;
+  bool ReadCachedKernel(const char* script_uri,
+                        const char* package_config,
+                        uint8_t** kernel_buffer,
+                        intptr_t* kernel_buffer_size) const;
+  void WriteCachedKernel(const char* script_uri,
+                         const char* package_config,
+                         const uint8_t* kernel_buffer,
+                         intptr_t kernel_buffer_size) const;
+
   DISALLOW_COPY_AND_ASSIGN(DFE);
 };
 
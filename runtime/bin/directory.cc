@@ -15,6 +15,7 @@
 #include "include/dart_api.h"
 #include "platform/assert.h"
 #include "platform/syslog.h"
+#include "platform/utils.h"
 
 namespace dart {
 namespace bin {
@@ -398,10 +399,13 @@ CObject* Directory::ListNextRequest(const CObjectArray& request) {
   if (dir_listing->IsEmpty()) {
     return new CObjectArray(CObject::NewArray(0));
   }
+  // Files, directories and links are packed into few Uint8Lists, so the
+  // array mostly holds errors.
   const int kArraySize = 128;
   CObjectArray* response = new CObjectArray(CObject::NewArray(kArraySize));
   dir_listing->SetArray(response, kArraySize);
   Directory::List(dir_listing);
+  dir_listing->FlushPacked();
   // In case the listing ended before it hit the buffer length, we need to
   // override the array length.
   response->AsApiCObject()->value.as_array.length = dir_listing->index();
@@ -464,24 +468,65 @@ bool AsyncDirectoryListing::AddFileSystemEntityToResponse(Response type,
   return index_ < length_;
 }
 
+bool AsyncDirectoryListing::HasRoom() const {
+  // Leave room for flushing the packed entries, followed by an error or done
+  // response.
+  return (index_ + 4 <= length_) && (packed_length_ < kPackedBatchSize);
+}
+
+bool AsyncDirectoryListing::AddPackedEntry(Response type, const char* path) {
+  intptr_t path_length = strlen(path) + 1;
+  intptr_t needed = packed_length_ + 1 + path_length;
+  if (needed > packed_capacity_) {
+    intptr_t capacity = Utils::Maximum(needed, 2 * kPackedBatchSize);
+    packed_ = reinterpret_cast<uint8_t*>(realloc(packed_, capacity));
+    if (packed_ == NULL) {
+      OUT_OF_MEMORY();
+    }
+    packed_capacity_ = capacity;
+  }
+  packed_[packed_length_] = static_cast<uint8_t>(type);
+  memmove(packed_ + packed_length_ + 1, path, path_length);
+  packed_length_ = needed;
+  return HasRoom();
+}
+
+void AsyncDirectoryListing::FlushPacked() {
+  if (packed_length_ == 0) {
+    return;
+  }
+  Dart_CObject* io_buffer = CObject::NewIOBuffer(packed_length_);
+  if (io_buffer == NULL) {
+    OUT_OF_MEMORY();
+  }
+  memmove(io_buffer->value.as_external_typed_data.data, packed_,
+          packed_length_);
+  packed_length_ = 0;
+  array_->SetAt(index_++, new CObjectInt32(CObject::NewInt32(kListPacked)));
+  array_->SetAt(index_++, new CObjectExternalUint8Array(io_buffer));
+}
+
 bool AsyncDirectoryListing::HandleDirectory(const char* dir_name) {
-  return AddFileSystemEntityToResponse(kListDirectory, dir_name);
+  return AddPackedEntry(kListDirectory, dir_name);
 }
 
 bool AsyncDirectoryListing::HandleFile(const char* file_name) {
-  return AddFileSystemEntityToResponse(kListFile, file_name);
+  return AddPackedEntry(kListFile, file_name);
 }
 
 bool AsyncDirectoryListing::HandleLink(const char* link_name) {
-  return AddFileSystemEntityToResponse(kListLink, link_name);
+  return AddPackedEntry(kListLink, link_name);
 }
 
 void AsyncDirectoryListing::HandleDone() {
+  FlushPacked();
   AddFileSystemEntityToResponse(kListDone, NULL);
 }
 
 bool AsyncDirectoryListing::HandleError() {
   CObject* err = CObject::NewOSError();
+  // Keep the entries found before the error ahead of it.
+  FlushPacked();
   array_->SetAt(index_++, new CObjectInt32(CObject::NewInt32(kListError)));
   CObjectArray* response = new CObjectArray(CObject::NewArray(3));
   response->SetAt(0, new CObjectInt32(CObject::NewInt32(kListError)));
@@ -491,7 +536,7 @@ bool AsyncDirectoryListing::HandleError() {
                          error() ? "Invalid path" : CurrentPath())));
   response->SetAt(2, err);
   array_->SetAt(index_++, response);
-  return index_ < length_;
+  return HasRoom();
 }
 
 bool SyncDirectoryListing::HandleDirectory(const char* dir_name) {
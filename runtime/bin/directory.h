@@ -161,9 +161,15 @@ class AsyncDirectoryListing : public ReferenceCounted<AsyncDirectoryListing>,
     kListDirectory = 1,
     kListLink = 2,
     kListError = 3,
-    kListDone = 4
+    kListDone = 4,
+    // Any number of file, directory and link entries packed into one
+    // Uint8List. Each is a type byte followed by a NUL-terminated path.
+    kListPacked = 5
   };
 
+  // The size at which a packed batch of entries is sent.
+  static const intptr_t kPackedBatchSize = 64 * KB;
+
   AsyncDirectoryListing(Namespace* namespc,
                         const char* dir_name,
                         bool recursive,
@@ -172,7 +178,10 @@ class AsyncDirectoryListing : public ReferenceCounted<AsyncDirectoryListing>,
         DirectoryListing(namespc, dir_name, recursive, follow_links),
         array_(NULL),
         index_(0),
-        length_(0) {}
+        length_(0),
+        packed_(NULL),
+        packed_length_(0),
+        packed_capacity_(0) {}
 
   virtual bool HandleDirectory(const char* dir_name);
   virtual bool HandleFile(const char* file_name);
@@ -189,12 +198,20 @@ class AsyncDirectoryListing : public ReferenceCounted<AsyncDirectoryListing>,
 
   intptr_t index() const { return index_; }
 
+  // Adds the entries packed since the last call to the response.
+  void FlushPacked();
+
  private:
-  virtual ~AsyncDirectoryListing() {}
+  virtual ~AsyncDirectoryListing() { free(packed_); }
   bool AddFileSystemEntityToResponse(Response response, const char* arg);
+  bool AddPackedEntry(Response response, const char* path);
+  bool HasRoom() const;
   CObjectArray* array_;
   intptr_t index_;
   intptr_t length_;
+  uint8_t* packed_;
+  intptr_t packed_length_;
+  intptr_t packed_capacity_;
 
   friend class ReferenceCounted<AsyncDirectoryListing>;
   DISALLOW_IMPLICIT_CONSTRUCTORS(AsyncDirectoryListing);
@@ -7,14 +7,15 @@
 
 #include "bin/directory.h"
 
-#include <dirent.h>     // NOLINT
-#include <errno.h>      // NOLINT
-#include <fcntl.h>      // NOLINT
-#include <stdlib.h>     // NOLINT
-#include <string.h>     // NOLINT
-#include <sys/param.h>  // NOLINT
-#include <sys/stat.h>   // NOLINT
-#include <unistd.h>     // NOLINT
+#include <dirent.h>       // NOLINT
+#include <errno.h>        // NOLINT
+#include <fcntl.h>        // NOLINT
+#include <stdlib.h>       // NOLINT
+#include <string.h>       // NOLINT
+#include <sys/param.h>    // NOLINT
+#include <sys/stat.h>     // NOLINT
+#include <sys/syscall.h>  // NOLINT
+#include <unistd.h>       // NOLINT
 
 #include "bin/crypto.h"
 #include "bin/dartutils.h"
@@ -80,6 +81,44 @@ struct LinkList {
   LinkList* next;
 };
 
+// Reads the entries of a directory with getdents64, in batches larger than
+// those of readdir. The kernel reports the type of most entries, so they
+// need no stat.
+class DirectoryReader {
+ public:
+  explicit DirectoryReader(int fd) : fd_(fd), position_(0), end_(0) {}
+  ~DirectoryReader() { FDUtils::SaveErrorAndClose(fd_); }
+
+  // Returns the next entry. Returns NULL at the end of the directory, and on
+  // errors, which leave errno set.
+  dirent64* Next() {
+    if (position_ >= end_) {
+      intptr_t result = TEMP_FAILURE_RETRY(
+          syscall(SYS_getdents64, fd_, buffer_, sizeof(buffer_)));
+      if (result <= 0) {
+        return NULL;
+      }
+      position_ = 0;
+      end_ = result;
+    }
+    dirent64* entry = reinterpret_cast<dirent64*>(
+        reinterpret_cast<uint8_t*>(buffer_) + position_);
+    position_ += entry->d_reclen;
+    return entry;
+  }
+
+ private:
+  static const intptr_t kBufferSize = 64 * KB;
+
+  const int fd_;
+  intptr_t position_;
+  intptr_t end_;
+  // Entries are 8 byte aligned.
+  uint64_t buffer_[kBufferSize / sizeof(uint64_t)];
+
+  DISALLOW_COPY_AND_ASSIGN(DirectoryReader);
+};
+
 ListType DirectoryListingEntry::Next(DirectoryListing* listing) {
   if (done_) {
     return kListDone;
@@ -98,13 +137,7 @@ ListType DirectoryListingEntry::Next(DirectoryListing* listing) {
   }
 
   if (lister_ == 0) {
-    do {
-      lister_ = reinterpret_cast<intptr_t>(fdopendir(fd_));
-    } while ((lister_ == 0) && (errno == EINTR));
-    if (lister_ == 0) {
-      done_ = true;
-      return kListError;
-    }
+    lister_ = reinterpret_cast<intptr_t>(new DirectoryReader(fd_));
     if (parent_ != NULL) {
       if (!listing->path_buffer().Add(File::PathSeparator())) {
         return kListError;
@@ -119,7 +152,7 @@ ListType DirectoryListingEntry::Next(DirectoryListing* listing) {
   // Iterate the directory and post the directories and files to the
   // ports.
   errno = 0;
-  dirent* entry = readdir(reinterpret_cast<DIR*>(lister_));
+  dirent64* entry = reinterpret_cast<DirectoryReader*>(lister_)->Next();
   if (entry != NULL) {
     if (!listing->path_buffer().Add(entry->d_name)) {
       done_ = true;
@@ -225,7 +258,7 @@ DirectoryListingEntry::~DirectoryListingEntry() {
   ResetLink();
   if (lister_ != 0) {
     // This also closes fd_.
-    VOID_NO_RETRY_EXPECTED(closedir(reinterpret_cast<DIR*>(lister_)));
+    delete reinterpret_cast<DirectoryReader*>(lister_);
   }
 }
 
@@ -475,19 +508,21 @@ bool Directory::Delete(Namespace* namespc,
                        const char* dir_name,
                        bool recursive) {
   NamespaceScope ns(namespc, dir_name);
+  bool result;
   if (!recursive) {
     if ((File::GetType(namespc, dir_name, false) == File::kIsLink) &&
         (File::GetType(namespc, dir_name, true) == File::kIsDirectory)) {
-      return NO_RETRY_EXPECTED(unlinkat(ns.fd(), ns.path(), 0)) == 0;
+      result = NO_RETRY_EXPECTED(unlinkat(ns.fd(), ns.path(), 0)) == 0;
+    } else {
+      result =
+          NO_RETRY_EXPECTED(unlinkat(ns.fd(), ns.path(), AT_REMOVEDIR)) == 0;
     }
-    return NO_RETRY_EXPECTED(unlinkat(ns.fd(), ns.path(), AT_REMOVEDIR)) == 0;
   } else {
     PathBuffer path;
-    if (!path.Add(ns.path())) {
-      return false;
-    }
-    return DeleteRecursively(ns.fd(), &path);
+    result = path.Add(ns.path()) && DeleteRecursively(ns.fd(), &path);
   }
+  DirectoryCache::Invalidate(dir_name);
+  return result;
 }
 
 bool Directory::Rename(Namespace* namespc,
@@ -499,8 +534,12 @@ bool Directory::Rename(Namespace* namespc,
   }
   NamespaceScope oldns(namespc, old_path);
   NamespaceScope newns(namespc, new_path);
-  return (NO_RETRY_EXPECTED(renameat(oldns.fd(), oldns.path(), newns.fd(),
-                                     newns.path())) == 0);
+  const bool result =
+      NO_RETRY_EXPECTED(
+          renameat(oldns.fd(), oldns.path(), newns.fd(), newns.path())) == 0;
+  DirectoryCache::Invalidate(old_path);
+  DirectoryCache::Invalidate(new_path);
+  return result;
 }
 
 }  // namespace bin
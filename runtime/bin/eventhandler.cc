@@ -11,61 +11,206 @@
 #include "bin/thread.h"
 
 #include "include/dart_api.h"
+#include "platform/utils.h"
 
 namespace dart {
 namespace bin {
 
+TimeoutQueue::TimeoutQueue()
+    : timeouts_(&SamePort, 16), base_(0), next_timeout_(NULL) {
+  for (intptr_t level = 0; level < kLevels; level++) {
+    occupied_[level] = 0;
+    for (intptr_t slot = 0; slot < kSlots; slot++) {
+      slots_[level][slot] = NULL;
+    }
+  }
+}
+
+TimeoutQueue::~TimeoutQueue() {
+  while (HasTimeout()) {
+    RemoveCurrent();
+  }
+  ASSERT(size() == 0);
+}
+
+bool TimeoutQueue::SamePort(void* key1, void* key2) {
+  return reinterpret_cast<Timeout*>(key1)->port() ==
+         reinterpret_cast<Timeout*>(key2)->port();
+}
+
+uint32_t TimeoutQueue::PortHash(Dart_Port port) {
+  const uint64_t bits = static_cast<uint64_t>(port);
+  return static_cast<uint32_t>(bits ^ (bits >> 32));
+}
+
 void TimeoutQueue::UpdateTimeout(Dart_Port port, int64_t timeout) {
-  // Find port if present.
-  Timeout* last = NULL;
-  Timeout* current = timeouts_;
-  while (current != NULL) {
-    if (current->port() == port) {
-      // Found.
-      if (timeout < 0) {
-        // Remove from list and delete existing.
-        if (last != NULL) {
-          last->set_next(current->next());
-        } else {
-          timeouts_ = current->next();
-        }
-        delete current;
-      } else {
-        // Update timeout.
-        current->set_timeout(timeout);
-      }
-      break;
+  Timeout key(port, 0);
+  const uint32_t hash = PortHash(port);
+  SimpleHashMap::Entry* entry = timeouts_.Lookup(&key, hash, timeout >= 0);
+  if (entry == NULL) {
+    // Removing a timeout the port does not have.
+    return;
+  }
+  Timeout* current = reinterpret_cast<Timeout*>(entry->value);
+  if (current != NULL) {
+    Unlink(current);
+  }
+  if (timeout < 0) {
+    ASSERT(current != NULL);
+    timeouts_.Remove(current, hash);
+    delete current;
+  } else {
+    if (current == NULL) {
+      // Replace the key on the stack inserted by Lookup.
+      current = new Timeout(port, timeout);
+      entry->key = current;
+      entry->value = current;
+    } else {
+      current->set_timeout(timeout);
     }
-    last = current;
-    current = current->next();
+    Link(current);
   }
-  if (current == NULL && timeout >= 0) {
-    // Not found, create a new.
-    timeouts_ = new Timeout(port, timeout, timeouts_);
+  FindNextTimeout();
+}
+
+void TimeoutQueue::Link(Timeout* timeout) {
+  // Timeouts that have passed are kept with the earliest ones.
+  const uint64_t time =
+      Utils::Maximum(static_cast<uint64_t>(timeout->timeout()), base_);
+  const uint64_t diff = time ^ base_;
+  const intptr_t level =
+      (diff == 0) ? 0
+                  : Utils::HighestBit(static_cast<int64_t>(diff)) / kSlotBits;
+  const intptr_t slot = (time >> (level * kSlotBits)) & (kSlots - 1);
+  Timeout* head = slots_[level][slot];
+  timeout->set_position(level, slot);
+  timeout->set_prev(NULL);
+  timeout->set_next(head);
+  if (head != NULL) {
+    head->set_prev(timeout);
   }
-  // Clear and find next timeout.
+  slots_[level][slot] = timeout;
+  occupied_[level] |= static_cast<uint64_t>(1) << slot;
+}
+
+void TimeoutQueue::Unlink(Timeout* timeout) {
+  const intptr_t level = timeout->level();
+  const intptr_t slot = timeout->slot();
+  if (timeout->prev() != NULL) {
+    timeout->prev()->set_next(timeout->next());
+  } else {
+    ASSERT(slots_[level][slot] == timeout);
+    slots_[level][slot] = timeout->next();
+    if (timeout->next() == NULL) {
+      occupied_[level] &= ~(static_cast<uint64_t>(1) << slot);
+    }
+  }
+  if (timeout->next() != NULL) {
+    timeout->next()->set_prev(timeout->prev());
+  }
+  timeout->set_prev(NULL);
+  timeout->set_next(NULL);
+}
+
+void TimeoutQueue::FindNextTimeout() {
   next_timeout_ = NULL;
-  current = timeouts_;
-  while (current != NULL) {
-    if ((next_timeout_ == NULL) ||
-        (current->timeout() < next_timeout_->timeout())) {
-      next_timeout_ = current;
+  for (intptr_t level = 0; level < kLevels; level++) {
+    const uint64_t occupied = occupied_[level];
+    if (occupied == 0) {
+      continue;
     }
-    current = current->next();
+    const intptr_t slot =
+        Utils::HighestBit(static_cast<int64_t>(occupied & (~occupied + 1)));
+    Timeout* earliest = slots_[level][slot];
+    for (Timeout* current = earliest->next(); current != NULL;
+         current = current->next()) {
+      if (current->timeout() < earliest->timeout()) {
+        earliest = current;
+      }
+    }
+    if (level > 0) {
+      // Move the timeouts of the slot down to the levels below, relative to
+      // the earliest of them.
+      base_ = earliest->timeout();
+      Timeout* current = slots_[level][slot];
+      slots_[level][slot] = NULL;
+      occupied_[level] &= ~(static_cast<uint64_t>(1) << slot);
+      while (current != NULL) {
+        Timeout* next = current->next();
+        Link(current);
+        ASSERT(current->level() < level);
+        current = next;
+      }
+    }
+    next_timeout_ = earliest;
+    return;
   }
 }
 
-static EventHandler* event_handler = NULL;
+static EventHandler** event_handlers = NULL;
+static intptr_t event_handler_count = 0;
 static Monitor* shutdown_monitor = NULL;
 
+bool EventHandler::io_uring_polling_ = false;
+bool EventHandler::epoll_keep_registered_ = false;
+intptr_t EventHandler::epoll_max_events_ = 16;
+intptr_t EventHandler::thread_count_ = 1;
+intptr_t EventHandler::spin_microseconds_ = 0;
+bool EventHandler::group_by_incoming_cpu_ = false;
+
 void EventHandler::Start() {
   // Initialize global socket registry.
   ListeningSocketRegistry::Initialize();
 
-  ASSERT(event_handler == NULL);
+  ASSERT(event_handlers == NULL);
   shutdown_monitor = new Monitor();
-  event_handler = new EventHandler();
-  event_handler->delegate_.Start(event_handler);
+#if defined(HOST_OS_WINDOWS)
+  // Handles are bound to the IO completion port of EventHandler::delegate().
+  event_handler_count = 1;
+#else
+  event_handler_count = thread_count_;
+#endif
+  event_handlers = new EventHandler*[event_handler_count];
+  for (intptr_t i = 0; i < event_handler_count; i++) {
+    event_handlers[i] = new EventHandler(i);
+    event_handlers[i]->delegate_.Start(event_handlers[i]);
+  }
+}
+
+// Sockets are assigned to event handlers by file descriptor. All commands for
+// a descriptor, including those for a later socket that reuses its number,
+// are then handled in order by the same thread. Timers are assigned by port.
+//
+// With group_by_incoming_cpu(), a socket is instead assigned by the CPU that
+// received its packets when its first command is sent, and keeps that
+// thread. Its commands stay ordered, and a later socket can only reuse its
+// descriptor number once that thread has closed it. Listening sockets, which
+// isolates share, and sockets with no incoming CPU yet keep the descriptor
+// hash.
+static EventHandler* GetEventHandler(intptr_t id,
+                                     Dart_Port dart_port,
+                                     int64_t data) {
+  if (event_handler_count == 1) {
+    return event_handlers[0];
+  }
+  intptr_t key;
+  if (id == kTimerId) {
+    key = static_cast<intptr_t>(dart_port);
+  } else {
+    Socket* socket = reinterpret_cast<Socket*>(id);
+    if (EventHandler::group_by_incoming_cpu() &&
+        !IS_LISTENING_SOCKET(data)) {
+      if (socket->event_handler() < 0) {
+        const intptr_t cpu = SocketBase::GetIncomingCpu(socket->fd());
+        socket->set_event_handler(
+            (cpu >= 0) ? (cpu % event_handler_count)
+                       : (Utils::WordHash(socket->fd()) % event_handler_count));
+      }
+      return event_handlers[socket->event_handler()];
+    }
+    key = socket->fd();
+  }
+  return event_handlers[Utils::WordHash(key) % event_handler_count];
 }
 
 void EventHandler::NotifyShutdownDone() {
@@ -74,22 +219,29 @@ void EventHandler::NotifyShutdownDone() {
 }
 
 void EventHandler::Stop() {
-  if (event_handler == NULL) {
+  if (event_handlers == NULL) {
     return;
   }
 
-  // Wait until it has stopped.
-  {
+  for (intptr_t i = 0; i < event_handler_count; i++) {
+    // Wait until it has stopped.
     MonitorLocker ml(shutdown_monitor);
 
     // Signal to event handler that we want it to stop.
-    event_handler->delegate_.Shutdown();
+    event_handlers[i]->delegate_.Shutdown();
     ml.Wait(Monitor::kNoTimeout);
   }
+  // The event handler threads are going down so there should be no more live
+  // Sockets.
+  DEBUG_ASSERT(ReferenceCounted<Socket>::instances() == 0);
 
   // Cleanup
-  delete event_handler;
-  event_handler = NULL;
+  for (intptr_t i = 0; i < event_handler_count; i++) {
+    delete event_handlers[i];
+  }
+  delete[] event_handlers;
+  event_handlers = NULL;
+  event_handler_count = 0;
   delete shutdown_monitor;
   shutdown_monitor = NULL;
 
@@ -98,14 +250,15 @@ void EventHandler::Stop() {
 }
 
 EventHandlerImplementation* EventHandler::delegate() {
-  if (event_handler == NULL) {
+  if (event_handlers == NULL) {
     return NULL;
   }
-  return &event_handler->delegate_;
+  ASSERT(event_handler_count == 1);
+  return &event_handlers[0]->delegate_;
 }
 
 void EventHandler::SendFromNative(intptr_t id, Dart_Port port, int64_t data) {
-  event_handler->SendData(id, port, data);
+  GetEventHandler(id, port, data)->SendData(id, port, data);
 }
 
 /*
@@ -134,7 +287,7 @@ void FUNCTION_NAME(EventHandler_SendData)(Dart_NativeArguments args) {
     id = reinterpret_cast<intptr_t>(socket);
   }
   int64_t data = DartUtils::GetIntegerValue(Dart_GetNativeArgument(args, 2));
-  event_handler->SendData(id, dart_port, data);
+  GetEventHandler(id, dart_port, data)->SendData(id, dart_port, data);
 }
 
 void FUNCTION_NAME(EventHandler_TimerMillisecondClock)(
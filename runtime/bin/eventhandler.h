@@ -56,12 +56,29 @@ enum MessageFlags {
 #define TOKEN_COUNT(data) (data & ((1 << kCloseCommand) - 1))
 // clang-format on
 
+// The timeouts of the ports that have one, kept in a hierarchical timer
+// wheel so that adding, updating and removing a timeout takes constant time
+// however many there are.
+//
+// Timeouts are absolute times in milliseconds. The wheel has kLevels levels
+// of kSlots slots, one per digit of base kSlots. A timeout is kept at the
+// level of the highest digit in which it differs from base_, in the slot
+// given by its own digit there. All timeouts are at or after base_, so the
+// first occupied slot of the lowest occupied level holds the next timeout.
+// When that slot is above level 0, base_ advances to its earliest timeout
+// and its timeouts move down, which happens at most kLevels times for each
+// timeout.
 class TimeoutQueue {
  private:
   class Timeout {
    public:
-    Timeout(Dart_Port port, int64_t timeout, Timeout* next)
-        : port_(port), timeout_(timeout), next_(next) {}
+    Timeout(Dart_Port port, int64_t timeout)
+        : port_(port),
+          timeout_(timeout),
+          prev_(NULL),
+          next_(NULL),
+          level_(0),
+          slot_(0) {}
 
     Dart_Port port() const { return port_; }
 
@@ -71,22 +88,30 @@ class TimeoutQueue {
       timeout_ = timeout;
     }
 
+    Timeout* prev() const { return prev_; }
+    void set_prev(Timeout* prev) { prev_ = prev; }
     Timeout* next() const { return next_; }
     void set_next(Timeout* next) { next_ = next; }
 
+    intptr_t level() const { return level_; }
+    intptr_t slot() const { return slot_; }
+    void set_position(intptr_t level, intptr_t slot) {
+      level_ = level;
+      slot_ = slot;
+    }
+
    private:
     Dart_Port port_;
     int64_t timeout_;
+    Timeout* prev_;
     Timeout* next_;
+    intptr_t level_;
+    intptr_t slot_;
   };
 
  public:
-  TimeoutQueue() : next_timeout_(NULL), timeouts_(NULL) {}
-
-  ~TimeoutQueue() {
-    while (HasTimeout())
-      RemoveCurrent();
-  }
+  TimeoutQueue();
+  ~TimeoutQueue();
 
   bool HasTimeout() const { return next_timeout_ != NULL; }
 
@@ -102,11 +127,29 @@ class TimeoutQueue {
 
   void RemoveCurrent() { UpdateTimeout(CurrentPort(), -1); }
 
+  // Sets the timeout of |port|, or removes it if |timeout| is negative.
   void UpdateTimeout(Dart_Port port, int64_t timeout);
 
+  intptr_t size() const { return timeouts_.size(); }
+
  private:
+  static const intptr_t kSlotBits = 6;
+  static const intptr_t kSlots = 1 << kSlotBits;
+  static const intptr_t kLevels = (64 + kSlotBits - 1) / kSlotBits;
+
+  static bool SamePort(void* key1, void* key2);
+  static uint32_t PortHash(Dart_Port port);
+
+  void Link(Timeout* timeout);
+  void Unlink(Timeout* timeout);
+  void FindNextTimeout();
+
+  // Maps ports to their Timeout, which is also the key.
+  SimpleHashMap timeouts_;
+  uint64_t base_;
+  uint64_t occupied_[kLevels];
+  Timeout* slots_[kLevels][kSlots];
   Timeout* next_timeout_;
-  Timeout* timeouts_;
 
   DISALLOW_COPY_AND_ASSIGN(TimeoutQueue);
 };
@@ -618,7 +661,11 @@ namespace bin {
 
 class EventHandler {
  public:
-  EventHandler() {}
+  explicit EventHandler(intptr_t index) : index_(index) {}
+
+  // The position of this event handler among the thread_count() ones.
+  intptr_t index() const { return index_; }
+
   void SendData(intptr_t id, Dart_Port dart_port, int64_t data) {
     delegate_.SendData(id, dart_port, data);
   }
@@ -643,9 +690,75 @@ class EventHandler {
 
   static void SendFromNative(intptr_t id, Dart_Port port, int64_t data);
 
+  /**
+   * Ask the Linux event handler to poll descriptors and wait for timers with
+   * io_uring instead of epoll when the kernel supports it. Reads, writes and
+   * accepts are not affected. Must be set before Start(). Ignored elsewhere.
+   */
+  static bool io_uring_polling() { return io_uring_polling_; }
+  static void set_io_uring_polling(bool value) { io_uring_polling_ = value; }
+
+  /**
+   * Ask the Linux epoll event handler to keep non-listening descriptors
+   * registered while nothing listens for their events, and to re-arm them
+   * with EPOLL_CTL_MOD only when the interest grows. Must be set before
+   * Start(). Ignored elsewhere.
+   */
+  static bool epoll_keep_registered() { return epoll_keep_registered_; }
+  static void set_epoll_keep_registered(bool value) {
+    epoll_keep_registered_ = value;
+  }
+
+  /**
+   * The most events the Linux epoll event handler takes from one
+   * epoll_wait. Must be set before Start(). Ignored elsewhere.
+   */
+  static intptr_t epoll_max_events() { return epoll_max_events_; }
+  static void set_epoll_max_events(intptr_t value) {
+    epoll_max_events_ = value;
+  }
+
+  /**
+   * The number of event handler threads, each with its own OS event queue
+   * and timers. Sockets are assigned to them by file descriptor and timers by
+   * port. Must be set before Start(). Windows always uses one.
+   */
+  static intptr_t thread_count() { return thread_count_; }
+  static void set_thread_count(intptr_t value) { thread_count_ = value; }
+
+  /**
+   * Ask the Linux epoll event handler to keep polling without blocking for
+   * this many microseconds after it handled events, so that events which
+   * follow soon after are handled without waking up a blocked thread. 0
+   * blocks at once. Must be set before Start(). Ignored elsewhere.
+   */
+  static intptr_t spin_microseconds() { return spin_microseconds_; }
+  static void set_spin_microseconds(intptr_t value) {
+    spin_microseconds_ = value;
+  }
+
+  /**
+   * Ask the Linux event handler to assign each connected socket to a thread
+   * by the CPU that received its packets (SO_INCOMING_CPU), and to run each
+   * thread on the CPUs it is assigned. Must be set before Start(). Ignored
+   * elsewhere and with a single thread.
+   */
+  static bool group_by_incoming_cpu() { return group_by_incoming_cpu_; }
+  static void set_group_by_incoming_cpu(bool value) {
+    group_by_incoming_cpu_ = value;
+  }
+
  private:
   friend class EventHandlerImplementation;
   EventHandlerImplementation delegate_;
+  const intptr_t index_;
+
+  static bool io_uring_polling_;
+  static bool epoll_keep_registered_;
+  static intptr_t epoll_max_events_;
+  static intptr_t thread_count_;
+  static intptr_t spin_microseconds_;
+  static bool group_by_incoming_cpu_;
 
   DISALLOW_COPY_AND_ASSIGN(EventHandler);
 };
@@ -121,6 +121,23 @@ intptr_t IOHandle::Write(const void* buffer, intptr_t num_bytes) {
   return written_bytes;
 }
 
+intptr_t IOHandle::WriteV(const struct iovec* iov, int iovcnt) {
+  MutexLocker ml(&mutex_);
+  const ssize_t written_bytes = NO_RETRY_EXPECTED(writev(fd_, iov, iovcnt));
+  const int err = errno;
+  LOG_INFO("IOHandle::WriteV: fd = %ld. wrote %ld bytes\n", fd_,
+           written_bytes);
+
+  // Resubscribe to write events.
+  write_events_enabled_ = true;
+  if (!AsyncWaitLocked(ZX_HANDLE_INVALID, POLLOUT, wait_key_)) {
+    LOG_ERR("IOHandle::AsyncWait failed for fd = %ld\n", fd_);
+  }
+
+  errno = err;
+  return written_bytes;
+}
+
 intptr_t IOHandle::Accept(struct sockaddr* addr, socklen_t* addrlen) {
   MutexLocker ml(&mutex_);
   const intptr_t socket = NO_RETRY_EXPECTED(accept(fd_, addr, addrlen));
@@ -565,7 +582,6 @@ void EventHandlerImplementation::Poll(uword args) {
       handler_impl->HandlePacket(&pkt);
     }
   }
-  DEBUG_ASSERT(ReferenceCounted<Socket>::instances() == 0);
   handler->NotifyShutdownDone();
 }
 
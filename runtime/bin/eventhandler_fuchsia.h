@@ -12,6 +12,7 @@
 #include <errno.h>
 #include <lib/fdio/unsafe.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <zircon/status.h>
 #include <zircon/syscalls.h>
@@ -41,10 +42,11 @@ class IOHandle : public ReferenceCounted<IOHandle> {
 
   intptr_t fd() const { return fd_; }
 
-  // Called from SocketBase::{Read(), Write()} and ServerSocket::Accept() on
-  // the Dart thread.
+  // Called from SocketBase::{Read(), Write(), WriteV()} and
+  // ServerSocket::Accept() on the Dart thread.
   intptr_t Read(void* buffer, intptr_t num_bytes);
   intptr_t Write(const void* buffer, intptr_t num_bytes);
+  intptr_t WriteV(const struct iovec* iov, int iovcnt);
   intptr_t Accept(struct sockaddr* addr, socklen_t* addrlen);
   intptr_t AvailableBytes();
 
@@ -11,6 +11,7 @@
 #include <errno.h>        // NOLINT
 #include <fcntl.h>        // NOLINT
 #include <pthread.h>      // NOLINT
+#include <sched.h>        // NOLINT
 #include <stdio.h>        // NOLINT
 #include <string.h>       // NOLINT
 #include <sys/epoll.h>    // NOLINT
@@ -23,6 +24,7 @@
 #include "bin/lockers.h"
 #include "bin/socket.h"
 #include "bin/thread.h"
+#include "bin/utils.h"
 #include "platform/syslog.h"
 #include "platform/utils.h"
 
@@ -48,15 +50,20 @@ static void RemoveFromEpollInstance(intptr_t epoll_fd_, DescriptorInfo* di) {
   VOID_NO_RETRY_EXPECTED(epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, di->fd(), NULL));
 }
 
-static void AddToEpollInstance(intptr_t epoll_fd_, DescriptorInfo* di) {
+// Registers the file descriptor for a DescriptorInfo structure with epoll,
+// or with op EPOLL_CTL_MOD changes its registration. Both report readiness
+// that is already there, so edges missed while not registered for an event
+// are not lost.
+static bool AddToEpollInstance(intptr_t epoll_fd_,
+                               DescriptorInfo* di,
+                               int op = EPOLL_CTL_ADD) {
   struct epoll_event event;
   event.events = EPOLLRDHUP | di->GetPollEvents();
   if (!di->IsListeningSocket()) {
     event.events |= EPOLLET;
   }
   event.data.ptr = di;
-  int status =
-      NO_RETRY_EXPECTED(epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, di->fd(), &event));
+  int status = NO_RETRY_EXPECTED(epoll_ctl(epoll_fd_, op, di->fd(), &event));
   if (status == -1) {
     // TODO(dart:io): Verify that the dart end is handling this correctly.
 
@@ -65,11 +72,32 @@ static void AddToEpollInstance(intptr_t epoll_fd_, DescriptorInfo* di) {
     // as /dev/null. In such case, mark the file descriptor as closed,
     // so dart will handle it accordingly.
     di->NotifyAllDartPorts(1 << kCloseEvent);
+    return false;
   }
+  return true;
 }
 
+// Completions are matched to their requests through user_data. Its low bits
+// hold the kind of request. Descriptor polls also carry the fd and a
+// sequence number, which lets completions of polls that were removed since,
+// or that belong to closed descriptors, be told apart and dropped.
+static const intptr_t kRingInterruptRequest = 1;
+static const intptr_t kRingDescriptorRequest = 2;
+static const intptr_t kRingTimerRequest = 3;
+static const intptr_t kRingCancelRequest = 4;
+static const intptr_t kRingKindBits = 3;
+static const uint64_t kRingKindMask = (1 << kRingKindBits) - 1;
+
+static const uint32_t kRingEntries = 256;
+
 EventHandlerImplementation::EventHandlerImplementation()
-    : socket_map_(&SimpleHashMap::SamePointerValue, 16) {
+    : socket_map_(&SimpleHashMap::SamePointerValue, 16),
+      epoll_fd_(-1),
+      timer_fd_(-1),
+      use_ring_(false),
+      ring_sequence_(0),
+      timer_request_(0),
+      timer_dirty_(false) {
   intptr_t result;
   result = NO_RETRY_EXPECTED(pipe(interrupt_fds_));
   if (result != 0) {
@@ -85,6 +113,11 @@ EventHandlerImplementation::EventHandlerImplementation()
     FATAL("Failed to set pipe fd close on exec\n");
   }
   shutdown_ = false;
+  if (EventHandler::io_uring_polling() && ring_.Initialize(kRingEntries)) {
+    use_ring_ = true;
+    ArmInterruptPoll();
+    return;
+  }
   // The initial size passed to epoll_create is ignore on newer (>=
   // 2.6.8) Linux versions
   static const int kEpollInitialSize = 64;
@@ -127,14 +160,26 @@ static void DeleteDescriptorInfo(void* info) {
 
 EventHandlerImplementation::~EventHandlerImplementation() {
   socket_map_.Clear(DeleteDescriptorInfo);
-  close(epoll_fd_);
-  close(timer_fd_);
+  if (epoll_fd_ != -1) {
+    close(epoll_fd_);
+  }
+  if (timer_fd_ != -1) {
+    close(timer_fd_);
+  }
   close(interrupt_fds_[0]);
   close(interrupt_fds_[1]);
 }
 
 void EventHandlerImplementation::UpdateEpollInstance(intptr_t old_mask,
                                                      DescriptorInfo* di) {
+  if (use_ring_) {
+    UpdatePollRequest(di);
+    return;
+  }
+  if (EventHandler::epoll_keep_registered() && !di->IsListeningSocket()) {
+    UpdateEpollRegistration(old_mask, di);
+    return;
+  }
   intptr_t new_mask = di->Mask();
   if ((old_mask != 0) && (new_mask == 0)) {
     RemoveFromEpollInstance(epoll_fd_, di);
@@ -142,8 +187,22 @@ void EventHandlerImplementation::UpdateEpollInstance(intptr_t old_mask,
     AddToEpollInstance(epoll_fd_, di);
   } else if ((old_mask != 0) && (new_mask != 0) && (old_mask != new_mask)) {
     ASSERT(!di->IsListeningSocket());
-    RemoveFromEpollInstance(epoll_fd_, di);
-    AddToEpollInstance(epoll_fd_, di);
+    AddToEpollInstance(epoll_fd_, di, EPOLL_CTL_MOD);
+  }
+}
+
+// Descriptors that stay registered are only re-armed when they gain an event,
+// as readiness for it may have been dropped by HandleDescriptorEvents. Losing
+// an event, or all of them when the tokens run out, needs no epoll_ctl.
+void EventHandlerImplementation::UpdateEpollRegistration(intptr_t old_mask,
+                                                         DescriptorInfo* di) {
+  const intptr_t gained = di->Mask() & ~old_mask;
+  if (gained == 0) {
+    return;
+  }
+  const int op = (di->epoll_events() == 0) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+  if (AddToEpollInstance(epoll_fd_, di, op)) {
+    di->set_epoll_events(EPOLLRDHUP | EPOLLET | di->GetPollEvents());
   }
 }
 
@@ -250,6 +309,10 @@ void EventHandlerImplementation::HandleInterruptFd() {
           }
         } else {
           ASSERT(new_mask == 0);
+          if (di->epoll_events() != 0) {
+            RemoveFromEpollInstance(epoll_fd_, di);
+            di->set_epoll_events(0);
+          }
           socket_map_.Remove(GetHashmapKeyFromFd(fd), GetHashmapHashFromFd(fd));
           di->Close();
           delete di;
@@ -277,6 +340,12 @@ void EventHandlerImplementation::HandleInterruptFd() {
 }
 
 void EventHandlerImplementation::UpdateTimerFd() {
+  if (use_ring_) {
+    // Several updates can arrive in one batch of interrupt messages. Only
+    // the last one needs to reach the kernel.
+    timer_dirty_ = true;
+    return;
+  }
   struct itimerspec it;
   memset(&it, 0, sizeof(it));
   if (timeout_queue_.HasTimeout()) {
@@ -360,17 +429,7 @@ void EventHandlerImplementation::HandleEvents(struct epoll_event* events,
     } else {
       DescriptorInfo* di =
           reinterpret_cast<DescriptorInfo*>(events[i].data.ptr);
-      const intptr_t old_mask = di->Mask();
-      const intptr_t event_mask = GetPollEvents(events[i].events, di);
-      if ((event_mask & (1 << kErrorEvent)) != 0) {
-        di->NotifyAllDartPorts(event_mask);
-        UpdateEpollInstance(old_mask, di);
-      } else if (event_mask != 0) {
-        Dart_Port port = di->NextNotifyDartPort(event_mask);
-        ASSERT(port != 0);
-        UpdateEpollInstance(old_mask, di);
-        DartUtils::PostInt32(port, event_mask);
-      }
+      HandleDescriptorEvents(di, events[i].events);
     }
   }
   if (interrupt_seen) {
@@ -380,27 +439,212 @@ void EventHandlerImplementation::HandleEvents(struct epoll_event* events,
   }
 }
 
+void EventHandlerImplementation::HandleDescriptorEvents(DescriptorInfo* di,
+                                                        intptr_t events) {
+  const intptr_t old_mask = di->Mask();
+  intptr_t event_mask = GetPollEvents(events, di);
+  if (di->epoll_events() != 0) {
+    // The registration may be wider than the interest. Drop readiness nobody
+    // listens for. The descriptor is re-armed when the interest grows, which
+    // reports it again.
+    if (old_mask == 0) {
+      return;
+    }
+    event_mask &= old_mask | ~((1 << kInEvent) | (1 << kOutEvent));
+  }
+  if ((event_mask & (1 << kErrorEvent)) != 0) {
+    di->NotifyAllDartPorts(event_mask);
+    UpdateEpollInstance(old_mask, di);
+  } else if (event_mask != 0) {
+    Dart_Port port = di->NextNotifyDartPort(event_mask);
+    ASSERT(port != 0);
+    UpdateEpollInstance(old_mask, di);
+    DartUtils::PostInt32(port, event_mask);
+  }
+}
+
+uint64_t EventHandlerImplementation::NewRingRequest(intptr_t kind,
+                                                    intptr_t fd) {
+  ASSERT((kind & ~kRingKindMask) == 0);
+  ASSERT((fd >= 0) && (fd < (1 << (32 - kRingKindBits))));
+  ring_sequence_++;
+  return (static_cast<uint64_t>(ring_sequence_) << 32) |
+         (static_cast<uint64_t>(fd) << kRingKindBits) | kind;
+}
+
+void EventHandlerImplementation::UpdatePollRequest(DescriptorInfo* di) {
+  const intptr_t events =
+      (di->Mask() == 0) ? 0 : (EPOLLRDHUP | di->GetPollEvents());
+  if ((di->poll_request() != 0) && (di->poll_events() == events)) {
+    return;
+  }
+  if (di->poll_request() != 0) {
+    ring_.PollRemove(di->poll_request(), kRingCancelRequest);
+    di->set_poll_request(0);
+  }
+  if (events != 0) {
+    // Multishot polls report edge-triggered readiness like EPOLLET. Listening
+    // sockets need level-triggered behaviour, so they use single-shot polls
+    // that are re-armed after each completion.
+    const uint64_t request = NewRingRequest(kRingDescriptorRequest, di->fd());
+    ring_.PollAdd(di->fd(), events, !di->IsListeningSocket(), request);
+    di->set_poll_request(request);
+    di->set_poll_events(events);
+  }
+}
+
+void EventHandlerImplementation::ArmInterruptPoll() {
+  ring_.PollAdd(interrupt_fds_[0], EPOLLIN, false, kRingInterruptRequest);
+}
+
+void EventHandlerImplementation::SubmitTimer() {
+  ASSERT(timer_dirty_);
+  timer_dirty_ = false;
+  if (timer_request_ != 0) {
+    ring_.TimeoutRemove(timer_request_, kRingCancelRequest);
+    timer_request_ = 0;
+  }
+  if (timeout_queue_.HasTimeout()) {
+    timer_request_ = NewRingRequest(kRingTimerRequest, 0);
+    ring_.TimeoutAdd(timeout_queue_.CurrentTimeout(), timer_request_);
+  }
+}
+
+void EventHandlerImplementation::HandleDescriptorCompletion(uint64_t user_data,
+                                                            int32_t result,
+                                                            uint32_t flags) {
+  const intptr_t fd =
+      static_cast<intptr_t>((user_data & 0xFFFFFFFF) >> kRingKindBits);
+  SimpleHashMap::Entry* entry = socket_map_.Lookup(
+      GetHashmapKeyFromFd(fd), GetHashmapHashFromFd(fd), false);
+  if (entry == NULL) {
+    return;  // The descriptor was closed.
+  }
+  DescriptorInfo* di = reinterpret_cast<DescriptorInfo*>(entry->value);
+  if (di->poll_request() != user_data) {
+    return;  // The poll was removed or replaced.
+  }
+  if ((flags & IOUring::kCompletionMore) == 0) {
+    di->set_poll_request(0);
+  }
+  if (result == -ECANCELED) {
+    // The kernel terminated the poll on its own, e.g. a multishot poll after
+    // the completion queue overflowed.
+    UpdatePollRequest(di);
+  } else if (result < 0) {
+    // Same as epoll_ctl rejecting the descriptor.
+    di->NotifyAllDartPorts(1 << kCloseEvent);
+  } else {
+    HandleDescriptorEvents(di, result);
+    // Re-arms single-shot polls even if there was nothing to report.
+    UpdatePollRequest(di);
+  }
+}
+
+void EventHandlerImplementation::HandleRingCompletions() {
+  bool interrupt_seen = false;
+  IOUringCqe* cqe;
+  while ((cqe = ring_.PeekCompletion()) != NULL) {
+    const uint64_t user_data = cqe->user_data;
+    const int32_t result = cqe->res;
+    const uint32_t flags = cqe->flags;
+    ring_.ConsumeCompletion();
+    switch (user_data & kRingKindMask) {
+      case kRingInterruptRequest:
+        interrupt_seen = true;
+        break;
+      case kRingDescriptorRequest:
+        HandleDescriptorCompletion(user_data, result, flags);
+        break;
+      case kRingTimerRequest:
+        if (user_data == timer_request_) {
+          timer_request_ = 0;
+          if ((result == -ETIME) && timeout_queue_.HasTimeout()) {
+            DartUtils::PostNull(timeout_queue_.CurrentPort());
+            timeout_queue_.RemoveCurrent();
+          }
+          UpdateTimerFd();
+        }
+        break;
+      case kRingCancelRequest:
+        break;
+      default:
+        UNREACHABLE();
+    }
+  }
+  if (interrupt_seen) {
+    // As with epoll, handle after socket events so we avoid closing a socket
+    // before we handle the current events.
+    HandleInterruptFd();
+    ArmInterruptPoll();
+  }
+}
+
+// Runs the calling thread on the CPUs whose sockets GetEventHandler() in
+// eventhandler.cc assigns to the event handler 'index'. Failure, for example
+// outside the allowed cpuset, leaves the thread where it was.
+static void SetEventHandlerAffinity(intptr_t index, intptr_t count) {
+  const intptr_t cpus = sysconf(_SC_NPROCESSORS_CONF);
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (intptr_t cpu = index; (cpu < cpus) && (cpu < CPU_SETSIZE);
+       cpu += count) {
+    CPU_SET(cpu, &set);
+  }
+  if (CPU_COUNT(&set) > 0) {
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  }
+}
+
 void EventHandlerImplementation::Poll(uword args) {
   ThreadSignalBlocker signal_blocker(SIGPROF);
-  static const intptr_t kMaxEvents = 16;
-  struct epoll_event events[kMaxEvents];
   EventHandler* handler = reinterpret_cast<EventHandler*>(args);
   EventHandlerImplementation* handler_impl = &handler->delegate_;
   ASSERT(handler_impl != NULL);
+  if (EventHandler::group_by_incoming_cpu() &&
+      (EventHandler::thread_count() > 1)) {
+    SetEventHandlerAffinity(handler->index(), EventHandler::thread_count());
+  }
 
+  while (handler_impl->use_ring_ && !handler_impl->shutdown_) {
+    if (handler_impl->timer_dirty_) {
+      handler_impl->SubmitTimer();
+    }
+    // Submits all poll and timer updates queued since the last iteration and
+    // waits for completions with a single system call.
+    handler_impl->ring_.SubmitAndWait();
+    handler_impl->HandleRingCompletions();
+  }
+  const intptr_t max_events = EventHandler::epoll_max_events();
+  struct epoll_event* events = NULL;
+  if (!handler_impl->use_ring_) {
+    events = new struct epoll_event[max_events];
+  }
+  // While spinning, epoll_wait does not block, until no event has come for
+  // spin_microseconds.
+  const int64_t spin_micros = EventHandler::spin_microseconds();
+  int64_t spin_until = 0;
   while (!handler_impl->shutdown_) {
+    const int timeout =
+        ((spin_micros > 0) &&
+         (TimerUtils::GetCurrentMonotonicMicros() < spin_until))
+            ? 0
+            : -1;
     intptr_t result = TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
-        epoll_wait(handler_impl->epoll_fd_, events, kMaxEvents, -1));
+        epoll_wait(handler_impl->epoll_fd_, events, max_events, timeout));
     ASSERT(EAGAIN == EWOULDBLOCK);
-    if (result <= 0) {
+    if (result < 0) {
       if (errno != EWOULDBLOCK) {
         perror("Poll failed");
       }
-    } else {
+    } else if (result > 0) {
       handler_impl->HandleEvents(events, result);
+      if (spin_micros > 0) {
+        spin_until = TimerUtils::GetCurrentMonotonicMicros() + spin_micros;
+      }
     }
   }
-  DEBUG_ASSERT(ReferenceCounted<Socket>::instances() == 0);
+  delete[] events;
   handler->NotifyShutdownDone();
 }
 
@@ -14,6 +14,7 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include "bin/io_uring_linux.h"
 #include "platform/hashmap.h"
 #include "platform/signal_blocker.h"
 
@@ -22,7 +23,11 @@ namespace bin {
 
 class DescriptorInfo : public DescriptorInfoBase {
  public:
-  explicit DescriptorInfo(intptr_t fd) : DescriptorInfoBase(fd) {}
+  explicit DescriptorInfo(intptr_t fd)
+      : DescriptorInfoBase(fd),
+        poll_request_(0),
+        poll_events_(0),
+        epoll_events_(0) {}
 
   virtual ~DescriptorInfo() {}
 
@@ -33,7 +38,22 @@ class DescriptorInfo : public DescriptorInfoBase {
     fd_ = -1;
   }
 
+  // The io_uring poll currently armed for this descriptor, or 0.
+  uint64_t poll_request() const { return poll_request_; }
+  void set_poll_request(uint64_t value) { poll_request_ = value; }
+  intptr_t poll_events() const { return poll_events_; }
+  void set_poll_events(intptr_t value) { poll_events_ = value; }
+
+  // The events registered with epoll when the descriptor stays registered
+  // (EventHandler::epoll_keep_registered()), or 0.
+  intptr_t epoll_events() const { return epoll_events_; }
+  void set_epoll_events(intptr_t value) { epoll_events_ = value; }
+
  private:
+  uint64_t poll_request_;
+  intptr_t poll_events_;
+  intptr_t epoll_events_;
+
   DISALLOW_COPY_AND_ASSIGN(DescriptorInfo);
 };
 
@@ -64,6 +84,7 @@ class EventHandlerImplementation {
   ~EventHandlerImplementation();
 
   void UpdateEpollInstance(intptr_t old_mask, DescriptorInfo* di);
+  void UpdateEpollRegistration(intptr_t old_mask, DescriptorInfo* di);
 
   // Gets the socket data structure for a given file
   // descriptor. Creates a new one if one is not found.
@@ -74,6 +95,7 @@ class EventHandlerImplementation {
 
  private:
   void HandleEvents(struct epoll_event* events, int size);
+  void HandleDescriptorEvents(DescriptorInfo* di, intptr_t events);
   static void Poll(uword args);
   void WakeupHandler(intptr_t id, Dart_Port dart_port, int64_t data);
   void HandleInterruptFd();
@@ -83,6 +105,17 @@ class EventHandlerImplementation {
   static void* GetHashmapKeyFromFd(intptr_t fd);
   static uint32_t GetHashmapHashFromFd(intptr_t fd);
 
+  // io_uring backend, used instead of epoll and the timerfd when
+  // EventHandler::io_uring_polling() is set and the kernel supports it.
+  uint64_t NewRingRequest(intptr_t kind, intptr_t fd);
+  void UpdatePollRequest(DescriptorInfo* di);
+  void ArmInterruptPoll();
+  void SubmitTimer();
+  void HandleRingCompletions();
+  void HandleDescriptorCompletion(uint64_t user_data,
+                                  int32_t result,
+                                  uint32_t flags);
+
   SimpleHashMap socket_map_;
   TimeoutQueue timeout_queue_;
   bool shutdown_;
@@ -90,6 +123,12 @@ class EventHandlerImplementation {
   int epoll_fd_;
   int timer_fd_;
 
+  bool use_ring_;
+  IOUring ring_;
+  uint32_t ring_sequence_;
+  uint64_t timer_request_;
+  bool timer_dirty_;
+
   DISALLOW_COPY_AND_ASSIGN(EventHandlerImplementation);
 };
 
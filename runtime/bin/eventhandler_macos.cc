@@ -460,7 +460,6 @@ void EventHandlerImplementation::EventHandlerEntry(uword args) {
       handler_impl->HandleEvents(events, result);
     }
   }
-  DEBUG_ASSERT(ReferenceCounted<Socket>::instances() == 0);
   handler->NotifyShutdownDone();
 }
 
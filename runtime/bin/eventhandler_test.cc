@@ -3,6 +3,7 @@
 // BSD-style license that can be found in the LICENSE file.
 
 #include "bin/eventhandler.h"
+#include "bin/utils.h"
 #include "platform/assert.h"
 #include "vm/unit_test.h"
 
@@ -79,5 +80,140 @@ VM_UNIT_TEST_CASE(CircularLinkedList) {
   list.Remove(4242);
 }
 
+#if defined(HOST_OS_LINUX)
+VM_UNIT_TEST_CASE(IOUringPollAndTimeout) {
+  IOUring ring;
+  if (!ring.Initialize(4)) {
+    // Older kernel or io_uring disabled; the event handler uses epoll.
+    return;
+  }
+  int fds[2];
+  EXPECT_EQ(0, pipe(fds));
+
+  const uint64_t kPoll = 1;
+  const uint64_t kTimer = 2;
+  const uint64_t kCancel = 3;
+  const int64_t start = TimerUtils::GetCurrentMonotonicMillis();
+  ring.PollAdd(fds[0], EPOLLIN, true, kPoll);
+  ring.TimeoutAdd(start + 10, kTimer);
+  // More requests than the submission queue holds.
+  for (intptr_t i = 0; i < 8; i++) {
+    ring.PollRemove(100 + i, kCancel);
+  }
+
+  bool timer_fired = false;
+  intptr_t polls = 0;
+  intptr_t cancels = 0;
+  while (polls < 2) {
+    ring.SubmitAndWait();
+    IOUringCqe* cqe;
+    while ((cqe = ring.PeekCompletion()) != NULL) {
+      if (cqe->user_data == kTimer) {
+        EXPECT_EQ(-ETIME, cqe->res);
+        EXPECT(TimerUtils::GetCurrentMonotonicMillis() >= start + 10);
+        timer_fired = true;
+        EXPECT_EQ(1, write(fds[1], "a", 1));
+      } else if (cqe->user_data == kPoll) {
+        EXPECT((cqe->res & EPOLLIN) != 0);
+        EXPECT((cqe->flags & IOUring::kCompletionMore) != 0);
+        polls++;
+        if (polls == 1) {
+          // A multishot poll is edge-triggered: it reports more data, not
+          // data that is still unread.
+          EXPECT_EQ(1, write(fds[1], "b", 1));
+        }
+      } else {
+        EXPECT_EQ(kCancel, cqe->user_data);
+        EXPECT_EQ(-ENOENT, cqe->res);
+        cancels++;
+      }
+      ring.ConsumeCompletion();
+    }
+  }
+  EXPECT(timer_fired);
+  EXPECT_EQ(8, cancels);
+  close(fds[0]);
+  close(fds[1]);
+}
+
+VM_UNIT_TEST_CASE(EpollModReportsReadiness) {
+  // Descriptors that stay registered with epoll rely on EPOLL_CTL_MOD
+  // reporting readiness that is already there, like EPOLL_CTL_ADD does.
+  int epoll_fd = epoll_create(1);
+  EXPECT(epoll_fd != -1);
+  int fds[2];
+  EXPECT_EQ(0, pipe(fds));
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+  event.data.fd = fds[0];
+  EXPECT_EQ(0, epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fds[0], &event));
+  EXPECT_EQ(1, write(fds[1], "a", 1));
+
+  struct epoll_event events[4];
+  EXPECT_EQ(1, epoll_wait(epoll_fd, events, 4, 0));
+  EXPECT((events[0].events & EPOLLIN) != 0);
+  // The edge was consumed.
+  EXPECT_EQ(0, epoll_wait(epoll_fd, events, 4, 0));
+  // Re-arming reports the unread data again.
+  EXPECT_EQ(0, epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fds[0], &event));
+  EXPECT_EQ(1, epoll_wait(epoll_fd, events, 4, 0));
+  EXPECT((events[0].events & EPOLLIN) != 0);
+
+  close(fds[0]);
+  close(fds[1]);
+  close(epoll_fd);
+}
+#endif  // defined(HOST_OS_LINUX)
+
+VM_UNIT_TEST_CASE(TimeoutQueue) {
+  // Compare the timer wheel against a plain array of timeouts, with timeouts
+  // spread over many levels and timeouts that have already passed.
+  const intptr_t kPorts = 200;
+  int64_t expected[kPorts];
+  for (intptr_t i = 0; i < kPorts; i++) {
+    expected[i] = -1;
+  }
+  TimeoutQueue queue;
+  uint64_t random = 42;
+  int64_t now = 1000;
+  for (intptr_t step = 0; step < 20000; step++) {
+    random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+    const intptr_t port = (random >> 33) % kPorts;
+    const intptr_t action = (random >> 20) % 4;
+    if (action == 0) {
+      queue.UpdateTimeout(port + 1, -1);
+      expected[port] = -1;
+    } else if ((action == 1) && queue.HasTimeout()) {
+      // Fire the next timeout, as the event handlers do.
+      const intptr_t fired = queue.CurrentPort() - 1;
+      EXPECT_EQ(expected[fired], queue.CurrentTimeout());
+      now = Utils::Maximum(now, queue.CurrentTimeout());
+      queue.RemoveCurrent();
+      expected[fired] = -1;
+    } else {
+      const int64_t delay = (random >> 40) % (1 << (((random >> 8) % 6) * 4));
+      const int64_t timeout = now + delay - 2;
+      queue.UpdateTimeout(port + 1, timeout);
+      expected[port] = timeout;
+    }
+    int64_t earliest = -1;
+    intptr_t count = 0;
+    for (intptr_t i = 0; i < kPorts; i++) {
+      if (expected[i] >= 0) {
+        count++;
+        if ((earliest < 0) || (expected[i] < earliest)) {
+          earliest = expected[i];
+        }
+      }
+    }
+    EXPECT_EQ(count, queue.size());
+    EXPECT_EQ(earliest >= 0, queue.HasTimeout());
+    if (queue.HasTimeout()) {
+      EXPECT_EQ(earliest, queue.CurrentTimeout());
+      EXPECT_EQ(earliest, expected[queue.CurrentPort() - 1]);
+    }
+  }
+}
+
 }  // namespace bin
 }  // namespace dart
@@ -677,6 +677,39 @@ intptr_t Handle::Write(const void* buffer, intptr_t num_bytes) {
   return truncated_bytes;
 }
 
+intptr_t Handle::WriteV(const WSABUF* buffers, intptr_t count) {
+  MonitorLocker ml(&monitor_);
+  if (HasPendingWrite()) {
+    return 0;
+  }
+  intptr_t num_bytes = 0;
+  for (intptr_t i = 0; i < count; i++) {
+    num_bytes += buffers[i].len;
+  }
+  if (num_bytes > kBufferSize) {
+    num_bytes = kBufferSize;
+  }
+  ASSERT(SupportsOverlappedIO());
+  if ((completion_port_ == INVALID_HANDLE_VALUE) || (num_bytes == 0)) {
+    return 0;
+  }
+  pending_write_ = OverlappedBuffer::AllocateWriteBuffer(num_bytes);
+  char* destination = pending_write_->GetBufferStart();
+  intptr_t remaining = num_bytes;
+  for (intptr_t i = 0; remaining > 0; i++) {
+    const intptr_t length =
+        Utils::Minimum(static_cast<intptr_t>(buffers[i].len), remaining);
+    memmove(destination, buffers[i].buf, length);
+    destination += length;
+    remaining -= length;
+  }
+  pending_write_->set_data_length(num_bytes);
+  if (!IssueWrite()) {
+    return -1;
+  }
+  return num_bytes;
+}
+
 intptr_t Handle::SendTo(const void* buffer,
                         intptr_t num_bytes,
                         struct sockaddr* sa,
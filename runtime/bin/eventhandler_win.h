@@ -178,6 +178,8 @@ class Handle : public ReferenceCounted<Handle>, public DescriptorInfoBase {
                     struct sockaddr* sa,
                     socklen_t addr_len);
   virtual intptr_t Write(const void* buffer, intptr_t num_bytes);
+  // Gathers the buffers into a single overlapped write.
+  intptr_t WriteV(const WSABUF* buffers, intptr_t count);
   virtual intptr_t SendTo(const void* buffer,
                           intptr_t num_bytes,
                           struct sockaddr* sa,
@@ -20,6 +20,8 @@
 #include <signal.h>
 #include <iostream>
 #include <limits>
+#include <thread>
+#include <vector>
 
 #include "include/dart_api.h"
 #include "include/dart_native_api.h"
@@ -292,6 +294,75 @@ DART_EXPORT Coord* CoordinateElemAt1(Coord* coord) {
   return retval;
 }
 
+// Transposes a Coordinate passed by value by (10, 10) and returns it by value.
+// Used for testing structs passed and returned in memory.
+DART_EXPORT Coord TransposeCoordinateByValue(Coord coord) {
+  std::cout << "TransposeCoordinateByValue({" << coord.x << ", " << coord.y
+            << ", " << coord.next << "})\n";
+  coord.x = coord.x + 10.0;
+  coord.y = coord.y + 10.0;
+  return coord;
+}
+
+struct Vector2 {
+  double x;
+  double y;
+};
+
+// Used for testing structs passed in floating point registers.
+DART_EXPORT double SumVector2(Vector2 v) {
+  std::cout << "SumVector2({" << v.x << ", " << v.y << "})\n";
+  return v.x + v.y;
+}
+
+// Used for testing structs returned in floating point registers.
+DART_EXPORT Vector2 ScaleVector2(Vector2 v, double factor) {
+  std::cout << "ScaleVector2({" << v.x << ", " << v.y << "}, " << factor
+            << ")\n";
+  Vector2 result = {v.x * factor, v.y * factor};
+  return result;
+}
+
+struct IntAndFloat {
+  int32_t a;
+  float b;
+};
+
+// Used for testing structs of mixed integer and floating point fields, which
+// are passed in integer registers.
+DART_EXPORT IntAndFloat IncrementIntAndFloat(IntAndFloat s) {
+  std::cout << "IncrementIntAndFloat({" << s.a << ", " << s.b << "})\n";
+  s.a = s.a + 1;
+  s.b = s.b + 1.0f;
+  return s;
+}
+
+struct ThreeBytes {
+  int8_t a;
+  int8_t b;
+  int8_t c;
+};
+
+// Used for testing structs whose size is not a power of two.
+DART_EXPORT ThreeBytes ReverseThreeBytes(ThreeBytes s) {
+  std::cout << "ReverseThreeBytes({" << static_cast<int>(s.a) << ", "
+            << static_cast<int>(s.b) << ", " << static_cast<int>(s.c)
+            << "})\n";
+  ThreeBytes result = {s.c, s.b, s.a};
+  return result;
+}
+
+// Used for testing many struct arguments, some of which are passed on the
+// stack.
+DART_EXPORT double SumManyVector2(Vector2 a,
+                                  Vector2 b,
+                                  Vector2 c,
+                                  Vector2 d,
+                                  Vector2 e,
+                                  Vector2 f) {
+  return a.x + a.y + b.x + b.y + c.x + c.y + d.x + d.y + e.x + e.y + f.x + f.y;
+}
+
 typedef Coord* (*CoordUnOp)(Coord* coord);
 
 // Takes a Coordinate Function(Coordinate) and applies it three times to a
@@ -667,6 +738,36 @@ struct CallbackTestData {
   void (*callback)();
 };
 
+struct AsyncCallbackRecord {
+  int64_t thread;
+  int64_t index;
+};
+
+// Posts |count| records to |queue| from each of |num_threads| threads.
+DART_EXPORT int TestPostAsyncCallbacks(Dart_AsyncCallbackQueue queue,
+                                       int64_t num_threads,
+                                       int64_t count) {
+  std::vector<std::thread> threads;
+  std::vector<int> failures(num_threads, 0);
+  for (int64_t thread = 0; thread < num_threads; thread++) {
+    threads.emplace_back([=, &failures]() {
+      for (int64_t index = 0; index < count; index++) {
+        AsyncCallbackRecord record = {thread, index};
+        if (!Dart_PostAsyncCallback(queue, &record)) {
+          failures[thread]++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int failed : failures) {
+    CHECK_EQ(failed, 0);
+  }
+  return 0;
+}
+
 #if defined(TARGET_OS_LINUX)
 
 thread_local sigjmp_buf buf;
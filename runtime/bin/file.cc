@@ -10,12 +10,14 @@
 #include "bin/dartutils.h"
 #include "bin/io_buffer.h"
 #include "bin/namespace.h"
+#include "bin/stdio.h"
 #include "bin/typed_data_utils.h"
 #include "bin/utils.h"
 #include "include/bin/dart_io_api.h"
 #include "include/dart_api.h"
 #include "include/dart_tools_api.h"
 #include "platform/globals.h"
+#include "platform/utils.h"
 
 namespace dart {
 namespace bin {
@@ -143,6 +145,10 @@ void FUNCTION_NAME(File_Close)(Dart_NativeArguments args) {
     Dart_SetIntegerReturnValue(args, -1);
     return;
   }
+  StdioWriter* writer = StdioWriter::ForFd(file->GetFD());
+  if (writer != NULL) {
+    writer->Flush();
+  }
   file->Close();
   file->DeleteWeakHandle(Dart_CurrentIsolate());
   file->Release();
@@ -282,7 +288,13 @@ void FUNCTION_NAME(File_WriteFrom)(Dart_NativeArguments args) {
 
   // Write all the data out into the file.
   char* byte_buffer = reinterpret_cast<char*>(buffer);
-  bool success = file->WriteFully(byte_buffer + start, length);
+  bool success = true;
+  StdioWriter* writer = StdioWriter::ForFd(file->GetFD());
+  if (writer != NULL) {
+    writer->Write(byte_buffer + start, length);
+  } else {
+    success = file->WriteFully(byte_buffer + start, length);
+  }
 
   // Release the direct pointer acquired above.
   ThrowIfError(Dart_TypedDataReleaseData(buffer_obj));
@@ -496,6 +508,55 @@ void FUNCTION_NAME(File_Lock)(Dart_NativeArguments args) {
   Dart_SetReturnValue(args, DartUtils::NewDartOSError(&os_error));
 }
 
+// Mappings start at a multiple of this, which is a multiple of both the page
+// size and the Windows allocation granularity.
+static const int64_t kMapAlignment = 64 * KB;
+
+static void UnmapFile(void* isolate_callback_data,
+                      Dart_WeakPersistentHandle handle,
+                      void* peer) {
+  delete reinterpret_cast<MappedMemory*>(peer);
+}
+
+void FUNCTION_NAME(File_Map)(Dart_NativeArguments args) {
+  File* file = GetFile(args);
+  ASSERT(file != NULL);
+  int64_t start;
+  int64_t end;
+  int64_t advice;
+  if (DartUtils::GetInt64Value(Dart_GetNativeArgument(args, 1), &start) &&
+      DartUtils::GetInt64Value(Dart_GetNativeArgument(args, 2), &end) &&
+      DartUtils::GetInt64Value(Dart_GetNativeArgument(args, 3), &advice)) {
+    int64_t position = Utils::RoundDown(start, kMapAlignment);
+    if ((start >= 0) && (end > start) && (end - position <= kIntptrMax) &&
+        (advice >= MappedMemory::kAdviceMin) &&
+        (advice <= MappedMemory::kAdviceMax)) {
+      MappedMemory* mapping =
+          file->Map(File::kReadWrite, position, end - position);
+      if (mapping == NULL) {
+        Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+        return;
+      }
+      mapping->Advise(static_cast<MappedMemory::Advice>(advice));
+      uint8_t* data =
+          reinterpret_cast<uint8_t*>(mapping->address()) + (start - position);
+      // The pages are backed by the file, so the OS can drop them under
+      // memory pressure. They are not reported as external allocation, which
+      // would make large mappings trigger old space GCs.
+      Dart_Handle result = Dart_NewExternalTypedDataWithFinalizer(
+          Dart_TypedData_kUint8, data, end - start, mapping, 0, UnmapFile);
+      if (Dart_IsError(result)) {
+        delete mapping;
+        Dart_PropagateError(result);
+      }
+      Dart_SetReturnValue(args, result);
+      return;
+    }
+  }
+  OSError os_error(-1, "Invalid argument", OSError::kUnknown);
+  Dart_SetReturnValue(args, DartUtils::NewDartOSError(&os_error));
+}
+
 void FUNCTION_NAME(File_Create)(Dart_NativeArguments args) {
   Namespace* namespc = Namespace::GetNamespace(args, 0);
   Dart_Handle path_handle = Dart_GetNativeArgument(args, 1);
@@ -1348,6 +1409,113 @@ CObject* File::WriteFromRequest(const CObjectArray& request) {
              : CObject::NewOSError();
 }
 
+CObject* File::ReadWholeRequest(const CObjectArray& request) {
+  if ((request.Length() < 1) || !request[0]->IsIntptr()) {
+    return CObject::IllegalArgumentError();
+  }
+  Namespace* namespc = CObjectToNamespacePointer(request[0]);
+  RefCntReleaseScope<Namespace> rs(namespc);
+  if ((request.Length() != 2) || !request[1]->IsUint8Array()) {
+    return CObject::IllegalArgumentError();
+  }
+  CObjectUint8Array filename(request[1]);
+  File* file = File::Open(
+      namespc, reinterpret_cast<const char*>(filename.Buffer()), File::kRead);
+  if (file == NULL) {
+    return CObject::NewOSError();
+  }
+  // Closes the file when the request is done.
+  RefCntReleaseScope<File> rs_file(file);
+  int64_t length = file->Length();
+  if (length < 0) {
+    return CObject::NewOSError();
+  }
+  // Files like character devices and those in /proc report a length of 0,
+  // and are read in chunks until the end instead.
+  const intptr_t kChunkSize = 64 * KB;
+  const bool chunked = length == 0;
+  if (length > kIntptrMax) {
+    return CObject::IllegalArgumentError();
+  }
+  intptr_t capacity = chunked ? kChunkSize : static_cast<intptr_t>(length);
+  uint8_t* data = IOBuffer::Allocate(capacity);
+  if (data == NULL) {
+    return CObject::NewOSError();
+  }
+  intptr_t bytes_read = 0;
+  while (true) {
+    if (bytes_read == capacity) {
+      if (!chunked) {
+        break;
+      }
+      capacity += kChunkSize;
+      uint8_t* new_data = IOBuffer::Reallocate(data, capacity);
+      if (new_data == NULL) {
+        IOBuffer::Free(data);
+        return CObject::NewOSError();
+      }
+      data = new_data;
+    }
+    const int64_t result =
+        file->Read(data + bytes_read, capacity - bytes_read);
+    if (result < 0) {
+      CObject* error = CObject::NewOSError();
+      IOBuffer::Free(data);
+      return error;
+    }
+    if (result == 0) {
+      break;
+    }
+    bytes_read += result;
+  }
+  CObjectExternalUint8Array* external_array =
+      new CObjectExternalUint8Array(CObject::NewExternalUint8Array(
+          capacity, data, data, IOBuffer::Finalizer));
+  external_array->SetLength(bytes_read);
+  CObjectArray* result = new CObjectArray(CObject::NewArray(2));
+  result->SetAt(0, new CObjectIntptr(CObject::NewInt32(0)));
+  result->SetAt(1, external_array);
+  return result;
+}
+
+CObject* File::WriteWholeRequest(const CObjectArray& request) {
+  if ((request.Length() < 1) || !request[0]->IsIntptr()) {
+    return CObject::IllegalArgumentError();
+  }
+  Namespace* namespc = CObjectToNamespacePointer(request[0]);
+  RefCntReleaseScope<Namespace> rs(namespc);
+  if ((request.Length() != 7) || !request[1]->IsUint8Array() ||
+      !request[2]->IsInt32() || !request[3]->IsTypedData() ||
+      !request[4]->IsInt32OrInt64() || !request[5]->IsInt32OrInt64() ||
+      !request[6]->IsBool()) {
+    return CObject::IllegalArgumentError();
+  }
+  CObjectUint8Array filename(request[1]);
+  CObjectInt32 mode(request[2]);
+  CObjectTypedData typed_data(request[3]);
+  const int64_t start = CObjectInt32OrInt64ToInt64(request[4]);
+  const int64_t end = CObjectInt32OrInt64ToInt64(request[5]);
+  CObjectBool flush(request[6]);
+  if ((SizeInBytes(typed_data.Type()) != 1) || (start < 0) || (end < start) ||
+      (end > typed_data.Length())) {
+    return CObject::IllegalArgumentError();
+  }
+  File::FileOpenMode file_mode = File::DartModeToFileMode(
+      static_cast<File::DartFileOpenMode>(mode.Value()));
+  File* file = File::Open(
+      namespc, reinterpret_cast<const char*>(filename.Buffer()), file_mode);
+  if (file == NULL) {
+    return CObject::NewOSError();
+  }
+  // Closes the file when the request is done.
+  RefCntReleaseScope<File> rs_file(file);
+  if (!file->WriteFully(typed_data.Buffer() + start, end - start) ||
+      (flush.Value() && !file->Flush())) {
+    return CObject::NewOSError();
+  }
+  return CObject::True();
+}
+
 CObject* File::CreateLinkRequest(const CObjectArray& request) {
   if ((request.Length() != 3) || !request[0]->IsIntptr()) {
     return CObject::IllegalArgumentError();
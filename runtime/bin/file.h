@@ -30,6 +30,20 @@ class MappedMemory {
   void* address() const { return address_; }
   intptr_t size() const { return size_; }
 
+  // These values have to be kept in sync with the constants of FileMapAccess
+  // in file.dart.
+  enum Advice {
+    kNormal = 0,
+    kSequential = 1,
+    kRandom = 2,
+    kAdviceMin = kNormal,
+    kAdviceMax = kRandom,
+  };
+
+  // Hints how the memory will be accessed. Does nothing where the platform
+  // has no such hints.
+  void Advise(Advice advice);
+
  private:
   void Unmap();
 
@@ -100,6 +114,8 @@ class File : public ReferenceCounted<File> {
   enum MapType {
     kReadOnly = 0,
     kReadExecute = 1,
+    // A private copy-on-write mapping. Writes are not written to the file.
+    kReadWrite = 2,
   };
   MappedMemory* Map(MapType type, int64_t position, int64_t length);
 
@@ -255,6 +271,8 @@ class File : public ReferenceCounted<File> {
   static CObject* ReadRequest(const CObjectArray& request);
   static CObject* ReadIntoRequest(const CObjectArray& request);
   static CObject* WriteFromRequest(const CObjectArray& request);
+  static CObject* ReadWholeRequest(const CObjectArray& request);
+  static CObject* WriteWholeRequest(const CObjectArray& request);
   static CObject* CreateLinkRequest(const CObjectArray& request);
   static CObject* DeleteLinkRequest(const CObjectArray& request);
   static CObject* RenameLinkRequest(const CObjectArray& request);
@@ -86,6 +86,9 @@ MappedMemory* File::Map(MapType type, int64_t position, int64_t length) {
     case kReadExecute:
       prot = PROT_READ | PROT_EXEC;
       break;
+    case kReadWrite:
+      prot = PROT_READ | PROT_WRITE;
+      break;
     default:
       return NULL;
   }
@@ -103,6 +106,22 @@ void MappedMemory::Unmap() {
   size_ = 0;
 }
 
+void MappedMemory::Advise(Advice advice) {
+  int hint = MADV_NORMAL;
+  switch (advice) {
+    case kSequential:
+      hint = MADV_SEQUENTIAL;
+      break;
+    case kRandom:
+      hint = MADV_RANDOM;
+      break;
+    default:
+      break;
+  }
+  // The hint only affects performance, so failures are ignored.
+  madvise(address_, size_, hint);
+}
+
 int64_t File::Read(void* buffer, int64_t num_bytes) {
   ASSERT(handle_->fd() >= 0);
   return TEMP_FAILURE_RETRY(read(handle_->fd(), buffer, num_bytes));
@@ -198,7 +217,7 @@ File* File::FileOpenW(const wchar_t* system_name, FileOpenMode mode) {
 }
 
 File* File::Open(Namespace* namespc, const char* name, FileOpenMode mode) {
-  NamespaceScope ns(namespc, name);
+  CachedNamespaceScope ns(namespc, name);
   // Report errors for non-regular files.
   struct stat64 st;
   if (TEMP_FAILURE_RETRY(fstatat64(ns.fd(), ns.path(), &st, 0)) == 0) {
@@ -251,7 +270,7 @@ File* File::OpenStdio(int fd) {
 }
 
 bool File::Exists(Namespace* namespc, const char* name) {
-  NamespaceScope ns(namespc, name);
+  CachedNamespaceScope ns(namespc, name);
   struct stat64 st;
   if (TEMP_FAILURE_RETRY(fstatat64(ns.fd(), ns.path(), &st, 0)) == 0) {
     // Everything but a directory and a link is a file to Dart.
@@ -296,7 +315,7 @@ bool File::CreateLink(Namespace* namespc,
 File::Type File::GetType(Namespace* namespc,
                          const char* name,
                          bool follow_links) {
-  NamespaceScope ns(namespc, name);
+  CachedNamespaceScope ns(namespc, name);
   struct stat64 entry_info;
   int stat_success;
   if (follow_links) {
@@ -351,8 +370,12 @@ bool File::Delete(Namespace* namespc, const char* name) {
 
 bool File::DeleteLink(Namespace* namespc, const char* name) {
   NamespaceScope ns(namespc, name);
-  return CheckTypeAndSetErrno(namespc, name, kIsLink, false) &&
-         (NO_RETRY_EXPECTED(unlinkat(ns.fd(), ns.path(), 0)) == 0);
+  const bool result =
+      CheckTypeAndSetErrno(namespc, name, kIsLink, false) &&
+      (NO_RETRY_EXPECTED(unlinkat(ns.fd(), ns.path(), 0)) == 0);
+  // Directories cached through the link must not be used anymore.
+  DirectoryCache::Invalidate(name);
+  return result;
 }
 
 bool File::Rename(Namespace* namespc,
@@ -370,9 +393,13 @@ bool File::RenameLink(Namespace* namespc,
                       const char* new_path) {
   NamespaceScope oldns(namespc, old_path);
   NamespaceScope newns(namespc, new_path);
-  return CheckTypeAndSetErrno(namespc, old_path, kIsLink, false) &&
-         (NO_RETRY_EXPECTED(renameat(oldns.fd(), oldns.path(), newns.fd(),
-                                     newns.path())) == 0);
+  const bool result =
+      CheckTypeAndSetErrno(namespc, old_path, kIsLink, false) &&
+      (NO_RETRY_EXPECTED(renameat(oldns.fd(), oldns.path(), newns.fd(),
+                                  newns.path())) == 0);
+  DirectoryCache::Invalidate(old_path);
+  DirectoryCache::Invalidate(new_path);
+  return result;
 }
 
 bool File::Copy(Namespace* namespc,
@@ -434,7 +461,7 @@ bool File::Copy(Namespace* namespc,
 static bool StatHelper(Namespace* namespc,
                        const char* name,
                        struct stat64* st) {
-  NamespaceScope ns(namespc, name);
+  CachedNamespaceScope ns(namespc, name);
   if (TEMP_FAILURE_RETRY(fstatat64(ns.fd(), ns.path(), st, 0)) != 0) {
     return false;
   }
@@ -467,7 +494,7 @@ static void MillisecondsToTimespec(int64_t millis, struct timespec* t) {
 }
 
 void File::Stat(Namespace* namespc, const char* name, int64_t* data) {
-  NamespaceScope ns(namespc, name);
+  CachedNamespaceScope ns(namespc, name);
   struct stat64 st;
   if (TEMP_FAILURE_RETRY(fstatat64(ns.fd(), ns.path(), &st, 0)) == 0) {
     if (S_ISREG(st.st_mode)) {
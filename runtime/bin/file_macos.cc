@@ -87,6 +87,9 @@ MappedMemory* File::Map(MapType type, int64_t position, int64_t length) {
     case kReadExecute:
       prot = PROT_READ | PROT_EXEC;
       break;
+    case kReadWrite:
+      prot = PROT_READ | PROT_WRITE;
+      break;
     default:
       return NULL;
   }
@@ -104,6 +107,22 @@ void MappedMemory::Unmap() {
   size_ = 0;
 }
 
+void MappedMemory::Advise(Advice advice) {
+  int hint = MADV_NORMAL;
+  switch (advice) {
+    case kSequential:
+      hint = MADV_SEQUENTIAL;
+      break;
+    case kRandom:
+      hint = MADV_RANDOM;
+      break;
+    default:
+      break;
+  }
+  // The hint only affects performance, so failures are ignored.
+  madvise(address_, size_, hint);
+}
+
 int64_t File::Read(void* buffer, int64_t num_bytes) {
   ASSERT(handle_->fd() >= 0);
   return TEMP_FAILURE_RETRY(read(handle_->fd(), buffer, num_bytes));
@@ -83,6 +83,7 @@ class _RandomAccessFileOpsImpl extends NativeFieldWrapperClass1
   length() native "File_Length";
   flush() native "File_Flush";
   lock(int lock, int start, int end) native "File_Lock";
+  map(int start, int end, int access) native "File_Map";
 }
 
 class _WatcherPath {
@@ -322,27 +323,77 @@ class _InotifyFileSystemWatcher extends _FileSystemWatcher {
   static final Map<int, StreamController> _idMap = {};
   static StreamSubscription _subscription;
 
+  // Events held back to be coalesced, as [pathId, event] pairs in the order
+  // they arrived, their keys, and the timer that delivers them.
+  static final List _pending = [];
+  static final Set<String> _pendingKeys = new Set<String>();
+  static Timer _coalesceTimer;
+
   _InotifyFileSystemWatcher(path, events, recursive)
       : super._(path, events, recursive);
 
   void _newWatcher() {
     int id = _FileSystemWatcher._id;
+    int window = _coalesceMilliseconds();
     _subscription =
         _FileSystemWatcher._listenOnSocket(id, id, 0).listen((event) {
-      if (_idMap.containsKey(event[0])) {
-        if (event[1] != null) {
-          _idMap[event[0]].add(event[1]);
-        } else {
-          _idMap[event[0]].close();
+      if (window == 0) {
+        _deliver(event);
+      } else if (event[1] == null) {
+        // Events that arrived before the watch ended are still delivered.
+        _deliverPending();
+        _deliver(event);
+      } else {
+        var key = _coalesceKey(event);
+        if (key == null || _pendingKeys.add(key)) {
+          _pending.add(event);
         }
+        _coalesceTimer ??=
+            new Timer(new Duration(milliseconds: window), _deliverPending);
       }
     });
   }
 
   void _doneWatcher() {
+    _coalesceTimer?.cancel();
+    _coalesceTimer = null;
+    _pending.clear();
+    _pendingKeys.clear();
     _subscription.cancel();
   }
 
+  static void _deliver(event) {
+    if (_idMap.containsKey(event[0])) {
+      if (event[1] != null) {
+        _idMap[event[0]].add(event[1]);
+      } else {
+        _idMap[event[0]].close();
+      }
+    }
+  }
+
+  static void _deliverPending() {
+    _coalesceTimer?.cancel();
+    _coalesceTimer = null;
+    var pending = _pending.toList();
+    _pending.clear();
+    _pendingKeys.clear();
+    pending.forEach(_deliver);
+  }
+
+  // Events with the same key are delivered once. Move events are not
+  // coalesced, as they pair up two paths.
+  static String _coalesceKey(event) {
+    FileSystemEvent fsEvent = event[1];
+    if (fsEvent.type == FileSystemEvent.move) return null;
+    var changed = fsEvent is FileSystemModifyEvent && fsEvent.contentChanged;
+    return "${event[0]} ${fsEvent.type} ${fsEvent.isDirectory} $changed "
+        "${fsEvent.path}";
+  }
+
+  static int _coalesceMilliseconds()
+      native "FileSystemWatcher_CoalesceMilliseconds";
+
   Stream _pathWatched() {
     var pathId = _watcherPath.pathId;
     if (!_idMap.containsKey(pathId)) {
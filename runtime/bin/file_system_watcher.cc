@@ -14,10 +14,17 @@
 namespace dart {
 namespace bin {
 
+int FileSystemWatcher::coalesce_milliseconds_ = 0;
+
 void FUNCTION_NAME(FileSystemWatcher_IsSupported)(Dart_NativeArguments args) {
   Dart_SetBooleanReturnValue(args, FileSystemWatcher::IsSupported());
 }
 
+void FUNCTION_NAME(FileSystemWatcher_CoalesceMilliseconds)(
+    Dart_NativeArguments args) {
+  Dart_SetIntegerReturnValue(args, FileSystemWatcher::coalesce_milliseconds());
+}
+
 void FUNCTION_NAME(FileSystemWatcher_InitWatcher)(Dart_NativeArguments args) {
   intptr_t id = FileSystemWatcher::Init();
   if (id >= 0) {
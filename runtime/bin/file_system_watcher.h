@@ -48,7 +48,16 @@ class FileSystemWatcher {
   static intptr_t GetSocketId(intptr_t id, intptr_t path_id);
   static Dart_Handle ReadEvents(intptr_t id, intptr_t path_id);
 
+  // Events for the same path and of the same kind that arrive within this
+  // many milliseconds of each other are delivered once. Only used on Linux.
+  static int coalesce_milliseconds() { return coalesce_milliseconds_; }
+  static void set_coalesce_milliseconds(int milliseconds) {
+    coalesce_milliseconds_ = milliseconds;
+  }
+
  private:
+  static int coalesce_milliseconds_;
+
   DISALLOW_COPY_AND_ASSIGN(FileSystemWatcher);
 };
 
@@ -7,17 +7,225 @@
 
 #include "bin/file_system_watcher.h"
 
+#include <dirent.h>       // NOLINT
 #include <errno.h>        // NOLINT
 #include <sys/inotify.h>  // NOLINT
+#include <sys/stat.h>     // NOLINT
 
 #include "bin/fdutils.h"
 #include "bin/file.h"
+#include "bin/lockers.h"
 #include "bin/socket.h"
+#include "bin/thread.h"
+#include "platform/hashmap.h"
 #include "platform/signal_blocker.h"
+#include "platform/utils.h"
 
 namespace dart {
 namespace bin {
 
+// A directory watched by an inotify instance, either directly through
+// WatchPath, or as part of the tree below a recursive watch, or both.
+struct InotifyWatch {
+  intptr_t id;
+  int wd;
+  // Whether the directory is watched through WatchPath, and if so whether
+  // recursively.
+  bool watched;
+  bool recursive;
+  // The recursive watch whose tree the directory is in, or -1. Its events
+  // are also reported for that watch, with the name made relative to it.
+  int root_wd;
+  // For recursive watches, the inotify events watched in the whole tree.
+  int mask;
+  char* path;
+  char* relative;
+};
+
+// inotify reports the same wd for every watch of a directory through one
+// instance, so the watches are tracked by instance and wd, for all isolates.
+class InotifyWatches {
+ public:
+  static InotifyWatch* Lookup(intptr_t id, int wd) {
+    InotifyWatch key;
+    key.id = id;
+    key.wd = wd;
+    SimpleHashMap::Entry* entry = map_->Lookup(&key, Hash(id, wd), false);
+    return entry != NULL ? reinterpret_cast<InotifyWatch*>(entry->value)
+                         : NULL;
+  }
+
+  // Takes ownership of the malloced 'path'.
+  static InotifyWatch* Add(intptr_t id, int wd, char* path) {
+    InotifyWatch* watch = new InotifyWatch();
+    watch->id = id;
+    watch->wd = wd;
+    watch->watched = false;
+    watch->recursive = false;
+    watch->root_wd = -1;
+    watch->mask = 0;
+    watch->path = path;
+    watch->relative = NULL;
+    SimpleHashMap::Entry* entry = map_->Lookup(watch, Hash(id, wd), true);
+    ASSERT(entry->value == NULL);
+    entry->value = watch;
+    return watch;
+  }
+
+  static void Remove(InotifyWatch* watch) {
+    map_->Remove(watch, Hash(watch->id, watch->wd));
+    free(watch->path);
+    free(watch->relative);
+    delete watch;
+  }
+
+  // Returns the watches of instance 'id' in the tree of 'root_wd' whose
+  // relative path is 'relative' or below it, or all of them if 'relative' is
+  // NULL. The caller frees the returned array.
+  static InotifyWatch** InTree(intptr_t id,
+                               int root_wd,
+                               const char* relative,
+                               intptr_t* count) {
+    InotifyWatch** result = reinterpret_cast<InotifyWatch**>(
+        malloc((map_->size() + 1) * sizeof(InotifyWatch*)));
+    const intptr_t length = relative != NULL ? strlen(relative) : 0;
+    *count = 0;
+    for (SimpleHashMap::Entry* entry = map_->Start(); entry != NULL;
+         entry = map_->Next(entry)) {
+      InotifyWatch* watch = reinterpret_cast<InotifyWatch*>(entry->value);
+      if ((watch->id != id) || (watch->root_wd != root_wd)) {
+        continue;
+      }
+      if ((relative == NULL) ||
+          ((strncmp(watch->relative, relative, length) == 0) &&
+           ((watch->relative[length] == '\0') ||
+            (watch->relative[length] == '/')))) {
+        result[(*count)++] = watch;
+      }
+    }
+    return result;
+  }
+
+  // Returns all the watches of instance 'id'. The caller frees the returned
+  // array.
+  static InotifyWatch** ForInstance(intptr_t id, intptr_t* count) {
+    InotifyWatch** result = reinterpret_cast<InotifyWatch**>(
+        malloc((map_->size() + 1) * sizeof(InotifyWatch*)));
+    *count = 0;
+    for (SimpleHashMap::Entry* entry = map_->Start(); entry != NULL;
+         entry = map_->Next(entry)) {
+      InotifyWatch* watch = reinterpret_cast<InotifyWatch*>(entry->value);
+      if (watch->id == id) {
+        result[(*count)++] = watch;
+      }
+    }
+    return result;
+  }
+
+  static Mutex* mutex() { return mutex_; }
+
+ private:
+  static uint32_t Hash(intptr_t id, int wd) {
+    return static_cast<uint32_t>(wd) ^ (static_cast<uint32_t>(id) << 16);
+  }
+
+  static bool SameWatch(void* a, void* b) {
+    InotifyWatch* watch_a = reinterpret_cast<InotifyWatch*>(a);
+    InotifyWatch* watch_b = reinterpret_cast<InotifyWatch*>(b);
+    return (watch_a->id == watch_b->id) && (watch_a->wd == watch_b->wd);
+  }
+
+  static SimpleHashMap* map_;
+  static Mutex* mutex_;
+
+  DISALLOW_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(InotifyWatches);
+};
+
+SimpleHashMap* InotifyWatches::map_ =
+    new SimpleHashMap(&InotifyWatches::SameWatch, 64);
+Mutex* InotifyWatches::mutex_ = new Mutex();
+
+static void WatchSubdirectories(InotifyWatch* root,
+                                const char* path,
+                                const char* relative);
+
+// Adds the directory at 'path' and the directories below it to the tree of
+// 'root'. Takes ownership of the malloced 'path' and 'relative'.
+static void WatchSubdirectory(InotifyWatch* root, char* path, char* relative) {
+  int wd = NO_RETRY_EXPECTED(inotify_add_watch(
+      root->id, path, root->mask | IN_ONLYDIR | IN_DONT_FOLLOW | IN_MASK_ADD));
+  InotifyWatch* watch =
+      wd >= 0 ? InotifyWatches::Lookup(root->id, wd) : NULL;
+  if ((wd < 0) || (watch == root) ||
+      ((watch != NULL) && (watch->root_wd != -1))) {
+    // The directory is gone, or already in a tree, e.g. through a link.
+    free(path);
+    free(relative);
+    return;
+  }
+  if (watch == NULL) {
+    watch = InotifyWatches::Add(root->id, wd, path);
+  } else {
+    free(path);
+  }
+  watch->root_wd = root->wd;
+  watch->relative = relative;
+  WatchSubdirectories(root, watch->path, watch->relative);
+}
+
+static void WatchSubdirectories(InotifyWatch* root,
+                                const char* path,
+                                const char* relative) {
+  DIR* dir = opendir(path);
+  if (dir == NULL) {
+    return;
+  }
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL) {
+    if ((strcmp(entry->d_name, ".") == 0) ||
+        (strcmp(entry->d_name, "..") == 0)) {
+      continue;
+    }
+    char* child = Utils::SCreate("%s/%s", path, entry->d_name);
+    bool is_dir = entry->d_type == DT_DIR;
+    if (entry->d_type == DT_UNKNOWN) {
+      struct stat st;
+      is_dir = (NO_RETRY_EXPECTED(lstat(child, &st)) == 0) &&
+               S_ISDIR(st.st_mode);
+    }
+    if (!is_dir) {
+      free(child);
+      continue;
+    }
+    WatchSubdirectory(
+        root, child,
+        relative != NULL ? Utils::SCreate("%s/%s", relative, entry->d_name)
+                         : strdup(entry->d_name));
+  }
+  closedir(dir);
+}
+
+// Removes the directories of 'root' from its tree whose relative path is
+// 'relative' or below it, or all of them if 'relative' is NULL.
+static void UnwatchSubdirectories(InotifyWatch* root, const char* relative) {
+  intptr_t count;
+  InotifyWatch** watches =
+      InotifyWatches::InTree(root->id, root->wd, relative, &count);
+  for (intptr_t i = 0; i < count; i++) {
+    InotifyWatch* watch = watches[i];
+    if (watch->watched) {
+      watch->root_wd = -1;
+      free(watch->relative);
+      watch->relative = NULL;
+    } else {
+      VOID_NO_RETRY_EXPECTED(inotify_rm_watch(watch->id, watch->wd));
+      InotifyWatches::Remove(watch);
+    }
+  }
+  free(watches);
+}
+
 bool FileSystemWatcher::IsSupported() {
   return true;
 }
@@ -35,7 +243,13 @@ intptr_t FileSystemWatcher::Init() {
 }
 
 void FileSystemWatcher::Close(intptr_t id) {
-  USE(id);
+  MutexLocker ml(InotifyWatches::mutex());
+  intptr_t count;
+  InotifyWatch** watches = InotifyWatches::ForInstance(id, &count);
+  for (intptr_t i = 0; i < count; i++) {
+    InotifyWatches::Remove(watches[i]);
+  }
+  free(watches);
 }
 
 intptr_t FileSystemWatcher::WatchPath(intptr_t id,
@@ -58,15 +272,45 @@ intptr_t FileSystemWatcher::WatchPath(intptr_t id,
   }
   const char* resolved_path = File::GetCanonicalPath(namespc, path);
   path = resolved_path != NULL ? resolved_path : path;
-  int path_id = NO_RETRY_EXPECTED(inotify_add_watch(id, path, list_events));
+  MutexLocker ml(InotifyWatches::mutex());
+  // The events of other watches of the same path are kept.
+  int path_id = NO_RETRY_EXPECTED(
+      inotify_add_watch(id, path, list_events | IN_MASK_ADD));
   if (path_id < 0) {
     return -1;
   }
+  InotifyWatch* watch = InotifyWatches::Lookup(id, path_id);
+  if (watch == NULL) {
+    watch = InotifyWatches::Add(id, path_id, strdup(path));
+  }
+  watch->watched = true;
+  if (recursive && !watch->recursive && File::GetType(namespc, path, true) ==
+                                            File::kIsDirectory) {
+    // New directories in the tree are watched as they are created or moved
+    // into it.
+    watch->recursive = true;
+    watch->mask = list_events | IN_CREATE | IN_MOVE;
+    WatchSubdirectories(watch, watch->path, NULL);
+  }
   return path_id;
 }
 
 void FileSystemWatcher::UnwatchPath(intptr_t id, intptr_t path_id) {
-  VOID_NO_RETRY_EXPECTED(inotify_rm_watch(id, path_id));
+  MutexLocker ml(InotifyWatches::mutex());
+  InotifyWatch* watch = InotifyWatches::Lookup(id, path_id);
+  if (watch == NULL) {
+    VOID_NO_RETRY_EXPECTED(inotify_rm_watch(id, path_id));
+    return;
+  }
+  if (watch->recursive) {
+    UnwatchSubdirectories(watch, NULL);
+  }
+  watch->watched = false;
+  watch->recursive = false;
+  if (watch->root_wd == -1) {
+    VOID_NO_RETRY_EXPECTED(inotify_rm_watch(id, path_id));
+    InotifyWatches::Remove(watch);
+  }
 }
 
 intptr_t FileSystemWatcher::GetSocketId(intptr_t id, intptr_t path_id) {
@@ -100,44 +344,110 @@ static int InotifyEventToMask(struct inotify_event* e) {
   return mask;
 }
 
+static Dart_Handle NewEvent(struct inotify_event* e,
+                            int wd,
+                            const char* name) {
+  Dart_Handle event = Dart_NewList(5);
+  int mask = InotifyEventToMask(e);
+  Dart_ListSetAt(event, 0, Dart_NewInteger(mask));
+  Dart_ListSetAt(event, 1, Dart_NewInteger(e->cookie));
+  if (name != NULL) {
+    Dart_Handle name_handle = Dart_NewStringFromUTF8(
+        reinterpret_cast<const uint8_t*>(name), strlen(name));
+    if (Dart_IsError(name_handle)) {
+      return name_handle;
+    }
+    Dart_ListSetAt(event, 2, name_handle);
+  } else {
+    Dart_ListSetAt(event, 2, Dart_Null());
+  }
+  Dart_ListSetAt(event, 3, Dart_NewBoolean(e->mask & IN_MOVED_TO));
+  Dart_ListSetAt(event, 4, Dart_NewInteger(wd));
+  return event;
+}
+
+// Keeps the tree of the recursive watch containing 'watch' up to date with
+// a directory created in or moved into or out of it.
+static void UpdateTree(InotifyWatch* watch, struct inotify_event* e) {
+  if (((e->mask & IN_ISDIR) == 0) || (e->len == 0)) {
+    return;
+  }
+  InotifyWatch* root = watch->recursive
+                           ? watch
+                           : (watch->root_wd != -1
+                                  ? InotifyWatches::Lookup(watch->id,
+                                                           watch->root_wd)
+                                  : NULL);
+  if (root == NULL) {
+    return;
+  }
+  char* relative = root == watch
+                       ? strdup(e->name)
+                       : Utils::SCreate("%s/%s", watch->relative, e->name);
+  if ((e->mask & IN_MOVED_FROM) != 0) {
+    UnwatchSubdirectories(root, relative);
+    free(relative);
+  } else if ((e->mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+    WatchSubdirectory(root, Utils::SCreate("%s/%s", watch->path, e->name),
+                      relative);
+  } else {
+    free(relative);
+  }
+}
+
 Dart_Handle FileSystemWatcher::ReadEvents(intptr_t id, intptr_t path_id) {
   USE(path_id);
   const intptr_t kEventSize = sizeof(struct inotify_event);
-  const intptr_t kBufferSize = kEventSize + NAME_MAX + 1;
+  const intptr_t kBufferSize = 16 * (kEventSize + NAME_MAX + 1);
   uint8_t buffer[kBufferSize];
   intptr_t bytes =
       SocketBase::Read(id, buffer, kBufferSize, SocketBase::kAsync);
   if (bytes < 0) {
     return DartUtils::NewDartOSError();
   }
-  const intptr_t kMaxCount = bytes / kEventSize;
+  // An event in a directory below a recursive watch that is also watched
+  // directly is reported for both watches.
+  const intptr_t kMaxCount = 2 * (bytes / kEventSize);
   Dart_Handle events = Dart_NewList(kMaxCount);
+  MutexLocker ml(InotifyWatches::mutex());
   intptr_t offset = 0;
   intptr_t i = 0;
   while (offset < bytes) {
     struct inotify_event* e =
         reinterpret_cast<struct inotify_event*>(buffer + offset);
-    if ((e->mask & IN_IGNORED) == 0) {
-      Dart_Handle event = Dart_NewList(5);
-      int mask = InotifyEventToMask(e);
-      Dart_ListSetAt(event, 0, Dart_NewInteger(mask));
-      Dart_ListSetAt(event, 1, Dart_NewInteger(e->cookie));
-      if (e->len > 0) {
-        Dart_Handle name = Dart_NewStringFromUTF8(
-            reinterpret_cast<uint8_t*>(e->name), strlen(e->name));
-        if (Dart_IsError(name)) {
-          return name;
-        }
-        Dart_ListSetAt(event, 2, name);
-      } else {
-        Dart_ListSetAt(event, 2, Dart_Null());
+    offset += kEventSize + e->len;
+    InotifyWatch* watch = InotifyWatches::Lookup(id, e->wd);
+    if ((e->mask & IN_IGNORED) != 0) {
+      if ((watch != NULL) && !watch->watched) {
+        InotifyWatches::Remove(watch);
       }
-      Dart_ListSetAt(event, 3, Dart_NewBoolean(e->mask & IN_MOVED_TO));
-      Dart_ListSetAt(event, 4, Dart_NewInteger(e->wd));
-      Dart_ListSetAt(events, i, event);
-      i++;
+      continue;
+    }
+    if (watch != NULL) {
+      UpdateTree(watch, e);
+    }
+    const char* name = e->len > 0 ? e->name : NULL;
+    if ((watch == NULL) || watch->watched) {
+      Dart_Handle event = NewEvent(e, e->wd, name);
+      if (Dart_IsError(event)) {
+        return event;
+      }
+      Dart_ListSetAt(events, i++, event);
+    }
+    // A directory in the tree being deleted or moved is reported by its
+    // parent, and does not end the recursive watch.
+    if ((watch != NULL) && (watch->root_wd != -1) &&
+        ((e->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) == 0)) {
+      char* relative =
+          name != NULL ? Utils::SCreate("%s/%s", watch->relative, name)
+                       : strdup(watch->relative);
+      Dart_Handle event = NewEvent(e, watch->root_wd, relative);
+      free(relative);
+      if (Dart_IsError(event)) {
+        return event;
+      }
+      Dart_ListSetAt(events, i++, event);
     }
-    offset += kEventSize + e->len;
   }
   ASSERT(offset == bytes);
   return events;
@@ -85,6 +85,10 @@ MappedMemory* File::Map(File::MapType type, int64_t position, int64_t length) {
       prot_alloc = PAGE_EXECUTE_READWRITE;
       prot_final = PAGE_EXECUTE_READ;
       break;
+    case File::kReadWrite:
+      prot_alloc = PAGE_READWRITE;
+      prot_final = PAGE_READWRITE;
+      break;
     default:
       return NULL;
   }
@@ -95,8 +99,13 @@ MappedMemory* File::Map(File::MapType type, int64_t position, int64_t length) {
     return NULL;
   }
 
+  // The memory is read from the file up front, so restore the position the
+  // read moves.
+  int64_t old_position = Position();
   SetPosition(position);
-  if (!ReadFully(addr, length)) {
+  bool read = ReadFully(addr, length);
+  SetPosition(old_position);
+  if (!read) {
     Syslog::PrintErr("ReadFully failed %d\n", GetLastError());
     VirtualFree(addr, 0, MEM_RELEASE);
     return NULL;
@@ -119,6 +128,10 @@ void MappedMemory::Unmap() {
   size_ = 0;
 }
 
+void MappedMemory::Advise(Advice advice) {
+  // The memory was read from the file when it was mapped.
+}
+
 int64_t File::Read(void* buffer, int64_t num_bytes) {
   ASSERT(handle_->fd() >= 0);
   return read(handle_->fd(), buffer, num_bytes);
@@ -255,6 +255,98 @@ void FUNCTION_NAME(Filter_Processed)(Dart_NativeArguments args) {
   }
 }
 
+void FUNCTION_NAME(Filter_ProcessInto)(Dart_NativeArguments args) {
+  Dart_Handle filter_obj = Dart_GetNativeArgument(args, 0);
+  Dart_Handle input_obj = Dart_GetNativeArgument(args, 1);
+  intptr_t input_start =
+      DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 2));
+  intptr_t input_end =
+      DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 3));
+  Dart_Handle output_obj = Dart_GetNativeArgument(args, 4);
+  intptr_t output_start =
+      DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 5));
+  intptr_t output_end =
+      DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 6));
+  bool flush = DartUtils::GetBooleanValue(Dart_GetNativeArgument(args, 7));
+  bool end = DartUtils::GetBooleanValue(Dart_GetNativeArgument(args, 8));
+
+  Filter* filter = NULL;
+  Dart_Handle err = GetFilter(filter_obj, &filter);
+  if (Dart_IsError(err)) {
+    Dart_PropagateError(err);
+  }
+  if (filter->processing()) {
+    Dart_ThrowException(DartUtils::NewInternalError(
+        "Call to processInto while still processing data"));
+  }
+
+  // Both lists are Uint8Lists whose ranges were checked by the caller. They
+  // stay acquired while zlib works on them, so nothing is copied.
+  Dart_TypedData_Type type;
+  uint8_t* input = NULL;
+  intptr_t input_length;
+  err = Dart_TypedDataAcquireData(
+      input_obj, &type, reinterpret_cast<void**>(&input), &input_length);
+  if (Dart_IsError(err)) {
+    Dart_PropagateError(err);
+  }
+  ASSERT(input_end <= input_length);
+  uint8_t* output = NULL;
+  intptr_t output_length;
+  err = Dart_TypedDataAcquireData(
+      output_obj, &type, reinterpret_cast<void**>(&output), &output_length);
+  if (Dart_IsError(err)) {
+    Dart_TypedDataReleaseData(input_obj);
+    Dart_PropagateError(err);
+  }
+  ASSERT(output_end <= output_length);
+
+  intptr_t consumed = 0;
+  intptr_t written = filter->ProcessInto(
+      input + input_start, input_end - input_start, &consumed,
+      output + output_start, output_end - output_start, flush, end);
+  Dart_TypedDataReleaseData(output_obj);
+  Dart_TypedDataReleaseData(input_obj);
+  if (written < 0) {
+    Dart_ThrowException(DartUtils::NewInternalError("Filter error, bad data"));
+  }
+  filter->set_consumed(consumed);
+  Dart_SetIntegerReturnValue(args, written);
+}
+
+void FUNCTION_NAME(Filter_GetConsumed)(Dart_NativeArguments args) {
+  Filter* filter = NULL;
+  Dart_Handle err = GetFilter(Dart_GetNativeArgument(args, 0), &filter);
+  if (Dart_IsError(err)) {
+    Dart_PropagateError(err);
+  }
+  Dart_SetIntegerReturnValue(args, filter->consumed());
+}
+
+void FUNCTION_NAME(Filter_Reset)(Dart_NativeArguments args) {
+  Dart_Handle level_obj = Dart_GetNativeArgument(args, 1);
+  Dart_Handle strategy_obj = Dart_GetNativeArgument(args, 2);
+
+  Filter* filter = NULL;
+  Dart_Handle err = GetFilter(Dart_GetNativeArgument(args, 0), &filter);
+  if (Dart_IsError(err)) {
+    Dart_PropagateError(err);
+  }
+  if (!filter->Reset()) {
+    Dart_ThrowException(DartUtils::NewInternalError("Failed to reset filter"));
+  }
+  if (!Dart_IsNull(level_obj)) {
+    int64_t level =
+        DartUtils::GetInt64ValueCheckRange(level_obj, kMinInt32, kMaxInt32);
+    int64_t strategy = DartUtils::GetIntegerValue(strategy_obj);
+    if (!filter->SetParameters(static_cast<int32_t>(level),
+                               static_cast<int32_t>(strategy))) {
+      Dart_ThrowException(
+          DartUtils::NewInternalError("Failed to set filter parameters"));
+    }
+  }
+}
+
 static void DeleteFilter(void* isolate_data,
                          Dart_WeakPersistentHandle handle,
                          void* filter_pointer) {
@@ -317,18 +409,43 @@ bool ZLibDeflateFilter::Init() {
   if (result != Z_OK) {
     return false;
   }
-  if ((dictionary_ != NULL) && !gzip_ && !raw_) {
-    result = deflateSetDictionary(&stream_, dictionary_, dictionary_length_);
-    delete[] dictionary_;
-    dictionary_ = NULL;
-    if (result != Z_OK) {
-      return false;
-    }
+  if (!SetDictionary()) {
+    return false;
   }
   set_initialized(true);
   return true;
 }
 
+bool ZLibDeflateFilter::SetDictionary() {
+  // The dictionary is kept, as every stream after a Reset needs it again.
+  if ((dictionary_ != NULL) && !gzip_ && !raw_) {
+    return deflateSetDictionary(&stream_, dictionary_, dictionary_length_) ==
+           Z_OK;
+  }
+  return true;
+}
+
+bool ZLibDeflateFilter::Reset() {
+  delete[] current_buffer_;
+  current_buffer_ = NULL;
+  stream_.next_in = Z_NULL;
+  stream_.avail_in = 0;
+  return (deflateReset(&stream_) == Z_OK) && SetDictionary();
+}
+
+bool ZLibDeflateFilter::SetParameters(int32_t level, int32_t strategy) {
+  if ((level == level_) && (strategy == strategy_)) {
+    return true;
+  }
+  // deflateParams may flush pending output of the previous stream, so start
+  // over with a new stream instead.
+  deflateEnd(&stream_);
+  set_initialized(false);
+  level_ = level;
+  strategy_ = strategy;
+  return Init();
+}
+
 bool ZLibDeflateFilter::Process(uint8_t* data, intptr_t length) {
   if (current_buffer_ != NULL) {
     return false;
@@ -368,6 +485,31 @@ intptr_t ZLibDeflateFilter::Processed(uint8_t* buffer,
   return error ? -1 : 0;
 }
 
+intptr_t ZLibDeflateFilter::ProcessInto(uint8_t* input,
+                                        intptr_t input_length,
+                                        intptr_t* consumed,
+                                        uint8_t* output,
+                                        intptr_t output_length,
+                                        bool flush,
+                                        bool end) {
+  ASSERT(current_buffer_ == NULL);
+  stream_.avail_in = input_length;
+  stream_.next_in = input;
+  stream_.avail_out = output_length;
+  stream_.next_out = output;
+  int result =
+      deflate(&stream_, end ? Z_FINISH : flush ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+  *consumed = input_length - stream_.avail_in;
+  // Do not keep pointers into the caller's buffers.
+  stream_.next_in = Z_NULL;
+  stream_.avail_in = 0;
+  stream_.next_out = Z_NULL;
+  if ((result != Z_OK) && (result != Z_STREAM_END) && (result != Z_BUF_ERROR)) {
+    return -1;
+  }
+  return output_length - stream_.avail_out;
+}
+
 ZLibInflateFilter::~ZLibInflateFilter() {
   delete[] dictionary_;
   delete[] current_buffer_;
@@ -423,15 +565,7 @@ intptr_t ZLibInflateFilter::Processed(uint8_t* buffer,
     }
 
     case Z_NEED_DICT:
-      if (dictionary_ == NULL) {
-        error = true;
-      } else {
-        int result =
-            inflateSetDictionary(&stream_, dictionary_, dictionary_length_);
-        delete[] dictionary_;
-        dictionary_ = NULL;
-        error = result != Z_OK;
-      }
+      error = !SetDictionary();
       if (error) {
         break;
       } else {
@@ -451,5 +585,51 @@ intptr_t ZLibInflateFilter::Processed(uint8_t* buffer,
   return error ? -1 : 0;
 }
 
+bool ZLibInflateFilter::SetDictionary() {
+  // The dictionary is kept, as every stream after a Reset needs it again.
+  if (dictionary_ == NULL) {
+    return false;
+  }
+  return inflateSetDictionary(&stream_, dictionary_, dictionary_length_) ==
+         Z_OK;
+}
+
+bool ZLibInflateFilter::Reset() {
+  delete[] current_buffer_;
+  current_buffer_ = NULL;
+  stream_.next_in = Z_NULL;
+  stream_.avail_in = 0;
+  return inflateReset(&stream_) == Z_OK;
+}
+
+intptr_t ZLibInflateFilter::ProcessInto(uint8_t* input,
+                                        intptr_t input_length,
+                                        intptr_t* consumed,
+                                        uint8_t* output,
+                                        intptr_t output_length,
+                                        bool flush,
+                                        bool end) {
+  ASSERT(current_buffer_ == NULL);
+  stream_.avail_in = input_length;
+  stream_.next_in = input;
+  stream_.avail_out = output_length;
+  stream_.next_out = output;
+  int result =
+      inflate(&stream_, end ? Z_FINISH : flush ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+  if ((result == Z_NEED_DICT) && SetDictionary()) {
+    result =
+        inflate(&stream_, end ? Z_FINISH : flush ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+  }
+  *consumed = input_length - stream_.avail_in;
+  // Do not keep pointers into the caller's buffers.
+  stream_.next_in = Z_NULL;
+  stream_.avail_in = 0;
+  stream_.next_out = Z_NULL;
+  if ((result != Z_OK) && (result != Z_STREAM_END) && (result != Z_BUF_ERROR)) {
+    return -1;
+  }
+  return output_length - stream_.avail_out;
+}
+
 }  // namespace bin
 }  // namespace dart
@@ -30,6 +30,29 @@ class Filter {
                              bool finish,
                              bool end) = 0;
 
+  /**
+   * Processes input directly into output, without taking ownership of
+   * either. Returns the number of bytes written to output, or -1 on error, and
+   * sets consumed to the number of input bytes used. Must not be called while
+   * data passed to Process is still being processed.
+   */
+  virtual intptr_t ProcessInto(uint8_t* input,
+                               intptr_t input_length,
+                               intptr_t* consumed,
+                               uint8_t* output,
+                               intptr_t output_length,
+                               bool flush,
+                               bool end) = 0;
+
+  // Discards all state to start a new stream with the same options.
+  virtual bool Reset() = 0;
+
+  // Changes the compression level and strategy. Only supported by deflate
+  // filters, and only right after a Reset.
+  virtual bool SetParameters(int32_t level, int32_t strategy) { return false; }
+
+  virtual bool processing() const = 0;
+
   static Dart_Handle SetFilterAndCreateFinalizer(Dart_Handle filter,
                                                  Filter* filter_pointer,
                                                  intptr_t filter_size);
@@ -40,14 +63,17 @@ class Filter {
   void set_initialized(bool value) { initialized_ = value; }
   uint8_t* processed_buffer() { return processed_buffer_; }
   intptr_t processed_buffer_size() const { return kFilterBufferSize; }
+  intptr_t consumed() const { return consumed_; }
+  void set_consumed(intptr_t value) { consumed_ = value; }
 
  protected:
-  Filter() : initialized_(false) {}
+  Filter() : initialized_(false), consumed_(0) {}
 
  private:
   static const intptr_t kFilterBufferSize = 64 * KB;
   uint8_t processed_buffer_[kFilterBufferSize];
   bool initialized_;
+  intptr_t consumed_;
 
   DISALLOW_COPY_AND_ASSIGN(Filter);
 };
@@ -79,13 +105,25 @@ class ZLibDeflateFilter : public Filter {
                              intptr_t length,
                              bool finish,
                              bool end);
+  virtual intptr_t ProcessInto(uint8_t* input,
+                               intptr_t input_length,
+                               intptr_t* consumed,
+                               uint8_t* output,
+                               intptr_t output_length,
+                               bool flush,
+                               bool end);
+  virtual bool Reset();
+  virtual bool processing() const { return current_buffer_ != NULL; }
+  virtual bool SetParameters(int32_t level, int32_t strategy);
 
  private:
+  bool SetDictionary();
+
   const bool gzip_;
-  const int32_t level_;
+  int32_t level_;
   const int32_t window_bits_;
   const int32_t mem_level_;
-  const int32_t strategy_;
+  int32_t strategy_;
   uint8_t* dictionary_;
   const intptr_t dictionary_length_;
   const bool raw_;
@@ -114,8 +152,19 @@ class ZLibInflateFilter : public Filter {
                              intptr_t length,
                              bool finish,
                              bool end);
+  virtual intptr_t ProcessInto(uint8_t* input,
+                               intptr_t input_length,
+                               intptr_t* consumed,
+                               uint8_t* output,
+                               intptr_t output_length,
+                               bool flush,
+                               bool end);
+  virtual bool Reset();
+  virtual bool processing() const { return current_buffer_ != NULL; }
 
  private:
+  bool SetDictionary();
+
   const int32_t window_bits_;
   uint8_t* dictionary_;
   const intptr_t dictionary_length_;
@@ -9,6 +9,32 @@ class _FilterImpl extends NativeFieldWrapperClass1 implements RawZLibFilter {
 
   List<int> processed({bool flush: true, bool end: false})
       native "Filter_Processed";
+
+  int processInto(Uint8List input, int inputStart, int inputEnd,
+      Uint8List output, int outputStart, int outputEnd,
+      {bool flush: true, bool end: false}) {
+    inputEnd = RangeError.checkValidRange(
+        inputStart, inputEnd, input.length, "inputStart", "inputEnd");
+    outputEnd = RangeError.checkValidRange(
+        outputStart, outputEnd, output.length, "outputStart", "outputEnd");
+    return _processInto(input, inputStart, inputEnd, output, outputStart,
+        outputEnd, flush, end);
+  }
+
+  int _processInto(Uint8List input, int inputStart, int inputEnd,
+      Uint8List output, int outputStart, int outputEnd, bool flush, bool end)
+      native "Filter_ProcessInto";
+
+  int get consumed native "Filter_GetConsumed";
+
+  void reset({int level, int strategy}) {
+    if (level != null || strategy != null) {
+      throw new UnsupportedError("Inflate filters have no level or strategy");
+    }
+    _reset(null, null);
+  }
+
+  void _reset(int level, int strategy) native "Filter_Reset";
 }
 
 class _ZLibInflateFilter extends _FilterImpl {
@@ -20,12 +46,27 @@ class _ZLibInflateFilter extends _FilterImpl {
 }
 
 class _ZLibDeflateFilter extends _FilterImpl {
+  int _level;
+  int _strategy;
+
   _ZLibDeflateFilter(bool gzip, int level, int windowBits, int memLevel,
-      int strategy, List<int> dictionary, bool raw) {
+      int strategy, List<int> dictionary, bool raw)
+      : _level = level,
+        _strategy = strategy {
     _init(gzip, level, windowBits, memLevel, strategy, dictionary, raw);
   }
   void _init(bool gzip, int level, int windowBits, int memLevel, int strategy,
       List<int> dictionary, bool raw) native "Filter_CreateZLibDeflate";
+
+  void reset({int level, int strategy}) {
+    level ??= _level;
+    strategy ??= _strategy;
+    _validateZLibeLevel(level);
+    _validateZLibStrategy(strategy);
+    _reset(level, strategy);
+    _level = level;
+    _strategy = strategy;
+  }
 }
 
 @patch
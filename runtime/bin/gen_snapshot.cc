@@ -126,6 +126,7 @@ static const char* kSnapshotKindNames[] = {
 
 #define BOOL_OPTIONS_LIST(V)                                                   \
   V(compile_all, compile_all)                                                  \
+  V(compress_data, compress_data)                                              \
   V(help, help)                                                                \
   V(obfuscate, obfuscate)                                                      \
   V(read_all_bytecode, read_all_bytecode)                                      \
@@ -204,6 +205,20 @@ static void PrintUsage() {
 "using --save-obfuscation-map=<filename> option. See dartbug.com/30524       \n"
 "for implementation details and limitations of the obfuscation pass.         \n"
 "                                                                            \n"
+"AOT snapshots can be compiled with type feedback saved by a training run    \n"
+"(see Dart_SaveTypeFeedback) using --load_type_feedback=<filename>. The      \n"
+"receiver classes and call counts seen in training guide devirtualization    \n"
+"and inlining.                                                               \n"
+"                                                                            \n"
+"AOT snapshots written to a single file with --blobs_container_filename can  \n"
+"have their data sections compressed with --compress_data. They are then     \n"
+"decompressed into memory when loaded instead of being mapped.               \n"
+"                                                                            \n"
+"The code of AOT snapshots can be ordered with --code_order_file=<filename>, \n"
+"a file listing one function per line, hottest first, using the names        \n"
+"printed by --print_instructions_sizes_to. Listed functions are placed       \n"
+"first and in this order, so the hot code of an application shares pages.   \n"
+"                                                                            \n"
 "\n");
   if (verbose) {
     Syslog::PrintErr(
@@ -450,7 +465,8 @@ static void MaybeLoadCode() {
   }
 
   if ((load_type_feedback_filename != NULL) &&
-      ((snapshot_kind == kCoreJIT) || (snapshot_kind == kAppJIT))) {
+      ((snapshot_kind == kCoreJIT) || (snapshot_kind == kAppJIT) ||
+       IsSnapshottingForPrecompilation())) {
     uint8_t* buffer = NULL;
     intptr_t size = 0;
     ReadFile(load_type_feedback_filename, &buffer, &size);
@@ -702,7 +718,7 @@ static void CreateAndWritePrecompiledSnapshot() {
           vm_snapshot_data_size, vm_snapshot_instructions_buffer,
           vm_snapshot_instructions_size, isolate_snapshot_data_buffer,
           isolate_snapshot_data_size, isolate_snapshot_instructions_buffer,
-          isolate_snapshot_instructions_size);
+          isolate_snapshot_instructions_size, compress_data);
     } else {
       WriteFile(vm_snapshot_data_filename, vm_snapshot_data_buffer,
                 vm_snapshot_data_size);
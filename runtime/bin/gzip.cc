@@ -6,11 +6,28 @@
 
 #include "platform/assert.h"
 #include "platform/globals.h"
+#include "platform/utils.h"
 #include "zlib/zlib.h"
 
 namespace dart {
 namespace bin {
 
+intptr_t GzipUncompressedLength(const uint8_t* input, intptr_t input_len) {
+  // A member ends with the CRC-32 and the length modulo 2^32 of its data,
+  // both little endian, after at least a 10 byte header.
+  const intptr_t kHeaderSize = 10;
+  const intptr_t kTrailerSize = 8;
+  if ((input_len < kHeaderSize + kTrailerSize) || (input[0] != 0x1f) ||
+      (input[1] != 0x8b)) {
+    return -1;
+  }
+  const uint8_t* size = &input[input_len - 4];
+  return static_cast<intptr_t>(size[0]) |
+         (static_cast<intptr_t>(size[1]) << 8) |
+         (static_cast<intptr_t>(size[2]) << 16) |
+         (static_cast<intptr_t>(size[3]) << 24);
+}
+
 void Decompress(const uint8_t* input,
                 intptr_t input_len,
                 uint8_t** output,
@@ -22,14 +39,17 @@ void Decompress(const uint8_t* input,
 
   const intptr_t kChunkSize = 256 * 1024;
 
-  // Initialize output.
-  intptr_t output_capacity = input_len * 2;
-  if (output_capacity < kChunkSize) {
-    output_capacity = kChunkSize;
+  // Inflate straight into the output. The length in the gzip trailer is
+  // exact for the single member streams gzip writes, so the output is
+  // usually allocated once. The extra byte lets inflate read the trailer
+  // without a full buffer; otherwise the buffer grows as it fills.
+  intptr_t output_capacity = GzipUncompressedLength(input, input_len);
+  if (output_capacity < 0) {
+    output_capacity = Utils::Maximum(input_len * 2, kChunkSize);
   }
+  output_capacity += 1;
   *output = reinterpret_cast<uint8_t*>(malloc(output_capacity));
 
-  uint8_t chunk_out[kChunkSize];
   z_stream strm;
   strm.zalloc = Z_NULL;
   strm.zfree = Z_NULL;
@@ -42,45 +62,90 @@ void Decompress(const uint8_t* input,
   intptr_t input_cursor = 0;
   intptr_t output_cursor = 0;
   do {
-    // Setup input.
-    intptr_t size_in = input_len - input_cursor;
-    if (size_in > kChunkSize) {
-      size_in = kChunkSize;
+    if ((strm.avail_in == 0) && (input_cursor < input_len)) {
+      const intptr_t size_in = Utils::Minimum(input_len - input_cursor,
+                                              static_cast<intptr_t>(kMaxInt32));
+      strm.avail_in = size_in;
+      strm.next_in = const_cast<uint8_t*>(&input[input_cursor]);
+      input_cursor += size_in;
+    }
+    if (output_cursor == output_capacity) {
+      output_capacity *= 2;
+      *output = reinterpret_cast<uint8_t*>(realloc(*output, output_capacity));
     }
-    strm.avail_in = size_in;
-    strm.next_in = const_cast<uint8_t*>(&input[input_cursor]);
-
-    // Inflate until we've exhausted the current input chunk.
-    do {
-      // Setup output.
-      strm.avail_out = kChunkSize;
-      strm.next_out = &chunk_out[0];
-      // Inflate.
-      ret = inflate(&strm, Z_SYNC_FLUSH);
-      // We either hit the end of the stream or made forward progress.
-      ASSERT((ret == Z_STREAM_END) || (ret == Z_OK));
-      // Grow output buffer size.
-      intptr_t size_out = kChunkSize - strm.avail_out;
-      if (size_out > (output_capacity - output_cursor)) {
-        output_capacity *= 2;
-        ASSERT(size_out <= (output_capacity - output_cursor));
-        *output = reinterpret_cast<uint8_t*>(realloc(*output, output_capacity));
-      }
-      // Copy output.
-      memmove(&((*output)[output_cursor]), &chunk_out[0], size_out);
-      output_cursor += size_out;
-    } while (strm.avail_out == 0);
-
-    // We've processed size_in bytes.
-    input_cursor += size_in;
-
-    // We're finished decompressing when zlib tells us.
-  } while (ret != Z_STREAM_END);
+    const intptr_t size_out =
+        Utils::Minimum(output_capacity - output_cursor,
+                       static_cast<intptr_t>(kMaxInt32));
+    strm.avail_out = size_out;
+    strm.next_out = &((*output)[output_cursor]);
+    ret = inflate(&strm, Z_NO_FLUSH);
+    output_cursor += size_out - strm.avail_out;
+    // Z_BUF_ERROR only means no progress was possible; it is an error once
+    // the input is used up.
+    if ((ret == Z_BUF_ERROR) && (strm.avail_in == 0) &&
+        (input_cursor == input_len)) {
+      break;
+    }
+    ASSERT((ret == Z_STREAM_END) || (ret == Z_OK) || (ret == Z_BUF_ERROR));
+  } while ((ret == Z_OK) || (ret == Z_BUF_ERROR));
 
   inflateEnd(&strm);
 
   *output_length = output_cursor;
 }
 
+void Compress(const uint8_t* input,
+              intptr_t input_len,
+              uint8_t** output,
+              intptr_t* output_length) {
+  ASSERT(input != NULL);
+  ASSERT(output != NULL);
+  ASSERT(output_length != NULL);
+
+  z_stream strm;
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+  int ret = deflateInit(&strm, Z_BEST_SPEED);
+  ASSERT(ret == Z_OK);
+
+  const intptr_t output_capacity = deflateBound(&strm, input_len);
+  *output = reinterpret_cast<uint8_t*>(malloc(output_capacity));
+  strm.avail_in = input_len;
+  strm.next_in = const_cast<uint8_t*>(input);
+  strm.avail_out = output_capacity;
+  strm.next_out = *output;
+  // The output buffer is large enough to finish in one call.
+  ret = deflate(&strm, Z_FINISH);
+  ASSERT(ret == Z_STREAM_END);
+  *output_length = output_capacity - strm.avail_out;
+  deflateEnd(&strm);
+}
+
+bool DecompressInto(const uint8_t* input,
+                    intptr_t input_len,
+                    uint8_t* output,
+                    intptr_t output_length) {
+  ASSERT(input != NULL);
+  ASSERT(output != NULL);
+
+  z_stream strm;
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+  strm.avail_in = input_len;
+  strm.next_in = const_cast<uint8_t*>(input);
+  int ret = inflateInit2(&strm, 32 + MAX_WBITS);
+  if (ret != Z_OK) {
+    return false;
+  }
+  strm.avail_out = output_length;
+  strm.next_out = output;
+  ret = inflate(&strm, Z_FINISH);
+  const bool complete = (ret == Z_STREAM_END) && (strm.avail_out == 0);
+  inflateEnd(&strm);
+  return complete;
+}
+
 }  // namespace bin
 }  // namespace dart
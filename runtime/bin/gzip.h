@@ -10,6 +10,11 @@
 namespace dart {
 namespace bin {
 
+// Returns the uncompressed length recorded in the trailer of the gzip stream
+// |input|, or -1 if |input| is not one. The length is exact for a stream of
+// one member shorter than 4GB, which is what gzip writes.
+intptr_t GzipUncompressedLength(const uint8_t* input, intptr_t input_len);
+
 // |input| is assumed to be a gzipped stream.
 // This function allocates the output buffer in the C heap and the caller
 // is responsible for freeing it.
@@ -18,6 +23,22 @@ void Decompress(const uint8_t* input,
                 uint8_t** output,
                 intptr_t* output_length);
 
+// Compresses |input| into a zlib stream, favoring speed over ratio.
+// This function allocates the output buffer in the C heap and the caller
+// is responsible for freeing it.
+void Compress(const uint8_t* input,
+              intptr_t input_len,
+              uint8_t** output,
+              intptr_t* output_length);
+
+// |input| is assumed to be a zlib or gzip stream that decompresses to exactly
+// |output_length| bytes, which are written to |output|. Returns false if it
+// does not.
+bool DecompressInto(const uint8_t* input,
+                    intptr_t input_len,
+                    uint8_t* output,
+                    intptr_t output_length);
+
 }  // namespace bin
 }  // namespace dart
 
@@ -12,13 +12,7 @@ Dart_Handle IOBuffer::Allocate(intptr_t size, uint8_t** buffer) {
   if (data == NULL) {
     return Dart_Null();
   }
-  Dart_Handle result = Dart_NewExternalTypedDataWithFinalizer(
-      Dart_TypedData_kUint8, data, size, data, size, IOBuffer::Finalizer);
-
-  if (Dart_IsError(result)) {
-    Free(data);
-    Dart_PropagateError(result);
-  }
+  Dart_Handle result = Wrap(data, size);
   if (buffer != NULL) {
     *buffer = data;
   }
@@ -29,5 +23,20 @@ uint8_t* IOBuffer::Allocate(intptr_t size) {
   return reinterpret_cast<uint8_t*>(malloc(size));
 }
 
+uint8_t* IOBuffer::Reallocate(uint8_t* buffer, intptr_t new_size) {
+  return reinterpret_cast<uint8_t*>(realloc(buffer, new_size));
+}
+
+Dart_Handle IOBuffer::Wrap(uint8_t* data, intptr_t size) {
+  Dart_Handle result = Dart_NewExternalTypedDataWithFinalizer(
+      Dart_TypedData_kUint8, data, size, data, size, IOBuffer::Finalizer);
+
+  if (Dart_IsError(result)) {
+    Free(data);
+    Dart_PropagateError(result);
+  }
+  return result;
+}
+
 }  // namespace bin
 }  // namespace dart
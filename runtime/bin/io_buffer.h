@@ -20,6 +20,15 @@ class IOBuffer {
   // Allocate IO buffer storage.
   static uint8_t* Allocate(intptr_t size);
 
+  // Shrink IO buffer storage to [new_size] bytes. Shrinking is normally done
+  // in place, so this avoids the allocation and copy of a second buffer.
+  static uint8_t* Reallocate(uint8_t* buffer, intptr_t new_size);
+
+  // Create an IO buffer dart object (of type Uint8List) that takes ownership
+  // of storage allocated with Allocate. The storage is freed if creating the
+  // object fails.
+  static Dart_Handle Wrap(uint8_t* data, intptr_t size);
+
   // Function for disposing of IO buffer storage. All backing storage
   // for IO buffers must be freed using this function.
   static void Free(void* buffer) { free(buffer); }
@@ -53,6 +53,7 @@ namespace bin {
   V(File_LengthFromPath, 2)                                                    \
   V(File_LinkTarget, 2)                                                        \
   V(File_Lock, 4)                                                              \
+  V(File_Map, 4)                                                               \
   V(File_Open, 3)                                                              \
   V(File_OpenStdio, 1)                                                         \
   V(File_Position, 1)                                                          \
@@ -71,6 +72,7 @@ namespace bin {
   V(File_WriteByte, 2)                                                         \
   V(File_WriteFrom, 4)                                                         \
   V(FileSystemWatcher_CloseWatcher, 1)                                         \
+  V(FileSystemWatcher_CoalesceMilliseconds, 0)                                 \
   V(FileSystemWatcher_GetSocketId, 2)                                          \
   V(FileSystemWatcher_InitWatcher, 0)                                          \
   V(FileSystemWatcher_IsSupported, 0)                                          \
@@ -79,9 +81,13 @@ namespace bin {
   V(FileSystemWatcher_WatchPath, 5)                                            \
   V(Filter_CreateZLibDeflate, 8)                                               \
   V(Filter_CreateZLibInflate, 4)                                               \
+  V(Filter_GetConsumed, 1)                                                     \
   V(Filter_Process, 4)                                                         \
+  V(Filter_ProcessInto, 9)                                                     \
   V(Filter_Processed, 3)                                                       \
+  V(Filter_Reset, 3)                                                           \
   V(InternetAddress_Parse, 1)                                                  \
+  V(IOService_MaxPorts, 1)                                                     \
   V(IOService_NewServicePort, 0)                                               \
   V(Namespace_Create, 2)                                                       \
   V(Namespace_GetDefault, 0)                                                   \
@@ -113,11 +119,14 @@ namespace bin {
   V(RawSocketOption_GetOptionValue, 1)                                         \
   V(SecureSocket_Connect, 7)                                                   \
   V(SecureSocket_Destroy, 1)                                                   \
+  V(SecureSocket_EnableKernelTls, 2)                                           \
   V(SecureSocket_FilterPointer, 1)                                             \
   V(SecureSocket_GetSelectedProtocol, 1)                                       \
   V(SecureSocket_Handshake, 1)                                                 \
   V(SecureSocket_Init, 1)                                                      \
   V(SecureSocket_PeerCertificate, 1)                                           \
+  V(SecureSocket_ProcessBuffers, 3)                                            \
+  V(SecureSocket_ProcessesSynchronously, 1)                                    \
   V(SecureSocket_RegisterBadCertificateCallback, 2)                            \
   V(SecureSocket_RegisterHandshakeCompleteCallback, 2)                         \
   V(SecureSocket_Renegotiate, 4)                                               \
@@ -146,11 +155,14 @@ namespace bin {
   V(Socket_JoinMulticast, 4)                                                   \
   V(Socket_LeaveMulticast, 4)                                                  \
   V(Socket_Read, 2)                                                            \
+  V(Socket_ReadInto, 4)                                                        \
   V(Socket_RecvFrom, 1)                                                        \
+  V(Socket_SendFile, 4)                                                        \
   V(Socket_SendTo, 6)                                                          \
   V(Socket_SetOption, 4)                                                       \
   V(Socket_SetRawOption, 4)                                                    \
   V(Socket_SetSocketId, 3)                                                     \
+  V(Socket_WriteBuffers, 4)                                                    \
   V(Socket_WriteList, 4)                                                       \
   V(Stdin_ReadByte, 1)                                                         \
   V(Stdin_GetEchoMode, 1)                                                      \
@@ -54,6 +54,8 @@ void IOServiceCallback(Dart_Port dest_port_id, Dart_CObject* message) {
   Dart_PostCObject(reply_port_id, result.AsApiCObject());
 }
 
+int IOService::max_ports_[IOService::kNumLanes] = {16, 8, 8};
+
 Dart_Port IOService::GetServicePort() {
   return Dart_NewNativePort("IOService", IOServiceCallback, true);
 }
@@ -68,6 +70,17 @@ void FUNCTION_NAME(IOService_NewServicePort)(Dart_NativeArguments args) {
   }
 }
 
+void FUNCTION_NAME(IOService_MaxPorts)(Dart_NativeArguments args) {
+  const int64_t lane =
+      DartUtils::GetIntegerValue(Dart_GetNativeArgument(args, 0));
+  if ((lane < 0) || (lane >= IOService::kNumLanes)) {
+    Dart_SetReturnValue(args,
+                        DartUtils::NewDartArgumentError("Invalid lane"));
+    return;
+  }
+  Dart_SetIntegerReturnValue(args, IOService::max_ports(lane));
+}
+
 }  // namespace bin
 }  // namespace dart
 
@@ -60,7 +60,9 @@ namespace bin {
   V(Directory, ListStart, 38)                                                  \
   V(Directory, ListNext, 39)                                                   \
   V(Directory, ListStop, 40)                                                   \
-  V(Directory, Rename, 41)
+  V(Directory, Rename, 41)                                                     \
+  V(File, ReadWhole, 43)                                                       \
+  V(File, WriteWhole, 44)
 
 #define DECLARE_REQUEST(type, method, id) k##type##method##Request = id,
 
@@ -70,7 +72,19 @@ class IOService {
 
   static Dart_Port GetServicePort();
 
+  // The kinds of requests which are sent to separate groups of service ports,
+  // see _IOServicePorts in io_service_patch.dart.
+  enum Lane { kFileLane, kLookupLane, kFilterLane, kNumLanes };
+
+  // The maximum number of service ports of each isolate for a lane.
+  static int max_ports(intptr_t lane) { return max_ports_[lane]; }
+  static void set_max_ports(intptr_t lane, int max_ports) {
+    max_ports_[lane] = max_ports;
+  }
+
  private:
+  static int max_ports_[kNumLanes];
+
   DISALLOW_ALLOCATION();
   DISALLOW_IMPLICIT_CONSTRUCTORS(IOService);
 };
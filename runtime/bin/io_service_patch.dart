@@ -4,42 +4,108 @@
 
 // part of "common_patch.dart";
 
-class _IOServicePorts {
-  // We limit the number of IO Service ports per isolate so that we don't
-  // spawn too many threads all at once, which can crash the VM on Windows.
-  static const int maxPorts = 32;
+// A group of IO Service ports that only serves some kinds of requests, so
+// that slow requests of one kind cannot delay requests of another kind that
+// happen to be queued behind them on the same port.
+class _IOServicePortLane {
+  final int maxPorts;
   List<SendPort> _ports = <SendPort>[];
   List<SendPort> _freePorts = <SendPort>[];
-  Map<int, SendPort> _usedPorts = new HashMap<int, SendPort>();
+  // Number of outstanding requests for ports that are in use.
+  Map<SendPort, int> _load = new HashMap<SendPort, int>();
 
-  _IOServicePorts();
+  _IOServicePortLane(this.maxPorts);
 
-  SendPort _getPort(int forRequestId) {
-    if (_freePorts.isEmpty && _usedPorts.length < maxPorts) {
-      final SendPort port = _newServicePort();
+  SendPort _getPort() {
+    if (_freePorts.isEmpty && _ports.length < maxPorts) {
+      final SendPort port = _IOServicePorts._newServicePort();
       _ports.add(port);
       _freePorts.add(port);
     }
+    SendPort port;
     if (!_freePorts.isEmpty) {
-      final SendPort port = _freePorts.removeLast();
-      assert(!_usedPorts.containsKey(forRequestId));
-      _usedPorts[forRequestId] = port;
-      return port;
+      port = _freePorts.removeLast();
+    } else {
+      // We have already allocated the max number of ports. Re-use the one
+      // with the fewest outstanding requests.
+      int minLoad;
+      for (final SendPort candidate in _ports) {
+        final int load = _load[candidate];
+        if (minLoad == null || load < minLoad) {
+          port = candidate;
+          minLoad = load;
+        }
+      }
     }
-    // We have already allocated the max number of ports. Re-use an
-    // existing one.
-    final SendPort port = _ports[forRequestId % maxPorts];
+    _load[port] = (_load[port] ?? 0) + 1;
+    return port;
+  }
+
+  void _returnPort(SendPort port) {
+    final int load = _load[port] - 1;
+    if (load == 0) {
+      _load.remove(port);
+      _freePorts.add(port);
+    } else {
+      _load[port] = load;
+    }
+  }
+}
+
+class _IOServicePorts {
+  // We limit the number of IO Service ports per isolate so that we don't
+  // spawn too many threads all at once, which can crash the VM on Windows.
+  // The limit is split into lanes: TLS filtering is latency sensitive and
+  // host lookups can block for seconds, so neither shares ports with file
+  // and directory requests or with each other. The embedder sets the size of
+  // each lane (see --io-service-file-ports and friends in main_options.cc).
+  // These must match IOService::Lane in io_service.h.
+  static const int _fileLaneId = 0;
+  static const int _lookupLaneId = 1;
+  static const int _filterLaneId = 2;
+  _IOServicePortLane _generalLane =
+      new _IOServicePortLane(_maxPorts(_fileLaneId));
+  _IOServicePortLane _lookupLane =
+      new _IOServicePortLane(_maxPorts(_lookupLaneId));
+  _IOServicePortLane _filterLane =
+      new _IOServicePortLane(_maxPorts(_filterLaneId));
+  Map<int, SendPort> _usedPorts = new HashMap<int, SendPort>();
+  Map<int, _IOServicePortLane> _usedLanes =
+      new HashMap<int, _IOServicePortLane>();
+
+  _IOServicePorts();
+
+  _IOServicePortLane _laneFor(int request) {
+    switch (request) {
+      case _IOService.sslProcessFilter:
+        return _filterLane;
+      case _IOService.socketLookup:
+      case _IOService.socketListInterfaces:
+      case _IOService.socketReverseLookup:
+        return _lookupLane;
+      default:
+        // Requests for one file are never outstanding concurrently (see
+        // _RandomAccessFile._dispatch), so they stay in order no matter
+        // which port each of them is sent to.
+        return _generalLane;
+    }
+  }
+
+  SendPort _getPort(int forRequestId, int request) {
+    assert(!_usedPorts.containsKey(forRequestId));
+    final _IOServicePortLane lane = _laneFor(request);
+    final SendPort port = lane._getPort();
     _usedPorts[forRequestId] = port;
+    _usedLanes[forRequestId] = lane;
     return port;
   }
 
   void _returnPort(int forRequestId) {
     final SendPort port = _usedPorts.remove(forRequestId);
-    if (!_usedPorts.values.contains(port)) {
-      _freePorts.add(port);
-    }
+    _usedLanes.remove(forRequestId)._returnPort(port);
   }
 
+  static int _maxPorts(int lane) native "IOService_MaxPorts";
   static SendPort _newServicePort() native "IOService_NewServicePort";
 }
 
@@ -57,7 +123,7 @@ class _IOService {
     do {
       id = _getNextId();
     } while (_messageMap.containsKey(id));
-    final SendPort servicePort = _servicePorts._getPort(id);
+    final SendPort servicePort = _servicePorts._getPort(id, request);
     _ensureInitialize();
     final Completer completer = new Completer();
     _messageMap[id] = completer;
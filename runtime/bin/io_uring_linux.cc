@@ -0,0 +1,305 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "platform/globals.h"
+#if defined(HOST_OS_LINUX)
+
+#include "bin/eventhandler.h"
+#include "bin/eventhandler_linux.h"
+
+#include <errno.h>        // NOLINT
+#include <string.h>       // NOLINT
+#include <sys/mman.h>     // NOLINT
+#include <sys/syscall.h>  // NOLINT
+#include <unistd.h>       // NOLINT
+
+#include "bin/fdutils.h"
+#include "platform/atomic.h"
+#include "platform/signal_blocker.h"
+
+// io_uring system calls share their numbers across all architectures we
+// support, and libc does not provide wrappers for them.
+#if !defined(__NR_io_uring_setup)
+#define __NR_io_uring_setup 425
+#endif
+#if !defined(__NR_io_uring_enter)
+#define __NR_io_uring_enter 426
+#endif
+
+namespace dart {
+namespace bin {
+
+// Constants and structures from <linux/io_uring.h>.
+static const uint8_t kOpPollAdd = 6;
+static const uint8_t kOpPollRemove = 7;
+static const uint8_t kOpTimeout = 11;
+static const uint8_t kOpTimeoutRemove = 12;
+
+static const uint32_t kPollAddMulti = 1 << 0;
+static const uint32_t kTimeoutAbs = 1 << 0;
+static const uint32_t kEnterGetEvents = 1 << 0;
+
+static const uint32_t kFeatureNoDrop = 1 << 1;
+static const uint32_t kFeatureSubmitStable = 1 << 2;
+// Added in Linux 5.13 together with multishot poll, which does not have a
+// feature bit of its own.
+static const uint32_t kFeatureRsrcTags = 1 << 10;
+static const uint32_t kRequiredFeatures =
+    kFeatureNoDrop | kFeatureSubmitStable | kFeatureRsrcTags;
+
+static const off_t kOffsetSqRing = 0;
+static const off_t kOffsetCqRing = 0x8000000;
+static const off_t kOffsetSqes = 0x10000000;
+
+struct IOUringSqRingOffsets {
+  uint32_t head;
+  uint32_t tail;
+  uint32_t ring_mask;
+  uint32_t ring_entries;
+  uint32_t flags;
+  uint32_t dropped;
+  uint32_t array;
+  uint32_t resv1;
+  uint64_t resv2;
+};
+
+struct IOUringCqRingOffsets {
+  uint32_t head;
+  uint32_t tail;
+  uint32_t ring_mask;
+  uint32_t ring_entries;
+  uint32_t overflow;
+  uint32_t cqes;
+  uint32_t flags;
+  uint32_t resv1;
+  uint64_t resv2;
+};
+
+struct IOUringParams {
+  uint32_t sq_entries;
+  uint32_t cq_entries;
+  uint32_t flags;
+  uint32_t sq_thread_cpu;
+  uint32_t sq_thread_idle;
+  uint32_t features;
+  uint32_t wq_fd;
+  uint32_t resv[3];
+  IOUringSqRingOffsets sq_off;
+  IOUringCqRingOffsets cq_off;
+};
+
+COMPILE_ASSERT(sizeof(IOUringSqe) == 64);
+COMPILE_ASSERT(sizeof(IOUringCqe) == 16);
+COMPILE_ASSERT(sizeof(IOUringParams) == 120);
+
+static void* MapRing(int fd, uword size, off_t offset) {
+  void* result = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd, offset);
+  return (result == MAP_FAILED) ? NULL : result;
+}
+
+IOUring::IOUring()
+    : ring_fd_(-1),
+      sq_ring_(NULL),
+      sq_ring_size_(0),
+      sq_head_(NULL),
+      sq_tail_(NULL),
+      sq_array_(NULL),
+      sq_mask_(0),
+      sq_entries_(0),
+      sqes_(NULL),
+      sqes_size_(0),
+      pending_(0),
+      cq_ring_(NULL),
+      cq_ring_size_(0),
+      cq_head_(NULL),
+      cq_tail_(NULL),
+      cq_mask_(0),
+      cqes_(NULL),
+      timeout_tail_(0) {
+  memset(&timeout_, 0, sizeof(timeout_));
+}
+
+IOUring::~IOUring() {
+  if (sqes_ != NULL) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != NULL) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != NULL) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  if (ring_fd_ != -1) {
+    close(ring_fd_);
+  }
+}
+
+bool IOUring::Initialize(uint32_t entries) {
+  ASSERT(ring_fd_ == -1);
+  IOUringParams params;
+  memset(&params, 0, sizeof(params));
+  int fd = NO_RETRY_EXPECTED(syscall(__NR_io_uring_setup, entries, &params));
+  if (fd == -1) {
+    // ENOSYS on kernels older than 5.1, EPERM when disabled by a seccomp
+    // policy or sysctl.
+    return false;
+  }
+  ring_fd_ = fd;
+  if (((params.features & kRequiredFeatures) != kRequiredFeatures) ||
+      !FDUtils::SetCloseOnExec(ring_fd_)) {
+    return false;
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  sq_ring_ = MapRing(ring_fd_, sq_ring_size_, kOffsetSqRing);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(IOUringCqe);
+  cq_ring_ = MapRing(ring_fd_, cq_ring_size_, kOffsetCqRing);
+  sqes_size_ = params.sq_entries * sizeof(IOUringSqe);
+  sqes_ = reinterpret_cast<IOUringSqe*>(
+      MapRing(ring_fd_, sqes_size_, kOffsetSqes));
+  if ((sq_ring_ == NULL) || (cq_ring_ == NULL) || (sqes_ == NULL)) {
+    return false;
+  }
+
+  uint8_t* sq = reinterpret_cast<uint8_t*>(sq_ring_);
+  sq_head_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+  sq_array_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+  sq_mask_ = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+
+  uint8_t* cq = reinterpret_cast<uint8_t*>(cq_ring_);
+  cq_head_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<IOUringCqe*>(cq + params.cq_off.cqes);
+  return true;
+}
+
+IOUringSqe* IOUring::NextSqe() {
+  ASSERT(ring_fd_ != -1);
+  uint32_t tail = *sq_tail_;
+  if ((tail - AtomicOperations::LoadAcquire(sq_head_)) == sq_entries_) {
+    // The submission queue is full. Hand what we have to the kernel without
+    // waiting for completions.
+    Submit(0);
+    ASSERT(tail == AtomicOperations::LoadAcquire(sq_head_));
+  }
+  uint32_t index = tail & sq_mask_;
+  IOUringSqe* sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  // Without a kernel polling thread the tail is only read inside
+  // io_uring_enter, so the entry can be filled in after bumping it here.
+  *sq_tail_ = tail + 1;
+  pending_++;
+  return sqe;
+}
+
+void IOUring::PollAdd(intptr_t fd,
+                      uint32_t events,
+                      bool multishot,
+                      uint64_t user_data) {
+  IOUringSqe* sqe = NextSqe();
+  sqe->opcode = kOpPollAdd;
+  sqe->fd = fd;
+  // The kernel swaps the halves of poll32_events on big-endian hosts only.
+  sqe->op_flags = events;
+  sqe->len = multishot ? kPollAddMulti : 0;
+  sqe->user_data = user_data;
+}
+
+void IOUring::PollRemove(uint64_t target, uint64_t user_data) {
+  IOUringSqe* sqe = NextSqe();
+  sqe->opcode = kOpPollRemove;
+  sqe->fd = -1;
+  sqe->addr = target;
+  sqe->user_data = user_data;
+}
+
+void IOUring::TimeoutAdd(int64_t millis, uint64_t user_data) {
+  if (static_cast<int32_t>(AtomicOperations::LoadAcquire(sq_head_) -
+                           timeout_tail_) < 0) {
+    // An interrupted SubmitAndWait left the previous timeout in the
+    // submission queue. Hand it to the kernel before overwriting it.
+    Submit(0);
+  }
+  timeout_.tv_sec = millis / 1000;
+  timeout_.tv_nsec = (millis % 1000) * 1000000;
+  IOUringSqe* sqe = NextSqe();
+  sqe->opcode = kOpTimeout;
+  sqe->fd = -1;
+  sqe->addr = reinterpret_cast<uint64_t>(&timeout_);
+  sqe->len = 1;
+  sqe->op_flags = kTimeoutAbs;
+  sqe->user_data = user_data;
+  timeout_tail_ = *sq_tail_;
+}
+
+void IOUring::TimeoutRemove(uint64_t target, uint64_t user_data) {
+  IOUringSqe* sqe = NextSqe();
+  sqe->opcode = kOpTimeoutRemove;
+  sqe->fd = -1;
+  sqe->addr = target;
+  sqe->user_data = user_data;
+}
+
+void IOUring::Submit(uint32_t wait_nr) {
+  // Makes the entries written by NextSqe visible before the kernel can see
+  // the tail that covers them.
+  AtomicOperations::StoreRelease(sq_tail_, *sq_tail_);
+  uint32_t flags = (wait_nr > 0) ? kEnterGetEvents : 0;
+  while (true) {
+    intptr_t result = syscall(__NR_io_uring_enter, ring_fd_, pending_,
+                              wait_nr, flags, NULL, 0);
+    if (result >= 0) {
+      ASSERT(static_cast<uint32_t>(result) <= pending_);
+      pending_ -= result;
+      if (pending_ == 0) {
+        return;
+      }
+      // The kernel may stop short of the full batch, e.g. when it failed to
+      // allocate a request. Requests that were consumed have completions.
+      continue;
+    }
+    if (errno == EINTR) {
+      if (wait_nr > 0) {
+        // Let the caller handle whatever did complete.
+        return;
+      }
+      continue;
+    }
+    if ((errno == EAGAIN) || (errno == EBUSY)) {
+      // The completion queue is backed up. Returning lets the caller drain
+      // it; remaining requests go out with the next submission.
+      if (wait_nr > 0) {
+        return;
+      }
+      FATAL("io_uring submission queue stalled with a full completion queue");
+    }
+    FATAL1("io_uring_enter failed: %i", errno);
+  }
+}
+
+void IOUring::SubmitAndWait() {
+  Submit(1);
+}
+
+IOUringCqe* IOUring::PeekCompletion() {
+  uint32_t head = *cq_head_;
+  if (head == AtomicOperations::LoadAcquire(cq_tail_)) {
+    return NULL;
+  }
+  return &cqes_[head & cq_mask_];
+}
+
+void IOUring::ConsumeCompletion() {
+  AtomicOperations::StoreRelease(cq_head_, *cq_head_ + 1);
+}
+
+}  // namespace bin
+}  // namespace dart
+
+#endif  // defined(HOST_OS_LINUX)
@@ -0,0 +1,121 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_BIN_IO_URING_LINUX_H_
+#define RUNTIME_BIN_IO_URING_LINUX_H_
+
+#if !defined(RUNTIME_BIN_EVENTHANDLER_LINUX_H_)
+#error Do not include io_uring_linux.h directly; use eventhandler.h instead.
+#endif
+
+#include <stdint.h>
+
+#include "platform/globals.h"
+
+namespace dart {
+namespace bin {
+
+// The subset of the io_uring kernel ABI used by the event handler. It is
+// declared here rather than taken from <linux/io_uring.h> because the
+// sysroots we build against predate that header.
+struct IOUringSqe {
+  uint8_t opcode;
+  uint8_t flags;
+  uint16_t ioprio;
+  int32_t fd;
+  uint64_t off;
+  uint64_t addr;
+  uint32_t len;
+  uint32_t op_flags;  // poll32_events, timeout_flags, etc.
+  uint64_t user_data;
+  uint64_t pad[3];
+};
+
+struct IOUringCqe {
+  uint64_t user_data;
+  int32_t res;
+  uint32_t flags;
+};
+
+struct IOUringTimespec {
+  int64_t tv_sec;
+  int64_t tv_nsec;
+};
+
+// A minimal io_uring instance: a submission queue that is filled by the
+// event handler thread and flushed together with waiting for completions,
+// so that any number of requests costs a single io_uring_enter(2).
+//
+// Only the event handler thread may use an IOUring.
+class IOUring {
+ public:
+  // Completion flag signalling that a multishot request stays armed.
+  static const uint32_t kCompletionMore = 1 << 1;
+
+  IOUring();
+  ~IOUring();
+
+  // Returns false if the kernel does not provide an io_uring that supports
+  // everything used below. The caller is expected to fall back to epoll.
+  bool Initialize(uint32_t entries);
+
+  // Queues a poll for `events` (EPOLL* bits) on `fd`. A multishot poll keeps
+  // reporting edge-triggered readiness until it is removed. Otherwise it
+  // completes once, which gives level-triggered behaviour when re-armed.
+  void PollAdd(intptr_t fd,
+               uint32_t events,
+               bool multishot,
+               uint64_t user_data);
+  void PollRemove(uint64_t target, uint64_t user_data);
+
+  // Queues a timer for the absolute CLOCK_MONOTONIC time `millis`.
+  void TimeoutAdd(int64_t millis, uint64_t user_data);
+  void TimeoutRemove(uint64_t target, uint64_t user_data);
+
+  // Submits all queued requests and blocks until at least one completion is
+  // available.
+  void SubmitAndWait();
+
+  // Returns the oldest unconsumed completion, or NULL if there is none. The
+  // completion must be consumed with ConsumeCompletion before the next call.
+  IOUringCqe* PeekCompletion();
+  void ConsumeCompletion();
+
+ private:
+  IOUringSqe* NextSqe();
+  void Submit(uint32_t wait_nr);
+
+  int ring_fd_;
+
+  void* sq_ring_;
+  uword sq_ring_size_;
+  uint32_t* sq_head_;
+  uint32_t* sq_tail_;
+  uint32_t* sq_array_;
+  uint32_t sq_mask_;
+  uint32_t sq_entries_;
+  IOUringSqe* sqes_;
+  uword sqes_size_;
+  uint32_t pending_;
+
+  void* cq_ring_;
+  uword cq_ring_size_;
+  uint32_t* cq_head_;
+  uint32_t* cq_tail_;
+  uint32_t cq_mask_;
+  IOUringCqe* cqes_;
+
+  // The kernel reads timeouts when it consumes the request, not when it is
+  // queued, so timeout_ may only be reused once the submission queue head
+  // has passed timeout_tail_, the tail just after the last TimeoutAdd.
+  IOUringTimespec timeout_;
+  uint32_t timeout_tail_;
+
+  DISALLOW_COPY_AND_ASSIGN(IOUring);
+};
+
+}  // namespace bin
+}  // namespace dart
+
+#endif  // RUNTIME_BIN_IO_URING_LINUX_H_
@@ -66,6 +66,16 @@ class IsolateGroupData {
     kernel_buffer_size_ = size;
   }
 
+  // Like SetKernelBufferNewlyOwned, for a buffer that is released with
+  // [release] rather than free().
+  void SetKernelBufferNewlyOwned(uint8_t* buffer,
+                                 intptr_t size,
+                                 void (*release)(uint8_t*)) {
+    ASSERT(kernel_buffer_.get() == NULL);
+    kernel_buffer_ = std::shared_ptr<uint8_t>(buffer, release);
+    kernel_buffer_size_ = size;
+  }
+
   // Associate the given kernel buffer with this IsolateGroupData and give it
   // ownership of the buffer. The buffer is already owned by another
   // IsolateGroupData.
@@ -582,10 +582,10 @@ Dart_Handle Loader::DartColonLibraryTagHandler(Dart_LibraryTag tag,
   return Dart_Null();
 }
 #else
-static void MallocFinalizer(void* isolate_callback_data,
-                            Dart_WeakPersistentHandle handle,
-                            void* peer) {
-  free(peer);
+static void KernelBufferFinalizer(void* isolate_callback_data,
+                                  Dart_WeakPersistentHandle handle,
+                                  void* peer) {
+  DFE::FreeKernelBuffer(reinterpret_cast<uint8_t*>(peer));
 }
 
 Dart_Handle Loader::LibraryTagHandler(Dart_LibraryTag tag,
@@ -613,7 +613,7 @@ Dart_Handle Loader::LibraryTagHandler(Dart_LibraryTag tag,
     result = Dart_NewExternalTypedData(Dart_TypedData_kUint8, kernel_buffer,
                                        kernel_buffer_size);
     Dart_NewWeakPersistentHandle(result, kernel_buffer, kernel_buffer_size,
-                                 MallocFinalizer);
+                                 KernelBufferFinalizer);
     return result;
   }
   if (tag == Dart_kImportExtensionTag) {
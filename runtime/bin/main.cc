@@ -185,7 +185,8 @@ static void OnExitHook(int64_t exit_code) {
   }
   if (exit_code == 0) {
     if (Options::gen_snapshot_kind() == kAppJIT) {
-      Snapshot::GenerateAppJIT(Options::snapshot_filename());
+      Snapshot::GenerateAppJIT(Options::snapshot_filename(),
+                               Options::compress_snapshot_data());
     }
     WriteDepsFile(main_isolate);
   }
@@ -365,6 +366,7 @@ static Dart_Isolate IsolateSetupHelper(Dart_Isolate isolate,
     CHECK_RESULT(resolved_script_uri);
     result = Dart_LoadScriptFromKernel(kernel_buffer, kernel_buffer_size);
     CHECK_RESULT(result);
+    DFE::KernelBufferLoaded(kernel_buffer);
   }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
@@ -663,8 +665,8 @@ static Dart_Isolate CreateIsolateGroupAndSetupHelper(
       isolate_group_data->SetKernelBufferAlreadyOwned(
           std::move(parent_kernel_buffer), kernel_buffer_size);
     } else {
-      isolate_group_data->SetKernelBufferNewlyOwned(kernel_buffer,
-                                                    kernel_buffer_size);
+      isolate_group_data->SetKernelBufferNewlyOwned(
+          kernel_buffer, kernel_buffer_size, DFE::FreeKernelBuffer);
     }
   }
   if (is_main_isolate && (Options::depfile() != NULL)) {
@@ -976,7 +978,8 @@ bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
     // Generate an app snapshot after execution if specified.
     if (Options::gen_snapshot_kind() == kAppJIT) {
       if (!Dart_IsCompilationError(result)) {
-        Snapshot::GenerateAppJIT(Options::snapshot_filename());
+        Snapshot::GenerateAppJIT(Options::snapshot_filename(),
+                                 Options::compress_snapshot_data());
       }
     }
     CHECK_RESULT(result);
@@ -1017,6 +1020,31 @@ extern const uint8_t* observatory_assets_archive;
 
 
 Dart_Handle GetVMServiceAssetsArchiveCallback() {
+  // Inflate straight into the Dart array when the gzip trailer gives its
+  // length, rather than into a C buffer that is then copied.
+  const intptr_t length = GzipUncompressedLength(
+      observatory_assets_archive, observatory_assets_archive_len);
+  if (length > 0) {
+    Dart_Handle tar_file = Dart_NewTypedData(Dart_TypedData_kUint8, length);
+    if (Dart_IsError(tar_file)) {
+      return tar_file;
+    }
+    Dart_TypedData_Type type;
+    void* data;
+    intptr_t data_length;
+    Dart_Handle result =
+        Dart_TypedDataAcquireData(tar_file, &type, &data, &data_length);
+    if (Dart_IsError(result)) {
+      return result;
+    }
+    const bool ok = DecompressInto(observatory_assets_archive,
+                                   observatory_assets_archive_len,
+                                   reinterpret_cast<uint8_t*>(data), length);
+    Dart_TypedDataReleaseData(tar_file);
+    if (ok) {
+      return tar_file;
+    }
+  }
   uint8_t* decompressed = NULL;
   intptr_t decompressed_len = 0;
   Decompress(observatory_assets_archive, observatory_assets_archive_len,
@@ -1163,15 +1191,12 @@ void main(int argc, char** argv) {
 // they might affect how the platform is loaded.
 #if !defined(DART_PRECOMPILED_RUNTIME)
   dfe.Init(Options::target_abi_version());
-  uint8_t* application_kernel_buffer = NULL;
-  intptr_t application_kernel_buffer_size = 0;
-  dfe.ReadScript(script_name, &application_kernel_buffer,
-                 &application_kernel_buffer_size);
-  if (application_kernel_buffer != NULL) {
-    // Since we loaded the script anyway, save it.
-    dfe.set_application_kernel_buffer(application_kernel_buffer,
-                                      application_kernel_buffer_size);
-    Options::dfe()->set_use_dfe();
+  // --depfile needs the dependencies the kernel service records while
+  // compiling, so it bypasses the kernel cache.
+  if ((Options::kernel_cache_dir() != NULL) && (Options::depfile() == NULL)) {
+    dfe.set_kernel_cache_dir(Options::kernel_cache_dir());
+    dfe.SetKernelCacheKey(Options::target_abi_version(), vm_options.count(),
+                          vm_options.arguments());
   }
 #endif
 
@@ -1207,6 +1232,21 @@ void main(int argc, char** argv) {
     Platform::Exit(kErrorExitCode);
   }
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  // Read the script only now, so that reading it overlaps
+  // the kernel isolate starting in the background.
+  uint8_t* application_kernel_buffer = NULL;
+  intptr_t application_kernel_buffer_size = 0;
+  dfe.ReadScript(script_name, &application_kernel_buffer,
+                 &application_kernel_buffer_size);
+  if (application_kernel_buffer != NULL) {
+    // Since we loaded the script anyway, save it.
+    dfe.set_application_kernel_buffer(application_kernel_buffer,
+                                      application_kernel_buffer_size);
+    Options::dfe()->set_use_dfe();
+  }
+#endif
+
   Dart_SetServiceStreamCallbacks(&ServiceStreamListenCallback,
                                  &ServiceStreamCancelCallback);
   Dart_SetFileModifiedCallback(&FileModifiedCallback);
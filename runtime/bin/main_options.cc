@@ -9,13 +9,24 @@
 #include <string.h>
 
 #include "bin/abi_version.h"
+#include "bin/eventhandler.h"
+#include "bin/file_system_watcher.h"
+#if defined(DART_IO_SECURE_SOCKET_DISABLED)
+#include "bin/io_service_no_ssl.h"
+#else
+#include "bin/io_service.h"
+#endif
+#include "bin/namespace.h"
 #include "bin/options.h"
 #include "bin/platform.h"
 #include "platform/syslog.h"
+#include "platform/utils.h"
 #if !defined(DART_IO_SECURE_SOCKET_DISABLED)
+#include "bin/secure_socket_filter.h"
 #include "bin/security_context.h"
 #endif  // !defined(DART_IO_SECURE_SOCKET_DISABLED)
 #include "bin/socket.h"
+#include "bin/stdio.h"
 #include "include/dart_api.h"
 #include "platform/assert.h"
 #include "platform/globals.h"
@@ -191,6 +202,90 @@ void Options::PrintUsage() {
 "--trace-loading\n"
 "  enables tracing of library and script loading\n"
 "\n"
+"--io-uring-polling\n"
+"  On Linux, poll sockets and wait for timers in the dart:io event handler\n"
+"  with io_uring instead of epoll when the kernel supports it (5.13 or\n"
+"  later). Socket reads, writes and accepts still use regular system calls.\n"
+"\n"
+"--epoll-keep-registered\n"
+"  On Linux, keep sockets registered with epoll while nothing listens for\n"
+"  their events, and only re-arm them when more events are listened for.\n"
+"--epoll-max-events=<count>\n"
+"  On Linux, the most events the dart:io event handler takes from epoll at\n"
+"  once (default 16).\n"
+"\n"
+"--event-handler-threads=<count>\n"
+"  The number of threads, each with its own OS event queue, that deliver\n"
+"  dart:io socket and timer events (default 1). Sockets are spread across\n"
+"  them by file descriptor. Windows always uses one.\n"
+"--event-handler-incoming-cpu\n"
+"  On Linux with several event handler threads, assign each connected\n"
+"  socket to a thread by the CPU that received its packets, and run each\n"
+"  thread on the CPUs it is assigned.\n"
+"--event-handler-spin=<microseconds>\n"
+"  On Linux, keep polling epoll without blocking for this long after\n"
+"  handling events, trading CPU time for lower wake-up latency.\n"
+"--socket-busy-poll=<microseconds>\n"
+"  On Linux, set SO_BUSY_POLL on sockets so that reads poll the device\n"
+"  queue for up to this long. Raising it above net.core.busy_read needs\n"
+"  CAP_NET_ADMIN.\n"
+"\n"
+"--dns-cache-ttl=<seconds>\n"
+"  Reuse the addresses found by InternetAddress.lookup and Socket.connect for\n"
+"  a host name for this many seconds (default 0, no caching).\n"
+"\n"
+"--stdio-buffer-size=<KB>\n"
+"  Buffer up to this many kilobytes of stdout and stderr output each, and\n"
+"  write it out on a separate thread so that printing does not wait for\n"
+"  the terminal or pipe. Not supported on Windows.\n"
+"--stdio-drop-on-overflow\n"
+"  With --stdio-buffer-size, drop writes that do not fit in the buffer\n"
+"  instead of waiting for it to drain.\n"
+"\n"
+"--directory-fd-cache\n"
+"  On Linux, keep the directories of absolute paths that files are opened\n"
+"  or looked up in open, and resolve the paths relative to them. Renaming or\n"
+"  deleting directories through dart:io updates the cache, but changes made\n"
+"  by other processes are not noticed.\n"
+"\n"
+"--map-kernel-files\n"
+"  Map kernel (.dill) files read-only instead of reading them into memory,\n"
+"  so that the isolates and processes running the same file share its\n"
+"  pages. The file must not be rewritten in place while the VM runs.\n"
+"\n"
+"--file-watcher-coalesce=<milliseconds>\n"
+"  On Linux, deliver the FileSystemEvents of the same kind for the same path\n"
+"  that arrive within this many milliseconds of each other once (default 0,\n"
+"  every event is delivered).\n"
+"\n"
+"--io-service-file-ports=<count>\n"
+"--io-service-lookup-ports=<count>\n"
+"--io-service-filter-ports=<count>\n"
+"  The maximum number of IO service ports, each served by one worker thread,\n"
+"  that an isolate sends file and directory requests, host lookups, and\n"
+"  SecureSocket filtering to (default 16, 8 and 8). Requests of one kind\n"
+"  never wait behind requests of another kind.\n"
+"\n"
+"--secure-socket-sync-filter\n"
+"  Encrypt and decrypt SecureSocket data on the isolate's thread instead of\n"
+"  sending each batch of buffers to the IO service.\n"
+"--tls-session-cache\n"
+"  Resume the TLS sessions of earlier client connections to the same host\n"
+"  and security context, and let servers resume their clients' sessions.\n"
+"--kernel-tls\n"
+"  On Linux, once a TLS 1.2 AES-GCM connection is established, let the\n"
+"  kernel encrypt the data SecureSocket sends, when the kernel supports it.\n"
+"\n"
+"--compress-snapshot-data\n"
+"  With --snapshot-kind=app-jit, compress the data sections of the snapshot.\n"
+"  They are decompressed into memory when the snapshot is run, instead of\n"
+"  being mapped from the file.\n"
+"\n"
+"--kernel-cache=<path>\n"
+"  Cache the kernel compiled from scripts in this directory, and reuse it\n"
+"  while none of the script's sources, its package config, the SDK or the\n"
+"  VM flags have changed.\n"
+"\n"
 "--enable-vm-service[=<port>[/<bind-address>]]\n"
 "  Enables the VM service and listens on specified port for connections\n"
 "  (default port number is 8181, default bind address is localhost).\n"
@@ -359,6 +454,97 @@ bool Options::ProcessAbiVersionOption(const char* arg,
   return true;
 }
 
+// Parses the value of the option --<name>=<value> in arg into count.
+static bool ProcessCountOption(const char* arg, const char* name, int* count) {
+  char option[64];
+  Utils::SNPrint(option, sizeof(option), "--%s=", name);
+  const char* value = OptionProcessor::ProcessOption(arg, option);
+  if (value == NULL) {
+    return false;
+  }
+  int result = 0;
+  for (int i = 0; value[i]; ++i) {
+    if ((value[i] < '0') || (value[i] > '9') || (result > 1000000)) {
+      result = 0;
+      break;
+    }
+    result = (result * 10) + value[i] - '0';
+  }
+  if (result < 1) {
+    Syslog::PrintErr("--%s must be a positive int\n", name);
+    return false;
+  }
+  *count = result;
+  return true;
+}
+
+int Options::epoll_max_events_ = 16;
+bool Options::ProcessEpollMaxEventsOption(const char* arg,
+                                          CommandLineOptions* vm_options) {
+  return ProcessCountOption(arg, "epoll_max_events", &epoll_max_events_);
+}
+
+int Options::event_handler_threads_ = 1;
+bool Options::ProcessEventHandlerThreadsOption(const char* arg,
+                                               CommandLineOptions* vm_options) {
+  return ProcessCountOption(arg, "event_handler_threads",
+                            &event_handler_threads_);
+}
+
+int Options::event_handler_spin_ = 0;
+bool Options::ProcessEventHandlerSpinOption(const char* arg,
+                                            CommandLineOptions* vm_options) {
+  return ProcessCountOption(arg, "event_handler_spin", &event_handler_spin_);
+}
+
+int Options::socket_busy_poll_ = 0;
+bool Options::ProcessSocketBusyPollOption(const char* arg,
+                                          CommandLineOptions* vm_options) {
+  return ProcessCountOption(arg, "socket_busy_poll", &socket_busy_poll_);
+}
+
+int Options::dns_cache_ttl_ = 0;
+bool Options::ProcessDnsCacheTtlOption(const char* arg,
+                                       CommandLineOptions* vm_options) {
+  return ProcessCountOption(arg, "dns_cache_ttl", &dns_cache_ttl_);
+}
+
+int Options::stdio_buffer_size_ = 0;
+bool Options::ProcessStdioBufferSizeOption(const char* arg,
+                                           CommandLineOptions* vm_options) {
+  return ProcessCountOption(arg, "stdio_buffer_size", &stdio_buffer_size_);
+}
+
+int Options::file_watcher_coalesce_ = 0;
+bool Options::ProcessFileWatcherCoalesceOption(const char* arg,
+                                               CommandLineOptions* vm_options) {
+  return ProcessCountOption(arg, "file_watcher_coalesce",
+                            &file_watcher_coalesce_);
+}
+
+int Options::io_service_file_ports_ = 0;
+bool Options::ProcessIOServiceFilePortsOption(const char* arg,
+                                              CommandLineOptions* vm_options) {
+  return ProcessCountOption(arg, "io_service_file_ports",
+                            &io_service_file_ports_);
+}
+
+int Options::io_service_lookup_ports_ = 0;
+bool Options::ProcessIOServiceLookupPortsOption(
+    const char* arg,
+    CommandLineOptions* vm_options) {
+  return ProcessCountOption(arg, "io_service_lookup_ports",
+                            &io_service_lookup_ports_);
+}
+
+int Options::io_service_filter_ports_ = 0;
+bool Options::ProcessIOServiceFilterPortsOption(
+    const char* arg,
+    CommandLineOptions* vm_options) {
+  return ProcessCountOption(arg, "io_service_filter_ports",
+                            &io_service_filter_ports_);
+}
+
 int Options::ParseArguments(int argc,
                             char** argv,
                             bool vm_run_app_snapshot,
@@ -415,9 +601,39 @@ int Options::ParseArguments(int argc,
 
   Socket::set_short_socket_read(Options::short_socket_read());
   Socket::set_short_socket_write(Options::short_socket_write());
+  EventHandler::set_io_uring_polling(Options::io_uring_polling());
+  EventHandler::set_epoll_keep_registered(Options::epoll_keep_registered());
+  EventHandler::set_epoll_max_events(Options::epoll_max_events());
+  EventHandler::set_thread_count(Options::event_handler_threads());
+  EventHandler::set_spin_microseconds(Options::event_handler_spin());
+  EventHandler::set_group_by_incoming_cpu(
+      Options::event_handler_incoming_cpu());
+  Socket::set_busy_poll_microseconds(Options::socket_busy_poll());
+  HostLookupCache::set_ttl_seconds(Options::dns_cache_ttl());
+  StdioWriter::Configure(Options::stdio_buffer_size() * KB,
+                         Options::stdio_drop_on_overflow());
+  FileSystemWatcher::set_coalesce_milliseconds(
+      Options::file_watcher_coalesce());
+  if (Options::io_service_file_ports() > 0) {
+    IOService::set_max_ports(IOService::kFileLane,
+                             Options::io_service_file_ports());
+  }
+  if (Options::io_service_lookup_ports() > 0) {
+    IOService::set_max_ports(IOService::kLookupLane,
+                             Options::io_service_lookup_ports());
+  }
+  if (Options::io_service_filter_ports() > 0) {
+    IOService::set_max_ports(IOService::kFilterLane,
+                             Options::io_service_filter_ports());
+  }
+  Namespace::set_directory_cache(Options::directory_fd_cache());
+  DFE::set_map_kernel_files(Options::map_kernel_files());
 #if !defined(DART_IO_SECURE_SOCKET_DISABLED)
   SSLCertContext::set_root_certs_file(Options::root_certs_file());
   SSLCertContext::set_root_certs_cache(Options::root_certs_cache());
+  SSLFilter::set_process_synchronously(Options::secure_socket_sync_filter());
+  SSLSessionCache::set_enabled(Options::tls_session_cache());
+  SSLFilter::set_kernel_tls(Options::kernel_tls());
 #endif  // !defined(DART_IO_SECURE_SOCKET_DISABLED)
 
   // The arguments to the VM are at positions 1 through i-1 in argv.
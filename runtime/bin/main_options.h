@@ -30,6 +30,7 @@ namespace bin {
   V(load_type_feedback, load_type_feedback_filename)                           \
   V(root_certs_file, root_certs_file)                                          \
   V(root_certs_cache, root_certs_cache)                                        \
+  V(kernel_cache, kernel_cache_dir)                                            \
   V(namespace, namespc)
 
 // As STRING_OPTIONS_LIST but for boolean valued options. The default value is
@@ -37,12 +38,22 @@ namespace bin {
 #define BOOL_OPTIONS_LIST(V)                                                   \
   V(version, version_option)                                                   \
   V(compile_all, compile_all)                                                  \
+  V(compress_snapshot_data, compress_snapshot_data)                            \
   V(disable_service_origin_check, vm_service_dev_mode)                         \
   V(disable_service_auth_codes, vm_service_auth_disabled)                      \
   V(deterministic, deterministic)                                              \
   V(trace_loading, trace_loading)                                              \
   V(short_socket_read, short_socket_read)                                      \
   V(short_socket_write, short_socket_write)                                    \
+  V(io_uring_polling, io_uring_polling)                                        \
+  V(epoll_keep_registered, epoll_keep_registered)                              \
+  V(event_handler_incoming_cpu, event_handler_incoming_cpu)                    \
+  V(secure_socket_sync_filter, secure_socket_sync_filter)                      \
+  V(tls_session_cache, tls_session_cache)                                      \
+  V(kernel_tls, kernel_tls)                                                    \
+  V(stdio_drop_on_overflow, stdio_drop_on_overflow)                            \
+  V(directory_fd_cache, directory_fd_cache)                                    \
+  V(map_kernel_files, map_kernel_files)                                        \
   V(disable_exit, exit_disabled)                                               \
   V(preview_dart_2, nop_option)                                                \
   V(suppress_core_dump, suppress_core_dump)
@@ -64,7 +75,17 @@ namespace bin {
   V(ProcessEnvironmentOption)                                                  \
   V(ProcessEnableVmServiceOption)                                              \
   V(ProcessObserveOption)                                                      \
-  V(ProcessAbiVersionOption)
+  V(ProcessAbiVersionOption)                                                   \
+  V(ProcessEpollMaxEventsOption)                                               \
+  V(ProcessEventHandlerThreadsOption)                                          \
+  V(ProcessEventHandlerSpinOption)                                             \
+  V(ProcessSocketBusyPollOption)                                               \
+  V(ProcessDnsCacheTtlOption)                                                  \
+  V(ProcessStdioBufferSizeOption)                                              \
+  V(ProcessFileWatcherCoalesceOption)                                          \
+  V(ProcessIOServiceFilePortsOption)                                           \
+  V(ProcessIOServiceLookupPortsOption)                                         \
+  V(ProcessIOServiceFilterPortsOption)
 
 // This enum must match the strings in kSnapshotKindNames in main_options.cc.
 enum SnapshotKind {
@@ -120,6 +141,17 @@ class Options {
   static constexpr int kAbiVersionUnset = -1;
   static int target_abi_version() { return target_abi_version_; }
 
+  static int epoll_max_events() { return epoll_max_events_; }
+  static int event_handler_threads() { return event_handler_threads_; }
+  static int event_handler_spin() { return event_handler_spin_; }
+  static int socket_busy_poll() { return socket_busy_poll_; }
+  static int dns_cache_ttl() { return dns_cache_ttl_; }
+  static int stdio_buffer_size() { return stdio_buffer_size_; }
+  static int file_watcher_coalesce() { return file_watcher_coalesce_; }
+  static int io_service_file_ports() { return io_service_file_ports_; }
+  static int io_service_lookup_ports() { return io_service_lookup_ports_; }
+  static int io_service_filter_ports() { return io_service_filter_ports_; }
+
 #if !defined(DART_PRECOMPILED_RUNTIME)
   static DFE* dfe() { return dfe_; }
   static void set_dfe(DFE* dfe) { dfe_ = dfe; }
@@ -165,6 +197,16 @@ class Options {
                                     const char* default_ip);
 
   static int target_abi_version_;
+  static int epoll_max_events_;
+  static int event_handler_threads_;
+  static int event_handler_spin_;
+  static int socket_busy_poll_;
+  static int dns_cache_ttl_;
+  static int stdio_buffer_size_;
+  static int file_watcher_coalesce_;
+  static int io_service_file_ports_;
+  static int io_service_lookup_ports_;
+  static int io_service_filter_ports_;
 
 #define OPTION_FRIEND(flag, variable) friend class OptionProcessor_##flag;
   STRING_OPTIONS_LIST(OPTION_FRIEND)
@@ -16,6 +16,8 @@ namespace bin {
 
 static const int kNamespaceNativeFieldIndex = 0;
 
+bool Namespace::directory_cache_ = false;
+
 static void ReleaseNamespace(void* isolate_callback_data,
                              Dart_WeakPersistentHandle handle,
                              void* peer) {
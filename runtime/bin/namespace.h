@@ -8,6 +8,7 @@
 #include "bin/builtin.h"
 #include "bin/dartutils.h"
 #include "bin/reference_counting.h"
+#include "bin/thread.h"
 #include "platform/syslog.h"
 
 namespace dart {
@@ -40,7 +41,14 @@ class Namespace : public ReferenceCounted<Namespace> {
 
   NamespaceImpl* namespc() const { return namespc_; }
 
+  // Whether the directories of absolute paths are kept open for lookups
+  // relative to them. Only used on Linux.
+  static bool directory_cache() { return directory_cache_; }
+  static void set_directory_cache(bool enabled) { directory_cache_ = enabled; }
+
  private:
+  static bool directory_cache_;
+
   // When namespc_ has this value, it indicates that there is currently
   // no namespace for resolving absolute paths.
   static const intptr_t kNone = 0;
@@ -90,6 +98,65 @@ class NamespaceScope {
   DISALLOW_COPY_AND_ASSIGN(NamespaceScope);
 };
 
+#if defined(HOST_OS_LINUX)
+class CachedDirectory;
+
+// Keeps the directories of absolute paths that are looked up open, so that
+// the kernel only has to resolve the last component of a path.
+class DirectoryCache {
+ public:
+  // Returns the cached directory 'path[0..length)' of 'namespc', opening it
+  // relative to 'dirfd' if needed, or NULL if it cannot be opened.
+  static CachedDirectory* Acquire(NamespaceImpl* namespc,
+                                  intptr_t dirfd,
+                                  const char* path,
+                                  intptr_t length);
+  static void Release(CachedDirectory* directory);
+  static intptr_t FdOf(CachedDirectory* directory);
+
+  // Drops the cached directories at or below 'path' after it has been
+  // renamed or deleted, so none of them can be cached again meanwhile. A
+  // relative path drops all of them. Preserves errno.
+  static void Invalidate(const char* path);
+
+  // Drops the cached directories of 'namespc'.
+  static void Clear(NamespaceImpl* namespc);
+
+ private:
+  static const intptr_t kMaxEntries = 64;
+
+  static void Unreference(CachedDirectory* directory);
+
+  static Mutex* mutex_;
+  static CachedDirectory* entries_[kMaxEntries];
+  static uint64_t uses_;
+
+  DISALLOW_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(DirectoryCache);
+};
+
+// Like NamespaceScope, but with Namespace::directory_cache() an absolute path
+// is looked up relative to the cached fd of its directory. Only for
+// operations on the path itself, as path() is then just its last component.
+class CachedNamespaceScope {
+ public:
+  CachedNamespaceScope(Namespace* namespc, const char* path);
+  ~CachedNamespaceScope();
+
+  intptr_t fd() const { return fd_; }
+  const char* path() const { return path_; }
+
+ private:
+  NamespaceScope ns_;
+  CachedDirectory* directory_;
+  intptr_t fd_;
+  const char* path_;
+
+  DISALLOW_ALLOCATION();
+  DISALLOW_COPY_AND_ASSIGN(CachedNamespaceScope);
+};
+#endif  // defined(HOST_OS_LINUX)
+
 }  // namespace bin
 }  // namespace dart
 
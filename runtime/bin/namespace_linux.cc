@@ -11,6 +11,7 @@
 #include <fcntl.h>
 
 #include "bin/file.h"
+#include "bin/lockers.h"
 #include "platform/signal_blocker.h"
 #include "platform/text_buffer.h"
 
@@ -34,6 +35,7 @@ class NamespaceImpl {
   }
 
   ~NamespaceImpl() {
+    DirectoryCache::Clear(this);
     NO_RETRY_EXPECTED(close(rootfd_));
     free(cwd_);
     NO_RETRY_EXPECTED(close(cwdfd_));
@@ -153,6 +155,175 @@ NamespaceScope::NamespaceScope(Namespace* namespc, const char* path) {
 
 NamespaceScope::~NamespaceScope() {}
 
+class CachedDirectory {
+ public:
+  CachedDirectory(NamespaceImpl* namespc, char* path, intptr_t fd)
+      : namespc_(namespc), path_(path), fd_(fd), references_(1), last_use_(0) {}
+
+  ~CachedDirectory() {
+    NO_RETRY_EXPECTED(close(fd_));
+    free(path_);
+  }
+
+ private:
+  NamespaceImpl* namespc_;
+  char* path_;
+  intptr_t fd_;
+  // One for the cache while the directory is in it, and one for each
+  // CachedNamespaceScope using it.
+  intptr_t references_;
+  uint64_t last_use_;
+
+  friend class DirectoryCache;
+  DISALLOW_COPY_AND_ASSIGN(CachedDirectory);
+};
+
+Mutex* DirectoryCache::mutex_ = new Mutex();
+CachedDirectory* DirectoryCache::entries_[DirectoryCache::kMaxEntries];
+uint64_t DirectoryCache::uses_ = 0;
+
+CachedDirectory* DirectoryCache::Acquire(NamespaceImpl* namespc,
+                                         intptr_t dirfd,
+                                         const char* path,
+                                         intptr_t length) {
+  MutexLocker ml(mutex_);
+  intptr_t victim = 0;
+  for (intptr_t i = 0; i < kMaxEntries; i++) {
+    CachedDirectory* entry = entries_[i];
+    if (entry == NULL) {
+      victim = i;
+      continue;
+    }
+    if ((entry->namespc_ == namespc) &&
+        (strncmp(entry->path_, path, length) == 0) &&
+        (entry->path_[length] == '\0')) {
+      entry->references_++;
+      entry->last_use_ = ++uses_;
+      return entry;
+    }
+    if ((entries_[victim] != NULL) &&
+        (entry->last_use_ < entries_[victim]->last_use_)) {
+      victim = i;
+    }
+  }
+  char* directory_path = strndup(path, length);
+  // In a namespace, absolute paths are opened relative to its root.
+  const int fd = TEMP_FAILURE_RETRY(
+      openat64(dirfd, namespc != NULL ? directory_path + 1 : directory_path,
+               O_PATH | O_DIRECTORY | O_CLOEXEC));
+  if (fd < 0) {
+    free(directory_path);
+    return NULL;
+  }
+  if (entries_[victim] != NULL) {
+    Unreference(entries_[victim]);
+  }
+  CachedDirectory* entry = new CachedDirectory(namespc, directory_path, fd);
+  entry->references_++;
+  entry->last_use_ = ++uses_;
+  entries_[victim] = entry;
+  return entry;
+}
+
+void DirectoryCache::Release(CachedDirectory* directory) {
+  MutexLocker ml(mutex_);
+  Unreference(directory);
+}
+
+intptr_t DirectoryCache::FdOf(CachedDirectory* directory) {
+  return directory->fd_;
+}
+
+void DirectoryCache::Unreference(CachedDirectory* directory) {
+  if (--directory->references_ == 0) {
+    delete directory;
+  }
+}
+
+void DirectoryCache::Invalidate(const char* path) {
+  if (!Namespace::directory_cache()) {
+    return;
+  }
+  const bool absolute = File::IsAbsolutePath(path);
+  intptr_t length = strlen(path);
+  while ((length > 0) && (path[length - 1] == '/')) {
+    length--;
+  }
+  const int saved_errno = errno;
+  MutexLocker ml(mutex_);
+  for (intptr_t i = 0; i < kMaxEntries; i++) {
+    CachedDirectory* entry = entries_[i];
+    if ((entry != NULL) &&
+        (!absolute || ((strncmp(entry->path_, path, length) == 0) &&
+                       ((entry->path_[length] == '\0') ||
+                        (entry->path_[length] == '/'))))) {
+      Unreference(entry);
+      entries_[i] = NULL;
+    }
+  }
+  errno = saved_errno;
+}
+
+void DirectoryCache::Clear(NamespaceImpl* namespc) {
+  MutexLocker ml(mutex_);
+  for (intptr_t i = 0; i < kMaxEntries; i++) {
+    CachedDirectory* entry = entries_[i];
+    if ((entry != NULL) && (entry->namespc_ == namespc)) {
+      Unreference(entry);
+      entries_[i] = NULL;
+    }
+  }
+}
+
+// Whether the directory path[0..length) has no empty, "." or ".." components,
+// so that invalidating its path covers every way it was cached.
+static bool IsNormalizedDirectory(const char* path, intptr_t length) {
+  intptr_t start = 1;
+  for (intptr_t i = 1; i <= length; i++) {
+    if ((i < length) && (path[i] != '/')) {
+      continue;
+    }
+    const intptr_t component = i - start;
+    if ((component == 0) || ((component == 1) && (path[start] == '.')) ||
+        ((component == 2) && (path[start] == '.') &&
+         (path[start + 1] == '.'))) {
+      return false;
+    }
+    start = i + 1;
+  }
+  return true;
+}
+
+CachedNamespaceScope::CachedNamespaceScope(Namespace* namespc,
+                                           const char* path)
+    : ns_(namespc, path),
+      directory_(NULL),
+      fd_(ns_.fd()),
+      path_(ns_.path()) {
+  if (!Namespace::directory_cache() || !File::IsAbsolutePath(path)) {
+    return;
+  }
+  const char* last = strrchr(path, '/');
+  const intptr_t length = last - path;
+  if ((length == 0) || (last[1] == '\0') ||
+      !IsNormalizedDirectory(path, length)) {
+    return;
+  }
+  directory_ = DirectoryCache::Acquire(
+      Namespace::IsDefault(namespc) ? NULL : namespc->namespc(), ns_.fd(),
+      path, length);
+  if (directory_ != NULL) {
+    fd_ = DirectoryCache::FdOf(directory_);
+    path_ = last + 1;
+  }
+}
+
+CachedNamespaceScope::~CachedNamespaceScope() {
+  if (directory_ != NULL) {
+    DirectoryCache::Release(directory_);
+  }
+}
+
 }  // namespace bin
 }  // namespace dart
 
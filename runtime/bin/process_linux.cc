@@ -9,7 +9,9 @@
 
 #include <errno.h>         // NOLINT
 #include <fcntl.h>         // NOLINT
+#include <gnu/libc-version.h>  // NOLINT
 #include <poll.h>          // NOLINT
+#include <spawn.h>         // NOLINT
 #include <stdio.h>         // NOLINT
 #include <stdlib.h>        // NOLINT
 #include <string.h>        // NOLINT
@@ -31,6 +33,11 @@
 
 extern char** environ;
 
+// Only in glibc 2.29 and later.
+extern "C" int posix_spawn_file_actions_addchdir_np(
+    posix_spawn_file_actions_t* file_actions,
+    const char* path) __attribute__((weak));
+
 namespace dart {
 namespace bin {
 
@@ -70,11 +77,20 @@ class ProcessInfoList {
  public:
   static void AddProcess(pid_t pid, intptr_t fd) {
     MutexLocker locker(mutex_);
+    AddProcessLocked(pid, fd);
+  }
+
+  // Like AddProcess, with mutex() held. Since exits are looked up with
+  // mutex() held, a process started while holding it cannot have its exit
+  // handled before it is added.
+  static void AddProcessLocked(pid_t pid, intptr_t fd) {
     ProcessInfo* info = new ProcessInfo(pid, fd);
     info->set_next(active_processes_);
     active_processes_ = info;
   }
 
+  static Mutex* mutex() { return mutex_; }
+
   static intptr_t LookupProcessExitFd(pid_t pid) {
     MutexLocker locker(mutex_);
     ProcessInfo* current = active_processes_;
@@ -304,6 +320,137 @@ class ProcessStarter {
       return err;
     }
 
+    pid_t pid;
+    err = CanSpawnProcess() ? SpawnProcess(&pid) : ForkProcess(&pid);
+    if (err != 0) {
+      return err;
+    }
+
+    if (Process::ModeHasStdio(mode_)) {
+      // Connect stdio, stdout and stderr.
+      FDUtils::SetNonBlocking(read_in_[0]);
+      *in_ = read_in_[0];
+      close(read_in_[1]);
+      FDUtils::SetNonBlocking(write_out_[1]);
+      *out_ = write_out_[1];
+      close(write_out_[0]);
+      FDUtils::SetNonBlocking(read_err_[0]);
+      *err_ = read_err_[0];
+      close(read_err_[1]);
+    } else {
+      // Close all fds.
+      close(read_in_[0]);
+      close(read_in_[1]);
+      ASSERT(write_out_[0] == -1);
+      ASSERT(write_out_[1] == -1);
+      ASSERT(read_err_[0] == -1);
+      ASSERT(read_err_[1] == -1);
+    }
+    ASSERT(exec_control_[0] == -1);
+    ASSERT(exec_control_[1] == -1);
+
+    *id_ = pid;
+    return 0;
+  }
+
+ private:
+  // Whether posix_spawn can start the process. Unlike fork, it does not
+  // copy the page tables of this process, which takes long for a large
+  // heap. Detached processes, non-default namespaces and PATH searches in a
+  // new environment still need code running in a forked child.
+  bool CanSpawnProcess() {
+    if (!Process::ModeIsAttached(mode_) || !Namespace::IsDefault(namespc_)) {
+      return false;
+    }
+    if ((program_environment_ != NULL) && (strchr(path_, '/') == NULL)) {
+      return false;
+    }
+    if ((working_directory_ != NULL) &&
+        (posix_spawn_file_actions_addchdir_np == NULL)) {
+      return false;
+    }
+    // Before glibc 2.24, posix_spawn does not report a failing exec, but
+    // starts a process that exits with 127.
+    static const bool spawn_reports_exec_errors = []() {
+      int major = 0;
+      int minor = 0;
+      return (sscanf(gnu_get_libc_version(), "%d.%d", &major, &minor) == 2) &&
+             ((major > 2) || ((major == 2) && (minor >= 24)));
+    }();
+    return spawn_reports_exec_errors;
+  }
+
+  int SpawnProcess(pid_t* pid) {
+    // posix_spawn returns the errors of the child, so the exec control pipe
+    // is not needed.
+    ClosePipe(exec_control_);
+
+    posix_spawn_file_actions_t actions;
+    int result = posix_spawn_file_actions_init(&actions);
+    if (result != 0) {
+      errno = result;
+      return CleanupAndReturnError();
+    }
+    if (mode_ == kNormal) {
+      result = posix_spawn_file_actions_adddup2(&actions, write_out_[0],
+                                                STDIN_FILENO);
+      if (result == 0) {
+        result = posix_spawn_file_actions_adddup2(&actions, read_in_[1],
+                                                  STDOUT_FILENO);
+      }
+      if (result == 0) {
+        result = posix_spawn_file_actions_adddup2(&actions, read_err_[1],
+                                                  STDERR_FILENO);
+      }
+    } else {
+      ASSERT(mode_ == kInheritStdio);
+    }
+    if ((result == 0) && (working_directory_ != NULL)) {
+      result =
+          posix_spawn_file_actions_addchdir_np(&actions, working_directory_);
+    }
+
+    int event_fds[2] = {-1, -1};
+    if ((result == 0) &&
+        (TEMP_FAILURE_RETRY(pipe2(event_fds, O_CLOEXEC)) < 0)) {
+      result = errno;
+    }
+    if (result == 0) {
+      char** environment =
+          (program_environment_ != NULL) ? program_environment_ : environ;
+      char* const* arguments = const_cast<char* const*>(program_arguments_);
+      // Registering the process before its exit can be looked up replaces
+      // the start notification the forked child waits for.
+      MutexLocker locker(ProcessInfoList::mutex());
+      if (strchr(path_, '/') == NULL) {
+        result = posix_spawnp(pid, path_, &actions, NULL, arguments,
+                              environment);
+      } else {
+        result =
+            posix_spawn(pid, path_, &actions, NULL, arguments, environment);
+      }
+      if (result == 0) {
+        ExitCodeHandler::ProcessStarted();
+        ProcessInfoList::AddProcessLocked(*pid, event_fds[1]);
+      }
+    }
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (result != 0) {
+      if (event_fds[0] != -1) {
+        close(event_fds[0]);
+        close(event_fds[1]);
+      }
+      errno = result;
+      return CleanupAndReturnError();
+    }
+    *exit_event_ = event_fds[0];
+    FDUtils::SetNonBlocking(event_fds[0]);
+    return 0;
+  }
+
+  int ForkProcess(pid_t* pid_result) {
+    int err;
     // Fork to create the new process.
     pid_t pid = TEMP_FAILURE_RETRY(fork());
     if (pid < 0) {
@@ -362,35 +509,10 @@ class ProcessStarter {
       CloseAllPipes();
       return err;
     }
-
-    if (Process::ModeHasStdio(mode_)) {
-      // Connect stdio, stdout and stderr.
-      FDUtils::SetNonBlocking(read_in_[0]);
-      *in_ = read_in_[0];
-      close(read_in_[1]);
-      FDUtils::SetNonBlocking(write_out_[1]);
-      *out_ = write_out_[1];
-      close(write_out_[0]);
-      FDUtils::SetNonBlocking(read_err_[0]);
-      *err_ = read_err_[0];
-      close(read_err_[1]);
-    } else {
-      // Close all fds.
-      close(read_in_[0]);
-      close(read_in_[1]);
-      ASSERT(write_out_[0] == -1);
-      ASSERT(write_out_[1] == -1);
-      ASSERT(read_err_[0] == -1);
-      ASSERT(read_err_[1] == -1);
-    }
-    ASSERT(exec_control_[0] == -1);
-    ASSERT(exec_control_[1] == -1);
-
-    *id_ = pid;
+    *pid_result = pid;
     return 0;
   }
 
- private:
   int CreatePipes() {
     int result;
     result = TEMP_FAILURE_RETRY(pipe2(exec_control_, O_CLOEXEC));
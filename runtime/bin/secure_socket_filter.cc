@@ -10,9 +10,15 @@
 #include <openssl/ssl.h>
 #include <openssl/x509.h>
 
+#if defined(HOST_OS_LINUX)
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
 #include "bin/lockers.h"
 #include "bin/secure_socket_utils.h"
 #include "bin/security_context.h"
+#include "bin/socket.h"
 #include "platform/syslog.h"
 #include "platform/text_buffer.h"
 
@@ -29,6 +35,8 @@ namespace dart {
 namespace bin {
 
 bool SSLFilter::library_initialized_ = false;
+bool SSLFilter::process_synchronously_ = false;
+bool SSLFilter::kernel_tls_ = false;
 // To protect library initialization.
 Mutex* SSLFilter::mutex_ = new Mutex();
 int SSLFilter::filter_ssl_index;
@@ -175,6 +183,27 @@ void FUNCTION_NAME(SecureSocket_PeerCertificate)(Dart_NativeArguments args) {
   Dart_SetReturnValue(args, cert);
 }
 
+void FUNCTION_NAME(SecureSocket_ProcessesSynchronously)(
+    Dart_NativeArguments args) {
+  Dart_SetBooleanReturnValue(args, SSLFilter::process_synchronously());
+}
+
+void FUNCTION_NAME(SecureSocket_ProcessBuffers)(Dart_NativeArguments args) {
+  bool in_handshake =
+      DartUtils::GetBooleanValue(Dart_GetNativeArgument(args, 1));
+  Dart_Handle positions = ThrowIfError(Dart_GetNativeArgument(args, 2));
+  Dart_SetReturnValue(
+      args, ThrowIfError(GetFilter(args)->ProcessBuffers(positions,
+                                                        in_handshake)));
+}
+
+void FUNCTION_NAME(SecureSocket_EnableKernelTls)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 1));
+  Dart_SetBooleanReturnValue(args,
+                             GetFilter(args)->EnableKernelTls(socket->fd()));
+}
+
 void FUNCTION_NAME(SecureSocket_FilterPointer)(Dart_NativeArguments args) {
   SSLFilter* filter = GetFilter(args);
   // This filter pointer is passed to the IO Service thread. The IO Service
@@ -237,11 +266,53 @@ CObject* SSLFilter::ProcessFilterRequest(const CObjectArray& request) {
   }
 }
 
+Dart_Handle SSLFilter::ProcessBuffers(Dart_Handle positions,
+                                      bool in_handshake) {
+  int starts[kNumBuffers];
+  int ends[kNumBuffers];
+  for (int i = 0; i < kNumBuffers; ++i) {
+    int64_t start;
+    int64_t end;
+    Dart_Handle element = Dart_ListGetAt(positions, 2 * i);
+    RETURN_IF_ERROR(element);
+    RETURN_IF_ERROR(Dart_IntegerToInt64(element, &start));
+    element = Dart_ListGetAt(positions, 2 * i + 1);
+    RETURN_IF_ERROR(element);
+    RETURN_IF_ERROR(Dart_IntegerToInt64(element, &end));
+    starts[i] = static_cast<int>(start);
+    ends[i] = static_cast<int>(end);
+  }
+
+  Dart_Handle result;
+  if (ProcessAllBuffers(starts, ends, in_handshake)) {
+    result = Dart_NewList(kNumBuffers * 2);
+    RETURN_IF_ERROR(result);
+    for (int i = 0; i < kNumBuffers; ++i) {
+      RETURN_IF_ERROR(
+          Dart_ListSetAt(result, 2 * i, Dart_NewInteger(starts[i])));
+      RETURN_IF_ERROR(
+          Dart_ListSetAt(result, 2 * i + 1, Dart_NewInteger(ends[i])));
+    }
+  } else {
+    int32_t error_code = static_cast<int32_t>(ERR_peek_error());
+    TextBuffer error_string(SecureSocketUtils::SSL_ERROR_MESSAGE_BUFFER_SIZE);
+    SecureSocketUtils::FetchErrorString(ssl_, &error_string);
+    result = Dart_NewList(2);
+    RETURN_IF_ERROR(result);
+    RETURN_IF_ERROR(Dart_ListSetAt(result, 0, Dart_NewInteger(error_code)));
+    RETURN_IF_ERROR(
+        Dart_ListSetAt(result, 1, DartUtils::NewString(error_string.buf())));
+  }
+  return result;
+}
+
 bool SSLFilter::ProcessAllBuffers(int starts[kNumBuffers],
                                   int ends[kNumBuffers],
                                   bool in_handshake) {
   for (int i = 0; i < kNumBuffers; ++i) {
     if (in_handshake && (i == kReadPlaintext || i == kWritePlaintext)) continue;
+    // The socket writes the plaintext itself and the kernel encrypts it.
+    if (kernel_tls_tx_ && (i == kWritePlaintext)) continue;
     int start = starts[i];
     int end = ends[i];
     int size = IsBufferEncrypted(i) ? encrypted_buffer_size_ : buffer_size_;
@@ -457,6 +528,7 @@ void SSLFilter::Connect(const char* hostname,
 
   ASSERT(context != NULL);
   ASSERT(context->context() != NULL);
+  context_id_ = context->id();
   ssl_ = SSL_new(context->context());
   SSL_set_bio(ssl_, ssl_side, ssl_side);
   SSL_set_mode(ssl_, SSL_MODE_AUTO_RETRY);  // TODO(whesse): Is this right?
@@ -487,6 +559,13 @@ void SSLFilter::Connect(const char* hostname,
                                          hostname_, strlen(hostname_));
     SecureSocketUtils::CheckStatusSSL(
         status, "TlsException", "Set hostname for certificate checking", ssl_);
+    if (SSLSessionCache::enabled()) {
+      SSL_SESSION* session = SSLSessionCache::Lookup(context_id_, hostname_);
+      if (session != NULL) {
+        SSL_set_session(ssl_, session);
+        SSL_SESSION_free(session);
+      }
+    }
   }
   // Make the connection:
   if (is_server_) {
@@ -570,6 +649,102 @@ void SSLFilter::GetSelectedProtocol(Dart_NativeArguments args) {
   }
 }
 
+#if defined(HOST_OS_LINUX)
+// From linux/tls.h and linux/tcp.h, which older system headers lack.
+#if !defined(TCP_ULP)
+#define TCP_ULP 31
+#endif
+#if !defined(SOL_TLS)
+#define SOL_TLS 282
+#endif
+static const int kTlsTx = 1;
+static const uint16_t kTls12Version = 0x0303;
+static const uint16_t kTlsCipherAesGcm128 = 51;
+static const uint16_t kTlsCipherAesGcm256 = 52;
+// The implicit part of the nonce, and the explicit part and record sequence
+// number which follow the key in tls12_crypto_info_aes_gcm_*.
+static const size_t kTlsSaltLength = 4;
+static const size_t kTlsIVLength = 8;
+static const size_t kTlsSequenceLength = 8;
+static const size_t kTlsMaxKeyLength = 32;
+#endif  // defined(HOST_OS_LINUX)
+
+bool SSLFilter::EnableKernelTls(intptr_t fd) {
+#if defined(HOST_OS_LINUX)
+  if (!kernel_tls_ || kernel_tls_tx_ || (ssl_ == NULL) || SSL_in_init(ssl_) ||
+      (BIO_ctrl_pending(socket_side_) != 0)) {
+    return false;
+  }
+  // Kernel TLS can only take over TLS 1.2 with AES-GCM here: TLS 1.3 needs
+  // the key updates and alerts the filter still sends.
+  if (SSL_version(ssl_) != TLS1_2_VERSION) return false;
+  uint16_t cipher_type;
+  size_t key_length;
+  switch (SSL_CIPHER_get_cipher_nid(SSL_get_current_cipher(ssl_))) {
+    case NID_aes_128_gcm:
+      cipher_type = kTlsCipherAesGcm128;
+      key_length = 16;
+      break;
+    case NID_aes_256_gcm:
+      cipher_type = kTlsCipherAesGcm256;
+      key_length = 32;
+      break;
+    default:
+      return false;
+  }
+
+  // The key block holds the client and server write keys, followed by the
+  // client and server implicit nonces.
+  uint8_t key_block[2 * (kTlsMaxKeyLength + kTlsSaltLength)];
+  const size_t key_block_length = 2 * (key_length + kTlsSaltLength);
+  if ((SSL_get_key_block_len(ssl_) != key_block_length) ||
+      !SSL_generate_key_block(ssl_, key_block, key_block_length)) {
+    return false;
+  }
+  const uint8_t* key = key_block + (is_server_ ? key_length : 0);
+  const uint8_t* salt =
+      key_block + (2 * key_length) + (is_server_ ? kTlsSaltLength : 0);
+
+  // The explicit nonce is the record sequence number, as in BoringSSL.
+  uint8_t sequence[kTlsSequenceLength];
+  const uint64_t write_sequence = SSL_get_write_sequence(ssl_);
+  for (size_t i = 0; i < kTlsSequenceLength; i++) {
+    sequence[i] = static_cast<uint8_t>(
+        write_sequence >> (8 * (kTlsSequenceLength - 1 - i)));
+  }
+
+  // Laid out as struct tls12_crypto_info_aes_gcm_128 or _256.
+  uint8_t crypto_info[2 * sizeof(uint16_t) + kTlsIVLength + kTlsMaxKeyLength +
+                      kTlsSaltLength + kTlsSequenceLength];
+  uint8_t* cursor = crypto_info;
+  memmove(cursor, &kTls12Version, sizeof(kTls12Version));
+  cursor += sizeof(kTls12Version);
+  memmove(cursor, &cipher_type, sizeof(cipher_type));
+  cursor += sizeof(cipher_type);
+  memmove(cursor, sequence, kTlsIVLength);
+  cursor += kTlsIVLength;
+  memmove(cursor, key, key_length);
+  cursor += key_length;
+  memmove(cursor, salt, kTlsSaltLength);
+  cursor += kTlsSaltLength;
+  memmove(cursor, sequence, kTlsSequenceLength);
+  cursor += kTlsSequenceLength;
+
+  const int socket = static_cast<int>(fd);
+  const bool enabled =
+      (setsockopt(socket, IPPROTO_TCP, TCP_ULP, "tls", sizeof("tls")) == 0) &&
+      (setsockopt(socket, SOL_TLS, kTlsTx, crypto_info,
+                  cursor - crypto_info) == 0);
+  OPENSSL_cleanse(key_block, sizeof(key_block));
+  OPENSSL_cleanse(crypto_info, sizeof(crypto_info));
+  if (!enabled) return false;
+  kernel_tls_tx_ = true;
+  return true;
+#else
+  return false;
+#endif  // defined(HOST_OS_LINUX)
+}
+
 void SSLFilter::Renegotiate(bool use_session_cache,
                             bool request_client_certificate,
                             bool require_client_certificate) {
@@ -45,13 +45,33 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
         handshake_complete_(NULL),
         bad_certificate_callback_(NULL),
         in_handshake_(false),
-        hostname_(NULL) {}
+        hostname_(NULL),
+        context_id_(0),
+        bad_certificate_accepted_(false),
+        kernel_tls_tx_(false) {}
 
   ~SSLFilter();
 
   char* hostname() const { return hostname_; }
   bool is_server() const { return is_server_; }
   bool is_client() const { return !is_server_; }
+  intptr_t context_id() const { return context_id_; }
+
+  // Whether a bad certificate callback accepted the peer certificate.
+  bool bad_certificate_accepted() const { return bad_certificate_accepted_; }
+  void set_bad_certificate_accepted() { bad_certificate_accepted_ = true; }
+
+  // Whether _SecureFilter processes its buffers on the isolate thread,
+  // instead of sending them to the IO service.
+  static bool process_synchronously() { return process_synchronously_; }
+  static void set_process_synchronously(bool value) {
+    process_synchronously_ = value;
+  }
+
+  // Whether connected sockets hand encryption of the data they send to the
+  // kernel, where Linux kernel TLS supports the negotiated cipher.
+  static bool kernel_tls() { return kernel_tls_; }
+  static void set_kernel_tls(bool value) { kernel_tls_ = value; }
 
   Dart_Handle Init(Dart_Handle dart_this);
   void Connect(const char* hostname,
@@ -64,6 +84,12 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   void FreeResources();
   void Handshake();
   void GetSelectedProtocol(Dart_NativeArguments args);
+  // Installs the keys for sending on the socket 'fd', so that the kernel
+  // encrypts what is written to it from now on. Returns false if kernel TLS
+  // is disabled or not supported for this connection, which then goes on
+  // encrypting in the filter. Must not be called while buffers are being
+  // processed, and only once all encrypted data has been written out.
+  bool EnableKernelTls(intptr_t fd);
   void Renegotiate(bool use_session_cache,
                    bool request_client_certificate,
                    bool require_client_certificate);
@@ -84,6 +110,9 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   Dart_Handle callback_error;
 
   static CObject* ProcessFilterRequest(const CObjectArray& request);
+  // Like ProcessFilterRequest, on the isolate thread. positions holds the
+  // start and end of each buffer.
+  Dart_Handle ProcessBuffers(Dart_Handle positions, bool in_handshake);
 
   // The index of the external data field in _ssl that points to the SSLFilter.
   static int filter_ssl_index;
@@ -91,6 +120,8 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
  private:
   static const intptr_t kInternalBIOSize;
   static bool library_initialized_;
+  static bool process_synchronously_;
+  static bool kernel_tls_;
   static Mutex* mutex_;  // To protect library initialization.
 
   SSL* ssl_;
@@ -107,6 +138,11 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   bool in_handshake_;
   bool is_server_;
   char* hostname_;
+  intptr_t context_id_;
+  bool bad_certificate_accepted_;
+  // Whether the write plaintext buffer is written to the socket as is,
+  // since the kernel encrypts it.
+  bool kernel_tls_tx_;
 
   static bool IsBufferEncrypted(int i) {
     return static_cast<BufferIndex>(i) >= kFirstEncrypted;
@@ -98,12 +98,23 @@ class _SecureFilterImpl extends NativeFieldWrapperClass1
 
   void _destroy() native "SecureSocket_Destroy";
 
+  bool enableKernelTls(RawSocket socket) =>
+      socket is _RawSocket && _enableKernelTls(socket._socket);
+
+  bool _enableKernelTls(_NativeSocket socket)
+      native "SecureSocket_EnableKernelTls";
+
   void handshake() native "SecureSocket_Handshake";
 
   void rehandshake() => throw new UnimplementedError();
 
   int processBuffer(int bufferIndex) => throw new UnimplementedError();
 
+  bool get processesSynchronously native "SecureSocket_ProcessesSynchronously";
+
+  List processBuffers(bool inHandshake, List<int> positions)
+      native "SecureSocket_ProcessBuffers";
+
   String selectedProtocol() native "SecureSocket_GetSelectedProtocol";
 
   void renegotiate(bool useSessionCache, bool requestClientCertificate,
@@ -35,6 +35,84 @@ namespace bin {
 const char* SSLCertContext::root_certs_file_ = NULL;
 const char* SSLCertContext::root_certs_cache_ = NULL;
 
+bool SSLSessionCache::enabled_ = false;
+Mutex* SSLSessionCache::mutex_ = new Mutex();
+SSLSessionCache::Entry SSLSessionCache::entries_[kMaxEntries];
+intptr_t SSLSessionCache::next_context_id_ = 0;
+int64_t SSLSessionCache::clock_ = 0;
+
+intptr_t SSLSessionCache::NewContextId() {
+  MutexLocker locker(mutex_);
+  return ++next_context_id_;
+}
+
+SSLSessionCache::Entry* SSLSessionCache::Find(intptr_t context_id,
+                                              const char* hostname) {
+  for (intptr_t i = 0; i < kMaxEntries; i++) {
+    Entry* entry = &entries_[i];
+    if ((entry->session != NULL) && (entry->context_id == context_id) &&
+        (strcmp(entry->hostname, hostname) == 0)) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+SSL_SESSION* SSLSessionCache::Lookup(intptr_t context_id,
+                                     const char* hostname) {
+  MutexLocker locker(mutex_);
+  Entry* entry = Find(context_id, hostname);
+  if ((entry == NULL) || !SSL_SESSION_is_resumable(entry->session)) {
+    return NULL;
+  }
+  entry->last_used = ++clock_;
+  SSL_SESSION_up_ref(entry->session);
+  return entry->session;
+}
+
+void SSLSessionCache::Add(intptr_t context_id,
+                          const char* hostname,
+                          SSL_SESSION* session) {
+  MutexLocker locker(mutex_);
+  Entry* entry = Find(context_id, hostname);
+  if (entry == NULL) {
+    // Use a free entry, or else the least recently used one.
+    entry = &entries_[0];
+    for (intptr_t i = 0; i < kMaxEntries; i++) {
+      if (entries_[i].session == NULL) {
+        entry = &entries_[i];
+        break;
+      }
+      if (entries_[i].last_used < entry->last_used) {
+        entry = &entries_[i];
+      }
+    }
+    if (entry->session != NULL) {
+      SSL_SESSION_free(entry->session);
+      free(entry->hostname);
+    }
+    entry->context_id = context_id;
+    entry->hostname = strdup(hostname);
+  } else {
+    SSL_SESSION_free(entry->session);
+  }
+  entry->session = session;
+  entry->last_used = ++clock_;
+}
+
+int SSLCertContext::NewSessionCallback(SSL* ssl, SSL_SESSION* session) {
+  SSLFilter* filter = static_cast<SSLFilter*>(
+      SSL_get_ex_data(ssl, SSLFilter::filter_ssl_index));
+  if ((filter == NULL) || filter->is_server() ||
+      (filter->hostname() == NULL) || filter->bad_certificate_accepted() ||
+      (SSL_get_verify_result(ssl) != X509_V_OK)) {
+    return 0;
+  }
+  SSLSessionCache::Add(filter->context_id(), filter->hostname(), session);
+  // The cache took over the reference to the session.
+  return 1;
+}
+
 int SSLCertContext::CertificateCallback(int preverify_ok,
                                         X509_STORE_CTX* store_ctx) {
   if (preverify_ok == 1) {
@@ -76,7 +154,11 @@ int SSLCertContext::CertificateCallback(int preverify_ok,
     filter->callback_error = result;
     return 0;
   }
-  return DartUtils::GetBooleanValue(result);
+  bool accepted = DartUtils::GetBooleanValue(result);
+  if (accepted) {
+    filter->set_bad_certificate_accepted();
+  }
+  return accepted;
 }
 
 SSLCertContext* SSLCertContext::GetSecurityContext(Dart_NativeArguments args) {
@@ -824,6 +906,16 @@ void FUNCTION_NAME(SecurityContext_Allocate)(Dart_NativeArguments args) {
   SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, SSLCertContext::CertificateCallback);
   SSL_CTX_set_min_proto_version(ctx, TLS1_VERSION);
   SSL_CTX_set_cipher_list(ctx, "HIGH:MEDIUM");
+  if (SSLSessionCache::enabled()) {
+    // Clients keep their sessions in the process-wide SSLSessionCache.
+    // Servers keep theirs in the SSL_CTX, and need a session id context to
+    // resume sessions of connections with client certificates.
+    static const uint8_t kSessionIdContext[] = {'d', 'a', 'r', 't'};
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_BOTH);
+    SSL_CTX_sess_set_new_cb(ctx, SSLCertContext::NewSessionCallback);
+    SSL_CTX_set_session_id_context(ctx, kSessionIdContext,
+                                   sizeof(kSessionIdContext));
+  }
   SSLCertContext* context = new SSLCertContext(ctx);
   Dart_Handle err = SetSecurityContext(args, context);
   if (Dart_IsError(err)) {
@@ -18,6 +18,46 @@ namespace bin {
 // Forward declaration
 class SSLFilter;
 
+// A process-wide cache of the TLS sessions of client connections. Connecting
+// to a host again with the same security context resumes its session instead
+// of doing a full handshake. Sessions are cached only if the peer certificate
+// verified without the help of a bad certificate callback.
+class SSLSessionCache : public AllStatic {
+ public:
+  static bool enabled() { return enabled_; }
+  static void set_enabled(bool value) { enabled_ = value; }
+
+  // Returns a new id for a security context. Ids are not reused, so sessions
+  // of a deleted context are never offered for a new one.
+  static intptr_t NewContextId();
+
+  // Returns a new reference to the session cached for hostname, or NULL.
+  static SSL_SESSION* Lookup(intptr_t context_id, const char* hostname);
+
+  // Caches session for hostname, taking over the caller's reference.
+  static void Add(intptr_t context_id,
+                  const char* hostname,
+                  SSL_SESSION* session);
+
+ private:
+  static const intptr_t kMaxEntries = 256;
+
+  struct Entry {
+    intptr_t context_id;
+    char* hostname;
+    SSL_SESSION* session;
+    int64_t last_used;
+  };
+
+  static Entry* Find(intptr_t context_id, const char* hostname);
+
+  static bool enabled_;
+  static Mutex* mutex_;
+  static Entry entries_[kMaxEntries];
+  static intptr_t next_context_id_;
+  static int64_t clock_;
+};
+
 class SSLCertContext : public ReferenceCounted<SSLCertContext> {
  public:
   static const intptr_t kApproximateSize;
@@ -28,7 +68,8 @@ class SSLCertContext : public ReferenceCounted<SSLCertContext> {
       : ReferenceCounted(),
         context_(context),
         alpn_protocol_string_(NULL),
-        trust_builtin_(false) {}
+        trust_builtin_(false),
+        id_(SSLSessionCache::NewContextId()) {}
 
   ~SSLCertContext() {
     SSL_CTX_free(context_);
@@ -38,6 +79,7 @@ class SSLCertContext : public ReferenceCounted<SSLCertContext> {
   }
 
   static int CertificateCallback(int preverify_ok, X509_STORE_CTX* store_ctx);
+  static int NewSessionCallback(SSL* ssl, SSL_SESSION* session);
 
   static SSLCertContext* GetSecurityContext(Dart_NativeArguments args);
   static const char* GetPasswordArgument(Dart_NativeArguments args,
@@ -68,6 +110,7 @@ class SSLCertContext : public ReferenceCounted<SSLCertContext> {
   void TrustBuiltinRoots();
 
   SSL_CTX* context() const { return context_; }
+  intptr_t id() const { return id_; }
 
   uint8_t* alpn_protocol_string() const { return alpn_protocol_string_; }
 
@@ -96,6 +139,7 @@ class SSLCertContext : public ReferenceCounted<SSLCertContext> {
   uint8_t* alpn_protocol_string_;
 
   bool trust_builtin_;
+  const intptr_t id_;
 
   DISALLOW_COPY_AND_ASSIGN(SSLCertContext);
 };
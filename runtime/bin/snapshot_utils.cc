@@ -4,11 +4,14 @@
 
 #include "bin/snapshot_utils.h"
 
+#include <memory>
+
 #include "bin/dartutils.h"
 #include "bin/dfe.h"
 #include "bin/error_exit.h"
 #include "bin/extensions.h"
 #include "bin/file.h"
+#include "bin/gzip.h"
 #include "bin/platform.h"
 #include "include/dart_api.h"
 #include "platform/utils.h"
@@ -23,9 +26,17 @@ extern const char* kVmSnapshotInstructionsSymbolName;
 extern const char* kIsolateSnapshotDataSymbolName;
 extern const char* kIsolateSnapshotInstructionsSymbolName;
 
-static const int64_t kAppSnapshotHeaderSize = 5 * kInt64Size;
+// The header is the magic number, the sizes of the four sections and flags.
+// Snapshots written before the flags were added have zero padding there.
+static const int64_t kAppSnapshotHeaderSize = 6 * kInt64Size;
 static const int64_t kAppSnapshotPageSize = 4 * KB;
 
+// The data sections are compressed. Each is then laid out as its
+// uncompressed size, the chunk size, the compressed size of every chunk and
+// the chunks, each compressed independently.
+static const int64_t kAppSnapshotCompressedData = 1 << 0;
+static const int64_t kAppSnapshotCompressionChunkSize = 256 * KB;
+
 class MappedAppSnapshot : public AppSnapshot {
  public:
   MappedAppSnapshot(MappedMemory* vm_snapshot_data,
@@ -35,13 +46,26 @@ class MappedAppSnapshot : public AppSnapshot {
       : vm_data_mapping_(vm_snapshot_data),
         vm_instructions_mapping_(vm_snapshot_instructions),
         isolate_data_mapping_(isolate_snapshot_data),
-        isolate_instructions_mapping_(isolate_snapshot_instructions) {}
+        isolate_instructions_mapping_(isolate_snapshot_instructions),
+        vm_data_buffer_(NULL),
+        isolate_data_buffer_(NULL) {}
 
   ~MappedAppSnapshot() {
     delete vm_data_mapping_;
     delete vm_instructions_mapping_;
     delete isolate_data_mapping_;
     delete isolate_instructions_mapping_;
+    free(vm_data_buffer_);
+    free(isolate_data_buffer_);
+  }
+
+  // Takes ownership of data sections decompressed into the C heap, which are
+  // used instead of mappings.
+  void SetDecompressedData(uint8_t* vm_data_buffer,
+                           uint8_t* isolate_data_buffer) {
+    ASSERT((vm_data_mapping_ == NULL) && (isolate_data_mapping_ == NULL));
+    vm_data_buffer_ = vm_data_buffer;
+    isolate_data_buffer_ = isolate_data_buffer;
   }
 
   void SetBuffers(const uint8_t** vm_data_buffer,
@@ -51,6 +75,8 @@ class MappedAppSnapshot : public AppSnapshot {
     if (vm_data_mapping_ != NULL) {
       *vm_data_buffer =
           reinterpret_cast<const uint8_t*>(vm_data_mapping_->address());
+    } else if (vm_data_buffer_ != NULL) {
+      *vm_data_buffer = vm_data_buffer_;
     }
     if (vm_instructions_mapping_ != NULL) {
       *vm_instructions_buffer =
@@ -59,6 +85,8 @@ class MappedAppSnapshot : public AppSnapshot {
     if (isolate_data_mapping_ != NULL) {
       *isolate_data_buffer =
           reinterpret_cast<const uint8_t*>(isolate_data_mapping_->address());
+    } else if (isolate_data_buffer_ != NULL) {
+      *isolate_data_buffer = isolate_data_buffer_;
     }
     if (isolate_instructions_mapping_ != NULL) {
       *isolate_instructions_buffer = reinterpret_cast<const uint8_t*>(
@@ -71,8 +99,62 @@ class MappedAppSnapshot : public AppSnapshot {
   MappedMemory* vm_instructions_mapping_;
   MappedMemory* isolate_data_mapping_;
   MappedMemory* isolate_instructions_mapping_;
+  uint8_t* vm_data_buffer_;
+  uint8_t* isolate_data_buffer_;
 };
 
+// Reads the compressed data section of |size| bytes at |position| and
+// decompresses it into the C heap. Returns NULL if the section is malformed.
+static uint8_t* ReadCompressedData(File* file, int64_t position, int64_t size) {
+  if (size == 0) {
+    return NULL;
+  }
+  int64_t header[2];
+  if ((size < static_cast<int64_t>(sizeof(header))) ||
+      !file->SetPosition(position) ||
+      !file->ReadFully(&header, sizeof(header))) {
+    return NULL;
+  }
+  const int64_t uncompressed_size = header[0];
+  const int64_t chunk_size = header[1];
+  if ((uncompressed_size <= 0) || (chunk_size <= 0)) {
+    return NULL;
+  }
+  const int64_t num_chunks = (uncompressed_size + chunk_size - 1) / chunk_size;
+  const int64_t index_size = num_chunks * kInt64Size;
+  if (index_size > size - static_cast<int64_t>(sizeof(header))) {
+    return NULL;
+  }
+  int64_t* chunk_sizes = reinterpret_cast<int64_t*>(malloc(index_size));
+  uint8_t* compressed = reinterpret_cast<uint8_t*>(
+      malloc(size - sizeof(header) - index_size));
+  uint8_t* data = reinterpret_cast<uint8_t*>(malloc(uncompressed_size));
+  bool ok = file->ReadFully(chunk_sizes, index_size) &&
+            file->ReadFully(compressed, size - sizeof(header) - index_size);
+  int64_t input_cursor = 0;
+  for (int64_t i = 0; ok && (i < num_chunks); i++) {
+    const int64_t output_cursor = i * chunk_size;
+    const int64_t output_length =
+        Utils::Minimum(chunk_size, uncompressed_size - output_cursor);
+    if ((chunk_sizes[i] <= 0) ||
+        (chunk_sizes[i] > size - static_cast<int64_t>(sizeof(header)) -
+                              index_size - input_cursor)) {
+      ok = false;
+      break;
+    }
+    ok = DecompressInto(&compressed[input_cursor], chunk_sizes[i],
+                        &data[output_cursor], output_length);
+    input_cursor += chunk_sizes[i];
+  }
+  free(chunk_sizes);
+  free(compressed);
+  if (!ok) {
+    free(data);
+    return NULL;
+  }
+  return data;
+}
+
 static AppSnapshot* TryReadAppSnapshotBlobs(const char* script_name) {
   File* file = File::Open(NULL, script_name, File::kRead);
   if (file == NULL) {
@@ -82,7 +164,7 @@ static AppSnapshot* TryReadAppSnapshotBlobs(const char* script_name) {
   if (file->Length() < kAppSnapshotHeaderSize) {
     return NULL;
   }
-  int64_t header[5];
+  int64_t header[6];
   ASSERT(sizeof(header) == kAppSnapshotHeaderSize);
   if (!file->ReadFully(&header, kAppSnapshotHeaderSize)) {
     return NULL;
@@ -113,6 +195,22 @@ static AppSnapshot* TryReadAppSnapshotBlobs(const char* script_name) {
         Utils::RoundUp(isolate_instructions_position, kAppSnapshotPageSize);
   }
 
+  // Compressed data sections are decompressed into the C heap instead of
+  // being mapped; the instructions are always mapped.
+  uint8_t* vm_data = NULL;
+  uint8_t* isolate_data = NULL;
+  if ((header[5] & kAppSnapshotCompressedData) != 0) {
+    vm_data = ReadCompressedData(file, vm_data_position, vm_data_size);
+    isolate_data =
+        ReadCompressedData(file, isolate_data_position, isolate_data_size);
+    if (((vm_data_size != 0) && (vm_data == NULL)) ||
+        ((isolate_data_size != 0) && (isolate_data == NULL))) {
+      FATAL1("Failed to decompress snapshot: %s\n", script_name);
+    }
+    vm_data_size = 0;
+    isolate_data_size = 0;
+  }
+
   MappedMemory* vm_data_mapping = NULL;
   if (vm_data_size != 0) {
     vm_data_mapping =
@@ -150,8 +248,11 @@ static AppSnapshot* TryReadAppSnapshotBlobs(const char* script_name) {
     }
   }
 
-  return new MappedAppSnapshot(vm_data_mapping, vm_instr_mapping,
-                               isolate_data_mapping, isolate_instr_mapping);
+  MappedAppSnapshot* snapshot =
+      new MappedAppSnapshot(vm_data_mapping, vm_instr_mapping,
+                            isolate_data_mapping, isolate_instr_mapping);
+  snapshot->SetDecompressedData(vm_data, isolate_data);
+  return snapshot;
 }
 
 #if defined(DART_PRECOMPILED_RUNTIME)
@@ -270,6 +371,73 @@ static bool WriteInt64(File* file, int64_t size) {
   return file->WriteFully(&size, sizeof(size));
 }
 
+// A data section compressed in independent chunks, in the layout described
+// at kAppSnapshotCompressedData.
+class CompressedData {
+ public:
+  CompressedData(const uint8_t* buffer, intptr_t size)
+      : uncompressed_size_(size), num_chunks_(0), chunks_(NULL), size_(0) {
+    if (size == 0) {
+      return;
+    }
+    num_chunks_ = (size + kAppSnapshotCompressionChunkSize - 1) /
+                  kAppSnapshotCompressionChunkSize;
+    chunks_ = new Chunk[num_chunks_];
+    size_ = 2 * kInt64Size + num_chunks_ * kInt64Size;
+    for (intptr_t i = 0; i < num_chunks_; i++) {
+      const intptr_t offset = i * kAppSnapshotCompressionChunkSize;
+      const intptr_t length =
+          Utils::Minimum(kAppSnapshotCompressionChunkSize, size - offset);
+      Compress(&buffer[offset], length, &chunks_[i].data, &chunks_[i].size);
+      size_ += chunks_[i].size;
+    }
+  }
+
+  ~CompressedData() {
+    for (intptr_t i = 0; i < num_chunks_; i++) {
+      free(chunks_[i].data);
+    }
+    delete[] chunks_;
+  }
+
+  // The size of the section in the file.
+  intptr_t size() const { return size_; }
+
+  bool Write(File* file) const {
+    if (uncompressed_size_ == 0) {
+      return true;
+    }
+    if (!WriteInt64(file, uncompressed_size_) ||
+        !WriteInt64(file, kAppSnapshotCompressionChunkSize)) {
+      return false;
+    }
+    for (intptr_t i = 0; i < num_chunks_; i++) {
+      if (!WriteInt64(file, chunks_[i].size)) {
+        return false;
+      }
+    }
+    for (intptr_t i = 0; i < num_chunks_; i++) {
+      if (!file->WriteFully(chunks_[i].data, chunks_[i].size)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  struct Chunk {
+    uint8_t* data;
+    intptr_t size;
+  };
+
+  intptr_t uncompressed_size_;
+  intptr_t num_chunks_;
+  Chunk* chunks_;
+  intptr_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompressedData);
+};
+
 void Snapshot::WriteAppSnapshot(const char* filename,
                                 uint8_t* vm_data_buffer,
                                 intptr_t vm_data_size,
@@ -278,24 +446,43 @@ void Snapshot::WriteAppSnapshot(const char* filename,
                                 uint8_t* isolate_data_buffer,
                                 intptr_t isolate_data_size,
                                 uint8_t* isolate_instructions_buffer,
-                                intptr_t isolate_instructions_size) {
+                                intptr_t isolate_instructions_size,
+                                bool compress_data) {
   File* file = File::Open(NULL, filename, File::kWriteTruncate);
   if (file == NULL) {
     ErrorExit(kErrorExitCode, "Unable to write snapshot file '%s'\n", filename);
   }
 
+  std::unique_ptr<CompressedData> vm_data;
+  std::unique_ptr<CompressedData> isolate_data;
+  if (compress_data) {
+    vm_data.reset(new CompressedData(vm_data_buffer, vm_data_size));
+    isolate_data.reset(new CompressedData(isolate_data_buffer,
+                                          isolate_data_size));
+    if (Dart_IsVMFlagSet("print_snapshot_sizes")) {
+      Syslog::Print("CompressedVMData(CodeSize): %" Pd "\n", vm_data->size());
+      Syslog::Print("CompressedIsolateData(CodeSize): %" Pd "\n",
+                    isolate_data->size());
+      Syslog::Print("CompressionSaved(CodeSize): %" Pd "\n",
+                    vm_data_size + isolate_data_size - vm_data->size() -
+                        isolate_data->size());
+    }
+  }
+
   file->WriteFully(appjit_magic_number.bytes, appjit_magic_number.length);
-  WriteInt64(file, vm_data_size);
+  WriteInt64(file, compress_data ? vm_data->size() : vm_data_size);
   WriteInt64(file, vm_instructions_size);
-  WriteInt64(file, isolate_data_size);
+  WriteInt64(file, compress_data ? isolate_data->size() : isolate_data_size);
   WriteInt64(file, isolate_instructions_size);
+  WriteInt64(file, compress_data ? kAppSnapshotCompressedData : 0);
   ASSERT(file->Position() == kAppSnapshotHeaderSize);
 
   file->SetPosition(Utils::RoundUp(file->Position(), kAppSnapshotPageSize));
   if (LOG_SECTION_BOUNDARIES) {
     Syslog::PrintErr("%" Px64 ": VM Data\n", file->Position());
   }
-  if (!file->WriteFully(vm_data_buffer, vm_data_size)) {
+  if (compress_data ? !vm_data->Write(file)
+                    : !file->WriteFully(vm_data_buffer, vm_data_size)) {
     ErrorExit(kErrorExitCode, "Unable to write snapshot file '%s'\n", filename);
   }
 
@@ -314,7 +501,9 @@ void Snapshot::WriteAppSnapshot(const char* filename,
   if (LOG_SECTION_BOUNDARIES) {
     Syslog::PrintErr("%" Px64 ": Isolate Data\n", file->Position());
   }
-  if (!file->WriteFully(isolate_data_buffer, isolate_data_size)) {
+  if (compress_data ? !isolate_data->Write(file)
+                    : !file->WriteFully(isolate_data_buffer,
+                                        isolate_data_size)) {
     ErrorExit(kErrorExitCode, "Unable to write snapshot file '%s'\n", filename);
   }
 
@@ -357,7 +546,8 @@ void Snapshot::GenerateKernel(const char* snapshot_filename,
 #endif  // !defined(EXCLUDE_CFE_AND_KERNEL_PLATFORM) && !defined(TESTING)
 }
 
-void Snapshot::GenerateAppJIT(const char* snapshot_filename) {
+void Snapshot::GenerateAppJIT(const char* snapshot_filename,
+                              bool compress_data) {
 #if defined(TARGET_ARCH_IA32)
   // Snapshots with code are not supported on IA32.
   uint8_t* isolate_buffer = NULL;
@@ -370,7 +560,7 @@ void Snapshot::GenerateAppJIT(const char* snapshot_filename) {
   }
 
   WriteAppSnapshot(snapshot_filename, NULL, 0, NULL, 0, isolate_buffer,
-                   isolate_size, NULL, 0);
+                   isolate_size, NULL, 0, compress_data);
 #else
   uint8_t* isolate_data_buffer = NULL;
   intptr_t isolate_data_size = 0;
@@ -384,7 +574,7 @@ void Snapshot::GenerateAppJIT(const char* snapshot_filename) {
   }
   WriteAppSnapshot(snapshot_filename, NULL, 0, NULL, 0, isolate_data_buffer,
                    isolate_data_size, isolate_instructions_buffer,
-                   isolate_instructions_size);
+                   isolate_instructions_size, compress_data);
 #endif
 }
 
@@ -410,7 +600,8 @@ void Snapshot::GenerateAppAOTAsBlobs(const char* snapshot_filename,
   WriteAppSnapshot(snapshot_filename, vm_data_buffer, vm_data_size,
                    vm_instructions_buffer, vm_instructions_size,
                    isolate_data_buffer, isolate_data_size,
-                   isolate_instructions_buffer, isolate_instructions_size);
+                   isolate_instructions_buffer, isolate_instructions_size,
+                   /*compress_data=*/false);
 }
 
 static void StreamingWriteCallback(void* callback_data,
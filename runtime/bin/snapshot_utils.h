@@ -31,7 +31,9 @@ class Snapshot {
   static void GenerateKernel(const char* snapshot_filename,
                              const char* script_name,
                              const char* package_config);
-  static void GenerateAppJIT(const char* snapshot_filename);
+  // With |compress_data|, the data sections of the snapshot are compressed
+  // and decompressed into the C heap when it is read, instead of being mapped.
+  static void GenerateAppJIT(const char* snapshot_filename, bool compress_data);
   static void GenerateAppAOTAsBlobs(const char* snapshot_filename,
                                     const uint8_t* shared_data,
                                     const uint8_t* shared_instructions);
@@ -46,7 +48,8 @@ class Snapshot {
                                uint8_t* isolate_data_buffer,
                                intptr_t isolate_data_size,
                                uint8_t* isolate_instructions_buffer,
-                               intptr_t isolate_instructions_size);
+                               intptr_t isolate_instructions_size,
+                               bool compress_data);
 
  private:
   DISALLOW_ALLOCATION();
@@ -4,8 +4,11 @@
 
 #include "bin/socket.h"
 
+#include <errno.h>  // NOLINT
+
 #include "bin/dartutils.h"
 #include "bin/eventhandler.h"
+#include "bin/file.h"
 #include "bin/io_buffer.h"
 #include "bin/isolate_data.h"
 #include "bin/lockers.h"
@@ -27,6 +30,86 @@ ListeningSocketRegistry* globalTcpListeningSocketRegistry = NULL;
 
 bool Socket::short_socket_read_ = false;
 bool Socket::short_socket_write_ = false;
+intptr_t Socket::busy_poll_microseconds_ = 0;
+
+intptr_t HostLookupCache::ttl_seconds_ = 0;
+Mutex* HostLookupCache::mutex_ = new Mutex();
+HostLookupCache::Entry HostLookupCache::entries_[kMaxEntries];
+
+HostLookupCache::Entry* HostLookupCache::Find(const char* host, int type) {
+  for (intptr_t i = 0; i < kMaxEntries; i++) {
+    Entry* entry = &entries_[i];
+    if ((entry->host != NULL) && (entry->type == type) &&
+        (strcmp(entry->host, host) == 0)) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+void HostLookupCache::Clear(Entry* entry) {
+  free(entry->host);
+  delete[] entry->addresses;
+  entry->host = NULL;
+  entry->addresses = NULL;
+  entry->count = 0;
+}
+
+AddressList<SocketAddress>* HostLookupCache::Lookup(const char* host,
+                                                    int type) {
+  if (ttl_seconds_ <= 0) {
+    return NULL;
+  }
+  MutexLocker ml(mutex_);
+  Entry* entry = Find(host, type);
+  if (entry == NULL) {
+    return NULL;
+  }
+  if (entry->expires <= TimerUtils::GetCurrentMonotonicMillis()) {
+    Clear(entry);
+    return NULL;
+  }
+  AddressList<SocketAddress>* addresses =
+      new AddressList<SocketAddress>(entry->count);
+  for (intptr_t i = 0; i < entry->count; i++) {
+    RawAddr addr = entry->addresses[i];
+    addresses->SetAt(i, new SocketAddress(&addr.addr));
+  }
+  return addresses;
+}
+
+void HostLookupCache::Add(const char* host,
+                          int type,
+                          const AddressList<SocketAddress>& addresses) {
+  if (ttl_seconds_ <= 0) {
+    return;
+  }
+  int64_t now = TimerUtils::GetCurrentMonotonicMillis();
+  MutexLocker ml(mutex_);
+  Entry* entry = Find(host, type);
+  if (entry == NULL) {
+    // Use a free entry, or else the one that expires first.
+    entry = &entries_[0];
+    for (intptr_t i = 0; i < kMaxEntries; i++) {
+      if (entries_[i].host == NULL) {
+        entry = &entries_[i];
+        break;
+      }
+      if (entries_[i].expires < entry->expires) {
+        entry = &entries_[i];
+      }
+    }
+  }
+  Clear(entry);
+  entry->host = strdup(host);
+  entry->type = type;
+  entry->count = addresses.count();
+  entry->addresses = new RawAddr[entry->count];
+  for (intptr_t i = 0; i < entry->count; i++) {
+    entry->addresses[i] = addresses.GetAt(i)->addr();
+  }
+  entry->expires = now + ttl_seconds_ * kMillisecondsPerSecond;
+}
 
 void ListeningSocketRegistry::Initialize() {
   ASSERT(globalTcpListeningSocketRegistry == NULL);
@@ -156,6 +239,15 @@ Dart_Handle ListeningSocketRegistry::CreateBindListen(Dart_Handle socket_object,
     OSError os_error(-1, "Failed to start accept", OSError::kUnknown);
     return DartUtils::NewDartOSError(&os_error);
   }
+#if !defined(HOST_OS_WINDOWS)
+  if (addr.addr.sa_family == AF_UNIX) {
+    // A Unix domain socket has no port to share it by, and binding its path
+    // a second time fails, so it is not registered.
+    Socket::SetSocketIdNativeField(socket_object, fd,
+                                   Socket::kFinalizerListening);
+    return Dart_True();
+  }
+#endif
   intptr_t allocated_port = SocketBase::GetPort(fd);
   ASSERT(allocated_port > 0);
 
@@ -313,6 +405,14 @@ void FUNCTION_NAME(Socket_CreateBindDatagram)(Dart_NativeArguments args) {
 void FUNCTION_NAME(Socket_Available)(Dart_NativeArguments args) {
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  if (socket->udp_received_next() < socket->udp_received_count()) {
+    // Datagrams of the last batch are still to be returned by
+    // Socket_RecvFrom.
+    const intptr_t length =
+        socket->udp_received()[socket->udp_received_next()].length;
+    Dart_SetIntegerReturnValue(args, Utils::Maximum<intptr_t>(length, 1));
+    return;
+  }
   intptr_t available = SocketBase::Available(socket->fd());
   if (available >= 0) {
     Dart_SetIntegerReturnValue(args, available);
@@ -332,40 +432,37 @@ void FUNCTION_NAME(Socket_Read)(Dart_NativeArguments args) {
     if (Socket::short_socket_read()) {
       length = (length + 1) / 2;
     }
-    uint8_t* buffer = NULL;
-    Dart_Handle result = IOBuffer::Allocate(length, &buffer);
-    if (Dart_IsNull(result)) {
+    // Read into plain storage first, so that a short read can shrink it
+    // before the Uint8List is created instead of copying into a second one.
+    uint8_t* buffer = IOBuffer::Allocate(length);
+    if (buffer == NULL) {
       Dart_SetReturnValue(args, DartUtils::NewDartOSError());
       return;
     }
-    if (Dart_IsError(result)) {
-      Dart_PropagateError(result);
-    }
-    ASSERT(buffer != NULL);
     intptr_t bytes_read =
         SocketBase::Read(socket->fd(), buffer, length, SocketBase::kAsync);
-    if (bytes_read == length) {
-      Dart_SetReturnValue(args, result);
-    } else if (bytes_read > 0) {
-      uint8_t* new_buffer = NULL;
-      Dart_Handle new_result = IOBuffer::Allocate(bytes_read, &new_buffer);
-      if (Dart_IsNull(new_result)) {
-        Dart_SetReturnValue(args, DartUtils::NewDartOSError());
-        return;
-      }
-      if (Dart_IsError(new_result)) {
-        Dart_PropagateError(new_result);
+    if (bytes_read > 0) {
+      if (bytes_read < length) {
+        uint8_t* new_buffer = IOBuffer::Reallocate(buffer, bytes_read);
+        if (new_buffer == NULL) {
+          IOBuffer::Free(buffer);
+          Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+          return;
+        }
+        buffer = new_buffer;
       }
-      ASSERT(new_buffer != NULL);
-      memmove(new_buffer, buffer, bytes_read);
-      Dart_SetReturnValue(args, new_result);
+      Dart_SetReturnValue(args, IOBuffer::Wrap(buffer, bytes_read));
     } else if (bytes_read == 0) {
       // On MacOS when reading from a tty Ctrl-D will result in reading one
       // less byte then reported as available.
+      IOBuffer::Free(buffer);
       Dart_SetReturnValue(args, Dart_Null());
     } else {
       ASSERT(bytes_read == -1);
-      Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+      // Create the error before free() can clobber errno.
+      Dart_Handle error = DartUtils::NewDartOSError();
+      IOBuffer::Free(buffer);
+      Dart_SetReturnValue(args, error);
     }
   } else {
     OSError os_error(-1, "Invalid argument", OSError::kUnknown);
@@ -373,6 +470,62 @@ void FUNCTION_NAME(Socket_Read)(Dart_NativeArguments args) {
   }
 }
 
+void FUNCTION_NAME(Socket_ReadInto)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  Dart_Handle buffer_obj = Dart_GetNativeArgument(args, 1);
+  // start and end arguments are checked in Dart code to be integers and
+  // have the property that start <= end <= list.length. Therefore, it is
+  // safe to extract their value as intptr_t.
+  intptr_t start = DartUtils::GetNativeIntptrArgument(args, 2);
+  intptr_t end = DartUtils::GetNativeIntptrArgument(args, 3);
+  intptr_t length = end - start;
+  if (Socket::short_socket_read()) {
+    length = (length + 1) / 2;
+  }
+
+  intptr_t bytes_read;
+  Dart_TypedData_Type type = Dart_GetTypeOfTypedData(buffer_obj);
+  if ((type == Dart_TypedData_kUint8) || (type == Dart_TypedData_kInt8)) {
+    // Read directly into the caller's buffer.
+    void* data = NULL;
+    intptr_t data_length = 0;
+    Dart_Handle result =
+        Dart_TypedDataAcquireData(buffer_obj, &type, &data, &data_length);
+    if (Dart_IsError(result)) {
+      Dart_PropagateError(result);
+    }
+    ASSERT(end <= data_length);
+    bytes_read = SocketBase::Read(socket->fd(),
+                                  reinterpret_cast<uint8_t*>(data) + start,
+                                  length, SocketBase::kAsync);
+    // Releasing the data must not clobber the error from the read.
+    const int read_errno = errno;
+    result = Dart_TypedDataReleaseData(buffer_obj);
+    if (Dart_IsError(result)) {
+      Dart_PropagateError(result);
+    }
+    errno = read_errno;
+  } else {
+    uint8_t* buffer = Dart_ScopeAllocate(length);
+    bytes_read =
+        SocketBase::Read(socket->fd(), buffer, length, SocketBase::kAsync);
+    if (bytes_read > 0) {
+      Dart_Handle result =
+          Dart_ListSetAsBytes(buffer_obj, start, buffer, bytes_read);
+      if (Dart_IsError(result)) {
+        Dart_PropagateError(result);
+      }
+    }
+  }
+  if (bytes_read >= 0) {
+    Dart_SetIntegerReturnValue(args, bytes_read);
+  } else {
+    ASSERT(bytes_read == -1);
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+  }
+}
+
 void FUNCTION_NAME(Socket_RecvFrom)(Dart_NativeArguments args) {
   // TODO(sgjesse): Use a MTU value here. Only the loopback adapter can
   // handle 64k datagrams.
@@ -380,25 +533,45 @@ void FUNCTION_NAME(Socket_RecvFrom)(Dart_NativeArguments args) {
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
 
-  // Ensure that a receive buffer for the UDP socket exists.
+  // Ensure that a receive buffer for the UDP socket exists. It has a slot for
+  // each datagram of a batch.
   ASSERT(socket != NULL);
   uint8_t* recv_buffer = socket->udp_receive_buffer();
   if (recv_buffer == NULL) {
-    recv_buffer = reinterpret_cast<uint8_t*>(malloc(kReceiveBufferLen));
+    recv_buffer = reinterpret_cast<uint8_t*>(
+        malloc(kReceiveBufferLen * SocketBase::kMaxRecvBatch));
     socket->set_udp_receive_buffer(recv_buffer);
+    socket->set_udp_received(reinterpret_cast<SocketBase::ReceivedDatagram*>(
+        malloc(sizeof(SocketBase::ReceivedDatagram) *
+               SocketBase::kMaxRecvBatch)));
   }
 
-  // Read data into the buffer.
-  RawAddr addr;
-  const intptr_t bytes_read = SocketBase::RecvFrom(
-      socket->fd(), recv_buffer, kReceiveBufferLen, &addr, SocketBase::kAsync);
-  if (bytes_read == 0) {
+  // Receive the next batch of datagrams once the last one is used up, so a
+  // read event hands out a whole batch with one system call.
+  if (socket->udp_received_next() == socket->udp_received_count()) {
+    const intptr_t received = SocketBase::RecvFromBatch(
+        socket->fd(), recv_buffer, kReceiveBufferLen,
+        SocketBase::kMaxRecvBatch, socket->udp_received(),
+        SocketBase::kAsync);
+    if (received < 0) {
+      ASSERT(received == -1);
+      socket->set_udp_received_range(0, 0);
+      Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+      return;
+    }
+    socket->set_udp_received_range(0, received);
+  }
+  if (socket->udp_received_next() == socket->udp_received_count()) {
     Dart_SetReturnValue(args, Dart_Null());
     return;
   }
-  if (bytes_read < 0) {
-    ASSERT(bytes_read == -1);
-    Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+  const intptr_t index = socket->udp_received_next();
+  socket->set_udp_received_range(index + 1, socket->udp_received_count());
+  const intptr_t bytes_read = socket->udp_received()[index].length;
+  RawAddr addr = socket->udp_received()[index].addr;
+  recv_buffer += index * kReceiveBufferLen;
+  if (bytes_read == 0) {
+    Dart_SetReturnValue(args, Dart_Null());
     return;
   }
 
@@ -418,18 +591,16 @@ void FUNCTION_NAME(Socket_RecvFrom)(Dart_NativeArguments args) {
 
   // Get the port and clear it in the sockaddr structure.
   int port = SocketAddress::GetAddrPort(addr);
-  if (addr.addr.sa_family == AF_INET) {
-    addr.in.sin_port = 0;
-  } else {
-    ASSERT(addr.addr.sa_family == AF_INET6);
-    addr.in6.sin6_port = 0;
-  }
+  SocketAddress::SetAddrPort(&addr, 0);
   // Format the address to a string using the numeric format.
-  char numeric_address[INET6_ADDRSTRLEN];
-  SocketBase::FormatNumericAddress(addr, numeric_address, INET6_ADDRSTRLEN);
+  char numeric_address[SocketAddress::kMaxAddressStringLength];
+  if (!SocketBase::FormatNumericAddress(addr, numeric_address,
+                                        sizeof(numeric_address))) {
+    numeric_address[0] = '\0';
+  }
 
   // Create a Datagram object with the data and sender address and port.
-  const int kNumArgs = 4;
+  const int kNumArgs = 5;
   Dart_Handle dart_args[kNumArgs];
   dart_args[0] = data;
   dart_args[1] = Dart_NewStringFromCString(numeric_address);
@@ -441,6 +612,7 @@ void FUNCTION_NAME(Socket_RecvFrom)(Dart_NativeArguments args) {
   if (Dart_IsError(dart_args[3])) {
     Dart_PropagateError(dart_args[3]);
   }
+  dart_args[4] = Dart_NewInteger(SocketAddress::GetAddrType(addr));
   // TODO(sgjesse): Cache the _makeDatagram function somewhere.
   Dart_Handle io_lib = Dart_LookupLibrary(DartUtils::NewString("dart:io"));
   if (Dart_IsError(io_lib)) {
@@ -494,6 +666,121 @@ void FUNCTION_NAME(Socket_WriteList)(Dart_NativeArguments args) {
   }
 }
 
+void FUNCTION_NAME(Socket_WriteBuffers)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  Dart_Handle buffers_obj = Dart_GetNativeArgument(args, 1);
+  Dart_Handle offsets_obj = Dart_GetNativeArgument(args, 2);
+  Dart_Handle lengths_obj = Dart_GetNativeArgument(args, 3);
+  intptr_t count = 0;
+  Dart_Handle result = Dart_ListLength(buffers_obj, &count);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  ASSERT(count <= SocketBase::kMaxWriteBuffers);
+  Dart_Handle buffer_objs[SocketBase::kMaxWriteBuffers];
+  intptr_t offsets[SocketBase::kMaxWriteBuffers];
+  SocketBase::WriteBuffer buffers[SocketBase::kMaxWriteBuffers];
+  intptr_t total_length = 0;
+  for (intptr_t i = 0; i < count; i++) {
+    buffer_objs[i] = ThrowIfError(Dart_ListGetAt(buffers_obj, i));
+    offsets[i] = DartUtils::GetIntptrValue(
+        ThrowIfError(Dart_ListGetAt(offsets_obj, i)));
+    buffers[i].length = DartUtils::GetIntptrValue(
+        ThrowIfError(Dart_ListGetAt(lengths_obj, i)));
+    total_length += buffers[i].length;
+  }
+  bool short_write = false;
+  if (Socket::short_socket_write()) {
+    if (total_length > 1) {
+      short_write = true;
+    }
+    intptr_t remaining = (total_length + 1) / 2;
+    for (intptr_t i = 0; i < count; i++) {
+      buffers[i].length = Utils::Minimum(buffers[i].length, remaining);
+      remaining -= buffers[i].length;
+    }
+  }
+
+  // All buffers stay acquired for the duration of the write.
+  intptr_t acquired = 0;
+  for (; acquired < count; acquired++) {
+    Dart_TypedData_Type type;
+    uint8_t* data = NULL;
+    intptr_t len;
+    result = Dart_TypedDataAcquireData(buffer_objs[acquired], &type,
+                                       reinterpret_cast<void**>(&data), &len);
+    if (Dart_IsError(result)) {
+      break;
+    }
+    ASSERT((offsets[acquired] + buffers[acquired].length) <= len);
+    buffers[acquired].data = data + offsets[acquired];
+  }
+  if (acquired < count) {
+    for (intptr_t i = 0; i < acquired; i++) {
+      Dart_TypedDataReleaseData(buffer_objs[i]);
+    }
+    Dart_PropagateError(result);
+  }
+
+  intptr_t bytes_written =
+      SocketBase::WriteV(socket->fd(), buffers, count, SocketBase::kAsync);
+  // Extract OSError before we release data, as it may override the error.
+  OSError os_error;
+  for (intptr_t i = 0; i < count; i++) {
+    Dart_TypedDataReleaseData(buffer_objs[i]);
+  }
+  if (bytes_written >= 0) {
+    if (short_write) {
+      // If the write was forced 'short', indicate by returning the negative
+      // number of bytes. A forced short write may not trigger a write event.
+      Dart_SetIntegerReturnValue(args, -bytes_written);
+    } else {
+      Dart_SetIntegerReturnValue(args, bytes_written);
+    }
+  } else {
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError(&os_error));
+  }
+}
+
+void FUNCTION_NAME(Socket_SendFile)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  File* file = NULL;
+  Dart_Handle result = Dart_GetNativeInstanceField(
+      Dart_GetNativeArgument(args, 1), 0, reinterpret_cast<intptr_t*>(&file));
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  int64_t offset = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 2), 0, kMaxInt64);
+  intptr_t length = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 3));
+  if ((file == NULL) || file->IsClosed()) {
+    Dart_SetReturnValue(args, DartUtils::NewDartArgumentError("File closed"));
+    return;
+  }
+  bool short_write = false;
+  if (Socket::short_socket_write()) {
+    if (length > 1) {
+      short_write = true;
+    }
+    length = (length + 1) / 2;
+  }
+  intptr_t bytes_written = SocketBase::SendFile(
+      socket->fd(), file->GetFD(), offset, length, SocketBase::kAsync);
+  if (bytes_written >= 0) {
+    if (short_write) {
+      // If the write was forced 'short', indicate by returning the negative
+      // number of bytes. A forced short write may not trigger a write event.
+      Dart_SetIntegerReturnValue(args, -bytes_written);
+    } else {
+      Dart_SetIntegerReturnValue(args, bytes_written);
+    }
+  } else {
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+  }
+}
+
 void FUNCTION_NAME(Socket_SendTo)(Dart_NativeArguments args) {
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
@@ -657,7 +944,14 @@ CObject* Socket::LookupRequest(const CObjectArray& request) {
     CObject* result = NULL;
     OSError* os_error = NULL;
     AddressList<SocketAddress>* addresses =
-        SocketBase::LookupAddress(host.CString(), type.Value(), &os_error);
+        HostLookupCache::Lookup(host.CString(), type.Value());
+    if (addresses == NULL) {
+      addresses =
+          SocketBase::LookupAddress(host.CString(), type.Value(), &os_error);
+      if (addresses != NULL) {
+        HostLookupCache::Add(host.CString(), type.Value(), *addresses);
+      }
+    }
     if (addresses != NULL) {
       CObjectArray* array =
           new CObjectArray(CObject::NewArray(addresses->count() + 1));
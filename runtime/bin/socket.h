@@ -59,6 +59,26 @@ class Socket : public ReferenceCounted<Socket> {
   uint8_t* udp_receive_buffer() const { return udp_receive_buffer_; }
   void set_udp_receive_buffer(uint8_t* buffer) { udp_receive_buffer_ = buffer; }
 
+  // The datagrams of the last batch received into udp_receive_buffer, of
+  // which Socket_RecvFrom has not yet returned the ones from index
+  // udp_received_next on.
+  SocketBase::ReceivedDatagram* udp_received() const { return udp_received_; }
+  void set_udp_received(SocketBase::ReceivedDatagram* datagrams) {
+    udp_received_ = datagrams;
+  }
+  intptr_t udp_received_count() const { return udp_received_count_; }
+  intptr_t udp_received_next() const { return udp_received_next_; }
+  void set_udp_received_range(intptr_t next, intptr_t count) {
+    udp_received_next_ = next;
+    udp_received_count_ = count;
+  }
+
+  // The index of the event handler thread that handles this socket, or -1
+  // while no command for it has been sent. See GetEventHandler() in
+  // eventhandler.cc.
+  intptr_t event_handler() const { return event_handler_; }
+  void set_event_handler(intptr_t index) { event_handler_ = index; }
+
   static bool Initialize();
 
   // Creates a socket which is bound and connected. The port to connect to is
@@ -98,6 +118,14 @@ class Socket : public ReferenceCounted<Socket> {
     short_socket_write_ = short_socket_write;
   }
 
+  // On Linux, the SO_BUSY_POLL time in microseconds given to connected,
+  // accepted and datagram sockets, so that reads poll the device queue
+  // instead of waiting for its interrupt. 0 leaves the system default.
+  static intptr_t busy_poll_microseconds() { return busy_poll_microseconds_; }
+  static void set_busy_poll_microseconds(intptr_t value) {
+    busy_poll_microseconds_ = value;
+  }
+
   static bool IsSignalSocketFlag(intptr_t flag) {
     return ((flag & (0x1 << kInternalSignalSocket)) != 0);
   }
@@ -107,17 +135,24 @@ class Socket : public ReferenceCounted<Socket> {
     ASSERT(fd_ == kClosedFd);
     free(udp_receive_buffer_);
     udp_receive_buffer_ = NULL;
+    free(udp_received_);
+    udp_received_ = NULL;
   }
 
   static const int kClosedFd = -1;
 
   static bool short_socket_read_;
   static bool short_socket_write_;
+  static intptr_t busy_poll_microseconds_;
 
   intptr_t fd_;
   Dart_Port isolate_port_;
   Dart_Port port_;
   uint8_t* udp_receive_buffer_;
+  SocketBase::ReceivedDatagram* udp_received_;
+  intptr_t udp_received_count_;
+  intptr_t udp_received_next_;
+  intptr_t event_handler_;
 
   friend class ReferenceCounted<Socket>;
   DISALLOW_COPY_AND_ASSIGN(Socket);
@@ -150,6 +185,40 @@ class ServerSocket {
   DISALLOW_IMPLICIT_CONSTRUCTORS(ServerSocket);
 };
 
+// A process-wide cache of the results of host name lookups, shared by all
+// IOService threads. getaddrinfo does not report the TTLs of the records, so
+// entries expire after a fixed time set with set_ttl_seconds. The cache is
+// disabled while that time is 0. Failed lookups are not cached.
+class HostLookupCache : public AllStatic {
+ public:
+  static intptr_t ttl_seconds() { return ttl_seconds_; }
+  static void set_ttl_seconds(intptr_t value) { ttl_seconds_ = value; }
+
+  // Returns a copy of the addresses cached for host and type, or NULL.
+  static AddressList<SocketAddress>* Lookup(const char* host, int type);
+  static void Add(const char* host,
+                  int type,
+                  const AddressList<SocketAddress>& addresses);
+
+ private:
+  static const intptr_t kMaxEntries = 64;
+
+  struct Entry {
+    char* host;
+    int type;
+    RawAddr* addresses;
+    intptr_t count;
+    int64_t expires;
+  };
+
+  static Entry* Find(const char* host, int type);
+  static void Clear(Entry* entry);
+
+  static intptr_t ttl_seconds_;
+  static Mutex* mutex_;
+  static Entry entries_[kMaxEntries];
+};
+
 class ListeningSocketRegistry {
  public:
   ListeningSocketRegistry()
@@ -19,26 +19,104 @@
 namespace dart {
 namespace bin {
 
-int SocketAddress::GetType() {
-  if (addr_.ss.ss_family == AF_INET6) {
+#if !defined(HOST_OS_WINDOWS)
+#if defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID)
+static const bool kHasAbstractNamespace = true;
+#else
+static const bool kHasAbstractNamespace = false;
+#endif
+
+static const intptr_t kUnixPathOffset = offsetof(struct sockaddr_un, sun_path);
+static const intptr_t kUnixPathSize =
+    sizeof(reinterpret_cast<struct sockaddr_un*>(0)->sun_path);
+
+// An abstract name follows a NUL byte. An unnamed address, such as the peer
+// of a connected client that did not bind, has no name at all.
+static bool IsAbstractUnixAddress(const RawAddr& addr) {
+  return kHasAbstractNamespace && (addr.un.sun_path[0] == '\0') &&
+         (addr.un.sun_path[1] != '\0');
+}
+
+// The length of the path as Dart sees it, which counts the '@' of an
+// abstract name.
+static intptr_t UnixPathLength(const RawAddr& addr) {
+  if (IsAbstractUnixAddress(addr)) {
+    return 1 + strnlen(addr.un.sun_path + 1, kUnixPathSize - 1);
+  }
+  return strnlen(addr.un.sun_path, kUnixPathSize);
+}
+
+bool SocketAddress::FormatUnixDomainAddress(const RawAddr& addr,
+                                            char* address,
+                                            intptr_t len) {
+  ASSERT(addr.addr.sa_family == AF_UNIX);
+  const intptr_t length = UnixPathLength(addr);
+  if (length >= len) {
+    return false;
+  }
+  if (IsAbstractUnixAddress(addr)) {
+    address[0] = '@';
+    memmove(address + 1, addr.un.sun_path + 1, length - 1);
+  } else {
+    memmove(address, addr.un.sun_path, length);
+  }
+  address[length] = '\0';
+  return true;
+}
+#endif  // !defined(HOST_OS_WINDOWS)
+
+int SocketAddress::GetAddrType(const RawAddr& addr) {
+  if (addr.ss.ss_family == AF_INET6) {
     return TYPE_IPV6;
   }
+#if !defined(HOST_OS_WINDOWS)
+  if (addr.ss.ss_family == AF_UNIX) {
+    return TYPE_UNIX;
+  }
+#endif
   return TYPE_IPV4;
 }
 
 intptr_t SocketAddress::GetAddrLength(const RawAddr& addr) {
+#if !defined(HOST_OS_WINDOWS)
+  if (addr.ss.ss_family == AF_UNIX) {
+    const intptr_t length = UnixPathLength(addr);
+    if ((length == 0) || IsAbstractUnixAddress(addr)) {
+      // Abstract names are not NUL terminated; the NUL before the name takes
+      // the place of the '@'.
+      return kUnixPathOffset + length;
+    }
+    return kUnixPathOffset + Utils::Minimum(length + 1, kUnixPathSize);
+  }
+#endif
   ASSERT((addr.ss.ss_family == AF_INET) || (addr.ss.ss_family == AF_INET6));
   return (addr.ss.ss_family == AF_INET6) ? sizeof(struct sockaddr_in6)
                                          : sizeof(struct sockaddr_in);
 }
 
 intptr_t SocketAddress::GetInAddrLength(const RawAddr& addr) {
+#if !defined(HOST_OS_WINDOWS)
+  if (addr.ss.ss_family == AF_UNIX) {
+    return UnixPathLength(addr);
+  }
+#endif
   ASSERT((addr.ss.ss_family == AF_INET) || (addr.ss.ss_family == AF_INET6));
   return (addr.ss.ss_family == AF_INET6) ? sizeof(struct in6_addr)
                                          : sizeof(struct in_addr);
 }
 
 bool SocketAddress::AreAddressesEqual(const RawAddr& a, const RawAddr& b) {
+#if !defined(HOST_OS_WINDOWS)
+  if (a.ss.ss_family == AF_UNIX) {
+    if (b.ss.ss_family != AF_UNIX) {
+      return false;
+    }
+    const intptr_t length = GetAddrLength(a);
+    return (length == GetAddrLength(b)) &&
+           (memcmp(a.un.sun_path, b.un.sun_path, length - kUnixPathOffset) ==
+            0);
+  }
+#endif
   if (a.ss.ss_family == AF_INET) {
     if (b.ss.ss_family != AF_INET) {
       return false;
@@ -56,7 +134,35 @@ bool SocketAddress::AreAddressesEqual(const RawAddr& a, const RawAddr& b) {
   }
 }
 
+static void GetUnixDomainSockAddr(Dart_Handle obj, RawAddr* addr) {
+#if defined(HOST_OS_WINDOWS)
+  Dart_ThrowException(DartUtils::NewDartArgumentError(
+      "Unix domain sockets are not supported on this platform"));
+#else
+  const char* path = DartUtils::GetStringValue(obj);
+  const intptr_t length = strlen(path);
+  const bool abstract = kHasAbstractNamespace && (path[0] == '@');
+  // A path needs room for its NUL terminator, an abstract name does not.
+  const intptr_t max_length = abstract ? kUnixPathSize : kUnixPathSize - 1;
+  if ((length < (abstract ? 2 : 1)) || (length > max_length)) {
+    Dart_ThrowException(
+        DartUtils::NewDartArgumentError("Invalid Unix domain socket path"));
+  }
+  memset(reinterpret_cast<void*>(addr), 0, sizeof(RawAddr));
+  addr->un.sun_family = AF_UNIX;
+  if (abstract) {
+    memmove(addr->un.sun_path + 1, path + 1, length - 1);
+  } else {
+    memmove(addr->un.sun_path, path, length);
+  }
+#endif
+}
+
 void SocketAddress::GetSockAddr(Dart_Handle obj, RawAddr* addr) {
+  if (Dart_IsString(obj)) {
+    GetUnixDomainSockAddr(obj, addr);
+    return;
+  }
   Dart_TypedData_Type data_type;
   uint8_t* data = NULL;
   intptr_t len;
@@ -88,14 +194,20 @@ int16_t SocketAddress::FromType(int type) {
   if (type == TYPE_IPV4) {
     return AF_INET;
   }
+#if !defined(HOST_OS_WINDOWS)
+  if (type == TYPE_UNIX) {
+    return AF_UNIX;
+  }
+#endif
   ASSERT((type == TYPE_IPV6) && "Invalid type");
   return AF_INET6;
 }
 
+// Unix domain addresses have no port.
 void SocketAddress::SetAddrPort(RawAddr* addr, intptr_t port) {
   if (addr->ss.ss_family == AF_INET) {
     addr->in.sin_port = htons(port);
-  } else {
+  } else if (addr->ss.ss_family == AF_INET6) {
     addr->in6.sin6_port = htons(port);
   }
 }
@@ -103,9 +215,26 @@ void SocketAddress::SetAddrPort(RawAddr* addr, intptr_t port) {
 intptr_t SocketAddress::GetAddrPort(const RawAddr& addr) {
   if (addr.ss.ss_family == AF_INET) {
     return ntohs(addr.in.sin_port);
-  } else {
+  } else if (addr.ss.ss_family == AF_INET6) {
     return ntohs(addr.in6.sin6_port);
   }
+  return 0;
+}
+
+// Returns the bytes Dart sees as the raw address: the in_addr or in6_addr,
+// or the path of a Unix domain address, which is formatted into 'path'.
+static const void* GetInAddrBytes(const RawAddr& addr, char* path) {
+#if !defined(HOST_OS_WINDOWS)
+  if (addr.addr.sa_family == AF_UNIX) {
+    SocketAddress::FormatUnixDomainAddress(
+        addr, path, SocketAddress::kMaxAddressStringLength);
+    return path;
+  }
+#endif
+  if (addr.addr.sa_family == AF_INET6) {
+    return &addr.in6.sin6_addr;
+  }
+  return &addr.in.sin_addr;
 }
 
 Dart_Handle SocketAddress::ToTypedData(const RawAddr& addr) {
@@ -114,14 +243,10 @@ Dart_Handle SocketAddress::ToTypedData(const RawAddr& addr) {
   if (Dart_IsError(result)) {
     Dart_PropagateError(result);
   }
-  Dart_Handle err;
-  if (addr.addr.sa_family == AF_INET6) {
-    err = Dart_ListSetAsBytes(
-        result, 0, reinterpret_cast<const uint8_t*>(&addr.in6.sin6_addr), len);
-  } else {
-    err = Dart_ListSetAsBytes(
-        result, 0, reinterpret_cast<const uint8_t*>(&addr.in.sin_addr), len);
-  }
+  char path[kMaxAddressStringLength];
+  Dart_Handle err = Dart_ListSetAsBytes(
+      result, 0, reinterpret_cast<const uint8_t*>(GetInAddrBytes(addr, path)),
+      len);
   if (Dart_IsError(err)) {
     Dart_PropagateError(err);
   }
@@ -130,15 +255,10 @@ Dart_Handle SocketAddress::ToTypedData(const RawAddr& addr) {
 
 CObjectUint8Array* SocketAddress::ToCObject(const RawAddr& addr) {
   int in_addr_len = SocketAddress::GetInAddrLength(addr);
-  const void* in_addr;
   CObjectUint8Array* data =
       new CObjectUint8Array(CObject::NewUint8Array(in_addr_len));
-  if (addr.addr.sa_family == AF_INET6) {
-    in_addr = reinterpret_cast<const void*>(&addr.in6.sin6_addr);
-  } else {
-    in_addr = reinterpret_cast<const void*>(&addr.in.sin_addr);
-  }
-  memmove(data->Buffer(), in_addr, in_addr_len);
+  char path[kMaxAddressStringLength];
+  memmove(data->Buffer(), GetInAddrBytes(addr, path), in_addr_len);
   return data;
 }
 
@@ -34,6 +34,9 @@ namespace bin {
 union RawAddr {
   struct sockaddr_in in;
   struct sockaddr_in6 in6;
+#if !defined(HOST_OS_WINDOWS)
+  struct sockaddr_un un;
+#endif
   struct sockaddr_storage ss;
   struct sockaddr addr;
 };
@@ -44,6 +47,7 @@ class SocketAddress {
     TYPE_ANY = -1,
     TYPE_IPV4,
     TYPE_IPV6,
+    TYPE_UNIX,
   };
 
   enum {
@@ -59,14 +63,18 @@ class SocketAddress {
 
   ~SocketAddress() {}
 
-  int GetType();
+  int GetType() const { return GetAddrType(addr_); }
 
   const char* as_string() const { return as_string_; }
   const RawAddr& addr() const { return addr_; }
 
+  static int GetAddrType(const RawAddr& addr);
   static intptr_t GetAddrLength(const RawAddr& addr);
   static intptr_t GetInAddrLength(const RawAddr& addr);
   static bool AreAddressesEqual(const RawAddr& a, const RawAddr& b);
+  // 'obj' is either the Uint8List of an IP address or, for a Unix domain
+  // socket, the String path. On Linux and Android a path starting with '@'
+  // names an address in the abstract namespace.
   static void GetSockAddr(Dart_Handle obj, RawAddr* addr);
   static int16_t FromType(int type);
   static void SetAddrPort(RawAddr* addr, intptr_t port);
@@ -74,8 +82,22 @@ class SocketAddress {
   static Dart_Handle ToTypedData(const RawAddr& addr);
   static CObjectUint8Array* ToCObject(const RawAddr& addr);
 
+#if defined(HOST_OS_WINDOWS)
+  static const intptr_t kMaxAddressStringLength = INET6_ADDRSTRLEN;
+#else
+  // Also holds a Unix domain path, and the '@' of an abstract address.
+  static const intptr_t kMaxAddressStringLength =
+      sizeof(reinterpret_cast<struct sockaddr_un*>(0)->sun_path) + 1;
+
+  // Writes the path of the AF_UNIX address 'addr' to 'address', starting an
+  // abstract address with '@'. An unnamed address gives the empty string.
+  static bool FormatUnixDomainAddress(const RawAddr& addr,
+                                      char* address,
+                                      intptr_t len);
+#endif
+
  private:
-  char as_string_[INET6_ADDRSTRLEN];
+  char as_string_[kMaxAddressStringLength];
   RawAddr addr_;
 
   DISALLOW_COPY_AND_ASSIGN(SocketAddress);
@@ -152,6 +174,27 @@ class SocketBase : public AllStatic {
                         const void* buffer,
                         intptr_t num_bytes,
                         SocketOpKind sync);
+  // Sends count bytes of the file open as file_fd, starting at offset, on
+  // the socket without copying them through user space. Returns the number
+  // of bytes sent, 0 if the socket would block or the file has ended, or -1
+  // on error. Not supported on Fuchsia and Windows.
+  static intptr_t SendFile(intptr_t fd,
+                           intptr_t file_fd,
+                           int64_t offset,
+                           intptr_t count,
+                           SocketOpKind sync);
+  // The most buffers WriteV takes.
+  static const intptr_t kMaxWriteBuffers = 16;
+  struct WriteBuffer {
+    const void* data;
+    intptr_t length;
+  };
+  // Writes the buffers in order with a single system call. Returns the total
+  // number of bytes written, or -1 on error like Write.
+  static intptr_t WriteV(intptr_t fd,
+                         const WriteBuffer* buffers,
+                         intptr_t count,
+                         SocketOpKind sync);
   // Send data on a socket. The port to send to is specified in the port
   // component of the passed RawAddr structure. The RawAddr structure is only
   // used for datagram sockets.
@@ -165,10 +208,32 @@ class SocketBase : public AllStatic {
                            intptr_t num_bytes,
                            RawAddr* addr,
                            SocketOpKind sync);
+  // The most datagrams RecvFromBatch receives with one system call.
+#if defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID)
+  static const intptr_t kMaxRecvBatch = 16;
+#else
+  static const intptr_t kMaxRecvBatch = 1;
+#endif
+  struct ReceivedDatagram {
+    intptr_t length;
+    RawAddr addr;
+  };
+  // Receives up to count datagrams, the i-th into buffer + i * slot_size.
+  // Returns the number of datagrams received, 0 if none was available, or -1
+  // on error.
+  static intptr_t RecvFromBatch(intptr_t fd,
+                                uint8_t* buffer,
+                                intptr_t slot_size,
+                                intptr_t count,
+                                ReceivedDatagram* datagrams,
+                                SocketOpKind sync);
   // Returns true if the given error-number is because the system was not able
   // to bind the socket to a specific IP.
   static bool IsBindError(intptr_t error_number);
   static intptr_t GetPort(intptr_t fd);
+  // The CPU that processed the packets last received by the socket, or -1 if
+  // it is not known or the OS does not report it.
+  static intptr_t GetIncomingCpu(intptr_t fd);
   static SocketAddress* GetRemotePeer(intptr_t fd, intptr_t* port);
   static void GetError(intptr_t fd, OSError* os_error);
   static int GetType(intptr_t fd);
@@ -14,7 +14,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/sendfile.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "bin/fdutils.h"
@@ -29,7 +31,7 @@ namespace bin {
 SocketAddress::SocketAddress(struct sockaddr* sa) {
   ASSERT(INET6_ADDRSTRLEN >= INET_ADDRSTRLEN);
   if (!SocketBase::FormatNumericAddress(*reinterpret_cast<RawAddr*>(sa),
-                                        as_string_, INET6_ADDRSTRLEN)) {
+                                        as_string_, kMaxAddressStringLength)) {
     as_string_[0] = 0;
   }
   socklen_t salen = GetAddrLength(*reinterpret_cast<RawAddr*>(sa));
@@ -44,6 +46,9 @@ bool SocketBase::Initialize() {
 bool SocketBase::FormatNumericAddress(const RawAddr& addr,
                                       char* address,
                                       int len) {
+  if (addr.addr.sa_family == AF_UNIX) {
+    return SocketAddress::FormatUnixDomainAddress(addr, address, len);
+  }
   socklen_t salen = SocketAddress::GetAddrLength(addr);
   return (NO_RETRY_EXPECTED(getnameinfo(&addr.addr, salen, address, len, NULL,
                                         0, NI_NUMERICHOST)) == 0);
@@ -79,6 +84,9 @@ intptr_t SocketBase::RecvFrom(intptr_t fd,
                               RawAddr* addr,
                               SocketOpKind sync) {
   ASSERT(fd >= 0);
+  // A Unix domain path is read up to its NUL, so clear the bytes the kernel
+  // does not fill in.
+  memset(addr, 0, sizeof(*addr));
   socklen_t addr_len = sizeof(addr->ss);
   ssize_t read_bytes = TEMP_FAILURE_RETRY(
       recvfrom(fd, buffer, num_bytes, 0, &addr->addr, &addr_len));
@@ -90,6 +98,38 @@ intptr_t SocketBase::RecvFrom(intptr_t fd,
   return read_bytes;
 }
 
+intptr_t SocketBase::RecvFromBatch(intptr_t fd,
+                                   uint8_t* buffer,
+                                   intptr_t slot_size,
+                                   intptr_t count,
+                                   ReceivedDatagram* datagrams,
+                                   SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  ASSERT(count <= kMaxRecvBatch);
+  struct mmsghdr messages[kMaxRecvBatch];
+  struct iovec iov[kMaxRecvBatch];
+  memset(messages, 0, sizeof(messages));
+  for (intptr_t i = 0; i < count; i++) {
+    iov[i].iov_base = buffer + i * slot_size;
+    iov[i].iov_len = slot_size;
+    messages[i].msg_hdr.msg_iov = &iov[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+    memset(&datagrams[i].addr, 0, sizeof(datagrams[i].addr));
+    messages[i].msg_hdr.msg_name = &datagrams[i].addr.addr;
+    messages[i].msg_hdr.msg_namelen = sizeof(datagrams[i].addr.ss);
+  }
+  int received = TEMP_FAILURE_RETRY(recvmmsg(fd, messages, count, 0, NULL));
+  if ((sync == kAsync) && (received == -1) && (errno == EWOULDBLOCK)) {
+    // If the read would block we need to retry and therefore return 0
+    // as the number of datagrams received.
+    return 0;
+  }
+  for (intptr_t i = 0; i < received; i++) {
+    datagrams[i].length = messages[i].msg_len;
+  }
+  return received;
+}
+
 intptr_t SocketBase::Write(intptr_t fd,
                            const void* buffer,
                            intptr_t num_bytes,
@@ -105,6 +145,44 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::WriteV(intptr_t fd,
+                            const WriteBuffer* buffers,
+                            intptr_t count,
+                            SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  ASSERT(count <= kMaxWriteBuffers);
+  struct iovec iov[kMaxWriteBuffers];
+  for (intptr_t i = 0; i < count; i++) {
+    iov[i].iov_base = const_cast<void*>(buffers[i].data);
+    iov[i].iov_len = buffers[i].length;
+  }
+  ssize_t written_bytes = TEMP_FAILURE_RETRY(writev(fd, iov, count));
+  ASSERT(EAGAIN == EWOULDBLOCK);
+  if ((sync == kAsync) && (written_bytes == -1) && (errno == EWOULDBLOCK)) {
+    // If the would block we need to retry and therefore return 0 as
+    // the number of bytes written.
+    written_bytes = 0;
+  }
+  return written_bytes;
+}
+
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              intptr_t file_fd,
+                              int64_t offset,
+                              intptr_t count,
+                              SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  off64_t file_offset = offset;
+  ssize_t sent_bytes =
+      TEMP_FAILURE_RETRY(sendfile64(fd, file_fd, &file_offset, count));
+  if ((sync == kAsync) && (sent_bytes == -1) && (errno == EWOULDBLOCK)) {
+    // If the write would block we need to retry and therefore return 0 as
+    // the number of bytes sent.
+    sent_bytes = 0;
+  }
+  return sent_bytes;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
@@ -133,9 +211,23 @@ intptr_t SocketBase::GetPort(intptr_t fd) {
   return SocketAddress::GetAddrPort(raw);
 }
 
+intptr_t SocketBase::GetIncomingCpu(intptr_t fd) {
+  ASSERT(fd >= 0);
+#if defined(SO_INCOMING_CPU)
+  int cpu = -1;
+  socklen_t size = sizeof(cpu);
+  if (NO_RETRY_EXPECTED(
+          getsockopt(fd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &size)) == 0) {
+    return cpu;
+  }
+#endif
+  return -1;
+}
+
 SocketAddress* SocketBase::GetRemotePeer(intptr_t fd, intptr_t* port) {
   ASSERT(fd >= 0);
   RawAddr raw;
+  memset(&raw, 0, sizeof(raw));
   socklen_t size = sizeof(raw);
   if (NO_RETRY_EXPECTED(getpeername(fd, &raw.addr, &size))) {
     return NULL;
@@ -123,6 +123,23 @@ intptr_t SocketBase::RecvFrom(intptr_t fd,
   return -1;
 }
 
+intptr_t SocketBase::RecvFromBatch(intptr_t fd,
+                                   uint8_t* buffer,
+                                   intptr_t slot_size,
+                                   intptr_t count,
+                                   ReceivedDatagram* datagrams,
+                                   SocketOpKind sync) {
+  ASSERT(count >= 1);
+  // There is no batched receive, so receive a single datagram.
+  const intptr_t read_bytes =
+      RecvFrom(fd, buffer, slot_size, &datagrams[0].addr, sync);
+  if (read_bytes <= 0) {
+    return read_bytes;
+  }
+  datagrams[0].length = read_bytes;
+  return 1;
+}
+
 intptr_t SocketBase::Write(intptr_t fd,
                            const void* buffer,
                            intptr_t num_bytes,
@@ -147,6 +164,40 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::WriteV(intptr_t fd,
+                            const WriteBuffer* buffers,
+                            intptr_t count,
+                            SocketOpKind sync) {
+  IOHandle* handle = reinterpret_cast<IOHandle*>(fd);
+  ASSERT(handle->fd() >= 0);
+  ASSERT(count <= kMaxWriteBuffers);
+  struct iovec iov[kMaxWriteBuffers];
+  for (intptr_t i = 0; i < count; i++) {
+    iov[i].iov_base = const_cast<void*>(buffers[i].data);
+    iov[i].iov_len = buffers[i].length;
+  }
+  intptr_t written_bytes = handle->WriteV(iov, count);
+  ASSERT(EAGAIN == EWOULDBLOCK);
+  if ((sync == kAsync) && (written_bytes == -1) && (errno == EWOULDBLOCK)) {
+    // If the would block we need to retry and therefore return 0 as
+    // the number of bytes written.
+    written_bytes = 0;
+  } else if (written_bytes == -1) {
+    LOG_ERR("SocketBase::WriteV: writev(%ld, %ld buffers) failed\n",
+            handle->fd(), count);
+  }
+  return written_bytes;
+}
+
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              intptr_t file_fd,
+                              int64_t offset,
+                              intptr_t count,
+                              SocketOpKind sync) {
+  errno = ENOSYS;
+  return -1;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
@@ -168,6 +219,11 @@ intptr_t SocketBase::GetPort(intptr_t fd) {
   return SocketAddress::GetAddrPort(raw);
 }
 
+intptr_t SocketBase::GetIncomingCpu(intptr_t fd) {
+  USE(fd);
+  return -1;
+}
+
 SocketAddress* SocketBase::GetRemotePeer(intptr_t fd, intptr_t* port) {
   IOHandle* handle = reinterpret_cast<IOHandle*>(fd);
   ASSERT(handle->fd() >= 0);
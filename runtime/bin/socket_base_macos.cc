@@ -15,6 +15,7 @@
 #include <stdlib.h>       // NOLINT
 #include <string.h>       // NOLINT
 #include <sys/stat.h>     // NOLINT
+#include <sys/uio.h>      // NOLINT
 #include <unistd.h>       // NOLINT
 
 #include "bin/fdutils.h"
@@ -28,7 +29,7 @@ namespace bin {
 SocketAddress::SocketAddress(struct sockaddr* sa) {
   ASSERT(INET6_ADDRSTRLEN >= INET_ADDRSTRLEN);
   if (!SocketBase::FormatNumericAddress(*reinterpret_cast<RawAddr*>(sa),
-                                        as_string_, INET6_ADDRSTRLEN)) {
+                                        as_string_, kMaxAddressStringLength)) {
     as_string_[0] = 0;
   }
   socklen_t salen = GetAddrLength(*reinterpret_cast<RawAddr*>(sa));
@@ -43,6 +44,9 @@ bool SocketBase::Initialize() {
 bool SocketBase::FormatNumericAddress(const RawAddr& addr,
                                       char* address,
                                       int len) {
+  if (addr.addr.sa_family == AF_UNIX) {
+    return SocketAddress::FormatUnixDomainAddress(addr, address, len);
+  }
   socklen_t salen = SocketAddress::GetAddrLength(addr);
   return (NO_RETRY_EXPECTED(getnameinfo(&addr.addr, salen, address, len, NULL,
                                         0, NI_NUMERICHOST)) == 0);
@@ -78,6 +82,9 @@ intptr_t SocketBase::RecvFrom(intptr_t fd,
                               RawAddr* addr,
                               SocketOpKind sync) {
   ASSERT(fd >= 0);
+  // A Unix domain path is read up to its NUL, so clear the bytes the kernel
+  // does not fill in.
+  memset(addr, 0, sizeof(*addr));
   socklen_t addr_len = sizeof(addr->ss);
   ssize_t read_bytes = TEMP_FAILURE_RETRY(
       recvfrom(fd, buffer, num_bytes, 0, &addr->addr, &addr_len));
@@ -89,6 +96,23 @@ intptr_t SocketBase::RecvFrom(intptr_t fd,
   return read_bytes;
 }
 
+intptr_t SocketBase::RecvFromBatch(intptr_t fd,
+                                   uint8_t* buffer,
+                                   intptr_t slot_size,
+                                   intptr_t count,
+                                   ReceivedDatagram* datagrams,
+                                   SocketOpKind sync) {
+  ASSERT(count >= 1);
+  // There is no batched receive, so receive a single datagram.
+  const intptr_t read_bytes =
+      RecvFrom(fd, buffer, slot_size, &datagrams[0].addr, sync);
+  if (read_bytes <= 0) {
+    return read_bytes;
+  }
+  datagrams[0].length = read_bytes;
+  return 1;
+}
+
 intptr_t SocketBase::Write(intptr_t fd,
                            const void* buffer,
                            intptr_t num_bytes,
@@ -104,6 +128,50 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::WriteV(intptr_t fd,
+                            const WriteBuffer* buffers,
+                            intptr_t count,
+                            SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  ASSERT(count <= kMaxWriteBuffers);
+  struct iovec iov[kMaxWriteBuffers];
+  for (intptr_t i = 0; i < count; i++) {
+    iov[i].iov_base = const_cast<void*>(buffers[i].data);
+    iov[i].iov_len = buffers[i].length;
+  }
+  ssize_t written_bytes = TEMP_FAILURE_RETRY(writev(fd, iov, count));
+  ASSERT(EAGAIN == EWOULDBLOCK);
+  if ((sync == kAsync) && (written_bytes == -1) && (errno == EWOULDBLOCK)) {
+    // If the would block we need to retry and therefore return 0 as
+    // the number of bytes written.
+    written_bytes = 0;
+  }
+  return written_bytes;
+}
+
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              intptr_t file_fd,
+                              int64_t offset,
+                              intptr_t count,
+                              SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  // On return, length holds the number of bytes sent, also when sendfile
+  // fails with EAGAIN or EINTR after a partial send.
+  off_t length = count;
+  if (sendfile(file_fd, fd, offset, &length, NULL, 0) == 0) {
+    return length;
+  }
+  if (length > 0) {
+    return length;
+  }
+  if (((sync == kAsync) && (errno == EWOULDBLOCK)) || (errno == EINTR)) {
+    // If the write would block we need to retry and therefore return 0 as
+    // the number of bytes sent.
+    return 0;
+  }
+  return -1;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
@@ -132,9 +200,15 @@ intptr_t SocketBase::GetPort(intptr_t fd) {
   return SocketAddress::GetAddrPort(raw);
 }
 
+intptr_t SocketBase::GetIncomingCpu(intptr_t fd) {
+  USE(fd);
+  return -1;
+}
+
 SocketAddress* SocketBase::GetRemotePeer(intptr_t fd, intptr_t* port) {
   ASSERT(fd >= 0);
   RawAddr raw;
+  memset(&raw, 0, sizeof(raw));
   socklen_t size = sizeof(raw);
   if (NO_RETRY_EXPECTED(getpeername(fd, &raw.addr, &size))) {
     return NULL;
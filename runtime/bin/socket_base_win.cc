@@ -88,6 +88,23 @@ intptr_t SocketBase::RecvFrom(intptr_t fd,
   return handle->RecvFrom(buffer, num_bytes, &addr->addr, addr_len);
 }
 
+intptr_t SocketBase::RecvFromBatch(intptr_t fd,
+                                   uint8_t* buffer,
+                                   intptr_t slot_size,
+                                   intptr_t count,
+                                   ReceivedDatagram* datagrams,
+                                   SocketOpKind sync) {
+  ASSERT(count >= 1);
+  // There is no batched receive, so receive a single datagram.
+  const intptr_t read_bytes =
+      RecvFrom(fd, buffer, slot_size, &datagrams[0].addr, sync);
+  if (read_bytes <= 0) {
+    return read_bytes;
+  }
+  datagrams[0].length = read_bytes;
+  return 1;
+}
+
 intptr_t SocketBase::Write(intptr_t fd,
                            const void* buffer,
                            intptr_t num_bytes,
@@ -96,6 +113,30 @@ intptr_t SocketBase::Write(intptr_t fd,
   return handle->Write(buffer, num_bytes);
 }
 
+intptr_t SocketBase::WriteV(intptr_t fd,
+                            const WriteBuffer* buffers,
+                            intptr_t count,
+                            SocketOpKind sync) {
+  ASSERT(count <= kMaxWriteBuffers);
+  WSABUF wsa_buffers[kMaxWriteBuffers];
+  for (intptr_t i = 0; i < count; i++) {
+    wsa_buffers[i].buf =
+        reinterpret_cast<char*>(const_cast<void*>(buffers[i].data));
+    wsa_buffers[i].len = static_cast<ULONG>(buffers[i].length);
+  }
+  Handle* handle = reinterpret_cast<Handle*>(fd);
+  return handle->WriteV(wsa_buffers, count);
+}
+
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              intptr_t file_fd,
+                              int64_t offset,
+                              intptr_t count,
+                              SocketOpKind sync) {
+  SetLastError(ERROR_NOT_SUPPORTED);
+  return -1;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
@@ -118,6 +159,11 @@ intptr_t SocketBase::GetPort(intptr_t fd) {
   return SocketAddress::GetAddrPort(raw);
 }
 
+intptr_t SocketBase::GetIncomingCpu(intptr_t fd) {
+  USE(fd);
+  return -1;
+}
+
 SocketAddress* SocketBase::GetRemotePeer(intptr_t fd, intptr_t* port) {
   ASSERT(reinterpret_cast<Handle*>(fd)->is_socket());
   SocketHandle* socket_handle = reinterpret_cast<SocketHandle*>(fd);
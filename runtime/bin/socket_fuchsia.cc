@@ -48,7 +48,11 @@ Socket::Socket(intptr_t fd)
       fd_(fd),
       isolate_port_(Dart_GetMainPortId()),
       port_(ILLEGAL_PORT),
-      udp_receive_buffer_(NULL) {}
+      udp_receive_buffer_(NULL),
+      udp_received_(NULL),
+      udp_received_count_(0),
+      udp_received_next_(0),
+      event_handler_(-1) {}
 
 void Socket::SetClosedFd() {
   ASSERT(fd_ != kClosedFd);
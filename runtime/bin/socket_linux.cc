@@ -22,12 +22,28 @@ Socket::Socket(intptr_t fd)
       fd_(fd),
       isolate_port_(Dart_GetMainPortId()),
       port_(ILLEGAL_PORT),
-      udp_receive_buffer_(NULL) {}
+      udp_receive_buffer_(NULL),
+      udp_received_(NULL),
+      udp_received_count_(0),
+      udp_received_next_(0),
+      event_handler_(-1) {}
 
 void Socket::SetClosedFd() {
   fd_ = kClosedFd;
 }
 
+// Best effort: raising SO_BUSY_POLL above net.core.busy_read needs
+// CAP_NET_ADMIN, and the socket works the same without it.
+static void SetBusyPoll(intptr_t fd) {
+#if defined(SO_BUSY_POLL)
+  int usecs = Socket::busy_poll_microseconds();
+  if (usecs > 0) {
+    VOID_NO_RETRY_EXPECTED(
+        setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &usecs, sizeof(usecs)));
+  }
+#endif
+}
+
 static intptr_t Create(const RawAddr& addr) {
   intptr_t fd;
   intptr_t type = SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC;
@@ -35,6 +51,7 @@ static intptr_t Create(const RawAddr& addr) {
   if (fd < 0) {
     return -1;
   }
+  SetBusyPoll(fd);
   return fd;
 }
 
@@ -79,12 +96,15 @@ intptr_t Socket::CreateBindDatagram(const RawAddr& addr,
                                     int ttl) {
   intptr_t fd;
 
+  // Unix domain datagram sockets have no protocol.
+  const int protocol = (addr.addr.sa_family == AF_UNIX) ? 0 : IPPROTO_UDP;
   fd = NO_RETRY_EXPECTED(socket(addr.addr.sa_family,
                                 SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK,
-                                IPPROTO_UDP));
+                                protocol));
   if (fd < 0) {
     return -1;
   }
+  SetBusyPoll(fd);
 
   if (reuseAddress) {
     int optval = 1;
@@ -116,7 +136,8 @@ intptr_t Socket::CreateBindDatagram(const RawAddr& addr,
 #endif  // SO_REUSEPORT
   }
 
-  if (!SocketBase::SetMulticastHops(fd,
+  if ((addr.addr.sa_family != AF_UNIX) &&
+      !SocketBase::SetMulticastHops(fd,
                                     addr.addr.sa_family == AF_INET
                                         ? SocketAddress::TYPE_IPV4
                                         : SocketAddress::TYPE_IPV6,
@@ -196,24 +217,16 @@ intptr_t ServerSocket::Accept(intptr_t fd) {
   intptr_t socket;
   struct sockaddr clientaddr;
   socklen_t addrlen = sizeof(clientaddr);
-  socket = TEMP_FAILURE_RETRY(accept(fd, &clientaddr, &addrlen));
-  if (socket == -1) {
-    if (IsTemporaryAcceptError(errno)) {
-      // We need to signal to the caller that this is actually not an
-      // error. We got woken up from the poll on the listening socket,
-      // but there is no connection ready to be accepted.
-      ASSERT(kTemporaryFailure != -1);
-      socket = kTemporaryFailure;
-    }
-  } else {
-    if (!FDUtils::SetCloseOnExec(socket)) {
-      FDUtils::SaveErrorAndClose(socket);
-      return -1;
-    }
-    if (!FDUtils::SetNonBlocking(socket)) {
-      FDUtils::SaveErrorAndClose(socket);
-      return -1;
-    }
+  socket = TEMP_FAILURE_RETRY(accept4(fd, &clientaddr, &addrlen,
+                                     SOCK_NONBLOCK | SOCK_CLOEXEC));
+  if ((socket == -1) && IsTemporaryAcceptError(errno)) {
+    // We need to signal to the caller that this is actually not an
+    // error. We got woken up from the poll on the listening socket,
+    // but there is no connection ready to be accepted.
+    ASSERT(kTemporaryFailure != -1);
+    socket = kTemporaryFailure;
+  } else if (socket >= 0) {
+    SetBusyPoll(socket);
   }
   return socket;
 }
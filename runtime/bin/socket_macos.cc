@@ -20,7 +20,11 @@ Socket::Socket(intptr_t fd)
       fd_(fd),
       isolate_port_(Dart_GetMainPortId()),
       port_(ILLEGAL_PORT),
-      udp_receive_buffer_(NULL) {}
+      udp_receive_buffer_(NULL),
+      udp_received_(NULL),
+      udp_received_count_(0),
+      udp_received_next_(0),
+      event_handler_(-1) {}
 
 void Socket::SetClosedFd() {
   fd_ = kClosedFd;
@@ -85,7 +89,9 @@ intptr_t Socket::CreateBindDatagram(const RawAddr& addr,
                                     int ttl) {
   intptr_t fd;
 
-  fd = NO_RETRY_EXPECTED(socket(addr.addr.sa_family, SOCK_DGRAM, IPPROTO_UDP));
+  // Unix domain datagram sockets have no protocol.
+  const int protocol = (addr.addr.sa_family == AF_UNIX) ? 0 : IPPROTO_UDP;
+  fd = NO_RETRY_EXPECTED(socket(addr.addr.sa_family, SOCK_DGRAM, protocol));
   if (fd < 0) {
     return -1;
   }
@@ -108,7 +114,8 @@ intptr_t Socket::CreateBindDatagram(const RawAddr& addr,
         setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval)));
   }
 
-  if (!SocketBase::SetMulticastHops(fd,
+  if ((addr.addr.sa_family != AF_UNIX) &&
+      !SocketBase::SetMulticastHops(fd,
                                     addr.addr.sa_family == AF_INET
                                         ? SocketAddress::TYPE_IPV4
                                         : SocketAddress::TYPE_IPV6,
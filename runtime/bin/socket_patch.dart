@@ -69,8 +69,17 @@ class InternetAddress {
   }
 
   @patch
-  factory InternetAddress(String address) {
-    return new _InternetAddress.parse(address);
+  factory InternetAddress(String address, {InternetAddressType type}) {
+    if (type == InternetAddressType.unix) {
+      return new _InternetAddress.unix(address);
+    }
+    var result = new _InternetAddress.parse(address);
+    if (type != null &&
+        type != InternetAddressType.any &&
+        type != result.type) {
+      throw new ArgumentError("Invalid $type address $address");
+    }
+    return result;
   }
 
   @patch
@@ -134,18 +143,20 @@ class _InternetAddress implements InternetAddress {
   static _InternetAddress anyIPv4 = new _InternetAddress.fixed(_addressAnyIPv4);
   static _InternetAddress anyIPv6 = new _InternetAddress.fixed(_addressAnyIPv6);
 
+  final InternetAddressType type;
   final String address;
   final String _host;
   final Uint8List _in_addr;
 
-  InternetAddressType get type => _in_addr.length == _IPv4AddrLength
-      ? InternetAddressType.IPv4
-      : InternetAddressType.IPv6;
-
   String get host => _host != null ? _host : address;
 
   Uint8List get rawAddress => new Uint8List.fromList(_in_addr);
 
+  // The address the socket natives take: the raw address, or the path of a
+  // Unix domain socket.
+  Object get _sockaddr =>
+      type == InternetAddressType.unix ? address : _in_addr;
+
   bool get isLoopback {
     switch (type) {
       case InternetAddressType.IPv4:
@@ -156,6 +167,9 @@ class _InternetAddress implements InternetAddress {
           if (_in_addr[i] != 0) return false;
         }
         return _in_addr[_IPv6AddrLength - 1] == 1;
+
+      case InternetAddressType.unix:
+        return false;
     }
   }
 
@@ -168,6 +182,9 @@ class _InternetAddress implements InternetAddress {
       case InternetAddressType.IPv6:
         // Checking for fe80::/10.
         return _in_addr[0] == 0xFE && (_in_addr[1] & 0xB0) == 0x80;
+
+      case InternetAddressType.unix:
+        return false;
     }
   }
 
@@ -180,12 +197,26 @@ class _InternetAddress implements InternetAddress {
       case InternetAddressType.IPv6:
         // Checking for ff00::/8.
         return _in_addr[0] == 0xFF;
+
+      case InternetAddressType.unix:
+        return false;
     }
   }
 
-  Future<InternetAddress> reverse() => _NativeSocket.reverseLookup(this);
+  Future<InternetAddress> reverse() {
+    if (type == InternetAddressType.unix) return new Future.value(this);
+    return _NativeSocket.reverseLookup(this);
+  }
 
-  _InternetAddress(this.address, this._host, this._in_addr);
+  _InternetAddress(this.type, this.address, this._host, this._in_addr);
+
+  factory _InternetAddress.unix(String path) {
+    if (path is! String || path.isEmpty) {
+      throw new ArgumentError("Invalid Unix domain socket path $path");
+    }
+    return new _InternetAddress(InternetAddressType.unix, path, null,
+        new Uint8List.fromList(utf8.encode(path)));
+  }
 
   factory _InternetAddress.parse(String address) {
     if (address is! String) {
@@ -195,7 +226,13 @@ class _InternetAddress implements InternetAddress {
     if (in_addr == null) {
       throw new ArgumentError("Invalid internet address $address");
     }
-    return new _InternetAddress(address, null, in_addr);
+    return new _InternetAddress(
+        in_addr.length == _IPv4AddrLength
+            ? InternetAddressType.IPv4
+            : InternetAddressType.IPv6,
+        address,
+        null,
+        in_addr);
   }
 
   factory _InternetAddress.fixed(int id) {
@@ -204,17 +241,21 @@ class _InternetAddress implements InternetAddress {
         var in_addr = new Uint8List(_IPv4AddrLength);
         in_addr[0] = 127;
         in_addr[_IPv4AddrLength - 1] = 1;
-        return new _InternetAddress("127.0.0.1", null, in_addr);
+        return new _InternetAddress(
+            InternetAddressType.IPv4, "127.0.0.1", null, in_addr);
       case _addressLoopbackIPv6:
         var in_addr = new Uint8List(_IPv6AddrLength);
         in_addr[_IPv6AddrLength - 1] = 1;
-        return new _InternetAddress("::1", null, in_addr);
+        return new _InternetAddress(
+            InternetAddressType.IPv6, "::1", null, in_addr);
       case _addressAnyIPv4:
         var in_addr = new Uint8List(_IPv4AddrLength);
-        return new _InternetAddress("0.0.0.0", "0.0.0.0", in_addr);
+        return new _InternetAddress(
+            InternetAddressType.IPv4, "0.0.0.0", "0.0.0.0", in_addr);
       case _addressAnyIPv6:
         var in_addr = new Uint8List(_IPv6AddrLength);
-        return new _InternetAddress("::", "::", in_addr);
+        return new _InternetAddress(
+            InternetAddressType.IPv6, "::", "::", in_addr);
       default:
         assert(false);
         throw new ArgumentError();
@@ -224,7 +265,7 @@ class _InternetAddress implements InternetAddress {
   // Create a clone of this _InternetAddress replacing the host.
   _InternetAddress _cloneWithNewHost(String host) {
     return new _InternetAddress(
-        address, host, new Uint8List.fromList(_in_addr));
+        type, address, host, new Uint8List.fromList(_in_addr));
   }
 
   bool operator ==(other) {
@@ -322,6 +363,10 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
       typeInternalSocket |
       typeInternalSignalSocket;
 
+  // The most buffers writeBuffers passes to one system call.
+  // Keep in sync with SocketBase::kMaxWriteBuffers in socket_base.h.
+  static const int maxWriteBuffers = 16;
+
   // Native port messages.
   static const hostNameLookupMessage = 0;
   static const listInterfacesMessage = 1;
@@ -334,6 +379,10 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   static const int normalTokenBatchSize = 8;
   static const int listeningTokenBatchSize = 2;
 
+  // The most connections accepted for one read event on a listening socket
+  // that is not shared.
+  static const int acceptBatchSize = 16;
+
   static const Duration _retryDuration = const Duration(milliseconds: 250);
   static const Duration _retryDurationLoopback =
       const Duration(milliseconds: 25);
@@ -362,6 +411,15 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
 
   int available = 0;
 
+  // Whether this is a listening socket shared with other isolates. Those
+  // accept one connection per read event, so that the event handler hands
+  // the connections round-robin to the isolates.
+  bool isShared = false;
+
+  // The connections that may still be accepted after the last read event
+  // on a listening socket, until the backlog is found to be empty.
+  int acceptBatch = 0;
+
   int tokens = 0;
 
   bool sendReadEvents = false;
@@ -387,7 +445,7 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
       } else {
         return response.skip(1).map<InternetAddress>((result) {
           var type = new InternetAddressType._from(result[0]);
-          return new _InternetAddress(result[1], host, result[2]);
+          return new _InternetAddress(type, result[1], host, result[2]);
         }).toList();
       }
     });
@@ -418,7 +476,7 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
           var type = new InternetAddressType._from(result[0]);
           var name = result[3];
           var index = result[4];
-          var address = new _InternetAddress(result[1], "", result[2]);
+          var address = new _InternetAddress(type, result[1], "", result[2]);
           if (!includeLinkLocal && address.isLinkLocal) return map;
           if (!includeLoopback && address.isLoopback) return map;
           map.putIfAbsent(name, () => new _NetworkInterface(name, index));
@@ -465,11 +523,11 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
         socket.localAddress = address;
         var result;
         if (sourceAddress == null) {
-          result = socket.nativeCreateConnect(address._in_addr, port);
+          result = socket.nativeCreateConnect(address._sockaddr, port);
         } else {
           assert(sourceAddress is _InternetAddress);
           result = socket.nativeCreateBindConnect(
-              address._in_addr, port, sourceAddress._in_addr);
+              address._sockaddr, port, sourceAddress._sockaddr);
         }
         if (result is OSError) {
           // Keep first error, if present.
@@ -598,12 +656,13 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     var socket = new _NativeSocket.listen();
     socket.localAddress = address;
     var result = socket.nativeCreateBindListen(
-        address._in_addr, port, backlog, v6Only, shared);
+        address._sockaddr, port, backlog, v6Only, shared);
     if (result is OSError) {
       throw new SocketException("Failed to create server socket",
           osError: result, address: address, port: port);
     }
     if (port != 0) socket.localPort = port;
+    socket.isShared = shared;
     setupResourceInfo(socket);
     socket.connectToEventHandler();
     return socket;
@@ -622,7 +681,7 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
 
     var socket = new _NativeSocket.datagram(address);
     var result = socket.nativeCreateBindDatagram(
-        address._in_addr, port, reuseAddress, reusePort, ttl);
+        address._sockaddr, port, reuseAddress, reusePort, ttl);
     if (result is OSError) {
       throw new SocketException("Failed to create datagram socket",
           osError: result, address: address, port: port);
@@ -693,6 +752,27 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     return result;
   }
 
+  // Reads up to `end - start` bytes directly into [buffer] without
+  // allocating a new list. Returns the number of bytes read.
+  int readInto(List<int> buffer, int start, int end) {
+    if (isClosing || isClosed) return 0;
+    end = min(end, start + available);
+    if (end <= start) return 0;
+    var result = nativeReadInto(buffer, start, end);
+    if (result is OSError) {
+      reportError(result, "Read failed");
+      return 0;
+    }
+    available -= result;
+    // TODO(ricow): Remove when we track internal and pipe uses.
+    assert(resourceInfo != null || isPipe || isInternal || isInternalSignal);
+    if (resourceInfo != null) {
+      resourceInfo.totalRead += result;
+      resourceInfo.didRead();
+    }
+    return result;
+  }
+
   Datagram receive() {
     if (isClosing || isClosed) return null;
     var result = nativeRecvFrom();
@@ -764,6 +844,70 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     return result;
   }
 
+  // Writes [buffers] in order with a single system call, starting at
+  // [offset] in the first one. At most [maxWriteBuffers] buffers are written.
+  // Returns the number of bytes written.
+  int writeBuffers(List<List<int>> buffers, int offset) {
+    if (isClosing || isClosed) return 0;
+    int count = min(buffers.length, maxWriteBuffers);
+    var nativeBuffers = new List<List<int>>(count);
+    var offsets = new List<int>(count);
+    var lengths = new List<int>(count);
+    int bytes = 0;
+    for (int i = 0; i < count; i++) {
+      List<int> buffer = buffers[i];
+      int start = (i == 0) ? offset : 0;
+      _BufferAndStart bufferAndStart =
+          _ensureFastAndSerializableByteData(buffer, start, buffer.length);
+      nativeBuffers[i] = bufferAndStart.buffer;
+      offsets[i] = bufferAndStart.start;
+      lengths[i] = buffer.length - start;
+      bytes += lengths[i];
+    }
+    if (bytes == 0) return 0;
+    var result = nativeWriteBuffers(nativeBuffers, offsets, lengths);
+    if (result is OSError) {
+      OSError osError = result;
+      scheduleMicrotask(() => reportError(osError, "Write failed"));
+      result = 0;
+    }
+    // As in write, a negative result is a forced short write.
+    if (result >= 0 && result < bytes) {
+      writeAvailable = false;
+    }
+    if (result < 0) result = -result;
+    // TODO(ricow): Remove when we track internal and pipe uses.
+    assert(resourceInfo != null || isPipe || isInternal || isInternalSignal);
+    if (resourceInfo != null) {
+      resourceInfo.addWrite(result);
+    }
+    return result;
+  }
+
+  // Sends [count] bytes of [file], starting at [position], without copying
+  // them through Dart. Returns the number of bytes sent.
+  int sendFile(_RandomAccessFile file, int position, int count) {
+    if (isClosing || isClosed) return 0;
+    if (count == 0) return 0;
+    var result = nativeSendFile(file._ops, position, count);
+    if (result is OSError) {
+      OSError osError = result;
+      scheduleMicrotask(() => reportError(osError, "Write failed"));
+      result = 0;
+    }
+    // As in write, a negative result is a forced short write.
+    if (result >= 0 && result < count) {
+      writeAvailable = false;
+    }
+    if (result < 0) result = -result;
+    // TODO(ricow): Remove when we track internal and pipe uses.
+    assert(resourceInfo != null || isPipe || isInternal || isInternalSignal);
+    if (resourceInfo != null) {
+      resourceInfo.addWrite(result);
+    }
+    return result;
+  }
+
   int send(List<int> buffer, int offset, int bytes, InternetAddress address,
       int port) {
     _throwOnBadPort(port);
@@ -771,7 +915,7 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     _BufferAndStart bufferAndStart =
         _ensureFastAndSerializableByteData(buffer, offset, bytes);
     var result = nativeSendTo(bufferAndStart.buffer, bufferAndStart.start,
-        bytes, (address as _InternetAddress)._in_addr, port);
+        bytes, (address as _InternetAddress)._sockaddr, port);
     if (result is OSError) {
       OSError osError = result;
       scheduleMicrotask(() => reportError(osError, "Send failed"));
@@ -788,12 +932,20 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   _NativeSocket accept() {
     // Don't issue accept if we're closing.
     if (isClosing || isClosed) return null;
-    assert(available > 0);
-    available--;
-    tokens++;
-    returnTokens(listeningTokenBatchSize);
+    if (available > 0) {
+      available--;
+      tokens++;
+      returnTokens(listeningTokenBatchSize);
+      if (!isShared) acceptBatch = acceptBatchSize - 1;
+    } else {
+      assert(acceptBatch > 0);
+      acceptBatch--;
+    }
     var socket = new _NativeSocket.normal();
-    if (nativeAccept(socket) != true) return null;
+    if (nativeAccept(socket) != true) {
+      acceptBatch = 0;
+      return null;
+    }
     socket.localPort = localPort;
     socket.localAddress = address;
     setupResourceInfo(socket);
@@ -808,6 +960,8 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
 
   int get port {
     if (localPort != 0) return localPort;
+    // Unix domain sockets have no port.
+    if (localAddress?.type == InternetAddressType.unix) return 0;
     if (isClosing || isClosed) throw const SocketException.closed();
     var result = nativeGetPort();
     if (result is OSError) throw result;
@@ -829,7 +983,7 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     if (result is OSError) throw result;
     var addr = result[0];
     var type = new InternetAddressType._from(addr[0]);
-    return new _InternetAddress(addr[1], null, addr[2]);
+    return new _InternetAddress(type, addr[1], null, addr[2]);
   }
 
   void issueReadEvent() {
@@ -1102,6 +1256,11 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
 
   getOption(SocketOption option) {
     if (option == null) throw new ArgumentError.notNull("option");
+    // Unix domain sockets do not batch writes like TCP.
+    if (option == SocketOption.tcpNoDelay &&
+        address.type == InternetAddressType.unix) {
+      return true;
+    }
     var result = nativeGetOption(option._value, address.type._value);
     if (result is OSError) throw result;
     return result;
@@ -1109,6 +1268,10 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
 
   bool setOption(SocketOption option, value) {
     if (option == null) throw new ArgumentError.notNull("option");
+    if (option == SocketOption.tcpNoDelay &&
+        address.type == InternetAddressType.unix) {
+      return true;
+    }
     var result = nativeSetOption(option._value, address.type._value, value);
     if (result != null) throw result;
     return true;
@@ -1174,18 +1337,24 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   void nativeSetSocketId(int id, int typeFlags) native "Socket_SetSocketId";
   nativeAvailable() native "Socket_Available";
   nativeRead(int len) native "Socket_Read";
+  nativeReadInto(List<int> buffer, int start, int end)
+      native "Socket_ReadInto";
   nativeRecvFrom() native "Socket_RecvFrom";
   nativeWrite(List<int> buffer, int offset, int bytes)
       native "Socket_WriteList";
-  nativeSendTo(List<int> buffer, int offset, int bytes, Uint8List address,
+  nativeWriteBuffers(List<List<int>> buffers, List<int> offsets,
+      List<int> lengths) native "Socket_WriteBuffers";
+  nativeSendFile(_RandomAccessFileOps file, int position, int count)
+      native "Socket_SendFile";
+  nativeSendTo(List<int> buffer, int offset, int bytes, Object address,
       int port) native "Socket_SendTo";
-  nativeCreateConnect(Uint8List addr, int port) native "Socket_CreateConnect";
-  nativeCreateBindConnect(Uint8List addr, int port, Uint8List sourceAddr)
+  nativeCreateConnect(Object addr, int port) native "Socket_CreateConnect";
+  nativeCreateBindConnect(Object addr, int port, Object sourceAddr)
       native "Socket_CreateBindConnect";
   bool isBindError(int errorNumber) native "SocketBase_IsBindError";
-  nativeCreateBindListen(Uint8List addr, int port, int backlog, bool v6Only,
+  nativeCreateBindListen(Object addr, int port, int backlog, bool v6Only,
       bool shared) native "ServerSocket_CreateBindListen";
-  nativeCreateBindDatagram(Uint8List addr, int port, bool reuseAddress,
+  nativeCreateBindDatagram(Object addr, int port, bool reuseAddress,
       bool reusePort, int ttl) native "Socket_CreateBindDatagram";
   nativeAccept(_NativeSocket socket) native "ServerSocket_Accept";
   int nativeGetPort() native "Socket_GetPort";
@@ -1234,7 +1403,7 @@ class _RawServerSocket extends Stream<RawSocket> implements RawServerSocket {
         onPause: _onPauseStateChange,
         onResume: _onPauseStateChange);
     _socket.setHandlers(read: zone.bindCallbackGuarded(() {
-      while (_socket.available > 0) {
+      while (_socket.available > 0 || _socket.acceptBatch > 0) {
         var socket = _socket.accept();
         if (socket == null) return;
         _controller.add(new _RawSocket(socket));
@@ -1297,7 +1466,8 @@ class _RawServerSocket extends Stream<RawSocket> implements RawServerSocket {
   }
 }
 
-class _RawSocket extends Stream<RawSocketEvent> implements RawSocket {
+class _RawSocket extends Stream<RawSocketEvent>
+    implements RawSocket, _ReadIntoRawSocket {
   final _NativeSocket _socket;
   StreamController<RawSocketEvent> _controller;
   bool _readEventsEnabled = true;
@@ -1394,6 +1564,17 @@ class _RawSocket extends Stream<RawSocketEvent> implements RawSocket {
     }
   }
 
+  int _readInto(List<int> buffer, int start, int end) {
+    if (_isMacOSTerminalInput) {
+      // Needs the Ctrl-D detection in read().
+      var data = read(end - start);
+      if (data == null) return 0;
+      buffer.setRange(start, start + data.length, data);
+      return data.length;
+    }
+    return _socket.readInto(buffer, start, end);
+  }
+
   int write(List<int> buffer, [int offset, int count]) =>
       _socket.write(buffer, offset, count);
 
@@ -1528,21 +1709,45 @@ class Socket {
 class _SocketStreamConsumer extends StreamConsumer<List<int>> {
   StreamSubscription subscription;
   final _Socket socket;
-  int offset;
-  List<int> buffer;
+  // The buffers not yet written, and the offset of the unwritten part of the
+  // first one. While waiting for a write event, up to
+  // _NativeSocket.maxWriteBuffers buffers are queued, which the next write
+  // event writes with one system call.
+  int offset = 0;
+  final List<List<int>> buffers = <List<int>>[];
   bool paused = false;
   Completer streamCompleter;
+  // A file stream added to a plain socket is sent straight from [file] with
+  // sendfile, where the platform supports it, instead of being read into
+  // buffers. [sendingFile] is set while opening the file.
+  bool sendingFile = false;
+  RandomAccessFile file;
+  int filePosition;
+  int fileEnd;
+
+  // The most bytes one sendfile call is asked to send.
+  static const int maxSendFileCount = 1 << 30;
 
   _SocketStreamConsumer(this.socket);
 
   Future<Socket> addStream(Stream<List<int>> stream) {
     socket._ensureRawSocketSubscription();
     streamCompleter = new Completer<Socket>();
-    if (socket._raw != null) {
+    if (socket._raw != null && canSendFile(stream)) {
+      _FileStream fileStream = stream;
+      sendFile(fileStream._path, fileStream._position, fileStream._end);
+    } else if (socket._raw != null) {
       subscription = stream.listen((data) {
         assert(!paused);
-        assert(buffer == null);
-        buffer = data;
+        buffers.add(data);
+        if (buffers.length > 1) {
+          // A write event is pending.
+          if (buffers.length >= _NativeSocket.maxWriteBuffers) {
+            paused = true;
+            subscription.pause();
+          }
+          return;
+        }
         offset = 0;
         try {
           write();
@@ -1566,27 +1771,92 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
     return new Future.value(socket);
   }
 
+  bool canSendFile(Stream<List<int>> stream) {
+    if (!Platform.isLinux && !Platform.isAndroid && !Platform.isMacOS) {
+      return false;
+    }
+    // The stream must not have been listened to, and must not be stdin.
+    return socket._raw is _RawSocket &&
+        stream is _FileStream &&
+        stream._path != null &&
+        stream._controller == null;
+  }
+
+  void sendFile(String path, int position, int end) {
+    sendingFile = true;
+    new File(path).open().then((opened) {
+      if (!sendingFile) {
+        // Stopped while opening.
+        opened.close();
+        return null;
+      }
+      file = opened;
+      filePosition = position;
+      return file.length();
+    }).then((length) {
+      if (file == null) return;
+      fileEnd = (end == null) ? length : min(end, length);
+      write();
+    }).catchError((error, stackTrace) {
+      socket.destroy();
+      done(error, stackTrace);
+    });
+  }
+
+  void writeFile() {
+    int count = min(fileEnd - filePosition, maxSendFileCount);
+    int written = 0;
+    if (count > 0) {
+      written = socket._sendFile(file, filePosition, count);
+      filePosition += written;
+    }
+    // Nothing is sent at the end of a file truncated while being sent, so
+    // check the length before waiting for a write event that never helps.
+    if (filePosition < fileEnd &&
+        (written > 0 || filePosition < file.lengthSync())) {
+      socket._enableWriteEvent();
+    } else {
+      done();
+    }
+  }
+
   void write() {
+    if (file != null) {
+      writeFile();
+      return;
+    }
     if (subscription == null) return;
-    assert(buffer != null);
+    assert(buffers.isNotEmpty);
     // Write as much as possible.
-    offset += socket._write(buffer, offset, buffer.length - offset);
-    if (offset < buffer.length) {
-      if (!paused) {
-        paused = true;
-        subscription.pause();
+    int written = socket._writeBuffers(buffers, offset);
+    while (buffers.isNotEmpty) {
+      int remaining = buffers.first.length - offset;
+      if (written < remaining) {
+        offset += written;
+        break;
       }
+      written -= remaining;
+      buffers.removeAt(0);
+      offset = 0;
+    }
+    if (buffers.isNotEmpty) {
       socket._enableWriteEvent();
-    } else {
-      buffer = null;
-      if (paused) {
-        paused = false;
-        subscription.resume();
-      }
+    } else if (paused) {
+      paused = false;
+      subscription.resume();
+    }
+  }
+
+  void closeFile() {
+    sendingFile = false;
+    if (file != null) {
+      file.close();
+      file = null;
     }
   }
 
   void done([error, stackTrace]) {
+    closeFile();
     if (streamCompleter != null) {
       if (error != null) {
         streamCompleter.completeError(error, stackTrace);
@@ -1598,6 +1868,10 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
   }
 
   void stop() {
+    if (sendingFile) {
+      closeFile();
+      socket._disableWriteEvent();
+    }
     if (subscription == null) return;
     subscription.cancel();
     subscription = null;
@@ -1734,7 +2008,7 @@ class _Socket extends Stream<List<int>> implements Socket {
     _detachReady = new Completer();
     _sink.close();
     return _detachReady.future.then((_) {
-      assert(_consumer.buffer == null);
+      assert(_consumer.buffers.isEmpty);
       var raw = _raw;
       _raw = null;
       return [raw, _subscription];
@@ -1815,6 +2089,30 @@ class _Socket extends Stream<List<int>> implements Socket {
   int _write(List<int> data, int offset, int length) =>
       _raw.write(data, offset, length);
 
+  int _sendFile(RandomAccessFile file, int position, int count) {
+    _RawSocket raw = _raw;
+    return raw._socket.sendFile(file, position, count);
+  }
+
+  // Writes as much of [buffers] as possible, starting at [offset] in the
+  // first one, and returns the number of bytes written.
+  int _writeBuffers(List<List<int>> buffers, int offset) {
+    var raw = _raw;
+    if (raw is _RawSocket) {
+      return raw._socket.writeBuffers(buffers, offset);
+    }
+    // Secure sockets encrypt each write into their own buffer.
+    int written = 0;
+    for (var buffer in buffers) {
+      int length = buffer.length - offset;
+      int bytes = _write(buffer, offset, length);
+      written += bytes;
+      if (bytes < length) break;
+      offset = 0;
+    }
+    return written;
+  }
+
   void _enableWriteEvent() {
     _raw.writeEventsEnabled = true;
   }
@@ -1985,6 +2283,10 @@ class _RawDatagramSocket extends Stream<RawSocketEvent>
 
 @pragma("vm:entry-point", "call")
 Datagram _makeDatagram(
-    List<int> data, String address, Uint8List in_addr, int port) {
-  return new Datagram(data, new _InternetAddress(address, null, in_addr), port);
+    List<int> data, String address, Uint8List in_addr, int port, int type) {
+  return new Datagram(
+      data,
+      new _InternetAddress(
+          new InternetAddressType._from(type), address, null, in_addr),
+      port);
 }
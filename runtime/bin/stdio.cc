@@ -4,13 +4,24 @@
 
 #include "bin/stdio.h"
 
+#if !defined(HOST_OS_WINDOWS)
+#include <errno.h>     // NOLINT
+#include <poll.h>      // NOLINT
+#include <stdlib.h>    // NOLINT
+#include <string.h>    // NOLINT
+#include <sys/uio.h>   // NOLINT
+#include <unistd.h>    // NOLINT
+#endif
+
 #include "bin/builtin.h"
 #include "bin/dartutils.h"
+#include "bin/lockers.h"
 #include "bin/utils.h"
 
 #include "include/dart_api.h"
 
 #include "platform/globals.h"
+#include "platform/signal_blocker.h"
 #include "platform/utils.h"
 
 namespace dart {
@@ -160,5 +171,142 @@ void FUNCTION_NAME(Stdout_AnsiSupported)(Dart_NativeArguments args) {
   }
 }
 
+bool StdioWriter::drop_on_overflow_ = false;
+StdioWriter* StdioWriter::stdout_writer_ = NULL;
+StdioWriter* StdioWriter::stderr_writer_ = NULL;
+
+StdioWriter::StdioWriter(intptr_t fd, intptr_t capacity)
+    : fd_(fd),
+      capacity_(capacity),
+      buffer_(reinterpret_cast<uint8_t*>(malloc(capacity))),
+      monitor_(),
+      thread_started_(false),
+      start_(0),
+      end_(0) {}
+
+StdioWriter* StdioWriter::ForFd(intptr_t fd) {
+  if (fd == 1) {
+    return stdout_writer_;
+  }
+  if (fd == 2) {
+    return stderr_writer_;
+  }
+  return NULL;
+}
+
+#if defined(HOST_OS_WINDOWS)
+
+void StdioWriter::Configure(intptr_t buffer_size, bool drop_on_overflow) {
+  // Writes to the console are not buffered on Windows.
+}
+
+void StdioWriter::Write(const void* data, intptr_t length) {
+  UNREACHABLE();
+}
+
+void StdioWriter::Flush() {
+  UNREACHABLE();
+}
+
+#else
+
+void StdioWriter::Configure(intptr_t buffer_size, bool drop_on_overflow) {
+  ASSERT(stdout_writer_ == NULL);
+  if (buffer_size <= 0) {
+    return;
+  }
+  drop_on_overflow_ = drop_on_overflow;
+  stdout_writer_ = new StdioWriter(1, buffer_size);
+  stderr_writer_ = new StdioWriter(2, buffer_size);
+  // Output written before the process exits must not be lost.
+  atexit(FlushAll);
+}
+
+void StdioWriter::FlushAll() {
+  stdout_writer_->Flush();
+  stderr_writer_->Flush();
+}
+
+void StdioWriter::Write(const void* data, intptr_t length) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  MonitorLocker ml(&monitor_);
+  if (!thread_started_) {
+    int result = Thread::Start("dart:io StdioWriter", &StdioWriter::Run,
+                               reinterpret_cast<uword>(this));
+    if (result != 0) {
+      FATAL1("Failed to start stdio writer thread %d", result);
+    }
+    thread_started_ = true;
+  }
+  if (drop_on_overflow_ && (capacity_ - (end_ - start_) < length)) {
+    return;
+  }
+  while (length > 0) {
+    const intptr_t available = capacity_ - (end_ - start_);
+    if (available == 0) {
+      ml.Wait();
+      continue;
+    }
+    const intptr_t position = end_ % capacity_;
+    const intptr_t count =
+        Utils::Minimum(Utils::Minimum(available, length), capacity_ - position);
+    memmove(buffer_ + position, bytes, count);
+    end_ += count;
+    bytes += count;
+    length -= count;
+    ml.NotifyAll();
+  }
+}
+
+void StdioWriter::Flush() {
+  MonitorLocker ml(&monitor_);
+  const int64_t end = end_;
+  while (start_ < end) {
+    ml.Wait();
+  }
+}
+
+void StdioWriter::Run(uword parameter) {
+  reinterpret_cast<StdioWriter*>(parameter)->FlushLoop();
+}
+
+void StdioWriter::FlushLoop() {
+  monitor_.Enter();
+  while (true) {
+    while (start_ == end_) {
+      monitor_.Wait(Monitor::kNoTimeout);
+    }
+    // The buffered bytes wrap around the end of the ring at most once, so
+    // they are written with one writev of at most two parts. Writers only
+    // fill the free part of the ring, so the lock is not held while writing.
+    const intptr_t position = start_ % capacity_;
+    const intptr_t pending = end_ - start_;
+    struct iovec parts[2];
+    int part_count = 1;
+    parts[0].iov_base = buffer_ + position;
+    parts[0].iov_len = Utils::Minimum(pending, capacity_ - position);
+    if (static_cast<intptr_t>(parts[0].iov_len) < pending) {
+      parts[1].iov_base = buffer_;
+      parts[1].iov_len = pending - parts[0].iov_len;
+      part_count = 2;
+    }
+    monitor_.Exit();
+    ssize_t written = TEMP_FAILURE_RETRY(writev(fd_, parts, part_count));
+    if ((written < 0) && (errno == EAGAIN)) {
+      // The fd was made non-blocking by another process sharing it.
+      struct pollfd pfd = {static_cast<int>(fd_), POLLOUT, 0};
+      TEMP_FAILURE_RETRY(poll(&pfd, 1, -1));
+      written = 0;
+    }
+    monitor_.Enter();
+    // Bytes that cannot be written, e.g. to a closed pipe, are discarded
+    // like the failed writes of an unbuffered stdout.
+    start_ = (written < 0) ? end_ : start_ + written;
+    monitor_.NotifyAll();
+  }
+}
+
+#endif  // defined(HOST_OS_WINDOWS)
+
 }  // namespace bin
 }  // namespace dart
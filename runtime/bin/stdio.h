@@ -6,6 +6,7 @@
 #define RUNTIME_BIN_STDIO_H_
 
 #include "bin/builtin.h"
+#include "bin/thread.h"
 #include "bin/utils.h"
 
 #include "platform/globals.h"
@@ -40,6 +41,49 @@ class Stdout {
   DISALLOW_IMPLICIT_CONSTRUCTORS(Stdout);
 };
 
+// Buffers the bytes written to stdout and stderr, and writes them to the file
+// descriptor on a thread of its own, so that printing does not block the
+// isolate while the terminal or pipe is slow to drain. Writes are only
+// buffered after Configure has been called with a non-zero size.
+class StdioWriter {
+ public:
+  // Gives fds 1 and 2 a ring buffer of 'buffer_size' bytes each. When a
+  // buffer is full, writes wait for it to drain, or with 'drop_on_overflow'
+  // a write that does not fit is dropped instead.
+  static void Configure(intptr_t buffer_size, bool drop_on_overflow);
+
+  // Returns the writer for 'fd', or NULL if writes to it are not buffered.
+  static StdioWriter* ForFd(intptr_t fd);
+
+  void Write(const void* data, intptr_t length);
+
+  // Waits until everything written so far has been written to the fd.
+  void Flush();
+
+ private:
+  StdioWriter(intptr_t fd, intptr_t capacity);
+
+  static void FlushAll();
+  static void Run(uword parameter);
+  void FlushLoop();
+
+  const intptr_t fd_;
+  const intptr_t capacity_;
+  uint8_t* buffer_;
+  Monitor monitor_;
+  bool thread_started_;
+  // Bytes are buffered at positions [start_, end_) modulo capacity_. Only the
+  // flush thread advances start_, after the bytes have been written.
+  int64_t start_;
+  int64_t end_;
+
+  static bool drop_on_overflow_;
+  static StdioWriter* stdout_writer_;
+  static StdioWriter* stderr_writer_;
+
+  DISALLOW_COPY_AND_ASSIGN(StdioWriter);
+};
+
 }  // namespace bin
 }  // namespace dart
 
@@ -91,7 +91,7 @@ class _NativeSynchronousSocket extends _NativeSynchronousSocketNativeWrapper {
       var address = it.current;
       var socket = new _NativeSynchronousSocket();
       socket.localAddress = address;
-      var result = socket.nativeCreateConnectSync(address._in_addr, port);
+      var result = socket.nativeCreateConnectSync(address._sockaddr, port);
       if (result is OSError) {
         // Keep first error, if present.
         if (error == null) {
@@ -142,7 +142,8 @@ class _NativeSynchronousSocket extends _NativeSynchronousSocketNativeWrapper {
       throw result;
     }
     var addr = result[0];
-    return new _InternetAddress(addr[1], null, addr[2]);
+    var type = new InternetAddressType._from(addr[0]);
+    return new _InternetAddress(type, addr[1], null, addr[2]);
   }
 
   int get remotePort {
@@ -186,7 +187,8 @@ class _NativeSynchronousSocket extends _NativeSynchronousSocketNativeWrapper {
         new List<_InternetAddress>(response.length);
     for (int i = 0; i < response.length; ++i) {
       var result = response[i];
-      addresses[i] = new _InternetAddress(result[1], host, result[2]);
+      var type = new InternetAddressType._from(result[0]);
+      addresses[i] = new _InternetAddress(type, result[1], host, result[2]);
     }
     return addresses;
   }
@@ -500,6 +500,19 @@ DART_EXPORT void Dart_DeleteWeakPersistentHandle(
     Dart_Isolate isolate,
     Dart_WeakPersistentHandle object);
 
+/**
+ * Sets whether the callback of a weak persistent handle is invoked when the
+ * isolate shuts down while its object is still alive and the VM runs with
+ * --fast_shutdown, e.g. because it releases a resource that outlives the
+ * isolate. Other callbacks are only skipped with --fast_shutdown; without
+ * it, the callbacks of all weak persistent handles are invoked when the
+ * isolate shuts down.
+ *
+ * Requires there to be a current isolate.
+ */
+DART_EXPORT void Dart_SetFinalizeOnShutdown(Dart_WeakPersistentHandle object,
+                                            bool finalize_on_shutdown);
+
 /*
  * ==========================
  * Initialization and Globals
@@ -1048,6 +1061,30 @@ DART_EXPORT void Dart_NotifyIdle(int64_t deadline);
  */
 DART_EXPORT void Dart_NotifyLowMemory();
 
+/**
+ * Reports that the embedder allocated |size| bytes of native memory that is
+ * kept alive by Dart objects of the current isolate, e.g. decoded images held
+ * by small wrapper objects, but not attached to them with
+ * Dart_NewWeakPersistentHandle.
+ *
+ * The VM counts such memory against the old generation's external memory
+ * budget, which is separate from the budget of the heap pages, and collects
+ * garbage when it grows faster than collections release it (see
+ * Dart_ReportExternalFree).
+ *
+ * Requires there to be a current isolate. May trigger a garbage collection.
+ */
+DART_EXPORT void Dart_ReportExternalAllocation(intptr_t size);
+
+/**
+ * Reports that the embedder freed |size| bytes of native memory previously
+ * reported with Dart_ReportExternalAllocation, typically from the finalizer
+ * of the object that kept it alive.
+ *
+ * Requires there to be a current isolate.
+ */
+DART_EXPORT void Dart_ReportExternalFree(intptr_t size);
+
 /**
  * Starts the CPU sampling profiler.
  */
@@ -1152,6 +1189,26 @@ DART_EXPORT bool Dart_IsKernel(const uint8_t* buffer, intptr_t buffer_size);
 DART_EXPORT DART_WARN_UNUSED_RESULT char* Dart_IsolateMakeRunnable(
     Dart_Isolate isolate);
 
+/**
+ * Sets the number of isolates which the isolate group of the current isolate
+ * keeps created and initialized ahead of `Isolate.spawn()`.
+ *
+ * Pooled isolates are created on the VM's thread pool and initialized with
+ * the Dart_InitializeIsolateCallback, so the pool is only used by embedders
+ * which provide that callback. A spawn takes a pooled isolate if one is ready
+ * and creates a new one otherwise. Isolates are never returned to the pool
+ * after running. Pooled isolates are shut down when no other isolate of the
+ * group is left.
+ *
+ * Must be called after the program of the group has been loaded, since
+ * pooled isolates are created from the same source as the current isolate.
+ * The default size is given by the VM flag `--isolate_spawn_pool_size`.
+ *
+ * \param size The number of isolates to keep ready. 0 stops refilling the
+ *   pool.
+ */
+DART_EXPORT void Dart_SetIsolateSpawnPoolSize(intptr_t size);
+
 /*
  * ==================
  * Messages and Ports
@@ -1459,6 +1516,44 @@ DART_EXPORT void Dart_ExitScope();
  */
 DART_EXPORT uint8_t* Dart_ScopeAllocate(intptr_t size);
 
+/**
+ * An arena is a zone owned by the embedder. Unlike memory from
+ * Dart_ScopeAllocate, memory allocated in an arena outlives API scopes and
+ * native port handlers, and is only reclaimed when the arena is reset or
+ * deleted. Resetting an arena, e.g. after each request handled by a native,
+ * frees everything allocated in it at once.
+ *
+ * Arenas can be used without a current isolate. An arena must not be used
+ * from several threads at the same time.
+ */
+typedef struct _Dart_Arena* Dart_Arena;
+
+/**
+ * Creates an empty arena.
+ */
+DART_EXPORT Dart_Arena Dart_NewArena();
+
+/**
+ * Allocates memory in an arena.
+ *
+ * \param arena The arena to allocate in.
+ * \param size Size of the memory to allocate.
+ *
+ * \return A pointer to the allocated memory, which is valid until the arena
+ *   is reset or deleted.
+ */
+DART_EXPORT uint8_t* Dart_ArenaAllocate(Dart_Arena arena, intptr_t size);
+
+/**
+ * Frees all memory allocated in an arena. The arena can then be used again.
+ */
+DART_EXPORT void Dart_ResetArena(Dart_Arena arena);
+
+/**
+ * Frees all memory allocated in an arena and deletes the arena.
+ */
+DART_EXPORT void Dart_DeleteArena(Dart_Arena arena);
+
 /*
  * =======
  * Objects
@@ -1910,6 +2005,33 @@ Dart_NewExternalLatin1String(const uint8_t* latin1_array,
                              intptr_t external_allocation_size,
                              Dart_WeakPersistentHandleFinalizer callback);
 
+/**
+ * Returns a String built from an external array of UTF-8 encoded
+ * characters.
+ *
+ * If all the characters are ASCII, the String references the array without
+ * copying it, as with Dart_NewExternalLatin1String. Otherwise the characters
+ * are decoded into a String in the Dart heap. In both cases the array must
+ * stay valid until the callback is called when the String is finalized, but
+ * only a String that references the array has a peer.
+ *
+ * \param utf8_array Array of UTF-8 encoded characters. This must not move.
+ * \param length The length of the characters array.
+ * \param peer An external pointer to associate with this string.
+ * \param external_allocation_size The number of externally allocated
+ *   bytes for peer. Used to inform the garbage collector.
+ * \param callback A callback to be called when this string is finalized.
+ *
+ * \return The String object if no error occurs. Otherwise returns
+ *   an error handle.
+ */
+DART_EXPORT Dart_Handle
+Dart_NewExternalUTF8String(const uint8_t* utf8_array,
+                           intptr_t length,
+                           void* peer,
+                           intptr_t external_allocation_size,
+                           Dart_WeakPersistentHandleFinalizer callback);
+
 /**
  * Returns a String which references an external array of UTF-16 encoded
  * characters.
@@ -2117,6 +2239,40 @@ DART_EXPORT Dart_Handle Dart_ListGetRange(Dart_Handle list,
                                           intptr_t length,
                                           Dart_Handle* result);
 
+/**
+ * Gets a range of ints from a List into a native array.
+ *
+ * The elements of lists created with the List constructor or literals are
+ * read directly, without allocating a handle per element. Other lists are
+ * read through their index operator. The data of typed data lists can also
+ * be accessed in place with Dart_TypedDataAcquireData.
+ *
+ * If any of the requested index values are out of bounds, or an element is
+ * not an int, an error occurs.
+ *
+ * May generate an unhandled exception error.
+ *
+ * \param list A List.
+ * \param offset The offset of the first item to get.
+ * \param length The number of items to get.
+ * \param result A native array of at least 'length' elements to fill.
+ *
+ * \return Success if no error occurs during the operation.
+ */
+DART_EXPORT Dart_Handle Dart_ListGetRangeAsInt64(Dart_Handle list,
+                                                 intptr_t offset,
+                                                 intptr_t length,
+                                                 int64_t* result);
+
+/**
+ * Gets a range of nums from a List into a native array of doubles, like
+ * Dart_ListGetRangeAsInt64. Int elements are converted to double.
+ */
+DART_EXPORT Dart_Handle Dart_ListGetRangeAsDouble(Dart_Handle list,
+                                                  intptr_t offset,
+                                                  intptr_t length,
+                                                  double* result);
+
 /**
  * Sets the Object at some index of a List.
  *
@@ -2284,6 +2440,28 @@ DART_EXPORT Dart_Handle Dart_NewExternalTypedDataWithFinalizer(
     intptr_t external_allocation_size,
     Dart_WeakPersistentHandleFinalizer callback);
 
+/**
+ * Returns a TransferableTypedData object whose content is the concatenation
+ * of the given buffers, without copying them.
+ *
+ * The VM takes ownership of the buffers, which must have been allocated with
+ * malloc, and frees them when they are no longer needed. The buffers are
+ * passed on as they are when the object is sent to another isolate. They are
+ * only concatenated when the object is materialized, and a single buffer
+ * becomes the materialized data without a copy.
+ *
+ * \param chunks The buffers. They must not be accessed by the embedder after
+ *   this call succeeds.
+ * \param lengths The length in bytes of each buffer.
+ * \param num_chunks The number of buffers, at least 1.
+ *
+ * \return The TransferableTypedData object if no error occurs. Otherwise
+ *   returns an error handle, and the buffers remain owned by the embedder.
+ */
+DART_EXPORT Dart_Handle Dart_NewTransferableTypedData(uint8_t* const* chunks,
+                                                      const intptr_t* lengths,
+                                                      intptr_t num_chunks);
+
 /**
  * Returns a ByteBuffer object for the typed data.
  *
@@ -2428,6 +2606,43 @@ Dart_Invoke(Dart_Handle target,
             Dart_Handle* arguments);
 /* TODO(turnidge): Document how to invoke operators. */
 
+/**
+ * Looks up a static method or top-level function, so that it can be invoked
+ * repeatedly with Dart_InvokeFunction without resolving its name each time.
+ *
+ * The 'target' parameter may be a type or a library, as for Dart_Invoke.
+ * The lookup is not updated by hot reload; it has to be repeated after the
+ * program has been reloaded.
+ *
+ * This function ignores visibility (leading underscores in names).
+ *
+ * \param target A type or library.
+ * \param name The name of the function to look up.
+ *
+ * \return The function, which can be kept in a persistent handle. If no
+ *   function with this name is found, an error handle is returned.
+ */
+DART_EXPORT DART_WARN_UNUSED_RESULT Dart_Handle
+Dart_LookupFunction(Dart_Handle target, Dart_Handle name);
+
+/**
+ * Invokes a function returned by Dart_LookupFunction.
+ *
+ * May generate an unhandled exception error.
+ *
+ * \param function A function returned by Dart_LookupFunction.
+ * \param number_of_arguments Size of the arguments array.
+ * \param arguments An array of arguments to the function.
+ *
+ * \return If the function is called and completes successfully, then the
+ *   return value is returned. If an error occurs during execution, then an
+ *   error handle is returned.
+ */
+DART_EXPORT DART_WARN_UNUSED_RESULT Dart_Handle
+Dart_InvokeFunction(Dart_Handle function,
+                    int number_of_arguments,
+                    Dart_Handle* arguments);
+
 /**
  * Invokes a Closure with the given arguments.
  *
@@ -2835,6 +3050,33 @@ typedef Dart_NativeFunction (*Dart_NativeEntryResolver)(Dart_Handle name,
  */
 typedef const uint8_t* (*Dart_NativeEntrySymbol)(Dart_NativeFunction nf);
 
+/**
+ * FFI native resolution callback.
+ *
+ * Static native functions annotated with @pragma('vm:ffi-native') take only
+ * int, double and typed data arguments and return int, double or void. The
+ * embedder can resolve such a native to a plain C function, which the VM then
+ * calls directly like a leaf FFI call: int arguments are passed as int64_t,
+ * doubles as double and typed data as a pointer to its first element. No
+ * Dart_NativeArguments are built and no API scope is entered, so the C
+ * function must not call back into the Dart API, and it must not keep the
+ * typed data pointers after it returns. A call with a typed data argument
+ * which is null or not a typed data object of the VM, such as an
+ * UnmodifiableUint8ListView, goes through the regular native resolver
+ * instead.
+ *
+ * The parameters to the resolver function are:
+ * \param name The native name of the function, as a UTF-8 string.
+ * \param num_of_arguments The number of arguments of the native function.
+ *
+ * \return The address of the C function, or NULL if the native should be
+ *   called through the regular Dart_NativeEntryResolver instead.
+ *
+ * See Dart_SetFfiNativeResolver.
+ */
+typedef void* (*Dart_FfiNativeResolver)(const char* name,
+                                        uintptr_t num_of_arguments);
+
 /*
  * ===========
  * Environment
@@ -2897,6 +3139,22 @@ Dart_GetNativeResolver(Dart_Handle library, Dart_NativeEntryResolver* resolver);
 DART_EXPORT Dart_Handle Dart_GetNativeSymbol(Dart_Handle library,
                                              Dart_NativeEntrySymbol* resolver);
 
+/**
+ * Sets the callback used to resolve 'vm:ffi-native' natives of a library to
+ * C functions which are called without Dart_NativeArguments.
+ *
+ * Must be set before the natives are compiled. Natives which are not resolved
+ * are called through the regular native resolver.
+ *
+ * \param library A library.
+ * \param resolver An FFI native resolver.
+ *
+ * \return A valid handle if the resolver was set successfully.
+ */
+DART_EXPORT Dart_Handle
+Dart_SetFfiNativeResolver(Dart_Handle library,
+                          Dart_FfiNativeResolver resolver);
+
 /*
  * =====================
  * Scripts and Libraries
@@ -111,6 +111,82 @@ DART_EXPORT bool Dart_PostCObject(Dart_Port port_id, Dart_CObject* message);
  */
 DART_EXPORT bool Dart_PostInteger(Dart_Port port_id, int64_t message);
 
+/**
+ * A pool of fixed-size buffers for sending data from native code to Dart
+ * without copying it.
+ *
+ * A buffer acquired from the pool is filled by the sender and posted as a
+ * Dart_CObject_kExternalTypedData set up by Dart_NativeBufferPoolMakeCObject.
+ * The receiving isolate gets an external Uint8List backed by the buffer, and
+ * the buffer goes back to the pool when that list is garbage collected or
+ * when the message is discarded, ready to be acquired again by the sender.
+ */
+typedef struct _Dart_NativeBufferPool* Dart_NativeBufferPool;
+
+/**
+ * Creates a buffer pool.
+ *
+ * \param buffer_size The size in bytes of each buffer.
+ * \param max_free_buffers The number of returned buffers kept for reuse.
+ *   Buffers returned beyond this are freed.
+ *
+ * \return The pool, or NULL if the arguments are invalid.
+ */
+DART_EXPORT Dart_NativeBufferPool
+Dart_NewNativeBufferPool(intptr_t buffer_size, intptr_t max_free_buffers);
+
+/**
+ * Deletes a buffer pool. Buffers still held by the sender or by Dart remain
+ * valid; the pool is freed once all of them have been returned.
+ */
+DART_EXPORT void Dart_DeleteNativeBufferPool(Dart_NativeBufferPool pool);
+
+/**
+ * Returns a buffer of the pool's buffer size, reusing a returned buffer when
+ * one is available, or NULL if it could not be allocated.
+ */
+DART_EXPORT uint8_t* Dart_NativeBufferPoolAcquire(Dart_NativeBufferPool pool);
+
+/**
+ * Returns a buffer which was acquired but not posted to its pool.
+ */
+DART_EXPORT void Dart_NativeBufferPoolRelease(uint8_t* buffer);
+
+/**
+ * Sets up |object| as a Dart_CObject_kExternalTypedData of type Uint8 whose
+ * data are the first |length| bytes of |buffer|, which must have been
+ * acquired from a pool and must not be accessed by the caller once the
+ * object has been posted with Dart_PostCObject. If the message is not
+ * delivered, the buffer is returned to the pool.
+ */
+DART_EXPORT void Dart_NativeBufferPoolMakeCObject(uint8_t* buffer,
+                                                  intptr_t length,
+                                                  Dart_CObject* object);
+
+/**
+ * A queue of fixed-size records through which native threads call back into
+ * Dart asynchronously, created in Dart with AsyncCallbackQueue from dart:ffi,
+ * whose handle is the address of the queue.
+ *
+ * The records are handed to the queue's Dart callback in batches on the
+ * event loop of the isolate which created it, without serializing them into
+ * Dart objects.
+ */
+typedef struct _Dart_AsyncCallbackQueue* Dart_AsyncCallbackQueue;
+
+/**
+ * Posts a copy of a record of the queue's record size to the queue. May be
+ * called on any thread, but not after the queue has been closed in Dart.
+ *
+ * The copy is allocated with malloc, and the post which finds the queue empty
+ * also sends a message to the isolate which created it, which takes the
+ * port map lock. So posting is neither allocation free nor async-signal-safe.
+ *
+ * \return True if the record was posted.
+ */
+DART_EXPORT bool Dart_PostAsyncCallback(Dart_AsyncCallbackQueue queue,
+                                        const void* record);
+
 /**
  * A native message handler.
  *
@@ -143,6 +219,81 @@ DART_EXPORT Dart_Port Dart_NewNativePort(const char* name,
                                          bool handle_concurrently);
 /* TODO(turnidge): Currently handle_concurrently is ignored. */
 
+/**
+ * A native message handler that receives the messages pending on its port
+ * together, in the order they were posted.
+ *
+ * The messages and the array holding them are reclaimed when the handler
+ * returns, as for Dart_NativeMessageHandler.
+ */
+typedef void (*Dart_NativeMessageBatchHandler)(Dart_Port dest_port_id,
+                                               Dart_CObject** messages,
+                                               intptr_t count);
+
+/**
+ * Where the handler of a native port runs.
+ */
+typedef enum {
+  /* On the VM's thread pool, possibly on a different thread for each run. */
+  Dart_NativePortThreading_ThreadPool = 0,
+  /* On a thread started for the port, which lives until the port is closed.
+   * The handler always runs on that thread. */
+  Dart_NativePortThreading_DedicatedThread,
+  /* On the threads of an executor provided by the embedder. */
+  Dart_NativePortThreading_Executor,
+} Dart_NativePortThreading;
+
+/**
+ * A task the VM asks an executor to run once.
+ */
+typedef void (*Dart_NativePortTask)(void* task_data);
+
+/**
+ * Runs |task| with |task_data| on a thread of the executor. Must not run the
+ * task before returning, and must run every task it is given, even after the
+ * port is closed.
+ */
+typedef void (*Dart_NativePortExecutor)(Dart_NativePortTask task,
+                                        void* task_data,
+                                        void* executor_data);
+
+typedef struct {
+  Dart_NativePortThreading threading;
+
+  /* The executor and its data for Dart_NativePortThreading_Executor. */
+  Dart_NativePortExecutor executor;
+  void* executor_data;
+
+  /* Whether several messages may be handled at the same time, on different
+   * threads. Only for handlers that keep no state between messages; not
+   * supported with Dart_NativePortThreading_DedicatedThread. */
+  bool handle_concurrently;
+
+  /* If set, pending messages are passed to this handler in batches instead
+   * of one by one to the message handler. */
+  Dart_NativeMessageBatchHandler batch_handler;
+
+  /* The largest batch, or 0 for no limit. */
+  intptr_t max_batch_size;
+} Dart_NativePortOptions;
+
+/**
+ * Creates a new native port like Dart_NewNativePort, with control over the
+ * threads its handler runs on and over how messages are delivered to it.
+ *
+ * \param name The name of this port in debugging messages.
+ * \param handler The C handler to run for each message, or NULL if
+ *   options->batch_handler is set.
+ * \param options How the port's messages are handled.
+ *
+ * \return If successful, returns the port id for the native port.  In
+ *   case of error, returns ILLEGAL_PORT.
+ */
+DART_EXPORT Dart_Port
+Dart_NewNativePortWithOptions(const char* name,
+                              Dart_NativeMessageHandler handler,
+                              const Dart_NativePortOptions* options);
+
 /**
  * Closes the native port with the given id.
  *
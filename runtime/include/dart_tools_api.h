@@ -268,6 +268,49 @@ DART_EXPORT Dart_Handle Dart_ServiceSendDataEvent(const char* stream_id,
                                                   const uint8_t* bytes,
                                                   intptr_t bytes_length);
 
+/*
+ * ========
+ * Heap Snapshots
+ * ========
+ */
+
+/**
+ * A callback that receives a chunk of a heap snapshot, e.g. to write it to a
+ * file descriptor. The chunk is only valid during the call.
+ *
+ * \param context The context passed to Dart_WriteHeapSnapshot.
+ *
+ * \param buffer The bytes of the chunk. Chunks may end in the middle of an
+ *   encoded value.
+ *
+ * \param size The number of bytes in the chunk.
+ *
+ * \param is_last Whether this is the last chunk, which may be empty.
+ */
+typedef void (*Dart_HeapSnapshotWriteChunkCallback)(void* context,
+                                                    uint8_t* buffer,
+                                                    intptr_t size,
+                                                    bool is_last);
+
+/**
+ * Writes a snapshot of the current isolate's heap, in the format sent on the
+ * _Graph service stream, through 'write'.
+ *
+ * The snapshot is passed to 'write' in megabyte-sized chunks as the heap is
+ * walked, so that it is never held in memory as a whole. Dominators and
+ * retained sizes are left to the tool reading the snapshot. The isolate is
+ * stopped while the snapshot is written, so 'write' must not call into the
+ * Dart API.
+ *
+ * Requires there to be a current isolate.
+ *
+ * \return NULL if the snapshot was written. Otherwise, returns an error
+ *   message, which the caller is responsible for freeing.
+ */
+DART_EXPORT char* Dart_WriteHeapSnapshot(
+    Dart_HeapSnapshotWriteChunkCallback write,
+    void* context);
+
 /*
  * ========
  * Reload support
@@ -432,5 +475,105 @@ DART_EXPORT int64_t
 Dart_IsolateRunnableLatencyMetric(Dart_Isolate isolate);  // Microsecond
 DART_EXPORT int64_t
 Dart_IsolateRunnableHeapSizeMetric(Dart_Isolate isolate);  // Byte
+DART_EXPORT int64_t
+Dart_IsolateSafepointReachTimeMetric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateSafepointReachTimeMaxMetric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateMessageQueueDepthMetric(Dart_Isolate isolate);  // Counter
+DART_EXPORT int64_t
+Dart_IsolateMessageQueueDepthMaxMetric(Dart_Isolate isolate);  // Counter
+DART_EXPORT int64_t
+Dart_IsolateMessagesHandledMetric(Dart_Isolate isolate);  // Counter
+DART_EXPORT int64_t
+Dart_IsolateMessagesPerSecondMetric(Dart_Isolate isolate);  // Counter
+DART_EXPORT int64_t
+Dart_IsolateMessageLatencyMetric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateMessageLatencyMaxMetric(Dart_Isolate isolate);  // Microsecond
+
+/**
+ * Returns an upper bound in microseconds on the time messages to an isolate
+ * waited between being posted and being handled at 'percentile' (0 to 100).
+ * The bound is within 1/16 of the recorded latency. Returns 0 if no message
+ * has been handled.
+ *
+ * This may be called from any thread, e.g. to apply backpressure to the
+ * senders of a slow isolate together with
+ * Dart_IsolateMessageQueueDepthMetric.
+ */
+DART_EXPORT int64_t
+Dart_IsolateMessageLatencyPercentileMetric(Dart_Isolate isolate,
+                                           double percentile);  // Microsecond
+
+/**
+ * Stop-the-world pauses whose durations are kept in per-isolate histograms.
+ */
+typedef enum {
+  Dart_GCPause_Scavenge = 0,
+  Dart_GCPause_MarkSweep,
+  Dart_GCPause_MarkCompact,
+  /** Time taken for all threads to reach a safepoint for a collection. */
+  Dart_GCPause_Safepoint,
+  /** Time taken to finish a concurrent mark. */
+  Dart_GCPause_MarkingFinalization,
+} Dart_GCPauseKind;
+
+/**
+ * Returns the number of pauses of the given kind recorded for an isolate.
+ *
+ * Pauses are recorded whether or not the timeline is enabled. This may be
+ * called from any thread; the result is a snapshot and may be slightly stale
+ * if the isolate is collecting concurrently.
+ */
+DART_EXPORT int64_t Dart_IsolateGCPauseCountMetric(Dart_Isolate isolate,
+                                                   Dart_GCPauseKind kind);
+
+/**
+ * Returns an upper bound in microseconds on the pause of the given kind at
+ * 'percentile' (0 to 100), e.g. 99 for the p99 pause. The bound is within
+ * 1/16 of the recorded pause. Returns 0 if no pause has been recorded.
+ */
+DART_EXPORT int64_t
+Dart_IsolateGCPausePercentileMetric(Dart_Isolate isolate,
+                                    Dart_GCPauseKind kind,
+                                    double percentile);  // Microsecond
+
+/**
+ * The value of a metric in a snapshot of the metrics of the VM or of an
+ * isolate.
+ */
+typedef struct {
+  /** The name of the metric, e.g. "heap.old.used". Statically allocated. */
+  const char* name;
+  int64_t value;
+} Dart_MetricValue;
+
+/**
+ * Fills 'metrics' with the current values of the first 'length' metrics of
+ * the VM, e.g. "vm.memory.current" and "vm.thread_pool.workers.running".
+ *
+ * Returns the number of metrics of the VM, which may be more than 'length':
+ * call with a 'length' of 0 to size the array. The metrics are always
+ * reported in the same order.
+ *
+ * This does not need the service isolate and may be called from any thread,
+ * e.g. periodically by a metrics exporter. Returns 0 in PRODUCT builds.
+ */
+DART_EXPORT intptr_t Dart_VMMetricsSnapshot(Dart_MetricValue* metrics,
+                                            intptr_t length);
+
+/**
+ * Like Dart_VMMetricsSnapshot, but for the metrics of an isolate, which
+ * cover its heap, collections, compilations and message queue, e.g.
+ * "heap.old.used", "heap.new.collections", "isolate.compilations.optimized"
+ * and "isolate.messages.depth".
+ *
+ * This may be called from any thread while the isolate is alive. The values
+ * are read without stopping the isolate, so they may be slightly stale.
+ */
+DART_EXPORT intptr_t Dart_IsolateMetricsSnapshot(Dart_Isolate isolate,
+                                                 Dart_MetricValue* metrics,
+                                                 intptr_t length);
 
 #endif  // RUNTIME_INCLUDE_DART_TOOLS_API_H_
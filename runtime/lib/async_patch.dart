@@ -17,31 +17,35 @@ import "dart:_internal" show VMLibraryHooks, patch;
 // Equivalent of calling FATAL from C++ code.
 _fatal(msg) native "DartAsync_fatal";
 
+// The future of an async function is completed directly, rather than
+// through a nested Completer, to save an allocation per call.
 class _AsyncAwaitCompleter<T> implements Completer<T> {
-  final _completer = new Completer<T>.sync();
+  final _future = new _Future<T>();
   bool isSync;
 
   _AsyncAwaitCompleter() : isSync = false;
 
   void complete([FutureOr<T> value]) {
+    if (!_future._mayComplete) throw new StateError("Future already completed");
     if (isSync) {
-      _completer.complete(value);
-    } else if (value is Future<T>) {
-      value.then(_completer.complete, onError: _completer.completeError);
+      _future._complete(value);
     } else {
-      scheduleMicrotask(() {
-        _completer.complete(value);
-      });
+      _future._asyncComplete(value);
     }
   }
 
   void completeError(e, [st]) {
+    e = _nonNullError(e);
+    if (!_future._mayComplete) throw new StateError("Future already completed");
+    AsyncError replacement = Zone.current.errorCallback(e, st);
+    if (replacement != null) {
+      e = _nonNullError(replacement.error);
+      st = replacement.stackTrace;
+    }
     if (isSync) {
-      _completer.completeError(e, st);
+      _future._completeError(e, st);
     } else {
-      scheduleMicrotask(() {
-        _completer.completeError(e, st);
-      });
+      _future._asyncCompleteError(e, st);
     }
   }
 
@@ -50,8 +54,8 @@ class _AsyncAwaitCompleter<T> implements Completer<T> {
     isSync = true;
   }
 
-  Future<T> get future => _completer.future;
-  bool get isCompleted => _completer.isCompleted;
+  Future<T> get future => _future;
+  bool get isCompleted => !_future._mayComplete;
 }
 
 // We need to pass the value as first argument and leave the second and third
@@ -90,11 +94,18 @@ Function _asyncErrorWrapperHelper(continuation) {
 ///
 /// If [object] is not a future, then it is wrapped into one.
 ///
-/// Returns the result of registering with `.then`.
+/// Returns the result of registering with `.then`, or null if [object] is not
+/// a future. The result is unused by the async transformation.
 Future _awaitHelper(
     var object, Function thenCallback, Function errorCallback, var awaiter) {
   if (object is! Future) {
-    object = new _Future().._setValue(object);
+    // Awaiting a value still resumes in a later microtask, but without the
+    // value future, listener and result future of a `.then`.
+    final zone = Zone.current;
+    zone.scheduleMicrotask(() {
+      zone.runUnary(thenCallback, object);
+    });
+    return null;
   } else if (object is! _Future) {
     return object.then(thenCallback, onError: errorCallback);
   }
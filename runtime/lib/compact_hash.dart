@@ -123,11 +123,61 @@ abstract class _HashBase implements _HashVMBase {
       !identical(_data, oldData) || (_checkSum != oldCheckSum);
 
   int get length;
+  int _hashCode(e);
+
+  // Returns an index of twice the size of _index for the same entries, each
+  // of which takes [entrySize] slots of _data, or null if _index does not
+  // keep enough hash bits for the larger size.
+  //
+  // The pairs in _index keep the low bits of the hash codes of their keys,
+  // so the entries are placed without calling hashCode or ==. Only keys
+  // whose masked hash is 0, which is stored as 1, are hashed again.
+  Uint32List _growIndex(int entrySize) {
+    final Uint32List oldIndex = _index;
+    final int oldSize = oldIndex.length;
+    final int size = oldSize << 1;
+    final int sizeMask = size - 1;
+    if ((_hashMask & sizeMask) != sizeMask) {
+      return null;
+    }
+    final int hashMask = _hashMask >> 1;
+    final int entryBits = oldSize.bitLength - 2;
+    final int entryMask = (1 << entryBits) - 1;
+    final Uint32List index = new Uint32List(size);
+    for (int i = 0; i < oldSize; i++) {
+      final int pair = oldIndex[i];
+      if (pair == _UNUSED_PAIR || pair == _DELETED_PAIR) {
+        continue;
+      }
+      final int entry = pair & entryMask;
+      int maskedHash = pair >> entryBits;
+      if (maskedHash == 1) {
+        maskedHash = _hashCode(_data[entry * entrySize]) & _hashMask;
+      }
+      int j = _firstProbe(maskedHash, sizeMask);
+      while (index[j] != _UNUSED_PAIR) {
+        j = _nextProbe(j, sizeMask);
+      }
+      index[j] = _hashPattern(maskedHash, hashMask, size) | entry;
+    }
+    return index;
+  }
 }
 
 class _OperatorEqualsAndHashCode {
-  int _hashCode(e) => e.hashCode;
-  bool _equals(e1, e2) => e1 == e2;
+  // Strings and integers, the most common keys, get call sites of their own,
+  // which stay monomorphic instead of sharing the megamorphic generic ones.
+  int _hashCode(e) {
+    if (e is String) return e.hashCode;
+    if (e is int) return e.hashCode;
+    return e.hashCode;
+  }
+
+  bool _equals(e1, e2) {
+    if (e1 is String) return e1 == e2;
+    if (e1 is int) return e1 == e2;
+    return e1 == e2;
+  }
 }
 
 class _IdenticalAndIdentityHashCode {
@@ -168,12 +218,34 @@ abstract class _LinkedHashMapMixin<K, V> implements _HashBase {
       // TODO(koda): Consider shrinking.
       // TODO(koda): Consider in-place compaction and more costly CME check.
       _init(_index.length, _hashMask, _data, _usedData);
-    } else {
+    } else if (!_grow()) {
       // TODO(koda): Support 32->64 bit transition (and adjust _hashMask).
       _init(_index.length << 1, _hashMask >> 1, _data, _usedData);
     }
   }
 
+  // Doubles the size of _index and _data without rehashing the keys, which
+  // is only possible while no keys are deleted, so that entries keep their
+  // place in _data.
+  bool _grow() {
+    if (_deletedKeys != 0) {
+      return false;
+    }
+    final Uint32List index = _growIndex(2);
+    if (index == null) {
+      return false;
+    }
+    final List oldData = _data;
+    final List data = new List(index.length);
+    for (int i = 0; i < _usedData; i++) {
+      data[i] = oldData[i];
+    }
+    _index = index;
+    _hashMask = _hashMask >> 1;
+    _data = data;
+    return true;
+  }
+
   void clear() {
     if (!isEmpty) {
       _init(_HashBase._INITIAL_INDEX_SIZE, _hashMask, null, 0);
@@ -491,11 +563,31 @@ class _CompactLinkedHashSet<E> extends _HashFieldBase
   void _rehash() {
     if ((_deletedKeys << 1) > _usedData) {
       _init(_index.length, _hashMask, _data, _usedData);
-    } else {
+    } else if (!_grow()) {
       _init(_index.length << 1, _hashMask >> 1, _data, _usedData);
     }
   }
 
+  // See _LinkedHashMapMixin._grow.
+  bool _grow() {
+    if (_deletedKeys != 0) {
+      return false;
+    }
+    final Uint32List index = _growIndex(1);
+    if (index == null) {
+      return false;
+    }
+    final List oldData = _data;
+    final List data = new List(index.length >> 1);
+    for (int i = 0; i < _usedData; i++) {
+      data[i] = oldData[i];
+    }
+    _index = index;
+    _hashMask = _hashMask >> 1;
+    _data = data;
+    return true;
+  }
+
   void clear() {
     if (!isEmpty) {
       _init(_HashBase._INITIAL_INDEX_SIZE, _hashMask, null, 0);
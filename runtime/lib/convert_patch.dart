@@ -17,6 +17,12 @@ import "dart:typed_data" show Uint8List, Uint16List;
 
 @patch
 _parseJson(String source, reviver(key, value)) {
+  if (reviver == null) {
+    // The native parser only takes one-byte strings, and returns null for
+    // anything it does not parse, which is left to the Dart parser.
+    final result = _parseJsonNative(source);
+    if (result != null) return result;
+  }
   _BuildJsonListener listener;
   if (reviver == null) {
     listener = new _BuildJsonListener();
@@ -31,6 +37,9 @@ _parseJson(String source, reviver(key, value)) {
   return listener.result;
 }
 
+Object _parseJsonNative(String source)
+    native "JsonDecoder_parseOneByteString";
+
 @patch
 class Utf8Decoder {
   @patch
@@ -48,8 +57,16 @@ class Utf8Decoder {
   @patch
   static String _convertIntercepted(
       bool allowMalformed, List<int> codeUnits, int start, int end) {
+    if (codeUnits is Uint8List) {
+      end = RangeError.checkValidRange(start, end, codeUnits.length);
+      // Returns null for malformed input, which is left to the Dart decoder.
+      return _decodeUint8List(codeUnits, start, end);
+    }
     return null; // This call was not intercepted.
   }
+
+  static String _decodeUint8List(Uint8List codeUnits, int start, int end)
+      native "Utf8Decoder_decodeUint8List";
 }
 
 class _JsonUtf8Decoder extends Converter<List<int>, Object> {
@@ -1852,6 +1869,38 @@ class _JsonUtf8DecoderSink extends ByteConversionSinkBase {
   }
 }
 
+// Ranges of at least this many bytes are scanned by the VM a word at a time.
+const int _NATIVE_SCAN_THRESHOLD = 64;
+
+int _scanOneByteCharactersNative(Uint8List units, int from, int to)
+    native "Utf8Decoder_scanOneByteCharacters";
+
+// Base64 conversion of at least this many bytes or characters is done by
+// the VM.
+const int _BASE64_NATIVE_THRESHOLD = 32;
+
+String _encodeBase64Native(Uint8List bytes, bool urlSafe)
+    native "Base64Encoder_encodeUint8List";
+
+Uint8List _decodeBase64Native(String input, int start, int end)
+    native "Base64Decoder_decodeOneByteString";
+
+@patch
+String _encodeBase64Fast(List<int> bytes, bool urlSafe) {
+  if (bytes is Uint8List && bytes.length >= _BASE64_NATIVE_THRESHOLD) {
+    return _encodeBase64Native(bytes, urlSafe);
+  }
+  return null;
+}
+
+@patch
+Uint8List _decodeBase64Fast(String input, int start, int end) {
+  if (end - start >= _BASE64_NATIVE_THRESHOLD) {
+    return _decodeBase64Native(input, start, end);
+  }
+  return null;
+}
+
 @patch
 int _scanOneByteCharacters(List<int> units, int from, int endIndex) {
   final to = endIndex;
@@ -1859,6 +1908,10 @@ int _scanOneByteCharacters(List<int> units, int from, int endIndex) {
   // Special case for _Uint8ArrayView.
   if (units is Uint8List) {
     if (from >= 0 && to >= 0 && to <= units.length) {
+      if (to - from >= _NATIVE_SCAN_THRESHOLD) {
+        final count = _scanOneByteCharactersNative(units, from, to);
+        if (count >= 0) return count;
+      }
       for (int i = from; i < to; i++) {
         final unit = units[i];
         if ((unit & _ONE_BYTE_LIMIT) != unit) return i - from;
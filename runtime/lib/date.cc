@@ -2,18 +2,193 @@
 // for details. All rights reserved. Use of this source code is governed by a
 // BSD-style license that can be found in the LICENSE file.
 
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include "vm/bootstrap_natives.h"
 
+#include "platform/atomic.h"
 #include "vm/native_entry.h"
 #include "vm/object.h"
 #include "vm/os.h"
+#include "vm/os_thread.h"
 
 namespace dart {
 
 static int64_t kMaxAllowedSeconds = kMaxInt32;
 
+// Caches the offset and name of the local time zone over intervals of time in
+// which they do not change, so that most lookups are a binary search instead
+// of a call to localtime_r.
+//
+// Like V8's date cache, this assumes that the time zone never changes and
+// changes back within kProbeSeconds: two instants that close together with
+// the same offset and name have that offset and name in between. A miss
+// probes kProbeSeconds ahead and bisects for the transition if there is one.
+// The cache is dropped when the TZ environment variable changes.
+class TimeZoneCache : public AllStatic {
+ public:
+  static const intptr_t kMaxNameLength = 31;
+
+  static int GetOffset(int64_t seconds) { return Lookup(seconds).offset; }
+
+  // Copies the name, which is at most kMaxNameLength characters, to [name].
+  static void GetName(int64_t seconds, char* name) {
+    const Interval interval = Lookup(seconds);
+    strncpy(name, interval.name, kMaxNameLength + 1);
+  }
+
+ private:
+  static const intptr_t kMaxIntervals = 64;
+  static const int64_t kProbeSeconds = 19 * 24 * 60 * 60;
+
+  struct Interval {
+    int64_t start;
+    int64_t end;  // Inclusive.
+    int offset;
+    char name[kMaxNameLength + 1];
+  };
+
+  static Mutex* GetMutex();
+  static Interval Lookup(int64_t seconds);
+  static void CheckTimeZoneLocked();
+  static intptr_t AddLocked(int64_t seconds, intptr_t index);
+  static void RemoveLocked(intptr_t index);
+
+  static void Probe(int64_t seconds, Interval* interval) {
+    interval->offset = OS::GetTimeZoneOffsetInSeconds(seconds);
+    strncpy(interval->name, OS::GetTimeZoneName(seconds), kMaxNameLength);
+    interval->name[kMaxNameLength] = '\0';
+  }
+
+  static bool SameZone(const Interval& a, const Interval& b) {
+    return (a.offset == b.offset) && (strcmp(a.name, b.name) == 0);
+  }
+
+  static Mutex* mutex_;
+  static char* time_zone_;
+  static Interval intervals_[kMaxIntervals];
+  static intptr_t length_;
+};
+
+Mutex* TimeZoneCache::mutex_ = NULL;
+char* TimeZoneCache::time_zone_ = NULL;
+TimeZoneCache::Interval TimeZoneCache::intervals_[kMaxIntervals];
+intptr_t TimeZoneCache::length_ = 0;
+
+Mutex* TimeZoneCache::GetMutex() {
+  Mutex* mutex = AtomicOperations::LoadAcquire(&mutex_);
+  if (mutex != NULL) {
+    return mutex;
+  }
+  Mutex* created = new Mutex(NOT_IN_PRODUCT("TimeZoneCache::mutex_"));
+  mutex = AtomicOperations::CompareAndSwapPointer(
+      &mutex_, static_cast<Mutex*>(NULL), created);
+  if (mutex != NULL) {
+    delete created;
+    return mutex;
+  }
+  return created;
+}
+
+void TimeZoneCache::CheckTimeZoneLocked() {
+  const char* time_zone = getenv("TZ");
+  if ((time_zone == NULL) ? (time_zone_ == NULL)
+                          : ((time_zone_ != NULL) &&
+                             (strcmp(time_zone, time_zone_) == 0))) {
+    return;
+  }
+  free(time_zone_);
+  time_zone_ = (time_zone == NULL) ? NULL : strdup(time_zone);
+  length_ = 0;
+}
+
+TimeZoneCache::Interval TimeZoneCache::Lookup(int64_t seconds) {
+  MutexLocker ml(GetMutex());
+  CheckTimeZoneLocked();
+  // Find the first interval starting after [seconds].
+  intptr_t low = 0;
+  intptr_t high = length_;
+  while (low < high) {
+    const intptr_t mid = low + (high - low) / 2;
+    if (intervals_[mid].start <= seconds) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if ((low > 0) && (seconds <= intervals_[low - 1].end)) {
+    return intervals_[low - 1];
+  }
+  return intervals_[AddLocked(seconds, low)];
+}
+
+// Adds the interval around [seconds], which is not cached and belongs at
+// [index], and returns the index of the interval that contains it.
+intptr_t TimeZoneCache::AddLocked(int64_t seconds, intptr_t index) {
+  Interval interval;
+  interval.start = seconds;
+  interval.end = seconds;
+  Probe(seconds, &interval);
+
+  int64_t limit = Utils::Minimum(seconds + kProbeSeconds, kMaxAllowedSeconds);
+  if (index < length_) {
+    limit = Utils::Minimum(limit, intervals_[index].start - 1);
+  }
+  if (limit > seconds) {
+    Interval probe;
+    Probe(limit, &probe);
+    if (SameZone(interval, probe)) {
+      interval.end = limit;
+    } else {
+      // The zone is [interval]'s at |low| and something else at |high|.
+      int64_t low = seconds;
+      int64_t high = limit;
+      while (high - low > 1) {
+        const int64_t mid = low + (high - low) / 2;
+        Probe(mid, &probe);
+        if (SameZone(interval, probe)) {
+          low = mid;
+        } else {
+          high = mid;
+        }
+      }
+      interval.end = low;
+    }
+  }
+
+  if ((index > 0) && (seconds - intervals_[index - 1].end <= kProbeSeconds) &&
+      SameZone(intervals_[index - 1], interval)) {
+    // Close enough to the previous interval to extend it.
+    index--;
+    intervals_[index].end = interval.end;
+  } else {
+    if (length_ == kMaxIntervals) {
+      // Scattered lookups; start over rather than evict.
+      length_ = 0;
+      index = 0;
+    }
+    memmove(&intervals_[index + 1], &intervals_[index],
+            (length_ - index) * sizeof(Interval));
+    intervals_[index] = interval;
+    length_++;
+  }
+  if ((index + 1 < length_) &&
+      (intervals_[index + 1].start == intervals_[index].end + 1) &&
+      SameZone(intervals_[index], intervals_[index + 1])) {
+    intervals_[index].end = intervals_[index + 1].end;
+    RemoveLocked(index + 1);
+  }
+  return index;
+}
+
+void TimeZoneCache::RemoveLocked(intptr_t index) {
+  memmove(&intervals_[index], &intervals_[index + 1],
+          (length_ - index - 1) * sizeof(Interval));
+  length_--;
+}
+
 DEFINE_NATIVE_ENTRY(DateTime_timeZoneName, 0, 1) {
   GET_NON_NULL_NATIVE_ARGUMENT(Integer, dart_seconds,
                                arguments->NativeArgAt(0));
@@ -21,7 +196,8 @@ DEFINE_NATIVE_ENTRY(DateTime_timeZoneName, 0, 1) {
   if (llabs(seconds) > kMaxAllowedSeconds) {
     Exceptions::ThrowArgumentError(dart_seconds);
   }
-  const char* name = OS::GetTimeZoneName(seconds);
+  char name[TimeZoneCache::kMaxNameLength + 1];
+  TimeZoneCache::GetName(seconds, name);
   return String::New(name);
 }
 
@@ -32,7 +208,7 @@ DEFINE_NATIVE_ENTRY(DateTime_timeZoneOffsetInSeconds, 0, 1) {
   if (llabs(seconds) > kMaxAllowedSeconds) {
     Exceptions::ThrowArgumentError(dart_seconds);
   }
-  int offset = OS::GetTimeZoneOffsetInSeconds(seconds);
+  int offset = TimeZoneCache::GetOffset(seconds);
   return Integer::New(offset);
 }
 
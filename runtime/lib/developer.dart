@@ -13,6 +13,8 @@ import "dart:async" show Future, Zone;
 
 import "dart:isolate" show SendPort;
 
+import "dart:typed_data" show Int64List;
+
 /// These are the additional parts of this patch library:
 // part "profiler.dart"
 // part "timeline.dart"
@@ -12,6 +12,7 @@
 #include "vm/compiler/ffi.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/exceptions.h"
+#include "vm/ffi_callback_queue.h"
 #include "vm/log.h"
 #include "vm/native_arguments.h"
 #include "vm/native_entry.h"
@@ -86,7 +87,8 @@ static bool IsNativeFunction(const AbstractType& type_arg) {
 static void CheckSized(const AbstractType& type_arg) {
   classid_t type_cid = type_arg.type_class_id();
   if (RawObject::IsFfiTypeVoidClassId(type_cid) ||
-      RawObject::IsFfiTypeNativeFunctionClassId(type_cid)) {
+      RawObject::IsFfiTypeNativeFunctionClassId(type_cid) ||
+      RawObject::IsFfiTypeByValueClassId(type_cid)) {
     const String& error = String::Handle(String::NewFormatted(
         "%s does not have a predefined size (@unsized). "
         "Unsized NativeTypes do not support [sizeOf] because their size "
@@ -115,6 +117,7 @@ static void CheckSized(const AbstractType& type_arg) {
 // [Float]                              -> [double]
 // [Pointer]<T>                         -> [Pointer]<T>
 // T extends [Pointer]                  -> T
+// [ByValue]<T>                         -> T
 // [NativeFunction]<T1 Function(T2, T3) -> S1 Function(S2, S3)
 //    where DartRepresentationOf(Tn) -> Sn
 static bool DartAndCTypeCorrespond(const AbstractType& native_type,
@@ -131,6 +134,11 @@ static bool DartAndCTypeCorrespond(const AbstractType& native_type,
   if (RawObject::IsFfiPointerClassId(native_type_cid)) {
     return native_type.Equals(dart_type) || dart_type.IsNullType();
   }
+  if (RawObject::IsFfiTypeByValueClassId(native_type_cid)) {
+    const AbstractType& struct_type = AbstractType::Handle(
+        TypeArguments::Handle(native_type.arguments()).TypeAt(0));
+    return struct_type.Equals(dart_type) || dart_type.IsNullType();
+  }
   if (RawObject::IsFfiTypeNativeFunctionClassId(native_type_cid)) {
     if (!dart_type.IsFunctionType()) {
       return false;
@@ -479,7 +487,8 @@ DEFINE_NATIVE_ENTRY(Ffi_sizeOf, 1, 0) {
 // TODO(dacoharkes): Cache the trampolines.
 // We can possibly address simultaniously with 'precaching' in AOT.
 static RawFunction* TrampolineFunction(const Function& dart_signature,
-                                       const Function& c_signature) {
+                                       const Function& c_signature,
+                                       bool is_leaf) {
   Thread* thread = Thread::Current();
   Zone* zone = thread->zone();
   String& name =
@@ -513,12 +522,40 @@ static RawFunction* TrampolineFunction(const Function& dart_signature,
   }
   function.set_parameter_names(parameter_names);
   function.SetFfiCSignature(c_signature);
+  function.SetFfiIsLeaf(is_leaf);
 
   return function.raw();
 }
 
-DEFINE_NATIVE_ENTRY(Ffi_asFunction, 1, 1) {
+// Throws if [c_signature] passes or returns structs by value which are not
+// supported.
+static void CheckStructsByValue(const Function& c_signature) {
+  AbstractType& type = AbstractType::Handle(c_signature.result_type());
+  for (intptr_t i = 0; i < c_signature.num_fixed_parameters(); i++) {
+    if (i > 0) {
+      type = c_signature.ParameterTypeAt(i);
+    }
+    if (!RawObject::IsFfiTypeByValueClassId(type.type_class_id())) {
+      continue;
+    }
+    if (!compiler::ffi::kSupportsStructsByValue) {
+      Exceptions::ThrowUnsupportedError(
+          "Passing structs by value is not supported on this platform.");
+    }
+#if !defined(DART_PRECOMPILED_RUNTIME)
+    const AbstractType& struct_type =
+        AbstractType::Handle(TypeArguments::Handle(type.arguments()).TypeAt(0));
+    if (compiler::ffi::StructLayout::FromType(Thread::Current()->zone(),
+                                              struct_type) == nullptr) {
+      ThrowTypeArgumentError(struct_type, "struct");
+    }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+  }
+}
+
+DEFINE_NATIVE_ENTRY(Ffi_asFunction, 1, 2) {
   GET_NON_NULL_NATIVE_ARGUMENT(Pointer, pointer, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Bool, is_leaf, arguments->NativeArgAt(1));
   AbstractType& pointer_type_arg =
       AbstractType::Handle(pointer.type_argument());
   ASSERT(IsNativeFunction(pointer_type_arg));
@@ -532,8 +569,10 @@ DEFINE_NATIVE_ENTRY(Ffi_asFunction, 1, 1) {
       AbstractType::Handle(nativefunction_type_args.TypeAt(0));
   Function& c_signature =
       Function::Handle(Type::Cast(nativefunction_type_arg).signature());
+  CheckStructsByValue(c_signature);
   Function& function =
-      Function::Handle(TrampolineFunction(dart_signature, c_signature));
+      Function::Handle(TrampolineFunction(dart_signature, c_signature,
+                                          is_leaf.value()));
 
   // Set the c function pointer in the context of the closure rather than in
   // the function so that we can reuse the function for each c function with
@@ -635,6 +674,17 @@ DEFINE_NATIVE_ENTRY(Ffi_fromFunction, 1, 1) {
   func = func.parent_function();
   ASSERT(func.is_static());
 
+  AbstractType& type = AbstractType::Handle(native_signature.result_type());
+  for (intptr_t i = 0; i < native_signature.num_fixed_parameters(); i++) {
+    if (i > 0) {
+      type = native_signature.ParameterTypeAt(i);
+    }
+    if (RawObject::IsFfiTypeByValueClassId(type.type_class_id())) {
+      Exceptions::ThrowUnsupportedError(
+          "FFI callbacks cannot pass structs by value.");
+    }
+  }
+
   const uword address = CompileNativeCallback(native_signature, func);
 
   const Pointer& result = Pointer::Handle(Pointer::New(
@@ -643,6 +693,37 @@ DEFINE_NATIVE_ENTRY(Ffi_fromFunction, 1, 1) {
   return result.raw();
 }
 
+static FfiCallbackQueue* AsyncCallbackQueueAt(const Integer& address) {
+  return reinterpret_cast<FfiCallbackQueue*>(address.AsInt64Value());
+}
+
+DEFINE_NATIVE_ENTRY(Ffi_newAsyncCallbackQueue, 0, 2) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, record_size, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(SendPort, port, arguments->NativeArgAt(1));
+  CheckRange(record_size, 1, kMaxInt32, "recordSize");
+
+  FfiCallbackQueue* queue =
+      new FfiCallbackQueue(record_size.AsInt64Value(), port.Id());
+  return Integer::New(reinterpret_cast<intptr_t>(queue));
+}
+
+DEFINE_NATIVE_ENTRY(Ffi_drainAsyncCallbackQueue, 0, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, address, arguments->NativeArgAt(0));
+  return Smi::New(AsyncCallbackQueueAt(address)->Drain());
+}
+
+DEFINE_NATIVE_ENTRY(Ffi_asyncCallbackQueueBatch, 0, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, address, arguments->NativeArgAt(0));
+  return Integer::New(
+      reinterpret_cast<intptr_t>(AsyncCallbackQueueAt(address)->batch()));
+}
+
+DEFINE_NATIVE_ENTRY(Ffi_deleteAsyncCallbackQueue, 0, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, address, arguments->NativeArgAt(0));
+  delete AsyncCallbackQueueAt(address);
+  return Object::null();
+}
+
 #if defined(TARGET_ARCH_DBC)
 
 void FfiMarshalledArguments::SetFunctionAddress(uint64_t value) const {
@@ -3,6 +3,7 @@
 // BSD-style license that can be found in the LICENSE file.
 
 import "dart:_internal" show patch;
+import "dart:isolate" show RawReceivePort, SendPort;
 
 @patch
 Pointer<T> allocate<T extends NativeType>({int count: 1}) native "Ffi_allocate";
@@ -17,6 +18,56 @@ int sizeOf<T extends NativeType>() native "Ffi_sizeOf";
 Pointer<NativeFunction<T>> fromFunction<T extends Function>(
     @DartRepresentationOf("T") Function f) native "Ffi_fromFunction";
 
+@patch
+class AsyncCallbackQueue {
+  @patch
+  factory AsyncCallbackQueue(int recordSize,
+          void callback(Pointer<Uint8> records, int count)) =>
+      new _AsyncCallbackQueue(recordSize, callback);
+}
+
+class _AsyncCallbackQueue implements AsyncCallbackQueue {
+  final RawReceivePort _port = new RawReceivePort();
+  final void Function(Pointer<Uint8>, int) _callback;
+
+  // The address of the native queue, or 0 once it is closed.
+  int _queue;
+
+  _AsyncCallbackQueue(int recordSize, this._callback) {
+    try {
+      _queue = _new(recordSize, _port.sendPort);
+    } catch (e) {
+      _port.close();
+      rethrow;
+    }
+    _port.handler = _handleWakeUp;
+  }
+
+  Pointer<Void> get handle => fromAddress<Pointer<Void>>(_queue);
+
+  // Native code only messages the port when it posts to an empty queue, so
+  // each message stands for all the records posted since the last drain.
+  void _handleWakeUp(_) {
+    if (_queue == 0) return;
+    final int count = _drain(_queue);
+    if (count == 0) return;
+    _callback(fromAddress<Pointer<Uint8>>(_batch(_queue)), count);
+  }
+
+  void close() {
+    if (_queue == 0) return;
+    _port.close();
+    _delete(_queue);
+    _queue = 0;
+  }
+
+  static int _new(int recordSize, SendPort port)
+      native "Ffi_newAsyncCallbackQueue";
+  static int _drain(int queue) native "Ffi_drainAsyncCallbackQueue";
+  static int _batch(int queue) native "Ffi_asyncCallbackQueueBatch";
+  static void _delete(int queue) native "Ffi_deleteAsyncCallbackQueue";
+}
+
 @patch
 @pragma("vm:entry-point")
 class Pointer<T extends NativeType> {
@@ -48,12 +99,18 @@ class Pointer<T extends NativeType> {
   U cast<U extends Pointer>() native "Ffi_cast";
 
   @patch
-  R asFunction<R extends Function>() native "Ffi_asFunction";
+  R asFunction<R extends Function>({bool isLeaf: false})
+      native "Ffi_asFunction";
 
   @patch
   void free() native "Ffi_free";
 }
 
+// Allocates the C memory for a struct returned by value from an FFI call and
+// returns its address. Called from the FFI trampolines.
+@pragma("vm:entry-point")
+int _allocateStructResult(int size) => allocate<Uint8>(count: size).address;
+
 // This method gets called when an exception bubbles up to the native -> Dart
 // boundary from an FFI native callback. Since native code does not have any
 // concept of exceptions, the exception cannot be propagated any further.
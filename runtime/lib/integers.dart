@@ -584,14 +584,19 @@ class _Smi extends _IntegerImplementation {
   String toString() {
     if (this < 100 && this > -100) return _smallLookupTable[this + 99];
     if (this < 0) return _negativeToString(this);
+    return _positiveToString(this);
+  }
+
+  // Convert a positive integer >= 100 to a string.
+  static String _positiveToString(int value) {
     // Inspired by Andrei Alexandrescu: "Three Optimization Tips for C++"
     // Avoid expensive remainder operation by doing it on more than
     // one digit at a time.
     const int DIGIT_ZERO = 0x30;
-    int length = _positiveBase10Length(this);
+    int length = _positiveBase10Length(value);
     _OneByteString result = _OneByteString._allocate(length);
     int index = length - 1;
-    var smi = this;
+    var smi = value;
     do {
       // Two digits at a time.
       var twoDigits = smi.remainder(100);
@@ -694,4 +699,10 @@ class _Mint extends _IntegerImplementation {
   int get bitLength native "Mint_bitLength";
 
   int _bitAndFromSmi(_Smi other) => _bitAndFromInteger(other);
+
+  // A mint is never between -100 and 100, and the digits are formatted like
+  // those of a smi rather than by the runtime.
+  String toString() => (this < 0)
+      ? _Smi._negativeToString(this)
+      : _Smi._positiveToString(this);
 }
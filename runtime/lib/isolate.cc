@@ -166,25 +166,33 @@ class SpawnIsolateTask : public ThreadPool::Task {
         return;
       }
 
-      isolate = CreateIsolateFromExistingSource(source, name, &error);
-      parent_isolate_->DecrementSpawnCount();
-      parent_isolate_ = nullptr;
-      if (isolate == nullptr) {
-        FailedSpawn(error);
-        free(error);
-        return;
+      // Prefer an isolate that was created and initialized ahead of time.
+      isolate = source->spawn_pool.Take();
+      if (isolate != nullptr) {
+        isolate->set_name(name);
+        parent_isolate_->DecrementSpawnCount();
+        parent_isolate_ = nullptr;
+      } else {
+        isolate = CreateIsolateFromExistingSource(source, name, &error);
+        parent_isolate_->DecrementSpawnCount();
+        parent_isolate_ = nullptr;
+        if (isolate == nullptr) {
+          FailedSpawn(error);
+          free(error);
+          return;
+        }
+
+        void* child_isolate_data = nullptr;
+        bool success = initialize_callback(&child_isolate_data, &error);
+        isolate->set_init_callback_data(child_isolate_data);
+        if (!success) {
+          Dart_ShutdownIsolate();
+          FailedSpawn(error);
+          free(error);
+          return;
+        }
+        Dart_ExitIsolate();
       }
-
-      void* child_isolate_data = nullptr;
-      bool success = initialize_callback(&child_isolate_data, &error);
-      isolate->set_init_callback_data(child_isolate_data);
-      if (!success) {
-        Dart_ShutdownIsolate();
-        FailedSpawn(error);
-        free(error);
-        return;
-      }
-      Dart_ExitIsolate();
     }
 
     if (isolate == nullptr) {
@@ -561,15 +569,20 @@ DEFINE_NATIVE_ENTRY(TransferableTypedData_materialize, 0, 1) {
 
   TransferableTypedDataPeer* tpeer =
       reinterpret_cast<TransferableTypedDataPeer*>(peer);
-  const intptr_t length = tpeer->length();
-  uint8_t* data = tpeer->data();
-  if (data == nullptr) {
+  if (!tpeer->HasData()) {
     const auto& error = String::Handle(String::New(
         "Attempt to materialize object that was transferred already."));
     Exceptions::ThrowArgumentError(error);
     UNREACHABLE();
   }
-  tpeer->ClearData();
+  const intptr_t length = tpeer->length();
+  uint8_t* data;
+  if (!tpeer->TakeContiguousData(&data)) {
+    const Instance& exception =
+        Instance::Handle(thread->isolate()->object_store()->out_of_memory());
+    Exceptions::Throw(thread, exception);
+    UNREACHABLE();
+  }
 
   const ExternalTypedData& typed_data = ExternalTypedData::Handle(
       ExternalTypedData::New(kExternalTypedDataUint8ArrayCid, data, length,
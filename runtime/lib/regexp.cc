@@ -45,7 +45,11 @@ DEFINE_NATIVE_ENTRY(RegExp_factory, 0, 6) {
   RegExpParser::ParseRegExp(pattern, flags, &compileData);
 
   // Create a RegExp object containing only the initial parameters.
-  return RegExpEngine::CreateRegExp(thread, pattern, flags);
+  const RegExp& regexp =
+      RegExp::Handle(RegExpEngine::CreateRegExp(thread, pattern, flags));
+  regexp.set_literal_prefix(
+      String::Handle(RegExpEngine::LiteralPrefix(&compileData, flags)));
+  return regexp.raw();
 }
 
 DEFINE_NATIVE_ENTRY(RegExp_getPattern, 0, 1) {
@@ -118,13 +122,26 @@ static RawObject* ExecuteMatch(Zone* zone,
   GET_NON_NULL_NATIVE_ARGUMENT(String, subject, arguments->NativeArgAt(1));
   GET_NON_NULL_NATIVE_ARGUMENT(Smi, start_index, arguments->NativeArgAt(2));
 
+  // Every match starts with the literal prefix, so the matcher can start at
+  // the first occurrence of the prefix instead of trying every position.
+  Smi& match_start = Smi::Handle(zone, start_index.raw());
+  if (!sticky && regexp.literal_prefix() != String::null()) {
+    const String& prefix = String::Handle(zone, regexp.literal_prefix());
+    const intptr_t candidate = RegExpEngine::FindLiteralPrefix(
+        subject, prefix, start_index.Value());
+    if (candidate < 0) {
+      return Object::null();
+    }
+    match_start = Smi::New(candidate);
+  }
+
 #if !defined(DART_PRECOMPILED_RUNTIME)
   if (!FLAG_interpret_irregexp) {
-    return IRRegExpMacroAssembler::Execute(regexp, subject, start_index,
+    return IRRegExpMacroAssembler::Execute(regexp, subject, match_start,
                                            /*sticky=*/sticky, zone);
   }
 #endif
-  return BytecodeRegExpMacroAssembler::Interpret(regexp, subject, start_index,
+  return BytecodeRegExpMacroAssembler::Interpret(regexp, subject, match_start,
                                                  /*sticky=*/sticky, zone);
 }
 
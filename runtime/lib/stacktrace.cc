@@ -16,28 +16,52 @@ namespace dart {
 
 DECLARE_FLAG(bool, show_invisible_frames);
 
-static RawStackTrace* CurrentSyncStackTrace(Thread* thread,
-                                            intptr_t skip_frames = 1) {
-  Zone* zone = thread->zone();
-  const Function& null_function = Function::ZoneHandle(zone);
-
-  // Determine how big the stack trace is.
-  const intptr_t stack_trace_length =
-      StackTraceUtils::CountFrames(thread, skip_frames, null_function);
-
-  // Allocate once.
-  const Array& code_array =
-      Array::ZoneHandle(zone, Array::New(stack_trace_length));
-  const Array& pc_offset_array =
-      Array::ZoneHandle(zone, Array::New(stack_trace_length));
-
-  // Collect the frames.
-  const intptr_t collected_frames_count = StackTraceUtils::CollectFrames(
-      thread, code_array, pc_offset_array, 0, stack_trace_length, skip_frames);
-
-  ASSERT(collected_frames_count == stack_trace_length);
+DEFINE_FLAG(int,
+            max_stack_trace_depth,
+            0,
+            "Maximum number of frames captured by StackTrace.current and for "
+            "thrown exceptions (0 means no limit). Asynchronous frames are not "
+            "linked to a truncated trace.");
+
+// Creates a StackTrace object from the frames collected in one stack walk,
+// with |extra_frames| slots left null at the start.
+static RawStackTrace* NewStackTrace(
+    Zone* zone,
+    const GrowableArray<const Object*>& code_list,
+    const GrowableArray<intptr_t>& pc_offset_list,
+    intptr_t extra_frames,
+    const StackTrace& async_link) {
+  const intptr_t length = extra_frames + code_list.length();
+  const Array& code_array = Array::Handle(zone, Array::New(length));
+  const Array& pc_offset_array = Array::Handle(zone, Array::New(length));
+  Smi& offset = Smi::Handle(zone);
+  for (intptr_t i = 0; i < code_list.length(); i++) {
+    code_array.SetAt(extra_frames + i, *code_list[i]);
+    offset = Smi::New(pc_offset_list[i]);
+    pc_offset_array.SetAt(extra_frames + i, offset);
+  }
+  return StackTrace::New(code_array, pc_offset_array, async_link);
+}
 
-  return StackTrace::New(code_array, pc_offset_array);
+// Whether |stack_trace| is the trace of an async function which would be
+// created from the given frames and link.
+static bool IsSameAsyncFunctionStackTrace(
+    const StackTrace& stack_trace,
+    const GrowableArray<const Object*>& code_list,
+    const GrowableArray<intptr_t>& pc_offset_list,
+    const StackTrace& async_link) {
+  if (stack_trace.IsNull() || (stack_trace.async_link() != async_link.raw()) ||
+      (stack_trace.Length() != code_list.length() + 1)) {
+    return false;
+  }
+  for (intptr_t i = 0; i < code_list.length(); i++) {
+    if ((stack_trace.CodeAtFrame(i + 1) != code_list[i]->raw()) ||
+        (Smi::Value(stack_trace.PcOffsetAtFrame(i + 1)) !=
+         pc_offset_list[i])) {
+      return false;
+    }
+  }
+  return true;
 }
 
 static RawStackTrace* CurrentStackTrace(
@@ -45,56 +69,55 @@ static RawStackTrace* CurrentStackTrace(
     bool for_async_function,
     intptr_t skip_frames = 1,
     bool causal_async_stacks = FLAG_causal_async_stacks) {
-  if (!causal_async_stacks) {
-    // Return the synchronous stack trace.
-    return CurrentSyncStackTrace(thread, skip_frames);
-  }
-
   Zone* zone = thread->zone();
-  Code& code = Code::ZoneHandle(zone);
-  Smi& offset = Smi::ZoneHandle(zone);
-  Function& async_function = Function::ZoneHandle(zone);
-  StackTrace& async_stack_trace = StackTrace::ZoneHandle(zone);
-  Array& async_code_array = Array::ZoneHandle(zone);
-  Array& async_pc_offset_array = Array::ZoneHandle(zone);
-
-  StackTraceUtils::ExtractAsyncStackTraceInfo(
-      thread, &async_function, &async_stack_trace, &async_code_array,
-      &async_pc_offset_array);
-
-  // Determine the size of the stack trace.
-  const intptr_t extra_frames = for_async_function ? 1 : 0;
-  const intptr_t synchronous_stack_trace_length =
-      StackTraceUtils::CountFrames(thread, skip_frames, async_function);
+  Function& async_function = Function::Handle(zone);
+  StackTrace& async_stack_trace = StackTrace::Handle(zone);
+  if (causal_async_stacks) {
+    Array& async_code_array = Array::Handle(zone);
+    Array& async_pc_offset_array = Array::Handle(zone);
+    StackTraceUtils::ExtractAsyncStackTraceInfo(
+        thread, &async_function, &async_stack_trace, &async_code_array,
+        &async_pc_offset_array);
+  }
 
-  const intptr_t capacity = synchronous_stack_trace_length +
-                            extra_frames;  // For the asynchronous gap.
+  // The trace of an async function stops at its own frame, so it is never
+  // truncated.
+  const intptr_t max_frames =
+      for_async_function ? 0 : FLAG_max_stack_trace_depth;
+  GrowableArray<const Object*> code_list;
+  GrowableArray<intptr_t> pc_offset_list;
+  const bool complete =
+      StackTraceUtils::CollectFrames(thread, skip_frames, async_function,
+                                     max_frames, &code_list, &pc_offset_list);
+  if (!complete) {
+    async_stack_trace = StackTrace::null();
+  }
 
-  // Allocate memory for the stack trace.
-  const Array& code_array = Array::ZoneHandle(zone, Array::New(capacity));
-  const Array& pc_offset_array = Array::ZoneHandle(zone, Array::New(capacity));
+  // An async function called repeatedly from the same place, e.g. awaited in
+  // a loop, reuses the trace of its previous call instead of allocating one.
+  ObjectStore* object_store = thread->isolate()->object_store();
+  if (for_async_function) {
+    const StackTrace& last_stack_trace = StackTrace::Handle(
+        zone, object_store->last_async_function_stack_trace());
+    if (IsSameAsyncFunctionStackTrace(last_stack_trace, code_list,
+                                      pc_offset_list, async_stack_trace)) {
+      return last_stack_trace.raw();
+    }
+  }
 
-  intptr_t write_cursor = 0;
+  // Leave room for the asynchronous gap marker at the top of the trace.
+  const intptr_t extra_frames = for_async_function ? 1 : 0;
+  const StackTrace& stack_trace = StackTrace::Handle(
+      zone, NewStackTrace(zone, code_list, pc_offset_list, extra_frames,
+                          async_stack_trace));
   if (for_async_function) {
-    // Place the asynchronous gap marker at the top of the stack trace.
-    code = StubCode::AsynchronousGapMarker().raw();
+    const Code& code = StubCode::AsynchronousGapMarker();
     ASSERT(!code.IsNull());
-    offset = Smi::New(0);
-    code_array.SetAt(write_cursor, code);
-    pc_offset_array.SetAt(write_cursor, offset);
-    write_cursor++;
+    stack_trace.SetCodeAtFrame(0, code);
+    stack_trace.SetPcOffsetAtFrame(0, Smi::Handle(zone, Smi::New(0)));
+    object_store->set_last_async_function_stack_trace(stack_trace);
   }
-
-  // Append the synchronous stack trace.
-  const intptr_t collected_frames_count = StackTraceUtils::CollectFrames(
-      thread, code_array, pc_offset_array, write_cursor,
-      synchronous_stack_trace_length, skip_frames);
-
-  write_cursor += collected_frames_count;
-
-  ASSERT(write_cursor == capacity);
-
-  return StackTrace::New(code_array, pc_offset_array, async_stack_trace);
+  return stack_trace.raw();
 }
 
 RawStackTrace* GetStackTraceForException() {
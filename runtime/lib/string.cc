@@ -7,8 +7,11 @@
 #include "include/dart_api.h"
 #include "platform/unicode.h"
 #include "vm/dart_api_impl.h"
+#include "vm/dart_entry.h"
+#include "vm/double_conversion.h"
 #include "vm/exceptions.h"
 #include "vm/isolate.h"
+#include "vm/json_parser.h"
 #include "vm/native_entry.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
@@ -264,21 +267,20 @@ DEFINE_NATIVE_ENTRY(OneByteString_splitWithCharCode, 0, 2) {
   ASSERT(receiver.IsOneByteString());
   GET_NON_NULL_NATIVE_ARGUMENT(Smi, smi_split_code, arguments->NativeArgAt(1));
   const intptr_t len = receiver.Length();
-  const intptr_t split_code = smi_split_code.Value();
+  const uint16_t split_code = static_cast<uint16_t>(smi_split_code.Value());
   const GrowableObjectArray& result = GrowableObjectArray::Handle(
       zone, GrowableObjectArray::New(16, Heap::kNew));
   String& str = String::Handle(zone);
   intptr_t start = 0;
-  intptr_t i = 0;
-  for (; i < len; i++) {
-    if (split_code == OneByteString::CharAt(receiver, i)) {
-      str = OneByteString::SubStringUnchecked(receiver, start, (i - start),
-                                              Heap::kNew);
-      result.Add(str);
-      start = i + 1;
-    }
+  intptr_t i = String::IndexOf(receiver, split_code, start);
+  while (i >= 0) {
+    str = OneByteString::SubStringUnchecked(receiver, start, (i - start),
+                                            Heap::kNew);
+    result.Add(str);
+    start = i + 1;
+    i = String::IndexOf(receiver, split_code, start);
   }
-  str = OneByteString::SubStringUnchecked(receiver, start, (i - start),
+  str = OneByteString::SubStringUnchecked(receiver, start, (len - start),
                                           Heap::kNew);
   result.Add(str);
   result.SetTypeArguments(TypeArguments::Handle(
@@ -524,6 +526,15 @@ DEFINE_NATIVE_ENTRY(String_concat, 0, 2) {
   return String::Concat(receiver, b);
 }
 
+DEFINE_NATIVE_ENTRY(String_indexOf, 0, 3) {
+  const String& receiver =
+      String::CheckedHandle(zone, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(String, pattern, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, start, arguments->NativeArgAt(2));
+  ASSERT((start.Value() >= 0) && (start.Value() <= receiver.Length()));
+  return Smi::New(String::IndexOf(receiver, pattern, start.Value()));
+}
+
 DEFINE_NATIVE_ENTRY(String_toLowerCase, 0, 1) {
   const String& receiver =
       String::CheckedHandle(zone, arguments->NativeArgAt(0));
@@ -573,6 +584,85 @@ DEFINE_NATIVE_ENTRY(String_concatRange, 0, 3) {
   return String::ConcatAllRange(strings, start_ix, end_ix, Heap::kNew);
 }
 
+// Formats a part of an interpolation which is not a string the way its
+// toString does, or returns nullptr if that needs a call to Dart code.
+static const char* FormatInterpolationPart(const Instance& part) {
+  if (part.IsNull()) {
+    return "null";
+  }
+  if (part.IsBool()) {
+    return Bool::Cast(part).value() ? "true" : "false";
+  }
+  if (part.IsInteger() || part.IsDouble()) {
+    return part.ToCString();
+  }
+  return nullptr;
+}
+
+DEFINE_NATIVE_ENTRY(String_interpolateKnownParts, 0, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Array, parts, arguments->NativeArgAt(0));
+  const intptr_t num_parts = parts.Length();
+  // The formatted parts, or nullptr for the parts which are strings.
+  const char** formatted = zone->Alloc<const char*>(num_parts);
+  intptr_t* lengths = zone->Alloc<intptr_t>(num_parts);
+  Instance& part = Instance::Handle(zone);
+  intptr_t result_length = 0;
+  intptr_t char_size = String::kOneByteChar;
+  for (intptr_t i = 0; i < num_parts; i++) {
+    part ^= parts.At(i);
+    formatted[i] = nullptr;
+    if (!part.IsString()) {
+      formatted[i] = FormatInterpolationPart(part);
+      if (formatted[i] == nullptr) {
+        // The compiler only uses this for parts of the types above, but
+        // fall back to toString rather than produce a wrong result.
+        const Object& result =
+            Object::Handle(zone, DartLibraryCalls::ToString(part));
+        if (result.IsError()) {
+          Exceptions::PropagateError(Error::Cast(result));
+        }
+        if (!result.IsString()) {
+          Exceptions::ThrowArgumentError(Instance::Cast(result));
+        }
+        part ^= result.raw();
+        parts.SetAt(i, part);
+      }
+    }
+    if (formatted[i] != nullptr) {
+      lengths[i] = strlen(formatted[i]);
+    } else {
+      const String& str = String::Cast(part);
+      lengths[i] = str.Length();
+      char_size = Utils::Maximum(char_size, str.CharSize());
+    }
+    if ((String::kMaxElements - result_length) < lengths[i]) {
+      Exceptions::ThrowOOM();
+    }
+    result_length += lengths[i];
+  }
+  if (result_length == 0) {
+    return Symbols::Empty().raw();
+  }
+
+  const String& result =
+      (char_size == String::kOneByteChar)
+          ? String::Handle(zone, OneByteString::New(result_length, Heap::kNew))
+          : String::Handle(zone, TwoByteString::New(result_length, Heap::kNew));
+  String& str = String::Handle(zone);
+  intptr_t position = 0;
+  for (intptr_t i = 0; i < num_parts; i++) {
+    if (formatted[i] != nullptr) {
+      String::Copy(result, position,
+                   reinterpret_cast<const uint8_t*>(formatted[i]), lengths[i]);
+    } else {
+      str ^= parts.At(i);
+      String::Copy(result, position, str, 0, lengths[i]);
+    }
+    position += lengths[i];
+  }
+  return result.raw();
+}
+
 DEFINE_NATIVE_ENTRY(StringBuffer_createStringFromUint16Array, 0, 3) {
   GET_NON_NULL_NATIVE_ARGUMENT(TypedData, codeUnits, arguments->NativeArgAt(0));
   GET_NON_NULL_NATIVE_ARGUMENT(Smi, length, arguments->NativeArgAt(1));
@@ -593,4 +683,140 @@ DEFINE_NATIVE_ENTRY(StringBuffer_createStringFromUint16Array, 0, 3) {
   return result.raw();
 }
 
+DEFINE_NATIVE_ENTRY(StringBuffer_writeDouble, 0, 3) {
+  GET_NON_NULL_NATIVE_ARGUMENT(TypedData, codeUnits, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, position, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Double, value, arguments->NativeArgAt(2));
+  const int kBufferSize = 128;
+  char buffer[kBufferSize];
+  DoubleToCString(value.value(), buffer, kBufferSize);
+  const intptr_t length = strlen(buffer);
+  const intptr_t start = position.Value();
+  const intptr_t array_length = codeUnits.Length();
+  if ((start < 0) || (start > array_length - length)) {
+    Exceptions::ThrowRangeError("position", position, 0,
+                                array_length - length);
+  }
+  NoSafepointScope no_safepoint;
+  uint16_t* data = reinterpret_cast<uint16_t*>(codeUnits.DataAddr(0)) + start;
+  for (intptr_t i = 0; i < length; i++) {
+    data[i] = buffer[i];
+  }
+  return Smi::New(start + length);
+}
+
+static bool IsUint8ListClassId(intptr_t cid) {
+  return (cid == kTypedDataUint8ArrayCid) ||
+         (cid == kExternalTypedDataUint8ArrayCid) ||
+         (cid == kTypedDataUint8ArrayViewCid);
+}
+
+// Returns the range [start, end) of a Uint8List argument as bytes, or false
+// if the argument is not a Uint8List or the range is out of bounds. The
+// address is only valid until the next allocation.
+static bool GetUint8ListRange(const Instance& list,
+                              intptr_t start,
+                              intptr_t end,
+                              const uint8_t** bytes) {
+  if (!IsUint8ListClassId(list.GetClassId())) {
+    return false;
+  }
+  const TypedDataBase& typed_data = TypedDataBase::Cast(list);
+  if ((start < 0) || (start > end) || (end > typed_data.Length())) {
+    return false;
+  }
+  *bytes = reinterpret_cast<const uint8_t*>(typed_data.DataAddr(0)) + start;
+  return true;
+}
+
+// Decodes well-formed UTF-8 from a Uint8List without a per-byte Dart loop.
+// Returns null for anything else, including malformed input, so that the
+// Dart decoder reports the error or substitutes replacement characters.
+DEFINE_NATIVE_ENTRY(Utf8Decoder_decodeUint8List, 0, 3) {
+  const Instance& list =
+      Instance::CheckedHandle(zone, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, start_obj, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, end_obj, arguments->NativeArgAt(2));
+  intptr_t start = start_obj.Value();
+  const intptr_t end = end_obj.Value();
+  {
+    NoSafepointScope no_safepoint;
+    const uint8_t* bytes;
+    if (!GetUint8ListRange(list, start, end, &bytes)) {
+      return Object::null();
+    }
+    // A leading byte order mark is dropped, like the Dart decoder does.
+    if (((end - start) >= 3) && (bytes[0] == 0xEF) && (bytes[1] == 0xBB) &&
+        (bytes[2] == 0xBF)) {
+      bytes += 3;
+      start += 3;
+    }
+    if (!Utf8::IsValid(bytes, end - start)) {
+      return Object::null();
+    }
+  }
+  return String::FromUTF8(TypedDataBase::Cast(list), start, end);
+}
+
+// Returns the number of ASCII bytes at the start of the range, or -1 if the
+// arguments do not describe a range of a Uint8List.
+DEFINE_NATIVE_ENTRY(Utf8Decoder_scanOneByteCharacters, 0, 3) {
+  const Instance& list =
+      Instance::CheckedHandle(zone, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, start, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, end, arguments->NativeArgAt(2));
+  NoSafepointScope no_safepoint;
+  const uint8_t* bytes;
+  if (!GetUint8ListRange(list, start.Value(), end.Value(), &bytes)) {
+    return Smi::New(-1);
+  }
+  return Smi::New(Utf8::AsciiPrefixLength(bytes, end.Value() - start.Value()));
+}
+
+// Returns the padded base64 encoding of a Uint8List, or null if the argument
+// is not one.
+DEFINE_NATIVE_ENTRY(Base64Encoder_encodeUint8List, 0, 2) {
+  const Instance& list =
+      Instance::CheckedHandle(zone, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Bool, url_safe, arguments->NativeArgAt(1));
+  if (!IsUint8ListClassId(list.GetClassId())) {
+    return Object::null();
+  }
+  const TypedDataBase& data = TypedDataBase::Cast(list);
+  return String::EncodeBase64(data, 0, data.Length(), url_safe.value());
+}
+
+// Decodes padded base64 from a one-byte string. Returns null for anything
+// else, including malformed input, so that the Dart decoder reports the error
+// or handles percent-escaped padding.
+DEFINE_NATIVE_ENTRY(Base64Decoder_decodeOneByteString, 0, 3) {
+  GET_NON_NULL_NATIVE_ARGUMENT(String, str, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, start, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, end, arguments->NativeArgAt(2));
+  if ((start.Value() < 0) || (start.Value() > end.Value()) ||
+      (end.Value() > str.Length())) {
+    return Object::null();
+  }
+  return String::DecodeBase64(str, start.Value(), end.Value());
+}
+
+// Parses JSON text from a one-byte string. Returns null for anything else,
+// including malformed input, so that the Dart parser reports the error.
+DEFINE_NATIVE_ENTRY(JsonDecoder_parseOneByteString, 0, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(String, source, arguments->NativeArgAt(0));
+  if (!source.IsOneByteString() && !source.IsExternalOneByteString()) {
+    return Object::null();
+  }
+  // Parsing allocates, so it reads a copy of the text outside the heap.
+  const intptr_t length = source.Length();
+  uint8_t* chars = zone->Alloc<uint8_t>(length);
+  String::ToLatin1(source, chars);
+  JsonParser parser(thread, chars, length);
+  Object& result = Object::Handle(zone);
+  if (!parser.Parse(&result)) {
+    return Object::null();
+  }
+  return result.raw();
+}
+
 }  // namespace dart
@@ -9,6 +9,8 @@ class StringBuffer {
   static const int _BUFFER_SIZE = 64;
   static const int _PARTS_TO_COMPACT = 128;
   static const int _PARTS_TO_COMPACT_SIZE_LIMIT = _PARTS_TO_COMPACT * 8;
+  // The longest [double.toString] result, such as "-0.0000012345678901234567".
+  static const int _MAX_DOUBLE_LENGTH = 25;
 
   /**
    * When strings are written to the string buffer, we add them to a
@@ -61,6 +63,14 @@ class StringBuffer {
 
   @patch
   void write(Object obj) {
+    if (obj is int) {
+      _writeInt(obj);
+      return;
+    }
+    if (obj is double) {
+      _writeDouble(obj);
+      return;
+    }
     String str = '$obj';
     if (str.isEmpty) return;
     _consumeBuffer();
@@ -111,6 +121,56 @@ class StringBuffer {
     write("\n");
   }
 
+  /**
+   * Writes the decimal digits of [value] straight into the buffer, without
+   * creating a string for them.
+   */
+  void _writeInt(int value) {
+    // A sign and at most 19 digits.
+    _ensureCapacity(20);
+    final Uint16List buffer = _buffer;
+    int position = _bufferPosition;
+    // The digits are taken from the last one of the negated value, which
+    // cannot overflow, and reversed afterwards.
+    int negative = value;
+    if (value < 0) {
+      buffer[position++] = 0x2d; // '-'.
+    } else {
+      negative = -value;
+    }
+    final int start = position;
+    while (negative <= -100) {
+      final int digitIndex = -2 * negative.remainder(100);
+      negative = negative ~/ 100;
+      buffer[position++] = _Smi._digitTable[digitIndex + 1];
+      buffer[position++] = _Smi._digitTable[digitIndex];
+    }
+    if (negative <= -10) {
+      final int digitIndex = -2 * negative;
+      buffer[position++] = _Smi._digitTable[digitIndex + 1];
+      buffer[position++] = _Smi._digitTable[digitIndex];
+    } else {
+      buffer[position++] = 0x30 - negative;
+    }
+    for (int i = start, j = position - 1; i < j; i++, j--) {
+      final int digit = buffer[i];
+      buffer[i] = buffer[j];
+      buffer[j] = digit;
+    }
+    _bufferPosition = position;
+    _bufferCodeUnitMagnitude |= 0x7F;
+  }
+
+  /**
+   * Writes the shortest representation of [value] that reads back as the
+   * same double, the same as [double.toString], straight into the buffer.
+   */
+  void _writeDouble(double value) {
+    _ensureCapacity(_MAX_DOUBLE_LENGTH);
+    _bufferPosition = _writeDoubleAt(_buffer, _bufferPosition, value);
+    _bufferCodeUnitMagnitude |= 0x7F;
+  }
+
   /** Makes the buffer empty. */
   @patch
   void clear() {
@@ -193,4 +253,11 @@ class StringBuffer {
    */
   static String _create(Uint16List buffer, int length, bool isLatin1)
       native "StringBuffer_createStringFromUint16Array";
+
+  /**
+   * Writes [value] like [double.toString] to [buffer] at [position], and
+   * returns the position after it.
+   */
+  static int _writeDoubleAt(Uint16List buffer, int position, double value)
+      native "StringBuffer_writeDouble";
 }
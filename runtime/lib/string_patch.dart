@@ -9,6 +9,9 @@ const int _maxLatin1 = 0xff;
 const int _maxUtf16 = 0xffff;
 const int _maxUnicode = 0x10ffff;
 
+// Shorter single character searches are faster in Dart than in the VM.
+const int _nativeSearchThreshold = 32;
+
 @patch
 class String {
   @patch
@@ -333,15 +336,7 @@ abstract class _StringBase implements String {
       throw new RangeError.range(start, 0, this.length, "start");
     }
     if (pattern is String) {
-      String other = pattern;
-      int maxIndex = this.length - other.length;
-      // TODO: Use an efficient string search (e.g. BMH).
-      for (int index = start; index <= maxIndex; index++) {
-        if (_substringMatches(index, other)) {
-          return index;
-        }
-      }
-      return -1;
+      return _indexOfString(pattern, start);
     }
     for (int i = start; i <= this.length; i++) {
       // TODO(11276); This has quadratic behavior because matchAsPrefix tries
@@ -351,6 +346,10 @@ abstract class _StringBase implements String {
     return -1;
   }
 
+  // Searches for [pattern] a word of code units at a time. Assumes that
+  // 0 <= start <= length.
+  int _indexOfString(String pattern, int start) native "String_indexOf";
+
   int lastIndexOf(Pattern pattern, [int start = null]) {
     if (start == null) {
       start = this.length;
@@ -861,6 +860,16 @@ abstract class _StringBase implements String {
     return _OneByteString._concatAll(values, totalLength);
   }
 
+  /**
+   * Concatenates [values] into a result string like [_interpolate], for
+   * interpolations whose parts the compiler knows to be strings, numbers,
+   * booleans or null. The result is allocated once and the numbers are
+   * formatted straight into it, without calling `toString` on any part.
+   */
+  @pragma("vm:entry-point", "call")
+  static String _interpolateKnownParts(List values)
+      native "String_interpolateKnownParts";
+
   Iterable<Match> allMatches(String string, [int start = 0]) {
     if (start < 0 || start > string.length) {
       throw new RangeError.range(start, 0, string.length, "start");
@@ -1014,6 +1023,9 @@ class _OneByteString extends _StringBase {
         if (patternCu0 > 0xFF) {
           return -1;
         }
+        if (len - start >= _nativeSearchThreshold) {
+          return _indexOfString(patternAsString, start);
+        }
         for (int i = start; i < len; i++) {
           if (this.codeUnitAt(i) == patternCu0) {
             return i;
@@ -1037,6 +1049,9 @@ class _OneByteString extends _StringBase {
         if (patternCu0 > 0xFF) {
           return false;
         }
+        if (len - start >= _nativeSearchThreshold) {
+          return _indexOfString(patternAsString, start) >= 0;
+        }
         for (int i = start; i < len; i++) {
           if (this.codeUnitAt(i) == patternCu0) {
             return true;
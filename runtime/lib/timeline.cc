@@ -44,109 +44,13 @@ DEFINE_NATIVE_ENTRY(Timeline_getThreadCpuClock, 0, 0) {
   return Integer::New(OS::GetCurrentThreadCPUMicros(), Heap::kNew);
 }
 
-DEFINE_NATIVE_ENTRY(Timeline_reportTaskEvent, 0, 6) {
+DEFINE_NATIVE_ENTRY(Timeline_reportBufferedEvents, 0, 3) {
 #if defined(SUPPORT_TIMELINE)
-  GET_NON_NULL_NATIVE_ARGUMENT(Integer, start, arguments->NativeArgAt(0));
-  GET_NON_NULL_NATIVE_ARGUMENT(Integer, id, arguments->NativeArgAt(1));
-  GET_NON_NULL_NATIVE_ARGUMENT(String, phase, arguments->NativeArgAt(2));
-  GET_NON_NULL_NATIVE_ARGUMENT(String, category, arguments->NativeArgAt(3));
-  GET_NON_NULL_NATIVE_ARGUMENT(String, name, arguments->NativeArgAt(4));
-  GET_NON_NULL_NATIVE_ARGUMENT(String, args, arguments->NativeArgAt(5));
-
-  TimelineEventRecorder* recorder = Timeline::recorder();
-  if (recorder == NULL) {
-    return Object::null();
-  }
-
-  TimelineEvent* event = Timeline::GetDartStream()->StartEvent();
-  if (event == NULL) {
-    // Stream was turned off.
-    return Object::null();
-  }
-
-  DartTimelineEventHelpers::ReportTaskEvent(
-      thread, event, start.AsInt64Value(), id.AsInt64Value(), phase.ToCString(),
-      category.ToCString(), name.ToMallocCString(), args.ToMallocCString());
-#endif  // SUPPORT_TIMELINE
-  return Object::null();
-}
-
-DEFINE_NATIVE_ENTRY(Timeline_reportCompleteEvent, 0, 5) {
-#if defined(SUPPORT_TIMELINE)
-  GET_NON_NULL_NATIVE_ARGUMENT(Integer, start, arguments->NativeArgAt(0));
-  GET_NON_NULL_NATIVE_ARGUMENT(Integer, start_cpu, arguments->NativeArgAt(1));
-  GET_NON_NULL_NATIVE_ARGUMENT(String, category, arguments->NativeArgAt(2));
-  GET_NON_NULL_NATIVE_ARGUMENT(String, name, arguments->NativeArgAt(3));
-  GET_NON_NULL_NATIVE_ARGUMENT(String, args, arguments->NativeArgAt(4));
-
-  TimelineEventRecorder* recorder = Timeline::recorder();
-  if (recorder == NULL) {
-    return Object::null();
-  }
-
-  TimelineEvent* event = Timeline::GetDartStream()->StartEvent();
-  if (event == NULL) {
-    // Stream was turned off.
-    return Object::null();
-  }
-
-  DartTimelineEventHelpers::ReportCompleteEvent(
-      thread, event, start.AsInt64Value(), start_cpu.AsInt64Value(),
-      category.ToCString(), name.ToMallocCString(), args.ToMallocCString());
-#endif  // SUPPORT_TIMELINE
-  return Object::null();
-}
-
-DEFINE_NATIVE_ENTRY(Timeline_reportFlowEvent, 0, 7) {
-#if defined(SUPPORT_TIMELINE)
-  GET_NON_NULL_NATIVE_ARGUMENT(Integer, start, arguments->NativeArgAt(0));
-  GET_NON_NULL_NATIVE_ARGUMENT(Integer, start_cpu, arguments->NativeArgAt(1));
-  GET_NON_NULL_NATIVE_ARGUMENT(String, category, arguments->NativeArgAt(2));
-  GET_NON_NULL_NATIVE_ARGUMENT(String, name, arguments->NativeArgAt(3));
-  GET_NON_NULL_NATIVE_ARGUMENT(Integer, type, arguments->NativeArgAt(4));
-  GET_NON_NULL_NATIVE_ARGUMENT(Integer, flow_id, arguments->NativeArgAt(5));
-  GET_NON_NULL_NATIVE_ARGUMENT(String, args, arguments->NativeArgAt(6));
-
-  TimelineEventRecorder* recorder = Timeline::recorder();
-  if (recorder == NULL) {
-    return Object::null();
-  }
-
-  TimelineEvent* event = Timeline::GetDartStream()->StartEvent();
-  if (event == NULL) {
-    // Stream was turned off.
-    return Object::null();
-  }
-
-  DartTimelineEventHelpers::ReportFlowEvent(
-      thread, event, start.AsInt64Value(), start_cpu.AsInt64Value(),
-      category.ToCString(), name.ToMallocCString(), type.AsInt64Value(),
-      flow_id.AsInt64Value(), args.ToMallocCString());
-#endif  // SUPPORT_TIMELINE
-  return Object::null();
-}
-
-DEFINE_NATIVE_ENTRY(Timeline_reportInstantEvent, 0, 4) {
-#if defined(SUPPORT_TIMELINE)
-  GET_NON_NULL_NATIVE_ARGUMENT(Integer, start, arguments->NativeArgAt(0));
-  GET_NON_NULL_NATIVE_ARGUMENT(String, category, arguments->NativeArgAt(1));
-  GET_NON_NULL_NATIVE_ARGUMENT(String, name, arguments->NativeArgAt(2));
-  GET_NON_NULL_NATIVE_ARGUMENT(String, args, arguments->NativeArgAt(3));
-
-  TimelineEventRecorder* recorder = Timeline::recorder();
-  if (recorder == NULL) {
-    return Object::null();
-  }
-
-  TimelineEvent* event = Timeline::GetDartStream()->StartEvent();
-  if (event == NULL) {
-    // Stream was turned off.
-    return Object::null();
-  }
-
-  DartTimelineEventHelpers::ReportInstantEvent(
-      thread, event, start.AsInt64Value(), category.ToCString(),
-      name.ToMallocCString(), args.ToMallocCString());
+  GET_NON_NULL_NATIVE_ARGUMENT(TypedData, numbers, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Array, strings, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, length, arguments->NativeArgAt(2));
+  DartTimelineEventHelpers::ReportBufferedEvents(thread, numbers, strings,
+                                                 length.Value());
 #endif  // SUPPORT_TIMELINE
   return Object::null();
 }
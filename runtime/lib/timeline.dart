@@ -18,16 +18,91 @@ int _getNextAsyncId() native "Timeline_getNextAsyncId";
 
 @patch
 void _reportTaskEvent(int start, int taskId, String phase, String category,
-    String name, String argumentsAsJson) native "Timeline_reportTaskEvent";
+    String name, String argumentsAsJson) {
+  _TimelineBuffer.add(_TimelineBuffer.kTaskEvent, start, taskId,
+      phase.codeUnitAt(0), 0, category, name, argumentsAsJson);
+}
 
 @patch
 void _reportCompleteEvent(int start, int startCpu, String category, String name,
-    String argumentsAsJson) native "Timeline_reportCompleteEvent";
+    String argumentsAsJson) {
+  _TimelineBuffer.add(_TimelineBuffer.kCompleteEvent, start, startCpu,
+      _getTraceClock(), _getThreadCpuClock(), category, name, argumentsAsJson);
+}
 
 @patch
 void _reportFlowEvent(int start, int startCpu, String category, String name,
-    int type, int id, String argumentsAsJson) native "Timeline_reportFlowEvent";
+    int type, int id, String argumentsAsJson) {
+  _TimelineBuffer.add(_TimelineBuffer.kFlowEvent, start, startCpu, type, id,
+      category, name, argumentsAsJson);
+}
 
 @patch
 void _reportInstantEvent(int start, String category, String name,
-    String argumentsAsJson) native "Timeline_reportInstantEvent";
+    String argumentsAsJson) {
+  _TimelineBuffer.add(_TimelineBuffer.kInstantEvent, start, 0, 0, 0, category,
+      name, argumentsAsJson);
+}
+
+/// Buffers the events of the Dart stream, so that the events of nested
+/// synchronous blocks are reported to the VM in one native call when the
+/// outermost block finishes. Events of blocks that are still open, e.g.
+/// because a block is never finished, are reported by a microtask at the end
+/// of the current event loop turn, or by the VM when the isolate shuts down.
+class _TimelineBuffer {
+  // Keep in sync with BufferedEventKind in timeline.cc.
+  static const int kCompleteEvent = 0;
+  static const int kInstantEvent = 1;
+  static const int kFlowEvent = 2;
+  static const int kTaskEvent = 3;
+
+  static const int kCapacity = 128;
+  static const int kNumbersPerEvent = 5;
+  static const int kStringsPerEvent = 3;
+
+  // The kind of each event followed by its timestamps and ids.
+  static final Int64List _numbers = new Int64List(kCapacity * kNumbersPerEvent);
+  // The category, name and arguments of each event.
+  static final List<String> _strings =
+      new List<String>(kCapacity * kStringsPerEvent);
+  static int _length = 0;
+  static bool _flushScheduled = false;
+
+  static void add(int kind, int a, int b, int c, int d, String category,
+      String name, String argumentsAsJson) {
+    final int numbers = _length * kNumbersPerEvent;
+    _numbers[numbers] = kind;
+    _numbers[numbers + 1] = a;
+    _numbers[numbers + 2] = b;
+    _numbers[numbers + 3] = c;
+    _numbers[numbers + 4] = d;
+    final int strings = _length * kStringsPerEvent;
+    _strings[strings] = category;
+    _strings[strings + 1] = name;
+    _strings[strings + 2] = argumentsAsJson;
+    _length++;
+    if ((_length == kCapacity) || Timeline._stack.isEmpty) {
+      flush();
+    } else if (!_flushScheduled) {
+      // The root zone keeps the flush out of the zones of user code.
+      _flushScheduled = true;
+      Zone.root.scheduleMicrotask(_flushScheduledEvents);
+    }
+  }
+
+  static void _flushScheduledEvents() {
+    _flushScheduled = false;
+    if (_length > 0) {
+      flush();
+    }
+  }
+
+  static void flush() {
+    _reportBufferedEvents(_numbers, _strings, _length);
+    _strings.fillRange(0, _length * kStringsPerEvent, null);
+    _length = 0;
+  }
+}
+
+void _reportBufferedEvents(Int64List numbers, List<String> strings, int length)
+    native "Timeline_reportBufferedEvents";
@@ -109,6 +109,64 @@ abstract class _TypedListBase {
   // Element size of toCid and fromCid must match (test at caller).
   bool _setRange(int startInBytes, int lengthInBytes, _TypedListBase from,
       int startFromInBytes, int toCid, int fromCid) native "TypedData_setRange";
+
+  // Copies 'count' elements of 'from', starting at 'startFrom', to this list
+  // starting at 'start', as if through a temporary buffer when the ranges
+  // overlap. Both lists must have elements of the same size which need no
+  // clamping, and the ranges must be valid.
+  void _memMove(int start, _TypedListBase from, int startFrom, int count) {
+    switch (elementSizeInBytes) {
+      case 1:
+        _memMove1(start, from, startFrom, count);
+        break;
+      case 2:
+        _memMove2(start, from, startFrom, count);
+        break;
+      case 4:
+        _memMove4(start, from, startFrom, count);
+        break;
+      case 8:
+        _memMove8(start, from, startFrom, count);
+        break;
+      case 16:
+        _memMove16(start, from, startFrom, count);
+        break;
+    }
+  }
+
+  // The optimizing compiler replaces calls to these with a MemoryCopy
+  // instruction for elements of the size in their name.
+  void _memMove1(int start, _TypedListBase from, int startFrom, int count) {
+    _memMoveNative(start, from, startFrom, count);
+  }
+
+  void _memMove2(int start, _TypedListBase from, int startFrom, int count) {
+    _memMoveNative(start, from, startFrom, count);
+  }
+
+  void _memMove4(int start, _TypedListBase from, int startFrom, int count) {
+    _memMoveNative(start, from, startFrom, count);
+  }
+
+  void _memMove8(int start, _TypedListBase from, int startFrom, int count) {
+    _memMoveNative(start, from, startFrom, count);
+  }
+
+  void _memMove16(int start, _TypedListBase from, int startFrom, int count) {
+    _memMoveNative(start, from, startFrom, count);
+  }
+
+  void _memMoveNative(
+      int start, _TypedListBase from, int startFrom, int count) {
+    final int size = elementSizeInBytes;
+    buffer._data._setRange(
+        start * size + offsetInBytes,
+        count * size,
+        from.buffer._data,
+        startFrom * size + from.offsetInBytes,
+        ClassID.getID(this),
+        ClassID.getID(from));
+  }
 }
 
 mixin _IntListMixin implements List<int> {
@@ -390,6 +448,7 @@ mixin _IntListMixin implements List<int> {
 mixin _TypedIntListMixin<SpawnedType extends List<int>> on _IntListMixin
     implements List<int> {
   SpawnedType _createList(int length);
+  void _memMove(int start, _TypedListBase from, int startFrom, int count);
 
   void setRange(int start, int end, Iterable<int> from, [int skipCount = 0]) {
     // Check ranges.
@@ -413,7 +472,11 @@ mixin _TypedIntListMixin<SpawnedType extends List<int>> on _IntListMixin
       // no promotion here.
       final fromAsTypedList = from as _TypedListBase;
       if (this.elementSizeInBytes == fromAsTypedList.elementSizeInBytes) {
-        if ((count < 10) && (fromAsTypedList.buffer != this.buffer)) {
+        // Only Int8 values stored into a Uint8ClampedList need clamping.
+        if (this is! Uint8ClampedList || from is! Int8List) {
+          _memMove(start, fromAsTypedList, skipCount, count);
+          return;
+        } else if ((count < 10) && (fromAsTypedList.buffer != this.buffer)) {
           Lists.copy(from as List<int>, skipCount, this, start, count);
           return;
         } else if (this.buffer._data._setRange(
@@ -746,6 +809,7 @@ mixin _DoubleListMixin implements List<double> {
 mixin _TypedDoubleListMixin<SpawnedType extends List<double>>
     on _DoubleListMixin implements List<double> {
   SpawnedType _createList(int length);
+  void _memMove(int start, _TypedListBase from, int startFrom, int count);
 
   void setRange(int start, int end, Iterable<double> from,
       [int skipCount = 0]) {
@@ -770,18 +834,8 @@ mixin _TypedDoubleListMixin<SpawnedType extends List<double>>
       // no promotion here.
       final fromAsTypedList = from as _TypedListBase;
       if (this.elementSizeInBytes == fromAsTypedList.elementSizeInBytes) {
-        if ((count < 10) && (fromAsTypedList.buffer != this.buffer)) {
-          Lists.copy(from as List<double>, skipCount, this, start, count);
-          return;
-        } else if (this.buffer._data._setRange(
-            start * elementSizeInBytes + this.offsetInBytes,
-            count * elementSizeInBytes,
-            fromAsTypedList.buffer._data,
-            skipCount * elementSizeInBytes + fromAsTypedList.offsetInBytes,
-            ClassID.getID(this),
-            ClassID.getID(from))) {
-          return;
-        }
+        _memMove(start, fromAsTypedList, skipCount, count);
+        return;
       } else if (fromAsTypedList.buffer == this.buffer) {
         // Different element sizes, but same buffer means that we need
         // an intermediate structure.
@@ -828,6 +882,7 @@ abstract class _Float32x4ListMixin implements List<Float32x4> {
   _ByteBuffer get buffer;
 
   Float32x4List _createList(int length);
+  void _memMove(int start, _TypedListBase from, int startFrom, int count);
 
   Iterable<T> whereType<T>() => new WhereTypeIterable<T>(this);
 
@@ -912,18 +967,8 @@ abstract class _Float32x4ListMixin implements List<Float32x4> {
       // no promotion here.
       final fromAsTypedList = from as _TypedListBase;
       if (this.elementSizeInBytes == fromAsTypedList.elementSizeInBytes) {
-        if ((count < 10) && (fromAsTypedList.buffer != this.buffer)) {
-          Lists.copy(from as List<Float32x4>, skipCount, this, start, count);
-          return;
-        } else if (this.buffer._data._setRange(
-            start * elementSizeInBytes + this.offsetInBytes,
-            count * elementSizeInBytes,
-            fromAsTypedList.buffer._data,
-            skipCount * elementSizeInBytes + fromAsTypedList.offsetInBytes,
-            ClassID.getID(this),
-            ClassID.getID(from))) {
-          return;
-        }
+        _memMove(start, fromAsTypedList, skipCount, count);
+        return;
       } else if (fromAsTypedList.buffer == this.buffer) {
         // Different element sizes, but same buffer means that we need
         // an intermediate structure.
@@ -1186,6 +1231,7 @@ abstract class _Int32x4ListMixin implements List<Int32x4> {
   _ByteBuffer get buffer;
 
   Int32x4List _createList(int length);
+  void _memMove(int start, _TypedListBase from, int startFrom, int count);
 
   Iterable<T> whereType<T>() => new WhereTypeIterable<T>(this);
 
@@ -1270,18 +1316,8 @@ abstract class _Int32x4ListMixin implements List<Int32x4> {
       // no promotion here.
       final fromAsTypedList = from as _TypedListBase;
       if (this.elementSizeInBytes == fromAsTypedList.elementSizeInBytes) {
-        if ((count < 10) && (fromAsTypedList.buffer != this.buffer)) {
-          Lists.copy(from as List<Int32x4>, skipCount, this, start, count);
-          return;
-        } else if (this.buffer._data._setRange(
-            start * elementSizeInBytes + this.offsetInBytes,
-            count * elementSizeInBytes,
-            fromAsTypedList.buffer._data,
-            skipCount * elementSizeInBytes + fromAsTypedList.offsetInBytes,
-            ClassID.getID(this),
-            ClassID.getID(from))) {
-          return;
-        }
+        _memMove(start, fromAsTypedList, skipCount, count);
+        return;
       } else if (fromAsTypedList.buffer == this.buffer) {
         // Different element sizes, but same buffer means that we need
         // an intermediate structure.
@@ -1543,6 +1579,7 @@ abstract class _Float64x2ListMixin implements List<Float64x2> {
   _ByteBuffer get buffer;
 
   Float64x2List _createList(int length);
+  void _memMove(int start, _TypedListBase from, int startFrom, int count);
 
   Iterable<T> whereType<T>() => new WhereTypeIterable<T>(this);
 
@@ -1627,18 +1664,8 @@ abstract class _Float64x2ListMixin implements List<Float64x2> {
       // no promotion here.
       final fromAsTypedList = from as _TypedListBase;
       if (this.elementSizeInBytes == fromAsTypedList.elementSizeInBytes) {
-        if ((count < 10) && (fromAsTypedList.buffer != this.buffer)) {
-          Lists.copy(from as List<Float64x2>, skipCount, this, start, count);
-          return;
-        } else if (this.buffer._data._setRange(
-            start * elementSizeInBytes + this.offsetInBytes,
-            count * elementSizeInBytes,
-            fromAsTypedList.buffer._data,
-            skipCount * elementSizeInBytes + fromAsTypedList.offsetInBytes,
-            ClassID.getID(this),
-            ClassID.getID(from))) {
-          return;
-        }
+        _memMove(start, fromAsTypedList, skipCount, count);
+        return;
       } else if (fromAsTypedList.buffer == this.buffer) {
         // Different element sizes, but same buffer means that we need
         // an intermediate structure.
@@ -49,9 +49,14 @@ class HeapSnapshotLoadingProgress extends M.HeapSnapshotLoadingProgress {
 
       stream.listen((status) {
         if (status is List) {
-          _progress = status[0] * 100.0 / status[1];
-          _stepDescription = 'Receiving snapshot chunk ${status[0] + 1}'
-              ' of ${status[1]}...';
+          // The number of chunks is only known once the last one arrives.
+          if (status[1] == null) {
+            _stepDescription = 'Receiving snapshot chunk ${status[0] + 1}...';
+          } else {
+            _progress = status[0] * 100.0 / status[1];
+            _stepDescription = 'Receiving snapshot chunk ${status[0] + 1}'
+                ' of ${status[1]}...';
+          }
           _triggerOnProgress();
         }
       });
@@ -1478,6 +1478,8 @@ class Isolate extends ServiceObjectOwner implements M.Isolate {
   StreamController _snapshotFetch;
 
   List<ByteData> _chunksInProgress;
+  int _chunkCountInProgress;
+  int _nodeCountInProgress;
 
   List<Thread> get threads => _threads;
   final List<Thread> _threads = new List<Thread>();
@@ -1499,24 +1501,36 @@ class Isolate extends ServiceObjectOwner implements M.Isolate {
       return;
     }
 
-    // Occasionally these actually arrive out of order.
+    // Occasionally these actually arrive out of order. The chunks are sent
+    // while the heap is walked, so only the last one has the counts.
     var chunkIndex = event.chunkIndex;
-    var chunkCount = event.chunkCount;
     if (_chunksInProgress == null) {
-      _chunksInProgress = new List(chunkCount);
+      _chunksInProgress = <ByteData>[];
+    }
+    if (_chunksInProgress.length <= chunkIndex) {
+      _chunksInProgress.length = chunkIndex + 1;
     }
     _chunksInProgress[chunkIndex] = event.data;
+    if (event.chunkCount != null) {
+      _chunkCountInProgress = event.chunkCount;
+      _nodeCountInProgress = event.nodeCount;
+    }
+    var chunkCount = _chunkCountInProgress;
     _snapshotFetch.add([chunkIndex, chunkCount]);
 
+    if (chunkCount == null) return;
     for (var i = 0; i < chunkCount; i++) {
       if (_chunksInProgress[i] == null) return;
     }
 
     var loadedChunks = _chunksInProgress;
+    var nodeCount = _nodeCountInProgress;
     _chunksInProgress = null;
+    _chunkCountInProgress = null;
+    _nodeCountInProgress = null;
 
     if (_snapshotFetch != null) {
-      _snapshotFetch.add(new RawHeapSnapshot(loadedChunks, event.nodeCount));
+      _snapshotFetch.add(new RawHeapSnapshot(loadedChunks, nodeCount));
       _snapshotFetch.close();
     }
   }
@@ -0,0 +1,64 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+// VMOptions=--complete_timeline
+
+import 'dart:developer';
+import 'package:observatory/service_io.dart';
+import 'package:unittest/unittest.dart';
+
+import 'test_helper.dart';
+
+// More events than fit in the buffer of the Dart stream, so that some are
+// reported before the outermost block finishes.
+const int kDepth = 200;
+
+primeTimeline() {
+  for (int i = 0; i < kDepth; i++) {
+    Timeline.startSync('block$i', arguments: {'depth': '$i'});
+    Timeline.instantSync('instant$i');
+  }
+  for (int i = 0; i < kDepth; i++) {
+    Timeline.finishSync();
+  }
+  Timeline.instantSync('after');
+}
+
+List filterForDartEvents(List events) {
+  return events.where((event) => event['cat'] == 'Dart').toList();
+}
+
+Map findEvent(List events, String phase, String name) {
+  for (Map event in events) {
+    if ((event['ph'] == phase) && (event['name'] == name)) {
+      return event;
+    }
+  }
+  return null;
+}
+
+var tests = <VMTest>[
+  (VM vm) async {
+    Map result = await vm.invokeRpcNoUpgrade('getVMTimeline', {});
+    expect(result['type'], equals('Timeline'));
+    List dartEvents = filterForDartEvents(result['traceEvents']);
+    expect(dartEvents.length, equals(2 * kDepth + 1));
+    expect(findEvent(dartEvents, 'i', 'after'), isNotNull);
+    Map outer;
+    for (int i = 0; i < kDepth; i++) {
+      expect(findEvent(dartEvents, 'i', 'instant$i'), isNotNull);
+      Map block = findEvent(dartEvents, 'X', 'block$i');
+      expect(block, isNotNull);
+      expect(block['args']['depth'], equals('$i'));
+      if (outer != null) {
+        // Blocks are nested in the blocks started before them.
+        expect(block['ts'], greaterThanOrEqualTo(outer['ts']));
+        expect(block['ts'] + block['dur'],
+            lessThanOrEqualTo(outer['ts'] + outer['dur']));
+      }
+      outer = block;
+    }
+  },
+];
+
+main(args) async => runVMTests(args, tests, testeeBefore: primeTimeline);
@@ -7,6 +7,7 @@
 #include "platform/allocation.h"
 #include "platform/globals.h"
 #include "platform/syslog.h"
+#include "platform/utils.h"
 
 namespace dart {
 
@@ -48,8 +49,16 @@ intptr_t Utf8::CodeUnitCount(const uint8_t* utf8_array,
                              Type* type) {
   intptr_t len = 0;
   Type char_type = kLatin1;
-  for (intptr_t i = 0; i < array_len; i++) {
+  intptr_t i = 0;
+  while (i < array_len) {
     uint8_t code_unit = utf8_array[i];
+    if (code_unit <= kMaxOneByteChar) {
+      const intptr_t ascii_len =
+          AsciiPrefixLength(&utf8_array[i], array_len - i);
+      len += ascii_len;
+      i += ascii_len;
+      continue;
+    }
     if (!IsTrailByte(code_unit)) {
       ++len;
       if (!IsLatin1SequenceStart(code_unit)) {          // > U+00FF
@@ -61,6 +70,7 @@ intptr_t Utf8::CodeUnitCount(const uint8_t* utf8_array,
         }
       }
     }
+    i++;
   }
   *type = char_type;
   return len;
@@ -71,30 +81,50 @@ bool Utf8::IsValid(const uint8_t* utf8_array, intptr_t array_len) {
   intptr_t i = 0;
   while (i < array_len) {
     uint32_t ch = utf8_array[i] & 0xFF;
+    if (ch <= kMaxOneByteChar) {
+      i += AsciiPrefixLength(&utf8_array[i], array_len - i);
+      continue;
+    }
     intptr_t j = 1;
-    if (ch >= 0x80) {
-      int8_t num_trail_bytes = kTrailBytes[ch];
-      bool is_malformed = false;
-      for (; j < num_trail_bytes; ++j) {
-        if ((i + j) < array_len) {
-          uint8_t code_unit = utf8_array[i + j];
-          is_malformed |= !IsTrailByte(code_unit);
-          ch = (ch << 6) + code_unit;
-        } else {
-          return false;
-        }
-      }
-      ch -= kMagicBits[num_trail_bytes];
-      if (!((is_malformed == false) && (j == num_trail_bytes) &&
-            !Utf::IsOutOfRange(ch) && !IsNonShortestForm(ch, j))) {
+    int8_t num_trail_bytes = kTrailBytes[ch];
+    bool is_malformed = false;
+    for (; j < num_trail_bytes; ++j) {
+      if ((i + j) < array_len) {
+        uint8_t code_unit = utf8_array[i + j];
+        is_malformed |= !IsTrailByte(code_unit);
+        ch = (ch << 6) + code_unit;
+      } else {
         return false;
       }
     }
+    ch -= kMagicBits[num_trail_bytes];
+    if (!((is_malformed == false) && (j == num_trail_bytes) &&
+          !Utf::IsOutOfRange(ch) && !IsNonShortestForm(ch, j))) {
+      return false;
+    }
     i += j;
   }
   return true;
 }
 
+// Bytes that are not ASCII have their high bit set.
+static const uword kNonAsciiMask = (kUwordMax / 0xFF) * 0x80;
+
+intptr_t Utf8::AsciiPrefixLength(const uint8_t* utf8_array,
+                                 intptr_t array_len) {
+  // Text is mostly ASCII, so look at a word at a time.
+  intptr_t i = 0;
+  while (((i + kWordSize) <= array_len) &&
+         ((ReadUnaligned(reinterpret_cast<const uword*>(&utf8_array[i])) &
+           kNonAsciiMask) == 0)) {
+    i += kWordSize;
+  }
+  while ((i < array_len) && (utf8_array[i] <= kMaxOneByteChar)) {
+    i++;
+  }
+  return i;
+}
+
 intptr_t Utf8::Length(int32_t ch) {
   if (ch <= kMaxOneByteChar) {
     return 1;
@@ -197,16 +227,25 @@ bool Utf8::DecodeToLatin1(const uint8_t* utf8_array,
                           intptr_t len) {
   intptr_t i = 0;
   intptr_t j = 0;
-  intptr_t num_bytes;
-  for (; (i < array_len) && (j < len); i += num_bytes, ++j) {
+  while ((i < array_len) && (j < len)) {
+    if (utf8_array[i] <= kMaxOneByteChar) {
+      const intptr_t ascii_len = AsciiPrefixLength(
+          &utf8_array[i], Utils::Minimum(array_len - i, len - j));
+      memmove(&dst[j], &utf8_array[i], ascii_len);
+      i += ascii_len;
+      j += ascii_len;
+      continue;
+    }
     int32_t ch;
     ASSERT(IsLatin1SequenceStart(utf8_array[i]));
-    num_bytes = Utf8::Decode(&utf8_array[i], (array_len - i), &ch);
+    intptr_t num_bytes = Utf8::Decode(&utf8_array[i], (array_len - i), &ch);
     if (ch == -1) {
       return false;  // Invalid input.
     }
     ASSERT(Utf::IsLatin1(ch));
     dst[j] = ch;
+    i += num_bytes;
+    ++j;
   }
   if ((i < array_len) && (j == len)) {
     return false;  // Output overflow.
@@ -220,11 +259,20 @@ bool Utf8::DecodeToUTF16(const uint8_t* utf8_array,
                          intptr_t len) {
   intptr_t i = 0;
   intptr_t j = 0;
-  intptr_t num_bytes;
-  for (; (i < array_len) && (j < len); i += num_bytes, ++j) {
+  while ((i < array_len) && (j < len)) {
+    if (utf8_array[i] <= kMaxOneByteChar) {
+      const intptr_t ascii_len = AsciiPrefixLength(
+          &utf8_array[i], Utils::Minimum(array_len - i, len - j));
+      for (intptr_t k = 0; k < ascii_len; k++) {
+        dst[j + k] = utf8_array[i + k];
+      }
+      i += ascii_len;
+      j += ascii_len;
+      continue;
+    }
     int32_t ch;
     bool is_supplementary = IsSupplementarySequenceStart(utf8_array[i]);
-    num_bytes = Utf8::Decode(&utf8_array[i], (array_len - i), &ch);
+    intptr_t num_bytes = Utf8::Decode(&utf8_array[i], (array_len - i), &ch);
     if (ch == -1) {
       return false;  // Invalid input.
     }
@@ -235,6 +283,8 @@ bool Utf8::DecodeToUTF16(const uint8_t* utf8_array,
     } else {
       dst[j] = ch;
     }
+    i += num_bytes;
+    ++j;
   }
   if ((i < array_len) && (j == len)) {
     return false;  // Output overflow.
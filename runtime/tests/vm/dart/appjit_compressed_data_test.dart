@@ -0,0 +1,50 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// OtherResources=appjit_load_static_licm_test_body.dart
+
+// Verify that an app-jit snapshot written with --compress-snapshot-data is
+// smaller than an uncompressed one and runs the same.
+
+import "dart:async";
+import "dart:io";
+
+import "package:expect/expect.dart";
+import "package:path/path.dart" as p;
+
+import "snapshot_test_helper.dart";
+
+Future<void> main() async {
+  await withTempDir((String temp) async {
+    final String testPath = Platform.script
+        .resolve("appjit_load_static_licm_test_body.dart")
+        .toFilePath();
+    final String plainPath = p.join(temp, "plain.jit");
+    final String compressedPath = p.join(temp, "compressed.jit");
+
+    final plainResult = await runDart("TRAINING RUN", [
+      "--snapshot=$plainPath",
+      "--snapshot-kind=app-jit",
+      testPath,
+      "--train"
+    ]);
+    expectOutput("OK(Trained)", plainResult);
+
+    final compressedResult = await runDart("COMPRESSED TRAINING RUN", [
+      "--compress-snapshot-data",
+      "--snapshot=$compressedPath",
+      "--snapshot-kind=app-jit",
+      testPath,
+      "--train"
+    ]);
+    expectOutput("OK(Trained)", compressedResult);
+
+    Expect.isTrue(new File(compressedPath).lengthSync() <
+        new File(plainPath).lengthSync());
+
+    final runResult =
+        await runDart("RUN FROM COMPRESSED SNAPSHOT", [compressedPath]);
+    expectOutput("OK(Run)", runResult);
+  });
+}
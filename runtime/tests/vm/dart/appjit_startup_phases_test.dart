@@ -0,0 +1,63 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// OtherResources=appjit_load_static_licm_test_body.dart
+
+// Verify that --print_startup_phases reports the phases of starting from an
+// app-jit snapshot as a single line of JSON.
+
+import "dart:async";
+import "dart:convert";
+import "dart:io";
+
+import "package:expect/expect.dart";
+import "package:path/path.dart" as p;
+
+import "snapshot_test_helper.dart";
+
+Map<String, dynamic> startupPhases(Result result) {
+  final String line = (result.processResult.stdout as String)
+      .split("\n")
+      .firstWhere((String line) => line.contains('"StartupPhases"'));
+  return json.decode(line);
+}
+
+Future<void> main() async {
+  await withTempDir((String temp) async {
+    final String testPath = Platform.script
+        .resolve("appjit_load_static_licm_test_body.dart")
+        .toFilePath();
+    final String snapshotPath = p.join(temp, "app.jit");
+
+    final trainingResult = await runDart("TRAINING RUN", [
+      "--snapshot=$snapshotPath",
+      "--snapshot-kind=app-jit",
+      testPath,
+      "--train"
+    ]);
+    expectOutput("OK(Trained)", trainingResult);
+
+    final runResult = await runDart("RUN FROM SNAPSHOT", [
+      "--print_startup_phases",
+      snapshotPath,
+    ]);
+    Expect.equals(0, runResult.processResult.exitCode);
+    final String stdout = runResult.processResult.stdout;
+    Expect.isTrue(stdout.contains("OK(Run)"), stdout);
+
+    final Map<String, dynamic> phases = startupPhases(runResult);
+    final List<String> names = (phases["phases"] as List)
+        .map<String>((dynamic phase) => phase["name"])
+        .toList();
+    Expect.isTrue(names.contains("VMInitialize"), "$names");
+    Expect.isTrue(names.contains("ReadIsolateSnapshot"), "$names");
+    final List clusters = phases["clusters"];
+    Expect.isTrue(clusters.isNotEmpty);
+    for (final dynamic cluster in clusters) {
+      Expect.isTrue(cluster["count"] > 0);
+      Expect.isTrue(cluster["allocMicros"] >= 0);
+      Expect.isTrue(cluster["fillMicros"] >= 0);
+    }
+  });
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Verify that an app-jit snapshot can be refreshed after a change by loading
+// the type feedback of a previous training run: feedback is applied to the
+// functions that did not change and skipped for the ones that did.
+
+import "dart:async";
+import "dart:io";
+
+import "package:expect/expect.dart";
+import "package:path/path.dart" as p;
+
+import "snapshot_test_helper.dart";
+
+String program(String fibBody) => """
+int fib(int n) {
+  $fibBody
+}
+
+int sum(int n) {
+  int result = 0;
+  for (int i = 0; i < n; i++) {
+    result += i;
+  }
+  return result;
+}
+
+main() {
+  print(fib(25) + sum(100000));
+}
+""";
+
+Future<void> main() async {
+  await withTempDir((String tmp) async {
+    final String oldPath = p.join(tmp, "old.dart");
+    final String newPath = p.join(tmp, "new.dart");
+    final String feedbackPath = p.join(tmp, "type_feedback.bin");
+    final String snapshotPath = p.join(tmp, "app.jit");
+
+    new File(oldPath).writeAsStringSync(
+        program("if (n <= 1) return 1; return fib(n - 1) + fib(n - 2);"));
+    // Same length, so that the token positions of sum do not move.
+    new File(newPath).writeAsStringSync(
+        program("if (n <  2) return 1; return fib(n - 1) + fib(n - 2);"));
+
+    final result1 = await runDart("save type feedback", [
+      "--save_type_feedback=$feedbackPath",
+      oldPath,
+    ]);
+    expectOutput("5000071393", result1);
+
+    final result2 = await runDart("refresh app-jit snapshot", [
+      "--trace_compilation_trace",
+      "--load_type_feedback=$feedbackPath",
+      "--snapshot-kind=app-jit",
+      "--snapshot=$snapshotPath",
+      newPath,
+    ]);
+    final String trace = result2.processResult.stdout;
+    Expect.isTrue(trace.contains("Changed function fib"), trace);
+    Expect.isFalse(trace.contains("Changed function sum"), trace);
+    Expect.isFalse(trace.contains("Missing function sum"), trace);
+
+    final result3 = await runDart("run refreshed snapshot", [snapshotPath]);
+    expectOutput("5000071393", result3);
+  });
+}
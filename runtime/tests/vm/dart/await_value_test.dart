@@ -0,0 +1,86 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Verify that awaiting values and completing async functions, which skip
+// the intermediate futures and completers, keep their ordering, zone and
+// error semantics.
+
+import "dart:async";
+
+import "package:expect/expect.dart";
+
+final events = <String>[];
+
+Future<int> awaitValues(int n) async {
+  int sum = 0;
+  for (int i = 0; i < n; i++) {
+    events.add("await $i");
+    sum += await i;
+  }
+  return sum;
+}
+
+Future<int> returnFuture() async => new Future<int>.value(42);
+
+Future<int> throwAfterAwait() async {
+  await null;
+  throw "error";
+}
+
+Future<void> testOrdering() async {
+  events.clear();
+  final future = awaitValues(3);
+  events.add("after call");
+  scheduleMicrotask(() => events.add("microtask"));
+  Expect.equals(3, await future);
+  Expect.listEquals(
+      ["await 0", "after call", "await 1", "microtask", "await 2"], events);
+}
+
+Future<void> testZones() async {
+  int scheduled = 0;
+  int runs = 0;
+  final result = await runZoned(() => awaitValues(4),
+      zoneSpecification: new ZoneSpecification(
+          scheduleMicrotask: (self, parent, zone, f) {
+    scheduled++;
+    parent.scheduleMicrotask(zone, f);
+  }, runUnary: <R, T>(self, parent, zone, R f(T arg), T arg) {
+    runs++;
+    return parent.runUnary(zone, f, arg);
+  }));
+  Expect.equals(6, result);
+  Expect.isTrue(scheduled >= 4);
+  Expect.isTrue(runs >= 4);
+}
+
+Future<void> testErrors() async {
+  Expect.equals(42, await returnFuture());
+  try {
+    await throwAfterAwait();
+    Expect.fail("Expected an error");
+  } catch (e) {
+    Expect.equals("error", e);
+  }
+
+  final replaced = new StateError("replaced");
+  Object caught;
+  await runZoned(() async {
+    try {
+      await throwAfterAwait();
+    } catch (e) {
+      caught = e;
+    }
+  },
+      zoneSpecification: new ZoneSpecification(
+          errorCallback: (self, parent, zone, error, stackTrace) =>
+              error == "error" ? new AsyncError(replaced, null) : null));
+  Expect.identical(replaced, caught);
+}
+
+main() async {
+  await testOrdering();
+  await testZones();
+  await testErrors();
+}
@@ -0,0 +1,51 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--causal_async_stacks
+
+// Verify that async functions called repeatedly from the same place, which
+// share their causal stack trace, still report the right callers.
+
+import "package:expect/expect.dart";
+
+Future<int> leaf(int i) async {
+  if (i == 9) throw "leaf $i";
+  return i;
+}
+
+Future<int> loopA() async {
+  int sum = 0;
+  for (int i = 0; i < 10; i++) {
+    sum += await leaf(i);
+  }
+  return sum;
+}
+
+Future<int> loopB() async {
+  int sum = 0;
+  for (int i = 5; i < 10; i++) {
+    sum += await leaf(i);
+  }
+  return sum;
+}
+
+Future<void> expectTrace(Future<int> f(), String caller, String other) async {
+  try {
+    await f();
+    Expect.fail("Expected an error");
+  } catch (e, st) {
+    Expect.equals("leaf 9", e);
+    final trace = st.toString();
+    Expect.isTrue(trace.contains("leaf"), trace);
+    Expect.isTrue(trace.contains(caller), trace);
+    Expect.isFalse(trace.contains(other), trace);
+    Expect.isTrue(trace.contains("<asynchronous suspension>"), trace);
+  }
+}
+
+main() async {
+  await expectTrace(loopA, "loopA", "loopB");
+  await expectTrace(loopB, "loopB", "loopA");
+  await expectTrace(loopA, "loopA", "loopB");
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Verify that maps and sets find all their keys, in insertion order, after
+// growing from the hash bits kept in their index.
+
+import "dart:collection";
+
+import "package:expect/expect.dart";
+
+class Key {
+  final int value;
+  Key(this.value);
+  // Many keys hash to 0 or 1, whose masked hashes are stored alike.
+  int get hashCode => value % 3 == 0 ? value % 2 : value * 0x9E3779B1;
+  bool operator ==(other) => other is Key && other.value == value;
+}
+
+void checkMap(Map<Object, int> map, Object key(int i)) {
+  const int count = 5000;
+  for (int i = 0; i < count; i++) {
+    map[key(i)] = i;
+  }
+  Expect.equals(count, map.length);
+  for (int i = 0; i < count; i++) {
+    Expect.equals(i, map[key(i)]);
+  }
+  int expected = 0;
+  map.forEach((k, v) => Expect.equals(expected++, v));
+  Expect.isNull(map[key(count)]);
+
+  // Removing keys makes the next growth rehash them.
+  for (int i = 0; i < count; i += 2) {
+    Expect.equals(i, map.remove(key(i)));
+  }
+  for (int i = count; i < 3 * count; i++) {
+    map[key(i)] = i;
+  }
+  for (int i = 0; i < 3 * count; i++) {
+    Expect.equals((i < count && i.isEven) ? null : i, map[key(i)]);
+  }
+}
+
+void checkSet(Set<Object> set, Object key(int i)) {
+  const int count = 5000;
+  for (int i = 0; i < count; i++) {
+    Expect.isTrue(set.add(key(i)));
+  }
+  for (int i = 0; i < count; i++) {
+    Expect.isTrue(set.contains(key(i)));
+    Expect.isFalse(set.add(key(i)));
+  }
+  Expect.equals(key(0), set.first);
+  Expect.equals(key(count - 1), set.last);
+}
+
+void main() {
+  checkMap(<Object, int>{}, (i) => i);
+  checkMap(<Object, int>{}, (i) => "key$i");
+  checkMap(<Object, int>{}, (i) => new Key(i));
+  checkMap(
+      new LinkedHashMap<Object, int>(
+          equals: (a, b) => a == b, hashCode: (k) => k.hashCode),
+      (i) => new Key(i));
+  checkSet(new Set<Object>(), (i) => new Key(i));
+  checkSet(new Set<Object>(), (i) => "key$i");
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+// VMOptions=--share_group_type_feedback
+// VMOptions=--share_group_type_feedback --optimization_counter_threshold=10 --no-background-compilation
+
+// Verify that isolates spawned after other isolates of the group have warmed
+// up and exited load their type feedback and compute the same results.
+
+import 'dart:async';
+import 'dart:isolate';
+
+import "package:expect/expect.dart";
+
+class A {
+  int value(int i) => i;
+}
+
+class B extends A {
+  int value(int i) => 2 * i;
+}
+
+int sum(List<A> objects, int n) {
+  int result = 0;
+  for (int i = 0; i < n; i++) {
+    result += objects[i % objects.length].value(i);
+  }
+  return result;
+}
+
+void child(SendPort replyPort) {
+  replyPort.send(sum([new A(), new B()], 10000));
+}
+
+Future<void> main() async {
+  final int expected = sum([new A(), new B()], 10000);
+  for (int i = 0; i < 5; i++) {
+    final port = new ReceivePort();
+    final exitPort = new ReceivePort();
+    await Isolate.spawn(child, port.sendPort, onExit: exitPort.sendPort);
+    Expect.equals(expected, await port.first);
+    // Let the child leave its feedback behind before the next spawn.
+    await exitPort.first;
+  }
+}
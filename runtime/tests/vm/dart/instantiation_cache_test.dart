@@ -0,0 +1,36 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Verify that type arguments instantiated with many different instantiators,
+// which makes their instantiations cache a hash table, give the right types.
+
+import "package:expect/expect.dart";
+
+class Box<T> {}
+
+List<Object> boxes = <Object>[];
+
+void nest<T>(int depth) {
+  boxes.add(new Box<T>());
+  if (depth > 0) nest<Box<T>>(depth - 1);
+}
+
+String expectedName(int depth) {
+  String name = "int";
+  for (int i = 0; i < depth; i++) {
+    name = "Box<$name>";
+  }
+  return "Box<$name>";
+}
+
+main() {
+  for (int round = 0; round < 3; round++) {
+    boxes.clear();
+    nest<int>(100);
+    Expect.equals(101, boxes.length);
+    for (int i = 0; i < boxes.length; i++) {
+      Expect.equals(expectedName(i), boxes[i].runtimeType.toString());
+    }
+  }
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--jit_code_cache_size=1
+// VMOptions=--jit_code_cache_size=1 --optimization_counter_threshold=10 --no-background-compilation
+// VMOptions=--collect_code --optimization_counter_threshold=10
+
+// Verify that functions keep working when their code is evicted from the JIT
+// code cache and compiled again.
+
+import "package:expect/expect.dart";
+
+abstract class Shape {
+  double get area;
+}
+
+class Square extends Shape {
+  final double side;
+  Square(this.side);
+  double get area => side * side;
+}
+
+class Rectangle extends Shape {
+  final double width;
+  final double height;
+  Rectangle(this.width, this.height);
+  double get area => width * height;
+}
+
+double totalArea(List<Shape> shapes) {
+  double total = 0.0;
+  for (final shape in shapes) {
+    total += shape.area;
+  }
+  return total;
+}
+
+int fib(int n) => n < 2 ? n : fib(n - 1) + fib(n - 2);
+
+// Large arrays are allocated in old space, so this causes old space GCs,
+// after which the code is aged.
+int allocate() {
+  int length = 0;
+  for (int i = 0; i < 100; i++) {
+    length += new List(100000).length;
+  }
+  return length;
+}
+
+main() {
+  final shapes = <Shape>[new Square(2.0), new Rectangle(2.0, 3.0)];
+  for (int i = 0; i < 20; i++) {
+    Expect.equals(10.0, totalArea(shapes));
+    Expect.equals(55, fib(10));
+    Expect.equals(10000000, allocate());
+  }
+}
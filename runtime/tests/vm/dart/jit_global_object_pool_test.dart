@@ -0,0 +1,57 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--jit_global_object_pool
+// VMOptions=--jit_global_object_pool --optimization_counter_threshold=10 --no-background-compilation
+
+// Run code that calls, patches call sites, deoptimizes and throws while JIT
+// compiled functions share their object pool.
+
+import "package:expect/expect.dart";
+
+abstract class Shape {
+  double get area;
+}
+
+class Square extends Shape {
+  final double side;
+  Square(this.side);
+  double get area => side * side;
+}
+
+class Rectangle extends Shape {
+  final double width, height;
+  Rectangle(this.width, this.height);
+  double get area => width * height;
+}
+
+double totalArea(List<Shape> shapes) {
+  double total = 0.0;
+  for (final shape in shapes) {
+    total += shape.area;
+  }
+  return total;
+}
+
+String describe(Object value) {
+  try {
+    return "value " + (value as String);
+  } on CastError {
+    return "not a string";
+  }
+}
+
+main() {
+  final squares = new List<Shape>.generate(20, (i) => new Square(2.0));
+  for (int i = 0; i < 50; i++) {
+    Expect.equals(80.0, totalArea(squares));
+    Expect.equals("value a", describe("a"));
+  }
+  // A new receiver class and a failing cast deoptimize the code above.
+  final mixed = <Shape>[new Square(1.0), new Rectangle(2.0, 3.0)];
+  for (int i = 0; i < 50; i++) {
+    Expect.equals(7.0, totalArea(mixed));
+    Expect.equals("not a string", describe(i));
+  }
+}
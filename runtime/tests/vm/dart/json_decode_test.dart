@@ -0,0 +1,65 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Verify that JSON decoded by the native parser, which builds the maps
+// itself, gives the same values as the Dart parser, and that the maps can
+// be used and modified like any other.
+
+import "dart:convert";
+
+import "package:expect/expect.dart";
+
+// A reviver makes jsonDecode use the Dart parser.
+dynamic decodeInDart(String text) => jsonDecode(text, reviver: (k, v) => v);
+
+void testSame(String text) {
+  final native = jsonDecode(text);
+  Expect.deepEquals(decodeInDart(text), native);
+}
+
+void testMaps() {
+  final keys = new List<String>.generate(100, (i) => "key$i");
+  final text = "{" +
+      keys.map((key) => '"$key": "$key"').join(", ") +
+      ', "key0": 0, "": 1}';
+  final Map<String, dynamic> map = jsonDecode(text);
+  Expect.equals(101, map.length);
+  Expect.equals(0, map["key0"]);
+  Expect.equals(1, map[""]);
+  for (int i = 1; i < keys.length; i++) {
+    Expect.equals(keys[i], map[keys[i]]);
+  }
+  Expect.listEquals(["key0", "key1", "key2"], map.keys.take(3).toList());
+  Expect.isNull(map["missing"]);
+  Expect.isFalse(map.containsKey("key100"));
+
+  for (int i = 0; i < 50; i++) {
+    Expect.equals(keys[i + 50], map.remove(keys[i + 50]));
+    map["new$i"] = i;
+  }
+  Expect.equals(101, map.length);
+  Expect.equals(49, map["new49"]);
+  Expect.isFalse(map.containsKey("key50"));
+  Expect.equals("key49", map["key49"]);
+
+  final Map<String, dynamic> empty = jsonDecode("{}");
+  empty["a"] = 1;
+  Expect.equals(1, empty["a"]);
+  Expect.isTrue(empty is Map<String, dynamic>);
+}
+
+main() {
+  testSame('{"a": [1, -0, 2.5, -1e400, 1E2, 9223372036854775808], "b": {}}');
+  testSame('["\\u00e9\\u20ac\\ud800", "\\"\\\\\\/\\b\\f\\n\\r\\t", "ÿ"]');
+  testSame(' [true, false, null, [], [[]], {"x": {"x": {"x": null}}}] ');
+  testSame('{"a": 1, "b": 2, "a": 3}');
+  testMaps();
+
+  Expect.throwsFormatException(() => jsonDecode("[1, 2,]"));
+  Expect.throwsFormatException(() => jsonDecode('{"a": 01}'));
+  Expect.throwsFormatException(() => jsonDecode('"\t"'));
+  Expect.isNull(jsonDecode(" null "));
+  final deep = "[" * 1000 + "]" * 1000;
+  Expect.isTrue(jsonDecode(deep) is List);
+}
@@ -0,0 +1,38 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--max_stack_trace_depth=5
+
+// Verify that captured stack traces keep only the innermost frames when
+// their depth is limited.
+
+import "package:expect/expect.dart";
+
+int countFrames(StackTrace trace) =>
+    trace.toString().split("\n").where((line) => line.startsWith("#")).length;
+
+StackTrace captureAt(int depth) {
+  if (depth == 0) return StackTrace.current;
+  return captureAt(depth - 1);
+}
+
+void throwAt(int depth) {
+  if (depth == 0) throw new FormatException("bottom");
+  throwAt(depth - 1);
+}
+
+main() {
+  final trace = captureAt(20);
+  Expect.equals(5, countFrames(trace));
+  Expect.isTrue(trace.toString().contains("captureAt"));
+
+  try {
+    throwAt(20);
+  } catch (e, st) {
+    Expect.equals(5, countFrames(st));
+    Expect.isTrue(st.toString().contains("throwAt"));
+  }
+
+  Expect.isTrue(countFrames(captureAt(2)) <= 5);
+}
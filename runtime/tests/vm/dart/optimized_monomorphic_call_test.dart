@@ -0,0 +1,48 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--opt_monomorphic_calls --optimization_counter_threshold=10 --no-background-compilation
+
+// Verify that calls from optimized code that switched to the monomorphic
+// state go back to the IC stub when they see another receiver class.
+
+import "package:expect/expect.dart";
+
+class A {
+  int foo(int x) => x + 1;
+}
+
+class B extends A {
+  int foo(int x) => x + 2;
+}
+
+class C {
+  int foo(int x) => x + 3;
+}
+
+// The call has no type feedback when the function is optimized, so optimized
+// code calls it through the IC stub.
+@pragma('vm:never-inline')
+int call(bool take, dynamic receiver, int x) {
+  if (take) {
+    return receiver.foo(x);
+  }
+  return x;
+}
+
+main() {
+  for (int i = 0; i < 100; i++) {
+    Expect.equals(i, call(false, null, i));
+  }
+  final a = new A();
+  for (int i = 0; i < 100; i++) {
+    Expect.equals(i + 1, call(true, a, i));
+  }
+  Expect.equals(2, call(true, new B(), 0));
+  Expect.equals(3, call(true, new C(), 0));
+  for (int i = 0; i < 100; i++) {
+    Expect.equals(i + 1, call(true, a, i));
+    Expect.equals(i + 3, call(true, new C(), i));
+  }
+}
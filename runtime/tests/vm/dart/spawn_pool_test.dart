@@ -0,0 +1,30 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+// VMOptions=--isolate_spawn_pool_size=2
+
+// Verify that isolates spawned from a pool of pre-initialized isolates run
+// their entry point with fresh statics, and that the VM shuts down cleanly
+// with isolates left in the pool.
+
+import 'dart:async';
+import 'dart:isolate';
+
+import "package:expect/expect.dart";
+
+int counter = 0;
+
+void child(SendPort replyPort) {
+  counter++;
+  replyPort.send(counter);
+}
+
+Future<void> main() async {
+  for (int i = 0; i < 10; i++) {
+    final port = new ReceivePort();
+    await Isolate.spawn(child, port.sendPort);
+    Expect.equals(1, await port.first);
+  }
+  // The parent's statics are not shared with its children either.
+  Expect.equals(0, counter);
+}
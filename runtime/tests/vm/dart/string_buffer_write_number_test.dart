@@ -0,0 +1,81 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Verify that StringBuffer.write formats numbers like their toString, also
+// when the numbers straddle the end of its internal buffer, and that mints
+// format like smis. JSON encoding writes its numbers this way.
+
+import "dart:convert";
+
+import "package:expect/expect.dart";
+
+const ints = const [
+  0,
+  7,
+  -7,
+  99,
+  -100,
+  12345,
+  -1073741824,
+  1073741824,
+  4611686018427387903,
+  -4611686018427387904,
+  9223372036854775807,
+  -9223372036854775808,
+];
+
+const doubles = const [
+  0.0,
+  -0.0,
+  1.0,
+  -1.5,
+  0.1,
+  1e21,
+  123456789012345680000.0,
+  -0.0000012345678901234567,
+  1.2345678901234567e-308,
+  double.maxFinite,
+  double.minPositive,
+  double.infinity,
+  double.negativeInfinity,
+  double.nan,
+];
+
+String naive(int value) {
+  if (value == 0) return "0";
+  final digits = <int>[];
+  final bool negative = value < 0;
+  while (value != 0) {
+    digits.add(0x30 + (value.remainder(10)).abs());
+    value = value ~/ 10;
+  }
+  if (negative) digits.add(0x2d);
+  return new String.fromCharCodes(digits.reversed);
+}
+
+main() {
+  for (final value in ints) {
+    Expect.equals(naive(value), value.toString());
+    Expect.equals(naive(value), (new StringBuffer()..write(value)).toString());
+  }
+  for (int i = 0; i < 64; i++) {
+    final prefix = "x" * i;
+    final expected = new StringBuffer(prefix);
+    final buffer = new StringBuffer(prefix);
+    for (final value in ints) {
+      expected.write(value.toString());
+      buffer.write(value);
+    }
+    for (final value in doubles) {
+      expected.write(value.toString());
+      buffer.write(value);
+      buffer.writeCharCode(0x20AC);
+      expected.write("€");
+    }
+    Expect.equals(expected.toString(), buffer.toString());
+    Expect.equals(expected.length, buffer.length);
+  }
+  Expect.equals("[1,-2.5,9223372036854775807]",
+      json.encode([1, -2.5, 9223372036854775807]));
+}
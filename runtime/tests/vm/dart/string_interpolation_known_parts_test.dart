@@ -0,0 +1,58 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--optimization_counter_threshold=10 --no-background-compilation
+
+// Verify that interpolations of strings, numbers, booleans and null, which
+// optimized code concatenates without calling toString, produce the same
+// strings as toString.
+
+import "package:expect/expect.dart";
+
+String interpolateInt(String prefix, int i) => "$prefix$i!";
+
+String interpolateDouble(String prefix, double d) => "$prefix$d!";
+
+String interpolateMixed(String s, int i, double d, bool b) => "$s:$i:$d:$b";
+
+String interpolateStrings(String a, String b) => "$a$b";
+
+main() {
+  const ints = const <int>[
+    0,
+    -1,
+    99,
+    -100,
+    1 << 40,
+    -(1 << 62),
+    0x7fffffffffffffff,
+    null,
+  ];
+  const doubles = const <double>[
+    0.0,
+    -0.0,
+    0.1,
+    1e21,
+    -1.5e-7,
+    double.nan,
+    double.infinity,
+    double.negativeInfinity,
+    null,
+  ];
+  for (int k = 0; k < 20; k++) {
+    for (final i in ints) {
+      Expect.equals("a${i.toString()}!", interpolateInt("a", i));
+      Expect.equals(
+          "\u{1F600}${i.toString()}!", interpolateInt("\u{1F600}", i));
+    }
+    for (final d in doubles) {
+      Expect.equals("\xe9${d.toString()}!", interpolateDouble("\xe9", d));
+    }
+    Expect.equals("x:1:2.5:true", interpolateMixed("x", 1, 2.5, true));
+    Expect.equals(
+        "null:null:null:null", interpolateMixed(null, null, null, null));
+    Expect.equals("", interpolateStrings("", ""));
+    Expect.equals("ab\u0100", interpolateStrings("ab", "\u0100"));
+  }
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Verify that type checks at a site seeing many different instance types,
+// whose subtype test cache becomes a hash table, keep giving the right
+// answers.
+
+import "package:expect/expect.dart";
+
+class Box<T> {}
+
+class Other<T> {}
+
+bool isBoxOfNum(Object o) => o is Box<num>;
+
+Box<num> asBoxOfNum(Object o) => o as Box<num>;
+
+Box<Object> nest(int depth) =>
+    depth == 0 ? new Box<int>() : nestIn<Box<Object>>(depth - 1);
+
+Box<Object> nestIn<T>(int depth) =>
+    depth == 0 ? new Box<T>() : nestIn<Box<T>>(depth - 1);
+
+main() {
+  final boxes = <Object>[];
+  final others = <Object>[];
+  for (int i = 0; i < 40; i++) {
+    boxes.add(nest(i));
+  }
+  others.addAll([new Box<String>(), new Other<int>(), 1, "a", new Box()]);
+
+  for (int round = 0; round < 3; round++) {
+    Expect.isTrue(isBoxOfNum(boxes[0]));
+    Expect.identical(boxes[0], asBoxOfNum(boxes[0]));
+    for (int i = 1; i < boxes.length; i++) {
+      Expect.isFalse(isBoxOfNum(boxes[i]));
+      Expect.throwsCastError(() => asBoxOfNum(boxes[i]));
+    }
+    for (final other in others) {
+      Expect.isFalse(isBoxOfNum(other));
+    }
+    Expect.isTrue(isBoxOfNum(new Box<double>()));
+    Expect.isTrue(isBoxOfNum(new Box<num>()));
+  }
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--optimization-counter-threshold=10 --no-background-compilation
+
+// Tests type testing stubs for instantiated types of implemented generic
+// classes (e.g. `List<Foo>`), where only some implementations store the type
+// arguments in the same way as the implemented class.
+
+import 'dart:collection';
+
+import "package:expect/expect.dart";
+
+class Foo {}
+
+class Bar extends Foo {}
+
+// Stores the type argument of [List] at a different position.
+class SwappedList<A, B> extends ListBase<B> {
+  final List<B> _list = <B>[];
+
+  int get length => _list.length;
+  set length(int value) => _list.length = value;
+  B operator [](int index) => _list[index];
+  void operator []=(int index, B value) => _list[index] = value;
+}
+
+// Implements [List] without having any type arguments.
+class FooList extends ListBase<Foo> {
+  final List<Foo> _list = <Foo>[];
+
+  int get length => _list.length;
+  set length(int value) => _list.length = value;
+  Foo operator [](int index) => _list[index];
+  void operator []=(int index, Foo value) => _list[index] = value;
+}
+
+@pragma('vm:never-inline')
+List<Foo> asListOfFoo(Object o) => o as List<Foo>;
+
+@pragma('vm:never-inline')
+Map<String, int> asMapOfStringToInt(Object o) => o as Map<String, int>;
+
+void expectCastSucceeds(Object o) {
+  Expect.identical(o, asListOfFoo(o));
+}
+
+void expectCastFails(Object o) {
+  Expect.throwsCastError(() => asListOfFoo(o));
+}
+
+main() {
+  for (int i = 0; i < 50; i++) {
+    expectCastSucceeds(<Foo>[]);
+    expectCastSucceeds(<Bar>[]);
+    expectCastSucceeds(new List<Foo>(1));
+    expectCastSucceeds(new List<Bar>.unmodifiable([]));
+    expectCastSucceeds(new SwappedList<int, Foo>());
+    expectCastSucceeds(new SwappedList<int, Bar>());
+    expectCastSucceeds(new FooList());
+    expectCastSucceeds(null);
+
+    expectCastFails(<int>[]);
+    expectCastFails(<Object>[]);
+    expectCastFails(new List<int>(1));
+    expectCastFails(new SwappedList<Foo, int>());
+    expectCastFails(new Foo());
+    expectCastFails(1);
+
+    final map = <String, int>{'a': 1};
+    Expect.identical(map, asMapOfStringToInt(map));
+    Expect.throwsCastError(() => asMapOfStringToInt(<String, String>{}));
+    Expect.throwsCastError(() => asMapOfStringToInt(<int, int>{}));
+  }
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--optimization_counter_threshold=10 --no-background-compilation
+
+// Verify that setRange between typed lists of the same element size copies
+// the same elements before and after it is optimized, including between
+// overlapping ranges of one buffer and through views.
+
+import "dart:typed_data";
+
+import "package:expect/expect.dart";
+
+// Copies through a plain list, as setRange must behave.
+void expectedSetRange(List list, int start, int end, List from, int skip) {
+  final copy = new List.from(from.sublist(skip, skip + end - start));
+  for (int i = start; i < end; i++) {
+    list[i] = copy[i - start];
+  }
+}
+
+void testOverlap(List<int> create(ByteBuffer buffer, int offset, int length)) {
+  final buffer = new Uint8List(128).buffer;
+  final list = create(buffer, 0, 16);
+  for (int start = 0; start < 8; start++) {
+    for (int skip = 0; skip < 8; skip++) {
+      for (int i = 0; i < list.length; i++) {
+        list[i] = i + 1;
+      }
+      final expected = new List<int>.from(list);
+      expectedSetRange(expected, start, start + 8, list, skip);
+      list.setRange(start, start + 8, list, skip);
+      Expect.listEquals(expected, list);
+    }
+  }
+  // A view of the same buffer starting at the fifth element.
+  final size = (list as TypedData).elementSizeInBytes;
+  final view = create(buffer, 4 * size, 8);
+  for (int i = 0; i < list.length; i++) {
+    list[i] = i + 1;
+  }
+  final expected = new List<int>.from(list);
+  expectedSetRange(expected, 0, 8, expected, 4);
+  list.setRange(0, 8, view);
+  Expect.listEquals(expected, list);
+}
+
+void testDoubles() {
+  final a = new Float64List.fromList([1.0, 2.0, 3.0, 4.0, 5.0]);
+  a.setRange(1, 5, a);
+  Expect.listEquals([1.0, 1.0, 2.0, 3.0, 4.0], a);
+  final b = new Float32List.fromList([1.0, 2.0, 3.0, 4.0, 5.0]);
+  b.setRange(0, 4, b, 1);
+  Expect.listEquals([2.0, 3.0, 4.0, 5.0, 5.0], b);
+}
+
+void testSimd() {
+  final a = new Float32x4List(4);
+  for (int i = 0; i < a.length; i++) {
+    a[i] = new Float32x4.splat(i.toDouble());
+  }
+  a.setRange(1, 4, a);
+  Expect.equals(0.0, a[0].x);
+  Expect.equals(0.0, a[1].y);
+  Expect.equals(1.0, a[2].z);
+  Expect.equals(2.0, a[3].w);
+}
+
+void testClamped() {
+  final from = new Int8List.fromList([-1, 5, 127, -128]);
+  final to = new Uint8ClampedList(4);
+  to.setRange(0, 4, from);
+  Expect.listEquals([0, 5, 127, 0], to);
+}
+
+main() {
+  for (int i = 0; i < 20; i++) {
+    testOverlap((b, o, l) => new Uint8List.view(b, o, l));
+    testOverlap((b, o, l) => new Int16List.view(b, o, l));
+    testOverlap((b, o, l) => new Uint32List.view(b, o, l));
+    testOverlap((b, o, l) => new Int64List.view(b, o, l));
+    testDoubles();
+    testSimd();
+    testClamped();
+  }
+}
@@ -0,0 +1,49 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Verify that UTF-8 decoding of Uint8Lists, which the VM does natively,
+// agrees with decoding the same bytes from a plain list.
+
+import "dart:convert";
+import "dart:typed_data";
+
+import "package:expect/expect.dart";
+
+void check(List<int> bytes, {bool allowMalformed: false}) {
+  final decoder = new Utf8Decoder(allowMalformed: allowMalformed);
+  final expected = decoder.convert(new List<int>.from(bytes));
+  final list = new Uint8List.fromList(bytes);
+  Expect.equals(expected, decoder.convert(list));
+
+  final padded = new Uint8List(bytes.length + 6)
+    ..setRange(3, 3 + bytes.length, bytes);
+  Expect.equals(expected, decoder.convert(padded, 3, 3 + bytes.length));
+  final view = new Uint8List.view(padded.buffer, 3, bytes.length);
+  Expect.equals(expected, decoder.convert(view));
+
+  // Chunked decoding scans ASCII runs natively.
+  final buffer = new StringBuffer();
+  final sink = decoder.startChunkedConversion(
+      new StringConversionSink.fromStringSink(buffer));
+  sink.addSlice(list, 0, list.length ~/ 2, false);
+  sink.addSlice(list, list.length ~/ 2, list.length, true);
+  Expect.equals(expected, buffer.toString());
+}
+
+void main() {
+  final ascii = new List<int>.generate(200, (i) => 0x20 + i % 0x5F);
+  check([]);
+  check(ascii);
+  check([0xEF, 0xBB, 0xBF]..addAll(ascii));
+  check(ascii.sublist(0, 100)..addAll([0xC3, 0xA9])..addAll(ascii));
+  check(ascii.sublist(0, 70)..addAll([0xE2, 0x82, 0xAC])..addAll(ascii));
+  check(ascii.sublist(0, 90)..addAll([0xF0, 0x9F, 0x98, 0x80]));
+
+  final malformed = ascii.sublist(0, 80)..addAll([0xC3])..addAll(ascii);
+  check(malformed, allowMalformed: true);
+  Expect.throws(() => utf8.decode(new Uint8List.fromList(malformed)),
+      (e) => e is FormatException);
+  Expect.throws(() => utf8.decode(new Uint8List(4), 3, 5),
+      (e) => e is RangeError);
+}
@@ -0,0 +1,140 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+# for details. All rights reserved. Use of this source code is governed by a
+# BSD-style license that can be found in the LICENSE file.
+
+"""
+Symbolize stack traces printed by AOT snapshots run with --dwarf_stack_traces.
+
+Such traces only carry the offsets of the return addresses in the snapshot and
+its build ID, e.g.
+
+    #00 pc 0000000000161a2b  /data/app/libapp.so (BuildId: 6a2f...)
+
+so that the snapshot can be shipped stripped of its DWARF information. This
+tool maps the offsets back to functions, files and lines using the unstripped
+snapshot written by gen_snapshot with --dwarf_stack_traces, and checks that
+its build ID matches the one in the trace.
+
+Usage:
+  dwarf_symbolize.py --debug-info=app.so.unstripped < trace.txt
+"""
+
+import optparse
+import re
+import struct
+import subprocess
+import sys
+
+FRAME_RE = re.compile(
+    r'^(?P<prefix>\s*#(?P<index>\d+) pc )(?P<pc>[0-9a-fA-F]+)  (?P<dso>\S+)'
+    r'(?: \(BuildId: (?P<build_id>[0-9a-f]+)\))?\s*$')
+
+SHT_NOTE = 7
+NT_GNU_BUILD_ID = 3
+
+
+def BuildOptions():
+  result = optparse.OptionParser()
+  result.add_option(
+      "--debug-info",
+      help="The unstripped ELF snapshot holding the DWARF information.")
+  result.add_option(
+      "--addr2line",
+      help="The addr2line tool for the architecture of the snapshot.",
+      default="addr2line")
+  result.add_option(
+      "--ignore-build-id",
+      help="Symbolize frames whose build ID does not match the snapshot.",
+      default=False, action="store_true")
+  return result
+
+
+def ReadBuildId(path):
+  """Returns the GNU build ID of the ELF file at path in hex, or None."""
+  with open(path, 'rb') as f:
+    data = f.read()
+  if data[:4] != b'\x7fELF':
+    raise Exception("%s is not an ELF file" % path)
+  is_64_bit = ord(data[4:5]) == 2
+  if is_64_bit:
+    shoff, = struct.unpack_from('<Q', data, 0x28)
+    shentsize, shnum = struct.unpack_from('<HH', data, 0x3a)
+  else:
+    shoff, = struct.unpack_from('<I', data, 0x20)
+    shentsize, shnum = struct.unpack_from('<HH', data, 0x2e)
+  for i in range(shnum):
+    header = shoff + i * shentsize
+    sh_type, = struct.unpack_from('<I', data, header + 4)
+    if sh_type != SHT_NOTE:
+      continue
+    if is_64_bit:
+      offset, size = struct.unpack_from('<QQ', data, header + 0x18)
+    else:
+      offset, size = struct.unpack_from('<II', data, header + 0x10)
+    note = offset
+    while note + 12 <= offset + size:
+      namesz, descsz, note_type = struct.unpack_from('<III', data, note)
+      name = note + 12
+      desc = name + ((namesz + 3) & ~3)
+      if note_type == NT_GNU_BUILD_ID and data[name:name + namesz] == b'GNU\0':
+        return ''.join('%02x' % b for b in bytearray(data[desc:desc + descsz]))
+      note = desc + ((descsz + 3) & ~3)
+  return None
+
+
+def Symbolize(addr2line, debug_info, pcs):
+  """Returns the inlined frames of each pc as lists of (function, location)."""
+  if not pcs:
+    return []
+  # With -a, the frames of each address are preceded by the address itself.
+  args = [addr2line, '-a', '-f', '-i', '-C', '-e', debug_info]
+  args.extend('0x%x' % pc for pc in pcs)
+  output = subprocess.check_output(args).decode('utf-8').splitlines()
+  result = []
+  i = 0
+  while i < len(output):
+    if output[i].startswith('0x'):
+      result.append([])
+      i += 1
+      continue
+    result[-1].append((output[i], output[i + 1]))
+    i += 2
+  return result
+
+
+def Main():
+  parser = BuildOptions()
+  (options, args) = parser.parse_args()
+  if not options.debug_info:
+    parser.error("--debug-info is required")
+  build_id = ReadBuildId(options.debug_info)
+
+  lines = (open(args[0]) if args else sys.stdin).read().splitlines()
+  frames = []
+  for line in lines:
+    match = FRAME_RE.match(line)
+    if not match:
+      continue
+    if (not options.ignore_build_id and build_id is not None and
+        match.group('build_id') not in (None, build_id)):
+      continue
+    frames.append(int(match.group('pc'), 16))
+  symbolized = dict(zip(frames, Symbolize(options.addr2line,
+                                          options.debug_info, frames)))
+
+  for line in lines:
+    match = FRAME_RE.match(line)
+    if not match or int(match.group('pc'), 16) not in symbolized:
+      print(line)
+      continue
+    inlined = symbolized[int(match.group('pc'), 16)]
+    for function, location in inlined:
+      print('%s%s  %s  %s' % (match.group('prefix'), match.group('pc'),
+                              function, location))
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(Main())
@@ -72,4 +72,128 @@ uint8_t* DecodeBase64(Zone* zone, const char* str, intptr_t* out_decoded_len) {
   return bytes;
 }
 
+static const char kEncodeTable[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char kUrlSafeEncodeTable[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+intptr_t Base64EncodedLength(intptr_t length) {
+  return ((length + 2) / 3) * 4;
+}
+
+void EncodeBase64(const uint8_t* bytes,
+                  intptr_t length,
+                  bool url_safe,
+                  uint8_t* out) {
+  const char* table = url_safe ? kUrlSafeEncodeTable : kEncodeTable;
+  const uint8_t* end = bytes + length - (length % 3);
+  while (bytes < end) {
+    const uint32_t x = (bytes[0] << 16) | (bytes[1] << 8) | bytes[2];
+    out[0] = table[x >> 18];
+    out[1] = table[(x >> 12) & 0x3F];
+    out[2] = table[(x >> 6) & 0x3F];
+    out[3] = table[x & 0x3F];
+    bytes += 3;
+    out += 4;
+  }
+  switch (length % 3) {
+    case 1: {
+      const uint32_t x = bytes[0] << 16;
+      out[0] = table[x >> 18];
+      out[1] = table[(x >> 12) & 0x3F];
+      out[2] = PAD;
+      out[3] = PAD;
+      break;
+    }
+    case 2: {
+      const uint32_t x = (bytes[0] << 16) | (bytes[1] << 8);
+      out[0] = table[x >> 18];
+      out[1] = table[(x >> 12) & 0x3F];
+      out[2] = table[(x >> 6) & 0x3F];
+      out[3] = PAD;
+      break;
+    }
+  }
+}
+
+// Like decode_table, but without the line breaks and with the padding
+// character invalid: -1 outside both alphabets.
+static const int8_t kStrictDecodeTable[] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, 62, -1, 63,  //
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,  //
+    -1, 00, 01, 02, 03, 04, 05, 06, 07, 8,  9,  10, 11, 12, 13, 14,  //
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, 63,  //
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,  //
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,  //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+
+intptr_t Base64DecodedLength(const uint8_t* chars, intptr_t length) {
+  if ((length == 0) || ((length % 4) != 0)) {
+    return -1;
+  }
+  intptr_t pad_length = 0;
+  while ((pad_length < length) && (chars[length - 1 - pad_length] == PAD)) {
+    pad_length++;
+  }
+  if (pad_length > 2) {
+    return -1;
+  }
+  return (length / 4) * 3 - pad_length;
+}
+
+bool DecodeBase64Padded(const uint8_t* chars, intptr_t length, uint8_t* out) {
+  ASSERT(Base64DecodedLength(chars, length) >= 0);
+  const intptr_t pad_length =
+      (chars[length - 1] != PAD) ? 0 : ((chars[length - 2] != PAD) ? 1 : 2);
+  // The last block is decoded separately when it is padded.
+  const uint8_t* end = chars + length - ((pad_length != 0) ? 4 : 0);
+  while (chars < end) {
+    const int32_t a = kStrictDecodeTable[chars[0]];
+    const int32_t b = kStrictDecodeTable[chars[1]];
+    const int32_t c = kStrictDecodeTable[chars[2]];
+    const int32_t d = kStrictDecodeTable[chars[3]];
+    if ((a | b | c | d) < 0) {
+      return false;
+    }
+    const uint32_t x = (a << 18) | (b << 12) | (c << 6) | d;
+    out[0] = x >> 16;
+    out[1] = (x >> 8) & 0xFF;
+    out[2] = x & 0xFF;
+    chars += 4;
+    out += 3;
+  }
+  if (pad_length == 0) {
+    return true;
+  }
+  const int32_t a = kStrictDecodeTable[chars[0]];
+  const int32_t b = kStrictDecodeTable[chars[1]];
+  if ((a | b) < 0) {
+    return false;
+  }
+  if (pad_length == 2) {
+    if ((b & 0x0F) != 0) {
+      return false;
+    }
+    out[0] = (a << 2) | (b >> 4);
+    return true;
+  }
+  const int32_t c = kStrictDecodeTable[chars[2]];
+  if ((c < 0) || ((c & 0x03) != 0)) {
+    return false;
+  }
+  const uint32_t x = (a << 18) | (b << 12) | (c << 6);
+  out[0] = x >> 16;
+  out[1] = (x >> 8) & 0xFF;
+  return true;
+}
+
 }  // namespace dart
@@ -11,6 +11,27 @@ namespace dart {
 
 uint8_t* DecodeBase64(Zone* zone, const char* str, intptr_t* out_decoded_len);
 
+// Returns the length of the padded base64 encoding of |length| bytes.
+intptr_t Base64EncodedLength(intptr_t length);
+
+// Writes the padded base64 encoding of |length| bytes from |bytes| to |out|,
+// using the URL and filename safe alphabet if |url_safe|.
+void EncodeBase64(const uint8_t* bytes,
+                  intptr_t length,
+                  bool url_safe,
+                  uint8_t* out);
+
+// Returns the number of bytes encoded by the |length| characters of padded
+// base64 in |chars|, or -1 if the length is not a positive multiple of four
+// or there are more than two padding characters.
+intptr_t Base64DecodedLength(const uint8_t* chars, intptr_t length);
+
+// Decodes the |length| characters of padded base64 in |chars| to |out|, which
+// has room for Base64DecodedLength() bytes. Accepts both alphabets. Returns
+// false if there is a character outside them, or if the bits left over before
+// the padding are not zero.
+bool DecodeBase64Padded(const uint8_t* chars, intptr_t length, uint8_t* out);
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_BASE64_H_
@@ -29,4 +29,50 @@ TEST_CASE(Base64DecodeEmpty) {
   intptr_t decoded_len;
   EXPECT(DecodeBase64(thread->zone(), "", &decoded_len) == nullptr);
 }
+
+TEST_CASE(Base64EncodeDecodePadded) {
+  const char* expected[] = {"", "AA==", "AAE=", "AAEC", "AAECAw==", "AAECAwQ="};
+  uint8_t bytes[5] = {0, 1, 2, 3, 4};
+  for (intptr_t length = 0; length <= 5; length++) {
+    uint8_t encoded[8];
+    const intptr_t encoded_len = Base64EncodedLength(length);
+    EXPECT_EQ(static_cast<intptr_t>(strlen(expected[length])), encoded_len);
+    EncodeBase64(bytes, length, false, encoded);
+    EXPECT(!memcmp(expected[length], encoded, encoded_len));
+    if (length == 0) continue;
+    EXPECT_EQ(length, Base64DecodedLength(encoded, encoded_len));
+    uint8_t decoded[5];
+    EXPECT(DecodeBase64Padded(encoded, encoded_len, decoded));
+    EXPECT(!memcmp(bytes, decoded, length));
+  }
+
+  const uint8_t url_bytes[] = {0xFB, 0xFF};
+  uint8_t encoded[4];
+  EncodeBase64(url_bytes, 2, true, encoded);
+  EXPECT(!memcmp("-_8=", encoded, 4));
+  EncodeBase64(url_bytes, 2, false, encoded);
+  EXPECT(!memcmp("+/8=", encoded, 4));
+
+  // Both alphabets are accepted.
+  uint8_t decoded[3];
+  EXPECT(DecodeBase64Padded(reinterpret_cast<const uint8_t*>("-/8="), 4,
+                            decoded));
+  EXPECT_EQ(0xFB, decoded[0]);
+  EXPECT_EQ(0xFF, decoded[1]);
+}
+
+TEST_CASE(Base64DecodePaddedMalformed) {
+  // "AB==" leaves non-zero bits before the padding.
+  const char* malformed[] = {"A===", "AB=C", "AB*D",
+                             "AB\xC3\xA9", "AB%3D", "AB=="};
+  uint8_t decoded[3];
+  for (intptr_t i = 0; i < 6; i++) {
+    const uint8_t* chars = reinterpret_cast<const uint8_t*>(malformed[i]);
+    const intptr_t length = strlen(malformed[i]);
+    const intptr_t decoded_len = Base64DecodedLength(chars, length);
+    EXPECT((decoded_len < 0) || !DecodeBase64Padded(chars, length, decoded));
+  }
+  const uint8_t* unpadded = reinterpret_cast<const uint8_t*>("ABC");
+  EXPECT_EQ(-1, Base64DecodedLength(unpadded, 3));
+}
 }  // namespace dart
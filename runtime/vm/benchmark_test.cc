@@ -4,6 +4,12 @@
 
 #include "vm/benchmark_test.h"
 
+#if defined(HOST_OS_LINUX)
+#include <sched.h>  // NOLINT
+#endif
+
+#include <math.h>
+
 #include "bin/builtin.h"
 #include "bin/file.h"
 #include "bin/isolate_data.h"
@@ -12,11 +18,18 @@
 
 #include "platform/assert.h"
 #include "platform/globals.h"
+#include "platform/unicode.h"
 
 #include "vm/clustered_snapshot.h"
+#include "vm/compiler/jit/compiler.h"
+#include "vm/cpu.h"
 #include "vm/dart_api_impl.h"
+#include "vm/os.h"
+#include "vm/program_visitor.h"
 #include "vm/stack_frame.h"
+#include "vm/startup_phases.h"
 #include "vm/timer.h"
+#include "vm/version.h"
 
 using dart::bin::File;
 
@@ -25,6 +38,211 @@ namespace dart {
 Benchmark* Benchmark::first_ = NULL;
 Benchmark* Benchmark::tail_ = NULL;
 const char* Benchmark::executable_ = NULL;
+intptr_t Benchmark::num_regressions_ = 0;
+
+DEFINE_FLAG(int,
+            benchmark_warmup_runs,
+            0,
+            "Number of benchmark runs whose scores are discarded.");
+DEFINE_FLAG(int,
+            benchmark_runs,
+            1,
+            "Number of benchmark runs whose scores are summarized.");
+DEFINE_FLAG(charp,
+            benchmark_json,
+            NULL,
+            "Append a JSON summary of each benchmark to the given file.");
+DEFINE_FLAG(charp,
+            benchmark_baseline,
+            NULL,
+            "Compare benchmark scores with a file written by "
+            "--benchmark_json and report significant regressions.");
+DEFINE_FLAG(int,
+            benchmark_regression_threshold,
+            2,
+            "Smallest slowdown in percent that --benchmark_baseline reports.");
+#if defined(HOST_OS_LINUX)
+DEFINE_FLAG(int,
+            benchmark_cpu,
+            -1,
+            "Pin the benchmarks to the given CPU to reduce noise.");
+#endif
+
+// Summary of the scores of the runs of a benchmark. All scores are costs, so
+// lower is better.
+struct BenchmarkSummary {
+  intptr_t runs;
+  int64_t min;
+  int64_t max;
+  double median;
+  double stddev;
+};
+
+static int CompareScores(const void* a, const void* b) {
+  const int64_t left = *reinterpret_cast<const int64_t*>(a);
+  const int64_t right = *reinterpret_cast<const int64_t*>(b);
+  if (left < right) return -1;
+  if (left > right) return 1;
+  return 0;
+}
+
+static void Summarize(int64_t* scores,
+                      intptr_t runs,
+                      BenchmarkSummary* summary) {
+  ASSERT(runs > 0);
+  qsort(scores, runs, sizeof(int64_t), CompareScores);
+  summary->runs = runs;
+  summary->min = scores[0];
+  summary->max = scores[runs - 1];
+  summary->median = ((runs % 2) == 1) ? scores[runs / 2]
+                                      : (scores[runs / 2 - 1] / 2.0 +
+                                         scores[runs / 2] / 2.0);
+  double mean = 0.0;
+  for (intptr_t i = 0; i < runs; i++) {
+    mean += static_cast<double>(scores[i]) / runs;
+  }
+  double variance = 0.0;
+  for (intptr_t i = 0; i < runs; i++) {
+    const double delta = scores[i] - mean;
+    variance += delta * delta;
+  }
+  summary->stddev = (runs > 1) ? sqrt(variance / (runs - 1)) : 0.0;
+}
+
+// Reads the summary of the given benchmark from the --benchmark_baseline
+// file, which holds the lines written by WriteJson. Later lines win.
+static bool ReadBaseline(const char* name,
+                         const char* kind,
+                         BenchmarkSummary* summary) {
+  File* file = File::Open(NULL, FLAG_benchmark_baseline, File::kRead);
+  if (file == NULL) {
+    Syslog::PrintErr("Cannot open benchmark baseline %s\n",
+                     FLAG_benchmark_baseline);
+    return false;
+  }
+  bin::RefCntReleaseScope<File> rs(file);
+  const int64_t length = file->Length();
+  char* contents = reinterpret_cast<char*>(malloc(length + 1));
+  if (!file->ReadFully(contents, length)) {
+    free(contents);
+    return false;
+  }
+  contents[length] = '\0';
+
+  bool found = false;
+  char* line = contents;
+  while (line != NULL) {
+    char* end = strchr(line, '\n');
+    if (end != NULL) *end = '\0';
+    char line_name[256];
+    char line_kind[64];
+    BenchmarkSummary line_summary;
+    if ((sscanf(line,
+                "{\"name\": \"%255[^\"]\", \"kind\": \"%63[^\"]\", "
+                "\"runs\": %" SCNdPTR ", \"min\": %" SCNd64
+                ", \"max\": %" SCNd64 ", \"median\": %lf, "
+                "\"stddev\": %lf",
+                line_name, line_kind, &line_summary.runs, &line_summary.min,
+                &line_summary.max, &line_summary.median,
+                &line_summary.stddev) == 7) &&
+        (strcmp(line_name, name) == 0) && (strcmp(line_kind, kind) == 0)) {
+      *summary = line_summary;
+      found = true;
+    }
+    line = (end != NULL) ? end + 1 : NULL;
+  }
+  free(contents);
+  return found;
+}
+
+static void WriteJson(const char* name,
+                      const char* kind,
+                      const BenchmarkSummary& summary) {
+  File* file = File::Open(NULL, FLAG_benchmark_json, File::kWrite);
+  if (file == NULL) {
+    Syslog::PrintErr("Cannot open %s\n", FLAG_benchmark_json);
+    return;
+  }
+  bin::RefCntReleaseScope<File> rs(file);
+  file->SetPosition(file->Length());
+  file->Print("{\"name\": \"%s\", \"kind\": \"%s\", \"runs\": %" Pd
+              ", \"min\": %" Pd64 ", \"max\": %" Pd64
+              ", \"median\": %.1f, \"stddev\": %.2f, \"os\": \"%s\", "
+              "\"cpu\": \"%s\", \"processors\": %d, "
+              "\"version\": \"%s\"}\n",
+              name, kind, summary.runs, summary.min, summary.max,
+              summary.median, summary.stddev, OS::Name(), CPU::Id(),
+              OS::NumberOfAvailableProcessors(), Version::String());
+}
+
+// A score is a regression if its median is more than the threshold worse
+// than the baseline's, and the difference is larger than twice the standard
+// error of the difference of the means, which approximates a one-sided test
+// at the 97.5% level.
+static bool IsRegression(const BenchmarkSummary& baseline,
+                         const BenchmarkSummary& current) {
+  const double difference = current.median - baseline.median;
+  if (difference * 100 <=
+      baseline.median * FLAG_benchmark_regression_threshold) {
+    return false;
+  }
+  const double standard_error =
+      sqrt(current.stddev * current.stddev / current.runs +
+           baseline.stddev * baseline.stddev / baseline.runs);
+  return difference > 2 * standard_error;
+}
+
+void Benchmark::RunAndReport() {
+#if defined(HOST_OS_LINUX)
+  if (FLAG_benchmark_cpu >= 0) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(FLAG_benchmark_cpu, &cpus);
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+      Syslog::PrintErr("Cannot pin benchmark to CPU %d\n",
+                       FLAG_benchmark_cpu);
+    }
+  }
+#endif
+  for (intptr_t i = 0; i < FLAG_benchmark_warmup_runs; i++) {
+    Run();
+  }
+  const intptr_t runs = Utils::Maximum(1, FLAG_benchmark_runs);
+  int64_t* scores = reinterpret_cast<int64_t*>(malloc(runs * sizeof(int64_t)));
+  for (intptr_t i = 0; i < runs; i++) {
+    Run();
+    scores[i] = score();
+  }
+  BenchmarkSummary summary;
+  Summarize(scores, runs, &summary);
+  free(scores);
+
+  // Keep the single line format that benchmark runners parse.
+  Syslog::Print("%s(%s): %" Pd64 "\n", name(), score_kind(),
+                static_cast<int64_t>(summary.median));
+  if (runs > 1) {
+    Syslog::Print("%s(%s) min: %" Pd64 ", max: %" Pd64
+                  ", stddev: %.2f, runs: %" Pd "\n",
+                  name(), score_kind(), summary.min, summary.max,
+                  summary.stddev, runs);
+  }
+  if (FLAG_benchmark_json != NULL) {
+    WriteJson(name(), score_kind(), summary);
+  }
+  BenchmarkSummary baseline;
+  if ((FLAG_benchmark_baseline != NULL) &&
+      ReadBaseline(name(), score_kind(), &baseline)) {
+    const bool is_regression = IsRegression(baseline, summary);
+    Syslog::Print("%s(%s) baseline: %.1f, change: %+.1f%%%s\n", name(),
+                  score_kind(), baseline.median,
+                  (summary.median - baseline.median) * 100 /
+                      Utils::Maximum(baseline.median, 1.0),
+                  is_regression ? " REGRESSION" : "");
+    if (is_regression) {
+      num_regressions_++;
+    }
+  }
+}
 
 void Benchmark::RunAll(const char* executable) {
   SetExecutable(executable);
@@ -50,7 +268,7 @@ BENCHMARK(CorelibCompileAll) {
   const Error& error =
       Error::Handle(Library::CompileAll(/*ignore_error=*/true));
   if (!error.IsNull()) {
-    OS::PrintErr("Unexpected error in CorelibCompileAll benchmark:\n%s",
+    Syslog::PrintErr("Unexpected error in CorelibCompileAll benchmark:\n%s",
                  error.ToErrorCString());
   }
   timer.Stop();
@@ -210,6 +428,44 @@ BENCHMARK(CorelibIsolateStartup) {
   Dart_EnterIsolate(reinterpret_cast<Dart_Isolate>(isolate));
 }
 
+#if !defined(PRODUCT)
+//
+// Break isolate startup down into its phases and print them as JSON: reading
+// the snapshot by cluster, loading kernel, finalizing classes and compiling
+// the first functions called.
+//
+BENCHMARK(StartupPhases) {
+  const int kNumIterations = 100;
+  const char* kScriptChars =
+      "class A {\n"
+      "  int x = 1;\n"
+      "  int get y => x + 1;\n"
+      "}\n"
+      "main() => new A().y;\n";
+  Timer timer(true, "StartupPhases");
+  Isolate* isolate = thread->isolate();
+  Dart_ExitIsolate();
+  StartupPhases::Enable();
+  for (int i = 0; i < kNumIterations; i++) {
+    timer.Start();
+    TestCase::CreateTestIsolate();
+    {
+      Dart_EnterScope();
+      Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+      EXPECT_VALID(lib);
+      EXPECT_VALID(Dart_Invoke(lib, NewString("main"), 0, NULL));
+      Dart_ExitScope();
+    }
+    timer.Stop();
+    Dart_ShutdownIsolate();
+  }
+  StartupPhases::Print();
+  StartupPhases::Disable();
+  benchmark->set_score(timer.TotalElapsedTime() / kNumIterations);
+  Dart_EnterIsolate(reinterpret_cast<Dart_Isolate>(isolate));
+}
+#endif  // !defined(PRODUCT)
+
 //
 // Measure invocation of Dart API functions.
 //
@@ -350,6 +606,40 @@ BENCHMARK(DartStringAccess) {
   benchmark->set_score(elapsed_time);
 }
 
+//
+// Measure validating and decoding mostly ASCII UTF-8 text, such as JSON, as
+// done when creating strings from UTF-8.
+BENCHMARK(Utf8Decode) {
+  const intptr_t kLength = 1 * MB;
+  const intptr_t kNumIterations = 100;
+  const char* kRecord = "{\"id\":12345,\"name\":\"caf\xC3\xA9 \xE2\x82\xAC\"},";
+  const intptr_t record_length = strlen(kRecord);
+  uint8_t* utf8 = reinterpret_cast<uint8_t*>(malloc(kLength));
+  intptr_t utf8_length = 0;
+  while ((utf8_length + record_length) <= kLength) {
+    memmove(&utf8[utf8_length], kRecord, record_length);
+    utf8_length += record_length;
+  }
+  Utf8::Type type;
+  const intptr_t utf16_length = Utf8::CodeUnitCount(utf8, utf8_length, &type);
+  EXPECT_EQ(Utf8::kBMP, type);
+  uint16_t* utf16 =
+      reinterpret_cast<uint16_t*>(malloc(utf16_length * sizeof(uint16_t)));
+
+  Timer timer(true, "Utf8Decode benchmark");
+  timer.Start();
+  for (intptr_t i = 0; i < kNumIterations; i++) {
+    EXPECT(Utf8::IsValid(utf8, utf8_length));
+    EXPECT_EQ(utf16_length, Utf8::CodeUnitCount(utf8, utf8_length, &type));
+    EXPECT(Utf8::DecodeToUTF16(utf8, utf8_length, utf16, utf16_length));
+  }
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+  free(utf16);
+  free(utf8);
+}
+
 static void vmservice_resolver(Dart_NativeArguments args) {}
 
 static Dart_NativeFunction NativeResolver(Dart_Handle name,
@@ -363,7 +653,9 @@ static Dart_NativeFunction NativeResolver(Dart_Handle name,
 //
 // Measure compile of all kernel Service(CFE) functions.
 //
-BENCHMARK(KernelServiceCompileAll) {
+// Loads the kernel service as the script of the current isolate. Returns
+// the kernel buffer, which the caller frees.
+static uint8_t* LoadKernelService() {
   bin::Builtin::SetNativeResolver(bin::Builtin::kBuiltinLibrary);
   bin::Builtin::SetNativeResolver(bin::Builtin::kIOLibrary);
   bin::Builtin::SetNativeResolver(bin::Builtin::kCLILibrary);
@@ -387,22 +679,109 @@ BENCHMARK(KernelServiceCompileAll) {
       NULL);
   result = Dart_FinalizeLoading(false);
   EXPECT_VALID(result);
+  free(dill_path);
+  return kernel_buffer;
+}
 
-  Timer timer(true, "Compile all of kernel service benchmark");
-  timer.Start();
+static void CompileAllUnoptimized() {
 #if !defined(PRODUCT)
   const bool old_flag = FLAG_background_compilation;
   FLAG_background_compilation = false;
 #endif
-  result = Dart_CompileAll();
+  Dart_Handle result = Dart_CompileAll();
 #if !defined(PRODUCT)
   FLAG_background_compilation = old_flag;
 #endif
   EXPECT_VALID(result);
+}
+
+BENCHMARK(KernelServiceCompileAll) {
+  uint8_t* kernel_buffer = LoadKernelService();
+
+  Timer timer(true, "Compile all of kernel service benchmark");
+  timer.Start();
+  CompileAllUnoptimized();
   timer.Stop();
   int64_t elapsed_time = timer.TotalElapsedTime();
   benchmark->set_score(elapsed_time);
-  free(dill_path);
+  free(kernel_buffer);
+}
+
+// Compiles every function of the program that has unoptimized code with the
+// optimizing compiler, one at a time and without type feedback. Returns the
+// time taken and sets 'code_size' to the total size of the optimized code.
+// Run with --dump_compiler_pass_stats to break the time and the IL size down
+// per compiler pass and per function.
+static int64_t CompileAllOptimized(Thread* thread, intptr_t* code_size) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+
+  class CollectFunctionsVisitor : public FunctionVisitor {
+   public:
+    explicit CollectFunctionsVisitor(const GrowableObjectArray& functions)
+        : functions_(functions) {}
+
+    void Visit(const Function& function) {
+      if (function.HasCode() && !function.HasOptimizedCode() &&
+          function.IsOptimizable()) {
+        functions_.Add(function);
+      }
+    }
+
+   private:
+    const GrowableObjectArray& functions_;
+  };
+
+  const GrowableObjectArray& functions =
+      GrowableObjectArray::Handle(GrowableObjectArray::New());
+  CollectFunctionsVisitor visitor(functions);
+  ProgramVisitor::VisitFunctions(&visitor);
+
+  Function& function = Function::Handle();
+  Object& result = Object::Handle();
+  *code_size = 0;
+  Timer timer(true, "Compile all optimized");
+  for (intptr_t i = 0; i < functions.Length(); i++) {
+    function ^= functions.At(i);
+    timer.Start();
+    result = Compiler::CompileOptimizedFunction(thread, function);
+    timer.Stop();
+    EXPECT(!result.IsError());
+    if (result.IsCode()) {
+      *code_size += Code::Cast(result).Size();
+    }
+  }
+  return timer.TotalElapsedTime();
+}
+
+BENCHMARK(CorelibCompileAllOptimized) {
+  CompileAllUnoptimized();
+  intptr_t code_size = 0;
+  benchmark->set_score(CompileAllOptimized(thread, &code_size));
+}
+
+BENCHMARK_SIZE(CorelibOptimizedCodeSize) {
+  CompileAllUnoptimized();
+  intptr_t code_size = 0;
+  CompileAllOptimized(thread, &code_size);
+  benchmark->set_score(code_size);
+}
+
+BENCHMARK(KernelServiceCompileAllOptimized) {
+  uint8_t* kernel_buffer = LoadKernelService();
+  CompileAllUnoptimized();
+  intptr_t code_size = 0;
+  benchmark->set_score(CompileAllOptimized(thread, &code_size));
+  free(kernel_buffer);
+}
+
+BENCHMARK_SIZE(KernelServiceOptimizedCodeSize) {
+  uint8_t* kernel_buffer = LoadKernelService();
+  CompileAllUnoptimized();
+  intptr_t code_size = 0;
+  CompileAllOptimized(thread, &code_size);
+  benchmark->set_score(code_size);
   free(kernel_buffer);
 }
 
@@ -704,6 +1083,36 @@ BENCHMARK(SimpleMessage) {
   benchmark->set_score(elapsed_time);
 }
 
+BENCHMARK(LargeStringMessage) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kLength = 1 * MB;
+  uint8_t* latin1 = thread->zone()->Alloc<uint8_t>(kLength);
+  for (intptr_t i = 0; i < kLength; i++) {
+    latin1[i] = 'a' + (i % 26);
+  }
+  const Array& array_object = Array::Handle(Array::New(2));
+  array_object.SetAt(0, String::Handle(String::FromLatin1(latin1, kLength)));
+  array_object.SetAt(1, Integer::Handle(Smi::New(42)));
+  const intptr_t kLoopCount = 1000;
+  Timer timer(true, "Large String Message");
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    StackZone zone(thread);
+    MessageWriter writer(true);
+    std::unique_ptr<Message> message = writer.WriteMessage(
+        array_object, ILLEGAL_PORT, Message::kNormalPriority);
+
+    // Read object back from the snapshot.
+    MessageSnapshotReader reader(message.get(), thread);
+    reader.ReadObject();
+  }
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
 BENCHMARK(LargeMap) {
   const char* kScript =
       "makeMap() {\n"
@@ -738,6 +1147,172 @@ BENCHMARK(LargeMap) {
   benchmark->set_score(elapsed_time);
 }
 
+DECLARE_FLAG(bool, concurrent_sweep);
+DECLARE_FLAG(bool, use_mark_bitmap);
+
+// Times old space GCs of a heap in which 1% of the objects survive.
+static int64_t SparseHeapGC(Thread* thread, bool use_mark_bitmap) {
+  // Pages allocated from here on get a mark bitmap if requested.
+  SetFlagScope<bool> sfs_bitmap(&FLAG_use_mark_bitmap, use_mark_bitmap);
+  SetFlagScope<bool> sfs_sweep(&FLAG_concurrent_sweep, false);
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  Heap* heap = thread->heap();
+  const intptr_t kNumObjects = 1000000;
+  const intptr_t kSurvivalRate = 100;
+  const intptr_t kLoopCount = 10;
+  const Array& survivors =
+      Array::Handle(Array::New(kNumObjects / kSurvivalRate, Heap::kOld));
+  Array& element = Array::Handle();
+  Timer timer(true, "Sparse heap GC");
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    for (intptr_t j = 0; j < kNumObjects; j++) {
+      element = Array::New(2, Heap::kOld);
+      if ((j % kSurvivalRate) == 0) {
+        survivors.SetAt(j / kSurvivalRate, element);
+      }
+    }
+    timer.Start();
+    heap->CollectGarbage(Heap::kOld);
+    timer.Stop();
+  }
+  return timer.TotalElapsedTime();
+}
+
+BENCHMARK(SparseHeapGC) {
+  benchmark->set_score(SparseHeapGC(thread, false));
+}
+
+BENCHMARK(SparseHeapGCWithMarkBitmap) {
+  benchmark->set_score(SparseHeapGC(thread, true));
+}
+
+// Shape of the synthetic heaps of the GC benchmarks below. The heap holds
+// 'num_objects' arrays of 'object_size' elements. One in 'survival_rate' of
+// them is kept alive, and 'pointer_percent' percent of the elements of each
+// survivor point to another survivor, the others hold Smis. With
+// 'weak_entries' every array has a peer in the heap's weak tables.
+struct GCBenchmarkHeap {
+  intptr_t num_objects;
+  intptr_t object_size;
+  intptr_t survival_rate;
+  intptr_t pointer_percent;
+  bool weak_entries;
+};
+
+static void AllocateGCBenchmarkHeap(Thread* thread,
+                                    const GCBenchmarkHeap& shape,
+                                    Heap::Space space,
+                                    const Array& survivors) {
+  Heap* heap = thread->heap();
+  Array& element = Array::Handle();
+  Array& previous = Array::Handle();
+  Smi& smi = Smi::Handle();
+  const intptr_t num_pointers = shape.object_size * shape.pointer_percent / 100;
+  for (intptr_t i = 0; i < shape.num_objects; i++) {
+    element = Array::New(shape.object_size, space);
+    if (shape.weak_entries) {
+      heap->SetPeer(element.raw(), reinterpret_cast<void*>(i + 1));
+    }
+    if ((i % shape.survival_rate) != 0) {
+      continue;
+    }
+    for (intptr_t j = 0; j < shape.object_size; j++) {
+      if (!previous.IsNull() && (j < num_pointers)) {
+        element.SetAt(j, previous);
+      } else {
+        smi = Smi::New(j);
+        element.SetAt(j, smi);
+      }
+    }
+    survivors.SetAt((i / shape.survival_rate) % survivors.Length(), element);
+    previous = element.raw();
+  }
+}
+
+// Returns the total pause time of 'kLoopCount' collections of the given
+// type, each of a freshly allocated heap of the given shape.
+static int64_t GCBenchmark(Thread* thread,
+                           const GCBenchmarkHeap& shape,
+                           Heap::GCType type) {
+  SetFlagScope<bool> sfs_sweep(&FLAG_concurrent_sweep, false);
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  Heap* heap = thread->heap();
+  // Keep concurrent marking out of the measured pauses.
+  const bool concurrent_mark = heap->old_space()->enable_concurrent_mark();
+  heap->old_space()->set_enable_concurrent_mark(false);
+  const intptr_t kLoopCount = 10;
+  const Heap::Space space = (type == Heap::kScavenge) ? Heap::kNew : Heap::kOld;
+  // Survivors of a scavenge must fit in new space, so they replace each
+  // other there.
+  const intptr_t num_survivors =
+      (type == Heap::kScavenge)
+          ? Utils::Minimum<intptr_t>(shape.num_objects / shape.survival_rate,
+                                     1024)
+          : shape.num_objects / shape.survival_rate;
+  const Array& survivors =
+      Array::Handle(Array::New(Utils::Maximum<intptr_t>(num_survivors, 1),
+                               Heap::kOld));
+  Timer timer(true, "GC benchmark");
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    AllocateGCBenchmarkHeap(thread, shape, space, survivors);
+    timer.Start();
+    heap->CollectGarbage(type, Heap::kFull);
+    timer.Stop();
+  }
+  heap->old_space()->set_enable_concurrent_mark(concurrent_mark);
+  return timer.TotalElapsedTime();
+}
+
+static const GCBenchmarkHeap kSmallObjects = {100000, 2, 10, 50, false};
+static const GCBenchmarkHeap kHighSurvival = {100000, 2, 2, 50, false};
+static const GCBenchmarkHeap kDensePointers = {100000, 8, 4, 100, false};
+static const GCBenchmarkHeap kWeakEntries = {100000, 2, 10, 50, true};
+static const GCBenchmarkHeap kLargeArrays = {200, 10000, 2, 10, false};
+
+BENCHMARK(GCScavengeSmallObjects) {
+  benchmark->set_score(GCBenchmark(thread, kSmallObjects, Heap::kScavenge));
+}
+
+BENCHMARK(GCScavengeHighSurvival) {
+  benchmark->set_score(GCBenchmark(thread, kHighSurvival, Heap::kScavenge));
+}
+
+BENCHMARK(GCScavengeWeakEntries) {
+  benchmark->set_score(GCBenchmark(thread, kWeakEntries, Heap::kScavenge));
+}
+
+BENCHMARK(GCMarkSweep0Tasks) {
+  SetFlagScope<int> sfs(&FLAG_marker_tasks, 0);
+  benchmark->set_score(GCBenchmark(thread, kDensePointers, Heap::kMarkSweep));
+}
+
+BENCHMARK(GCMarkSweep2Tasks) {
+  SetFlagScope<int> sfs(&FLAG_marker_tasks, 2);
+  benchmark->set_score(GCBenchmark(thread, kDensePointers, Heap::kMarkSweep));
+}
+
+BENCHMARK(GCMarkSweepAllTasks) {
+  SetFlagScope<int> sfs(&FLAG_marker_tasks,
+                        OS::NumberOfAvailableProcessors());
+  benchmark->set_score(GCBenchmark(thread, kDensePointers, Heap::kMarkSweep));
+}
+
+BENCHMARK(GCMarkSweepWeakEntries) {
+  benchmark->set_score(GCBenchmark(thread, kWeakEntries, Heap::kMarkSweep));
+}
+
+BENCHMARK(GCMarkSweepLargeArrays) {
+  benchmark->set_score(GCBenchmark(thread, kLargeArrays, Heap::kMarkSweep));
+}
+
+BENCHMARK(GCMarkCompact) {
+  benchmark->set_score(GCBenchmark(thread, kHighSurvival, Heap::kMarkCompact));
+}
+
 BENCHMARK_MEMORY(InitialRSS) {
   benchmark->set_score(bin::Process::MaxRSS());
 }
@@ -86,6 +86,16 @@ class Benchmark {
   void Run() { (*run_)(this); }
   void RunBenchmark();
 
+  // Runs the benchmark --benchmark_warmup_runs times discarding the scores,
+  // then --benchmark_runs times, and prints the median score. With more than
+  // one run the minimum, maximum and standard deviation are printed as well,
+  // the summary is appended to the --benchmark_json file and compared with
+  // the one in the --benchmark_baseline file.
+  void RunAndReport();
+
+  // Whether a benchmark score was significantly worse than the baseline.
+  static bool HasRegressions() { return num_regressions_ > 0; }
+
   static void RunAll(const char* executable);
   static void SetExecutable(const char* arg) { executable_ = arg; }
   static const char* Executable() { return executable_; }
@@ -99,6 +109,7 @@ class Benchmark {
   static Benchmark* first_;
   static Benchmark* tail_;
   static const char* executable_;
+  static intptr_t num_regressions_;
 
   RunEntry* const run_;
   const char* name_;
@@ -119,6 +119,7 @@ namespace dart {
   V(StringBase_substringUnchecked, 3)                                          \
   V(StringBase_joinReplaceAllResult, 4)                                        \
   V(StringBuffer_createStringFromUint16Array, 3)                               \
+  V(StringBuffer_writeDouble, 3)                                               \
   V(OneByteString_substringUnchecked, 3)                                       \
   V(OneByteString_splitWithCharCode, 2)                                        \
   V(OneByteString_allocate, 1)                                                 \
@@ -131,9 +132,16 @@ namespace dart {
   V(String_codeUnitAt, 2)                                                      \
   V(String_concat, 2)                                                          \
   V(String_fromEnvironment, 3)                                                 \
+  V(String_indexOf, 3)                                                         \
   V(String_toLowerCase, 1)                                                     \
   V(String_toUpperCase, 1)                                                     \
+  V(Utf8Decoder_decodeUint8List, 3)                                            \
+  V(Utf8Decoder_scanOneByteCharacters, 3)                                      \
+  V(Base64Encoder_encodeUint8List, 2)                                          \
+  V(Base64Decoder_decodeOneByteString, 3)                                      \
+  V(JsonDecoder_parseOneByteString, 1)                                         \
   V(String_concatRange, 3)                                                     \
+  V(String_interpolateKnownParts, 1)                                           \
   V(Math_sqrt, 1)                                                              \
   V(Math_sin, 1)                                                               \
   V(Math_cos, 1)                                                               \
@@ -168,10 +176,7 @@ namespace dart {
   V(Timeline_getTraceClock, 0)                                                 \
   V(Timeline_getThreadCpuClock, 0)                                             \
   V(Timeline_isDartStreamEnabled, 0)                                           \
-  V(Timeline_reportCompleteEvent, 5)                                           \
-  V(Timeline_reportFlowEvent, 7)                                               \
-  V(Timeline_reportInstantEvent, 4)                                            \
-  V(Timeline_reportTaskEvent, 6)                                               \
+  V(Timeline_reportBufferedEvents, 3)                                          \
   V(TypedData_Int8Array_new, 2)                                                \
   V(TypedData_Uint8Array_new, 2)                                               \
   V(TypedData_Uint8ClampedArray_new, 2)                                        \
@@ -383,8 +388,12 @@ namespace dart {
   V(Ffi_offsetBy, 2)                                                           \
   V(Ffi_cast, 1)                                                               \
   V(Ffi_sizeOf, 0)                                                             \
-  V(Ffi_asFunction, 1)                                                         \
+  V(Ffi_asFunction, 2)                                                         \
   V(Ffi_fromFunction, 1)                                                       \
+  V(Ffi_newAsyncCallbackQueue, 2)                                              \
+  V(Ffi_drainAsyncCallbackQueue, 1)                                            \
+  V(Ffi_asyncCallbackQueueBatch, 1)                                            \
+  V(Ffi_deleteAsyncCallbackQueue, 1)                                           \
   V(Ffi_dl_open, 1)                                                            \
   V(Ffi_dl_lookup, 2)                                                          \
   V(Ffi_dl_getHandle, 1)                                                       \
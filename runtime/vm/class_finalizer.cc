@@ -15,6 +15,7 @@
 #include "vm/object_store.h"
 #include "vm/program_visitor.h"
 #include "vm/runtime_entry.h"
+#include "vm/startup_phases.h"
 #include "vm/symbols.h"
 #include "vm/timeline.h"
 #include "vm/type_table.h"
@@ -173,6 +174,7 @@ static void CollectImmediateSuperInterfaces(const Class& cls,
 bool ClassFinalizer::ProcessPendingClasses() {
   Thread* thread = Thread::Current();
   TIMELINE_DURATION(thread, Isolate, "ProcessPendingClasses");
+  STARTUP_PHASE("FinalizeClasses");
   Isolate* isolate = thread->isolate();
   ASSERT(isolate != NULL);
   HANDLESCOPE(thread);
@@ -1594,7 +1596,8 @@ class ClearTypeHashVisitor : public ObjectVisitor {
   explicit ClearTypeHashVisitor(Zone* zone)
       : type_param_(TypeParameter::Handle(zone)),
         type_(Type::Handle(zone)),
-        type_args_(TypeArguments::Handle(zone)) {}
+        type_args_(TypeArguments::Handle(zone)),
+        instantiations_(Array::Handle(zone)) {}
 
   void VisitObject(RawObject* obj) {
     if (obj->IsTypeParameter()) {
@@ -1606,6 +1609,12 @@ class ClearTypeHashVisitor : public ObjectVisitor {
     } else if (obj->IsTypeArguments()) {
       type_args_ ^= obj;
       type_args_.SetHash(0);
+      // Hashed instantiation caches are keyed by the old hashes.
+      instantiations_ = type_args_.instantiations();
+      if (!instantiations_.IsNull() &&
+          TypeArguments::IsHashedInstantiations(instantiations_)) {
+        type_args_.set_instantiations(Object::zero_array());
+      }
     }
   }
 
@@ -1613,6 +1622,7 @@ class ClearTypeHashVisitor : public ObjectVisitor {
   TypeParameter& type_param_;
   Type& type_;
   TypeArguments& type_args_;
+  Array& instantiations_;
 };
 
 void ClassFinalizer::RehashTypes() {
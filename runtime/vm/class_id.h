@@ -127,6 +127,7 @@ namespace dart {
   V(Pointer)                                                                   \
   V(NativeFunction)                                                            \
   CLASS_LIST_FFI_TYPE_MARKER(V)                                                \
+  V(ByValue)                                                                   \
   V(NativeType)                                                                \
   V(DynamicLibrary)
 
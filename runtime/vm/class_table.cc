@@ -251,12 +251,19 @@ void ClassTable::SetAt(intptr_t index, RawClass* raw_cls) {
   if (raw_cls == NULL) {
     table_[index] = ClassAndSize(raw_cls, 0);
   } else {
-    table_[index] = ClassAndSize(raw_cls, Class::instance_size(raw_cls));
+    table_[index] = ClassAndSize(raw_cls);
   }
 }
 
 ClassAndSize::ClassAndSize(RawClass* clazz) : class_(clazz) {
   size_ = clazz == NULL ? 0 : Class::instance_size(clazz);
+#if defined(ARCH_IS_64_BIT)
+  unboxed_fields_bitmap_ =
+      clazz == NULL ? 0 : Class::unboxed_fields_bitmap(clazz);
+  if (unboxed_fields_bitmap_ != 0) {
+    RawObject::set_has_unboxed_fields();
+  }
+#endif
 }
 
 #ifndef PRODUCT
@@ -430,11 +437,13 @@ void ClassHeapStats::PrintToJSONObject(const Class& cls,
   obj->AddProperty64("bytesCurrent", bytes_current);
 }
 
-void ClassTable::UpdateAllocatedOldGC(intptr_t cid, intptr_t size) {
+void ClassTable::UpdateAllocatedOldGC(intptr_t cid,
+                                      intptr_t size,
+                                      intptr_t count) {
   ClassHeapStats* stats = PreliminaryStatsAt(cid);
   ASSERT(stats != NULL);
   ASSERT(size != 0);
-  stats->recent.AddOldGC(size);
+  stats->recent.AddOldGC(size, count);
 }
 
 void ClassTable::UpdateAllocatedExternalNew(intptr_t cid, intptr_t size) {
@@ -31,9 +31,23 @@ class ClassAndSize {
   RawClass* get_raw_class() const { return class_; }
   intptr_t size() const { return size_; }
 
+  // Bit i is set if word i of the instances holds an unboxed field, which
+  // the GC must not visit. Unboxed fields are only used on 64-bit targets.
+  uint32_t unboxed_fields_bitmap() const {
+#if defined(ARCH_IS_64_BIT)
+    return unboxed_fields_bitmap_;
+#else
+    return 0;
+#endif
+  }
+
  private:
   RawClass* class_;
-  intptr_t size_;
+  // Keeps the pair at two words, see ClassTable::kSizeOfClassPairLog2.
+  int32_t size_;
+#if defined(ARCH_IS_64_BIT)
+  uint32_t unboxed_fields_bitmap_ = 0;
+#endif
 
   friend class ClassTable;
   friend class IsolateReloadContext;  // For VisitObjectPointers.
@@ -204,6 +218,11 @@ class ClassTable {
     return table_[index].size_;
   }
 
+  uint32_t UnboxedFieldsBitmapAt(intptr_t index) const {
+    ASSERT(IsValidIndex(index));
+    return table_[index].unboxed_fields_bitmap();
+  }
+
   ClassAndSize PairAt(intptr_t index) const {
     ASSERT(IsValidIndex(index));
     return table_[index];
@@ -286,7 +305,7 @@ class ClassTable {
     ASSERT(size != 0);
     stats->recent.AddOld(size);
   }
-  void UpdateAllocatedOldGC(intptr_t cid, intptr_t size);
+  void UpdateAllocatedOldGC(intptr_t cid, intptr_t size, intptr_t count = 1);
   void UpdateAllocatedExternalNew(intptr_t cid, intptr_t size);
   void UpdateAllocatedExternalOld(intptr_t cid, intptr_t size);
 
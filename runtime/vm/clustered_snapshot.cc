@@ -17,8 +17,11 @@
 #include "vm/object.h"
 #include "vm/object_store.h"
 #include "vm/program_visitor.h"
+#include "vm/reverse_pc_lookup_cache.h"
+#include "vm/startup_phases.h"
 #include "vm/stub_code.h"
 #include "vm/symbols.h"
+#include "vm/thread_pool.h"
 #include "vm/timeline.h"
 #include "vm/version.h"
 
@@ -29,6 +32,197 @@ namespace dart {
 #if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32) &&                 \
     !defined(TARGET_ARCH_DBC)
 
+DEFINE_FLAG(charp,
+            code_order_file,
+            NULL,
+            "Place the code of the functions listed in the given file, one "
+            "qualified name per line, first in AOT snapshots and in the order "
+            "of the file.");
+DEFINE_FLAG(bool,
+            place_deferred_code_last,
+            true,
+            "Place the code of libraries that are only reachable through "
+            "deferred imports after all other code in AOT snapshots, so that "
+            "its pages are not touched until the library is used.");
+
+class CodeOrderKeyValueTrait {
+ public:
+  struct Pair {
+    const char* name;
+    intptr_t rank;
+  };
+
+  // Typedefs needed for the DirectChainedHashMap template.
+  typedef const char* Key;
+  typedef intptr_t Value;
+
+  static Key KeyOf(Pair kv) { return kv.name; }
+  static Value ValueOf(Pair kv) { return kv.rank; }
+  static inline intptr_t Hashcode(Key key) {
+    return Utils::StringHash(key, strlen(key));
+  }
+
+  static inline bool IsKeyEqual(Pair pair, Key key) {
+    return strcmp(pair.name, key) == 0;
+  }
+};
+
+typedef DirectChainedHashMap<CodeOrderKeyValueTrait> CodeOrderMap;
+
+// Reads --code_order_file into [ranks]. Returns false if it cannot be read.
+static bool ReadCodeOrder(Zone* zone, CodeOrderMap* ranks) {
+  auto file_open = Dart::file_open_callback();
+  auto file_read = Dart::file_read_callback();
+  auto file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_read == nullptr) ||
+      (file_close == nullptr)) {
+    return false;
+  }
+
+  auto file = file_open(FLAG_code_order_file, /*write=*/false);
+  if (file == nullptr) {
+    OS::PrintErr("Failed to open file %s\n", FLAG_code_order_file);
+    return false;
+  }
+  uint8_t* data = nullptr;
+  intptr_t length = 0;
+  file_read(&data, &length, file);
+  file_close(file);
+  if ((data == nullptr) || (length < 0)) {
+    OS::PrintErr("Failed to read file %s\n", FLAG_code_order_file);
+    return false;
+  }
+
+  // Empty lines and lines starting with '#' are ignored. A name listed more
+  // than once keeps its first position.
+  const char* chars = reinterpret_cast<const char*>(data);
+  intptr_t start = 0;
+  while (start < length) {
+    intptr_t end = start;
+    while ((end < length) && (chars[end] != '\n')) {
+      end++;
+    }
+    intptr_t line_end = end;
+    if ((line_end > start) && (chars[line_end - 1] == '\r')) {
+      line_end--;
+    }
+    if ((line_end > start) && (chars[start] != '#')) {
+      const char* name =
+          zone->MakeCopyOfStringN(chars + start, line_end - start);
+      if (ranks->LookupValue(name) == 0) {
+        // Ranks start at 1, so that 0 means the name is not listed.
+        ranks->Insert({name, ranks->Length() + 1});
+      }
+    }
+    start = end + 1;
+  }
+  free(data);
+  return true;
+}
+
+// Moves the code of the functions listed in --code_order_file to the front,
+// in the order of the file. All other code keeps its relative order.
+static void OrderCodeObjects(GrowableArray<RawCode*>* code_objects) {
+  auto thread = Thread::Current();
+  auto zone = thread->zone();
+  CodeOrderMap ranks;
+  if (!ReadCodeOrder(zone, &ranks)) {
+    return;
+  }
+
+  struct Entry {
+    RawCode* code;
+    intptr_t rank;
+    intptr_t index;
+
+    static int Compare(const Entry* a, const Entry* b) {
+      if (a->rank != b->rank) {
+        return (a->rank < b->rank) ? -1 : 1;
+      }
+      return (a->index < b->index) ? -1 : ((a->index > b->index) ? 1 : 0);
+    }
+  };
+
+  GrowableArray<Entry> entries(code_objects->length());
+  auto& code = Code::Handle(zone);
+  for (intptr_t i = 0; i < code_objects->length(); ++i) {
+    code = (*code_objects)[i];
+    intptr_t rank = ranks.LookupValue(code.QualifiedName());
+    if (rank == 0) {
+      rank = kIntptrMax;
+    }
+    entries.Add({code.raw(), rank, i});
+  }
+  entries.Sort(Entry::Compare);
+  for (intptr_t i = 0; i < entries.length(); ++i) {
+    (*code_objects)[i] = entries[i].code;
+  }
+}
+
+// Moves the code owned by the libraries in ObjectStore::deferred_libraries
+// behind all other code, grouped by library. Other code keeps its relative
+// order.
+static void PlaceDeferredCodeLast(GrowableArray<RawCode*>* code_objects) {
+  auto thread = Thread::Current();
+  auto zone = thread->zone();
+  const auto& deferred_libraries = Array::Handle(
+      zone, thread->isolate()->object_store()->deferred_libraries());
+  if (deferred_libraries.IsNull() || (deferred_libraries.Length() == 0)) {
+    return;
+  }
+
+  // Units start at 1, so that 0 means the code is loaded eagerly.
+  DirectChainedHashMap<RawPointerKeyValueTrait<RawObject, intptr_t>> units;
+  for (intptr_t i = 0; i < deferred_libraries.Length(); i++) {
+    units.Insert({deferred_libraries.At(i), i + 1});
+  }
+
+  struct Entry {
+    RawCode* code;
+    intptr_t unit;
+    intptr_t index;
+
+    static int Compare(const Entry* a, const Entry* b) {
+      if (a->unit != b->unit) {
+        return (a->unit < b->unit) ? -1 : 1;
+      }
+      return (a->index < b->index) ? -1 : ((a->index > b->index) ? 1 : 0);
+    }
+  };
+
+  GrowableArray<Entry> entries(code_objects->length());
+  auto& code = Code::Handle(zone);
+  auto& owner = Object::Handle(zone);
+  auto& cls = Class::Handle(zone);
+  intptr_t num_deferred = 0;
+  for (intptr_t i = 0; i < code_objects->length(); ++i) {
+    code = (*code_objects)[i];
+    owner = code.owner();
+    cls = Class::null();
+    if (owner.IsFunction()) {
+      cls = Function::Cast(owner).Owner();
+    } else if (owner.IsClass()) {
+      cls ^= owner.raw();
+    }
+    intptr_t unit = 0;
+    if (!cls.IsNull()) {
+      unit = units.LookupValue(cls.library());
+    }
+    if (unit != 0) {
+      num_deferred++;
+    }
+    entries.Add({code.raw(), unit, i});
+  }
+  entries.Sort(Entry::Compare);
+  for (intptr_t i = 0; i < entries.length(); ++i) {
+    (*code_objects)[i] = entries[i].code;
+  }
+  if (FLAG_print_snapshot_sizes) {
+    OS::Print("DeferredCodeObjects: %" Pd " of %" Pd "\n", num_deferred,
+              code_objects->length());
+  }
+}
+
 static void RelocateCodeObjects(
     bool is_vm,
     GrowableArray<RawCode*>* code_objects,
@@ -169,6 +363,9 @@ class ClassSerializationCluster : public SerializationCluster {
     }
   }
 
+  // Reports classes with illegal cids, which needs handles.
+  bool CanWriteFillConcurrently() const { return false; }
+
   void WriteClass(Serializer* s, RawClass* cls) {
     AutoTraceObjectName(cls, cls->ptr()->name_);
     WriteFromTo(cls);
@@ -188,6 +385,7 @@ class ClassSerializationCluster : public SerializationCluster {
     s->WriteTokenPosition(cls->ptr()->token_pos_);
     s->WriteTokenPosition(cls->ptr()->end_token_pos_);
     s->Write<uint32_t>(cls->ptr()->state_bits_);
+    s->Write<uint32_t>(cls->ptr()->unboxed_fields_bitmap_);
   }
 
  private:
@@ -250,6 +448,7 @@ class ClassDeserializationCluster : public DeserializationCluster {
       cls->ptr()->token_pos_ = d->ReadTokenPosition();
       cls->ptr()->end_token_pos_ = d->ReadTokenPosition();
       cls->ptr()->state_bits_ = d->Read<uint32_t>();
+      cls->ptr()->unboxed_fields_bitmap_ = d->Read<uint32_t>();
     }
 
     for (intptr_t id = start_index_; id < stop_index_; id++) {
@@ -277,12 +476,16 @@ class ClassDeserializationCluster : public DeserializationCluster {
       cls->ptr()->token_pos_ = d->ReadTokenPosition();
       cls->ptr()->end_token_pos_ = d->ReadTokenPosition();
       cls->ptr()->state_bits_ = d->Read<uint32_t>();
+      cls->ptr()->unboxed_fields_bitmap_ = d->Read<uint32_t>();
 
       table->AllocateIndex(class_id);
       table->SetAt(class_id, cls);
     }
   }
 
+  // Registers the classes in the class table.
+  bool CanFillConcurrently() const { return false; }
+
  private:
   intptr_t predefined_start_index_;
   intptr_t predefined_stop_index_;
@@ -579,11 +782,39 @@ class FunctionDeserializationCluster : public DeserializationCluster {
         func->ptr()->deoptimization_counter_ = 0;
         func->ptr()->state_bits_ = 0;
         func->ptr()->inlining_depth_ = 0;
+
+        if (kind == Snapshot::kFull) {
+          // Same as Function::ClearCode. The stub is in the VM isolate, so
+          // no write barrier is needed and PostLoad has nothing left to do.
+          func->ptr()->unoptimized_code_ = Code::null();
+          func->ptr()->bytecode_ = Bytecode::null();
+          SetLazyCompileStub(func);
+        } else if (FLAG_lazy_snapshot_code &&
+                   (func->ptr()->code_ != Code::null()) &&
+                   (func->ptr()->code_ == func->ptr()->unoptimized_code_)) {
+          // Compiler::CompileFunction attaches the unoptimized code on the
+          // first call instead of PostLoad doing it for every function.
+          SetLazyCompileStub(func);
+        }
 #endif
       }
     }
   }
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  static void SetLazyCompileStub(RawFunction* func) {
+    const Code& stub = StubCode::LazyCompile();
+    func->ptr()->code_ = stub.raw();
+    func->ptr()->entry_point_ = stub.EntryPoint();
+    func->ptr()->unchecked_entry_point_ = stub.UncheckedEntryPoint();
+  }
+
+  static bool IsLazyFromSnapshot(RawFunction* func) {
+    return (func->ptr()->code_ == StubCode::LazyCompile().raw()) &&
+           (func->ptr()->unoptimized_code_ != Code::null());
+  }
+#endif
+
   void PostLoad(const Array& refs, Snapshot::Kind kind, Zone* zone) {
     if (kind == Snapshot::kFullAOT) {
       Function& func = Function::Handle(zone);
@@ -603,6 +834,11 @@ class FunctionDeserializationCluster : public DeserializationCluster {
       Code& code = Code::Handle(zone);
       for (intptr_t i = start_index_; i < stop_index_; i++) {
         func ^= refs.At(i);
+#if !defined(DART_PRECOMPILED_RUNTIME)
+        if (IsLazyFromSnapshot(func.raw())) {
+          continue;
+        }
+#endif
         code = func.CurrentCode();
         if (func.HasCode() && !code.IsDisabled()) {
           func.SetInstructions(code);  // Set entrypoint.
@@ -618,12 +854,6 @@ class FunctionDeserializationCluster : public DeserializationCluster {
           func.ClearCode();  // Set code and entrypoint to lazy compile stub.
         }
       }
-    } else {
-      Function& func = Function::Handle(zone);
-      for (intptr_t i = start_index_; i < stop_index_; i++) {
-        func ^= refs.At(i);
-        func.ClearCode();  // Set code and entrypoint to lazy compile stub.
-      }
     }
   }
 };
@@ -803,6 +1033,7 @@ class FfiTrampolineDataSerializationCluster : public SerializationCluster {
       // TODO(37295): FFI callbacks shouldn't be written to a snapshot. They
       // should only be referenced by the callback registry in Thread.
       ASSERT(data->ptr()->callback_id_ == 0);
+      s->Write<bool>(data->ptr()->is_leaf_);
     }
   }
 
@@ -835,6 +1066,7 @@ class FfiTrampolineDataDeserializationCluster : public DeserializationCluster {
                                      FfiTrampolineData::InstanceSize());
       ReadFromTo(data);
       data->ptr()->callback_id_ = 0;
+      data->ptr()->is_leaf_ = d->Read<bool>();
     }
   }
 };
@@ -1211,6 +1443,7 @@ class LibraryDeserializationCluster : public DeserializationCluster {
       ReadFromTo(lib);
       lib->ptr()->native_entry_resolver_ = NULL;
       lib->ptr()->native_entry_symbol_resolver_ = NULL;
+      lib->ptr()->ffi_native_resolver_ = NULL;
       lib->ptr()->index_ = d->Read<int32_t>();
       lib->ptr()->num_imports_ = d->Read<uint16_t>();
       lib->ptr()->load_state_ = d->Read<int8_t>();
@@ -1459,6 +1692,9 @@ class CodeSerializationCluster : public SerializationCluster {
     }
   }
 
+  // Looks up the text offsets of the instructions in the image writer.
+  bool CanWriteFillConcurrently() const { return false; }
+
   GrowableArray<RawCode*>* discovered_objects() { return &objects_; }
 
  private:
@@ -1577,14 +1813,23 @@ class CodeDeserializationCluster : public DeserializationCluster {
     }
   }
 
-#if !(defined(DART_PRECOMPILED_RUNTIME) || defined(PRODUCT))
+#if !defined(DART_PRECOMPILED_RUNTIME)
   void PostLoad(const Array& refs, Snapshot::Kind kind, Zone* zone) {
+    // The code is indexed here on the main thread: ReadFill may run on a
+    // helper thread, which has no isolate.
+    JitReversePcLookupTable* table = Isolate::Current()->jit_pc_lookup_table();
+    for (intptr_t id = start_index_; id < stop_index_; id++) {
+      table->Add(Code::RawCast(refs.At(id)));
+    }
+
+#if !defined(PRODUCT)
     if (!CodeObservers::AreActive()) return;
     Code& code = Code::Handle(zone);
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       code ^= refs.At(id);
       Code::NotifyCodeObservers(code, code.is_optimized());
     }
+#endif  // !PRODUCT
   }
 #endif  // !DART_PRECOMPILED_RUNTIME
 };
@@ -2658,6 +2903,14 @@ class UnhandledExceptionDeserializationCluster : public DeserializationCluster {
   }
 };
 
+// Tests if the word at [offset] of an instance holds an unboxed field, which
+// is written as raw bits rather than as a reference.
+static bool IsUnboxedField(uint32_t unboxed_fields_bitmap, intptr_t offset) {
+  const intptr_t index = offset >> kWordSizeLog2;
+  return (index < kBitsPerInt32) &&
+         (((unboxed_fields_bitmap >> index) & 1) != 0);
+}
+
 #if !defined(DART_PRECOMPILED_RUNTIME)
 class InstanceSerializationCluster : public SerializationCluster {
  public:
@@ -2666,6 +2919,7 @@ class InstanceSerializationCluster : public SerializationCluster {
     RawClass* cls = Isolate::Current()->class_table()->At(cid);
     next_field_offset_in_words_ = cls->ptr()->next_field_offset_in_words_;
     instance_size_in_words_ = cls->ptr()->instance_size_in_words_;
+    unboxed_fields_bitmap_ = cls->ptr()->unboxed_fields_bitmap_;
     ASSERT(next_field_offset_in_words_ > 0);
     ASSERT(instance_size_in_words_ > 0);
   }
@@ -2678,9 +2932,11 @@ class InstanceSerializationCluster : public SerializationCluster {
     intptr_t next_field_offset = next_field_offset_in_words_ << kWordSizeLog2;
     intptr_t offset = Instance::NextFieldOffset();
     while (offset < next_field_offset) {
-      RawObject* raw_obj = *reinterpret_cast<RawObject**>(
-          reinterpret_cast<uword>(instance->ptr()) + offset);
-      s->Push(raw_obj);
+      if (!IsUnboxedField(unboxed_fields_bitmap_, offset)) {
+        RawObject* raw_obj = *reinterpret_cast<RawObject**>(
+            reinterpret_cast<uword>(instance->ptr()) + offset);
+        s->Push(raw_obj);
+      }
       offset += kWordSize;
     }
   }
@@ -2692,6 +2948,7 @@ class InstanceSerializationCluster : public SerializationCluster {
 
     s->Write<int32_t>(next_field_offset_in_words_);
     s->Write<int32_t>(instance_size_in_words_);
+    s->Write<uint32_t>(unboxed_fields_bitmap_);
 
     for (intptr_t i = 0; i < count; i++) {
       RawInstance* instance = objects_[i];
@@ -2708,9 +2965,14 @@ class InstanceSerializationCluster : public SerializationCluster {
       s->Write<bool>(instance->IsCanonical());
       intptr_t offset = Instance::NextFieldOffset();
       while (offset < next_field_offset) {
-        RawObject* raw_obj = *reinterpret_cast<RawObject**>(
-            reinterpret_cast<uword>(instance->ptr()) + offset);
-        s->WriteElementRef(raw_obj, offset);
+        if (IsUnboxedField(unboxed_fields_bitmap_, offset)) {
+          s->Write<int64_t>(*reinterpret_cast<int64_t*>(
+              reinterpret_cast<uword>(instance->ptr()) + offset));
+        } else {
+          RawObject* raw_obj = *reinterpret_cast<RawObject**>(
+              reinterpret_cast<uword>(instance->ptr()) + offset);
+          s->WriteElementRef(raw_obj, offset);
+        }
         offset += kWordSize;
       }
     }
@@ -2720,6 +2982,7 @@ class InstanceSerializationCluster : public SerializationCluster {
   const intptr_t cid_;
   intptr_t next_field_offset_in_words_;
   intptr_t instance_size_in_words_;
+  uint32_t unboxed_fields_bitmap_;
   GrowableArray<RawInstance*> objects_;
 };
 #endif  // !DART_PRECOMPILED_RUNTIME
@@ -2735,6 +2998,7 @@ class InstanceDeserializationCluster : public DeserializationCluster {
     intptr_t count = d->ReadUnsigned();
     next_field_offset_in_words_ = d->Read<int32_t>();
     instance_size_in_words_ = d->Read<int32_t>();
+    unboxed_fields_bitmap_ = d->Read<uint32_t>();
     intptr_t instance_size =
         Object::RoundedAllocationSize(instance_size_in_words_ * kWordSize);
     for (intptr_t i = 0; i < count; i++) {
@@ -2755,9 +3019,15 @@ class InstanceDeserializationCluster : public DeserializationCluster {
                                      is_canonical);
       intptr_t offset = Instance::NextFieldOffset();
       while (offset < next_field_offset) {
-        RawObject** p = reinterpret_cast<RawObject**>(
-            reinterpret_cast<uword>(instance->ptr()) + offset);
-        *p = d->ReadRef();
+        if (IsUnboxedField(unboxed_fields_bitmap_, offset)) {
+          int64_t* p = reinterpret_cast<int64_t*>(
+              reinterpret_cast<uword>(instance->ptr()) + offset);
+          *p = d->Read<int64_t>();
+        } else {
+          RawObject** p = reinterpret_cast<RawObject**>(
+              reinterpret_cast<uword>(instance->ptr()) + offset);
+          *p = d->ReadRef();
+        }
         offset += kWordSize;
       }
       if (offset < instance_size) {
@@ -2774,6 +3044,7 @@ class InstanceDeserializationCluster : public DeserializationCluster {
   const intptr_t cid_;
   intptr_t next_field_offset_in_words_;
   intptr_t instance_size_in_words_;
+  uint32_t unboxed_fields_bitmap_;
 };
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -3229,6 +3500,52 @@ class ClosureDeserializationCluster : public DeserializationCluster {
   }
 };
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+// Canonical numbers are deeply immutable. Snapshots that include code keep
+// them in the read-only data image, where they are referenced in place and
+// shared by all processes mapping the snapshot, rather than copying them into
+// the heap of every process.
+static bool IsReadOnlyNumber(Serializer* s, RawObject* object) {
+#if defined(IS_SIMARM_X64)
+  // Numbers are laid out differently on the host and the 32-bit target.
+  return false;
+#else
+  return Snapshot::IncludesCode(s->kind()) && object->IsCanonical();
+#endif
+}
+
+static void WriteReadOnlyNumbers(Serializer* s,
+                                 const char* name,
+                                 const GrowableArray<RawObject*>& objects) {
+  const intptr_t count = objects.length();
+  s->WriteUnsigned(count);
+  uint32_t running_offset = 0;
+  for (intptr_t i = 0; i < count; i++) {
+    RawObject* object = objects[i];
+    s->AssignRef(object);
+    s->TraceStartWritingObject(name, object, nullptr);
+    uint32_t offset = s->GetDataOffset(object);
+    s->TraceDataOffset(offset);
+    ASSERT(Utils::IsAligned(
+        offset, compiler::target::ObjectAlignment::kObjectAlignment));
+    ASSERT(offset > running_offset);
+    s->WriteUnsigned((offset - running_offset) >>
+                     compiler::target::ObjectAlignment::kObjectAlignmentLog2);
+    running_offset = offset;
+    s->TraceEndWritingObject();
+  }
+}
+#endif  // !DART_PRECOMPILED_RUNTIME
+
+static void ReadReadOnlyNumbers(Deserializer* d) {
+  const intptr_t count = d->ReadUnsigned();
+  uint32_t running_offset = 0;
+  for (intptr_t i = 0; i < count; i++) {
+    running_offset += d->ReadUnsigned() << kObjectAlignmentLog2;
+    d->AssignRef(d->GetObjectAt(running_offset));
+  }
+}
+
 #if !defined(DART_PRECOMPILED_RUNTIME)
 class MintSerializationCluster : public SerializationCluster {
  public:
@@ -3241,12 +3558,18 @@ class MintSerializationCluster : public SerializationCluster {
       smis_.Add(smi);
     } else {
       RawMint* mint = Mint::RawCast(object);
-      mints_.Add(mint);
+      // Values that fit in a Smi are read back as Smis.
+      if (IsReadOnlyNumber(s, mint) && !Smi::IsValid(mint->ptr()->value_)) {
+        read_only_mints_.Add(mint);
+      } else {
+        mints_.Add(mint);
+      }
     }
   }
 
   void WriteAlloc(Serializer* s) {
     s->WriteCid(kMintCid);
+    WriteReadOnlyNumbers(s, "(RO)int", read_only_mints_);
 
     s->WriteUnsigned(smis_.length() + mints_.length());
     for (intptr_t i = 0; i < smis_.length(); i++) {
@@ -3270,6 +3593,7 @@ class MintSerializationCluster : public SerializationCluster {
  private:
   GrowableArray<RawSmi*> smis_;
   GrowableArray<RawMint*> mints_;
+  GrowableArray<RawObject*> read_only_mints_;
 };
 #endif  // !DART_PRECOMPILED_RUNTIME
 
@@ -3282,6 +3606,7 @@ class MintDeserializationCluster : public DeserializationCluster {
     PageSpace* old_space = d->heap()->old_space();
 
     start_index_ = d->next_index();
+    ReadReadOnlyNumbers(d);
     intptr_t count = d->ReadUnsigned();
     for (intptr_t i = 0; i < count; i++) {
       bool is_canonical = d->Read<bool>();
@@ -3324,11 +3649,16 @@ class DoubleSerializationCluster : public SerializationCluster {
 
   void Trace(Serializer* s, RawObject* object) {
     RawDouble* dbl = Double::RawCast(object);
-    objects_.Add(dbl);
+    if (IsReadOnlyNumber(s, dbl)) {
+      read_only_objects_.Add(dbl);
+    } else {
+      objects_.Add(dbl);
+    }
   }
 
   void WriteAlloc(Serializer* s) {
     s->WriteCid(kDoubleCid);
+    WriteReadOnlyNumbers(s, "(RO)double", read_only_objects_);
     intptr_t count = objects_.length();
     s->WriteUnsigned(count);
     for (intptr_t i = 0; i < count; i++) {
@@ -3349,6 +3679,7 @@ class DoubleSerializationCluster : public SerializationCluster {
 
  private:
   GrowableArray<RawDouble*> objects_;
+  GrowableArray<RawObject*> read_only_objects_;
 };
 #endif  // !DART_PRECOMPILED_RUNTIME
 
@@ -3358,6 +3689,7 @@ class DoubleDeserializationCluster : public DeserializationCluster {
   ~DoubleDeserializationCluster() {}
 
   void ReadAlloc(Deserializer* d) {
+    ReadReadOnlyNumbers(d);
     start_index_ = d->next_index();
     PageSpace* old_space = d->heap()->old_space();
     intptr_t count = d->ReadUnsigned();
@@ -3645,6 +3977,9 @@ class ExternalTypedDataSerializationCluster : public SerializationCluster {
     }
   }
 
+  // Aligns the data to its position in the snapshot.
+  bool CanWriteFillConcurrently() const { return false; }
+
  private:
   const intptr_t cid_;
   GrowableArray<RawExternalTypedData*> objects_;
@@ -4003,6 +4338,10 @@ class LinkedHashMapDeserializationCluster : public DeserializationCluster {
       map->ptr()->deleted_keys_ = Smi::New(0);
     }
   }
+
+  // Allocates the backing stores, which needs the heap lock held by the main
+  // thread.
+  bool CanFillConcurrently() const { return false; }
 };
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -4300,6 +4639,41 @@ Serializer::Serializer(Thread* thread,
   }
 }
 
+static uint8_t* MallocReallocate(uint8_t* ptr,
+                                 intptr_t old_size,
+                                 intptr_t new_size) {
+  return reinterpret_cast<uint8_t*>(realloc(ptr, new_size));
+}
+
+Serializer::Serializer(Thread* thread, const Serializer& main, uint8_t** buffer)
+    : ThreadStackResource(thread),
+      heap_(main.heap_),
+      zone_(thread->zone()),
+      kind_(main.kind_),
+      stream_(buffer, MallocReallocate, 64 * KB),
+      image_writer_(NULL),
+      clusters_by_cid_(NULL),
+      stack_(),
+      num_cids_(main.num_cids_),
+      num_base_objects_(main.num_base_objects_),
+      num_written_objects_(main.num_written_objects_),
+      next_ref_index_(main.next_ref_index_),
+      vm_(main.vm_),
+      profile_writer_(nullptr)
+#if defined(SNAPSHOT_BACKTRACE)
+      ,
+      current_parent_(Object::null()),
+      parent_pairs_()
+#endif
+{
+  // The main serializer's map is only read while fills are written, but it
+  // was allocated in the main thread's zone, so it is copied into this one.
+  auto it = main.smi_ids_.GetIterator();
+  for (SmiObjectIdPair* pair = it.Next(); pair != NULL; pair = it.Next()) {
+    smi_ids_.Insert(*pair);
+  }
+}
+
 Serializer::~Serializer() {
   delete[] clusters_by_cid_;
 }
@@ -4694,6 +5068,135 @@ static int CompareClusters(SerializationCluster* const* a,
 }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
+void Serializer::WriteClusterFill(SerializationCluster* cluster) {
+  cluster->WriteAndMeasureFill(this);
+#if defined(DEBUG)
+  Write<int32_t>(kSectionMarker);
+#endif
+}
+
+void Serializer::WriteFillsConcurrently(
+    Thread* thread,
+    uint8_t** buffer,
+    const GrowableArray<SerializationCluster*>& clusters,
+    SerializedClusterFill* fills,
+    uintptr_t* next_cluster) {
+  Serializer writer(thread, *this, buffer);
+  while (true) {
+    const intptr_t index = AtomicOperations::FetchAndIncrement(next_cluster);
+    if (index >= clusters.length()) {
+      return;
+    }
+    if (clusters[index]->CanWriteFillConcurrently()) {
+      fills[index].buffer = buffer;
+      fills[index].start = writer.bytes_written();
+      writer.WriteClusterFill(clusters[index]);
+      fills[index].stop = writer.bytes_written();
+    }
+  }
+}
+
+class SerializerFillTask : public ThreadPool::Task {
+ public:
+  SerializerFillTask(Serializer* serializer,
+                     Isolate* isolate,
+                     const GrowableArray<SerializationCluster*>* clusters,
+                     SerializedClusterFill* fills,
+                     uint8_t** buffer,
+                     uintptr_t* next_cluster,
+                     Monitor* monitor,
+                     intptr_t* num_running)
+      : serializer_(serializer),
+        isolate_(isolate),
+        clusters_(clusters),
+        fills_(fills),
+        buffer_(buffer),
+        next_cluster_(next_cluster),
+        monitor_(monitor),
+        num_running_(num_running) {}
+
+  virtual void Run() {
+    bool result =
+        Thread::EnterIsolateAsHelper(isolate_, Thread::kUnknownTask, true);
+    ASSERT(result);
+    {
+      Thread* thread = Thread::Current();
+      StackZone stack_zone(thread);
+      serializer_->WriteFillsConcurrently(thread, buffer_, *clusters_, fills_,
+                                          next_cluster_);
+    }
+    Thread::ExitIsolateAsHelper(true);
+
+    MonitorLocker ml(monitor_);
+    (*num_running_)--;
+    ml.Notify();
+  }
+
+ private:
+  Serializer* serializer_;
+  Isolate* isolate_;
+  const GrowableArray<SerializationCluster*>* clusters_;
+  SerializedClusterFill* fills_;
+  uint8_t** buffer_;
+  uintptr_t* next_cluster_;
+  Monitor* monitor_;
+  intptr_t* num_running_;
+
+  DISALLOW_COPY_AND_ASSIGN(SerializerFillTask);
+};
+
+void Serializer::WriteFillsInParallel(GrowableArray<uint32_t>* fill_offsets) {
+  // Every ref has been assigned by now, so a fill only reads the heap and the
+  // ref ids. Each task writes the fills it takes into its own buffer, and the
+  // buffers are copied into the snapshot in cluster order afterwards, so the
+  // snapshot is the same as when the fills are written on this thread.
+  GrowableArray<SerializationCluster*> clusters;
+  for (intptr_t cid = 1; cid < num_cids_; cid++) {
+    if (clusters_by_cid_[cid] != NULL) {
+      clusters.Add(clusters_by_cid_[cid]);
+    }
+  }
+  const intptr_t num_clusters = clusters.length();
+  SerializedClusterFill* fills =
+      zone_->Alloc<SerializedClusterFill>(num_clusters);
+
+  // One buffer for each task, and one for this thread, which helps.
+  const intptr_t num_tasks = FLAG_serializer_tasks;
+  uint8_t** buffers = zone_->Alloc<uint8_t*>(num_tasks + 1);
+  uintptr_t next_cluster = 0;
+  Monitor monitor;
+  intptr_t num_running = num_tasks;
+  for (intptr_t i = 0; i < num_tasks; i++) {
+    buffers[i] = NULL;
+    bool result = Dart::thread_pool()->Run<SerializerFillTask>(
+        this, isolate(), &clusters, fills, &buffers[i], &next_cluster,
+        &monitor, &num_running);
+    ASSERT(result);
+  }
+  buffers[num_tasks] = NULL;
+  WriteFillsConcurrently(thread(), &buffers[num_tasks], clusters, fills,
+                         &next_cluster);
+  {
+    MonitorLocker ml(&monitor);
+    while (num_running > 0) {
+      ml.Wait();
+    }
+  }
+
+  for (intptr_t i = 0; i < num_clusters; i++) {
+    fill_offsets->Add(bytes_written());
+    if (clusters[i]->CanWriteFillConcurrently()) {
+      const SerializedClusterFill& fill = fills[i];
+      WriteBytes(*fill.buffer + fill.start, fill.stop - fill.start);
+    } else {
+      WriteClusterFill(clusters[i]);
+    }
+  }
+  for (intptr_t i = 0; i <= num_tasks; i++) {
+    free(buffers[i]);
+  }
+}
+
 void Serializer::Serialize() {
   while (stack_.length() > 0) {
     Trace(stack_.RemoveLast());
@@ -4707,6 +5210,13 @@ void Serializer::Serialize() {
         static_cast<CodeSerializationCluster*>(clusters_by_cid_[kCodeCid])
             ->discovered_objects();
 
+    if (FLAG_place_deferred_code_last && !vm_) {
+      PlaceDeferredCodeLast(code_objects);
+    }
+    if (FLAG_code_order_file != nullptr) {
+      OrderCodeObjects(code_objects);
+    }
+
     GrowableArray<ImageWriterCommand> writer_commands;
     RelocateCodeObjects(vm_, code_objects, &writer_commands);
     image_writer_->PrepareForSerialization(&writer_commands);
@@ -4772,15 +5282,41 @@ void Serializer::Serialize() {
   // We should have assigned a ref to every object we pushed.
   ASSERT((next_ref_index_ - 1) == num_objects);
 
-  for (intptr_t cid = 1; cid < num_cids_; cid++) {
-    SerializationCluster* cluster = clusters_by_cid_[cid];
-    if (cluster != NULL) {
-      cluster->WriteAndMeasureFill(this);
-#if defined(DEBUG)
-      Write<int32_t>(kSectionMarker);
-#endif
+  // Reserve a table with the start of each cluster's fill section and the end
+  // of the last one, so the deserializer can fill clusters independently. The
+  // entries have a fixed size because they are patched after the fills.
+  const intptr_t fill_offsets_position = bytes_written();
+  const uint32_t placeholder = 0;
+  for (intptr_t i = 0; i <= num_clusters; i++) {
+    WriteBytes(reinterpret_cast<const uint8_t*>(&placeholder),
+               sizeof(placeholder));
+  }
+
+  GrowableArray<uint32_t> fill_offsets(num_clusters + 1);
+  if ((FLAG_serializer_tasks > 0) && (num_clusters > 1) &&
+      (profile_writer_ == nullptr)) {
+    WriteFillsInParallel(&fill_offsets);
+  } else {
+    for (intptr_t cid = 1; cid < num_cids_; cid++) {
+      SerializationCluster* cluster = clusters_by_cid_[cid];
+      if (cluster != NULL) {
+        fill_offsets.Add(bytes_written());
+        WriteClusterFill(cluster);
+      }
     }
   }
+  if (!Utils::IsUint(32, bytes_written())) {
+    FATAL("Snapshot too large");
+  }
+  fill_offsets.Add(bytes_written());
+
+  const intptr_t fills_end = bytes_written();
+  stream_.SetPosition(fill_offsets_position);
+  for (intptr_t i = 0; i <= num_clusters; i++) {
+    WriteBytes(reinterpret_cast<const uint8_t*>(&fill_offsets[i]),
+               sizeof(fill_offsets[i]));
+  }
+  stream_.SetPosition(fills_end);
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
   if (FLAG_print_snapshot_sizes_verbose) {
@@ -4968,6 +5504,8 @@ Deserializer::Deserializer(Thread* thread,
       heap_(thread->isolate()->heap()),
       zone_(thread->zone()),
       kind_(kind),
+      buffer_(buffer),
+      size_(size),
       stream_(buffer, size),
       image_reader_(NULL),
       refs_(NULL),
@@ -4983,12 +5521,31 @@ Deserializer::Deserializer(Thread* thread,
   stream_.SetPosition(offset);
 }
 
+Deserializer::Deserializer(const Deserializer& main, intptr_t position)
+    : ThreadStackResource(NULL),
+      heap_(main.heap_),
+      zone_(NULL),
+      kind_(main.kind_),
+      buffer_(main.buffer_),
+      size_(main.size_),
+      stream_(buffer_, size_),
+      image_reader_(main.image_reader_),
+      num_base_objects_(main.num_base_objects_),
+      num_objects_(main.num_objects_),
+      num_clusters_(main.num_clusters_),
+      code_order_length_(main.code_order_length_),
+      refs_(main.refs_),
+      next_ref_index_(main.next_ref_index_),
+      clusters_(NULL),
+      fill_micros_(main.fill_micros_) {
+  stream_.SetPosition(position);
+}
+
 Deserializer::~Deserializer() {
   delete[] clusters_;
 }
 
-DeserializationCluster* Deserializer::ReadCluster() {
-  intptr_t cid = ReadCid();
+DeserializationCluster* Deserializer::ReadCluster(intptr_t cid) {
   Zone* Z = zone_;
   if (cid >= kNumPredefinedCids || cid == kInstanceCid) {
     return new (Z) InstanceDeserializationCluster(cid);
@@ -5259,9 +5816,25 @@ void Deserializer::Deserialize() {
            num_base_objects_, next_ref_index_ - 1);
   }
 
+#if !defined(PRODUCT)
+  if (StartupPhases::enabled()) {
+    cluster_cids_ = zone_->Alloc<intptr_t>(num_clusters_);
+    alloc_micros_ = zone_->Alloc<int64_t>(num_clusters_);
+    fill_micros_ = zone_->Alloc<int64_t>(num_clusters_);
+  }
+#endif
+
   for (intptr_t i = 0; i < num_clusters_; i++) {
-    clusters_[i] = ReadCluster();
+    const intptr_t cid = ReadCid();
+    const int64_t start = (alloc_micros_ != nullptr)
+                              ? OS::GetCurrentMonotonicMicros()
+                              : 0;
+    clusters_[i] = ReadCluster(cid);
     clusters_[i]->ReadAlloc(this);
+    if (alloc_micros_ != nullptr) {
+      cluster_cids_[i] = cid;
+      alloc_micros_[i] = OS::GetCurrentMonotonicMicros() - start;
+    }
 #if defined(DEBUG)
     intptr_t serializers_next_ref_index_ = Read<int32_t>();
     ASSERT(serializers_next_ref_index_ == next_ref_index_);
@@ -5271,12 +5844,136 @@ void Deserializer::Deserialize() {
   // We should have completely filled the ref array.
   ASSERT((next_ref_index_ - 1) == num_objects_);
 
+  intptr_t* fill_offsets = zone_->Alloc<intptr_t>(num_clusters_ + 1);
+  for (intptr_t i = 0; i <= num_clusters_; i++) {
+    uint32_t offset;
+    ReadBytes(reinterpret_cast<uint8_t*>(&offset), sizeof(offset));
+    fill_offsets[i] = offset;
+  }
+  ASSERT(stream_.Position() == fill_offsets[0]);
+
+  if ((FLAG_deserializer_tasks > 0) && (num_clusters_ > 1)) {
+    FillClustersInParallel(fill_offsets);
+    stream_.SetPosition(fill_offsets[num_clusters_]);
+  } else {
+    for (intptr_t i = 0; i < num_clusters_; i++) {
+      FillCluster(i, clusters_[i], fill_offsets[i], fill_offsets[i + 1]);
+    }
+  }
+  ASSERT(stream_.Position() == fill_offsets[num_clusters_]);
+}
+
+void Deserializer::RecordClusterTimes() {
+#if !defined(PRODUCT)
+  if (alloc_micros_ == nullptr) {
+    return;
+  }
+  ClassTable* class_table = thread()->isolate()->class_table();
+  Class& cls = Class::Handle(zone_);
+  String& name = String::Handle(zone_);
   for (intptr_t i = 0; i < num_clusters_; i++) {
-    clusters_[i]->ReadFill(this);
+    const intptr_t cid = cluster_cids_[i];
+    const char* cluster_name = "";
+    if ((cid < kNumPredefinedCids) && class_table->IsValidIndex(cid) &&
+        class_table->HasValidClassAt(cid)) {
+      cls = class_table->At(cid);
+      name = cls.Name();
+      cluster_name = name.IsNull() ? "" : name.ToCString();
+    }
+    StartupPhases::RecordCluster(cid, cluster_name, alloc_micros_[i],
+                                 fill_micros_[i]);
+  }
+#endif  // !defined(PRODUCT)
+}
+
+void Deserializer::FillCluster(intptr_t index,
+                               DeserializationCluster* cluster,
+                               intptr_t start,
+                               intptr_t stop) {
+  const int64_t fill_start =
+      (fill_micros_ != nullptr) ? OS::GetCurrentMonotonicMicros() : 0;
+  stream_.SetPosition(start);
+  cluster->ReadFill(this);
+  if (fill_micros_ != nullptr) {
+    fill_micros_[index] = OS::GetCurrentMonotonicMicros() - fill_start;
+  }
 #if defined(DEBUG)
-    int32_t section_marker = Read<int32_t>();
-    ASSERT(section_marker == kSectionMarker);
+  int32_t section_marker = Read<int32_t>();
+  ASSERT(section_marker == kSectionMarker);
 #endif
+  ASSERT(stream_.Position() == stop);
+}
+
+void Deserializer::FillClustersConcurrently(const intptr_t* fill_offsets,
+                                            uintptr_t* next_cluster) {
+  while (true) {
+    const intptr_t index = AtomicOperations::FetchAndIncrement(next_cluster);
+    if (index >= num_clusters_) {
+      return;
+    }
+    if (clusters_[index]->CanFillConcurrently()) {
+      Deserializer reader(*this, fill_offsets[index]);
+      reader.FillCluster(index, clusters_[index], fill_offsets[index],
+                         fill_offsets[index + 1]);
+    }
+  }
+}
+
+class DeserializerFillTask : public ThreadPool::Task {
+ public:
+  DeserializerFillTask(Deserializer* deserializer,
+                       const intptr_t* fill_offsets,
+                       uintptr_t* next_cluster,
+                       Monitor* monitor,
+                       intptr_t* num_running)
+      : deserializer_(deserializer),
+        fill_offsets_(fill_offsets),
+        next_cluster_(next_cluster),
+        monitor_(monitor),
+        num_running_(num_running) {}
+
+  virtual void Run() {
+    deserializer_->FillClustersConcurrently(fill_offsets_, next_cluster_);
+
+    MonitorLocker ml(monitor_);
+    (*num_running_)--;
+    ml.Notify();
+  }
+
+ private:
+  Deserializer* deserializer_;
+  const intptr_t* fill_offsets_;
+  uintptr_t* next_cluster_;
+  Monitor* monitor_;
+  intptr_t* num_running_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeserializerFillTask);
+};
+
+void Deserializer::FillClustersInParallel(const intptr_t* fill_offsets) {
+  // Clusters only write to their own objects while filling, and every object
+  // has been allocated already, so fills are independent of each other apart
+  // from the side effects checked by CanFillConcurrently.
+  const intptr_t num_tasks = FLAG_deserializer_tasks;
+  uintptr_t next_cluster = 0;
+  Monitor monitor;
+  intptr_t num_running = num_tasks;
+  for (intptr_t i = 0; i < num_tasks; i++) {
+    bool result = Dart::thread_pool()->Run<DeserializerFillTask>(
+        this, fill_offsets, &next_cluster, &monitor, &num_running);
+    ASSERT(result);
+  }
+
+  for (intptr_t i = 0; i < num_clusters_; i++) {
+    if (!clusters_[i]->CanFillConcurrently()) {
+      FillCluster(i, clusters_[i], fill_offsets[i], fill_offsets[i + 1]);
+    }
+  }
+  FillClustersConcurrently(fill_offsets, &next_cluster);
+
+  MonitorLocker ml(&monitor);
+  while (num_running > 0) {
+    ml.Wait();
   }
 }
 
@@ -5396,6 +6093,7 @@ void Deserializer::ReadVMSnapshot() {
   for (intptr_t i = 0; i < num_clusters_; i++) {
     clusters_[i]->PostLoad(refs, kind_, zone_);
   }
+  RecordClusterTimes();
 }
 
 void Deserializer::ReadIsolateSnapshot(ObjectStore* object_store) {
@@ -5442,6 +6140,7 @@ void Deserializer::ReadIsolateSnapshot(ObjectStore* object_store) {
   for (intptr_t i = 0; i < num_clusters_; i++) {
     clusters_[i]->PostLoad(refs, kind_, zone_);
   }
+  RecordClusterTimes();
 
   // Setup native resolver for bootstrap impl.
   Bootstrap::SetupNativeResolver();
@@ -5535,6 +6234,8 @@ void FullSnapshotWriter::WriteIsolateSnapshot(intptr_t num_base_objects) {
                         profile_writer_);
   ObjectStore* object_store = isolate()->object_store();
   ASSERT(object_store != NULL);
+  // The snapshot carries a single, complete symbol table.
+  Symbols::UnfreezeSnapshotTable(isolate());
 
   serializer.ReserveHeader();
   serializer.WriteVersionAndFeatures(false);
@@ -5726,6 +6427,7 @@ RawApiError* FullSnapshotReader::ReadIsolateSnapshot() {
 
   auto object_store = thread_->isolate()->object_store();
   deserializer.ReadIsolateSnapshot(object_store);
+  Symbols::FreezeSnapshotTable(thread_->isolate());
 
 #if defined(DART_PRECOMPILED_RUNTIME)
   if (FLAG_use_bare_instructions) {
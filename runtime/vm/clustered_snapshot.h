@@ -46,6 +46,8 @@ class ImageReader;
 // initialization/fill secton is read for each cluster, using the indices into
 // the reference array to fill pointers. At this point, every object has been
 // touched exactly once and in order, making this approach very cache friendly.
+// The fill sections are preceded by a table of their offsets, which allows
+// clusters to be filled in parallel.
 // Finally, each cluster is given an opportunity to perform some fix-ups that
 // require the graph has been fully loaded, such as rehashing, though most
 // clusters do not require fixups.
@@ -67,6 +69,12 @@ class SerializationCluster : public ZoneAllocated {
   // Write the byte and reference data of the cluster's objects.
   virtual void WriteFill(Serializer* serializer) = 0;
 
+  // Whether WriteFill may run on a helper thread while other clusters are
+  // being written. Clusters that use handles or the image writer, or that
+  // align to positions in the whole snapshot, must be written on the main
+  // thread.
+  virtual bool CanWriteFillConcurrently() const { return true; }
+
   void WriteAndMeasureAlloc(Serializer* serializer);
   void WriteAndMeasureFill(Serializer* serializer);
 
@@ -92,6 +100,11 @@ class DeserializationCluster : public ZoneAllocated {
   // Initialize the cluster's objects. Do not touch the memory of other objects.
   virtual void ReadFill(Deserializer* deserializer) = 0;
 
+  // Whether ReadFill may run on a helper thread while other clusters are being
+  // filled. Clusters that allocate or update isolate state while filling must
+  // be filled on the main thread.
+  virtual bool CanFillConcurrently() const { return true; }
+
   // Complete any action that requires the full graph to be deserialized, such
   // as rehashing.
   virtual void PostLoad(const Array& refs, Snapshot::Kind kind, Zone* zone) {}
@@ -127,6 +140,13 @@ class SmiObjectIdPairTrait {
 
 typedef DirectChainedHashMap<SmiObjectIdPairTrait> SmiObjectIdMap;
 
+// Where the fill section of a cluster was written by a helper serializer.
+struct SerializedClusterFill {
+  uint8_t** buffer;
+  intptr_t start;
+  intptr_t stop;
+};
+
 class Serializer : public ThreadStackResource {
  public:
   Serializer(Thread* thread,
@@ -216,6 +236,17 @@ class Serializer : public ThreadStackResource {
   void WriteVersionAndFeatures(bool is_vm_snapshot);
 
   void Serialize();
+
+  // Writes the fills of the clusters that can be written concurrently into
+  // [buffer], taking their indices from [next_cluster] until all have been
+  // handed out, and records where each one was written in [fills].
+  void WriteFillsConcurrently(
+      Thread* thread,
+      uint8_t** buffer,
+      const GrowableArray<SerializationCluster*>& clusters,
+      SerializedClusterFill* fills,
+      uintptr_t* next_cluster);
+
   WriteStream* stream() { return &stream_; }
   intptr_t bytes_written() { return stream_.bytes_written(); }
 
@@ -366,6 +397,13 @@ class Serializer : public ThreadStackResource {
   void DumpCombinedCodeStatistics();
 
  private:
+  // Creates a serializer for [thread] that writes cluster fills into its own
+  // [buffer], using the refs assigned by [main].
+  Serializer(Thread* thread, const Serializer& main, uint8_t** buffer);
+
+  void WriteClusterFill(SerializationCluster* cluster);
+  void WriteFillsInParallel(GrowableArray<uint32_t>* fill_offsets);
+
   Heap* heap_;
   Zone* zone_;
   Snapshot::Kind kind_;
@@ -557,7 +595,12 @@ class Deserializer : public ThreadStackResource {
   void Prepare();
   void Deserialize();
 
-  DeserializationCluster* ReadCluster();
+  // Fills the clusters that can be filled concurrently, taking their indices
+  // from [next_cluster] until all have been handed out.
+  void FillClustersConcurrently(const intptr_t* fill_offsets,
+                                uintptr_t* next_cluster);
+
+  DeserializationCluster* ReadCluster(intptr_t cid);
 
   intptr_t next_index() const { return next_ref_index_; }
   Heap* heap() const { return heap_; }
@@ -579,9 +622,25 @@ class Deserializer : public ThreadStackResource {
   intptr_t code_order_length() const { return code_order_length_; }
 
  private:
+  // Creates a deserializer for reading the fill section at [position] of
+  // [main]'s snapshot. It has no thread and may be used by a helper thread.
+  Deserializer(const Deserializer& main, intptr_t position);
+
+  void FillCluster(intptr_t index,
+                   DeserializationCluster* cluster,
+                   intptr_t start,
+                   intptr_t stop);
+  void FillClustersInParallel(const intptr_t* fill_offsets);
+
+  // Reports the time spent allocating and filling each cluster to
+  // StartupPhases.
+  void RecordClusterTimes();
+
   Heap* heap_;
   Zone* zone_;
   Snapshot::Kind kind_;
+  const uint8_t* buffer_;
+  intptr_t size_;
   ReadStream stream_;
   ImageReader* image_reader_;
   intptr_t num_base_objects_;
@@ -591,6 +650,10 @@ class Deserializer : public ThreadStackResource {
   RawArray* refs_;
   intptr_t next_ref_index_;
   DeserializationCluster** clusters_;
+  // Only allocated while startup phases are being recorded.
+  intptr_t* cluster_cids_ = nullptr;
+  int64_t* alloc_micros_ = nullptr;
+  int64_t* fill_micros_ = nullptr;
 };
 
 #define ReadFromTo(obj, ...) d->ReadFromTo(obj, ##__VA_ARGS__);
@@ -291,6 +291,11 @@ class CodeSourceMapReader : public ValueObject {
   void GetInlinedFunctionsAt(int32_t pc_offset,
                              GrowableArray<const Function*>* function_stack,
                              GrowableArray<TokenPosition>* token_positions);
+  // Appends the start of each range of instructions, with the innermost
+  // function they were compiled from and the position in that function.
+  void GetSourcePositions(GrowableArray<int32_t>* pc_offsets,
+                          GrowableArray<const Function*>* functions,
+                          GrowableArray<TokenPosition>* token_positions);
   NOT_IN_PRODUCT(void PrintJSONInlineIntervals(JSONObject* jsobj));
   void DumpInlineIntervals(uword start);
   void DumpSourcePositions(uword start);
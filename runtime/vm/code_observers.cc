@@ -27,7 +27,8 @@ class ExternalCodeObserverAdapter : public CodeObserver {
                       uword prologue_offset,
                       uword size,
                       bool optimized,
-                      const CodeComments* comments) {
+                      const CodeComments* comments,
+                      const CodeLineInfo* lines) {
     return delegate_->on_new_code(delegate_, name, base, size);
   }
 
@@ -54,12 +55,13 @@ void CodeObservers::NotifyAll(const char* name,
                               uword prologue_offset,
                               uword size,
                               bool optimized,
-                              const CodeComments* comments) {
+                              const CodeComments* comments,
+                              const CodeLineInfo* lines) {
   ASSERT(!AreActive() || (strlen(name) != 0));
   for (intptr_t i = 0; i < observers_length_; i++) {
     if (observers_[i]->IsActive()) {
       observers_[i]->Notify(name, base, prologue_offset, size, optimized,
-                            comments);
+                            comments, lines);
     }
   }
 }
@@ -71,6 +73,15 @@ bool CodeObservers::AreActive() {
   return false;
 }
 
+bool CodeObservers::WantLineInfo() {
+  for (intptr_t i = 0; i < observers_length_; i++) {
+    if (observers_[i]->IsActive() && observers_[i]->WantsLineInfo()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void CodeObservers::Cleanup() {
   for (intptr_t i = 0; i < observers_length_; i++) {
     delete observers_[i];
@@ -30,6 +30,21 @@ class CodeComments : public ValueObject {
 
 // Object observing code creation events. Used by external profilers and
 // debuggers to map address ranges to function names.
+// The Dart source lines that the instructions of a code object were compiled
+// from. Entries are sorted by pc offset, and each covers the instructions up
+// to the next one. Inlined code has the lines of the inlined function.
+class CodeLineInfo : public ValueObject {
+ public:
+  CodeLineInfo() = default;
+  virtual ~CodeLineInfo() = default;
+
+  virtual intptr_t Length() const = 0;
+  virtual intptr_t PCOffsetAt(intptr_t index) const = 0;
+  // The script's URI, or its path for file: URIs.
+  virtual const char* FileAt(intptr_t index) const = 0;
+  virtual intptr_t LineAt(intptr_t index) const = 0;
+};
+
 class CodeObserver {
  public:
   CodeObserver() {}
@@ -40,14 +55,19 @@ class CodeObserver {
   // about newly created code objects.
   virtual bool IsActive() const = 0;
 
+  // Returns true if this observer uses the lines passed to Notify, which are
+  // otherwise not computed.
+  virtual bool WantsLineInfo() const { return false; }
+
   // Notify code observer about a newly created code object with the
-  // given properties.
+  // given properties. lines is null if no active observer wants them.
   virtual void Notify(const char* name,
                       uword base,
                       uword prologue_offset,
                       uword size,
                       bool optimized,
-                      const CodeComments* comments) = 0;
+                      const CodeComments* comments,
+                      const CodeLineInfo* lines) = 0;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(CodeObserver);
@@ -67,11 +87,15 @@ class CodeObservers : public AllStatic {
                         uword prologue_offset,
                         uword size,
                         bool optimized,
-                        const CodeComments* comments);
+                        const CodeComments* comments,
+                        const CodeLineInfo* lines);
 
   // Returns true if there is at least one active code observer.
   static bool AreActive();
 
+  // Returns true if an active code observer wants source lines.
+  static bool WantLineInfo();
+
   static void Cleanup();
 
   static Mutex* mutex() { return mutex_; }
@@ -386,7 +386,7 @@ void CompilationTraceLoader::SpeculateInstanceCallTargets(
   if (sites_.IsNull()) {
     return;
   }
-  for (intptr_t i = 1; i < sites_.Length(); i++) {
+  for (intptr_t i = Function::kFirstICDataIndex; i < sites_.Length(); i++) {
     site_ ^= sites_.At(i);
     if (site_.rebind_rule() != ICData::kInstance) {
       continue;
@@ -456,6 +456,35 @@ static char* CompilerFlags() {
   return buffer.Steal();
 }
 
+// Version of the layout that follows the header. Bump when it changes.
+static const intptr_t kFeedbackFormatVersion = 2;
+
+// The kernel source fingerprint of |function|, or 0 for functions that have
+// no kernel declaration of their own (closures, dispatchers and other
+// synthetic functions, or functions declared in bytecode). Saved feedback is
+// only applied to a function while its fingerprint is unchanged, so that a
+// refreshed app-JIT snapshot can be trained with the feedback of a previous
+// run for the code that did not change.
+static int32_t FeedbackFingerprint(const Function& function) {
+  switch (function.kind()) {
+    case RawFunction::kRegularFunction:
+    case RawFunction::kGetterFunction:
+    case RawFunction::kSetterFunction:
+    case RawFunction::kConstructor:
+    case RawFunction::kImplicitGetter:
+    case RawFunction::kImplicitSetter:
+    case RawFunction::kImplicitStaticGetter:
+      break;
+    default:
+      return 0;
+  }
+  if (function.IsLocalFunction() || function.is_declared_in_bytecode() ||
+      (function.kernel_offset() <= 0)) {
+    return 0;
+  }
+  return function.SourceFingerprint();
+}
+
 void TypeFeedbackSaver::WriteHeader() {
   const char* expected_version = Version::SnapshotString();
   ASSERT(expected_version != NULL);
@@ -469,6 +498,8 @@ void TypeFeedbackSaver::WriteHeader() {
   stream_->WriteBytes(reinterpret_cast<const uint8_t*>(expected_features),
                       features_len + 1);
   free(expected_features);
+
+  WriteInt(kFeedbackFormatVersion);
 }
 
 void TypeFeedbackSaver::SaveClasses() {
@@ -519,6 +550,7 @@ void TypeFeedbackSaver::Visit(const Function& function) {
 
   WriteInt(function.kind());
   WriteInt(function.token_pos().value());
+  WriteInt(FeedbackFingerprint(function));
 
   code_ = function.CurrentCode();
   intptr_t usage = function.usage_counter();
@@ -538,9 +570,10 @@ void TypeFeedbackSaver::Visit(const Function& function) {
     call_sites_ = Object::empty_array().raw();  // Remove edge case.
   }
 
-  // First element is edge counters.
-  WriteInt(call_sites_.Length() - 1);
-  for (intptr_t i = 1; i < call_sites_.Length(); i++) {
+  // The ICData follow the edge counters and the coverage array.
+  WriteInt(call_sites_.Length() - Function::kFirstICDataIndex);
+  for (intptr_t i = Function::kFirstICDataIndex; i < call_sites_.Length();
+       i++) {
     call_site_ ^= call_sites_.At(i);
 
     WriteInt(call_site_.deopt_id());
@@ -694,8 +727,13 @@ RawObject* TypeFeedbackLoader::CheckHeader() {
       reinterpret_cast<const char*>(stream_->AddressOfCurrentPosition());
   ASSERT(features != NULL);
   intptr_t buffer_len = Utils::StrNLen(features, stream_->PendingBytes());
-  if ((buffer_len != expected_len) ||
-      strncmp(features, expected_features, expected_len)) {
+  // The precompiler runs with different flags than the training run (for
+  // example without field guards or OSR), so it cannot rely on matching deopt
+  // ids. Instead each call site is checked against the current program when
+  // the feedback is applied (see Precompiler::ApplyTypeFeedback).
+  if (!FLAG_precompiled_mode &&
+      ((buffer_len != expected_len) ||
+       strncmp(features, expected_features, expected_len))) {
     const String& msg = String::Handle(String::NewFormatted(
         Heap::kOld,
         "Feedback not compatible with the current VM configuration: "
@@ -706,7 +744,19 @@ RawObject* TypeFeedbackLoader::CheckHeader() {
     return ApiError::New(msg, Heap::kOld);
   }
   free(expected_features);
-  stream_->Advance(expected_len + 1);
+  stream_->Advance(buffer_len + 1);
+
+  const intptr_t format_version =
+      (stream_->PendingBytes() < static_cast<intptr_t>(sizeof(int32_t)))
+          ? -1
+          : ReadInt();
+  if (format_version != kFeedbackFormatVersion) {
+    const String& msg = String::Handle(String::NewFormatted(
+        Heap::kOld,
+        "Feedback format version %" Pd " is not supported, expected %" Pd,
+        format_version, kFeedbackFormatVersion));
+    return ApiError::New(msg, Heap::kOld);
+  }
   return Error::null();
 }
 
@@ -750,7 +800,9 @@ RawObject* TypeFeedbackLoader::LoadFields() {
       intptr_t guarded_cid = cid_map_[ReadInt()];
       intptr_t is_nullable = ReadInt();
 
-      if (skip) {
+      // The precompiler does not use field guards, so guarded cids from the
+      // training run would never be invalidated.
+      if (skip || FLAG_precompiled_mode) {
         continue;
       }
 
@@ -815,6 +867,7 @@ RawObject* TypeFeedbackLoader::LoadFunction() {
   func_name_ = ReadString();  // Without private mangling.
   RawFunction::Kind kind = static_cast<RawFunction::Kind>(ReadInt());
   intptr_t token_pos = ReadInt();
+  int32_t fingerprint = ReadInt();
   intptr_t usage = ReadInt();
   intptr_t inlining_depth = ReadInt();
   intptr_t num_call_sites = ReadInt();
@@ -827,9 +880,21 @@ RawObject* TypeFeedbackLoader::LoadFunction() {
         THR_Print("Missing function %s %s\n", func_name_.ToCString(),
                   Function::KindToCString(kind));
       }
+    } else if (FeedbackFingerprint(func_) != fingerprint) {
+      // The function changed since the feedback was saved, so its call sites
+      // and deopt ids may no longer line up with the feedback.
+      skip = true;
+      if (FLAG_trace_compilation_trace) {
+        THR_Print("Changed function %s %s\n", func_name_.ToCString(),
+                  Function::KindToCString(kind));
+      }
     }
   }
 
+  if (FLAG_precompiled_mode) {
+    return LoadFunctionForPrecompilation(skip, num_call_sites);
+  }
+
   if (!skip) {
     error_ = Compiler::CompileFunction(thread_, func_);
     if (error_.IsError()) {
@@ -839,7 +904,8 @@ RawObject* TypeFeedbackLoader::LoadFunction() {
     if (call_sites_.IsNull()) {
       call_sites_ = Object::empty_array().raw();  // Remove edge case.
     }
-    if (call_sites_.Length() != num_call_sites + 1) {
+    if (call_sites_.Length() !=
+        num_call_sites + Function::kFirstICDataIndex) {
       skip = true;
       if (FLAG_trace_compilation_trace) {
         THR_Print("Mismatched call site count %s %" Pd " %" Pd "\n",
@@ -848,8 +914,9 @@ RawObject* TypeFeedbackLoader::LoadFunction() {
     }
   }
 
-  // First element is edge counters.
-  for (intptr_t i = 1; i <= num_call_sites; i++) {
+  // The ICData follow the edge counters and the coverage array.
+  for (intptr_t i = Function::kFirstICDataIndex;
+       i < num_call_sites + Function::kFirstICDataIndex; i++) {
     intptr_t deopt_id = ReadInt();
     intptr_t rebind_rule = ReadInt();
     target_name_ = ReadString();
@@ -923,6 +990,89 @@ RawObject* TypeFeedbackLoader::LoadFunction() {
   return Error::null();
 }
 
+// Compiling the function here would produce AOT code without ICData, so the
+// feedback is kept in ObjectStore::type_feedback() instead, as a list of
+// (function, call sites) pairs. The call sites of a function are described
+// by kCallSiteEntryLength elements each:
+//
+//   [deopt id, target name, number of checked arguments, checks]
+//
+// where checks is an array of (count, class, ..., class) tuples. Classes are
+// kept rather than cids because the precompiler sorts the class table before
+// it turns these into ICData.
+RawObject* TypeFeedbackLoader::LoadFunctionForPrecompilation(
+    bool skip,
+    intptr_t num_call_sites) {
+  const Array& call_sites = Array::Handle(
+      zone_, skip ? Array::null()
+                  : Array::New(num_call_sites * kCallSiteEntryLength,
+                               Heap::kOld));
+  const GrowableObjectArray& checks =
+      GrowableObjectArray::Handle(zone_, GrowableObjectArray::New());
+  Array& call_site_checks = Array::Handle(zone_);
+  Smi& value = Smi::Handle(zone_);
+  bool has_checks = false;
+
+  for (intptr_t i = 0; i < num_call_sites; i++) {
+    intptr_t deopt_id = ReadInt();
+    ReadInt();  // Rebind rule.
+    target_name_ = ReadString();
+    intptr_t num_checked_arguments = ReadInt();
+    intptr_t num_entries = ReadInt();
+
+    checks.SetLength(0);
+    for (intptr_t entry_index = 0; entry_index < num_entries; entry_index++) {
+      intptr_t entry_usage = ReadInt();
+      const intptr_t start = checks.Length();
+      value = Smi::New(entry_usage);
+      checks.Add(value);
+      bool skip_entry = skip;
+      for (intptr_t argument_index = 0; argument_index < num_checked_arguments;
+           argument_index++) {
+        intptr_t cid = cid_map_[ReadInt()];
+        if (cid == kIllegalCid) {
+          skip_entry = true;
+        } else {
+          cls_ = thread_->isolate()->class_table()->At(cid);
+          checks.Add(cls_);
+        }
+      }
+      if (skip_entry) {
+        checks.SetLength(start);
+      }
+    }
+
+    if (skip) {
+      continue;
+    }
+
+    has_checks = has_checks || (checks.Length() > 0);
+    call_site_checks = Array::MakeFixedLength(checks);
+    const intptr_t base = i * kCallSiteEntryLength;
+    value = Smi::New(deopt_id);
+    call_sites.SetAt(base + kCallSiteDeoptId, value);
+    call_sites.SetAt(base + kCallSiteTargetName, target_name_);
+    value = Smi::New(num_checked_arguments);
+    call_sites.SetAt(base + kCallSiteNumArgsTested, value);
+    call_sites.SetAt(base + kCallSiteChecks, call_site_checks);
+  }
+
+  if (skip || !has_checks) {
+    return Error::null();
+  }
+
+  ObjectStore* object_store = thread_->isolate()->object_store();
+  GrowableObjectArray& feedback =
+      GrowableObjectArray::Handle(zone_, object_store->type_feedback());
+  if (feedback.IsNull()) {
+    feedback = GrowableObjectArray::New(Heap::kOld);
+    object_store->set_type_feedback(feedback);
+  }
+  feedback.Add(func_, Heap::kOld);
+  feedback.Add(call_sites, Heap::kOld);
+  return Error::null();
+}
+
 RawFunction* TypeFeedbackLoader::FindFunction(RawFunction::Kind kind,
                                               intptr_t token_pos) {
   if (cls_name_.Equals(Symbols::TopLevel())) {
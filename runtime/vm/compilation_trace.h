@@ -97,11 +97,21 @@ class TypeFeedbackLoader : public ValueObject {
 
   RawObject* LoadFeedback(ReadStream* stream);
 
+  // Layout of the call site entries recorded for the precompiler.
+  enum {
+    kCallSiteDeoptId,
+    kCallSiteTargetName,
+    kCallSiteNumArgsTested,
+    kCallSiteChecks,
+    kCallSiteEntryLength,
+  };
+
  private:
   RawObject* CheckHeader();
   RawObject* LoadClasses();
   RawObject* LoadFields();
   RawObject* LoadFunction();
+  RawObject* LoadFunctionForPrecompilation(bool skip, intptr_t num_call_sites);
   RawFunction* FindFunction(RawFunction::Kind kind, intptr_t token_pos);
 
   RawClass* ReadClassByName();
@@ -0,0 +1,180 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_DBC) &&                  \
+    !defined(TARGET_ARCH_IA32)
+
+#include "vm/compiler/aot/dispatch_table_generator.h"
+
+#include "vm/class_table.h"
+#include "vm/dart_entry.h"
+#include "vm/flags.h"
+#include "vm/isolate.h"
+#include "vm/log.h"
+#include "vm/megamorphic_cache_table.h"
+#include "vm/resolver.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            use_dispatch_table,
+            true,
+            "In AOT, look up the targets of megamorphic calls in a global "
+            "dispatch table.");
+DECLARE_FLAG(bool, trace_precompiler);
+
+DispatchTableGenerator::DispatchTableGenerator(Zone* zone)
+    : zone_(zone), selectors_(zone) {}
+
+void DispatchTableGenerator::AddSelectorsFrom(const ObjectPool& pool) {
+  Object& entry = Object::Handle(zone_);
+  for (intptr_t i = 0; i < pool.Length(); i++) {
+    if (pool.TypeAt(i) != ObjectPool::EntryType::kTaggedObject) {
+      continue;
+    }
+    entry = pool.ObjectAt(i);
+    if (!entry.IsICData()) {
+      continue;
+    }
+    // The only IC calls generated by precompilation are for switchable
+    // calls, i.e. dynamic calls which may become megamorphic.
+    const ICData& ic_data = ICData::Cast(entry);
+    Selector key = {&String::Handle(zone_, ic_data.target_name()),
+                    &Array::Handle(zone_, ic_data.arguments_descriptor())};
+    if (selectors_.HasKey(&key)) {
+      continue;
+    }
+    Selector* selector = new (zone_) Selector();
+    selector->name = &String::ZoneHandle(zone_, key.name->raw());
+    selector->arguments_descriptor =
+        &Array::ZoneHandle(zone_, key.arguments_descriptor->raw());
+    selectors_.Insert(selector);
+  }
+}
+
+int DispatchTableGenerator::CompareRowsBySize(const Row* a, const Row* b) {
+  // Place the largest rows first: they are the hardest to fit.
+  return b->cids->length() - a->cids->length();
+}
+
+intptr_t DispatchTableGenerator::FindRowOffset(
+    const Row& row,
+    const GrowableArray<const Row*>& slots,
+    const GrowableArray<bool>& used_offsets,
+    intptr_t bias) {
+  const ZoneGrowableArray<intptr_t>& cids = *row.cids;
+  for (intptr_t offset = -cids[0];; offset++) {
+    const intptr_t offset_index = offset + bias;
+    if (offset_index < used_offsets.length() && used_offsets[offset_index]) {
+      continue;
+    }
+    bool fits = true;
+    for (intptr_t i = 0; i < cids.length(); i++) {
+      const intptr_t slot = offset + cids[i];
+      if (slot < slots.length() && slots[slot] != nullptr) {
+        fits = false;
+        break;
+      }
+    }
+    if (fits) {
+      return offset;
+    }
+  }
+}
+
+void DispatchTableGenerator::Generate() {
+  if (!FLAG_use_dispatch_table) {
+    return;
+  }
+
+  Thread* thread = Thread::Current();
+  Isolate* isolate = thread->isolate();
+  ClassTable* class_table = isolate->class_table();
+  const intptr_t num_cids = class_table->NumCids();
+
+  // Resolve the targets of every selector for all allocated classes. Calls
+  // to selectors with few receiver classes stay polymorphic, so they don't
+  // need a row.
+  GrowableArray<Row> rows(zone_, selectors_.Length());
+  Class& cls = Class::Handle(zone_);
+  Function& target = Function::Handle(zone_);
+  auto it = selectors_.GetIterator();
+  for (const Selector** selector = it.Next(); selector != nullptr;
+       selector = it.Next()) {
+    const ArgumentsDescriptor args_desc(*(*selector)->arguments_descriptor);
+    Row row = {*selector, new (zone_) ZoneGrowableArray<intptr_t>(zone_, 4),
+               new (zone_) ZoneGrowableArray<const Function*>(zone_, 4),
+               /*offset=*/0};
+    for (intptr_t cid = kInstanceCid; cid < num_cids; cid++) {
+      if (!class_table->HasValidClassAt(cid)) continue;
+      cls = class_table->At(cid);
+      if (!cls.is_allocated() || cls.is_abstract()) continue;
+      target = Resolver::ResolveDynamicForReceiverClass(
+          cls, *(*selector)->name, args_desc, /*allow_add=*/false);
+      if (target.IsNull() || !target.HasCode()) continue;
+      row.cids->Add(cid);
+      row.targets->Add(&Function::ZoneHandle(zone_, target.raw()));
+    }
+    if (row.cids->length() > FLAG_max_polymorphic_checks) {
+      rows.Add(row);
+    }
+  }
+  if (rows.is_empty()) {
+    return;
+  }
+  rows.Sort(CompareRowsBySize);
+
+  // Place the rows. Offsets have to be unique since a slot is identified as
+  // belonging to a row by its offset.
+  GrowableArray<const Row*> slots(zone_, num_cids);
+  GrowableArray<bool> used_offsets(zone_, num_cids);
+  const intptr_t bias = num_cids;
+  intptr_t num_entries = 0;
+  for (intptr_t i = 0; i < rows.length(); i++) {
+    Row& row = rows[i];
+    row.offset = FindRowOffset(row, slots, used_offsets, bias);
+    while (used_offsets.length() <= row.offset + bias) {
+      used_offsets.Add(false);
+    }
+    used_offsets[row.offset + bias] = true;
+    for (intptr_t j = 0; j < row.cids->length(); j++) {
+      const intptr_t slot = row.offset + row.cids->At(j);
+      while (slots.length() <= slot) {
+        slots.Add(nullptr);
+      }
+      slots[slot] = &row;
+    }
+    num_entries += row.cids->length();
+  }
+
+  const Array& table = Array::Handle(
+      zone_, Array::New(slots.length() * MegamorphicCache::kEntryLength,
+                        Heap::kOld));
+  MegamorphicCache& cache = MegamorphicCache::Handle(zone_);
+  Smi& row_offset = Smi::Handle(zone_);
+  for (intptr_t i = 0; i < rows.length(); i++) {
+    const Row& row = rows[i];
+    row_offset = Smi::New(row.offset);
+    for (intptr_t j = 0; j < row.cids->length(); j++) {
+      const intptr_t slot = row.offset + row.cids->At(j);
+      table.SetAt(slot * MegamorphicCache::kEntryLength, row_offset);
+      table.SetAt(slot * MegamorphicCache::kEntryLength + 1,
+                  *row.targets->At(j));
+    }
+    cache = MegamorphicCacheTable::Lookup(isolate, *row.selector->name,
+                                          *row.selector->arguments_descriptor);
+    cache.SetDispatchTableRow(table, row.offset);
+  }
+
+  if (FLAG_trace_precompiler) {
+    THR_Print("Dispatch table: %" Pd " rows, %" Pd " of %" Pd
+              " slots used.\n",
+              rows.length(), num_entries, slots.length());
+  }
+}
+
+}  // namespace dart
+
+#endif  // defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_DBC) &&           \
+        // !defined(TARGET_ARCH_IA32)
@@ -0,0 +1,88 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_AOT_DISPATCH_TABLE_GENERATOR_H_
+#define RUNTIME_VM_COMPILER_AOT_DISPATCH_TABLE_GENERATOR_H_
+
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+#include "vm/hash_map.h"
+#include "vm/object.h"
+
+namespace dart {
+
+// Builds the global dispatch table used by megamorphic calls in AOT.
+//
+// Every selector (a name together with an arguments descriptor) which may be
+// called on many receiver classes gets a row: the targets for all receiver
+// classes are stored at index `cid + row` of one shared table. Rows are
+// placed with row displacement, i.e. each row is fitted into the unused slots
+// left by the rows placed before it. Each slot holds the row it belongs to
+// and the target [Function]:
+//
+//   [row (Smi), target (Function), row (Smi), target (Function), ...]
+//
+// so a megamorphic call finds its target with one indexed load and a check
+// of the row. The [MegamorphicCache] of each selector with a row refers to
+// the table; calls through it fall back to probing the cache if the slot for
+// the receiver class belongs to another row.
+class DispatchTableGenerator : public ValueObject {
+ public:
+  explicit DispatchTableGenerator(Zone* zone);
+
+  // Records the selectors of all dynamic calls in [pool].
+  void AddSelectorsFrom(const ObjectPool& pool);
+
+  // Builds the table for the recorded selectors and attaches it to their
+  // megamorphic caches.
+  void Generate();
+
+ private:
+  struct Selector {
+    const String* name;
+    const Array* arguments_descriptor;
+  };
+
+  class SelectorTrait {
+   public:
+    typedef const Selector* Value;
+    typedef const Selector* Key;
+    typedef const Selector* Pair;
+
+    static Key KeyOf(Pair kv) { return kv; }
+    static Value ValueOf(Pair kv) { return kv; }
+    static intptr_t Hashcode(Key key) { return key->name->Hash(); }
+    static bool IsKeyEqual(Pair kv, Key key) {
+      return (kv->name->raw() == key->name->raw()) &&
+             (kv->arguments_descriptor->raw() ==
+              key->arguments_descriptor->raw());
+    }
+  };
+
+  struct Row {
+    const Selector* selector;
+    // Receiver class ids in increasing order.
+    ZoneGrowableArray<intptr_t>* cids;
+    ZoneGrowableArray<const Function*>* targets;
+    intptr_t offset;
+  };
+
+  static int CompareRowsBySize(const Row* a, const Row* b);
+
+  // Returns the smallest unused row offset at which all entries of [row] fit
+  // into free slots of [slots]. [used_offsets] is indexed by offset + [bias].
+  static intptr_t FindRowOffset(const Row& row,
+                                const GrowableArray<const Row*>& slots,
+                                const GrowableArray<bool>& used_offsets,
+                                intptr_t bias);
+
+  Zone* zone_;
+  DirectChainedHashMap<SelectorTrait> selectors_;
+
+  DISALLOW_COPY_AND_ASSIGN(DispatchTableGenerator);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_AOT_DISPATCH_TABLE_GENERATOR_H_
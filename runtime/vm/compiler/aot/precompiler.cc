@@ -7,10 +7,13 @@
 #include "platform/unicode.h"
 #include "vm/class_finalizer.h"
 #include "vm/code_patcher.h"
+#include "vm/compilation_trace.h"
 #include "vm/compiler/aot/aot_call_specializer.h"
+#include "vm/compiler/aot/dispatch_table_generator.h"
 #include "vm/compiler/assembler/assembler.h"
 #include "vm/compiler/assembler/disassembler.h"
 #include "vm/compiler/backend/block_scheduler.h"
+#include "vm/compiler/backend/call_effects.h"
 #include "vm/compiler/backend/branch_optimizer.h"
 #include "vm/compiler/backend/constant_propagator.h"
 #include "vm/compiler/backend/flow_graph.h"
@@ -27,12 +30,15 @@
 #include "vm/compiler/frontend/flow_graph_builder.h"
 #include "vm/compiler/frontend/kernel_to_il.h"
 #include "vm/compiler/jit/compiler.h"
+#include "vm/dart.h"
 #include "vm/dart_entry.h"
 #include "vm/exceptions.h"
 #include "vm/flags.h"
 #include "vm/hash_table.h"
+#include "vm/heap/safepoint.h"
 #include "vm/isolate.h"
 #include "vm/kernel_loader.h"  // For kernel::ParseStaticFieldInitializer.
+#include "vm/lockers.h"
 #include "vm/log.h"
 #include "vm/longjump.h"
 #include "vm/object.h"
@@ -46,6 +52,7 @@
 #include "vm/runtime_entry.h"
 #include "vm/symbols.h"
 #include "vm/tags.h"
+#include "vm/thread_pool.h"
 #include "vm/timeline.h"
 #include "vm/timer.h"
 #include "vm/type_table.h"
@@ -66,6 +73,12 @@ DEFINE_FLAG(
     max_speculative_inlining_attempts,
     1,
     "Max number of attempts with speculative inlining (precompilation only)");
+DEFINE_FLAG(int,
+            precompiler_tasks,
+            0,
+            "Number of helper threads used to compile functions in parallel "
+            "during precompilation. 0 compiles every function on the main "
+            "thread.");
 
 DECLARE_FLAG(bool, print_flow_graph);
 DECLARE_FLAG(bool, print_flow_graph_optimized);
@@ -94,10 +107,14 @@ class PrecompileParsedFunctionHelper : public ValueObject {
  public:
   PrecompileParsedFunctionHelper(Precompiler* precompiler,
                                  ParsedFunction* parsed_function,
-                                 bool optimized)
+                                 bool optimized,
+                                 PrecompilerWave* wave = nullptr,
+                                 intptr_t wave_index = -1)
       : precompiler_(precompiler),
         parsed_function_(parsed_function),
         optimized_(optimized),
+        wave_(wave),
+        wave_index_(wave_index),
         thread_(Thread::Current()) {}
 
   bool Compile(CompilationPipeline* pipeline);
@@ -116,11 +133,161 @@ class PrecompileParsedFunctionHelper : public ValueObject {
   Precompiler* precompiler_;
   ParsedFunction* parsed_function_;
   const bool optimized_;
+  PrecompilerWave* const wave_;
+  const intptr_t wave_index_;
   Thread* const thread_;
 
   DISALLOW_COPY_AND_ASSIGN(PrecompileParsedFunctionHelper);
 };
 
+// A batch of functions compiled by the helper threads of
+// --precompiler_tasks, one function per helper.
+//
+// The helpers build and optimize the flow graphs of all functions of the
+// batch in parallel. Code generation is then handed to one helper at a time,
+// in the order in which the main thread took the functions off the worklist.
+// Since no code is installed before every flow graph of the batch has been
+// optimized, and the global object pool is only used during code generation,
+// the generated code is the same in every run.
+class PrecompilerWave : public ValueObject {
+ public:
+  enum Status {
+    kOptimizing,  // The flow graph is being built and optimized.
+    kReady,       // Waiting for the turn to generate code.
+    kDone,        // The code is installed.
+    kFailed,      // The helper bailed out.
+  };
+
+  PrecompilerWave(Thread* thread,
+                  const GrowableArray<const Function*>& functions)
+      : functions_(functions),
+        type_usage_info_(thread->type_usage_info()),
+        status_(functions.length()),
+        num_optimizing_(functions.length()),
+        num_running_(functions.length()),
+        turn_(-1),
+        canceled_(false) {
+    for (intptr_t i = 0; i < functions.length(); i++) {
+      status_.Add(kOptimizing);
+    }
+  }
+
+  intptr_t length() const { return functions_.length(); }
+
+  RawFunction* FunctionAt(intptr_t index) const {
+    return functions_[index]->raw();
+  }
+
+  // Called by the helper of [index] once its flow graph is optimized. Returns
+  // false if the batch was canceled before the helper got its turn.
+  bool WaitForTurn(Thread* thread, intptr_t index) {
+    MonitorLocker ml(&monitor_);
+    if (turn_ == index) {
+      // Compilation is retried, e.g. with far branches.
+      return true;
+    }
+    ASSERT(status_[index] == kOptimizing);
+    status_[index] = kReady;
+    num_optimizing_--;
+    ml.NotifyAll();
+    while ((turn_ != index) && !canceled_) {
+      ml.WaitWithSafepointCheck(thread);
+    }
+    if (canceled_) {
+      return false;
+    }
+    // The types used by the generated code are collected by the main thread.
+    thread->set_type_usage_info(type_usage_info_);
+    return true;
+  }
+
+  // Called by the helper of [index] when it is done with the function.
+  void Finish(Thread* thread, intptr_t index, bool compiled) {
+    if (thread->type_usage_info() != nullptr) {
+      thread->set_type_usage_info(nullptr);
+    }
+    MonitorLocker ml(&monitor_);
+    if (status_[index] == kOptimizing) {
+      num_optimizing_--;
+    }
+    status_[index] = compiled ? kDone : kFailed;
+    num_running_--;
+    ml.NotifyAll();
+  }
+
+  // Waits until the flow graphs of all functions are optimized.
+  void WaitUntilOptimized(Thread* thread) {
+    MonitorLocker ml(&monitor_);
+    while (num_optimizing_ > 0) {
+      ml.WaitWithSafepointCheck(thread);
+    }
+  }
+
+  // Lets the helper of [index] generate and install its code.
+  Status GenerateCode(Thread* thread, intptr_t index) {
+    MonitorLocker ml(&monitor_);
+    ASSERT(num_optimizing_ == 0);
+    if (status_[index] == kReady) {
+      turn_ = index;
+      ml.NotifyAll();
+      while (status_[index] == kReady) {
+        ml.WaitWithSafepointCheck(thread);
+      }
+    }
+    return status_[index];
+  }
+
+  // Makes the helpers that are still waiting for their turn bail out, and
+  // waits until all helpers are done.
+  void Stop(Thread* thread) {
+    MonitorLocker ml(&monitor_);
+    canceled_ = true;
+    ml.NotifyAll();
+    while (num_running_ > 0) {
+      ml.WaitWithSafepointCheck(thread);
+    }
+  }
+
+ private:
+  const GrowableArray<const Function*>& functions_;
+  TypeUsageInfo* const type_usage_info_;
+  Monitor monitor_;
+  GrowableArray<Status> status_;
+  intptr_t num_optimizing_;
+  intptr_t num_running_;
+  intptr_t turn_;
+  bool canceled_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrecompilerWave);
+};
+
+// Compiles one function of a [PrecompilerWave] on a helper thread.
+class PrecompilerTask : public ThreadPool::Task {
+ public:
+  PrecompilerTask(Precompiler* precompiler,
+                  Isolate* isolate,
+                  PrecompilerWave* wave,
+                  intptr_t index)
+      : precompiler_(precompiler),
+        isolate_(isolate),
+        wave_(wave),
+        index_(index) {}
+
+  virtual void Run();
+
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kHighPriority;
+  }
+
+ private:
+  Precompiler* precompiler_;
+  Isolate* isolate_;
+  PrecompilerWave* wave_;
+  const intptr_t index_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrecompilerTask);
+};
+
 static void Jump(const Error& error) {
   Thread::Current()->long_jump_base()->Jump(1, error);
 }
@@ -162,6 +329,8 @@ Precompiler::Precompiler(Thread* thread)
       typeargs_to_retain_(),
       types_to_retain_(),
       consts_to_retain_(),
+      type_feedback_(),
+      function_effects_(),
       error_(Error::Handle()),
       get_runtime_type_is_unique_(false) {
   ASSERT(Precompiler::singleton_ == NULL);
@@ -198,6 +367,8 @@ void Precompiler::DoCompileAll() {
 
       ClassFinalizer::SortClasses();
 
+      CollectTypeFeedback();
+
       // Collects type usage information which allows us to decide when/how to
       // optimize runtime type tests.
       TypeUsageInfo type_usage_info(T);
@@ -269,6 +440,42 @@ void Precompiler::DoCompileAll() {
         stub_code = StubCode::BuildIsolateSpecificArrayWriteBarrierStub(
             global_object_pool_builder());
         I->object_store()->set_array_write_barrier_stub(stub_code);
+
+        stub_code = StubCode::BuildIsolateSpecificAllocateArrayStub(
+            global_object_pool_builder());
+        I->object_store()->set_allocate_array_stub(stub_code);
+
+        stub_code = StubCode::BuildIsolateSpecificAllocateContextStub(
+            global_object_pool_builder());
+        I->object_store()->set_allocate_context_stub(stub_code);
+
+        stub_code = StubCode::BuildIsolateSpecificCallBootstrapNativeStub(
+            global_object_pool_builder());
+        I->object_store()->set_call_bootstrap_native_stub(stub_code);
+
+        stub_code = StubCode::BuildIsolateSpecificCallAutoScopeNativeStub(
+            global_object_pool_builder());
+        I->object_store()->set_call_auto_scope_native_stub(stub_code);
+
+        stub_code = StubCode::BuildIsolateSpecificCallNoScopeNativeStub(
+            global_object_pool_builder());
+        I->object_store()->set_call_no_scope_native_stub(stub_code);
+
+        stub_code = StubCode::BuildIsolateSpecificSubtype1TestCacheStub(
+            global_object_pool_builder());
+        I->object_store()->set_subtype1_test_cache_stub(stub_code);
+
+        stub_code = StubCode::BuildIsolateSpecificSubtype2TestCacheStub(
+            global_object_pool_builder());
+        I->object_store()->set_subtype2_test_cache_stub(stub_code);
+
+        stub_code = StubCode::BuildIsolateSpecificSubtype4TestCacheStub(
+            global_object_pool_builder());
+        I->object_store()->set_subtype4_test_cache_stub(stub_code);
+
+        stub_code = StubCode::BuildIsolateSpecificSubtype6TestCacheStub(
+            global_object_pool_builder());
+        I->object_store()->set_subtype6_test_cache_stub(stub_code);
       }
 
       CollectDynamicFunctionNames();
@@ -302,6 +509,7 @@ void Precompiler::DoCompileAll() {
 
       I->set_compilation_allowed(false);
 
+      CollectDeferredLibraries();
       TraceForRetainedFunctions();
       DropFunctions();
       DropFields();
@@ -337,6 +545,7 @@ void Precompiler::DoCompileAll() {
     DropLibraries();
 
     BindStaticCalls();
+    GenerateDispatchTable();
     SwitchICCalls();
     Obfuscate();
 
@@ -443,8 +652,12 @@ void Precompiler::Iterate() {
     changed_ = false;
 
     while (pending_functions_.Length() > 0) {
-      function ^= pending_functions_.RemoveLast();
-      ProcessFunction(function);
+      if (FLAG_precompiler_tasks > 0) {
+        ProcessFunctionsInParallel();
+      } else {
+        function ^= pending_functions_.RemoveLast();
+        ProcessFunction(function);
+      }
     }
 
     CheckForNewDynamicFunctions();
@@ -513,7 +726,44 @@ void Precompiler::CollectCallbackFields() {
   }
 }
 
-void Precompiler::ProcessFunction(const Function& function) {
+void Precompiler::ProcessFunctionsInParallel() {
+  HANDLESCOPE(T);
+
+  // Take as many functions off the worklist as there are helpers. The
+  // functions are processed in the order in which they were taken.
+  GrowableArray<const Function*> functions;
+  GrowableArray<const Function*> batch;
+  GrowableArray<intptr_t> batch_indices;
+  while ((functions.length() < FLAG_precompiler_tasks) &&
+         (pending_functions_.Length() > 0)) {
+    Function& function = Function::Handle(Z);
+    function ^= pending_functions_.RemoveLast();
+    functions.Add(&function);
+    if (function.HasCode()) {
+      batch_indices.Add(-1);
+    } else {
+      batch_indices.Add(batch.length());
+      batch.Add(&function);
+    }
+  }
+
+  PrecompilerWave wave(T, batch);
+  for (intptr_t i = 0; i < batch.length(); i++) {
+    bool result =
+        Dart::thread_pool()->Run<PrecompilerTask>(this, I, &wave, i);
+    ASSERT(result);
+  }
+  wave.WaitUntilOptimized(T);
+
+  for (intptr_t i = 0; i < functions.length(); i++) {
+    ProcessFunction(*functions[i], &wave, batch_indices[i]);
+  }
+  wave.Stop(T);
+}
+
+void Precompiler::ProcessFunction(const Function& function,
+                                  PrecompilerWave* wave,
+                                  intptr_t wave_index) {
   const intptr_t gop_offset =
       FLAG_use_bare_instructions ? global_object_pool_builder()->CurrentLength()
                                  : 0;
@@ -531,9 +781,17 @@ void Precompiler::ProcessFunction(const Function& function) {
     ASSERT(!function.is_abstract());
     ASSERT(!function.IsRedirectingFactory());
 
-    error_ = CompileFunction(this, thread_, zone_, function);
-    if (!error_.IsNull()) {
-      Jump(error_);
+    // Functions the helper could not compile are compiled again here, which
+    // also reports their compile-time errors.
+    if ((wave == nullptr) ||
+        (wave->GenerateCode(T, wave_index) != PrecompilerWave::kDone)) {
+      error_ = CompileFunction(this, thread_, zone_, function);
+      if (!error_.IsNull()) {
+        if (wave != nullptr) {
+          wave->Stop(T);
+        }
+        Jump(error_);
+      }
     }
     // Used in the JIT to save type-feedback across compilations.
     function.ClearICDataArray();
@@ -1850,6 +2108,82 @@ void Precompiler::DropClasses() {
   }
 }
 
+// Libraries reachable from the root library through imports and exports
+// that are not deferred are loaded eagerly. The remaining libraries can only
+// be reached through a deferred import (or not at all, in which case their
+// code is dropped), so the serializer places their code after all eagerly
+// loaded code, one library after another.
+void Precompiler::CollectDeferredLibraries() {
+  const intptr_t num_libraries = libraries_.Length();
+  GrowableArray<bool> eager(num_libraries);
+  for (intptr_t i = 0; i < num_libraries; i++) {
+    eager.Add(false);
+  }
+
+  GrowableObjectArray& worklist =
+      GrowableObjectArray::Handle(Z, GrowableObjectArray::New());
+  Library& lib = Library::Handle(Z);
+  auto enqueue = [&](const Library& library) {
+    if (!library.IsNull() && (library.index() >= 0) &&
+        (library.index() < num_libraries) && !eager[library.index()]) {
+      eager[library.index()] = true;
+      worklist.Add(library);
+    }
+  };
+
+  lib = I->object_store()->root_library();
+  enqueue(lib);
+  for (intptr_t i = 0; i < num_libraries; i++) {
+    lib ^= libraries_.At(i);
+    if (lib.is_dart_scheme()) {
+      enqueue(lib);
+    }
+  }
+
+  Library& target = Library::Handle(Z);
+  Array& exports = Array::Handle(Z);
+  Namespace& ns = Namespace::Handle(Z);
+  LibraryPrefix& prefix = LibraryPrefix::Handle(Z);
+  while (worklist.Length() > 0) {
+    lib ^= worklist.RemoveLast();
+    for (intptr_t i = 0; i < lib.num_imports(); i++) {
+      target = lib.ImportLibraryAt(i);
+      enqueue(target);
+    }
+    exports = lib.exports();
+    for (intptr_t i = 0; i < exports.Length(); i++) {
+      ns ^= exports.At(i);
+      target = ns.library();
+      enqueue(target);
+    }
+    LibraryPrefixIterator it(lib);
+    while (it.HasNext()) {
+      prefix = it.GetNext();
+      if (prefix.is_deferred_load()) {
+        continue;
+      }
+      for (intptr_t i = 0; i < prefix.num_imports(); i++) {
+        target = prefix.GetLibrary(i);
+        enqueue(target);
+      }
+    }
+  }
+
+  const GrowableObjectArray& deferred =
+      GrowableObjectArray::Handle(Z, GrowableObjectArray::New());
+  for (intptr_t i = 0; i < num_libraries; i++) {
+    if (!eager[i]) {
+      lib ^= libraries_.At(i);
+      deferred.Add(lib);
+      if (FLAG_trace_precompiler) {
+        THR_Print("Deferred library %s\n", lib.ToCString());
+      }
+    }
+  }
+  I->object_store()->set_deferred_libraries(
+      Array::Handle(Z, Array::MakeFixedLength(deferred)));
+}
+
 void Precompiler::DropLibraries() {
   const GrowableObjectArray& retained_libraries =
       GrowableObjectArray::Handle(Z, GrowableObjectArray::New());
@@ -1986,6 +2320,48 @@ void Precompiler::BindStaticCalls() {
   }
 }
 
+void Precompiler::GenerateDispatchTable() {
+  ASSERT(!I->compilation_allowed());
+  // Must run before [SwitchICCalls] replaces the ICData of the switchable
+  // calls, which name their selectors.
+  class CollectSelectorsVisitor : public FunctionVisitor {
+   public:
+    CollectSelectorsVisitor(DispatchTableGenerator* generator, Zone* zone)
+        : generator_(generator),
+          code_(Code::Handle(zone)),
+          pool_(ObjectPool::Handle(zone)) {}
+
+    void Visit(const Function& function) {
+      if (!function.HasCode()) {
+        return;
+      }
+      code_ = function.CurrentCode();
+      pool_ = code_.object_pool();
+      generator_->AddSelectorsFrom(pool_);
+    }
+
+   private:
+    DispatchTableGenerator* generator_;
+    Code& code_;
+    ObjectPool& pool_;
+  };
+
+  DispatchTableGenerator generator(Z);
+  auto& gop = ObjectPool::Handle(I->object_store()->global_object_pool());
+  if (FLAG_use_bare_instructions) {
+    generator.AddSelectorsFrom(gop);
+  } else {
+    CollectSelectorsVisitor visitor(&generator, Z);
+    ProgramVisitor::VisitFunctions(&visitor);
+    FunctionSet::Iterator it(enqueued_functions_.GetIterator());
+    for (const Function** current = it.Next(); current != NULL;
+         current = it.Next()) {
+      visitor.Visit(**current);
+    }
+  }
+  generator.Generate();
+}
+
 void Precompiler::SwitchICCalls() {
   ASSERT(!I->compilation_allowed());
 #if !defined(TARGET_ARCH_DBC)
@@ -2179,6 +2555,144 @@ void Precompiler::FinalizeAllClasses() {
   I->set_all_classes_finalized(true);
 }
 
+void Precompiler::CollectTypeFeedback() {
+  const GrowableObjectArray& feedback =
+      GrowableObjectArray::Handle(Z, I->object_store()->type_feedback());
+  if (feedback.IsNull()) {
+    return;
+  }
+  for (intptr_t i = 0; i < feedback.Length(); i += 2) {
+    Function& function = Function::ZoneHandle(Z);
+    function ^= feedback.At(i);
+    Array& call_sites = Array::ZoneHandle(Z);
+    call_sites ^= feedback.At(i + 1);
+    type_feedback_.Insert(
+        FunctionFeedbackKeyValueTrait::Pair(&function, &call_sites));
+  }
+  // The feedback is reachable from [type_feedback_] now and must not be
+  // retained by the snapshot.
+  I->object_store()->set_type_feedback(GrowableObjectArray::Handle(Z));
+}
+
+void Precompiler::RecordEffects(const Function& function,
+                                const CallEffects& effects) {
+  if (function_effects_.HasKey(&function)) {
+    return;
+  }
+  function_effects_.Insert(FunctionEffectsKeyValueTrait::Pair(
+      &Function::ZoneHandle(Z, function.raw()), effects.CopyTo(Z)));
+}
+
+void Precompiler::ApplyTypeFeedback(FlowGraph* flow_graph) {
+  const Function& function = flow_graph->function();
+  const FunctionFeedbackKeyValueTrait::Pair* pair =
+      type_feedback_.Lookup(&function);
+  if (pair == nullptr) {
+    return;
+  }
+  const Array& call_sites = *pair->value;
+
+  // Map deopt ids to the start of the corresponding call site entries.
+  IntMap<intptr_t> call_site_index;
+  for (intptr_t i = 0; i < call_sites.Length();
+       i += TypeFeedbackLoader::kCallSiteEntryLength) {
+    call_site_index.Insert(
+        Smi::Value(Smi::RawCast(
+            call_sites.At(i + TypeFeedbackLoader::kCallSiteDeoptId))),
+        i);
+  }
+
+  String& target_name = String::Handle(Z);
+  String& feedback_name = String::Handle(Z);
+  Array& checks = Array::Handle(Z);
+  Array& args_desc = Array::Handle(Z);
+  Class& cls = Class::Handle(Z);
+  Function& target = Function::Handle(Z);
+  GrowableArray<intptr_t> class_ids;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      InstanceCallInstr* instance_call = it.Current()->AsInstanceCall();
+      StaticCallInstr* static_call = it.Current()->AsStaticCall();
+      const ICData* ic_data = nullptr;
+      if (instance_call != nullptr) {
+        ic_data = instance_call->ic_data();
+      } else if (static_call != nullptr) {
+        ic_data = static_call->ic_data();
+      }
+      if ((ic_data == nullptr) || (ic_data->deopt_id() == DeoptId::kNone)) {
+        continue;
+      }
+      const auto call_site = call_site_index.LookupPair(ic_data->deopt_id());
+      if (call_site == nullptr) {
+        continue;
+      }
+
+      // Deopt ids are not guaranteed to match between the training run and
+      // the precompiler, so only use call sites that agree on the selector
+      // and on the number of checked arguments.
+      const intptr_t base = call_site->value;
+      const intptr_t num_args_tested = ic_data->NumArgsTested();
+      target_name = ic_data->target_name();
+      feedback_name ^=
+          call_sites.At(base + TypeFeedbackLoader::kCallSiteTargetName);
+      if ((Smi::Value(Smi::RawCast(call_sites.At(
+               base + TypeFeedbackLoader::kCallSiteNumArgsTested))) !=
+           num_args_tested) ||
+          !String::EqualsIgnoringPrivateKey(target_name, feedback_name)) {
+        if (FLAG_trace_precompiler) {
+          THR_Print("Mismatched type feedback for %s in %s\n",
+                    target_name.ToCString(), function.ToQualifiedCString());
+        }
+        continue;
+      }
+      checks ^= call_sites.At(base + TypeFeedbackLoader::kCallSiteChecks);
+
+      const ICData& feedback = ICData::ZoneHandle(
+          Z, ICData::NewFrom(*ic_data, num_args_tested));
+      if (static_call != nullptr) {
+        // Static calls only contribute how often they were executed.
+        intptr_t count = 0;
+        for (intptr_t i = 0; i < checks.Length(); i += num_args_tested + 1) {
+          count += Smi::Value(Smi::RawCast(checks.At(i)));
+        }
+        feedback.AddTarget(static_call->function());
+        feedback.SetCountAt(0, count);
+        static_call->set_ic_data(&feedback);
+        continue;
+      }
+
+      if (num_args_tested == 0) {
+        continue;
+      }
+      args_desc = ic_data->arguments_descriptor();
+      for (intptr_t i = 0; i < checks.Length(); i += num_args_tested + 1) {
+        class_ids.Clear();
+        for (intptr_t j = 1; j <= num_args_tested; j++) {
+          cls ^= checks.At(i + j);
+          class_ids.Add(cls.id());
+        }
+        cls ^= checks.At(i + 1);
+        target = Resolver::ResolveDynamicForReceiverClass(
+            cls, target_name, ArgumentsDescriptor(args_desc));
+        if (target.IsNull()) {
+          continue;
+        }
+        const intptr_t count = Smi::Value(Smi::RawCast(checks.At(i)));
+        if (num_args_tested == 1) {
+          feedback.AddReceiverCheck(class_ids[0], target, count);
+        } else {
+          feedback.AddCheck(class_ids, target, count);
+        }
+      }
+      if (!feedback.NumberOfChecksIs(0)) {
+        instance_call->set_ic_data(&feedback);
+      }
+    }
+  }
+}
+
 
 void PrecompileParsedFunctionHelper::FinalizeCompilation(
     Assembler* assembler,
@@ -2220,7 +2734,7 @@ void PrecompileParsedFunctionHelper::FinalizeCompilation(
 
   if (optimized()) {
     // Installs code while at safepoint.
-    ASSERT(thread()->IsMutatorThread());
+    ASSERT(thread()->IsMutatorThread() || thread()->IsAtSafepoint());
     function.InstallOptimizedCode(code);
   } else {  // not optimized.
     function.set_unoptimized_code(code);
@@ -2262,6 +2776,7 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
     if (val == 0) {
       FlowGraph* flow_graph = nullptr;
       ZoneGrowableArray<const ICData*>* ic_data_array = nullptr;
+      CallEffects* effects = nullptr;
 
       CompilerState compiler_state(thread());
 
@@ -2276,6 +2791,9 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
 
       if (optimized()) {
         flow_graph->PopulateWithICData(parsed_function()->function());
+        if (precompiler_ != nullptr) {
+          precompiler_->ApplyTypeFeedback(flow_graph);
+        }
       }
 
       const bool print_flow_graph =
@@ -2312,6 +2830,7 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
         pass_state.call_specializer = &call_specializer;
 
         CompilerPass::RunPipeline(CompilerPass::kAOT, &pass_state);
+        effects = CallEffects::Compute(flow_graph);
       }
 
       ASSERT(pass_state.inline_id_to_function.length() ==
@@ -2319,6 +2838,11 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
 
       ASSERT(!FLAG_use_bare_instructions || precompiler_ != nullptr);
 
+      if ((wave_ != nullptr) && !wave_->WaitForTurn(thread(), wave_index_)) {
+        Compiler::AbortBackgroundCompilation(DeoptId::kNone,
+                                             "Precompiler batch canceled");
+      }
+
       ObjectPoolBuilder object_pool;
       ObjectPoolBuilder* active_object_pool_builder =
           FLAG_use_bare_instructions
@@ -2345,9 +2869,22 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
       }
       {
         TIMELINE_DURATION(thread(), CompilerVerbose, "FinalizeCompilation");
-        ASSERT(thread()->IsMutatorThread());
-        FinalizeCompilation(&assembler, &graph_compiler, flow_graph,
-                            function_stats);
+        if (thread()->IsMutatorThread()) {
+          FinalizeCompilation(&assembler, &graph_compiler, flow_graph,
+                              function_stats);
+        } else {
+          // Helpers of --precompiler_tasks create the instructions and
+          // install the code at a safepoint, like the background compiler.
+          SafepointOperationScope safepoint_scope(thread());
+          NoHeapGrowthControlScope no_growth_control;
+          FinalizeCompilation(&assembler, &graph_compiler, flow_graph,
+                              function_stats);
+        }
+      }
+      // Like the code, the summary only becomes visible to functions which
+      // are optimized after this one is installed.
+      if ((effects != nullptr) && (precompiler_ != nullptr)) {
+        precompiler_->RecordEffects(function, *effects);
       }
       // Exit the loop and the function with the correct result value.
       is_compiled = true;
@@ -2402,7 +2939,9 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
 static RawError* PrecompileFunctionHelper(Precompiler* precompiler,
                                           CompilationPipeline* pipeline,
                                           const Function& function,
-                                          bool optimized) {
+                                          bool optimized,
+                                          PrecompilerWave* wave = nullptr,
+                                          intptr_t wave_index = -1) {
   // Check that we optimize, except if the function is not optimizable.
   ASSERT(FLAG_precompiled_mode);
   ASSERT(!function.IsOptimizable() || optimized);
@@ -2431,13 +2970,14 @@ static RawError* PrecompileFunctionHelper(Precompiler* precompiler,
     }
 
     PrecompileParsedFunctionHelper helper(precompiler, parsed_function,
-                                          optimized);
+                                          optimized, wave, wave_index);
     const bool success = helper.Compile(pipeline);
     if (!success) {
-      // We got an error during compilation.
+      // We got an error during compilation, or a helper bailed out.
       const Error& error = Error::Handle(thread->StealStickyError());
-      ASSERT(error.IsLanguageError() &&
-             LanguageError::Cast(error).kind() != Report::kBailout);
+      ASSERT((wave != nullptr) ||
+             (error.IsLanguageError() &&
+              LanguageError::Cast(error).kind() != Report::kBailout));
       return error.raw();
     }
 
@@ -2466,14 +3006,35 @@ static RawError* PrecompileFunctionHelper(Precompiler* precompiler,
     // We got an error during compilation.
     const Error& error = Error::Handle(thread->StealStickyError());
     // Precompilation may encounter compile-time errors.
-    // Do not attempt to optimize functions that can cause errors.
-    function.set_is_optimizable(false);
+    // Do not attempt to optimize functions that can cause errors. Helpers
+    // leave this to the main thread, which compiles the function again.
+    if (wave == nullptr) {
+      function.set_is_optimizable(false);
+    }
     return error.raw();
   }
   UNREACHABLE();
   return Error::null();
 }
 
+void PrecompilerTask::Run() {
+  bool result = Thread::EnterIsolateAsHelper(isolate_, Thread::kCompilerTask);
+  ASSERT(result);
+  {
+    Thread* thread = Thread::Current();
+    StackZone stack_zone(thread);
+    HANDLESCOPE(thread);
+    HierarchyInfo hierarchy_info(thread);
+    const Function& function =
+        Function::Handle(stack_zone.GetZone(), wave_->FunctionAt(index_));
+    DartCompilationPipeline pipeline;
+    PrecompileFunctionHelper(precompiler_, &pipeline, function,
+                             function.IsOptimizable(), wave_, index_);
+    wave_->Finish(thread, index_, function.HasCode());
+  }
+  Thread::ExitIsolateAsHelper();
+}
+
 RawError* Precompiler::CompileFunction(Precompiler* precompiler,
                                        Thread* thread,
                                        Zone* zone,
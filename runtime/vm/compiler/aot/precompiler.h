@@ -15,6 +15,7 @@
 namespace dart {
 
 // Forward declarations.
+class CallEffects;
 class Class;
 class Error;
 class Field;
@@ -26,6 +27,7 @@ class String;
 class ParsedJSONObject;
 class ParsedJSONArray;
 class Precompiler;
+class PrecompilerWave;
 class FlowGraph;
 class PrecompilerEntryPointsPrinter;
 
@@ -104,6 +106,68 @@ class FunctionKeyValueTrait {
 
 typedef DirectChainedHashMap<FunctionKeyValueTrait> FunctionSet;
 
+// Maps a function to the call sites recorded for it in the type feedback
+// (see TypeFeedbackLoader::LoadFunctionForPrecompilation).
+class FunctionFeedbackKeyValueTrait {
+ public:
+  // Typedefs needed for the DirectChainedHashMap template.
+  typedef const Function* Key;
+  typedef const Array* Value;
+
+  struct Pair {
+    Key key;
+    Value value;
+    Pair() : key(NULL), value(NULL) {}
+    Pair(const Key key, const Value& value) : key(key), value(value) {}
+    Pair(const Pair& other) : key(other.key), value(other.value) {}
+  };
+
+  static Key KeyOf(Pair kv) { return kv.key; }
+
+  static Value ValueOf(Pair kv) { return kv.value; }
+
+  static inline intptr_t Hashcode(Key key) {
+    return FunctionKeyValueTrait::Hashcode(key);
+  }
+
+  static inline bool IsKeyEqual(Pair pair, Key key) {
+    return pair.key->raw() == key->raw();
+  }
+};
+
+typedef DirectChainedHashMap<FunctionFeedbackKeyValueTrait> FunctionFeedbackMap;
+
+// Maps a compiled function to the summary of the memory it may write
+// (see CallEffects).
+class FunctionEffectsKeyValueTrait {
+ public:
+  // Typedefs needed for the DirectChainedHashMap template.
+  typedef const Function* Key;
+  typedef const CallEffects* Value;
+
+  struct Pair {
+    Key key;
+    Value value;
+    Pair() : key(NULL), value(NULL) {}
+    Pair(const Key key, const Value& value) : key(key), value(value) {}
+    Pair(const Pair& other) : key(other.key), value(other.value) {}
+  };
+
+  static Key KeyOf(Pair kv) { return kv.key; }
+
+  static Value ValueOf(Pair kv) { return kv.value; }
+
+  static inline intptr_t Hashcode(Key key) {
+    return FunctionKeyValueTrait::Hashcode(key);
+  }
+
+  static inline bool IsKeyEqual(Pair pair, Key key) {
+    return pair.key->raw() == key->raw();
+  }
+};
+
+typedef DirectChainedHashMap<FunctionEffectsKeyValueTrait> FunctionEffectsMap;
+
 class FieldKeyValueTrait {
  public:
   // Typedefs needed for the DirectChainedHashMap template.
@@ -235,6 +299,28 @@ class Precompiler : public ValueObject {
 
   static Precompiler* Instance() { return singleton_; }
 
+  // Returns true if type feedback from a training run was loaded for
+  // [function] (see Dart_LoadTypeFeedback).
+  bool HasTypeFeedback(const Function& function) const {
+    return type_feedback_.HasKey(&function);
+  }
+
+  // Replaces the empty ICData of the calls in [flow_graph] with the receiver
+  // classes and call counts recorded in the type feedback, if any.
+  void ApplyTypeFeedback(FlowGraph* flow_graph);
+
+  // Returns the summary of the memory written by [function], or nullptr if
+  // [function] was not compiled yet or may write any memory.
+  const CallEffects* EffectsOf(const Function& function) const {
+    const FunctionEffectsKeyValueTrait::Pair* pair =
+        function_effects_.Lookup(&function);
+    return (pair != nullptr) ? pair->value : nullptr;
+  }
+
+  // Records the summary of the memory written by the just compiled
+  // [function].
+  void RecordEffects(const Function& function, const CallEffects& effects);
+
  private:
   static Precompiler* singleton_;
 
@@ -262,7 +348,10 @@ class Precompiler : public ValueObject {
   void AddSelector(const String& selector);
   bool IsSent(const String& selector);
 
-  void ProcessFunction(const Function& function);
+  void ProcessFunctionsInParallel();
+  void ProcessFunction(const Function& function,
+                       PrecompilerWave* wave = nullptr,
+                       intptr_t wave_index = -1);
   void CheckForNewDynamicFunctions();
   void CollectCallbackFields();
 
@@ -280,17 +369,21 @@ class Precompiler : public ValueObject {
   void DropLibraries();
 
   void BindStaticCalls();
+  void GenerateDispatchTable();
   void SwitchICCalls();
 
   void Obfuscate();
 
   void CollectDynamicFunctionNames();
+  void CollectDeferredLibraries();
 
   void PrecompileStaticInitializers();
   void PrecompileConstructors();
 
   void FinalizeAllClasses();
 
+  void CollectTypeFeedback();
+
   Thread* thread() const { return thread_; }
   Zone* zone() const { return zone_; }
   Isolate* isolate() const { return isolate_; }
@@ -322,6 +415,8 @@ class Precompiler : public ValueObject {
   TypeArgumentsSet typeargs_to_retain_;
   AbstractTypeSet types_to_retain_;
   InstanceSet consts_to_retain_;
+  FunctionFeedbackMap type_feedback_;
+  FunctionEffectsMap function_effects_;
   Error& error_;
 
   bool get_runtime_type_is_unique_;
@@ -2193,6 +2193,13 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
   // Load the specialized function pointer into R0. Leverage the fact the
   // string CIDs as well as stored function pointers are in sequence.
   __ ldr(R2, Address(SP, kRegExpParamOffset));
+  if (!sticky) {
+    // Regexps with a literal prefix are matched by the native, which scans for
+    // the prefix before it calls the matcher.
+    __ ldr(R1, FieldAddress(R2, target::RegExp::literal_prefix_offset()));
+    __ CompareObject(R1, NullObject());
+    __ b(normal_ir_body, NE);
+  }
   __ ldr(R1, Address(SP, kStringParamOffset));
   __ LoadClassId(R1, R1);
   __ AddImmediate(R1, -kOneByteStringCid);
@@ -2207,6 +2214,10 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
   // Tail-call the function.
   __ ldr(CODE_REG, FieldAddress(R0, target::Function::code_offset()));
   __ Branch(FieldAddress(R0, target::Function::entry_point_offset()));
+
+  if (!sticky) {
+    __ Bind(normal_ir_body);
+  }
 }
 
 // On stack: user tag (+0).
@@ -2258,6 +2269,15 @@ void AsmIntrinsifier::Timeline_isDartStreamEnabled(Assembler* assembler,
 #endif
 }
 
+void AsmIntrinsifier::Timeline_getTraceClock(Assembler* assembler,
+                                             Label* normal_ir_body) {
+  // The clocks do not fit in a Smi on 32-bit targets, so they are left to
+  // their natives, which allocate a Mint.
+}
+
+void AsmIntrinsifier::Timeline_getThreadCpuClock(Assembler* assembler,
+                                                 Label* normal_ir_body) {}
+
 void AsmIntrinsifier::ClearAsyncThreadStackTrace(Assembler* assembler,
                                                  Label* normal_ir_body) {
   __ LoadObject(R0, NullObject());
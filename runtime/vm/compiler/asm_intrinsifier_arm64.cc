@@ -2255,6 +2255,13 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
   // Load the specialized function pointer into R0. Leverage the fact the
   // string CIDs as well as stored function pointers are in sequence.
   __ ldr(R2, Address(SP, kRegExpParamOffset));
+  if (!sticky) {
+    // Regexps with a literal prefix are matched by the native, which scans for
+    // the prefix before it calls the matcher.
+    __ ldr(R1, FieldAddress(R2, target::RegExp::literal_prefix_offset()));
+    __ CompareObject(R1, NullObject());
+    __ b(normal_ir_body, NE);
+  }
   __ ldr(R1, Address(SP, kStringParamOffset));
   __ LoadClassId(R1, R1);
   __ AddImmediate(R1, -kOneByteStringCid);
@@ -2270,6 +2277,10 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
   __ ldr(CODE_REG, FieldAddress(R0, target::Function::code_offset()));
   __ ldr(R1, FieldAddress(R0, target::Function::entry_point_offset()));
   __ br(R1);
+
+  if (!sticky) {
+    __ Bind(normal_ir_body);
+  }
 }
 
 // On stack: user tag (+0).
@@ -2322,6 +2333,27 @@ void AsmIntrinsifier::Timeline_isDartStreamEnabled(Assembler* assembler,
 #endif
 }
 
+// Calls the clocks directly instead of through their natives. They fit in a
+// Smi on 64-bit targets.
+static void CallClock(Assembler* assembler, const RuntimeEntry& clock) {
+  // The leaf call clobbers LR.
+  AsmIntrinsifier::IntrinsicCallPrologue(assembler);
+  __ CallRuntime(clock, 0);
+  AsmIntrinsifier::IntrinsicCallEpilogue(assembler);
+  __ SmiTag(R0);
+  __ ret();
+}
+
+void AsmIntrinsifier::Timeline_getTraceClock(Assembler* assembler,
+                                             Label* normal_ir_body) {
+  CallClock(assembler, kTimelineGetTraceClockRuntimeEntry);
+}
+
+void AsmIntrinsifier::Timeline_getThreadCpuClock(Assembler* assembler,
+                                                 Label* normal_ir_body) {
+  CallClock(assembler, kTimelineGetThreadCpuClockRuntimeEntry);
+}
+
 void AsmIntrinsifier::ClearAsyncThreadStackTrace(Assembler* assembler,
                                                  Label* normal_ir_body) {
   __ LoadObject(R0, NullObject());
@@ -2192,6 +2192,14 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
   // Load the specialized function pointer into EAX. Leverage the fact the
   // string CIDs as well as stored function pointers are in sequence.
   __ movl(EBX, Address(ESP, kRegExpParamOffset));
+  if (!sticky) {
+    // Regexps with a literal prefix are matched by the native, which scans for
+    // the prefix before it calls the matcher.
+    __ movl(EDI,
+            FieldAddress(EBX, target::RegExp::literal_prefix_offset()));
+    __ CompareObject(EDI, NullObject());
+    __ j(NOT_EQUAL, normal_ir_body);
+  }
   __ movl(EDI, Address(ESP, kStringParamOffset));
   __ LoadClassId(EDI, EDI);
   __ SubImmediate(EDI, Immediate(kOneByteStringCid));
@@ -2205,6 +2213,10 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
 
   // Tail-call the function.
   __ jmp(FieldAddress(EAX, target::Function::entry_point_offset()));
+
+  if (!sticky) {
+    __ Bind(normal_ir_body);
+  }
 }
 
 // On stack: user tag (+1), return-address (+0).
@@ -2262,6 +2274,15 @@ void AsmIntrinsifier::Timeline_isDartStreamEnabled(Assembler* assembler,
 #endif
 }
 
+void AsmIntrinsifier::Timeline_getTraceClock(Assembler* assembler,
+                                             Label* normal_ir_body) {
+  // The clocks do not fit in a Smi on 32-bit targets, so they are left to
+  // their natives, which allocate a Mint.
+}
+
+void AsmIntrinsifier::Timeline_getThreadCpuClock(Assembler* assembler,
+                                                 Label* normal_ir_body) {}
+
 void AsmIntrinsifier::ClearAsyncThreadStackTrace(Assembler* assembler,
                                                  Label* normal_ir_body) {
   __ LoadObject(EAX, NullObject());
@@ -2220,6 +2220,14 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
   // Load the specialized function pointer into RAX. Leverage the fact the
   // string CIDs as well as stored function pointers are in sequence.
   __ movq(RBX, Address(RSP, kRegExpParamOffset));
+  if (!sticky) {
+    // Regexps with a literal prefix are matched by the native, which scans for
+    // the prefix before it calls the matcher.
+    __ movq(RDI,
+            FieldAddress(RBX, target::RegExp::literal_prefix_offset()));
+    __ CompareObject(RDI, NullObject());
+    __ j(NOT_EQUAL, normal_ir_body);
+  }
   __ movq(RDI, Address(RSP, kStringParamOffset));
   __ LoadClassId(RDI, RDI);
   __ SubImmediate(RDI, Immediate(kOneByteStringCid));
@@ -2235,6 +2243,10 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
   __ movq(CODE_REG, FieldAddress(RAX, target::Function::code_offset()));
   __ movq(RDI, FieldAddress(RAX, target::Function::entry_point_offset()));
   __ jmp(RDI);
+
+  if (!sticky) {
+    __ Bind(normal_ir_body);
+  }
 }
 
 // On stack: user tag (+1), return-address (+0).
@@ -2292,6 +2304,27 @@ void AsmIntrinsifier::Timeline_isDartStreamEnabled(Assembler* assembler,
 #endif
 }
 
+// Calls the clocks directly instead of through their natives. They fit in a
+// Smi on 64-bit targets.
+static void CallClock(Assembler* assembler, const RuntimeEntry& clock) {
+  __ EnterFrame(0);
+  __ ReserveAlignedFrameSpace(0);
+  __ CallRuntime(clock, 0);
+  __ LeaveFrame();
+  __ SmiTag(RAX);
+  __ ret();
+}
+
+void AsmIntrinsifier::Timeline_getTraceClock(Assembler* assembler,
+                                             Label* normal_ir_body) {
+  CallClock(assembler, kTimelineGetTraceClockRuntimeEntry);
+}
+
+void AsmIntrinsifier::Timeline_getThreadCpuClock(Assembler* assembler,
+                                                 Label* normal_ir_body) {
+  CallClock(assembler, kTimelineGetThreadCpuClockRuntimeEntry);
+}
+
 void AsmIntrinsifier::ClearAsyncThreadStackTrace(Assembler* assembler,
                                                  Label* normal_ir_body) {
   __ LoadObject(RAX, NullObject());
@@ -245,6 +245,7 @@ void ObjectPoolBuilder::Reset() {
 
   object_pool_.Clear();
   object_pool_index_table_.Clear();
+  shareable_entries_.Clear();
 }
 
 intptr_t ObjectPoolBuilder::AddObject(
@@ -278,12 +279,12 @@ intptr_t ObjectPoolBuilder::AddObject(ObjectPoolBuilderEntry entry) {
   }
 
   object_pool_.Add(entry);
+  const intptr_t index = base_ + object_pool_.length() - 1;
   if (entry.patchable() == ObjectPoolBuilderEntry::kNotPatchable) {
     // The object isn't patchable. Record the index for fast lookup.
-    object_pool_index_table_.Insert(
-        ObjIndexPair(entry, object_pool_.length() - 1));
+    object_pool_index_table_.Insert(ObjIndexPair(entry, index));
   }
-  return object_pool_.length() - 1;
+  return index;
 }
 
 intptr_t ObjectPoolBuilder::FindObject(ObjectPoolBuilderEntry entry) {
@@ -294,10 +295,37 @@ intptr_t ObjectPoolBuilder::FindObject(ObjectPoolBuilderEntry entry) {
     if (idx != ObjIndexPair::kNoIndex) {
       return idx;
     }
+    // Shared entries are looked up by object only, so entries with a
+    // different equivalence are kept to this builder.
+    if ((shared_ != nullptr) &&
+        ((entry.type() != ObjectPoolBuilderEntry::kTaggedObject) ||
+         IsSameObject(*entry.obj_, *entry.equivalence_))) {
+      idx = shared_->Lookup(entry);
+      if (idx != ObjIndexPair::kNoIndex) {
+        return idx;
+      }
+      shareable_entries_.Add(object_pool_.length());
+    }
   }
   return AddObject(entry);
 }
 
+bool ObjectPoolBuilder::IsShareable(intptr_t i) const {
+  // Entries are added in order, so the indices are sorted.
+  intptr_t lo = 0;
+  intptr_t hi = shareable_entries_.length() - 1;
+  while (lo <= hi) {
+    const intptr_t mid = lo + (hi - lo) / 2;
+    if (shareable_entries_[mid] == i) return true;
+    if (shareable_entries_[mid] < i) {
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return false;
+}
+
 intptr_t ObjectPoolBuilder::FindObject(
     const Object& obj,
     ObjectPoolBuilderEntry::Patchability patchable) {
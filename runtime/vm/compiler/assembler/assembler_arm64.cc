@@ -1332,15 +1332,23 @@ void Assembler::TransitionGeneratedToNative(Register destination,
     movz(addr, Immediate(compiler::target::Thread::safepoint_state_offset()),
          0);
     add(addr, THR, Operand(addr));
-    Bind(&retry);
-    ldxr(state, addr);
-    cmp(state, Operand(Thread::safepoint_state_unacquired()));
-    b(&slow_path, NE);
-
-    movz(state, Immediate(Thread::safepoint_state_acquired()), 0);
-    stxr(TMP, state, addr);
-    cbz(&done, TMP);  // 0 means stxr was successful.
-    b(&retry);
+    if (TargetCPUFeatures::atomic_memory_supported()) {
+      movz(TMP, Immediate(Thread::safepoint_state_unacquired()), 0);
+      movz(state, Immediate(Thread::safepoint_state_acquired()), 0);
+      cas(TMP, state, addr);
+      cmp(TMP, Operand(Thread::safepoint_state_unacquired()));
+      b(&done, EQ);
+    } else {
+      Bind(&retry);
+      ldxr(state, addr);
+      cmp(state, Operand(Thread::safepoint_state_unacquired()));
+      b(&slow_path, NE);
+
+      movz(state, Immediate(Thread::safepoint_state_acquired()), 0);
+      stxr(TMP, state, addr);
+      cbz(&done, TMP);  // 0 means stxr was successful.
+      b(&retry);
+    }
   }
 
   Bind(&slow_path);
@@ -1361,15 +1369,23 @@ void Assembler::TransitionNativeToGenerated(Register state) {
     movz(addr, Immediate(compiler::target::Thread::safepoint_state_offset()),
          0);
     add(addr, THR, Operand(addr));
-    Bind(&retry);
-    ldxr(state, addr);
-    cmp(state, Operand(Thread::safepoint_state_acquired()));
-    b(&slow_path, NE);
-
-    movz(state, Immediate(Thread::safepoint_state_unacquired()), 0);
-    stxr(TMP, state, addr);
-    cbz(&done, TMP);  // 0 means stxr was successful.
-    b(&retry);
+    if (TargetCPUFeatures::atomic_memory_supported()) {
+      movz(TMP, Immediate(Thread::safepoint_state_acquired()), 0);
+      movz(state, Immediate(Thread::safepoint_state_unacquired()), 0);
+      cas(TMP, state, addr);
+      cmp(TMP, Operand(Thread::safepoint_state_acquired()));
+      b(&done, EQ);
+    } else {
+      Bind(&retry);
+      ldxr(state, addr);
+      cmp(state, Operand(Thread::safepoint_state_acquired()));
+      b(&slow_path, NE);
+
+      movz(state, Immediate(Thread::safepoint_state_unacquired()), 0);
+      stxr(TMP, state, addr);
+      cbz(&done, TMP);  // 0 means stxr was successful.
+      b(&retry);
+    }
   }
 
   Bind(&slow_path);
@@ -926,6 +926,36 @@ class Assembler : public AssemblerBase {
     Emit(encoding);
   }
 
+  // ARMv8.1 atomic memory instructions. Only emit these when
+  // TargetCPUFeatures::atomic_memory_supported().
+  void ldclr(Register rs,
+             Register rt,
+             Register rn,
+             OperandSize size = kDoubleWord) {
+    // rs = bits to clear
+    // rt = old value (ZR to discard)
+    // rn = address
+    EmitAtomicMemory(LDCLR, rs, rn, rt, size);
+  }
+  void ldset(Register rs,
+             Register rt,
+             Register rn,
+             OperandSize size = kDoubleWord) {
+    // rs = bits to set
+    // rt = old value (ZR to discard)
+    // rn = address
+    EmitAtomicMemory(LDSET, rs, rn, rt, size);
+  }
+  void cas(Register rs,
+           Register rt,
+           Register rn,
+           OperandSize size = kDoubleWord) {
+    // rs = expected value, replaced by the old value
+    // rt = new value, stored if the old value is the expected one
+    // rn = address
+    EmitCompareAndSwap(CAS, rs, rn, rt, size);
+  }
+
   // Conditional select.
   void csel(Register rd, Register rn, Register rm, Condition cond) {
     EmitConditionalSelect(CSEL, rd, rn, rm, cond, kDoubleWord);
@@ -2068,6 +2098,40 @@ class Assembler : public AssemblerBase {
     Emit(encoding);
   }
 
+  void EmitAtomicMemory(AtomicMemoryOp op,
+                        Register rs,
+                        Register rn,
+                        Register rt,
+                        OperandSize sz = kDoubleWord) {
+    ASSERT(sz == kDoubleWord || sz == kWord);
+    const int32_t size = B31 | (sz == kDoubleWord ? B30 : 0);
+
+    ASSERT((rs != kNoRegister) && (rs != CSP));
+    ASSERT((rn != kNoRegister) && (rn != ZR));
+    ASSERT((rt != kNoRegister) && (rt != CSP));
+
+    const int32_t encoding = op | size | Arm64Encode::Rs(rs) |
+                             Arm64Encode::Rn(rn) | Arm64Encode::Rt(rt);
+    Emit(encoding);
+  }
+
+  void EmitCompareAndSwap(CompareAndSwapOp op,
+                          Register rs,
+                          Register rn,
+                          Register rt,
+                          OperandSize sz = kDoubleWord) {
+    ASSERT(sz == kDoubleWord || sz == kWord);
+    const int32_t size = (sz == kDoubleWord ? B31 | B30 : B31);
+
+    ASSERT((rs != kNoRegister) && (rs != ZR) && (rs != CSP));
+    ASSERT((rn != kNoRegister) && (rn != ZR));
+    ASSERT((rt != kNoRegister) && (rt != CSP));
+
+    const int32_t encoding = op | size | Arm64Encode::Rs(rs) |
+                             Arm64Encode::Rn(rn) | Arm64Encode::Rt(rt);
+    Emit(encoding);
+  }
+
   void EmitLoadStoreReg(LoadStoreRegOp op,
                         Register rt,
                         Address a,
@@ -585,6 +585,36 @@ ASSEMBLER_TEST_RUN(Semaphore32, test) {
             EXECUTE_TEST_CODE_INT64(Semaphore32, test->entry()));
 }
 
+ASSEMBLER_TEST_GENERATE(AtomicMemory, assembler) {
+  if (!TargetCPUFeatures::atomic_memory_supported()) {
+    __ ret();
+    return;
+  }
+  __ SetupDartSP();
+  __ movz(R0, Immediate(0xff), 0);
+  __ Push(R0);
+  __ movz(R1, Immediate(0x0f), 0);
+  __ ldclr(R1, R2, SP);  // [SP] == 0xf0, R2 == 0xff
+  __ movz(R1, Immediate(0x100), 0);
+  __ ldset(R1, ZR, SP);  // [SP] == 0x1f0
+  __ movz(R3, Immediate(0x1f0), 0);
+  __ movz(R4, Immediate(42), 0);
+  __ cas(R3, R4, SP);  // [SP] == 42, R3 == 0x1f0
+  __ Pop(R0);
+  __ add(R0, R0, Operand(R2));
+  __ sub(R0, R0, Operand(R3));  // 42 + 0xff - 0x1f0
+  __ RestoreCSP();
+  __ ret();
+}
+
+ASSEMBLER_TEST_RUN(AtomicMemory, test) {
+  EXPECT(test != NULL);
+  if (TargetCPUFeatures::atomic_memory_supported()) {
+    typedef intptr_t (*AtomicMemory)() DART_UNUSED;
+    EXPECT_EQ(-199, EXECUTE_TEST_CODE_INT64(AtomicMemory, test->entry()));
+  }
+}
+
 ASSEMBLER_TEST_GENERATE(FailedSemaphore32, assembler) {
   __ SetupDartSP();
   __ movz(R0, Immediate(40), 0);
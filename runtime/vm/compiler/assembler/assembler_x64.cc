@@ -397,6 +397,32 @@ void Assembler::EmitL(int dst, int src, int opcode, int prefix2, int prefix1) {
   EmitRegisterOperand(dst & 7, src);
 }
 
+void Assembler::EmitVex(int dst,
+                        int src1,
+                        int src2,
+                        int opcode,
+                        VexPrefix prefix) {
+  ASSERT(dst <= XMM15);
+  ASSERT(src1 <= XMM15);
+  ASSERT(src2 <= XMM15);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The R, X and B bits and the vvvv register are stored inverted.
+  const uint8_t r = (dst & 8) != 0 ? 0 : 0x80;
+  const uint8_t vvvv_l_pp = ((~src1 & 0xF) << 3) | prefix;
+  if ((src2 & 8) == 0) {
+    // Two byte VEX prefix, implies the 0F opcode map.
+    EmitUint8(0xC5);
+    EmitUint8(r | vvvv_l_pp);
+  } else {
+    // Three byte VEX prefix with B set and the 0F opcode map.
+    EmitUint8(0xC4);
+    EmitUint8(r | 0x40 | 0x01);
+    EmitUint8(vvvv_l_pp);
+  }
+  EmitUint8(opcode);
+  EmitRegisterOperand(dst & 7, src2);
+}
+
 void Assembler::EmitW(Register dst,
                       Register src,
                       int opcode,
@@ -433,6 +433,24 @@ class Assembler : public AssemblerBase {
 #undef AX
 #undef XA
 
+// Three operand AVX forms of the XMM ALU operations, dst = src1 op src2.
+// Only emit these when TargetCPUFeatures::avx_supported().
+#define DECLARE_VXMM(name, code)                                               \
+  void v##name##ps(XmmRegister dst, XmmRegister src1, XmmRegister src2) {      \
+    EmitVex(dst, src1, src2, 0x50 + code, kVexNone);                           \
+  }                                                                            \
+  void v##name##pd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {      \
+    EmitVex(dst, src1, src2, 0x50 + code, kVex66);                             \
+  }                                                                            \
+  void v##name##ss(XmmRegister dst, XmmRegister src1, XmmRegister src2) {      \
+    EmitVex(dst, src1, src2, 0x50 + code, kVexF3);                             \
+  }                                                                            \
+  void v##name##sd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {      \
+    EmitVex(dst, src1, src2, 0x50 + code, kVexF2);                             \
+  }
+  XMM_ALU_CODES(DECLARE_VXMM)
+#undef DECLARE_VXMM
+
 #define DECLARE_CMPPS(name, code)                                              \
   void cmpps##name(XmmRegister dst, XmmRegister src) {                         \
     EmitL(dst, src, 0xC2, 0x0F);                                               \
@@ -1001,6 +1019,9 @@ class Assembler : public AssemblerBase {
              int prefix2 = -1,
              int prefix1 = -1);
   void EmitQ(int dst, int src, int opcode, int prefix2 = -1, int prefix1 = -1);
+  // The implied SIMD prefix of a VEX encoded instruction.
+  enum VexPrefix { kVexNone = 0, kVex66 = 1, kVexF3 = 2, kVexF2 = 3 };
+  void EmitVex(int dst, int src1, int src2, int opcode, VexPrefix prefix);
   void EmitL(int dst, int src, int opcode, int prefix2 = -1, int prefix1 = -1);
   void EmitW(Register dst,
              Register src,
@@ -6,6 +6,7 @@
 #if defined(TARGET_ARCH_X64)
 
 #include "vm/compiler/assembler/assembler.h"
+#include "vm/cpu.h"
 #include "vm/os.h"
 #include "vm/unit_test.h"
 #include "vm/virtual_memory.h"
@@ -5159,6 +5160,42 @@ ASSEMBLER_TEST_RUN(Pxor, test) {
       "ret\n");
 }
 
+ASSEMBLER_TEST_GENERATE(AvxDoubleFPOperations, assembler) {
+  __ movq(RAX, Immediate(bit_cast<int64_t, double>(12.3)));
+  __ pushq(RAX);
+  __ movsd(XMM0, Address(RSP, 0));
+  __ movq(RAX, Immediate(bit_cast<int64_t, double>(3.4)));
+  __ movq(Address(RSP, 0), RAX);
+  __ movsd(XMM12, Address(RSP, 0));
+  __ vaddsd(XMM8, XMM0, XMM12);  // 15.7
+  __ vmulsd(XMM1, XMM8, XMM12);  // 53.38
+  __ vsubsd(XMM9, XMM1, XMM12);  // 49.98
+  __ vdivsd(XMM0, XMM9, XMM12);  // 14.7
+  __ popq(RAX);
+  __ ret();
+}
+
+ASSEMBLER_TEST_RUN(AvxDoubleFPOperations, test) {
+  if (TargetCPUFeatures::avx_supported()) {
+    typedef double (*AvxDoubleFPOperationsCode)();
+    double res = reinterpret_cast<AvxDoubleFPOperationsCode>(test->entry())();
+    EXPECT_FLOAT_EQ(14.7, res, 0.001);
+  }
+  EXPECT_DISASSEMBLY(
+      "movq rax,0x................\n"
+      "push rax\n"
+      "movsd xmm0,[rsp]\n"
+      "movq rax,0x................\n"
+      "movq [rsp],rax\n"
+      "movsd xmm12,[rsp]\n"
+      "vaddsd xmm8,xmm0,xmm12\n"
+      "vmulsd xmm1,xmm8,xmm12\n"
+      "vsubsd xmm9,xmm1,xmm12\n"
+      "vdivsd xmm0,xmm9,xmm12\n"
+      "pop rax\n"
+      "ret\n");
+}
+
 ASSEMBLER_TEST_GENERATE(SquareRootDouble, assembler) {
   __ sqrtsd(XMM0, XMM0);
   __ ret();
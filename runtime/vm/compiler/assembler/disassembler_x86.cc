@@ -345,6 +345,9 @@ class DisassemblerX64 : public ValueObject {
   const char* TwoByteMnemonic(uint8_t opcode);
   int TwoByteOpcodeInstruction(uint8_t* data);
   int Print660F38Instruction(uint8_t* data);
+#if defined(TARGET_ARCH_X64)
+  int VexInstruction(uint8_t* data);
+#endif
 
   int F6F7Instruction(uint8_t* data);
   int ShiftInstruction(uint8_t* data);
@@ -1605,6 +1608,43 @@ const char* DisassemblerX64::TwoByteMnemonic(uint8_t opcode) {
   }
 }
 
+#if defined(TARGET_ARCH_X64)
+// Decodes the three operand AVX forms of the XMM ALU instructions, the only
+// VEX encoded instructions the assembler emits.
+int DisassemblerX64::VexInstruction(uint8_t* data) {
+  uint8_t* current = data + 1;
+  // The R, X and B bits and the vvvv register are stored inverted.
+  uint8_t rex = REX_PREFIX;
+  if ((*current & 0x80) == 0) rex |= REX_R;
+  int opcode_map = 1;
+  if (*data == 0xC4) {
+    if ((*current & 0x40) == 0) rex |= REX_X;
+    if ((*current & 0x20) == 0) rex |= REX_B;
+    opcode_map = *current & 0x1F;
+    current++;
+    if ((*current & 0x80) != 0) rex |= REX_W;
+  }
+  const int vvvv = (~*current >> 3) & 0xF;
+  const int simd_prefix = *current & 3;
+  current++;
+  setRex(rex);
+  const uint8_t opcode = *current++;
+  if ((opcode_map != 1) || (opcode < 0x51) || (opcode > 0x5F) ||
+      (opcode == 0x5A) || (opcode == 0x5B)) {
+    UnimplementedInstruction();
+  }
+  const XmmMnemonic& mnemonic = xmm_instructions[opcode & 0xF];
+  const char* const names[] = {mnemonic.ps_name, mnemonic.pd_name,
+                               mnemonic.ss_name, mnemonic.sd_name};
+  int mod, regop, rm;
+  get_modrm(*current, &mod, &regop, &rm);
+  Print("v%s %s,%s,", names[simd_prefix], NameOfXMMRegister(regop),
+        NameOfXMMRegister(vvvv));
+  current += PrintRightXMMOperand(current);
+  return current - data;
+}
+#endif  // defined(TARGET_ARCH_X64)
+
 int DisassemblerX64::InstructionDecode(uword pc) {
   uint8_t* data = reinterpret_cast<uint8_t*>(pc);
 
@@ -1647,6 +1687,14 @@ int DisassemblerX64::InstructionDecode(uword pc) {
         data += TwoByteOpcodeInstruction(data);
         break;
 
+#if defined(TARGET_ARCH_X64)
+      case 0xC4:
+        FALL_THROUGH;
+      case 0xC5:
+        data += VexInstruction(data);
+        break;
+#endif
+
       case 0x8F: {
         data++;
         int mod, regop, rm;
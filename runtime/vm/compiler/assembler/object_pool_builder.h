@@ -112,9 +112,24 @@ class ObjIndexPair {
   Value value_;
 };
 
+// An object pool whose entries are shared by the pools of several builders,
+// such as the global object pool of JIT code.
+class SharedObjectPool {
+ public:
+  virtual ~SharedObjectPool() {}
+
+  // The number of shared entries. Entries of a builder using this pool are
+  // numbered after them.
+  virtual intptr_t Length() const = 0;
+
+  // Returns the index of the shared entry equal to [entry] or
+  // ObjIndexPair::kNoIndex.
+  virtual intptr_t Lookup(const ObjectPoolBuilderEntry& entry) const = 0;
+};
+
 class ObjectPoolBuilder : public ValueObject {
  public:
-  ObjectPoolBuilder() : zone_(nullptr) {}
+  ObjectPoolBuilder() : zone_(nullptr), shared_(nullptr), base_(0) {}
   ~ObjectPoolBuilder() {
     if (zone_ != nullptr) {
       Reset();
@@ -137,6 +152,15 @@ class ObjectPoolBuilder : public ValueObject {
     zone_ = zone;
   }
 
+  // Makes the entries of this builder follow the entries of [shared], which
+  // are reused instead of adding equal entries that are not patchable.
+  void InitializeWithSharedPool(const SharedObjectPool* shared) {
+    ASSERT(object_pool_.length() == 0);
+    ASSERT(shared_ == nullptr && shared != nullptr);
+    shared_ = shared;
+    base_ = shared->Length();
+  }
+
   intptr_t AddObject(const Object& obj,
                      ObjectPoolBuilderEntry::Patchability patchable =
                          ObjectPoolBuilderEntry::kNotPatchable);
@@ -153,12 +177,21 @@ class ObjectPoolBuilder : public ValueObject {
       const ExternalLabel* label,
       ObjectPoolBuilderEntry::Patchability patchable);
 
+  // The index of the first entry of this builder in the object pool.
+  intptr_t base() const { return base_; }
+
+  // The number of entries added to this builder, and the entry at the given
+  // index counted from [base].
   intptr_t CurrentLength() const { return object_pool_.length(); }
   ObjectPoolBuilderEntry& EntryAt(intptr_t i) { return object_pool_[i]; }
   const ObjectPoolBuilderEntry& EntryAt(intptr_t i) const {
     return object_pool_[i];
   }
 
+  // Whether the entry at the given index counted from [base] was added by a
+  // lookup, so that other builders can share it.
+  bool IsShareable(intptr_t i) const;
+
   intptr_t AddObject(ObjectPoolBuilderEntry entry);
 
  private:
@@ -170,10 +203,17 @@ class ObjectPoolBuilder : public ValueObject {
   // Hashmap for fast lookup in object pool.
   DirectChainedHashMap<ObjIndexPair> object_pool_index_table_;
 
+  // Indices counted from [base_] of the entries added by a lookup.
+  GrowableArray<intptr_t> shareable_entries_;
+
   // The zone used for allocating the handles we keep in the map and array (or
   // NULL, in which case allocations happen using the zone active at the point
   // of insertion).
   Zone* zone_;
+
+  // The entries shared with other builders, or NULL.
+  const SharedObjectPool* shared_;
+  intptr_t base_;
 };
 
 }  // namespace compiler
@@ -73,7 +73,7 @@ void BlockScheduler::AssignEdgeWeights() const {
     return;
   }
   Array& edge_counters = Array::Handle();
-  edge_counters ^= ic_data_array.At(0);
+  edge_counters ^= ic_data_array.At(Function::kEdgeCountersIndex);
 
   auto graph_entry = flow_graph()->graph_entry();
   BlockEntryInstr* entry = graph_entry->normal_entry();
@@ -158,6 +158,85 @@ static void Union(GrowableArray<Chain*>* chains,
   }
 }
 
+// Marks blocks ending in a throw/rethrow, as well as any block post-dominated
+// by such a throwing block.
+static void MarkTerminatingBlocks(FlowGraph* flow_graph,
+                                  GrowableArray<bool>* is_cold) {
+  auto& reverse_postorder = flow_graph->reverse_postorder();
+  const intptr_t block_count = reverse_postorder.length();
+
+  // Any block in the worklist is marked and any of its unconditional
+  // predecessors need to be marked as well.
+  GrowableArray<BlockEntryInstr*> worklist;
+
+  // Add all throwing blocks to the worklist.
+  for (intptr_t i = 0; i < block_count; ++i) {
+    auto block = reverse_postorder[i];
+    auto last = block->last_instruction();
+    if (last->IsThrow() || last->IsReThrow()) {
+      const intptr_t preorder_nr = block->preorder_number();
+      (*is_cold)[preorder_nr] = true;
+      worklist.Add(block);
+    }
+  }
+
+  // Follow all indirect predecessors which unconditionally will end up in a
+  // throwing block.
+  while (worklist.length() > 0) {
+    auto block = worklist.RemoveLast();
+    for (intptr_t i = 0; i < block->PredecessorCount(); ++i) {
+      auto predecessor = block->PredecessorAt(i);
+      if (predecessor->last_instruction()->IsGoto()) {
+        const intptr_t preorder_nr = predecessor->preorder_number();
+        if (!(*is_cold)[preorder_nr]) {
+          (*is_cold)[preorder_nr] = true;
+          worklist.Add(predecessor);
+        }
+      }
+    }
+  }
+}
+
+// Marks the successors of branches which the unoptimized code always took the
+// other way, as well as any block only reachable through such blocks.
+//
+// Blocks created by the optimizer have no edge weights, so a successor is only
+// considered cold if the other successor of its branch was taken.
+static void MarkNeverExecutedBlocks(FlowGraph* flow_graph,
+                                    GrowableArray<bool>* is_cold) {
+  auto& reverse_postorder = flow_graph->reverse_postorder();
+  for (intptr_t i = 0; i < reverse_postorder.length(); ++i) {
+    auto block = reverse_postorder[i];
+    const intptr_t preorder_nr = block->preorder_number();
+    if ((*is_cold)[preorder_nr]) continue;
+
+    if (auto target = block->AsTargetEntry()) {
+      auto predecessor = target->PredecessorAt(0);
+      if ((*is_cold)[predecessor->preorder_number()]) {
+        (*is_cold)[preorder_nr] = true;
+      } else if (auto branch = predecessor->last_instruction()->AsBranch()) {
+        TargetEntryInstr* other = (branch->true_successor() == target)
+                                      ? branch->false_successor()
+                                      : branch->true_successor();
+        if ((target->edge_weight() == 0.0) && (other->edge_weight() > 0.0)) {
+          (*is_cold)[preorder_nr] = true;
+        }
+      }
+    } else if (auto join = block->AsJoinEntry()) {
+      // Predecessors along back edges come later in reverse postorder and are
+      // not marked yet, which keeps loop headers out of the cold region.
+      bool all_cold = true;
+      for (intptr_t j = 0; j < join->PredecessorCount(); ++j) {
+        if (!(*is_cold)[join->PredecessorAt(j)->preorder_number()]) {
+          all_cold = false;
+          break;
+        }
+      }
+      (*is_cold)[preorder_nr] = all_cold;
+    }
+  }
+}
+
 void BlockScheduler::ReorderBlocks() const {
   if (FLAG_precompiled_mode) {
     ReorderBlocksAOT();
@@ -219,26 +298,44 @@ void BlockScheduler::ReorderBlocksJIT() const {
     Union(&chains, source_chain, target_chain);
   }
 
+  // Blocks the unoptimized code never reached are moved after all other
+  // blocks, so that the hot part of the function is contiguous. Slow paths
+  // are emitted after them.
+  GrowableArray<bool> is_cold(block_count);
+  is_cold.FillWith(false, 0, block_count);
+  MarkTerminatingBlocks(flow_graph(), &is_cold);
+  MarkNeverExecutedBlocks(flow_graph(), &is_cold);
+
   // Ensure the checked entry remains first to avoid needing another offset on
   // Instructions, compare Code::EntryPoint.
+  auto& codegen_order = *flow_graph()->CodegenBlockOrder(true);
   GraphEntryInstr* graph_entry = flow_graph()->graph_entry();
-  flow_graph()->CodegenBlockOrder(true)->Add(graph_entry);
+  codegen_order.Add(graph_entry);
   FunctionEntryInstr* checked_entry = graph_entry->normal_entry();
   if (checked_entry != nullptr) {
-    flow_graph()->CodegenBlockOrder(true)->Add(checked_entry);
+    codegen_order.Add(checked_entry);
   }
   // Build a new block order.  Emit each chain when its first block occurs
   // in the original reverse postorder ordering (which gives a topological
   // sort of the blocks).
+  GrowableArray<BlockEntryInstr*> cold_blocks;
   for (intptr_t i = block_count - 1; i >= 0; --i) {
     if (chains[i]->first->block == flow_graph()->postorder()[i]) {
       for (Link* link = chains[i]->first; link != NULL; link = link->next) {
         if ((link->block != checked_entry) && (link->block != graph_entry)) {
-          flow_graph()->CodegenBlockOrder(true)->Add(link->block);
+          if (is_cold[link->block->preorder_number()] &&
+              !link->block->IsFunctionEntry()) {
+            cold_blocks.Add(link->block);
+          } else {
+            codegen_order.Add(link->block);
+          }
         }
       }
     }
   }
+  for (intptr_t i = 0; i < cold_blocks.length(); ++i) {
+    codegen_order.Add(cold_blocks[i]);
+  }
 }
 
 // Moves blocks ending in a throw/rethrow, as well as any block post-dominated
@@ -252,37 +349,7 @@ void BlockScheduler::ReorderBlocksAOT() const {
   const intptr_t block_count = reverse_postorder.length();
   GrowableArray<bool> is_terminating(block_count);
   is_terminating.FillWith(false, 0, block_count);
-
-  // Any block in the worklist is marked and any of its unconditional
-  // predecessors need to be marked as well.
-  GrowableArray<BlockEntryInstr*> worklist;
-
-  // Add all throwing blocks to the worklist.
-  for (intptr_t i = 0; i < block_count; ++i) {
-    auto block = reverse_postorder[i];
-    auto last = block->last_instruction();
-    if (last->IsThrow() || last->IsReThrow()) {
-      const intptr_t preorder_nr = block->preorder_number();
-      is_terminating[preorder_nr] = true;
-      worklist.Add(block);
-    }
-  }
-
-  // Follow all indirect predecessors which unconditionally will end up in a
-  // throwing block.
-  while (worklist.length() > 0) {
-    auto block = worklist.RemoveLast();
-    for (intptr_t i = 0; i < block->PredecessorCount(); ++i) {
-      auto predecessor = block->PredecessorAt(i);
-      if (predecessor->last_instruction()->IsGoto()) {
-        const intptr_t preorder_nr = predecessor->preorder_number();
-        if (!is_terminating[preorder_nr]) {
-          is_terminating[preorder_nr] = true;
-          worklist.Add(predecessor);
-        }
-      }
-    }
-  }
+  MarkTerminatingBlocks(flow_graph(), &is_terminating);
 
   // Emit code in reverse postorder but move any throwing blocks (except the
   // function entry, which needs to come first) to the very end.
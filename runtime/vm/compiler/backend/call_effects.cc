@@ -0,0 +1,151 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/compiler/backend/call_effects.h"
+
+#include "vm/compiler/aot/precompiler.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/object.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            use_call_effects,
+            true,
+            "In AOT, forward loads across calls to functions which are known "
+            "not to write the loaded fields.");
+
+// Returns true if the given definition is an object allocated by the
+// function itself: writes into it can't be observed by the callers.
+static bool IsFreshAllocation(Definition* defn) {
+  defn = defn->OriginalDefinition();
+  return defn->IsAllocateObject() || defn->IsCreateArray() ||
+         defn->IsAllocateUninitializedContext();
+}
+
+CallEffects* CallEffects::Compute(FlowGraph* flow_graph) {
+  if (!FLAG_use_call_effects || !FLAG_precompiled_mode) {
+    return nullptr;
+  }
+
+  Zone* zone = flow_graph->zone();
+  CallEffects* effects = new (zone) CallEffects(zone);
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      Instruction* instr = it.Current();
+      if (instr->IsParallelMove()) {
+        continue;
+      }
+
+      if (StoreInstanceFieldInstr* store = instr->AsStoreInstanceField()) {
+        if (IsFreshAllocation(store->instance()->definition())) {
+          continue;
+        }
+        if (!store->slot().IsDartField() ||
+            !effects->Add(store->slot().field())) {
+          return nullptr;
+        }
+      } else if (StoreStaticFieldInstr* store = instr->AsStoreStaticField()) {
+        if (!effects->Add(store->field())) {
+          return nullptr;
+        }
+      } else if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+        if (!IsFreshAllocation(store->array()->definition())) {
+          return nullptr;
+        }
+      } else if (instr->IsStoreIndexedUnsafe() || instr->IsStoreUntagged() ||
+                 instr->IsMemoryCopy()) {
+        return nullptr;
+      } else if (instr->HasUnknownSideEffects()) {
+        const CallEffects* callee_effects = Of(instr);
+        if ((callee_effects == nullptr) || !effects->Add(*callee_effects)) {
+          return nullptr;
+        }
+      }
+    }
+  }
+  return effects;
+}
+
+const CallEffects* CallEffects::Of(Instruction* call) {
+#if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_DBC) &&                  \
+    !defined(TARGET_ARCH_IA32)
+  Precompiler* precompiler = Precompiler::Instance();
+  if (!FLAG_use_call_effects || (precompiler == nullptr)) {
+    return nullptr;
+  }
+
+  if (StaticCallInstr* static_call = call->AsStaticCall()) {
+    return precompiler->EffectsOf(static_call->function());
+  }
+
+  if (PolymorphicInstanceCallInstr* instance_call =
+          call->AsPolymorphicInstanceCall()) {
+    if (!instance_call->complete()) {
+      return nullptr;
+    }
+    const CallTargets& targets = instance_call->targets();
+    if (targets.length() == 1) {
+      return precompiler->EffectsOf(*targets.TargetAt(0)->target);
+    }
+    Zone* zone = Thread::Current()->zone();
+    CallEffects* effects = new (zone) CallEffects(zone);
+    for (intptr_t i = 0; i < targets.length(); i++) {
+      const CallEffects* target_effects =
+          precompiler->EffectsOf(*targets.TargetAt(i)->target);
+      if ((target_effects == nullptr) || !effects->Add(*target_effects)) {
+        return nullptr;
+      }
+    }
+    return effects;
+  }
+#endif
+  return nullptr;
+}
+
+bool CallEffects::MayWrite(const Field& field) const {
+  for (intptr_t i = 0; i < fields_.length(); i++) {
+    if (fields_[i]->Original() == field.Original()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+CallEffects* CallEffects::CopyTo(Zone* zone) const {
+  CallEffects* copy = new (zone) CallEffects(zone);
+  for (intptr_t i = 0; i < fields_.length(); i++) {
+    copy->fields_.Add(&Field::ZoneHandle(zone, fields_[i]->raw()));
+  }
+  return copy;
+}
+
+bool CallEffects::Add(const Field& field) {
+  if (MayWrite(field)) {
+    return true;
+  }
+  if (fields_.length() == kMaxFields) {
+    return false;
+  }
+  fields_.Add(&Field::ZoneHandle(zone_, field.Original()));
+  return true;
+}
+
+bool CallEffects::Add(const CallEffects& other) {
+  for (intptr_t i = 0; i < other.fields_.length(); i++) {
+    if (!Add(*other.fields_[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace dart
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
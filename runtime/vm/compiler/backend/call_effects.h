@@ -0,0 +1,61 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_CALL_EFFECTS_H_
+#define RUNTIME_VM_COMPILER_BACKEND_CALL_EFFECTS_H_
+
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+
+namespace dart {
+
+class Field;
+class FlowGraph;
+class Instruction;
+
+// Summary of the memory a function may write that is visible to its callers.
+//
+// A summary only exists for functions which write nothing but a small set of
+// Dart fields (stores into objects allocated by the function itself are not
+// visible to callers and are ignored). LoadOptimizer uses summaries to keep
+// loads of other fields alive across calls.
+//
+// Summaries are computed in AOT from the final flow graph of each compiled
+// function and recorded by the precompiler, so a call can only benefit from
+// the summary of a callee that was compiled before the caller.
+class CallEffects : public ZoneAllocated {
+ public:
+  explicit CallEffects(Zone* zone) : zone_(zone), fields_(zone, 4) {}
+
+  // Returns the summary of the given optimized flow graph, or nullptr if the
+  // function may write memory other than a few Dart fields.
+  static CallEffects* Compute(FlowGraph* flow_graph);
+
+  // Returns the summary of all possible targets of the given instruction
+  // with unknown side-effects, or nullptr if it is not known.
+  static const CallEffects* Of(Instruction* call);
+
+  // Returns true if the function may write the given field.
+  bool MayWrite(const Field& field) const;
+
+  // Copies this summary into the given zone.
+  CallEffects* CopyTo(Zone* zone) const;
+
+ private:
+  static const intptr_t kMaxFields = 16;
+
+  // Adds the given field or all fields of the given summary. Returns false
+  // if the summary became too large.
+  bool Add(const Field& field);
+  bool Add(const CallEffects& other);
+
+  Zone* zone_;
+  GrowableArray<const Field*> fields_;
+
+  DISALLOW_COPY_AND_ASSIGN(CallEffects);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_CALL_EFFECTS_H_
@@ -56,6 +56,7 @@ FlowGraph::FlowGraph(const ParsedFunction& parsed_function,
       loop_invariant_loads_(nullptr),
       deferred_prefixes_(parsed_function.deferred_prefixes()),
       captured_parameters_(new (zone()) BitVector(zone(), variable_count())),
+      coverage_array_(&Array::null_array()),
       inlining_id_(-1),
       should_print_(FlowGraphPrinter::ShouldPrint(parsed_function.function())) {
   DiscoverBlocks();
@@ -448,7 +449,7 @@ FlowGraph::ToCheck FlowGraph::CheckForInstanceCall(
           method_name.ToCString(), receiver_class.ToCString());
     }
     if (FLAG_use_cha_deopt) {
-      cha.AddToGuardedClasses(receiver_class, subclass_count);
+      cha.AddToGuardedClasses(receiver_class, method_name, subclass_count);
     }
     return receiver_maybe_null ? ToCheck::kCheckNull : ToCheck::kNoCheck;
   }
@@ -1770,12 +1771,20 @@ static void UnboxPhi(PhiInstr* phi) {
       break;
   }
 
-  // If all the inputs are unboxed, leave the Phi unboxed.
+  // If all the inputs are unboxed, leave the Phi unboxed. Integer constants
+  // are unboxed for free, so loop phis such as accumulators that start at a
+  // constant and are updated by unboxed int64 operations stay unboxed
+  // across the back edge instead of being boxed on every iteration.
   if ((unboxed == kTagged) && phi->Type()->IsInt()) {
     bool should_unbox = true;
+    bool has_constant_input = false;
     Representation new_representation = kTagged;
     for (intptr_t i = 0; i < phi->InputCount(); i++) {
       Definition* input = phi->InputAt(i)->definition();
+      if (input->IsConstant() && input->AsConstant()->value().IsInteger()) {
+        has_constant_input = true;
+        continue;
+      }
       if (input->representation() != kUnboxedInt64 &&
           input->representation() != kUnboxedInt32 &&
           input->representation() != kUnboxedUint32 && !(input == phi)) {
@@ -1789,6 +1798,14 @@ static void UnboxPhi(PhiInstr* phi) {
         new_representation = kNoRepresentation;
       }
     }
+    if (new_representation == kTagged) {
+      // Only constants and the phi itself: nothing to gain from unboxing.
+      should_unbox = false;
+    } else if (has_constant_input && (new_representation != kUnboxedInt64)) {
+      // Treat the constants like inputs of another representation: choose
+      // by the range of the phi.
+      new_representation = kNoRepresentation;
+    }
     if (should_unbox) {
       unboxed = new_representation != kNoRepresentation
                     ? new_representation
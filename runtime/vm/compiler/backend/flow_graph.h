@@ -342,6 +342,10 @@ class FlowGraph : public ZoneAllocated {
 
   BitVector* captured_parameters() const { return captured_parameters_; }
 
+  // The coverage array the code updates, see Function::GetCoverageArray.
+  const Array& coverage_array() const { return *coverage_array_; }
+  void set_coverage_array(const Array& array) { coverage_array_ = &array; }
+
   intptr_t inlining_id() const { return inlining_id_; }
   void set_inlining_id(intptr_t value) { inlining_id_ = value; }
 
@@ -528,6 +532,7 @@ class FlowGraph : public ZoneAllocated {
   ZoneGrowableArray<const LibraryPrefix*>* deferred_prefixes_;
   DirectChainedHashMap<ConstantPoolTrait> constant_instr_pool_;
   BitVector* captured_parameters_;
+  const Array* coverage_array_;
 
   intptr_t inlining_id_;
   bool should_print_;
@@ -774,6 +774,37 @@ void FlowGraphCompiler::AddPcRelativeCallStubTarget(const Code& stub_code) {
       &stub_code));
 }
 
+#if !defined(TARGET_ARCH_DBC)
+const Code& FlowGraphCompiler::IsolateSpecificStubFor(const Code& stub) {
+  if (!FLAG_precompiled_mode || !FLAG_use_bare_instructions ||
+      !stub.InVMIsolateHeap()) {
+    return stub;
+  }
+  auto object_store = isolate()->object_store();
+  auto& copy = Code::ZoneHandle(zone());
+  if (stub.raw() == StubCode::AllocateArray().raw()) {
+    copy = object_store->allocate_array_stub();
+  } else if (stub.raw() == StubCode::AllocateContext().raw()) {
+    copy = object_store->allocate_context_stub();
+  } else if (stub.raw() == StubCode::CallBootstrapNative().raw()) {
+    copy = object_store->call_bootstrap_native_stub();
+  } else if (stub.raw() == StubCode::CallAutoScopeNative().raw()) {
+    copy = object_store->call_auto_scope_native_stub();
+  } else if (stub.raw() == StubCode::CallNoScopeNative().raw()) {
+    copy = object_store->call_no_scope_native_stub();
+  } else if (stub.raw() == StubCode::Subtype1TestCache().raw()) {
+    copy = object_store->subtype1_test_cache_stub();
+  } else if (stub.raw() == StubCode::Subtype2TestCache().raw()) {
+    copy = object_store->subtype2_test_cache_stub();
+  } else if (stub.raw() == StubCode::Subtype4TestCache().raw()) {
+    copy = object_store->subtype4_test_cache_stub();
+  } else if (stub.raw() == StubCode::Subtype6TestCache().raw()) {
+    copy = object_store->subtype6_test_cache_stub();
+  }
+  return copy.IsNull() ? stub : copy;
+}
+#endif  // !defined(TARGET_ARCH_DBC)
+
 void FlowGraphCompiler::AddStaticCallTarget(const Function& func,
                                             Code::EntryKind entry_kind) {
   ASSERT(func.IsZoneHandle());
@@ -1234,7 +1265,8 @@ bool FlowGraphCompiler::TryIntrinsifyHelper() {
 
         // Only intrinsify getter if the field cannot contain a mutable double.
         // Reading from a mutable double box requires allocating a fresh double.
-        if (field.is_instance() &&
+        // Likewise, fields stored unboxed in the instance need a fresh box.
+        if (field.is_instance() && !field.is_unboxed() &&
             (FLAG_precompiled_mode || !IsPotentialUnboxedField(field))) {
           SpecialStatsBegin(CombinedCodeStatistics::kTagIntrinsics);
           GenerateGetterIntrinsic(compiler::target::Field::OffsetOf(field));
@@ -1253,7 +1285,7 @@ bool FlowGraphCompiler::TryIntrinsifyHelper() {
           field = field.CloneFromOriginal();
 #endif
 
-          if (field.is_instance() &&
+          if (field.is_instance() && !field.is_unboxed() &&
               (FLAG_precompiled_mode || field.guarded_cid() == kDynamicCid)) {
             SpecialStatsBegin(CombinedCodeStatistics::kTagIntrinsics);
             GenerateSetterIntrinsic(compiler::target::Field::OffsetOf(field));
@@ -882,6 +882,10 @@ class FlowGraphCompiler : public ValueObject {
   void AddPcRelativeCallTarget(const Function& function,
                                Code::EntryKind entry_kind);
   void AddPcRelativeCallStubTarget(const Code& stub_code);
+  // In bare instructions AOT mode, returns the isolate-specific copy of the
+  // VM stub 'stub' built by the precompiler, which unlike the VM stub can be
+  // called PC-relative. Otherwise returns 'stub'.
+  const Code& IsolateSpecificStubFor(const Code& stub);
   void AddStaticCallTarget(const Function& function,
                            Code::EntryKind entry_kind);
 
@@ -9,6 +9,7 @@
 
 #include "vm/compiler/backend/il_printer.h"
 #include "vm/compiler/backend/locations.h"
+#include "vm/compiler/jit/code_cache.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/cpu.h"
 #include "vm/dart_entry.h"
@@ -235,25 +236,33 @@ RawSubtypeTestCache* FlowGraphCompiler::GenerateCallSubtypeTestStub(
   const SubtypeTestCache& type_test_cache =
       SubtypeTestCache::ZoneHandle(zone(), SubtypeTestCache::New());
   __ LoadUniqueObject(R3, type_test_cache);
+  const Code* stub = nullptr;
   if (test_kind == kTestTypeOneArg) {
     ASSERT(instantiator_type_arguments_reg == kNoRegister);
     ASSERT(function_type_arguments_reg == kNoRegister);
-    __ BranchLink(StubCode::Subtype1TestCache());
+    stub = &StubCode::Subtype1TestCache();
   } else if (test_kind == kTestTypeTwoArgs) {
     ASSERT(instantiator_type_arguments_reg == kNoRegister);
     ASSERT(function_type_arguments_reg == kNoRegister);
-    __ BranchLink(StubCode::Subtype2TestCache());
+    stub = &StubCode::Subtype2TestCache();
   } else if (test_kind == kTestTypeFourArgs) {
     ASSERT(instantiator_type_arguments_reg == R2);
     ASSERT(function_type_arguments_reg == R1);
-    __ BranchLink(StubCode::Subtype4TestCache());
+    stub = &StubCode::Subtype4TestCache();
   } else if (test_kind == kTestTypeSixArgs) {
     ASSERT(instantiator_type_arguments_reg == R2);
     ASSERT(function_type_arguments_reg == R1);
-    __ BranchLink(StubCode::Subtype6TestCache());
+    stub = &StubCode::Subtype6TestCache();
   } else {
     UNREACHABLE();
   }
+  const Code& target = IsolateSpecificStubFor(*stub);
+  if (!target.InVMIsolateHeap()) {
+    AddPcRelativeCallStubTarget(target);
+    __ GenerateUnRelocatedPcRelativeCall();
+  } else {
+    __ BranchLink(target);
+  }
   // Result is in R1: null -> not found, otherwise Bool::True or Bool::False.
   GenerateBoolToJump(R1, is_instance_lbl, is_not_instance_lbl);
   return type_test_cache.raw();
@@ -885,6 +894,15 @@ void FlowGraphCompiler::EmitFrameEntry() {
     ASSERT(function_reg == R8);
     __ Branch(Address(THR, compiler::target::Thread::optimize_entry_offset()),
               GE);
+  } else if (CodeCache::IsEnabled()) {
+    // Let the code cache tell code in use from cold code.
+    __ Comment("Invocation Count");
+    const intptr_t usage_counter_offset =
+        compiler::target::Function::usage_counter_offset();
+    __ ldr(R8, FieldAddress(CODE_REG, compiler::target::Code::owner_offset()));
+    __ ldr(R3, FieldAddress(R8, usage_counter_offset));
+    __ add(R3, R3, Operand(1));
+    __ str(R3, FieldAddress(R8, usage_counter_offset));
   }
   __ Comment("Enter frame");
   if (flow_graph().IsCompiledForOsr()) {
@@ -957,16 +975,17 @@ void FlowGraphCompiler::GenerateCall(TokenPosition token_pos,
                                      const Code& stub,
                                      RawPcDescriptors::Kind kind,
                                      LocationSummary* locs) {
+  const Code& target = IsolateSpecificStubFor(stub);
   if (FLAG_precompiled_mode && FLAG_use_bare_instructions &&
-      !stub.InVMIsolateHeap()) {
-    AddPcRelativeCallStubTarget(stub);
+      !target.InVMIsolateHeap()) {
+    AddPcRelativeCallStubTarget(target);
     __ GenerateUnRelocatedPcRelativeCall();
     EmitCallsiteMetadata(token_pos, DeoptId::kNone, kind, locs);
   } else {
-    ASSERT(!stub.IsNull());
-    __ BranchLink(stub);
+    ASSERT(!target.IsNull());
+    __ BranchLink(target);
     EmitCallsiteMetadata(token_pos, DeoptId::kNone, kind, locs);
-    AddStubCallTarget(stub);
+    AddStubCallTarget(target);
   }
 }
 
@@ -1059,12 +1078,9 @@ void FlowGraphCompiler::EmitOptimizedInstanceCall(const Code& stub,
   // Pass the function explicitly, it is used in IC stub.
 
   __ LoadObject(R8, parsed_function().function());
-  __ LoadFromOffset(kWord, R0, SP,
-                    (ic_data.CountWithoutTypeArgs() - 1) * kWordSize);
-  __ LoadUniqueObject(R9, ic_data);
-  GenerateDartCall(deopt_id, token_pos, stub, RawPcDescriptors::kIcCall, locs,
-                   entry_kind);
-  __ Drop(ic_data.CountWithTypeArgs());
+  // The call has the same shape as in unoptimized code, so it can be switched
+  // to a monomorphic call the same way.
+  EmitInstanceCallJIT(stub, ic_data, deopt_id, token_pos, locs, entry_kind);
 }
 
 void FlowGraphCompiler::EmitInstanceCallJIT(const Code& stub,
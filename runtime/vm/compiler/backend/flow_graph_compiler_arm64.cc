@@ -9,6 +9,7 @@
 
 #include "vm/compiler/backend/il_printer.h"
 #include "vm/compiler/backend/locations.h"
+#include "vm/compiler/jit/code_cache.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/cpu.h"
 #include "vm/dart_entry.h"
@@ -227,25 +228,33 @@ RawSubtypeTestCache* FlowGraphCompiler::GenerateCallSubtypeTestStub(
   const SubtypeTestCache& type_test_cache =
       SubtypeTestCache::ZoneHandle(zone(), SubtypeTestCache::New());
   __ LoadUniqueObject(R3, type_test_cache);
+  const Code* stub = nullptr;
   if (test_kind == kTestTypeOneArg) {
     ASSERT(instantiator_type_arguments_reg == kNoRegister);
     ASSERT(function_type_arguments_reg == kNoRegister);
-    __ BranchLink(StubCode::Subtype1TestCache());
+    stub = &StubCode::Subtype1TestCache();
   } else if (test_kind == kTestTypeTwoArgs) {
     ASSERT(instantiator_type_arguments_reg == kNoRegister);
     ASSERT(function_type_arguments_reg == kNoRegister);
-    __ BranchLink(StubCode::Subtype2TestCache());
+    stub = &StubCode::Subtype2TestCache();
   } else if (test_kind == kTestTypeFourArgs) {
     ASSERT(instantiator_type_arguments_reg == R1);
     ASSERT(function_type_arguments_reg == R2);
-    __ BranchLink(StubCode::Subtype4TestCache());
+    stub = &StubCode::Subtype4TestCache();
   } else if (test_kind == kTestTypeSixArgs) {
     ASSERT(instantiator_type_arguments_reg == R1);
     ASSERT(function_type_arguments_reg == R2);
-    __ BranchLink(StubCode::Subtype6TestCache());
+    stub = &StubCode::Subtype6TestCache();
   } else {
     UNREACHABLE();
   }
+  const Code& target = IsolateSpecificStubFor(*stub);
+  if (!target.InVMIsolateHeap()) {
+    AddPcRelativeCallStubTarget(target);
+    __ GenerateUnRelocatedPcRelativeCall();
+  } else {
+    __ BranchLink(target);
+  }
   // Result is in R1: null -> not found, otherwise Bool::True or Bool::False.
   GenerateBoolToJump(R1, is_instance_lbl, is_not_instance_lbl);
   return type_test_cache.raw();
@@ -859,6 +868,13 @@ void FlowGraphCompiler::EmitFrameEntry() {
     __ ldr(TMP, Address(THR, Thread::optimize_entry_offset()));
     __ br(TMP);
     __ Bind(&dont_optimize);
+  } else if (CodeCache::IsEnabled()) {
+    // Let the code cache tell code in use from cold code.
+    __ Comment("Invocation Count");
+    __ ldr(R6, FieldAddress(CODE_REG, Code::owner_offset()));
+    __ LoadFieldFromOffset(R7, R6, Function::usage_counter_offset(), kWord);
+    __ add(R7, R7, Operand(1));
+    __ StoreFieldToOffset(R7, R6, Function::usage_counter_offset(), kWord);
   }
   __ Comment("Enter frame");
   if (flow_graph().IsCompiledForOsr()) {
@@ -930,16 +946,17 @@ void FlowGraphCompiler::GenerateCall(TokenPosition token_pos,
                                      const Code& stub,
                                      RawPcDescriptors::Kind kind,
                                      LocationSummary* locs) {
+  const Code& target = IsolateSpecificStubFor(stub);
   if (FLAG_precompiled_mode && FLAG_use_bare_instructions &&
-      !stub.InVMIsolateHeap()) {
-    AddPcRelativeCallStubTarget(stub);
+      !target.InVMIsolateHeap()) {
+    AddPcRelativeCallStubTarget(target);
     __ GenerateUnRelocatedPcRelativeCall();
     EmitCallsiteMetadata(token_pos, DeoptId::kNone, kind, locs);
   } else {
-    ASSERT(!stub.IsNull());
-    __ BranchLink(stub);
+    ASSERT(!target.IsNull());
+    __ BranchLink(target);
     EmitCallsiteMetadata(token_pos, DeoptId::kNone, kind, locs);
-    AddStubCallTarget(stub);
+    AddStubCallTarget(target);
   }
 }
 
@@ -1026,10 +1043,10 @@ void FlowGraphCompiler::EmitOptimizedInstanceCall(const Code& stub,
   // Pass the function explicitly, it is used in IC stub.
 
   __ LoadObject(R6, parsed_function().function());
-  __ LoadFromOffset(R0, SP, (ic_data.CountWithoutTypeArgs() - 1) * kWordSize);
-  __ LoadUniqueObject(R5, ic_data);
-  GenerateDartCall(deopt_id, token_pos, stub, RawPcDescriptors::kIcCall, locs);
-  __ Drop(ic_data.CountWithTypeArgs());
+  // The call has the same shape as in unoptimized code, so it can be switched
+  // to a monomorphic call the same way.
+  EmitInstanceCallJIT(stub, ic_data, deopt_id, token_pos, locs,
+                      Code::EntryKind::kNormal);
 }
 
 void FlowGraphCompiler::EmitInstanceCallJIT(const Code& stub,
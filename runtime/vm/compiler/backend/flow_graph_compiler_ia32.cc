@@ -11,6 +11,7 @@
 #include "vm/compiler/backend/il_printer.h"
 #include "vm/compiler/backend/locations.h"
 #include "vm/compiler/frontend/flow_graph_builder.h"
+#include "vm/compiler/jit/code_cache.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/cpu.h"
 #include "vm/dart_entry.h"
@@ -779,6 +780,11 @@ void FlowGraphCompiler::EmitFrameEntry() {
     __ j(LESS, &dont_optimize, Assembler::kNearJump);
     __ jmp(Address(THR, Thread::optimize_entry_offset()));
     __ Bind(&dont_optimize);
+  } else if (CodeCache::IsEnabled()) {
+    // Let the code cache tell code in use from cold code.
+    __ Comment("Invocation Count");
+    __ LoadObject(EBX, function);
+    __ incl(FieldAddress(EBX, Function::usage_counter_offset()));
   }
   __ Comment("Enter frame");
   if (flow_graph().IsCompiledForOsr()) {
@@ -915,11 +921,10 @@ void FlowGraphCompiler::EmitOptimizedInstanceCall(const Code& stub,
   // reoptimized and which counter needs to be incremented.
   // Pass the function explicitly, it is used in IC stub.
   __ LoadObject(EAX, parsed_function().function());
-  // Load receiver into EBX.
-  __ movl(EBX, Address(ESP, (ic_data.CountWithoutTypeArgs() - 1) * kWordSize));
-  __ LoadObject(ECX, ic_data);
-  GenerateDartCall(deopt_id, token_pos, stub, RawPcDescriptors::kIcCall, locs);
-  __ Drop(ic_data.CountWithTypeArgs());
+  // The call has the same shape as in unoptimized code, so it can be switched
+  // to a monomorphic call the same way.
+  EmitInstanceCallJIT(stub, ic_data, deopt_id, token_pos, locs,
+                      Code::EntryKind::kNormal);
 }
 
 void FlowGraphCompiler::EmitInstanceCallJIT(const Code& stub,
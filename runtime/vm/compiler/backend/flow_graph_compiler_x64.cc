@@ -9,6 +9,7 @@
 
 #include "vm/compiler/backend/il_printer.h"
 #include "vm/compiler/backend/locations.h"
+#include "vm/compiler/jit/code_cache.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/dart_entry.h"
 #include "vm/deopt_instructions.h"
@@ -232,25 +233,33 @@ RawSubtypeTestCache* FlowGraphCompiler::GenerateCallSubtypeTestStub(
   const SubtypeTestCache& type_test_cache =
       SubtypeTestCache::ZoneHandle(zone(), SubtypeTestCache::New());
   __ LoadUniqueObject(R9, type_test_cache);
+  const Code* stub = nullptr;
   if (test_kind == kTestTypeOneArg) {
     ASSERT(instantiator_type_arguments_reg == kNoRegister);
     ASSERT(function_type_arguments_reg == kNoRegister);
-    __ Call(StubCode::Subtype1TestCache());
+    stub = &StubCode::Subtype1TestCache();
   } else if (test_kind == kTestTypeTwoArgs) {
     ASSERT(instantiator_type_arguments_reg == kNoRegister);
     ASSERT(function_type_arguments_reg == kNoRegister);
-    __ Call(StubCode::Subtype2TestCache());
+    stub = &StubCode::Subtype2TestCache();
   } else if (test_kind == kTestTypeFourArgs) {
     ASSERT(RDX == instantiator_type_arguments_reg);
     ASSERT(RCX == function_type_arguments_reg);
-    __ Call(StubCode::Subtype4TestCache());
+    stub = &StubCode::Subtype4TestCache();
   } else if (test_kind == kTestTypeSixArgs) {
     ASSERT(RDX == instantiator_type_arguments_reg);
     ASSERT(RCX == function_type_arguments_reg);
-    __ Call(StubCode::Subtype6TestCache());
+    stub = &StubCode::Subtype6TestCache();
   } else {
     UNREACHABLE();
   }
+  const Code& target = IsolateSpecificStubFor(*stub);
+  if (!target.InVMIsolateHeap()) {
+    AddPcRelativeCallStubTarget(target);
+    __ GenerateUnRelocatedPcRelativeCall();
+  } else {
+    __ Call(target);
+  }
   // Result is in R8: null -> not found, otherwise Bool::True or Bool::False.
   GenerateBoolToJump(R8, is_instance_lbl, is_not_instance_lbl);
   return type_test_cache.raw();
@@ -877,6 +886,11 @@ void FlowGraphCompiler::EmitFrameEntry() {
       __ j(LESS, &dont_optimize, Assembler::kNearJump);
       __ jmp(Address(THR, Thread::optimize_entry_offset()));
       __ Bind(&dont_optimize);
+    } else if (CodeCache::IsEnabled()) {
+      // Let the code cache tell code in use from cold code.
+      __ Comment("Invocation Count");
+      __ movq(RDI, FieldAddress(CODE_REG, Code::owner_offset()));
+      __ incl(FieldAddress(RDI, Function::usage_counter_offset()));
     }
     ASSERT(StackSize() >= 0);
     __ Comment("Enter frame");
@@ -940,16 +954,17 @@ void FlowGraphCompiler::GenerateCall(TokenPosition token_pos,
                                      const Code& stub,
                                      RawPcDescriptors::Kind kind,
                                      LocationSummary* locs) {
+  const Code& target = IsolateSpecificStubFor(stub);
   if (FLAG_precompiled_mode && FLAG_use_bare_instructions &&
-      !stub.InVMIsolateHeap()) {
-    AddPcRelativeCallStubTarget(stub);
+      !target.InVMIsolateHeap()) {
+    AddPcRelativeCallStubTarget(target);
     __ GenerateUnRelocatedPcRelativeCall();
     EmitCallsiteMetadata(token_pos, DeoptId::kNone, kind, locs);
   } else {
-    ASSERT(!stub.IsNull());
-    __ Call(stub);
+    ASSERT(!target.IsNull());
+    __ Call(target);
     EmitCallsiteMetadata(token_pos, DeoptId::kNone, kind, locs);
-    AddStubCallTarget(stub);
+    AddStubCallTarget(target);
   }
 }
 
@@ -1043,12 +1058,9 @@ void FlowGraphCompiler::EmitOptimizedInstanceCall(const Code& stub,
   // reoptimized and which counter needs to be incremented.
   // Pass the function explicitly, it is used in IC stub.
   __ LoadObject(RDI, parsed_function().function());
-  // Load receiver into RDX.
-  __ movq(RDX, Address(RSP, (ic_data.CountWithoutTypeArgs() - 1) * kWordSize));
-  __ LoadUniqueObject(RBX, ic_data);
-  GenerateDartCall(deopt_id, token_pos, stub, RawPcDescriptors::kIcCall, locs,
-                   entry_kind);
-  __ Drop(ic_data.CountWithTypeArgs(), RCX);
+  // The call has the same shape as in unoptimized code, so it can be switched
+  // to a monomorphic call the same way.
+  EmitInstanceCallJIT(stub, ic_data, deopt_id, token_pos, locs, entry_kind);
 }
 
 void FlowGraphCompiler::EmitInstanceCallJIT(const Code& stub,
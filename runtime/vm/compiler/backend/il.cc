@@ -422,15 +422,10 @@ bool HierarchyInfo::CanUseGenericSubtypeRangeCheckFor(
          type.arguments() != TypeArguments::null());
 
   // If the type class is implemented the different implementations might have
-  // their type argument vector stored at different offsets and we can therefore
-  // not perform our optimized [CidRange]-based implementation.
-  //
-  // TODO(kustermann): If the class is implemented but all implementations
-  // store the instantator type argument vector at the same offset we can
-  // still do it!
-  if (type_class.is_implemented()) {
-    return false;
-  }
+  // their type argument vector stored at different offsets or their type
+  // arguments at different positions.  The type testing stub will then only
+  // handle the implementations which agree on both and leave the others to
+  // the slow path (see [TypeTestingStubGenerator]).
 
   const TypeArguments& ta =
       TypeArguments::Handle(zone, Type::Cast(type).arguments());
@@ -476,7 +471,8 @@ bool HierarchyInfo::InstanceOfHasClassRange(const AbstractType& type,
 #if defined(DEBUG)
 void Instruction::CheckField(const Field& field) const {
   ASSERT(field.IsZoneHandle());
-  ASSERT(!Compiler::IsBackgroundCompilation() || !field.IsOriginal());
+  ASSERT(FLAG_precompiled_mode || !Compiler::IsBackgroundCompilation() ||
+         !field.IsOriginal());
 }
 #endif  // DEBUG
 
@@ -901,6 +897,9 @@ bool LoadFieldInstr::IsPotentialUnboxedLoad() const {
 }
 
 Representation LoadFieldInstr::representation() const {
+  if (slot().is_unboxed()) {
+    return slot().UnboxedRepresentation();
+  }
   if (IsUnboxedLoad()) {
     const intptr_t cid = slot().field().UnboxedFieldCid();
     switch (cid) {
@@ -930,6 +929,9 @@ bool StoreInstanceFieldInstr::IsPotentialUnboxedStore() const {
 Representation StoreInstanceFieldInstr::RequiredInputRepresentation(
     intptr_t index) const {
   ASSERT((index == 0) || (index == 1));
+  if ((index == 1) && slot().is_unboxed()) {
+    return slot().UnboxedRepresentation();
+  }
   if ((index == 1) && IsUnboxedStore()) {
     const intptr_t cid = slot().field().UnboxedFieldCid();
     switch (cid) {
@@ -2706,6 +2708,7 @@ bool LoadFieldInstr::IsImmutableLengthLoad() const {
     case Slot::Kind::kClosure_instantiator_type_arguments:
     case Slot::Kind::kClosure_hash:
     case Slot::Kind::kCapturedVariable:
+    case Slot::Kind::kArrayElement:
     case Slot::Kind::kDartField:
     case Slot::Kind::kPointer_c_memory_address:
       return false;
@@ -4187,6 +4190,27 @@ void ConstraintInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   UNREACHABLE();
 }
 
+MaterializeObjectInstr::MaterializeObjectInstr(
+    CreateArrayInstr* allocation,
+    const ZoneGrowableArray<const Slot*>& slots,
+    ZoneGrowableArray<Value*>* values)
+    : allocation_(allocation),
+      cls_(Class::ZoneHandle(
+          Isolate::Current()->object_store()->array_class())),
+      num_variables_(
+          Smi::Cast(allocation->num_elements()->BoundConstant()).Value()),
+      slots_(slots),
+      values_(values),
+      locations_(NULL),
+      visited_for_liveness_(false),
+      registers_remapped_(false) {
+  ASSERT(slots_.length() == values_->length());
+  for (intptr_t i = 0; i < InputCount(); i++) {
+    InputAt(i)->set_instruction(this);
+    InputAt(i)->set_use_index(i);
+  }
+}
+
 LocationSummary* MaterializeObjectInstr::MakeLocationSummary(
     Zone* zone,
     bool optimizing) const {
@@ -5179,16 +5203,30 @@ const Function& StringInterpolateInstr::CallFunction() const {
     const Class& cls =
         Class::Handle(Library::LookupCoreClass(Symbols::StringBase()));
     ASSERT(!cls.IsNull());
+    const String& name = has_known_part_types_
+                             ? Symbols::InterpolateKnownParts()
+                             : Symbols::Interpolate();
     function_ = Resolver::ResolveStatic(
-        cls, Library::PrivateCoreLibName(Symbols::Interpolate()), kTypeArgsLen,
+        cls, Library::PrivateCoreLibName(name), kTypeArgsLen,
         kNumberOfArguments, kNoArgumentNames);
   }
   ASSERT(!function_.IsNull());
   return function_;
 }
 
+// Whether the interpolation of a value of this type can be formatted by
+// _StringBase._interpolateKnownParts without calling toString.
+static bool IsKnownInterpolationPartType(CompileType* type) {
+  return type->IsNullableInt() || type->IsNullableDouble() ||
+         type->IsAssignableTo(Type::Handle(Type::StringType())) ||
+         type->IsAssignableTo(Type::Handle(Type::BoolType()));
+}
+
 // Replace StringInterpolateInstr with a constant string if all inputs are
 // constant of [string, number, boolean, null].
+// Otherwise, if all inputs are known to be of these types, call
+// _StringBase._interpolateKnownParts, which allocates the result once and
+// formats the numbers straight into it, instead of _StringBase._interpolate.
 // Leave the CreateArrayInstr and StoreIndexedInstr in the stream in case
 // deoptimization occurs.
 Definition* StringInterpolateInstr::Canonicalize(FlowGraph* flow_graph) {
@@ -5219,6 +5257,24 @@ Definition* StringInterpolateInstr::Canonicalize(FlowGraph* flow_graph) {
     pieces.Add(Object::null_string());
   }
 
+  bool has_known_part_types = true;
+  for (Value::Iterator it(create_array->input_use_list()); !it.Done();
+       it.Advance()) {
+    Instruction* curr = it.Current()->instruction();
+    if (curr == this) continue;
+
+    StoreIndexedInstr* store = curr->AsStoreIndexed();
+    if ((store == NULL) || (store->array()->definition() != create_array)) {
+      return this;
+    }
+    has_known_part_types = has_known_part_types &&
+                           IsKnownInterpolationPartType(store->value()->Type());
+  }
+  if (has_known_part_types && !has_known_part_types_) {
+    has_known_part_types_ = true;
+    function_ = Function::null();
+  }
+
   for (Value::Iterator it(create_array->input_use_list()); !it.Done();
        it.Advance()) {
     Instruction* curr = it.Current()->instruction();
@@ -5472,7 +5528,8 @@ void BitCastInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
 #endif  // defined(TARGET_ARCH_ARM)
 
 Representation FfiCallInstr::RequiredInputRepresentation(intptr_t idx) const {
-  if (idx == TargetAddressIndex()) {
+  if (idx == TargetAddressIndex() ||
+      (HasStructResult() && idx == ResultAddressIndex())) {
     return kUnboxedFfiIntPtr;
   } else {
     return arg_representations_[idx];
@@ -5533,6 +5590,12 @@ LocationSummary* FfiCallInstr::MakeLocationSummary(Zone* zone,
     summary->set_in(i, UnallocateStackSlots(arg_locations_[i], is_atomic));
   }
 
+  // The address of the memory for a struct result is kept in the outgoing
+  // argument area during the call.
+  if (HasStructResult()) {
+    summary->set_in(ResultAddressIndex(), Location::Any());
+  }
+
   return summary;
 }
 
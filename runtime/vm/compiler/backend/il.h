@@ -237,8 +237,10 @@ class HierarchyInfo : public ThreadStackResource {
   // determine if a given instance's type is a subtype of [type].
   //
   // This is the case for [type]s with type arguments where we are able to do a
-  // [CidRange]-based subclass-check against the class and [CidRange]-based
-  // subtype-checks against the type arguments.
+  // [CidRange]-based subclass-check against the class (or, if the class is
+  // implemented, a check against those implementations which store the type
+  // arguments in a compatible way) and [CidRange]-based subtype-checks against
+  // the type arguments.
   //
   // This method should only be called if [CanUseSubtypeRangecheckFor] returned
   // false.
@@ -389,6 +391,7 @@ struct InstrAttrs {
   M(LoadField, kNoGC)                                                          \
   M(LoadUntagged, kNoGC)                                                       \
   M(StoreUntagged, kNoGC)                                                      \
+  M(MemoryCopy, kNoGC)                                                         \
   M(LoadClassId, kNoGC)                                                        \
   M(InstantiateType, _)                                                        \
   M(InstantiateTypeArguments, _)                                               \
@@ -953,6 +956,7 @@ class Instruction : public ZoneAllocated {
   friend class LICM;
   friend class ComparisonInstr;
   friend class Scheduler;
+  friend class UnrollableLoop;
   friend class BlockEntryInstr;
   friend class CatchBlockEntryInstr;  // deopt_id_
   friend class DebugStepCheckInstr;   // deopt_id_
@@ -4311,34 +4315,80 @@ class FfiCallInstr : public Definition {
   FfiCallInstr(Zone* zone,
                intptr_t deopt_id,
                const Function& signature,
+               bool is_leaf,
                const ZoneGrowableArray<Representation>& arg_reps,
                const ZoneGrowableArray<Location>& arg_locs,
-               const ZoneGrowableArray<HostLocation>* arg_host_locs = nullptr)
+               const ZoneGrowableArray<HostLocation>* arg_host_locs = nullptr,
+               const compiler::ffi::StructCallingConvention* structs = nullptr)
       : Definition(deopt_id),
         zone_(zone),
         signature_(signature),
+        is_leaf_(is_leaf),
         inputs_(arg_reps.length() + 1),
         arg_representations_(arg_reps),
         arg_locations_(arg_locs),
-        arg_host_locations_(arg_host_locs) {
-    inputs_.FillWith(nullptr, 0, arg_reps.length() + 1);
+        arg_host_locations_(arg_host_locs),
+        structs_(structs) {
+    const intptr_t num_inputs =
+        arg_reps.length() + (HasStructResult() ? 2 : 1);
+    inputs_.FillWith(nullptr, 0, num_inputs);
     ASSERT(signature.IsZoneHandle());
   }
 
   DECLARE_INSTRUCTION(FfiCall)
 
   // Number of arguments to the native function.
-  intptr_t NativeArgCount() const { return InputCount() - 1; }
+  intptr_t NativeArgCount() const {
+    return InputCount() - (HasStructResult() ? 2 : 1);
+  }
+
+  // Whether the native function returns a struct by value, which is stored
+  // to the memory at the address in input [ResultAddressIndex]. The result of
+  // the call is that address.
+  bool HasStructResult() const {
+    return structs_ != nullptr && structs_->has_struct_result();
+  }
+
+  // Input index of the address of the memory for a struct result.
+  intptr_t ResultAddressIndex() const {
+    ASSERT(HasStructResult());
+    return NativeArgCount();
+  }
 
   // Input index of the function pointer to invoke.
-  intptr_t TargetAddressIndex() const { return NativeArgCount(); }
+  intptr_t TargetAddressIndex() const { return InputCount() - 1; }
+
+  // How structs are passed and returned by value, nullptr if the native
+  // function neither takes nor returns structs by value.
+  const compiler::ffi::StructCallingConvention* structs() const {
+    return structs_;
+  }
+
+  // Number of stack slots in the outgoing argument area: the stack arguments
+  // and, for a struct result, a slot which keeps the address of its memory
+  // during the call.
+  intptr_t NumOutgoingStackSlots() const {
+    return compiler::ffi::NumStackSlots(arg_locations_) +
+           (HasStructResult() ? 1 : 0);
+  }
+
+  // Stack slot which keeps the address of the memory for a struct result.
+  intptr_t ResultAddressStackSlot() const {
+    ASSERT(HasStructResult());
+    return NumOutgoingStackSlots() - 1;
+  }
+
+  // Leaf calls promise not to call back into Dart or block, so they are made
+  // without an exit frame and without leaving the safepoint state of
+  // generated code.
+  bool is_leaf() const { return is_leaf_; }
 
   virtual intptr_t InputCount() const { return inputs_.length(); }
   virtual Value* InputAt(intptr_t i) const { return inputs_[i]; }
   virtual bool MayThrow() const { return false; }
 
   // FfiCallInstr calls C code, which can call back into Dart.
-  virtual bool ComputeCanDeoptimize() const { return true; }
+  virtual bool ComputeCanDeoptimize() const { return !is_leaf_; }
 
   virtual bool HasUnknownSideEffects() const { return true; }
 
@@ -4356,11 +4406,13 @@ class FfiCallInstr : public Definition {
 
   Zone* const zone_;
   const Function& signature_;
+  const bool is_leaf_;
 
   GrowableArray<Value*> inputs_;
   const ZoneGrowableArray<Representation>& arg_representations_;
   const ZoneGrowableArray<Location>& arg_locations_;
   const ZoneGrowableArray<HostLocation>* arg_host_locations_;
+  const compiler::ffi::StructCallingConvention* const structs_;
 
   DISALLOW_COPY_AND_ASSIGN(FfiCallInstr);
 };
@@ -4462,6 +4514,10 @@ class StoreInstanceFieldInstr : public TemplateInstruction<2, NoThrow> {
   bool is_initialization() const { return is_initialization_; }
 
   bool ShouldEmitStoreBarrier() const {
+    if (slot().is_unboxed()) {
+      // Unboxed values are not pointers.
+      return false;
+    }
     if (instance()->definition() == value()->definition()) {
       // `x.slot = x` cannot create an old->new or old&marked->old&unmarked
       // reference.
@@ -4860,13 +4916,18 @@ class StringInterpolateInstr : public TemplateDefinition<1, Throws> {
                          intptr_t deopt_id)
       : TemplateDefinition(deopt_id),
         token_pos_(token_pos),
-        function_(Function::ZoneHandle()) {
+        function_(Function::ZoneHandle()),
+        has_known_part_types_(false) {
     SetInputAt(0, value);
   }
 
   Value* value() const { return inputs_[0]; }
   virtual TokenPosition token_pos() const { return token_pos_; }
 
+  // True if all parts are known to be strings, numbers, booleans or null, so
+  // that they can be concatenated without calling toString on them.
+  bool has_known_part_types() const { return has_known_part_types_; }
+
   virtual CompileType ComputeType() const;
   // Issues a static call to Dart code which calls toString on objects.
   virtual bool HasUnknownSideEffects() const { return true; }
@@ -4881,6 +4942,7 @@ class StringInterpolateInstr : public TemplateDefinition<1, Throws> {
  private:
   const TokenPosition token_pos_;
   Function& function_;
+  bool has_known_part_types_;
 
   DISALLOW_COPY_AND_ASSIGN(StringInterpolateInstr);
 };
@@ -4909,6 +4971,8 @@ class StoreIndexedInstr : public TemplateInstruction<3, NoThrow> {
   intptr_t class_id() const { return class_id_; }
   bool aligned() const { return alignment_ == kAlignedAccess; }
 
+  virtual TokenPosition token_pos() const { return token_pos_; }
+
   bool ShouldEmitStoreBarrier() const {
     if (array()->definition() == value()->definition()) {
       // `x[slot] = x` cannot create an old->new or old&marked->old&unmarked
@@ -4920,6 +4984,10 @@ class StoreIndexedInstr : public TemplateInstruction<3, NoThrow> {
            (emit_store_barrier_ == kEmitStoreBarrier);
   }
 
+  void set_emit_store_barrier(StoreBarrierType value) {
+    emit_store_barrier_ = value;
+  }
+
   virtual SpeculativeMode speculative_mode() const { return speculative_mode_; }
 
   virtual bool ComputeCanDeoptimize() const { return false; }
@@ -4943,7 +5011,7 @@ class StoreIndexedInstr : public TemplateInstruction<3, NoThrow> {
     return Assembler::kValueCanBeSmi;
   }
 
-  const StoreBarrierType emit_store_barrier_;
+  StoreBarrierType emit_store_barrier_;
   const intptr_t index_scale_;
   const intptr_t class_id_;
   const AlignmentType alignment_;
@@ -5195,6 +5263,10 @@ class MaterializeObjectInstr : public Definition {
     }
   }
 
+  MaterializeObjectInstr(CreateArrayInstr* allocation,
+                         const ZoneGrowableArray<const Slot*>& slots,
+                         ZoneGrowableArray<Value*>* values);
+
   Definition* allocation() const { return allocation_; }
   const Class& cls() const { return cls_; }
 
@@ -5392,6 +5464,68 @@ class StoreUntaggedInstr : public TemplateInstruction<2, NoThrow> {
   DISALLOW_COPY_AND_ASSIGN(StoreUntaggedInstr);
 };
 
+// Copies [length] elements of [element_size] bytes from the payload of the
+// typed data (or view) [src] starting at element [src_start] to the payload of
+// [dest] starting at element [dest_start], as memmove would: the ranges may
+// overlap.
+//
+// The payload addresses are loaded from the objects by the instruction itself,
+// so no derived pointer is live across the instructions around it. The caller
+// checks the ranges.
+class MemoryCopyInstr : public TemplateInstruction<5, NoThrow> {
+ public:
+  MemoryCopyInstr(Value* src,
+                  Value* dest,
+                  Value* src_start,
+                  Value* dest_start,
+                  Value* length,
+                  intptr_t element_size)
+      : element_size_(element_size) {
+    SetInputAt(kSrcPos, src);
+    SetInputAt(kDestPos, dest);
+    SetInputAt(kSrcStartPos, src_start);
+    SetInputAt(kDestStartPos, dest_start);
+    SetInputAt(kLengthPos, length);
+  }
+
+  enum {
+    kSrcPos = 0,
+    kDestPos = 1,
+    kSrcStartPos = 2,
+    kDestStartPos = 3,
+    kLengthPos = 4
+  };
+
+  DECLARE_INSTRUCTION(MemoryCopy)
+
+  virtual Representation RequiredInputRepresentation(intptr_t index) const {
+    ASSERT((0 <= index) && (index < InputCount()));
+    return kTagged;
+  }
+
+  virtual bool ComputeCanDeoptimize() const { return false; }
+  // The copy writes memory that is not described to the alias analysis.
+  virtual bool HasUnknownSideEffects() const { return true; }
+
+  virtual bool AttributesEqual(Instruction* other) const {
+    return other->AsMemoryCopy()->element_size() == element_size();
+  }
+
+  Value* src() const { return inputs_[kSrcPos]; }
+  Value* dest() const { return inputs_[kDestPos]; }
+  Value* src_start() const { return inputs_[kSrcStartPos]; }
+  Value* dest_start() const { return inputs_[kDestStartPos]; }
+  Value* length() const { return inputs_[kLengthPos]; }
+  intptr_t element_size() const { return element_size_; }
+
+  PRINT_OPERANDS_TO_SUPPORT
+
+ private:
+  const intptr_t element_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryCopyInstr);
+};
+
 class LoadClassIdInstr : public TemplateDefinition<1, NoThrow, Pure> {
  public:
   explicit LoadClassIdInstr(Value* object) { SetInputAt(0, object); }
@@ -7015,6 +7149,7 @@ class CheckStackOverflowInstr : public TemplateInstruction<0, NoThrow> {
   bool in_loop() const { return loop_depth_ > 0; }
   intptr_t stack_depth() const { return stack_depth_; }
   intptr_t loop_depth() const { return loop_depth_; }
+  Kind kind() const { return kind_; }
 
   DECLARE_INSTRUCTION(CheckStackOverflow)
 
@@ -7663,6 +7798,7 @@ class CheckArrayBoundInstr : public CheckBoundBase {
 
   bool IsRedundant(const RangeBoundary& length);
 
+  bool generalized() const { return generalized_; }
   void mark_generalized() { generalized_ = true; }
 
   virtual Definition* Canonicalize(FlowGraph* flow_graph);
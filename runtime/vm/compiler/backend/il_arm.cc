@@ -1000,6 +1000,25 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   // frame.
   __ mov(saved_fp, Operand(FPREG));
 
+  if (is_leaf_) {
+    // The callee cannot observe the stack or reach a safepoint, so a plain
+    // frame for the outgoing arguments suffices.
+    __ EnterFrame((1 << FP) | (1 << LR), 0);
+    __ ReserveAlignedFrameSpace(compiler::ffi::NumStackSlots(arg_locations_) *
+                                kWordSize);
+    FrameRebase rebase(/*old_base=*/FPREG, /*new_base=*/saved_fp,
+                       /*stack_delta=*/0);
+    for (intptr_t i = 0, n = NativeArgCount(); i < n; ++i) {
+      const Location origin = rebase.Rebase(locs()->in(i));
+      const Location target = arg_locations_[i];
+      NoTemporaryAllocator no_temp;
+      compiler->EmitMove(target, origin, &no_temp);
+    }
+    __ blx(branch);
+    __ LeaveFrame((1 << FP) | (1 << LR));
+    return;
+  }
+
   // Make a space to put the return address.
   __ PushImmediate(0);
 
@@ -1315,6 +1334,107 @@ DEFINE_BACKEND(StoreUntagged, (NoLocation, Register obj, Register value)) {
   __ StoreToOffset(kWord, value, obj, instr->offset_from_tagged());
 }
 
+LocationSummary* MemoryCopyInstr::MakeLocationSummary(Zone* zone,
+                                                      bool opt) const {
+  const intptr_t kNumInputs = 5;
+  const intptr_t kNumTemps = 2;
+  LocationSummary* locs = new (zone)
+      LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
+  locs->set_in(kSrcPos, Location::RequiresRegister());
+  locs->set_in(kDestPos, Location::RequiresRegister());
+  locs->set_in(kSrcStartPos, Location::RequiresRegister());
+  locs->set_in(kDestStartPos, Location::RequiresRegister());
+  locs->set_in(kLengthPos, Location::WritableRegister());
+  locs->set_temp(0, Location::RequiresRegister());
+  locs->set_temp(1, Location::RequiresRegister());
+  return locs;
+}
+
+// Moves one unit of [unit] bytes from [src_ptr] to [dest_ptr] through TMP,
+// writing back the addresses of [mode].
+static void EmitMoveUnit(FlowGraphCompiler* compiler,
+                         intptr_t unit,
+                         Register src_ptr,
+                         Register dest_ptr,
+                         int32_t offset,
+                         Address::Mode mode) {
+  switch (unit) {
+    case 1:
+      __ ldrb(TMP, Address(src_ptr, offset, mode));
+      __ strb(TMP, Address(dest_ptr, offset, mode));
+      break;
+    case 2:
+      __ ldrh(TMP, Address(src_ptr, offset, mode));
+      __ strh(TMP, Address(dest_ptr, offset, mode));
+      break;
+    case 4:
+      __ ldr(TMP, Address(src_ptr, offset, mode));
+      __ str(TMP, Address(dest_ptr, offset, mode));
+      break;
+    default:
+      UNREACHABLE();
+  }
+}
+
+void MemoryCopyInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  const Register src_reg = locs()->in(kSrcPos).reg();
+  const Register dest_reg = locs()->in(kDestPos).reg();
+  const Register src_start_reg = locs()->in(kSrcStartPos).reg();
+  const Register dest_start_reg = locs()->in(kDestStartPos).reg();
+  const Register length_reg = locs()->in(kLengthPos).reg();
+  const Register src_ptr = locs()->temp(0).reg();
+  const Register dest_ptr = locs()->temp(1).reg();
+
+  // Elements are moved in units of at most a word.
+  const intptr_t unit = Utils::Minimum<intptr_t>(element_size_, 4);
+  const intptr_t unit_shift = Utils::ShiftForPowerOfTwo(unit);
+
+  // The starts are Smis: scale them by half the element size, or untag them
+  // for single bytes.
+  const intptr_t data_offset =
+      compiler::target::TypedDataBase::data_field_offset();
+  __ LoadFieldFromOffset(kWord, src_ptr, src_reg, data_offset);
+  __ LoadFieldFromOffset(kWord, dest_ptr, dest_reg, data_offset);
+  if (element_size_ == 1) {
+    __ add(src_ptr, src_ptr, Operand(src_start_reg, ASR, kSmiTagSize));
+    __ add(dest_ptr, dest_ptr, Operand(dest_start_reg, ASR, kSmiTagSize));
+  } else {
+    const intptr_t shift = Utils::ShiftForPowerOfTwo(element_size_) - 1;
+    __ add(src_ptr, src_ptr, Operand(src_start_reg, LSL, shift));
+    __ add(dest_ptr, dest_ptr, Operand(dest_start_reg, LSL, shift));
+  }
+  // Turn the length into a number of units.
+  if (element_size_ <= 4) {
+    __ SmiUntag(length_reg);
+  } else if (element_size_ == 16) {
+    __ Lsl(length_reg, length_reg, Operand(1));
+  }
+
+  // Copy forward unless the destination starts inside the source.
+  Label forward, backward, loop, done;
+  __ cmp(dest_ptr, Operand(src_ptr));
+  __ b(&forward, LS);
+  __ add(TMP, src_ptr, Operand(length_reg, LSL, unit_shift));
+  __ cmp(dest_ptr, Operand(TMP));
+  __ b(&forward, CS);
+  // The ranges overlap, so the length is not zero.
+  __ mov(src_ptr, Operand(TMP));
+  __ add(dest_ptr, dest_ptr, Operand(length_reg, LSL, unit_shift));
+  __ Bind(&backward);
+  EmitMoveUnit(compiler, unit, src_ptr, dest_ptr, -unit, Address::PreIndex);
+  __ subs(length_reg, length_reg, Operand(1));
+  __ b(&backward, NE);
+  __ b(&done);
+  __ Bind(&forward);
+  __ cmp(length_reg, Operand(0));
+  __ b(&done, EQ);
+  __ Bind(&loop);
+  EmitMoveUnit(compiler, unit, src_ptr, dest_ptr, unit, Address::PostIndex);
+  __ subs(length_reg, length_reg, Operand(1));
+  __ b(&loop, NE);
+  __ Bind(&done);
+}
+
 LocationSummary* LoadClassIdInstr::MakeLocationSummary(Zone* zone,
                                                        bool opt) const {
   const intptr_t kNumInputs = 1;
@@ -3028,6 +3148,43 @@ void InstantiateTypeArgumentsInstr::EmitNativeCode(
   // The instantiations cache is initialized with Object::zero_array() and is
   // therefore guaranteed to contain kNoInstantiator. No length check needed.
   Label loop, next, found, slow_case;
+  // A hashed cache also starts with kNoInstantiator, but is longer than
+  // Object::zero_array(). Its probe starts at the entry for the hashes of the
+  // instantiators.
+  {
+    __ ldr(R2, Address(R3, 0 * compiler::target::kWordSize));
+    __ CompareImmediate(R2,
+                        compiler::target::ToRawSmi(StubCode::kNoInstantiator));
+    __ b(&loop, NE);
+    __ ldr(R2, Address(R3, compiler::target::Array::length_offset() -
+                               compiler::target::Array::data_offset()));
+    __ CompareImmediate(R2, compiler::target::ToRawSmi(1));
+    __ b(&loop, EQ);
+    __ LoadImmediate(R2, 0);
+    __ CompareObject(instantiator_type_args_reg, Object::null_object());
+    __ ldr(R2,
+           FieldAddress(instantiator_type_args_reg,
+                        compiler::target::TypeArguments::hash_offset()),
+           NE);
+    __ CompareObject(function_type_args_reg, Object::null_object());
+    __ ldr(IP,
+           FieldAddress(function_type_args_reg,
+                        compiler::target::TypeArguments::hash_offset()),
+           NE);
+    __ eor(R2, R2, Operand(IP), NE);
+    // The hashes and the mask are Smis, so they are combined tagged.
+    __ ldr(IP, Address(R3, TypeArguments::kHashedInstantiationsMaskIndex *
+                               compiler::target::kWordSize));
+    __ and_(R2, R2, Operand(IP));
+    __ SmiUntag(R2);
+    __ LoadImmediate(IP, StubCode::kInstantiationSizeInWords *
+                             compiler::target::kWordSize);
+    __ mul(R2, R2, IP);
+    __ add(R3, R3, Operand(R2));
+    // Skip the header.
+    __ AddImmediate(R3, StubCode::kInstantiationSizeInWords *
+                            compiler::target::kWordSize);
+  }
   __ Bind(&loop);
   __ ldr(
       R2,
@@ -872,6 +872,111 @@ void NativeCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   __ Drop(ArgumentCount());  // Drop the arguments.
 }
 
+// Stores the part of a struct result returned in [part.location] to the
+// memory of the struct at [base]. Clobbers the register of the part.
+static void StoreStructResultPart(FlowGraphCompiler* compiler,
+                                  Register base,
+                                  const compiler::ffi::StructPart& part) {
+  if (part.location.IsFpuRegister()) {
+    if (part.size == 4) {
+      __ fstrs(part.location.fpu_reg(), Address(base, part.offset));
+    } else {
+      __ fstrd(part.location.fpu_reg(), Address(base, part.offset));
+    }
+    return;
+  }
+  const Register src = part.location.reg();
+  intptr_t offset = part.offset;
+  intptr_t remaining = part.size;
+  while (remaining > 0) {
+    intptr_t size;
+    if (remaining >= 8) {
+      size = 8;
+      __ StoreToOffset(src, base, offset, kDoubleWord);
+    } else if (remaining >= 4) {
+      size = 4;
+      __ StoreToOffset(src, base, offset, kUnsignedWord);
+    } else if (remaining >= 2) {
+      size = 2;
+      __ StoreToOffset(src, base, offset, kUnsignedHalfword);
+    } else {
+      size = 1;
+      __ StoreToOffset(src, base, offset, kUnsignedByte);
+    }
+    offset += size;
+    remaining -= size;
+    if (remaining > 0) {
+      __ LsrImmediate(src, src, size * kBitsPerByte);
+    }
+  }
+}
+
+// Keeps the address of the memory for a struct result in the outgoing argument
+// area across the call.
+static void SaveStructResultAddress(FlowGraphCompiler* compiler,
+                                    FfiCallInstr* instr,
+                                    FrameRebase* rebase,
+                                    Register temp) {
+  if (!instr->HasStructResult()) return;
+  ConstantTemporaryAllocator temp_alloc(temp);
+  compiler->EmitMove(
+      Location::StackSlot(instr->ResultAddressStackSlot(), SPREG),
+      rebase->Rebase(instr->locs()->in(instr->ResultAddressIndex())),
+      &temp_alloc);
+}
+
+// Passes the addresses of the copies of struct arguments which are passed by
+// reference. The parts of the copies have already been moved to the outgoing
+// argument area.
+static void PassStructCopies(FlowGraphCompiler* compiler,
+                             FfiCallInstr* instr) {
+  if (instr->structs() == nullptr) return;
+  const auto& copies = instr->structs()->copies();
+  for (intptr_t i = 0; i < copies.length(); i++) {
+    const compiler::ffi::StructCopy& copy = copies[i];
+    if (copy.location.IsRegister()) {
+      __ AddImmediate(copy.location.reg(), SPREG,
+                      copy.stack_index * kWordSize);
+    } else {
+      ASSERT(copy.location.IsStackSlot());
+      __ AddImmediate(TMP, SPREG, copy.stack_index * kWordSize);
+      __ StoreToOffset(TMP, copy.location.base_reg(),
+                       copy.location.ToStackSlotOffset());
+    }
+  }
+}
+
+// Calls [branch], passing the address of the memory for a struct result
+// which the callee writes the result to. The address is passed in R8, which
+// may be [branch].
+static void CallPassingStructResultAddress(FlowGraphCompiler* compiler,
+                                           FfiCallInstr* instr,
+                                           Register branch) {
+  if (!instr->HasStructResult() ||
+      !instr->structs()->result_address_location().IsRegister()) {
+    __ blr(branch);
+    return;
+  }
+  const Register address = instr->structs()->result_address_location().reg();
+  __ mov(TMP, branch);
+  __ LoadFromOffset(address, SPREG,
+                    instr->ResultAddressStackSlot() * kWordSize);
+  __ blr(TMP);
+}
+
+// Stores a struct result returned in registers to its memory and makes the
+// address of the memory the result of the call.
+static void StoreStructResult(FlowGraphCompiler* compiler,
+                              FfiCallInstr* instr) {
+  if (!instr->HasStructResult()) return;
+  __ LoadFromOffset(TMP, SPREG, instr->ResultAddressStackSlot() * kWordSize);
+  const auto& parts = instr->structs()->result_parts();
+  for (intptr_t i = 0; i < parts.length(); i++) {
+    StoreStructResultPart(compiler, TMP, parts[i]);
+  }
+  __ mov(CallingConventions::kReturnReg, TMP);
+}
+
 void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   Register saved_fp = locs()->temp(0).reg();
   Register temp = locs()->temp(1).reg();
@@ -881,6 +986,29 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   // frame.
   __ mov(saved_fp, FPREG);
 
+  if (is_leaf_) {
+    // The callee cannot observe the stack or reach a safepoint, so a plain
+    // frame for the outgoing arguments suffices.
+    __ EnterFrame(0);
+    __ ReserveAlignedFrameSpace(NumOutgoingStackSlots() * kWordSize);
+    FrameRebase rebase(/*old_base=*/FPREG, /*new_base=*/saved_fp,
+                       /*stack_delta=*/0);
+    SaveStructResultAddress(compiler, this, &rebase, temp);
+    for (intptr_t i = 0, n = NativeArgCount(); i < n; ++i) {
+      const Location origin = rebase.Rebase(locs()->in(i));
+      const Location target = arg_locations_[i];
+      ConstantTemporaryAllocator temp_alloc(temp);
+      compiler->EmitMove(target, origin, &temp_alloc);
+    }
+    PassStructCopies(compiler, this);
+    __ mov(CSP, SP);
+    CallPassingStructResultAddress(compiler, this, branch);
+    __ mov(SP, CSP);
+    StoreStructResult(compiler, this);
+    __ LeaveFrame();
+    return;
+  }
+
   // We need to create a dummy "exit frame". It will share the same pool pointer
   // but have a null code object.
   __ LoadObject(CODE_REG, Object::null_object());
@@ -888,17 +1016,18 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   __ EnterDartFrame(0, PP);
 
   // Make space for arguments and align the frame.
-  __ ReserveAlignedFrameSpace(compiler::ffi::NumStackSlots(arg_locations_) *
-                              kWordSize);
+  __ ReserveAlignedFrameSpace(NumOutgoingStackSlots() * kWordSize);
 
   FrameRebase rebase(/*old_base=*/FPREG, /*new_base=*/saved_fp,
                      /*stack_delta=*/0);
+  SaveStructResultAddress(compiler, this, &rebase, temp);
   for (intptr_t i = 0, n = NativeArgCount(); i < n; ++i) {
     const Location origin = rebase.Rebase(locs()->in(i));
     const Location target = arg_locations_[i];
     ConstantTemporaryAllocator temp_alloc(temp);
     compiler->EmitMove(target, origin, &temp_alloc);
   }
+  PassStructCopies(compiler, this);
 
   // We need to copy a dummy return address up into the dummy stack frame so the
   // stack walker will know which safepoint to use.
@@ -918,11 +1047,13 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   // the stack limit to the top of the stack.
   __ mov(CSP, SP);
 
-  __ blr(branch);
+  CallPassingStructResultAddress(compiler, this, branch);
 
   // Restore the Dart stack pointer.
   __ mov(SP, CSP);
 
+  StoreStructResult(compiler, this);
+
   // Update information in the thread object and leave the safepoint.
   __ TransitionNativeToGenerated(temp);
 
@@ -1202,6 +1333,106 @@ DEFINE_BACKEND(StoreUntagged, (NoLocation, Register obj, Register value)) {
   __ StoreToOffset(value, obj, instr->offset_from_tagged());
 }
 
+LocationSummary* MemoryCopyInstr::MakeLocationSummary(Zone* zone,
+                                                      bool opt) const {
+  const intptr_t kNumInputs = 5;
+  const intptr_t kNumTemps = 2;
+  LocationSummary* locs = new (zone)
+      LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
+  locs->set_in(kSrcPos, Location::RequiresRegister());
+  locs->set_in(kDestPos, Location::RequiresRegister());
+  locs->set_in(kSrcStartPos, Location::RequiresRegister());
+  locs->set_in(kDestStartPos, Location::RequiresRegister());
+  locs->set_in(kLengthPos, Location::WritableRegister());
+  locs->set_temp(0, Location::RequiresRegister());
+  locs->set_temp(1, Location::RequiresRegister());
+  return locs;
+}
+
+void MemoryCopyInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  const Register src_reg = locs()->in(kSrcPos).reg();
+  const Register dest_reg = locs()->in(kDestPos).reg();
+  const Register src_start_reg = locs()->in(kSrcStartPos).reg();
+  const Register dest_start_reg = locs()->in(kDestStartPos).reg();
+  const Register length_reg = locs()->in(kLengthPos).reg();
+  const Register src_ptr = locs()->temp(0).reg();
+  const Register dest_ptr = locs()->temp(1).reg();
+
+  // Elements are moved in units of at most a double word.
+  OperandSize unit_size;
+  switch (element_size_) {
+    case 1:
+      unit_size = kUnsignedByte;
+      break;
+    case 2:
+      unit_size = kUnsignedHalfword;
+      break;
+    case 4:
+      unit_size = kUnsignedWord;
+      break;
+    case 8:
+    case 16:
+      unit_size = kDoubleWord;
+      break;
+    default:
+      UNREACHABLE();
+      unit_size = kUnsignedByte;
+      break;
+  }
+  const intptr_t unit = Utils::Minimum<intptr_t>(element_size_, 8);
+  const intptr_t unit_shift = Utils::ShiftForPowerOfTwo(unit);
+
+  // The starts are Smis: scale them by half the element size, or untag them
+  // for single bytes.
+  const intptr_t data_offset =
+      compiler::target::TypedDataBase::data_field_offset();
+  __ LoadFieldFromOffset(src_ptr, src_reg, data_offset);
+  __ LoadFieldFromOffset(dest_ptr, dest_reg, data_offset);
+  if (element_size_ == 1) {
+    __ add(src_ptr, src_ptr, Operand(src_start_reg, ASR, kSmiTagSize));
+    __ add(dest_ptr, dest_ptr, Operand(dest_start_reg, ASR, kSmiTagSize));
+  } else {
+    const intptr_t shift = Utils::ShiftForPowerOfTwo(element_size_) - 1;
+    __ add(src_ptr, src_ptr, Operand(src_start_reg, LSL, shift));
+    __ add(dest_ptr, dest_ptr, Operand(dest_start_reg, LSL, shift));
+  }
+  // Turn the length into a number of units. The Smi length of 16 byte
+  // elements already counts double words.
+  if (element_size_ != 16) {
+    __ SmiUntag(length_reg);
+  }
+
+  // Copy forward unless the destination starts inside the source.
+  Label forward, loop, done;
+  __ cmp(dest_ptr, Operand(src_ptr));
+  __ b(&forward, LS);
+  __ add(TMP2, src_ptr, Operand(length_reg, LSL, unit_shift));
+  __ cmp(dest_ptr, Operand(TMP2));
+  __ b(&forward, CS);
+  // The ranges overlap, so the length is not zero.
+  Label backward;
+  __ mov(src_ptr, TMP2);
+  __ add(dest_ptr, dest_ptr, Operand(length_reg, LSL, unit_shift));
+  __ Bind(&backward);
+  __ ldr(TMP, Address(src_ptr, -unit, Address::PreIndex, unit_size),
+         unit_size);
+  __ str(TMP, Address(dest_ptr, -unit, Address::PreIndex, unit_size),
+         unit_size);
+  __ subs(length_reg, length_reg, Operand(1));
+  __ b(&backward, NE);
+  __ b(&done);
+  __ Bind(&forward);
+  __ cbz(&done, length_reg);
+  __ Bind(&loop);
+  __ ldr(TMP, Address(src_ptr, unit, Address::PostIndex, unit_size),
+         unit_size);
+  __ str(TMP, Address(dest_ptr, unit, Address::PostIndex, unit_size),
+         unit_size);
+  __ subs(length_reg, length_reg, Operand(1));
+  __ b(&loop, NE);
+  __ Bind(&done);
+}
+
 LocationSummary* LoadClassIdInstr::MakeLocationSummary(Zone* zone,
                                                        bool opt) const {
   const intptr_t kNumInputs = 1;
@@ -2113,6 +2344,16 @@ static void EnsureMutableBox(FlowGraphCompiler* compiler,
 LocationSummary* StoreInstanceFieldInstr::MakeLocationSummary(Zone* zone,
                                                               bool opt) const {
   const intptr_t kNumInputs = 2;
+  if (slot().is_unboxed()) {
+    ASSERT(opt);
+    LocationSummary* summary = new (zone)
+        LocationSummary(zone, kNumInputs, 0, LocationSummary::kNoCall);
+    summary->set_in(0, Location::RequiresRegister());
+    summary->set_in(1, (slot().UnboxedRepresentation() == kUnboxedDouble)
+                           ? Location::RequiresFpuRegister()
+                           : Location::RequiresRegister());
+    return summary;
+  }
   const intptr_t kNumTemps =
       (IsUnboxedStore() && opt) ? 2 : ((IsPotentialUnboxedStore()) ? 2 : 0);
   LocationSummary* summary = new (zone)
@@ -2147,6 +2388,17 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   const Register instance_reg = locs()->in(0).reg();
   const intptr_t offset_in_bytes = OffsetInBytes();
 
+  if (slot().is_unboxed()) {
+    if (slot().UnboxedRepresentation() == kUnboxedDouble) {
+      __ StoreDFieldToOffset(locs()->in(1).fpu_reg(), instance_reg,
+                             offset_in_bytes);
+    } else {
+      __ StoreFieldToOffset(locs()->in(1).reg(), instance_reg,
+                            offset_in_bytes);
+    }
+    return;
+  }
+
   if (IsUnboxedStore() && compiler->is_optimizing()) {
     const VRegister value = locs()->in(1).fpu_reg();
     const Register temp = locs()->temp(0).reg();
@@ -2480,6 +2732,16 @@ void CreateArrayInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
 LocationSummary* LoadFieldInstr::MakeLocationSummary(Zone* zone,
                                                      bool opt) const {
   const intptr_t kNumInputs = 1;
+  if (slot().is_unboxed()) {
+    ASSERT(opt);
+    LocationSummary* locs = new (zone)
+        LocationSummary(zone, kNumInputs, 0, LocationSummary::kNoCall);
+    locs->set_in(0, Location::RequiresRegister());
+    locs->set_out(0, (slot().UnboxedRepresentation() == kUnboxedDouble)
+                         ? Location::RequiresFpuRegister()
+                         : Location::RequiresRegister());
+    return locs;
+  }
   const intptr_t kNumTemps =
       (IsUnboxedLoad() && opt) ? 1 : ((IsPotentialUnboxedLoad()) ? 1 : 0);
   LocationSummary* locs = new (zone) LocationSummary(
@@ -2501,6 +2763,16 @@ LocationSummary* LoadFieldInstr::MakeLocationSummary(Zone* zone,
 void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   ASSERT(sizeof(classid_t) == kInt16Size);
   const Register instance_reg = locs()->in(0).reg();
+  if (slot().is_unboxed()) {
+    if (slot().UnboxedRepresentation() == kUnboxedDouble) {
+      __ LoadDFieldFromOffset(locs()->out(0).fpu_reg(), instance_reg,
+                              OffsetInBytes());
+    } else {
+      __ LoadFieldFromOffset(locs()->out(0).reg(), instance_reg,
+                             OffsetInBytes());
+    }
+    return;
+  }
   if (IsUnboxedLoad() && compiler->is_optimizing()) {
     const VRegister result = locs()->out(0).fpu_reg();
     const Register temp = locs()->temp(0).reg();
@@ -2679,6 +2951,40 @@ void InstantiateTypeArgumentsInstr::EmitNativeCode(
   // The instantiations cache is initialized with Object::zero_array() and is
   // therefore guaranteed to contain kNoInstantiator. No length check needed.
   Label loop, next, found, slow_case;
+  // A hashed cache also starts with kNoInstantiator, but is longer than
+  // Object::zero_array(). Its probe starts at the entry for the hashes of the
+  // instantiators.
+  {
+    Label instantiator_hashed, hashed;
+    __ LoadFromOffset(R2, R3, 0 * kWordSize);
+    __ CompareImmediate(R2, Smi::RawValue(StubCode::kNoInstantiator));
+    __ b(&loop, NE);
+    __ LoadFromOffset(R2, R3, Array::length_offset() - Array::data_offset());
+    __ CompareImmediate(R2, Smi::RawValue(1));
+    __ b(&loop, EQ);
+    __ mov(R2, ZR);
+    __ CompareObject(instantiator_type_args_reg, Object::null_object());
+    __ b(&instantiator_hashed, EQ);
+    __ LoadFieldFromOffset(R2, instantiator_type_args_reg,
+                           TypeArguments::hash_offset());
+    __ Bind(&instantiator_hashed);
+    __ CompareObject(function_type_args_reg, Object::null_object());
+    __ b(&hashed, EQ);
+    __ LoadFieldFromOffset(TMP, function_type_args_reg,
+                           TypeArguments::hash_offset());
+    __ eor(R2, R2, Operand(TMP));
+    __ Bind(&hashed);
+    // The hashes and the mask are Smis, so they are combined tagged.
+    __ LoadFromOffset(
+        TMP, R3, TypeArguments::kHashedInstantiationsMaskIndex * kWordSize);
+    __ and_(R2, R2, Operand(TMP));
+    __ SmiUntag(R2);
+    __ LoadImmediate(TMP, StubCode::kInstantiationSizeInWords * kWordSize);
+    __ mul(R2, R2, TMP);
+    __ add(R3, R3, Operand(R2));
+    // Skip the header.
+    __ AddImmediate(R3, StubCode::kInstantiationSizeInWords * kWordSize);
+  }
   __ Bind(&loop);
   __ LoadFromOffset(R2, R3, 0 * kWordSize);  // Cached instantiator type args.
   __ CompareRegisters(R2, instantiator_type_args_reg);
@@ -41,6 +41,7 @@ DECLARE_FLAG(int, optimization_counter_threshold);
   M(IfThenElse)                                                                \
   M(Int32ToDouble)                                                             \
   M(LoadCodeUnits)                                                             \
+  M(MemoryCopy)                                                                \
   M(ShiftUint32Op)                                                             \
   M(SpeculativeShiftUint32Op)                                                  \
   M(TruncDivMod)                                                               \
@@ -905,6 +905,21 @@ void NativeCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   __ Drop(ArgumentCount());  // Drop the arguments.
 }
 
+// The x86 calling convention requires floating point values to be returned on
+// the "floating-point stack" (aka. register ST0). We don't use the
+// floating-point stack in Dart, so we need to move the return value back into
+// an XMM register.
+static void MoveFloatingPointResult(FlowGraphCompiler* compiler,
+                                    Representation rep) {
+  if (rep == kUnboxedDouble) {
+    __ fstpl(Address(SPREG, -kDoubleSize));
+    __ movsd(XMM0, Address(SPREG, -kDoubleSize));
+  } else if (rep == kUnboxedFloat) {
+    __ fstps(Address(SPREG, -kFloatSize));
+    __ movss(XMM0, Address(SPREG, -kFloatSize));
+  }
+}
+
 void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   const Register saved_fp = locs()->temp(0).reg();  // volatile
   const Register branch = locs()->in(TargetAddressIndex()).reg();
@@ -914,6 +929,26 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   // frame.
   __ movl(saved_fp, FPREG);
 
+  if (is_leaf_) {
+    // The callee cannot observe the stack or reach a safepoint, so a plain
+    // frame for the outgoing arguments suffices.
+    __ EnterFrame(0);
+    __ ReserveAlignedFrameSpace(compiler::ffi::NumStackSlots(arg_locations_) *
+                                kWordSize);
+    FrameRebase rebase(/*old_base=*/FPREG, /*new_base=*/saved_fp,
+                       /*stack_delta=*/0);
+    for (intptr_t i = 0, n = NativeArgCount(); i < n; ++i) {
+      const Location origin = rebase.Rebase(locs()->in(i));
+      const Location target = arg_locations_[i];
+      ConstantTemporaryAllocator tmp_alloc(tmp);
+      compiler->EmitMove(target, origin, &tmp_alloc);
+    }
+    __ call(branch);
+    MoveFloatingPointResult(compiler, representation());
+    __ LeaveFrame();
+    return;
+  }
+
   // Make a space to put the return address.
   __ pushl(Immediate(0));
 
@@ -948,18 +983,7 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
 
   __ TransitionGeneratedToNative(branch, FPREG, tmp);
   __ call(branch);
-
-  // The x86 calling convention requires floating point values to be returned on
-  // the "floating-point stack" (aka. register ST0). We don't use the
-  // floating-point stack in Dart, so we need to move the return value back into
-  // an XMM register.
-  if (representation() == kUnboxedDouble) {
-    __ fstpl(Address(SPREG, -kDoubleSize));
-    __ movsd(XMM0, Address(SPREG, -kDoubleSize));
-  } else if (representation() == kUnboxedFloat) {
-    __ fstps(Address(SPREG, -kFloatSize));
-    __ movss(XMM0, Address(SPREG, -kFloatSize));
-  }
+  MoveFloatingPointResult(compiler, representation());
 
   __ TransitionNativeToGenerated(tmp);
 
@@ -1675,6 +1699,8 @@ void StoreIndexedInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
 
 DEFINE_UNIMPLEMENTED_INSTRUCTION(GuardFieldTypeInstr)
 DEFINE_UNIMPLEMENTED_INSTRUCTION(CheckConditionInstr)
+// The inliner does not emit MemoryCopy on IA32, see ShouldInlineMemoryCopy.
+DEFINE_UNIMPLEMENTED_INSTRUCTION(MemoryCopyInstr)
 
 LocationSummary* GuardFieldClassInstr::MakeLocationSummary(Zone* zone,
                                                            bool opt) const {
@@ -2567,6 +2593,37 @@ void InstantiateTypeArgumentsInstr::EmitNativeCode(
   // The instantiations cache is initialized with Object::zero_array() and is
   // therefore guaranteed to contain kNoInstantiator. No length check needed.
   Label loop, next, found, slow_case;
+  // A hashed cache also starts with kNoInstantiator, but is longer than
+  // Object::zero_array(). Its probe starts at the entry for the hashes of the
+  // instantiators.
+  {
+    Label instantiator_hashed, hashed;
+    __ cmpl(Address(EDI, 0 * kWordSize),
+            Immediate(Smi::RawValue(StubCode::kNoInstantiator)));
+    __ j(NOT_EQUAL, &loop);
+    __ cmpl(Address(EDI, Array::length_offset() - Array::data_offset()),
+            Immediate(Smi::RawValue(1)));
+    __ j(EQUAL, &loop);
+    __ xorl(EDX, EDX);
+    __ CompareObject(instantiator_type_args_reg, Object::null_object());
+    __ j(EQUAL, &instantiator_hashed, Assembler::kNearJump);
+    __ movl(EDX, FieldAddress(instantiator_type_args_reg,
+                              TypeArguments::hash_offset()));
+    __ Bind(&instantiator_hashed);
+    __ CompareObject(function_type_args_reg, Object::null_object());
+    __ j(EQUAL, &hashed, Assembler::kNearJump);
+    __ xorl(EDX,
+            FieldAddress(function_type_args_reg, TypeArguments::hash_offset()));
+    __ Bind(&hashed);
+    // The hashes and the mask are Smis, so they are combined tagged.
+    __ andl(EDX, Address(EDI, TypeArguments::kHashedInstantiationsMaskIndex *
+                                  kWordSize));
+    __ SmiUntag(EDX);
+    __ imull(EDX, Immediate(StubCode::kInstantiationSizeInWords * kWordSize));
+    // Skip the header.
+    __ leal(EDI, Address(EDI, EDX, TIMES_1,
+                         StubCode::kInstantiationSizeInWords * kWordSize));
+  }
   __ Bind(&loop);
   __ movl(EDX, Address(EDI, 0 * kWordSize));  // Cached instantiator type args.
   __ cmpl(EDX, instantiator_type_args_reg);
@@ -524,11 +524,18 @@ void ClosureCallInstr::PrintOperandsTo(BufferFormatter* f) const {
 void FfiCallInstr::PrintOperandsTo(BufferFormatter* f) const {
   f->Print(" pointer=");
   InputAt(TargetAddressIndex())->PrintTo(f);
-  for (intptr_t i = 0, n = InputCount(); i < n - 1; ++i) {
+  for (intptr_t i = 0, n = NativeArgCount(); i < n; ++i) {
     f->Print(", ");
     InputAt(i)->PrintTo(f);
     f->Print(" (@%s)", arg_locations_[i].ToCString());
   }
+  if (HasStructResult()) {
+    f->Print(", result=");
+    InputAt(ResultAddressIndex())->PrintTo(f);
+  }
+  if (is_leaf_) {
+    f->Print(", leaf");
+  }
 }
 
 void InstanceCallInstr::PrintOperandsTo(BufferFormatter* f) const {
@@ -1103,6 +1110,11 @@ void StoreIndexedUnsafeInstr::PrintOperandsTo(BufferFormatter* f) const {
   value()->PrintTo(f);
 }
 
+void MemoryCopyInstr::PrintOperandsTo(BufferFormatter* f) const {
+  Instruction::PrintOperandsTo(f);
+  f->Print(", element_size=%" Pd, element_size());
+}
+
 void TailCallInstr::PrintOperandsTo(BufferFormatter* f) const {
   const char* name = "<unknown code>";
   if (code_.IsStubCode()) {
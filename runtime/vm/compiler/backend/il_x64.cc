@@ -916,6 +916,82 @@ void NativeCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   __ Drop(ArgumentCount());  // Drop the arguments.
 }
 
+// Stores the part of a struct result returned in [part.location] to the
+// memory of the struct at [base]. Clobbers the register of the part.
+static void StoreStructResultPart(FlowGraphCompiler* compiler,
+                                  Register base,
+                                  const compiler::ffi::StructPart& part) {
+  if (part.location.IsFpuRegister()) {
+    if (part.size == 4) {
+      __ movss(Address(base, part.offset), part.location.fpu_reg());
+    } else {
+      __ movsd(Address(base, part.offset), part.location.fpu_reg());
+    }
+    return;
+  }
+  const Register src = part.location.reg();
+  intptr_t offset = part.offset;
+  intptr_t remaining = part.size;
+  while (remaining > 0) {
+    intptr_t size;
+    if (remaining >= 8) {
+      size = 8;
+      __ movq(Address(base, offset), src);
+    } else if (remaining >= 4) {
+      size = 4;
+      __ movl(Address(base, offset), src);
+    } else if (remaining >= 2) {
+      size = 2;
+      __ movw(Address(base, offset), src);
+    } else {
+      size = 1;
+      __ movb(Address(base, offset), src);
+    }
+    offset += size;
+    remaining -= size;
+    if (remaining > 0) {
+      __ shrq(src, Immediate(size * kBitsPerByte));
+    }
+  }
+}
+
+// Keeps the address of the memory for a struct result in the outgoing argument
+// area across the call.
+static void SaveStructResultAddress(FlowGraphCompiler* compiler,
+                                    FfiCallInstr* instr,
+                                    FrameRebase* rebase) {
+  if (!instr->HasStructResult()) return;
+  NoTemporaryAllocator temp;
+  compiler->EmitMove(
+      Location::StackSlot(instr->ResultAddressStackSlot(), SPREG),
+      rebase->Rebase(instr->locs()->in(instr->ResultAddressIndex())), &temp);
+}
+
+// Passes the address of the memory for a struct result which the callee
+// writes the result to.
+static void PassStructResultAddress(FlowGraphCompiler* compiler,
+                                    FfiCallInstr* instr) {
+  if (!instr->HasStructResult()) return;
+  const Location location = instr->structs()->result_address_location();
+  if (location.IsRegister()) {
+    __ movq(location.reg(),
+            Address(SPREG, instr->ResultAddressStackSlot() * kWordSize));
+  }
+}
+
+// Stores a struct result returned in registers to its memory and makes the
+// address of the memory the result of the call.
+static void StoreStructResult(FlowGraphCompiler* compiler,
+                              FfiCallInstr* instr) {
+  if (!instr->HasStructResult()) return;
+  __ movq(TMP, Address(SPREG, instr->ResultAddressStackSlot() * kWordSize));
+  const auto& parts = instr->structs()->result_parts();
+  for (intptr_t i = 0; i < parts.length(); i++) {
+    StoreStructResultPart(compiler, TMP, parts[i]);
+  }
+  __ movq(CallingConventions::kReturnReg, TMP);
+}
+
 void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   Register saved_fp = locs()->temp(0).reg();
   Register target_address = locs()->in(TargetAddressIndex()).reg();
@@ -924,6 +1000,27 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   // frame.
   __ movq(saved_fp, FPREG);
 
+  if (is_leaf_) {
+    // The callee cannot observe the stack or reach a safepoint, so a plain
+    // frame for the outgoing arguments suffices.
+    __ EnterFrame(0);
+    __ ReserveAlignedFrameSpace(NumOutgoingStackSlots() * kWordSize);
+    FrameRebase rebase(/*old_base=*/FPREG, /*new_base=*/saved_fp,
+                       /*stack_delta=*/0);
+    SaveStructResultAddress(compiler, this, &rebase);
+    for (intptr_t i = 0, n = NativeArgCount(); i < n; ++i) {
+      const Location origin = rebase.Rebase(locs()->in(i));
+      const Location target = arg_locations_[i];
+      NoTemporaryAllocator temp;
+      compiler->EmitMove(target, origin, &temp);
+    }
+    PassStructResultAddress(compiler, this);
+    __ CallCFunction(target_address);
+    StoreStructResult(compiler, this);
+    __ LeaveFrame();
+    return;
+  }
+
   // Make a space to put the return address.
   __ pushq(Immediate(0));
 
@@ -931,8 +1028,7 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   // but have a null code object.
   __ LoadObject(CODE_REG, Object::null_object());
   __ set_constant_pool_allowed(false);
-  __ EnterDartFrame(compiler::ffi::NumStackSlots(arg_locations_) * kWordSize,
-                    PP);
+  __ EnterDartFrame(NumOutgoingStackSlots() * kWordSize, PP);
 
   // Align frame before entering C++ world.
   if (OS::ActivationFrameAlignment() > 1) {
@@ -941,6 +1037,7 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
 
   FrameRebase rebase(/*old_base=*/FPREG, /*new_base=*/saved_fp,
                      /*stack_delta=*/0);
+  SaveStructResultAddress(compiler, this, &rebase);
   for (intptr_t i = 0, n = NativeArgCount(); i < n; ++i) {
     const Location origin = rebase.Rebase(locs()->in(i));
     const Location target = arg_locations_[i];
@@ -960,7 +1057,9 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   // Update information in the thread object and enter a safepoint.
   __ TransitionGeneratedToNative(target_address, FPREG);
 
+  PassStructResultAddress(compiler, this);
   __ CallCFunction(target_address);
+  StoreStructResult(compiler, this);
 
   // Update information in the thread object and leave the safepoint.
   __ TransitionNativeToGenerated();
@@ -1211,6 +1310,94 @@ DEFINE_BACKEND(StoreUntagged, (NoLocation, Register obj, Register value)) {
   __ movq(Address(obj, instr->offset_from_tagged()), value);
 }
 
+LocationSummary* MemoryCopyInstr::MakeLocationSummary(Zone* zone,
+                                                      bool opt) const {
+  const intptr_t kNumInputs = 5;
+  const intptr_t kNumTemps = 3;
+  LocationSummary* locs = new (zone)
+      LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
+  locs->set_in(kSrcPos, Location::RequiresRegister());
+  locs->set_in(kDestPos, Location::RequiresRegister());
+  locs->set_in(kSrcStartPos, Location::WritableRegister());
+  locs->set_in(kDestStartPos, Location::WritableRegister());
+  locs->set_in(kLengthPos, Location::RequiresRegister());
+  // Fixed for rep movsb.
+  locs->set_temp(0, Location::RegisterLocation(RSI));
+  locs->set_temp(1, Location::RegisterLocation(RDI));
+  locs->set_temp(2, Location::RegisterLocation(RCX));
+  return locs;
+}
+
+void MemoryCopyInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  const Register src_reg = locs()->in(kSrcPos).reg();
+  const Register dest_reg = locs()->in(kDestPos).reg();
+  const Register src_start_reg = locs()->in(kSrcStartPos).reg();
+  const Register dest_start_reg = locs()->in(kDestStartPos).reg();
+  const Register length_reg = locs()->in(kLengthPos).reg();
+  ASSERT(locs()->temp(0).reg() == RSI);
+  ASSERT(locs()->temp(1).reg() == RDI);
+  ASSERT(locs()->temp(2).reg() == RCX);
+
+  // The starts and the length are Smis: scale them by half the element size,
+  // or untag them for single bytes.
+  ScaleFactor scale;
+  switch (element_size_) {
+    case 1:
+      __ SmiUntag(src_start_reg);
+      __ SmiUntag(dest_start_reg);
+      scale = TIMES_1;
+      break;
+    case 2:
+      scale = TIMES_1;
+      break;
+    case 4:
+      scale = TIMES_2;
+      break;
+    case 8:
+      scale = TIMES_4;
+      break;
+    case 16:
+      scale = TIMES_8;
+      break;
+    default:
+      UNREACHABLE();
+      scale = TIMES_1;
+      break;
+  }
+  const intptr_t data_offset =
+      compiler::target::TypedDataBase::data_field_offset();
+  __ movq(RSI, FieldAddress(src_reg, data_offset));
+  __ leaq(RSI, Address(RSI, src_start_reg, scale, 0));
+  __ movq(RDI, FieldAddress(dest_reg, data_offset));
+  __ leaq(RDI, Address(RDI, dest_start_reg, scale, 0));
+  __ movq(RCX, length_reg);
+  if (element_size_ == 1) {
+    __ SmiUntag(RCX);
+  } else if (element_size_ > 2) {
+    __ shlq(RCX, Immediate(Utils::ShiftForPowerOfTwo(element_size_) - 1));
+  }
+
+  // Copy forward unless the destination starts inside the source.
+  Label forward, done;
+  __ cmpq(RDI, RSI);
+  __ j(BELOW_EQUAL, &forward, Assembler::kNearJump);
+  __ leaq(TMP, Address(RSI, RCX, TIMES_1, 0));
+  __ cmpq(RDI, TMP);
+  __ j(ABOVE_EQUAL, &forward, Assembler::kNearJump);
+  // The ranges overlap, so RCX is not zero. The moves leave the flags of the
+  // decrement alone.
+  Label backward;
+  __ Bind(&backward);
+  __ decq(RCX);
+  __ movzxb(TMP, Address(RSI, RCX, TIMES_1, 0));
+  __ movb(Address(RDI, RCX, TIMES_1, 0), TMP);
+  __ j(NOT_ZERO, &backward, Assembler::kNearJump);
+  __ jmp(&done, Assembler::kNearJump);
+  __ Bind(&forward);
+  __ rep_movsb();
+  __ Bind(&done);
+}
+
 LocationSummary* LoadClassIdInstr::MakeLocationSummary(Zone* zone,
                                                        bool opt) const {
   const intptr_t kNumInputs = 1;
@@ -2096,6 +2283,16 @@ void GuardFieldTypeInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
 LocationSummary* StoreInstanceFieldInstr::MakeLocationSummary(Zone* zone,
                                                               bool opt) const {
   const intptr_t kNumInputs = 2;
+  if (slot().is_unboxed()) {
+    ASSERT(opt);
+    LocationSummary* summary = new (zone)
+        LocationSummary(zone, kNumInputs, 0, LocationSummary::kNoCall);
+    summary->set_in(0, Location::RequiresRegister());
+    summary->set_in(1, (slot().UnboxedRepresentation() == kUnboxedDouble)
+                           ? Location::RequiresFpuRegister()
+                           : Location::RequiresRegister());
+    return summary;
+  }
   const intptr_t kNumTemps =
       (IsUnboxedStore() && opt) ? 2 : ((IsPotentialUnboxedStore()) ? 3 : 0);
   LocationSummary* summary = new (zone)
@@ -2151,6 +2348,17 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   const Register instance_reg = locs()->in(0).reg();
   const intptr_t offset_in_bytes = OffsetInBytes();
 
+  if (slot().is_unboxed()) {
+    if (slot().UnboxedRepresentation() == kUnboxedDouble) {
+      __ movsd(FieldAddress(instance_reg, offset_in_bytes),
+               locs()->in(1).fpu_reg());
+    } else {
+      __ movq(FieldAddress(instance_reg, offset_in_bytes),
+              locs()->in(1).reg());
+    }
+    return;
+  }
+
   if (IsUnboxedStore() && compiler->is_optimizing()) {
     XmmRegister value = locs()->in(1).fpu_reg();
     Register temp = locs()->temp(0).reg();
@@ -2476,6 +2684,16 @@ void CreateArrayInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
 LocationSummary* LoadFieldInstr::MakeLocationSummary(Zone* zone,
                                                      bool opt) const {
   const intptr_t kNumInputs = 1;
+  if (slot().is_unboxed()) {
+    ASSERT(opt);
+    LocationSummary* locs = new (zone)
+        LocationSummary(zone, kNumInputs, 0, LocationSummary::kNoCall);
+    locs->set_in(0, Location::RequiresRegister());
+    locs->set_out(0, (slot().UnboxedRepresentation() == kUnboxedDouble)
+                         ? Location::RequiresFpuRegister()
+                         : Location::RequiresRegister());
+    return locs;
+  }
   const intptr_t kNumTemps =
       (IsUnboxedLoad() && opt) ? 1 : ((IsPotentialUnboxedLoad()) ? 2 : 0);
   LocationSummary* locs = new (zone) LocationSummary(
@@ -2499,6 +2717,16 @@ LocationSummary* LoadFieldInstr::MakeLocationSummary(Zone* zone,
 void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   ASSERT(sizeof(classid_t) == kInt16Size);
   Register instance_reg = locs()->in(0).reg();
+  if (slot().is_unboxed()) {
+    if (slot().UnboxedRepresentation() == kUnboxedDouble) {
+      __ movsd(locs()->out(0).fpu_reg(),
+               FieldAddress(instance_reg, OffsetInBytes()));
+    } else {
+      __ movq(locs()->out(0).reg(),
+              FieldAddress(instance_reg, OffsetInBytes()));
+    }
+    return;
+  }
   if (IsUnboxedLoad() && compiler->is_optimizing()) {
     XmmRegister result = locs()->out(0).fpu_reg();
     Register temp = locs()->temp(0).reg();
@@ -2674,6 +2902,37 @@ void InstantiateTypeArgumentsInstr::EmitNativeCode(
   // The instantiations cache is initialized with Object::zero_array() and is
   // therefore guaranteed to contain kNoInstantiator. No length check needed.
   Label loop, next, found, slow_case;
+  // A hashed cache also starts with kNoInstantiator, but is longer than
+  // Object::zero_array(). Its probe starts at the entry for the hashes of the
+  // instantiators.
+  {
+    Label instantiator_hashed, hashed;
+    __ cmpq(Address(RDI, 0 * kWordSize),
+            Immediate(Smi::RawValue(StubCode::kNoInstantiator)));
+    __ j(NOT_EQUAL, &loop);
+    __ cmpq(Address(RDI, Array::length_offset() - Array::data_offset()),
+            Immediate(Smi::RawValue(1)));
+    __ j(EQUAL, &loop);
+    __ xorq(RDX, RDX);
+    __ CompareObject(instantiator_type_args_reg, Object::null_object());
+    __ j(EQUAL, &instantiator_hashed, Assembler::kNearJump);
+    __ movq(RDX, FieldAddress(instantiator_type_args_reg,
+                              TypeArguments::hash_offset()));
+    __ Bind(&instantiator_hashed);
+    __ CompareObject(function_type_args_reg, Object::null_object());
+    __ j(EQUAL, &hashed, Assembler::kNearJump);
+    __ xorq(RDX,
+            FieldAddress(function_type_args_reg, TypeArguments::hash_offset()));
+    __ Bind(&hashed);
+    // The hashes and the mask are Smis, so they are combined tagged.
+    __ andq(RDX, Address(RDI, TypeArguments::kHashedInstantiationsMaskIndex *
+                                  kWordSize));
+    __ SmiUntag(RDX);
+    __ imulq(RDX, Immediate(StubCode::kInstantiationSizeInWords * kWordSize));
+    // Skip the header.
+    __ leaq(RDI, Address(RDI, RDX, TIMES_1,
+                         StubCode::kInstantiationSizeInWords * kWordSize));
+  }
   __ Bind(&loop);
   __ movq(RDX, Address(RDI, 0 * kWordSize));  // Cached instantiator type args.
   __ cmpq(RDX, instantiator_type_args_reg);
@@ -4143,7 +4402,10 @@ LocationSummary* BinaryDoubleOpInstr::MakeLocationSummary(Zone* zone,
       LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
   summary->set_in(0, Location::RequiresFpuRegister());
   summary->set_in(1, Location::RequiresFpuRegister());
-  summary->set_out(0, Location::SameAsFirstInput());
+  // The three operand AVX forms do not overwrite the left operand.
+  summary->set_out(0, TargetCPUFeatures::avx_supported()
+                          ? Location::RequiresFpuRegister()
+                          : Location::SameAsFirstInput());
   return summary;
 }
 
@@ -4151,6 +4413,27 @@ void BinaryDoubleOpInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   XmmRegister left = locs()->in(0).fpu_reg();
   XmmRegister right = locs()->in(1).fpu_reg();
 
+  if (TargetCPUFeatures::avx_supported()) {
+    const XmmRegister result = locs()->out(0).fpu_reg();
+    switch (op_kind()) {
+      case Token::kADD:
+        __ vaddsd(result, left, right);
+        break;
+      case Token::kSUB:
+        __ vsubsd(result, left, right);
+        break;
+      case Token::kMUL:
+        __ vmulsd(result, left, right);
+        break;
+      case Token::kDIV:
+        __ vdivsd(result, left, right);
+        break;
+      default:
+        UNREACHABLE();
+    }
+    return;
+  }
+
   ASSERT(locs()->out(0).fpu_reg() == left);
 
   switch (op_kind()) {
@@ -4239,6 +4522,41 @@ Condition DoubleTestOpInstr::EmitComparisonCode(FlowGraphCompiler* compiler,
   V(Float32x4LessThan, cmppslt)                                                \
   V(Float32x4LessThanOrEqual, cmppsle)
 
+// Float operations that have three operand AVX forms.
+#define SIMD_OP_AVX_BINARY(V)                                                  \
+  SIMD_OP_FLOAT_ARITH(V, Add, vadd)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Sub, vsub)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Mul, vmul)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Div, vdiv)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Min, vmin)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Max, vmax)
+
+static bool IsAvxBinaryOp(SimdOpInstr::Kind kind) {
+  if (!TargetCPUFeatures::avx_supported()) return false;
+  switch (kind) {
+#define CASE(Name, op) case SimdOpInstr::k##Name:
+    SIMD_OP_AVX_BINARY(CASE)
+#undef CASE
+    return true;
+    default:
+      return false;
+  }
+}
+
+DEFINE_EMIT(SimdBinaryOpAvx,
+            (XmmRegister out, XmmRegister left, XmmRegister right)) {
+  switch (instr->kind()) {
+#define EMIT(Name, op)                                                         \
+  case SimdOpInstr::k##Name:                                                   \
+    __ op(out, left, right);                                                   \
+    break;
+    SIMD_OP_AVX_BINARY(EMIT)
+#undef EMIT
+    default:
+      UNREACHABLE();
+  }
+}
+
 DEFINE_EMIT(SimdBinaryOp,
             (SameAsFirstInput, XmmRegister left, XmmRegister right)) {
   switch (instr->kind()) {
@@ -4586,6 +4904,9 @@ DEFINE_EMIT(Int32x4Select,
   SIMPLE(Int32x4Select)
 
 LocationSummary* SimdOpInstr::MakeLocationSummary(Zone* zone, bool opt) const {
+  if (IsAvxBinaryOp(kind())) {
+    return MakeLocationSummaryFromEmitter(zone, this, &EmitSimdBinaryOpAvx);
+  }
   switch (kind()) {
 #define CASE(Name, ...) case k##Name:
 #define EMIT(Name)                                                             \
@@ -4603,6 +4924,10 @@ LocationSummary* SimdOpInstr::MakeLocationSummary(Zone* zone, bool opt) const {
 }
 
 void SimdOpInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  if (IsAvxBinaryOp(kind())) {
+    InvokeEmitter(compiler, this, &EmitSimdBinaryOpAvx);
+    return;
+  }
   switch (kind()) {
 #define CASE(Name, ...) case k##Name:
 #define EMIT(Name)                                                             \
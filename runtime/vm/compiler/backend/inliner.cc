@@ -60,6 +60,11 @@ DEFINE_FLAG(int,
             inlining_small_leaf_size_threshold,
             50,
             "Do not inline leaf callees larger than threshold");
+DEFINE_FLAG(int,
+            inlining_unboxed_size_threshold,
+            50,
+            "In AOT, always inline functions taking or returning int or "
+            "double that have threshold or fewer instructions");
 DEFINE_FLAG(int,
             inlining_caller_size_threshold,
             50000,
@@ -125,6 +130,43 @@ static bool IsCallRecursive(const Function& function, Definition* call) {
   return false;
 }
 
+// Test if the inlining decisions cached on callees may be updated. The
+// helpers of --precompiler_tasks compile functions in parallel and must only
+// see the state from before their batch started, otherwise the inlining
+// decisions would depend on the order in which the helpers run.
+static bool MayUpdateInliningCache() {
+  return !FLAG_precompiled_mode || !Compiler::IsBackgroundCompilation();
+}
+
+// Test if calls to the function pass or return int or double values. In AOT
+// such values are boxed at every call boundary, while inlining the call lets
+// the unboxing pass keep them unboxed.
+static bool HasUnboxableSignature(const Function& function) {
+  AbstractType& type = AbstractType::Handle(function.result_type());
+  if (type.IsIntType() || type.IsDoubleType()) {
+    return true;
+  }
+  for (intptr_t i = function.NumImplicitParameters(),
+                n = function.NumParameters();
+       i < n; ++i) {
+    type = function.ParameterTypeAt(i);
+    if (type.IsIntType() || type.IsDoubleType()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the size up to which the function is always inlined.
+static intptr_t InliningSizeThreshold(const Function& function) {
+  if (FLAG_precompiled_mode &&
+      (FLAG_inlining_unboxed_size_threshold > FLAG_inlining_size_threshold) &&
+      HasUnboxableSignature(function)) {
+    return FLAG_inlining_unboxed_size_threshold;
+  }
+  return FLAG_inlining_size_threshold;
+}
+
 // Helper to get the default value of a formal parameter.
 static ConstantInstr* GetDefaultValue(intptr_t i,
                                       const ParsedFunction& parsed_function) {
@@ -315,6 +357,14 @@ class CallSites : public ValueObject {
     instance_calls_.Clear();
   }
 
+  // Orders the instance and static call sites from the hottest to the
+  // coldest, so that the hottest ones are inlined first while the caller is
+  // within --inlining-caller-size-threshold.
+  void SortByRatio() {
+    instance_calls_.Sort(CompareByRatio<InstanceCallInfo>);
+    static_calls_.Sort(CompareByRatio<StaticCallInfo>);
+  }
+
   // Heuristic that maps the loop nesting depth to a static estimate of number
   // of times code at that depth is executed (code at each higher nesting
   // depth is assumed to execute 10x more often up to depth 3).
@@ -337,9 +387,11 @@ class CallSites : public ValueObject {
   // Computes the ratio for each call site in a method, defined as the
   // number of times a call site is executed over the maximum number of
   // times any call site is executed in the method. JIT uses actual call
-  // counts whereas AOT uses a static estimate based on nesting depth.
+  // counts whereas AOT uses a static estimate based on nesting depth, unless
+  // the method has type feedback from a training run.
   void ComputeCallSiteRatio(intptr_t static_call_start_ix,
-                            intptr_t instance_call_start_ix) {
+                            intptr_t instance_call_start_ix,
+                            bool use_call_counts) {
     const intptr_t num_static_calls =
         static_calls_.length() - static_call_start_ix;
     const intptr_t num_instance_calls =
@@ -351,8 +403,8 @@ class CallSites : public ValueObject {
       const InstanceCallInfo& info =
           instance_calls_[i + instance_call_start_ix];
       intptr_t aggregate_count =
-          FLAG_precompiled_mode ? AotCallCountApproximation(info.nesting_depth)
-                                : info.call->CallCount();
+          use_call_counts ? info.call->CallCount()
+                          : AotCallCountApproximation(info.nesting_depth);
       instance_call_counts.Add(aggregate_count);
       if (aggregate_count > max_count) max_count = aggregate_count;
     }
@@ -361,8 +413,8 @@ class CallSites : public ValueObject {
     for (intptr_t i = 0; i < num_static_calls; ++i) {
       const StaticCallInfo& info = static_calls_[i + static_call_start_ix];
       intptr_t aggregate_count =
-          FLAG_precompiled_mode ? AotCallCountApproximation(info.nesting_depth)
-                                : info.call->CallCount();
+          use_call_counts ? info.call->CallCount()
+                          : AotCallCountApproximation(info.nesting_depth);
       static_call_counts.Add(aggregate_count);
       if (aggregate_count > max_count) max_count = aggregate_count;
     }
@@ -384,6 +436,17 @@ class CallSites : public ValueObject {
     }
   }
 
+  template <typename T>
+  static int CompareByRatio(const T* a, const T* b) {
+    if (a->ratio != b->ratio) {
+      return (a->ratio > b->ratio) ? -1 : 1;
+    }
+    // Keep the order of equally hot call sites deterministic.
+    const intptr_t a_deopt_id = a->call->deopt_id();
+    const intptr_t b_deopt_id = b->call->deopt_id();
+    return (a_deopt_id < b_deopt_id) ? -1 : ((a_deopt_id > b_deopt_id) ? 1 : 0);
+  }
+
   static void RecordAllNotInlinedFunction(
       FlowGraph* graph,
       intptr_t depth,
@@ -416,6 +479,17 @@ class CallSites : public ValueObject {
     }
   }
 
+  static bool HasTypeFeedback(FlowGraph* graph) {
+#if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_DBC) &&                  \
+    !defined(TARGET_ARCH_IA32)
+    Precompiler* precompiler = Precompiler::Instance();
+    return (precompiler != nullptr) &&
+           precompiler->HasTypeFeedback(graph->function());
+#else
+    return false;
+#endif
+  }
+
   void FindCallSites(FlowGraph* graph,
                      intptr_t depth,
                      GrowableArray<InlinedInfo>* inlined_info) {
@@ -486,7 +560,8 @@ class CallSites : public ValueObject {
         }
       }
     }
-    ComputeCallSiteRatio(static_call_start_ix, instance_call_start_ix);
+    ComputeCallSiteRatio(static_call_start_ix, instance_call_start_ix,
+                         !FLAG_precompiled_mode || HasTypeFeedback(graph));
   }
 
  private:
@@ -791,6 +866,8 @@ class CallSiteInliner : public ValueObject {
       return InliningDecision::Yes("need to count first");
     } else if (instr_count <= FLAG_inlining_size_threshold) {
       return InliningDecision::Yes("--inlining-size-threshold");
+    } else if (instr_count <= InliningSizeThreshold(callee)) {
+      return InliningDecision::Yes("--inlining-unboxed-size-threshold");
     } else if (call_site_count <= FLAG_inlining_callee_call_sites_threshold) {
       return InliningDecision::Yes("--inlining-callee-call-sites-threshold");
     }
@@ -830,6 +907,7 @@ class CallSiteInliner : public ValueObject {
       collected_call_sites_ = inlining_call_sites_;
       inlining_call_sites_ = call_sites_temp;
       collected_call_sites_->Clear();
+      inlining_call_sites_->SortByRatio();
       // Inline call sites at the current depth.
       bool inlined_instance = InlineInstanceCalls();
       bool inlined_statics = InlineStaticCalls();
@@ -919,7 +997,9 @@ class CallSiteInliner : public ValueObject {
     // Abort if this function has deoptimized too much.
     if (function.deoptimization_counter() >=
         FLAG_max_deoptimization_counter_threshold) {
-      function.set_is_inlinable(false);
+      if (MayUpdateInliningCache()) {
+        function.set_is_inlinable(false);
+      }
       TRACE_INLINING(THR_Print("     Bailout: deoptimization threshold\n"));
       PRINT_INLINING_TREE("Deoptimization threshold exceeded",
                           &call_data->caller, &function, call_data->call);
@@ -1000,7 +1080,7 @@ class CallSiteInliner : public ValueObject {
             new (Z) ZoneGrowableArray<const ICData*>();
         const bool clone_ic_data = Compiler::IsBackgroundCompilation();
         function.RestoreICDataMap(ic_data_array, clone_ic_data);
-        if (Compiler::IsBackgroundCompilation() &&
+        if (!FLAG_precompiled_mode && Compiler::IsBackgroundCompilation() &&
             (function.ic_data_array() == Array::null())) {
           Compiler::AbortBackgroundCompilation(DeoptId::kNone,
                                                "ICData cleared while inlining");
@@ -1052,6 +1132,9 @@ class CallSiteInliner : public ValueObject {
     !defined(TARGET_ARCH_IA32)
         if (FLAG_precompiled_mode) {
           callee_graph->PopulateWithICData(parsed_function->function());
+          if (inliner_->precompiler_ != nullptr) {
+            inliner_->precompiler_->ApplyTypeFeedback(callee_graph);
+          }
         }
 #endif
 
@@ -1097,7 +1180,9 @@ class CallSiteInliner : public ValueObject {
           if (!AdjustForOptionalParameters(
                   *parsed_function, first_actual_param_index, argument_names,
                   arguments, param_stubs, callee_graph)) {
-            function.set_is_inlinable(false);
+            if (MayUpdateInliningCache()) {
+              function.set_is_inlinable(false);
+            }
             TRACE_INLINING(THR_Print("     Bailout: optional arg mismatch\n"));
             PRINT_INLINING_TREE("Optional arg mismatch", &call_data->caller,
                                 &function, call_data->call);
@@ -1196,8 +1281,9 @@ class CallSiteInliner : public ValueObject {
             ShouldWeInline(function, instruction_count, call_site_count);
         if (!decision.value) {
           // If size is larger than all thresholds, don't consider it again.
-          if ((instruction_count > FLAG_inlining_size_threshold) &&
-              (call_site_count > FLAG_inlining_callee_call_sites_threshold)) {
+          if ((instruction_count > InliningSizeThreshold(function)) &&
+              (call_site_count > FLAG_inlining_callee_call_sites_threshold) &&
+              MayUpdateInliningCache()) {
             function.set_is_inlinable(false);
           }
           TRACE_INLINING(
@@ -1517,11 +1603,46 @@ class CallSiteInliner : public ValueObject {
       if (TryInlining(target, call->argument_names(), &call_data, false)) {
         InlineCall(&call_data);
         inlined = true;
+      } else {
+        ReplaceWithStaticCall(call, target);
       }
     }
     return inlined;
   }
 
+  // Calls the known target of a closure call which was not inlined directly,
+  // instead of loading it from the closure and dispatching on the arguments
+  // descriptor. The entry point of the closure call is kept.
+  void ReplaceWithStaticCall(ClosureCallInstr* call, const Function& target) {
+    if (!target.AreValidArguments(call->type_args_len(),
+                                  call->ArgumentCountWithoutTypeArgs(),
+                                  call->argument_names(), NULL)) {
+      return;
+    }
+    PushArgumentsArray* arguments =
+        new (Z) PushArgumentsArray(call->ArgumentCount());
+    for (intptr_t i = 0; i < call->ArgumentCount(); i++) {
+      arguments->Add(call->PushArgumentAt(i));
+    }
+    StaticCallInstr* static_call = new (Z) StaticCallInstr(
+        call->token_pos(), target, call->type_args_len(),
+        call->argument_names(), arguments, call->deopt_id(), call->CallCount(),
+        ICData::kNoRebind);
+    static_call->set_entry_kind(call->entry_kind());
+    call->ReplaceWith(static_call, NULL);
+    TRACE_INLINING(THR_Print("     Replaced with static call to %s\n",
+                             target.ToCString()));
+  }
+
+  bool HasAlwaysInlineTarget(const CallTargets& targets) {
+    for (intptr_t i = 0; i < targets.length(); i++) {
+      if (inliner_->AlwaysInline(*targets.TargetAt(i)->target)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   bool InlineInstanceCalls() {
     bool inlined = false;
     const GrowableArray<CallSites::InstanceCallInfo>& call_info =
@@ -1530,6 +1651,18 @@ class CallSiteInliner : public ValueObject {
                              call_info.length()));
     for (intptr_t call_idx = 0; call_idx < call_info.length(); ++call_idx) {
       PolymorphicInstanceCallInstr* call = call_info[call_idx].call;
+      // Leave cold call sites as calls, unless a target is smaller than the
+      // call itself.
+      if (((call_info[call_idx].ratio * 100) < FLAG_inlining_hotness) &&
+          !HasAlwaysInlineTarget(call->targets())) {
+        TRACE_INLINING(
+            THR_Print("  => %s\n     Bailout: cold %f\n",
+                      call->instance_call()->function_name().ToCString(),
+                      call_info[call_idx].ratio));
+        PRINT_INLINING_TREE("Too cold", &call_info[call_idx].caller(),
+                            &call->targets().FirstTarget(), call);
+        continue;
+      }
       // PolymorphicInliner introduces deoptimization paths.
       if (!call->complete() && !FLAG_polymorphic_with_deopt) {
         TRACE_INLINING(
@@ -2252,6 +2385,11 @@ void FlowGraphInliner::CollectGraphInfo(FlowGraph* flow_graph,
   if (force || (function.optimized_instruction_count() == 0)) {
     GraphInfoCollector info;
     info.Collect(*flow_graph);
+    if (!MayUpdateInliningCache()) {
+      *instruction_count = info.instruction_count();
+      *call_site_count = info.call_site_count();
+      return;
+    }
     function.SetOptimizedInstructionCountClamped(info.instruction_count());
     function.SetOptimizedCallSiteCountClamped(info.call_site_count());
   }
@@ -2405,6 +2543,14 @@ static bool ShouldInlineInt64ArrayOps() {
   return FlowGraphCompiler::SupportsUnboxedInt64();
 }
 
+static bool ShouldInlineMemoryCopy() {
+#if defined(TARGET_ARCH_DBC) || defined(TARGET_ARCH_IA32)
+  return false;
+#else
+  return true;
+#endif
+}
+
 static bool CanUnboxInt32() {
   // Int32/Uint32 can be unboxed if it fits into a smi or the platform
   // supports unboxed mints.
@@ -3214,6 +3360,39 @@ static bool InlineByteArrayBaseStore(FlowGraph* flow_graph,
   return true;
 }
 
+// Replaces _TypedListBase._memMoveN(start, from, startFrom, count) with a
+// MemoryCopy of [element_size] byte elements. The caller has checked the
+// ranges and the element sizes.
+static bool InlineTypedDataMemMove(FlowGraph* flow_graph,
+                                   Instruction* call,
+                                   Definition* receiver,
+                                   intptr_t element_size,
+                                   GraphEntryInstr* graph_entry,
+                                   FunctionEntryInstr** entry,
+                                   Instruction** last,
+                                   Definition** result) {
+  if (!ShouldInlineMemoryCopy() ||
+      !flow_graph->isolate()->can_use_strong_mode_types()) {
+    return false;
+  }
+  Definition* dest_start = call->ArgumentAt(1);
+  Definition* src = call->ArgumentAt(2);
+  Definition* src_start = call->ArgumentAt(3);
+  Definition* length = call->ArgumentAt(4);
+
+  *entry =
+      new (Z) FunctionEntryInstr(graph_entry, flow_graph->allocate_block_id(),
+                                 call->GetBlock()->try_index(), DeoptId::kNone);
+  (*entry)->InheritDeoptTarget(Z, call);
+  MemoryCopyInstr* copy = new (Z) MemoryCopyInstr(
+      new (Z) Value(src), new (Z) Value(receiver), new (Z) Value(src_start),
+      new (Z) Value(dest_start), new (Z) Value(length), element_size);
+  flow_graph->AppendTo(*entry, copy, nullptr, FlowGraph::kEffect);
+  *last = copy;
+  *result = flow_graph->constant_null();
+  return true;
+}
+
 // Returns the LoadIndexedInstr.
 static Definition* PrepareInlineStringIndexOp(FlowGraph* flow_graph,
                                               Instruction* call,
@@ -3970,6 +4149,21 @@ bool FlowGraphInliner::TryInlineRecognizedMethod(
       return InlineByteArrayBaseStore(flow_graph, target, call, receiver,
                                       receiver_cid, kTypedDataInt32x4ArrayCid,
                                       graph_entry, entry, last, result);
+    case MethodRecognizer::kTypedDataMemMove1:
+      return InlineTypedDataMemMove(flow_graph, call, receiver, 1, graph_entry,
+                                    entry, last, result);
+    case MethodRecognizer::kTypedDataMemMove2:
+      return InlineTypedDataMemMove(flow_graph, call, receiver, 2, graph_entry,
+                                    entry, last, result);
+    case MethodRecognizer::kTypedDataMemMove4:
+      return InlineTypedDataMemMove(flow_graph, call, receiver, 4, graph_entry,
+                                    entry, last, result);
+    case MethodRecognizer::kTypedDataMemMove8:
+      return InlineTypedDataMemMove(flow_graph, call, receiver, 8, graph_entry,
+                                    entry, last, result);
+    case MethodRecognizer::kTypedDataMemMove16:
+      return InlineTypedDataMemMove(flow_graph, call, receiver, 16,
+                                    graph_entry, entry, last, result);
     case MethodRecognizer::kOneByteStringCodeUnitAt:
     case MethodRecognizer::kTwoByteStringCodeUnitAt:
     case MethodRecognizer::kExternalOneByteStringCodeUnitAt:
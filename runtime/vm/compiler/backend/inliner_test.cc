@@ -134,4 +134,135 @@ ISOLATE_UNIT_TEST_CASE(Inliner_PolyInliningRedefinition) {
   EXPECT(current->AsRedefinition()->Type()->ToCid() == kDynamicCid);
 }
 
+// Test that only the hot one of two instance call sites is inlined.
+ISOLATE_UNIT_TEST_CASE(Inliner_ColdInstanceCallNotInlined) {
+  const char* kScript = R"(
+    class A {
+      int foo(int x) {
+        var s = 0;
+        for (var i = 0; i < x; i++) s += i * x;
+        return s;
+      }
+    }
+
+    class B extends A {
+      int foo(int x) {
+        var s = 1;
+        for (var i = 0; i < x; i++) s += i;
+        return s;
+      }
+    }
+
+    int testColdCall(A a, A b, int n) {
+      var s = 0;
+      for (var i = 0; i < n; i++) s += a.foo(i);
+      return s + b.foo(n);
+    }
+
+    main() {
+      for (var i = 0; i < 10; i++) {
+        testColdCall(new A(), new B(), 100);
+      }
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& function =
+      Function::Handle(GetFunction(root_library, "testColdCall"));
+
+  Invoke(root_library, "main");
+
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({
+      CompilerPass::kComputeSSA,
+      CompilerPass::kApplyICData,
+      CompilerPass::kTryOptimizePatterns,
+      CompilerPass::kSetOuterInliningId,
+      CompilerPass::kTypePropagation,
+      CompilerPass::kApplyClassIds,
+      CompilerPass::kInlining,
+  });
+
+  intptr_t foo_calls = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (PolymorphicInstanceCallInstr* call =
+              it.Current()->AsPolymorphicInstanceCall()) {
+        if (call->instance_call()->function_name().Equals("foo")) {
+          const Class& owner =
+              Class::Handle(call->targets().FirstTarget().Owner());
+          EXPECT(String::Handle(owner.Name()).Equals("B"));
+          foo_calls++;
+        }
+      } else if (InstanceCallInstr* call = it.Current()->AsInstanceCall()) {
+        if (call->function_name().Equals("foo")) {
+          foo_calls++;
+        }
+      }
+    }
+  }
+  EXPECT_EQ(1, foo_calls);
+}
+
+DECLARE_FLAG(int, inlining_caller_size_threshold);
+
+// Test that a closure call to a known closure which is not inlined becomes a
+// static call of the closure function.
+ISOLATE_UNIT_TEST_CASE(Inliner_ClosureCallToStaticCall) {
+  const char* kScript = R"(
+    int testClosureCall(int x) {
+      final f = (int y) => x + y;
+      return f(x);
+    }
+
+    main() {
+      for (var i = 0; i < 10; i++) {
+        testClosureCall(i);
+      }
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& function =
+      Function::Handle(GetFunction(root_library, "testClosureCall"));
+
+  Invoke(root_library, "main");
+
+  // Reject inlining of all calls.
+  SetFlagScope<int> sfs(&FLAG_inlining_caller_size_threshold, -1);
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({
+      CompilerPass::kComputeSSA,
+      CompilerPass::kApplyICData,
+      CompilerPass::kTryOptimizePatterns,
+      CompilerPass::kSetOuterInliningId,
+      CompilerPass::kTypePropagation,
+      CompilerPass::kApplyClassIds,
+      CompilerPass::kInlining,
+  });
+
+  intptr_t closure_calls = 0;
+  StaticCallInstr* static_call = nullptr;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (it.Current()->IsClosureCall()) {
+        closure_calls++;
+      } else if (StaticCallInstr* call = it.Current()->AsStaticCall()) {
+        if (call->function().IsClosureFunction()) {
+          static_call = call;
+        }
+      }
+    }
+  }
+  EXPECT_EQ(0, closure_calls);
+  EXPECT(static_call != nullptr);
+  EXPECT_EQ(2, static_call->ArgumentCount());
+  Definition* receiver = static_call->PushArgumentAt(0)->value()->definition();
+  EXPECT(receiver->IsAllocateObject());
+}
+
 }  // namespace dart
@@ -523,6 +523,65 @@ void FlowGraphAllocator::PrintLiveRanges() {
   }
 }
 
+static void CountSpillMoves(ParallelMoveInstr* parallel_move,
+                            intptr_t* spills,
+                            intptr_t* reloads) {
+  for (intptr_t i = 0; i < parallel_move->NumMoves(); i++) {
+    MoveOperands* move = parallel_move->MoveOperandsAt(i);
+    if (move->IsRedundant()) continue;
+    if (move->dest().HasStackIndex() && !move->src().HasStackIndex()) {
+      (*spills)++;
+    } else if (move->src().HasStackIndex() && !move->dest().HasStackIndex()) {
+      (*reloads)++;
+    }
+  }
+}
+
+void FlowGraphAllocator::PrintRegisterPressure() {
+  intptr_t total_spills = 0;
+  intptr_t total_reloads = 0;
+  intptr_t loop_spills = 0;
+  intptr_t loop_reloads = 0;
+  intptr_t max_live = 0;
+  for (intptr_t i = 0; i < block_order_.length(); i++) {
+    BlockEntryInstr* block = block_order_[i];
+    intptr_t live = 0;
+    for (BitVector::Iterator it(liveness_.GetLiveInSet(block)); !it.Done();
+         it.Advance()) {
+      live++;
+    }
+    intptr_t spills = 0;
+    intptr_t reloads = 0;
+    if (block->HasParallelMove()) {
+      CountSpillMoves(block->parallel_move(), &spills, &reloads);
+    }
+    for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+      if (ParallelMoveInstr* parallel_move = it.Current()->AsParallelMove()) {
+        CountSpillMoves(parallel_move, &spills, &reloads);
+      }
+    }
+    GotoInstr* goto_instr = block->last_instruction()->AsGoto();
+    if ((goto_instr != NULL) && goto_instr->HasParallelMove()) {
+      CountSpillMoves(goto_instr->parallel_move(), &spills, &reloads);
+    }
+    const intptr_t depth =
+        (block->loop_info() != NULL) ? block->loop_info()->NestingDepth() : 0;
+    THR_Print("  B%" Pd " loop depth %" Pd ": live-in %" Pd ", spills %" Pd
+              ", reloads %" Pd "\n",
+              block->block_id(), depth, live, spills, reloads);
+    total_spills += spills;
+    total_reloads += reloads;
+    if (depth > 0) {
+      loop_spills += spills;
+      loop_reloads += reloads;
+    }
+    max_live = Utils::Maximum(max_live, live);
+  }
+  THR_Print("  max live-in %" Pd ", spills %" Pd " (%" Pd " in loops)"
+            ", reloads %" Pd " (%" Pd " in loops)\n",
+            max_live, total_spills, loop_spills, total_reloads, loop_reloads);
+}
+
 // Returns true if all uses of the given range inside the
 // given loop boundary have Any allocation policy.
 static bool HasOnlyUnconstrainedUsesInLoop(LiveRange* range,
@@ -3058,6 +3117,11 @@ void FlowGraphAllocator::AllocateRegisters() {
     PrintLiveRanges();
     THR_Print("----------------------------------------------\n");
 
+    THR_Print("-- [after ssa allocator] register pressure [%s] ---\n",
+              function.ToFullyQualifiedCString());
+    PrintRegisterPressure();
+    THR_Print("----------------------------------------------\n");
+
     THR_Print("-- [after ssa allocator] ir [%s] -------------\n",
               function.ToFullyQualifiedCString());
     if (FLAG_support_il_printer) {
@@ -244,6 +244,10 @@ class FlowGraphAllocator : public ValueObject {
 
   void PrintLiveRanges();
 
+  // Prints, for every block, the number of values live on entry and the
+  // number of spill stores and reloads the allocator inserted into it.
+  void PrintRegisterPressure();
+
   const FlowGraph& flow_graph_;
 
   ReachingDefs reaching_defs_;
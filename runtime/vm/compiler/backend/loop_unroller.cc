@@ -0,0 +1,507 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/compiler/backend/loop_unroller.h"
+
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/loops.h"
+#include "vm/object.h"
+#include "vm/symbols.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            loop_unrolling,
+            false,
+            "Fully unroll small loops with a constant trip count.");
+DEFINE_FLAG(int,
+            loop_unrolling_budget,
+            128,
+            "Maximum number of instructions loop unrolling may add to a "
+            "function.");
+DEFINE_FLAG(bool, trace_loop_unrolling, false, "Trace loop unrolling.");
+
+// A loop whose header holds only phis, an optional stack overflow check and
+// the exit branch on a control induction with a constant trip count, and
+// whose body is a single block of instructions that can be copied.
+class UnrollableLoop : public ZoneAllocated {
+ public:
+  UnrollableLoop(FlowGraph* flow_graph, LoopInfo* loop)
+      : flow_graph_(flow_graph),
+        loop_(loop),
+        header_(nullptr),
+        pre_header_(nullptr),
+        pre_header_goto_(nullptr),
+        body_(nullptr),
+        exit_(nullptr),
+        pre_header_index_(-1),
+        trip_count_(0),
+        body_size_(0),
+        copies_() {}
+
+  // Returns true if the loop has the expected shape and every instruction
+  // in its body can be copied.
+  bool Analyze() { return AnalyzeControl() && AnalyzeBody(); }
+
+  // Replaces the loop with trip_count() copies of its body in the
+  // pre-header.
+  void Unroll();
+
+  // Number of instructions added by unrolling the loop.
+  intptr_t Cost() const { return (trip_count_ - 1) * body_size_; }
+
+  JoinEntryInstr* header() const { return header_; }
+  intptr_t trip_count() const { return trip_count_; }
+
+ private:
+  bool AnalyzeControl();
+  bool AnalyzeBody();
+  static bool CanCopy(Instruction* instr);
+
+  Definition* CopyOf(Definition* def) const {
+    if (def->HasSSATemp() && (def->ssa_temp_index() < copies_.length()) &&
+        (copies_[def->ssa_temp_index()] != nullptr)) {
+      return copies_[def->ssa_temp_index()];
+    }
+    // Defined outside of the loop.
+    return def;
+  }
+  Value* CopyOf(Value* value) const {
+    return new Value(CopyOf(value->definition()));
+  }
+  void SetCopy(Definition* def, Definition* copy) {
+    ASSERT(def->HasSSATemp());
+    copies_[def->ssa_temp_index()] = copy;
+  }
+
+  Instruction* Copy(Instruction* instr);
+  void Emit(Instruction* instr);
+
+  FlowGraph* flow_graph_;
+  LoopInfo* loop_;
+  JoinEntryInstr* header_;
+  BlockEntryInstr* pre_header_;
+  GotoInstr* pre_header_goto_;
+  TargetEntryInstr* body_;
+  TargetEntryInstr* exit_;
+  intptr_t pre_header_index_;
+  intptr_t trip_count_;
+  intptr_t body_size_;
+
+  // Copy for the current iteration of each definition in the loop, indexed
+  // by SSA temp index.
+  GrowableArray<Definition*> copies_;
+
+  DISALLOW_COPY_AND_ASSIGN(UnrollableLoop);
+};
+
+bool UnrollableLoop::AnalyzeControl() {
+  header_ = loop_->header()->AsJoinEntry();
+  if ((header_ == nullptr) || (loop_->inner() != nullptr) ||
+      (header_->PredecessorCount() != 2) ||
+      (loop_->back_edges().length() != 1)) {
+    return false;
+  }
+
+  // Entered from a pre-header, with the body as the only other block.
+  pre_header_ = header_->ImmediateDominator();
+  if ((pre_header_ == nullptr) || !pre_header_->last_instruction()->IsGoto() ||
+      (pre_header_->try_index() != header_->try_index())) {
+    return false;
+  }
+  pre_header_goto_ = pre_header_->last_instruction()->AsGoto();
+  pre_header_index_ = header_->IndexOfPredecessor(pre_header_);
+  body_ = loop_->back_edges()[0]->AsTargetEntry();
+  if ((pre_header_index_ < 0) || (body_ == nullptr) ||
+      (body_->PredecessorAt(0) != header_) ||
+      !body_->last_instruction()->IsGoto()) {
+    return false;
+  }
+
+  // Only a stack overflow check in front of the exit branch, so nothing in
+  // the header needs to be copied.
+  Instruction* current = header_->next();
+  if (current->IsCheckStackOverflow()) {
+    current = current->next();
+  }
+  BranchInstr* branch = current->AsBranch();
+  if (branch == nullptr) {
+    return false;
+  }
+  if (branch->true_successor() == body_) {
+    exit_ = branch->false_successor();
+  } else if (branch->false_successor() == body_) {
+    exit_ = branch->true_successor();
+  } else {
+    return false;
+  }
+
+  // The exit branch tests a control induction against a constant, so the
+  // body runs a known number of times.
+  InductionVar* control = loop_->control();
+  InductionVar* limit = nullptr;
+  if (control != nullptr) {
+    for (auto bound : control->bounds()) {
+      if (bound.branch_ == branch) {
+        limit = bound.limit_;
+        break;
+      }
+    }
+  }
+  int64_t stride = 0;
+  int64_t begin = 0;
+  int64_t end = 0;
+  if ((limit == nullptr) || !InductionVar::IsLinear(control, &stride) ||
+      !InductionVar::IsConstant(control->initial(), &begin) ||
+      !InductionVar::IsConstant(limit, &end)) {
+    return false;
+  }
+  // The induction variable analysis only records bounds that the induction
+  // reaches with a unit stride.
+  ASSERT((stride == 1) || (stride == -1));
+  const int64_t trip_count = (end - begin) * stride;
+  if ((trip_count <= 0) || (trip_count > FLAG_loop_unrolling_budget + 1)) {
+    return false;
+  }
+  trip_count_ = trip_count;
+  return true;
+}
+
+bool UnrollableLoop::AnalyzeBody() {
+  for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->IsGoto() || current->IsCheckStackOverflow()) {
+      continue;
+    }
+    if (!CanCopy(current)) {
+      if (FLAG_trace_loop_unrolling && flow_graph_->should_print()) {
+        THR_Print("Not unrolling loop B%" Pd ": %s\n", header_->block_id(),
+                  current->ToCString());
+      }
+      return false;
+    }
+    body_size_++;
+  }
+  return true;
+}
+
+bool UnrollableLoop::CanCopy(Instruction* instr) {
+  switch (instr->tag()) {
+    case Instruction::kBinarySmiOp:
+    case Instruction::kBinaryInt32Op:
+    case Instruction::kBinaryUint32Op:
+    case Instruction::kBinaryInt64Op:
+      switch (instr->AsBinaryIntegerOp()->op_kind()) {
+        case Token::kADD:
+        case Token::kSUB:
+        case Token::kMUL:
+        case Token::kBIT_AND:
+        case Token::kBIT_OR:
+        case Token::kBIT_XOR:
+          return true;
+        default:
+          return false;
+      }
+    case Instruction::kBinaryDoubleOp:
+    case Instruction::kUnaryDoubleOp:
+    case Instruction::kDoubleToFloat:
+    case Instruction::kFloatToDouble:
+    case Instruction::kIntConverter:
+    case Instruction::kBox:
+    case Instruction::kBoxInt32:
+    case Instruction::kBoxUint32:
+    case Instruction::kBoxInt64:
+    case Instruction::kUnbox:
+    case Instruction::kUnboxInt32:
+    case Instruction::kUnboxUint32:
+    case Instruction::kUnboxInt64:
+    case Instruction::kLoadField:
+    case Instruction::kLoadIndexed:
+    case Instruction::kStoreIndexed:
+    case Instruction::kCheckArrayBound:
+    case Instruction::kGenericCheckBound:
+      return true;
+    default:
+      return false;
+  }
+}
+
+Instruction* UnrollableLoop::Copy(Instruction* instr) {
+  Instruction* copy = nullptr;
+  switch (instr->tag()) {
+    case Instruction::kBinaryInt64Op: {
+      BinaryInt64OpInstr* op = instr->AsBinaryInt64Op();
+      copy = new BinaryInt64OpInstr(op->op_kind(), CopyOf(op->left()),
+                                    CopyOf(op->right()), DeoptId::kNone,
+                                    op->speculative_mode());
+      break;
+    }
+    case Instruction::kBinarySmiOp:
+    case Instruction::kBinaryInt32Op:
+    case Instruction::kBinaryUint32Op: {
+      BinaryIntegerOpInstr* op = instr->AsBinaryIntegerOp();
+      copy = BinaryIntegerOpInstr::Make(
+          op->representation(), op->op_kind(), CopyOf(op->left()),
+          CopyOf(op->right()), DeoptId::kNone, op->can_overflow(),
+          op->is_truncating(), op->range());
+      break;
+    }
+    case Instruction::kBinaryDoubleOp: {
+      BinaryDoubleOpInstr* op = instr->AsBinaryDoubleOp();
+      copy = new BinaryDoubleOpInstr(op->op_kind(), CopyOf(op->left()),
+                                     CopyOf(op->right()), DeoptId::kNone,
+                                     op->token_pos(), op->speculative_mode());
+      break;
+    }
+    case Instruction::kUnaryDoubleOp: {
+      UnaryDoubleOpInstr* op = instr->AsUnaryDoubleOp();
+      copy = new UnaryDoubleOpInstr(op->op_kind(), CopyOf(op->value()),
+                                    DeoptId::kNone, op->speculative_mode());
+      break;
+    }
+    case Instruction::kDoubleToFloat: {
+      DoubleToFloatInstr* convert = instr->AsDoubleToFloat();
+      copy = new DoubleToFloatInstr(CopyOf(convert->value()), DeoptId::kNone,
+                                    convert->speculative_mode());
+      break;
+    }
+    case Instruction::kFloatToDouble:
+      copy = new FloatToDoubleInstr(CopyOf(instr->AsFloatToDouble()->value()),
+                                    DeoptId::kNone);
+      break;
+    case Instruction::kIntConverter: {
+      IntConverterInstr* convert = instr->AsIntConverter();
+      IntConverterInstr* converter = new IntConverterInstr(
+          convert->from(), convert->to(), CopyOf(convert->value()),
+          DeoptId::kNone);
+      if (convert->is_truncating()) {
+        converter->mark_truncating();
+      }
+      copy = converter;
+      break;
+    }
+    case Instruction::kBox:
+    case Instruction::kBoxInt32:
+    case Instruction::kBoxUint32:
+    case Instruction::kBoxInt64: {
+      BoxInstr* box = instr->AsBox();
+      copy = BoxInstr::Create(box->from_representation(), CopyOf(box->value()));
+      break;
+    }
+    case Instruction::kUnbox:
+    case Instruction::kUnboxInt32:
+    case Instruction::kUnboxUint32:
+    case Instruction::kUnboxInt64: {
+      UnboxInstr* unbox = instr->AsUnbox();
+      UnboxInstr* unboxed =
+          UnboxInstr::Create(unbox->representation(), CopyOf(unbox->value()),
+                             DeoptId::kNone, unbox->speculative_mode());
+      UnboxIntegerInstr* unbox_integer = unbox->AsUnboxInteger();
+      if ((unbox_integer != nullptr) && unbox_integer->is_truncating()) {
+        unboxed->AsUnboxInteger()->mark_truncating();
+      }
+      copy = unboxed;
+      break;
+    }
+    case Instruction::kLoadField: {
+      LoadFieldInstr* load = instr->AsLoadField();
+      copy = new LoadFieldInstr(CopyOf(load->instance()), load->slot(),
+                                load->token_pos());
+      break;
+    }
+    case Instruction::kLoadIndexed: {
+      LoadIndexedInstr* load = instr->AsLoadIndexed();
+      copy = new LoadIndexedInstr(
+          CopyOf(load->array()), CopyOf(load->index()), load->index_scale(),
+          load->class_id(), load->aligned() ? kAlignedAccess : kUnalignedAccess,
+          DeoptId::kNone, load->token_pos());
+      break;
+    }
+    case Instruction::kStoreIndexed: {
+      StoreIndexedInstr* store = instr->AsStoreIndexed();
+      copy = new StoreIndexedInstr(
+          CopyOf(store->array()), CopyOf(store->index()),
+          CopyOf(store->value()),
+          store->ShouldEmitStoreBarrier() ? kEmitStoreBarrier
+                                          : kNoStoreBarrier,
+          store->index_scale(), store->class_id(),
+          store->aligned() ? kAlignedAccess : kUnalignedAccess,
+          DeoptId::kNone, store->token_pos(), store->speculative_mode());
+      break;
+    }
+    case Instruction::kCheckArrayBound: {
+      CheckArrayBoundInstr* check = instr->AsCheckArrayBound();
+      CheckArrayBoundInstr* checked = new CheckArrayBoundInstr(
+          CopyOf(check->length()), CopyOf(check->index()), DeoptId::kNone);
+      if (check->generalized()) {
+        checked->mark_generalized();
+      }
+      copy = checked;
+      break;
+    }
+    case Instruction::kGenericCheckBound: {
+      GenericCheckBoundInstr* check = instr->AsGenericCheckBound();
+      copy = new GenericCheckBoundInstr(CopyOf(check->length()),
+                                        CopyOf(check->index()), DeoptId::kNone);
+      break;
+    }
+    default:
+      UNREACHABLE();
+  }
+  copy->CopyDeoptIdFrom(*instr);
+
+  // Every iteration produces values within the range of the loop values.
+  Definition* def = instr->AsDefinition();
+  if ((def != nullptr) && (def->range() != nullptr)) {
+    copy->AsDefinition()->set_range(*def->range());
+  }
+  return copy;
+}
+
+void UnrollableLoop::Emit(Instruction* instr) {
+  Instruction* copy = Copy(instr);
+
+  // Deoptimization resumes the unoptimized loop in the iteration that the
+  // copy belongs to.
+  Environment* env = nullptr;
+  if (instr->env() != nullptr) {
+    env = instr->env()->DeepCopy(flow_graph_->zone());
+    for (Environment::DeepIterator it(env); !it.Done(); it.Advance()) {
+      Value* value = it.CurrentValue();
+      value->set_definition(CopyOf(value->definition()));
+    }
+  }
+
+  Definition* def = instr->AsDefinition();
+  const bool is_value = (def != nullptr) && def->HasSSATemp();
+  flow_graph_->InsertBefore(pre_header_goto_, copy, env,
+                            is_value ? FlowGraph::kValue : FlowGraph::kEffect);
+  if (is_value) {
+    SetCopy(def, copy->AsDefinition());
+  }
+}
+
+void UnrollableLoop::Unroll() {
+  Zone* zone = flow_graph_->zone();
+  copies_.FillWith(nullptr, 0, flow_graph_->current_ssa_temp_index());
+
+  // Values of the header phis at the start of the current iteration.
+  GrowableArray<PhiInstr*> phis;
+  GrowableArray<Definition*> values;
+  for (PhiIterator it(header_); !it.Done(); it.Advance()) {
+    PhiInstr* phi = it.Current();
+    phis.Add(phi);
+    values.Add(phi->InputAt(pre_header_index_)->definition());
+  }
+  const intptr_t back_edge_index = 1 - pre_header_index_;
+
+  for (intptr_t i = 0; i < trip_count_; ++i) {
+    for (intptr_t j = 0; j < phis.length(); ++j) {
+      if (phis[j]->HasSSATemp()) {
+        SetCopy(phis[j], values[j]);
+      }
+    }
+    for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+      Instruction* current = it.Current();
+      // The unrolled code no longer loops, so it needs no interrupt checks.
+      if (current->IsGoto() || current->IsCheckStackOverflow()) {
+        continue;
+      }
+      Emit(current);
+    }
+    for (intptr_t j = 0; j < phis.length(); ++j) {
+      values[j] = CopyOf(phis[j]->InputAt(back_edge_index)->definition());
+    }
+  }
+
+  // Detach the loop blocks from the rest of the graph, then let uses after
+  // the loop see the values computed by the last iteration.
+  for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+    it.Current()->UnuseAllInputs();
+  }
+  for (ForwardInstructionIterator it(header_); !it.Done(); it.Advance()) {
+    it.Current()->UnuseAllInputs();
+  }
+  for (intptr_t j = 0; j < phis.length(); ++j) {
+    phis[j]->UnuseAllInputs();
+  }
+  for (intptr_t j = 0; j < phis.length(); ++j) {
+    phis[j]->ReplaceUsesWith(values[j]);
+  }
+
+  // Jump from the pre-header straight to the loop exit, which becomes a
+  // join. Dominators are recomputed once all loops have been unrolled.
+  ASSERT(exit_->parallel_move() == nullptr);
+  JoinEntryInstr* join = new (zone)
+      JoinEntryInstr(exit_->block_id(), exit_->try_index(), DeoptId::kNone);
+  join->InheritDeoptTarget(zone, exit_);
+  exit_->UnuseAllInputs();
+  join->LinkTo(exit_->next());
+
+  GotoInstr* jump = new (zone) GotoInstr(join, DeoptId::kNone);
+  jump->InheritDeoptTarget(zone, pre_header_goto_);
+  Instruction* previous = pre_header_goto_->previous();
+  pre_header_goto_->set_previous(nullptr);
+  pre_header_goto_->UnuseAllInputs();
+  previous->LinkTo(jump);
+}
+
+bool LoopUnroller::HasUnrollPragma(const Function& function) {
+  if (!function.has_pragma()) {
+    return false;
+  }
+  Thread* thread = Thread::Current();
+  Object& options = Object::Handle(thread->zone());
+  return Library::FindPragma(thread, /*only_core=*/false, function,
+                             Symbols::vm_unroll(), &options);
+}
+
+bool LoopUnroller::Optimize(FlowGraph* flow_graph) {
+  if (!FLAG_loop_unrolling && !HasUnrollPragma(flow_graph->function())) {
+    return false;
+  }
+
+  const LoopHierarchy& loop_hierarchy = flow_graph->GetLoopHierarchy();
+  const ZoneGrowableArray<BlockEntryInstr*>& loop_headers =
+      loop_hierarchy.headers();
+  loop_hierarchy.ComputeInduction();
+
+  // Analyze all loops before changing any of them, since unrolling
+  // invalidates the loop information. Loops are taken in the order of
+  // their headers until the budget is used up.
+  intptr_t budget = FLAG_loop_unrolling_budget;
+  GrowableArray<UnrollableLoop*> loops;
+  for (intptr_t i = 0; i < loop_headers.length(); ++i) {
+    UnrollableLoop* loop = new (flow_graph->zone())
+        UnrollableLoop(flow_graph, loop_headers[i]->loop_info());
+    if (loop->Analyze() && (loop->Cost() <= budget)) {
+      budget -= loop->Cost();
+      loops.Add(loop);
+    }
+  }
+  if (loops.is_empty()) {
+    return false;
+  }
+
+  for (intptr_t i = 0; i < loops.length(); ++i) {
+    if (FLAG_trace_loop_unrolling && flow_graph->should_print()) {
+      THR_Print("Unrolling loop B%" Pd " %" Pd " times\n",
+                loops[i]->header()->block_id(), loops[i]->trip_count());
+    }
+    loops[i]->Unroll();
+  }
+
+  flow_graph->DiscoverBlocks();
+  flow_graph->MergeBlocks();
+  GrowableArray<BitVector*> dominance_frontier;
+  flow_graph->ComputeDominators(&dominance_frontier);
+  return true;
+}
+
+}  // namespace dart
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
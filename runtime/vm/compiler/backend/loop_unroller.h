@@ -0,0 +1,40 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
+
+#include "vm/allocation.h"
+
+namespace dart {
+
+class FlowGraph;
+class Function;
+
+// Fully unrolls innermost loops with a small constant trip count, such as
+//
+//   for (int i = 0; i < 4; i++) {
+//     a[i] = b[i] * c;
+//   }
+//
+// by peeling every iteration into the loop pre-header. This removes the
+// compare and branch of each iteration, and lets CSE and constant folding
+// work across iterations.
+//
+// Loops are unrolled when --loop_unrolling is enabled, or when the function
+// being compiled is annotated with @pragma('vm:unroll'). Either way the
+// number of instructions added to the function is limited by
+// --loop_unrolling_budget.
+class LoopUnroller : public AllStatic {
+ public:
+  // Returns true if any loop was unrolled.
+  static bool Optimize(FlowGraph* flow_graph);
+
+  // Returns true if the function is annotated with @pragma('vm:unroll').
+  static bool HasUnrollPragma(const Function& function);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
@@ -0,0 +1,78 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/loop_unroller.h"
+
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/compiler/backend/loops.h"
+#include "vm/dart_entry.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+DECLARE_FLAG(bool, loop_unrolling);
+DECLARE_FLAG(int, loop_unrolling_budget);
+
+#if !defined(TARGET_ARCH_DBC)
+
+static const char* kFillScript =
+    R"(
+    import 'dart:typed_data';
+
+    @pragma('vm:unroll')
+    void fill(Int32List list) {
+      for (int i = 0; i < 8; i++) {
+        list[i] = i * 3;
+      }
+    }
+
+    void main() {
+      final list = new Int32List(8);
+      for (int i = 0; i < 100; i++) {
+        fill(list);
+      }
+    }
+    )";
+
+ISOLATE_UNIT_TEST_CASE(LoopUnroller_Pragma) {
+  const auto& root_library = Library::Handle(LoadTestScript(kFillScript));
+  Invoke(root_library, "main");
+  const auto& function = Function::Handle(GetFunction(root_library, "fill"));
+  EXPECT(LoopUnroller::HasUnrollPragma(function));
+
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  EXPECT_EQ(0, flow_graph->GetLoopHierarchy().num_loops());
+  pipeline.CompileGraphAndAttachFunction();
+
+  const intptr_t kLength = 8;
+  const auto& list =
+      TypedData::Handle(TypedData::New(kTypedDataInt32ArrayCid, kLength));
+  const auto& arguments = Array::Handle(Array::New(1));
+  arguments.SetAt(0, list);
+  const auto& result =
+      Object::Handle(DartEntry::InvokeFunction(function, arguments));
+  EXPECT(result.IsNull());
+  for (intptr_t i = 0; i < kLength; i++) {
+    EXPECT_EQ(i * 3, list.GetInt32(i * sizeof(int32_t)));
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopUnroller_Budget) {
+  const auto& root_library = Library::Handle(LoadTestScript(kFillScript));
+  Invoke(root_library, "main");
+  const auto& function = Function::Handle(GetFunction(root_library, "fill"));
+
+  // Eight copies of the body do not fit into a budget of two instructions.
+  SetFlagScope<bool> sfs_unrolling(&FLAG_loop_unrolling, true);
+  SetFlagScope<int> sfs_budget(&FLAG_loop_unrolling_budget, 2);
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  EXPECT_EQ(1, flow_graph->GetLoopHierarchy().num_loops());
+}
+
+#endif  // !defined(TARGET_ARCH_DBC)
+
+}  // namespace dart
@@ -0,0 +1,586 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/compiler/backend/loop_vectorizer.h"
+
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/loops.h"
+#include "vm/compiler/backend/range_analysis.h"
+#include "vm/hash_map.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            loop_vectorization,
+            false,
+            "Vectorize simple loops over Float32List, Int32List and "
+            "Uint32List.");
+DEFINE_FLAG(bool, trace_loop_vectorization, false, "Trace loop vectorization.");
+
+#if defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+
+// Number of elements handled by one iteration of a vectorized loop.
+static const intptr_t kLanes = 4;
+
+// Describes what a definition in the loop body computes for each element.
+enum LaneKind {
+  // The definition cannot be vectorized.
+  kNoLanes,
+  // A float, as loaded from or stored into a Float32List.
+  kFloat32Lanes,
+  // A float widened to a double.
+  kWidenedFloat32Lanes,
+  // A single double operation on widened floats. Narrowing the result to a
+  // float gives the same value as performing the operation on floats, since
+  // doubles have more than twice the precision. This no longer holds once
+  // the result takes part in another operation.
+  kFloat32OpLanes,
+  // An integer of which only the low 32 bits are observed, as it ends up
+  // in an Int32List or Uint32List.
+  kInt32Lanes,
+};
+
+static LaneKind LaneKindForArrayCid(intptr_t cid) {
+  switch (cid) {
+    case kTypedDataFloat32ArrayCid:
+      return kFloat32Lanes;
+    case kTypedDataInt32ArrayCid:
+    case kTypedDataUint32ArrayCid:
+      return kInt32Lanes;
+    default:
+      return kNoLanes;
+  }
+}
+
+static intptr_t VectorArrayCid(LaneKind kind) {
+  ASSERT((kind == kFloat32Lanes) || (kind == kInt32Lanes));
+  return (kind == kFloat32Lanes) ? kTypedDataFloat32x4ArrayCid
+                                 : kTypedDataInt32x4ArrayCid;
+}
+
+// Returns true if [def] is a Smi small enough to add kLanes to it without
+// overflow.
+static bool IsSmallSmi(Definition* def) {
+  const int64_t kMaxValue = compiler::target::kSmiMax - kLanes;
+  if (ConstantInstr* constant = def->AsConstant()) {
+    return constant->value().IsSmi() &&
+           (Smi::Cast(constant->value()).Value() <= kMaxValue);
+  }
+  return RangeUtils::IsWithin(def->range(), compiler::target::kSmiMin,
+                              kMaxValue);
+}
+
+// A loop whose header holds only the induction phi, an optional stack
+// overflow check and the exit branch, and whose body is a single block that
+// jumps back to the header.
+class VectorizableLoop : public ZoneAllocated {
+ public:
+  VectorizableLoop(FlowGraph* flow_graph, LoopInfo* loop)
+      : flow_graph_(flow_graph),
+        loop_(loop),
+        header_(nullptr),
+        pre_header_(nullptr),
+        body_(nullptr),
+        branch_(nullptr),
+        check_(nullptr),
+        induction_(nullptr),
+        increment_(nullptr),
+        limit_(nullptr),
+        pre_header_index_(-1),
+        vector_exit_(nullptr) {}
+
+  // Returns true if the loop has the expected shape and every instruction
+  // in its body has a vector counterpart.
+  bool Analyze() { return AnalyzeControl() && AnalyzeBody(); }
+
+  // Inserts a vector loop in front of the loop, which is kept to handle the
+  // remaining iterations.
+  void Vectorize();
+
+  // Brings the inputs of the induction phi back in line with the header
+  // predecessors once blocks have been rediscovered.
+  void UpdateInductionPhi();
+
+  JoinEntryInstr* header() const { return header_; }
+
+ private:
+  bool AnalyzeControl();
+  bool AnalyzeBody();
+  LaneKind AnalyzeInstruction(Instruction* instr);
+  bool IsVectorAccess(Value* array,
+                      Value* index,
+                      intptr_t index_scale,
+                      intptr_t class_id) const;
+  bool IsInvariant(Definition* def) const {
+    return def->GetBlock()->Dominates(pre_header_);
+  }
+  LaneKind LanesOf(Value* value) const {
+    return lanes_.LookupValue(value->definition());
+  }
+  Definition* VectorOf(Value* value) const {
+    Definition* vector = vectors_.LookupValue(value->definition());
+    ASSERT(vector != nullptr);
+    return vector;
+  }
+
+  Instruction* EmitVectorInstruction(Instruction* instr,
+                                     Definition* index,
+                                     Instruction* cursor);
+  TargetEntryInstr* NewTarget();
+  GotoInstr* NewGoto(JoinEntryInstr* target);
+  BinarySmiOpInstr* NewIndexAdd(Definition* index, intptr_t offset);
+
+  typedef RawPointerKeyValueTrait<Definition, LaneKind> LanesKV;
+  typedef RawPointerKeyValueTrait<Definition, Definition*> VectorKV;
+
+  FlowGraph* flow_graph_;
+  LoopInfo* loop_;
+  JoinEntryInstr* header_;
+  BlockEntryInstr* pre_header_;
+  TargetEntryInstr* body_;
+  BranchInstr* branch_;
+  CheckStackOverflowInstr* check_;
+  PhiInstr* induction_;
+  Definition* increment_;
+  Definition* limit_;
+  intptr_t pre_header_index_;
+  TargetEntryInstr* vector_exit_;
+
+  // Lane kind of each vectorizable definition in the body.
+  DirectChainedHashMap<LanesKV> lanes_;
+  // Vector counterpart of each definition in the body.
+  DirectChainedHashMap<VectorKV> vectors_;
+
+  DISALLOW_COPY_AND_ASSIGN(VectorizableLoop);
+};
+
+bool VectorizableLoop::AnalyzeControl() {
+  header_ = loop_->header()->AsJoinEntry();
+  if ((header_ == nullptr) || (loop_->inner() != nullptr) ||
+      (header_->PredecessorCount() != 2) ||
+      (loop_->back_edges().length() != 1)) {
+    return false;
+  }
+
+  // Entered from a pre-header, with the body as the only other block.
+  pre_header_ = header_->ImmediateDominator();
+  if ((pre_header_ == nullptr) || !pre_header_->last_instruction()->IsGoto()) {
+    return false;
+  }
+  pre_header_index_ = header_->IndexOfPredecessor(pre_header_);
+  body_ = loop_->back_edges()[0]->AsTargetEntry();
+  if ((pre_header_index_ < 0) || (body_ == nullptr) ||
+      (body_->PredecessorAt(0) != header_)) {
+    return false;
+  }
+
+  // A single phi for an induction with unit stride.
+  for (PhiIterator it(header_); !it.Done(); it.Advance()) {
+    if (induction_ != nullptr) {
+      return false;
+    }
+    induction_ = it.Current();
+  }
+  int64_t stride = 0;
+  if ((induction_ == nullptr) || (induction_->representation() != kTagged) ||
+      !InductionVar::IsLinear(loop_->LookupInduction(induction_), &stride) ||
+      (stride != 1)) {
+    return false;
+  }
+  Value* increment_use = induction_->InputAt(1 - pre_header_index_);
+  increment_ = increment_use->definition();
+  if ((increment_->GetBlock() != body_) || !increment_->IsBinarySmiOp() ||
+      !increment_->HasOnlyInputUse(increment_use)) {
+    return false;
+  }
+
+  // Looping while i < n on Smis.
+  branch_ = header_->last_instruction()->AsBranch();
+  if ((branch_ == nullptr) || (branch_->true_successor() != body_)) {
+    return false;
+  }
+  RelationalOpInstr* compare = branch_->comparison()->AsRelationalOp();
+  if ((compare == nullptr) || (compare->operation_cid() != kSmiCid)) {
+    return false;
+  }
+  if ((compare->kind() == Token::kLT) &&
+      (compare->left()->definition() == induction_)) {
+    limit_ = compare->right()->definition();
+  } else if ((compare->kind() == Token::kGT) &&
+             (compare->right()->definition() == induction_)) {
+    limit_ = compare->left()->definition();
+  } else {
+    return false;
+  }
+
+  // The vector loop index never exceeds the larger of the initial value and
+  // the limit, so it is safe to compute with Smi operations that can't
+  // overflow.
+  Definition* init = induction_->InputAt(pre_header_index_)->definition();
+  if (!IsInvariant(limit_) || !IsSmallSmi(init) || !IsSmallSmi(limit_)) {
+    return false;
+  }
+
+  // Nothing else in the header.
+  for (Instruction* instr = header_->next(); instr != branch_;
+       instr = instr->next()) {
+    if (!instr->IsCheckStackOverflow() || (check_ != nullptr)) {
+      return false;
+    }
+    check_ = instr->AsCheckStackOverflow();
+  }
+  return true;
+}
+
+bool VectorizableLoop::AnalyzeBody() {
+  bool has_store = false;
+  for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->IsGoto() || (current == increment_)) {
+      continue;
+    }
+    const LaneKind kind = AnalyzeInstruction(current);
+    if (kind == kNoLanes) {
+      return false;
+    }
+    if (current->IsStoreIndexed()) {
+      has_store = true;
+    } else {
+      lanes_.Insert(LanesKV::Pair(current->AsDefinition(), kind));
+    }
+  }
+  return has_store;
+}
+
+// Elements are only accessed at the induction, in internal typed data that
+// is the same in every iteration. Distinct internal typed data never
+// overlap, so iterations are independent of each other.
+bool VectorizableLoop::IsVectorAccess(Value* array,
+                                      Value* index,
+                                      intptr_t index_scale,
+                                      intptr_t class_id) const {
+  const intptr_t element_size =
+      compiler::target::Instance::ElementSizeFor(class_id);
+  return (LaneKindForArrayCid(class_id) != kNoLanes) &&
+         (index_scale == element_size) &&
+         (index->definition() == induction_) &&
+         (array->definition()->representation() == kTagged) &&
+         IsInvariant(array->definition());
+}
+
+LaneKind VectorizableLoop::AnalyzeInstruction(Instruction* instr) {
+  if (LoadIndexedInstr* load = instr->AsLoadIndexed()) {
+    if (!IsVectorAccess(load->array(), load->index(), load->index_scale(),
+                        load->class_id())) {
+      return kNoLanes;
+    }
+    return LaneKindForArrayCid(load->class_id());
+  }
+
+  if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+    const LaneKind kind = LaneKindForArrayCid(store->class_id());
+    if (!IsVectorAccess(store->array(), store->index(), store->index_scale(),
+                        store->class_id()) ||
+        (LanesOf(store->value()) != kind)) {
+      return kNoLanes;
+    }
+    return kind;
+  }
+
+  if (instr->IsFloatToDouble()) {
+    return (LanesOf(instr->InputAt(0)) == kFloat32Lanes) ? kWidenedFloat32Lanes
+                                                         : kNoLanes;
+  }
+
+  if (instr->IsDoubleToFloat()) {
+    const LaneKind kind = LanesOf(instr->InputAt(0));
+    return ((kind == kWidenedFloat32Lanes) || (kind == kFloat32OpLanes))
+               ? kFloat32Lanes
+               : kNoLanes;
+  }
+
+  if (BinaryDoubleOpInstr* op = instr->AsBinaryDoubleOp()) {
+    switch (op->op_kind()) {
+      case Token::kADD:
+      case Token::kSUB:
+      case Token::kMUL:
+      case Token::kDIV:
+        break;
+      default:
+        return kNoLanes;
+    }
+    return ((LanesOf(op->left()) == kWidenedFloat32Lanes) &&
+            (LanesOf(op->right()) == kWidenedFloat32Lanes))
+               ? kFloat32OpLanes
+               : kNoLanes;
+  }
+
+  // Only the low 32 bits are observed, so conversions between integer
+  // representations don't matter, and neither do the checks that might
+  // deoptimize the scalar code on the way.
+  if (instr->IsBoxInteger() || instr->IsUnboxInteger() ||
+      instr->IsIntConverter()) {
+    return (LanesOf(instr->InputAt(0)) == kInt32Lanes) ? kInt32Lanes
+                                                       : kNoLanes;
+  }
+
+  // The low 32 bits of these only depend on the low 32 bits of the inputs.
+  if (BinaryIntegerOpInstr* op = instr->AsBinaryIntegerOp()) {
+    switch (op->op_kind()) {
+      case Token::kADD:
+      case Token::kSUB:
+      case Token::kBIT_AND:
+      case Token::kBIT_OR:
+      case Token::kBIT_XOR:
+        break;
+      default:
+        return kNoLanes;
+    }
+    return ((LanesOf(op->left()) == kInt32Lanes) &&
+            (LanesOf(op->right()) == kInt32Lanes))
+               ? kInt32Lanes
+               : kNoLanes;
+  }
+
+  return kNoLanes;
+}
+
+TargetEntryInstr* VectorizableLoop::NewTarget() {
+  TargetEntryInstr* target = new (flow_graph_->zone())
+      TargetEntryInstr(flow_graph_->allocate_block_id(), header_->try_index(),
+                       DeoptId::kNone);
+  target->InheritDeoptTarget(flow_graph_->zone(), branch_);
+  return target;
+}
+
+GotoInstr* VectorizableLoop::NewGoto(JoinEntryInstr* target) {
+  GotoInstr* got =
+      new (flow_graph_->zone()) GotoInstr(target, DeoptId::kNone);
+  got->InheritDeoptTarget(flow_graph_->zone(), branch_);
+  return got;
+}
+
+BinarySmiOpInstr* VectorizableLoop::NewIndexAdd(Definition* index,
+                                                intptr_t offset) {
+  Zone* zone = flow_graph_->zone();
+  ConstantInstr* constant =
+      flow_graph_->GetConstant(Smi::ZoneHandle(zone, Smi::New(offset)));
+  BinarySmiOpInstr* add = new (zone)
+      BinarySmiOpInstr(Token::kADD, new (zone) Value(index),
+                       new (zone) Value(constant), DeoptId::kNone);
+  add->set_can_overflow(false);
+  return add;
+}
+
+Instruction* VectorizableLoop::EmitVectorInstruction(Instruction* instr,
+                                                     Definition* index,
+                                                     Instruction* cursor) {
+  Zone* zone = flow_graph_->zone();
+
+  if (LoadIndexedInstr* load = instr->AsLoadIndexed()) {
+    LoadIndexedInstr* vector = new (zone) LoadIndexedInstr(
+        new (zone) Value(load->array()->definition()), new (zone) Value(index),
+        load->index_scale(), VectorArrayCid(lanes_.LookupValue(load)),
+        kUnalignedAccess, DeoptId::kNone, load->token_pos());
+    vectors_.Insert(VectorKV::Pair(load, vector));
+    return flow_graph_->AppendTo(cursor, vector, nullptr, FlowGraph::kValue);
+  }
+
+  if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+    StoreIndexedInstr* vector = new (zone) StoreIndexedInstr(
+        new (zone) Value(store->array()->definition()), new (zone) Value(index),
+        new (zone) Value(VectorOf(store->value())), kNoStoreBarrier,
+        store->index_scale(),
+        VectorArrayCid(LaneKindForArrayCid(store->class_id())),
+        kUnalignedAccess, DeoptId::kNone, store->token_pos());
+    return flow_graph_->AppendTo(cursor, vector, nullptr, FlowGraph::kEffect);
+  }
+
+  SimdOpInstr* vector = nullptr;
+  if (BinaryDoubleOpInstr* op = instr->AsBinaryDoubleOp()) {
+    vector = SimdOpInstr::Create(
+        SimdOpInstr::KindForOperator(kFloat32x4Cid, op->op_kind()),
+        new (zone) Value(VectorOf(op->left())),
+        new (zone) Value(VectorOf(op->right())), DeoptId::kNone);
+  } else if (BinaryIntegerOpInstr* op = instr->AsBinaryIntegerOp()) {
+    vector = SimdOpInstr::Create(
+        SimdOpInstr::KindForOperator(kInt32x4Cid, op->op_kind()),
+        new (zone) Value(VectorOf(op->left())),
+        new (zone) Value(VectorOf(op->right())), DeoptId::kNone);
+  }
+  if (vector != nullptr) {
+    vectors_.Insert(VectorKV::Pair(instr->AsDefinition(), vector));
+    return flow_graph_->AppendTo(cursor, vector, nullptr, FlowGraph::kValue);
+  }
+
+  // Conversions leave the lanes as they are.
+  ASSERT(instr->IsFloatToDouble() || instr->IsDoubleToFloat() ||
+         instr->IsBoxInteger() || instr->IsUnboxInteger() ||
+         instr->IsIntConverter());
+  vectors_.Insert(
+      VectorKV::Pair(instr->AsDefinition(), VectorOf(instr->InputAt(0))));
+  return cursor;
+}
+
+// Turns
+//
+//   pre_header:
+//     goto header
+//   header:
+//     i = phi(init, i + 1)
+//     if (i < n) goto body else goto exit
+//
+// into
+//
+//   pre_header:
+//     goto vector_header
+//   vector_header:
+//     j = phi(init, j + 4)
+//     if (j + 3 < n) goto vector_body else goto vector_exit
+//   vector_body:
+//     ...
+//     goto vector_header
+//   vector_exit:
+//     goto header
+//   header:
+//     i = phi(j, i + 1)
+//     if (i < n) goto body else goto exit
+void VectorizableLoop::Vectorize() {
+  Zone* zone = flow_graph_->zone();
+  Definition* init = induction_->InputAt(pre_header_index_)->definition();
+
+  JoinEntryInstr* vector_header = new (zone) JoinEntryInstr(
+      flow_graph_->allocate_block_id(), header_->try_index(), DeoptId::kNone);
+  vector_header->InheritDeoptTarget(zone, branch_);
+  TargetEntryInstr* vector_body = NewTarget();
+  vector_exit_ = NewTarget();
+
+  // The pre-header has a lower block id than the new body, so the initial
+  // value comes first.
+  PhiInstr* vector_induction = new (zone) PhiInstr(vector_header, 2);
+  flow_graph_->AllocateSSAIndexes(vector_induction);
+  vector_induction->mark_alive();
+  Value* init_use = new (zone) Value(init);
+  vector_induction->SetInputAt(0, init_use);
+  init->AddInputUse(init_use);
+  vector_header->InsertPhi(vector_induction);
+
+  Instruction* cursor = vector_header;
+  if (check_ != nullptr) {
+    // Deoptimizing here resumes the scalar loop at the vector index.
+    CheckStackOverflowInstr* check = new (zone) CheckStackOverflowInstr(
+        check_->token_pos(), check_->stack_depth(), check_->loop_depth(),
+        check_->deopt_id(), check_->kind());
+    cursor =
+        flow_graph_->AppendTo(cursor, check, check_->env(), FlowGraph::kEffect);
+    for (Environment::DeepIterator it(check->env()); !it.Done();
+         it.Advance()) {
+      if (it.CurrentValue()->definition() == induction_) {
+        it.CurrentValue()->BindToEnvironment(vector_induction);
+      }
+    }
+  }
+  BinarySmiOpInstr* last_lane = NewIndexAdd(vector_induction, kLanes - 1);
+  cursor = flow_graph_->AppendTo(cursor, last_lane, nullptr, FlowGraph::kValue);
+  RelationalOpInstr* compare = new (zone)
+      RelationalOpInstr(branch_->token_pos(), Token::kLT,
+                        new (zone) Value(last_lane), new (zone) Value(limit_),
+                        kSmiCid, DeoptId::kNone);
+  BranchInstr* branch = new (zone) BranchInstr(compare, DeoptId::kNone);
+  branch->InheritDeoptTarget(zone, branch_);
+  flow_graph_->AppendTo(cursor, branch, nullptr, FlowGraph::kEffect);
+  vector_header->set_last_instruction(branch);
+  *branch->true_successor_address() = vector_body;
+  *branch->false_successor_address() = vector_exit_;
+
+  cursor = vector_body;
+  for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->IsGoto() || (current == increment_)) {
+      continue;
+    }
+    cursor = EmitVectorInstruction(current, vector_induction, cursor);
+  }
+  BinarySmiOpInstr* next = NewIndexAdd(vector_induction, kLanes);
+  cursor = flow_graph_->AppendTo(cursor, next, nullptr, FlowGraph::kValue);
+  GotoInstr* back_edge = NewGoto(vector_header);
+  flow_graph_->AppendTo(cursor, back_edge, nullptr, FlowGraph::kEffect);
+  vector_body->set_last_instruction(back_edge);
+  Value* next_use = new (zone) Value(next);
+  vector_induction->SetInputAt(1, next_use);
+  next->AddInputUse(next_use);
+
+  GotoInstr* exit = NewGoto(header_);
+  vector_exit_->AppendInstruction(exit);
+  vector_exit_->set_last_instruction(exit);
+
+  pre_header_->last_instruction()->AsGoto()->set_successor(vector_header);
+  induction_->InputAt(pre_header_index_)->BindTo(vector_induction);
+}
+
+void VectorizableLoop::UpdateInductionPhi() {
+  // Predecessors are sorted by block id, and the vector exit may have taken
+  // a different position than the pre-header it replaces.
+  if (header_->IndexOfPredecessor(vector_exit_) != pre_header_index_) {
+    Value* first = induction_->InputAt(0);
+    Value* second = induction_->InputAt(1);
+    induction_->SetInputAt(0, second);
+    induction_->SetInputAt(1, first);
+  }
+  ASSERT(induction_->InputAt(header_->IndexOfPredecessor(vector_exit_))
+             ->definition()
+             ->IsPhi());
+}
+
+#endif  // defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+
+void LoopVectorizer::Optimize(FlowGraph* flow_graph) {
+#if defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+  if (!FLAG_loop_vectorization ||
+      !FlowGraphCompiler::SupportsUnboxedSimd128()) {
+    return;
+  }
+
+  const LoopHierarchy& loop_hierarchy = flow_graph->GetLoopHierarchy();
+  const ZoneGrowableArray<BlockEntryInstr*>& loop_headers =
+      loop_hierarchy.headers();
+  loop_hierarchy.ComputeInduction();
+
+  // Analyze all loops before changing any of them, since the rewrite
+  // invalidates the loop information.
+  GrowableArray<VectorizableLoop*> loops;
+  for (intptr_t i = 0; i < loop_headers.length(); ++i) {
+    VectorizableLoop* loop = new (flow_graph->zone())
+        VectorizableLoop(flow_graph, loop_headers[i]->loop_info());
+    if (loop->Analyze()) {
+      loops.Add(loop);
+    }
+  }
+  if (loops.is_empty()) {
+    return;
+  }
+
+  for (intptr_t i = 0; i < loops.length(); ++i) {
+    if (FLAG_trace_loop_vectorization && flow_graph->should_print()) {
+      THR_Print("Vectorizing loop B%" Pd "\n", loops[i]->header()->block_id());
+    }
+    loops[i]->Vectorize();
+  }
+
+  flow_graph->DiscoverBlocks();
+  GrowableArray<BitVector*> dominance_frontier;
+  flow_graph->ComputeDominators(&dominance_frontier);
+  for (intptr_t i = 0; i < loops.length(); ++i) {
+    loops[i]->UpdateInductionPhi();
+  }
+#endif  // defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+}
+
+}  // namespace dart
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
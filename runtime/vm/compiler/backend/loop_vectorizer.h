@@ -0,0 +1,33 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+
+#include "vm/allocation.h"
+
+namespace dart {
+
+class FlowGraph;
+
+// Rewrites innermost counted loops of the form
+//
+//   for (int i = init; i < n; i++) {
+//     a[i] = b[i] op c[i];
+//   }
+//
+// over Float32List, Int32List and Uint32List into a loop that handles four
+// elements per iteration with SIMD instructions, followed by the original
+// loop which handles the remaining elements.
+//
+// Only loops whose bounds checks have already been eliminated or hoisted by
+// range analysis are rewritten, so the pass must run after it.
+class LoopVectorizer : public AllStatic {
+ public:
+  static void Optimize(FlowGraph* flow_graph);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
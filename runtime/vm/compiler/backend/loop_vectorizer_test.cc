@@ -0,0 +1,151 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/loop_vectorizer.h"
+
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/dart_entry.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+DECLARE_FLAG(bool, loop_vectorization);
+
+#if defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+
+static intptr_t CountSimdOps(FlowGraph* flow_graph) {
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (it.Current()->IsSimdOp()) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+// Warms up the test script, then compiles [name] with vectorization and
+// installs the result as its optimized code.
+static RawFunction* CompileVectorized(const char* script_chars,
+                                      const char* name) {
+  const auto& root_library = Library::Handle(LoadTestScript(script_chars));
+  Invoke(root_library, "main");
+
+  SetFlagScope<bool> sfs(&FLAG_loop_vectorization, true);
+  const auto& function = Function::Handle(GetFunction(root_library, name));
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  if (FlowGraphCompiler::SupportsUnboxedSimd128()) {
+    EXPECT(CountSimdOps(flow_graph) > 0);
+  }
+  pipeline.CompileGraphAndAttachFunction();
+  return function.raw();
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopVectorizer_Float32Add) {
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      void add(Float32List a, Float32List b, Float32List c) {
+        for (int i = 0; i < a.length; i++) {
+          a[i] = b[i] + c[i];
+        }
+      }
+
+      void main() {
+        final list = new Float32List(10);
+        for (int i = 0; i < 100; i++) {
+          add(list, list, list);
+        }
+      }
+      )";
+  const auto& function = Function::Handle(CompileVectorized(kScript, "add"));
+
+  // An odd length exercises the scalar loop after the vector loop.
+  const intptr_t kLength = 11;
+  const auto& a =
+      TypedData::Handle(TypedData::New(kTypedDataFloat32ArrayCid, kLength));
+  const auto& b =
+      TypedData::Handle(TypedData::New(kTypedDataFloat32ArrayCid, kLength));
+  const auto& c =
+      TypedData::Handle(TypedData::New(kTypedDataFloat32ArrayCid, kLength));
+  for (intptr_t i = 0; i < kLength; i++) {
+    b.SetFloat32(i * sizeof(float), 1.0f / (i + 1));
+    c.SetFloat32(i * sizeof(float), 3.0f * i + 0.1f);
+  }
+
+  const auto& arguments = Array::Handle(Array::New(3));
+  arguments.SetAt(0, a);
+  arguments.SetAt(1, b);
+  arguments.SetAt(2, c);
+  const auto& result =
+      Object::Handle(DartEntry::InvokeFunction(function, arguments));
+  EXPECT(result.IsNull());
+  EXPECT(function.HasOptimizedCode());
+
+  for (intptr_t i = 0; i < kLength; i++) {
+    const float expected = b.GetFloat32(i * sizeof(float)) +
+                           c.GetFloat32(i * sizeof(float));
+    EXPECT_EQ(expected, a.GetFloat32(i * sizeof(float)));
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopVectorizer_Int32AddWraps) {
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      void add(Int32List a, Int32List b, Int32List c) {
+        for (int i = 0; i < a.length; i++) {
+          a[i] = b[i] + c[i];
+        }
+      }
+
+      void main() {
+        final list = new Int32List(10);
+        for (int i = 0; i < 100; i++) {
+          add(list, list, list);
+        }
+      }
+      )";
+  const auto& function = Function::Handle(CompileVectorized(kScript, "add"));
+
+  const intptr_t kLength = 9;
+  const auto& a =
+      TypedData::Handle(TypedData::New(kTypedDataInt32ArrayCid, kLength));
+  const auto& b =
+      TypedData::Handle(TypedData::New(kTypedDataInt32ArrayCid, kLength));
+  const auto& c =
+      TypedData::Handle(TypedData::New(kTypedDataInt32ArrayCid, kLength));
+  for (intptr_t i = 0; i < kLength; i++) {
+    // The sums overflow 32 bits and must wrap around like the scalar stores.
+    b.SetInt32(i * sizeof(int32_t), kMaxInt32 - i);
+    c.SetInt32(i * sizeof(int32_t), i * 1000);
+  }
+
+  const auto& arguments = Array::Handle(Array::New(3));
+  arguments.SetAt(0, a);
+  arguments.SetAt(1, b);
+  arguments.SetAt(2, c);
+  const auto& result =
+      Object::Handle(DartEntry::InvokeFunction(function, arguments));
+  EXPECT(result.IsNull());
+
+  for (intptr_t i = 0; i < kLength; i++) {
+    const uint32_t sum =
+        static_cast<uint32_t>(b.GetInt32(i * sizeof(int32_t))) +
+        static_cast<uint32_t>(c.GetInt32(i * sizeof(int32_t)));
+    EXPECT_EQ(static_cast<int32_t>(sum), a.GetInt32(i * sizeof(int32_t)));
+  }
+}
+
+#endif  // defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+
+}  // namespace dart
@@ -518,4 +518,49 @@ ISOLATE_UNIT_TEST_CASE(SecondExitDown) {
   EXPECT_STREQ(expected, ComputeInduction(thread, script_chars));
 }
 
+//
+// Representation tests.
+//
+
+ISOLATE_UNIT_TEST_CASE(UnboxedInt64LoopPhi) {
+  // The hash overflows the Smi range, so its operations are specialized to
+  // int64 and the accumulator phi, which starts at a constant, is unboxed.
+  const char* script_chars =
+      R"(
+      foo(int n) {
+        int h = 17;
+        for (int i = 0; i < n; i++) {
+          h = h * 0x7fffffff + i;
+        }
+        return h;
+      }
+      main() {
+        foo(10);
+      }
+    )";
+  const auto& root_library = Library::Handle(LoadTestScript(script_chars));
+  Invoke(root_library, "main");
+
+  std::initializer_list<CompilerPass::Id> passes = {
+      CompilerPass::kComputeSSA,      CompilerPass::kTypePropagation,
+      CompilerPass::kApplyICData,     CompilerPass::kTypePropagation,
+      CompilerPass::kSelectRepresentations,
+  };
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses(passes);
+
+  const LoopHierarchy& hierarchy = flow_graph->GetLoopHierarchy();
+  EXPECT_EQ(1, hierarchy.num_loops());
+  JoinEntryInstr* header = hierarchy.headers()[0]->AsJoinEntry();
+  EXPECT(header != nullptr);
+  bool found_unboxed_phi = false;
+  for (PhiIterator it(header); !it.Done(); it.Advance()) {
+    if (it.Current()->representation() == kUnboxedInt64) {
+      found_unboxed_phi = true;
+    }
+  }
+  EXPECT(found_unboxed_phi);
+}
+
 }  // namespace dart
@@ -975,7 +975,7 @@ class BoundsCheckGeneralizer {
     value = UnwrapConstraint(value);
     if (value->IsPhi()) {
       PhiInstr* phi = value->AsPhi();
-      LoopInfo* loop = GetSmiBoundedLoop(phi);
+      LoopInfo* loop = phi->GetBlock()->loop_info();
       InductionVar* induc = GetSmiInduction(loop, phi);
       if (induc != nullptr) {
         return (this->*phi_bound_func)(phi, loop, induc, point);
@@ -1008,8 +1008,8 @@ class BoundsCheckGeneralizer {
                                           Instruction* point) {
     // Test if limit dominates given point.
     ConstraintInstr* limit = loop->limit();
-    if (!point->IsDominatedBy(limit)) {
-      return phi;
+    if (GetSmiBoundedLoop(phi) == nullptr || !point->IsDominatedBy(limit)) {
+      return InductionBoundsUpperBound(phi, loop, induc, point);
     }
     // Decide between direct or indirect bound.
     Definition* bounded_def = UnwrapConstraint(limit->value()->definition());
@@ -1044,6 +1044,41 @@ class BoundsCheckGeneralizer {
     }
   }
 
+  // Given a smi induction variable
+  //
+  //          x <- phi(x0, x + 1)
+  //
+  // and a strict bound x < U found by the induction variable analysis on
+  // a loop exit that dominates the given point we conclude that U - 1 is an
+  // upper bound for x. This covers constant limits and loops whose limit
+  // is not recorded as the constraint on x, e.g. loops with several exits.
+  Definition* InductionBoundsUpperBound(PhiInstr* phi,
+                                        LoopInfo* loop,
+                                        InductionVar* induc,
+                                        Instruction* point) {
+    if (!loop->Contains(point->GetBlock())) {
+      return phi;
+    }
+    for (auto bound : induc->bounds()) {
+      if (!point->IsDominatedBy(bound.branch_)) {
+        continue;
+      }
+      InductionVar* limit = bound.limit_;
+      const int64_t offset = limit->offset() - 1;
+      if (!compiler::target::IsSmi(offset)) {
+        continue;
+      }
+      if (limit->mult() == 0) {
+        return flow_graph_->GetConstant(Smi::ZoneHandle(Smi::New(offset)));
+      }
+      if (limit->mult() == 1 && limit->def()->Type()->ToCid() == kSmiCid) {
+        return (offset == 0) ? limit->def()
+                             : MakeBinaryOp(Token::kADD, limit->def(), offset);
+      }
+    }
+    return phi;
+  }
+
   Definition* InductionVariableLowerBound(PhiInstr* phi,
                                           LoopInfo* loop,
                                           InductionVar* induc,
@@ -1334,7 +1369,13 @@ void RangeAnalysis::EliminateRedundantBoundsChecks() {
       ASSERT(check != nullptr);
       RangeBoundary array_length =
           RangeBoundary::FromDefinition(check->length()->definition());
-      if (check->IsRedundant(array_length)) {
+      RangeBoundary original_length = RangeBoundary::FromDefinition(
+          check->length()
+              ->definition()
+              ->OriginalDefinitionIgnoreBoxingAndConstraints());
+      if (check->IsRedundant(array_length) ||
+          IsRedundantBasedOnInduction(check, check->index()->definition(),
+                                      original_length)) {
         check->ReplaceUsesWith(check->index()->definition());
         check->RemoveFromGraph();
       } else if (try_generalization) {
@@ -2644,6 +2685,7 @@ void LoadFieldInstr::InferRange(RangeAnalysis* analysis, Range* range) {
 
     case Slot::Kind::kDartField:
     case Slot::Kind::kCapturedVariable:
+    case Slot::Kind::kArrayElement:
       // Use default value.
       Definition::InferRange(analysis, range);
       break;
@@ -2996,13 +3038,27 @@ static bool IsSameBound(const RangeBoundary& a, InductionVar* b) {
   return false;
 }
 
-bool GenericCheckBoundInstr::IsRedundant(const RangeBoundary& length) {
+// Check if invariant is known to be non-negative.
+static bool IsNonNegative(InductionVar* x) {
+  ASSERT(InductionVar::IsInvariant(x));
+  int64_t c = 0;
+  if (InductionVar::IsConstant(x, &c)) {
+    return c >= 0;
+  }
+  // Only accept the definition itself, since an offset could wrap around.
+  return x->mult() == 1 && x->offset() == 0 && x->def()->range() != nullptr &&
+         RangeUtils::IsPositive(x->def()->range());
+}
+
+bool RangeAnalysis::IsRedundantBasedOnInduction(Instruction* check,
+                                                Definition* index,
+                                                const RangeBoundary& length) {
   // In loop, with index as induction?
-  LoopInfo* loop = GetBlock()->loop_info();
+  LoopInfo* loop = check->GetBlock()->loop_info();
   if (loop == nullptr) {
     return false;
   }
-  InductionVar* induc = loop->LookupInduction(index()->definition());
+  InductionVar* induc = loop->LookupInduction(index);
   if (induc == nullptr) {
     return false;
   }
@@ -3012,21 +3068,23 @@ bool GenericCheckBoundInstr::IsRedundant(const RangeBoundary& length) {
   //   for (int i = initial; i < length; i++)
   //     .... a[i] ....
   int64_t stride = 0;
-  int64_t initial = 0;
-  if (InductionVar::IsLinear(induc, &stride) &&
-      InductionVar::IsConstant(induc->initial(), &initial)) {
-    if (stride == 1 && initial >= 0) {
-      for (auto bound : induc->bounds()) {
-        if (IsSameBound(length, bound.limit_) &&
-            this->IsDominatedBy(bound.branch_)) {
-          return true;
-        }
+  if (InductionVar::IsLinear(induc, &stride) && stride == 1 &&
+      IsNonNegative(induc->initial())) {
+    for (auto bound : induc->bounds()) {
+      if (IsSameBound(length, bound.limit_) &&
+          check->IsDominatedBy(bound.branch_)) {
+        return true;
       }
     }
   }
   return false;
 }
 
+bool GenericCheckBoundInstr::IsRedundant(const RangeBoundary& length) {
+  return RangeAnalysis::IsRedundantBasedOnInduction(
+      this, index()->definition(), length);
+}
+
 }  // namespace dart
 
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
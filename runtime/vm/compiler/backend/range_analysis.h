@@ -546,6 +546,13 @@ class RangeAnalysis : public ValueObject {
 
   void AssignRangesRecursively(Definition* defn);
 
+  // Returns true if the given bounds check in a loop has an index that is a
+  // unit stride linear induction variable starting at a non-negative value,
+  // and a loop exit that tests the index against the length dominates it.
+  static bool IsRedundantBasedOnInduction(Instruction* check,
+                                          Definition* index,
+                                          const RangeBoundary& length);
+
  private:
   enum JoinOperator { NONE, WIDEN, NARROW };
   static char OpPrefix(JoinOperator op);
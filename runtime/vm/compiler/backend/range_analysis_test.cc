@@ -3,6 +3,10 @@
 // BSD-style license that can be found in the LICENSE file.
 
 #include "vm/compiler/backend/range_analysis.h"
+
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/dart_entry.h"
+#include "vm/object.h"
 #include "vm/unit_test.h"
 
 namespace dart {
@@ -639,4 +643,83 @@ TEST_CASE(RangeJoinMinMax) {
           .IsMaximumOrAbove(size));
 }
 
+#if !defined(TARGET_ARCH_DBC)
+
+// Verifies that a bounds check against a constant loop limit is replaced by
+// a single generalized check in the preheader, and that a failing hoisted
+// check deoptimizes into code that throws and no longer hoists.
+ISOLATE_UNIT_TEST_CASE(RangeAnalysis_HoistBoundsCheckWithConstantLimit) {
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      int sum(Int32List a) {
+        int s = 0;
+        for (int i = 0; i < 64; i++) {
+          s += a[i];
+        }
+        return s;
+      }
+
+      void main() {
+        final list = new Int32List(64);
+        for (int i = 0; i < 100; i++) {
+          sum(list);
+        }
+      }
+      )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+  const auto& function = Function::Handle(GetFunction(root_library, "sum"));
+  EXPECT(!function.ProhibitsBoundsCheckGeneralization());
+
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+
+  intptr_t checks_in_loop = 0;
+  intptr_t hoisted_checks = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    BlockEntryInstr* block = block_it.Current();
+    for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+      CheckArrayBoundInstr* check = it.Current()->AsCheckArrayBound();
+      if (check == nullptr) {
+        continue;
+      }
+      if (block->loop_info() != nullptr) {
+        checks_in_loop++;
+      } else if (check->generalized()) {
+        hoisted_checks++;
+      }
+    }
+  }
+  EXPECT_EQ(0, checks_in_loop);
+  EXPECT_EQ(1, hoisted_checks);
+
+  pipeline.CompileGraphAndAttachFunction();
+
+  const intptr_t kLength = 64;
+  auto& list =
+      TypedData::Handle(TypedData::New(kTypedDataInt32ArrayCid, kLength));
+  for (intptr_t i = 0; i < kLength; i++) {
+    list.SetInt32(i * sizeof(int32_t), i);
+  }
+  auto& arguments = Array::Handle(Array::New(1));
+  arguments.SetAt(0, list);
+  auto& result =
+      Object::Handle(DartEntry::InvokeFunction(function, arguments));
+  EXPECT(result.IsSmi());
+  EXPECT_EQ(kLength * (kLength - 1) / 2, Smi::Cast(result).Value());
+
+  // A shorter list fails the hoisted check.
+  list = TypedData::New(kTypedDataInt32ArrayCid, kLength / 2);
+  arguments.SetAt(0, list);
+  result = DartEntry::InvokeFunction(function, arguments);
+  EXPECT(result.IsUnhandledException());
+  EXPECT(function.ProhibitsBoundsCheckGeneralization());
+}
+
+#endif  // !defined(TARGET_ARCH_DBC)
+
 }  // namespace dart
@@ -7,6 +7,7 @@
 #include "vm/compiler/backend/redundancy_elimination.h"
 
 #include "vm/bit_vector.h"
+#include "vm/compiler/backend/call_effects.h"
 #include "vm/compiler/backend/flow_graph.h"
 #include "vm/compiler/backend/il.h"
 #include "vm/compiler/backend/il_printer.h"
@@ -22,6 +23,11 @@ DEFINE_FLAG(bool,
             trace_load_optimization,
             false,
             "Print live sets for load optimization pass.");
+DEFINE_FLAG(int,
+            max_trip_count_without_stack_check,
+            1000,
+            "Maximum trip count of a loop without calls whose stack "
+            "overflow check is removed.");
 
 // Quick access to the current zone.
 #define Z (zone())
@@ -1587,6 +1593,28 @@ class LoadOptimizer : public ValueObject {
 
   // Compute sets of loads generated and killed by each block.
   // Additionally compute upwards exposed and generated loads for each block.
+  // Kill places aliased by effects which correspond to one of the fields
+  // written according to the given summary.
+  void KillPlacesWrittenBy(const CallEffects& effects,
+                           BitVector* kill,
+                           BitVector* gen) {
+    for (BitVector::Iterator it(aliased_set_->aliased_by_effects());
+         !it.Done(); it.Advance()) {
+      const Place* place = aliased_set_->places()[it.Current()];
+      bool may_write = false;
+      if (place->kind() == Place::kStaticField) {
+        may_write = effects.MayWrite(place->static_field());
+      } else if ((place->kind() == Place::kInstanceField) &&
+                 place->instance_field().IsDartField()) {
+        may_write = effects.MayWrite(place->instance_field().field());
+      }
+      if (may_write) {
+        kill->Add(it.Current());
+        gen->Remove(it.Current());
+      }
+    }
+  }
+
   // Exposed loads are those that can be replaced if a corresponding
   // reaching load will be found.
   // Loads that are locally redundant will be replaced as we go through
@@ -1680,6 +1708,13 @@ class LoadOptimizer : public ValueObject {
 
         // If instruction has effects then kill all loads affected.
         if (instr->HasUnknownSideEffects()) {
+          const CallEffects* effects = CallEffects::Of(instr);
+          if (effects != nullptr) {
+            // The call is known to write only a few fields. Kill loads
+            // from just these fields.
+            KillPlacesWrittenBy(*effects, kill, gen);
+            continue;
+          }
           kill->AddAll(aliased_set_->aliased_by_effects());
           // There is no need to clear out_values when removing values from GEN
           // set because only those values that are in the GEN set
@@ -1739,6 +1774,42 @@ class LoadOptimizer : public ValueObject {
           continue;
         }
 
+        // Similarly elements of a freshly allocated array are null and its
+        // type arguments are known.
+        CreateArrayInstr* array_alloc = instr->AsCreateArray();
+        if (array_alloc != NULL) {
+          for (Value* use = array_alloc->input_use_list(); use != NULL;
+               use = use->next_use()) {
+            if (use->use_index() != 0) {
+              continue;
+            }
+
+            Definition* forward_def = NULL;
+            Definition* load = NULL;
+            if (LoadIndexedInstr* load_indexed =
+                    use->instruction()->AsLoadIndexed()) {
+              if ((load_indexed->class_id() == kArrayCid) &&
+                  load_indexed->index()->BindsToConstant()) {
+                forward_def = graph_->constant_null();
+                load = load_indexed;
+              }
+            } else if (LoadFieldInstr* load_field =
+                           use->instruction()->AsLoadField()) {
+              if (load_field->slot().IsTypeArguments()) {
+                forward_def = array_alloc->element_type()->definition();
+                load = load_field;
+              }
+            }
+
+            if (load != NULL) {
+              gen->Add(load->place_id());
+              if (out_values == NULL) out_values = CreateBlockOutValues();
+              (*out_values)[load->place_id()] = forward_def;
+            }
+          }
+          continue;
+        }
+
         if (!IsLoadEliminationCandidate(defn)) {
           continue;
         }
@@ -2679,10 +2750,51 @@ void DeadStoreElimination::Optimize(FlowGraph* graph) {
 // Allocation Sinking
 //
 
+// Arrays with more elements than this are not considered for allocation
+// sinking: materializing them would require too much deoptimization info.
+static const intptr_t kMaxAllocationSinkingNumElements = 32;
+
+// Returns the number of elements of the given array allocation if it is
+// a small constant, or -1 otherwise.
+static intptr_t SinkableArrayLength(CreateArrayInstr* alloc) {
+  if (!alloc->num_elements()->BindsToConstant()) {
+    return -1;
+  }
+  const Object& length = alloc->num_elements()->BoundConstant();
+  if (!length.IsSmi()) {
+    return -1;
+  }
+  const intptr_t num_elements = Smi::Cast(length).Value();
+  if ((num_elements < 0) ||
+      (num_elements > kMaxAllocationSinkingNumElements)) {
+    return -1;
+  }
+  return num_elements;
+}
+
 // Returns true if the given instruction is an allocation that
 // can be sunk by the Allocation Sinking pass.
 static bool IsSupportedAllocation(Instruction* instr) {
-  return instr->IsAllocateObject() || instr->IsAllocateUninitializedContext();
+  return instr->IsAllocateObject() || instr->IsAllocateUninitializedContext() ||
+         (instr->IsCreateArray() &&
+          (SinkableArrayLength(instr->AsCreateArray()) >= 0));
+}
+
+// Returns the index of the array element written by the given store into
+// a sinkable array allocation, or -1 if the store does not write a single
+// element at a known index.
+static intptr_t ConstantArrayStoreIndex(StoreIndexedInstr* store) {
+  CreateArrayInstr* alloc = store->array()->definition()->AsCreateArray();
+  if ((alloc == NULL) || (store->class_id() != kArrayCid) ||
+      !store->index()->BindsToConstant() ||
+      !store->index()->BoundConstant().IsSmi()) {
+    return -1;
+  }
+  const intptr_t index = Smi::Cast(store->index()->BoundConstant()).Value();
+  if ((index < 0) || (index >= SinkableArrayLength(alloc))) {
+    return -1;
+  }
+  return index;
 }
 
 enum SafeUseCheck { kOptimisticCheck, kStrictCheck };
@@ -2693,7 +2805,9 @@ enum SafeUseCheck { kOptimisticCheck, kStrictCheck };
 //     - any store into the allocation candidate itself is unconditionally safe
 //       as it just changes the rematerialization state of this candidate;
 //     - store into another object is only safe if another object is allocation
-//       candidate.
+//       candidate;
+//     - stores into an array candidate must write a single element at a
+//       constant index.
 //
 // We use a simple fix-point algorithm to discover the set of valid candidates
 // (see CollectCandidates method), that's why this IsSafeUse can operate in two
@@ -2723,12 +2837,28 @@ static bool IsSafeUse(Value* use, SafeUseCheck check_type) {
     return true;
   }
 
+  StoreIndexedInstr* store_indexed = use->instruction()->AsStoreIndexed();
+  if (store_indexed != NULL) {
+    if (use == store_indexed->value()) {
+      Definition* instance = store_indexed->array()->definition();
+      return IsSupportedAllocation(instance) &&
+             ((check_type == kOptimisticCheck) ||
+              instance->Identity().IsAllocationSinkingCandidate()) &&
+             (ConstantArrayStoreIndex(store_indexed) >= 0);
+    }
+    if (use == store_indexed->array()) {
+      return ConstantArrayStoreIndex(store_indexed) >= 0;
+    }
+    return false;
+  }
+
   return false;
 }
 
 // Right now we are attempting to sink allocation only into
 // deoptimization exit. So candidate should only be used in StoreInstanceField
-// instructions that write into fields of the allocated object.
+// and StoreIndexed instructions that write into fields or elements of the
+// allocated object.
 static bool IsAllocationSinkingCandidate(Definition* alloc,
                                          SafeUseCheck check_type) {
   for (Value* use = alloc->input_use_list(); use != NULL;
@@ -2753,6 +2883,11 @@ static Definition* StoreInto(Value* use) {
     return store->instance()->definition();
   }
 
+  StoreIndexedInstr* store_indexed = use->instruction()->AsStoreIndexed();
+  if (store_indexed != NULL) {
+    return store_indexed->array()->definition();
+  }
+
   return NULL;
 }
 
@@ -2878,9 +3013,9 @@ void AllocationSinking::RemoveUnusedMaterializations() {
       // candidate in the beginning so it is safe to assume that any encountered
       // load was inserted by CreateMaterializationAt.
       for (intptr_t i = 0; i < mat->InputCount(); i++) {
-        LoadFieldInstr* load = mat->InputAt(i)->definition()->AsLoadField();
-        if ((load != NULL) &&
-            (load->instance()->definition() == mat->allocation())) {
+        Definition* load = mat->InputAt(i)->definition();
+        if ((load->IsLoadField() || load->IsLoadIndexed()) &&
+            (load->InputAt(0)->definition() == mat->allocation())) {
           load->ReplaceUsesWith(flow_graph_->constant_null());
           load->RemoveFromGraph();
         }
@@ -2941,14 +3076,16 @@ void AllocationSinking::DiscoverFailedCandidates() {
       alloc->set_env_use_list(NULL);
       for (Value* use = alloc->input_use_list(); use != NULL;
            use = use->next_use()) {
-        if (use->instruction()->IsLoadField()) {
-          LoadFieldInstr* load = use->instruction()->AsLoadField();
+        if (use->instruction()->IsLoadField() ||
+            use->instruction()->IsLoadIndexed()) {
+          Definition* load = use->instruction()->AsDefinition();
           load->ReplaceUsesWith(flow_graph_->constant_null());
           load->RemoveFromGraph();
         } else {
           ASSERT(use->instruction()->IsMaterializeObject() ||
                  use->instruction()->IsPhi() ||
-                 use->instruction()->IsStoreInstanceField());
+                 use->instruction()->IsStoreInstanceField() ||
+                 use->instruction()->IsStoreIndexed());
         }
       }
     } else {
@@ -3104,10 +3241,25 @@ void AllocationSinking::CreateMaterializationAt(
   // instruction.
   Instruction* load_point = FirstMaterializationAt(exit);
 
-  // Insert load instruction for every field.
+  // Insert load instruction for every field. Array elements are loaded
+  // with LoadIndexed so that load forwarding can match them with the
+  // StoreIndexed instructions that initialized them.
   for (auto slot : slots) {
-    LoadFieldInstr* load =
-        new (Z) LoadFieldInstr(new (Z) Value(alloc), *slot, alloc->token_pos());
+    Definition* load = nullptr;
+    if (slot->IsArrayElement()) {
+      const intptr_t index =
+          (slot->offset_in_bytes() - compiler::target::Array::data_offset()) /
+          compiler::target::kWordSize;
+      load = new (Z) LoadIndexedInstr(
+          new (Z) Value(alloc),
+          new (Z) Value(flow_graph_->GetConstant(Smi::ZoneHandle(
+              Z, Smi::New(index)))),
+          compiler::target::kWordSize, kArrayCid, kAlignedAccess,
+          DeoptId::kNone, alloc->token_pos());
+    } else {
+      load = new (Z)
+          LoadFieldInstr(new (Z) Value(alloc), *slot, alloc->token_pos());
+    }
     flow_graph_->InsertBefore(load_point, load, nullptr, FlowGraph::kValue);
     values->Add(new (Z) Value(load));
   }
@@ -3116,6 +3268,9 @@ void AllocationSinking::CreateMaterializationAt(
   if (alloc->IsAllocateObject()) {
     mat = new (Z)
         MaterializeObjectInstr(alloc->AsAllocateObject(), slots, values);
+  } else if (alloc->IsCreateArray()) {
+    mat =
+        new (Z) MaterializeObjectInstr(alloc->AsCreateArray(), slots, values);
   } else {
     ASSERT(alloc->IsAllocateUninitializedContext());
     mat = new (Z) MaterializeObjectInstr(
@@ -3216,6 +3371,23 @@ void AllocationSinking::InsertMaterializations(Definition* alloc) {
     if ((store != NULL) && (store->instance()->definition() == alloc)) {
       AddSlot(slots, store->slot());
     }
+
+    StoreIndexedInstr* store_indexed = use->instruction()->AsStoreIndexed();
+    if ((store_indexed != NULL) &&
+        (store_indexed->array()->definition() == alloc)) {
+      const intptr_t index = ConstantArrayStoreIndex(store_indexed);
+      ASSERT(index >= 0);
+      AddSlot(slots,
+              Slot::GetArrayElementSlot(
+                  flow_graph_->thread(),
+                  compiler::target::Array::element_offset(index)));
+    }
+  }
+
+  if (alloc->IsCreateArray()) {
+    AddSlot(slots, Slot::GetTypeArgumentsSlotAt(
+                       flow_graph_->thread(),
+                       compiler::target::Array::type_arguments_offset()));
   }
 
   if (alloc->ArgumentCount() > 0) {
@@ -3641,7 +3813,81 @@ void DeadCodeElimination::RemoveDeadAndRedundantPhisFromTheGraph(
   }
 }
 
+// Returns true if the given innermost loop contains no calls and its header
+// exits after at most FLAG_max_trip_count_without_stack_check iterations,
+// which bounds the time between the interrupt checks around the loop.
+static bool IsBoundedLeafLoop(FlowGraph* graph, LoopInfo* loop) {
+  if (loop->inner() != nullptr) {
+    return false;
+  }
+
+  InductionVar* control = loop->control();
+  int64_t stride = 0;
+  int64_t begin = 0;
+  if ((control == nullptr) || !InductionVar::IsLinear(control, &stride) ||
+      !InductionVar::IsConstant(control->initial(), &begin)) {
+    return false;
+  }
+  bool is_bounded = false;
+  for (auto bound : control->bounds()) {
+    int64_t end = 0;
+    if ((bound.branch_->GetBlock() == loop->header()) &&
+        InductionVar::IsConstant(bound.limit_, &end) &&
+        ((end - begin) * stride <= FLAG_max_trip_count_without_stack_check)) {
+      is_bounded = true;
+      break;
+    }
+  }
+  if (!is_bounded) {
+    return false;
+  }
+
+  const GrowableArray<BlockEntryInstr*>& preorder = graph->preorder();
+  for (BitVector::Iterator block_it(loop->blocks()); !block_it.Done();
+       block_it.Advance()) {
+    BlockEntryInstr* block = preorder[block_it.Current()];
+    for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+      Instruction* current = it.Current();
+      if (current->IsBranch()) {
+        current = current->AsBranch()->comparison();
+      }
+      if (current->HasUnknownSideEffects()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void CheckStackOverflowElimination::EliminateInBoundedLoops(FlowGraph* graph) {
+  const LoopHierarchy& loop_hierarchy = graph->GetLoopHierarchy();
+  const ZoneGrowableArray<BlockEntryInstr*>& headers =
+      loop_hierarchy.headers();
+  if (headers.is_empty()) {
+    return;
+  }
+  loop_hierarchy.ComputeInduction();
+  for (intptr_t i = 0; i < headers.length(); i++) {
+    LoopInfo* loop = headers[i]->loop_info();
+    if (!IsBoundedLeafLoop(graph, loop)) {
+      continue;
+    }
+    const GrowableArray<BlockEntryInstr*>& preorder = graph->preorder();
+    for (BitVector::Iterator block_it(loop->blocks()); !block_it.Done();
+         block_it.Advance()) {
+      BlockEntryInstr* block = preorder[block_it.Current()];
+      for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+        if (it.Current()->IsCheckStackOverflow()) {
+          it.RemoveCurrentFromGraph();
+        }
+      }
+    }
+  }
+}
+
 void CheckStackOverflowElimination::EliminateStackOverflow(FlowGraph* graph) {
+  EliminateInBoundedLoops(graph);
+
   CheckStackOverflowInstr* first_stack_overflow_instr = NULL;
   for (BlockIterator block_it = graph->reverse_postorder_iterator();
        !block_it.Done(); block_it.Advance()) {
@@ -140,8 +140,13 @@ class LICM : public ValueObject {
 
 class CheckStackOverflowElimination : public AllStatic {
  public:
-  // For leaf functions with only a single [StackOverflowInstr] we remove it.
+  // Removes the [StackOverflowInstr]s of innermost loops without calls and
+  // with a small constant trip count. For leaf functions with only a single
+  // [StackOverflowInstr] left we remove it as well.
   static void EliminateStackOverflow(FlowGraph* graph);
+
+ private:
+  static void EliminateInBoundedLoops(FlowGraph* graph);
 };
 
 }  // namespace dart
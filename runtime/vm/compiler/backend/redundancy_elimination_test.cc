@@ -15,6 +15,7 @@
 #include "vm/compiler/compiler_pass.h"
 #include "vm/compiler/frontend/kernel_to_il.h"
 #include "vm/compiler/jit/jit_call_specializer.h"
+#include "vm/dart_entry.h"
 #include "vm/log.h"
 #include "vm/object.h"
 #include "vm/parser.h"
@@ -741,4 +742,98 @@ ISOLATE_UNIT_TEST_CASE(LoadOptimizer_AliasingViaLoadElimination_AcrossBlocks) {
   EXPECT(boxed_result->value()->definition() == final_load);
 }
 
+// This test verifies that a small fixed-length array which does not escape
+// is removed by allocation sinking and rematerialized on deoptimization.
+ISOLATE_UNIT_TEST_CASE(AllocationSinking_Arrays) {
+  const char* kScript = R"(
+    @pragma('vm:never-inline')
+    sum(a, b) {
+      final list = new List(2);
+      list[0] = a;
+      list[1] = b;
+      return list[0] + list[1];
+    }
+
+    main() {
+      for (var i = 0; i < 100; i++) {
+        sum(i, i);
+      }
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+  const auto& function = Function::Handle(GetFunction(root_library, "sum"));
+
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      EXPECT(!it.Current()->IsCreateArray());
+    }
+  }
+  pipeline.CompileGraphAndAttachFunction();
+
+  // Passing doubles deoptimizes the integer addition, which materializes
+  // the array.
+  const auto& arguments = Array::Handle(Array::New(2));
+  arguments.SetAt(0, Double::Handle(Double::New(1.5)));
+  arguments.SetAt(1, Double::Handle(Double::New(2.0)));
+  const auto& result =
+      Object::Handle(DartEntry::InvokeFunction(function, arguments));
+  EXPECT(result.IsDouble());
+  EXPECT_EQ(3.5, Double::Cast(result).value());
+}
+
+// This test verifies that the stack overflow check is removed from a short
+// counted loop without calls, but not from a long one.
+ISOLATE_UNIT_TEST_CASE(CheckStackOverflowElimination_BoundedLoop) {
+  const char* kScript = R"(
+    foo() {
+      int s = 0;
+      for (int i = 0; i < 100; i++) {
+        s = s ^ i;
+      }
+      for (int i = 0; i < 1000000; i++) {
+        s = s ^ i;
+      }
+      return s;
+    }
+
+    main() {
+      foo();
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+
+  Invoke(root_library, "main");
+
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({
+      CompilerPass::kComputeSSA,
+      CompilerPass::kApplyICData,
+      CompilerPass::kTypePropagation,
+      CompilerPass::kCanonicalize,
+      CompilerPass::kEliminateStackOverflowChecks,
+  });
+
+  intptr_t checks_in_loops = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      CheckStackOverflowInstr* check = it.Current()->AsCheckStackOverflow();
+      if ((check != nullptr) && check->in_loop()) {
+        checks_in_loops++;
+      }
+    }
+  }
+  EXPECT_EQ(1, checks_in_loops);
+}
+
 }  // namespace dart
@@ -122,6 +122,13 @@ const Slot& Slot::GetContextVariableSlotFor(Thread* thread,
       &variable.name(), /*static_type=*/nullptr));
 }
 
+const Slot& Slot::GetArrayElementSlot(Thread* thread,
+                                      intptr_t offset_in_bytes) {
+  return SlotCache::Instance(thread).Canonicalize(
+      Slot(Kind::kArrayElement, IsNullableBit::encode(true), kDynamicCid,
+           offset_in_bytes, ":array_element", /*static_type=*/nullptr));
+}
+
 const Slot& Slot::Get(const Field& field,
                       const ParsedFunction* parsed_function) {
   Thread* thread = Thread::Current();
@@ -158,7 +165,8 @@ const Slot& Slot::Get(const Field& field,
       Slot(Kind::kDartField,
            IsImmutableBit::encode(field.is_final() || field.is_const()) |
                IsNullableBit::encode(is_nullable) |
-               IsGuardedBit::encode(used_guarded_state),
+               IsGuardedBit::encode(used_guarded_state) |
+               IsUnboxedBit::encode(field.is_unboxed()),
            nullable_cid, compiler::target::Field::OffsetOf(field), &field,
            &AbstractType::ZoneHandle(zone, field.type())));
 
@@ -190,9 +198,17 @@ const Slot& Slot::Get(const Field& field,
 }
 
 CompileType Slot::ComputeCompileType() const {
+  if (is_unboxed() && (nullable_cid() == kDynamicCid)) {
+    return CompileType::Int();
+  }
   return CompileType::CreateNullable(is_nullable(), nullable_cid());
 }
 
+Representation Slot::UnboxedRepresentation() const {
+  ASSERT(is_unboxed());
+  return (nullable_cid() == kDoubleCid) ? kUnboxedDouble : kUnboxedInt64;
+}
+
 const AbstractType& Slot::static_type() const {
   return static_type_ != nullptr ? *static_type_ : Object::null_abstract_type();
 }
@@ -214,6 +230,7 @@ bool Slot::Equals(const Slot* other) const {
 
   switch (kind_) {
     case Kind::kTypeArguments:
+    case Kind::kArrayElement:
       return (offset_in_bytes_ == other->offset_in_bytes_);
 
     case Kind::kCapturedVariable:
@@ -25,6 +25,7 @@
 #define RUNTIME_VM_COMPILER_BACKEND_SLOT_H_
 
 #include "vm/compiler/backend/compile_type.h"
+#include "vm/compiler/backend/locations.h"
 #include "vm/thread.h"
 
 namespace dart {
@@ -97,6 +98,11 @@ class Slot : public ZoneAllocated {
     // local variable.
     kCapturedVariable,
 
+    // A slot within an Array object that contains the element at a constant
+    // index. Only used to describe the state of arrays removed by allocation
+    // sinking.
+    kArrayElement,
+
     // A slot that corresponds to a Dart field (has corresponding Field object).
     kDartField,
   };
@@ -119,6 +125,11 @@ class Slot : public ZoneAllocated {
   static const Slot& GetContextVariableSlotFor(Thread* thread,
                                                const LocalVariable& var);
 
+  // Returns a slot that represents the element of an Array object at the
+  // given offset.
+  static const Slot& GetArrayElementSlot(Thread* thread,
+                                         intptr_t offset_in_bytes);
+
   // Returns a slot that represents the given Dart field.
   static const Slot& Get(const Field& field,
                          const ParsedFunction* parsed_function);
@@ -135,6 +146,7 @@ class Slot : public ZoneAllocated {
   Kind kind() const { return kind_; }
   bool IsDartField() const { return kind() == Kind::kDartField; }
   bool IsLocalVariable() const { return kind() == Kind::kCapturedVariable; }
+  bool IsArrayElement() const { return kind() == Kind::kArrayElement; }
   bool IsTypeArguments() const { return kind() == Kind::kTypeArguments; }
 
   const char* Name() const;
@@ -150,6 +162,11 @@ class Slot : public ZoneAllocated {
   // of the corresponding Dart field.
   bool is_guarded_field() const { return IsGuardedBit::decode(flags_); }
 
+  // Returns true if the value of this slot is stored unboxed inside of the
+  // object, see Field::is_unboxed.
+  bool is_unboxed() const { return IsUnboxedBit::decode(flags_); }
+  Representation UnboxedRepresentation() const;
+
   // Static type of the slots if any.
   //
   // A value that is read from the slot is guaranteed to be assignable to its
@@ -195,6 +212,7 @@ class Slot : public ZoneAllocated {
   using IsImmutableBit = BitField<int8_t, bool, 0, 1>;
   using IsNullableBit = BitField<int8_t, bool, IsImmutableBit::kNextBit, 1>;
   using IsGuardedBit = BitField<int8_t, bool, IsNullableBit::kNextBit, 1>;
+  using IsUnboxedBit = BitField<int8_t, bool, IsGuardedBit::kNextBit, 1>;
 
   template <typename T>
   const T* DataAs() const {
@@ -204,7 +222,7 @@ class Slot : public ZoneAllocated {
   static const Slot& GetNativeSlot(Kind kind);
 
   const Kind kind_;
-  const int8_t flags_;  // is_immutable, is_nullable
+  const int8_t flags_;  // is_immutable, is_nullable, is_guarded, is_unboxed
   const int16_t cid_;   // Concrete cid of a value or kDynamicCid.
 
   const intptr_t offset_in_bytes_;
@@ -0,0 +1,119 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/write_barrier_elimination.h"
+
+#include "vm/bit_vector.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/il.h"
+
+namespace dart {
+
+// Returns the allocation the stored-into 'instance' refers to if it may be
+// tracked, or nullptr.
+static Definition* TrackedAllocation(Value* instance) {
+  Definition* defn = instance->definition()->OriginalDefinition();
+  AllocationInstr* alloc = defn->AsAllocation();
+  if ((alloc == nullptr) || !alloc->HasSSATemp() ||
+      !alloc->WillAllocateNewOrRemembered()) {
+    return nullptr;
+  }
+  return alloc;
+}
+
+// Applies the effect of the instructions of 'block' to 'available', the set
+// of allocations (by SSA temp index) which are known to be new or
+// remembered. If 'eliminate' is true, removes the barriers from the stores
+// into them.
+static void ProcessBlock(BlockEntryInstr* block,
+                         BitVector* available,
+                         bool eliminate) {
+  for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->CanTriggerGC()) {
+      available->Clear();
+    } else if (eliminate) {
+      if (StoreInstanceFieldInstr* store = current->AsStoreInstanceField()) {
+        Definition* alloc = TrackedAllocation(store->instance());
+        if ((alloc != nullptr) &&
+            available->Contains(alloc->ssa_temp_index())) {
+          store->set_emit_store_barrier(kNoStoreBarrier);
+        }
+      } else if (StoreIndexedInstr* store = current->AsStoreIndexed()) {
+        Definition* alloc = TrackedAllocation(store->array());
+        if ((alloc != nullptr) && (store->class_id() == kArrayCid) &&
+            available->Contains(alloc->ssa_temp_index())) {
+          store->set_emit_store_barrier(kNoStoreBarrier);
+        }
+      }
+    }
+
+    // The allocation itself can trigger GC, but its result is not affected.
+    if (AllocationInstr* alloc = current->AsAllocation()) {
+      if (alloc->HasSSATemp() && alloc->WillAllocateNewOrRemembered()) {
+        available->Add(alloc->ssa_temp_index());
+      }
+    }
+  }
+}
+
+// Sets 'available' to the allocations available on entry to 'block', which
+// are those available at the end of all its predecessors.
+static void ComputeAvailableIn(BlockEntryInstr* block,
+                               const GrowableArray<BitVector*>& available_out,
+                               BitVector* available) {
+  if (block->PredecessorCount() == 0) {
+    available->Clear();
+    return;
+  }
+  available->CopyFrom(
+      available_out[block->PredecessorAt(0)->preorder_number()]);
+  for (intptr_t i = 1; i < block->PredecessorCount(); i++) {
+    available->Intersect(
+        available_out[block->PredecessorAt(i)->preorder_number()]);
+  }
+}
+
+void WriteBarrierElimination::EliminateWriteBarriers(FlowGraph* flow_graph) {
+  Zone* zone = flow_graph->zone();
+  const intptr_t num_temps = flow_graph->current_ssa_temp_index();
+  if (num_temps == 0) return;
+  const GrowableArray<BlockEntryInstr*>& preorder = flow_graph->preorder();
+
+  // Allocations available at the end of each block, by preorder number.
+  // Everything starts out available, and the sets shrink to the greatest
+  // fixed point. Blocks without predecessors start with nothing available.
+  GrowableArray<BitVector*> available_out(preorder.length());
+  for (intptr_t i = 0; i < preorder.length(); i++) {
+    BitVector* out = new (zone) BitVector(zone, num_temps);
+    out->SetAll();
+    available_out.Add(out);
+  }
+
+  BitVector* available = new (zone) BitVector(zone, num_temps);
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+         !block_it.Done(); block_it.Advance()) {
+      BlockEntryInstr* block = block_it.Current();
+      ComputeAvailableIn(block, available_out, available);
+      ProcessBlock(block, available, /*eliminate=*/false);
+      BitVector* out = available_out[block->preorder_number()];
+      if (!out->Equals(*available)) {
+        out->CopyFrom(available);
+        changed = true;
+      }
+    }
+  }
+
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    BlockEntryInstr* block = block_it.Current();
+    ComputeAvailableIn(block, available_out, available);
+    ProcessBlock(block, available, /*eliminate=*/true);
+  }
+}
+
+}  // namespace dart
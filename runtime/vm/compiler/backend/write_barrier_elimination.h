@@ -0,0 +1,38 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_WRITE_BARRIER_ELIMINATION_H_
+#define RUNTIME_VM_COMPILER_BACKEND_WRITE_BARRIER_ELIMINATION_H_
+
+#include "vm/allocation.h"
+
+namespace dart {
+
+class FlowGraph;
+
+// Removes write barriers from stores into objects which are known to be in
+// new space or in the store buffer, such as
+//
+//   a = CreateArray(3)
+//   if (...) {
+//     StoreIndexed(a, 0, x)
+//   } else {
+//     StoreIndexed(a, 0, y)
+//   }
+//   StoreIndexed(a, 1, z)
+//
+// An allocation whose 'WillAllocateNewOrRemembered' holds produces such an
+// object, and it stays one until the next instruction which can trigger GC,
+// since a GC may promote it. A forward dataflow over the whole function
+// tracks the allocations which are available on every path to a store, so
+// the barriers are also removed across control flow and in loops which
+// have no GC points.
+class WriteBarrierElimination : public AllStatic {
+ public:
+  static void EliminateWriteBarriers(FlowGraph* flow_graph);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_WRITE_BARRIER_ELIMINATION_H_
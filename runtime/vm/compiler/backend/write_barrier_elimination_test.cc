@@ -0,0 +1,95 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/write_barrier_elimination.h"
+
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if !defined(TARGET_ARCH_DBC)
+
+static const char* kScript =
+    R"(
+    @pragma('vm:never-inline')
+    void opaque() {}
+
+    List<dynamic> diamond(bool flag, dynamic x, dynamic y) {
+      final list = new List<dynamic>(3);
+      if (flag) {
+        list[0] = x;
+      } else {
+        list[0] = y;
+      }
+      list[1] = x;
+      return list;
+    }
+
+    List<dynamic> call(dynamic x) {
+      final list = new List<dynamic>(2);
+      list[0] = x;
+      opaque();
+      list[1] = x;
+      return list;
+    }
+
+    void main() {
+      final x = new Object();
+      for (int i = 0; i < 100; i++) {
+        diamond(i.isEven, x, x);
+        call(x);
+      }
+    }
+    )";
+
+// Collects the stores into arrays in the optimized graph of 'name'.
+static void CollectArrayStores(const Library& root_library,
+                               const char* name,
+                               GrowableArray<StoreIndexedInstr*>* stores) {
+  const auto& function = Function::Handle(GetFunction(root_library, name));
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      StoreIndexedInstr* store = it.Current()->AsStoreIndexed();
+      if ((store != nullptr) && (store->class_id() == kArrayCid)) {
+        stores->Add(store);
+      }
+    }
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(WriteBarrierElimination_AcrossBlocks) {
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+
+  GrowableArray<StoreIndexedInstr*> stores;
+  CollectArrayStores(root_library, "diamond", &stores);
+  EXPECT_EQ(3, stores.length());
+  for (intptr_t i = 0; i < stores.length(); i++) {
+    EXPECT(!stores[i]->ShouldEmitStoreBarrier());
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(WriteBarrierElimination_AfterCall) {
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+
+  // The call can trigger GC, which may promote the array.
+  GrowableArray<StoreIndexedInstr*> stores;
+  CollectArrayStores(root_library, "call", &stores);
+  EXPECT_EQ(2, stores.length());
+  if (stores.length() == 2) {
+    EXPECT(!stores[0]->ShouldEmitStoreBarrier());
+    EXPECT(stores[1]->ShouldEmitStoreBarrier());
+  }
+}
+
+#endif  // !defined(TARGET_ARCH_DBC)
+
+}  // namespace dart
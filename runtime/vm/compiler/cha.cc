@@ -15,11 +15,29 @@ namespace dart {
 
 void CHA::AddToGuardedClasses(const Class& cls, intptr_t subclass_count) {
   for (intptr_t i = 0; i < guarded_classes_.length(); i++) {
-    if (guarded_classes_[i].cls->raw() == cls.raw()) {
+    if ((guarded_classes_[i].cls->raw() == cls.raw()) &&
+        (guarded_classes_[i].selector == NULL)) {
       return;
     }
   }
   GuardedClassInfo info = {&Class::ZoneHandle(thread_->zone(), cls.raw()),
+                           NULL, subclass_count};
+  guarded_classes_.Add(info);
+  return;
+}
+
+void CHA::AddToGuardedClasses(const Class& cls,
+                              const String& selector,
+                              intptr_t subclass_count) {
+  for (intptr_t i = 0; i < guarded_classes_.length(); i++) {
+    if ((guarded_classes_[i].cls->raw() == cls.raw()) &&
+        ((guarded_classes_[i].selector == NULL) ||
+         guarded_classes_[i].selector->Equals(selector))) {
+      return;
+    }
+  }
+  GuardedClassInfo info = {&Class::ZoneHandle(thread_->zone(), cls.raw()),
+                           &String::ZoneHandle(thread_->zone(), selector.raw()),
                            subclass_count};
   guarded_classes_.Add(info);
   return;
@@ -111,11 +129,38 @@ static intptr_t CountFinalizedSubclasses(Thread* thread, const Class& cls) {
   return count;
 }
 
+// Whether any finalized subclass of 'cls' declares 'selector'.
+static bool HasDeclaringSubclass(Thread* thread,
+                                 const Class& cls,
+                                 const String& selector) {
+  const GrowableObjectArray& cls_direct_subclasses =
+      GrowableObjectArray::Handle(thread->zone(), cls.direct_subclasses());
+  if (cls_direct_subclasses.IsNull()) return false;
+  Class& direct_subclass = Class::Handle(thread->zone());
+  for (intptr_t i = 0; i < cls_direct_subclasses.Length(); i++) {
+    direct_subclass ^= cls_direct_subclasses.At(i);
+    if (!direct_subclass.is_finalized()) {
+      continue;
+    }
+    if (direct_subclass.DeclaresSelector(selector) ||
+        HasDeclaringSubclass(thread, direct_subclass, selector)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool CHA::IsConsistentWithCurrentHierarchy() const {
   for (intptr_t i = 0; i < guarded_classes_.length(); i++) {
     const intptr_t subclass_count =
         CountFinalizedSubclasses(thread_, *guarded_classes_[i].cls);
-    if (guarded_classes_[i].subclass_count != subclass_count) {
+    if (guarded_classes_[i].subclass_count == subclass_count) {
+      continue;
+    }
+    // New subclasses only matter to a selector if they override it.
+    if ((guarded_classes_[i].selector == NULL) ||
+        HasDeclaringSubclass(thread_, *guarded_classes_[i].cls,
+                             *guarded_classes_[i].selector)) {
       return false;
     }
   }
@@ -168,7 +213,12 @@ bool CHA::HasOverride(const Class& cls,
 
 void CHA::RegisterDependencies(const Code& code) const {
   for (intptr_t i = 0; i < guarded_classes_.length(); ++i) {
-    guarded_classes_[i].cls->RegisterCHACode(code);
+    if (guarded_classes_[i].selector == NULL) {
+      guarded_classes_[i].cls->RegisterCHACode(code);
+    } else {
+      guarded_classes_[i].cls->RegisterCHACode(code,
+                                               *guarded_classes_[i].selector);
+    }
   }
 }
 
@@ -49,6 +49,13 @@ class CHA : public ValueObject {
   // libraries. Only classes that were used for CHA optimizations are added.
   void AddToGuardedClasses(const Class& cls, intptr_t subclass_count);
 
+  // Like AddToGuardedClasses, for code that only relies on no subclass of
+  // 'cls' overriding 'selector'. Subclasses that do not declare it do not
+  // cause deoptimization.
+  void AddToGuardedClasses(const Class& cls,
+                           const String& selector,
+                           intptr_t subclass_count);
+
   // When compiling in background we need to check that no new finalized
   // subclasses were added to guarded classes.
   bool IsConsistentWithCurrentHierarchy() const;
@@ -64,6 +71,10 @@ class CHA : public ValueObject {
   struct GuardedClassInfo {
     Class* cls;
 
+    // The selector that must not be overridden in subclasses of 'cls', or
+    // NULL if no subclass may be added.
+    String* selector;
+
     // Number of finalized subclasses that this class had at the moment
     // when CHA made the first decision based on this class.
     // Used to validate correctness of background compilation: if
@@ -97,4 +97,53 @@ TEST_CASE(ClassHierarchyAnalysis) {
   EXPECT(!cha.HasSubclasses(closure_class.id()));
 }
 
+TEST_CASE(ClassHierarchyAnalysis_DeclaresSelector) {
+  const char* kScriptChars =
+      "class A {"
+      "  foo() { }"
+      "  var x;"
+      "}\n"
+      "class B extends A {"
+      "  get foo => null;"
+      "}\n"
+      "class C extends A {"
+      "  bar() { }"
+      "}\n";
+
+  TestCase::LoadTestScript(kScriptChars, NULL);
+
+  TransitionNativeToVM transition(thread);
+  EXPECT(ClassFinalizer::ProcessPendingClasses());
+  const String& name = String::Handle(String::New(TestCase::url()));
+  const Library& lib = Library::Handle(Library::LookupLibrary(thread, name));
+  EXPECT(!lib.IsNull());
+
+  const Class& class_a =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+  EXPECT(!class_a.IsNull());
+  const Class& class_b =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "B"))));
+  EXPECT(!class_b.IsNull());
+  const Class& class_c =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "C"))));
+  EXPECT(!class_c.IsNull());
+
+  const String& foo = String::Handle(String::New("foo"));
+  const String& get_foo = String::Handle(String::New("get:foo"));
+  const String& set_x = String::Handle(String::New("set:x"));
+
+  // Members of a name are treated alike, whatever their kind.
+  EXPECT(class_a.DeclaresSelector(foo));
+  EXPECT(class_a.DeclaresSelector(set_x));
+  EXPECT(class_b.DeclaresSelector(foo));
+  EXPECT(class_b.DeclaresSelector(get_foo));
+  EXPECT(!class_b.DeclaresSelector(set_x));
+  EXPECT(!class_c.DeclaresSelector(foo));
+
+  CHA cha(thread);
+  cha.AddToGuardedClasses(class_c, foo, /*subclass_count=*/0);
+  EXPECT(cha.IsGuardedClass(class_c.id()));
+  EXPECT(cha.IsConsistentWithCurrentHierarchy());
+}
+
 }  // namespace dart
@@ -13,13 +13,18 @@
 #include "vm/compiler/backend/il_printer.h"
 #include "vm/compiler/backend/inliner.h"
 #include "vm/compiler/backend/linearscan.h"
+#include "vm/compiler/backend/loop_unroller.h"
+#include "vm/compiler/backend/loop_vectorizer.h"
 #include "vm/compiler/backend/range_analysis.h"
 #include "vm/compiler/backend/redundancy_elimination.h"
 #include "vm/compiler/backend/type_propagator.h"
+#include "vm/compiler/backend/write_barrier_elimination.h"
 #include "vm/compiler/call_specializer.h"
 #if defined(DART_PRECOMPILER)
 #include "vm/compiler/aot/aot_call_specializer.h"
 #endif
+#include "vm/json_stream.h"
+#include "vm/lockers.h"
 #include "vm/timeline.h"
 
 #define COMPILER_PASS_REPEAT(Name, Body)                                       \
@@ -175,7 +180,21 @@ void CompilerPass::Run(CompilerPassState* state) const {
     PrintGraph(state, kTraceBefore, round);
     {
       TIMELINE_DURATION(thread, CompilerVerbose, name());
+#if !defined(PRODUCT)
+      CompilerPassStats* stats = state->pass_stats;
+      const intptr_t instructions_before =
+          (stats != NULL) ? state->flow_graph->InstructionCount() : 0;
+      const int64_t start =
+          (stats != NULL) ? OS::GetCurrentMonotonicMicros() : 0;
+#endif
       repeat = DoBody(state);
+#if !defined(PRODUCT)
+      if (stats != NULL) {
+        const int64_t micros = OS::GetCurrentMonotonicMicros() - start;
+        stats->RecordPass(id(), micros, instructions_before,
+                          state->flow_graph->InstructionCount());
+      }
+#endif
       thread->CheckForSafepoint();
 #if defined(DEBUG)
       FlowGraphChecker(state->flow_graph).Check(name());
@@ -204,6 +223,45 @@ void CompilerPass::PrintGraph(CompilerPassState* state,
   }
 }
 
+#if !defined(PRODUCT)
+// Accounts a run of the top-level pipeline to the function being compiled
+// if the isolate collects compiler pass statistics.
+class CompilerPassStatsScope : public ValueObject {
+ public:
+  explicit CompilerPassStatsScope(CompilerPassState* state)
+      : state_(state), start_(0), instructions_before_(0) {
+    Isolate* isolate = state->thread->isolate();
+    CompilerPassStats* stats =
+        (isolate != NULL) ? isolate->compiler_pass_stats() : NULL;
+    if (stats == NULL) {
+      return;
+    }
+    state->pass_stats = stats;
+    instructions_before_ = state->flow_graph->InstructionCount();
+    start_ = OS::GetCurrentMonotonicMicros();
+  }
+
+  ~CompilerPassStatsScope() {
+    CompilerPassStats* stats = state_->pass_stats;
+    if (stats == NULL) {
+      return;
+    }
+    const int64_t micros = OS::GetCurrentMonotonicMicros() - start_;
+    FlowGraph* flow_graph = state_->flow_graph;
+    stats->RecordFunction(flow_graph->function(), micros, instructions_before_,
+                          flow_graph->InstructionCount());
+    state_->pass_stats = NULL;
+  }
+
+ private:
+  CompilerPassState* const state_;
+  int64_t start_;
+  intptr_t instructions_before_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompilerPassStatsScope);
+};
+#endif  // !defined(PRODUCT)
+
 #define INVOKE_PASS(Name)                                                      \
   CompilerPass::Get(CompilerPass::k##Name)->Run(pass_state);
 
@@ -227,6 +285,7 @@ void CompilerPass::RunInliningPipeline(PipelineMode mode,
 
 void CompilerPass::RunPipeline(PipelineMode mode,
                                CompilerPassState* pass_state) {
+  NOT_IN_PRODUCT(CompilerPassStatsScope stats_scope(pass_state));
   INVOKE_PASS(ComputeSSA);
 #if defined(DART_PRECOMPILER)
   if (mode == kAOT) {
@@ -272,6 +331,8 @@ void CompilerPass::RunPipeline(PipelineMode mode,
   INVOKE_PASS(TypePropagation);
   INVOKE_PASS(RangeAnalysis);
   INVOKE_PASS(OptimizeBranches);
+  INVOKE_PASS(UnrollLoops);
+  INVOKE_PASS(VectorizeLoops);
   INVOKE_PASS(TypePropagation);
   INVOKE_PASS(TryCatchOptimization);
   INVOKE_PASS(EliminateEnvironments);
@@ -294,6 +355,7 @@ void CompilerPass::RunPipeline(PipelineMode mode,
 void CompilerPass::RunPipelineWithPasses(
     CompilerPassState* state,
     std::initializer_list<CompilerPass::Id> passes) {
+  NOT_IN_PRODUCT(CompilerPassStatsScope stats_scope(state));
   for (auto pass_id : passes) {
     passes_[pass_id]->Run(state);
   }
@@ -392,6 +454,22 @@ COMPILER_PASS(OptimizeBranches, {
   ConstantPropagator::OptimizeBranches(flow_graph);
 });
 
+COMPILER_PASS(UnrollLoops, {
+  // Runs after range analysis, which removes or hoists the bounds checks
+  // inside the loops. Fold the induction variable into constants and
+  // eliminate redundancies across the unrolled iterations.
+  if (LoopUnroller::Optimize(flow_graph)) {
+    flow_graph->Canonicalize();
+    DominatorBasedCSE::Optimize(flow_graph);
+  }
+});
+
+COMPILER_PASS(VectorizeLoops, {
+  // Runs after range analysis, which removes the bounds checks that would
+  // otherwise prevent vectorization.
+  LoopVectorizer::Optimize(flow_graph);
+});
+
 COMPILER_PASS(OptimizeTypedDataAccesses,
               { TypedDataSpecializer::Optimize(flow_graph); });
 
@@ -444,38 +522,9 @@ COMPILER_PASS(ReorderBlocks, {
   }
 });
 
-static void WriteBarrierElimination(FlowGraph* flow_graph) {
-  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
-       !block_it.Done(); block_it.Advance()) {
-    BlockEntryInstr* block = block_it.Current();
-    Definition* last_allocated = nullptr;
-    for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
-      Instruction* current = it.Current();
-      if (!current->CanTriggerGC()) {
-        if (StoreInstanceFieldInstr* instr = current->AsStoreInstanceField()) {
-          if (instr->instance()->definition() == last_allocated) {
-            instr->set_emit_store_barrier(kNoStoreBarrier);
-          }
-          continue;
-        }
-      }
-
-      if (AllocationInstr* alloc = current->AsAllocation()) {
-        if (alloc->WillAllocateNewOrRemembered()) {
-          last_allocated = alloc;
-          continue;
-        }
-      }
-
-      if (current->CanTriggerGC()) {
-        last_allocated = nullptr;
-      }
-    }
-  }
-}
-
-COMPILER_PASS(WriteBarrierElimination,
-              { WriteBarrierElimination(flow_graph); });
+COMPILER_PASS(WriteBarrierElimination, {
+  WriteBarrierElimination::EliminateWriteBarriers(flow_graph);
+});
 
 COMPILER_PASS(FinalizeGraph, {
   // At the end of the pipeline, force recomputing and caching graph
@@ -492,6 +541,146 @@ COMPILER_PASS(FinalizeGraph, {
   flow_graph->RemoveRedefinitions();
 });
 
+#if !defined(PRODUCT)
+
+// Number of the most expensive functions reported by Print and PrintJSON.
+static const intptr_t kMaxPrintedFunctions = 20;
+static const intptr_t kMaxReportedFunctions = 100;
+
+CompilerPassStats::CompilerPassStats()
+    : mutex_("CompilerPassStats::mutex_") {
+  memset(passes_, 0, sizeof(passes_));
+}
+
+CompilerPassStats::~CompilerPassStats() {
+  auto it = functions_.GetIterator();
+  for (FunctionEntry** entry = it.Next(); entry != nullptr; entry = it.Next()) {
+    free((*entry)->name);
+    delete *entry;
+  }
+}
+
+void CompilerPassStats::RecordPass(CompilerPass::Id id,
+                                   int64_t micros,
+                                   intptr_t instructions_before,
+                                   intptr_t instructions_after) {
+  MutexLocker ml(&mutex_);
+  PassEntry* entry = &passes_[id];
+  entry->runs++;
+  entry->micros += micros;
+  entry->instructions_before += instructions_before;
+  entry->instructions_after += instructions_after;
+}
+
+void CompilerPassStats::RecordFunction(const Function& function,
+                                       int64_t micros,
+                                       intptr_t instructions_before,
+                                       intptr_t instructions_after) {
+  const char* name = function.ToQualifiedCString();
+  MutexLocker ml(&mutex_);
+  FunctionEntry** entry = functions_.Lookup(name);
+  if (entry == nullptr) {
+    functions_.Insert(new FunctionEntry{strdup(name), 1, micros,
+                                        instructions_before,
+                                        instructions_after});
+    return;
+  }
+  (*entry)->compilations++;
+  (*entry)->micros += micros;
+  (*entry)->instructions_before += instructions_before;
+  (*entry)->instructions_after += instructions_after;
+}
+
+int CompilerPassStats::CompareByMicros(FunctionEntry* const* a,
+                                       FunctionEntry* const* b) {
+  if ((*a)->micros != (*b)->micros) {
+    return (*a)->micros > (*b)->micros ? -1 : 1;
+  }
+  return strcmp((*a)->name, (*b)->name);
+}
+
+void CompilerPassStats::SortFunctions(
+    MallocGrowableArray<FunctionEntry*>* sorted) const {
+  auto it = functions_.GetIterator();
+  for (FunctionEntry** entry = it.Next(); entry != nullptr; entry = it.Next()) {
+    sorted->Add(*entry);
+  }
+  sorted->Sort(CompareByMicros);
+}
+
+void CompilerPassStats::Print() const {
+  MutexLocker ml(&mutex_);
+  int64_t total_micros = 0;
+  for (intptr_t i = 0; i < CompilerPass::kNumPasses; i++) {
+    total_micros += passes_[i].micros;
+  }
+  OS::PrintErr("Compiler passes took %" Pd64 " us in total:\n", total_micros);
+  OS::PrintErr("  %-40s %8s %12s %12s %12s\n", "pass", "runs", "micros",
+               "IL before", "IL after");
+  for (intptr_t i = 0; i < CompilerPass::kNumPasses; i++) {
+    const PassEntry& entry = passes_[i];
+    CompilerPass* pass = CompilerPass::Get(static_cast<CompilerPass::Id>(i));
+    if ((entry.runs == 0) || (pass == NULL)) {
+      continue;
+    }
+    OS::PrintErr("  %-40s %8" Pd " %12" Pd64 " %12" Pd64 " %12" Pd64 "\n",
+                 pass->name(), entry.runs, entry.micros,
+                 entry.instructions_before, entry.instructions_after);
+  }
+
+  MallocGrowableArray<FunctionEntry*> sorted(functions_.Length());
+  SortFunctions(&sorted);
+  OS::PrintErr("%" Pd " functions were compiled, the most expensive:\n",
+               sorted.length());
+  OS::PrintErr("  %8s %12s %12s %12s  %s\n", "count", "micros", "IL before",
+               "IL after", "function");
+  for (intptr_t i = 0; (i < sorted.length()) && (i < kMaxPrintedFunctions);
+       i++) {
+    const FunctionEntry* entry = sorted[i];
+    OS::PrintErr("  %8" Pd " %12" Pd64 " %12" Pd64 " %12" Pd64 "  %s\n",
+                 entry->compilations, entry->micros, entry->instructions_before,
+                 entry->instructions_after, entry->name);
+  }
+}
+
+void CompilerPassStats::PrintJSON(JSONStream* stream) const {
+  MutexLocker ml(&mutex_);
+  JSONObject obj(stream);
+  obj.AddProperty("type", "_CompilerPassStats");
+  {
+    JSONArray passes(&obj, "passes");
+    for (intptr_t i = 0; i < CompilerPass::kNumPasses; i++) {
+      const PassEntry& entry = passes_[i];
+      CompilerPass* pass = CompilerPass::Get(static_cast<CompilerPass::Id>(i));
+      if ((entry.runs == 0) || (pass == NULL)) {
+        continue;
+      }
+      JSONObject pass_obj(&passes);
+      pass_obj.AddProperty("name", pass->name());
+      pass_obj.AddProperty64("runs", entry.runs);
+      pass_obj.AddProperty64("micros", entry.micros);
+      pass_obj.AddProperty64("instructionsBefore", entry.instructions_before);
+      pass_obj.AddProperty64("instructionsAfter", entry.instructions_after);
+    }
+  }
+  MallocGrowableArray<FunctionEntry*> sorted(functions_.Length());
+  SortFunctions(&sorted);
+  obj.AddProperty64("functionCount", sorted.length());
+  JSONArray functions(&obj, "functions");
+  for (intptr_t i = 0; (i < sorted.length()) && (i < kMaxReportedFunctions);
+       i++) {
+    const FunctionEntry* entry = sorted[i];
+    JSONObject function(&functions);
+    function.AddProperty("name", entry->name);
+    function.AddProperty64("compilations", entry->compilations);
+    function.AddProperty64("micros", entry->micros);
+    function.AddProperty64("instructionsBefore", entry->instructions_before);
+    function.AddProperty64("instructionsAfter", entry->instructions_after);
+  }
+}
+
+#endif  // !defined(PRODUCT)
+
 }  // namespace dart
 
 #endif  // DART_PRECOMPILED_RUNTIME
@@ -10,6 +10,8 @@
 #include <initializer_list>
 
 #include "vm/growable_array.h"
+#include "vm/hash_map.h"
+#include "vm/os_thread.h"
 #include "vm/token_position.h"
 #include "vm/zone.h"
 
@@ -45,14 +47,18 @@ namespace dart {
   V(TryCatchOptimization)                                                      \
   V(TryOptimizePatterns)                                                       \
   V(TypePropagation)                                                           \
+  V(UnrollLoops)                                                               \
+  V(VectorizeLoops)                                                            \
   V(WidenSmiToInt32)                                                           \
   V(WriteBarrierElimination)
 
 class AllocationSinking;
 class BlockScheduler;
 class CallSpecializer;
+class CompilerPassStats;
 class FlowGraph;
 class Function;
+class JSONStream;
 class Precompiler;
 class SpeculativeInliningPolicy;
 class TimelineStream;
@@ -72,7 +78,8 @@ struct CompilerPassState {
         speculative_policy(speculative_policy),
         reorder_blocks(false),
         block_scheduler(NULL),
-        sticky_flags(0) {
+        sticky_flags(0),
+        pass_stats(NULL) {
   }
 
   Thread* const thread;
@@ -97,6 +104,11 @@ struct CompilerPassState {
   BlockScheduler* block_scheduler;
 
   intptr_t sticky_flags;
+
+  // Where passes run on this state account their time and IL size, or NULL.
+  // Only set for the top-level pipeline, so the passes run on graphs being
+  // inlined are accounted to the Inlining pass.
+  CompilerPassStats* pass_stats;
 };
 
 class CompilerPass {
@@ -111,7 +123,7 @@ class CompilerPass {
   static const intptr_t kNumPasses = 0 COMPILER_PASS_LIST(ADD_ONE);
 #undef ADD_ONE
 
-  CompilerPass(Id id, const char* name) : name_(name), flags_(0) {
+  CompilerPass(Id id, const char* name) : id_(id), name_(name), flags_(0) {
     ASSERT(passes_[id] == NULL);
     passes_[id] = this;
 
@@ -132,6 +144,7 @@ class CompilerPass {
 
   void Run(CompilerPassState* state) const;
 
+  Id id() const { return id_; }
   intptr_t flags() const { return flags_; }
   const char* name() const { return name_; }
 
@@ -173,10 +186,80 @@ class CompilerPass {
 
   static CompilerPass* passes_[];
 
+  const Id id_;
   const char* name_;
   intptr_t flags_;
 };
 
+#if !defined(PRODUCT)
+
+// Cumulative time and IL instruction counts of the compiler passes run in an
+// isolate, in total and per compiled function, for JIT and AOT compilation
+// (see --dump_compiler_pass_stats). Compiler threads record concurrently.
+class CompilerPassStats {
+ public:
+  CompilerPassStats();
+  ~CompilerPassStats();
+
+  void RecordPass(CompilerPass::Id id,
+                  int64_t micros,
+                  intptr_t instructions_before,
+                  intptr_t instructions_after);
+  void RecordFunction(const Function& function,
+                      int64_t micros,
+                      intptr_t instructions_before,
+                      intptr_t instructions_after);
+
+  // Prints the passes and the functions that took the most time.
+  void Print() const;
+  void PrintJSON(JSONStream* stream) const;
+
+ private:
+  struct PassEntry {
+    intptr_t runs;
+    int64_t micros;
+    int64_t instructions_before;
+    int64_t instructions_after;
+  };
+
+  struct FunctionEntry {
+    char* name;
+    intptr_t compilations;
+    int64_t micros;
+    int64_t instructions_before;
+    int64_t instructions_after;
+  };
+
+  class FunctionTrait {
+   public:
+    typedef FunctionEntry* Value;
+    typedef const char* Key;
+    typedef FunctionEntry* Pair;
+
+    static Key KeyOf(Pair kv) { return kv->name; }
+    static Value ValueOf(Pair kv) { return kv; }
+    static intptr_t Hashcode(Key key) {
+      return Utils::StringHash(key, strlen(key));
+    }
+    static bool IsKeyEqual(Pair kv, Key key) {
+      return strcmp(kv->name, key) == 0;
+    }
+  };
+
+  static int CompareByMicros(FunctionEntry* const* a, FunctionEntry* const* b);
+
+  // Returns the functions in order of decreasing time. Requires |mutex_|.
+  void SortFunctions(MallocGrowableArray<FunctionEntry*>* sorted) const;
+
+  mutable Mutex mutex_;
+  PassEntry passes_[CompilerPass::kNumPasses];
+  MallocDirectChainedHashMap<FunctionTrait> functions_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompilerPassStats);
+};
+
+#endif  // !defined(PRODUCT)
+
 }  // namespace dart
 
 #endif
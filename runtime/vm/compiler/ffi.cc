@@ -11,6 +11,7 @@
 #include "vm/compiler/runtime_api.h"
 #include "vm/growable_array.h"
 #include "vm/stack_frame.h"
+#include "vm/symbols.h"
 
 namespace dart {
 
@@ -95,6 +96,10 @@ bool NativeTypeIsVoid(const AbstractType& result_type) {
   return result_type.type_class_id() == kFfiVoidCid;
 }
 
+bool NativeTypeIsByValue(const AbstractType& type) {
+  return type.type_class_id() == kFfiByValueCid;
+}
+
 bool NativeTypeIsPointer(const AbstractType& result_type) {
   switch (result_type.type_class_id()) {
     case kFfiVoidCid:
@@ -109,6 +114,7 @@ bool NativeTypeIsPointer(const AbstractType& result_type) {
     case kFfiInt64Cid:
     case kFfiUint64Cid:
     case kFfiIntPtrCid:
+    case kFfiByValueCid:
       return false;
     case kFfiPointerCid:
     default:
@@ -116,6 +122,63 @@ bool NativeTypeIsPointer(const AbstractType& result_type) {
   }
 }
 
+const StructLayout* StructLayout::FromType(Zone* zone,
+                                           const AbstractType& struct_type) {
+  if (!struct_type.HasTypeClass()) {
+    return nullptr;
+  }
+  const Class& struct_class = Class::Handle(zone, struct_type.type_class());
+  Object& field_types = Object::Handle(zone);
+  if (!Library::FindPragma(Thread::Current(), /*only_core=*/false,
+                           struct_class, Symbols::vm_ffi_struct_fields(),
+                           &field_types) ||
+      !field_types.IsArray() || Array::Cast(field_types).Length() == 0) {
+    return nullptr;
+  }
+
+  StructLayout* layout = new (zone) StructLayout(zone);
+  Object& field_type = Object::Handle(zone);
+  intptr_t alignment = 1;
+  for (intptr_t i = 0; i < Array::Cast(field_types).Length(); i++) {
+    field_type = Array::Cast(field_types).At(i);
+    ASSERT(field_type.IsAbstractType());
+    const classid_t cid = AbstractType::Cast(field_type).type_class_id();
+    const intptr_t size = ElementSizeInBytes(cid);
+    layout->size_ = Utils::RoundUp(layout->size_, size);
+    layout->field_cids_.Add(cid);
+    layout->field_offsets_.Add(layout->size_);
+    layout->size_ += size;
+    alignment = Utils::Maximum(alignment, size);
+  }
+  layout->size_ = Utils::RoundUp(layout->size_, alignment);
+  return layout;
+}
+
+bool StructLayout::IsFloatingPointIn(intptr_t from, intptr_t to) const {
+  for (intptr_t i = 0; i < num_fields(); i++) {
+    const intptr_t offset = field_offsets_[i];
+    const intptr_t size = ElementSizeInBytes(field_cids_[i]);
+    if (offset < to && offset + size > from &&
+        !RawObject::IsFfiTypeDoubleClassId(field_cids_[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Representation StructLayout::HomogeneousFloatRepresentation() const {
+  const classid_t cid = field_cids_[0];
+  if (!RawObject::IsFfiTypeDoubleClassId(cid) || num_fields() > 4) {
+    return kNoRepresentation;
+  }
+  for (intptr_t i = 1; i < num_fields(); i++) {
+    if (field_cids_[i] != cid) {
+      return kNoRepresentation;
+    }
+  }
+  return cid == kFfiFloatCid ? kUnboxedFloat : kUnboxedDouble;
+}
+
 // Converts a Ffi [signature] to a list of Representations.
 // Note that this ignores first argument (receiver) which is dynamic.
 template <class CallingConventions>
@@ -221,6 +284,94 @@ class ArgumentAllocator : public ValueObject {
     }
   }
 
+#if !defined(TARGET_ARCH_DBC)
+  // Allocates the locations of the parts of a struct passed by value and adds
+  // them to [parts]. Returns false if the struct is passed by reference to a
+  // copy instead.
+  bool AllocateStruct(const StructLayout& layout,
+                      ZoneGrowableArray<StructPart>* parts) {
+    const intptr_t size = layout.size();
+#if defined(TARGET_ARCH_X64)
+    // Structs of up to two eightbytes are passed in registers, if there are
+    // enough left for all of them. Eightbytes which only contain floating-point
+    // fields go into XMM registers, the others into general purpose registers.
+    if (size <= 16) {
+      intptr_t num_fpu_regs = 0;
+      intptr_t num_cpu_regs = 0;
+      for (intptr_t offset = 0; offset < size; offset += 8) {
+        if (layout.IsFloatingPointIn(offset, offset + 8)) {
+          num_fpu_regs++;
+        } else {
+          num_cpu_regs++;
+        }
+      }
+      if (cpu_regs_used + num_cpu_regs <= CallingConventions::kNumArgRegs &&
+          fpu_regs_used + num_fpu_regs <= CallingConventions::kNumFpuArgRegs) {
+        for (intptr_t offset = 0; offset < size; offset += 8) {
+          const intptr_t part_size = Utils::Minimum<intptr_t>(8, size - offset);
+          if (layout.IsFloatingPointIn(offset, offset + 8)) {
+            parts->Add({offset, part_size,
+                        part_size == 4 ? kUnboxedFloat : kUnboxedDouble,
+                        AllocateFpuRegister()});
+          } else {
+            parts->Add({offset, part_size, kUnboxedInt64,
+                        AllocateCpuRegister()});
+          }
+        }
+        return true;
+      }
+    }
+#elif defined(TARGET_ARCH_ARM64)
+    // Homogeneous floating-point aggregates are passed in consecutive V
+    // registers, other structs of up to 16 bytes in consecutive R registers.
+    // If there are not enough registers left, no further arguments are passed
+    // in registers of that kind. Larger structs are passed by reference.
+    const Representation hfa_rep = layout.HomogeneousFloatRepresentation();
+    if (hfa_rep != kNoRepresentation) {
+      if (fpu_regs_used + layout.num_fields() <=
+          CallingConventions::kNumFpuArgRegs) {
+        for (intptr_t i = 0; i < layout.num_fields(); i++) {
+          parts->Add({layout.FieldOffsetAt(i),
+                      static_cast<intptr_t>(
+                          ElementSizeInBytes(layout.FieldCidAt(i))),
+                      hfa_rep, AllocateFpuRegister()});
+        }
+        return true;
+      }
+      fpu_regs_used = CallingConventions::kNumFpuArgRegs;
+    } else if (size <= 16) {
+      if (cpu_regs_used + Utils::RoundUp(size, 8) / 8 <=
+          CallingConventions::kNumArgRegs) {
+        for (intptr_t offset = 0; offset < size; offset += 8) {
+          const intptr_t part_size = Utils::Minimum<intptr_t>(8, size - offset);
+          parts->Add({offset, part_size, kUnboxedInt64, AllocateCpuRegister()});
+        }
+        return true;
+      }
+      cpu_regs_used = CallingConventions::kNumArgRegs;
+    } else {
+      return false;
+    }
+#else
+    UNREACHABLE();
+#endif
+    // The struct is copied to the stack.
+    for (intptr_t offset = 0; offset < size; offset += 8) {
+      const intptr_t part_size = Utils::Minimum<intptr_t>(8, size - offset);
+      parts->Add({offset, part_size, kUnboxedInt64, AllocateStackSlot()});
+    }
+    return true;
+  }
+
+  // Allocates [num_slots] consecutive stack slots and returns the index of
+  // the first one.
+  intptr_t AllocateStackSlots(intptr_t num_slots) {
+    const intptr_t first_slot = stack_height_in_slots;
+    stack_height_in_slots += num_slots;
+    return first_slot;
+  }
+#endif  // !defined(TARGET_ARCH_DBC)
+
  private:
   Location AllocateStackSlot() {
     return Location::StackSlot(stack_height_in_slots++,
@@ -401,6 +552,180 @@ ZoneGrowableArray<Location>* ArgumentLocations(
 #endif
 }
 
+#if !defined(TARGET_ARCH_DBC)
+
+// Adds the registers in which a struct result is returned to [parts]. Returns
+// the location in which the caller passes the address of the memory for the
+// result if the callee writes it there instead.
+template <class Allocator>
+static Location AllocateStructResult(const StructLayout& layout,
+                                     Allocator* frame_state,
+                                     ZoneGrowableArray<StructPart>* parts) {
+  const intptr_t size = layout.size();
+#if defined(TARGET_ARCH_X64)
+  // The eightbytes are classified like those of arguments, and returned in
+  // RAX and RDX or XMM0 and XMM1.
+  if (size <= 16) {
+    const Register cpu_regs[] = {RAX, RDX};
+    const FpuRegister fpu_regs[] = {XMM0, XMM1};
+    intptr_t cpu_regs_used = 0;
+    intptr_t fpu_regs_used = 0;
+    for (intptr_t offset = 0; offset < size; offset += 8) {
+      const intptr_t part_size = Utils::Minimum<intptr_t>(8, size - offset);
+      if (layout.IsFloatingPointIn(offset, offset + 8)) {
+        parts->Add(
+            {offset, part_size, part_size == 4 ? kUnboxedFloat : kUnboxedDouble,
+             Location::FpuRegisterLocation(fpu_regs[fpu_regs_used++])});
+      } else {
+        parts->Add({offset, part_size, kUnboxedInt64,
+                    Location::RegisterLocation(cpu_regs[cpu_regs_used++])});
+      }
+    }
+    return Location::NoLocation();
+  }
+  // The address of the memory is passed as the first argument.
+  return frame_state->AllocateArgument(kUnboxedFfiIntPtr);
+#elif defined(TARGET_ARCH_ARM64)
+  const Representation hfa_rep = layout.HomogeneousFloatRepresentation();
+  if (hfa_rep != kNoRepresentation) {
+    for (intptr_t i = 0; i < layout.num_fields(); i++) {
+      parts->Add({layout.FieldOffsetAt(i),
+                  static_cast<intptr_t>(
+                      ElementSizeInBytes(layout.FieldCidAt(i))),
+                  hfa_rep,
+                  Location::FpuRegisterLocation(static_cast<VRegister>(i))});
+    }
+    return Location::NoLocation();
+  }
+  if (size <= 16) {
+    for (intptr_t offset = 0; offset < size; offset += 8) {
+      const intptr_t part_size = Utils::Minimum<intptr_t>(8, size - offset);
+      parts->Add({offset, part_size, kUnboxedInt64,
+                  Location::RegisterLocation(
+                      static_cast<Register>(R0 + offset / 8))});
+    }
+    return Location::NoLocation();
+  }
+  // The address of the memory is passed in R8, the indirect result location
+  // register.
+  return Location::RegisterLocation(R8);
+#else
+  UNREACHABLE();
+  return Location::NoLocation();
+#endif
+}
+
+static const StructLayout* StructLayoutOf(Zone* zone,
+                                          const AbstractType& by_value_type) {
+  const TypeArguments& type_args =
+      TypeArguments::Handle(zone, by_value_type.arguments());
+  const StructLayout* layout = StructLayout::FromType(
+      zone, AbstractType::Handle(zone, type_args.TypeAt(0)));
+  ASSERT(layout != nullptr);
+  return layout;
+}
+
+StructCallingConvention::StructCallingConvention(Zone* zone)
+    : argument_representations_(
+          new (zone) ZoneGrowableArray<Representation>(zone, 8)),
+      argument_locations_(new (zone) ZoneGrowableArray<Location>(zone, 8)),
+      arguments_(zone, 8),
+      argument_parts_(zone, 8),
+      copies_(new (zone) ZoneGrowableArray<StructCopy>(zone, 0)),
+      result_parts_(new (zone) ZoneGrowableArray<StructPart>(zone, 2)),
+      result_address_location_(Location::NoLocation()) {}
+
+const StructCallingConvention* StructCallingConvention::FromSignature(
+    Zone* zone,
+    const Function& signature) {
+  const intptr_t num_arguments = signature.num_fixed_parameters() - 1;
+  AbstractType& type = AbstractType::Handle(zone, signature.result_type());
+  bool passes_structs = NativeTypeIsByValue(type);
+  for (intptr_t i = 0; i < num_arguments && !passes_structs; i++) {
+    type = signature.ParameterTypeAt(i + 1);
+    passes_structs = NativeTypeIsByValue(type);
+  }
+  if (!passes_structs) {
+    return nullptr;
+  }
+  ASSERT(kSupportsStructsByValue);
+
+  StructCallingConvention* convention =
+      new (zone) StructCallingConvention(zone);
+  ArgumentAllocator<dart::CallingConventions, Location, dart::Register,
+                    dart::FpuRegister>
+      frame_state;
+
+  // The address of the memory for the result may be passed as the first
+  // argument, so the result is allocated first.
+  type = signature.result_type();
+  if (NativeTypeIsByValue(type)) {
+    const StructLayout& layout = *StructLayoutOf(zone, type);
+    convention->result_size_ = layout.size();
+    convention->result_address_location_ =
+        AllocateStructResult(layout, &frame_state, convention->result_parts_);
+  }
+
+  GrowableArray<intptr_t> copied_arguments(zone, 0);
+  GrowableArray<const StructLayout*> copied_layouts(zone, 0);
+  for (intptr_t i = 0; i < num_arguments; i++) {
+    type = signature.ParameterTypeAt(i + 1);
+    if (!NativeTypeIsByValue(type)) {
+      const Representation rep = TypeRepresentation(type);
+      convention->AddArgument(i, rep, frame_state.AllocateArgument(rep),
+                              nullptr);
+      continue;
+    }
+    const StructLayout* layout = StructLayoutOf(zone, type);
+    auto* parts = new (zone) ZoneGrowableArray<StructPart>(zone, 2);
+    if (frame_state.AllocateStruct(*layout, parts)) {
+      for (intptr_t j = 0; j < parts->length(); j++) {
+        const StructPart* part = &parts->At(j);
+        convention->AddArgument(i, part->representation, part->location, part);
+      }
+    } else {
+      convention->copies_->Add(
+          {frame_state.AllocateArgument(kUnboxedFfiIntPtr), -1});
+      copied_arguments.Add(i);
+      copied_layouts.Add(layout);
+    }
+  }
+
+  // The copies are made above the stack arguments.
+  for (intptr_t i = 0; i < copied_arguments.length(); i++) {
+    const intptr_t size = copied_layouts[i]->size();
+    const intptr_t num_slots = Utils::RoundUp(size, 8) / 8;
+    const intptr_t first_slot = frame_state.AllocateStackSlots(num_slots);
+    (*convention->copies_)[i].stack_index = first_slot;
+    auto* parts = new (zone) ZoneGrowableArray<StructPart>(zone, num_slots);
+    for (intptr_t j = 0; j < num_slots; j++) {
+      const Location location = Location::StackSlot(
+          first_slot + j, CallingConventions::kStackPointerRegister);
+      parts->Add({j * 8, Utils::Minimum<intptr_t>(8, size - j * 8),
+                  kUnboxedInt64, location});
+    }
+    for (intptr_t j = 0; j < num_slots; j++) {
+      const StructPart* part = &parts->At(j);
+      convention->AddArgument(copied_arguments[i], part->representation,
+                              part->location, part);
+    }
+  }
+
+  return convention;
+}
+
+void StructCallingConvention::AddArgument(intptr_t argument,
+                                          Representation rep,
+                                          Location location,
+                                          const StructPart* part) {
+  argument_representations_->Add(rep);
+  argument_locations_->Add(location);
+  arguments_.Add(argument);
+  argument_parts_.Add(part);
+}
+
+#endif  // !defined(TARGET_ARCH_DBC)
+
 #if defined(TARGET_ARCH_DBC)
 ZoneGrowableArray<HostLocation>* HostArgumentLocations(
     const ZoneGrowableArray<Representation>& arg_reps) {
@@ -38,6 +38,136 @@ bool NativeTypeIsPointer(const AbstractType& result_type);
 // Whether a type is 'ffi.Void'.
 bool NativeTypeIsVoid(const AbstractType& result_type);
 
+// Whether a type is 'ffi.ByValue'.
+bool NativeTypeIsByValue(const AbstractType& type);
+
+// Structs can be passed and returned by value (see 'ffi.ByValue') with the
+// System V AMD64 and the AArch64 procedure call standard calling conventions.
+#if (defined(TARGET_ARCH_X64) && !defined(_WIN64)) || defined(TARGET_ARCH_ARM64)
+constexpr bool kSupportsStructsByValue = true;
+#else
+constexpr bool kSupportsStructsByValue = false;
+#endif
+
+// The layout of a struct (a class annotated with 'ffi.struct'). The kernel
+// transformation records the types of the fields in the 'vm:ffi:struct-fields'
+// pragma of the class, the fields are naturally aligned.
+class StructLayout : public ZoneAllocated {
+ public:
+  // Returns nullptr if [struct_type] is not a struct with at least one field.
+  static const StructLayout* FromType(Zone* zone,
+                                      const AbstractType& struct_type);
+
+  intptr_t size() const { return size_; }
+  intptr_t num_fields() const { return field_cids_.length(); }
+  classid_t FieldCidAt(intptr_t index) const { return field_cids_[index]; }
+  intptr_t FieldOffsetAt(intptr_t index) const {
+    return field_offsets_[index];
+  }
+
+  // Whether all fields which overlap the bytes [from, to) are floats or
+  // doubles.
+  bool IsFloatingPointIn(intptr_t from, intptr_t to) const;
+
+  // The representation of the fields if this is a homogeneous floating-point
+  // aggregate (1 to 4 fields which are all floats or all doubles), otherwise
+  // kNoRepresentation.
+  Representation HomogeneousFloatRepresentation() const;
+
+ private:
+  explicit StructLayout(Zone* zone)
+      : field_cids_(zone, 4), field_offsets_(zone, 4) {}
+
+  intptr_t size_ = 0;
+  GrowableArray<classid_t> field_cids_;
+  GrowableArray<intptr_t> field_offsets_;
+};
+
+// A part of a struct passed or returned by value: [size] bytes at [offset] in
+// the struct, which are passed or returned in [location] as a primitive value
+// with [representation].
+struct StructPart {
+  intptr_t offset;
+  intptr_t size;
+  Representation representation;
+  Location location;
+};
+
+// A struct argument which is passed by reference to a copy made by the caller.
+// The copy is made in the outgoing argument area, from stack slot
+// [stack_index] on; its address is passed in [location].
+struct StructCopy {
+  Location location;
+  intptr_t stack_index;
+};
+
+// The native calling convention of a C signature function which passes or
+// returns structs by value (see 'ffi.ByValue').
+//
+// Struct arguments are split into parts which the FFI trampoline loads from
+// the memory of the struct and passes like primitive arguments, so the native
+// arguments of 'FfiCallInstr' are all primitive. A struct result is either
+// returned in registers, which 'FfiCallInstr' stores to memory allocated by
+// the trampoline, or written by the callee to that memory.
+class StructCallingConvention : public ZoneAllocated {
+ public:
+  // Returns nullptr if [signature] neither takes nor returns structs by value.
+  // Only called if [kSupportsStructsByValue] and all structs in [signature]
+  // have a [StructLayout].
+  static const StructCallingConvention* FromSignature(
+      Zone* zone,
+      const Function& signature);
+
+  // Representations and locations of the native arguments.
+  const ZoneGrowableArray<Representation>& argument_representations() const {
+    return *argument_representations_;
+  }
+  const ZoneGrowableArray<Location>& argument_locations() const {
+    return *argument_locations_;
+  }
+
+  // The argument of the C signature function (not counting the receiver)
+  // which native argument [index] is taken from.
+  intptr_t ArgumentOf(intptr_t index) const { return arguments_[index]; }
+
+  // The part of a struct argument which is passed as native argument [index],
+  // or nullptr if native argument [index] is a primitive argument.
+  const StructPart* StructPartAt(intptr_t index) const {
+    return argument_parts_[index];
+  }
+
+  // Struct arguments which are passed by reference to a copy.
+  const ZoneGrowableArray<StructCopy>& copies() const { return *copies_; }
+
+  bool has_struct_result() const { return result_size_ != 0; }
+  intptr_t result_size() const { return result_size_; }
+
+  // The parts of a struct result which is returned in registers. Empty if the
+  // callee writes the result to the memory of which the caller passes the
+  // address in [result_address_location].
+  const ZoneGrowableArray<StructPart>& result_parts() const {
+    return *result_parts_;
+  }
+  Location result_address_location() const { return result_address_location_; }
+
+ private:
+  explicit StructCallingConvention(Zone* zone);
+
+  void AddArgument(intptr_t argument,
+                   Representation rep,
+                   Location location,
+                   const StructPart* part);
+
+  ZoneGrowableArray<Representation>* argument_representations_;
+  ZoneGrowableArray<Location>* argument_locations_;
+  GrowableArray<intptr_t> arguments_;
+  GrowableArray<const StructPart*> argument_parts_;
+  ZoneGrowableArray<StructCopy>* copies_;
+  intptr_t result_size_ = 0;
+  ZoneGrowableArray<StructPart>* result_parts_;
+  Location result_address_location_;
+};
+
 // Location for the result of a C signature function.
 Location ResultLocation(Representation result_rep);
 
@@ -806,22 +806,22 @@ void BytecodeFlowGraphBuilder::BuildInterfaceCallCommon(
   const String& name = String::ZoneHandle(Z, interface_target.name());
   ASSERT(name.IsSymbol());
 
-  const Array& arg_desc_array =
-      Array::Cast(ConstantAt(DecodeOperandD(), 1).value());
-  const ArgumentsDescriptor arg_desc(arg_desc_array);
+  // Inline cache of the call site, populated by the interpreter.
+  const ICData& icdata =
+      ICData::Cast(ConstantAt(DecodeOperandD(), 1).value());
+  ASSERT(ic_data_array_->At(icdata.deopt_id())->Original() == icdata.raw());
+
+  const ArgumentsDescriptor arg_desc(
+      Array::Handle(Z, icdata.arguments_descriptor()));
 
   const intptr_t argc = DecodeOperandF().value();
   Token::Kind token_kind = MethodTokenRecognizer::RecognizeTokenKind(name);
 
-  intptr_t checked_argument_count = 1;
   if (token_kind != Token::kILLEGAL) {
-    intptr_t argument_count = arg_desc.Count();
-    ASSERT(argument_count <= 2);
-    checked_argument_count = argument_count;
+    ASSERT(icdata.NumArgsTested() == arg_desc.Count());
   } else if (Library::IsPrivateCoreLibName(name,
                                            Symbols::_simpleInstanceOf())) {
-    ASSERT(arg_desc.Count() == 2);
-    checked_argument_count = 2;
+    ASSERT(icdata.NumArgsTested() == 2);
     token_kind = Token::kIS;
   } else if (Library::IsPrivateCoreLibName(name, Symbols::_instanceOf())) {
     token_kind = Token::kIS;
@@ -831,8 +831,11 @@ void BytecodeFlowGraphBuilder::BuildInterfaceCallCommon(
 
   InstanceCallInstr* call = new (Z) InstanceCallInstr(
       position_, name, token_kind, arguments, arg_desc.TypeArgsLen(),
-      Array::ZoneHandle(Z, arg_desc.GetArgumentNames()), checked_argument_count,
-      *ic_data_array_, B->GetNextDeoptId(), interface_target);
+      Array::ZoneHandle(Z, arg_desc.GetArgumentNames()), icdata.NumArgsTested(),
+      *ic_data_array_, icdata.deopt_id(), interface_target);
+
+  ASSERT(call->ic_data() != nullptr);
+  ASSERT(call->ic_data()->Original() == icdata.raw());
 
   // TODO(alexmarkov): add type info - call->SetResultType()
 
@@ -1674,6 +1677,26 @@ void BytecodeFlowGraphBuilder::BuildCompareIntLe() {
   BuildIntOp(Symbols::LessEqualOperator(), Token::kLTE, 2);
 }
 
+void BytecodeFlowGraphBuilder::BuildJumpIfNotIntGt() {
+  BuildCompareIntGt();
+  BuildJumpIfFalse();
+}
+
+void BytecodeFlowGraphBuilder::BuildJumpIfNotIntLt() {
+  BuildCompareIntLt();
+  BuildJumpIfFalse();
+}
+
+void BytecodeFlowGraphBuilder::BuildJumpIfNotIntGe() {
+  BuildCompareIntGe();
+  BuildJumpIfFalse();
+}
+
+void BytecodeFlowGraphBuilder::BuildJumpIfNotIntLe() {
+  BuildCompareIntLe();
+  BuildJumpIfFalse();
+}
+
 void BytecodeFlowGraphBuilder::BuildNegateDouble() {
   BuildDoubleOp(Symbols::UnaryMinus(), Token::kNEGATE, 1);
 }
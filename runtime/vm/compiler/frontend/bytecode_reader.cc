@@ -287,39 +287,14 @@ void BytecodeReaderHelper::ReadCode(const Function& function,
     }
   }
 
-  // Read closures.
+  // Most closures are never called, so their bytecode is only read when
+  // they are, see ReadClosureCode. Record where it is.
   if (has_closures) {
     Function& closure = Function::Handle(Z);
-    Bytecode& closure_bytecode = Bytecode::Handle(Z);
     for (intptr_t i = 0; i < num_closures; i++) {
       closure ^= closures_->At(i);
-
-      const intptr_t flags = reader_.ReadUInt();
-      const bool has_exceptions_table =
-          (flags & ClosureCode::kHasExceptionsTableFlag) != 0;
-      const bool has_source_positions =
-          (flags & ClosureCode::kHasSourcePositionsFlag) != 0;
-      const bool has_local_variables =
-          (flags & ClosureCode::kHasLocalVariablesFlag) != 0;
-
-      // Read closure bytecode and attach to closure function.
-      closure_bytecode = ReadBytecode(pool);
-      closure.AttachBytecode(closure_bytecode);
-      ASSERT(bytecode.GetBinary(Z) == reader_.typed_data()->raw());
-
-      ReadExceptionsTable(closure_bytecode, has_exceptions_table);
-
-      ReadSourcePositions(closure_bytecode, has_source_positions);
-
-      ReadLocalVariables(closure_bytecode, has_local_variables);
-
-      if (FLAG_dump_kernel_bytecode) {
-        KernelBytecodeDisassembler::Disassemble(closure);
-      }
-
-#if !defined(PRODUCT)
-      thread_->isolate()->debugger()->NotifyBytecodeLoaded(closure);
-#endif
+      closure.set_bytecode_offset(reader_.offset());
+      SkipClosureCode();
     }
   }
 
@@ -808,8 +783,28 @@ void BytecodeReaderHelper::ReadConstantPool(const Function& function,
         pool.SetObjectAt(i, elem);
         ++i;
         ASSERT(i < obj_count);
-        // The second entry is used for arguments descriptor.
-        obj = ReadObject();
+        // The second entry is used for the inline cache of the call site,
+        // which also holds arguments descriptor.
+        array ^= ReadObject();
+        name = Function::Cast(elem).name();
+        ASSERT(name.IsSymbol());
+        if (simpleInstanceOf == nullptr) {
+          simpleInstanceOf =
+              &Library::PrivateCoreLibName(Symbols::_simpleInstanceOf());
+        }
+        intptr_t checked_argument_count = 1;
+        if ((MethodTokenRecognizer::RecognizeTokenKind(name) !=
+             Token::kILLEGAL) ||
+            (name.raw() == simpleInstanceOf->raw())) {
+          intptr_t argument_count = ArgumentsDescriptor(array).Count();
+          ASSERT(argument_count <= 2);
+          checked_argument_count = argument_count;
+        }
+        obj =
+            ICData::New(function, name,
+                        array,  // Arguments descriptor.
+                        thread_->compiler_state().GetNextDeoptId(),
+                        checked_argument_count, ICData::RebindRule::kInstance);
       } break;
       default:
         UNREACHABLE();
@@ -820,6 +815,78 @@ void BytecodeReaderHelper::ReadConstantPool(const Function& function,
   }
 }
 
+void BytecodeReaderHelper::ReadClosureCode(const Function& closure,
+                                           intptr_t code_offset) {
+  ASSERT(Thread::Current()->IsMutatorThread());
+  ASSERT(closure.kind() == RawFunction::kClosureFunction);
+  ASSERT(code_offset > 0);
+
+  // Closures share the object pool of their outermost function.
+  const Function& outermost_function =
+      Function::Handle(Z, closure.GetOutermostFunction());
+  ASSERT(outermost_function.HasBytecode());
+  const ObjectPool& pool = ObjectPool::Handle(
+      Z, Bytecode::Handle(Z, outermost_function.bytecode()).object_pool());
+
+  AlternativeReadingScope alt(&reader_, code_offset);
+
+  const intptr_t flags = reader_.ReadUInt();
+  const bool has_exceptions_table =
+      (flags & ClosureCode::kHasExceptionsTableFlag) != 0;
+  const bool has_source_positions =
+      (flags & ClosureCode::kHasSourcePositionsFlag) != 0;
+  const bool has_local_variables =
+      (flags & ClosureCode::kHasLocalVariablesFlag) != 0;
+
+  // Read closure bytecode and attach to closure function.
+  const Bytecode& bytecode = Bytecode::Handle(Z, ReadBytecode(pool));
+  closure.AttachBytecode(bytecode);
+  ASSERT(bytecode.GetBinary(Z) == reader_.typed_data()->raw());
+
+  ReadExceptionsTable(bytecode, has_exceptions_table);
+
+  ReadSourcePositions(bytecode, has_source_positions);
+
+  ReadLocalVariables(bytecode, has_local_variables);
+
+  if (FLAG_dump_kernel_bytecode) {
+    KernelBytecodeDisassembler::Disassemble(closure);
+  }
+
+#if !defined(PRODUCT)
+  thread_->isolate()->debugger()->NotifyBytecodeLoaded(closure);
+#endif
+}
+
+void BytecodeReaderHelper::SkipClosureCode() {
+  const intptr_t flags = reader_.ReadUInt();
+
+  // Bytecode.
+  const intptr_t size = reader_.ReadUInt();
+  reader_.set_offset(reader_.offset() + size);
+
+  if ((flags & ClosureCode::kHasExceptionsTableFlag) != 0) {
+    const intptr_t try_block_count = reader_.ReadListLength();
+    for (intptr_t i = 0; i < try_block_count; i++) {
+      reader_.ReadUInt();  // Outer try index + 1.
+      reader_.ReadUInt();  // Start pc.
+      reader_.ReadUInt();  // End pc.
+      reader_.ReadUInt();  // Handler pc.
+      reader_.ReadByte();  // Flags.
+      const intptr_t type_count = reader_.ReadListLength();
+      for (intptr_t j = 0; j < type_count; j++) {
+        reader_.ReadUInt();
+      }
+    }
+  }
+  if ((flags & ClosureCode::kHasSourcePositionsFlag) != 0) {
+    reader_.ReadUInt();
+  }
+  if ((flags & ClosureCode::kHasLocalVariablesFlag) != 0) {
+    reader_.ReadUInt();
+  }
+}
+
 RawBytecode* BytecodeReaderHelper::ReadBytecode(const ObjectPool& pool) {
 #if defined(SUPPORT_TIMELINE)
   TIMELINE_DURATION(Thread::Current(), CompilerVerbose,
@@ -2529,10 +2596,12 @@ void BytecodeReaderHelper::ParseBytecodeFunction(
     case RawFunction::kRegularFunction:
     case RawFunction::kGetterFunction:
     case RawFunction::kSetterFunction:
-    case RawFunction::kClosureFunction:
     case RawFunction::kConstructor:
       ReadCode(function, function.bytecode_offset());
       break;
+    case RawFunction::kClosureFunction:
+      ReadClosureCode(function, function.bytecode_offset());
+      break;
     case RawFunction::kNoSuchMethodDispatcher:
     case RawFunction::kInvokeFieldDispatcher:
     case RawFunction::kSignatureFunction:
@@ -2942,7 +3011,11 @@ RawError* BytecodeReader::ReadFunctionBytecode(Thread* thread,
         BytecodeReaderHelper bytecode_reader(&translation_helper, &active_class,
                                              &bytecode_component);
 
-        bytecode_reader.ReadCode(function, code_offset);
+        if (function.kind() == RawFunction::kClosureFunction) {
+          bytecode_reader.ReadClosureCode(function, code_offset);
+        } else {
+          bytecode_reader.ReadCode(function, code_offset);
+        }
       }
     }
     return Error::null();
@@ -59,6 +59,10 @@ class BytecodeReaderHelper : public ValueObject {
 
   void ReadCode(const Function& function, intptr_t code_offset);
 
+  // Reads the bytecode of a closure declared in the code of its outermost
+  // function, which has already been read.
+  void ReadClosureCode(const Function& closure, intptr_t code_offset);
+
   RawArray* CreateForwarderChecks(const Function& function);
 
   void ReadMembers(const Class& cls, bool discard_fields);
@@ -185,6 +189,7 @@ class BytecodeReaderHelper : public ValueObject {
 
   void ReadConstantPool(const Function& function, const ObjectPool& pool);
   RawBytecode* ReadBytecode(const ObjectPool& pool);
+  void SkipClosureCode();
   void ReadExceptionsTable(const Bytecode& bytecode, bool has_exceptions_table);
   void ReadSourcePositions(const Bytecode& bytecode, bool has_source_positions);
   void ReadLocalVariables(const Bytecode& bytecode, bool has_local_variables);
@@ -1689,6 +1689,23 @@ Fragment StreamingFlowGraphBuilder::CheckStackOverflow(TokenPosition position) {
       flow_graph_builder_->loop_depth_);
 }
 
+Fragment StreamingFlowGraphBuilder::RecordBranchCoverage(
+    const Fragment& branch,
+    TokenPosition position) {
+  if (!FLAG_block_coverage || (branch.entry == nullptr)) {
+    return Fragment();
+  }
+  // Only the straight-line code at the start of the branch is searched.
+  for (Instruction* instr = branch.entry; instr != nullptr;
+       instr = instr->next()) {
+    if (instr->token_pos().IsReal()) {
+      position = instr->token_pos();
+      break;
+    }
+  }
+  return flow_graph_builder_->RecordCoverage(position);
+}
+
 Fragment StreamingFlowGraphBuilder::CloneContext(
     const GrowableArray<LocalVariable*>& context_variables) {
   return flow_graph_builder_->CloneContext(context_variables);
@@ -3333,16 +3350,24 @@ Fragment StreamingFlowGraphBuilder::BuildConditionalExpression(
   TestFragment condition = TranslateConditionForControl();  // read condition.
 
   Value* top = stack();
+  TokenPosition then_position = TokenPosition::kNoSource;
+  const Fragment then_value = BuildExpression(&then_position);  // read then.
   Fragment then_fragment(condition.CreateTrueSuccessor(flow_graph_builder_));
-  then_fragment += BuildExpression();  // read then.
+  then_fragment += RecordBranchCoverage(then_value, then_position);
+  then_fragment += then_value;
   then_fragment += StoreLocal(TokenPosition::kNoSource,
                               parsed_function()->expression_temp_var());
   then_fragment += Drop();
   ASSERT(stack() == top);
 
+  TokenPosition otherwise_position = TokenPosition::kNoSource;
+  const Fragment otherwise_value =
+      BuildExpression(&otherwise_position);  // read otherwise.
   Fragment otherwise_fragment(
       condition.CreateFalseSuccessor(flow_graph_builder_));
-  otherwise_fragment += BuildExpression();  // read otherwise.
+  otherwise_fragment +=
+      RecordBranchCoverage(otherwise_value, otherwise_position);
+  otherwise_fragment += otherwise_value;
   otherwise_fragment += StoreLocal(TokenPosition::kNoSource,
                                    parsed_function()->expression_temp_var());
   otherwise_fragment += Drop();
@@ -4035,6 +4060,7 @@ Fragment StreamingFlowGraphBuilder::BuildWhileStatement() {
   const Fragment body = BuildStatement();                   // read body
 
   Fragment body_entry(condition.CreateTrueSuccessor(flow_graph_builder_));
+  body_entry += RecordBranchCoverage(body, position);
   body_entry += body;
 
   Instruction* entry;
@@ -4122,8 +4148,10 @@ Fragment StreamingFlowGraphBuilder::BuildForStatement() {
     updates += Drop();
   }
 
+  const Fragment statement = BuildStatement();  // read body.
   Fragment body(body_entry);
-  body += BuildStatement();  // read body.
+  body += RecordBranchCoverage(statement, position);
+  body += statement;
 
   if (body.is_open()) {
     // We allocated a fresh context before the loop which contains captured
@@ -4197,6 +4225,7 @@ Fragment StreamingFlowGraphBuilder::BuildForInStatement(bool async) {
 
   Fragment body(body_entry);
   body += EnterScope(offset);
+  body += flow_graph_builder_->RecordCoverage(body_position);
   body += LoadLocal(iterator);
   body += PushArgument();
   const String& current_getter =
@@ -4255,14 +4284,18 @@ Fragment StreamingFlowGraphBuilder::BuildSwitchStatement() {
   for (intptr_t i = 0; i < case_count; ++i) {
     case_expression_offsets[i] = ReaderOffset();
     int expression_count = ReadListLength();  // read number of expressions.
+    TokenPosition case_position = TokenPosition::kNoSource;
     for (intptr_t j = 0; j < expression_count; ++j) {
-      ReadPosition();    // read jth position.
+      TokenPosition position = ReadPosition();  // read jth position.
+      if (j == 0) case_position = position;
       SkipExpression();  // read jth expression.
     }
     bool is_default = ReadBool();  // read is_default.
     if (is_default) default_case = i;
     Fragment& body_fragment = body_fragments[i] =
         BuildStatement();  // read body.
+    body_fragment =
+        RecordBranchCoverage(body_fragment, case_position) + body_fragment;
 
     if (body_fragment.entry == NULL) {
       // Make a NOP in order to ensure linking works properly.
@@ -4457,16 +4490,20 @@ Fragment StreamingFlowGraphBuilder::BuildContinueSwitchStatement() {
 }
 
 Fragment StreamingFlowGraphBuilder::BuildIfStatement() {
-  ReadPosition();  // read position.
+  const TokenPosition position = ReadPosition();  // read position.
 
   TestFragment condition = TranslateConditionForControl();
 
+  const Fragment then_body = BuildStatement();  // read then.
   Fragment then_fragment(condition.CreateTrueSuccessor(flow_graph_builder_));
-  then_fragment += BuildStatement();  // read then.
+  then_fragment += RecordBranchCoverage(then_body, position);
+  then_fragment += then_body;
 
+  const Fragment otherwise_body = BuildStatement();  // read otherwise.
   Fragment otherwise_fragment(
       condition.CreateFalseSuccessor(flow_graph_builder_));
-  otherwise_fragment += BuildStatement();  // read otherwise.
+  otherwise_fragment += RecordBranchCoverage(otherwise_body, position);
+  otherwise_fragment += otherwise_body;
 
   if (then_fragment.is_open()) {
     if (otherwise_fragment.is_open()) {
@@ -4565,6 +4602,7 @@ Fragment StreamingFlowGraphBuilder::BuildTryCatch() {
     }
 
     Fragment catch_handler_body = EnterScope(catch_offset);
+    catch_handler_body += flow_graph_builder_->RecordCoverage(position);
 
     tag = ReadTag();  // read first part of exception.
     if (tag == kSomething) {
@@ -224,6 +224,9 @@ class StreamingFlowGraphBuilder : public KernelReaderHelper {
   Fragment CreateArray();
   Fragment StoreIndexed(intptr_t class_id);
   Fragment CheckStackOverflow(TokenPosition position);
+  // Marks the code of a branch as reached, see --block_coverage. The branch is
+  // identified by its first source position, or by 'position' if it has none.
+  Fragment RecordBranchCoverage(const Fragment& branch, TokenPosition position);
   Fragment CloneContext(const GrowableArray<LocalVariable*>& context_variables);
   Fragment TranslateFinallyFinalizers(TryFinallyBlock* outer_finally,
                                       intptr_t target_context_depth);
@@ -53,6 +53,9 @@ FlowGraphBuilder::FlowGraphBuilder(
       parsed_function_(parsed_function),
       optimizing_(optimizing),
       ic_data_array_(*ic_data_array),
+      coverage_array_(Array::ZoneHandle(zone_)),
+      coverage_indices_(),
+      coverage_positions_(),
       next_function_id_(0),
       loop_depth_(0),
       try_depth_(0),
@@ -69,6 +72,16 @@ FlowGraphBuilder::FlowGraphBuilder(
   const Script& script =
       Script::Handle(Z, parsed_function->function().script());
   H.InitFromScript(script);
+
+  if (FLAG_block_coverage) {
+    coverage_array_ = parsed_function->function().GetCoverageArray();
+    if (!coverage_array_.IsNull()) {
+      for (intptr_t i = 0; i < coverage_array_.Length(); i += 2) {
+        coverage_indices_.Insert(
+            Smi::Value(Smi::RawCast(coverage_array_.At(i))), i + 1);
+      }
+    }
+  }
 }
 
 FlowGraphBuilder::~FlowGraphBuilder() {}
@@ -317,6 +330,44 @@ Fragment FlowGraphBuilder::CheckStackOverflowInPrologue(
   return BaseFlowGraphBuilder::CheckStackOverflowInPrologue(position);
 }
 
+Fragment FlowGraphBuilder::RecordCoverage(TokenPosition position) {
+  if (!FLAG_block_coverage || !position.IsReal()) {
+    return Fragment();
+  }
+  intptr_t index = coverage_indices_.Lookup(position.value());
+  if (index == 0) {
+    // Only unoptimized code adds positions. The array it saves is final.
+    if (optimizing_ || !coverage_array_.IsNull()) {
+      return Fragment();
+    }
+    index = 2 * coverage_positions_.length() + 1;
+    coverage_positions_.Add(position);
+    coverage_indices_.Insert(position.value(), index);
+  }
+  // The array is allocated once the graph is built, so this constant is
+  // filled in through its handle. Storing a Smi needs no barrier.
+  Fragment instructions;
+  instructions += Constant(coverage_array_);
+  instructions += IntConstant(index);
+  instructions += IntConstant(1);
+  instructions += StoreIndexed(kArrayCid);
+  return instructions;
+}
+
+void FlowGraphBuilder::FinalizeCoverageArray() {
+  if (!coverage_array_.IsNull() || coverage_positions_.is_empty()) {
+    return;
+  }
+  coverage_array_ = Array::New(2 * coverage_positions_.length(), Heap::kOld);
+  const Smi& zero = Smi::Handle(Z, Smi::New(0));
+  Smi& value = Smi::Handle(Z);
+  for (intptr_t i = 0; i < coverage_positions_.length(); i++) {
+    value = Smi::New(coverage_positions_[i].value());
+    coverage_array_.SetAt(2 * i, value);
+    coverage_array_.SetAt(2 * i + 1, zero);
+  }
+}
+
 Fragment FlowGraphBuilder::CloneContext(
     const GrowableArray<LocalVariable*>& context_variables) {
   LocalVariable* context_variable = parsed_function_->current_context_var();
@@ -389,13 +440,16 @@ Fragment FlowGraphBuilder::ClosureCall(TokenPosition position,
 
 Fragment FlowGraphBuilder::FfiCall(
     const Function& signature,
+    bool is_leaf,
     const ZoneGrowableArray<Representation>& arg_reps,
     const ZoneGrowableArray<Location>& arg_locs,
-    const ZoneGrowableArray<HostLocation>* arg_host_locs) {
+    const ZoneGrowableArray<HostLocation>* arg_host_locs,
+    const compiler::ffi::StructCallingConvention* structs) {
   Fragment body;
 
-  FfiCallInstr* const call = new (Z) FfiCallInstr(
-      Z, GetNextDeoptId(), signature, arg_reps, arg_locs, arg_host_locs);
+  FfiCallInstr* const call =
+      new (Z) FfiCallInstr(Z, GetNextDeoptId(), signature, is_leaf, arg_reps,
+                           arg_locs, arg_host_locs, structs);
 
   for (intptr_t i = call->InputCount() - 1; i >= 0; --i) {
     call->SetInputAt(i, Pop());
@@ -735,9 +789,192 @@ FlowGraph* FlowGraphBuilder::BuildGraph() {
   //  used for bytecode functions.
   StreamingFlowGraphBuilder streaming_flow_graph_builder(
       this, kernel_data, kernel_data_program_offset);
-  return streaming_flow_graph_builder.BuildGraph();
+  FlowGraph* flow_graph = streaming_flow_graph_builder.BuildGraph();
+  FinalizeCoverageArray();
+  flow_graph->set_coverage_array(coverage_array_);
+  return flow_graph;
 }
 
+#if !defined(TARGET_ARCH_DBC)
+// Returns the C signature with which a 'vm:ffi-native' function is called, or
+// null if [function] is not such a native or has a parameter or result type
+// which cannot be passed unwrapped. Parameter 0 of the signature is a dummy,
+// like the closure parameter of FFI trampolines.
+static RawFunction* FfiNativeCSignature(Thread* thread,
+                                        const Function& function) {
+  Zone* zone = thread->zone();
+  if (!function.is_static() || function.IsGeneric() ||
+      function.HasOptionalParameters()) {
+    return Function::null();
+  }
+  Object& options = Object::Handle(zone);
+  if (!Library::FindPragma(thread, /*only_core=*/false, function,
+                           Symbols::vm_ffi_native(), &options)) {
+    return Function::null();
+  }
+
+  ClassTable* class_table = thread->isolate()->class_table();
+  const Library& typed_data_lib =
+      Library::Handle(zone, Library::TypedDataLibrary());
+  const Type& typed_data_type = Type::Handle(
+      zone, Type::NewNonParameterizedType(Class::Handle(
+                zone, typed_data_lib.LookupClass(Symbols::TypedData()))));
+
+  const intptr_t num_params = function.NumParameters();
+  const Array& c_parameter_types =
+      Array::Handle(zone, Array::New(num_params + 1, Heap::kOld));
+  c_parameter_types.SetAt(0, Object::dynamic_type());
+  AbstractType& type = AbstractType::Handle(zone);
+  Class& c_type_class = Class::Handle(zone);
+  for (intptr_t i = 0; i < num_params; i++) {
+    type = function.ParameterTypeAt(i);
+    if (type.IsIntType()) {
+      c_type_class = class_table->At(kFfiInt64Cid);
+    } else if (type.IsDoubleType()) {
+      c_type_class = class_table->At(kFfiDoubleCid);
+    } else if (type.IsFinalized() &&
+               type.IsSubtypeOf(typed_data_type, Heap::kOld)) {
+      c_type_class = class_table->At(kFfiIntPtrCid);
+    } else {
+      return Function::null();
+    }
+    type = Type::NewNonParameterizedType(c_type_class);
+    c_parameter_types.SetAt(i + 1, type);
+  }
+
+  type = function.result_type();
+  if (type.IsIntType()) {
+    c_type_class = class_table->At(kFfiInt64Cid);
+  } else if (type.IsDoubleType()) {
+    c_type_class = class_table->At(kFfiDoubleCid);
+  } else if (type.IsVoidType()) {
+    c_type_class = class_table->At(kFfiVoidCid);
+  } else {
+    return Function::null();
+  }
+
+  const Class& owner = Class::Handle(zone, function.Owner());
+  const Function& c_signature = Function::Handle(
+      zone, Function::NewSignatureFunction(owner, Function::null_function(),
+                                           TokenPosition::kNoSource));
+  c_signature.set_result_type(
+      Type::Handle(zone, Type::NewNonParameterizedType(c_type_class)));
+  c_signature.set_num_fixed_parameters(num_params + 1);
+  c_signature.set_parameter_types(c_parameter_types);
+  return c_signature.raw();
+}
+
+// Resolves the C function of a 'vm:ffi-native' function through the
+// Dart_FfiNativeResolver of its library.
+static void* ResolveFfiNative(Zone* zone, const Function& function) {
+  const Library& library =
+      Library::Handle(zone, Class::Handle(zone, function.Owner()).library());
+  Dart_FfiNativeResolver resolver = library.ffi_native_resolver();
+  if (resolver == nullptr) {
+    return nullptr;
+  }
+  const String& name = String::Handle(zone, function.native_name());
+  return resolver(name.ToCString(), function.NumParameters());
+}
+
+// Calls the C function of a 'vm:ffi-native' function as a leaf FFI call. The
+// call cannot reach a safepoint, so the data of typed data arguments is passed
+// as an untagged pointer without copying it out of the heap.
+//
+// Only the VM's typed data classes have such data. If a typed data argument is
+// null or another implementation of a typed data interface, such as an
+// unmodifiable view, the native is called through its native entry instead.
+Fragment FlowGraphBuilder::FfiNativeFunctionBody(const Function& function,
+                                                 const Function& c_signature,
+                                                 void* address) {
+  InlineBailout("kernel::FlowGraphBuilder::FfiNativeFunctionBody");
+  const auto& arg_reps = *compiler::ffi::ArgumentRepresentations(c_signature);
+  const auto& arg_locs = *compiler::ffi::ArgumentLocations(arg_reps);
+  JoinEntryInstr* native_entry = nullptr;
+
+  Fragment body;
+  AbstractType& ffi_type = AbstractType::Handle(Z);
+  for (intptr_t i = 0; i < arg_reps.length(); i++) {
+    ffi_type = c_signature.ParameterTypeAt(i + 1);
+    if (ffi_type.type_class_id() != kFfiIntPtrCid) continue;
+    if (native_entry == nullptr) {
+      native_entry = BuildJoinEntry();
+    }
+    LocalVariable* parameter = parsed_function_->RawParameterVariable(i);
+    TargetEntryInstr* below;
+    TargetEntryInstr* not_below;
+    body += LoadLocal(parameter);
+    body += LoadClassId();
+    body += IntConstant(kTypedDataInt8ArrayCid);
+    body += SmiRelationalOp(Token::kLT);
+    body += BranchIfTrue(&below, &not_below);
+    Fragment not_typed_data_below(below);
+    not_typed_data_below += Goto(native_entry);
+
+    TargetEntryInstr* above;
+    TargetEntryInstr* typed_data;
+    body = Fragment(body.entry, not_below);
+    body += LoadLocal(parameter);
+    body += LoadClassId();
+    body += IntConstant(kByteDataViewCid);
+    body += SmiRelationalOp(Token::kGT);
+    body += BranchIfTrue(&above, &typed_data);
+    Fragment not_typed_data_above(above);
+    not_typed_data_above += Goto(native_entry);
+    body = Fragment(body.entry, typed_data);
+  }
+
+  for (intptr_t i = 0; i < arg_reps.length(); i++) {
+    LocalVariable* parameter = parsed_function_->RawParameterVariable(i);
+    ffi_type = c_signature.ParameterTypeAt(i + 1);
+    body += LoadLocal(parameter);
+    if (ffi_type.type_class_id() == kFfiIntPtrCid) {
+      body +=
+          LoadUntagged(compiler::target::TypedDataBase::data_field_offset());
+      body += ConvertUntaggedToIntptr();
+    } else {
+      body += FfiConvertArgumentToNative(function, ffi_type, arg_reps[i]);
+    }
+  }
+
+  body += Constant(Integer::ZoneHandle(
+      Z, Integer::New(reinterpret_cast<intptr_t>(address), Heap::kOld)));
+  body += UnboxTruncate(kUnboxedFfiIntPtr);
+  body += FfiCall(c_signature, /*is_leaf=*/true, arg_reps, arg_locs);
+
+  ffi_type = c_signature.result_type();
+  body += FfiConvertArgumentToDart(
+      ffi_type, compiler::ffi::ResultRepresentation(c_signature));
+  if (native_entry == nullptr) {
+    return body;
+  }
+
+  LocalVariable* result = parsed_function_->expression_temp_var();
+  JoinEntryInstr* join = BuildJoinEntry();
+  body += StoreLocal(TokenPosition::kNoSource, result);
+  body += Drop();
+  body += Goto(join);
+
+  Fragment call_native_entry(native_entry);
+  const String& name = String::ZoneHandle(Z, function.native_name());
+  for (intptr_t i = 0; i < function.NumParameters(); ++i) {
+    call_native_entry += LoadLocal(parsed_function_->RawParameterVariable(i));
+    call_native_entry += PushArgument();
+  }
+  call_native_entry += NativeCall(&name, &function);
+  call_native_entry += CheckAssignable(
+      AbstractType::Handle(Z, function.result_type()),
+      Symbols::FunctionResult());
+  call_native_entry += StoreLocal(TokenPosition::kNoSource, result);
+  call_native_entry += Drop();
+  call_native_entry += Goto(join);
+
+  body = Fragment(body.entry, join);
+  body += LoadLocal(result);
+  return body;
+}
+#endif  // !defined(TARGET_ARCH_DBC)
+
 Fragment FlowGraphBuilder::NativeFunctionBody(const Function& function,
                                               LocalVariable* first_parameter) {
   ASSERT(function.is_native());
@@ -987,6 +1224,22 @@ Fragment FlowGraphBuilder::NativeFunctionBody(const Function& function,
       body += NullConstant();
       break;
     default: {
+#if !defined(TARGET_ARCH_DBC)
+      // The C function address is only known in the running process, so
+      // AOT snapshots keep calling these natives through their native entry
+      // and JIT snapshots drop their code (see DropFfiNativeCode).
+      if (!FLAG_precompiled_mode) {
+        const Function& c_signature = Function::ZoneHandle(
+            Z, FfiNativeCSignature(thread_, function));
+        void* address = c_signature.IsNull()
+                            ? nullptr
+                            : ResolveFfiNative(Z, function);
+        if (address != nullptr) {
+          body += FfiNativeFunctionBody(function, c_signature, address);
+          break;
+        }
+      }
+#endif  // !defined(TARGET_ARCH_DBC)
       String& name = String::ZoneHandle(Z, function.native_name());
       if (function.IsGeneric()) {
         body += LoadLocal(parsed_function_->RawTypeArgumentsVariable());
@@ -2541,6 +2794,106 @@ Fragment FlowGraphBuilder::BitCast(Representation from, Representation to) {
   return Fragment(instr);
 }
 
+Fragment FlowGraphBuilder::FfiLoadStructPart(
+    LocalVariable* address,
+    const compiler::ffi::StructPart& part) {
+  Fragment body;
+  if (part.representation == kUnboxedInt64) {
+    body += FfiLoadStructBytes(address, part.offset, part.size);
+    return body;
+  }
+  ASSERT(part.representation == kUnboxedFloat ||
+         part.representation == kUnboxedDouble);
+  const classid_t cid = part.size == 4 ? kTypedDataFloat32ArrayCid
+                                       : kTypedDataFloat64ArrayCid;
+  body += LoadLocal(address);
+  body += UnboxTruncate(kUnboxedFfiIntPtr);
+  body += ConvertIntptrToUntagged();
+  body += IntConstant(part.offset);
+  Value* index = Pop();
+  Value* array = Pop();
+  LoadIndexedInstr* load = new (Z)
+      LoadIndexedInstr(array, index, /*index_scale=*/1, cid, kUnalignedAccess,
+                       DeoptId::kNone, TokenPosition::kNoSource);
+  Push(load);
+  body <<= load;
+  if (part.representation == kUnboxedFloat) {
+    auto* to_float = new (Z) DoubleToFloatInstr(Pop(), DeoptId::kNone);
+    Push(to_float);
+    body <<= to_float;
+  }
+  return body;
+}
+
+Fragment FlowGraphBuilder::FfiLoadStructBytes(LocalVariable* address,
+                                              intptr_t offset,
+                                              intptr_t size) {
+  Fragment body;
+  if (size != 1 && size != 2 && size != 4 && size != 8) {
+    // Combine the lower bytes with the remaining bytes shifted above them.
+    const intptr_t low_size = size > 4 ? 4 : 2;
+    body += FfiLoadStructBytes(address, offset, low_size);
+    body += FfiLoadStructBytes(address, offset + low_size, size - low_size);
+    body += IntConstant(low_size * kBitsPerByte);
+    body += UnboxTruncate(kUnboxedInt64);
+    Value* shift = Pop();
+    Value* high = Pop();
+    BinaryIntegerOpInstr* shl = BinaryIntegerOpInstr::Make(
+        kUnboxedInt64, Token::kSHL, high, shift, DeoptId::kNone,
+        /*can_overflow=*/false, /*is_truncating=*/true, /*range=*/nullptr,
+        Instruction::kNotSpeculative);
+    Push(shl);
+    body <<= shl;
+    Value* right = Pop();
+    Value* left = Pop();
+    BinaryIntegerOpInstr* bit_or = BinaryIntegerOpInstr::Make(
+        kUnboxedInt64, Token::kBIT_OR, left, right, DeoptId::kNone,
+        /*can_overflow=*/false, /*is_truncating=*/false, /*range=*/nullptr,
+        Instruction::kNotSpeculative);
+    Push(bit_or);
+    body <<= bit_or;
+    return body;
+  }
+
+  classid_t cid;
+  switch (size) {
+    case 1:
+      cid = kTypedDataUint8ArrayCid;
+      break;
+    case 2:
+      cid = kTypedDataUint16ArrayCid;
+      break;
+    case 4:
+      cid = kTypedDataUint32ArrayCid;
+      break;
+    default:
+      cid = kTypedDataInt64ArrayCid;
+      break;
+  }
+  body += LoadLocal(address);
+  body += UnboxTruncate(kUnboxedFfiIntPtr);
+  body += ConvertIntptrToUntagged();
+  body += IntConstant(offset);
+  Value* index = Pop();
+  Value* array = Pop();
+  LoadIndexedInstr* load = new (Z)
+      LoadIndexedInstr(array, index, /*index_scale=*/1, cid, kUnalignedAccess,
+                       DeoptId::kNone, TokenPosition::kNoSource);
+  Push(load);
+  body <<= load;
+  if (size == 4) {
+    // Loads of 'Uint32' produce unboxed uint32 values.
+    auto* extend = new (Z) IntConverterInstr(kUnboxedUint32, kUnboxedInt64,
+                                             Pop(), DeoptId::kNone);
+    Push(extend);
+    body <<= extend;
+  } else if (size < 4) {
+    // Loads of 'Uint8' and 'Uint16' produce Smis.
+    body += UnboxTruncate(kUnboxedInt64);
+  }
+  return body;
+}
+
 Fragment FlowGraphBuilder::FfiConvertArgumentToDart(
     const AbstractType& ffi_type,
     const Representation native_representation) {
@@ -2548,6 +2901,14 @@ Fragment FlowGraphBuilder::FfiConvertArgumentToDart(
   if (compiler::ffi::NativeTypeIsPointer(ffi_type)) {
     body += Box(kUnboxedFfiIntPtr);
     body += FfiPointerFromAddress(Type::Cast(ffi_type));
+  } else if (compiler::ffi::NativeTypeIsByValue(ffi_type)) {
+    // Structs are returned in memory, which is wrapped in the struct class.
+    const TypeArguments& args =
+        TypeArguments::Handle(Z, Type::Cast(ffi_type).arguments());
+    body += Box(kUnboxedFfiIntPtr);
+    body += FfiPointerFromAddress(
+        Type::ZoneHandle(Z, Type::Cast(AbstractType::Handle(Z, args.TypeAt(0)))
+                                .raw()));
   } else if (compiler::ffi::NativeTypeIsVoid(ffi_type)) {
     body += Drop();
     body += NullConstant();
@@ -2620,23 +2981,79 @@ FlowGraph* FlowGraphBuilder::BuildGraphOfFfiNative(const Function& function) {
 
   const Function& signature = Function::ZoneHandle(Z, function.FfiCSignature());
 #if !defined(TARGET_ARCH_DBC)
-  const auto& arg_reps = *compiler::ffi::ArgumentRepresentations(signature);
+  const auto* structs =
+      compiler::ffi::StructCallingConvention::FromSignature(Z, signature);
+  const auto& arg_reps =
+      structs != nullptr ? structs->argument_representations()
+                         : *compiler::ffi::ArgumentRepresentations(signature);
   const ZoneGrowableArray<HostLocation>* arg_host_locs = nullptr;
+  const auto& arg_locs = structs != nullptr
+                             ? structs->argument_locations()
+                             : *compiler::ffi::ArgumentLocations(arg_reps);
 #else
+  const compiler::ffi::StructCallingConvention* structs = nullptr;
   const auto& arg_reps = *compiler::ffi::ArgumentHostRepresentations(signature);
   const auto* arg_host_locs = compiler::ffi::HostArgumentLocations(arg_reps);
-#endif
   const auto& arg_locs = *compiler::ffi::ArgumentLocations(arg_reps);
+#endif
 
   BuildArgumentTypeChecks(TypeChecksToBuild::kCheckAllTypeParameterBounds,
                           &body, &body, &body);
 
-  // Unbox and push the arguments.
+  // Allocate the memory for a struct result and keep the addresses of the
+  // memory of struct arguments, from which their parts are loaded.
   AbstractType& ffi_type = AbstractType::Handle(Z);
-  for (intptr_t pos = 1; pos < function.num_fixed_parameters(); pos++) {
+  intptr_t num_struct_temps = 0;
+  LocalVariable* result_address = nullptr;
+  GrowableArray<LocalVariable*> struct_addresses(Z, 0);
+  if (structs != nullptr) {
+    if (structs->has_struct_result()) {
+      const Library& ffi_lib = Library::Handle(Z, Library::FfiLibrary());
+      const Function& allocate =
+          Function::ZoneHandle(Z, ffi_lib.LookupFunctionAllowPrivate(
+                                      Symbols::AllocateStructResult()));
+      ASSERT(!allocate.IsNull());
+      body += IntConstant(structs->result_size());
+      body += PushArgument();
+      body += StaticCall(TokenPosition::kNoSource, allocate, /*num_args=*/1,
+                         ICData::kStatic);
+      result_address = MakeTemporary();
+      num_struct_temps++;
+    }
+    for (intptr_t pos = 1; pos < function.num_fixed_parameters(); pos++) {
+      ffi_type = signature.ParameterTypeAt(pos);
+      if (!compiler::ffi::NativeTypeIsByValue(ffi_type)) {
+        struct_addresses.Add(nullptr);
+        continue;
+      }
+      body += CheckNull(TokenPosition::kNoSource,
+                        parsed_function_->ParameterVariable(pos),
+                        String::ZoneHandle(Z, function.name()),
+                        /*clear_the_temp=*/false);
+      body += LoadLocal(parsed_function_->ParameterVariable(pos));
+      body += LoadNativeField(Slot::Pointer_c_memory_address());
+      struct_addresses.Add(MakeTemporary());
+      num_struct_temps++;
+    }
+  }
+
+  // Unbox and push the arguments.
+  for (intptr_t i = 0; i < arg_reps.length(); i++) {
+    const intptr_t pos =
+        (structs != nullptr ? structs->ArgumentOf(i) : i) + 1;
+    const compiler::ffi::StructPart* part =
+        structs != nullptr ? structs->StructPartAt(i) : nullptr;
+    if (part != nullptr) {
+      body += FfiLoadStructPart(struct_addresses[pos - 1], *part);
+      continue;
+    }
     body += LoadLocal(parsed_function_->ParameterVariable(pos));
     ffi_type = signature.ParameterTypeAt(pos);
-    body += FfiConvertArgumentToNative(function, ffi_type, arg_reps[pos - 1]);
+    body += FfiConvertArgumentToNative(function, ffi_type, arg_reps[i]);
+  }
+  if (result_address != nullptr) {
+    body += LoadLocal(result_address);
+    body += UnboxTruncate(kUnboxedFfiIntPtr);
   }
 
   // Push the function pointer, which is stored (boxed) in the first slot of the
@@ -2648,7 +3065,11 @@ FlowGraph* FlowGraphBuilder::BuildGraphOfFfiNative(const Function& function) {
                     Z, Class::Handle(I->object_store()->ffi_pointer_class()))
                     ->context_variables()[0]));
   body += UnboxTruncate(kUnboxedFfiIntPtr);
-  body += FfiCall(signature, arg_reps, arg_locs, arg_host_locs);
+  body += FfiCall(signature, function.FfiIsLeaf(), arg_reps, arg_locs,
+                  arg_host_locs, structs);
+  if (num_struct_temps > 0) {
+    body += DropTempsPreserveTop(num_struct_temps);
+  }
 
   ffi_type = signature.result_type();
 #if !defined(TARGET_ARCH_DBC)
@@ -106,6 +106,9 @@ class FlowGraphBuilder : public BaseFlowGraphBuilder {
 
   Fragment NativeFunctionBody(const Function& function,
                               LocalVariable* first_parameter);
+  Fragment FfiNativeFunctionBody(const Function& function,
+                                 const Function& c_signature,
+                                 void* address);
 
   Fragment BuildTypedDataViewFactoryConstructor(const Function& function,
                                                 classid_t cid);
@@ -133,6 +136,13 @@ class FlowGraphBuilder : public BaseFlowGraphBuilder {
                            bool is_synthesized);
   Fragment TryCatch(int try_handler_index);
   Fragment CheckStackOverflowInPrologue(TokenPosition position);
+
+  // Marks the code at 'position' as reached in the function's coverage array
+  // when compiling with --block_coverage. Unoptimized code allocates the
+  // array (see FinalizeCoverageArray), optimized code reuses it.
+  Fragment RecordCoverage(TokenPosition position);
+  void FinalizeCoverageArray();
+
   Fragment CloneContext(const GrowableArray<LocalVariable*>& context_variables);
 
   Fragment InstanceCall(
@@ -156,9 +166,11 @@ class FlowGraphBuilder : public BaseFlowGraphBuilder {
 
   Fragment FfiCall(
       const Function& signature,
+      bool is_leaf,
       const ZoneGrowableArray<Representation>& arg_reps,
       const ZoneGrowableArray<Location>& arg_locs,
-      const ZoneGrowableArray<HostLocation>* arg_host_locs = nullptr);
+      const ZoneGrowableArray<HostLocation>* arg_host_locs = nullptr,
+      const compiler::ffi::StructCallingConvention* structs = nullptr);
 
   Fragment RethrowException(TokenPosition position, int catch_try_index);
   Fragment LoadLocal(LocalVariable* variable);
@@ -250,6 +262,17 @@ class FlowGraphBuilder : public BaseFlowGraphBuilder {
       const AbstractType& ffi_type,
       const Representation native_representation);
 
+  // Pushes the unboxed [part] of the struct at the (boxed) address in
+  // [address], with the representation of the part.
+  Fragment FfiLoadStructPart(LocalVariable* address,
+                             const compiler::ffi::StructPart& part);
+
+  // Pushes the [size] bytes at [offset] in the struct at the (boxed) address
+  // in [address] as an unboxed int64, zero extended.
+  Fragment FfiLoadStructBytes(LocalVariable* address,
+                              intptr_t offset,
+                              intptr_t size);
+
   // Reverse of 'FfiConvertArgumentToNative'.
   Fragment FfiConvertArgumentToDart(const AbstractType& ffi_type,
                                     const Representation native_representation);
@@ -369,6 +392,11 @@ class FlowGraphBuilder : public BaseFlowGraphBuilder {
   const bool optimizing_;
   ZoneGrowableArray<const ICData*>& ic_data_array_;
 
+  // The coverage array and the index of the flag of each recorded position.
+  Array& coverage_array_;
+  IntMap<intptr_t> coverage_indices_;
+  GrowableArray<TokenPosition> coverage_positions_;
+
   intptr_t next_function_id_;
   intptr_t AllocateFunctionId() { return next_function_id_++; }
 
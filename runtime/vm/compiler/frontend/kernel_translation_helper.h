@@ -1098,6 +1098,7 @@ class KernelReaderHelper {
   friend class KernelLoader;
   friend class LibraryDependencyHelper;
   friend class LibraryHelper;
+  friend class LineStartsDecoder;
   friend class MetadataHelper;
   friend class ProcedureAttributesMetadataHelper;
   friend class ProcedureHelper;
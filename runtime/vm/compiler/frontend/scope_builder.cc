@@ -126,7 +126,9 @@ ScopeBuildingResult* ScopeBuilder::BuildScopes() {
     scope_->AddVariable(parsed_function_->arg_desc_var());
   }
 
-  if (parsed_function_->function().IsFfiTrampoline()) {
+  // Natives join a leaf FFI call and a call of their native entry through
+  // the expression temp when they are 'vm:ffi-native' natives.
+  if (function.IsFfiTrampoline() || function.is_native()) {
     needs_expr_temp_ = true;
   }
 
@@ -0,0 +1,246 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/compiler/jit/code_cache.h"
+
+#include "platform/atomic.h"
+#include "vm/debugger.h"
+#include "vm/flags.h"
+#include "vm/growable_array.h"
+#include "vm/hash_map.h"
+#include "vm/heap/heap.h"
+#include "vm/isolate.h"
+#include "vm/log.h"
+#include "vm/object.h"
+#include "vm/stack_frame.h"
+#include "vm/stub_code.h"
+#include "vm/thread.h"
+#include "vm/visitor.h"
+
+namespace dart {
+
+DEFINE_FLAG(int,
+            jit_code_cache_size,
+            0,
+            "Maximum size in bytes of the JIT compiled code of an isolate, "
+            "beyond which the code of the least used functions is evicted "
+            "after old space GCs. 0 means unlimited.");
+DEFINE_FLAG(bool, trace_code_cache, false, "Trace JIT code cache aging.");
+
+class FunctionsWithCodeCollector : public ObjectVisitor {
+ public:
+  FunctionsWithCodeCollector(Zone* zone,
+                             GrowableArray<const Function*>* functions)
+      : zone_(zone), functions_(functions) {}
+  virtual ~FunctionsWithCodeCollector() {}
+
+  virtual void VisitObject(RawObject* obj) {
+    if (obj->IsFunction() &&
+        Function::HasCode(static_cast<RawFunction*>(obj))) {
+      functions_->Add(
+          &Function::Handle(zone_, static_cast<RawFunction*>(obj)));
+    }
+  }
+
+ private:
+  Zone* const zone_;
+  GrowableArray<const Function*>* const functions_;
+};
+
+typedef DirectChainedHashMap<RawPointerKeyValueTrait<RawFunction, bool> >
+    FunctionSet;
+
+struct EvictionCandidate {
+  const Function* function;
+  intptr_t usage;
+
+  static int Compare(const EvictionCandidate* a, const EvictionCandidate* b) {
+    return (a->usage < b->usage) ? -1 : ((a->usage > b->usage) ? 1 : 0);
+  }
+};
+
+CodeCache::CodeCache() : aging_scheduled_(0) {}
+
+bool CodeCache::IsEnabled() {
+#if defined(TARGET_ARCH_DBC)
+  // Optimized code does not count invocations.
+  return false;
+#else
+  return !FLAG_precompiled_mode &&
+         (FLAG_collect_code || (FLAG_jit_code_cache_size > 0));
+#endif
+}
+
+void CodeCache::ScheduleAging(Thread* thread) {
+  ASSERT(IsEnabled());
+  AtomicOperations::StoreRelease(&aging_scheduled_, static_cast<uword>(1));
+  if (thread->IsMutatorThread()) {
+    thread->ScheduleInterrupts(Thread::kVMInterrupt);
+  } else {
+    thread->isolate()->ScheduleInterrupts(Thread::kVMInterrupt);
+  }
+}
+
+void CodeCache::AgeIfScheduled(Thread* thread) {
+  if (AtomicOperations::CompareAndSwapWord(&aging_scheduled_, 1, 0) == 1) {
+    Age(thread);
+  }
+}
+
+// Returns the size of the code of [function] not shared with other functions.
+static intptr_t CodeSize(Zone* zone, const Function& function) {
+  Code& code = Code::Handle(zone, function.CurrentCode());
+  if (code.IsStubCode()) {
+    return 0;
+  }
+  intptr_t size = code.Size();
+  if (function.HasOptimizedCode()) {
+    code = function.unoptimized_code();
+    if (!code.IsNull()) {
+      size += code.Size();
+    }
+  }
+  return size;
+}
+
+// Drops the optimized code of [function], or else its unoptimized code.
+// Returns the size of the dropped code.
+static intptr_t Evict(Zone* zone, const Function& function) {
+  const Code& code = Code::Handle(zone, function.CurrentCode());
+  const intptr_t size = code.Size();
+  if (function.HasOptimizedCode()) {
+    function.SwitchToLazyCompiledUnoptimizedCode();
+    return size;
+  }
+  ASSERT(function.unoptimized_code() == code.raw());
+  // Make optimized code calling it directly call the new code instead, so
+  // that it can be collected.
+  code.DisableDartCode();
+  function.set_unoptimized_code(Code::Handle(zone));
+  if (FLAG_enable_interpreter && function.HasBytecode()) {
+    function.SetInstructions(StubCode::InterpretCall());
+  } else {
+    function.SetInstructions(StubCode::LazyCompile());
+  }
+  return size;
+}
+
+static bool CanEvict(Thread* thread,
+                     const Function& function,
+                     const FunctionSet& active) {
+  if (function.ForceOptimize() || function.IsIrregexpFunction() ||
+      function.IsFfiTrampoline()) {
+    // There is no unoptimized code to fall back to.
+    return false;
+  }
+  if (function.usage_counter() < 0) {
+    // Queued for background compilation.
+    return false;
+  }
+  if (active.HasKey(function.raw())) {
+    return false;
+  }
+  if (!function.HasOptimizedCode() &&
+      (function.unoptimized_code() == Code::null())) {
+    // The code was not compiled for the function, e.g. it is a stub.
+    return false;
+  }
+#if !defined(PRODUCT)
+  if (Debugger::IsDebugging(thread, function)) {
+    return false;
+  }
+#endif
+  return true;
+}
+
+void CodeCache::Age(Thread* thread) {
+  ASSERT(thread->IsMutatorThread());
+  ASSERT(IsEnabled());
+  StackZone stack_zone(thread);
+  Zone* zone = stack_zone.GetZone();
+  HANDLESCOPE(thread);
+
+  // The other threads stay at a safepoint until the code is evicted, so that
+  // the background compilers do not install code meanwhile.
+  GrowableArray<const Function*> functions;
+  HeapIterationScope iteration(thread);
+  {
+    FunctionsWithCodeCollector visitor(zone, &functions);
+    iteration.IterateObjects(&visitor);
+  }
+  // Nothing is allocated from here on, so that functions do not move and can
+  // be identified by their raw pointers.
+  NoSafepointScope no_safepoint;
+
+  // The code of functions running is needed to return to them, and their
+  // unoptimized code to deoptimize or OSR them.
+  FunctionSet active;
+  {
+    DartFrameIterator iterator(thread,
+                               StackFrameIterator::kNoCrossThreadIteration);
+    for (StackFrame* frame = iterator.NextFrame(); frame != NULL;
+         frame = iterator.NextFrame()) {
+      if (!frame->is_interpreted()) {
+        RawFunction* function = frame->LookupDartFunction();
+        active.Insert(RawPointerKeyValueTrait<RawFunction, bool>::Pair(
+            function, true));
+      }
+    }
+  }
+
+  intptr_t size = 0;
+  GrowableArray<EvictionCandidate> candidates;
+  for (intptr_t i = 0; i < functions.length(); i++) {
+    const Function& function = *functions[i];
+    size += CodeSize(zone, function);
+    if (CanEvict(thread, function, active)) {
+      EvictionCandidate candidate = {&function, function.usage_counter()};
+      candidates.Add(candidate);
+    }
+  }
+  candidates.Sort(EvictionCandidate::Compare);
+
+  intptr_t evicted = 0;
+  intptr_t evicted_size = 0;
+  const intptr_t limit = FLAG_jit_code_cache_size;
+  for (intptr_t i = 0; i < candidates.length(); i++) {
+    const bool over_limit = (limit > 0) && (size - evicted_size > limit);
+    const bool unused = FLAG_collect_code && (candidates[i].usage == 0);
+    if (!over_limit && !unused) {
+      break;
+    }
+    const Function& function = *candidates[i].function;
+    if (FLAG_trace_code_cache) {
+      THR_Print("Evicting %s code of %s, usage %" Pd "\n",
+                function.HasOptimizedCode() ? "optimized" : "unoptimized",
+                function.ToCString(), candidates[i].usage);
+    }
+    evicted_size += Evict(zone, function);
+    evicted++;
+  }
+
+  // Age the counters, so that invocations count less the older they are.
+  for (intptr_t i = 0; i < candidates.length(); i++) {
+    const Function& function = *candidates[i].function;
+    function.SetUsageCounter(function.usage_counter() / 2);
+  }
+
+  if (FLAG_trace_code_cache) {
+    THR_Print("Code cache: %" Pd " bytes, evicted %" Pd " bytes of %" Pd
+              " functions\n",
+              size - evicted_size, evicted_size, evicted);
+  }
+#if !defined(PRODUCT)
+  Isolate* isolate = thread->isolate();
+  isolate->GetCodeCacheSizeMetric()->set_value(size - evicted_size);
+  isolate->GetCodeCacheEvictionsMetric()->AtomicAdd(evicted);
+  isolate->GetCodeCacheEvictedMetric()->AtomicAdd(evicted_size);
+#endif
+}
+
+}  // namespace dart
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
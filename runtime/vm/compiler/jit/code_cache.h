@@ -0,0 +1,49 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_JIT_CODE_CACHE_H_
+#define RUNTIME_VM_COMPILER_JIT_CODE_CACHE_H_
+
+#include "vm/allocation.h"
+
+namespace dart {
+
+class Thread;
+
+// Evicts the JIT compiled code of cold functions of an isolate, either to
+// keep the code within --jit_code_cache_size or, with --collect_code, once
+// the functions stopped being called.
+//
+// The code is aged after every old space GC: the usage counters of the
+// functions are halved, so that they count recent invocations more than old
+// ones, and the functions with the lowest counters lose their code first.
+// Optimized code is dropped for the unoptimized code, and unoptimized code
+// for the lazy compilation stub. The evicted code is freed by the next old
+// space GC.
+class CodeCache {
+ public:
+  CodeCache();
+
+  static bool IsEnabled();
+
+  // Requests aging at the next interrupt check of the mutator of the isolate
+  // of [thread], where it is neither compiling nor patching code.
+  void ScheduleAging(Thread* thread);
+
+  // Called by the mutator when handling interrupts.
+  void AgeIfScheduled(Thread* thread);
+
+  // Ages the code of the isolate of [thread], which must be its mutator, and
+  // evicts the code of cold functions.
+  void Age(Thread* thread);
+
+ private:
+  uword aging_scheduled_;
+
+  DISALLOW_COPY_AND_ASSIGN(CodeCache);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_JIT_CODE_CACHE_H_
@@ -26,6 +26,7 @@
 #include "vm/compiler/frontend/bytecode_reader.h"
 #include "vm/compiler/frontend/flow_graph_builder.h"
 #include "vm/compiler/frontend/kernel_to_il.h"
+#include "vm/compiler/jit/global_object_pool.h"
 #include "vm/compiler/jit/jit_call_specializer.h"
 #include "vm/dart_entry.h"
 #include "vm/debugger.h"
@@ -42,6 +43,7 @@
 #include "vm/regexp_assembler.h"
 #include "vm/regexp_parser.h"
 #include "vm/runtime_entry.h"
+#include "vm/startup_phases.h"
 #include "vm/symbols.h"
 #include "vm/tags.h"
 #include "vm/thread_registry.h"
@@ -227,7 +229,10 @@ DEFINE_RUNTIME_ENTRY(CompileFunction, 1) {
   const Function& function = Function::CheckedHandle(zone, arguments.ArgAt(0));
   Object& result = Object::Handle(zone);
 
-  if (FLAG_enable_interpreter && function.IsBytecodeAllowed(zone)) {
+  // Unoptimized code that is still to be attached is preferred over bytecode,
+  // see Compiler::CompileFunction.
+  if (FLAG_enable_interpreter && function.IsBytecodeAllowed(zone) &&
+      (function.unoptimized_code() == Object::null())) {
     if (!function.HasBytecode()) {
       result = kernel::BytecodeReader::ReadFunctionBytecode(thread, function);
       if (!result.IsNull()) {
@@ -355,7 +360,8 @@ class CompileParsedFunctionHelper : public ValueObject {
   }
   RawCode* FinalizeCompilation(Assembler* assembler,
                                FlowGraphCompiler* graph_compiler,
-                               FlowGraph* flow_graph);
+                               FlowGraph* flow_graph,
+                               GlobalObjectPool* global_object_pool);
   void CheckIfBackgroundCompilerIsBeingStopped(bool optimizing_compiler);
 
   ParsedFunction* parsed_function_;
@@ -370,7 +376,8 @@ class CompileParsedFunctionHelper : public ValueObject {
 RawCode* CompileParsedFunctionHelper::FinalizeCompilation(
     Assembler* assembler,
     FlowGraphCompiler* graph_compiler,
-    FlowGraph* flow_graph) {
+    FlowGraph* flow_graph,
+    GlobalObjectPool* global_object_pool) {
   ASSERT(!FLAG_precompiled_mode);
   const Function& function = parsed_function()->function();
   Zone* const zone = thread()->zone();
@@ -383,8 +390,14 @@ RawCode* CompileParsedFunctionHelper::FinalizeCompilation(
   // Allocates instruction object. Since this occurs only at safepoint,
   // there can be no concurrent access to the instruction page.
   Code& code = Code::Handle(Code::FinalizeCode(
-      graph_compiler, assembler, Code::PoolAttachment::kAttachPool, optimized(),
+      graph_compiler, assembler,
+      global_object_pool != nullptr ? Code::PoolAttachment::kNotAttachPool
+                                    : Code::PoolAttachment::kAttachPool,
+      optimized(),
       /*stats=*/nullptr));
+  if (global_object_pool != nullptr) {
+    global_object_pool->AttachTo(code, assembler->object_pool_builder());
+  }
   code.set_is_optimized(optimized());
   code.set_owner(function);
 
@@ -496,7 +509,8 @@ RawCode* CompileParsedFunctionHelper::FinalizeCompilation(
     if (function.ic_data_array() == Array::null()) {
       function.SaveICDataMap(
           graph_compiler->deopt_id_to_ic_data(),
-          Array::Handle(zone, graph_compiler->edge_counters_array()));
+          Array::Handle(zone, graph_compiler->edge_counters_array()),
+          flow_graph->coverage_array());
     }
     function.set_unoptimized_code(code);
     function.AttachCode(code);
@@ -515,6 +529,15 @@ RawCode* CompileParsedFunctionHelper::FinalizeCompilation(
       (*prefixes)[i]->RegisterDependentCode(code);
     }
   }
+#if !defined(PRODUCT)
+  if (!code.IsNull()) {
+    if (optimized()) {
+      isolate()->GetOptimizedCompilationsMetric()->AtomicAdd(1);
+    } else {
+      isolate()->GetUnoptimizedCompilationsMetric()->AtomicAdd(1);
+    }
+  }
+#endif  // !defined(PRODUCT)
   return code.raw();
 }
 
@@ -562,6 +585,9 @@ RawCode* CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
   // blacklist, since we don't restart optimization.
   SpeculativeInliningPolicy speculative_policy(/* enable_blacklist= */ false);
 
+  // The global object pool while this compilation is adding entries to it.
+  GlobalObjectPool* volatile global_object_pool = nullptr;
+
   Code* volatile result = &Code::ZoneHandle(zone);
   while (!done) {
     *result = Code::null();
@@ -655,6 +681,10 @@ RawCode* CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
       ASSERT(pass_state.inline_id_to_function.length() ==
              pass_state.caller_inline_id.length());
       ObjectPoolBuilder object_pool_builder;
+      GlobalObjectPool* pool = isolate()->jit_global_object_pool();
+      if ((pool != nullptr) && pool->Acquire(&object_pool_builder)) {
+        global_object_pool = pool;
+      }
       Assembler assembler(&object_pool_builder, use_far_branches);
       FlowGraphCompiler graph_compiler(
           &assembler, flow_graph, *parsed_function(), optimized(),
@@ -669,8 +699,8 @@ RawCode* CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
       {
         TIMELINE_DURATION(thread(), CompilerVerbose, "FinalizeCompilation");
         if (thread()->IsMutatorThread()) {
-          *result =
-              FinalizeCompilation(&assembler, &graph_compiler, flow_graph);
+          *result = FinalizeCompilation(&assembler, &graph_compiler,
+                                        flow_graph, global_object_pool);
         } else {
           // This part of compilation must be at a safepoint.
           // Stop mutator thread before creating the instruction object and
@@ -686,10 +716,14 @@ RawCode* CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
             // heap to grow.
             NoHeapGrowthControlScope no_growth_control;
             CheckIfBackgroundCompilerIsBeingStopped(optimized());
-            *result =
-                FinalizeCompilation(&assembler, &graph_compiler, flow_graph);
+            *result = FinalizeCompilation(&assembler, &graph_compiler,
+                                          flow_graph, global_object_pool);
           }
         }
+        if (global_object_pool != nullptr) {
+          global_object_pool->Release();
+          global_object_pool = nullptr;
+        }
 
         // We notify code observers after finalizing the code in order to be
         // outside a [SafepointOperationScope].
@@ -713,6 +747,10 @@ RawCode* CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
     } else {
       // We bailed out or we encountered an error.
       const Error& error = Error::Handle(thread()->StealStickyError());
+      if (global_object_pool != nullptr) {
+        global_object_pool->Release();
+        global_object_pool = nullptr;
+      }
 
       if (error.raw() == Object::branch_offset_error().raw()) {
         // Compilation failed due to an out of range branch offset in the
@@ -916,6 +954,20 @@ RawObject* Compiler::CompileFunction(Thread* thread, const Function& function) {
   }
 #endif
 
+  if (!function.ForceOptimize() && !function.HasCode() &&
+      (function.unoptimized_code() != Object::null())) {
+    // With --lazy_snapshot_code, functions read from a JIT snapshot keep
+    // their unoptimized code here until they are first called.
+    const Code& code =
+        Code::Handle(thread->zone(), function.unoptimized_code());
+    if (!code.IsDisabled()) {
+      function.SetInstructions(code);
+      function.SetWasCompiled(true);
+      return code.raw();
+    }
+    function.ClearCode();
+  }
+
   Isolate* isolate = thread->isolate();
   if (!isolate->compilation_allowed()) {
     FATAL3("Precompilation missed function %s (%s, %s)\n",
@@ -934,6 +986,7 @@ RawObject* Compiler::CompileFunction(Thread* thread, const Function& function) {
   }
   TIMELINE_FUNCTION_COMPILATION_DURATION(thread, event_name, function);
 #endif  // defined(SUPPORT_TIMELINE)
+  STARTUP_PHASE("CompileUnoptimized");
 
   CompilationPipeline* pipeline =
       CompilationPipeline::New(thread->zone(), function);
@@ -989,6 +1042,7 @@ RawObject* Compiler::CompileOptimizedFunction(Thread* thread,
   }
   TIMELINE_FUNCTION_COMPILATION_DURATION(thread, event_name, function);
 #endif  // defined(SUPPORT_TIMELINE)
+  STARTUP_PHASE("CompileOptimized");
 
   ASSERT(function.ShouldCompilerOptimize());
 
@@ -1151,7 +1205,9 @@ class QueueElement {
 };
 
 // Allocated in C-heap. Handles both input and output of background compilation.
-// It implements a FIFO queue, using Peek, Add, Remove operations.
+// It implements a queue, using Peek, Add, Remove operations. Functions are
+// added at the end of the queue, and PrioritizeHottest moves the hottest
+// function to the front before it is peeked.
 class BackgroundCompilationQueue {
  public:
   BackgroundCompilationQueue() : first_(NULL), last_(NULL) {}
@@ -1184,6 +1240,38 @@ class BackgroundCompilationQueue {
 
   QueueElement* Peek() const { return first_; }
 
+  // Moves the function with the highest usage counter to the front of the
+  // queue. Functions are queued when their usage counter reaches a
+  // threshold, but keep running and counting while they wait, so after
+  // a burst of tier-ups the functions which matter most are compiled first.
+  void PrioritizeHottest() {
+    if ((first_ == NULL) || (first_->next() == NULL)) {
+      return;
+    }
+    Function& function = Function::Handle(first_->Function());
+    QueueElement* hottest_prev = NULL;
+    QueueElement* hottest = first_;
+    intptr_t hottest_counter = function.usage_counter();
+    for (QueueElement* prev = first_; prev->next() != NULL;
+         prev = prev->next()) {
+      function = prev->next()->Function();
+      if (function.usage_counter() > hottest_counter) {
+        hottest_prev = prev;
+        hottest = prev->next();
+        hottest_counter = function.usage_counter();
+      }
+    }
+    if (hottest_prev == NULL) {
+      return;
+    }
+    hottest_prev->set_next(hottest->next());
+    if (last_ == hottest) {
+      last_ = hottest_prev;
+    }
+    hottest->set_next(first_);
+    first_ = hottest;
+  }
+
   RawFunction* PeekFunction() const {
     QueueElement* e = Peek();
     if (e == NULL) {
@@ -1257,6 +1345,7 @@ void BackgroundCompiler::Run() {
       Function& function = Function::Handle(zone);
       {
         MonitorLocker ml(&queue_monitor_);
+        function_queue()->PrioritizeHottest();
         function = function_queue()->PeekFunction();
       }
       while (running_ && !function.IsNull()) {
@@ -1291,6 +1380,7 @@ void BackgroundCompiler::Run() {
                 function_queue()->Add(repeat_qelem);
               }
             }
+            function_queue()->PrioritizeHottest();
             function = function_queue()->PeekFunction();
           }
         }
@@ -1346,6 +1436,10 @@ class BackgroundCompilerTask : public ThreadPool::Task {
       : background_compiler_(background_compiler) {}
   virtual ~BackgroundCompilerTask() {}
 
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kLowPriority;
+  }
+
  private:
   virtual void Run() { background_compiler_->Run(); }
 
@@ -0,0 +1,139 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/compiler/jit/global_object_pool.h"
+
+#include "vm/flags.h"
+#include "vm/lockers.h"
+#include "vm/object.h"
+#include "vm/thread.h"
+#include "vm/visitor.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            jit_global_object_pool,
+            false,
+            "Share the object pool entries of JIT compiled code that are not "
+            "patchable, instead of giving each code object its own pool.");
+
+GlobalObjectPool::GlobalObjectPool()
+    : mutex_(NOT_IN_PRODUCT("GlobalObjectPool::mutex_")),
+      in_use_(false),
+      pool_(ObjectPool::null()),
+      length_(0),
+      shared_entries_() {}
+
+GlobalObjectPool::~GlobalObjectPool() {
+  ASSERT(!in_use_);
+}
+
+bool GlobalObjectPool::Acquire(compiler::ObjectPoolBuilder* builder) {
+#if defined(TARGET_ARCH_IA32)
+  // Code embeds objects in its instructions instead.
+  return false;
+#else
+  if (!FLAG_jit_global_object_pool) {
+    return false;
+  }
+  MutexLocker ml(&mutex_);
+  if (in_use_) {
+    return false;
+  }
+  in_use_ = true;
+  builder->InitializeWithSharedPool(this);
+  return true;
+#endif
+}
+
+void GlobalObjectPool::Release() {
+  MutexLocker ml(&mutex_);
+  ASSERT(in_use_);
+  in_use_ = false;
+}
+
+void GlobalObjectPool::AttachTo(const Code& code,
+                                const compiler::ObjectPoolBuilder& builder) {
+  Thread* thread = Thread::Current();
+  ASSERT(thread->IsMutatorThread() || thread->IsAtSafepoint());
+  ASSERT(in_use_);
+  ASSERT(builder.base() == length_);
+  Zone* zone = thread->zone();
+  ObjectPool& pool = ObjectPool::Handle(zone, pool_);
+  const intptr_t length = length_ + builder.CurrentLength();
+  if (pool.IsNull() || (length > pool.Length())) {
+    intptr_t capacity = pool.IsNull() ? kInitialCapacity : 2 * pool.Length();
+    while (capacity < length) {
+      capacity *= 2;
+    }
+    const ObjectPool& grown =
+        ObjectPool::Handle(zone, ObjectPool::New(capacity));
+    // Only the shared entries are copied: the others belong to code that
+    // keeps using the old pool.
+    auto it = shared_entries_.GetIterator();
+    for (EntryTrait::Pair* pair = it.Next(); pair != nullptr;
+         pair = it.Next()) {
+      const intptr_t i = pair->index;
+      grown.SetTypeAt(i, pool.TypeAt(i), pool.PatchableAt(i));
+      if (pool.TypeAt(i) == ObjectPool::EntryType::kTaggedObject) {
+        grown.SetObjectAt(i, Object::Handle(zone, pool.ObjectAt(i)));
+      } else {
+        grown.SetRawValueAt(i, pool.RawValueAt(i));
+      }
+    }
+    pool_ = grown.raw();
+    pool = grown.raw();
+  }
+
+  // The new entries are past the end of the pool as seen by running code,
+  // so they can be filled in while it runs.
+  for (intptr_t i = 0; i < builder.CurrentLength(); i++) {
+    const auto& entry = builder.EntryAt(i);
+    const intptr_t index = length_ + i;
+    pool.SetTypeAt(index, entry.type(), entry.patchable());
+    if (entry.type() == ObjectPool::EntryType::kTaggedObject) {
+      pool.SetObjectAt(index, *entry.obj_);
+    } else {
+      pool.SetRawValueAt(index, entry.raw_value_);
+    }
+    if (builder.IsShareable(i)) {
+      shared_entries_.Insert(
+          EntryTrait::Pair(compiler::ObjIndexPair::Hashcode(entry), index));
+    }
+  }
+  length_ = length;
+  code.set_object_pool(pool.raw());
+}
+
+intptr_t GlobalObjectPool::Lookup(
+    const compiler::ObjectPoolBuilderEntry& entry) const {
+  ASSERT(in_use_);
+  const EntryTrait::Key key = {compiler::ObjIndexPair::Hashcode(entry), &entry,
+                               this};
+  return shared_entries_.LookupValue(key);
+}
+
+bool GlobalObjectPool::IsEntryAt(
+    intptr_t index,
+    const compiler::ObjectPoolBuilderEntry& entry) const {
+  const ObjectPool& pool = ObjectPool::Handle(pool_);
+  if ((pool.TypeAt(index) != entry.type()) ||
+      (pool.PatchableAt(index) != entry.patchable())) {
+    return false;
+  }
+  if (entry.type() == ObjectPool::EntryType::kTaggedObject) {
+    return pool.ObjectAt(index) == entry.obj_->raw();
+  }
+  return pool.RawValueAt(index) == entry.raw_value_;
+}
+
+void GlobalObjectPool::VisitObjectPointers(ObjectPointerVisitor* visitor) {
+  visitor->VisitPointer(reinterpret_cast<RawObject**>(&pool_));
+}
+
+}  // namespace dart
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
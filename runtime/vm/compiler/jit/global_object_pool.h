@@ -0,0 +1,94 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_JIT_GLOBAL_OBJECT_POOL_H_
+#define RUNTIME_VM_COMPILER_JIT_GLOBAL_OBJECT_POOL_H_
+
+#include "vm/allocation.h"
+#include "vm/compiler/assembler/object_pool_builder.h"
+#include "vm/hash_map.h"
+#include "vm/os_thread.h"
+
+namespace dart {
+
+class Code;
+class ObjectPointerVisitor;
+class RawObjectPool;
+
+// An append-only object pool shared by the code JIT compiled in an isolate
+// with --jit_global_object_pool, so that constants, stubs and other entries
+// that are not patchable are stored once rather than in the pool of every
+// [Code] using them.
+//
+// Only one compilation at a time adds entries to the pool; compilations
+// meanwhile use a pool of their own. When the pool is full it is replaced
+// by a larger copy of its shared entries, while code compiled earlier keeps
+// using the pool it was compiled against.
+class GlobalObjectPool : public compiler::SharedObjectPool {
+ public:
+  GlobalObjectPool();
+  ~GlobalObjectPool();
+
+  // Makes [builder] number its entries after the entries of this pool and
+  // share them, unless another compilation is using the pool. Returns
+  // whether it does.
+  bool Acquire(compiler::ObjectPoolBuilder* builder);
+
+  // Adds the entries of [builder] to this pool and uses it as the object
+  // pool of [code]. Must be called on the mutator or at a safepoint.
+  void AttachTo(const Code& code, const compiler::ObjectPoolBuilder& builder);
+
+  // Lets other compilations use the pool.
+  void Release();
+
+  virtual intptr_t Length() const { return length_; }
+  virtual intptr_t Lookup(const compiler::ObjectPoolBuilderEntry& entry) const;
+
+  void VisitObjectPointers(ObjectPointerVisitor* visitor);
+
+ private:
+  static const intptr_t kInitialCapacity = 1024;
+
+  // The shared entries, which are looked up by comparing them with the
+  // entries of the pool, so that moving objects does not invalidate them.
+  class EntryTrait {
+   public:
+    struct Key {
+      intptr_t hash;
+      const compiler::ObjectPoolBuilderEntry* entry;
+      const GlobalObjectPool* pool;
+    };
+    typedef intptr_t Value;
+    struct Pair {
+      Pair() : hash(0), index(compiler::ObjIndexPair::kNoIndex) {}
+      Pair(intptr_t h, intptr_t i) : hash(h), index(i) {}
+
+      intptr_t hash;
+      intptr_t index;
+    };
+
+    static Key KeyOf(Pair kv) { return {kv.hash, nullptr, nullptr}; }
+    static Value ValueOf(Pair kv) { return kv.index; }
+    static intptr_t Hashcode(Key key) { return key.hash; }
+    static bool IsKeyEqual(Pair kv, Key key) {
+      return (kv.hash == key.hash) && key.pool->IsEntryAt(kv.index, *key.entry);
+    }
+  };
+
+  bool IsEntryAt(intptr_t index,
+                 const compiler::ObjectPoolBuilderEntry& entry) const;
+
+  Mutex mutex_;
+  bool in_use_;
+
+  RawObjectPool* pool_;
+  intptr_t length_;
+  MallocDirectChainedHashMap<EntryTrait> shared_entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(GlobalObjectPool);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_JIT_GLOBAL_OBJECT_POOL_H_
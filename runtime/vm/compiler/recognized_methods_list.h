@@ -42,6 +42,11 @@ namespace dart {
   V(_TypedList, _setFloat64, ByteArrayBaseSetFloat64, 0x38a80b0d)              \
   V(_TypedList, _setFloat32x4, ByteArrayBaseSetFloat32x4, 0x40052c4e)          \
   V(_TypedList, _setInt32x4, ByteArrayBaseSetInt32x4, 0x07b89f54)              \
+  V(_TypedListBase, _memMove1, TypedDataMemMove1, 0x0)                         \
+  V(_TypedListBase, _memMove2, TypedDataMemMove2, 0x0)                         \
+  V(_TypedListBase, _memMove4, TypedDataMemMove4, 0x0)                         \
+  V(_TypedListBase, _memMove8, TypedDataMemMove8, 0x0)                         \
+  V(_TypedListBase, _memMove16, TypedDataMemMove16, 0x0)                       \
   V(ByteData, ., ByteDataFactory, 0x0)                                         \
   V(_ByteDataView, get:offsetInBytes, ByteDataViewOffsetInBytes, 0x0)          \
   V(_ByteDataView, get:_typedData, ByteDataViewTypedData, 0x0)                 \
@@ -347,6 +352,8 @@ namespace dart {
   V(::, _getDefaultTag, UserTag_defaultTag, 0x69f3f1ad)                        \
   V(::, _getCurrentTag, Profiler_getCurrentTag, 0x05fa99d2)                    \
   V(::, _isDartStreamEnabled, Timeline_isDartStreamEnabled, 0x72f13f7a)        \
+  V(::, _getTraceClock, Timeline_getTraceClock, 0x0)                           \
+  V(::, _getThreadCpuClock, Timeline_getThreadCpuClock, 0x0)                   \
 
 #define ASYNC_LIB_INTRINSIC_LIST(V)                                            \
   V(::, _clearAsyncThreadStackTrace, ClearAsyncThreadStackTrace, 0x2edd4b25)   \
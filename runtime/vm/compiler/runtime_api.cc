@@ -606,6 +606,10 @@ word RegExp::function_offset(classid_t cid, bool sticky) {
   return TranslateOffsetInWords(dart::RegExp::function_offset(cid, sticky));
 }
 
+word RegExp::literal_prefix_offset() {
+  return TranslateOffsetInWords(dart::RegExp::literal_prefix_offset());
+}
+
 const word Symbols::kNumberOfOneCharCodeSymbols =
     dart::Symbols::kNumberOfOneCharCodeSymbols;
 const word Symbols::kNullCharCodeSymbolOffset =
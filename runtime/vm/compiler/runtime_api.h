@@ -453,6 +453,8 @@ class MegamorphicCache : public AllStatic {
   static word mask_offset();
   static word buckets_offset();
   static word arguments_descriptor_offset();
+  static word dispatch_table_offset();
+  static word dispatch_table_row_offset();
 };
 
 class SingleTargetCache : public AllStatic {
@@ -809,6 +811,7 @@ class SubtypeTestCache : public AllStatic {
   static const word kInstanceParentFunctionTypeArguments;
   static const word kInstanceDelayedFunctionTypeArguments;
   static const word kTestResult;
+  static const word kHashedMask;
 };
 
 class Context : public AllStatic {
@@ -863,6 +866,7 @@ class NativeEntry {
 class RegExp : public AllStatic {
  public:
   static word function_offset(classid_t cid, bool sticky);
+  static word literal_prefix_offset();
 };
 
 class UserTag : public AllStatic {
@@ -891,6 +895,7 @@ class Field : public AllStatic {
 class TypeArguments : public AllStatic {
  public:
   static word instantiations_offset();
+  static word hash_offset();
   static word type_at_offset(intptr_t i);
 };
 
@@ -43,6 +43,7 @@
   CONSTANT(NativeEntry, kNumCallWrapperArguments)                              \
   CONSTANT(String, kMaxElements)                                               \
   CONSTANT(SubtypeTestCache, kFunctionTypeArguments)                           \
+  CONSTANT(SubtypeTestCache, kHashedMask)                                      \
   CONSTANT(SubtypeTestCache, kInstanceClassIdOrFunction)                       \
   CONSTANT(SubtypeTestCache, kInstanceDelayedFunctionTypeArguments)            \
   CONSTANT(SubtypeTestCache, kInstanceParentFunctionTypeArguments)             \
@@ -125,6 +126,8 @@
   FIELD(MarkingStackBlock, top_offset)                                         \
   FIELD(MegamorphicCache, arguments_descriptor_offset)                         \
   FIELD(MegamorphicCache, buckets_offset)                                      \
+  FIELD(MegamorphicCache, dispatch_table_offset)                               \
+  FIELD(MegamorphicCache, dispatch_table_row_offset)                           \
   FIELD(MegamorphicCache, mask_offset)                                         \
   FIELD(Mint, value_offset)                                                    \
   FIELD(NativeArguments, argc_tag_offset)                                      \
@@ -224,6 +227,7 @@
   FIELD(Type, signature_offset)                                                \
   FIELD(Type, type_class_id_offset)                                            \
   FIELD(Type, type_state_offset)                                               \
+  FIELD(TypeArguments, hash_offset)                                            \
   FIELD(TypeArguments, instantiations_offset)                                  \
   FIELD(TypeRef, type_offset)                                                  \
   FIELD(TypedDataBase, data_field_offset)                                      \
@@ -2532,7 +2532,7 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
          FieldAddress(kCacheReg, target::SubtypeTestCache::cache_offset()));
   __ AddImmediate(kCacheReg, target::Array::data_offset() - kHeapObjectTag);
 
-  Label loop, not_closure;
+  Label probe, loop, not_closure;
   if (n >= 4) {
     __ LoadClassIdMayBeSmi(kInstanceCidOrFunction, kInstanceReg);
   } else {
@@ -2560,7 +2560,7 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
                             target::Closure::delayed_type_arguments_offset()));
       }
     }
-    __ b(&loop);
+    __ b(&probe);
   }
 
   // Non-Closure handling.
@@ -2590,6 +2590,39 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
 
   Label found, not_found, next_iteration;
 
+  // A hashed cache is probed linearly like a linear cache, but from the entry
+  // for the class id of the instance. Both start with an entry whose instance
+  // class id is null, and only the header of a hashed cache has a mask.
+  {
+    Label is_closure, hashed;
+    __ Bind(&probe);
+    __ ldr(R9,
+           Address(kCacheReg,
+                   target::kWordSize *
+                       target::SubtypeTestCache::kInstanceClassIdOrFunction));
+    __ cmp(R9, Operand(kNullReg));
+    __ b(&loop, NE);
+    __ ldr(R9, Address(kCacheReg, target::kWordSize *
+                                      target::SubtypeTestCache::kHashedMask));
+    __ cmp(R9, Operand(kNullReg));
+    __ b(&not_found, EQ);
+    // The mask and a class id are both Smis, so they are and-ed tagged.
+    __ BranchIfNotSmi(kInstanceCidOrFunction, &is_closure);
+    __ and_(R9, R9, Operand(kInstanceCidOrFunction));
+    __ b(&hashed);
+    __ Bind(&is_closure);
+    __ AndImmediate(R9, R9, target::ToRawSmi(kClosureCid));
+    __ Bind(&hashed);
+    __ SmiUntag(R9);
+    __ LoadImmediate(IP, target::kWordSize *
+                             target::SubtypeTestCache::kTestEntryLength);
+    __ mul(R9, R9, IP);
+    __ add(kCacheReg, kCacheReg, Operand(R9));
+    // Skip the header.
+    __ AddImmediate(kCacheReg, target::kWordSize *
+                                   target::SubtypeTestCache::kTestEntryLength);
+  }
+
   // Loop header.
   __ Bind(&loop);
   __ ldr(R9, Address(kCacheReg,
@@ -3095,6 +3128,37 @@ void StubCodeCompiler::GenerateOptimizedIdenticalWithNumberCheckStub(
 void StubCodeCompiler::GenerateMegamorphicCallStub(Assembler* assembler) {
   __ LoadTaggedClassIdMayBeSmi(R0, R0);
   // R0: receiver cid as Smi.
+  const intptr_t base = target::Array::data_offset();
+  if (FLAG_precompiled_mode) {
+    // If the selector has a row in the global dispatch table, the target for
+    // the receiver class is in the slot at index (cid + row) if that slot is
+    // tagged with the row.
+    Label not_in_dispatch_table;
+    __ ldr(R2,
+           FieldAddress(R9, target::MegamorphicCache::dispatch_table_offset()));
+    __ CompareObject(R2, NullObject());
+    __ b(&not_in_dispatch_table, EQ);
+    __ ldr(R6, FieldAddress(
+                   R9, target::MegamorphicCache::dispatch_table_row_offset()));
+    // R3: cid + row as a smi.
+    __ add(R3, R0, Operand(R6));
+    // The table has two words per slot, so compare with half its length.
+    __ ldr(R1, FieldAddress(R2, target::Array::length_offset()));
+    __ cmp(R3, Operand(R1, LSR, 1));
+    __ b(&not_in_dispatch_table, CS);
+    // R3 is smi tagged, but slots are two words, so LSL 2.
+    __ add(IP, R2, Operand(R3, LSL, 2));
+    __ ldr(R1, FieldAddress(IP, base));
+    __ cmp(R1, Operand(R6));
+    __ b(&not_in_dispatch_table, NE);
+    __ ldr(R0, FieldAddress(IP, base + target::kWordSize));
+    __ ldr(CODE_REG, FieldAddress(R0, target::Function::code_offset()));
+    __ ldr(ARGS_DESC_REG,
+           FieldAddress(
+               R9, target::MegamorphicCache::arguments_descriptor_offset()));
+    __ Branch(FieldAddress(R0, target::Function::entry_point_offset()));
+    __ Bind(&not_in_dispatch_table);
+  }
   __ ldr(R2, FieldAddress(R9, target::MegamorphicCache::buckets_offset()));
   __ ldr(R1, FieldAddress(R9, target::MegamorphicCache::mask_offset()));
   // R2: cache buckets array.
@@ -3109,7 +3173,6 @@ void StubCodeCompiler::GenerateMegamorphicCallStub(Assembler* assembler) {
   __ Bind(&loop);
   __ and_(R3, R3, Operand(R1));
 
-  const intptr_t base = target::Array::data_offset();
   // R3 is smi tagged, but table entries are two words, so LSL 2.
   Label probe_failed;
   __ add(IP, R2, Operand(R3, LSL, 2));
@@ -1606,12 +1606,18 @@ static void GenerateWriteBarrierStubHelper(Assembler* assembler,
   // R3: Untagged address of header word (ldxr/stxr do not support offsets).
   // Note that we use 32 bit operations here to match the size of the
   // background sweeper which is also manipulating this 32 bit word.
-  Label retry;
-  __ Bind(&retry);
-  __ ldxr(R2, R3, kWord);
-  __ AndImmediate(R2, R2, ~(1 << target::RawObject::kOldAndNotRememberedBit));
-  __ stxr(R4, R2, R3, kWord);
-  __ cbnz(&retry, R4);
+  if (TargetCPUFeatures::atomic_memory_supported()) {
+    __ LoadImmediate(R2, 1 << target::RawObject::kOldAndNotRememberedBit);
+    __ ldclr(R2, ZR, R3, kWord);
+  } else {
+    Label retry;
+    __ Bind(&retry);
+    __ ldxr(R2, R3, kWord);
+    __ AndImmediate(R2, R2,
+                    ~(1 << target::RawObject::kOldAndNotRememberedBit));
+    __ stxr(R4, R2, R3, kWord);
+    __ cbnz(&retry, R4);
+  }
 
   // Load the StoreBuffer block out of the thread. Then load top_ out of the
   // StoreBufferBlock and add the address to the pointers_.
@@ -1662,12 +1668,20 @@ static void GenerateWriteBarrierStubHelper(Assembler* assembler,
   ASSERT(target::Object::tags_offset() == 0);
   __ sub(R3, R0, Operand(kHeapObjectTag));
   // R3: Untagged address of header word (ldxr/stxr do not support offsets).
-  __ Bind(&marking_retry);
-  __ ldxr(R2, R3, kWord);
-  __ tbz(&lost_race, R2, target::RawObject::kOldAndNotMarkedBit);
-  __ AndImmediate(R2, R2, ~(1 << target::RawObject::kOldAndNotMarkedBit));
-  __ stxr(R4, R2, R3, kWord);
-  __ cbnz(&marking_retry, R4);
+  if (TargetCPUFeatures::atomic_memory_supported()) {
+    // Clearing an already clear bit is harmless, so only the old value needs
+    // to be checked for a lost race.
+    __ LoadImmediate(R2, 1 << target::RawObject::kOldAndNotMarkedBit);
+    __ ldclr(R2, R2, R3, kWord);
+    __ tbz(&lost_race, R2, target::RawObject::kOldAndNotMarkedBit);
+  } else {
+    __ Bind(&marking_retry);
+    __ ldxr(R2, R3, kWord);
+    __ tbz(&lost_race, R2, target::RawObject::kOldAndNotMarkedBit);
+    __ AndImmediate(R2, R2, ~(1 << target::RawObject::kOldAndNotMarkedBit));
+    __ stxr(R4, R2, R3, kWord);
+    __ cbnz(&marking_retry, R4);
+  }
 
   __ LoadFromOffset(R4, THR, target::Thread::marking_stack_block_offset());
   __ LoadFromOffset(R2, R4, target::MarkingStackBlock::top_offset(),
@@ -2615,7 +2629,7 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
          FieldAddress(kCacheReg, target::SubtypeTestCache::cache_offset()));
   __ AddImmediate(kCacheReg, target::Array::data_offset() - kHeapObjectTag);
 
-  Label loop, not_closure;
+  Label probe, loop, not_closure;
   if (n >= 4) {
     __ LoadClassIdMayBeSmi(kInstanceCidOrFunction, kInstanceReg);
   } else {
@@ -2643,7 +2657,7 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
                             target::Closure::delayed_type_arguments_offset()));
       }
     }
-    __ b(&loop);
+    __ b(&probe);
   }
 
   // Non-Closure handling.
@@ -2675,6 +2689,39 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
 
   Label found, not_found, next_iteration;
 
+  // A hashed cache is probed linearly like a linear cache, but from the entry
+  // for the class id of the instance. Both start with an entry whose instance
+  // class id is null, and only the header of a hashed cache has a mask.
+  {
+    Label is_closure, hashed;
+    __ Bind(&probe);
+    __ ldr(R5,
+           Address(kCacheReg,
+                   target::kWordSize *
+                       target::SubtypeTestCache::kInstanceClassIdOrFunction));
+    __ cmp(R5, Operand(kNullReg));
+    __ b(&loop, NE);
+    __ ldr(R5, Address(kCacheReg, target::kWordSize *
+                                      target::SubtypeTestCache::kHashedMask));
+    __ cmp(R5, Operand(kNullReg));
+    __ b(&not_found, EQ);
+    // The mask and a class id are both Smis, so they are and-ed tagged.
+    __ BranchIfNotSmi(kInstanceCidOrFunction, &is_closure);
+    __ and_(R5, R5, Operand(kInstanceCidOrFunction));
+    __ b(&hashed);
+    __ Bind(&is_closure);
+    __ AndImmediate(R5, R5, target::ToRawSmi(kClosureCid));
+    __ Bind(&hashed);
+    __ SmiUntag(R5);
+    __ LoadImmediate(TMP, target::kWordSize *
+                              target::SubtypeTestCache::kTestEntryLength);
+    __ mul(R5, R5, TMP);
+    __ add(kCacheReg, kCacheReg, Operand(R5));
+    // Skip the header.
+    __ AddImmediate(kCacheReg, target::kWordSize *
+                                   target::SubtypeTestCache::kTestEntryLength);
+  }
+
   // Loop header
   __ Bind(&loop);
   __ ldr(R5, Address(kCacheReg,
@@ -3164,6 +3211,38 @@ void StubCodeCompiler::GenerateMegamorphicCallStub(Assembler* assembler) {
 
   Label cid_loaded;
   __ Bind(&cid_loaded);
+  const intptr_t base = target::Array::data_offset();
+  if (FLAG_precompiled_mode) {
+    // If the selector has a row in the global dispatch table, the target for
+    // the receiver class is in the slot at index (cid + row) if that slot is
+    // tagged with the row.
+    Label not_in_dispatch_table;
+    __ ldr(R2,
+           FieldAddress(R5, target::MegamorphicCache::dispatch_table_offset()));
+    __ CompareObject(R2, NullObject());
+    __ b(&not_in_dispatch_table, EQ);
+    __ ldr(R6, FieldAddress(
+                   R5, target::MegamorphicCache::dispatch_table_row_offset()));
+    // R3: cid + row as a smi.
+    __ add(R3, R6, Operand(R0, LSL, 1));
+    // The table has two words per slot, so compare with half its length.
+    __ ldr(R1, FieldAddress(R2, target::Array::length_offset()));
+    __ cmp(R3, Operand(R1, LSR, 1));
+    __ b(&not_in_dispatch_table, CS);
+    // R3 is smi tagged, but slots are 16 bytes, so LSL 3.
+    __ add(TMP, R2, Operand(R3, LSL, 3));
+    __ ldr(R1, FieldAddress(TMP, base));
+    __ CompareRegisters(R1, R6);
+    __ b(&not_in_dispatch_table, NE);
+    __ ldr(R0, FieldAddress(TMP, base + target::kWordSize));
+    __ ldr(R1, FieldAddress(R0, target::Function::entry_point_offset()));
+    __ ldr(ARGS_DESC_REG,
+           FieldAddress(
+               R5, target::MegamorphicCache::arguments_descriptor_offset()));
+    __ ldr(CODE_REG, FieldAddress(R0, target::Function::code_offset()));
+    __ br(R1);
+    __ Bind(&not_in_dispatch_table);
+  }
   __ ldr(R2, FieldAddress(R5, target::MegamorphicCache::buckets_offset()));
   __ ldr(R1, FieldAddress(R5, target::MegamorphicCache::mask_offset()));
   // R2: cache buckets array.
@@ -3183,7 +3262,6 @@ void StubCodeCompiler::GenerateMegamorphicCallStub(Assembler* assembler) {
   __ Bind(&loop);
   __ and_(R3, R3, Operand(R1));
 
-  const intptr_t base = target::Array::data_offset();
   // R3 is smi tagged, but table entries are 16 bytes, so LSL 3.
   __ add(TMP, R2, Operand(R3, LSL, 3));
   __ ldr(R6, FieldAddress(TMP, base));
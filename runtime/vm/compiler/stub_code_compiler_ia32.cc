@@ -2222,7 +2222,7 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
   __ movl(EDX, FieldAddress(EDX, target::SubtypeTestCache::cache_offset()));
   __ addl(EDX, Immediate(target::Array::data_offset() - kHeapObjectTag));
 
-  Label loop, not_closure;
+  Label probe, loop, not_closure;
   if (n >= 4) {
     __ LoadClassIdMayBeSmi(kInstanceCidOrFunction, kInstanceReg);
   } else {
@@ -2247,7 +2247,7 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
             kInstanceReg, target::Closure::function_type_arguments_offset()));
       }
     }
-    __ jmp(&loop, Assembler::kNearJump);
+    __ jmp(&probe, Assembler::kNearJump);
   }
 
   // Non-Closure handling.
@@ -2283,6 +2283,39 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
 
   Label found, not_found, next_iteration;
 
+  // A hashed cache is probed linearly like a linear cache, but from the entry
+  // for the class id of the instance. Both start with an entry whose instance
+  // class id is null, and only the header of a hashed cache has a mask.
+  {
+    Label is_closure, hashed;
+    __ Bind(&probe);
+    __ movl(
+        EDI,
+        Address(EDX, target::kWordSize *
+                         target::SubtypeTestCache::kInstanceClassIdOrFunction));
+    __ cmpl(EDI, raw_null);
+    __ j(NOT_EQUAL, &loop, Assembler::kNearJump);
+    __ movl(EDI, Address(EDX, target::kWordSize *
+                                  target::SubtypeTestCache::kHashedMask));
+    __ cmpl(EDI, raw_null);
+    __ j(EQUAL, &not_found);
+    // The mask and a class id are both Smis, so they are and-ed tagged.
+    __ testl(kInstanceCidOrFunction, Immediate(kSmiTagMask));
+    __ j(NOT_ZERO, &is_closure, Assembler::kNearJump);
+    __ andl(EDI, kInstanceCidOrFunction);
+    __ jmp(&hashed, Assembler::kNearJump);
+    __ Bind(&is_closure);
+    __ andl(EDI, Immediate(target::ToRawSmi(kClosureCid)));
+    __ Bind(&hashed);
+    __ SmiUntag(EDI);
+    __ imull(EDI, Immediate(target::kWordSize *
+                            target::SubtypeTestCache::kTestEntryLength));
+    // Skip the header.
+    __ leal(EDX, Address(EDX, EDI, TIMES_1,
+                         target::kWordSize *
+                             target::SubtypeTestCache::kTestEntryLength));
+  }
+
   // Loop header.
   __ Bind(&loop);
   __ movl(
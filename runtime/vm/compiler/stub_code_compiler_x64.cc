@@ -2625,7 +2625,7 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
           FieldAddress(kCacheReg, target::SubtypeTestCache::cache_offset()));
   __ addq(RSI, Immediate(target::Array::data_offset() - kHeapObjectTag));
 
-  Label loop, not_closure;
+  Label probe, loop, not_closure;
   if (n >= 4) {
     __ LoadClassIdMayBeSmi(kInstanceCidOrFunction, kInstanceReg);
   } else {
@@ -2654,7 +2654,7 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
                              target::Closure::delayed_type_arguments_offset()));
       }
     }
-    __ jmp(&loop, Assembler::kNearJump);
+    __ jmp(&probe, Assembler::kNearJump);
   }
 
   // Non-Closure handling.
@@ -2688,6 +2688,38 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
 
   Label found, not_found, next_iteration;
 
+  // A hashed cache is probed linearly like a linear cache, but from the entry
+  // for the class id of the instance. Both start with an entry whose instance
+  // class id is null, and only the header of a hashed cache has a mask.
+  {
+    Label is_closure, hashed;
+    __ Bind(&probe);
+    __ movq(RDI, Address(RSI, target::kWordSize *
+                                  target::SubtypeTestCache::
+                                      kInstanceClassIdOrFunction));
+    __ cmpq(RDI, kNullReg);
+    __ j(NOT_EQUAL, &loop);
+    __ movq(RDI, Address(RSI, target::kWordSize *
+                                  target::SubtypeTestCache::kHashedMask));
+    __ cmpq(RDI, kNullReg);
+    __ j(EQUAL, &not_found);
+    // The mask and a class id are both Smis, so they are and-ed tagged.
+    __ testq(kInstanceCidOrFunction, Immediate(kSmiTagMask));
+    __ j(NOT_ZERO, &is_closure, Assembler::kNearJump);
+    __ andq(RDI, kInstanceCidOrFunction);
+    __ jmp(&hashed, Assembler::kNearJump);
+    __ Bind(&is_closure);
+    __ andq(RDI, Immediate(target::ToRawSmi(kClosureCid)));
+    __ Bind(&hashed);
+    __ SmiUntag(RDI);
+    __ imulq(RDI, Immediate(target::kWordSize *
+                            target::SubtypeTestCache::kTestEntryLength));
+    // Skip the header.
+    __ leaq(RSI, Address(RSI, RDI, TIMES_1,
+                         target::kWordSize *
+                             target::SubtypeTestCache::kTestEntryLength));
+  }
+
   // Loop header.
   __ Bind(&loop);
   __ movq(
@@ -3171,6 +3203,37 @@ void StubCodeCompiler::GenerateMegamorphicCallStub(Assembler* assembler) {
 
   Label cid_loaded;
   __ Bind(&cid_loaded);
+  const intptr_t base = target::Array::data_offset();
+  if (FLAG_precompiled_mode) {
+    // If the selector has a row in the global dispatch table, the target for
+    // the receiver class is in the slot at index (cid + row) if that slot is
+    // tagged with the row.
+    Label not_in_dispatch_table;
+    __ movq(RDI, FieldAddress(
+                     RBX, target::MegamorphicCache::dispatch_table_offset()));
+    __ CompareObject(RDI, NullObject());
+    __ j(EQUAL, &not_in_dispatch_table);
+    __ movq(R9,
+            FieldAddress(
+                RBX, target::MegamorphicCache::dispatch_table_row_offset()));
+    // RCX: cid + row as a smi.
+    __ leaq(RCX, Address(R9, RAX, TIMES_2, 0));
+    // The table has two words per slot, so compare with half its length.
+    __ movq(R10, FieldAddress(RDI, target::Array::length_offset()));
+    __ shrq(R10, Immediate(1));
+    __ cmpq(RCX, R10);
+    __ j(ABOVE_EQUAL, &not_in_dispatch_table);
+    __ cmpq(R9, FieldAddress(RDI, RCX, TIMES_8, base));
+    __ j(NOT_EQUAL, &not_in_dispatch_table);
+    __ movq(RAX, FieldAddress(RDI, RCX, TIMES_8, base + target::kWordSize));
+    __ movq(R10,
+            FieldAddress(
+                RBX, target::MegamorphicCache::arguments_descriptor_offset()));
+    __ movq(RCX, FieldAddress(RAX, target::Function::entry_point_offset()));
+    __ movq(CODE_REG, FieldAddress(RAX, target::Function::code_offset()));
+    __ jmp(RCX);
+    __ Bind(&not_in_dispatch_table);
+  }
   __ movq(R9, FieldAddress(RBX, target::MegamorphicCache::mask_offset()));
   __ movq(RDI, FieldAddress(RBX, target::MegamorphicCache::buckets_offset()));
   // R9: mask as a smi.
@@ -3189,7 +3252,6 @@ void StubCodeCompiler::GenerateMegamorphicCallStub(Assembler* assembler) {
   __ Bind(&loop);
   __ andq(RCX, R9);
 
-  const intptr_t base = target::Array::data_offset();
   // RCX is smi tagged, but table entries are two words, so TIMES_8.
   Label probe_failed;
   __ cmpq(RAX, FieldAddress(RDI, RCX, TIMES_8, base));
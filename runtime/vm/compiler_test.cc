@@ -6,8 +6,12 @@
 #include "platform/assert.h"
 #include "vm/class_finalizer.h"
 #include "vm/code_patcher.h"
+#include "vm/compiler/compiler_pass.h"
+#include "vm/compiler/jit/code_cache.h"
 #include "vm/dart_api_impl.h"
+#include "vm/deopt_instructions.h"
 #include "vm/heap/safepoint.h"
+#include "vm/json_stream.h"
 #include "vm/kernel_isolate.h"
 #include "vm/object.h"
 #include "vm/symbols.h"
@@ -16,6 +20,10 @@
 
 namespace dart {
 
+DECLARE_FLAG(int, deoptimization_storm_threshold);
+DECLARE_FLAG(int, deoptimization_storm_window_millis);
+DECLARE_FLAG(bool, jit_global_object_pool);
+
 ISOLATE_UNIT_TEST_CASE(CompileFunction) {
   const char* kScriptChars =
       "class A {\n"
@@ -56,6 +64,185 @@ ISOLATE_UNIT_TEST_CASE(CompileFunction) {
                function_source.ToCString());
 }
 
+#if !defined(TARGET_ARCH_IA32)
+ISOLATE_UNIT_TEST_CASE(CompileFunction_GlobalObjectPool) {
+  SetFlagScope<bool> sfs(&FLAG_jit_global_object_pool, true);
+  const char* kScriptChars =
+      "class A {\n"
+      "  static foo() { return 'shared'; }\n"
+      "  static bar() { return 'shared'; }\n"
+      "}\n";
+  Dart_Handle library;
+  {
+    TransitionVMToNative transition(thread);
+    library = TestCase::LoadTestScript(kScriptChars, NULL);
+  }
+  const Library& lib =
+      Library::Handle(Library::RawCast(Api::UnwrapHandle(library)));
+  EXPECT(ClassFinalizer::ProcessPendingClasses());
+  Class& cls =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+  EXPECT(!cls.IsNull());
+  String& name = String::Handle(String::New("foo"));
+  const Function& foo = Function::Handle(cls.LookupStaticFunction(name));
+  name = String::New("bar");
+  const Function& bar = Function::Handle(cls.LookupStaticFunction(name));
+  EXPECT(CompilerTest::TestCompileFunction(foo));
+  EXPECT(CompilerTest::TestCompileFunction(bar));
+
+  // Both functions use the same pool, which has the string once.
+  const Code& foo_code = Code::Handle(foo.CurrentCode());
+  const Code& bar_code = Code::Handle(bar.CurrentCode());
+  EXPECT(foo_code.object_pool() == bar_code.object_pool());
+  const ObjectPool& pool = ObjectPool::Handle(foo_code.object_pool());
+  Object& entry = Object::Handle();
+  intptr_t count = 0;
+  for (intptr_t i = 0; i < pool.Length(); i++) {
+    if (pool.TypeAt(i) != ObjectPool::EntryType::kTaggedObject) continue;
+    entry = pool.ObjectAt(i);
+    if (entry.IsString() && String::Cast(entry).Equals("shared")) {
+      count++;
+    }
+  }
+  EXPECT_EQ(1, count);
+}
+#endif  // !defined(TARGET_ARCH_IA32)
+
+#if !defined(TARGET_ARCH_DBC)
+ISOLATE_UNIT_TEST_CASE(CodeCache_EvictUnusedCode) {
+  SetFlagScope<bool> sfs(&FLAG_collect_code, true);
+  const char* kScriptChars =
+      "class A {\n"
+      "  static foo() { return 42; }\n"
+      "  static bar() { return 43; }\n"
+      "}\n";
+  Dart_Handle library;
+  {
+    TransitionVMToNative transition(thread);
+    library = TestCase::LoadTestScript(kScriptChars, NULL);
+  }
+  const Library& lib =
+      Library::Handle(Library::RawCast(Api::UnwrapHandle(library)));
+  EXPECT(ClassFinalizer::ProcessPendingClasses());
+  Class& cls =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+  EXPECT(!cls.IsNull());
+  String& name = String::Handle(String::New("foo"));
+  const Function& foo = Function::Handle(cls.LookupStaticFunction(name));
+  name = String::New("bar");
+  const Function& bar = Function::Handle(cls.LookupStaticFunction(name));
+  EXPECT(CompilerTest::TestCompileFunction(foo));
+  EXPECT(CompilerTest::TestCompileFunction(bar));
+  bar.SetUsageCounter(10);
+
+  // The code of foo, which was never called, is evicted, and the usage of
+  // bar is aged.
+  Isolate* isolate = thread->isolate();
+  isolate->jit_code_cache()->Age(thread);
+  EXPECT(!foo.HasCode());
+  EXPECT(foo.unoptimized_code() == Code::null());
+  EXPECT(bar.HasCode());
+  EXPECT_EQ(5, bar.usage_counter());
+#if !defined(PRODUCT)
+  EXPECT(isolate->GetCodeCacheEvictionsMetric()->value() > 0);
+  EXPECT(isolate->GetCodeCacheSizeMetric()->value() > 0);
+#endif
+
+  // The code is compiled again when needed.
+  EXPECT(CompilerTest::TestCompileFunction(foo));
+  EXPECT(foo.HasCode());
+}
+#endif  // !defined(TARGET_ARCH_DBC)
+
+#if !defined(PRODUCT)
+ISOLATE_UNIT_TEST_CASE(CompilerPassStats) {
+  const char* kScriptChars =
+      "class A {\n"
+      "  static foo() { return 42; }\n"
+      "}\n";
+  Dart_Handle library;
+  {
+    TransitionVMToNative transition(thread);
+    library = TestCase::LoadTestScript(kScriptChars, NULL);
+  }
+  const Library& lib =
+      Library::Handle(Library::RawCast(Api::UnwrapHandle(library)));
+  EXPECT(ClassFinalizer::ProcessPendingClasses());
+  Class& cls =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+  EXPECT(!cls.IsNull());
+  const Function& function = Function::Handle(
+      cls.LookupStaticFunction(String::Handle(String::New("foo"))));
+  EXPECT(!function.IsNull());
+
+  CompilerPassStats stats;
+  stats.RecordPass(CompilerPass::kInlining, 30, 10, 25);
+  stats.RecordPass(CompilerPass::kInlining, 20, 12, 30);
+  stats.RecordPass(CompilerPass::kCSE, 5, 25, 20);
+  stats.RecordFunction(function, 55, 10, 20);
+  stats.RecordFunction(function, 45, 12, 18);
+
+  JSONStream js;
+  stats.PrintJSON(&js);
+  const char* json = js.ToCString();
+  EXPECT_SUBSTRING("\"type\":\"_CompilerPassStats\"", json);
+  EXPECT_SUBSTRING(
+      "{\"name\":\"Inlining\",\"runs\":2,\"micros\":50,"
+      "\"instructionsBefore\":22,\"instructionsAfter\":55}",
+      json);
+  EXPECT_SUBSTRING(
+      "{\"name\":\"CSE\",\"runs\":1,\"micros\":5,"
+      "\"instructionsBefore\":25,\"instructionsAfter\":20}",
+      json);
+  EXPECT_SUBSTRING("\"functionCount\":1", json);
+  EXPECT_SUBSTRING(
+      "\"compilations\":2,\"micros\":100,"
+      "\"instructionsBefore\":22,\"instructionsAfter\":38}",
+      json);
+}
+
+ISOLATE_UNIT_TEST_CASE(DeoptimizationStorm) {
+  const char* kScriptChars =
+      "class A {\n"
+      "  static foo() { return 42; }\n"
+      "}\n";
+  Dart_Handle library;
+  {
+    TransitionVMToNative transition(thread);
+    library = TestCase::LoadTestScript(kScriptChars, NULL);
+  }
+  const Library& lib =
+      Library::Handle(Library::RawCast(Api::UnwrapHandle(library)));
+  EXPECT(ClassFinalizer::ProcessPendingClasses());
+  Class& cls =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+  EXPECT(!cls.IsNull());
+  const Function& function = Function::Handle(
+      cls.LookupStaticFunction(String::Handle(String::New("foo"))));
+  EXPECT(!function.IsNull());
+
+  const int saved_threshold = FLAG_deoptimization_storm_threshold;
+  const int saved_window = FLAG_deoptimization_storm_window_millis;
+  FLAG_deoptimization_storm_threshold = 3;
+  FLAG_deoptimization_storm_window_millis = 60 * 1000;
+  DeoptStats stats;
+  EXPECT(!stats.Record(function, ICData::kDeoptCheckClass));
+  EXPECT(!stats.Record(function, ICData::kDeoptCheckSmi));
+  EXPECT(stats.Record(function, ICData::kDeoptCheckClass));
+  // A storm is only reported once.
+  EXPECT(!stats.Record(function, ICData::kDeoptCheckClass));
+  FLAG_deoptimization_storm_threshold = saved_threshold;
+  FLAG_deoptimization_storm_window_millis = saved_window;
+
+  JSONStream js;
+  stats.PrintJSON(&js);
+  EXPECT_SUBSTRING(
+      "\"deoptimizations\":4,\"storm\":true,"
+      "\"reasons\":{\"CheckSmi\":1,\"CheckClass\":3}",
+      js.ToCString());
+}
+#endif  // !defined(PRODUCT)
+
 ISOLATE_UNIT_TEST_CASE(OptimizeCompileFunctionOnHelperThread) {
   // Create a simple function and compile it without optimization.
   const char* kScriptChars =
@@ -456,6 +456,21 @@ enum LoadStoreExclusiveOp {
   STXR = LoadStoreExclusiveFixed,
 };
 
+// ARMv8.1 atomic memory operations (LSE).
+enum AtomicMemoryOp {
+  AtomicMemoryMask = 0x3f208c00,
+  AtomicMemoryFixed = B29 | B28 | B27 | B21,
+  LDCLR = AtomicMemoryFixed | B12,
+  LDSET = AtomicMemoryFixed | B13 | B12,
+};
+
+// ARMv8.1 compare and swap (LSE).
+enum CompareAndSwapOp {
+  CompareAndSwapMask = 0x3fa07c00,
+  CompareAndSwapFixed = B27 | B23 | B21 | B14 | B13 | B12 | B11 | B10,
+  CAS = CompareAndSwapFixed,
+};
+
 // C3.3.7-10
 enum LoadStoreRegOp {
   LoadStoreRegMask = 0x3a000000,
@@ -292,6 +292,15 @@ namespace dart {
 //
 //    Jump to the given target if SP[0] is true/false/null/not null.
 //
+//  - JumpIfNotIntGt target; JumpIfNotIntLt target; JumpIfNotIntGe target;
+//    JumpIfNotIntLe target
+//
+//    Superinstructions equivalent to CompareIntGt, CompareIntLt, CompareIntGe
+//    or CompareIntLe followed by JumpIfFalse target. Receiver and argument
+//    should have static type int.
+//    Check SP[-1] and SP[0] for null; pop both and jump to the given target
+//    unless SP[-1] <op> SP[0].
+//
 //  - IndirectStaticCall ArgC, D
 //
 //    Invoke the function given by the ICData in SP[0] with arguments
@@ -547,14 +556,14 @@ namespace dart {
   V(UnusedOpcode073,                       0, RESV, ___, ___, ___)             \
   V(UnusedOpcode074,                       0, RESV, ___, ___, ___)             \
   V(UnusedOpcode075,                       0, RESV, ___, ___, ___)             \
-  V(UnusedOpcode076,                       0, RESV, ___, ___, ___)             \
-  V(UnusedOpcode077,                       0, RESV, ___, ___, ___)             \
-  V(UnusedOpcode078,                       0, RESV, ___, ___, ___)             \
-  V(UnusedOpcode079,                       0, RESV, ___, ___, ___)             \
-  V(UnusedOpcode080,                       0, RESV, ___, ___, ___)             \
-  V(UnusedOpcode081,                       0, RESV, ___, ___, ___)             \
-  V(UnusedOpcode082,                       0, RESV, ___, ___, ___)             \
-  V(UnusedOpcode083,                       0, RESV, ___, ___, ___)             \
+  V(JumpIfNotIntGt,                        T, ORDN, tgt, ___, ___)             \
+  V(JumpIfNotIntGt_Wide,                   T, WIDE, tgt, ___, ___)             \
+  V(JumpIfNotIntLt,                        T, ORDN, tgt, ___, ___)             \
+  V(JumpIfNotIntLt_Wide,                   T, WIDE, tgt, ___, ___)             \
+  V(JumpIfNotIntGe,                        T, ORDN, tgt, ___, ___)             \
+  V(JumpIfNotIntGe_Wide,                   T, WIDE, tgt, ___, ___)             \
+  V(JumpIfNotIntLe,                        T, ORDN, tgt, ___, ___)             \
+  V(JumpIfNotIntLe_Wide,                   T, WIDE, tgt, ___, ___)             \
   V(UnusedOpcode084,                       0, RESV, ___, ___, ___)             \
   V(Trap,                                  0, ORDN, ___, ___, ___)             \
   V(Entry,                                 D, ORDN, num, ___, ___)             \
@@ -749,7 +758,7 @@ class KernelBytecode {
   // Maximum bytecode format version supported by VM.
   // The range of supported versions should include version produced by bytecode
   // generator (currentBytecodeFormatVersion in pkg/vm/lib/bytecode/dbc.dart).
-  static const intptr_t kMaxSupportedBytecodeFormatVersion = 11;
+  static const intptr_t kMaxSupportedBytecodeFormatVersion = 12;
 
   enum Opcode {
 #define DECLARE_BYTECODE(name, encoding, kind, op1, op2, op3) k##name,
@@ -880,6 +889,14 @@ class KernelBytecode {
       case KernelBytecode::kJumpIfNull_Wide:
       case KernelBytecode::kJumpIfNotNull:
       case KernelBytecode::kJumpIfNotNull_Wide:
+      case KernelBytecode::kJumpIfNotIntGt:
+      case KernelBytecode::kJumpIfNotIntGt_Wide:
+      case KernelBytecode::kJumpIfNotIntLt:
+      case KernelBytecode::kJumpIfNotIntLt_Wide:
+      case KernelBytecode::kJumpIfNotIntGe:
+      case KernelBytecode::kJumpIfNotIntGe_Wide:
+      case KernelBytecode::kJumpIfNotIntLe:
+      case KernelBytecode::kJumpIfNotIntLe_Wide:
         return true;
 
       default:
@@ -9,6 +9,7 @@
 #include "vm/cpu_arm64.h"
 
 #include "vm/cpuinfo.h"
+#include "vm/flags.h"
 #include "vm/simulator.h"
 
 #if !defined(USING_SIMULATOR)
@@ -22,6 +23,11 @@
 
 namespace dart {
 
+DEFINE_FLAG(bool,
+            use_atomic_memory,
+            true,
+            "Use ARMv8.1 atomic memory instructions if supported");
+
 void CPU::FlushICache(uword start, uword size) {
 #if HOST_OS_IOS
   // Precompilation never patches code so there should be no I cache flushes.
@@ -61,6 +67,7 @@ const char* CPU::Id() {
 }
 
 const char* HostCPUFeatures::hardware_ = NULL;
+bool HostCPUFeatures::atomic_memory_supported_ = false;
 #if defined(DEBUG)
 bool HostCPUFeatures::initialized_ = false;
 #endif
@@ -69,6 +76,13 @@ bool HostCPUFeatures::initialized_ = false;
 void HostCPUFeatures::Init() {
   CpuInfo::Init();
   hardware_ = CpuInfo::GetCpuModel();
+  // Code generated ahead of time may run on any ARMv8.0 CPU, so precompiled
+  // code does not depend on the host having LSE atomics.
+#if defined(HOST_OS_ANDROID) || defined(HOST_OS_LINUX)
+  atomic_memory_supported_ =
+      FLAG_use_atomic_memory && !FLAG_precompiled_mode &&
+      CpuInfo::FieldContains(kCpuInfoFeatures, "atomics");
+#endif
 #if defined(DEBUG)
   initialized_ = true;
 #endif
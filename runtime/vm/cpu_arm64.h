@@ -26,9 +26,14 @@ class HostCPUFeatures : public AllStatic {
     DEBUG_ASSERT(initialized_);
     return hardware_;
   }
+  static bool atomic_memory_supported() {
+    DEBUG_ASSERT(initialized_);
+    return atomic_memory_supported_;
+  }
 
  private:
   static const char* hardware_;
+  static bool atomic_memory_supported_;
 #if defined(DEBUG)
   static bool initialized_;
 #endif
@@ -40,6 +45,10 @@ class TargetCPUFeatures : public AllStatic {
   static void Cleanup() { HostCPUFeatures::Cleanup(); }
   static const char* hardware() { return HostCPUFeatures::hardware(); }
   static bool double_truncate_round_supported() { return false; }
+  // ARMv8.1 LSE atomics (ldclr, ldset, cas).
+  static bool atomic_memory_supported() {
+    return HostCPUFeatures::atomic_memory_supported();
+  }
 };
 
 }  // namespace dart
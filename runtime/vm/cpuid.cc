@@ -19,6 +19,7 @@ namespace dart {
 
 bool CpuId::sse2_ = false;
 bool CpuId::sse41_ = false;
+bool CpuId::avx_ = false;
 const char* CpuId::id_string_ = NULL;
 const char* CpuId::brand_string_ = NULL;
 
@@ -34,6 +35,17 @@ void CpuId::GetCpuId(int32_t level, uint32_t info[4]) {
 #endif
 }
 
+// Whether the OS saves the AVX (YMM) register state on context switches.
+static bool OSSavesAVXState() {
+#if defined(HOST_OS_WINDOWS)
+  return (_xgetbv(0) & 6) == 6;
+#else
+  uint32_t eax, edx;
+  asm volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (eax & 6) == 6;
+#endif
+}
+
 void CpuId::Init() {
   uint32_t info[4] = {static_cast<uint32_t>(-1)};
 
@@ -48,6 +60,10 @@ void CpuId::Init() {
   GetCpuId(1, info);
   CpuId::sse41_ = (info[2] & (1 << 19)) != 0;
   CpuId::sse2_ = (info[3] & (1 << 26)) != 0;
+  // AVX needs both the CPU support and OSXSAVE.
+  const uint32_t kAVXAndOSXSAVE = (1 << 28) | (1 << 27);
+  CpuId::avx_ =
+      ((info[2] & kAVXAndOSXSAVE) == kAVXAndOSXSAVE) && OSSavesAVXState();
 
   char* brand_string =
       reinterpret_cast<char*>(malloc(3 * 4 * sizeof(uint32_t)));
@@ -89,15 +105,10 @@ const char* CpuId::field(CpuInfoIndices idx) {
     case kCpuInfoHardware:
       return brand_string();
     case kCpuInfoFeatures: {
-      if (sse2() && sse41()) {
-        return strdup("sse2 sse4.1");
-      } else if (sse2()) {
-        return strdup("sse2");
-      } else if (sse41()) {
-        return strdup("sse4.1");
-      } else {
-        return strdup("");
-      }
+      char buffer[32];
+      snprintf(buffer, sizeof(buffer), "%s%s%s", sse2() ? "sse2 " : "",
+               sse41() ? "sse4.1 " : "", avx() ? "avx " : "");
+      return strdup(buffer);
     }
     default: {
       UNREACHABLE();
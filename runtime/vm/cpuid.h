@@ -33,9 +33,11 @@ class CpuId : public AllStatic {
 
   static bool sse2() { return sse2_; }
   static bool sse41() { return sse41_; }
+  static bool avx() { return avx_; }
 
   static bool sse2_;
   static bool sse41_;
+  static bool avx_;
   static const char* id_string_;
   static const char* brand_string_;
 
@@ -35,6 +35,7 @@
 #include "vm/simulator.h"
 #include "vm/snapshot.h"
 #include "vm/stack_frame.h"
+#include "vm/startup_phases.h"
 #include "vm/stub_code.h"
 #include "vm/symbols.h"
 #include "vm/thread_interrupter.h"
@@ -49,6 +50,7 @@ DECLARE_FLAG(bool, print_class_table);
 DEFINE_FLAG(bool, keep_code, false, "Keep deoptimized code for profiling.");
 DEFINE_FLAG(bool, trace_shutdown, false, "Trace VM shutdown on stderr");
 DECLARE_FLAG(bool, strong);
+DECLARE_FLAG(int, thread_pool_max_workers);
 
 Isolate* Dart::vm_isolate_ = NULL;
 int64_t Dart::start_time_micros_ = 0;
@@ -205,6 +207,7 @@ char* Dart::Init(const uint8_t* vm_isolate_snapshot,
   Timeline::Init();
   TimelineDurationScope tds(Timeline::GetVMStream(), "Dart::Init");
 #endif
+  STARTUP_PHASE("VMInitialize");
   Isolate::InitVM();
   PortMap::Init();
   FreeListElement::Init();
@@ -225,7 +228,7 @@ char* Dart::Init(const uint8_t* vm_isolate_snapshot,
   predefined_handles_ = new ReadOnlyHandles();
   // Create the VM isolate and finish the VM initialization.
   ASSERT(thread_pool_ == NULL);
-  thread_pool_ = new ThreadPool();
+  thread_pool_ = new ThreadPool(FLAG_thread_pool_max_workers);
   {
     ASSERT(vm_isolate_ == NULL);
     ASSERT(Flags::Initialized());
@@ -253,6 +256,7 @@ char* Dart::Init(const uint8_t* vm_isolate_snapshot,
 #if defined(SUPPORT_TIMELINE)
       TimelineDurationScope tds(Timeline::GetVMStream(), "ReadVMSnapshot");
 #endif
+      STARTUP_PHASE("ReadVMSnapshot");
       ASSERT(snapshot != nullptr);
       vm_snapshot_kind_ = snapshot->kind();
 
@@ -370,17 +374,19 @@ char* Dart::Init(const uint8_t* vm_isolate_snapshot,
   const bool is_dart2_aot_precompiler =
       FLAG_precompiled_mode && !kDartPrecompiledRuntime;
 
-  if (!is_dart2_aot_precompiler &&
-      (FLAG_support_service || !kDartPrecompiledRuntime)) {
-    ServiceIsolate::Run();
-  }
-
+  // The kernel isolate is started first: the embedder's first compile waits
+  // for it, while nothing on the startup path waits for the service isolate.
 #ifndef DART_PRECOMPILED_RUNTIME
   if (start_kernel_isolate) {
     KernelIsolate::Run();
   }
 #endif  // DART_PRECOMPILED_RUNTIME
 
+  if (!is_dart2_aot_precompiler &&
+      (FLAG_support_service || !kDartPrecompiledRuntime)) {
+    ServiceIsolate::Run();
+  }
+
   return NULL;
 }
 
@@ -447,6 +453,9 @@ char* Dart::Cleanup() {
   }
 
 #if !defined(PRODUCT)
+  if (FLAG_print_startup_phases) {
+    StartupPhases::Print();
+  }
   if (FLAG_trace_shutdown) {
     OS::PrintErr("[+%" Pd64 "ms] SHUTDOWN: Shutting down profiling\n",
                  UptimeMillis());
@@ -650,6 +659,7 @@ RawError* Dart::InitializeIsolate(const uint8_t* snapshot_data,
     TimelineDurationScope tds(T, Timeline::GetIsolateStream(),
                               "ReadIsolateSnapshot");
 #endif
+    STARTUP_PHASE("ReadIsolateSnapshot");
     // TODO(turnidge): Remove once length is not part of the snapshot.
     const Snapshot* snapshot = Snapshot::SetupFromBuffer(snapshot_data);
     if (snapshot == NULL) {
@@ -819,6 +829,10 @@ const char* Dart::FeaturesString(Isolate* isolate,
 #else
     buffer.AddString(" arm64-sysv");
 #endif
+    // Code using LSE atomics does not run on ARMv8.0.
+    if (TargetCPUFeatures::atomic_memory_supported()) {
+      buffer.AddString(" lse");
+    }
 #elif defined(TARGET_ARCH_IA32)
     buffer.AddString(" ia32");
 #elif defined(TARGET_ARCH_X64)
@@ -827,6 +841,10 @@ const char* Dart::FeaturesString(Isolate* isolate,
 #else
     buffer.AddString(" x64-sysv");
 #endif
+    // Code using VEX encoded instructions does not run without AVX.
+    if (TargetCPUFeatures::avx_supported()) {
+      buffer.AddString(" avx");
+    }
 
 #elif defined(TARGET_ARCH_DBC)
 #if defined(ARCH_IS_32_BIT)
@@ -37,6 +37,7 @@
 #include "vm/native_entry.h"
 #include "vm/native_symbol.h"
 #include "vm/object.h"
+#include "vm/object_graph.h"
 #include "vm/object_store.h"
 #include "vm/os.h"
 #include "vm/os_thread.h"
@@ -985,6 +986,17 @@ DART_EXPORT void Dart_DeleteWeakPersistentHandle(
   state->weak_persistent_handles().FreeHandle(weak_ref);
 }
 
+DART_EXPORT void Dart_SetFinalizeOnShutdown(Dart_WeakPersistentHandle object,
+                                            bool finalize_on_shutdown) {
+  Isolate* isolate = Isolate::Current();
+  CHECK_ISOLATE(isolate);
+  NoSafepointScope no_safepoint_scope;
+  ASSERT(isolate->api_state()->IsValidWeakPersistentHandle(object));
+  FinalizablePersistentHandle* weak_ref =
+      FinalizablePersistentHandle::Cast(object);
+  weak_ref->set_finalize_on_shutdown(finalize_on_shutdown);
+}
+
 // --- Initialization and Globals ---
 
 DART_EXPORT const char* Dart_VersionString() {
@@ -1045,6 +1057,83 @@ VM_METRIC_LIST(VM_METRIC_API);
   }
 ISOLATE_METRIC_LIST(ISOLATE_METRIC_API);
 #undef ISOLATE_METRIC_API
+
+COMPILE_ASSERT(static_cast<intptr_t>(Dart_GCPause_MarkingFinalization) ==
+               static_cast<intptr_t>(Heap::kMarkingFinalizationPause));
+
+static const PauseHistogram& GCPauseHistogram(Dart_Isolate isolate,
+                                              Dart_GCPauseKind kind,
+                                              const char* func) {
+  if (isolate == NULL) {
+    FATAL1("%s expects argument 'isolate' to be non-null.", func);
+  }
+  if ((kind < Dart_GCPause_Scavenge) ||
+      (kind > Dart_GCPause_MarkingFinalization)) {
+    FATAL2("%s: invalid pause kind %d.", func, kind);
+  }
+  Isolate* iso = reinterpret_cast<Isolate*>(isolate);
+  return iso->heap()->pause_histogram(static_cast<Heap::PauseKind>(kind));
+}
+
+DART_EXPORT int64_t Dart_IsolateGCPauseCountMetric(Dart_Isolate isolate,
+                                                   Dart_GCPauseKind kind) {
+  return GCPauseHistogram(isolate, kind, CURRENT_FUNC).count();
+}
+
+DART_EXPORT int64_t Dart_IsolateGCPausePercentileMetric(Dart_Isolate isolate,
+                                                        Dart_GCPauseKind kind,
+                                                        double percentile) {
+  return GCPauseHistogram(isolate, kind, CURRENT_FUNC).Percentile(percentile);
+}
+
+DART_EXPORT int64_t
+Dart_IsolateMessageLatencyPercentileMetric(Dart_Isolate isolate,
+                                           double percentile) {
+  if (isolate == NULL) {
+    FATAL1("%s expects argument 'isolate' to be non-null.", CURRENT_FUNC);
+  }
+  Isolate* iso = reinterpret_cast<Isolate*>(isolate);
+  return iso->message_handler()->latency_histogram().Percentile(percentile);
+}
+
+DART_EXPORT intptr_t Dart_VMMetricsSnapshot(Dart_MetricValue* metrics,
+                                            intptr_t length) {
+  if ((metrics == NULL) && (length > 0)) {
+    FATAL1("%s expects argument 'metrics' to be non-null.", CURRENT_FUNC);
+  }
+  intptr_t count = 0;
+#define VM_METRIC_SNAPSHOT(type, variable, metric_name, unit)                  \
+  if (count < length) {                                                        \
+    metrics[count].name = metric_name;                                         \
+    metrics[count].value = vm_metric_##variable.CurrentValue();                \
+  }                                                                            \
+  count++;
+  VM_METRIC_LIST(VM_METRIC_SNAPSHOT);
+#undef VM_METRIC_SNAPSHOT
+  return count;
+}
+
+DART_EXPORT intptr_t Dart_IsolateMetricsSnapshot(Dart_Isolate isolate,
+                                                 Dart_MetricValue* metrics,
+                                                 intptr_t length) {
+  if (isolate == NULL) {
+    FATAL1("%s expects argument 'isolate' to be non-null.", CURRENT_FUNC);
+  }
+  if ((metrics == NULL) && (length > 0)) {
+    FATAL1("%s expects argument 'metrics' to be non-null.", CURRENT_FUNC);
+  }
+  Isolate* iso = reinterpret_cast<Isolate*>(isolate);
+  intptr_t count = 0;
+#define ISOLATE_METRIC_SNAPSHOT(type, variable, metric_name, unit)             \
+  if (count < length) {                                                        \
+    metrics[count].name = metric_name;                                         \
+    metrics[count].value = iso->Get##variable##Metric()->CurrentValue();       \
+  }                                                                            \
+  count++;
+  ISOLATE_METRIC_LIST(ISOLATE_METRIC_SNAPSHOT);
+#undef ISOLATE_METRIC_SNAPSHOT
+  return count;
+}
 #else  // !defined(PRODUCT)
 #define VM_METRIC_API(type, variable, name, unit)                              \
   DART_EXPORT int64_t Dart_VM##variable##Metric() { return -1; }
@@ -1056,6 +1145,34 @@ VM_METRIC_LIST(VM_METRIC_API);
     return -1;                                                                 \
   }
 ISOLATE_METRIC_LIST(ISOLATE_METRIC_API);
+
+DART_EXPORT int64_t Dart_IsolateGCPauseCountMetric(Dart_Isolate isolate,
+                                                   Dart_GCPauseKind kind) {
+  return -1;
+}
+
+DART_EXPORT int64_t Dart_IsolateGCPausePercentileMetric(Dart_Isolate isolate,
+                                                        Dart_GCPauseKind kind,
+                                                        double percentile) {
+  return -1;
+}
+
+DART_EXPORT int64_t
+Dart_IsolateMessageLatencyPercentileMetric(Dart_Isolate isolate,
+                                           double percentile) {
+  return -1;
+}
+
+DART_EXPORT intptr_t Dart_VMMetricsSnapshot(Dart_MetricValue* metrics,
+                                            intptr_t length) {
+  return 0;
+}
+
+DART_EXPORT intptr_t Dart_IsolateMetricsSnapshot(Dart_Isolate isolate,
+                                                 Dart_MetricValue* metrics,
+                                                 intptr_t length) {
+  return 0;
+}
 #endif  // !defined(PRODUCT)
 
 // --- Isolates ---
@@ -1130,6 +1247,9 @@ Isolate* CreateIsolateFromExistingSource(IsolateGroupSource* source,
 
   Isolate* isolate = reinterpret_cast<Isolate*>(
       CreateIsolate(source, name, /*isolate_data=*/nullptr, error));
+  if (isolate == nullptr) {
+    return nullptr;
+  }
   RELEASE_ASSERT(isolate->source() == source);
 
   if (source->script_kernel_buffer != nullptr) {
@@ -1583,6 +1703,21 @@ DART_EXPORT void Dart_NotifyLowMemory() {
   Isolate::NotifyLowMemory();
 }
 
+DART_EXPORT void Dart_ReportExternalAllocation(intptr_t size) {
+  Thread* T = Thread::Current();
+  CHECK_ISOLATE(T->isolate());
+  ASSERT(size >= 0);
+  TransitionNativeToVM transition(T);
+  T->isolate()->heap()->AllocateExternal(kIllegalCid, size, Heap::kOld);
+}
+
+DART_EXPORT void Dart_ReportExternalFree(intptr_t size) {
+  Thread* T = Thread::Current();
+  CHECK_ISOLATE(T->isolate());
+  ASSERT(size >= 0);
+  T->isolate()->heap()->FreeExternal(size, Heap::kOld);
+}
+
 DART_EXPORT void Dart_ExitIsolate() {
   Thread* T = Thread::Current();
   CHECK_ISOLATE(T->isolate());
@@ -1680,6 +1815,15 @@ DART_EXPORT char* Dart_IsolateMakeRunnable(Dart_Isolate isolate) {
   return NULL;
 }
 
+DART_EXPORT void Dart_SetIsolateSpawnPoolSize(intptr_t size) {
+  Isolate* isolate = Isolate::Current();
+  CHECK_ISOLATE(isolate);
+  if (size < 0) {
+    FATAL1("%s expects argument 'size' to be non-negative.", CURRENT_FUNC);
+  }
+  isolate->source()->spawn_pool.SetCapacity(size);
+}
+
 // --- Messages and Ports ---
 
 DART_EXPORT void Dart_SetMessageNotifyCallback(
@@ -1946,6 +2090,28 @@ DART_EXPORT uint8_t* Dart_ScopeAllocate(intptr_t size) {
   return reinterpret_cast<uint8_t*>(zone->AllocUnsafe(size));
 }
 
+DART_EXPORT Dart_Arena Dart_NewArena() {
+  return (new ApiArena())->apiArena();
+}
+
+DART_EXPORT uint8_t* Dart_ArenaAllocate(Dart_Arena arena, intptr_t size) {
+  if (arena == NULL) {
+    FATAL1("%s expects argument 'arena' to be non-null.", CURRENT_FUNC);
+  }
+  return reinterpret_cast<uint8_t*>(ApiArena::Cast(arena)->AllocUnsafe(size));
+}
+
+DART_EXPORT void Dart_ResetArena(Dart_Arena arena) {
+  if (arena == NULL) {
+    FATAL1("%s expects argument 'arena' to be non-null.", CURRENT_FUNC);
+  }
+  ApiArena::Cast(arena)->Reset();
+}
+
+DART_EXPORT void Dart_DeleteArena(Dart_Arena arena) {
+  delete ApiArena::Cast(arena);
+}
+
 // --- Objects ----
 
 DART_EXPORT Dart_Handle Dart_Null() {
@@ -2615,6 +2781,42 @@ Dart_NewExternalLatin1String(const uint8_t* latin1_array,
                           callback, T->heap()->SpaceForExternal(length)));
 }
 
+DART_EXPORT Dart_Handle
+Dart_NewExternalUTF8String(const uint8_t* utf8_array,
+                           intptr_t length,
+                           void* peer,
+                           intptr_t external_allocation_size,
+                           Dart_WeakPersistentHandleFinalizer callback) {
+  DARTSCOPE(Thread::Current());
+  API_TIMELINE_DURATION(T);
+  if (utf8_array == NULL && length != 0) {
+    RETURN_NULL_ERROR(utf8_array);
+  }
+  if (callback == NULL) {
+    RETURN_NULL_ERROR(callback);
+  }
+  CHECK_LENGTH(length, String::kMaxElements);
+  CHECK_CALLBACK_STATE(T);
+  // ASCII is also Latin-1, so mostly ASCII text is referenced in place.
+  if (Utf8::AsciiPrefixLength(utf8_array, length) == length) {
+    return Api::NewHandle(
+        T, String::NewExternal(utf8_array, length, peer,
+                               external_allocation_size, callback,
+                               T->heap()->SpaceForExternal(length)));
+  }
+  if (!Utf8::IsValid(utf8_array, length)) {
+    return Api::NewError("%s expects argument 'utf8_array' to be valid UTF-8.",
+                         CURRENT_FUNC);
+  }
+  // The decoded string owns the array like an external string would, so the
+  // callback is called at the same time in either case.
+  const String& result =
+      String::Handle(Z, String::FromUTF8(utf8_array, length));
+  AllocateFinalizableHandle(T, result, peer, external_allocation_size,
+                            callback);
+  return Api::NewHandle(T, result.raw());
+}
+
 DART_EXPORT Dart_Handle
 Dart_NewExternalUTF16String(const uint16_t* utf16_array,
                             intptr_t length,
@@ -2920,7 +3122,7 @@ DART_EXPORT Dart_Handle Dart_ListGetAt(Dart_Handle list, intptr_t index) {
 
 #define GET_LIST_RANGE(thread, type, obj, offset, length)                      \
   const type& array_obj = type::Cast(obj);                                     \
-  if ((offset >= 0) && (offset + length <= array_obj.Length())) {              \
+  if (Utils::RangeCheck(offset, length, array_obj.Length())) {                 \
     for (intptr_t index = 0; index < length; ++index) {                        \
       result[index] = Api::NewHandle(thread, array_obj.At(index + offset));    \
     }                                                                          \
@@ -2953,14 +3155,14 @@ DART_EXPORT Dart_Handle Dart_ListGetRange(Dart_Handle list,
       ArgumentsDescriptor args_desc(
           Array::Handle(ArgumentsDescriptor::New(kTypeArgsLen, kNumArgs)));
       const Function& function = Function::Handle(
-          Z, Resolver::ResolveDynamic(instance, Symbols::AssignIndexToken(),
-                                      args_desc));
+          Z,
+          Resolver::ResolveDynamic(instance, Symbols::IndexToken(), args_desc));
       if (!function.IsNull()) {
         const Array& args = Array::Handle(Array::New(kNumArgs));
         args.SetAt(0, instance);
         Instance& index = Instance::Handle(Z);
         for (intptr_t i = 0; i < length; ++i) {
-          index = Integer::New(i);
+          index = Integer::New(offset + i);
           args.SetAt(1, index);
           Dart_Handle value =
               Api::NewHandle(T, DartEntry::InvokeFunction(function, args));
@@ -2974,6 +3176,144 @@ DART_EXPORT Dart_Handle Dart_ListGetRange(Dart_Handle list,
   }
 }
 
+// Element readers for Dart_ListGetRangeAsInt64 and Dart_ListGetRangeAsDouble.
+// They read an element without allocating a handle, and return false if it
+// does not have the expected type.
+struct Int64ListElement {
+  typedef int64_t Type;
+  static const char* Name() { return "int"; }
+  static bool Get(RawObject* raw, int64_t* result) {
+    if (!raw->IsHeapObject() || raw->IsMint()) {
+      *result = Integer::GetInt64Value(static_cast<RawInteger*>(raw));
+      return true;
+    }
+    return false;
+  }
+};
+
+struct DoubleListElement {
+  typedef double Type;
+  static const char* Name() { return "num"; }
+  static bool Get(RawObject* raw, double* result) {
+    if (raw->IsHeapObject() && raw->IsDouble()) {
+      *result = Double::GetDoubleValue(static_cast<RawDouble*>(raw));
+      return true;
+    }
+    int64_t value;
+    if (Int64ListElement::Get(raw, &value)) {
+      *result = static_cast<double>(value);
+      return true;
+    }
+    return false;
+  }
+};
+
+template <typename Element, typename ListType>
+static bool GetListRangeAs(const ListType& list,
+                           intptr_t offset,
+                           intptr_t length,
+                           typename Element::Type* result) {
+  NoSafepointScope no_safepoint;
+  for (intptr_t i = 0; i < length; i++) {
+    if (!Element::Get(list.At(offset + i), &result[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename Element>
+static Dart_Handle GetListRangeAs(Thread* thread,
+                                  Dart_Handle list,
+                                  intptr_t offset,
+                                  intptr_t length,
+                                  typename Element::Type* result,
+                                  const char* func) {
+  Zone* zone = thread->zone();
+  const Object& obj = Object::Handle(zone, Api::UnwrapHandle(list));
+  if (obj.IsArray() || obj.IsGrowableObjectArray()) {
+    const intptr_t list_length =
+        obj.IsArray() ? Array::Cast(obj).Length()
+                      : GrowableObjectArray::Cast(obj).Length();
+    if (!Utils::RangeCheck(offset, length, list_length)) {
+      return Api::NewError("Invalid offset/length passed in to access list");
+    }
+    bool ok;
+    if (obj.IsArray()) {
+      ok = GetListRangeAs<Element>(Array::Cast(obj), offset, length, result);
+    } else {
+      ok = GetListRangeAs<Element>(GrowableObjectArray::Cast(obj), offset,
+                                   length, result);
+    }
+    if (!ok) {
+      return Api::NewError("%s expects argument 'list' to be a List of %s.",
+                           func, Element::Name());
+    }
+    return Api::Success();
+  }
+  if (obj.IsError()) {
+    return list;
+  }
+  CHECK_CALLBACK_STATE(thread);
+
+  // Check and handle a dart object that implements the List interface.
+  const Instance& instance = Instance::Handle(zone, GetListInstance(zone, obj));
+  if (!instance.IsNull()) {
+    const intptr_t kTypeArgsLen = 0;
+    const intptr_t kNumArgs = 2;
+    ArgumentsDescriptor args_desc(
+        Array::Handle(zone, ArgumentsDescriptor::New(kTypeArgsLen, kNumArgs)));
+    const Function& function = Function::Handle(
+        zone,
+        Resolver::ResolveDynamic(instance, Symbols::IndexToken(), args_desc));
+    if (!function.IsNull()) {
+      Object& element = Object::Handle(zone);
+      Integer& index = Integer::Handle(zone);
+      const Array& args = Array::Handle(zone, Array::New(kNumArgs));
+      args.SetAt(0, instance);
+      for (intptr_t i = 0; i < length; i++) {
+        HANDLESCOPE(thread);
+        index = Integer::New(offset + i);
+        args.SetAt(1, index);
+        element = DartEntry::InvokeFunction(function, args);
+        if (element.IsError()) {
+          return Api::NewHandle(thread, element.raw());
+        }
+        if (!Element::Get(element.raw(), &result[i])) {
+          return Api::NewError("%s expects argument 'list' to be a List of %s.",
+                               func, Element::Name());
+        }
+      }
+      return Api::Success();
+    }
+  }
+  return Api::NewError("Object does not implement the 'List' interface");
+}
+
+DART_EXPORT Dart_Handle Dart_ListGetRangeAsInt64(Dart_Handle list,
+                                                 intptr_t offset,
+                                                 intptr_t length,
+                                                 int64_t* result) {
+  DARTSCOPE(Thread::Current());
+  if (result == NULL) {
+    RETURN_NULL_ERROR(result);
+  }
+  return GetListRangeAs<Int64ListElement>(T, list, offset, length, result,
+                                          CURRENT_FUNC);
+}
+
+DART_EXPORT Dart_Handle Dart_ListGetRangeAsDouble(Dart_Handle list,
+                                                  intptr_t offset,
+                                                  intptr_t length,
+                                                  double* result) {
+  DARTSCOPE(Thread::Current());
+  if (result == NULL) {
+    RETURN_NULL_ERROR(result);
+  }
+  return GetListRangeAs<DoubleListElement>(T, list, offset, length, result,
+                                           CURRENT_FUNC);
+}
+
 #define SET_LIST_ELEMENT(type, obj, index, value)                              \
   const type& array = type::Cast(obj);                                         \
   const Object& value_obj = Object::Handle(Z, Api::UnwrapHandle(value));       \
@@ -3703,6 +4043,39 @@ static RawObject* GetByteBufferConstructor(Thread* thread,
                             num_args);
 }
 
+DART_EXPORT Dart_Handle Dart_NewTransferableTypedData(uint8_t* const* chunks,
+                                                      const intptr_t* lengths,
+                                                      intptr_t num_chunks) {
+  DARTSCOPE(Thread::Current());
+  if (chunks == NULL) {
+    RETURN_NULL_ERROR(chunks);
+  }
+  if (lengths == NULL) {
+    RETURN_NULL_ERROR(lengths);
+  }
+  if (num_chunks <= 0) {
+    return Api::NewError("%s expects argument 'num_chunks' to be positive.",
+                         CURRENT_FUNC);
+  }
+  const intptr_t max_length = TypedData::MaxElements(kTypedDataUint8ArrayCid);
+  intptr_t total_length = 0;
+  for (intptr_t i = 0; i < num_chunks; i++) {
+    if ((chunks[i] == NULL) && (lengths[i] != 0)) {
+      RETURN_NULL_ERROR(chunks);
+    }
+    if ((lengths[i] < 0) || (lengths[i] > max_length - total_length)) {
+      return Api::NewError(
+          "%s expects the total length to be between 0 and %" Pd ".",
+          CURRENT_FUNC, max_length);
+    }
+    total_length += lengths[i];
+  }
+  CHECK_CALLBACK_STATE(T);
+  return Api::NewHandle(
+      T, TransferableTypedData::New(
+             new TransferableTypedDataPeer(chunks, lengths, num_chunks)));
+}
+
 DART_EXPORT Dart_Handle Dart_NewByteBuffer(Dart_Handle typed_data) {
   DARTSCOPE(Thread::Current());
   intptr_t class_id = Api::ClassId(typed_data);
@@ -4352,6 +4725,105 @@ DART_EXPORT Dart_Handle Dart_Invoke(Dart_Handle target,
   }
 }
 
+DART_EXPORT Dart_Handle Dart_LookupFunction(Dart_Handle target,
+                                           Dart_Handle name) {
+  DARTSCOPE(Thread::Current());
+  API_TIMELINE_DURATION(T);
+  CHECK_CALLBACK_STATE(T);
+
+  String& function_name =
+      String::Handle(Z, Api::UnwrapStringHandle(Z, name).raw());
+  if (function_name.IsNull()) {
+    RETURN_TYPE_ERROR(Z, name, String);
+  }
+  const Object& obj = Object::Handle(Z, Api::UnwrapHandle(target));
+  if (obj.IsError()) {
+    return target;
+  }
+  Function& function = Function::Handle(Z);
+  if (obj.IsType()) {
+    if (!Type::Cast(obj).IsFinalized()) {
+      return Api::NewError(
+          "%s expects argument 'target' to be a fully resolved type.",
+          CURRENT_FUNC);
+    }
+    const Class& cls = Class::Handle(Z, Type::Cast(obj).type_class());
+    CHECK_ERROR_HANDLE(cls.EnsureIsFinalized(T));
+    if (Library::IsPrivate(function_name)) {
+      const Library& lib = Library::Handle(Z, cls.library());
+      function_name = lib.PrivateName(function_name);
+    }
+    function = cls.LookupStaticFunction(function_name);
+  } else if (obj.IsLibrary()) {
+    const Library& lib = Library::Cast(obj);
+    if (!lib.Loaded()) {
+      return Api::NewError("%s expects library argument 'target' to be loaded.",
+                           CURRENT_FUNC);
+    }
+    if (Library::IsPrivate(function_name)) {
+      function_name = lib.PrivateName(function_name);
+    }
+    const Object& entry =
+        Object::Handle(Z, lib.LookupLocalOrReExportObject(function_name));
+    if (entry.IsFunction()) {
+      function ^= entry.raw();
+    }
+  } else {
+    return Api::NewError(
+        "%s expects argument 'target' to be a type or library.", CURRENT_FUNC);
+  }
+  if (function.IsNull()) {
+    return Api::NewError("%s: did not find function '%s'.", CURRENT_FUNC,
+                         function_name.ToCString());
+  }
+  if (FLAG_verify_entry_points) {
+    CHECK_ERROR_HANDLE(function.VerifyCallEntryPoint());
+  }
+  return Api::NewHandle(T, function.raw());
+}
+
+DART_EXPORT Dart_Handle Dart_InvokeFunction(Dart_Handle function,
+                                           int number_of_arguments,
+                                           Dart_Handle* arguments) {
+  DARTSCOPE(Thread::Current());
+  API_TIMELINE_DURATION(T);
+  CHECK_CALLBACK_STATE(T);
+
+  const Object& obj = Object::Handle(Z, Api::UnwrapHandle(function));
+  if (!obj.IsFunction()) {
+    RETURN_TYPE_ERROR(Z, function, Function);
+  }
+  const Function& func = Function::Cast(obj);
+  if (number_of_arguments < 0) {
+    return Api::NewError(
+        "%s expects argument 'number_of_arguments' to be non-negative.",
+        CURRENT_FUNC);
+  }
+  Array& args = Array::Handle(Z);
+  Dart_Handle result =
+      SetupArguments(T, number_of_arguments, arguments, 0, &args);
+  if (Api::IsError(result)) {
+    return result;
+  }
+  // Descriptors for unnamed arguments are cached by the VM.
+  const int kTypeArgsLen = 0;
+  const Array& args_descriptor_array = Array::Handle(
+      Z, ArgumentsDescriptor::New(kTypeArgsLen, number_of_arguments));
+  ArgumentsDescriptor args_descriptor(args_descriptor_array);
+  if (!func.AreValidArguments(args_descriptor, NULL)) {
+    return Api::NewError("%s: wrong number of arguments for '%s'.",
+                         CURRENT_FUNC, func.ToFullyQualifiedCString());
+  }
+  const Object& type_error = Object::Handle(
+      Z, func.DoArgumentTypesMatch(args, args_descriptor,
+                                   Object::null_type_arguments()));
+  if (!type_error.IsNull()) {
+    return Api::NewHandle(T, type_error.raw());
+  }
+  return Api::NewHandle(
+      T, DartEntry::InvokeFunction(func, args, args_descriptor_array));
+}
+
 DART_EXPORT Dart_Handle Dart_InvokeClosure(Dart_Handle closure,
                                            int number_of_arguments,
                                            Dart_Handle* arguments) {
@@ -5545,6 +6017,18 @@ Dart_GetNativeResolver(Dart_Handle library,
   return Api::Success();
 }
 
+DART_EXPORT Dart_Handle
+Dart_SetFfiNativeResolver(Dart_Handle library,
+                          Dart_FfiNativeResolver resolver) {
+  DARTSCOPE(Thread::Current());
+  const Library& lib = Api::UnwrapLibraryHandle(Z, library);
+  if (lib.IsNull()) {
+    RETURN_TYPE_ERROR(Z, library, Library);
+  }
+  lib.set_ffi_native_resolver(resolver);
+  return Api::Success();
+}
+
 DART_EXPORT Dart_Handle Dart_GetNativeSymbol(Dart_Handle library,
                                              Dart_NativeEntrySymbol* resolver) {
   if (resolver == NULL) {
@@ -5834,6 +6318,45 @@ DART_EXPORT Dart_Handle Dart_ServiceSendDataEvent(const char* stream_id,
   return Api::Success();
 }
 
+class CallbackHeapSnapshotWriter : public HeapSnapshotWriter {
+ public:
+  CallbackHeapSnapshotWriter(Dart_HeapSnapshotWriteChunkCallback write,
+                             void* context)
+      : write_(write), context_(context) {}
+
+ protected:
+  virtual void WriteChunk(uint8_t* chunk,
+                          intptr_t size,
+                          intptr_t chunk_index,
+                          bool is_last) {
+    write_(context_, chunk, size, is_last);
+  }
+
+ private:
+  Dart_HeapSnapshotWriteChunkCallback write_;
+  void* context_;
+
+  DISALLOW_COPY_AND_ASSIGN(CallbackHeapSnapshotWriter);
+};
+
+DART_EXPORT char* Dart_WriteHeapSnapshot(
+    Dart_HeapSnapshotWriteChunkCallback write,
+    void* context) {
+  Thread* thread = Thread::Current();
+  CHECK_ISOLATE(thread == NULL ? NULL : thread->isolate());
+  if (write == NULL) {
+    return OS::SCreate(NULL, "%s expects argument 'write' to be non-null.",
+                       CURRENT_FUNC);
+  }
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  CallbackHeapSnapshotWriter writer(write, context);
+  ObjectGraph graph(thread);
+  graph.Serialize(&writer, ObjectGraph::kVM, /*collect_garbage=*/true);
+  return NULL;
+}
+
 DART_EXPORT char* Dart_SetFileModifiedCallback(
     Dart_FileModifiedCallback file_modified_callback) {
 #if !defined(PRODUCT)
@@ -6343,6 +6866,40 @@ static void DropRegExpMatchCode(Zone* zone) {
   ASSERT(!func.HasCode());
 }
 
+// The code of 'vm:ffi-native' natives calls their C functions at addresses
+// which are only valid in the process that compiled it, so it is removed like
+// the code of the regexp matchers. The natives are resolved again when they
+// are compiled after the snapshot is loaded.
+static void DropFfiNativeCode(Thread* thread) {
+  class DropFfiNativeCodeVisitor : public FunctionVisitor {
+   public:
+    explicit DropFfiNativeCodeVisitor(Thread* thread)
+        : thread_(thread),
+          code_(Code::Handle(thread->zone())),
+          options_(Object::Handle(thread->zone())) {}
+
+    void Visit(const Function& func) {
+      if (!func.is_native() || !func.HasCode()) return;
+      if (!Library::FindPragma(thread_, /*only_core=*/false, func,
+                               Symbols::vm_ffi_native(), &options_)) {
+        return;
+      }
+      code_ = func.CurrentCode();
+      code_.DisableDartCode();
+      func.ClearCode();
+      func.ClearICDataArray();
+    }
+
+   private:
+    Thread* thread_;
+    Code& code_;
+    Object& options_;
+  };
+
+  DropFfiNativeCodeVisitor visitor(thread);
+  ProgramVisitor::VisitFunctions(&visitor);
+}
+
 #endif  // (!defined(TARGET_ARCH_IA32) && !defined(DART_PRECOMPILED_RUNTIME))
 
 DART_EXPORT Dart_Handle Dart_CreateCoreJITSnapshotAsBlobs(
@@ -6381,6 +6938,7 @@ DART_EXPORT Dart_Handle Dart_CreateCoreJITSnapshotAsBlobs(
   }
   BackgroundCompiler::Stop(I);
   DropRegExpMatchCode(Z);
+  DropFfiNativeCode(T);
 
   ProgramVisitor::Dedup();
   Symbols::Compact();
@@ -6440,6 +6998,7 @@ Dart_CreateAppJITSnapshotAsBlobs(uint8_t** isolate_snapshot_data_buffer,
   }
   BackgroundCompiler::Stop(I);
   DropRegExpMatchCode(Z);
+  DropFfiNativeCode(T);
 
   if (reused_instructions) {
     DropCodeWithoutReusableInstructions(reused_instructions);
@@ -23,6 +23,7 @@
 
 namespace dart {
 
+DECLARE_FLAG(bool, fast_shutdown);
 DECLARE_FLAG(bool, verify_acquired_data);
 
 #ifndef PRODUCT
@@ -1532,6 +1533,58 @@ TEST_CASE(DartAPI_ExternalStringCallback) {
   }
 }
 
+TEST_CASE(DartAPI_NewExternalUTF8String) {
+  int ascii_peer = 40;
+  int utf8_peer = 41;
+
+  {
+    Dart_EnterScope();
+
+    uint8_t ascii[] = {'h', 'e', 'l', 'l', 'o'};
+    Dart_Handle ascii_str = Dart_NewExternalUTF8String(
+        ascii, ARRAY_SIZE(ascii), &ascii_peer, sizeof(ascii),
+        ExternalStringCallbackFinalizer);
+    EXPECT_VALID(ascii_str);
+    EXPECT(Dart_IsExternalString(ascii_str));
+    void* peer = NULL;
+    EXPECT_VALID(Dart_StringGetProperties(ascii_str, NULL, NULL, &peer));
+    EXPECT_EQ(&ascii_peer, peer);
+    const char* cstr = NULL;
+    EXPECT_VALID(Dart_StringToCString(ascii_str, &cstr));
+    EXPECT_STREQ("hello", cstr);
+
+    // Non-ASCII text is decoded rather than referenced.
+    uint8_t utf8[] = {'h', 0xC3, 0xA9, 0xE2, 0x82, 0xAC};
+    Dart_Handle utf8_str = Dart_NewExternalUTF8String(
+        utf8, ARRAY_SIZE(utf8), &utf8_peer, sizeof(utf8),
+        ExternalStringCallbackFinalizer);
+    EXPECT_VALID(utf8_str);
+    EXPECT(!Dart_IsExternalString(utf8_str));
+    intptr_t length = 0;
+    EXPECT_VALID(Dart_StringLength(utf8_str, &length));
+    EXPECT_EQ(3, length);
+    EXPECT_VALID(Dart_StringToCString(utf8_str, &cstr));
+    EXPECT_STREQ("h\xC3\xA9\xE2\x82\xAC", cstr);
+
+    uint8_t invalid[] = {'h', 0xC3};
+    Dart_Handle error = Dart_NewExternalUTF8String(
+        invalid, ARRAY_SIZE(invalid), NULL, 0, NoopFinalizer);
+    EXPECT_ERROR(error,
+                 "Dart_NewExternalUTF8String expects argument 'utf8_array' "
+                 "to be valid UTF-8.");
+
+    Dart_ExitScope();
+  }
+
+  {
+    TransitionNativeToVM transition(thread);
+    Isolate::Current()->heap()->CollectAllGarbage();
+    GCTestHelper::WaitForGCTasks();
+    EXPECT_EQ(80, ascii_peer);
+    EXPECT_EQ(82, utf8_peer);
+  }
+}
+
 TEST_CASE(DartAPI_ExternalStringPretenure) {
   {
     Dart_EnterScope();
@@ -1755,6 +1808,60 @@ TEST_CASE(DartAPI_ListAccess) {
   EXPECT(Dart_IsUnhandledExceptionError(result));
 }
 
+TEST_CASE(DartAPI_ListGetRangeAsPrimitives) {
+  const char* kScriptChars =
+      "import 'dart:collection';\n"
+      "class MyList extends ListBase<int> {\n"
+      "  int length = 4;\n"
+      "  int operator [](int index) => index * 10;\n"
+      "  void operator []=(int index, int value) {}\n"
+      "}\n"
+      "List growable() => <int>[1, 2, 9223372036854775807];\n"
+      "List fixed() => new List<num>(3)..[0] = 0.5..[1] = 2..[2] = -1.5;\n"
+      "List mixed() => [1, 'two', 3];\n"
+      "List custom() => new MyList();\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  Dart_Handle growable = Dart_Invoke(lib, NewString("growable"), 0, NULL);
+  EXPECT_VALID(growable);
+  Dart_Handle fixed = Dart_Invoke(lib, NewString("fixed"), 0, NULL);
+  EXPECT_VALID(fixed);
+  Dart_Handle mixed = Dart_Invoke(lib, NewString("mixed"), 0, NULL);
+  EXPECT_VALID(mixed);
+  Dart_Handle custom = Dart_Invoke(lib, NewString("custom"), 0, NULL);
+  EXPECT_VALID(custom);
+
+  int64_t ints[3];
+  EXPECT_VALID(Dart_ListGetRangeAsInt64(growable, 0, 3, ints));
+  EXPECT_EQ(1, ints[0]);
+  EXPECT_EQ(2, ints[1]);
+  EXPECT_EQ(kMaxInt64, ints[2]);
+  EXPECT(Dart_IsError(Dart_ListGetRangeAsInt64(growable, 2, 2, ints)));
+  EXPECT(Dart_IsError(Dart_ListGetRangeAsInt64(growable, -1, 1, ints)));
+  EXPECT_ERROR(Dart_ListGetRangeAsInt64(mixed, 0, 3, ints),
+               "Dart_ListGetRangeAsInt64 expects argument 'list' to be a List "
+               "of int.");
+  EXPECT_ERROR(Dart_ListGetRangeAsInt64(fixed, 0, 1, ints),
+               "Dart_ListGetRangeAsInt64 expects argument 'list' to be a List "
+               "of int.");
+
+  double doubles[3];
+  EXPECT_VALID(Dart_ListGetRangeAsDouble(fixed, 0, 3, doubles));
+  EXPECT_EQ(0.5, doubles[0]);
+  EXPECT_EQ(2.0, doubles[1]);
+  EXPECT_EQ(-1.5, doubles[2]);
+
+  // Other lists are read through their index operator.
+  EXPECT_VALID(Dart_ListGetRangeAsInt64(custom, 1, 3, ints));
+  EXPECT_EQ(10, ints[0]);
+  EXPECT_EQ(20, ints[1]);
+  EXPECT_EQ(30, ints[2]);
+  Dart_Handle values[2];
+  EXPECT_VALID(Dart_ListGetRange(custom, 2, 2, values));
+  int64_t value;
+  EXPECT_VALID(Dart_IntegerToInt64(values[1], &value));
+  EXPECT_EQ(30, value);
+}
+
 TEST_CASE(DartAPI_MapAccess) {
   EXPECT(!Dart_IsMap(Dart_Null()));
   const char* kScriptChars =
@@ -2096,6 +2203,73 @@ TEST_CASE(DartAPI_ByteDataAccess) {
   EXPECT_VALID(result);
 }
 
+static int64_t FfiNativeSumRow(uint8_t* row, int64_t length, int64_t scale) {
+  int64_t sum = 0;
+  for (intptr_t i = 0; i < length; i++) {
+    sum += row[i];
+  }
+  return sum * scale;
+}
+
+static double FfiNativeScale(double value, double factor) {
+  return value * factor;
+}
+
+static void* FfiNativeResolver(const char* name, uintptr_t num_of_arguments) {
+  if (strcmp(name, "SumRow") == 0 && num_of_arguments == 3) {
+    return reinterpret_cast<void*>(&FfiNativeSumRow);
+  }
+  if (strcmp(name, "Scale") == 0 && num_of_arguments == 2) {
+    return reinterpret_cast<void*>(&FfiNativeScale);
+  }
+  return NULL;
+}
+
+static void FfiNativeFallbackFunction(Dart_NativeArguments args) {
+  Dart_SetReturnValue(args, Dart_NewInteger(42));
+}
+
+static Dart_NativeFunction FfiNativeFallbackResolver(Dart_Handle name,
+                                                     int arg_count,
+                                                     bool* auto_setup_scope) {
+  ASSERT(auto_setup_scope != NULL);
+  *auto_setup_scope = true;
+  return &FfiNativeFallbackFunction;
+}
+
+TEST_CASE(DartAPI_FfiNative) {
+  const char* kScriptChars =
+      "import 'dart:typed_data';\n"
+      "@pragma('vm:ffi-native')\n"
+      "int sumRow(Uint8List row, int length, int scale) native 'SumRow';\n"
+      "@pragma('vm:ffi-native')\n"
+      "double scale(double value, double factor) native 'Scale';\n"
+      "@pragma('vm:ffi-native')\n"
+      "int unresolved(int value) native 'Unresolved';\n"
+      "int main() {\n"
+      "  var row = new Uint8List(8);\n"
+      "  for (int i = 0; i < row.length; i++) row[i] = i;\n"
+      "  var view = new Uint8List.view(row.buffer, 4, 4);\n"
+      "  if (sumRow(row, row.length, 2) != 56) throw 'sumRow';\n"
+      "  if (sumRow(view, view.length, 1) != 22) throw 'sumRow view';\n"
+      "  if (scale(1.5, 4.0) != 6.0) throw 'scale';\n"
+      "  // Not typed data of the VM: called through the native entry.\n"
+      "  var unmodifiable = new UnmodifiableUint8ListView(row);\n"
+      "  if (sumRow(unmodifiable, 8, 2) != 42) throw 'sumRow unmodifiable';\n"
+      "  if (sumRow(null, 0, 1) != 42) throw 'sumRow null';\n"
+      "  return unresolved(1);\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(Dart_SetNativeResolver(lib, &FfiNativeFallbackResolver, NULL));
+  EXPECT_VALID(Dart_SetFfiNativeResolver(lib, &FfiNativeResolver));
+
+  Dart_Handle result = Dart_Invoke(lib, NewString("main"), 0, NULL);
+  EXPECT_VALID(result);
+  int64_t value = 0;
+  EXPECT_VALID(Dart_IntegerToInt64(result, &value));
+  EXPECT_EQ(42, value);
+}
+
 static const intptr_t kExtLength = 16;
 static int8_t data[kExtLength] = {
     0x41, 0x42, 0x41, 0x42, 0x41, 0x42, 0x41, 0x42,
@@ -2736,6 +2910,45 @@ TEST_CASE(DartAPI_ExternalTypedDataCallback) {
   }
 }
 
+TEST_CASE(DartAPI_NewTransferableTypedData) {
+  const char* kScriptChars =
+      "import 'dart:isolate';\n"
+      "materialize(TransferableTypedData t) =>\n"
+      "    t.materialize().asUint8List();\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+
+  const uint8_t kFirst[] = {1, 2, 3};
+  const uint8_t kSecond[] = {4, 5};
+  uint8_t* chunks[2];
+  intptr_t lengths[2] = {ARRAY_SIZE(kFirst), ARRAY_SIZE(kSecond)};
+  chunks[0] = reinterpret_cast<uint8_t*>(malloc(lengths[0]));
+  memmove(chunks[0], kFirst, lengths[0]);
+  chunks[1] = reinterpret_cast<uint8_t*>(malloc(lengths[1]));
+  memmove(chunks[1], kSecond, lengths[1]);
+
+  EXPECT(Dart_IsError(Dart_NewTransferableTypedData(chunks, lengths, 0)));
+  Dart_Handle transferable = Dart_NewTransferableTypedData(chunks, lengths, 2);
+  EXPECT_VALID(transferable);
+
+  // The chunks are concatenated on materialization.
+  Dart_Handle result =
+      Dart_Invoke(lib, NewString("materialize"), 1, &transferable);
+  EXPECT_VALID(result);
+  intptr_t length = 0;
+  EXPECT_VALID(Dart_ListLength(result, &length));
+  EXPECT_EQ(5, length);
+  uint8_t data[5];
+  EXPECT_VALID(Dart_ListGetAsBytes(result, 0, data, 5));
+  for (intptr_t i = 0; i < 5; i++) {
+    EXPECT_EQ(i + 1, data[i]);
+  }
+
+  // The content can only be materialized once.
+  result = Dart_Invoke(lib, NewString("materialize"), 1, &transferable);
+  EXPECT(Dart_IsError(result));
+}
+
 static void SlowFinalizer(void* isolate_callback_data,
                           Dart_WeakPersistentHandle handle,
                           void* peer) {
@@ -3226,6 +3439,24 @@ VM_UNIT_TEST_CASE(DartAPI_WeakPersistentHandlesCallbackShutdown) {
   EXPECT(peer == 42);
 }
 
+VM_UNIT_TEST_CASE(DartAPI_WeakPersistentHandlesCallbackFastShutdown) {
+  SetFlagScope<bool> sfs(&FLAG_fast_shutdown, true);
+  TestCase::CreateTestIsolate();
+  Dart_EnterScope();
+  Dart_Handle ref = Dart_True();
+  int skipped_peer = 1234;
+  Dart_NewWeakPersistentHandle(ref, &skipped_peer, 0,
+                               WeakPersistentHandlePeerFinalizer);
+  int finalized_peer = 1234;
+  Dart_WeakPersistentHandle weak_ref = Dart_NewWeakPersistentHandle(
+      ref, &finalized_peer, 0, WeakPersistentHandlePeerFinalizer);
+  Dart_SetFinalizeOnShutdown(weak_ref, true);
+  Dart_ExitScope();
+  Dart_ShutdownIsolate();
+  EXPECT(skipped_peer == 1234);
+  EXPECT(finalized_peer == 42);
+}
+
 TEST_CASE(DartAPI_WeakPersistentHandleExternalAllocationSize) {
   Heap* heap = Isolate::Current()->heap();
   EXPECT(heap->ExternalInWords(Heap::kNew) == 0);
@@ -5363,6 +5594,50 @@ TEST_CASE(DartAPI_Invoke_Null) {
       "NoSuchMethodError: The setter 'nullHasNoSetters=' was called on null");
 }
 
+TEST_CASE(DartAPI_LookupAndInvokeFunction) {
+  const char* kScriptChars =
+      "test(int a, b) => 'top $a $b';\n"
+      "class Methods {\n"
+      "  static _staticMethod(arg) => 'hidden static $arg';\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  Dart_Handle type = Dart_GetType(lib, NewString("Methods"), 0, NULL);
+  EXPECT_VALID(type);
+  const char* str = NULL;
+
+  Dart_Handle function = Dart_LookupFunction(lib, NewString("test"));
+  EXPECT_VALID(function);
+  Dart_Handle args[2];
+  for (intptr_t i = 0; i < 3; i++) {
+    args[0] = Dart_NewInteger(i);
+    args[1] = NewString("!");
+    Dart_Handle result = Dart_InvokeFunction(function, 2, args);
+    EXPECT_VALID(result);
+    EXPECT_VALID(Dart_StringToCString(result, &str));
+    EXPECT_STREQ(OS::SCreate(thread->zone(), "top %" Pd " !", i), str);
+  }
+
+  // Arguments are checked on each invocation.
+  Dart_Handle result = Dart_InvokeFunction(function, 1, args);
+  EXPECT_ERROR(result, "wrong number of arguments");
+  args[0] = NewString("not an int");
+  result = Dart_InvokeFunction(function, 2, args);
+  EXPECT(Dart_IsError(result));
+
+  function = Dart_LookupFunction(type, NewString("_staticMethod"));
+  EXPECT_VALID(function);
+  args[0] = NewString("!!!");
+  result = Dart_InvokeFunction(function, 1, args);
+  EXPECT_VALID(result);
+  EXPECT_VALID(Dart_StringToCString(result, &str));
+  EXPECT_STREQ("hidden static !!!", str);
+
+  result = Dart_LookupFunction(lib, NewString("missing"));
+  EXPECT_ERROR(result, "did not find function 'missing'");
+  result = Dart_InvokeFunction(lib, 0, NULL);
+  EXPECT_ERROR(result, "expects argument 'function' to be of type Function");
+}
+
 TEST_CASE(DartAPI_InvokeNoSuchMethod) {
   const char* kScriptChars =
       "class Expect {\n"
@@ -6340,6 +6615,45 @@ TEST_CASE(DartAPI_IllegalPost) {
   EXPECT(!success);
 }
 
+#ifndef PRODUCT
+TEST_CASE(DartAPI_MessageQueueMetrics) {
+  const char* kScriptChars =
+      "import 'dart:isolate';\n"
+      "int received = 0;\n"
+      "SendPort open() {\n"
+      "  var port = new RawReceivePort((message) { received++; });\n"
+      "  return port.sendPort;\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  Dart_Handle send_port = Dart_Invoke(lib, NewString("open"), 0, NULL);
+  EXPECT_VALID(send_port);
+  Dart_Port port_id = ILLEGAL_PORT;
+  EXPECT_VALID(Dart_SendPortGetId(send_port, &port_id));
+
+  Dart_Isolate isolate = Dart_CurrentIsolate();
+  const int64_t depth = Dart_IsolateMessageQueueDepthMetric(isolate);
+  const int64_t handled = Dart_IsolateMessagesHandledMetric(isolate);
+  EXPECT(Dart_Post(port_id, Dart_True()));
+  EXPECT(Dart_Post(port_id, Dart_False()));
+  EXPECT_EQ(depth + 2, Dart_IsolateMessageQueueDepthMetric(isolate));
+  EXPECT_LE(depth + 2, Dart_IsolateMessageQueueDepthMaxMetric(isolate));
+
+  EXPECT_VALID(Dart_HandleMessage());
+  EXPECT_VALID(Dart_HandleMessage());
+  EXPECT_EQ(depth, Dart_IsolateMessageQueueDepthMetric(isolate));
+  EXPECT_EQ(handled + 2, Dart_IsolateMessagesHandledMetric(isolate));
+  EXPECT_LE(0, Dart_IsolateMessageLatencyMaxMetric(isolate));
+  EXPECT_LE(Dart_IsolateMessageLatencyPercentileMetric(isolate, 50),
+            Dart_IsolateMessageLatencyPercentileMetric(isolate, 100));
+
+  Dart_Handle received = Dart_GetField(lib, NewString("received"));
+  EXPECT_VALID(received);
+  int64_t value = 0;
+  EXPECT_VALID(Dart_IntegerToInt64(received, &value));
+  EXPECT_EQ(2, value);
+}
+#endif  // !PRODUCT
+
 VM_UNIT_TEST_CASE(DartAPI_NewNativePort) {
   // Create a port with a bogus handler.
   Dart_Port error_port = Dart_NewNativePort("Foo", NULL, true);
@@ -6577,6 +6891,64 @@ TEST_CASE(DartAPI_NativePortReceiveInteger) {
   EXPECT(Dart_CloseNativePort(port_id1));
 }
 
+static Monitor* dedicated_port_monitor = NULL;
+static intptr_t dedicated_port_received = 0;
+static intptr_t dedicated_port_max_batch = 0;
+static ThreadId dedicated_port_thread = OSThread::kInvalidThreadId;
+static bool dedicated_port_same_thread = true;
+
+static void NewNativePort_receiveBatch(Dart_Port dest_port_id,
+                                       Dart_CObject** messages,
+                                       intptr_t count) {
+  MonitorLocker ml(dedicated_port_monitor);
+  const ThreadId id = OSThread::GetCurrentThreadId();
+  if (dedicated_port_thread == OSThread::kInvalidThreadId) {
+    dedicated_port_thread = id;
+  } else if (dedicated_port_thread != id) {
+    dedicated_port_same_thread = false;
+  }
+  for (intptr_t i = 0; i < count; i++) {
+    EXPECT_EQ(Dart_CObject_kInt32, messages[i]->type);
+    EXPECT_EQ(dedicated_port_received, messages[i]->value.as_int32);
+    dedicated_port_received++;
+  }
+  if (count > dedicated_port_max_batch) {
+    dedicated_port_max_batch = count;
+  }
+  ml.Notify();
+}
+
+VM_UNIT_TEST_CASE(DartAPI_NativePortDedicatedThread) {
+  dedicated_port_monitor = new Monitor();
+  Dart_NativePortOptions options = {};
+  options.threading = Dart_NativePortThreading_DedicatedThread;
+  options.batch_handler = NewNativePort_receiveBatch;
+  options.max_batch_size = 4;
+
+  options.handle_concurrently = true;
+  EXPECT_EQ(ILLEGAL_PORT,
+            Dart_NewNativePortWithOptions("Dedicated", NULL, &options));
+  options.handle_concurrently = false;
+
+  Dart_Port port_id =
+      Dart_NewNativePortWithOptions("Dedicated", NULL, &options);
+  EXPECT_NE(ILLEGAL_PORT, port_id);
+
+  const intptr_t kMessages = 100;
+  for (intptr_t i = 0; i < kMessages; i++) {
+    EXPECT(Dart_PostInteger(port_id, i));
+  }
+  {
+    MonitorLocker ml(dedicated_port_monitor);
+    while (dedicated_port_received < kMessages) {
+      ml.Wait();
+    }
+    EXPECT(dedicated_port_same_thread);
+    EXPECT_LE(dedicated_port_max_batch, 4);
+  }
+  EXPECT(Dart_CloseNativePort(port_id));
+}
+
 static Dart_Isolate RunLoopTestCallback(const char* script_name,
                                         const char* main,
                                         const char* package_root,
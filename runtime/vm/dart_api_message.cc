@@ -119,6 +119,50 @@ Dart_CObject* ApiMessageReader::AllocateDartCObjectString(intptr_t length) {
   return value;
 }
 
+Dart_CObject* ApiMessageReader::AllocateDartCObjectStringFromLatin1(
+    const uint8_t* latin1,
+    intptr_t length) {
+  intptr_t utf8_len = 0;
+  for (intptr_t i = 0; i < length; i++) {
+    utf8_len += Utf8::Length(latin1[i]);
+  }
+  Dart_CObject* object = AllocateDartCObjectString(utf8_len);
+  char* p = object->value.as_string;
+  for (intptr_t i = 0; i < length; i++) {
+    p += Utf8::Encode(latin1[i], p);
+  }
+  *p = '\0';
+  ASSERT(p == (object->value.as_string + utf8_len));
+  return object;
+}
+
+Dart_CObject* ApiMessageReader::AllocateDartCObjectStringFromUTF16(
+    const uint16_t* utf16,
+    intptr_t length) {
+  // Calculate the UTF-8 length and check if the string can be
+  // UTF-8 encoded.
+  intptr_t utf8_len = 0;
+  bool valid = true;
+  intptr_t i = 0;
+  while (i < length && valid) {
+    int32_t ch = Utf16::Next(utf16, &i, length);
+    utf8_len += Utf8::Length(ch);
+    valid = !Utf16::IsSurrogate(ch);
+  }
+  if (!valid) {
+    return AllocateDartCObjectUnsupported();
+  }
+  Dart_CObject* object = AllocateDartCObjectString(utf8_len);
+  char* p = object->value.as_string;
+  i = 0;
+  while (i < length) {
+    p += Utf8::Encode(Utf16::Next(utf16, &i, length), p);
+  }
+  *p = '\0';
+  ASSERT(p == (object->value.as_string + utf8_len));
+  return object;
+}
+
 static int GetTypedDataSizeInBytes(Dart_TypedData_Type type) {
   switch (type) {
     case Dart_TypedData_kInt8:
@@ -420,6 +464,9 @@ Dart_CObject* ApiMessageReader::ReadVMIsolateObject(intptr_t value) {
   if (object_id == kDoubleObject) {
     return AllocateDartCObjectDouble(ReadDouble());
   }
+  if (object_id == kFastMessageObject) {
+    return ReadFastMessage();
+  }
   if (Symbols::IsPredefinedSymbolId(object_id)) {
     return ReadPredefinedSymbol(object_id);
   }
@@ -427,6 +474,102 @@ Dart_CObject* ApiMessageReader::ReadVMIsolateObject(intptr_t value) {
   return AllocateDartCObjectNull();
 }
 
+static Dart_TypedData_Type TypedDataTypeFromClassId(intptr_t class_id) {
+  switch (class_id) {
+    case kTypedDataInt8ArrayCid:
+      return Dart_TypedData_kInt8;
+    case kTypedDataUint8ArrayCid:
+      return Dart_TypedData_kUint8;
+    case kTypedDataUint8ClampedArrayCid:
+      return Dart_TypedData_kUint8Clamped;
+    case kTypedDataInt16ArrayCid:
+      return Dart_TypedData_kInt16;
+    case kTypedDataUint16ArrayCid:
+      return Dart_TypedData_kUint16;
+    case kTypedDataInt32ArrayCid:
+      return Dart_TypedData_kInt32;
+    case kTypedDataUint32ArrayCid:
+      return Dart_TypedData_kUint32;
+    case kTypedDataInt64ArrayCid:
+      return Dart_TypedData_kInt64;
+    case kTypedDataUint64ArrayCid:
+      return Dart_TypedData_kUint64;
+    case kTypedDataFloat32ArrayCid:
+      return Dart_TypedData_kFloat32;
+    case kTypedDataFloat64ArrayCid:
+      return Dart_TypedData_kFloat64;
+    default:
+      UNREACHABLE();
+      return Dart_TypedData_kInvalid;
+  }
+}
+
+Dart_CObject* ApiMessageReader::ReadFastMessage() {
+  const intptr_t tag = Read<int8_t>();
+  switch (tag) {
+    case kFastTypedData: {
+      const intptr_t class_id = ReadClassIDValue();
+      const intptr_t length = Read<int64_t>();
+      Dart_CObject* object = AllocateDartCObjectTypedData(
+          TypedDataTypeFromClassId(class_id), length);
+      ReadBytes(object->value.as_typed_data.values,
+                object->value.as_typed_data.length);
+      return object;
+    }
+    case kFastArray:
+    case kFastGrowableObjectArray: {
+      // Type arguments are not represented in Dart_CObject.
+      Read<int32_t>();
+      const intptr_t length = Read<int64_t>();
+      Dart_CObject* object = AllocateDartCObjectArray(length);
+      for (intptr_t i = 0; i < length; i++) {
+        object->value.as_array.values[i] = ReadFastMessageValue(Read<int8_t>());
+      }
+      return object;
+    }
+    default:
+      return ReadFastMessageValue(tag);
+  }
+}
+
+Dart_CObject* ApiMessageReader::ReadFastMessageValue(intptr_t tag) {
+  switch (tag) {
+    case kFastNull:
+      return AllocateDartCObjectNull();
+    case kFastTrue:
+      return AllocateDartCObjectBool(true);
+    case kFastFalse:
+      return AllocateDartCObjectBool(false);
+    case kFastSmi: {
+      const int64_t value = Read<int64_t>();
+      if ((kMinInt32 <= value) && (value <= kMaxInt32)) {
+        return AllocateDartCObjectInt32(static_cast<int32_t>(value));
+      }
+      return AllocateDartCObjectInt64(value);
+    }
+    case kFastOneByteString: {
+      Read<int8_t>();  // Canonical strings are not distinguished.
+      const intptr_t length = Read<int64_t>();
+      Dart_CObject* object =
+          AllocateDartCObjectStringFromLatin1(CurrentBufferAddress(), length);
+      Advance(length);
+      return object;
+    }
+    case kFastTwoByteString: {
+      Read<int8_t>();  // Canonical strings are not distinguished.
+      const intptr_t length = Read<int64_t>();
+      // The code units are not aligned in the message.
+      uint16_t* utf16 =
+          reinterpret_cast<uint16_t*>(allocator(length * sizeof(uint16_t)));
+      ReadBytes(reinterpret_cast<uint8_t*>(utf16), length * sizeof(uint16_t));
+      return AllocateDartCObjectStringFromUTF16(utf16, length);
+    }
+    default:
+      UNREACHABLE();
+      return AllocateDartCObjectUnsupported();
+  }
+}
+
 Dart_CObject* ApiMessageReader::ReadInternalVMObject(intptr_t class_id,
                                                      intptr_t object_id) {
   switch (class_id) {
@@ -489,55 +632,42 @@ Dart_CObject* ApiMessageReader::ReadInternalVMObject(intptr_t class_id,
       // snapshots.
       UNREACHABLE();
     }
-    case kOneByteStringCid: {
+    case kOneByteStringCid:
+    case kExternalOneByteStringCid: {
       intptr_t len = ReadSmiValue();
       uint8_t* latin1 =
           reinterpret_cast<uint8_t*>(allocator(len * sizeof(uint8_t)));
-      intptr_t utf8_len = 0;
-      for (intptr_t i = 0; i < len; i++) {
-        latin1[i] = Read<uint8_t>();
-        utf8_len += Utf8::Length(latin1[i]);
+      if (class_id == kExternalOneByteStringCid) {
+        FinalizableData finalizable_data = finalizable_data_->Take();
+        memmove(latin1, finalizable_data.data, len * sizeof(uint8_t));
+        finalizable_data.callback(NULL, NULL, finalizable_data.peer);
+      } else {
+        ReadBytes(latin1, len * sizeof(uint8_t));
       }
-      Dart_CObject* object = AllocateDartCObjectString(utf8_len);
+      Dart_CObject* object = AllocateDartCObjectStringFromLatin1(latin1, len);
       AddBackRef(object_id, object, kIsDeserialized);
-      char* p = object->value.as_string;
-      for (intptr_t i = 0; i < len; i++) {
-        p += Utf8::Encode(latin1[i], p);
-      }
-      *p = '\0';
-      ASSERT(p == (object->value.as_string + utf8_len));
       return object;
     }
-    case kTwoByteStringCid: {
+    case kTwoByteStringCid:
+    case kExternalTwoByteStringCid: {
       intptr_t len = ReadSmiValue();
       uint16_t* utf16 =
           reinterpret_cast<uint16_t*>(allocator(len * sizeof(uint16_t)));
-      intptr_t utf8_len = 0;
-      // Read all the UTF-16 code units.
-      for (intptr_t i = 0; i < len; i++) {
-        utf16[i] = Read<uint16_t>();
-      }
-      // Calculate the UTF-8 length and check if the string can be
-      // UTF-8 encoded.
-      bool valid = true;
-      intptr_t i = 0;
-      while (i < len && valid) {
-        int32_t ch = Utf16::Next(utf16, &i, len);
-        utf8_len += Utf8::Length(ch);
-        valid = !Utf16::IsSurrogate(ch);
+      if (class_id == kExternalTwoByteStringCid) {
+        FinalizableData finalizable_data = finalizable_data_->Take();
+        memmove(utf16, finalizable_data.data, len * sizeof(uint16_t));
+        finalizable_data.callback(NULL, NULL, finalizable_data.peer);
+      } else {
+        // Read all the UTF-16 code units.
+        for (intptr_t i = 0; i < len; i++) {
+          utf16[i] = Read<uint16_t>();
+        }
       }
-      if (!valid) {
-        return AllocateDartCObjectUnsupported();
+      Dart_CObject* object = AllocateDartCObjectStringFromUTF16(utf16, len);
+      if (object->type == Dart_CObject_kUnsupported) {
+        return object;
       }
-      Dart_CObject* object = AllocateDartCObjectString(utf8_len);
       AddBackRef(object_id, object, kIsDeserialized);
-      char* p = object->value.as_string;
-      i = 0;
-      while (i < len) {
-        p += Utf8::Encode(Utf16::Next(utf16, &i, len), p);
-      }
-      *p = '\0';
-      ASSERT(p == (object->value.as_string + utf8_len));
       return object;
     }
     case kSendPortCid: {
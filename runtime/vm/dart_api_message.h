@@ -88,6 +88,13 @@ class ApiMessageReader : public BaseReader {
   Dart_CObject* AllocateDartCObjectDouble(double value);
   // Allocates a Dart_CObject object for string data.
   Dart_CObject* AllocateDartCObjectString(intptr_t length);
+  // Allocates a Dart_CObject object for a string given as Latin-1.
+  Dart_CObject* AllocateDartCObjectStringFromLatin1(const uint8_t* latin1,
+                                                    intptr_t length);
+  // Allocates a Dart_CObject object for a string given as UTF-16, or an
+  // unsupported object if the string has unpaired surrogates.
+  Dart_CObject* AllocateDartCObjectStringFromUTF16(const uint16_t* utf16,
+                                                   intptr_t length);
   // Allocates a C Dart_CObject object for a typed data.
   Dart_CObject* AllocateDartCObjectTypedData(Dart_TypedData_Type type,
                                              intptr_t length);
@@ -114,6 +121,8 @@ class ApiMessageReader : public BaseReader {
   Dart_CObject* ReadPredefinedSymbol(intptr_t object_id);
   Dart_CObject* ReadObjectRef();
   Dart_CObject* ReadObject();
+  Dart_CObject* ReadFastMessage();
+  Dart_CObject* ReadFastMessageValue(intptr_t tag);
 
   // Add object to backward references.
   void AddBackRef(intptr_t id, Dart_CObject* obj, DeserializeState state);
@@ -121,6 +121,29 @@ class ApiZone {
   DISALLOW_COPY_AND_ASSIGN(ApiZone);
 };
 
+// Implementation of Dart_Arena: a zone owned by the embedder instead of a
+// thread or scope. Its segments come from and return to the segment cache
+// of the thread that expands or resets it.
+class ApiArena {
+ public:
+  ApiArena() : zone_(/*is_arena=*/true) {}
+
+  uword AllocUnsafe(intptr_t size) { return zone_.AllocUnsafe(size); }
+
+  // Frees everything allocated in the arena.
+  void Reset() { zone_.DeleteAll(); }
+
+  Dart_Arena apiArena() { return reinterpret_cast<Dart_Arena>(this); }
+  static ApiArena* Cast(Dart_Arena arena) {
+    return reinterpret_cast<ApiArena*>(arena);
+  }
+
+ private:
+  Zone zone_;
+
+  DISALLOW_COPY_AND_ASSIGN(ApiArena);
+};
+
 // Implementation of local handles which are handed out from every
 // dart API call, these handles are valid only in the present scope
 // and are destroyed when a Dart_ExitScope() is called.
@@ -243,13 +266,23 @@ class FinalizablePersistentHandle {
     set_external_size(0);
   }
 
+  // Whether the finalizer runs when the isolate shuts down with
+  // --fast_shutdown.
+  bool finalize_on_shutdown() const {
+    return FinalizeOnShutdownBit::decode(external_data_);
+  }
+  void set_finalize_on_shutdown(bool value) {
+    external_data_ = FinalizeOnShutdownBit::update(value, external_data_);
+  }
+
   static FinalizablePersistentHandle* Cast(Dart_WeakPersistentHandle handle);
 
  private:
   enum {
     kExternalNewSpaceBit = 0,
-    kExternalSizeBits = 1,
-    kExternalSizeBitsSize = (kBitsPerWord - 1),
+    kFinalizeOnShutdownBit = 1,
+    kExternalSizeBits = 2,
+    kExternalSizeBitsSize = (kBitsPerWord - 2),
   };
 
   // This part of external_data_ is the number of externally allocated bytes.
@@ -261,6 +294,8 @@ class FinalizablePersistentHandle {
   // space and UpdateRelocated has not yet detected any promotion.
   class ExternalNewSpaceBit
       : public BitField<uword, bool, kExternalNewSpaceBit, 1> {};
+  class FinalizeOnShutdownBit
+      : public BitField<uword, bool, kFinalizeOnShutdownBit, 1> {};
 
   friend class FinalizablePersistentHandles;
 
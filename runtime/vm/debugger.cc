@@ -26,6 +26,7 @@
 #include "vm/os.h"
 #include "vm/parser.h"
 #include "vm/port.h"
+#include "vm/program_visitor.h"
 #include "vm/runtime_entry.h"
 #include "vm/service.h"
 #include "vm/service_event.h"
@@ -1950,10 +1951,8 @@ RawFunction* Debugger::ResolveFunction(const Library& library,
   return function.raw();
 }
 
-// Deoptimize all functions in the isolate.
-// TODO(hausner): Actually we only need to deoptimize those functions
-// that inline the function that contains the newly created breakpoint.
-// We currently don't have this info so we deoptimize all functions.
+// Deoptimize all functions in the isolate. Used when stepping into calls,
+// which may enter any function.
 void Debugger::DeoptimizeWorld() {
 #if defined(DART_PRECOMPILED_RUNTIME)
   UNREACHABLE();
@@ -1962,7 +1961,6 @@ void Debugger::DeoptimizeWorld() {
   if (FLAG_trace_deoptimization) {
     THR_Print("Deopt for debugger\n");
   }
-  isolate_->set_has_attempted_stepping(true);
 
   DeoptimizeFunctionsOnStack();
 
@@ -2030,8 +2028,146 @@ void Debugger::DeoptimizeWorld() {
 #endif  // defined(DART_PRECOMPILED_RUNTIME)
 }
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+// Returns true if 'code' is the optimized code of one of 'functions' or has
+// inlined one of them.
+static bool CodeContainsAnyOf(const Code& code,
+                              const GrowableObjectArray& functions,
+                              Array* inlined) {
+  *inlined = code.inlined_id_to_function();
+  for (intptr_t i = 0; i < functions.Length(); i++) {
+    if (functions.At(i) == code.function()) {
+      return true;
+    }
+    for (intptr_t j = 0; j < inlined->Length(); j++) {
+      if (functions.At(i) == inlined->At(j)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+class DeoptimizeContainingVisitor : public FunctionVisitor {
+ public:
+  DeoptimizeContainingVisitor(Zone* zone, const GrowableObjectArray& functions)
+      : functions_(functions),
+        code_(Code::Handle(zone)),
+        inlined_(Array::Handle(zone)),
+        count_(0) {}
+
+  void Visit(const Function& function) {
+    if (function.ForceOptimize() || !function.HasOptimizedCode()) {
+      return;
+    }
+    code_ = function.CurrentCode();
+    if (CodeContainsAnyOf(code_, functions_, &inlined_)) {
+      function.SwitchToUnoptimizedCode();
+      count_++;
+    }
+  }
+
+  intptr_t count() const { return count_; }
+
+ private:
+  const GrowableObjectArray& functions_;
+  Code& code_;
+  Array& inlined_;
+  intptr_t count_;
+};
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
+// Deoptimize only the code that can execute one of 'functions', which are
+// about to get breakpoints: their own optimized code and the optimized code
+// that inlines them. Functions with breakpoints are neither optimized nor
+// inlined afterwards, so the rest of the optimized code stays valid.
+void Debugger::DeoptimizeCodeContaining(const GrowableObjectArray& functions) {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  UNREACHABLE();
+#else
+  // A background compilation may be inlining one of the functions.
+  BackgroundCompiler::Stop(isolate_);
+
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+  Code& code = Code::Handle(zone);
+  Array& inlined = Array::Handle(zone);
+  DartFrameIterator iterator(thread,
+                             StackFrameIterator::kNoCrossThreadIteration);
+  for (StackFrame* frame = iterator.NextFrame(); frame != NULL;
+       frame = iterator.NextFrame()) {
+    if (frame->is_interpreted()) {
+      continue;
+    }
+    code = frame->LookupDartCode();
+    if (code.is_optimized() && !code.is_force_optimized() &&
+        CodeContainsAnyOf(code, functions, &inlined)) {
+      DeoptimizeAt(code, frame);
+    }
+  }
+
+  DeoptimizeContainingVisitor visitor(zone, functions);
+  ProgramVisitor::VisitFunctions(&visitor);
+  if (FLAG_trace_deoptimization) {
+    THR_Print("Deopt for breakpoint: %" Pd " function(s)\n", visitor.count());
+  }
+
+  // The breakpoints are patched into the IC calls of the unoptimized code,
+  // which must not have been switched to monomorphic calls.
+  Function& function = Function::Handle(zone);
+  for (intptr_t i = 0; i < functions.Length(); i++) {
+    function ^= functions.At(i);
+    code = function.unoptimized_code();
+    if (!code.IsNull()) {
+      code.ResetSwitchableCalls(zone);
+    }
+  }
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+}
+
+// Stepping over or out of the top frame only pauses in frames that are
+// already on the stack, so only those are deoptimized, lazily when they are
+// returned to. Their functions also switch to unoptimized code, which stays
+// in place while stepping, since functions are not optimized then.
+void Debugger::DeoptimizeFramesForStepping() {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  UNREACHABLE();
+#else
+  if (FLAG_trace_deoptimization) {
+    THR_Print("Deopt frames for stepping\n");
+  }
+  DeoptimizeFunctionsOnStack();
+
+  // Monomorphic calls do not check for single stepping.
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+  Code& code = Code::Handle(zone);
+  Function& function = Function::Handle(zone);
+  DartFrameIterator iterator(thread,
+                             StackFrameIterator::kNoCrossThreadIteration);
+  for (StackFrame* frame = iterator.NextFrame(); frame != NULL;
+       frame = iterator.NextFrame()) {
+    if (frame->is_interpreted()) {
+      continue;
+    }
+    code = frame->LookupDartCode();
+    function = code.function();
+    if (function.IsNull() || function.ForceOptimize()) {
+      continue;
+    }
+    code = function.unoptimized_code();
+    if (!code.IsNull()) {
+      code.ResetSwitchableCalls(zone);
+    }
+  }
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+}
+
 void Debugger::NotifySingleStepping(bool value) const {
   isolate_->set_single_step(value);
+  // Calls are only kept from switching to monomorphic calls, which do not
+  // check for single stepping, while stepping.
+  isolate_->set_has_attempted_stepping(value);
 #if !defined(DART_PRECOMPILED_RUNTIME)
   // Do not call Interpreter::Current(), which may allocate an interpreter.
   Interpreter* interpreter = Thread::Current()->interpreter();
@@ -3476,7 +3612,7 @@ BreakpointLocation* Debugger::SetBreakpoint(const Script& script,
                                  exact_token_pos, bytecode_functions);
       }
       if (code_functions.Length() > 0) {
-        DeoptimizeWorld();
+        DeoptimizeCodeContaining(code_functions);
         loc = SetCodeBreakpoints(false, loc, script, token_pos, last_token_pos,
                                  requested_line, requested_column,
                                  exact_token_pos, code_functions);
@@ -3831,7 +3967,7 @@ void Debugger::HandleSteppingRequest(DebuggerStackTrace* stack_trace,
       OS::PrintErr("HandleSteppingRequest- kStepInto\n");
     }
   } else if (resume_action_ == kStepOver) {
-    DeoptimizeWorld();
+    DeoptimizeFramesForStepping();
     NotifySingleStepping(true);
     skip_next_step_ = skip_next_step;
     SetSyncSteppingFramePointer(stack_trace);
@@ -3855,7 +3991,7 @@ void Debugger::HandleSteppingRequest(DebuggerStackTrace* stack_trace,
       }
     }
     // Fall through to synchronous stepping.
-    DeoptimizeWorld();
+    DeoptimizeFramesForStepping();
     NotifySingleStepping(true);
     // Find topmost caller that is debuggable.
     for (intptr_t i = 1; i < stack_trace->Length(); i++) {
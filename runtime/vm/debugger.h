@@ -675,6 +675,8 @@ class Debugger {
                                      intptr_t requested_column,
                                      TokenPosition exact_token_pos);
   void DeoptimizeWorld();
+  void DeoptimizeCodeContaining(const GrowableObjectArray& functions);
+  void DeoptimizeFramesForStepping();
   void NotifySingleStepping(bool value) const;
   BreakpointLocation* SetCodeBreakpoints(bool in_bytecode,
                                          BreakpointLocation* loc,
@@ -170,8 +170,11 @@ void DeferredPcMarker::Materialize(DeoptContext* deopt_context) {
 
   // Increment the deoptimization counter. This effectively increments each
   // function occurring in the optimized frame.
+  bool storm = false;
   if (deopt_context->deoptimizing_code()) {
     function.set_deoptimization_counter(function.deoptimization_counter() + 1);
+    DeoptStats* stats = deopt_context->thread()->isolate()->deopt_stats();
+    storm = stats->Record(function, deopt_context->deopt_reason());
   }
   if (FLAG_trace_deoptimization || FLAG_trace_deoptimization_verbose) {
     THR_Print("Deoptimizing '%s' (count %d)\n",
@@ -184,6 +187,10 @@ void DeferredPcMarker::Materialize(DeoptContext* deopt_context) {
   if (function.HasOptimizedCode()) {
     function.SwitchToUnoptimizedCode();
   }
+  if (storm) {
+    // Reoptimizing would likely deoptimize again; stay in unoptimized code.
+    function.SetIsOptimizable(false);
+  }
 }
 
 void DeferredPp::Materialize(DeoptContext* deopt_context) {
@@ -233,6 +240,15 @@ void DeferredObject::Create() {
     }
     object_ = &Context::ZoneHandle(Context::New(num_variables));
 
+  } else if (cls.id() == kArrayCid) {
+    intptr_t num_elements = Smi::Cast(Object::Handle(GetLength())).Value();
+    if (FLAG_trace_deoptimization_verbose) {
+      OS::PrintErr("materializing array of length %" Pd " (%" Px ", %" Pd
+                   " elements)\n",
+                   num_elements, reinterpret_cast<uword>(args_), field_count_);
+    }
+    object_ = &Array::ZoneHandle(Array::New(num_elements));
+
   } else {
     if (FLAG_trace_deoptimization_verbose) {
       OS::PrintErr("materializing instance of %s (%" Px ", %" Pd " fields)\n",
@@ -250,6 +266,12 @@ static intptr_t ToContextIndex(intptr_t offset_in_bytes) {
   return result;
 }
 
+static intptr_t ToArrayIndex(intptr_t offset_in_bytes) {
+  intptr_t result = (offset_in_bytes - Array::data_offset()) / kWordSize;
+  ASSERT(result >= 0);
+  return result;
+}
+
 void DeferredObject::Fill() {
   Create();  // Ensure instance is created.
 
@@ -283,6 +305,32 @@ void DeferredObject::Fill() {
         }
       }
     }
+  } else if (cls.id() == kArrayCid) {
+    const Array& array = Array::Cast(*object_);
+
+    Smi& offset = Smi::Handle();
+    Object& value = Object::Handle();
+
+    for (intptr_t i = 0; i < field_count_; i++) {
+      offset ^= GetFieldOffset(i);
+      value = GetValue(i);
+      if (offset.Value() == Array::type_arguments_offset()) {
+        TypeArguments& type_arguments = TypeArguments::Handle();
+        type_arguments ^= value.raw();
+        array.SetTypeArguments(type_arguments);
+        if (FLAG_trace_deoptimization_verbose) {
+          OS::PrintErr("    array@type_args (offset %" Pd ") <- %s\n",
+                       offset.Value(), value.ToCString());
+        }
+      } else {
+        intptr_t array_index = ToArrayIndex(offset.Value());
+        array.SetAt(array_index, value);
+        if (FLAG_trace_deoptimization_verbose) {
+          OS::PrintErr("    array@%" Pd " (offset %" Pd ") <- %s\n",
+                       array_index, offset.Value(), value.ToCString());
+        }
+      }
+    }
   } else {
     const Instance& obj = Instance::Cast(*object_);
 
@@ -12,6 +12,7 @@
 #include "vm/compiler/backend/il.h"
 #include "vm/compiler/backend/locations.h"
 #include "vm/compiler/jit/compiler.h"
+#include "vm/json_stream.h"
 #include "vm/parser.h"
 #include "vm/stack_frame.h"
 #include "vm/thread.h"
@@ -23,6 +24,15 @@ DEFINE_FLAG(bool,
             compress_deopt_info,
             true,
             "Compress the size of the deoptimization info for optimized code.");
+DEFINE_FLAG(int,
+            deoptimization_storm_threshold,
+            10,
+            "Stop optimizing a function that deoptimizes this many times "
+            "within --deoptimization_storm_window_millis (0 disables).");
+DEFINE_FLAG(int,
+            deoptimization_storm_window_millis,
+            1000,
+            "Time window for --deoptimization_storm_threshold.");
 DECLARE_FLAG(bool, trace_deoptimization);
 DECLARE_FLAG(bool, trace_deoptimization_verbose);
 
@@ -1480,6 +1490,109 @@ bool DeoptInfo::VerifyDecompression(const GrowableArray<DeoptInstr*>& original,
   return true;
 }
 
+DeoptStats::~DeoptStats() {
+  auto it = entries_.GetIterator();
+  for (Entry** entry = it.Next(); entry != nullptr; entry = it.Next()) {
+    free((*entry)->name);
+    delete *entry;
+  }
+}
+
+bool DeoptStats::Record(const Function& function,
+                        ICData::DeoptReasonId reason) {
+  const char* name = function.ToFullyQualifiedCString();
+  Entry** lookup = entries_.Lookup(name);
+  Entry* entry;
+  if (lookup != nullptr) {
+    entry = *lookup;
+  } else {
+    entry = new Entry();
+    entry->name = strdup(name);
+    entries_.Insert(entry);
+  }
+  entry->count++;
+  entry->reasons[reason]++;
+
+  if ((FLAG_deoptimization_storm_threshold <= 0) || entry->storm) {
+    return false;
+  }
+  const int64_t now =
+      OS::GetCurrentMonotonicMicros() / kMicrosecondsPerMillisecond;
+  if ((entry->window_count == 0) ||
+      (now - entry->window_start_millis >
+       FLAG_deoptimization_storm_window_millis)) {
+    entry->window_start_millis = now;
+    entry->window_count = 0;
+  }
+  entry->window_count++;
+  if (entry->window_count < FLAG_deoptimization_storm_threshold) {
+    return false;
+  }
+  entry->storm = true;
+
+  if (FLAG_trace_deoptimization || FLAG_trace_deoptimization_verbose) {
+    THR_Print("Deoptimization storm in '%s' (%" Pd
+              " deoptimizations in %" Pd64 " ms, last reason '%s')\n",
+              name, entry->window_count, now - entry->window_start_millis,
+              DeoptReasonToCString(reason));
+  }
+#if defined(SUPPORT_TIMELINE)
+  TimelineStream* compiler_stream = Timeline::GetCompilerStream();
+  ASSERT(compiler_stream != NULL);
+  TimelineEvent* event = compiler_stream->StartEvent();
+  if (event != NULL) {
+    event->Instant("DeoptimizationStorm");
+    event->SetNumArguments(3);
+    event->CopyArgument(0, "function", name);
+    event->CopyArgument(1, "reason", DeoptReasonToCString(reason));
+    event->FormatArgument(2, "deoptimizationCount", "%" Pd,
+                          entry->window_count);
+    event->Complete();
+  }
+#endif  // defined(SUPPORT_TIMELINE)
+  return true;
+}
+
+#if !defined(PRODUCT)
+int DeoptStats::CompareByCount(Entry* const* a, Entry* const* b) {
+  if ((*a)->count != (*b)->count) {
+    return (*a)->count > (*b)->count ? -1 : 1;
+  }
+  return strcmp((*a)->name, (*b)->name);
+}
+
+void DeoptStats::PrintJSON(JSONStream* stream) const {
+  MallocGrowableArray<Entry*> sorted(entries_.Length());
+  auto it = entries_.GetIterator();
+  for (Entry** entry = it.Next(); entry != nullptr; entry = it.Next()) {
+    sorted.Add(*entry);
+  }
+  sorted.Sort(CompareByCount);
+
+  JSONObject obj(stream);
+  obj.AddProperty("type", "_DeoptimizationStats");
+  obj.AddProperty64("stormThreshold", FLAG_deoptimization_storm_threshold);
+  obj.AddProperty64("stormWindowMillis",
+                    FLAG_deoptimization_storm_window_millis);
+  JSONArray functions(&obj, "functions");
+  for (intptr_t i = 0; i < sorted.length(); i++) {
+    const Entry* entry = sorted[i];
+    JSONObject function(&functions);
+    function.AddProperty("name", entry->name);
+    function.AddProperty64("deoptimizations", entry->count);
+    function.AddProperty("storm", entry->storm);
+    JSONObject reasons(&function, "reasons");
+    for (intptr_t reason = 0; reason < ICData::kDeoptNumReasons; reason++) {
+      if (entry->reasons[reason] != 0) {
+        reasons.AddProperty64(
+            DeoptReasonToCString(static_cast<ICData::DeoptReasonId>(reason)),
+            entry->reasons[reason]);
+      }
+    }
+  }
+}
+#endif  // !defined(PRODUCT)
+
 }  // namespace dart
 
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
@@ -12,6 +12,7 @@
 #include "vm/compiler/backend/locations.h"
 #include "vm/deferred_objects.h"
 #include "vm/growable_array.h"
+#include "vm/hash_map.h"
 #include "vm/object.h"
 #include "vm/runtime_entry.h"
 #include "vm/stack_frame.h"
@@ -645,6 +646,62 @@ class DeoptInfo : public AllStatic {
                          intptr_t length);
 };
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+// Counts the deoptimizations of each function by reason and detects
+// deoptimization storms: a function that deoptimizes at least
+// --deoptimization_storm_threshold times within
+// --deoptimization_storm_window_millis keeps failing its speculative
+// assumptions, so it is not optimized again and stays in unoptimized code.
+// Owned by the isolate and only used by its mutator thread.
+class DeoptStats {
+ public:
+  DeoptStats() {}
+  ~DeoptStats();
+
+  // Records a deoptimization of |function| and returns true if it started a
+  // deoptimization storm.
+  bool Record(const Function& function, ICData::DeoptReasonId reason);
+
+#if !defined(PRODUCT)
+  void PrintJSON(JSONStream* stream) const;
+#endif
+
+ private:
+  struct Entry {
+    char* name;
+    intptr_t count;
+    intptr_t reasons[ICData::kDeoptNumReasons];
+    int64_t window_start_millis;
+    intptr_t window_count;
+    bool storm;
+  };
+
+  static int CompareByCount(Entry* const* a, Entry* const* b);
+
+  class EntryTrait {
+   public:
+    typedef Entry* Value;
+    typedef const char* Key;
+    typedef Entry* Pair;
+
+    static Key KeyOf(Pair kv) { return kv->name; }
+    static Value ValueOf(Pair kv) { return kv; }
+    static intptr_t Hashcode(Key key) {
+      return Utils::StringHash(key, strlen(key));
+    }
+    static bool IsKeyEqual(Pair kv, Key key) {
+      return strcmp(kv->name, key) == 0;
+    }
+  };
+
+  MallocDirectChainedHashMap<EntryTrait> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeoptStats);
+};
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_DEOPT_INSTRUCTIONS_H_
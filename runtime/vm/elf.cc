@@ -35,6 +35,7 @@ static const intptr_t SHT_STRTAB = 3;
 static const intptr_t SHT_HASH = 5;
 static const intptr_t SHT_DYNSYM = 11;
 static const intptr_t SHT_DYNAMIC = 6;
+static const intptr_t SHT_NOTE = 7;
 
 static const intptr_t SHF_WRITE = 0x1;
 static const intptr_t SHF_ALLOC = 0x2;
@@ -46,6 +47,7 @@ static const intptr_t STN_UNDEF = 0;
 
 static const intptr_t PT_LOAD = 1;
 static const intptr_t PT_DYNAMIC = 2;
+static const intptr_t PT_NOTE = 4;
 static const intptr_t PT_PHDR = 6;
 
 static const intptr_t PF_X = 1;
@@ -64,6 +66,8 @@ static const intptr_t DT_SYMTAB = 6;
 static const intptr_t DT_STRSZ = 10;
 static const intptr_t DT_SYMENT = 11;
 
+static const intptr_t NT_GNU_BUILD_ID = 3;
+
 #if defined(TARGET_ARCH_IS_32_BIT)
 static const intptr_t kElfHeaderSize = 52;
 static const intptr_t kElfSectionTableAlignment = 4;
@@ -364,17 +368,64 @@ class DynamicTable : public Section {
   GrowableArray<Entry*> entries_;
 };
 
+// A GNU build ID, which identifies the snapshot in symbolized stack traces
+// (see StackTrace::ToDwarfCString) so that they can be matched with the
+// unstripped snapshot holding the DWARF information.
+class BuildIdNote : public Section {
+ public:
+  static const intptr_t kBuildIdSize = 16;
+
+  BuildIdNote() {
+    section_type = SHT_NOTE;
+    section_flags = SHF_ALLOC;
+    segment_type = PT_LOAD;
+    segment_flags = PF_R;
+    alignment = 4;
+
+    memory_size = file_size = kHeaderSize + sizeof(kName) + kBuildIdSize;
+    memset(build_id_, 0, kBuildIdSize);
+  }
+
+  void SetBuildId(const uint64_t* hashes) {
+    memmove(build_id_, hashes, kBuildIdSize);
+  }
+
+  void Write(Elf* stream) {
+    stream->WriteWord(sizeof(kName));  // Name size, including the '\0'.
+    stream->WriteWord(kBuildIdSize);
+    stream->WriteWord(NT_GNU_BUILD_ID);
+    stream->WriteBytes(reinterpret_cast<const uint8_t*>(kName), sizeof(kName));
+    stream->WriteBytes(build_id_, kBuildIdSize);
+  }
+
+ private:
+  static const intptr_t kHeaderSize = 3 * sizeof(uint32_t);
+  static constexpr const char kName[] = "GNU";
+
+  uint8_t build_id_[kBuildIdSize];
+};
+
+constexpr const char BuildIdNote::kName[];
+
 // The first section must be written out and contains only zeros.
 static const intptr_t kNumInvalidSections = 1;
 
 // Extra segments put in the program table that aren't reified in
 // Elf::segments_.
-static const intptr_t kNumImplicitSegments = 3;
+static const intptr_t kNumImplicitSegments = 4;
 
 static const intptr_t kProgramTableSegmentSize = kPageSize;
 
+// FNV-1a.
+static const uint64_t kBuildIdHashOffsetBasis = 0xcbf29ce484222325;
+static const uint64_t kBuildIdHashPrime = 0x100000001b3;
+
 Elf::Elf(Zone* zone, StreamingWriteStream* stream)
-    : zone_(zone), stream_(stream), memory_offset_(0) {
+    : zone_(zone),
+      stream_(stream),
+      memory_offset_(0),
+      build_id_(NULL),
+      build_id_hashes_{kBuildIdHashOffsetBasis, ~kBuildIdHashOffsetBasis} {
   // Assumed by various offset logic in this file.
   ASSERT(stream_->position() == 0);
 
@@ -410,6 +461,20 @@ void Elf::AddSegment(Section* section) {
   memory_offset_ = Utils::RoundUp(memory_offset_, kPageSize);
 }
 
+void Elf::AddToBuildId(const uint8_t* bytes, intptr_t size) {
+  // The two hashes differ in their bases and in the byte order of the
+  // sizes, which separate the contents of the sections.
+  for (intptr_t i = 0; i < size; i++) {
+    build_id_hashes_[0] = (build_id_hashes_[0] ^ bytes[i]) * kBuildIdHashPrime;
+    build_id_hashes_[1] = (build_id_hashes_[1] ^ bytes[size - i - 1]) *
+                          kBuildIdHashPrime;
+  }
+  build_id_hashes_[0] = (build_id_hashes_[0] ^ size) * kBuildIdHashPrime;
+  build_id_hashes_[1] =
+      (build_id_hashes_[1] ^ Utils::HostToBigEndian64(size)) *
+      kBuildIdHashPrime;
+}
+
 intptr_t Elf::NextMemoryOffset() {
   return memory_offset_;
 }
@@ -419,6 +484,7 @@ intptr_t Elf::AddText(const char* name, const uint8_t* bytes, intptr_t size) {
   image->section_name = shstrtab_->AddString(".text");
   AddSection(image);
   AddSegment(image);
+  AddToBuildId(bytes, size);
 
   Symbol* symbol = new (zone_) Symbol();
   symbol->cstr = name;
@@ -439,6 +505,7 @@ intptr_t Elf::AddROData(const char* name, const uint8_t* bytes, intptr_t size) {
   image->section_name = shstrtab_->AddString(".rodata");
   AddSection(image);
   AddSegment(image);
+  AddToBuildId(bytes, size);
 
   Symbol* symbol = new (zone_) Symbol();
   symbol->cstr = name;
@@ -461,6 +528,12 @@ void Elf::AddDebug(const char* name, const uint8_t* bytes, intptr_t size) {
 }
 
 void Elf::Finalize() {
+  build_id_ = new (zone_) BuildIdNote();
+  build_id_->section_name = shstrtab_->AddString(".note.gnu.build-id");
+  build_id_->SetBuildId(build_id_hashes_);
+  AddSection(build_id_);
+  AddSegment(build_id_);
+
   SymbolHashTable* hash = new (zone_) SymbolHashTable(symstrtab_, symtab_);
   hash->section_name = shstrtab_->AddString(".hash");
 
@@ -573,7 +646,7 @@ void Elf::WriteProgramTable() {
   // Self-reference to program header table. Required by Android but not by
   // Linux. Must appear before any PT_LOAD entries.
   {
-    ASSERT(kNumImplicitSegments == 3);
+    ASSERT(kNumImplicitSegments == 4);
     const intptr_t start = stream_->position();
 #if defined(TARGET_ARCH_IS_32_BIT)
     WriteWord(PT_PHDR);
@@ -608,7 +681,7 @@ void Elf::WriteProgramTable() {
     RELEASE_ASSERT((program_table_file_offset_ + program_table_file_size_) <
                    kProgramTableSegmentSize);
 
-    ASSERT(kNumImplicitSegments == 3);
+    ASSERT(kNumImplicitSegments == 4);
     const intptr_t start = stream_->position();
 #if defined(TARGET_ARCH_IS_32_BIT)
     WriteWord(PT_LOAD);
@@ -662,7 +735,7 @@ void Elf::WriteProgramTable() {
   // Special case: the dynamic section requires both LOAD and DYNAMIC program
   // header table entries.
   {
-    ASSERT(kNumImplicitSegments == 3);
+    ASSERT(kNumImplicitSegments == 4);
     const intptr_t start = stream_->position();
 #if defined(TARGET_ARCH_IS_32_BIT)
     WriteWord(PT_DYNAMIC);
@@ -682,6 +755,34 @@ void Elf::WriteProgramTable() {
     WriteXWord(dynamic_->file_size);
     WriteXWord(dynamic_->memory_size);
     WriteXWord(dynamic_->alignment);
+#endif
+    const intptr_t end = stream_->position();
+    ASSERT((end - start) == kElfProgramTableEntrySize);
+  }
+
+  // The build ID note requires both LOAD and NOTE program header table
+  // entries, so that it can be read from the loaded snapshot.
+  {
+    ASSERT(kNumImplicitSegments == 4);
+    const intptr_t start = stream_->position();
+#if defined(TARGET_ARCH_IS_32_BIT)
+    WriteWord(PT_NOTE);
+    WriteOff(build_id_->file_offset);
+    WriteAddr(build_id_->memory_offset);  // Virtual address.
+    WriteAddr(build_id_->memory_offset);  // Physical address, not used.
+    WriteWord(build_id_->file_size);
+    WriteWord(build_id_->memory_size);
+    WriteWord(build_id_->segment_flags);
+    WriteWord(4);
+#else
+    WriteWord(PT_NOTE);
+    WriteWord(build_id_->segment_flags);
+    WriteOff(build_id_->file_offset);
+    WriteAddr(build_id_->memory_offset);  // Virtual address.
+    WriteAddr(build_id_->memory_offset);  // Physical address, not used.
+    WriteXWord(build_id_->file_size);
+    WriteXWord(build_id_->memory_size);
+    WriteXWord(4);
 #endif
     const intptr_t end = stream_->position();
     ASSERT((end - start) == kElfProgramTableEntrySize);
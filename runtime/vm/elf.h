@@ -12,6 +12,7 @@
 
 namespace dart {
 
+class BuildIdNote;
 class DynamicTable;
 class Section;
 class StringTable;
@@ -57,6 +58,7 @@ class Elf : public ZoneAllocated {
  private:
   void AddSection(Section* section);
   void AddSegment(Section* section);
+  void AddToBuildId(const uint8_t* bytes, intptr_t size);
 
   void ComputeFileOffsets();
   void WriteHeader();
@@ -78,6 +80,10 @@ class Elf : public ZoneAllocated {
   StringTable* symstrtab_;
   SymbolTable* symtab_;
   DynamicTable* dynamic_;
+  BuildIdNote* build_id_;
+
+  // Hashes of the loaded contents, from which the build ID is made.
+  uint64_t build_id_hashes_[2];
 };
 
 }  // namespace dart
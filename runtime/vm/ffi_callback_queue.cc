@@ -0,0 +1,91 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/ffi_callback_queue.h"
+
+#include "platform/atomic.h"
+#include "platform/utils.h"
+#include "vm/message.h"
+#include "vm/object.h"
+#include "vm/port.h"
+
+namespace dart {
+
+const intptr_t FfiCallbackQueue::kNodeHeaderSize =
+    Utils::RoundUp(sizeof(Node), 2 * kWordSize);
+
+FfiCallbackQueue::FfiCallbackQueue(intptr_t record_size, Dart_Port port)
+    : record_size_(record_size),
+      port_(port),
+      head_(nullptr),
+      batch_(nullptr),
+      batch_capacity_(0) {}
+
+FfiCallbackQueue::~FfiCallbackQueue() {
+  Node* node = head_;
+  while (node != nullptr) {
+    Node* next = node->next;
+    free(node);
+    node = next;
+  }
+  free(batch_);
+}
+
+bool FfiCallbackQueue::Post(const void* record) {
+  Node* node = reinterpret_cast<Node*>(malloc(kNodeHeaderSize + record_size_));
+  if (node == nullptr) {
+    return false;
+  }
+  memmove(RecordOf(node), record, record_size_);
+  Node* head = AtomicOperations::LoadRelaxed(&head_);
+  while (true) {
+    node->next = head;
+    Node* previous =
+        AtomicOperations::CompareAndSwapPointer(&head_, head, node);
+    if (previous == head) break;
+    head = previous;
+  }
+  if (head != nullptr) {
+    // The owner has been woken up already and has not drained the queue yet.
+    return true;
+  }
+  return PortMap::PostMessage(
+      Message::New(port_, Smi::New(0), Message::kNormalPriority));
+}
+
+intptr_t FfiCallbackQueue::Drain() {
+  Node* head = AtomicOperations::LoadRelaxed(&head_);
+  while (true) {
+    Node* previous = AtomicOperations::CompareAndSwapPointer(
+        &head_, head, static_cast<Node*>(nullptr));
+    if (previous == head) break;
+    head = previous;
+  }
+
+  intptr_t count = 0;
+  for (Node* node = head; node != nullptr; node = node->next) {
+    count++;
+  }
+  if (count > batch_capacity_) {
+    free(batch_);
+    batch_capacity_ = Utils::RoundUpToPowerOfTwo(count);
+    batch_ = reinterpret_cast<uint8_t*>(malloc(batch_capacity_ * record_size_));
+    if (batch_ == nullptr) {
+      OUT_OF_MEMORY();
+    }
+  }
+
+  // The stack holds the most recent record first.
+  intptr_t index = count;
+  while (head != nullptr) {
+    Node* next = head->next;
+    index--;
+    memmove(batch_ + index * record_size_, RecordOf(head), record_size_);
+    free(head);
+    head = next;
+  }
+  return count;
+}
+
+}  // namespace dart
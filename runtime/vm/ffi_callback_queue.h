@@ -0,0 +1,64 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_FFI_CALLBACK_QUEUE_H_
+#define RUNTIME_VM_FFI_CALLBACK_QUEUE_H_
+
+#include "include/dart_api.h"
+#include "platform/globals.h"
+#include "vm/allocation.h"
+
+namespace dart {
+
+// A queue of fixed-size records which native threads post to and which the
+// isolate owning the queue hands to Dart code in batches. This backs
+// AsyncCallbackQueue in dart:ffi and Dart_PostAsyncCallback.
+//
+// Posting pushes a malloc'ed copy of the record onto a lock-free stack. Only
+// the post which finds the stack empty sends a message to the owner's port,
+// so a burst of records costs a single trip through the owner's message
+// handler. The owner takes the whole stack at once, copies it into a
+// contiguous batch in posting order and frees the copies.
+class FfiCallbackQueue {
+ public:
+  FfiCallbackQueue(intptr_t record_size, Dart_Port port);
+  ~FfiCallbackQueue();
+
+  // May be called on any thread. Returns false if the record could not be
+  // allocated or the owner's port is closed.
+  bool Post(const void* record);
+
+  // Moves the pending records into the batch and returns their number. Must
+  // only be called by the owner.
+  intptr_t Drain();
+
+  // The records moved by the last Drain, valid until the next one.
+  uint8_t* batch() const { return batch_; }
+
+  intptr_t record_size() const { return record_size_; }
+
+ private:
+  struct Node {
+    Node* next;
+  };
+
+  static const intptr_t kNodeHeaderSize;
+
+  static uint8_t* RecordOf(Node* node) {
+    return reinterpret_cast<uint8_t*>(node) + kNodeHeaderSize;
+  }
+
+  const intptr_t record_size_;
+  const Dart_Port port_;
+  // The records posted since the last Drain, most recent first.
+  Node* head_;
+  uint8_t* batch_;
+  intptr_t batch_capacity_;
+
+  DISALLOW_COPY_AND_ASSIGN(FfiCallbackQueue);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_FFI_CALLBACK_QUEUE_H_
@@ -57,6 +57,11 @@ constexpr bool kDartPrecompiledRuntime = false;
     "Debugger support async functions.")                                       \
   P(background_compilation, bool, USING_MULTICORE,                             \
     "Run optimizing compilation in background")                                \
+  P(become_tasks, int, 2,                                                      \
+    "The number of tasks to use for forwarding pointers after a become.")      \
+  R(block_coverage, false, bool, false,                                        \
+    "Record source coverage from unoptimized and optimized code by setting "   \
+    "a per-function flag on entry to each branch.")                            \
   P(causal_async_stacks, bool, !USING_PRODUCT, "Improved async stacks")        \
   P(collect_code, bool, false, "Attempt to GC infrequently used code.")        \
   P(collect_dynamic_function_names, bool, true,                                \
@@ -76,14 +81,21 @@ constexpr bool kDartPrecompiledRuntime = false;
     "Deoptimizes we are about to return to Dart code from native entries.")    \
   C(deoptimize_every, 0, 0, int, 0,                                            \
     "Deoptimize on every N stack overflow checks")                             \
+  P(deserializer_tasks, int, 0,                                                \
+    "The number of tasks to spawn for filling snapshot clusters (0 means "     \
+    "filling them on the main thread).")                                       \
   R(disable_alloc_stubs_after_gc, false, bool, false, "Stress testing flag.")  \
   R(disassemble, false, bool, false, "Disassemble dart code.")                 \
   R(disassemble_optimized, false, bool, false, "Disassemble optimized code.")  \
   R(disassemble_relative, false, bool, false,                                  \
     "Use offsets instead of absolute PCs")                                     \
+  R(dump_compiler_pass_stats, false, bool, false,                              \
+    "Dump the time and IL size of compiler passes and compiled functions")     \
   R(dump_megamorphic_stats, false, bool, false,                                \
     "Dump megamorphic cache statistics")                                       \
   R(dump_symbol_stats, false, bool, false, "Dump symbol table statistics")     \
+  R(dump_type_check_stats, false, bool, false,                                 \
+    "Dump statistics about type checks which were done in the runtime")        \
   P(dwarf_stack_traces, bool, false,                                           \
     "Emit DWARF line number and inlining info"                                 \
     "in dylib snapshots and don't symbolize stack traces.")                    \
@@ -109,6 +121,8 @@ constexpr bool kDartPrecompiledRuntime = false;
     "Allow idle tasks to run for this long.")                                  \
   P(interpret_irregexp, bool, USING_DBC, "Use irregexp bytecode interpreter")  \
   P(lazy_dispatchers, bool, true, "Generate dispatchers lazily")               \
+  P(lazy_snapshot_code, bool, false,                                           \
+    "Attach code read from a JIT snapshot to its function on first call.")     \
   P(link_natives_lazily, bool, false, "Link native calls lazily")              \
   C(load_deferred_eagerly, true, true, bool, false,                            \
     "Load deferred libraries eagerly.")                                        \
@@ -158,6 +172,12 @@ constexpr bool kDartPrecompiledRuntime = false;
   R(profiler_native_memory, false, bool, false,                                \
     "Enable native memory statistic collection.")                              \
   P(reorder_basic_blocks, bool, true, "Reorder basic blocks")                  \
+  P(scavenger_tasks, int, 0,                                                   \
+    "The number of tasks to spawn during new gen GC scavenging (0 means "      \
+    "perform all scavenging on main thread).")                                 \
+  P(serializer_tasks, int, 0,                                                  \
+    "The number of tasks to spawn for writing snapshot clusters (0 means "     \
+    "writing them on the main thread).")                                       \
   C(stress_async_stacks, false, false, bool, false,                            \
     "Stress test async stack traces")                                          \
   P(use_bare_instructions, bool, true, "Enable bare instructions mode.")       \
@@ -100,6 +100,14 @@ const intptr_t kDefaultMaxOldGenHeapSize = (kWordSize <= 4) ? 1536 : 0;
 #define HASH_IN_OBJECT_HEADER 1
 #endif
 
+// The heap cage is only implemented for 64-bit POSIX hosts.
+#if defined(DART_HEAP_CAGE) &&                                       \
+    (!defined(ARCH_IS_64_BIT) ||                                               \
+     !(defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID) ||                   \
+       defined(HOST_OS_MACOS)))
+#error The heap cage requires a 64-bit Linux, Android or macOS host.
+#endif
+
 // The expression OFFSET_OF(type, field) computes the byte-offset of
 // the specified field relative to the containing type.
 //
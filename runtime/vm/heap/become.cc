@@ -7,11 +7,15 @@
 #include "platform/assert.h"
 #include "platform/utils.h"
 
+#include "vm/dart.h"
 #include "vm/dart_api_state.h"
+#include "vm/heap/pages.h"
 #include "vm/heap/safepoint.h"
 #include "vm/isolate_reload.h"
 #include "vm/object.h"
 #include "vm/raw_object.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
 #include "vm/timeline.h"
 #include "vm/visitor.h"
 
@@ -146,6 +150,62 @@ class ForwardHeapPointersHandleVisitor : public HandleVisitor {
   DISALLOW_COPY_AND_ASSIGN(ForwardHeapPointersHandleVisitor);
 };
 
+// Forwards the pointers of the objects in 'pages', claiming one page at a
+// time through 'next_page' so that it can run concurrently with other
+// callers over the same pages.
+static void ForwardPages(Thread* thread,
+                         const GrowableArray<HeapPage*>& pages,
+                         uintptr_t* next_page) {
+  ForwardPointersVisitor pointer_visitor(thread);
+  ForwardHeapPointersVisitor object_visitor(&pointer_visitor);
+  const uintptr_t num_pages = pages.length();
+  uintptr_t index = AtomicOperations::FetchAndIncrement(next_page);
+  while (index < num_pages) {
+    pages[index]->VisitObjects(&object_visitor);
+    index = AtomicOperations::FetchAndIncrement(next_page);
+  }
+  pointer_visitor.VisitingObject(NULL);
+}
+
+class ForwardPagesTask : public ThreadPool::Task {
+ public:
+  ForwardPagesTask(Isolate* isolate,
+                   ThreadBarrier* barrier,
+                   const GrowableArray<HeapPage*>* pages,
+                   uintptr_t* next_page)
+      : isolate_(isolate),
+        barrier_(barrier),
+        pages_(pages),
+        next_page_(next_page) {}
+
+  virtual void Run() {
+    bool result =
+        Thread::EnterIsolateAsHelper(isolate_, Thread::kBecomeTask, true);
+    ASSERT(result);
+    {
+      Thread* thread = Thread::Current();
+      TIMELINE_FUNCTION_GC_DURATION(thread, "ForwardPages");
+      ForwardPages(thread, *pages_, next_page_);
+    }
+    // Release the store buffer block before the main thread proceeds.
+    Thread::ExitIsolateAsHelper(true);
+    barrier_->Sync();
+    barrier_->Exit();
+  }
+
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kHighPriority;
+  }
+
+ private:
+  Isolate* isolate_;
+  ThreadBarrier* barrier_;
+  const GrowableArray<HeapPage*>* pages_;
+  uintptr_t* next_page_;
+
+  DISALLOW_COPY_AND_ASSIGN(ForwardPagesTask);
+};
+
 // On IA32, object pointers are embedded directly in the instruction stream,
 // which is normally write-protected, so we need to make it temporarily writable
 // to forward the pointers. On all other architectures, object pointers are
@@ -215,19 +275,44 @@ void Become::CrashDump(RawObject* before_obj, RawObject* after_obj) {
   }
 }
 
+Become::Become()
+    : pairs_(GrowableObjectArray::Handle(
+          GrowableObjectArray::New(Heap::kOld))) {}
+
+void Become::Add(const Object& before, const Object& after) {
+  pairs_.Add(before, Heap::kOld);
+  pairs_.Add(after, Heap::kOld);
+}
+
 void Become::ElementsForwardIdentity(const Array& before, const Array& after) {
+  ASSERT(before.Length() == after.Length());
+  Become become;
+  Object& before_obj = Object::Handle();
+  Object& after_obj = Object::Handle();
+  for (intptr_t i = 0; i < before.Length(); i++) {
+    before_obj = before.At(i);
+    after_obj = after.At(i);
+    become.Add(before_obj, after_obj);
+  }
+  become.Forward();
+}
+
+void Become::Forward() {
+  if (pairs_.Length() == 0) {
+    return;
+  }
+
   Thread* thread = Thread::Current();
   Isolate* isolate = thread->isolate();
   Heap* heap = isolate->heap();
 
-  TIMELINE_FUNCTION_GC_DURATION(thread, "Become::ElementsForwardIdentity");
+  TIMELINE_FUNCTION_GC_DURATION(thread, "Become::Forward");
   HeapIterationScope his(thread);
 
   // Setup forwarding pointers.
-  ASSERT(before.Length() == after.Length());
-  for (intptr_t i = 0; i < before.Length(); i++) {
-    RawObject* before_obj = before.At(i);
-    RawObject* after_obj = after.At(i);
+  for (intptr_t i = 0; i < pairs_.Length(); i += 2) {
+    RawObject* before_obj = pairs_.At(i);
+    RawObject* after_obj = pairs_.At(i + 1);
 
     if (before_obj == after_obj) {
       FATAL("become: Cannot self-forward");
@@ -264,10 +349,11 @@ void Become::ElementsForwardIdentity(const Array& before, const Array& after) {
   FollowForwardingPointers(thread);
 
 #if defined(DEBUG)
-  for (intptr_t i = 0; i < before.Length(); i++) {
-    ASSERT(before.At(i) == after.At(i));
+  for (intptr_t i = 0; i < pairs_.Length(); i += 2) {
+    ASSERT(pairs_.At(i) == pairs_.At(i + 1));
   }
 #endif
+  pairs_.SetLength(0);
 }
 
 void Become::FollowForwardingPointers(Thread* thread) {
@@ -283,11 +369,32 @@ void Become::FollowForwardingPointers(Thread* thread) {
   ForwardPointersVisitor pointer_visitor(thread);
 
   {
-    // Heap pointers.
+    // Heap pointers. Old-space pages are shared out between the helper tasks
+    // and this thread, which visits new space first.
+    TIMELINE_FUNCTION_GC_DURATION(thread, "ForwardHeapPointers");
     WritableCodeLiteralsScope writable_code(heap);
+    GrowableArray<HeapPage*> pages;
+    heap->old_space()->AddPagesTo(&pages);
+    uintptr_t next_page = 0;
+    const intptr_t num_tasks =
+        Utils::Minimum<intptr_t>(FLAG_become_tasks, pages.length() - 1);
     ForwardHeapPointersVisitor object_visitor(&pointer_visitor);
-    heap->VisitObjects(&object_visitor);
+    heap->new_space()->VisitObjects(&object_visitor);
     pointer_visitor.VisitingObject(NULL);
+    if (num_tasks <= 0) {
+      ForwardPages(thread, pages, &next_page);
+    } else {
+      ThreadBarrier barrier(num_tasks + 1, heap->barrier(),
+                            heap->barrier_done());
+      for (intptr_t i = 0; i < num_tasks; i++) {
+        bool result = Dart::thread_pool()->Run<ForwardPagesTask>(
+            isolate, &barrier, &pages, &next_page);
+        ASSERT(result);
+      }
+      ForwardPages(thread, pages, &next_page);
+      barrier.Sync();
+      barrier.Exit();
+    }
   }
 
   // C++ pointers.
@@ -70,14 +70,27 @@ class ForwardingCorpse {
   DISALLOW_IMPLICIT_CONSTRUCTORS(ForwardingCorpse);
 };
 
-// TODO(johnmccutchan): Refactor this class so that it is not all static and
-// provides utility methods for building the mapping of before and after.
-class Become : public AllStatic {
+// Smalltalk's one-way bulk become (Array>>#elementsForwardIdentityTo:).
+//
+// Pairs of objects are accumulated with Add, and Forward then redirects all
+// pointers to each 'before' object to its 'after' object. Every 'before'
+// object is guaranteed to be not reachable afterwards. Useful for atomically
+// applying behavior and schema changes.
+//
+// Forwarding walks the whole heap, so all pairs of one operation should be
+// forwarded together rather than with separate Become instances.
+class Become : public ValueObject {
  public:
-  // Smalltalk's one-way bulk become (Array>>#elementsForwardIdentityTo:).
-  // Redirects all pointers to elements of 'before' to the corresponding element
-  // in 'after'. Every element in 'before' is guaranteed to be not reachable.
-  // Useful for atomically applying behavior and schema changes.
+  Become();
+
+  void Add(const Object& before, const Object& after);
+
+  // Forwards all pairs added since the last Forward in a single walk of the
+  // heap, which is split between --become_tasks helper tasks.
+  void Forward();
+
+  // Forwards each element of 'before' to the corresponding element of
+  // 'after'.
   static void ElementsForwardIdentity(const Array& before, const Array& after);
 
   // Convert and instance object into a dummy object,
@@ -91,6 +104,11 @@ class Become : public AllStatic {
   static void FollowForwardingPointers(Thread* thread);
 
   static void CrashDump(RawObject* before_obj, RawObject* after_obj);
+
+  // Holds the 'before' and 'after' object of each pair in consecutive slots.
+  const GrowableObjectArray& pairs_;
+
+  DISALLOW_COPY_AND_ASSIGN(Become);
 };
 
 }  // namespace dart
@@ -8,6 +8,8 @@
 #include "vm/heap/become.h"
 #include "vm/heap/heap.h"
 #include "vm/heap/pages.h"
+#include "vm/heap/sweeper.h"
+#include "vm/reverse_pc_lookup_cache.h"
 #include "vm/thread_barrier.h"
 #include "vm/timeline.h"
 
@@ -17,6 +19,17 @@ DEFINE_FLAG(bool,
             force_evacuation,
             false,
             "Force compaction to move every movable object");
+DEFINE_FLAG(int,
+            compactor_max_pages,
+            0,
+            "If non-zero, each compaction only moves the objects of up to this "
+            "many of the most fragmented pages and sweeps the others, so "
+            "repeated GCs compact the heap incrementally.");
+DEFINE_FLAG(int,
+            compactor_max_occupancy,
+            50,
+            "The percentage of live bytes above which a page is not worth "
+            "compacting when --compactor_max_pages is given.");
 
 static const intptr_t kBitVectorWordsPerBlock = 1;
 static const intptr_t kBlockSize =
@@ -137,6 +150,10 @@ class CompactorTask : public ThreadPool::Task {
         free_current_(0),
         free_end_(0) {}
 
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kHighPriority;
+  }
+
  private:
   void Run();
   void PlanPage(HeapPage* page);
@@ -144,6 +161,10 @@ class CompactorTask : public ThreadPool::Task {
   uword PlanBlock(uword first_object, ForwardingPage* forwarding_page);
   uword SlideBlock(uword first_object, ForwardingPage* forwarding_page);
   void PlanMoveToContiguousSize(intptr_t size);
+  void ForwardUnselectedPage(HeapPage* page);
+  void ForwardWeakTableChunks();
+
+  static const intptr_t kNumFixedForwardingTasks = 7;
 
   Isolate* isolate_;
   GCCompactor* compactor_;
@@ -170,6 +191,23 @@ void GCCompactor::Compact(HeapPage* pages,
                           Mutex* pages_lock) {
   SetupImagePageBoundaries();
 
+  if ((FLAG_compactor_max_pages > 0) &&
+      ((max_pages_ == 0) || (FLAG_compactor_max_pages < max_pages_))) {
+    max_pages_ = FLAG_compactor_max_pages;
+  }
+  if (max_pages_ > 0) {
+    pages = SelectPages(pages);
+    if (pages == NULL) {
+      // Nothing worth moving, so there is nothing to forward either.
+      {
+        MutexLocker ml(pages_lock);
+        heap_->old_space()->pages_ = heap_->old_space()->pages_tail_ = NULL;
+      }
+      SweepUnselectedPages(freelist, pages_lock);
+      return;
+    }
+  }
+
   // Divide the heap.
   // TODO(30978): Try to divide based on live bytes or with work stealing.
   intptr_t num_pages = 0;
@@ -232,6 +270,7 @@ void GCCompactor::Compact(HeapPage* pages,
     ThreadBarrier barrier(num_tasks + 1, heap_->barrier(),
                           heap_->barrier_done());
     intptr_t next_forwarding_task = 0;
+    PrepareWeakTables();
 
     for (intptr_t task_index = 0; task_index < num_tasks; task_index++) {
       Dart::thread_pool()->Run<CompactorTask>(
@@ -315,6 +354,93 @@ void GCCompactor::Compact(HeapPage* pages,
   for (HeapPage* page = pages; page != NULL; page = page->next()) {
     page->FreeForwardingPage();
   }
+
+  SweepUnselectedPages(freelist, pages_lock);
+}
+
+static int CompareLiveBytes(const GCCompactor::PageLiveBytes* a,
+                            const GCCompactor::PageLiveBytes* b) {
+  if (a->live_bytes < b->live_bytes) return -1;
+  if (a->live_bytes > b->live_bytes) return 1;
+  return 0;
+}
+
+// Chooses the pages with the fewest live bytes, up to max_pages_ of them, and
+// returns them as a list. The other pages are left in unselected_pages_.
+HeapPage* GCCompactor::SelectPages(HeapPage* pages) {
+  TIMELINE_FUNCTION_GC_DURATION(thread(), "SelectPages");
+  MallocGrowableArray<PageLiveBytes> candidates(64);
+  for (HeapPage* page = pages; page != NULL; page = page->next()) {
+    const uword start = page->object_start();
+    const uword end = page->object_end();
+    intptr_t live_bytes = 0;
+    for (uword current = start; current < end;) {
+      RawObject* obj = RawObject::FromAddr(current);
+      const intptr_t size = obj->HeapSize();
+      if (obj->IsMarked()) {
+        live_bytes += size;
+      }
+      current += size;
+    }
+    if (live_bytes * 100 <
+        static_cast<intptr_t>(end - start) * FLAG_compactor_max_occupancy) {
+      PageLiveBytes candidate = {page, live_bytes};
+      candidates.Add(candidate);
+    } else {
+      unselected_pages_.Add(page);
+    }
+  }
+
+  candidates.Sort(CompareLiveBytes);
+  // Moving a single page at most closes its gaps, which sweeping achieves
+  // without moving objects.
+  const intptr_t num_selected =
+      candidates.length() < 2
+          ? 0
+          : Utils::Minimum(candidates.length(), max_pages_);
+  HeapPage* selected = NULL;
+  for (intptr_t i = candidates.length() - 1; i >= 0; i--) {
+    HeapPage* page = candidates[i].page;
+    if (i < num_selected) {
+      page->set_next(selected);
+      selected = page;
+    } else {
+      unselected_pages_.Add(page);
+    }
+  }
+  for (intptr_t i = 0; i < unselected_pages_.length(); i++) {
+    unselected_pages_[i]->set_next(NULL);
+  }
+  return selected;
+}
+
+// Sweeps the pages which were not compacted and appends those still in use to
+// the page list.
+void GCCompactor::SweepUnselectedPages(FreeList* freelist, Mutex* pages_lock) {
+  if (unselected_pages_.is_empty()) {
+    return;
+  }
+  TIMELINE_FUNCTION_GC_DURATION(thread(), "SweepUnselectedPages");
+  PageSpace* old_space = heap_->old_space();
+  GCSweeper sweeper;
+  MutexLocker ml(pages_lock);
+  MutexLocker mlf(freelist->mutex());
+  for (intptr_t i = 0; i < unselected_pages_.length(); i++) {
+    HeapPage* page = unselected_pages_[i];
+    if (sweeper.SweepPage(page, freelist, true)) {
+      if (old_space->pages_tail_ == NULL) {
+        old_space->pages_ = page;
+      } else {
+        old_space->pages_tail_->set_next(page);
+      }
+      old_space->pages_tail_ = page;
+    } else {
+      old_space->IncreaseCapacityInWordsLocked(
+          -(page->memory_->size() >> kWordSizeLog2));
+      page->Deallocate();
+    }
+  }
+  unselected_pages_.Clear();
 }
 
 void CompactorTask::Run() {
@@ -388,7 +514,7 @@ void CompactorTask::Run() {
         }
         case 3: {
           TIMELINE_FUNCTION_GC_DURATION(thread, "ForwardWeakTables");
-          isolate_->heap()->ForwardWeakTables(compactor_);
+          ForwardWeakTableChunks();
           break;
         }
         case 4: {
@@ -405,12 +531,33 @@ void CompactorTask::Run() {
           break;
         }
 #endif  // !PRODUCT
-        default:
-          more_forwarding_tasks = false;
+#if !defined(DART_PRECOMPILED_RUNTIME)
+        case 6: {
+          TIMELINE_FUNCTION_GC_DURATION(thread, "ForwardJitPcLookupTable");
+          isolate_->jit_pc_lookup_table()->VisitPointers(compactor_);
+          break;
+        }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+        default: {
+          // Pages which were not selected for compaction are not slid, so
+          // their live objects are forwarded here, one page per task.
+          // (Negative indices are fixed tasks which do not exist in
+          // PRODUCT mode.)
+          const intptr_t index = forwarding_task - kNumFixedForwardingTasks;
+          if (index >= compactor_->unselected_pages_.length()) {
+            // Help with the weak tables before running out of work.
+            ForwardWeakTableChunks();
+            more_forwarding_tasks = false;
+          } else if (index >= 0) {
+            ForwardUnselectedPage(compactor_->unselected_pages_[index]);
+          }
+        }
       }
     }
 
     barrier_->Sync();
+
+    compactor_->RehashWeakTables();
   }
   Thread::ExitIsolateAsHelper(true);
 
@@ -418,6 +565,15 @@ void CompactorTask::Run() {
   barrier_->Exit();
 }
 
+void CompactorTask::ForwardWeakTableChunks() {
+  WeakTable* table;
+  intptr_t start;
+  intptr_t end;
+  while (compactor_->weak_table_chunks_.ClaimChunk(&table, &start, &end)) {
+    table->ForwardRange(compactor_, start, end);
+  }
+}
+
 void CompactorTask::PlanPage(HeapPage* page) {
   uword current = page->object_start();
   uword end = page->object_end();
@@ -530,6 +686,20 @@ uword CompactorTask::SlideBlock(uword first_object,
   return old_addr;  // First object in the next block.
 }
 
+void CompactorTask::ForwardUnselectedPage(HeapPage* page) {
+  // Only live objects: dead ones may point to pages which will be freed.
+  // The mark bits are left for the sweeper.
+  uword current = page->object_start();
+  uword end = page->object_end();
+  while (current < end) {
+    RawObject* obj = RawObject::FromAddr(current);
+    if (obj->IsMarked()) {
+      obj->VisitPointers(compactor_);
+    }
+    current += obj->HeapSize();
+  }
+}
+
 void CompactorTask::PlanMoveToContiguousSize(intptr_t size) {
   // Move the free cursor to ensure 'size' bytes of contiguous space.
   ASSERT(size <= kPageSize);
@@ -547,6 +717,29 @@ void CompactorTask::PlanMoveToContiguousSize(intptr_t size) {
   }
 }
 
+void GCCompactor::PrepareWeakTables() {
+  weak_table_chunks_.Reset();
+  for (int sel = 0; sel < Heap::kNumWeakSelectors; sel++) {
+    Heap::WeakSelector selector = static_cast<Heap::WeakSelector>(sel);
+    weak_table_chunks_.AddTable(heap_->GetWeakTable(Heap::kNew, selector));
+    weak_table_chunks_.AddTable(heap_->GetWeakTable(Heap::kOld, selector));
+  }
+  next_weak_table_rehash_ = 0;
+}
+
+void GCCompactor::RehashWeakTables() {
+  while (true) {
+    intptr_t i = AtomicOperations::FetchAndIncrement(&next_weak_table_rehash_);
+    if (i >= weak_table_chunks_.num_tables()) {
+      break;
+    }
+    WeakTable* table = weak_table_chunks_.TableAt(i);
+    if (table->used() != 0) {
+      table->Rehash();
+    }
+  }
+}
+
 void GCCompactor::SetupImagePageBoundaries() {
   for (intptr_t i = 0; i < kMaxImagePages; i++) {
     image_page_ranges_[i].base = 0;
@@ -10,6 +10,7 @@
 #include "vm/allocation.h"
 #include "vm/dart_api_state.h"
 #include "vm/globals.h"
+#include "vm/heap/weak_table.h"
 #include "vm/visitor.h"
 
 namespace dart {
@@ -20,23 +21,38 @@ class Heap;
 class HeapPage;
 class RawObject;
 
-// Implements a sliding compactor.
+// Implements a sliding compactor. With --compactor_max_pages or a page budget,
+// only the most fragmented pages are slid and the others are swept.
 class GCCompactor : public ValueObject,
                     public HandleVisitor,
                     public ObjectPointerVisitor {
  public:
-  GCCompactor(Thread* thread, Heap* heap)
+  // A non-zero max_pages bounds the pages moved below --compactor_max_pages.
+  GCCompactor(Thread* thread, Heap* heap, intptr_t max_pages)
       : HandleVisitor(thread),
         ObjectPointerVisitor(thread->isolate()),
-        heap_(heap) {}
+        heap_(heap),
+        max_pages_(max_pages),
+        unselected_pages_(0),
+        next_weak_table_rehash_(0) {}
   ~GCCompactor() {}
 
   void Compact(HeapPage* pages, FreeList* freelist, Mutex* mutex);
 
+  struct PageLiveBytes {
+    HeapPage* page;
+    intptr_t live_bytes;
+  };
+
  private:
   friend class CompactorTask;
 
+  HeapPage* SelectPages(HeapPage* pages);
+  void SweepUnselectedPages(FreeList* freelist, Mutex* pages_lock);
   void SetupImagePageBoundaries();
+  void PrepareWeakTables();
+  // Called by the tasks once all weak table keys are forwarded.
+  void RehashWeakTables();
   void ForwardStackPointers();
   void ForwardPointer(RawObject** ptr);
   void VisitTypedDataViewPointers(RawTypedDataView* view,
@@ -46,6 +62,7 @@ class GCCompactor : public ValueObject,
   void VisitHandle(uword addr);
 
   Heap* heap_;
+  intptr_t max_pages_;
 
   struct ImagePageRange {
     uword base;
@@ -60,6 +77,14 @@ class GCCompactor : public ValueObject,
   // complete.
   Mutex typed_data_view_mutex_;
   MallocGrowableArray<RawTypedDataView*> typed_data_views_;
+
+  // The pages which are swept instead of compacted.
+  MallocGrowableArray<HeapPage*> unselected_pages_;
+
+  // The weak tables, whose keys are forwarded by all tasks in chunks. Each
+  // table is then rehashed by one task.
+  WeakTableChunks weak_table_chunks_;
+  intptr_t next_weak_table_rehash_;
 };
 
 }  // namespace dart
@@ -10,6 +10,7 @@
 #include "vm/object.h"
 #include "vm/os_thread.h"
 #include "vm/raw_object.h"
+#include "vm/virtual_memory.h"
 
 namespace dart {
 
@@ -55,7 +56,8 @@ intptr_t FreeListElement::HeaderSizeFor(intptr_t size) {
 }
 
 FreeList::FreeList()
-    : mutex_(), freelist_search_budget_(kInitialFreeListSearchBudget) {
+    : mutex_(NOT_IN_PRODUCT("FreeList::mutex_")),
+      freelist_search_budget_(kInitialFreeListSearchBudget) {
   Reset();
 }
 
@@ -106,71 +108,111 @@ uword FreeList::TryAllocateLocked(intptr_t size, bool is_protected) {
     }
   }
 
+  intptr_t large_class = -1;
   FreeListElement* previous = NULL;
-  FreeListElement* current = free_lists_[kNumLists];
-  // We are willing to search the freelist further for a big block.
-  // For each successful free-list search we:
-  //   * increase the search budget by #allocated-words
-  //   * decrease the search budget by #free-list-entries-traversed
-  //     which guarantees us to not waste more than around 1 search step per
-  //     word of allocation
-  //
-  // If we run out of search budget we fall back to allocating a new page and
-  // reset the search budget.
-  intptr_t tries_left = freelist_search_budget_ + (size >> kWordSizeLog2);
-  while (current != NULL) {
-    if (current->HeapSize() >= size) {
-      // Found an element large enough to hold the requested size. Dequeue,
-      // split and enqueue the remainder.
-      intptr_t remainder_size = current->HeapSize() - size;
-      intptr_t region_size =
-          size + FreeListElement::HeaderSizeFor(remainder_size);
-      if (is_protected) {
-        // Make the allocated block and the header of the remainder element
-        // writable.  The remainder will be non-writable if necessary after
-        // the call to SplitElementAfterAndEnqueue.
-        VirtualMemory::Protect(reinterpret_cast<void*>(current), region_size,
-                               VirtualMemory::kReadWrite);
-      }
+  FreeListElement* element = FindLargeElement(size, &large_class, &previous);
+  if (element == NULL) {
+    return 0;  // Trigger allocation of new page.
+  }
+  // Dequeue, split and enqueue the remainder.
+  intptr_t remainder_size = element->HeapSize() - size;
+  intptr_t region_size = size + FreeListElement::HeaderSizeFor(remainder_size);
+  if (is_protected) {
+    // Make the allocated block and the header of the remainder element
+    // writable.  The remainder will be non-writable if necessary after
+    // the call to SplitElementAfterAndEnqueue.
+    VirtualMemory::Protect(reinterpret_cast<void*>(element), region_size,
+                           VirtualMemory::kReadWrite);
+  }
+  UnlinkLargeElement(large_class, previous, element, is_protected,
+                     region_size);
+  SplitElementAfterAndEnqueue(element, size, is_protected);
+  return reinterpret_cast<uword>(element);
+}
 
-      if (previous == NULL) {
-        free_lists_[kNumLists] = current->next();
-      } else {
-        // If the previous free list element's next field is protected, it
-        // needs to be unprotected before storing to it and reprotected
-        // after.
-        bool target_is_protected = false;
-        uword target_address = 0L;
-        if (is_protected) {
-          uword writable_start = reinterpret_cast<uword>(current);
-          uword writable_end = writable_start + region_size - 1;
-          target_address = previous->next_address();
-          target_is_protected =
-              !VirtualMemory::InSamePage(target_address, writable_start) &&
-              !VirtualMemory::InSamePage(target_address, writable_end);
-        }
-        if (target_is_protected) {
-          VirtualMemory::Protect(reinterpret_cast<void*>(target_address),
-                                 kWordSize, VirtualMemory::kReadWrite);
-        }
-        previous->set_next(current->next());
-        if (target_is_protected) {
-          VirtualMemory::Protect(reinterpret_cast<void*>(target_address),
-                                 kWordSize, VirtualMemory::kReadExecute);
-        }
+FreeListElement* FreeList::FindLargeElement(intptr_t size,
+                                            intptr_t* large_class,
+                                            FreeListElement** previous) {
+  *previous = NULL;
+  if (size >= kMinLargeSize) {
+    // The class containing the size holds the tightest fits, but only some
+    // of its elements are large enough. We are willing to search it for one.
+    // For each successful search we:
+    //   * increase the search budget by #allocated-words
+    //   * decrease the search budget by #free-list-entries-traversed
+    //     which guarantees us to not waste more than around 1 search step per
+    //     word of allocation
+    //
+    // If we run out of search budget we fall back to the larger classes and
+    // reset the search budget.
+    const intptr_t size_class = LargeClassForSize(size);
+    intptr_t tries_left = freelist_search_budget_ + (size >> kWordSizeLog2);
+    FreeListElement* current_previous = NULL;
+    FreeListElement* current = large_lists_[size_class];
+    while (current != NULL) {
+      if (current->HeapSize() >= size) {
+        freelist_search_budget_ =
+            Utils::Minimum(tries_left, kInitialFreeListSearchBudget);
+        *large_class = size_class;
+        *previous = current_previous;
+        return current;
+      } else if (tries_left-- < 0) {
+        freelist_search_budget_ = kInitialFreeListSearchBudget;
+        break;
       }
-      SplitElementAfterAndEnqueue(current, size, is_protected);
-      freelist_search_budget_ =
-          Utils::Minimum(tries_left, kInitialFreeListSearchBudget);
-      return reinterpret_cast<uword>(current);
-    } else if (tries_left-- < 0) {
-      freelist_search_budget_ = kInitialFreeListSearchBudget;
-      return 0;  // Trigger allocation of new page.
+      current_previous = current;
+      current = current->next();
     }
-    previous = current;
-    current = current->next();
   }
-  return 0;
+
+  // Any element of a larger class fits.
+  const intptr_t fitting_class = FittingLargeClass(size);
+  if (fitting_class < kNumLargeClasses) {
+    const intptr_t next_class = large_map_.Next(fitting_class);
+    if (next_class != -1) {
+      *large_class = next_class;
+      return large_lists_[next_class];
+    }
+  }
+  return NULL;
+}
+
+void FreeList::UnlinkLargeElement(intptr_t large_class,
+                                  FreeListElement* previous,
+                                  FreeListElement* element,
+                                  bool is_protected,
+                                  intptr_t writable_size) {
+  if (previous == NULL) {
+    ASSERT(large_lists_[large_class] == element);
+    large_lists_[large_class] = element->next();
+    if (element->next() == NULL) {
+      large_map_.Set(large_class, false);
+    }
+    return;
+  }
+
+  // If the previous free list element's next field is protected, it
+  // needs to be unprotected before storing to it and reprotected
+  // after.
+  bool target_is_protected = false;
+  uword target_address = 0L;
+  if (is_protected) {
+    uword writable_start = reinterpret_cast<uword>(element);
+    uword writable_end = writable_start + writable_size - 1;
+    target_address = previous->next_address();
+    target_is_protected =
+        !VirtualMemory::InSamePage(target_address, writable_start) &&
+        !VirtualMemory::InSamePage(target_address, writable_end);
+  }
+  if (target_is_protected) {
+    VirtualMemory::Protect(reinterpret_cast<void*>(target_address), kWordSize,
+                           VirtualMemory::kReadWrite);
+  }
+  previous->set_next(element->next());
+  if (target_is_protected) {
+    VirtualMemory::Protect(reinterpret_cast<void*>(target_address), kWordSize,
+                           VirtualMemory::kReadExecute);
+  }
 }
 
 void FreeList::Free(uword addr, intptr_t size) {
@@ -194,15 +236,23 @@ void FreeList::FreeLocked(uword addr, intptr_t size) {
 void FreeList::Reset() {
   MutexLocker ml(&mutex_);
   free_map_.Reset();
+  large_map_.Reset();
   last_free_small_size_ = -1;
-  for (int i = 0; i < (kNumLists + 1); i++) {
+  for (int i = 0; i < kNumLists; i++) {
     free_lists_[i] = NULL;
   }
+  for (int i = 0; i < kNumLargeClasses; i++) {
+    large_lists_[i] = NULL;
+  }
 }
 
 void FreeList::EnqueueElement(FreeListElement* element, intptr_t index) {
+  if (index == kNumLists) {
+    EnqueueLargeElement(element);
+    return;
+  }
   FreeListElement* next = free_lists_[index];
-  if (next == NULL && index != kNumLists) {
+  if (next == NULL) {
     free_map_.Set(index, true);
     last_free_small_size_ =
         Utils::Maximum(last_free_small_size_, index << kObjectAlignmentLog2);
@@ -211,6 +261,16 @@ void FreeList::EnqueueElement(FreeListElement* element, intptr_t index) {
   free_lists_[index] = element;
 }
 
+void FreeList::EnqueueLargeElement(FreeListElement* element) {
+  const intptr_t large_class = LargeClassForSize(element->HeapSize());
+  FreeListElement* next = large_lists_[large_class];
+  if (next == NULL) {
+    large_map_.Set(large_class, true);
+  }
+  element->set_next(next);
+  large_lists_[large_class] = element;
+}
+
 intptr_t FreeList::LengthLocked(int index) const {
   DEBUG_ASSERT(mutex_.IsOwnedByCurrentThread());
   ASSERT(index >= 0);
@@ -274,16 +334,18 @@ void FreeList::PrintLarge() const {
   int large_objects = 0;
   intptr_t large_bytes = 0;
   MallocDirectChainedHashMap<NumbersKeyValueTrait<IntptrPair> > map;
-  FreeListElement* node;
-  for (node = free_lists_[kNumLists]; node != NULL; node = node->next()) {
-    IntptrPair* pair = map.Lookup(node->HeapSize());
-    if (pair == NULL) {
-      large_sizes += 1;
-      map.Insert(IntptrPair(node->HeapSize(), 1));
-    } else {
-      pair->set_second(pair->second() + 1);
+  for (intptr_t i = 0; i < kNumLargeClasses; i++) {
+    FreeListElement* node;
+    for (node = large_lists_[i]; node != NULL; node = node->next()) {
+      IntptrPair* pair = map.Lookup(node->HeapSize());
+      if (pair == NULL) {
+        large_sizes += 1;
+        map.Insert(IntptrPair(node->HeapSize(), 1));
+      } else {
+        pair->set_second(pair->second() + 1);
+      }
+      large_objects += 1;
     }
-    large_objects += 1;
   }
 
   MallocDirectChainedHashMap<NumbersKeyValueTrait<IntptrPair> >::Iterator it =
@@ -309,6 +371,28 @@ void FreeList::Print() const {
   PrintLarge();
 }
 
+intptr_t FreeList::ReleaseFreeMemory() {
+  MutexLocker ml(&mutex_);
+  const intptr_t page_size = VirtualMemory::PageSize();
+  intptr_t released = 0;
+  // Small elements are too small to span an OS page.
+  for (int i = 0; i < kNumLargeClasses; i++) {
+    for (FreeListElement* element = large_lists_[i]; element != NULL;
+         element = element->next()) {
+      const uword addr = reinterpret_cast<uword>(element);
+      const intptr_t size = element->HeapSize();
+      const uword start = Utils::RoundUp(
+          addr + FreeListElement::HeaderSizeFor(size), page_size);
+      const uword end = Utils::RoundDown(addr + size, page_size);
+      if (end > start) {
+        VirtualMemory::DontNeed(reinterpret_cast<void*>(start), end - start);
+        released += end - start;
+      }
+    }
+  }
+  return released;
+}
+
 void FreeList::SplitElementAfterAndEnqueue(FreeListElement* element,
                                            intptr_t size,
                                            bool is_protected) {
@@ -341,31 +425,22 @@ FreeListElement* FreeList::TryAllocateLarge(intptr_t minimum_size) {
 
 FreeListElement* FreeList::TryAllocateLargeLocked(intptr_t minimum_size) {
   DEBUG_ASSERT(mutex_.IsOwnedByCurrentThread());
+  // Prefer an element from the largest class, so the caller can bump
+  // allocate from it for as long as possible.
+  const intptr_t last_class = large_map_.Last();
+  if ((last_class != -1) && (last_class >= FittingLargeClass(minimum_size))) {
+    FreeListElement* element = large_lists_[last_class];
+    UnlinkLargeElement(last_class, NULL, element, false, 0);
+    return element;
+  }
+  intptr_t large_class = -1;
   FreeListElement* previous = NULL;
-  FreeListElement* current = free_lists_[kNumLists];
-  // TODO(koda): Find largest.
-  // We are willing to search the freelist further for a big block.
-  intptr_t tries_left =
-      freelist_search_budget_ + (minimum_size >> kWordSizeLog2);
-  while (current != NULL) {
-    FreeListElement* next = current->next();
-    if (current->HeapSize() >= minimum_size) {
-      if (previous == NULL) {
-        free_lists_[kNumLists] = next;
-      } else {
-        previous->set_next(next);
-      }
-      freelist_search_budget_ =
-          Utils::Minimum(tries_left, kInitialFreeListSearchBudget);
-      return current;
-    } else if (tries_left-- < 0) {
-      freelist_search_budget_ = kInitialFreeListSearchBudget;
-      return 0;  // Trigger allocation of new page.
-    }
-    previous = current;
-    current = next;
+  FreeListElement* element =
+      FindLargeElement(minimum_size, &large_class, &previous);
+  if (element != NULL) {
+    UnlinkLargeElement(large_class, previous, element, false, 0);
   }
-  return NULL;
+  return element;
 }
 
 }  // namespace dart
@@ -86,6 +86,11 @@ class FreeList {
 
   void Print() const;
 
+  // Gives the OS pages inside large elements back to the OS, keeping the
+  // element headers so the elements stay on the list. Returns the number of
+  // bytes released.
+  intptr_t ReleaseFreeMemory();
+
   Mutex* mutex() { return &mutex_; }
   uword TryAllocateLocked(intptr_t size, bool is_protected);
   void FreeLocked(uword addr, intptr_t size);
@@ -120,6 +125,36 @@ class FreeList {
   static const int kNumLists = 128;
   static const intptr_t kInitialFreeListSearchBudget = 1000;
 
+  // Elements too large for the fixed size lists are segregated into size
+  // classes by powers of two: class c holds the sizes in
+  // [kMinLargeSize << c, kMinLargeSize << (c + 1)), the last class all
+  // larger ones. Every element of a class above the one containing a size
+  // fits it, so finding a fit takes a bit scan of large_map_.
+  static const int kNumLargeClasses = 12;
+  static const intptr_t kMinLargeSize = kNumLists << kObjectAlignmentLog2;
+
+  static intptr_t LargeClassForSize(intptr_t size) {
+    ASSERT(size >= kMinLargeSize);
+    const intptr_t large_class =
+        Utils::HighestBit(size) - Utils::HighestBit(kMinLargeSize);
+    return Utils::Minimum(large_class,
+                          static_cast<intptr_t>(kNumLargeClasses - 1));
+  }
+
+  // Returns the first class all of whose elements are at least 'size', or
+  // kNumLargeClasses if there is none.
+  static intptr_t FittingLargeClass(intptr_t size) {
+    if (size <= kMinLargeSize) {
+      return 0;
+    }
+    const intptr_t large_class = LargeClassForSize(size);
+    if ((large_class < kNumLargeClasses - 1) &&
+        (size == (kMinLargeSize << large_class))) {
+      return large_class;
+    }
+    return large_class + 1;
+  }
+
   static intptr_t IndexForSize(intptr_t size) {
     ASSERT(size >= kObjectAlignment);
     ASSERT(Utils::IsAligned(size, kObjectAlignment));
@@ -155,6 +190,19 @@ class FreeList {
                                    intptr_t size,
                                    bool is_protected);
 
+  void EnqueueLargeElement(FreeListElement* element);
+  // Finds a large element of at least 'size' bytes without unlinking it.
+  FreeListElement* FindLargeElement(intptr_t size,
+                                    intptr_t* large_class,
+                                    FreeListElement** previous);
+  // Unlinks 'element', which follows 'previous' (or heads the list if it is
+  // NULL). If is_protected, [element, element + writable_size) is writable.
+  void UnlinkLargeElement(intptr_t large_class,
+                          FreeListElement* previous,
+                          FreeListElement* element,
+                          bool is_protected,
+                          intptr_t writable_size);
+
   void PrintSmall() const;
   void PrintLarge() const;
 
@@ -163,7 +211,11 @@ class FreeList {
 
   BitSet<kNumLists> free_map_;
 
-  FreeListElement* free_lists_[kNumLists + 1];
+  FreeListElement* free_lists_[kNumLists];
+
+  BitSet<kNumLargeClasses> large_map_;
+
+  FreeListElement* large_lists_[kNumLargeClasses];
 
   intptr_t freelist_search_budget_;
 
@@ -182,4 +182,59 @@ TEST_CASE(FreeListProtectedVariableSizeObjects) {
   delete[] objects;
 }
 
+TEST_CASE(FreeListLargeSizeClasses) {
+  FreeList* free_list = new FreeList();
+  const intptr_t kBlobSize = 256 * KB;
+  VirtualMemory* blob =
+      VirtualMemory::Allocate(kBlobSize, /* is_executable = */ false, NULL);
+  blob->Protect(VirtualMemory::kReadWrite);
+  uword start = blob->start();
+
+  // Free blocks of different size classes, largest first.
+  free_list->Free(start + 8 * KB, 64 * KB);
+  free_list->Free(start + 128 * KB, 16 * KB);
+  free_list->Free(start, 4 * KB);
+
+  // Allocations take a block from the smallest class that fits them.
+  EXPECT_EQ(start, free_list->TryAllocate(3 * KB, false));
+  EXPECT_EQ(start + 128 * KB, free_list->TryAllocate(10 * KB, false));
+  // The tails are enqueued in their own classes.
+  EXPECT_EQ(start + 3 * KB, free_list->TryAllocate(1 * KB, false));
+  EXPECT_EQ(start + 138 * KB, free_list->TryAllocate(6 * KB, false));
+
+  // Bump allocation prefers the largest block.
+  FreeListElement* element = free_list->TryAllocateLarge(1 * KB);
+  EXPECT_EQ(start + 8 * KB, reinterpret_cast<uword>(element));
+  EXPECT_EQ(64 * KB, element->HeapSize());
+  EXPECT(free_list->TryAllocateLarge(1 * KB) == NULL);
+
+  delete blob;
+  delete free_list;
+}
+
+TEST_CASE(FreeListReleaseFreeMemory) {
+  FreeList* free_list = new FreeList();
+  const intptr_t kBlobSize = 256 * KB;
+  VirtualMemory* blob =
+      VirtualMemory::Allocate(kBlobSize, /* is_executable = */ false, NULL);
+  blob->Protect(VirtualMemory::kReadWrite);
+  uword start = blob->start();
+
+  // Blocks smaller than an OS page keep all their memory.
+  free_list->Free(start, 1 * KB);
+  EXPECT_EQ(0, free_list->ReleaseFreeMemory());
+
+  // Only the whole OS pages after the element header are released.
+  const intptr_t page_size = VirtualMemory::PageSize();
+  free_list->Free(start + page_size, 128 * KB);
+  EXPECT_EQ(128 * KB - page_size, free_list->ReleaseFreeMemory());
+
+  // The released block can still be allocated in full.
+  EXPECT_EQ(start + page_size, free_list->TryAllocate(128 * KB, false));
+  memset(reinterpret_cast<void*>(start + page_size), 0, 128 * KB);
+
+  delete blob;
+  delete free_list;
+}
+
 }  // namespace dart
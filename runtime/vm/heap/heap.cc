@@ -6,6 +6,7 @@
 
 #include "platform/assert.h"
 #include "platform/utils.h"
+#include "vm/compiler/jit/code_cache.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/flags.h"
 #include "vm/heap/become.h"
@@ -32,6 +33,16 @@
 namespace dart {
 
 DEFINE_FLAG(bool, write_protect_vm_isolate, true, "Write protect vm_isolate.");
+DEFINE_FLAG(int,
+            heap_sample_interval,
+            0,
+            "Sample an allocation on average every this many bytes and track "
+            "the samples that stay alive. 0 disables heap sampling.");
+DEFINE_FLAG(int,
+            new_gen_external_ratio,
+            4,
+            "Scavenge when the external memory of new gen exceeds this many "
+            "times its capacity.");
 
 Heap::Heap(Isolate* isolate,
            intptr_t max_new_gen_semi_words,
@@ -97,6 +108,9 @@ uword Heap::AllocateNew(intptr_t size) {
   if (tlab_size > 0) {
     uword tlab_top = new_space_.TryAllocateNewTLAB(thread, tlab_size);
     if (tlab_top != 0) {
+#ifndef PRODUCT
+      thread->CountHeapSampleBytes(thread->end() - tlab_top);
+#endif
       addr = new_space_.TryAllocateInTLAB(thread, size);
       if (addr != 0) {  // but "leftover" TLAB could end smaller than tlab_size
         return addr;
@@ -115,6 +129,9 @@ uword Heap::AllocateNew(intptr_t size) {
 
   uword tlab_top = new_space_.TryAllocateNewTLAB(thread, tlab_size);
   if (tlab_top != 0) {
+#ifndef PRODUCT
+    thread->CountHeapSampleBytes(thread->end() - tlab_top);
+#endif
     addr = new_space_.TryAllocateInTLAB(thread, size);
     // It is possible a GC doesn't clear enough space.
     // In that case, we must fall through and allocate into old space.
@@ -179,7 +196,8 @@ void Heap::AllocateExternal(intptr_t cid, intptr_t size, Space space) {
   if (space == kNew) {
     isolate()->AssertCurrentThreadIsMutator();
     new_space_.AllocateExternal(cid, size);
-    if (new_space_.ExternalInWords() > (4 * new_space_.CapacityInWords())) {
+    if (new_space_.ExternalInWords() >
+        (FLAG_new_gen_external_ratio * new_space_.CapacityInWords())) {
       // Attempt to free some external allocation by a scavenge. (If the total
       // remains above the limit, next external alloc will trigger another.)
       CollectGarbage(kScavenge, kExternal);
@@ -278,6 +296,9 @@ HeapIterationScope::HeapIterationScope(Thread* thread, bool writable)
     old_space_->set_tasks(1);
   }
 
+  // Dead objects in pages left unswept can point to freed objects.
+  old_space_->FinishLazySweep();
+
   isolate()->safepoint_handler()->SafepointThreads(thread);
 
   if (writable_) {
@@ -427,14 +448,32 @@ void Heap::NotifyIdle(int64_t deadline) {
   if (old_space_.ShouldPerformIdleMarkCompact(deadline)) {
     TIMELINE_FUNCTION_GC_DURATION(thread, "IdleGC");
     CollectOldSpaceGarbage(thread, kMarkCompact, kIdle);
-  } else if (old_space_.ShouldPerformIdleMarkSweep(deadline)) {
+  } else if (old_space_.ShouldPerformIdleFinalizeMarking(deadline) ||
+             old_space_.ShouldPerformIdleMarkSweep(deadline)) {
     TIMELINE_FUNCTION_GC_DURATION(thread, "IdleGC");
-    CollectOldSpaceGarbage(thread, kMarkSweep, kIdle);
+    // Spend whatever time marking leaves on compacting the most fragmented
+    // pages, so repeated idle periods compact the heap incrementally.
+    const intptr_t pages = old_space_.IdleCompactionPageBudget(deadline);
+    old_space_.set_compaction_page_budget(pages);
+    CollectOldSpaceGarbage(thread, pages > 0 ? kMarkCompact : kMarkSweep,
+                           kIdle);
+    old_space_.set_compaction_page_budget(0);
+  } else if (old_space_.ShouldStartIdleConcurrentMark()) {
+    // The idle period is too short for a whole mark-sweep. Mark concurrently
+    // so that a later idle period only has to finalize.
+    StartConcurrentMarking(thread);
+  }
+
+  if (old_space_.ShouldReleaseFreeMemory()) {
+    TIMELINE_FUNCTION_GC_DURATION(thread, "ReleaseFreeMemory");
+    old_space_.ReleaseFreeMemory();
   }
 }
 
 void Heap::NotifyLowMemory() {
   CollectAllGarbage(kLowMemory);
+  WaitForSweeperTasks(Thread::Current());
+  old_space_.ReleaseFreeMemory();
 }
 
 void Heap::EvacuateNewSpace(Thread* thread, GCReason reason) {
@@ -481,7 +520,7 @@ void Heap::CollectOldSpaceGarbage(Thread* thread,
                                   GCReason reason) {
   ASSERT(reason != kNewSpace);
   ASSERT(type != kScavenge);
-  if (FLAG_use_compactor) {
+  if (FLAG_use_compactor || old_space_.NeedsCompaction()) {
     type = kMarkCompact;
   }
   if (BeginOldSpaceGC(thread)) {
@@ -497,6 +536,14 @@ void Heap::CollectOldSpaceGarbage(Thread* thread,
     thread->isolate()->handler_info_cache()->Clear();
     thread->isolate()->catch_entry_moves_cache()->Clear();
     EndOldSpaceGC();
+#if !defined(DART_PRECOMPILED_RUNTIME)
+    // Cold code is evicted at the next interrupt check of the mutator, and
+    // freed by the next GC.
+    CodeCache* code_cache = thread->isolate()->jit_code_cache();
+    if (CodeCache::IsEnabled() && (code_cache != nullptr)) {
+      code_cache->ScheduleAging(thread);
+    }
+#endif
   }
 }
 
@@ -550,11 +597,15 @@ void Heap::CheckStartConcurrentMarking(Thread* thread, GCReason reason) {
   }
 
   if (old_space_.AlmostNeedsGarbageCollection()) {
-    if (BeginOldSpaceGC(thread)) {
-      TIMELINE_FUNCTION_GC_DURATION_BASIC(thread, "StartConcurrentMarking");
-      old_space_.CollectGarbage(kMarkSweep, false /* finish */);
-      EndOldSpaceGC();
-    }
+    StartConcurrentMarking(thread);
+  }
+}
+
+void Heap::StartConcurrentMarking(Thread* thread) {
+  if (BeginOldSpaceGC(thread)) {
+    TIMELINE_FUNCTION_GC_DURATION_BASIC(thread, "StartConcurrentMarking");
+    old_space_.CollectGarbage(kMarkSweep, false /* finish */);
+    EndOldSpaceGC();
   }
 }
 
@@ -585,10 +636,13 @@ void Heap::WaitForMarkerTasks(Thread* thread) {
 }
 
 void Heap::WaitForSweeperTasks(Thread* thread) {
-  MonitorLocker ml(old_space_.tasks_lock());
-  while (old_space_.tasks() > 0) {
-    ml.WaitWithSafepointCheck(thread);
+  {
+    MonitorLocker ml(old_space_.tasks_lock());
+    while (old_space_.tasks() > 0) {
+      ml.WaitWithSafepointCheck(thread);
+    }
   }
+  old_space_.FinishLazySweep();
 }
 
 void Heap::UpdateGlobalMaxUsed() {
@@ -825,6 +879,78 @@ void Heap::ResetObjectIdTable() {
   old_weak_tables_[kObjectIds]->Reset();
 }
 
+#ifndef PRODUCT
+void Heap::RecordHeapSample(RawObject* raw_obj, intptr_t size) {
+  ASSERT(FLAG_heap_sample_interval > 0);
+  // With sampling points spread as a Poisson process over the allocated
+  // bytes, an object of |size| bytes is sampled with probability
+  // 1 - exp(-size / interval). Weighting by the inverse keeps the estimate of
+  // live bytes unbiased.
+  const double interval = FLAG_heap_sample_interval;
+  const double weight = size / (1.0 - exp(-size / interval));
+  SetWeakEntry(raw_obj, kHeapSamples, static_cast<intptr_t>(weight));
+}
+
+int64_t Heap::HeapSampleCount() const {
+  return new_weak_tables_[kHeapSamples]->count() +
+         old_weak_tables_[kHeapSamples]->count();
+}
+
+void Heap::PrintPauseHistogramsJSON(JSONStream* stream) const {
+  static const char* const kPauseNames[kNumPauseKinds] = {
+      "scavenge", "markSweep", "markCompact", "safepoint",
+      "markingFinalization",
+  };
+  JSONObject obj(stream);
+  obj.AddProperty("type", "_GCPauseHistograms");
+  for (intptr_t i = 0; i < kNumPauseKinds; i++) {
+    JSONObject histogram(&obj, kPauseNames[i]);
+    pause_histograms_[i].PrintJSON(&histogram);
+  }
+}
+
+void Heap::PrintHeapSampleProfileJSON(JSONStream* stream) {
+  Zone* zone = Thread::Current()->zone();
+  ClassTable* class_table = isolate()->class_table();
+  const intptr_t num_cids = class_table->NumCids();
+  int64_t* samples = zone->Alloc<int64_t>(num_cids);
+  int64_t* bytes = zone->Alloc<int64_t>(num_cids);
+  memset(samples, 0, num_cids * sizeof(int64_t));
+  memset(bytes, 0, num_cids * sizeof(int64_t));
+  {
+    NoSafepointScope no_safepoint;
+    for (intptr_t i = 0; i < 2; i++) {
+      WeakTable* table = (i == 0) ? new_weak_tables_[kHeapSamples]
+                                  : old_weak_tables_[kHeapSamples];
+      table->FinishRehash();
+      for (intptr_t j = 0; j < table->size(); j++) {
+        if (table->IsValidEntryAt(j)) {
+          const intptr_t cid = table->ObjectAt(j)->GetClassId();
+          samples[cid]++;
+          bytes[cid] += table->ValueAt(j);
+        }
+      }
+    }
+  }
+
+  JSONObject obj(stream);
+  obj.AddProperty("type", "HeapSampleProfile");
+  obj.AddProperty64("sampleInterval", FLAG_heap_sample_interval);
+  JSONArray members(&obj, "members");
+  Class& cls = Class::Handle(zone);
+  for (intptr_t cid = 1; cid < num_cids; cid++) {
+    if ((samples[cid] == 0) || !class_table->HasValidClassAt(cid)) {
+      continue;
+    }
+    cls = class_table->At(cid);
+    JSONObject member(&members);
+    member.AddProperty("class", cls);
+    member.AddProperty64("liveSamples", samples[cid]);
+    member.AddProperty64("liveBytes", bytes[cid]);
+  }
+}
+#endif  // !PRODUCT
+
 intptr_t Heap::GetWeakEntry(RawObject* raw_obj, WeakSelector sel) const {
   if (raw_obj->IsNewObject()) {
     return new_weak_tables_[sel]->GetValue(raw_obj);
@@ -907,6 +1033,17 @@ void Heap::RecordBeforeGC(GCType type, GCReason reason) {
 void Heap::RecordAfterGC(GCType type) {
   stats_.after_.micros_ = OS::GetCurrentMonotonicMicros();
   int64_t delta = stats_.after_.micros_ - stats_.before_.micros_;
+  switch (stats_.type_) {
+    case kScavenge:
+      RecordPause(kScavengePause, delta);
+      break;
+    case kMarkSweep:
+      RecordPause(kMarkSweepPause, delta);
+      break;
+    case kMarkCompact:
+      RecordPause(kMarkCompactPause, delta);
+      break;
+  }
   if (stats_.type_ == kScavenge) {
     new_space_.AddGCTime(delta);
     new_space_.IncrementCollections();
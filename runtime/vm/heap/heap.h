@@ -14,6 +14,7 @@
 #include "vm/flags.h"
 #include "vm/globals.h"
 #include "vm/heap/pages.h"
+#include "vm/heap/pause_histogram.h"
 #include "vm/heap/scavenger.h"
 #include "vm/heap/spaces.h"
 #include "vm/heap/weak_table.h"
@@ -43,6 +44,7 @@ class Heap {
     kHashes,
 #endif
     kObjectIds,
+    kHeapSamples,
     kNumWeakSelectors
   };
 
@@ -64,6 +66,16 @@ class Heap {
     kDebugging,  // service request, --gc_at_instance_allocation, etc.
   };
 
+  // Stop-the-world pauses tracked in per-isolate histograms.
+  enum PauseKind {
+    kScavengePause,
+    kMarkSweepPause,
+    kMarkCompactPause,
+    kSafepointPause,            // Time for all threads to reach a safepoint.
+    kMarkingFinalizationPause,  // Finishing a concurrent mark.
+    kNumPauseKinds
+  };
+
   // Pattern for unused new space and swept old space.
   static const uint8_t kZapByte = 0xf3;
 
@@ -91,7 +103,8 @@ class Heap {
     return 0;
   }
 
-  // Track external data.
+  // Track external data. Native memory the embedder reports without an owning
+  // object (Dart_ReportExternalAllocation) is tracked with kIllegalCid.
   void AllocateExternal(intptr_t cid, intptr_t size, Space space);
   void FreeExternal(intptr_t size, Space space);
   // Move external size from new to old space. Does not by itself trigger GC.
@@ -140,6 +153,7 @@ class Heap {
   }
 
   void CheckStartConcurrentMarking(Thread* thread, GCReason reason);
+  void StartConcurrentMarking(Thread* thread);
   void CheckFinishConcurrentMarking(Thread* thread);
   void WaitForMarkerTasks(Thread* thread);
   void WaitForSweeperTasks(Thread* thread);
@@ -229,6 +243,15 @@ class Heap {
   int64_t ObjectIdCount() const;
   void ResetObjectIdTable();
 
+#ifndef PRODUCT
+  // Remembers an object picked by allocation sampling, weighted by the number
+  // of allocated bytes it stands for, for as long as it stays alive.
+  void RecordHeapSample(RawObject* raw_obj, intptr_t size);
+  int64_t HeapSampleCount() const;
+  // Prints the estimated live bytes per class from the surviving samples.
+  void PrintHeapSampleProfileJSON(JSONStream* stream);
+#endif
+
   // Used by the GC algorithms to propagate weak entries.
   intptr_t GetWeakEntry(RawObject* raw_obj, WeakSelector sel) const;
   void SetWeakEntry(RawObject* raw_obj, WeakSelector sel, intptr_t val);
@@ -265,11 +288,24 @@ class Heap {
 
   void UpdateGlobalMaxUsed();
 
+  void RecordPause(PauseKind kind, int64_t micros) {
+#ifndef PRODUCT
+    ASSERT((kind >= 0) && (kind < kNumPauseKinds));
+    pause_histograms_[kind].Add(micros);
+#endif
+  }
+
   static bool IsAllocatableInNewSpace(intptr_t size) {
     return size <= kNewAllocatableSize;
   }
 
 #ifndef PRODUCT
+  const PauseHistogram& pause_histogram(PauseKind kind) const {
+    ASSERT((kind >= 0) && (kind < kNumPauseKinds));
+    return pause_histograms_[kind];
+  }
+  void PrintPauseHistogramsJSON(JSONStream* stream) const;
+
   void PrintToJSONObject(Space space, JSONObject* object) const;
 
   // Returns a JSON object with total memory usage statistics for both new and
@@ -394,6 +430,9 @@ class Heap {
 
   // GC stats collection.
   GCStats stats_;
+#ifndef PRODUCT
+  PauseHistogram pause_histograms_[kNumPauseKinds];
+#endif
 
   // This heap is in read-only mode: No allocation is allowed.
   bool read_only_;
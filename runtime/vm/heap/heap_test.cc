@@ -9,11 +9,14 @@
 #include "vm/globals.h"
 #include "vm/heap/become.h"
 #include "vm/heap/heap.h"
+#include "vm/heap/weak_table.h"
 #include "vm/symbols.h"
 #include "vm/unit_test.h"
 
 namespace dart {
 
+DECLARE_FLAG(int, heap_sample_interval);
+
 TEST_CASE(OldGC) {
   const char* kScriptChars =
       "main() {\n"
@@ -386,6 +389,44 @@ ISOLATE_UNIT_TEST_CASE(BecomeForwardRememberedObject) {
   EXPECT(before_obj.raw() == after_obj.raw());
 }
 
+ISOLATE_UNIT_TEST_CASE(BecomeForwardBatch) {
+  Heap* heap = thread->isolate()->heap();
+  const intptr_t kNumPairs = 100;
+
+  // Each holder is big enough that the holders are spread over several pages,
+  // which are shared out between the tasks forwarding the pointers.
+  const Array& holders = Array::Handle(Array::New(kNumPairs, Heap::kOld));
+  const Array& afters = Array::Handle(Array::New(kNumPairs, Heap::kOld));
+  Array& holder = Array::Handle();
+  String& before_obj = String::Handle();
+  String& after_obj = String::Handle();
+  Become become;
+  for (intptr_t i = 0; i < kNumPairs; i++) {
+    before_obj = String::New("old", (i % 2) == 0 ? Heap::kOld : Heap::kNew);
+    after_obj = String::New("new", Heap::kNew);
+    holder = Array::New(4 * KB, Heap::kOld);
+    holder.SetAt(0, before_obj);
+    holders.SetAt(i, holder);
+    afters.SetAt(i, after_obj);
+    become.Add(before_obj, after_obj);
+  }
+  become.Forward();
+
+  for (intptr_t i = 0; i < kNumPairs; i++) {
+    holder ^= holders.At(i);
+    EXPECT(holder.At(0) == afters.At(i));
+    // The holders now point to new space and must have been remembered.
+    EXPECT(holder.raw()->IsRemembered());
+  }
+
+  heap->CollectAllGarbage();
+
+  for (intptr_t i = 0; i < kNumPairs; i++) {
+    holder ^= holders.At(i);
+    EXPECT(holder.At(0) == afters.At(i));
+  }
+}
+
 ISOLATE_UNIT_TEST_CASE(CollectAllGarbage_DeadOldToNew) {
   Isolate* isolate = Isolate::Current();
   Heap* heap = isolate->heap();
@@ -662,6 +703,95 @@ ISOLATE_UNIT_TEST_CASE(CollectAllGarbage_LiveOldToNewChain) {
   EXPECT(size_before < size_after);
 }
 
+ISOLATE_UNIT_TEST_CASE(ParallelScavenge) {
+  SetFlagScope<int> sfs(&FLAG_scavenger_tasks, 4);
+  Heap* heap = thread->heap();
+
+  const intptr_t kLength = 10000;
+  const Array& old = Array::Handle(Array::New(kLength, Heap::kOld));
+  const Array& shared = Array::Handle(Array::New(1, Heap::kNew));
+  Array& neu = Array::Handle();
+  String& str = String::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    neu = Array::New(2, Heap::kNew);
+    str = String::NewFormatted(Heap::kNew, "%" Pd, i);
+    neu.SetAt(0, str);
+    neu.SetAt(1, shared);
+    old.SetAt(i, neu);
+  }
+
+  // The first scavenge copies the objects within new space, the following
+  // ones promote them.
+  for (intptr_t gc = 0; gc < 3; gc++) {
+    heap->CollectGarbage(Heap::kNew);
+    for (intptr_t i = 0; i < kLength; i++) {
+      neu ^= old.At(i);
+      EXPECT(neu.At(1) == shared.raw());
+      str ^= neu.At(0);
+      EXPECT(str.Equals(String::Handle(String::NewFormatted("%" Pd, i))));
+    }
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(CardRememberedLargeArray) {
+  Heap* heap = thread->heap();
+
+  const intptr_t kLength = 100000;
+  EXPECT(Array::UseCardMarkingForAllocation(kLength));
+  const Array& old = Array::Handle(Array::New(kLength, Heap::kOld));
+  EXPECT(old.raw()->IsCardRemembered());
+
+  const intptr_t kStride = 10007;
+  String& str = String::Handle();
+  for (intptr_t i = 0; i < kLength; i += kStride) {
+    str = String::NewFormatted(Heap::kNew, "%" Pd, i);
+    old.SetAt(i, str);
+  }
+  // Card-remembered arrays are never added to the store buffer.
+  EXPECT(!old.raw()->IsRemembered());
+  // The stores are further apart than a card, so each dirtied its own card.
+  HeapPage* page = HeapPage::Of(old.raw());
+  EXPECT_EQ((kLength + kStride - 1) / kStride, page->NumRememberedCards());
+
+  for (intptr_t gc = 0; gc < 3; gc++) {
+    heap->CollectGarbage(Heap::kNew);
+    EXPECT(!old.raw()->IsRemembered());
+    for (intptr_t i = 0; i < kLength; i++) {
+      if ((i % kStride) == 0) {
+        str ^= old.At(i);
+        EXPECT(str.Equals(String::Handle(String::NewFormatted("%" Pd, i))));
+      } else {
+        EXPECT(old.At(i) == Object::null());
+      }
+    }
+  }
+
+  // Without any new targets left, the next scavenge cleans all cards and
+  // releases the card table.
+  for (intptr_t i = 0; i < kLength; i += kStride) {
+    old.SetAt(i, Object::null_object());
+  }
+  heap->CollectGarbage(Heap::kNew);
+  EXPECT(!page->has_card_table());
+  EXPECT_EQ(0, page->NumRememberedCards());
+
+  // A later store of a new object dirties its card again.
+  const intptr_t kIndex = kLength - 1;
+  str = String::NewFormatted(Heap::kNew, "%" Pd, kIndex);
+  EXPECT(str.raw()->IsNewObject());
+  old.SetAt(kIndex, str);
+  EXPECT(page->has_card_table());
+  EXPECT_EQ(1, page->NumRememberedCards());
+  heap->CollectGarbage(Heap::kNew);
+  str ^= old.At(kIndex);
+  EXPECT(str.Equals(String::Handle(String::NewFormatted("%" Pd, kIndex))));
+  if (str.raw()->IsNewObject()) {
+    EXPECT_EQ(1, page->NumRememberedCards());
+  } else {
+    EXPECT(!page->has_card_table());
+  }
+}
+
 static void NoopFinalizer(void* isolate_callback_data,
                           Dart_WeakPersistentHandle handle,
                           void* peer) {}
@@ -785,4 +915,292 @@ ISOLATE_UNIT_TEST_CASE(ArrayTruncationRaces) {
   }
 }
 
+DECLARE_FLAG(int, compactor_max_pages);
+
+ISOLATE_UNIT_TEST_CASE(IncrementalCompaction) {
+  SetFlagScope<int> sfs(&FLAG_compactor_max_pages, 4);
+  Heap* heap = thread->heap();
+  heap->CollectAllGarbage();
+
+  // Fill pages with arrays and keep every tenth one alive.
+  const intptr_t kLength = 1000;
+  const Array& survivors = Array::Handle(Array::New(kLength, Heap::kOld));
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < 10 * kLength; i++) {
+    element = Array::New(100, Heap::kOld);
+    element.SetAt(0, Smi::Handle(Smi::New(i)));
+    if ((i % 10) == 0) {
+      survivors.SetAt(i / 10, element);
+    }
+  }
+  element = Array::null();
+
+  const intptr_t capacity_before = heap->old_space()->CapacityInWords();
+  heap->CollectGarbage(Heap::kMarkCompact, Heap::kDebugging);
+  EXPECT_LT(heap->old_space()->CapacityInWords(), capacity_before);
+
+  for (intptr_t i = 0; i < kLength; i++) {
+    element ^= survivors.At(i);
+    EXPECT_EQ(i * 10, Smi::Cast(Object::Handle(element.At(0))).Value());
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(CompactionPageBudget) {
+  Heap* heap = thread->heap();
+  PageSpace* old_space = heap->old_space();
+  heap->CollectAllGarbage();
+
+  // Fill pages with arrays and keep every tenth one alive.
+  const intptr_t kLength = 1000;
+  const Array& survivors = Array::Handle(Array::New(kLength, Heap::kOld));
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < 10 * kLength; i++) {
+    element = Array::New(100, Heap::kOld);
+    element.SetAt(0, Smi::Handle(Smi::New(i)));
+    if ((i % 10) == 0) {
+      survivors.SetAt(i / 10, element);
+    }
+  }
+  element = Array::null();
+
+  // An idle period that is already over leaves no time to compact.
+  EXPECT_EQ(0, old_space->IdleCompactionPageBudget(
+                   OS::GetCurrentMonotonicMicros() - 1000));
+
+  const intptr_t capacity_before = old_space->CapacityInWords();
+  old_space->set_compaction_page_budget(4);
+  heap->CollectGarbage(Heap::kMarkCompact, Heap::kIdle);
+  old_space->set_compaction_page_budget(0);
+  EXPECT_LT(old_space->CapacityInWords(), capacity_before);
+
+  for (intptr_t i = 0; i < kLength; i++) {
+    element ^= survivors.At(i);
+    EXPECT_EQ(i * 10, Smi::Cast(Object::Handle(element.At(0))).Value());
+  }
+}
+
+DECLARE_FLAG(bool, use_mark_bitmap);
+
+ISOLATE_UNIT_TEST_CASE(SweepWithMarkBitmap) {
+  SetFlagScope<bool> sfs(&FLAG_use_mark_bitmap, true);
+  Heap* heap = thread->heap();
+
+  const intptr_t kLength = 1000;
+  const Array& survivors = Array::Handle(Array::New(kLength, Heap::kOld));
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < 10 * kLength; i++) {
+    element = Array::New(10, Heap::kOld);
+    element.SetAt(0, Smi::Handle(Smi::New(i)));
+    if ((i % 10) == 0) {
+      survivors.SetAt(i / 10, element);
+    }
+  }
+  element = Array::null();
+
+  for (intptr_t j = 0; j < 3; j++) {
+    heap->CollectAllGarbage();
+    heap->WaitForSweeperTasks(thread);
+    // Reuse the freed space.
+    for (intptr_t i = 0; i < 10 * kLength; i++) {
+      element = Array::New(10, Heap::kOld);
+    }
+    element = Array::null();
+  }
+
+  for (intptr_t i = 0; i < kLength; i++) {
+    element ^= survivors.At(i);
+    EXPECT_EQ(i * 10, Smi::Cast(Object::Handle(element.At(0))).Value());
+  }
+}
+
+DECLARE_FLAG(bool, lazy_sweep);
+
+ISOLATE_UNIT_TEST_CASE(LazySweep) {
+  SetFlagScope<bool> sfs(&FLAG_lazy_sweep, true);
+  Heap* heap = thread->heap();
+  heap->WaitForSweeperTasks(thread);
+
+  const intptr_t kLength = 1000;
+  const Array& survivors = Array::Handle(Array::New(kLength, Heap::kOld));
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < 10 * kLength; i++) {
+    element = Array::New(10, Heap::kOld);
+    element.SetAt(0, Smi::Handle(Smi::New(i)));
+    if ((i % 10) == 0) {
+      survivors.SetAt(i / 10, element);
+    }
+  }
+  element = Array::null();
+
+  heap->CollectAllGarbage();
+  EXPECT(heap->old_space()->HasUnsweptPages());
+  const int64_t capacity = heap->CapacityInWords(Heap::kOld);
+  // The garbage of the unswept pages is reused instead of growing.
+  for (intptr_t i = 0; i < 5 * kLength; i++) {
+    element = Array::New(10, Heap::kOld);
+  }
+  element = Array::null();
+  EXPECT_LE(heap->CapacityInWords(Heap::kOld), capacity);
+
+  heap->WaitForSweeperTasks(thread);
+  EXPECT(!heap->old_space()->HasUnsweptPages());
+  for (intptr_t i = 0; i < kLength; i++) {
+    element ^= survivors.At(i);
+    EXPECT_EQ(i * 10, Smi::Cast(Object::Handle(element.At(0))).Value());
+  }
+}
+
+DECLARE_FLAG(int, pretenure_sample_interval);
+
+ISOLATE_UNIT_TEST_CASE(PretenureSurvivingClass) {
+  SetFlagScope<int> sfs(&FLAG_pretenure_sample_interval, 1);
+  Heap* heap = thread->heap();
+
+  // Allocate enough arrays that all survive to make their class a candidate.
+  const intptr_t kLength = 10000;
+  const Array& old = Array::Handle(Array::New(kLength, Heap::kOld));
+  Array& neu = Array::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    neu = Array::New(8, Heap::kNew);
+    old.SetAt(i, neu);
+  }
+  heap->CollectGarbage(Heap::kNew);
+
+  // Arrays are now promoted at their first scavenge.
+  neu = Array::New(8, Heap::kNew);
+  EXPECT(neu.IsNew());
+  heap->CollectGarbage(Heap::kNew);
+  EXPECT(neu.IsOld());
+}
+
+static RawObject* WeakTableKey(intptr_t i) {
+  // The table only hashes and compares the keys.
+  return reinterpret_cast<RawObject*>(((i + 1) << kObjectAlignmentLog2) +
+                                      kHeapObjectTag);
+}
+
+VM_UNIT_TEST_CASE(WeakTableIncrementalRehash) {
+  WeakTable* table = new WeakTable();
+  const intptr_t kNumEntries = 10000;
+  for (intptr_t i = 0; i < kNumEntries; i++) {
+    table->SetValue(WeakTableKey(i), i + 1);
+  }
+  // Some entries may still be waiting in the previous backing store.
+  for (intptr_t i = 0; i < kNumEntries; i++) {
+    EXPECT_EQ(i + 1, table->GetValue(WeakTableKey(i)));
+  }
+  for (intptr_t i = 0; i < kNumEntries; i += 2) {
+    EXPECT_EQ(i + 1, table->RemoveValue(WeakTableKey(i)));
+  }
+  for (intptr_t i = 1; i < kNumEntries; i += 2) {
+    table->SetValue(WeakTableKey(i), i + 2);
+  }
+  EXPECT_EQ(kNumEntries / 2, table->count());
+
+  table->FinishRehash();
+  EXPECT_EQ(kNumEntries / 2, table->count());
+  for (intptr_t i = 0; i < kNumEntries; i++) {
+    EXPECT_EQ((i % 2) == 0 ? 0 : i + 2, table->GetValue(WeakTableKey(i)));
+  }
+  delete table;
+}
+
+#ifndef PRODUCT
+ISOLATE_UNIT_TEST_CASE(HeapSamplesTrackLiveObjects) {
+  Heap* heap = thread->heap();
+  const int saved_interval = FLAG_heap_sample_interval;
+  // Every old-space allocation crosses a sampling point.
+  FLAG_heap_sample_interval = 1;
+
+  heap->CollectAllGarbage();
+  const int64_t samples_before = heap->HeapSampleCount();
+  const intptr_t kNumDead = 100;
+  const Array& live = Array::Handle(Array::New(1, Heap::kOld));
+  {
+    HANDLESCOPE(thread);
+    for (intptr_t i = 0; i < kNumDead; i++) {
+      Array::New(1, Heap::kOld);
+    }
+  }
+  EXPECT(heap->HeapSampleCount() >= samples_before + kNumDead + 1);
+
+  FLAG_heap_sample_interval = saved_interval;
+  heap->CollectAllGarbage();
+  heap->WaitForMarkerTasks(thread);
+  EXPECT(heap->HeapSampleCount() < samples_before + kNumDead);
+  EXPECT(!live.IsNull());
+}
+#endif  // !PRODUCT
+
+VM_UNIT_TEST_CASE(PauseHistogramPercentiles) {
+  PauseHistogram histogram;
+  EXPECT_EQ(0, histogram.Percentile(99));
+  for (intptr_t i = 0; i < 15; i++) {
+    EXPECT_EQ(i,
+              PauseHistogram::BucketLowerBound(PauseHistogram::BucketFor(i)));
+  }
+  for (int64_t micros = 16; micros < 1000000; micros = micros * 3 + 1) {
+    const int64_t lower =
+        PauseHistogram::BucketLowerBound(PauseHistogram::BucketFor(micros));
+    EXPECT_LE(lower, micros);
+    EXPECT_LE(micros - lower, lower / 16);
+  }
+
+  // 98 short pauses and two long ones.
+  for (intptr_t i = 0; i < 98; i++) {
+    histogram.Add(100);
+  }
+  histogram.Add(50000);
+  histogram.Add(90000);
+  EXPECT_EQ(100, histogram.count());
+  EXPECT_EQ(90000, histogram.max_micros());
+  EXPECT_EQ(98 * 100 + 50000 + 90000, histogram.total_micros());
+  EXPECT_LE(100, histogram.Percentile(50));
+  EXPECT_LE(histogram.Percentile(50), 100 + 100 / 16);
+  EXPECT_LE(50000, histogram.Percentile(99));
+  EXPECT_LE(histogram.Percentile(99), 50000 + 50000 / 16);
+  EXPECT_EQ(90000, histogram.Percentile(100));
+}
+
+TEST_CASE(ReportExternalAllocation) {
+  Heap* heap = thread->heap();
+  const int64_t external_before = heap->old_space()->ExternalInWords();
+  const intptr_t collections_before = heap->old_space()->collections();
+
+  // Native memory retained beyond the external budget triggers an old space
+  // collection, however little of the heap is used.
+  const intptr_t kSize = 256 * MB;
+  Dart_ReportExternalAllocation(kSize);
+  EXPECT_EQ(external_before + kSize / kWordSize,
+            heap->old_space()->ExternalInWords());
+  EXPECT_LT(collections_before, heap->old_space()->collections());
+
+  // The budget grows with what survived, so retaining the memory does not
+  // collect again on the next small allocation.
+  const intptr_t collections_after = heap->old_space()->collections();
+  Dart_ReportExternalAllocation(KB);
+  EXPECT_EQ(collections_after, heap->old_space()->collections());
+
+  Dart_ReportExternalFree(kSize + KB);
+  EXPECT_EQ(external_before, heap->old_space()->ExternalInWords());
+}
+
+#ifndef PRODUCT
+ISOLATE_UNIT_TEST_CASE(GCPauseHistogramsRecordCollections) {
+  Heap* heap = thread->heap();
+  const int64_t scavenges = heap->pause_histogram(Heap::kScavengePause).count();
+  const int64_t safepoints =
+      heap->pause_histogram(Heap::kSafepointPause).count();
+  heap->CollectGarbage(Heap::kNew);
+  EXPECT_EQ(scavenges + 1, heap->pause_histogram(Heap::kScavengePause).count());
+  EXPECT_LT(safepoints, heap->pause_histogram(Heap::kSafepointPause).count());
+
+  const int64_t full = heap->pause_histogram(Heap::kMarkSweepPause).count() +
+                       heap->pause_histogram(Heap::kMarkCompactPause).count();
+  heap->CollectAllGarbage();
+  EXPECT_LT(full, heap->pause_histogram(Heap::kMarkSweepPause).count() +
+                      heap->pause_histogram(Heap::kMarkCompactPause).count());
+}
+#endif  // !PRODUCT
+
 }  // namespace dart
@@ -12,6 +12,7 @@
 #include "vm/log.h"
 #include "vm/object_id_ring.h"
 #include "vm/raw_object.h"
+#include "vm/reverse_pc_lookup_cache.h"
 #include "vm/stack_frame.h"
 #include "vm/thread_barrier.h"
 #include "vm/thread_pool.h"
@@ -21,10 +22,12 @@
 
 namespace dart {
 
+DECLARE_FLAG(bool, use_mark_bitmap);
+
 class MarkerWorkList : public ValueObject {
  public:
   explicit MarkerWorkList(MarkingStack* marking_stack)
-      : marking_stack_(marking_stack) {
+      : marking_stack_(marking_stack), pops_until_share_check_(0) {
     work_ = marking_stack_->PopEmptyBlock();
   }
 
@@ -47,6 +50,8 @@ class MarkerWorkList : public ValueObject {
       work_ = new_work;
       // Generated code appends to marking stacks; tell MemorySanitizer.
       MSAN_UNPOISON(work_, sizeof(*work_));
+    } else if (UNLIKELY(marking_stack_->HasWaiters())) {
+      MaybeShare();
     }
     return work_->Pop();
   }
@@ -76,10 +81,40 @@ class MarkerWorkList : public ValueObject {
   }
 
  private:
+  // How often a marker with waiting peers checks whether to share its work.
+  static const intptr_t kShareCheckInterval = 16;
+
+  // Markers only exchange whole blocks, so a marker working through a narrow
+  // part of the graph can keep a block that never fills up, while the other
+  // markers have nothing to do. Hand half of it over when they are waiting
+  // and the shared stack is empty.
+  void MaybeShare() {
+    if (--pops_until_share_check_ > 0) {
+      return;
+    }
+    pops_until_share_check_ = kShareCheckInterval;
+    if ((work_->Count() < 2) || !marking_stack_->IsEmpty()) {
+      return;
+    }
+    MarkingStack::Block* shared = marking_stack_->PopEmptyBlock();
+    for (intptr_t i = work_->Count() / 2; i > 0; i--) {
+      shared->Push(work_->Pop());
+    }
+    marking_stack_->PushBlock(shared);
+  }
+
   MarkingStack::Block* work_;
   MarkingStack* marking_stack_;
+  intptr_t pops_until_share_check_;
 };
 
+// Prefetches the start of an object that is about to be scanned.
+static DART_FORCE_INLINE void PrefetchObject(RawObject* raw_obj) {
+#if defined(__GNUC__)
+  __builtin_prefetch(reinterpret_cast<void*>(RawObject::ToAddr(raw_obj)));
+#endif
+}
+
 template <bool sync>
 class MarkingVisitorBase : public ObjectPointerVisitor {
  public:
@@ -97,6 +132,8 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
         page_space_(page_space),
         work_list_(marking_stack),
         deferred_work_list_(deferred_marking_stack),
+        prefetch_head_(0),
+        prefetch_count_(0),
         delayed_weak_properties_(NULL),
         marked_bytes_(0),
         marked_micros_(0) {
@@ -155,9 +192,9 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   }
 
   void DrainMarkingStack() {
-    RawObject* raw_obj = work_list_.Pop();
+    RawObject* raw_obj = PopPrefetched();
     if ((raw_obj == NULL) && ProcessPendingWeakProperties()) {
-      raw_obj = work_list_.Pop();
+      raw_obj = PopPrefetched();
     }
 
     if (raw_obj == NULL) {
@@ -168,6 +205,11 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
       do {
         // First drain the marking stacks.
         const intptr_t class_id = raw_obj->GetClassId();
+        if (FLAG_use_mark_bitmap) {
+          // Every marked object passes through the marking stacks except for
+          // black allocations, which PageSpace::AllocateBlack records.
+          RecordLive(raw_obj);
+        }
 
         intptr_t size;
         if (class_id != kWeakPropertyCid) {
@@ -179,7 +221,7 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
         marked_bytes_ += size;
         NOT_IN_PRODUCT(UpdateLiveOld(class_id, size));
 
-        raw_obj = work_list_.Pop();
+        raw_obj = PopPrefetched();
       } while (raw_obj != NULL);
 
       // Marking stack is empty.
@@ -187,8 +229,9 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 
       // Check whether any further work was pushed either by other markers or
       // by the handling of weak properties.
-      raw_obj = work_list_.Pop();
+      raw_obj = PopPrefetched();
     } while (raw_obj != NULL);
+    ASSERT(prefetch_count_ == 0);
   }
 
   void VisitPointers(RawObject** first, RawObject** last) {
@@ -238,6 +281,9 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
       if (TryAcquireMarkBit(raw_obj)) {
         marked_bytes_ += size;
         NOT_IN_PRODUCT(UpdateLiveOld(class_id, size));
+        if (FLAG_use_mark_bitmap) {
+          RecordLive(raw_obj);
+        }
       }
     }
   }
@@ -271,6 +317,34 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   }
 
  private:
+  // Objects taken from the work list wait in a small FIFO before they are
+  // scanned, with a prefetch issued as they enter it, so that the cache
+  // misses on an object overlap with the scanning of the objects before it.
+  static const intptr_t kPrefetchDepth = 8;
+
+  // Returns NULL if no more work was found, once all prefetched objects
+  // have been returned.
+  DART_FORCE_INLINE
+  RawObject* PopPrefetched() {
+    while (prefetch_count_ < kPrefetchDepth) {
+      RawObject* raw_obj = work_list_.Pop();
+      if (raw_obj == NULL) {
+        break;
+      }
+      PrefetchObject(raw_obj);
+      prefetch_buffer_[(prefetch_head_ + prefetch_count_) % kPrefetchDepth] =
+          raw_obj;
+      prefetch_count_++;
+    }
+    if (prefetch_count_ == 0) {
+      return NULL;
+    }
+    RawObject* raw_obj = prefetch_buffer_[prefetch_head_];
+    prefetch_head_ = (prefetch_head_ + 1) % kPrefetchDepth;
+    prefetch_count_--;
+    return raw_obj;
+  }
+
   void PushMarked(RawObject* raw_obj) {
     ASSERT(raw_obj->IsHeapObject());
     ASSERT(raw_obj->IsOldObject());
@@ -280,6 +354,13 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
     work_list_.Push(raw_obj);
   }
 
+  static void RecordLive(RawObject* raw_obj) {
+    HeapPage* page = HeapPage::Of(raw_obj);
+    if (page->mark_bitmap() != NULL) {
+      page->RecordLive(raw_obj);
+    }
+  }
+
   static bool TryAcquireMarkBit(RawObject* raw_obj) {
     if (FLAG_write_protect_code && raw_obj->IsInstructions()) {
       // A non-writable alias mapping may exist for instruction pages.
@@ -346,6 +427,9 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   PageSpace* page_space_;
   MarkerWorkList work_list_;
   MarkerWorkList deferred_work_list_;
+  RawObject* prefetch_buffer_[kPrefetchDepth];
+  intptr_t prefetch_head_;
+  intptr_t prefetch_count_;
   RawWeakProperty* delayed_weak_properties_;
   uintptr_t marked_bytes_;
   int64_t marked_micros_;
@@ -494,20 +578,21 @@ void GCMarker::IterateWeakRoots(HandleVisitor* visitor) {
   isolate_->VisitWeakPersistentHandles(visitor);
 }
 
-void GCMarker::ProcessWeakTables(PageSpace* page_space) {
+void GCMarker::PrepareWeakTables() {
+  weak_table_chunks_.Reset();
   for (int sel = 0; sel < Heap::kNumWeakSelectors; sel++) {
-    WeakTable* table =
-        heap_->GetWeakTable(Heap::kOld, static_cast<Heap::WeakSelector>(sel));
-    intptr_t size = table->size();
-    for (intptr_t i = 0; i < size; i++) {
-      if (table->IsValidEntryAt(i)) {
-        RawObject* raw_obj = table->ObjectAt(i);
-        ASSERT(raw_obj->IsHeapObject());
-        if (!raw_obj->IsMarked()) {
-          table->InvalidateAt(i);
-        }
-      }
-    }
+    weak_table_chunks_.AddTable(
+        heap_->GetWeakTable(Heap::kOld, static_cast<Heap::WeakSelector>(sel)));
+  }
+}
+
+void GCMarker::ProcessWeakTables() {
+  TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "ProcessWeakTables");
+  WeakTable* table;
+  intptr_t start;
+  intptr_t end;
+  while (weak_table_chunks_.ClaimChunk(&table, &start, &end)) {
+    table->InvalidateUnmarked(start, end);
   }
 }
 
@@ -528,6 +613,16 @@ class ObjectIdRingClearPointerVisitor : public ObjectPointerVisitor {
   }
 };
 
+void GCMarker::ProcessJitPcLookupTable() {
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  // The index does not keep code alive.
+  ObjectIdRingClearPointerVisitor visitor(isolate_);
+  JitReversePcLookupTable* table = isolate_->jit_pc_lookup_table();
+  table->VisitPointers(&visitor);
+  table->RemoveCleared();
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+}
+
 void GCMarker::ProcessObjectIdTable() {
 #ifndef PRODUCT
   if (!FLAG_support_service) {
@@ -577,12 +672,15 @@ class ParallelMarkTask : public ThreadPool::Task {
           // then there will never be more work (NB: 1 is *before* decrement).
           if (AtomicOperations::FetchAndDecrement(num_busy_) == 1) break;
 
-          // Wait for some work to appear.
+          // Wait for some work to appear, and let busy markers know to share
+          // theirs.
           // TODO(iposva): Replace busy-waiting with a solution using Monitor,
           // and redraw the boundaries between stack/visitor/task as needed.
+          marking_stack_->AddWaiter();
           while (marking_stack_->IsEmpty() &&
                  AtomicOperations::LoadRelaxed(num_busy_) > 0) {
           }
+          marking_stack_->RemoveWaiter();
 
           // If no tasks are busy, there will never be more work.
           if (AtomicOperations::LoadRelaxed(num_busy_) == 0) break;
@@ -626,6 +724,9 @@ class ParallelMarkTask : public ThreadPool::Task {
       // Phase 2: Weak processing and follow-up marking on main thread.
       barrier_->Sync();
 
+      // Marking is complete. Help the main thread clear the weak tables.
+      marker_->ProcessWeakTables();
+
       // Phase 3: Finalize results from all markers (detach code, etc.).
       int64_t stop = OS::GetCurrentMonotonicMicros();
       visitor_->AddMicros(stop - start);
@@ -643,6 +744,10 @@ class ParallelMarkTask : public ThreadPool::Task {
     barrier_->Exit();
   }
 
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kHighPriority;
+  }
+
  private:
   GCMarker* marker_;
   Isolate* isolate_;
@@ -706,6 +811,10 @@ class ConcurrentMarkTask : public ThreadPool::Task {
     }
   }
 
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kHighPriority;
+  }
+
  private:
   GCMarker* marker_;
   Isolate* isolate_;
@@ -822,6 +931,7 @@ void GCMarker::MarkObjects(PageSpace* page_space) {
   }
 
   Prologue();
+  PrepareWeakTables();
   {
     Thread* thread = Thread::Current();
     const int num_tasks = FLAG_marker_tasks;
@@ -841,6 +951,7 @@ void GCMarker::MarkObjects(PageSpace* page_space) {
         MarkingWeakVisitor mark_weak(thread);
         IterateWeakRoots(&mark_weak);
       }
+      ProcessWeakTables();
       // All marking done; detach code, etc.
       int64_t stop = OS::GetCurrentMonotonicMicros();
       mark.AddMicros(stop - start);
@@ -894,12 +1005,13 @@ void GCMarker::MarkObjects(PageSpace* page_space) {
         IterateWeakRoots(&mark_weak);
       }
       barrier.Sync();
+      ProcessWeakTables();
 
       // Phase 3: Finalize results from all markers (detach code, etc.).
       barrier.Exit();
     }
-    ProcessWeakTables(page_space);
     ProcessObjectIdTable();
+    ProcessJitPcLookupTable();
   }
   Epilogue();
 }
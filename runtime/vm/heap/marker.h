@@ -7,6 +7,7 @@
 
 #include "vm/allocation.h"
 #include "vm/heap/pointer_block.h"
+#include "vm/heap/weak_table.h"
 #include "vm/os_thread.h"  // Mutex.
 
 namespace dart {
@@ -52,8 +53,11 @@ class GCMarker {
   void IterateWeakRoots(HandleVisitor* visitor);
   template <class MarkingVisitorType>
   void IterateWeakReferences(MarkingVisitorType* visitor);
-  void ProcessWeakTables(PageSpace* page_space);
+  void PrepareWeakTables();
+  // Called by the main thread and the marker tasks once marking is complete.
+  void ProcessWeakTables();
   void ProcessObjectIdTable();
+  void ProcessJitPcLookupTable();
 
   // Called by anyone: finalize and accumulate stats from 'visitor'.
   template <class MarkingVisitorType>
@@ -69,6 +73,8 @@ class GCMarker {
   intptr_t root_slices_not_started_;
   intptr_t root_slices_not_finished_;
 
+  WeakTableChunks weak_table_chunks_;
+
   Mutex stats_mutex_;
   uintptr_t marked_bytes_;
   int64_t marked_micros_;
@@ -32,6 +32,35 @@ DEFINE_FLAG(int,
             old_gen_growth_rate,
             280,
             "The max number of pages the old generation can grow at a time");
+DEFINE_FLAG(int,
+            old_gen_target_pause,
+            0,
+            "If non-zero, the desired maximum old gen GC pause in "
+            "milliseconds. Concurrent marking starts earlier and compaction "
+            "is avoided while pauses exceed it.");
+DEFINE_FLAG(int,
+            old_gen_target_heap_size,
+            0,
+            "If non-zero, the old gen capacity in MB the growth policy aims to "
+            "stay below by collecting and compacting more often. Unlike "
+            "--old_gen_heap_size, exceeding it is not an error.");
+DEFINE_FLAG(int,
+            old_gen_external_growth_ratio,
+            100,
+            "The percentage by which the external memory retained after an "
+            "old gen GC may grow before the next GC. Doubled while GCs free "
+            "little of the external memory allocated between them.");
+DEFINE_FLAG(int,
+            old_gen_external_min_growth,
+            32,
+            "The minimum growth in MB of the external memory of old gen "
+            "between GCs.");
+DEFINE_FLAG(int,
+            free_memory_release_delay,
+            1000,
+            "Milliseconds after an old gen GC after which Dart_NotifyIdle "
+            "gives the memory of large free blocks back to the OS. Negative "
+            "values disable the release.");
 DEFINE_FLAG(bool,
             print_free_list_before_gc,
             false,
@@ -41,6 +70,17 @@ DEFINE_FLAG(bool,
             false,
             "Print free list statistics after a GC");
 DEFINE_FLAG(bool, log_growth, false, "Log PageSpace growth policy decisions.");
+DEFINE_FLAG(bool,
+            use_mark_bitmap,
+            false,
+            "Record live objects of data pages in side mark bitmaps, which "
+            "lets the sweeper skip dead objects and empty pages.");
+DEFINE_FLAG(bool,
+            lazy_sweep,
+            false,
+            "Sweep the data pages of old space when allocation needs free "
+            "space, in the order they were allocated, instead of all at once "
+            "after each GC.");
 
 HeapPage* HeapPage::Allocate(intptr_t size_in_words,
                              PageType type,
@@ -51,8 +91,19 @@ HeapPage* HeapPage::Allocate(intptr_t size_in_words,
   bool executable = type == kExecutable;
 #endif
 
-  VirtualMemory* memory = VirtualMemory::AllocateAligned(
-      size_in_words << kWordSizeLog2, kPageSize, executable, name);
+  const intptr_t size = size_in_words << kWordSizeLog2;
+  VirtualMemory* memory = NULL;
+#if defined(DART_HEAP_CAGE)
+  // All heap pages must be in the heap cage.
+  memory = VirtualMemory::AllocateInHeapCage(size, executable, name);
+#else
+  if (size == kPageSize) {
+    memory = VirtualMemory::AllocateInHugePageChunk(size, executable, name);
+  }
+  if (memory == NULL) {
+    memory = VirtualMemory::AllocateAligned(size, kPageSize, executable, name);
+  }
+#endif  // defined(DART_HEAP_CAGE)
   if (memory == NULL) {
     return NULL;
   }
@@ -65,12 +116,45 @@ HeapPage* HeapPage::Allocate(intptr_t size_in_words,
   result->forwarding_page_ = NULL;
   result->card_table_ = NULL;
   result->type_ = type;
+  result->mark_bitmap_ = NULL;
 
   LSAN_REGISTER_ROOT_REGION(result, sizeof(*result));
 
   return result;
 }
 
+void HeapPage::AllocateMarkBitmap() {
+  ASSERT(mark_bitmap_ == NULL);
+  mark_bitmap_ =
+      reinterpret_cast<uint32_t*>(calloc(kMarkBitmapLength, sizeof(uint32_t)));
+}
+
+void HeapPage::ClearMarkBitmap() {
+  ASSERT(mark_bitmap_ != NULL);
+  memset(mark_bitmap_, 0, kMarkBitmapLength * sizeof(uint32_t));
+}
+
+uword HeapPage::NextLive(uword addr, uword end) const {
+  ASSERT(mark_bitmap_ != NULL);
+  const uword base = reinterpret_cast<uword>(this);
+  const intptr_t unit = (addr - base) >> kObjectAlignmentLog2;
+  intptr_t index = unit / kBitsPerInt32;
+  // Ignore the bits of the objects before [addr].
+  uint32_t bits = mark_bitmap_[index] & (~0u << (unit % kBitsPerInt32));
+  while (bits == 0) {
+    index++;
+    if (index == kMarkBitmapLength) {
+      return end;
+    }
+    bits = mark_bitmap_[index];
+  }
+  const intptr_t live_unit =
+      index * kBitsPerInt32 + Utils::CountTrailingZeros(bits);
+  const uword live =
+      base + (live_unit << kObjectAlignmentLog2) + kOldObjectAlignmentOffset;
+  return Utils::Minimum(live, end);
+}
+
 void HeapPage::Deallocate() {
   ASSERT(forwarding_page_ == NULL);
 
@@ -78,6 +162,10 @@ void HeapPage::Deallocate() {
     free(card_table_);
     card_table_ = NULL;
   }
+  if (mark_bitmap_ != NULL) {
+    free(mark_bitmap_);
+    mark_bitmap_ = NULL;
+  }
 
   bool image_page = is_image_page();
 
@@ -123,14 +211,15 @@ void HeapPage::VisitObjectPointers(ObjectPointerVisitor* visitor) const {
 }
 
 void HeapPage::VisitRememberedCards(ObjectPointerVisitor* visitor) {
-  ASSERT(Thread::Current()->IsAtSafepoint());
+  ASSERT(Thread::Current()->IsAtSafepoint() ||
+         (Thread::Current()->task_kind() == Thread::kScavengerTask));
   NoSafepointScope no_safepoint;
 
   if (card_table_ == NULL) {
     return;
   }
 
-  bool table_is_empty = false;
+  bool table_is_empty = true;
 
   RawArray* obj = static_cast<RawArray*>(RawObject::FromAddr(object_start()));
   ASSERT(obj->IsArray());
@@ -234,6 +323,9 @@ PageSpace::PageSpace(Heap* heap, intptr_t max_capacity_in_words)
       image_pages_(NULL),
       bump_top_(0),
       bump_end_(0),
+      lazy_sweep_prev_(NULL),
+      lazy_sweep_next_(NULL),
+      lazy_sweep_last_(NULL),
       max_capacity_in_words_(max_capacity_in_words),
       usage_(),
       allocated_black_in_words_(0),
@@ -247,11 +339,17 @@ PageSpace::PageSpace(Heap* heap, intptr_t max_capacity_in_words)
       page_space_controller_(heap,
                              FLAG_old_gen_growth_space_ratio,
                              FLAG_old_gen_growth_rate,
-                             FLAG_old_gen_growth_time_ratio),
+                             FLAG_old_gen_growth_time_ratio,
+                             FLAG_old_gen_target_pause,
+                             FLAG_old_gen_target_heap_size),
       marker_(NULL),
       gc_time_micros_(0),
       collections_(0),
       mark_words_per_micro_(kConservativeInitialMarkSpeed),
+      finalize_mark_micros_(0),
+      compaction_page_budget_(0),
+      last_gc_end_micros_(0),
+      free_memory_released_(true),
       enable_concurrent_mark_(FLAG_concurrent_mark) {
   // We aren't holding the lock but no one can reference us yet.
   UpdateMaxCapacityLocked();
@@ -297,6 +395,9 @@ HeapPage* PageSpace::AllocatePage(HeapPage::PageType type, bool link) {
     IncreaseCapacityInWords(-kPageSizeInWords);
     return NULL;
   }
+  if (FLAG_use_mark_bitmap && !is_exec) {
+    page->AllocateMarkBitmap();
+  }
 
   MutexLocker ml(&pages_lock_);
   if (link) {
@@ -484,6 +585,17 @@ uword PageSpace::TryAllocateInternal(intptr_t size,
     } else {
       result = freelist_[type].TryAllocate(size, is_protected);
     }
+    if (type == HeapPage::kData) {
+      // Reclaim the free space of pages left unswept by the last GC before
+      // growing.
+      while ((result == 0) && SweepNextPage(is_locked)) {
+        if (is_locked) {
+          result = freelist_[type].TryAllocateLocked(size, is_protected);
+        } else {
+          result = freelist_[type].TryAllocate(size, is_protected);
+        }
+      }
+    }
     if (result == 0) {
       result = TryAllocateInFreshPage(size, type, growth_policy, is_locked);
       // usage_ is updated by the call above.
@@ -533,8 +645,11 @@ bool PageSpace::CurrentThreadOwnsDataLock() {
 void PageSpace::AllocateExternal(intptr_t cid, intptr_t size) {
   intptr_t size_in_words = size >> kWordSizeLog2;
   AtomicOperations::IncrementBy(&(usage_.external_in_words), size_in_words);
-  NOT_IN_PRODUCT(
-      heap_->isolate()->class_table()->UpdateAllocatedExternalOld(cid, size));
+#if !defined(PRODUCT)
+  if (cid != kIllegalCid) {
+    heap_->isolate()->class_table()->UpdateAllocatedExternalOld(cid, size);
+  }
+#endif
 }
 
 void PageSpace::PromoteExternal(intptr_t cid, intptr_t size) {
@@ -764,6 +879,12 @@ void PageSpace::VisitObjectsImagePages(ObjectVisitor* visitor) const {
   }
 }
 
+void PageSpace::AddPagesTo(GrowableArray<HeapPage*>* pages) const {
+  for (ExclusivePageIterator it(this); !it.Done(); it.Advance()) {
+    pages->Add(it.page());
+  }
+}
+
 void PageSpace::VisitObjectPointers(ObjectPointerVisitor* visitor) const {
   for (ExclusivePageIterator it(this); !it.Done(); it.Advance()) {
     it.page()->VisitObjectPointers(visitor);
@@ -955,15 +1076,7 @@ bool PageSpace::ShouldPerformIdleMarkCompact(int64_t deadline) {
   // middle of deciding whether to perform an idle GC.
   NoSafepointScope no_safepoint;
 
-  // Discount two pages to account for the newest data and code pages, whose
-  // partial use doesn't indicate fragmentation.
-  const intptr_t excess_in_words =
-      usage_.capacity_in_words - usage_.used_in_words - 2 * kPageSizeInWords;
-  const double excess_ratio = static_cast<double>(excess_in_words) /
-                              static_cast<double>(usage_.capacity_in_words);
-  const bool fragmented = excess_ratio > 0.05;
-
-  if (!fragmented &&
+  if (!IsFragmented() &&
       !page_space_controller_.NeedsIdleGarbageCollection(usage_)) {
     return false;
   }
@@ -990,6 +1103,106 @@ bool PageSpace::ShouldPerformIdleMarkCompact(int64_t deadline) {
   return estimated_mark_compact_completion <= deadline;
 }
 
+bool PageSpace::ShouldPerformIdleFinalizeMarking(int64_t deadline) {
+  NoSafepointScope no_safepoint;
+
+  {
+    MonitorLocker locker(tasks_lock());
+    if (phase() != kAwaitingFinalization) {
+      return false;
+    }
+  }
+
+  return OS::GetCurrentMonotonicMicros() + EstimatedFinalizeMarkMicros() <=
+         deadline;
+}
+
+bool PageSpace::ShouldStartIdleConcurrentMark() {
+  NoSafepointScope no_safepoint;
+
+  if (!page_space_controller_.NeedsIdleGarbageCollection(usage_)) {
+    return false;
+  }
+
+  MonitorLocker locker(tasks_lock());
+  return (phase() == kDone) && (tasks() == 0);
+}
+
+intptr_t PageSpace::IdleCompactionPageBudget(int64_t deadline) {
+  NoSafepointScope no_safepoint;
+
+  if (!IsFragmented()) {
+    return 0;
+  }
+
+  int64_t mark_micros;
+  {
+    MonitorLocker locker(tasks_lock());
+    mark_micros = phase() == kAwaitingFinalization
+                      ? EstimatedFinalizeMarkMicros()
+                      : UsedInWords() / mark_words_per_micro_;
+  }
+
+  // Assuming compaction moves words as fast as marking visits them.
+  const int64_t remaining_micros =
+      deadline - OS::GetCurrentMonotonicMicros() - mark_micros;
+  if (remaining_micros <= 0) {
+    return 0;
+  }
+  const int64_t pages =
+      remaining_micros * mark_words_per_micro_ / kPageSizeInWords;
+  // Moving a single page at most closes its gaps, which sweeping achieves
+  // without moving objects.
+  if (pages < 2) {
+    return 0;
+  }
+  return static_cast<intptr_t>(Utils::Minimum<int64_t>(pages, kMaxInt32));
+}
+
+bool PageSpace::ShouldReleaseFreeMemory() {
+  if ((FLAG_free_memory_release_delay < 0) || free_memory_released_) {
+    return false;
+  }
+  {
+    MonitorLocker locker(tasks_lock());
+    if (phase() != kDone) {
+      return false;  // The free lists are still being rebuilt.
+    }
+  }
+  return OS::GetCurrentMonotonicMicros() >=
+         last_gc_end_micros_ +
+             FLAG_free_memory_release_delay * kMicrosecondsPerMillisecond;
+}
+
+void PageSpace::ReleaseFreeMemory() {
+  free_memory_released_ = true;
+  intptr_t released = freelist_[HeapPage::kData].ReleaseFreeMemory();
+  released += freelist_[HeapPage::kExecutable].ReleaseFreeMemory();
+  if (FLAG_log_growth) {
+    THR_Print("%s: released=%" Pd "kB of free memory\n",
+              heap_->isolate()->name(), released / KB);
+  }
+}
+
+bool PageSpace::IsFragmented() const {
+  // Discount two pages to account for the newest data and code pages, whose
+  // partial use doesn't indicate fragmentation.
+  const intptr_t excess_in_words =
+      usage_.capacity_in_words - usage_.used_in_words - 2 * kPageSizeInWords;
+  const double excess_ratio = static_cast<double>(excess_in_words) /
+                              static_cast<double>(usage_.capacity_in_words);
+  return excess_ratio > 0.05;
+}
+
+int64_t PageSpace::EstimatedFinalizeMarkMicros() const {
+  if (finalize_mark_micros_ > 0) {
+    return finalize_mark_micros_;
+  }
+  // No concurrent mark has been finalized yet, so assume the final pause has
+  // to mark everything.
+  return UsedInWords() / mark_words_per_micro_;
+}
+
 void PageSpace::CollectGarbage(bool compact, bool finalize) {
   if (!finalize) {
 #if defined(TARGET_ARCH_IA32)
@@ -1020,6 +1233,11 @@ void PageSpace::CollectGarbage(bool compact, bool finalize) {
     set_tasks(1);
   }
 
+  // Marking needs the mark bits left by the last GC to be cleared. Sweep the
+  // rest of the heap before stopping the other threads, so the pause does not
+  // include it.
+  FinishLazySweep();
+
   const int64_t pre_safe_point = OS::GetCurrentMonotonicMicros();
 
   // Ensure that all threads for this isolate are at a safepoint (either
@@ -1055,6 +1273,7 @@ void PageSpace::CollectGarbageAtSafepoint(bool compact,
   isolate->class_table()->FreeOldTables();
 
   NoSafepointScope no_safepoints;
+  ASSERT(!HasUnsweptPages());
 
   if (FLAG_print_free_list_before_gc) {
     OS::PrintErr("Data Freelist (before GC):\n");
@@ -1076,8 +1295,10 @@ void PageSpace::CollectGarbageAtSafepoint(bool compact,
   SpaceUsage usage_before = GetCurrentUsage();
 
   // Mark all reachable old-gen objects.
+  const bool finalizing_concurrent_mark = marker_ != NULL;
   if (marker_ == NULL) {
     ASSERT(phase() == kDone);
+    ClearMarkBitmaps();
     marker_ = new GCMarker(isolate, heap_);
   } else {
     ASSERT(phase() == kAwaitingFinalization);
@@ -1098,6 +1319,10 @@ void PageSpace::CollectGarbageAtSafepoint(bool compact,
   marker_ = NULL;
 
   int64_t mid1 = OS::GetCurrentMonotonicMicros();
+  if (finalizing_concurrent_mark) {
+    finalize_mark_micros_ = mid1 - start;
+    heap_->RecordPause(Heap::kMarkingFinalizationPause, finalize_mark_micros_);
+  }
 
   // Abandon the remainder of the bump allocation block.
   AbandonBumpAllocation();
@@ -1160,6 +1385,11 @@ void PageSpace::CollectGarbageAtSafepoint(bool compact,
   if (compact) {
     Compact(thread);
     set_phase(kDone);
+  } else if (FLAG_lazy_sweep && !FLAG_verify_before_gc &&
+             !FLAG_verify_after_gc) {
+    // Verification expects a swept heap.
+    StartLazySweep();
+    set_phase(kDone);
   } else if (FLAG_concurrent_sweep) {
     ConcurrentSweep(isolate);
   } else {
@@ -1171,6 +1401,8 @@ void PageSpace::CollectGarbageAtSafepoint(bool compact,
   if (finalize) WriteProtectCode(true);
 
   int64_t end = OS::GetCurrentMonotonicMicros();
+  last_gc_end_micros_ = end;
+  free_memory_released_ = false;
 
   // Record signals for growth control. Include size of external allocations.
   page_space_controller_.EvaluateGarbageCollection(
@@ -1178,6 +1410,7 @@ void PageSpace::CollectGarbageAtSafepoint(bool compact,
 
   heap_->RecordTime(kConcurrentSweep, pre_safe_point - pre_wait_for_sweepers);
   heap_->RecordTime(kSafePoint, start - pre_safe_point);
+  heap_->RecordPause(Heap::kSafepointPause, start - pre_safe_point);
   heap_->RecordTime(kMarkObjects, mid1 - start);
   heap_->RecordTime(kResetFreeLists, mid2 - mid1);
   heap_->RecordTime(kSweepPages, mid3 - mid2);
@@ -1196,6 +1429,14 @@ void PageSpace::CollectGarbageAtSafepoint(bool compact,
   }
 }
 
+void PageSpace::ClearMarkBitmaps() {
+  for (HeapPage* page = pages_; page != NULL; page = page->next()) {
+    if (page->mark_bitmap() != NULL) {
+      page->ClearMarkBitmap();
+    }
+  }
+}
+
 void PageSpace::BlockingSweep() {
   TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "Sweep");
 
@@ -1231,9 +1472,57 @@ void PageSpace::ConcurrentSweep(Isolate* isolate) {
                              &freelist_[HeapPage::kData]);
 }
 
+void PageSpace::StartLazySweep() {
+  MutexLocker ml(freelist_[HeapPage::kData].mutex());
+  ASSERT(lazy_sweep_next_ == NULL);
+  // Pages allocated after this point are not swept.
+  lazy_sweep_prev_ = NULL;
+  lazy_sweep_next_ = pages_;
+  lazy_sweep_last_ = pages_tail_;
+}
+
+bool PageSpace::SweepNextPageLocked() {
+  DEBUG_ASSERT(freelist_[HeapPage::kData].mutex()->IsOwnedByCurrentThread());
+  HeapPage* page = lazy_sweep_next_;
+  if (page == NULL) {
+    return false;
+  }
+  HeapPage* next_page = (page == lazy_sweep_last_) ? NULL : page->next();
+  GCSweeper sweeper;
+  if (sweeper.SweepPage(page, &freelist_[HeapPage::kData], true)) {
+    lazy_sweep_prev_ = page;
+  } else {
+    FreePage(page, lazy_sweep_prev_);
+  }
+  lazy_sweep_next_ = next_page;
+  if (next_page == NULL) {
+    lazy_sweep_prev_ = NULL;
+    lazy_sweep_last_ = NULL;
+  }
+  return true;
+}
+
+bool PageSpace::SweepNextPage(bool is_locked) {
+  if (is_locked) {
+    return SweepNextPageLocked();
+  }
+  MutexLocker ml(freelist_[HeapPage::kData].mutex());
+  return SweepNextPageLocked();
+}
+
+void PageSpace::FinishLazySweep() {
+  MutexLocker ml(freelist_[HeapPage::kData].mutex());
+  if (lazy_sweep_next_ == NULL) {
+    return;
+  }
+  TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "FinishLazySweep");
+  while (SweepNextPageLocked()) {
+  }
+}
+
 void PageSpace::Compact(Thread* thread) {
   thread->isolate()->set_compaction_in_progress(true);
-  GCCompactor compactor(thread, heap_);
+  GCCompactor compactor(thread, heap_, compaction_page_budget_);
   compactor.Compact(pages_, &freelist_[HeapPage::kData], &pages_lock_);
   thread->isolate()->set_compaction_in_progress(false);
 
@@ -1255,6 +1544,9 @@ uword PageSpace::TryAllocateDataBumpLocked(intptr_t size) {
     }
     FreeListElement* block =
         freelist_[HeapPage::kData].TryAllocateLargeLocked(size);
+    while ((block == NULL) && SweepNextPageLocked()) {
+      block = freelist_[HeapPage::kData].TryAllocateLargeLocked(size);
+    }
     if (block == NULL) {
       // Allocating from a new page (if growth policy allows) will have the
       // side-effect of populating the freelist with a large block. The next
@@ -1303,6 +1595,12 @@ uword PageSpace::TryAllocatePromoLocked(intptr_t size) {
   return TryAllocateDataLocked(size, PageSpace::kForceGrowth);
 }
 
+void PageSpace::FreePromoLocked(uword addr, intptr_t size) {
+  freelist_[HeapPage::kData].FreeLocked(addr, size);
+  // No need for atomic operation: we're at a safepoint.
+  usage_.used_in_words -= (size >> kWordSizeLog2);
+}
+
 void PageSpace::SetupImagePage(void* pointer, uword size, bool is_executable) {
   // Setup a HeapPage so precompiled Instructions can be traversed.
   // Instructions are contiguous at [pointer, pointer + size). HeapPage
@@ -1321,6 +1619,7 @@ void PageSpace::SetupImagePage(void* pointer, uword size, bool is_executable) {
   page->used_in_bytes_ = page->object_end_ - page->object_start();
   page->forwarding_page_ = NULL;
   page->card_table_ = NULL;
+  page->mark_bitmap_ = NULL;
   if (is_executable) {
     ASSERT(Utils::IsAligned(pointer, OS::PreferredCodeAlignment()));
     page->type_ = HeapPage::kExecutable;
@@ -1348,17 +1647,27 @@ bool PageSpace::IsObjectFromImagePages(dart::RawObject* object) {
 PageSpaceController::PageSpaceController(Heap* heap,
                                          int heap_growth_ratio,
                                          int heap_growth_max,
-                                         int garbage_collection_time_ratio)
+                                         int garbage_collection_time_ratio,
+                                         int target_pause_ms,
+                                         int target_capacity_mb)
     : heap_(heap),
       is_enabled_(false),
       heap_growth_ratio_(heap_growth_ratio),
       desired_utilization_((100.0 - heap_growth_ratio) / 100.0),
       heap_growth_max_(heap_growth_max),
       garbage_collection_time_ratio_(garbage_collection_time_ratio),
-      idle_gc_threshold_in_words_(0) {
+      idle_gc_threshold_in_words_(0),
+      target_pause_micros_(static_cast<int64_t>(target_pause_ms) *
+                           kMicrosecondsPerMillisecond),
+      target_capacity_in_words_(static_cast<intptr_t>(target_capacity_mb) *
+                                MBInWords),
+      concurrent_mark_ratio_(1.0),
+      needs_compaction_(false) {
   intptr_t grow_heap = heap_growth_max / 2;
   gc_threshold_in_words_ =
       last_usage_.capacity_in_words + (kPageSizeInWords * grow_heap);
+  concurrent_mark_threshold_in_words_ = gc_threshold_in_words_;
+  EvaluateExternal(last_usage_, last_usage_);
 }
 
 PageSpaceController::~PageSpaceController() {}
@@ -1375,7 +1684,8 @@ bool PageSpaceController::NeedsGarbageCollection(SpaceUsage after) const {
 #else
   intptr_t headroom = heap_->new_space()->CapacityInWords();
 #endif
-  return after.CombinedCapacityInWords() > (gc_threshold_in_words_ + headroom);
+  return (after.capacity_in_words > (gc_threshold_in_words_ + headroom)) ||
+         (after.external_in_words > gc_external_threshold_in_words_);
 }
 
 bool PageSpaceController::AlmostNeedsGarbageCollection(SpaceUsage after) const {
@@ -1385,7 +1695,9 @@ bool PageSpaceController::AlmostNeedsGarbageCollection(SpaceUsage after) const {
   if (heap_growth_ratio_ == 100) {
     return false;
   }
-  return after.CombinedCapacityInWords() > gc_threshold_in_words_;
+  return (after.capacity_in_words > concurrent_mark_threshold_in_words_) ||
+         (after.external_in_words >
+          concurrent_mark_external_threshold_in_words_);
 }
 
 bool PageSpaceController::NeedsIdleGarbageCollection(SpaceUsage current) const {
@@ -1395,7 +1707,7 @@ bool PageSpaceController::NeedsIdleGarbageCollection(SpaceUsage current) const {
   if (heap_growth_ratio_ == 100) {
     return false;
   }
-  return current.CombinedCapacityInWords() > idle_gc_threshold_in_words_;
+  return current.capacity_in_words > idle_gc_threshold_in_words_;
 }
 
 void PageSpaceController::EvaluateGarbageCollection(SpaceUsage before,
@@ -1410,11 +1722,10 @@ void PageSpaceController::EvaluateGarbageCollection(SpaceUsage before,
   // Assume garbage increases linearly with allocation:
   // G = kA, and estimate k from the previous cycle.
   const intptr_t allocated_since_previous_gc =
-      before.CombinedUsedInWords() - last_usage_.CombinedUsedInWords();
+      before.used_in_words - last_usage_.used_in_words;
   intptr_t grow_heap;
   if (allocated_since_previous_gc > 0) {
-    const intptr_t garbage =
-        before.CombinedUsedInWords() - after.CombinedUsedInWords();
+    const intptr_t garbage = before.used_in_words - after.used_in_words;
     ASSERT(garbage >= 0);
     // It makes no sense to expect that each kb allocated will cause more than
     // one kb of garbage, so we clamp k at 1.0.
@@ -1434,9 +1745,8 @@ void PageSpaceController::EvaluateGarbageCollection(SpaceUsage before,
     // Number of pages we can allocate and still be within the desired growth
     // ratio.
     const intptr_t grow_pages =
-        (static_cast<intptr_t>(after.CombinedCapacityInWords() /
-                               desired_utilization_) -
-         (after.CombinedCapacityInWords())) /
+        (static_cast<intptr_t>(after.capacity_in_words / desired_utilization_) -
+         (after.capacity_in_words)) /
         kPageSizeInWords;
     if (garbage_ratio == 0) {
       // No garbage in the previous cycle so it would be hard to compute a
@@ -1452,10 +1762,10 @@ void PageSpaceController::EvaluateGarbageCollection(SpaceUsage before,
       intptr_t local_grow_heap = 0;
       while (min < max) {
         local_grow_heap = (max + min) / 2;
-        const intptr_t limit = after.CombinedCapacityInWords() +
-                               (local_grow_heap * kPageSizeInWords);
+        const intptr_t limit =
+            after.capacity_in_words + (local_grow_heap * kPageSizeInWords);
         const intptr_t allocated_before_next_gc =
-            limit - (after.CombinedUsedInWords());
+            limit - (after.used_in_words);
         const double estimated_garbage = k * allocated_before_next_gc;
         if (t <= estimated_garbage / limit) {
           max = local_grow_heap - 1;
@@ -1480,34 +1790,113 @@ void PageSpaceController::EvaluateGarbageCollection(SpaceUsage before,
 
   // Limit shrinkage: allow growth by at least half the pages freed by GC.
   const intptr_t freed_pages =
-      (before.CombinedCapacityInWords() - after.CombinedCapacityInWords()) /
-      kPageSizeInWords;
+      (before.capacity_in_words - after.capacity_in_words) / kPageSizeInWords;
   grow_heap = Utils::Maximum(grow_heap, freed_pages / 2);
   heap_->RecordData(PageSpace::kAllowedGrowth, grow_heap);
+  EvaluateExternal(before, after);
   last_usage_ = after;
 
   // Save final threshold compared before growing.
   gc_threshold_in_words_ =
-      after.CombinedCapacityInWords() + (kPageSizeInWords * grow_heap);
+      after.capacity_in_words + (kPageSizeInWords * grow_heap);
 
   // Set a tight idle threshold.
-  idle_gc_threshold_in_words_ =
-      after.CombinedCapacityInWords() + 2 * kPageSizeInWords;
+  idle_gc_threshold_in_words_ = after.capacity_in_words + 2 * kPageSizeInWords;
+
+  ApplyTargets(after);
 
   if (FLAG_log_growth) {
-    THR_Print("%s: threshold=%" Pd "kB, idle_threshold=%" Pd "kB, reason=gc\n",
+    THR_Print("%s: threshold=%" Pd "kB, idle_threshold=%" Pd
+              "kB, mark_threshold=%" Pd "kB, external_threshold=%" Pd
+              "kB, compact=%s, reason=gc\n",
               heap_->isolate()->name(), gc_threshold_in_words_ / KBInWords,
-              idle_gc_threshold_in_words_ / KBInWords);
+              idle_gc_threshold_in_words_ / KBInWords,
+              concurrent_mark_threshold_in_words_ / KBInWords,
+              gc_external_threshold_in_words_ / KBInWords,
+              needs_compaction_ ? "yes" : "no");
+  }
+}
+
+void PageSpaceController::ApplyTargets(SpaceUsage after) {
+  const intptr_t capacity = after.capacity_in_words;
+  needs_compaction_ = false;
+
+  if (target_pause_micros_ > 0) {
+    // Pauses over the target usually come from marking synchronously after
+    // the threshold was hit before concurrent marking finished, so start
+    // marking earlier. Give the headroom back slowly once pauses are well
+    // below the target.
+    const int64_t max_pause = history_.MaxPauseMicros();
+    if (max_pause > target_pause_micros_) {
+      concurrent_mark_ratio_ =
+          Utils::Maximum(0.25, concurrent_mark_ratio_ / 2);
+    } else if (max_pause < target_pause_micros_ / 2) {
+      concurrent_mark_ratio_ =
+          Utils::Minimum(1.0, concurrent_mark_ratio_ * 1.25);
+    }
+  }
+
+  if (target_capacity_in_words_ > 0) {
+    // Stay below the target by not growing past it; the heap still grows
+    // when the live data does not fit, as GC could not make progress
+    // otherwise.
+    const intptr_t limit = Utils::Maximum(
+        target_capacity_in_words_, capacity + 2 * kPageSizeInWords);
+    gc_threshold_in_words_ = Utils::Minimum(gc_threshold_in_words_, limit);
+
+    // Close to the target, fragmentation is what keeps the capacity up.
+    // Compact unless that is expected to blow the pause target, assuming
+    // compaction takes as long as marking (see ShouldPerformIdleMarkCompact).
+    const intptr_t free = capacity - after.used_in_words;
+    if ((capacity > target_capacity_in_words_ / 10 * 9) &&
+        (free > capacity / 4)) {
+      needs_compaction_ = true;
+      const intptr_t mark_words_per_micro =
+          heap_->old_space()->mark_words_per_micro_;
+      if ((target_pause_micros_ > 0) && (mark_words_per_micro > 0)) {
+        const int64_t estimated_compaction_micros =
+            after.used_in_words / (mark_words_per_micro / 2 + 1);
+        needs_compaction_ = estimated_compaction_micros <= target_pause_micros_;
+      }
+    }
   }
+
+  concurrent_mark_threshold_in_words_ =
+      capacity + static_cast<intptr_t>((gc_threshold_in_words_ - capacity) *
+                                       concurrent_mark_ratio_);
+}
+
+void PageSpaceController::EvaluateExternal(SpaceUsage before,
+                                           SpaceUsage after) {
+  // External memory is budgeted separately from the pages: its size says
+  // little about how much heap its owners take, and GCs only free it when
+  // its owners die. Let it grow in proportion to what survived, and more
+  // when the last GC freed little of what was allocated since the previous
+  // one, since collecting again soon would not free more.
+  intptr_t growth = static_cast<intptr_t>(
+      static_cast<int64_t>(after.external_in_words) *
+      FLAG_old_gen_external_growth_ratio / 100);
+  const intptr_t allocated =
+      before.external_in_words - last_usage_.external_in_words;
+  const intptr_t freed = before.external_in_words - after.external_in_words;
+  if ((allocated > 0) && (freed < allocated / 2)) {
+    growth *= 2;
+  }
+  growth = Utils::Maximum(
+      growth,
+      static_cast<intptr_t>(FLAG_old_gen_external_min_growth) * MBInWords);
+  gc_external_threshold_in_words_ = after.external_in_words + growth;
+  concurrent_mark_external_threshold_in_words_ =
+      after.external_in_words +
+      static_cast<intptr_t>(growth * concurrent_mark_ratio_);
 }
 
 void PageSpaceController::EvaluateAfterLoading(SpaceUsage after) {
   // Number of pages we can allocate and still be within the desired growth
   // ratio.
   intptr_t growth_in_pages =
-      (static_cast<intptr_t>(after.CombinedCapacityInWords() /
-                             desired_utilization_) -
-       (after.CombinedCapacityInWords())) /
+      (static_cast<intptr_t>(after.capacity_in_words / desired_utilization_) -
+       (after.capacity_in_words)) /
       kPageSizeInWords;
 
   // Apply growth cap.
@@ -1516,11 +1905,13 @@ void PageSpaceController::EvaluateAfterLoading(SpaceUsage after) {
 
   // Save final threshold compared before growing.
   gc_threshold_in_words_ =
-      after.CombinedCapacityInWords() + (kPageSizeInWords * growth_in_pages);
+      after.capacity_in_words + (kPageSizeInWords * growth_in_pages);
 
   // Set a tight idle threshold.
-  idle_gc_threshold_in_words_ =
-      after.CombinedCapacityInWords() + 2 * kPageSizeInWords;
+  idle_gc_threshold_in_words_ = after.capacity_in_words + 2 * kPageSizeInWords;
+
+  ApplyTargets(after);
+  EvaluateExternal(after, after);
 
   if (FLAG_log_growth) {
     THR_Print("%s: threshold=%" Pd "kB, idle_threshold=%" Pd
@@ -1538,6 +1929,15 @@ void PageSpaceGarbageCollectionHistory::AddGarbageCollectionTime(int64_t start,
   history_.Add(entry);
 }
 
+int64_t PageSpaceGarbageCollectionHistory::MaxPauseMicros() {
+  int64_t max_pause = 0;
+  for (int i = 0; i < history_.Size(); i++) {
+    Entry entry = history_.Get(i);
+    max_pause = Utils::Maximum(max_pause, entry.end - entry.start);
+  }
+  return max_pause;
+}
+
 int PageSpaceGarbageCollectionHistory::GarbageCollectionTimeFraction() {
   int64_t gc_time = 0;
   int64_t total_time = 0;
@@ -143,6 +143,43 @@ class HeapPage {
   }
   void VisitRememberedCards(ObjectPointerVisitor* visitor);
 
+  // The card table is freed once a scavenge finds no card with a new target.
+  bool has_card_table() const { return card_table_ != NULL; }
+  intptr_t NumRememberedCards() const {
+    intptr_t count = 0;
+    if (card_table_ != NULL) {
+      for (intptr_t i = 0; i < card_table_size(); i++) {
+        if (card_table_[i] != 0) count++;
+      }
+    }
+    return count;
+  }
+
+  // With --use_mark_bitmap, regular data pages record the objects found live
+  // by the marker in a side bitmap with one bit per allocation unit, in
+  // addition to the mark bits in the object headers. The sweeper then finds
+  // live objects with word-level bit scans instead of walking dead ones.
+  // NULL for other pages.
+  static const intptr_t kMarkBitmapLength =
+      kPageSize / kObjectAlignment / kBitsPerInt32;
+  uint32_t* mark_bitmap() const { return mark_bitmap_; }
+  void AllocateMarkBitmap();
+  void ClearMarkBitmap();
+
+  void RecordLive(RawObject* raw_obj) {
+    ASSERT(mark_bitmap_ != NULL);
+    const intptr_t unit = (RawObject::ToAddr(raw_obj) -
+                           reinterpret_cast<uword>(this)) >>
+                          kObjectAlignmentLog2;
+    ASSERT((unit >= 0) && (unit < kMarkBitmapLength * kBitsPerInt32));
+    AtomicOperations::FetchOrRelaxedUint32(
+        &mark_bitmap_[unit / kBitsPerInt32], 1u << (unit % kBitsPerInt32));
+  }
+
+  // Returns the address of the first object recorded live at or after
+  // [addr], or [end] if there is none before it.
+  uword NextLive(uword addr, uword end) const;
+
  private:
   void set_object_end(uword value) {
     ASSERT((value & kObjectAlignmentMask) == kOldObjectAlignmentOffset);
@@ -165,6 +202,7 @@ class HeapPage {
   ForwardingPage* forwarding_page_;
   uint8_t* card_table_;  // Remembered set, not marking.
   PageType type_;
+  uint32_t* mark_bitmap_;
 
   friend class PageSpace;
   friend class GCCompactor;
@@ -184,6 +222,9 @@ class PageSpaceGarbageCollectionHistory {
 
   int GarbageCollectionTimeFraction();
 
+  // The longest of the recorded collections, in microseconds.
+  int64_t MaxPauseMicros();
+
   bool IsEmpty() const { return history_.Size() == 0; }
 
  private:
@@ -206,7 +247,9 @@ class PageSpaceController {
   PageSpaceController(Heap* heap,
                       int heap_growth_ratio,
                       int heap_growth_max,
-                      int garbage_collection_time_ratio);
+                      int garbage_collection_time_ratio,
+                      int target_pause_ms = 0,
+                      int target_capacity_mb = 0);
   ~PageSpaceController();
 
   // Returns whether growing to 'after' should trigger a GC.
@@ -218,6 +261,10 @@ class PageSpaceController {
   // Returns whether an idle GC is worthwhile.
   bool NeedsIdleGarbageCollection(SpaceUsage current) const;
 
+  // Returns whether the next GC should compact to stay below the target
+  // capacity.
+  bool NeedsCompaction() const { return is_enabled_ && needs_compaction_; }
+
   // Should be called after each collection to update the controller state.
   void EvaluateGarbageCollection(SpaceUsage before,
                                  SpaceUsage after,
@@ -260,9 +307,35 @@ class PageSpaceController {
   // Perform a synchronous GC when external allocations exceed this amount.
   intptr_t gc_external_threshold_in_words_;
 
+  // Start concurrent marking when external allocations exceed this amount.
+  intptr_t concurrent_mark_external_threshold_in_words_;
+
   // Start considering idle GC when capacity exceeds this amount.
   intptr_t idle_gc_threshold_in_words_;
 
+  // Pause-targeted policy (see --old_gen_target_pause and
+  // --old_gen_target_heap_size). Zero means no target.
+  const int64_t target_pause_micros_;
+  const intptr_t target_capacity_in_words_;
+
+  // Start concurrent marking after this fraction of the growth allowed until
+  // the next GC. Lowered while pauses exceed the target so that marking
+  // finishes concurrently instead of in a synchronous GC.
+  double concurrent_mark_ratio_;
+
+  // Start concurrent marking when capacity exceeds this amount.
+  intptr_t concurrent_mark_threshold_in_words_;
+
+  bool needs_compaction_;
+
+  // Adjusts the thresholds computed from the growth ratios towards the pause
+  // and capacity targets.
+  void ApplyTargets(SpaceUsage after);
+
+  // Sets the external allocation thresholds from the external memory the
+  // last GC freed (see --old_gen_external_growth_ratio).
+  void EvaluateExternal(SpaceUsage before, SpaceUsage after);
+
   PageSpaceGarbageCollectionHistory history_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(PageSpaceController);
@@ -292,6 +365,9 @@ class PageSpace {
   bool AlmostNeedsGarbageCollection() const {
     return page_space_controller_.AlmostNeedsGarbageCollection(usage_);
   }
+  bool NeedsCompaction() const {
+    return page_space_controller_.NeedsCompaction();
+  }
   void EvaluateAfterLoading() {
     page_space_controller_.EvaluateAfterLoading(usage_);
   }
@@ -330,6 +406,10 @@ class PageSpace {
   void VisitObjectsImagePages(ObjectVisitor* visitor) const;
   void VisitObjectPointers(ObjectPointerVisitor* visitor) const;
 
+  // Appends all pages, including image pages, to 'pages' so that they can be
+  // visited by several threads. The caller must be in a HeapIterationScope.
+  void AddPagesTo(GrowableArray<HeapPage*>* pages) const;
+
   void VisitRememberedCards(ObjectPointerVisitor* visitor) const;
 
   RawObject* FindObject(FindObjectVisitor* visitor,
@@ -338,6 +418,12 @@ class PageSpace {
   // Collect the garbage in the page space using mark-sweep or mark-compact.
   void CollectGarbage(bool compact, bool finalize);
 
+  // Sweeps the data pages the last GC left for allocation to sweep with
+  // --lazy_sweep, for callers that need the whole heap to be swept.
+  void FinishLazySweep();
+  // Only safe to read at a safepoint or with the data freelist lock held.
+  bool HasUnsweptPages() const { return lazy_sweep_next_ != NULL; }
+
   void AddRegionsToObjectSet(ObjectSet* set) const;
 
   void InitGrowthControl() {
@@ -362,6 +448,27 @@ class PageSpace {
 
   bool ShouldPerformIdleMarkSweep(int64_t deadline);
   bool ShouldPerformIdleMarkCompact(int64_t deadline);
+  // Whether a finished concurrent mark can be finalized before the deadline.
+  bool ShouldPerformIdleFinalizeMarking(int64_t deadline);
+  // Whether to start a concurrent mark in an idle period too short for a
+  // whole mark-sweep, so a later idle period only has to finalize it.
+  bool ShouldStartIdleConcurrentMark();
+  // The number of fragmented pages that can be compacted in the time left
+  // before the deadline after marking, or 0 if compaction is not worthwhile.
+  intptr_t IdleCompactionPageBudget(int64_t deadline);
+
+  // Whether the memory of large free blocks has stayed unused for
+  // --free_memory_release_delay since the last GC and not been released yet.
+  bool ShouldReleaseFreeMemory();
+  // Gives the OS pages inside large free blocks back to the OS.
+  void ReleaseFreeMemory();
+
+  // If non-zero, the next compaction moves the objects of at most this many
+  // pages (see GCCompactor::SelectPages).
+  intptr_t compaction_page_budget() const { return compaction_page_budget_; }
+  void set_compaction_page_budget(intptr_t pages) {
+    compaction_page_budget_ = pages;
+  }
 
   void AddGCTime(int64_t micros) { gc_time_micros_ += micros; }
 
@@ -376,9 +483,13 @@ class PageSpace {
   void PrintHeapMapToJSONStream(Isolate* isolate, JSONStream* stream) const;
 #endif  // PRODUCT
 
-  void AllocateBlack(intptr_t size) {
+  void AllocateBlack(RawObject* raw_obj, intptr_t size) {
     AtomicOperations::IncrementBy(&allocated_black_in_words_,
                                   size >> kWordSizeLog2);
+    HeapPage* page = HeapPage::Of(raw_obj);
+    if (page->mark_bitmap() != NULL) {
+      page->RecordLive(raw_obj);
+    }
   }
 
   void AllocateExternal(intptr_t cid, intptr_t size);
@@ -417,6 +528,8 @@ class PageSpace {
   uword TryAllocateDataBumpLocked(intptr_t size);
   // Prefer small freelist blocks, then chip away at the bump block.
   uword TryAllocatePromoLocked(intptr_t size);
+  // Return the unused part of a block from TryAllocatePromoLocked.
+  void FreePromoLocked(uword addr, intptr_t size);
 
   void SetupImagePage(void* pointer, uword size, bool is_executable);
 
@@ -469,12 +582,21 @@ class PageSpace {
   void FreeLargePage(HeapPage* page, HeapPage* previous_page);
   void FreePages(HeapPage* pages);
 
+  bool IsFragmented() const;
+  int64_t EstimatedFinalizeMarkMicros() const;
+
   void CollectGarbageAtSafepoint(bool compact,
                                  bool finalize,
                                  int64_t pre_wait_for_sweepers,
                                  int64_t pre_safe_point);
+  void ClearMarkBitmaps();
   void BlockingSweep();
   void ConcurrentSweep(Isolate* isolate);
+  void StartLazySweep();
+  // Sweeps the next data page left by StartLazySweep into the data freelist,
+  // whose lock must be held. Returns false if no page is left.
+  bool SweepNextPageLocked();
+  bool SweepNextPage(bool is_locked);
   void Compact(Thread* thread);
 
   static intptr_t LargePageSizeInWordsFor(intptr_t size);
@@ -508,6 +630,13 @@ class PageSpace {
   uword bump_top_;
   uword bump_end_;
 
+  // The data pages from lazy_sweep_next_ to lazy_sweep_last_ that are still
+  // to be swept after a GC with --lazy_sweep, and the page before them.
+  // Guarded by the data freelist lock.
+  HeapPage* lazy_sweep_prev_;
+  HeapPage* lazy_sweep_next_;
+  HeapPage* lazy_sweep_last_;
+
   // Various sizes being tracked for this generation.
   intptr_t max_capacity_in_words_;
 
@@ -531,6 +660,11 @@ class PageSpace {
   int64_t gc_time_micros_;
   intptr_t collections_;
   intptr_t mark_words_per_micro_;
+  // Duration of the last final marking pause after a concurrent mark.
+  int64_t finalize_mark_micros_;
+  intptr_t compaction_page_budget_;
+  int64_t last_gc_end_micros_;
+  bool free_memory_released_;
 
   bool enable_concurrent_mark_;
 
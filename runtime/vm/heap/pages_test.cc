@@ -31,4 +31,32 @@ TEST_CASE(Pages) {
   delete space;
 }
 
+ISOLATE_UNIT_TEST_CASE(PageSpaceController_TargetCapacity) {
+  Heap* heap = thread->isolate()->heap();
+  PageSpaceController controller(heap, 20, 280, 3, 0, 16);
+  controller.Enable();
+
+  SpaceUsage before;
+  before.capacity_in_words = 15 * MBInWords;
+  before.used_in_words = 15 * MBInWords;
+  SpaceUsage after;
+  after.capacity_in_words = 15 * MBInWords;
+  after.used_in_words = 5 * MBInWords;
+  controller.EvaluateGarbageCollection(before, after, 0, 1000);
+
+  // Growth stops at the target capacity.
+  SpaceUsage current;
+  current.capacity_in_words = 15 * MBInWords + MBInWords / 2;
+  EXPECT(!controller.AlmostNeedsGarbageCollection(current));
+  current.capacity_in_words = 16 * MBInWords + MBInWords / 2;
+  EXPECT(controller.AlmostNeedsGarbageCollection(current));
+
+  // Two thirds of the capacity close to the target is free, so compact.
+  EXPECT(controller.NeedsCompaction());
+
+  after.used_in_words = 14 * MBInWords;
+  controller.EvaluateGarbageCollection(before, after, 2000, 3000);
+  EXPECT(!controller.NeedsCompaction());
+}
+
 }  // namespace dart
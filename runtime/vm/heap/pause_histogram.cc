@@ -0,0 +1,96 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/heap/pause_histogram.h"
+
+#include <math.h>
+
+#include "platform/utils.h"
+#include "vm/json_stream.h"
+
+namespace dart {
+
+intptr_t PauseHistogram::BucketFor(int64_t micros) {
+  if (micros < kSubBuckets) {
+    return (micros < 0) ? 0 : micros;
+  }
+  const intptr_t msb = Utils::HighestBit(micros);
+  if (msb >= kMaxValueBits) {
+    return kNumBuckets - 1;
+  }
+  const intptr_t shift = msb - kSubBucketBits;
+  return (shift + 1) * kSubBuckets + ((micros >> shift) - kSubBuckets);
+}
+
+int64_t PauseHistogram::BucketLowerBound(intptr_t bucket) {
+  ASSERT((bucket >= 0) && (bucket < kNumBuckets));
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  const intptr_t shift = (bucket / kSubBuckets) - 1;
+  return static_cast<int64_t>(kSubBuckets + (bucket % kSubBuckets)) << shift;
+}
+
+void PauseHistogram::Add(int64_t micros) {
+  if (micros < 0) {
+    micros = 0;
+  }
+  counts_[BucketFor(micros)]++;
+  count_++;
+  total_micros_ += micros;
+  if (micros > max_micros_) {
+    max_micros_ = micros;
+  }
+}
+
+void PauseHistogram::Reset() {
+  for (intptr_t i = 0; i < kNumBuckets; i++) {
+    counts_[i] = 0;
+  }
+  count_ = 0;
+  total_micros_ = 0;
+  max_micros_ = 0;
+}
+
+int64_t PauseHistogram::Percentile(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  int64_t rank = static_cast<int64_t>(ceil(percentile * count_ / 100.0));
+  if (rank < 1) {
+    rank = 1;
+  }
+  int64_t seen = 0;
+  for (intptr_t i = 0; i < kNumBuckets - 1; i++) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      const int64_t upper = BucketLowerBound(i + 1) - 1;
+      return (upper < max_micros_) ? upper : max_micros_;
+    }
+  }
+  return max_micros_;
+}
+
+#ifndef PRODUCT
+void PauseHistogram::PrintJSON(JSONObject* obj) const {
+  obj->AddProperty64("count", count_);
+  obj->AddProperty64("totalMicros", total_micros_);
+  obj->AddProperty64("maxMicros", max_micros_);
+  obj->AddProperty64("p50Micros", Percentile(50));
+  obj->AddProperty64("p90Micros", Percentile(90));
+  obj->AddProperty64("p99Micros", Percentile(99));
+  obj->AddProperty64("p999Micros", Percentile(99.9));
+  JSONArray buckets(obj, "buckets");
+  for (intptr_t i = 0; i < kNumBuckets; i++) {
+    if (counts_[i] == 0) {
+      continue;
+    }
+    JSONArray bucket(&buckets);
+    bucket.AddValue64(BucketLowerBound(i));
+    bucket.AddValue64(counts_[i]);
+  }
+}
+#endif  // !PRODUCT
+
+}  // namespace dart
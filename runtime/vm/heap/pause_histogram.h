@@ -0,0 +1,64 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_HEAP_PAUSE_HISTOGRAM_H_
+#define RUNTIME_VM_HEAP_PAUSE_HISTOGRAM_H_
+
+#include "vm/globals.h"
+
+#include "platform/assert.h"
+#include "vm/allocation.h"
+
+namespace dart {
+
+class JSONObject;
+
+// A log-linear histogram of pause durations in microseconds. Values below
+// kSubBuckets are counted exactly; above that every power of two is split
+// into kSubBuckets equal buckets, so a bucket's bounds are within 1/16 of
+// any value counted in it. Memory use is fixed and recording is O(1), so
+// pauses can be recorded during every collection.
+class PauseHistogram : public ValueObject {
+ public:
+  PauseHistogram() { Reset(); }
+
+  void Add(int64_t micros);
+  void Reset();
+
+  int64_t count() const { return count_; }
+  int64_t total_micros() const { return total_micros_; }
+  int64_t max_micros() const { return max_micros_; }
+
+  // Returns an upper bound on the pause at |percentile| (0 to 100), or 0 if
+  // nothing has been recorded.
+  int64_t Percentile(double percentile) const;
+
+#ifndef PRODUCT
+  // Adds count, total, max, common percentiles and the non-empty buckets as
+  // [lowerBoundMicros, count] pairs.
+  void PrintJSON(JSONObject* obj) const;
+#endif
+
+  static intptr_t BucketFor(int64_t micros);
+  static int64_t BucketLowerBound(intptr_t bucket);
+
+ private:
+  static const intptr_t kSubBucketBits = 4;
+  static const intptr_t kSubBuckets = 1 << kSubBucketBits;
+  // Pauses of 2^36us (about 19 hours) and more share the last bucket.
+  static const intptr_t kMaxValueBits = 36;
+  static const intptr_t kNumBuckets =
+      (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets;
+
+  int64_t counts_[kNumBuckets];
+  int64_t count_;
+  int64_t total_micros_;
+  int64_t max_micros_;
+
+  DISALLOW_COPY_AND_ASSIGN(PauseHistogram);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_HEAP_PAUSE_HISTOGRAM_H_
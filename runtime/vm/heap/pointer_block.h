@@ -6,6 +6,7 @@
 #define RUNTIME_VM_HEAP_POINTER_BLOCK_H_
 
 #include "platform/assert.h"
+#include "platform/atomic.h"
 #include "vm/globals.h"
 #include "vm/os_thread.h"
 
@@ -167,10 +168,21 @@ typedef StoreBuffer::Block StoreBufferBlock;
 static const int kMarkingStackBlockSize = 64;
 class MarkingStack : public BlockStack<kMarkingStackBlockSize> {
  public:
+  MarkingStack() : num_waiting_(0) {}
+
   // Adds and transfers ownership of the block to the buffer.
   void PushBlock(Block* block) {
     BlockStack<Block::kSize>::PushBlockImpl(block);
   }
+
+  // Markers that have run out of work wait between AddWaiter and
+  // RemoveWaiter, so that busy markers know to share some of theirs.
+  void AddWaiter() { AtomicOperations::FetchAndIncrement(&num_waiting_); }
+  void RemoveWaiter() { AtomicOperations::FetchAndDecrement(&num_waiting_); }
+  bool HasWaiters() { return AtomicOperations::LoadRelaxed(&num_waiting_) > 0; }
+
+ private:
+  uintptr_t num_waiting_;
 };
 
 typedef MarkingStack::Block MarkingStackBlock;
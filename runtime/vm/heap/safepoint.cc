@@ -4,8 +4,13 @@
 
 #include "vm/heap/safepoint.h"
 
+#include "vm/isolate.h"
+#include "vm/object.h"
+#include "vm/os.h"
+#include "vm/stack_frame.h"
 #include "vm/thread.h"
 #include "vm/thread_registry.h"
+#include "vm/timeline.h"
 
 namespace dart {
 
@@ -41,6 +46,9 @@ SafepointHandler::SafepointHandler(Isolate* isolate)
     : isolate_(isolate),
       safepoint_lock_(),
       number_threads_not_at_safepoint_(0),
+      safepoint_start_micros_(0),
+      num_check_ins_(0),
+      num_slowest_pcs_(0),
       safepoint_operation_count_(0),
       owner_(NULL) {}
 
@@ -76,6 +84,14 @@ void SafepointHandler::SafepointThreads(Thread* T) {
 
     // Set safepoint in progress state by this thread.
     SetSafepointInProgress(T);
+    {
+      MonitorLocker sl(&safepoint_lock_);
+      safepoint_start_micros_ = OS::GetCurrentMonotonicMicros();
+      num_check_ins_ = 0;
+      slowest_.thread = NULL;
+      slowest_.micros = 0;
+      num_slowest_pcs_ = 0;
+    }
 
     // Go over the active thread list and ensure that all threads active
     // in the isolate reach a safepoint.
@@ -125,6 +141,103 @@ void SafepointHandler::SafepointThreads(Thread* T) {
       }
     }
   }
+  ReportCheckIns(T);
+}
+
+void SafepointHandler::RecordCheckIn(Thread* T) {
+  ASSERT(safepoint_lock_.IsOwnedByCurrentThread());
+  const int64_t micros =
+      OS::GetCurrentMonotonicMicros() - safepoint_start_micros_;
+  if (num_check_ins_ < kMaxRecordedCheckIns) {
+    check_ins_[num_check_ins_].thread = T;
+    check_ins_[num_check_ins_].micros = micros;
+    num_check_ins_++;
+  }
+  if (number_threads_not_at_safepoint_ > 0) {
+    return;
+  }
+  // Last to arrive: remember where this thread was when it checked in.
+  slowest_.thread = T;
+  slowest_.micros = micros;
+  num_slowest_pcs_ = 0;
+  if (!T->IsMutatorThread() || (T->top_exit_frame_info() == 0)) {
+    return;
+  }
+  StackFrameIterator frames(ValidationPolicy::kDontValidateFrames, T,
+                            StackFrameIterator::kNoCrossThreadIteration);
+  for (StackFrame* frame = frames.NextFrame();
+       (frame != NULL) && (num_slowest_pcs_ < kMaxSlowestFrames);
+       frame = frames.NextFrame()) {
+    if (frame->IsDartFrame()) {
+      slowest_pcs_[num_slowest_pcs_++] = frame->pc();
+    }
+  }
+}
+
+#if !defined(PRODUCT)
+// A thread that checked in from native code may have left the isolate since.
+static const char* ThreadName(Thread* thread) {
+  OSThread* os_thread = thread->os_thread();
+  if ((os_thread == NULL) || (os_thread->name() == NULL)) {
+    return "<unnamed>";
+  }
+  return os_thread->name();
+}
+#endif  // !defined(PRODUCT)
+
+void SafepointHandler::ReportCheckIns(Thread* T) {
+#if !defined(PRODUCT)
+  const int64_t end = OS::GetCurrentMonotonicMicros();
+  const int64_t total = end - safepoint_start_micros_;
+  Isolate* I = isolate();
+  I->GetSafepointReachTimeMetric()->set_value(total);
+  I->GetSafepointReachTimeMaxMetric()->SetValue(total);
+
+  if ((slowest_.thread != NULL) && FLAG_trace_safepoint) {
+    OS::PrintErr("Safepoint reached in %" Pd64 "us, slowest thread %s (%" Pd64
+                 "us)\n",
+                 total, ThreadName(slowest_.thread), slowest_.micros);
+  }
+
+  TimelineStream* stream = Timeline::GetGCStream();
+  ASSERT(stream != NULL);
+  TimelineEvent* event = stream->StartEvent();
+  if (event == NULL) {
+    return;
+  }
+  event->Duration("SafepointThreads", safepoint_start_micros_, end);
+  TextBuffer check_ins(256);
+  for (intptr_t i = 0; i < num_check_ins_; i++) {
+    check_ins.Printf("%s: %" Pd64 "us\n", ThreadName(check_ins_[i].thread),
+                     check_ins_[i].micros);
+  }
+  if (slowest_.thread == NULL) {
+    // Every thread was already at a safepoint.
+    event->SetNumArguments(1);
+    event->CopyArgument(0, "checkIns", check_ins.buf());
+    event->Complete();
+    return;
+  }
+  TextBuffer stack(256);
+  Zone* zone = T->zone();
+  for (intptr_t i = 0; i < num_slowest_pcs_; i++) {
+    const uword pc = slowest_pcs_[i];
+    if (zone != NULL) {
+      const Code& code = Code::Handle(zone, Code::LookupCode(pc));
+      if (!code.IsNull()) {
+        stack.Printf("%s\n", code.QualifiedName());
+        continue;
+      }
+    }
+    stack.Printf("[0x%" Px "]\n", pc);
+  }
+  event->SetNumArguments(4);
+  event->CopyArgument(0, "checkIns", check_ins.buf());
+  event->CopyArgument(1, "slowestThread", ThreadName(slowest_.thread));
+  event->FormatArgument(2, "slowestMicros", "%" Pd64 "", slowest_.micros);
+  event->CopyArgument(3, "slowestStack", stack.buf());
+  event->Complete();
+#endif  // !defined(PRODUCT)
 }
 
 void SafepointHandler::ResumeThreads(Thread* T) {
@@ -168,6 +281,7 @@ void SafepointHandler::EnterSafepointUsingLock(Thread* T) {
     MonitorLocker sl(&safepoint_lock_);
     ASSERT(number_threads_not_at_safepoint_ > 0);
     number_threads_not_at_safepoint_ -= 1;
+    RecordCheckIn(T);
     sl.Notify();
   }
 }
@@ -192,6 +306,7 @@ void SafepointHandler::BlockForSafepoint(Thread* T) {
       MonitorLocker sl(&safepoint_lock_);
       ASSERT(number_threads_not_at_safepoint_ > 0);
       number_threads_not_at_safepoint_ -= 1;
+      RecordCheckIn(T);
       sl.Notify();
     }
     while (T->IsSafepointRequested()) {
@@ -39,6 +39,14 @@ class SafepointHandler {
   void SafepointThreads(Thread* T);
   void ResumeThreads(Thread* T);
 
+  // Notes how long |T| took to reach the safepoint requested by the current
+  // operation. Must be called with |safepoint_lock_| held, just after |T|
+  // has been counted as having reached it.
+  void RecordCheckIn(Thread* T);
+  // Publishes the time-to-safepoint records of the operation started by |T|
+  // once every thread has reached the safepoint.
+  void ReportCheckIns(Thread* T);
+
   Isolate* isolate() const { return isolate_; }
   Monitor* threads_lock() const { return isolate_->threads_lock(); }
   bool SafepointInProgress() const {
@@ -81,6 +89,22 @@ class SafepointHandler {
   Monitor safepoint_lock_;
   int32_t number_threads_not_at_safepoint_;
 
+  // Time-to-safepoint records for the current operation, guarded by
+  // |safepoint_lock_|. The last thread to check in is the slowest one, and
+  // the pcs of its Dart frames at that point are kept.
+  struct CheckIn {
+    Thread* thread;
+    int64_t micros;
+  };
+  static const intptr_t kMaxRecordedCheckIns = 32;
+  static const intptr_t kMaxSlowestFrames = 16;
+  int64_t safepoint_start_micros_;
+  CheckIn check_ins_[kMaxRecordedCheckIns];
+  intptr_t num_check_ins_;
+  CheckIn slowest_;
+  uword slowest_pcs_[kMaxSlowestFrames];
+  intptr_t num_slowest_pcs_;
+
   // Count that indicates if a safepoint operation is currently in progress
   // and also tracks the number of recursive safepoint operations on the
   // same thread.
@@ -7,6 +7,7 @@
 #include "vm/dart.h"
 #include "vm/dart_api_state.h"
 #include "vm/flag_list.h"
+#include "vm/heap/become.h"
 #include "vm/heap/pointer_block.h"
 #include "vm/heap/safepoint.h"
 #include "vm/heap/verifier.h"
@@ -17,6 +18,8 @@
 #include "vm/object_id_ring.h"
 #include "vm/object_set.h"
 #include "vm/stack_frame.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
 #include "vm/thread_registry.h"
 #include "vm/timeline.h"
 #include "vm/visitor.h"
@@ -33,6 +36,17 @@ DEFINE_FLAG(int,
             90,
             "Grow new gen when less than this percentage is garbage.");
 DEFINE_FLAG(int, new_gen_growth_factor, 2, "Grow new gen by this factor.");
+DEFINE_FLAG(int,
+            pretenure_sample_interval,
+            0,
+            "Sample which objects survive their first scavenge every this "
+            "many scavenges, and promote the objects of classes that mostly "
+            "survive it at their first scavenge. 0 disables pretenuring.");
+DEFINE_FLAG(int,
+            pretenure_survival_threshold,
+            90,
+            "Pretenure the objects of a class when more than this percentage "
+            "of them survive their first scavenge.");
 
 // Scavenger uses RawObject::kMarkBit to distinguish forwarded and non-forwarded
 // objects. The kMarkBit does not intersect with the target address because of
@@ -85,19 +99,146 @@ static inline void objcpy(void* dst, const void* src, size_t size) {
   } while (size > 0);
 }
 
-class ScavengerVisitor : public ObjectPointerVisitor {
+// Size of the allocation buffers the parallel scavenger carves out of the to
+// space. Each task copies objects into its own buffer, so only the refill
+// requires synchronization.
+static const intptr_t kParallelScavengerLABSize = 16 * KB;
+
+// Size of the buffers the parallel scavenger carves out of the old space free
+// lists for promotion. Larger objects are promoted directly.
+static const intptr_t kParallelScavengerPromoLABSize = 16 * KB;
+static const intptr_t kParallelScavengerMaxPromoLABObjectSize =
+    kParallelScavengerPromoLABSize / 8;
+
+// State shared by the tasks of a parallel scavenge.
+class ParallelScavengerState {
+ public:
+  enum RootSlices {
+    kIsolateRoots = 0,
+    kRememberedCards = 1,
+    kObjectIdRing = 2,
+    kNumRootSlices = 3,
+  };
+
+  explicit ParallelScavengerState(StoreBufferBlock* pending_blocks)
+      : root_slices_not_started_(kNumRootSlices),
+        pending_blocks_(pending_blocks),
+        store_buffer_entries_(0),
+        work_list_length_(0),
+        bytes_promoted_(0) {}
+
+  // Returns the next root slice to visit, or -1 if all have been claimed.
+  intptr_t ClaimRootSlice() {
+    return AtomicOperations::FetchAndDecrement(&root_slices_not_started_) - 1;
+  }
+
+  // Returns the next block of the store buffer as it was at the start of
+  // the scavenge, or NULL if all blocks have been claimed.
+  StoreBufferBlock* PopStoreBufferBlock() {
+    MutexLocker ml(&blocks_mutex_);
+    StoreBufferBlock* block = pending_blocks_;
+    if (block != NULL) {
+      pending_blocks_ = block->next();
+    }
+    return block;
+  }
+
+  void AddStoreBufferEntries(intptr_t count) {
+    AtomicOperations::IncrementBy(&store_buffer_entries_, count);
+  }
+  intptr_t store_buffer_entries() const { return store_buffer_entries_; }
+
+  // Ranges of copied but not yet scanned objects, shared between the tasks
+  // for load balancing.
+  void PushWork(uword start, uword end) {
+    ASSERT(start < end);
+    MutexLocker ml(&work_mutex_);
+    work_list_.Add(WorkRange(start, end));
+    AtomicOperations::StoreRelease(&work_list_length_, work_list_.length());
+  }
+  bool PopWork(uword* start, uword* end) {
+    if (WorkIsEmpty()) {
+      return false;
+    }
+    MutexLocker ml(&work_mutex_);
+    if (work_list_.is_empty()) {
+      return false;
+    }
+    WorkRange range = work_list_.RemoveLast();
+    AtomicOperations::StoreRelease(&work_list_length_, work_list_.length());
+    *start = range.start;
+    *end = range.end;
+    return true;
+  }
+  bool WorkIsEmpty() {
+    return AtomicOperations::LoadAcquire(&work_list_length_) == 0;
+  }
+
+  void AddBytesPromoted(intptr_t bytes) {
+    AtomicOperations::IncrementBy(&bytes_promoted_, bytes);
+  }
+  intptr_t bytes_promoted() const { return bytes_promoted_; }
+
+  // Protects merging the results of the tasks into the scavenger.
+  Mutex* results_mutex() { return &results_mutex_; }
+
+ private:
+  struct WorkRange {
+    WorkRange() : start(0), end(0) {}
+    WorkRange(uword start, uword end) : start(start), end(end) {}
+    uword start;
+    uword end;
+  };
+
+  intptr_t root_slices_not_started_;
+
+  Mutex blocks_mutex_;
+  StoreBufferBlock* pending_blocks_;
+  intptr_t store_buffer_entries_;
+
+  Mutex work_mutex_;
+  MallocGrowableArray<WorkRange> work_list_;
+  intptr_t work_list_length_;
+
+  intptr_t bytes_promoted_;
+  Mutex results_mutex_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelScavengerState);
+};
+
+template <bool parallel>
+class ScavengerVisitorBase : public ObjectPointerVisitor {
  public:
-  explicit ScavengerVisitor(Isolate* isolate,
-                            Scavenger* scavenger,
-                            SemiSpace* from)
+  explicit ScavengerVisitorBase(Isolate* isolate,
+                                Scavenger* scavenger,
+                                SemiSpace* from,
+                                ParallelScavengerState* state)
       : ObjectPointerVisitor(isolate),
         thread_(Thread::Current()),
         scavenger_(scavenger),
         from_(from),
         heap_(scavenger->heap_),
         page_space_(scavenger->heap_->old_space()),
+        state_(state),
+        delayed_weak_properties_(NULL),
         bytes_promoted_(0),
-        visiting_old_object_(NULL) {}
+        visiting_old_object_(NULL),
+        lab_top_(0),
+        lab_end_(0),
+        lab_scan_(0),
+        promo_lab_top_(0),
+        promo_lab_end_(0),
+        scan_(0),
+        scan_end_(0),
+        scanning_lab_(false) {
+    ASSERT(parallel == (state != NULL));
+  }
+
+  ~ScavengerVisitorBase() {
+#if !defined(PRODUCT)
+    free(promoted_stats_);
+#endif
+  }
 
   virtual void VisitTypedDataViewPointers(RawTypedDataView* view,
                                           RawObject** first,
@@ -161,6 +302,119 @@ class ScavengerVisitor : public ObjectPointerVisitor {
 
   intptr_t bytes_promoted() const { return bytes_promoted_; }
 
+  // Parallel scavenge only: scan everything this task has copied or
+  // promoted, then help the other tasks by stealing from the shared work
+  // list. Returns when no more work can be found.
+  void ProcessToSpace() {
+    ASSERT(parallel);
+    for (;;) {
+      // Finish the range we are currently scanning: a retired allocation
+      // buffer or a range stolen from another task.
+      while (scan_ < scan_end_) {
+        scan_ += ScanObject(RawObject::FromAddr(scan_));
+      }
+
+      // Scan the objects copied into our own allocation buffer. If the buffer
+      // is retired while we are scanning it, the remainder becomes the current
+      // range (see RetireLAB).
+      scanning_lab_ = true;
+      scan_ = lab_scan_;
+      while (scanning_lab_ && (scan_ < lab_top_)) {
+        scan_ += ScanObject(RawObject::FromAddr(scan_));
+      }
+      if (!scanning_lab_) {
+        continue;
+      }
+      scanning_lab_ = false;
+      lab_scan_ = scan_;
+      scan_end_ = scan_;
+
+      if (!promoted_.is_empty()) {
+        // Share a promoted object if the other tasks have run out of work.
+        if ((promoted_.length() > 1) && state_->WorkIsEmpty()) {
+          uword addr = promoted_.RemoveLast();
+          state_->PushWork(addr, addr + RawObject::FromAddr(addr)->HeapSize());
+        }
+        ScanObject(RawObject::FromAddr(promoted_.RemoveLast()));
+        continue;
+      }
+
+      uword start, end;
+      if (state_->PopWork(&start, &end)) {
+        scan_ = start;
+        scan_end_ = end;
+        continue;
+      }
+      return;
+    }
+  }
+
+  // Parallel scavenge only: revisit the weak properties whose keys were not
+  // reachable when they were scanned. Returns true if any of them became
+  // reachable since, which may have produced more work.
+  bool ProcessPendingWeakProperties() {
+    ASSERT(parallel);
+    bool more_to_scavenge = false;
+    RawWeakProperty* cur_weak = delayed_weak_properties_;
+    delayed_weak_properties_ = NULL;
+    while (cur_weak != NULL) {
+      uword next_weak = cur_weak->ptr()->next_;
+      ASSERT(cur_weak->IsNewObject());
+      RawObject* raw_key = cur_weak->ptr()->key_;
+      ASSERT(raw_key->IsHeapObject() && raw_key->IsNewObject());
+      uword raw_addr = RawObject::ToAddr(raw_key);
+      ASSERT(from_->Contains(raw_addr));
+      uword header =
+          AtomicOperations::LoadRelaxed(reinterpret_cast<uword*>(raw_addr));
+      // Reset the next pointer in the weak property.
+      cur_weak->ptr()->next_ = 0;
+      if (IsForwarding(header)) {
+        cur_weak->VisitPointersNonvirtual(this);
+        more_to_scavenge = true;
+      } else {
+        EnqueueWeakProperty(cur_weak);
+      }
+      cur_weak = reinterpret_cast<RawWeakProperty*>(next_weak);
+    }
+    return more_to_scavenge;
+  }
+
+  // Parallel scavenge only: make the unused part of our allocation buffer
+  // iterable and hand the results of this task to the scavenger.
+  void Finalize() {
+    ASSERT(parallel);
+    ASSERT(scan_ == scan_end_);
+    ASSERT(lab_scan_ == lab_top_);
+    ASSERT(promoted_.is_empty());
+    RetireLAB();
+    if (promo_lab_top_ < promo_lab_end_) {
+      page_space_->AcquireDataLock();
+      RetirePromoLABLocked();
+      page_space_->ReleaseDataLock();
+    }
+    state_->AddBytesPromoted(bytes_promoted_);
+    MutexLocker ml(state_->results_mutex());
+    while (delayed_weak_properties_ != NULL) {
+      RawWeakProperty* cur_weak = delayed_weak_properties_;
+      delayed_weak_properties_ =
+          reinterpret_cast<RawWeakProperty*>(cur_weak->ptr()->next_);
+      cur_weak->ptr()->next_ = 0;
+      scavenger_->EnqueueWeakProperty(cur_weak);
+    }
+#if !defined(PRODUCT)
+    if (promoted_stats_ != NULL) {
+      ClassTable* class_table = heap_->isolate()->class_table();
+      for (intptr_t cid = 0; cid < promoted_stats_length_; cid++) {
+        const intptr_t count = promoted_stats_[2 * cid];
+        if (count > 0) {
+          class_table->UpdateAllocatedOldGC(cid, promoted_stats_[2 * cid + 1],
+                                            count);
+        }
+      }
+    }
+#endif  // !defined(PRODUCT)
+  }
+
  private:
   void UpdateStoreBuffer(RawObject** p, RawObject* obj) {
     ASSERT(obj->IsHeapObject());
@@ -191,36 +445,57 @@ class ScavengerVisitor : public ObjectPointerVisitor {
     ASSERT(from_->Contains(raw_addr));
     // Read the header word of the object and determine if the object has
     // already been copied.
-    uword header = *reinterpret_cast<uword*>(raw_addr);
+    uword header =
+        parallel
+            ? AtomicOperations::LoadRelaxed(reinterpret_cast<uword*>(raw_addr))
+            : *reinterpret_cast<uword*>(raw_addr);
     uword new_addr = 0;
     if (IsForwarding(header)) {
       // Get the new location of the object.
       new_addr = ForwardedAddr(header);
     } else {
-      intptr_t size = raw_obj->HeapSize();
+      // Another task may replace the header with a forwarding pointer at any
+      // time, so the parallel scavenger sizes the object from the header it
+      // loaded above.
+      intptr_t size = parallel
+                          ? raw_obj->HeapSize(static_cast<uint32_t>(header))
+                          : raw_obj->HeapSize();
+      bool promoted = false;
       // Check whether object should be promoted.
-      if (scavenger_->survivor_end_ <= raw_addr) {
+      const bool is_survivor = raw_addr < scavenger_->survivor_end_;
+      const bool pretenure =
+          !is_survivor && scavenger_->ShouldPretenure(header);
+      if (!is_survivor && !pretenure) {
         // Not a survivor of a previous scavenge. Just copy the object into the
         // to space.
-        new_addr = scavenger_->AllocateGC(size);
+        new_addr = TryAllocateCopy(size);
       } else {
         // TODO(iposva): Experiment with less aggressive promotion. For example
         // a coin toss determines if an object is promoted or whether it should
         // survive in this generation.
         //
-        // This object is a survivor of a previous scavenge. Attempt to promote
-        // the object.
-        new_addr = page_space_->TryAllocatePromoLocked(size);
+        // This object is a survivor of a previous scavenge, or most objects
+        // of its class survive their first scavenge. Attempt to promote the
+        // object.
+        new_addr = TryAllocatePromo(size);
         if (new_addr != 0) {
           // If promotion succeeded then we need to remember it so that it can
           // be traversed later.
-          scavenger_->PushToPromotedStack(new_addr);
-          bytes_promoted_ += size;
+          promoted = true;
         } else {
           // Promotion did not succeed. Copy into the to space instead.
           scavenger_->failed_to_promote_ = true;
-          new_addr = scavenger_->AllocateGC(size);
+          new_addr = TryAllocateCopy(size);
+        }
+      }
+      if (parallel && (new_addr == 0)) {
+        // The to space can be exhausted by the unused tails of the allocation
+        // buffers. Promote the object instead.
+        new_addr = TryAllocatePromo(size);
+        if (new_addr == 0) {
+          OUT_OF_MEMORY();
         }
+        promoted = true;
       }
       // During a scavenge we always succeed to at least copy all of the
       // current objects to the to space.
@@ -232,7 +507,7 @@ class ScavengerVisitor : public ObjectPointerVisitor {
       RawObject* new_obj = RawObject::FromAddr(new_addr);
       if (new_obj->IsOldObject()) {
         // Promoted: update age/barrier tags.
-        uint32_t tags = new_obj->ptr()->tags_;
+        uint32_t tags = static_cast<uint32_t>(header);
         tags = RawObject::OldBit::update(true, tags);
         tags = RawObject::OldAndNotRememberedBit::update(true, tags);
         tags = RawObject::NewBit::update(false, tags);
@@ -244,6 +519,10 @@ class ScavengerVisitor : public ObjectPointerVisitor {
         tags =
             RawObject::OldAndNotMarkedBit::update(!thread_->is_marking(), tags);
         new_obj->ptr()->tags_ = tags;
+      } else if (parallel) {
+        // Our copy may have been made after another task already installed
+        // its forwarding pointer. Restore the header we decided on.
+        new_obj->ptr()->tags_ = static_cast<uint32_t>(header);
       }
 
       if (RawObject::IsTypedDataClassId(new_obj->GetClassId())) {
@@ -251,7 +530,28 @@ class ScavengerVisitor : public ObjectPointerVisitor {
       }
 
       // Remember forwarding address.
-      ForwardTo(raw_addr, new_addr);
+      if (parallel) {
+        ASSERT((new_addr & kForwardingMask) == 0);
+        uword forwarded = AtomicOperations::CompareAndSwapWord(
+            reinterpret_cast<uword*>(raw_addr), header, new_addr | kForwarded);
+        if (forwarded != header) {
+          // Another task copied this object first. Discard our copy.
+          ASSERT(IsForwarding(forwarded));
+          UndoAllocation(new_addr, size, promoted);
+          new_addr = ForwardedAddr(forwarded);
+          promoted = false;
+        }
+      } else {
+        ForwardTo(raw_addr, new_addr);
+      }
+      if (promoted) {
+        PushPromoted(new_addr);
+        // Pretenured objects were not promotion candidates. Leave them out
+        // of the early tenuring statistics.
+        if (!pretenure) {
+          bytes_promoted_ += size;
+        }
+      }
     }
     // Update the reference.
     RawObject* new_obj = RawObject::FromAddr(new_addr);
@@ -262,18 +562,226 @@ class ScavengerVisitor : public ObjectPointerVisitor {
     }
   }
 
+  DART_FORCE_INLINE
+  uword TryAllocateCopy(intptr_t size) {
+    if (!parallel) {
+      return scavenger_->AllocateGC(size);
+    }
+    if (static_cast<intptr_t>(lab_end_ - lab_top_) < size) {
+      RefillLAB(size);
+      if (static_cast<intptr_t>(lab_end_ - lab_top_) < size) {
+        return 0;
+      }
+    }
+    uword result = lab_top_;
+    lab_top_ += size;
+    return result;
+  }
+
+  DART_FORCE_INLINE
+  uword TryAllocatePromo(intptr_t size) {
+    if (!parallel) {
+      return page_space_->TryAllocatePromoLocked(size);
+    }
+    if (static_cast<intptr_t>(promo_lab_end_ - promo_lab_top_) >= size) {
+      uword result = promo_lab_top_;
+      promo_lab_top_ += size;
+      return result;
+    }
+    // The old space free list is shared by all tasks. Small objects refill
+    // the task's promotion buffer so most promotions skip the lock.
+    page_space_->AcquireDataLock();
+    uword result = 0;
+    if ((size <= kParallelScavengerMaxPromoLABObjectSize) &&
+        RefillPromoLABLocked()) {
+      result = promo_lab_top_;
+      promo_lab_top_ += size;
+    } else {
+      result = page_space_->TryAllocatePromoLocked(size);
+    }
+    page_space_->ReleaseDataLock();
+    return result;
+  }
+
+  bool RefillPromoLABLocked() {
+    ASSERT(parallel);
+    RetirePromoLABLocked();
+    uword start =
+        page_space_->TryAllocatePromoLocked(kParallelScavengerPromoLABSize);
+    if (start == 0) {
+      return false;
+    }
+    promo_lab_top_ = start;
+    promo_lab_end_ = start + kParallelScavengerPromoLABSize;
+    return true;
+  }
+
+  void RetirePromoLABLocked() {
+    ASSERT(parallel);
+    if (promo_lab_top_ < promo_lab_end_) {
+      page_space_->FreePromoLocked(promo_lab_top_,
+                                   promo_lab_end_ - promo_lab_top_);
+    }
+    promo_lab_top_ = promo_lab_end_ = 0;
+  }
+
+  void UndoAllocation(uword addr, intptr_t size, bool promoted) {
+    ASSERT(parallel);
+    if (!promoted && (addr + size == lab_top_)) {
+      lab_top_ = addr;
+      return;
+    }
+    if (promoted && (addr + size == promo_lab_top_)) {
+      promo_lab_top_ = addr;
+      return;
+    }
+    // Leave a filler so both spaces stay iterable. An unmarked filler in old
+    // space is reclaimed by the next sweep.
+    ForwardingCorpse::AsForwarder(addr, size);
+  }
+
+  void PushPromoted(uword addr) {
+    if (parallel) {
+      promoted_.Add(addr);
+    } else {
+      scavenger_->PushToPromotedStack(addr);
+    }
+  }
+
+  void RefillLAB(intptr_t size) {
+    ASSERT(parallel);
+    RetireLAB();
+    intptr_t lab_size = Utils::Maximum(size, kParallelScavengerLABSize);
+    uword start = scavenger_->TryAllocateGCParallel(lab_size);
+    if ((start == 0) && (lab_size > size)) {
+      lab_size = size;
+      start = scavenger_->TryAllocateGCParallel(lab_size);
+    }
+    if (start == 0) {
+      return;
+    }
+    lab_top_ = start;
+    lab_end_ = start + lab_size;
+    lab_scan_ = start;
+  }
+
+  void RetireLAB() {
+    ASSERT(parallel);
+    if (scanning_lab_) {
+      // We are in the middle of scanning this buffer. Finish it as the
+      // current range.
+      scan_end_ = lab_top_;
+      scanning_lab_ = false;
+    } else if (lab_scan_ < lab_top_) {
+      // Nothing in this buffer has been scanned yet. Share it.
+      state_->PushWork(lab_scan_, lab_top_);
+    }
+    if (lab_top_ < lab_end_) {
+      ForwardingCorpse::AsForwarder(lab_top_, lab_end_ - lab_top_);
+    }
+    lab_top_ = lab_end_ = lab_scan_ = 0;
+  }
+
+  intptr_t ScanObject(RawObject* raw_obj) {
+    ASSERT(parallel);
+    if (raw_obj->IsNewObject()) {
+      if (raw_obj->GetClassId() == kWeakPropertyCid) {
+        return ProcessWeakProperty(reinterpret_cast<RawWeakProperty*>(raw_obj));
+      }
+      return raw_obj->VisitPointersNonvirtual(this);
+    }
+    // A promoted object. Promoted weak properties are not enqueued, their
+    // keys and values are kept alive.
+    ASSERT(!raw_obj->IsRemembered());
+    VisitingOldObject(raw_obj);
+    intptr_t size = raw_obj->VisitPointersNonvirtual(this);
+    VisitingOldObject(NULL);
+#if !defined(PRODUCT)
+    UpdatePromotedStats(raw_obj->GetClassId(), size);
+#endif
+    if (raw_obj->IsMarked()) {
+      // Complete our promise from ScavengePointer. See
+      // Scavenger::ProcessToSpace.
+      thread_->MarkingStackAddObject(raw_obj);
+    }
+    return size;
+  }
+
+  intptr_t ProcessWeakProperty(RawWeakProperty* raw_weak) {
+    ASSERT(parallel);
+    // The fate of the weak property is determined by its key.
+    RawObject* raw_key = raw_weak->ptr()->key_;
+    if (raw_key->IsHeapObject() && raw_key->IsNewObject()) {
+      uword raw_addr = RawObject::ToAddr(raw_key);
+      uword header =
+          AtomicOperations::LoadRelaxed(reinterpret_cast<uword*>(raw_addr));
+      if (!IsForwarding(header)) {
+        // Key is white.  Enqueue the weak property.
+        EnqueueWeakProperty(raw_weak);
+        return raw_weak->HeapSize();
+      }
+    }
+    // Key is gray or black.  Make the weak property black.
+    return raw_weak->VisitPointersNonvirtual(this);
+  }
+
+  void EnqueueWeakProperty(RawWeakProperty* raw_weak) {
+    ASSERT(parallel);
+    ASSERT(raw_weak->IsNewObject());
+    ASSERT(raw_weak->ptr()->next_ == 0);
+    raw_weak->ptr()->next_ = reinterpret_cast<uword>(delayed_weak_properties_);
+    delayed_weak_properties_ = raw_weak;
+  }
+
+#if !defined(PRODUCT)
+  void UpdatePromotedStats(intptr_t cid, intptr_t size) {
+    if (promoted_stats_ == NULL) {
+      promoted_stats_length_ = heap_->isolate()->class_table()->NumCids();
+      promoted_stats_ = reinterpret_cast<intptr_t*>(
+          calloc(2 * promoted_stats_length_, sizeof(intptr_t)));
+    }
+    if (cid < promoted_stats_length_) {
+      promoted_stats_[2 * cid] += 1;
+      promoted_stats_[2 * cid + 1] += size;
+    }
+  }
+
+  // Pairs of (count, size) per class id, merged into the class table by
+  // Finalize. Only used by the parallel scavenger.
+  intptr_t* promoted_stats_ = NULL;
+  intptr_t promoted_stats_length_ = 0;
+#endif  // !defined(PRODUCT)
+
   Thread* thread_;
   Scavenger* scavenger_;
   SemiSpace* from_;
   Heap* heap_;
   PageSpace* page_space_;
+  ParallelScavengerState* state_;
   RawWeakProperty* delayed_weak_properties_;
   intptr_t bytes_promoted_;
   RawObject* visiting_old_object_;
 
+  // Parallel scavenge only. The task's allocation buffer in the to space;
+  // objects in [lab_scan_, lab_top_) are copied but not yet scanned.
+  uword lab_top_;
+  uword lab_end_;
+  uword lab_scan_;
+  // Parallel scavenge only. The task's promotion buffer in the old space,
+  // returned to the free list when the task finishes.
+  uword promo_lab_top_;
+  uword promo_lab_end_;
+  // The range of copied objects being scanned.
+  uword scan_;
+  uword scan_end_;
+  // Whether scan_ currently points into the allocation buffer.
+  bool scanning_lab_;
+  // Promoted objects whose slots have not been scanned yet.
+  MallocGrowableArray<uword> promoted_;
+
   friend class Scavenger;
 
-  DISALLOW_COPY_AND_ASSIGN(ScavengerVisitor);
+  DISALLOW_COPY_AND_ASSIGN(ScavengerVisitorBase);
 };
 
 class ScavengerWeakVisitor : public HandleVisitor {
@@ -362,11 +870,15 @@ void SemiSpace::Cleanup() {
 }
 
 SemiSpace* SemiSpace::New(intptr_t size_in_words, const char* name) {
+  size_in_words = Utils::RoundUp(size_in_words, kPageSizeInWords);
   SemiSpace* result = nullptr;
   {
     MutexLocker locker(mutex_);
-    // TODO(koda): Cache one entry per size.
-    if (cache_ != nullptr && cache_->size_in_words() == size_in_words) {
+    // A cached space whose reservation is large enough is reused with the
+    // requested capacity.
+    if ((cache_ != nullptr) && (size_in_words > 0) &&
+        (cache_->reserved_ != nullptr) &&
+        ((cache_->reserved_->size() >> kWordSizeLog2) >= size_in_words)) {
       result = cache_;
       cache_ = nullptr;
     }
@@ -375,6 +887,7 @@ SemiSpace* SemiSpace::New(intptr_t size_in_words, const char* name) {
 #ifdef DEBUG
     result->reserved_->Protect(VirtualMemory::kReadWrite);
 #endif
+    result->SetCapacity(size_in_words);
     return result;
   }
 
@@ -383,8 +896,13 @@ SemiSpace* SemiSpace::New(intptr_t size_in_words, const char* name) {
   } else {
     intptr_t size_in_bytes = size_in_words << kWordSizeLog2;
     const bool kExecutable = false;
+#if defined(DART_HEAP_CAGE)
+    VirtualMemory* memory =
+        VirtualMemory::AllocateInHeapCage(size_in_bytes, kExecutable, name);
+#else
     VirtualMemory* memory =
         VirtualMemory::Allocate(size_in_bytes, kExecutable, name);
+#endif
     if (memory == nullptr) {
       // TODO(koda): If cache_ is not empty, we could try to delete it.
       return nullptr;
@@ -413,6 +931,22 @@ void SemiSpace::Delete() {
   delete old_cache;
 }
 
+void SemiSpace::SetCapacity(intptr_t size_in_words) {
+  ASSERT(reserved_ != nullptr);
+  ASSERT(Utils::IsAligned(size_in_words, kPageSizeInWords));
+  const intptr_t size_in_bytes = size_in_words << kWordSizeLog2;
+  ASSERT(size_in_bytes <= reserved_->size());
+  const intptr_t old_size_in_bytes = region_.size();
+  if (size_in_bytes < old_size_in_bytes) {
+    // Give the pages beyond the new capacity back to the OS. The pages beyond
+    // the old capacity were already given back.
+    VirtualMemory::DontNeed(
+        reinterpret_cast<void*>(reserved_->start() + size_in_bytes),
+        old_size_in_bytes - size_in_bytes);
+  }
+  region_ = MemoryRegion(reserved_->address(), size_in_bytes);
+}
+
 void SemiSpace::WriteProtect(bool read_only) {
   if (reserved_ != NULL) {
     reserved_->Protect(read_only ? VirtualMemory::kReadOnly
@@ -431,6 +965,7 @@ Scavenger::Scavenger(Heap* heap,
                      uword object_alignment)
     : heap_(heap),
       max_semi_capacity_in_words_(max_semi_capacity_in_words),
+      min_semi_capacity_in_words_(0),
       object_alignment_(object_alignment),
       scavenging_(false),
       delayed_weak_properties_(NULL),
@@ -447,6 +982,8 @@ Scavenger::Scavenger(Heap* heap,
   // Set initial semi space size in words.
   const intptr_t initial_semi_capacity_in_words = Utils::Minimum(
       max_semi_capacity_in_words, FLAG_new_gen_semi_initial_size * MBInWords);
+  // New space does not shrink below its initial size.
+  min_semi_capacity_in_words_ = initial_semi_capacity_in_words;
 
   const intptr_t kVmNameSize = 128;
   char vm_name[kVmNameSize];
@@ -476,13 +1013,31 @@ intptr_t Scavenger::NewSizeInWords(intptr_t old_size_in_words) const {
   if (stats_history_.Size() == 0) {
     return old_size_in_words;
   }
-  double garbage = stats_history_.Get(0).ExpectedGarbageFraction();
+  // The capacity at which the last scavenge's survivors would have left the
+  // threshold fraction of garbage.
+  const double garbage = stats_history_.Get(0).ExpectedGarbageFraction();
+  const double survival = 1.0 - garbage;
+  const double target_survival = 1.0 - (FLAG_new_gen_garbage_threshold / 100.0);
+  const intptr_t target_size_in_words =
+      static_cast<intptr_t>(old_size_in_words * (survival / target_survival));
+  intptr_t new_size_in_words = old_size_in_words;
   if (garbage < (FLAG_new_gen_garbage_threshold / 100.0)) {
-    return Utils::Minimum(max_semi_capacity_in_words_,
-                          old_size_in_words * FLAG_new_gen_growth_factor);
-  } else {
-    return old_size_in_words;
+    // Grow towards the target, by at most the growth factor.
+    new_size_in_words =
+        Utils::Minimum(old_size_in_words * FLAG_new_gen_growth_factor,
+                       target_size_in_words);
+  } else if (target_size_in_words < (old_size_in_words / 2)) {
+    // Shrink in small steps, so a short quiet phase does not make the next
+    // busy one scavenge too often.
+    new_size_in_words =
+        Utils::Maximum(old_size_in_words - (old_size_in_words / 8),
+                       target_size_in_words);
   }
+  new_size_in_words = Utils::RoundUp(new_size_in_words,
+                                     SemiSpace::kPageSizeInWords);
+  new_size_in_words =
+      Utils::Maximum(new_size_in_words, min_semi_capacity_in_words_);
+  return Utils::Minimum(new_size_in_words, max_semi_capacity_in_words_);
 }
 
 SemiSpace* Scavenger::Prologue(Isolate* isolate) {
@@ -581,7 +1136,7 @@ void Scavenger::Epilogue(Isolate* isolate, SemiSpace* from) {
   {
     PageSpace* page_space = heap_->old_space();
     MonitorLocker ml(page_space->tasks_lock());
-    if (page_space->tasks() == 0) {
+    if ((page_space->tasks() == 0) && !page_space->HasUnsweptPages()) {
       VerifyStoreBufferPointerVisitor verify_store_buffer_visitor(isolate, to_);
       heap_->old_space()->VisitObjectPointers(&verify_store_buffer_visitor);
     }
@@ -613,7 +1168,7 @@ bool Scavenger::ShouldPerformIdleScavenge(int64_t deadline) {
 }
 
 void Scavenger::IterateStoreBuffers(Isolate* isolate,
-                                    ScavengerVisitor* visitor) {
+                                    SerialScavengerVisitor* visitor) {
   // Iterating through the store buffers.
   // Grab the deduplication sets out of the isolate's consolidated store buffer.
   StoreBufferBlock* pending = isolate->store_buffer()->Blocks();
@@ -649,7 +1204,7 @@ void Scavenger::IterateStoreBuffers(Isolate* isolate,
 }
 
 void Scavenger::IterateObjectIdTable(Isolate* isolate,
-                                     ScavengerVisitor* visitor) {
+                                     ObjectPointerVisitor* visitor) {
 #ifndef PRODUCT
   if (!FLAG_support_service) {
     return;
@@ -658,7 +1213,8 @@ void Scavenger::IterateObjectIdTable(Isolate* isolate,
 #endif  // !PRODUCT
 }
 
-void Scavenger::IterateRoots(Isolate* isolate, ScavengerVisitor* visitor) {
+void Scavenger::IterateRoots(Isolate* isolate,
+                             SerialScavengerVisitor* visitor) {
 #ifdef SUPPORT_TIMELINE
   Thread* thread = Thread::Current();
 #endif
@@ -681,6 +1237,245 @@ void Scavenger::IterateRoots(Isolate* isolate, ScavengerVisitor* visitor) {
   heap_->RecordTime(kDummyScavengeTime, 0);
 }
 
+void Scavenger::IterateRootSlices(Isolate* isolate,
+                                  ParallelScavengerState* state,
+                                  ParallelScavengerVisitor* visitor) {
+  for (;;) {
+    intptr_t slice = state->ClaimRootSlice();
+    if (slice < 0) {
+      break;  // No more slices.
+    }
+    switch (slice) {
+      case ParallelScavengerState::kIsolateRoots: {
+        TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "ProcessRoots");
+        isolate->VisitObjectPointers(visitor,
+                                     ValidationPolicy::kDontValidateFrames);
+        break;
+      }
+      case ParallelScavengerState::kRememberedCards: {
+        TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "ProcessCards");
+        heap_->old_space()->VisitRememberedCards(visitor);
+        break;
+      }
+      case ParallelScavengerState::kObjectIdRing: {
+        IterateObjectIdTable(isolate, visitor);
+        break;
+      }
+      default:
+        FATAL1("%" Pd, slice);
+        UNREACHABLE();
+    }
+  }
+
+  // The blocks of the store buffer are distributed between the tasks.
+  StoreBufferBlock* pending = state->PopStoreBufferBlock();
+  while (pending != NULL) {
+    // Generated code appends to store buffers; tell MemorySanitizer.
+    MSAN_UNPOISON(pending, sizeof(*pending));
+    state->AddStoreBufferEntries(pending->Count());
+    while (!pending->IsEmpty()) {
+      RawObject* raw_object = pending->Pop();
+      ASSERT(!raw_object->IsForwardingCorpse());
+      ASSERT(raw_object->IsRemembered());
+      raw_object->ClearRememberedBit();
+      visitor->VisitingOldObject(raw_object);
+      raw_object->VisitPointersNonvirtual(visitor);
+    }
+    pending->Reset();
+    // Return the emptied block for recycling (no need to check threshold).
+    isolate->store_buffer()->PushBlock(pending, StoreBuffer::kIgnoreThreshold);
+    pending = state->PopStoreBufferBlock();
+  }
+  visitor->VisitingOldObject(NULL);
+}
+
+class ParallelScavengerTask : public ThreadPool::Task {
+ public:
+  ParallelScavengerTask(Isolate* isolate,
+                        Scavenger* scavenger,
+                        SemiSpace* from,
+                        ParallelScavengerState* state,
+                        ThreadBarrier* barrier,
+                        uintptr_t* num_busy)
+      : isolate_(isolate),
+        scavenger_(scavenger),
+        from_(from),
+        state_(state),
+        barrier_(barrier),
+        num_busy_(num_busy) {}
+
+  virtual void Run() {
+    bool result =
+        Thread::EnterIsolateAsHelper(isolate_, Thread::kScavengerTask, true);
+    ASSERT(result);
+    {
+      TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "ParallelScavenge");
+      ParallelScavengerVisitor visitor(isolate_, scavenger_, from_, state_);
+
+      // Phase 1: Split the roots between the tasks.
+      scavenger_->IterateRootSlices(isolate_, state_, &visitor);
+
+      // Phase 2: Process the to space until no task can find more work.
+      bool more_to_scavenge = false;
+      do {
+        do {
+          visitor.ProcessToSpace();
+
+          // I can't find more work right now. If no other task is busy,
+          // then there will never be more work (NB: 1 is *before* decrement).
+          if (AtomicOperations::FetchAndDecrement(num_busy_) == 1) break;
+
+          // Wait for some work to appear.
+          while (state_->WorkIsEmpty() &&
+                 (AtomicOperations::LoadRelaxed(num_busy_) > 0)) {
+          }
+
+          // If no tasks are busy, there will never be more work.
+          if (AtomicOperations::LoadRelaxed(num_busy_) == 0) break;
+
+          // I saw some work; get busy and compete for it.
+          AtomicOperations::FetchAndIncrement(num_busy_);
+        } while (true);
+        // Wait for all scavengers to stop.
+        barrier_->Sync();
+#if defined(DEBUG)
+        ASSERT(AtomicOperations::LoadRelaxed(num_busy_) == 0);
+        // Caveat: must not allow any task to continue past the barrier
+        // before we checked num_busy, otherwise one of them might rush
+        // ahead and increment it.
+        barrier_->Sync();
+#endif
+        // Check if we have any pending weak properties whose keys were
+        // copied in the meantime, possibly by another task.
+        more_to_scavenge = visitor.ProcessPendingWeakProperties();
+        if (more_to_scavenge) {
+          // We have more work to do. Notify others.
+          AtomicOperations::FetchAndIncrement(num_busy_);
+        }
+
+        // Wait for all other tasks to finish processing their pending weak
+        // properties and decide if they need to continue scavenging.
+        // Caveat: we need two barriers here to make this decision in lock step
+        // between all tasks and the main thread.
+        barrier_->Sync();
+        if (!more_to_scavenge &&
+            (AtomicOperations::LoadRelaxed(num_busy_) > 0)) {
+          // All tasks continue to scavenge as long as any single task has
+          // some work to do.
+          AtomicOperations::FetchAndIncrement(num_busy_);
+          more_to_scavenge = true;
+        }
+        barrier_->Sync();
+      } while (more_to_scavenge);
+
+      // Phase 3: Hand the results of this task to the scavenger.
+      visitor.Finalize();
+    }
+    Thread::ExitIsolateAsHelper(true);
+
+    // This task is done. Notify the original thread.
+    barrier_->Exit();
+  }
+
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kHighPriority;
+  }
+
+ private:
+  Isolate* isolate_;
+  Scavenger* scavenger_;
+  SemiSpace* from_;
+  ParallelScavengerState* state_;
+  ThreadBarrier* barrier_;
+  uintptr_t* num_busy_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelScavengerTask);
+};
+
+intptr_t Scavenger::ParallelScavenge(Isolate* isolate, SemiSpace* from) {
+  const intptr_t num_tasks = FLAG_scavenger_tasks;
+  ASSERT(num_tasks > 0);
+
+  // Grab the store buffer blocks before any task can append to it.
+  ParallelScavengerState state(isolate->store_buffer()->Blocks());
+  {
+    ThreadBarrier barrier(num_tasks + 1, heap_->barrier(),
+                          heap_->barrier_done());
+    // Used to coordinate draining among tasks; all start out as 'busy'.
+    uintptr_t num_busy = num_tasks;
+    for (intptr_t i = 0; i < num_tasks; i++) {
+      bool result = Dart::thread_pool()->Run<ParallelScavengerTask>(
+          isolate, this, from, &state, &barrier, &num_busy);
+      ASSERT(result);
+    }
+    bool more_to_scavenge = false;
+    do {
+      // Wait for all tasks to stop.
+      barrier.Sync();
+#if defined(DEBUG)
+      ASSERT(AtomicOperations::LoadRelaxed(&num_busy) == 0);
+      // Caveat: must not allow any task to continue past the barrier
+      // before we checked num_busy, otherwise one of them might rush
+      // ahead and increment it.
+      barrier.Sync();
+#endif
+      // Wait for all tasks to go through their weak properties and verify
+      // that there is nothing more to scavenge.
+      barrier.Sync();
+      more_to_scavenge = AtomicOperations::LoadRelaxed(&num_busy) > 0;
+      barrier.Sync();
+    } while (more_to_scavenge);
+    barrier.Exit();
+  }
+  resolved_top_ = top_;
+
+#if !defined(PRODUCT)
+  // The tasks do not maintain the per-class statistics of new space; collect
+  // them from the surviving objects.
+  ClassTable* class_table = isolate->class_table();
+  uword cur = FirstObjectStart();
+  while (cur < top_) {
+    RawObject* raw_obj = RawObject::FromAddr(cur);
+    const intptr_t size = raw_obj->HeapSize();
+    const intptr_t class_id = raw_obj->GetClassId();
+    if (class_id != kForwardingCorpse) {
+      class_table->UpdateLiveNewGC(class_id, size);
+    }
+    cur += size;
+  }
+#endif  // !defined(PRODUCT)
+
+  heap_->RecordData(kStoreBufferEntries, state.store_buffer_entries());
+  heap_->RecordData(kDataUnused1, 0);
+  heap_->RecordData(kDataUnused2, 0);
+  heap_->RecordData(kToKBAfterStoreBuffer, RoundWordsToKB(UsedInWords()));
+  // Roots are scanned by the tasks together with the to space.
+  heap_->RecordTime(kVisitIsolateRoots, 0);
+  heap_->RecordTime(kIterateStoreBuffers, 0);
+  heap_->RecordTime(kDummyScavengeTime, 0);
+  return state.bytes_promoted();
+}
+
+uword Scavenger::TryAllocateGCParallel(intptr_t size) {
+  ASSERT(Utils::IsAligned(size, kObjectAlignment));
+  ASSERT(scavenging_);
+  uword result = AtomicOperations::LoadRelaxed(&top_);
+  for (;;) {
+    if (static_cast<intptr_t>(end_ - result) < size) {
+      return 0;
+    }
+    uword old_top =
+        AtomicOperations::CompareAndSwapWord(&top_, result, result + size);
+    if (old_top == result) {
+      break;
+    }
+    result = old_top;
+  }
+  ASSERT(to_->Contains(result));
+  ASSERT((result & kObjectAlignmentMask) == object_alignment_);
+  return result;
+}
+
 bool Scavenger::IsUnreachable(RawObject** p) {
   RawObject* raw_obj = *p;
   if (!raw_obj->IsHeapObject()) {
@@ -706,7 +1501,7 @@ void Scavenger::IterateWeakRoots(Isolate* isolate, HandleVisitor* visitor) {
   isolate->VisitWeakPersistentHandles(visitor);
 }
 
-void Scavenger::ProcessToSpace(ScavengerVisitor* visitor) {
+void Scavenger::ProcessToSpace(SerialScavengerVisitor* visitor) {
   Thread* thread = Thread::Current();
   NOT_IN_PRODUCT(ClassTable* class_table = thread->isolate()->class_table());
 
@@ -830,7 +1625,7 @@ void Scavenger::EnqueueWeakProperty(RawWeakProperty* raw_weak) {
 }
 
 uword Scavenger::ProcessWeakProperty(RawWeakProperty* raw_weak,
-                                     ScavengerVisitor* visitor) {
+                                     SerialScavengerVisitor* visitor) {
   // The fate of the weak property is determined by its key.
   RawObject* raw_key = raw_weak->ptr()->key_;
   if (raw_key->IsHeapObject() && raw_key->IsNewObject()) {
@@ -851,6 +1646,7 @@ void Scavenger::ProcessWeakReferences() {
   for (int sel = 0; sel < Heap::kNumWeakSelectors; sel++) {
     WeakTable* table =
         heap_->GetWeakTable(Heap::kNew, static_cast<Heap::WeakSelector>(sel));
+    table->FinishRehash();
     heap_->SetWeakTable(Heap::kNew, static_cast<Heap::WeakSelector>(sel),
                         WeakTable::NewFrom(table));
     intptr_t size = table->size();
@@ -1033,6 +1829,7 @@ void Scavenger::Scavenge() {
 
   int64_t safe_point = OS::GetCurrentMonotonicMicros();
   heap_->RecordTime(kSafePoint, safe_point - start);
+  heap_->RecordPause(Heap::kSafepointPause, safe_point - start);
 
   // TODO(koda): Make verification more compatible with concurrent sweep.
   if (FLAG_verify_before_gc && !FLAG_concurrent_sweep) {
@@ -1045,19 +1842,34 @@ void Scavenger::Scavenge() {
   SpaceUsage usage_before = GetCurrentUsage();
   intptr_t promo_candidate_words =
       (survivor_end_ - FirstObjectStart()) / kWordSize;
+  const bool sample_pretenure_feedback =
+      (FLAG_pretenure_sample_interval > 0) &&
+      ((collections_ % FLAG_pretenure_sample_interval) == 0);
+  const uword from_survivor_end = survivor_end_;
+  const uword from_top = top_;
   SemiSpace* from = Prologue(isolate);
   // The API prologue/epilogue may create/destroy zones, so we must not
   // depend on zone allocations surviving beyond the epilogue callback.
   {
     StackZone zone(thread);
-    // Setup the visitor and run the scavenge.
-    ScavengerVisitor visitor(isolate, this, from);
-    page_space->AcquireDataLock();
-    IterateRoots(isolate, &visitor);
-    int64_t iterate_roots = OS::GetCurrentMonotonicMicros();
-    {
-      TIMELINE_FUNCTION_GC_DURATION(thread, "ProcessToSpace");
-      ProcessToSpace(&visitor);
+    intptr_t bytes_promoted = 0;
+    int64_t iterate_roots = 0;
+    if (FLAG_scavenger_tasks > 0) {
+      iterate_roots = OS::GetCurrentMonotonicMicros();
+      // The tasks take the data lock whenever they promote.
+      bytes_promoted = ParallelScavenge(isolate, from);
+      page_space->AcquireDataLock();
+    } else {
+      // Setup the visitor and run the scavenge.
+      SerialScavengerVisitor visitor(isolate, this, from, NULL);
+      page_space->AcquireDataLock();
+      IterateRoots(isolate, &visitor);
+      iterate_roots = OS::GetCurrentMonotonicMicros();
+      {
+        TIMELINE_FUNCTION_GC_DURATION(thread, "ProcessToSpace");
+        ProcessToSpace(&visitor);
+      }
+      bytes_promoted = visitor.bytes_promoted();
     }
     int64_t process_to_space = OS::GetCurrentMonotonicMicros();
     {
@@ -1074,7 +1886,11 @@ void Scavenger::Scavenge() {
     heap_->RecordTime(kIterateWeaks, end - process_to_space);
     stats_history_.Add(ScavengeStats(
         start, end, usage_before, GetCurrentUsage(), promo_candidate_words,
-        visitor.bytes_promoted() >> kWordSizeLog2));
+        bytes_promoted >> kWordSizeLog2));
+  }
+  if (sample_pretenure_feedback) {
+    TIMELINE_FUNCTION_GC_DURATION(thread, "SamplePretenureFeedback");
+    SamplePretenureFeedback(from_survivor_end, from_top);
   }
   Epilogue(isolate, from);
 
@@ -1090,6 +1906,46 @@ void Scavenger::Scavenge() {
   scavenging_ = false;
 }
 
+void Scavenger::SamplePretenureFeedback(uword start, uword end) {
+  // The headers of the surviving objects forward to their copies, the dead
+  // objects are intact.
+  uword cur = start;
+  while (cur < end) {
+    uword header = *reinterpret_cast<uword*>(cur);
+    RawObject* raw_obj = IsForwarding(header)
+                             ? RawObject::FromAddr(ForwardedAddr(header))
+                             : RawObject::FromAddr(cur);
+    intptr_t size = raw_obj->HeapSize();
+    cur += size;
+    intptr_t cid = raw_obj->GetClassId();
+    if ((cid == kForwardingCorpse) || (cid == kFreeListElement)) {
+      continue;
+    }
+    while (pretenure_feedback_.length() <= cid) {
+      pretenure_feedback_.Add(PretenureFeedback());
+    }
+    pretenure_feedback_[cid].allocated_in_words += size >> kWordSizeLog2;
+    if (IsForwarding(header)) {
+      pretenure_feedback_[cid].survived_in_words += size >> kWordSizeLog2;
+    }
+  }
+
+  // Only decide once a class has allocated enough to be worth it, and decay
+  // the counts so the decisions follow phase changes of the program.
+  const intptr_t kMinSampleInWords = 64 * KBInWords;
+  for (intptr_t cid = 0; cid < pretenure_feedback_.length(); cid++) {
+    PretenureFeedback* feedback = &pretenure_feedback_[cid];
+    if (feedback->allocated_in_words < kMinSampleInWords) {
+      continue;
+    }
+    feedback->pretenure = (feedback->survived_in_words * 100) >
+                          (feedback->allocated_in_words *
+                           FLAG_pretenure_survival_threshold);
+    feedback->allocated_in_words /= 2;
+    feedback->survived_in_words /= 2;
+  }
+}
+
 void Scavenger::WriteProtect(bool read_only) {
   ASSERT(!scavenging_);
   to_->WriteProtect(read_only);
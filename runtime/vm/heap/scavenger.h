@@ -10,6 +10,7 @@
 #include "vm/dart.h"
 #include "vm/flags.h"
 #include "vm/globals.h"
+#include "vm/growable_array.h"
 #include "vm/heap/spaces.h"
 #include "vm/lockers.h"
 #include "vm/raw_object.h"
@@ -24,11 +25,19 @@ class Heap;
 class Isolate;
 class JSONObject;
 class ObjectSet;
-class ScavengerVisitor;
+class ParallelScavengerState;
+template <bool parallel>
+class ScavengerVisitorBase;
+typedef ScavengerVisitorBase<false> SerialScavengerVisitor;
+typedef ScavengerVisitorBase<true> ParallelScavengerVisitor;
 
 // Wrapper around VirtualMemory that adds caching and handles the empty case.
+// The capacity of a space is a whole number of pages, and may be less than its
+// reservation when a cached space is reused for a smaller new space.
 class SemiSpace {
  public:
+  static const intptr_t kPageSizeInWords = 256 * KBInWords;
+
   static void Init();
   static void Cleanup();
 
@@ -58,6 +67,10 @@ class SemiSpace {
   explicit SemiSpace(VirtualMemory* reserved);
   ~SemiSpace();
 
+  // Uses the first 'size_in_words' of the reservation and gives the rest of
+  // it back to the OS.
+  void SetCapacity(intptr_t size_in_words);
+
   VirtualMemory* reserved_;  // NULL for an empty space.
   MemoryRegion region_;
 
@@ -220,6 +233,15 @@ class Scavenger {
   int64_t FreeSpaceInWords(Isolate* isolate) const;
   void AbandonTLABs(Isolate* isolate);
 
+  // Whether the object with the given header is promoted at its first
+  // scavenge because most objects of its class survive it.
+  bool ShouldPretenure(uword header) const {
+    const intptr_t cid =
+        RawObject::ClassIdTag::decode(static_cast<uint32_t>(header));
+    return (cid < pretenure_feedback_.length()) &&
+           pretenure_feedback_[cid].pretenure;
+  }
+
  private:
   // Ids for time and data records in Heap::GCStats.
   enum {
@@ -239,18 +261,27 @@ class Scavenger {
 
   uword FirstObjectStart() const { return to_->start() | object_alignment_; }
   SemiSpace* Prologue(Isolate* isolate);
-  void IterateStoreBuffers(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateObjectIdTable(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateRoots(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateWeakProperties(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateWeakReferences(Isolate* isolate, ScavengerVisitor* visitor);
+  void IterateStoreBuffers(Isolate* isolate, SerialScavengerVisitor* visitor);
+  void IterateObjectIdTable(Isolate* isolate, ObjectPointerVisitor* visitor);
+  void IterateRoots(Isolate* isolate, SerialScavengerVisitor* visitor);
   void IterateWeakRoots(Isolate* isolate, HandleVisitor* visitor);
-  void ProcessToSpace(ScavengerVisitor* visitor);
+  void ProcessToSpace(SerialScavengerVisitor* visitor);
   void EnqueueWeakProperty(RawWeakProperty* raw_weak);
   uword ProcessWeakProperty(RawWeakProperty* raw_weak,
-                            ScavengerVisitor* visitor);
+                            SerialScavengerVisitor* visitor);
   void Epilogue(Isolate* isolate, SemiSpace* from);
 
+  // Scans the roots and processes the to space using FLAG_scavenger_tasks
+  // helper tasks. Returns the number of bytes promoted.
+  intptr_t ParallelScavenge(Isolate* isolate, SemiSpace* from);
+  void IterateRootSlices(Isolate* isolate,
+                         ParallelScavengerState* state,
+                         ParallelScavengerVisitor* visitor);
+  // Thread-safe bump allocation in the to space used by the parallel
+  // scavenger to carve out allocation buffers. Returns 0 if the to space is
+  // exhausted.
+  uword TryAllocateGCParallel(intptr_t size);
+
   bool IsUnreachable(RawObject** p);
 
   // During a scavenge we need to remember the promoted objects.
@@ -280,6 +311,11 @@ class Scavenger {
 
   void ProcessWeakReferences();
 
+  // Records which of the objects allocated since the previous scavenge in
+  // [start, end) of the from space survived, and updates the classes
+  // selected for pretenuring.
+  void SamplePretenureFeedback(uword start, uword end);
+
   intptr_t NewSizeInWords(intptr_t old_size_in_words) const;
 
   uword top_;
@@ -297,6 +333,7 @@ class Scavenger {
   uword survivor_end_;
 
   intptr_t max_semi_capacity_in_words_;
+  intptr_t min_semi_capacity_in_words_;
 
   // All object are aligned to this value.
   uword object_alignment_;
@@ -320,11 +357,25 @@ class Scavenger {
 
   bool failed_to_promote_;
 
+  // Sampled survival of the objects of each class at their first scavenge,
+  // indexed by class id. See FLAG_pretenure_sample_interval.
+  struct PretenureFeedback {
+    PretenureFeedback()
+        : allocated_in_words(0), survived_in_words(0), pretenure(false) {}
+
+    intptr_t allocated_in_words;
+    intptr_t survived_in_words;
+    bool pretenure;
+  };
+  MallocGrowableArray<PretenureFeedback> pretenure_feedback_;
+
   // Protects new space during the allocation of new TLABs
   Mutex space_lock_;
 
-  friend class ScavengerVisitor;
+  template <bool>
+  friend class ScavengerVisitorBase;
   friend class ScavengerWeakVisitor;
+  friend class ParallelScavengerTask;
 
   DISALLOW_COPY_AND_ASSIGN(Scavenger);
 };
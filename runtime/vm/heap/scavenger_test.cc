@@ -35,4 +35,21 @@ class FailingFindObjectVisitor : public FindObjectVisitor {
   }
 };
 
+VM_UNIT_TEST_CASE(SemiSpaceReuseWithSmallerCapacity) {
+  SemiSpace* space = SemiSpace::New(4 * SemiSpace::kPageSizeInWords, NULL);
+  EXPECT_EQ(4 * SemiSpace::kPageSizeInWords, space->size_in_words());
+  uword start = space->start();
+  space->Delete();
+
+  // The cached space is reused, and sizes are rounded up to whole pages.
+  space = SemiSpace::New(SemiSpace::kPageSizeInWords + 1, NULL);
+  EXPECT_EQ(start, space->start());
+  EXPECT_EQ(2 * SemiSpace::kPageSizeInWords, space->size_in_words());
+  EXPECT(space->Contains(start + SemiSpace::kPageSizeInWords * kWordSize));
+  EXPECT(!space->Contains(start + 2 * SemiSpace::kPageSizeInWords * kWordSize));
+  // The capacity is usable.
+  memset(space->pointer(), 0, space->size_in_words() << kWordSizeLog2);
+  space->Delete();
+}
+
 }  // namespace dart
@@ -18,6 +18,9 @@ namespace dart {
 
 bool GCSweeper::SweepPage(HeapPage* page, FreeList* freelist, bool locked) {
   ASSERT(!page->is_image_page());
+  if (page->mark_bitmap() != NULL) {
+    return SweepPageWithBitmap(page, freelist, locked);
+  }
 
   // Keep track whether this page is still in use.
   intptr_t used_in_bytes = 0;
@@ -78,6 +81,57 @@ bool GCSweeper::SweepPage(HeapPage* page, FreeList* freelist, bool locked) {
   return used_in_bytes != 0;  // In use.
 }
 
+bool GCSweeper::SweepPageWithBitmap(HeapPage* page,
+                                    FreeList* freelist,
+                                    bool locked) {
+  ASSERT(page->type() == HeapPage::kData);
+  uword start = page->object_start();
+  uword end = page->object_end();
+
+  uword current = page->NextLive(start, end);
+  if (current == end) {
+    // No live objects: the page is not even read.
+    page->set_used_in_bytes(0);
+    return false;
+  }
+
+  intptr_t used_in_bytes = 0;
+  uword free_start = start;
+  while (true) {
+    if (current != free_start) {
+      const intptr_t free_size = current - free_start;
+#if defined(DEBUG)
+      // Objects which are marked in their header must be in the bitmap.
+      for (uword dead = free_start; dead < current;) {
+        RawObject* dead_obj = RawObject::FromAddr(dead);
+        ASSERT(!dead_obj->IsMarked());
+        dead += dead_obj->HeapSize();
+      }
+      memset(reinterpret_cast<void*>(free_start), Heap::kZapByte, free_size);
+#endif  // DEBUG
+      if (locked) {
+        freelist->FreeLocked(free_start, free_size);
+      } else {
+        freelist->Free(free_start, free_size);
+      }
+    }
+    if (current == end) {
+      break;
+    }
+    RawObject* raw_obj = RawObject::FromAddr(current);
+    ASSERT(HeapPage::Of(raw_obj) == page);
+    ASSERT(raw_obj->IsMarked());
+    raw_obj->ClearMarkBit();
+    const intptr_t size = raw_obj->HeapSize();
+    used_in_bytes += size;
+    free_start = current + size;
+    current = page->NextLive(free_start, end);
+  }
+
+  page->set_used_in_bytes(used_in_bytes);
+  return true;  // In use.
+}
+
 intptr_t GCSweeper::SweepLargePage(HeapPage* page) {
   ASSERT(!page->is_image_page());
 
@@ -170,6 +224,10 @@ class ConcurrentSweeperTask : public ThreadPool::Task {
     }
   }
 
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kHighPriority;
+  }
+
  private:
   Isolate* task_isolate_;
   PageSpace* old_space_;
@@ -30,6 +30,10 @@ class GCSweeper {
   // in use.
   bool SweepPage(HeapPage* page, FreeList* freelist, bool locked);
 
+  // Like SweepPage, for pages with a side mark bitmap. Only live objects are
+  // visited, and empty pages are not touched at all.
+  bool SweepPageWithBitmap(HeapPage* page, FreeList* freelist, bool locked);
+
   // Returns the number of words from page->object_start() to the end of the
   // last marked object.
   intptr_t SweepLargePage(HeapPage* page);
@@ -18,6 +18,11 @@ bool WeakCodeReferences::HasCodes() const {
 }
 
 void WeakCodeReferences::Register(const Code& value) {
+  Register(value, Object::null_object());
+}
+
+void WeakCodeReferences::Register(const Code& value,
+                                  const Object& dependency) {
   if (!array_.IsNull()) {
     // Try to find and reuse cleared WeakProperty to avoid allocating new one.
     WeakProperty& weak_property = WeakProperty::Handle();
@@ -26,6 +31,7 @@ void WeakCodeReferences::Register(const Code& value) {
       if (weak_property.key() == Code::null()) {
         // Empty property found. Reuse it.
         weak_property.set_key(value);
+        weak_property.set_value(dependency);
         return;
       }
     }
@@ -34,6 +40,7 @@ void WeakCodeReferences::Register(const Code& value) {
   const WeakProperty& weak_property =
       WeakProperty::Handle(WeakProperty::New(Heap::kOld));
   weak_property.set_key(value);
+  weak_property.set_value(dependency);
 
   intptr_t length = array_.IsNull() ? 0 : array_.Length();
   const Array& new_array =
@@ -59,7 +66,8 @@ bool WeakCodeReferences::IsOptimizedCode(const Array& dependent_code,
 
 void WeakCodeReferences::DisableCode() {
   Thread* thread = Thread::Current();
-  const Array& code_objects = Array::Handle(thread->zone(), array_.raw());
+  Zone* zone = thread->zone();
+  Array& code_objects = Array::Handle(zone, array_.raw());
 #if defined(DART_PRECOMPILED_RUNTIME)
   ASSERT(code_objects.IsNull());
   return;
@@ -68,7 +76,41 @@ void WeakCodeReferences::DisableCode() {
     return;
   }
 
-  UpdateArrayTo(Object::null_array());
+  // Code whose dependency still holds stays registered.
+  WeakProperty& weak_property = WeakProperty::Handle(zone);
+  Object& dependency = Object::Handle(zone);
+  intptr_t affected_count = 0;
+  for (intptr_t i = 0; i < code_objects.Length(); i++) {
+    weak_property ^= code_objects.At(i);
+    dependency = weak_property.value();
+    if (IsAffected(dependency)) {
+      affected_count++;
+    }
+  }
+  if (affected_count == 0) {
+    return;
+  }
+  if (affected_count == code_objects.Length()) {
+    UpdateArrayTo(Object::null_array());
+  } else {
+    const Array& affected = Array::Handle(zone, Array::New(affected_count));
+    const Array& unaffected = Array::Handle(
+        zone, Array::New(code_objects.Length() - affected_count, Heap::kOld));
+    intptr_t affected_index = 0;
+    intptr_t unaffected_index = 0;
+    for (intptr_t i = 0; i < code_objects.Length(); i++) {
+      weak_property ^= code_objects.At(i);
+      dependency = weak_property.value();
+      if (IsAffected(dependency)) {
+        affected.SetAt(affected_index++, weak_property);
+      } else {
+        unaffected.SetAt(unaffected_index++, weak_property);
+      }
+    }
+    UpdateArrayTo(unaffected);
+    code_objects = affected.raw();
+  }
+
   // Disable all code on stack.
   Code& code = Code::Handle();
   {
@@ -88,7 +130,6 @@ void WeakCodeReferences::DisableCode() {
   }
 
   // Switch functions that use dependent code to unoptimized code.
-  WeakProperty& weak_property = WeakProperty::Handle();
   Object& owner = Object::Handle();
   Function& function = Function::Handle();
   for (intptr_t i = 0; i < code_objects.Length(); i++) {
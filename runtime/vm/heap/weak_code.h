@@ -12,6 +12,7 @@ namespace dart {
 
 class Array;
 class Code;
+class Object;
 
 // Helper class to handle an array of code weak properties. Implements
 // registration and disabling of stored code objects.
@@ -21,11 +22,18 @@ class WeakCodeReferences : public ValueObject {
   virtual ~WeakCodeReferences() {}
 
   void Register(const Code& value);
+  // Registers code that relies on the fact described by 'dependency', which
+  // IsAffected is asked about when the code is disabled.
+  void Register(const Code& value, const Object& dependency);
 
   virtual void UpdateArrayTo(const Array& array) = 0;
   virtual void ReportDeoptimization(const Code& code) = 0;
   virtual void ReportSwitchingCode(const Code& code) = 0;
 
+  // Whether code registered with 'dependency' must be disabled by
+  // DisableCode. Code for which this returns false stays registered.
+  virtual bool IsAffected(const Object& dependency) const { return true; }
+
   static bool IsOptimizedCode(const Array& dependent_code, const Code& code);
 
   void DisableCode();
@@ -5,6 +5,7 @@
 #include "vm/heap/weak_table.h"
 
 #include "platform/assert.h"
+#include "platform/atomic.h"
 #include "vm/raw_object.h"
 
 namespace dart {
@@ -30,6 +31,15 @@ intptr_t WeakTable::SizeFor(intptr_t count, intptr_t size) {
 }
 
 void WeakTable::SetValue(RawObject* key, intptr_t val) {
+  if (old_data_ != NULL) {
+    // Move the key's entry first, so it is never in both backing stores.
+    intptr_t old_val = RemoveOldEntry(key);
+    if (old_val != 0) {
+      InsertMigrated(key, old_val);
+    }
+    ContinueRehash(kRehashStep);
+  }
+
   intptr_t mask = size() - 1;
   intptr_t idx = Hash(key) & mask;
   intptr_t empty_idx = -1;
@@ -70,7 +80,11 @@ void WeakTable::SetValue(RawObject* key, intptr_t val) {
 
   // Rehash if needed to ensure that there are empty slots available.
   if (used_ >= limit()) {
-    Rehash();
+    if (old_data_ != NULL) {
+      Rehash();
+    } else {
+      StartRehash();
+    }
   }
 }
 
@@ -81,35 +95,81 @@ void WeakTable::Reset() {
   size_ = kMinSize;
   free(old_data);
   data_ = reinterpret_cast<intptr_t*>(calloc(size_, kEntrySize * kWordSize));
+  free(old_data_);
+  old_data_ = NULL;
+  old_size_ = 0;
+  rehash_index_ = 0;
 }
 
 void WeakTable::Forward(ObjectPointerVisitor* visitor) {
+  FinishRehash();
   if (used_ == 0) return;
 
-  for (intptr_t i = 0; i < size_; i++) {
+  ForwardRange(visitor, 0, size_);
+
+  Rehash();
+}
+
+void WeakTable::ForwardRange(ObjectPointerVisitor* visitor,
+                             intptr_t start,
+                             intptr_t end) {
+  ASSERT(old_data_ == NULL);
+  ASSERT((0 <= start) && (start <= end) && (end <= size_));
+  for (intptr_t i = start; i < end; i++) {
     if (IsValidEntryAt(i)) {
       visitor->VisitPointer(ObjectPointerAt(i));
     }
   }
+}
 
-  Rehash();
+void WeakTable::InvalidateUnmarked(intptr_t start, intptr_t end) {
+  ASSERT(old_data_ == NULL);
+  ASSERT((0 <= start) && (start <= end) && (end <= size_));
+  intptr_t invalidated = 0;
+  for (intptr_t i = start; i < end; i++) {
+    if (IsValidEntryAt(i)) {
+      RawObject* raw_obj = ObjectAt(i);
+      ASSERT(raw_obj->IsHeapObject());
+      if (!raw_obj->IsMarked()) {
+        // Like InvalidateAt, but other tasks may update the count
+        // concurrently.
+        data_[ObjectIndex(i)] = kDeletedEntry;
+        data_[ValueIndex(i)] = 0;
+        invalidated++;
+      }
+    }
+  }
+  if (invalidated != 0) {
+    AtomicOperations::DecrementBy(&count_, invalidated);
+  }
 }
 
 void WeakTable::Rehash() {
-  intptr_t old_size = size();
-  intptr_t* old_data = data_;
-
   intptr_t new_size = SizeFor(count(), size());
+  // Entries still in the old backing store may not fit the size chosen for
+  // the current one.
+  while (LimitFor(new_size) <= count()) {
+    new_size *= 2;
+  }
   ASSERT(Utils::IsPowerOfTwo(new_size));
   intptr_t* new_data =
       reinterpret_cast<intptr_t*>(calloc(new_size, kEntrySize * kWordSize));
 
   intptr_t mask = new_size - 1;
-  set_used(0);
-  for (intptr_t i = 0; i < old_size; i++) {
-    if (IsValidEntryAt(i)) {
+  intptr_t new_used = 0;
+  for (intptr_t pass = 0; pass < 2; pass++) {
+    intptr_t* data = (pass == 0) ? data_ : old_data_;
+    intptr_t size = (pass == 0) ? size_ : old_size_;
+    if (data == NULL) {
+      continue;
+    }
+    for (intptr_t i = 0; i < size; i++) {
+      intptr_t value = data[ValueIndex(i)];
+      if (value == 0) {
+        continue;
+      }
       // Find the new hash location for this entry.
-      RawObject* key = ObjectAt(i);
+      RawObject* key = reinterpret_cast<RawObject*>(data[ObjectIndex(i)]);
       intptr_t idx = Hash(key) & mask;
       RawObject* obj = reinterpret_cast<RawObject*>(new_data[ObjectIndex(idx)]);
       while (obj != NULL) {
@@ -119,17 +179,107 @@ void WeakTable::Rehash() {
       }
 
       new_data[ObjectIndex(idx)] = reinterpret_cast<intptr_t>(key);
-      new_data[ValueIndex(idx)] = ValueAt(i);
-      set_used(used() + 1);
+      new_data[ValueIndex(idx)] = value;
+      new_used++;
     }
   }
   // We should only have used valid entries.
-  ASSERT(used() == count());
+  ASSERT(new_used == count());
 
   // Switch to using the newly allocated backing store.
+  free(data_);
+  free(old_data_);
+  old_data_ = NULL;
+  old_size_ = 0;
+  rehash_index_ = 0;
   size_ = new_size;
   data_ = new_data;
-  free(old_data);
+  used_ = new_used;
+}
+
+void WeakTable::StartRehash() {
+  ASSERT(old_data_ == NULL);
+  old_data_ = data_;
+  old_size_ = size_;
+  rehash_index_ = 0;
+
+  size_ = SizeFor(count(), old_size_);
+  ASSERT(Utils::IsPowerOfTwo(size_));
+  ASSERT(count() < LimitFor(size_));
+  data_ = reinterpret_cast<intptr_t*>(calloc(size_, kEntrySize * kWordSize));
+  used_ = 0;
+  ContinueRehash(kRehashStep);
+}
+
+void WeakTable::ContinueRehash(intptr_t steps) {
+  while ((old_data_ != NULL) && (steps-- > 0)) {
+    if (rehash_index_ == old_size_) {
+      free(old_data_);
+      old_data_ = NULL;
+      old_size_ = 0;
+      rehash_index_ = 0;
+      return;
+    }
+    intptr_t i = rehash_index_++;
+    intptr_t value = old_data_[ValueIndex(i)];
+    if (value != 0) {
+      RawObject* key = reinterpret_cast<RawObject*>(old_data_[ObjectIndex(i)]);
+      old_data_[ObjectIndex(i)] = kDeletedEntry;
+      old_data_[ValueIndex(i)] = 0;
+      InsertMigrated(key, value);
+    }
+  }
+}
+
+void WeakTable::FinishRehash() {
+  while (old_data_ != NULL) {
+    ContinueRehash(old_size_);
+  }
+}
+
+void WeakTable::InsertMigrated(RawObject* key, intptr_t val) {
+  ASSERT(val != 0);
+  intptr_t mask = size() - 1;
+  intptr_t idx = Hash(key) & mask;
+  RawObject* obj = ObjectAt(idx);
+  while (obj != NULL) {
+    ASSERT(obj != key);  // Duplicate entry is not expected.
+    idx = (idx + 1) & mask;
+    obj = ObjectAt(idx);
+  }
+  SetObjectAt(idx, key);
+  data_[ValueIndex(idx)] = val;
+  set_used(used() + 1);
+  if (used_ >= limit()) {
+    // More entries were added than the new backing store was sized for.
+    Rehash();
+  }
+}
+
+intptr_t WeakTable::FindOldEntry(RawObject* key) const {
+  ASSERT(old_data_ != NULL);
+  intptr_t mask = old_size_ - 1;
+  intptr_t idx = Hash(key) & mask;
+  RawObject* obj = reinterpret_cast<RawObject*>(old_data_[ObjectIndex(idx)]);
+  while (obj != NULL) {
+    if (obj == key) {
+      return idx;
+    }
+    idx = (idx + 1) & mask;
+    obj = reinterpret_cast<RawObject*>(old_data_[ObjectIndex(idx)]);
+  }
+  return -1;
+}
+
+intptr_t WeakTable::RemoveOldEntry(RawObject* key) {
+  intptr_t idx = FindOldEntry(key);
+  if (idx < 0) {
+    return 0;
+  }
+  intptr_t result = old_data_[ValueIndex(idx)];
+  old_data_[ObjectIndex(idx)] = kDeletedEntry;
+  old_data_[ValueIndex(idx)] = 0;
+  return result;
 }
 
 }  // namespace dart
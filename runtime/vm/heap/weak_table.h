@@ -8,17 +8,25 @@
 #include "vm/globals.h"
 
 #include "platform/assert.h"
+#include "platform/atomic.h"
 #include "vm/raw_object.h"
 
 namespace dart {
 
 class WeakTable {
  public:
-  WeakTable() : size_(kMinSize), used_(0), count_(0) {
+  WeakTable()
+      : size_(kMinSize),
+        used_(0),
+        count_(0),
+        old_data_(NULL),
+        old_size_(0),
+        rehash_index_(0) {
     ASSERT(Utils::IsPowerOfTwo(size_));
     data_ = reinterpret_cast<intptr_t*>(calloc(size_, kEntrySize * kWordSize));
   }
-  explicit WeakTable(intptr_t size) : used_(0), count_(0) {
+  explicit WeakTable(intptr_t size)
+      : used_(0), count_(0), old_data_(NULL), old_size_(0), rehash_index_(0) {
     ASSERT(size >= 0);
     ASSERT(Utils::IsPowerOfTwo(kMinSize));
     if (size < kMinSize) {
@@ -36,7 +44,10 @@ class WeakTable {
     data_ = reinterpret_cast<intptr_t*>(calloc(size_, kEntrySize * kWordSize));
   }
 
-  ~WeakTable() { free(data_); }
+  ~WeakTable() {
+    free(data_);
+    free(old_data_);
+  }
 
   static WeakTable* NewFrom(WeakTable* original) {
     return new WeakTable(SizeFor(original->count(), original->size()));
@@ -85,6 +96,12 @@ class WeakTable {
       obj = ObjectAt(idx);
     }
     ASSERT(ValueAt(idx) == 0);
+    if (old_data_ != NULL) {
+      intptr_t old_idx = FindOldEntry(key);
+      if (old_idx >= 0) {
+        return old_data_[ValueIndex(old_idx)];
+      }
+    }
     return 0;
   }
 
@@ -104,6 +121,13 @@ class WeakTable {
       obj = ObjectAt(idx);
     }
     ASSERT(ValueAt(idx) == 0);
+    if (old_data_ != NULL) {
+      intptr_t result = RemoveOldEntry(key);
+      if (result != 0) {
+        set_count(count() - 1);
+      }
+      return result;
+    }
     return 0;
   }
 
@@ -111,6 +135,26 @@ class WeakTable {
 
   void Reset();
 
+  // Growing or shrinking the table moves its entries to a new backing store
+  // a few at a time with each SetValue, so no single update pays for
+  // rehashing the whole table. Moves the remaining entries at once; the GC
+  // calls this before iterating over the entries.
+  void FinishRehash();
+
+  // Parallel GC support. Different tasks may process disjoint ranges of
+  // entries concurrently once FinishRehash has been called.
+
+  // Invalidates the entries in [start, end) whose keys are not marked.
+  void InvalidateUnmarked(intptr_t start, intptr_t end);
+  // Visits the keys of the valid entries in [start, end). The table must be
+  // rehashed before it is used again if any of them moved.
+  void ForwardRange(ObjectPointerVisitor* visitor,
+                    intptr_t start,
+                    intptr_t end);
+
+  // Rebuilds the backing store at once.
+  void Rehash();
+
  private:
   enum {
     kObjectOffset = 0,
@@ -120,6 +164,9 @@ class WeakTable {
 
   static const intptr_t kDeletedEntry = 1;  // Equivalent to a tagged NULL.
   static const intptr_t kMinSize = 8;
+  // The number of entries of the old backing store moved by each SetValue
+  // during an incremental rehash.
+  static const intptr_t kRehashStep = 16;
 
   static intptr_t SizeFor(intptr_t count, intptr_t size);
   static intptr_t LimitFor(intptr_t size) {
@@ -136,8 +183,9 @@ class WeakTable {
   }
 
   void set_count(intptr_t val) {
-    ASSERT(val <= limit());
-    ASSERT(val <= used());
+    // Entries still in the old backing store are counted but not used.
+    ASSERT((old_data_ != NULL) || (val <= limit()));
+    ASSERT((old_data_ != NULL) || (val <= used()));
     count_ = val;
   }
 
@@ -168,7 +216,17 @@ class WeakTable {
     data_[ValueIndex(i)] = val;
   }
 
-  void Rehash();
+  // Starts moving the entries to a backing store sized for their count.
+  void StartRehash();
+  // Moves the next 'steps' entries of the old backing store.
+  void ContinueRehash(intptr_t steps);
+  // Inserts an entry that is not in the current backing store into it.
+  void InsertMigrated(RawObject* key, intptr_t val);
+  // Returns the index of the key in the old backing store, or -1.
+  intptr_t FindOldEntry(RawObject* key) const;
+  // Removes the key from the old backing store and returns its value, or 0
+  // if it is not there. Does not update the count.
+  intptr_t RemoveOldEntry(RawObject* key);
 
   static intptr_t Hash(RawObject* key) {
     return reinterpret_cast<uintptr_t>(key) * 92821;
@@ -182,10 +240,73 @@ class WeakTable {
   intptr_t size_;
   intptr_t used_;
   intptr_t count_;
+  // During an incremental rehash, the previous backing store. The entries
+  // below rehash_index_ have been moved to data_.
+  intptr_t* old_data_;
+  intptr_t old_size_;
+  intptr_t rehash_index_;
 
   DISALLOW_COPY_AND_ASSIGN(WeakTable);
 };
 
+// Parallel GC support. Splits the entries of a set of weak tables into chunks
+// that GC tasks claim one at a time, so that large tables are processed by
+// all tasks.
+class WeakTableChunks {
+ public:
+  WeakTableChunks() { Reset(); }
+
+  // Must not be called while tasks are claiming chunks.
+  void Reset() {
+    num_tables_ = 0;
+    num_chunks_ = 0;
+    next_chunk_ = 0;
+  }
+  void AddTable(WeakTable* table) {
+    ASSERT(num_tables_ < kMaxTables);
+    table->FinishRehash();
+    tables_[num_tables_] = table;
+    first_chunks_[num_tables_] = num_chunks_;
+    num_chunks_ += (table->size() + kChunkSize - 1) / kChunkSize;
+    num_tables_++;
+  }
+
+  intptr_t num_tables() const { return num_tables_; }
+  WeakTable* TableAt(intptr_t i) const {
+    ASSERT((i >= 0) && (i < num_tables_));
+    return tables_[i];
+  }
+
+  // Claims the entries [*start, *end) of *table. Returns false once all
+  // chunks have been claimed.
+  bool ClaimChunk(WeakTable** table, intptr_t* start, intptr_t* end) {
+    intptr_t chunk = AtomicOperations::FetchAndIncrement(&next_chunk_);
+    if (chunk >= num_chunks_) {
+      return false;
+    }
+    intptr_t i = num_tables_ - 1;
+    while (first_chunks_[i] > chunk) {
+      i--;
+    }
+    *table = tables_[i];
+    *start = (chunk - first_chunks_[i]) * kChunkSize;
+    *end = Utils::Minimum(*start + kChunkSize, tables_[i]->size());
+    return true;
+  }
+
+ private:
+  static const intptr_t kMaxTables = 8;
+  static const intptr_t kChunkSize = 4 * KB;
+
+  WeakTable* tables_[kMaxTables];
+  intptr_t first_chunks_[kMaxTables];
+  intptr_t num_tables_;
+  intptr_t num_chunks_;
+  intptr_t next_chunk_;
+
+  DISALLOW_COPY_AND_ASSIGN(WeakTableChunks);
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_HEAP_WEAK_TABLE_H_
@@ -549,6 +549,24 @@ const char* NameOfStubIsolateSpecificStub(ObjectStore* object_store,
     return "_iso_stub_WriteBarrierWrappersStub";
   } else if (code.raw() == object_store->array_write_barrier_stub()) {
     return "_iso_stub_ArrayWriteBarrierStub";
+  } else if (code.raw() == object_store->allocate_array_stub()) {
+    return "_iso_stub_AllocateArrayStub";
+  } else if (code.raw() == object_store->allocate_context_stub()) {
+    return "_iso_stub_AllocateContextStub";
+  } else if (code.raw() == object_store->call_bootstrap_native_stub()) {
+    return "_iso_stub_CallBootstrapNativeStub";
+  } else if (code.raw() == object_store->call_auto_scope_native_stub()) {
+    return "_iso_stub_CallAutoScopeNativeStub";
+  } else if (code.raw() == object_store->call_no_scope_native_stub()) {
+    return "_iso_stub_CallNoScopeNativeStub";
+  } else if (code.raw() == object_store->subtype1_test_cache_stub()) {
+    return "_iso_stub_Subtype1TestCacheStub";
+  } else if (code.raw() == object_store->subtype2_test_cache_stub()) {
+    return "_iso_stub_Subtype2TestCacheStub";
+  } else if (code.raw() == object_store->subtype4_test_cache_stub()) {
+    return "_iso_stub_Subtype4TestCacheStub";
+  } else if (code.raw() == object_store->subtype6_test_cache_stub()) {
+    return "_iso_stub_Subtype6TestCacheStub";
   }
   return nullptr;
 }
@@ -733,12 +733,35 @@ void Interpreter::InlineCacheMiss(int checked_args,
 }
 
 DART_FORCE_INLINE bool Interpreter::InterfaceCall(Thread* thread,
-                                                  RawString* target_name,
+                                                  RawICData* icdata,
                                                   RawObject** call_base,
                                                   RawObject** top,
                                                   const KBCInstr** pc,
                                                   RawObject*** FP,
                                                   RawObject*** SP) {
+  ASSERT(icdata->GetClassId() == kICDataCid);
+
+  // Call sites which have seen only a few receiver classes are dispatched
+  // through their own inline cache, which is also used as type feedback
+  // when the function is compiled. Megamorphic call sites fall back to the
+  // lookup cache shared by all call sites.
+  const intptr_t checked_args =
+      ICData::NumArgsTestedBits::decode(icdata->ptr()->state_bits_);
+  const intptr_t length = Smi::Value(icdata->ptr()->entries_->ptr()->length_);
+  // Last entry is a sentinel.
+  const intptr_t num_checks = length / (checked_args + 2) - 1;
+  if (LIKELY(num_checks < FLAG_max_polymorphic_checks)) {
+    if (checked_args == 1) {
+      return InstanceCall1(thread, icdata, call_base, top, pc, FP, SP,
+                           false /* optimized */);
+    }
+    ASSERT(checked_args == 2);
+    return InstanceCall2(thread, icdata, call_base, top, pc, FP, SP,
+                         false /* optimized */);
+  }
+
+  RawString* target_name = icdata->ptr()->target_name_;
+  argdesc_ = icdata->ptr()->args_descriptor_;
   const intptr_t type_args_len =
       InterpreterHelpers::ArgDescTypeArgsLen(argdesc_);
   const intptr_t receiver_idx = type_args_len > 0 ? 1 : 0;
@@ -1297,7 +1320,8 @@ bool Interpreter::AssertAssignable(Thread* thread,
           static_cast<RawTypeArguments*>(null_value);
     }
 
-    for (RawObject** entries = cache->ptr()->cache_->ptr()->data();
+    for (RawObject** entries = SubtypeTestCache::ProbeStart(
+             cache->ptr()->cache_->ptr()->data(), cid);
          entries[0] != null_value;
          entries += SubtypeTestCache::kTestEntryLength) {
       if ((entries[SubtypeTestCache::kInstanceClassIdOrFunction] ==
@@ -1821,14 +1845,15 @@ SwitchDispatch:
     if ((rA == 0) || (null_value != instantiator_type_args) ||
         (null_value != function_type_args)) {
       // First lookup in the cache.
-      RawArray* instantiations = type_arguments->ptr()->instantiations_;
-      for (intptr_t i = 0;
-           instantiations->ptr()->data()[i] != NULL;  // kNoInstantiator
-           i += 3) {  // kInstantiationSizeInWords
-        if ((instantiations->ptr()->data()[i] == instantiator_type_args) &&
-            (instantiations->ptr()->data()[i + 1] == function_type_args)) {
+      RawObject** entries = TypeArguments::InstantiationsProbeStart(
+          type_arguments->ptr()->instantiations_, instantiator_type_args,
+          function_type_args);
+      for (intptr_t i = 0; entries[i] != NULL;  // kNoInstantiator
+           i += 3) {                            // kInstantiationSizeInWords
+        if ((entries[i] == instantiator_type_args) &&
+            (entries[i + 1] == function_type_args)) {
           // Found in the cache.
-          SP[-1] = instantiations->ptr()->data()[i + 2];
+          SP[-1] = entries[i + 2];
           goto InstantiateTypeArgumentsTOSDone;
         }
       }
@@ -1972,11 +1997,8 @@ SwitchDispatch:
       RawObject** call_top = SP + 1;
 
       InterpreterHelpers::IncrementUsageCounter(FrameFunction(FP));
-      RawString* target_name =
-          static_cast<RawFunction*>(LOAD_CONSTANT(kidx))->ptr()->name_;
-      argdesc_ = static_cast<RawArray*>(LOAD_CONSTANT(kidx + 1));
-      if (!InterfaceCall(thread, target_name, call_base, call_top, &pc, &FP,
-                         &SP)) {
+      RawICData* icdata = RAW_CAST(ICData, LOAD_CONSTANT(kidx + 1));
+      if (!InterfaceCall(thread, icdata, call_base, call_top, &pc, &FP, &SP)) {
         HANDLE_EXCEPTION;
       }
     }
@@ -1995,11 +2017,8 @@ SwitchDispatch:
       RawObject** call_top = SP + 1;
 
       InterpreterHelpers::IncrementUsageCounter(FrameFunction(FP));
-      RawString* target_name =
-          static_cast<RawFunction*>(LOAD_CONSTANT(kidx))->ptr()->name_;
-      argdesc_ = static_cast<RawArray*>(LOAD_CONSTANT(kidx + 1));
-      if (!InterfaceCall(thread, target_name, call_base, call_top, &pc, &FP,
-                         &SP)) {
+      RawICData* icdata = RAW_CAST(ICData, LOAD_CONSTANT(kidx + 1));
+      if (!InterfaceCall(thread, icdata, call_base, call_top, &pc, &FP, &SP)) {
         HANDLE_EXCEPTION;
       }
     }
@@ -2905,6 +2924,54 @@ SwitchDispatch:
     DISPATCH();
   }
 
+  {
+    BYTECODE(JumpIfNotIntGt, T);
+    SP -= 1;
+    UNBOX_INT64(a, SP[0], Symbols::RAngleBracket());
+    UNBOX_INT64(b, SP[1], Symbols::RAngleBracket());
+    SP -= 1;
+    if (!(a > b)) {
+      LOAD_JUMP_TARGET();
+    }
+    DISPATCH();
+  }
+
+  {
+    BYTECODE(JumpIfNotIntLt, T);
+    SP -= 1;
+    UNBOX_INT64(a, SP[0], Symbols::LAngleBracket());
+    UNBOX_INT64(b, SP[1], Symbols::LAngleBracket());
+    SP -= 1;
+    if (!(a < b)) {
+      LOAD_JUMP_TARGET();
+    }
+    DISPATCH();
+  }
+
+  {
+    BYTECODE(JumpIfNotIntGe, T);
+    SP -= 1;
+    UNBOX_INT64(a, SP[0], Symbols::GreaterEqualOperator());
+    UNBOX_INT64(b, SP[1], Symbols::GreaterEqualOperator());
+    SP -= 1;
+    if (!(a >= b)) {
+      LOAD_JUMP_TARGET();
+    }
+    DISPATCH();
+  }
+
+  {
+    BYTECODE(JumpIfNotIntLe, T);
+    SP -= 1;
+    UNBOX_INT64(a, SP[0], Symbols::LessEqualOperator());
+    UNBOX_INT64(b, SP[1], Symbols::LessEqualOperator());
+    SP -= 1;
+    if (!(a <= b)) {
+      LOAD_JUMP_TARGET();
+    }
+    DISPATCH();
+  }
+
   {
     BYTECODE(NegateDouble, 0);
     UNBOX_DOUBLE(value, SP[0], Symbols::UnaryMinus());
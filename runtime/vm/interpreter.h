@@ -184,7 +184,7 @@ class Interpreter {
                        RawObject** SP);
 
   bool InterfaceCall(Thread* thread,
-                     RawString* target_name,
+                     RawICData* icdata,
                      RawObject** call_base,
                      RawObject** call_top,
                      const KBCInstr** pc,
@@ -13,7 +13,11 @@
 #include "platform/text_buffer.h"
 #include "vm/class_finalizer.h"
 #include "vm/code_observers.h"
+#include "vm/compilation_trace.h"
+#include "vm/compiler/compiler_pass.h"
+#include "vm/compiler/jit/code_cache.h"
 #include "vm/compiler/jit/compiler.h"
+#include "vm/compiler/jit/global_object_pool.h"
 #include "vm/dart_api_message.h"
 #include "vm/dart_api_state.h"
 #include "vm/dart_entry.h"
@@ -51,6 +55,7 @@
 #include "vm/thread_registry.h"
 #include "vm/timeline.h"
 #include "vm/timeline_analysis.h"
+#include "vm/type_testing_stubs.h"
 #include "vm/visitor.h"
 
 namespace dart {
@@ -73,6 +78,7 @@ static void DeterministicModeHandler(bool value) {
     FLAG_background_compilation = false;  // Timing dependent.
     FLAG_concurrent_mark = false;         // Timing dependent.
     FLAG_concurrent_sweep = false;        // Timing dependent.
+    FLAG_scavenger_tasks = 0;             // Timing dependent.
     FLAG_random_seed = 0x44617274;  // "Dart"
 #if !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
     FLAG_load_deferred_eagerly = true;
@@ -86,6 +92,22 @@ DEFINE_FLAG_HANDLER(DeterministicModeHandler,
                     deterministic,
                     "Enable deterministic mode.");
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+DEFINE_FLAG(bool,
+            share_group_type_feedback,
+            false,
+            "Save the type feedback of isolates that exit and load it into "
+            "isolates spawned later in the same isolate group.");
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
+DEFINE_FLAG(bool,
+            fast_shutdown,
+            false,
+            "Shut isolates down without running the finalizers of weak "
+            "persistent handles, except those set to finalize on shutdown, "
+            "and do not free the heaps of isolates shut down by Dart_Cleanup, "
+            "which the process releases when it exits.");
+
 // Quick access to the locally defined thread() and isolate() methods.
 #define T (thread())
 #define I (isolate())
@@ -929,6 +951,14 @@ Isolate::Isolate(const Dart_IsolateFlags& api_flags)
   }
   NOT_IN_PRECOMPILED(optimizing_background_compiler_ =
                          new BackgroundCompiler(this));
+  NOT_IN_PRECOMPILED(jit_global_object_pool_ = new GlobalObjectPool());
+  NOT_IN_PRECOMPILED(jit_code_cache_ = new CodeCache());
+  NOT_IN_PRECOMPILED(jit_pc_lookup_table_ = new JitReversePcLookupTable());
+#if !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
+  if (FLAG_dump_compiler_pass_stats) {
+    compiler_pass_stats_ = new CompilerPassStats();
+  }
+#endif
 }
 
 #undef REUSABLE_HANDLE_SCOPE_INIT
@@ -951,6 +981,17 @@ Isolate::~Isolate() {
   delete optimizing_background_compiler_;
   optimizing_background_compiler_ = nullptr;
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  delete deopt_stats_;
+  deopt_stats_ = nullptr;
+  delete jit_global_object_pool_;
+  jit_global_object_pool_ = nullptr;
+  delete jit_code_cache_;
+  jit_code_cache_ = nullptr;
+  delete jit_pc_lookup_table_;
+  jit_pc_lookup_table_ = nullptr;
+#endif
+
 #if !defined(PRODUCT)
   delete debugger_;
   debugger_ = nullptr;
@@ -960,11 +1001,21 @@ Isolate::~Isolate() {
   object_id_ring_ = nullptr;
   delete pause_loop_monitor_;
   pause_loop_monitor_ = nullptr;
+  delete type_check_stats_;
+  type_check_stats_ = nullptr;
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  delete compiler_pass_stats_;
+  compiler_pass_stats_ = nullptr;
+#endif
 #endif  // !defined(PRODUCT)
 
   free(name_);
   delete store_buffer_;
-  delete heap_;
+  if (!FLAG_fast_shutdown || IsolateCreationEnabled()) {
+    delete heap_;
+  }
+  // Otherwise the VM is exiting, and unmapping the heap page by page is left
+  // to the process exit.
   ASSERT(marking_stack_ == nullptr);
   delete object_store_;
   delete api_state_;
@@ -1223,6 +1274,25 @@ void Isolate::DoneLoading() {
   }
 }
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+DeoptStats* Isolate::deopt_stats() {
+  ASSERT(Thread::Current()->IsMutatorThread());
+  if (deopt_stats_ == nullptr) {
+    deopt_stats_ = new DeoptStats();
+  }
+  return deopt_stats_;
+}
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
+#if !defined(PRODUCT)
+TypeCheckStats* Isolate::type_check_stats() {
+  if (type_check_stats_ == nullptr) {
+    type_check_stats_ = new TypeCheckStats();
+  }
+  return type_check_stats_;
+}
+#endif  // !defined(PRODUCT)
+
 #if !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
 bool Isolate::CanReload() const {
   return !Isolate::IsVMInternalIsolate(this) && is_runnable() &&
@@ -1538,6 +1608,63 @@ bool Isolate::NotifyErrorListeners(const String& msg,
   return listeners.Length() > 0;
 }
 
+void IsolateGroupSource::SetTypeFeedback(uint8_t* buffer, intptr_t length) {
+  MutexLocker ml(&type_feedback_mutex_);
+  free(type_feedback_);
+  type_feedback_ = buffer;
+  type_feedback_length_ = length;
+}
+
+uint8_t* IsolateGroupSource::CopyTypeFeedback(intptr_t* length) {
+  MutexLocker ml(&type_feedback_mutex_);
+  if (type_feedback_ == nullptr) {
+    return nullptr;
+  }
+  uint8_t* copy = reinterpret_cast<uint8_t*>(malloc(type_feedback_length_));
+  memmove(copy, type_feedback_, type_feedback_length_);
+  *length = type_feedback_length_;
+  return copy;
+}
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+static uint8_t* MallocReallocate(uint8_t* ptr,
+                                 intptr_t old_size,
+                                 intptr_t new_size) {
+  return reinterpret_cast<uint8_t*>(realloc(ptr, new_size));
+}
+
+static void SaveGroupTypeFeedback(Thread* thread, IsolateGroupSource* source) {
+  StackZone zone(thread);
+  HandleScope handle_scope(thread);
+  uint8_t* buffer = nullptr;
+  WriteStream stream(&buffer, MallocReallocate, KB);
+  TypeFeedbackSaver saver(&stream);
+  saver.WriteHeader();
+  saver.SaveClasses();
+  saver.SaveFields();
+  ProgramVisitor::VisitFunctions(&saver);
+  source->SetTypeFeedback(buffer, stream.bytes_written());
+}
+
+static void LoadGroupTypeFeedback(Thread* thread, IsolateGroupSource* source) {
+  intptr_t length = 0;
+  uint8_t* buffer = source->CopyTypeFeedback(&length);
+  if (buffer == nullptr) {
+    return;
+  }
+  // The feedback only saves warm-up, so a failure to load it is not an error
+  // of the spawned isolate.
+  ReadStream stream(buffer, length);
+  TypeFeedbackLoader loader(thread);
+  const Object& error = Object::Handle(loader.LoadFeedback(&stream));
+  if (error.IsError() && FLAG_trace_isolates) {
+    OS::PrintErr("[!] Failed to load group type feedback: %s\n",
+                 Error::Cast(error).ToErrorCString());
+  }
+  free(buffer);
+}
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 static MessageHandler::MessageStatus RunIsolate(uword parameter) {
   Isolate* isolate = reinterpret_cast<Isolate*>(parameter);
   IsolateSpawnState* state = nullptr;
@@ -1578,6 +1705,12 @@ static MessageHandler::MessageStatus RunIsolate(uword parameter) {
       return MessageHandler::kError;
     }
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+    if (FLAG_share_group_type_feedback && (isolate->source() != nullptr)) {
+      LoadGroupTypeFeedback(thread, isolate->source());
+    }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
     Object& result = Object::Handle();
     result = state->ResolveFunction();
     bool is_spawn_uri = state->is_spawn_uri();
@@ -1731,6 +1864,9 @@ class FinalizeWeakPersistentHandlesVisitor : public HandleVisitor {
   void VisitHandle(uword addr) {
     FinalizablePersistentHandle* handle =
         reinterpret_cast<FinalizablePersistentHandle*>(addr);
+    if (FLAG_fast_shutdown && !handle->finalize_on_shutdown()) {
+      return;
+    }
     handle->UpdateUnreachable(thread()->isolate());
   }
 
@@ -1740,6 +1876,7 @@ class FinalizeWeakPersistentHandlesVisitor : public HandleVisitor {
 
 // static
 void Isolate::NotifyLowMemory() {
+  Zone::TrimSegmentCaches();
   Isolate::KillAllIsolates(Isolate::kLowMemoryMsg);
 }
 
@@ -1791,6 +1928,15 @@ void Isolate::LowLevelShutdown() {
   if (FLAG_dump_symbol_stats) {
     Symbols::DumpStats(this);
   }
+  if (FLAG_dump_type_check_stats && (type_check_stats_ != nullptr)) {
+    type_check_stats_->Print();
+  }
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  if (FLAG_dump_compiler_pass_stats && (compiler_pass_stats_ != nullptr)) {
+    OS::PrintErr("Compiler pass statistics for %s:\n", name());
+    compiler_pass_stats_->Print();
+  }
+#endif
   if (FLAG_trace_isolates) {
     heap()->PrintSizes();
     OS::PrintErr(
@@ -1848,6 +1994,14 @@ void Isolate::Shutdown() {
   // Don't allow anymore dart code to execution on this isolate.
   thread->ClearStackLimit();
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  // Pooled isolates have not run, so they have no feedback to leave behind.
+  if (FLAG_share_group_type_feedback && (source_ != nullptr) &&
+      is_runnable() && !is_pooled_ && !Isolate::IsVMInternalIsolate(this)) {
+    SaveGroupTypeFeedback(thread, source_);
+  }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
   // Remove this isolate from the list *before* we start tearing it down, to
   // avoid exposing it in a state of decay.
   RemoveIsolateFromList(this);
@@ -1856,6 +2010,11 @@ void Isolate::Shutdown() {
     // After removal from isolate list. Before tearing down the heap.
     StackZone zone(thread);
     HandleScope handle_scope(thread);
+#if defined(SUPPORT_TIMELINE)
+    // Events of synchronous blocks that were never finished may still be
+    // buffered in Dart.
+    DartTimelineEventHelpers::FlushBufferedEvents(thread);
+#endif
     ServiceIsolate::SendIsolateShutdownMessage();
     KernelIsolate::NotifyAboutIsolateShutdown(this);
 #if !defined(PRODUCT)
@@ -1915,18 +2074,25 @@ void Isolate::Shutdown() {
     }
 
     // Run isolate group specific cleanup function if the last isolate in an
-    // isolate group died.
-    if (source_->DecrementIsolateUsageCount()) {
-      auto group_cleanup_callback = Isolate::GroupCleanupCallback();
-      if (group_cleanup_callback != nullptr) {
-        group_cleanup_callback(source_->callback_data);
-      }
-      delete source_;
-      source_ = nullptr;
+    // isolate group died. Releasing an isolate which is not pooled may shut
+    // down the pooled ones, and with the last of them the source.
+    const bool last = is_pooled_ ? source_->DecrementIsolateUsageCount()
+                                 : source_->spawn_pool.ReleaseIsolate();
+    if (last) {
+      DeleteGroupSource(source_);
     }
+    source_ = nullptr;
   }
 }
 
+void Isolate::DeleteGroupSource(IsolateGroupSource* source) {
+  auto group_cleanup_callback = Isolate::GroupCleanupCallback();
+  if (group_cleanup_callback != nullptr) {
+    group_cleanup_callback(source->callback_data);
+  }
+  delete source;
+}
+
 Dart_InitializeIsolateCallback Isolate::initialize_callback_ = nullptr;
 Dart_IsolateGroupCreateCallback Isolate::create_group_callback_ = nullptr;
 Dart_IsolateShutdownCallback Isolate::shutdown_callback_ = nullptr;
@@ -2002,6 +2168,9 @@ void Isolate::VisitObjectPointers(ObjectPointerVisitor* visitor,
   if (deopt_context() != nullptr) {
     deopt_context()->VisitObjectPointers(visitor);
   }
+  if (jit_global_object_pool_ != nullptr) {
+    jit_global_object_pool_->VisitObjectPointers(visitor);
+  }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
 #if defined(TARGET_ARCH_DBC)
@@ -23,10 +23,12 @@
 #include "vm/growable_array.h"
 #include "vm/handles.h"
 #include "vm/heap/verifier.h"
+#include "vm/isolate_pool.h"
 #include "vm/megamorphic_cache_table.h"
 #include "vm/metrics.h"
 #include "vm/os_thread.h"
 #include "vm/random.h"
+#include "vm/regexp_bytecode_cache.h"
 #include "vm/tags.h"
 #include "vm/thread.h"
 #include "vm/thread_stack_resource.h"
@@ -38,10 +40,13 @@ namespace dart {
 class ApiState;
 class BackgroundCompiler;
 class Capability;
+class CodeCache;
 class CodeIndexTable;
 class Debugger;
 class DeoptContext;
 class ExternalTypedData;
+class GlobalObjectPool;
+class JitReversePcLookupTable;
 class HandleScope;
 class HandleVisitor;
 class Heap;
@@ -85,6 +90,9 @@ class StackZone;
 class StoreBuffer;
 class StubCode;
 class ThreadRegistry;
+class TypeCheckStats;
+class DeoptStats;
+class CompilerPassStats;
 class UserTag;
 
 class PendingLazyDeopt {
@@ -194,8 +202,16 @@ class IsolateGroupSource {
         flags(flags),
         callback_data(callback_data),
         script_kernel_buffer(nullptr),
-        script_kernel_size(-1) {}
-  ~IsolateGroupSource() { free(name); }
+        script_kernel_size(-1),
+        spawn_pool(this),
+        type_feedback_mutex_(
+            NOT_IN_PRODUCT("IsolateGroupSource::type_feedback_mutex_")),
+        type_feedback_(nullptr),
+        type_feedback_length_(0) {}
+  ~IsolateGroupSource() {
+    free(name);
+    free(type_feedback_);
+  }
 
   // The arguments used for spawning in
   // `Dart_CreateIsolateGroupFromKernel` / `Dart_CreateIsolate`.
@@ -214,6 +230,16 @@ class IsolateGroupSource {
   const uint8_t* script_kernel_buffer;
   intptr_t script_kernel_size;
 
+  // Irregexp bytecode shared by the isolates of the group.
+  RegExpBytecodeCache regexp_bytecode_cache;
+
+  // Isolates initialized ahead of `Isolate.spawn()`.
+  IsolatePool spawn_pool;
+
+  intptr_t isolate_count() {
+    return AtomicOperations::LoadRelaxed(&isolate_count_);
+  }
+
   void IncrementIsolateUsageCount() {
     AtomicOperations::IncrementBy(&isolate_count_, 1);
   }
@@ -223,8 +249,21 @@ class IsolateGroupSource {
     return AtomicOperations::FetchAndDecrement(&isolate_count_) == 1;
   }
 
+  // Type feedback saved by the last isolate of the group that shut down
+  // after running, which isolates spawned later load before running so that
+  // they do not warm up from scratch. See --share_group_type_feedback.
+  //
+  // Takes ownership of the malloc'ed [buffer].
+  void SetTypeFeedback(uint8_t* buffer, intptr_t length);
+  // Returns a malloc'ed copy of the saved type feedback, or nullptr.
+  uint8_t* CopyTypeFeedback(intptr_t* length);
+
  private:
   intptr_t isolate_count_ = 0;
+
+  Mutex type_feedback_mutex_;
+  uint8_t* type_feedback_;
+  intptr_t type_feedback_length_;
 };
 
 class Isolate : public BaseIsolate {
@@ -318,6 +357,10 @@ class Isolate : public BaseIsolate {
     source_ = source;
   }
 
+  // Whether the isolate is waiting in its group's [IsolatePool].
+  bool is_pooled() const { return is_pooled_; }
+  void set_is_pooled(bool value) { is_pooled_ = value; }
+
   bool HasPendingMessages();
 
   Thread* mutator_thread() const;
@@ -547,6 +590,10 @@ class Isolate : public BaseIsolate {
   static void SetGroupCleanupCallback(Dart_IsolateGroupCleanupCallback cb) {
     cleanup_group_callback_ = cb;
   }
+  // Runs the group cleanup callback and deletes [source] after its last
+  // isolate has shut down.
+  static void DeleteGroupSource(IsolateGroupSource* source);
+
   static Dart_IsolateGroupCleanupCallback GroupCleanupCallback() {
     return cleanup_group_callback_;
   }
@@ -577,6 +624,24 @@ class Isolate : public BaseIsolate {
     return optimizing_background_compiler_;
   }
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  // Deoptimization counts and storm detection, only used by the mutator.
+  DeoptStats* deopt_stats();
+
+  // The object pool shared by JIT compiled code.
+  GlobalObjectPool* jit_global_object_pool() const {
+    return jit_global_object_pool_;
+  }
+
+  // Evicts the code of cold functions.
+  CodeCache* jit_code_cache() const { return jit_code_cache_; }
+
+  // The pc -> code index of JIT compiled code.
+  JitReversePcLookupTable* jit_pc_lookup_table() const {
+    return jit_pc_lookup_table_;
+  }
+#endif
+
 #if !defined(PRODUCT)
   void UpdateLastAllocationProfileAccumulatorResetTimestamp() {
     last_allocationprofile_accumulator_reset_timestamp_ =
@@ -622,7 +687,17 @@ class Isolate : public BaseIsolate {
 #if !defined(PRODUCT)
   VMTagCounters* vm_tag_counters() { return &vm_tag_counters_; }
 
+  // Counters for type checks done in the runtime, see
+  // --dump_type_check_stats.
+  TypeCheckStats* type_check_stats();
+
 #if !defined(DART_PRECOMPILED_RUNTIME)
+  // Time and IL size of compiler passes, see --dump_compiler_pass_stats.
+  // NULL unless the flag is set.
+  CompilerPassStats* compiler_pass_stats() const {
+    return compiler_pass_stats_;
+  }
+
   bool IsReloading() const { return reload_context_ != nullptr; }
 
   IsolateReloadContext* reload_context() { return reload_context_; }
@@ -1028,6 +1103,13 @@ class Isolate : public BaseIsolate {
   // Optimized background compilation.
   BackgroundCompiler* optimizing_background_compiler_ = nullptr;
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  DeoptStats* deopt_stats_ = nullptr;
+  GlobalObjectPool* jit_global_object_pool_ = nullptr;
+  CodeCache* jit_code_cache_ = nullptr;
+  JitReversePcLookupTable* jit_pc_lookup_table_ = nullptr;
+#endif
+
 // Fields that aren't needed in a product build go here with boolean flags at
 // the top.
 #if !defined(PRODUCT)
@@ -1039,6 +1121,10 @@ class Isolate : public BaseIsolate {
   int64_t last_allocationprofile_gc_timestamp_ = 0;
 
   VMTagCounters vm_tag_counters_;
+  TypeCheckStats* type_check_stats_ = nullptr;
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  CompilerPassStats* compiler_pass_stats_ = nullptr;
+#endif
 
   // We use 6 list entries for each pending service extension calls.
   enum {
@@ -1168,6 +1254,7 @@ class Isolate : public BaseIsolate {
   static Isolate* isolates_list_head_;
   static bool creation_enabled_;
   IsolateGroupSource* source_ = nullptr;
+  bool is_pooled_ = false;
 
 #define REUSABLE_FRIEND_DECLARATION(name)                                      \
   friend class Reusable##name##HandleScope;
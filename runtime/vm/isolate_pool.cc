@@ -0,0 +1,200 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/isolate_pool.h"
+
+#include "include/dart_api.h"
+#include "vm/dart.h"
+#include "vm/dart_api_impl.h"
+#include "vm/flags.h"
+#include "vm/isolate.h"
+#include "vm/lockers.h"
+#include "vm/thread_pool.h"
+
+namespace dart {
+
+DEFINE_FLAG(int,
+            isolate_spawn_pool_size,
+            0,
+            "Number of isolates each isolate group keeps initialized ahead of "
+            "Isolate.spawn (0 disables the pool).");
+
+class IsolatePoolFillTask : public ThreadPool::Task {
+ public:
+  explicit IsolatePoolFillTask(IsolatePool* pool) : pool_(pool) {}
+
+  // Spawns do not wait for the pool; they create their isolate themselves
+  // when it is empty.
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kLowPriority;
+  }
+
+  virtual void Run() { pool_->Fill(); }
+
+ private:
+  IsolatePool* pool_;
+
+  DISALLOW_COPY_AND_ASSIGN(IsolatePoolFillTask);
+};
+
+IsolatePool::IsolatePool(IsolateGroupSource* source)
+    : source_(source),
+      mutex_(NOT_IN_PRODUCT("IsolatePool::mutex_")),
+      isolates_(),
+      capacity_(FLAG_isolate_spawn_pool_size),
+      filling_(false),
+      draining_(false) {}
+
+IsolatePool::~IsolatePool() {
+  ASSERT(isolates_.is_empty());
+  ASSERT(!filling_);
+}
+
+void IsolatePool::SetCapacity(intptr_t capacity) {
+  MutexLocker ml(&mutex_);
+  capacity_ = capacity;
+  ScheduleFillLocked();
+}
+
+Isolate* IsolatePool::Take() {
+  MutexLocker ml(&mutex_);
+  Isolate* isolate = nullptr;
+  if (!draining_ && !isolates_.is_empty()) {
+    isolate = isolates_.RemoveLast();
+    isolate->set_is_pooled(false);
+  }
+  ScheduleFillLocked();
+  return isolate;
+}
+
+void IsolatePool::ScheduleFillLocked() {
+  if (filling_ || draining_ || (isolates_.length() >= capacity_) ||
+      (Isolate::InitializeCallback() == nullptr)) {
+    return;
+  }
+  // The fill task holds a reference on the source until it is done, so that
+  // the group cannot go away under it.
+  filling_ = true;
+  source_->IncrementIsolateUsageCount();
+  if (!Dart::thread_pool()->Run<IsolatePoolFillTask>(this)) {
+    // The VM is shutting down. The caller's isolate still holds a reference.
+    filling_ = false;
+    const bool last = source_->DecrementIsolateUsageCount();
+    ASSERT(!last);
+    USE(last);
+  }
+}
+
+void IsolatePool::Fill() {
+  MallocGrowableArray<Isolate*> drained;
+  while (true) {
+    {
+      MutexLocker ml(&mutex_);
+      if (draining_ || (isolates_.length() >= capacity_)) {
+        break;
+      }
+    }
+    Isolate* isolate = CreatePooledIsolate();
+    if (isolate == nullptr) {
+      break;
+    }
+    MutexLocker ml(&mutex_);
+    if (draining_) {
+      drained.Add(isolate);
+      break;
+    }
+    isolates_.Add(isolate);
+  }
+
+  bool last;
+  {
+    MutexLocker ml(&mutex_);
+    filling_ = false;
+    last = source_->DecrementIsolateUsageCount();
+    // The last isolate of the group may have shut down while an isolate was
+    // being created, in which case it left the draining to us.
+    if (!last && !draining_ && HasOnlyPooledIsolatesLocked()) {
+      DrainLocked(&drained);
+    }
+  }
+  if (last) {
+    ASSERT(drained.is_empty());
+    Isolate::DeleteGroupSource(source_);
+    return;
+  }
+  // May delete the source, and with it this pool.
+  ShutdownIsolates(&drained);
+}
+
+Isolate* IsolatePool::CreatePooledIsolate() {
+  char* error = nullptr;
+  Isolate* isolate =
+      CreateIsolateFromExistingSource(source_, source_->name, &error);
+  if (isolate == nullptr) {
+    if (FLAG_trace_isolates) {
+      OS::PrintErr("[!] Failed to create pooled isolate: %s\n", error);
+    }
+    free(error);
+    return nullptr;
+  }
+  // Mark the isolate before the embedder sees it, so that a failed
+  // initialization releases it as a pooled isolate.
+  isolate->set_is_pooled(true);
+
+  void* child_isolate_data = nullptr;
+  const bool success =
+      Isolate::InitializeCallback()(&child_isolate_data, &error);
+  isolate->set_init_callback_data(child_isolate_data);
+  if (!success) {
+    if (FLAG_trace_isolates) {
+      OS::PrintErr("[!] Failed to initialize pooled isolate: %s\n", error);
+    }
+    Dart_ShutdownIsolate();
+    free(error);
+    return nullptr;
+  }
+  Dart_ExitIsolate();
+  return isolate;
+}
+
+bool IsolatePool::ReleaseIsolate() {
+  MallocGrowableArray<Isolate*> drained;
+  {
+    MutexLocker ml(&mutex_);
+    if (source_->DecrementIsolateUsageCount()) {
+      return true;
+    }
+    if (!draining_ && HasOnlyPooledIsolatesLocked()) {
+      DrainLocked(&drained);
+    }
+  }
+  // May delete the source, and with it this pool.
+  ShutdownIsolates(&drained);
+  return false;
+}
+
+bool IsolatePool::HasOnlyPooledIsolatesLocked() {
+  // Isolates being created by the fill task are not counted as pooled, so
+  // the task repeats this check when it is done.
+  return source_->isolate_count() ==
+         (isolates_.length() + (filling_ ? 1 : 0));
+}
+
+void IsolatePool::DrainLocked(MallocGrowableArray<Isolate*>* drained) {
+  draining_ = true;
+  while (!isolates_.is_empty()) {
+    drained->Add(isolates_.RemoveLast());
+  }
+}
+
+void IsolatePool::ShutdownIsolates(MallocGrowableArray<Isolate*>* isolates) {
+  for (intptr_t i = 0; i < isolates->length(); i++) {
+    Isolate* isolate = isolates->At(i);
+    ASSERT(isolate->is_pooled());
+    Dart_EnterIsolate(Api::CastIsolate(isolate));
+    Dart_ShutdownIsolate();
+  }
+}
+
+}  // namespace dart
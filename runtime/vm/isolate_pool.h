@@ -0,0 +1,78 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_ISOLATE_POOL_H_
+#define RUNTIME_VM_ISOLATE_POOL_H_
+
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+#include "vm/os_thread.h"
+
+namespace dart {
+
+class Isolate;
+class IsolateGroupSource;
+
+// Keeps isolates of an isolate group created and initialized ahead of
+// `Isolate.spawn()`, so that a spawn only has to hand the entry point to an
+// isolate that is ready to run it.
+//
+// Pooled isolates are created on the thread pool from the group's
+// [IsolateGroupSource] and initialized with the embedder's initialize
+// callback, then wait unentered until they are taken. An isolate that has run
+// Dart code is never returned to the pool: its statics and heap belong to the
+// job that ran it.
+//
+// Pooled isolates hold a reference on the source like any other isolate of
+// the group. Once only pooled isolates are left, the pool is drained so that
+// the group can shut down.
+class IsolatePool {
+ public:
+  explicit IsolatePool(IsolateGroupSource* source);
+  ~IsolatePool();
+
+  intptr_t capacity() const { return capacity_; }
+
+  // Sets the number of isolates to keep ready and starts filling the pool.
+  // Lowering the capacity does not shut down isolates that are already
+  // pooled; they are handed out before new ones are created.
+  void SetCapacity(intptr_t capacity);
+
+  // Returns a pooled isolate which is not entered by any thread and has not
+  // been made to run, or nullptr if none is ready. Schedules a refill.
+  Isolate* Take();
+
+  // Releases the reference of an isolate of the group that was not pooled
+  // when it shuts down, in place of
+  // [IsolateGroupSource::DecrementIsolateUsageCount]. Shuts down the pooled
+  // isolates if they are all that is left of the group.
+  //
+  // Must be called without a current isolate. Returns true if this was the
+  // last reference.
+  bool ReleaseIsolate();
+
+ private:
+  friend class IsolatePoolFillTask;
+
+  void ScheduleFillLocked();
+  void Fill();
+  Isolate* CreatePooledIsolate();
+
+  bool HasOnlyPooledIsolatesLocked();
+  void DrainLocked(MallocGrowableArray<Isolate*>* drained);
+  static void ShutdownIsolates(MallocGrowableArray<Isolate*>* isolates);
+
+  IsolateGroupSource* const source_;
+  Mutex mutex_;
+  MallocGrowableArray<Isolate*> isolates_;
+  intptr_t capacity_;
+  bool filling_;
+  bool draining_;
+
+  DISALLOW_COPY_AND_ASSIGN(IsolatePool);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_ISOLATE_POOL_H_
@@ -52,6 +52,11 @@ DEFINE_FLAG(bool,
             check_reloaded,
             false,
             "Assert that an isolate has reloaded at least once.")
+DEFINE_FLAG(bool,
+            reload_keep_optimized_code,
+            true,
+            "Keep the optimized code of unmodified libraries when it does not "
+            "refer to a modified library.");
 
 DECLARE_FLAG(bool, trace_deoptimization);
 
@@ -1519,6 +1524,7 @@ void IsolateReloadContext::Commit() {
         new_lib.set_native_entry_resolver(lib.native_entry_resolver());
         new_lib.set_native_entry_symbol_resolver(
             lib.native_entry_symbol_resolver());
+        new_lib.set_ffi_native_resolver(lib.ffi_native_resolver());
       }
     }
 
@@ -1548,39 +1554,30 @@ void IsolateReloadContext::Commit() {
   }
 
   {
-    MorphInstancesAndApplyNewClassTable();
-
     const GrowableObjectArray& become_enum_mappings =
         GrowableObjectArray::Handle(become_enum_mappings_);
     UnorderedHashMap<BecomeMapTraits> become_map(become_map_storage_);
-    intptr_t replacement_count =
-        become_map.NumOccupied() + become_enum_mappings.Length() / 2;
-    const Array& before =
-        Array::Handle(Array::New(replacement_count, Heap::kOld));
-    const Array& after =
-        Array::Handle(Array::New(replacement_count, Heap::kOld));
-    Object& obj = Object::Handle();
-    intptr_t replacement_index = 0;
+    Become become;
+    Object& before = Object::Handle();
+    Object& after = Object::Handle();
     UnorderedHashMap<BecomeMapTraits>::Iterator it(&become_map);
     while (it.MoveNext()) {
       const intptr_t entry = it.Current();
-      obj = become_map.GetKey(entry);
-      before.SetAt(replacement_index, obj);
-      obj = become_map.GetPayload(entry, 0);
-      after.SetAt(replacement_index, obj);
-      replacement_index++;
+      before = become_map.GetKey(entry);
+      after = become_map.GetPayload(entry, 0);
+      become.Add(before, after);
     }
     for (intptr_t i = 0; i < become_enum_mappings.Length(); i += 2) {
-      obj = become_enum_mappings.At(i);
-      before.SetAt(replacement_index, obj);
-      obj = become_enum_mappings.At(i + 1);
-      after.SetAt(replacement_index, obj);
-      replacement_index++;
+      before = become_enum_mappings.At(i);
+      after = become_enum_mappings.At(i + 1);
+      become.Add(before, after);
     }
-    ASSERT(replacement_index == replacement_count);
     become_map.Release();
 
-    Become::ElementsForwardIdentity(before, after);
+    // Morphing forwards these pairs together with the morphed instances, so
+    // that the heap is walked only once. This is a no-op if it already did.
+    MorphInstancesAndApplyNewClassTable(&become);
+    become.Forward();
   }
 
   // Rehash constants map for all classes. Constants are hashed by content, and
@@ -1677,7 +1674,8 @@ static bool HasNoTasks(Heap* heap) {
   return heap->old_space()->tasks() == 0;
 }
 
-void IsolateReloadContext::MorphInstancesAndApplyNewClassTable() {
+void IsolateReloadContext::MorphInstancesAndApplyNewClassTable(
+    Become* become) {
   TIMELINE_SCOPE(MorphInstances);
   if (!HasInstanceMorphers()) {
     // Fast path: no class had a shape change.
@@ -1723,15 +1721,12 @@ void IsolateReloadContext::MorphInstancesAndApplyNewClassTable() {
     instance_morphers_.At(i)->CreateMorphedCopies();
   }
 
-  // Create the inputs for Become.
+  // Add the morphed instances to the pairs to forward.
   intptr_t index = 0;
-  const Array& before = Array::Handle(Array::New(count));
-  const Array& after = Array::Handle(Array::New(count));
   for (intptr_t i = 0; i < instance_morphers_.length(); i++) {
     InstanceMorpher* morpher = instance_morphers_.At(i);
     for (intptr_t j = 0; j < morpher->before()->length(); j++) {
-      before.SetAt(index, *morpher->before()->At(j));
-      after.SetAt(index, *morpher->after()->At(j));
+      become->Add(*morpher->before()->At(j), *morpher->after()->At(j));
       index++;
     }
   }
@@ -1750,7 +1745,7 @@ void IsolateReloadContext::MorphInstancesAndApplyNewClassTable() {
   free(saved_class_table_);
   saved_class_table_ = nullptr;
 
-  Become::ElementsForwardIdentity(before, after);
+  become->Forward();
   // The heap now contains only instances with the new size. Ordinary GC is safe
   // again.
 }
@@ -1947,6 +1942,79 @@ class InvalidationCollector : public ObjectVisitor {
 
 typedef UnorderedHashMap<SmiTraits> IntHashMap;
 
+bool IsolateReloadContext::IsOwnedByDirtyLibrary(const Object& object) {
+  Zone* zone = Thread::Current()->zone();
+  Object& owner = Object::Handle(zone, object.raw());
+  if (owner.IsCode()) {
+    // E.g. the target of a static call or an allocation stub.
+    owner = Code::Cast(owner).owner();
+  }
+  Class& cls = Class::Handle(zone);
+  if (owner.IsFunction()) {
+    cls = Function::Cast(owner).Owner();
+  } else if (owner.IsField()) {
+    cls = Field::Cast(owner).Owner();
+  } else if (owner.IsClass()) {
+    cls ^= owner.raw();
+  } else if (owner.IsType()) {
+    cls = Type::Cast(owner).type_class();
+  } else {
+    return false;
+  }
+  const Library& lib = Library::Handle(zone, cls.library());
+  return !lib.IsNull() && IsDirty(lib);
+}
+
+bool IsolateReloadContext::CanKeepOptimizedCode(const Code& code) {
+#if defined(TARGET_ARCH_IA32)
+  // Without an object pool the embedded objects are not checked.
+  return false;
+#else
+  if (!FLAG_reload_keep_optimized_code || HasInstanceMorphers()) {
+    // Field offsets and allocation sizes may have changed.
+    return false;
+  }
+  // Code depending on field guards and CHA was deoptimized before the reload
+  // (see DeoptimizeDependentCode), and instance calls are reset. What remains
+  // is code inlined from, called directly or referenced in a modified
+  // library, which still refers to its old version.
+  Zone* zone = Thread::Current()->zone();
+  Object& object = Object::Handle(zone);
+  const Array& inlined = Array::Handle(zone, code.inlined_id_to_function());
+  for (intptr_t i = 0; !inlined.IsNull() && (i < inlined.Length()); i++) {
+    object = inlined.At(i);
+    if (IsOwnedByDirtyLibrary(object)) {
+      return false;
+    }
+  }
+  const Array& table = Array::Handle(zone, code.static_calls_target_table());
+  if (!table.IsNull()) {
+    StaticCallsTable static_calls(table);
+    for (auto& view : static_calls) {
+      object = view.Get<Code::kSCallTableFunctionTarget>();
+      if (IsOwnedByDirtyLibrary(object)) {
+        return false;
+      }
+      object = view.Get<Code::kSCallTableCodeTarget>();
+      if (IsOwnedByDirtyLibrary(object)) {
+        return false;
+      }
+    }
+  }
+  const ObjectPool& pool = ObjectPool::Handle(zone, code.object_pool());
+  for (intptr_t i = 0; i < pool.Length(); i++) {
+    if (pool.TypeAt(i) != ObjectPool::EntryType::kTaggedObject) {
+      continue;
+    }
+    object = pool.ObjectAt(i);
+    if (IsOwnedByDirtyLibrary(object)) {
+      return false;
+    }
+  }
+  return true;
+#endif  // defined(TARGET_ARCH_IA32)
+}
+
 void IsolateReloadContext::RunInvalidationVisitors() {
   TIMELINE_SCOPE(MarkAllFunctionsForRecompilation);
   TIR_Print("---- RUNNING INVALIDATION HEAP VISITORS\n");
@@ -1990,24 +2058,38 @@ void IsolateReloadContext::RunInvalidationVisitors() {
   Library& owning_lib = Library::Handle(zone);
   Code& code = Code::Handle(zone);
   Bytecode& bytecode = Bytecode::Handle(zone);
+  intptr_t kept_optimized_code = 0;
   for (intptr_t i = 0; i < functions.length(); i++) {
     const Function& func = *functions[i];
     if (func.IsSignatureFunction()) {
       continue;
     }
 
-    // Switch to unoptimized code or the lazy compilation stub.
-    func.SwitchToLazyCompiledUnoptimizedCode();
-
-    // Grab the current code.
-    code = func.CurrentCode();
-    ASSERT(!code.IsNull());
-    bytecode = func.bytecode();
-
     owning_class = func.Owner();
     owning_lib = owning_class.library();
     const bool clear_code = IsDirty(owning_lib);
-    const bool stub_code = code.IsStubCode();
+
+    // Switch to unoptimized code or the lazy compilation stub, unless the
+    // optimized code does not depend on the modified libraries.
+    if (func.HasOptimizedCode()) {
+      code = func.CurrentCode();
+      if (!clear_code && CanKeepOptimizedCode(code)) {
+        VTIR_Print("Keeping optimized code for %s\n", func.ToCString());
+        code.ResetICDatas(zone);
+        kept_optimized_code++;
+      } else {
+        func.SwitchToLazyCompiledUnoptimizedCode();
+      }
+    }
+
+    // Grab the unoptimized code, which is the current code unless the
+    // optimized code was kept.
+    code = func.HasOptimizedCode() ? func.unoptimized_code()
+                                   : func.CurrentCode();
+    ASSERT(!code.IsNull() || func.HasOptimizedCode());
+    bytecode = func.bytecode();
+
+    const bool stub_code = code.IsNull() || code.IsStubCode();
 
     // Zero edge counters.
     func.ZeroEdgeCounters();
@@ -2041,6 +2123,7 @@ void IsolateReloadContext::RunInvalidationVisitors() {
     func.set_optimized_instruction_count(0);
     func.set_optimized_call_site_count(0);
   }
+  TIR_Print("Kept optimized code for %" Pd " functions\n", kept_optimized_code);
 }
 
 void IsolateReloadContext::InvalidateWorld() {
@@ -39,6 +39,7 @@ DECLARE_FLAG(bool, trace_reload_verbose);
 namespace dart {
 
 class BitVector;
+class Become;
 class GrowableObjectArray;
 class Isolate;
 class Library;
@@ -245,7 +246,7 @@ class IsolateReloadContext {
 
   void CheckpointLibraries();
 
-  void MorphInstancesAndApplyNewClassTable();
+  void MorphInstancesAndApplyNewClassTable(Become* become);
 
   void RunNewFieldInitializers();
 
@@ -267,6 +268,8 @@ class IsolateReloadContext {
   void ClearReplacedObjectBits();
 
   // atomic_install:
+  bool IsOwnedByDirtyLibrary(const Object& object);
+  bool CanKeepOptimizedCode(const Code& code);
   void RunInvalidationVisitors();
   void ResetUnoptimizedICsOnStack();
   void ResetMegamorphicCaches();
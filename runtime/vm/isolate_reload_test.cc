@@ -5,6 +5,7 @@
 #include "include/dart_api.h"
 #include "include/dart_tools_api.h"
 #include "platform/assert.h"
+#include "vm/dart_api_impl.h"
 #include "vm/debugger_api_impl_test.h"
 #include "vm/globals.h"
 #include "vm/isolate.h"
@@ -199,6 +200,88 @@ TEST_CASE(IsolateReload_KernelIncrementalCompileAppAndLib) {
   EXPECT_EQ(24, value);
 }
 
+static bool HasOptimizedCode(Dart_Handle lib_handle, const char* name) {
+  TransitionNativeToVM transition(Thread::Current());
+  const Library& lib =
+      Library::Handle(Library::RawCast(Api::UnwrapHandle(lib_handle)));
+  const Function& function = Function::Handle(
+      lib.LookupLocalFunction(String::Handle(String::New(name))));
+  EXPECT(!function.IsNull());
+  return function.HasOptimizedCode();
+}
+
+TEST_CASE(IsolateReload_KeepsOptimizedCodeOfUnmodifiedLibrary) {
+  SetFlagScope<bool> sfs_background(&FLAG_background_compilation, false);
+  SetFlagScope<int> sfs_threshold(&FLAG_optimization_counter_threshold, 10);
+  // clang-format off
+  Dart_SourceFile sourcefiles[] = {
+    {
+      "file:///test-app.dart",
+      "import 'test-lib.dart';\n"
+      "import 'test-util.dart';\n"
+      "main() {\n"
+      "  int result = 0;\n"
+      "  for (int i = 0; i < 30; i++) {\n"
+      "    result = sum(10) + libValue();\n"
+      "  }\n"
+      "  return result;\n"
+      "}\n",
+    },
+    {
+      "file:///test-lib.dart",
+      "libValue() => 1;\n",
+    },
+    {
+      "file:///test-util.dart",
+      "int sum(int n) {\n"
+      "  int result = 0;\n"
+      "  for (int i = 0; i < n; i++) {\n"
+      "    result += i;\n"
+      "  }\n"
+      "  return result;\n"
+      "}\n",
+    }};
+  // clang-format on
+
+  Dart_Handle lib = TestCase::LoadTestScriptWithDFE(
+      sizeof(sourcefiles) / sizeof(Dart_SourceFile), sourcefiles,
+      NULL /* resolver */, true /* finalize */, true /* incrementally */);
+  EXPECT_VALID(lib);
+  EXPECT_EQ(46, SimpleInvoke(lib, "main"));
+  Dart_Handle util_lib =
+      Dart_LookupLibrary(NewString("file:///test-util.dart"));
+  EXPECT_VALID(util_lib);
+  EXPECT(HasOptimizedCode(util_lib, "sum"));
+
+  // clang-format off
+  Dart_SourceFile updated_sourcefiles[] = {
+    {
+      "file:///test-lib.dart",
+      "libValue() => 2;\n",
+    }};
+  // clang-format on
+
+  {
+    const uint8_t* kernel_buffer = NULL;
+    intptr_t kernel_buffer_size = 0;
+    char* error = TestCase::CompileTestScriptWithDFE(
+        "file:///test-app.dart",
+        sizeof(updated_sourcefiles) / sizeof(Dart_SourceFile),
+        updated_sourcefiles, &kernel_buffer, &kernel_buffer_size,
+        true /* incrementally */);
+    EXPECT(error == NULL);
+    EXPECT_NOTNULL(kernel_buffer);
+
+    lib = TestCase::ReloadTestKernel(kernel_buffer, kernel_buffer_size);
+    EXPECT_VALID(lib);
+  }
+  // The library that does not depend on the modified one keeps its code.
+  util_lib = Dart_LookupLibrary(NewString("file:///test-util.dart"));
+  EXPECT_VALID(util_lib);
+  EXPECT(HasOptimizedCode(util_lib, "sum"));
+  EXPECT_EQ(47, SimpleInvoke(lib, "main"));
+}
+
 TEST_CASE(IsolateReload_KernelIncrementalCompileGenerics) {
   // clang-format off
   Dart_SourceFile sourcefiles[] = {
@@ -0,0 +1,472 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/json_parser.h"
+
+#include "vm/double_conversion.h"
+#include "vm/handles.h"
+#include "vm/object_store.h"
+#include "vm/symbols.h"
+
+namespace dart {
+
+JsonParser::JsonParser(Thread* thread, const uint8_t* chars, intptr_t length)
+    : thread_(thread),
+      zone_(thread->zone()),
+      chars_(chars),
+      length_(length),
+      position_(0),
+      depth_(0),
+      map_type_arguments_(TypeArguments::ZoneHandle(
+          zone_,
+          thread->isolate()->object_store()->type_argument_string_dynamic())),
+      buffer_(zone_, 0) {
+  for (intptr_t i = 0; i < kKeyCacheSize; i++) {
+    key_cache_[i] = NULL;
+  }
+}
+
+bool JsonParser::Parse(Object* result) {
+  SkipWhitespace();
+  if (!ParseValue(result)) {
+    return false;
+  }
+  SkipWhitespace();
+  return position_ == length_;
+}
+
+void JsonParser::SkipWhitespace() {
+  while (position_ < length_) {
+    const uint8_t ch = chars_[position_];
+    if ((ch != ' ') && (ch != '\n') && (ch != '\r') && (ch != '\t')) {
+      return;
+    }
+    position_++;
+  }
+}
+
+bool JsonParser::ParseValue(Object* result) {
+  if (position_ == length_) {
+    return false;
+  }
+  switch (chars_[position_]) {
+    case '{':
+      return ParseObject(result);
+    case '[':
+      return ParseArray(result);
+    case '"':
+      position_++;
+      return ParseString(result, false);
+    case 't':
+      return ParseLiteral("true", Bool::True(), result);
+    case 'f':
+      return ParseLiteral("false", Bool::False(), result);
+    case 'n':
+      return ParseLiteral("null", Object::null_object(), result);
+    default:
+      return ParseNumber(result);
+  }
+}
+
+bool JsonParser::ParseLiteral(const char* literal,
+                              const Object& value,
+                              Object* result) {
+  const intptr_t length = strlen(literal);
+  if ((length_ - position_ < length) ||
+      (memcmp(chars_ + position_, literal, length) != 0)) {
+    return false;
+  }
+  position_ += length;
+  *result = value.raw();
+  return true;
+}
+
+bool JsonParser::ParseArray(Object* result) {
+  if (depth_ == kMaxDepth) {
+    return false;
+  }
+  depth_++;
+  position_++;
+  HANDLESCOPE(thread_);
+  const GrowableObjectArray& list =
+      GrowableObjectArray::Handle(zone_, GrowableObjectArray::New());
+  Object& element = Object::Handle(zone_);
+  SkipWhitespace();
+  if ((position_ < length_) && (chars_[position_] == ']')) {
+    position_++;
+  } else {
+    while (true) {
+      SkipWhitespace();
+      if (!ParseValue(&element)) {
+        return false;
+      }
+      list.Add(element);
+      SkipWhitespace();
+      if (position_ == length_) {
+        return false;
+      }
+      const uint8_t ch = chars_[position_++];
+      if (ch == ']') {
+        break;
+      }
+      if (ch != ',') {
+        return false;
+      }
+    }
+  }
+  depth_--;
+  *result = list.raw();
+  return true;
+}
+
+bool JsonParser::ParseObject(Object* result) {
+  if (depth_ == kMaxDepth) {
+    return false;
+  }
+  depth_++;
+  position_++;
+  HANDLESCOPE(thread_);
+  Array& data =
+      Array::Handle(zone_, Array::New(LinkedHashMap::kInitialIndexSize));
+  Object& key = Object::Handle(zone_);
+  Object& value = Object::Handle(zone_);
+  intptr_t used = 0;
+  SkipWhitespace();
+  if ((position_ < length_) && (chars_[position_] == '}')) {
+    position_++;
+  } else {
+    while (true) {
+      SkipWhitespace();
+      if ((position_ == length_) || (chars_[position_] != '"')) {
+        return false;
+      }
+      position_++;
+      if (!ParseString(&key, true)) {
+        return false;
+      }
+      SkipWhitespace();
+      if ((position_ == length_) || (chars_[position_] != ':')) {
+        return false;
+      }
+      position_++;
+      SkipWhitespace();
+      if (!ParseValue(&value)) {
+        return false;
+      }
+      if (used == data.Length()) {
+        data = Array::Grow(data, used << 1);
+      }
+      data.SetAt(used++, key);
+      data.SetAt(used++, value);
+      SkipWhitespace();
+      if (position_ == length_) {
+        return false;
+      }
+      const uint8_t ch = chars_[position_++];
+      if (ch == '}') {
+        break;
+      }
+      if (ch != ',') {
+        return false;
+      }
+    }
+  }
+  depth_--;
+  BuildMap(data, used, result);
+  return true;
+}
+
+void JsonParser::BuildMap(const Array& data, intptr_t used, Object* result) {
+  // Places the entries like _InternalLinkedHashMap's operator []= does, see
+  // lib/compact_hash.dart. The index has as many slots as 'data', a power of
+  // two which leaves it at most half full.
+  const intptr_t size = data.Length();
+  ASSERT(Utils::IsPowerOfTwo(size) && (used <= size));
+  const intptr_t size_mask = size - 1;
+  const intptr_t max_entries = size >> 1;
+  const intptr_t index_bits = Utils::ShiftForPowerOfTwo(size) - 1;
+#if defined(ARCH_IS_64_BIT)
+  const intptr_t hash_bits = 32 - index_bits;
+#else
+  const intptr_t hash_bits = 30 - index_bits;
+#endif
+  const intptr_t hash_mask = (static_cast<intptr_t>(1) << hash_bits) - 1;
+  const TypedData& index = TypedData::Handle(
+      zone_, TypedData::New(kTypedDataUint32ArrayCid, size));
+  String& key = String::Handle(zone_);
+  String& other = String::Handle(zone_);
+  Object& value = Object::Handle(zone_);
+  intptr_t entries = 0;
+  for (intptr_t i = 0; i < used; i += 2) {
+    key ^= data.At(i);
+    value = data.At(i + 1);
+    const intptr_t full_hash = key.Hash();
+    const intptr_t masked_hash = full_hash & hash_mask;
+    const intptr_t hash_pattern =
+        (masked_hash == 0) ? max_entries : masked_hash * max_entries;
+    intptr_t probe = full_hash & size_mask;
+    probe = ((probe << 1) + probe) & size_mask;
+    while (true) {
+      const uint32_t pair = index.GetUint32(probe << 2);
+      if (pair == 0) {
+        // Entries only move towards the front of 'data'.
+        index.SetUint32(probe << 2, hash_pattern | entries);
+        data.SetAt(entries << 1, key);
+        data.SetAt((entries << 1) + 1, value);
+        entries++;
+        break;
+      }
+      const intptr_t entry = hash_pattern ^ pair;
+      if (entry < max_entries) {
+        other ^= data.At(entry << 1);
+        if ((other.raw() == key.raw()) || other.Equals(key)) {
+          data.SetAt((entry << 1) + 1, value);
+          break;
+        }
+      }
+      probe = (probe + 1) & size_mask;
+    }
+  }
+  for (intptr_t i = entries << 1; i < used; i++) {
+    data.SetAt(i, Object::null_object());
+  }
+  const LinkedHashMap& map = LinkedHashMap::Handle(
+      zone_, LinkedHashMap::New(data, index, hash_mask, entries << 1, 0));
+  map.SetTypeArguments(map_type_arguments_);
+  *result = map.raw();
+}
+
+intptr_t JsonParser::FindStringEnd(intptr_t position) const {
+  // Tests a word of characters at a time for a quote, a backslash or a
+  // control character. A lane below 'n' has its top bit set in
+  // (lane - n) & ~lane, and a matching lane is turned into zero by the xor.
+  const uword kLaneOnes = kUwordMax / 0xFF;
+  const uword kLaneTops = kLaneOnes << 7;
+  const uword kQuotes = kLaneOnes * '"';
+  const uword kBackslashes = kLaneOnes * '\\';
+  const uword kSpaces = kLaneOnes * ' ';
+  while (position + kWordSize <= length_) {
+    const uword word =
+        ReadUnaligned(reinterpret_cast<const uword*>(chars_ + position));
+    const uword quotes = word ^ kQuotes;
+    const uword backslashes = word ^ kBackslashes;
+    const uword found = ((quotes - kLaneOnes) & ~quotes) |
+                        ((backslashes - kLaneOnes) & ~backslashes) |
+                        ((word - kSpaces) & ~word);
+    if ((found & kLaneTops) != 0) {
+      break;
+    }
+    position += kWordSize;
+  }
+  while (position < length_) {
+    const uint8_t ch = chars_[position];
+    if ((ch == '"') || (ch == '\\') || (ch < ' ')) {
+      break;
+    }
+    position++;
+  }
+  return position;
+}
+
+bool JsonParser::ParseString(Object* result, bool is_key) {
+  const intptr_t start = position_;
+  const intptr_t end = FindStringEnd(start);
+  if (end == length_) {
+    return false;
+  }
+  if (chars_[end] == '\\') {
+    return ParseEscapedString(start, result);
+  }
+  if (chars_[end] != '"') {
+    return false;
+  }
+  position_ = end + 1;
+  const uint8_t* chars = chars_ + start;
+  const intptr_t length = end - start;
+  if (length == 0) {
+    *result = Symbols::Empty().raw();
+    return true;
+  }
+  if (!is_key) {
+    *result = OneByteString::New(chars, length, Heap::kNew);
+    return true;
+  }
+  uint32_t hash = length;
+  for (intptr_t i = 0; i < length; i++) {
+    hash = (hash * 31) + chars[i];
+  }
+  String** cached = &key_cache_[hash & (kKeyCacheSize - 1)];
+  if ((*cached != NULL) && (*cached)->EqualsLatin1(chars, length)) {
+    *result = (*cached)->raw();
+    return true;
+  }
+  *result = OneByteString::New(chars, length, Heap::kNew);
+  if (*cached == NULL) {
+    *cached = &String::ZoneHandle(zone_);
+  }
+  **cached ^= result->raw();
+  return true;
+}
+
+static intptr_t HexDigitValue(uint8_t ch) {
+  if ((ch >= '0') && (ch <= '9')) return ch - '0';
+  if ((ch >= 'a') && (ch <= 'f')) return ch - 'a' + 10;
+  if ((ch >= 'A') && (ch <= 'F')) return ch - 'A' + 10;
+  return -1;
+}
+
+bool JsonParser::ParseEscapedString(intptr_t start, Object* result) {
+  buffer_.Clear();
+  uint16_t bits = 0;
+  intptr_t position = start;
+  while (true) {
+    const intptr_t end = FindStringEnd(position);
+    if (end == length_) {
+      return false;
+    }
+    for (intptr_t i = position; i < end; i++) {
+      buffer_.Add(chars_[i]);
+    }
+    if (chars_[end] == '"') {
+      position_ = end + 1;
+      break;
+    }
+    if ((chars_[end] != '\\') || (end + 1 == length_)) {
+      return false;
+    }
+    uint16_t ch;
+    position = end + 2;
+    switch (chars_[end + 1]) {
+      case '"':
+      case '\\':
+      case '/':
+        ch = chars_[end + 1];
+        break;
+      case 'b':
+        ch = '\b';
+        break;
+      case 'f':
+        ch = '\f';
+        break;
+      case 'n':
+        ch = '\n';
+        break;
+      case 'r':
+        ch = '\r';
+        break;
+      case 't':
+        ch = '\t';
+        break;
+      case 'u': {
+        if (length_ - position < 4) {
+          return false;
+        }
+        intptr_t value = 0;
+        for (intptr_t i = 0; i < 4; i++) {
+          const intptr_t digit = HexDigitValue(chars_[position + i]);
+          if (digit < 0) {
+            return false;
+          }
+          value = (value << 4) | digit;
+        }
+        position += 4;
+        ch = static_cast<uint16_t>(value);
+        break;
+      }
+      default:
+        return false;
+    }
+    buffer_.Add(ch);
+  }
+  for (intptr_t i = 0; i < buffer_.length(); i++) {
+    bits |= buffer_[i];
+  }
+  // Unpaired surrogates are kept as they are, like the Dart parser does.
+  if (bits <= 0xFF) {
+    *result = OneByteString::New(buffer_.data(), buffer_.length(), Heap::kNew);
+  } else {
+    *result = TwoByteString::New(buffer_.data(), buffer_.length(), Heap::kNew);
+  }
+  return true;
+}
+
+bool JsonParser::ParseNumber(Object* result) {
+  // Format: '-'?('0'|[1-9][0-9]*)('.'[0-9]+)?([eE][+-]?[0-9]+)?
+  const intptr_t start = position_;
+  intptr_t position = start;
+  const bool negative = chars_[position] == '-';
+  if (negative) {
+    position++;
+  }
+  const intptr_t digits_start = position;
+  if ((position < length_) && (chars_[position] == '0')) {
+    position++;
+  } else {
+    while ((position < length_) && Utils::IsDecimalDigit(chars_[position])) {
+      position++;
+    }
+  }
+  const intptr_t digits_end = position;
+  if (digits_start == digits_end) {
+    return false;
+  }
+  bool is_double = false;
+  if ((position < length_) && (chars_[position] == '.')) {
+    is_double = true;
+    position++;
+    const intptr_t fraction_start = position;
+    while ((position < length_) && Utils::IsDecimalDigit(chars_[position])) {
+      position++;
+    }
+    if (position == fraction_start) {
+      return false;
+    }
+  }
+  if ((position < length_) && ((chars_[position] | 0x20) == 'e')) {
+    is_double = true;
+    position++;
+    if ((position < length_) &&
+        ((chars_[position] == '+') || (chars_[position] == '-'))) {
+      position++;
+    }
+    const intptr_t exponent_start = position;
+    while ((position < length_) && Utils::IsDecimalDigit(chars_[position])) {
+      position++;
+    }
+    if (position == exponent_start) {
+      return false;
+    }
+  }
+  position_ = position;
+
+  if (!is_double) {
+    // Integer literals that do not fit in 64 bits become doubles, as in the
+    // Dart parser.
+    const uint64_t limit =
+        negative ? (static_cast<uint64_t>(1) << 63) : kMaxInt64;
+    uint64_t value = 0;
+    intptr_t i = digits_start;
+    for (; i < digits_end; i++) {
+      const uint64_t digit = chars_[i] - '0';
+      if (value > (limit - digit) / 10) {
+        break;
+      }
+      value = (value * 10) + digit;
+    }
+    if (i == digits_end) {
+      *result = Integer::New(negative ? static_cast<int64_t>(0 - value)
+                                      : static_cast<int64_t>(value));
+      return true;
+    }
+  }
+  double value;
+  if (!CStringToDouble(reinterpret_cast<const char*>(chars_ + start),
+                       position - start, &value)) {
+    return false;
+  }
+  *result = Double::New(value);
+  return true;
+}
+
+}  // namespace dart
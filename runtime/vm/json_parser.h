@@ -0,0 +1,70 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_JSON_PARSER_H_
+#define RUNTIME_VM_JSON_PARSER_H_
+
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+#include "vm/object.h"
+
+namespace dart {
+
+// Parses JSON text into the objects `jsonDecode` builds without a reviver:
+// an _InternalLinkedHashMap<String, dynamic> for each object, a growable
+// list for each array, and strings, ints, doubles, booleans and null.
+//
+// The parser only reports whether the text was parsed. Malformed text and
+// text nested deeper than kMaxDepth are left to the Dart parser, which
+// reports errors with their position.
+class JsonParser : public ValueObject {
+ public:
+  // Nesting limit, which bounds the native stack used by the parser.
+  static const intptr_t kMaxDepth = 256;
+
+  // 'chars' holds the Latin-1 encoded text. It must not be in the Dart
+  // heap, since parsing allocates.
+  JsonParser(Thread* thread, const uint8_t* chars, intptr_t length);
+
+  // Sets 'result' to the value of the text and returns true, or returns
+  // false if the text is not parsed.
+  bool Parse(Object* result);
+
+ private:
+  // Object keys are canonicalized through a direct-mapped cache, so that
+  // the keys repeated across the objects of a document share one string and
+  // its hash code.
+  static const intptr_t kKeyCacheSize = 128;
+
+  bool ParseValue(Object* result);
+  bool ParseObject(Object* result);
+  bool ParseArray(Object* result);
+  bool ParseString(Object* result, bool is_key);
+  bool ParseEscapedString(intptr_t start, Object* result);
+  bool ParseNumber(Object* result);
+  bool ParseLiteral(const char* literal, const Object& value, Object* result);
+
+  // Creates the map for the 'used' key/value slots of 'data'. Later values
+  // of a repeated key replace earlier ones, as in jsonDecode.
+  void BuildMap(const Array& data, intptr_t used, Object* result);
+
+  void SkipWhitespace();
+  intptr_t FindStringEnd(intptr_t position) const;
+
+  Thread* thread_;
+  Zone* zone_;
+  const uint8_t* chars_;
+  const intptr_t length_;
+  intptr_t position_;
+  intptr_t depth_;
+  const TypeArguments& map_type_arguments_;
+  GrowableArray<uint16_t> buffer_;
+  String* key_cache_[kKeyCacheSize];
+
+  DISALLOW_COPY_AND_ASSIGN(JsonParser);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_JSON_PARSER_H_
@@ -0,0 +1,88 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/json_parser.h"
+
+#include "platform/assert.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+static bool ParseJson(const char* text, Object* result) {
+  JsonParser parser(Thread::Current(), reinterpret_cast<const uint8_t*>(text),
+                    strlen(text));
+  return parser.Parse(result);
+}
+
+ISOLATE_UNIT_TEST_CASE(JsonParser_Values) {
+  Object& result = Object::Handle();
+  EXPECT(ParseJson(" null ", &result));
+  EXPECT(result.IsNull());
+  EXPECT(ParseJson("true", &result));
+  EXPECT(result.raw() == Bool::True().raw());
+  EXPECT(ParseJson("-0", &result));
+  EXPECT(result.IsSmi() && (Smi::Cast(result).Value() == 0));
+  EXPECT(ParseJson("-9223372036854775808", &result));
+  EXPECT(result.IsMint() && (Mint::Cast(result).value() == kMinInt64));
+  EXPECT(ParseJson("9223372036854775808", &result));
+  EXPECT(result.IsDouble());
+  EXPECT(ParseJson("1.5e3", &result));
+  EXPECT(result.IsDouble() && (Double::Cast(result).value() == 1500.0));
+  EXPECT(ParseJson("\"a\\u00e9\\n\"", &result));
+  EXPECT(String::Cast(result).IsOneByteString());
+  EXPECT(String::Cast(result).Equals("a\xC3\xA9\n"));
+  EXPECT(ParseJson("\"\\u20ac\"", &result));
+  EXPECT(String::Cast(result).IsTwoByteString());
+  EXPECT_EQ(0x20AC, String::Cast(result).CharAt(0));
+}
+
+ISOLATE_UNIT_TEST_CASE(JsonParser_Containers) {
+  Object& result = Object::Handle();
+  EXPECT(ParseJson("[{\"key\": 1, \"other\": 2, \"key\": 3}, {\"key\": []}]",
+                   &result));
+  EXPECT(result.IsGrowableObjectArray());
+  const GrowableObjectArray& list = GrowableObjectArray::Cast(result);
+  EXPECT_EQ(2, list.Length());
+  const LinkedHashMap& first =
+      LinkedHashMap::Handle(LinkedHashMap::RawCast(list.At(0)));
+  const LinkedHashMap& second =
+      LinkedHashMap::Handle(LinkedHashMap::RawCast(list.At(1)));
+  // The repeated key keeps its place and takes the last value.
+  EXPECT_EQ(2, first.Length());
+  const Array& data = Array::Handle(first.data());
+  EXPECT(String::Handle(String::RawCast(data.At(0))).Equals("key"));
+  EXPECT_EQ(3, Smi::Value(Smi::RawCast(data.At(1))));
+  // Keys are shared between objects.
+  const Array& other_data = Array::Handle(second.data());
+  EXPECT(data.At(0) == other_data.At(0));
+  EXPECT(other_data.At(1)->IsGrowableObjectArray());
+}
+
+ISOLATE_UNIT_TEST_CASE(JsonParser_Malformed) {
+  const char* malformed[] = {"",        "[1,]",   "{\"a\" 1}", "01",
+                             "1.",      "-",      "\"\x01\"",  "\"\\x\"",
+                             "\"\\u12", "[] []", "tru",       "{1: 2}"};
+  Object& result = Object::Handle();
+  for (intptr_t i = 0; i < static_cast<intptr_t>(ARRAY_SIZE(malformed)); i++) {
+    EXPECT(!ParseJson(malformed[i], &result));
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(JsonParser_Depth) {
+  Zone* zone = thread->zone();
+  const intptr_t depth = JsonParser::kMaxDepth + 1;
+  char* text = zone->Alloc<char>(2 * depth + 1);
+  for (intptr_t i = 0; i < depth; i++) {
+    text[i] = '[';
+    text[depth + i] = ']';
+  }
+  text[2 * depth] = '\0';
+  Object& result = Object::Handle();
+  EXPECT(!ParseJson(text, &result));
+  // One level less is within the limit.
+  text[2 * depth - 1] = '\0';
+  EXPECT(ParseJson(text + 1, &result));
+}
+
+}  // namespace dart
@@ -55,6 +55,18 @@ TEST_CASE(JSON_JSONStream_Primitives) {
     }
     EXPECT_STREQ("[4]", js.ToCString());
   }
+  {
+    JSONStream js;
+    {
+      JSONArray jsarr(&js);
+      jsarr.AddValue(static_cast<intptr_t>(0));
+      jsarr.AddValue(static_cast<intptr_t>(-1));
+      jsarr.AddValue64(9007199254740991);
+      jsarr.AddValue64(-9007199254740991);
+    }
+    EXPECT_STREQ("[0,-1,9007199254740991,-9007199254740991]",
+                 js.ToCString());
+  }
   {
     JSONStream js;
     {
@@ -201,6 +213,18 @@ TEST_CASE(JSON_JSONStream_EscapedString) {
   EXPECT_STREQ("[\"Hel\\\"\\\"lo\\r\\n\\t\"]", js.ToCString());
 }
 
+TEST_CASE(JSON_JSONStream_EscapedStringRuns) {
+  JSONStream js;
+  {
+    JSONArray jsarr(&js);
+    jsarr.AddValue("plain text");
+    jsarr.AddValue("a/b\\c\x01éd");
+    jsarr.AddValue("");
+  }
+  EXPECT_STREQ("[\"plain text\",\"a\\/b\\\\c\\u0001éd\",\"\"]",
+               js.ToCString());
+}
+
 TEST_CASE(JSON_JSONStream_DartString) {
   const char* kScriptChars =
       "var ascii = 'Hello, World!';\n"
@@ -210,7 +234,8 @@ TEST_CASE(JSON_JSONStream_DartString) {
       "var surrogates = '\\u{1D11E}\\u{1D11E}\\u{1D11E}"
       "\\u{1D11E}\\u{1D11E}';\n"
       "var wrongEncoding = '\\u{1D11E}' + surrogates[0] + '\\u{1D11E}';"
-      "var nullInMiddle = 'This has\\u0000 four words.';";
+      "var nullInMiddle = 'This has\\u0000 four words.';"
+      "var latin1 = 'a/\\\"b\\u00E9\\n';";
 
   Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
   EXPECT_VALID(lib);
@@ -260,6 +285,7 @@ TEST_CASE(JSON_JSONStream_DartString) {
   do_test("surrogates", "{\"surrogates\":\"𝄞𝄞𝄞𝄞𝄞\"}");
   do_test("wrongEncoding", "{\"wrongEncoding\":\"𝄞\\uD834𝄞\"}");
   do_test("nullInMiddle", "{\"nullInMiddle\":\"This has\\u0000 four words.\"}");
+  do_test("latin1", "{\"latin1\":\"a\\/\\\"bé\\n\"}");
 }
 
 TEST_CASE(JSON_JSONStream_Params) {
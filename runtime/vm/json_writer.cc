@@ -32,6 +32,40 @@ class MaybeOnStackBuffer {
   char buffer_[kOnStackBufferCapacity];
 };
 
+// Whether the ASCII character [ch] is written as is in JSON strings.
+static inline bool IsUnescapedAscii(uint32_t ch) {
+  return (ch >= 0x20) && (ch < 0x80) && (ch != '"') && (ch != '\\') &&
+         (ch != '/');
+}
+
+// Returns the length of the prefix of [s] that is written as is, so that it
+// can be copied at once instead of escaping it character by character.
+static intptr_t UnescapedPrefixLength(const uint8_t* s, intptr_t len) {
+  intptr_t i = 0;
+  while ((i < len) && IsUnescapedAscii(s[i])) {
+    i++;
+  }
+  return i;
+}
+
+// Appends [value] in decimal without going through printf.
+static void AddInt64(TextBuffer* buffer, int64_t value) {
+  // 19 digits and the sign.
+  char digits[20];
+  uint64_t magnitude = (value < 0) ? -static_cast<uint64_t>(value)
+                                   : static_cast<uint64_t>(value);
+  char* const end = &digits[0] + sizeof(digits);
+  char* start = end;
+  do {
+    *--start = '0' + static_cast<char>(magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+  if (value < 0) {
+    *--start = '-';
+  }
+  buffer->AddRaw(reinterpret_cast<const uint8_t*>(start), end - start);
+}
+
 JSONWriter::JSONWriter(intptr_t buf_size)
     : open_objects_(0), buffer_(buf_size) {}
 
@@ -97,24 +131,24 @@ void JSONWriter::CloseArray() {
 
 void JSONWriter::PrintValueNull() {
   PrintCommaIfNeeded();
-  buffer_.Printf("null");
+  buffer_.AddString("null");
 }
 
 void JSONWriter::PrintValueBool(bool b) {
   PrintCommaIfNeeded();
-  buffer_.Printf("%s", b ? "true" : "false");
+  buffer_.AddString(b ? "true" : "false");
 }
 
 void JSONWriter::PrintValue(intptr_t i) {
   EnsureIntegerIsRepresentableInJavaScript(static_cast<int64_t>(i));
   PrintCommaIfNeeded();
-  buffer_.Printf("%" Pd "", i);
+  AddInt64(&buffer_, i);
 }
 
 void JSONWriter::PrintValue64(int64_t i) {
   EnsureIntegerIsRepresentableInJavaScript(i);
   PrintCommaIfNeeded();
-  buffer_.Printf("%" Pd64 "", i);
+  AddInt64(&buffer_, i);
 }
 
 void JSONWriter::PrintValue(double d) {
@@ -124,7 +158,7 @@ void JSONWriter::PrintValue(double d) {
   char buffer[kBufferLen];
   DoubleToCString(d, buffer, kBufferLen);
   PrintCommaIfNeeded();
-  buffer_.Printf("%s", buffer);
+  buffer_.AddString(buffer);
 }
 
 static const char base64_digits[65] =
@@ -180,7 +214,7 @@ bool JSONWriter::PrintValueStr(const String& s,
 
 void JSONWriter::PrintValueNoEscape(const char* s) {
   PrintCommaIfNeeded();
-  buffer_.Printf("%s", s);
+  buffer_.AddString(s);
 }
 
 void JSONWriter::PrintfValue(const char* format, ...) {
@@ -351,6 +385,14 @@ void JSONWriter::AddEscapedUTF8String(const char* s, intptr_t len) {
   const uint8_t* s8 = reinterpret_cast<const uint8_t*>(s);
   intptr_t i = 0;
   for (; i < len;) {
+    const intptr_t unescaped = UnescapedPrefixLength(&s8[i], len - i);
+    if (unescaped > 0) {
+      buffer_.AddRaw(&s8[i], unescaped);
+      i += unescaped;
+      if (i == len) {
+        break;
+      }
+    }
     // Extract next UTF8 character.
     int32_t ch = 0;
     int32_t ch_len = Utf8::Decode(&s8[i], len - i, &ch);
@@ -374,6 +416,23 @@ bool JSONWriter::AddDartString(const String& s,
     count = length - offset;
   }
   intptr_t limit = offset + count;
+  if (s.IsOneByteString()) {
+    // Latin-1 has no surrogates, and ASCII runs are copied at once.
+    NoSafepointScope no_safepoint;
+    intptr_t i = offset;
+    while (i < limit) {
+      const uint8_t* chars = OneByteString::CharAddr(s, i);
+      const intptr_t unescaped = UnescapedPrefixLength(chars, limit - i);
+      if (unescaped > 0) {
+        buffer_.AddRaw(chars, unescaped);
+        i += unescaped;
+      } else {
+        buffer_.EscapeAndAddCodeUnit(*chars);
+        i++;
+      }
+    }
+    return (offset > 0) || (limit < length);
+  }
   for (intptr_t i = offset; i < limit; i++) {
     uint16_t code_unit = s.CharAt(i);
     if (Utf16::IsTrailSurrogate(code_unit)) {
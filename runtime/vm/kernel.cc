@@ -308,6 +308,13 @@ static void CollectBytecodeFunctionTokenPositions(
         closure ^= object.raw();
         if ((closure.kind() == RawFunction::kClosureFunction) &&
             (closure.IsLocalFunction())) {
+          if (!closure.HasBytecode()) {
+            const Object& result = Object::Handle(
+                zone, BytecodeReader::ReadFunctionBytecode(thread, closure));
+            if (!result.IsNull()) {
+              Exceptions::PropagateError(Error::Cast(result));
+            }
+          }
           bytecode = closure.bytecode();
           ASSERT(!bytecode.IsNull());
           if (bytecode.HasSourcePositions()) {
@@ -320,6 +327,34 @@ static void CollectBytecodeFunctionTokenPositions(
   }
 }
 
+// Returns false if none of the declarations of |lib| can come from |script|,
+// judging by the source files recorded for |lib| by the kernel loader.
+// Libraries without that record (e.g. those declared in bytecode) may
+// contain any script.
+static bool LibraryMayContainScript(Zone* zone,
+                                    const Library& lib,
+                                    const Script& script) {
+  const GrowableObjectArray& owned_scripts =
+      GrowableObjectArray::Handle(zone, lib.owned_scripts());
+  if (owned_scripts.IsNull() || (owned_scripts.Length() == 0)) {
+    return true;
+  }
+  Object& entry = Object::Handle(zone, lib.toplevel_class());
+  if (!entry.IsNull() && (Class::Cast(entry).script() == script.raw())) {
+    return true;
+  }
+  for (intptr_t i = 0; i < owned_scripts.Length(); i++) {
+    entry = owned_scripts.At(i);
+    if (entry.IsClass()) {
+      entry = Class::Cast(entry).script();
+    }
+    if (entry.raw() == script.raw()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void CollectTokenPositionsFor(const Script& interesting_script) {
   Thread* thread = Thread::Current();
   Zone* zone = thread->zone();
@@ -342,6 +377,11 @@ void CollectTokenPositionsFor(const Script& interesting_script) {
   auto& temp_function = Function::Handle(zone);
   for (intptr_t i = 0; i < libs.Length(); i++) {
     lib ^= libs.At(i);
+    // Avoid finalizing the top-level class, and so loading all top-level
+    // members, of libraries that cannot declare anything in the script.
+    if (!LibraryMayContainScript(zone, lib, interesting_script)) {
+      continue;
+    }
     lib.EnsureTopLevelClassIsFinalized();
     DictionaryIterator it(lib);
     while (it.HasNext()) {
@@ -20,6 +20,7 @@
 #include "vm/object_store.h"
 #include "vm/port.h"
 #include "vm/service.h"
+#include "vm/startup_phases.h"
 #include "vm/symbols.h"
 #include "vm/thread_pool.h"
 #include "vm/timeline.h"
@@ -328,8 +329,15 @@ void KernelIsolate::InitializingFailed() {
 Dart_Port KernelIsolate::WaitForKernelPort() {
   VMTagScope tagScope(Thread::Current(), VMTag::kLoadWaitTagId);
   MonitorLocker ml(monitor_);
-  while (state_ == kStarting && (kernel_port_ == ILLEGAL_PORT)) {
-    ml.Wait();
+  if (state_ == kStarting && (kernel_port_ == ILLEGAL_PORT)) {
+#if defined(SUPPORT_TIMELINE)
+    // Startup of the kernel isolate that the caller is serialized behind.
+    TimelineDurationScope tds(Timeline::GetVMStream(), "WaitForKernelIsolate");
+#endif  // SUPPORT_TIMELINE
+    STARTUP_PHASE("WaitForKernelIsolate");
+    while (state_ == kStarting && (kernel_port_ == ILLEGAL_PORT)) {
+      ml.Wait();
+    }
   }
   return kernel_port_;
 }
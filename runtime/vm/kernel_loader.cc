@@ -14,16 +14,26 @@
 #include "vm/flags.h"
 #include "vm/heap/heap.h"
 #include "vm/kernel_binary.h"
+#include "vm/lockers.h"
 #include "vm/longjump.h"
 #include "vm/object_store.h"
 #include "vm/parser.h"
 #include "vm/reusable_handles.h"
 #include "vm/service_isolate.h"
+#include "vm/startup_phases.h"
 #include "vm/symbols.h"
 #include "vm/thread.h"
+#include "vm/thread_pool.h"
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
 namespace dart {
+
+DEFINE_FLAG(int,
+            kernel_loader_tasks,
+            2,
+            "The number of helper tasks that decode the line starts of the "
+            "scripts in a kernel binary while it is being loaded.");
+
 namespace kernel {
 
 #define Z (zone_)
@@ -185,6 +195,172 @@ void ClassIndex::Init(intptr_t class_offset, intptr_t class_size) {
 
 using UriToSourceTable = DirectChainedHashMap<UriToSourceTableTrait>;
 
+// Source tables smaller than this are decoded on the mutator only.
+static const intptr_t kMinScriptsForLineStartsTasks = 32;
+
+// Decodes the delta encoded line starts of a kernel binary's source table on
+// helper threads while the mutator creates the scripts. Decoding only reads
+// the binary, so the helpers need no Thread; the mutator copies the decoded
+// deltas into the heap, or reads the binary itself for entries that no
+// helper has finished yet.
+class LineStartsDecoder : public ValueObject {
+ public:
+  LineStartsDecoder(Program* program, KernelReaderHelper* helper)
+      : kernel_data_(program->kernel_data()),
+        kernel_data_size_(program->kernel_data_size()),
+        length_(helper->SourceTableSize()),
+        entries_(NULL),
+        next_entry_(0),
+        num_running_(0) {
+    const intptr_t num_tasks = FLAG_kernel_loader_tasks;
+    if ((num_tasks <= 0) || (length_ < kMinScriptsForLineStartsTasks)) {
+      return;
+    }
+    entries_ = reinterpret_cast<Entry*>(calloc(length_, sizeof(Entry)));
+    for (intptr_t i = 0; i < length_; i++) {
+      entries_[i].source_info_offset = helper->GetOffsetForSourceInfo(i);
+    }
+    num_running_ = num_tasks;
+    for (intptr_t i = 0; i < num_tasks; i++) {
+      if (!Dart::thread_pool()->Run<Task>(this)) {
+        MonitorLocker ml(&monitor_);
+        num_running_--;
+      }
+    }
+  }
+
+  ~LineStartsDecoder() {
+    if (entries_ == NULL) {
+      return;
+    }
+    // Stop the helpers from claiming further entries and wait for the ones
+    // still decoding.
+    AtomicOperations::StoreRelease(&next_entry_,
+                                   static_cast<uintptr_t>(length_));
+    {
+      MonitorLocker ml(&monitor_);
+      while (num_running_ > 0) {
+        ml.Wait();
+      }
+    }
+    for (intptr_t i = 0; i < length_; i++) {
+      free(entries_[i].deltas);
+    }
+    free(entries_);
+  }
+
+  // Returns the line starts of the script at |index| if a helper has decoded
+  // them, or null if the caller has to read them from the binary.
+  RawTypedData* TakeLineStarts(intptr_t index) {
+    if (entries_ == NULL) {
+      return TypedData::null();
+    }
+    Entry* entry = &entries_[index];
+    // Claim the entry if it is still pending so that no helper decodes it
+    // after the mutator has read it itself.
+    if (AtomicOperations::CompareAndSwapWord(&entry->state, kPending,
+                                             kClaimed) == kPending) {
+      return TypedData::null();
+    }
+    if (AtomicOperations::LoadAcquire(&entry->state) != kDecoded) {
+      return TypedData::null();
+    }
+    const intptr_t count = entry->count;
+    const intptr_t cid =
+        (entry->max_delta <= kMaxInt8)
+            ? kTypedDataInt8ArrayCid
+            : ((entry->max_delta <= kMaxInt16) ? kTypedDataInt16ArrayCid
+                                               : kTypedDataInt32ArrayCid);
+    const TypedData& line_starts =
+        TypedData::Handle(TypedData::New(cid, count, Heap::kOld));
+    for (intptr_t i = 0; i < count; i++) {
+      const int32_t delta = entry->deltas[i];
+      if (cid == kTypedDataInt8ArrayCid) {
+        line_starts.SetInt8(i, static_cast<int8_t>(delta));
+      } else if (cid == kTypedDataInt16ArrayCid) {
+        line_starts.SetInt16(i << 1, static_cast<int16_t>(delta));
+      } else {
+        line_starts.SetInt32(i << 2, delta);
+      }
+    }
+    return line_starts.raw();
+  }
+
+ private:
+  enum State : uword { kPending = 0, kClaimed, kDecoded };
+
+  struct Entry {
+    intptr_t source_info_offset;
+    uword state;
+    int32_t* deltas;
+    intptr_t count;
+    int32_t max_delta;
+  };
+
+  class Task : public ThreadPool::Task {
+   public:
+    explicit Task(LineStartsDecoder* decoder) : decoder_(decoder) {}
+
+    virtual void Run() {
+      decoder_->DecodeEntries();
+      MonitorLocker ml(&decoder_->monitor_);
+      decoder_->num_running_--;
+      ml.Notify();
+    }
+
+   private:
+    LineStartsDecoder* decoder_;
+
+    DISALLOW_COPY_AND_ASSIGN(Task);
+  };
+
+  void DecodeEntries() {
+    Reader reader(kernel_data_, kernel_data_size_);
+    while (true) {
+      const intptr_t index =
+          AtomicOperations::FetchAndIncrement(&next_entry_);
+      if (index >= length_) {
+        return;
+      }
+      Entry* entry = &entries_[index];
+      if (AtomicOperations::CompareAndSwapWord(&entry->state, kPending,
+                                               kClaimed) != kPending) {
+        continue;
+      }
+      reader.set_offset(entry->source_info_offset);
+      intptr_t size = reader.ReadUInt();  // read uri List<byte> size.
+      reader.set_offset(reader.offset() + size);
+      size = reader.ReadUInt();  // read source List<byte> size.
+      reader.set_offset(reader.offset() + size);
+      const intptr_t count = reader.ReadUInt();
+      int32_t* deltas =
+          reinterpret_cast<int32_t*>(malloc(count * sizeof(int32_t)));
+      int32_t max_delta = 0;
+      for (intptr_t i = 0; i < count; i++) {
+        const int32_t delta = reader.ReadUInt();
+        deltas[i] = delta;
+        max_delta = Utils::Maximum(max_delta, delta);
+      }
+      entry->deltas = deltas;
+      entry->count = count;
+      entry->max_delta = max_delta;
+      AtomicOperations::StoreRelease(&entry->state,
+                                     static_cast<uword>(kDecoded));
+    }
+  }
+
+  const uint8_t* kernel_data_;
+  const intptr_t kernel_data_size_;
+  const intptr_t length_;
+  Entry* entries_;
+  uintptr_t next_entry_;
+  Monitor monitor_;
+  intptr_t num_running_;
+
+  DISALLOW_COPY_AND_ASSIGN(LineStartsDecoder);
+};
+
+
 KernelLoader::KernelLoader(Program* program,
                            UriToSourceTable* uri_to_source_table)
     : program_(program),
@@ -234,6 +410,7 @@ Object& KernelLoader::LoadEntireProgram(Program* program,
                                         bool process_pending_classes) {
   Thread* thread = Thread::Current();
   TIMELINE_DURATION(thread, Isolate, "LoadKernel");
+  STARTUP_PHASE("LoadKernel");
 
   if (program->is_single_program()) {
     KernelLoader loader(program, /*uri_to_source_table=*/nullptr);
@@ -356,6 +533,9 @@ RawString* KernelLoader::FindSourceForScript(const uint8_t* kernel_buffer,
 
 void KernelLoader::InitializeFields(UriToSourceTable* uri_to_source_table) {
   const intptr_t source_table_size = helper_.SourceTableSize();
+  // Decode line starts in the background while the tables below are copied
+  // and the script sources are read.
+  LineStartsDecoder line_starts_decoder(program_, &helper_);
   const Array& scripts =
       Array::Handle(Z, Array::New(source_table_size, Heap::kOld));
   patch_classes_ = Array::New(source_table_size, Heap::kOld);
@@ -427,7 +607,7 @@ void KernelLoader::InitializeFields(UriToSourceTable* uri_to_source_table) {
 
   Script& script = Script::Handle(Z);
   for (intptr_t index = 0; index < source_table_size; ++index) {
-    script = LoadScriptAt(index, uri_to_source_table);
+    script = LoadScriptAt(index, uri_to_source_table, &line_starts_decoder);
     scripts.SetAt(index, script);
   }
 
@@ -1989,7 +2169,8 @@ const Object& KernelLoader::ClassForScriptAt(const Class& klass,
 }
 
 RawScript* KernelLoader::LoadScriptAt(intptr_t index,
-                                      UriToSourceTable* uri_to_source_table) {
+                                      UriToSourceTable* uri_to_source_table,
+                                      LineStartsDecoder* line_starts_decoder) {
   const String& uri_string = helper_.SourceTableUriFor(index);
   const String& import_uri_string =
       helper_.SourceTableImportUriFor(index, program_->binary_version());
@@ -2009,7 +2190,12 @@ RawScript* KernelLoader::LoadScriptAt(intptr_t index,
 
   if (sources.IsNull() || line_starts.IsNull()) {
     const String& script_source = helper_.GetSourceFor(index);
-    line_starts = helper_.GetLineStartsFor(index);
+    if (line_starts_decoder != nullptr) {
+      line_starts = line_starts_decoder->TakeLineStarts(index);
+    }
+    if (line_starts.IsNull()) {
+      line_starts = helper_.GetLineStartsFor(index);
+    }
 
     if (script_source.raw() == Symbols::Empty().raw() &&
         line_starts.Length() == 0 && uri_string.Length() > 0) {
@@ -19,6 +19,7 @@ namespace dart {
 namespace kernel {
 
 class KernelLoader;
+class LineStartsDecoder;
 
 class BuildingTranslationHelper : public TranslationHelper {
  public:
@@ -329,7 +330,8 @@ class KernelLoader : public ValueObject {
 
   RawScript* LoadScriptAt(
       intptr_t index,
-      DirectChainedHashMap<UriToSourceTableTrait>* uri_to_source_table);
+      DirectChainedHashMap<UriToSourceTableTrait>* uri_to_source_table,
+      LineStartsDecoder* line_starts_decoder);
 
   // If klass's script is not the script at the uri index, return a PatchClass
   // for klass whose script corresponds to the uri index.
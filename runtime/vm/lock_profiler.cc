@@ -0,0 +1,342 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/lock_profiler.h"
+
+#include "platform/atomic.h"
+#include "vm/json_stream.h"
+#include "vm/native_symbol.h"
+#include "vm/os.h"
+#include "vm/timeline.h"
+
+namespace dart {
+
+#if !defined(PRODUCT)
+
+DEFINE_FLAG(bool,
+            profile_lock_contention,
+            false,
+            "Record wait and hold times of VM locks.");
+DEFINE_FLAG(int,
+            lock_contention_timeline_micros,
+            100,
+            "Report contended lock acquisitions that waited at least this "
+            "many microseconds on the VM timeline stream.");
+
+// Sizes of the statistics tables. Locks are keyed by their name pointer, so
+// the table must be a power of two for the probing below.
+static const intptr_t kMaxLocks = 512;
+static const intptr_t kMaxStacksPerLock = 8;
+static const intptr_t kMaxStackDepth = 8;
+
+struct ContendedStack {
+  uword pcs[kMaxStackDepth];
+  intptr_t depth;
+  int64_t count;
+  int64_t wait_micros;
+};
+
+struct LockStats {
+  const char* name;
+  int64_t acquisitions;
+  int64_t contentions;
+  int64_t wait_micros;
+  int64_t max_wait_micros;
+  int64_t hold_micros;
+  int64_t max_hold_micros;
+  // Allocated on the first contention; guarded by |contention_mutex_|.
+  ContendedStack* stacks;
+  intptr_t num_stacks;
+};
+
+static LockStats lock_stats_[kMaxLocks];
+
+// Guards the contended path. Taken without a locker so that it is never
+// profiled itself.
+static Mutex* contention_mutex_ = NULL;
+
+#if defined(HAS_C11_THREAD_LOCAL)
+// Set while the current thread is inside the contended path, whose stack
+// walk and timeline event may themselves take locks, or holds
+// |contention_mutex_| for reporting.
+static thread_local bool in_contended_path_ = false;
+#endif
+
+class ContendedPathScope : public ValueObject {
+ public:
+  ContendedPathScope() {
+#if defined(HAS_C11_THREAD_LOCAL)
+    ASSERT(!in_contended_path_);
+    in_contended_path_ = true;
+#endif
+  }
+  ~ContendedPathScope() {
+#if defined(HAS_C11_THREAD_LOCAL)
+    in_contended_path_ = false;
+#endif
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ContendedPathScope);
+};
+
+static Mutex* ContentionMutex() {
+  Mutex* mutex = AtomicOperations::LoadAcquire(&contention_mutex_);
+  if (mutex != NULL) {
+    return mutex;
+  }
+  Mutex* created = new Mutex("LockProfiler::contention_mutex_");
+  mutex = AtomicOperations::CompareAndSwapPointer(
+      &contention_mutex_, static_cast<Mutex*>(NULL), created);
+  if (mutex != NULL) {
+    delete created;
+    return mutex;
+  }
+  return created;
+}
+
+static LockStats* StatsFor(const char* name) {
+  uword hash = reinterpret_cast<uword>(name);
+  hash ^= hash >> 11;
+  for (intptr_t i = 0; i < kMaxLocks; i++) {
+    LockStats* stats = &lock_stats_[(hash + i) & (kMaxLocks - 1)];
+    const char* current = AtomicOperations::LoadRelaxed(&stats->name);
+    if (current == NULL) {
+      current = AtomicOperations::CompareAndSwapPointer(
+          &stats->name, static_cast<const char*>(NULL), name);
+      if (current == NULL) {
+        return stats;
+      }
+    }
+    if (current == name) {
+      return stats;
+    }
+  }
+  // Table full: further locks go unrecorded.
+  return NULL;
+}
+
+// Racy maximum; a concurrent update may be lost, which is acceptable for
+// profiling.
+static void UpdateMax(int64_t* max, int64_t value) {
+  if (value > AtomicOperations::LoadRelaxed(max)) {
+    *max = value;
+  }
+}
+
+// Walks the native frame pointer chain of the current thread.
+static intptr_t CaptureStack(uword* pcs) {
+#if !defined(HOST_OS_WINDOWS) &&                                               \
+    (defined(HOST_ARCH_X64) || defined(HOST_ARCH_IA32) ||                      \
+     defined(HOST_ARCH_ARM64))
+  OSThread* os_thread = OSThread::Current();
+  if (os_thread == NULL) {
+    return 0;
+  }
+  const uword lower = os_thread->stack_limit();
+  const uword upper = os_thread->stack_base();
+  uword fp = 0;
+  COPY_FP_REGISTER(fp);
+  intptr_t depth = 0;
+  while ((depth < kMaxStackDepth) && (fp >= lower) &&
+         (fp + 2 * kWordSize <= upper) && Utils::IsAligned(fp, kWordSize)) {
+    uword* frame = reinterpret_cast<uword*>(fp);
+    const uword caller_fp = frame[0];
+    const uword pc = frame[1];
+    if (pc == 0) {
+      break;
+    }
+    pcs[depth++] = pc;
+    if (caller_fp <= fp) {
+      break;
+    }
+    fp = caller_fp;
+  }
+  return depth;
+#else
+  return 0;
+#endif
+}
+
+void LockProfiler::RecordContendedStack(LockStats* stats,
+                                        int64_t wait_micros) {
+  uword pcs[kMaxStackDepth];
+  const intptr_t depth = CaptureStack(pcs);
+  if (depth == 0) {
+    return;
+  }
+  Mutex* mutex = ContentionMutex();
+  mutex->Lock();
+  if (stats->stacks == NULL) {
+    stats->stacks = reinterpret_cast<ContendedStack*>(
+        calloc(kMaxStacksPerLock, sizeof(ContendedStack)));
+  }
+  ContendedStack* slot = NULL;
+  for (intptr_t i = 0; i < stats->num_stacks; i++) {
+    ContendedStack* stack = &stats->stacks[i];
+    if ((stack->depth == depth) &&
+        (memcmp(stack->pcs, pcs, depth * sizeof(uword)) == 0)) {
+      slot = stack;
+      break;
+    }
+  }
+  if (slot == NULL) {
+    if (stats->num_stacks < kMaxStacksPerLock) {
+      slot = &stats->stacks[stats->num_stacks++];
+    } else {
+      // Replace the stack that accounts for the least waiting.
+      slot = &stats->stacks[0];
+      for (intptr_t i = 1; i < stats->num_stacks; i++) {
+        if (stats->stacks[i].wait_micros < slot->wait_micros) {
+          slot = &stats->stacks[i];
+        }
+      }
+    }
+    memmove(slot->pcs, pcs, depth * sizeof(uword));
+    slot->depth = depth;
+    slot->count = 0;
+    slot->wait_micros = 0;
+  }
+  slot->count++;
+  slot->wait_micros += wait_micros;
+  mutex->Unlock();
+}
+
+int64_t LockProfiler::Now() {
+  return OS::GetCurrentMonotonicMicros();
+}
+
+int64_t LockProfiler::Lock(Mutex* mutex) {
+  const int64_t start = Now();
+  const bool contended = !mutex->TryLock();
+  if (contended) {
+    mutex->Lock();
+  }
+  return Acquired(mutex->name(), start, contended);
+}
+
+int64_t LockProfiler::Enter(Monitor* monitor) {
+  const int64_t start = Now();
+  const bool contended = !monitor->TryEnter();
+  if (contended) {
+    monitor->Enter();
+  }
+  return Acquired(monitor->name(), start, contended);
+}
+
+int64_t LockProfiler::Acquired(const char* name,
+                               int64_t start_micros,
+                               bool contended) {
+  const int64_t acquired = contended ? Now() : start_micros;
+  LockStats* stats = StatsFor(name);
+  if (stats == NULL) {
+    return acquired;
+  }
+  AtomicOperations::IncrementInt64By(&stats->acquisitions, 1);
+  if (!contended) {
+    return acquired;
+  }
+  const int64_t wait = acquired - start_micros;
+  AtomicOperations::IncrementInt64By(&stats->contentions, 1);
+  AtomicOperations::IncrementInt64By(&stats->wait_micros, wait);
+  UpdateMax(&stats->max_wait_micros, wait);
+
+#if defined(HAS_C11_THREAD_LOCAL)
+  if (in_contended_path_) {
+    return acquired;
+  }
+  ContendedPathScope scope;
+  RecordContendedStack(stats, wait);
+  if (wait >= FLAG_lock_contention_timeline_micros) {
+    TimelineStream* stream = Timeline::GetVMStream();
+    TimelineEvent* event = (stream == NULL) ? NULL : stream->StartEvent();
+    if (event != NULL) {
+      // Lock names are string literals, so they outlive the event.
+      event->Duration(name, start_micros, acquired);
+      event->SetNumArguments(1);
+      event->CopyArgument(0, "type", "LockContention");
+      event->Complete();
+    }
+  }
+#endif
+  return acquired;
+}
+
+void LockProfiler::Released(const char* name, int64_t acquired_micros) {
+  if (acquired_micros == 0) {
+    return;
+  }
+  LockStats* stats = StatsFor(name);
+  if (stats == NULL) {
+    return;
+  }
+  const int64_t hold = Now() - acquired_micros;
+  AtomicOperations::IncrementInt64By(&stats->hold_micros, hold);
+  UpdateMax(&stats->max_hold_micros, hold);
+}
+
+void LockProfiler::PrintJSON(JSONStream* stream) {
+  JSONObject obj(stream);
+  obj.AddProperty("type", "_LockContentionProfile");
+  obj.AddProperty("enabled", enabled());
+  JSONArray locks(&obj, "locks");
+  ContendedPathScope scope;
+  Mutex* mutex = ContentionMutex();
+  mutex->Lock();
+  for (intptr_t i = 0; i < kMaxLocks; i++) {
+    const LockStats& stats = lock_stats_[i];
+    if ((stats.name == NULL) || (stats.acquisitions == 0)) {
+      continue;
+    }
+    JSONObject lock(&locks);
+    lock.AddProperty("name", stats.name);
+    lock.AddProperty64("acquisitions", stats.acquisitions);
+    lock.AddProperty64("contentions", stats.contentions);
+    lock.AddProperty64("waitMicros", stats.wait_micros);
+    lock.AddProperty64("maxWaitMicros", stats.max_wait_micros);
+    lock.AddProperty64("holdMicros", stats.hold_micros);
+    lock.AddProperty64("maxHoldMicros", stats.max_hold_micros);
+    JSONArray stacks(&lock, "contendedStacks");
+    for (intptr_t j = 0; j < stats.num_stacks; j++) {
+      const ContendedStack& stack = stats.stacks[j];
+      JSONObject entry(&stacks);
+      entry.AddProperty64("count", stack.count);
+      entry.AddProperty64("waitMicros", stack.wait_micros);
+      JSONArray frames(&entry, "frames");
+      for (intptr_t k = 0; k < stack.depth; k++) {
+        uintptr_t start = 0;
+        char* native_name =
+            NativeSymbolResolver::LookupSymbolName(stack.pcs[k], &start);
+        if (native_name == NULL) {
+          frames.AddValueF("[0x%" Px "]", stack.pcs[k]);
+        } else {
+          frames.AddValue(native_name);
+          NativeSymbolResolver::FreeSymbolName(native_name);
+        }
+      }
+    }
+  }
+  mutex->Unlock();
+}
+
+void LockProfiler::Reset() {
+  ContendedPathScope scope;
+  Mutex* mutex = ContentionMutex();
+  mutex->Lock();
+  for (intptr_t i = 0; i < kMaxLocks; i++) {
+    LockStats* stats = &lock_stats_[i];
+    stats->acquisitions = 0;
+    stats->contentions = 0;
+    stats->wait_micros = 0;
+    stats->max_wait_micros = 0;
+    stats->hold_micros = 0;
+    stats->max_hold_micros = 0;
+    stats->num_stacks = 0;
+  }
+  mutex->Unlock();
+}
+
+#endif  // !defined(PRODUCT)
+
+}  // namespace dart
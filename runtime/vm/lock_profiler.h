@@ -0,0 +1,64 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_LOCK_PROFILER_H_
+#define RUNTIME_VM_LOCK_PROFILER_H_
+
+#include "vm/allocation.h"
+#include "vm/flags.h"
+#include "vm/globals.h"
+#include "vm/os_thread.h"
+
+namespace dart {
+
+#if !defined(PRODUCT)
+
+DECLARE_FLAG(bool, profile_lock_contention);
+
+class JSONStream;
+struct LockStats;
+
+// Contention accounting for the locks taken through the lockers in
+// lockers.h, enabled with --profile_lock_contention. Statistics are kept per
+// lock name: acquisitions, how many of them had to wait, wait and hold
+// times, and the native stacks of the contended acquirers.
+//
+// Uncontended acquisitions only update counters with atomic operations;
+// stacks are captured and merged on the contended path only. Contended
+// acquisitions that waited at least --lock_contention_timeline_micros are
+// also reported as duration events on the VM timeline stream.
+class LockProfiler : public AllStatic {
+ public:
+  static bool enabled() { return FLAG_profile_lock_contention; }
+
+  static int64_t Now();
+
+  // Acquire |mutex| or |monitor| and record the acquisition. Return the time
+  // the lock was acquired, to be handed back to Released.
+  static int64_t Lock(Mutex* mutex);
+  static int64_t Enter(Monitor* monitor);
+
+  // Records an acquisition of the lock called |name| that was attempted at
+  // |start_micros| and had to wait if |contended|. For lockers that acquire
+  // the lock themselves. Returns the time the lock was acquired.
+  static int64_t Acquired(const char* name,
+                          int64_t start_micros,
+                          bool contended);
+
+  // Records the release of a lock acquired at |acquired_micros|. A zero
+  // |acquired_micros| means the acquisition was not profiled.
+  static void Released(const char* name, int64_t acquired_micros);
+
+  static void PrintJSON(JSONStream* stream);
+  static void Reset();
+
+ private:
+  static void RecordContendedStack(LockStats* stats, int64_t wait_micros);
+};
+
+#endif  // !defined(PRODUCT)
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_LOCK_PROFILER_H_
@@ -19,6 +19,7 @@ Monitor::WaitResult MonitorLocker::WaitWithSafepointCheck(Thread* thread,
 #endif
   thread->set_execution_state(Thread::kThreadInBlockedState);
   thread->EnterSafepoint();
+  NOT_IN_PRODUCT(SuspendHold());
   Monitor::WaitResult result = monitor_->Wait(millis);
   // First try a fast update of the thread state to indicate it is not at a
   // safepoint anymore.
@@ -30,6 +31,7 @@ Monitor::WaitResult MonitorLocker::WaitWithSafepointCheck(Thread* thread,
     handler->ExitSafepointUsingLock(thread);
     monitor_->Enter();
   }
+  NOT_IN_PRODUCT(ResumeHold());
   thread->set_execution_state(Thread::kThreadInVM);
 #if defined(DEBUG)
   if (no_safepoint_scope_) {
@@ -41,7 +43,11 @@ Monitor::WaitResult MonitorLocker::WaitWithSafepointCheck(Thread* thread,
 
 SafepointMutexLocker::SafepointMutexLocker(Mutex* mutex) : mutex_(mutex) {
   ASSERT(mutex != NULL);
-  if (!mutex_->TryLock()) {
+#if !defined(PRODUCT)
+  const int64_t start = LockProfiler::enabled() ? LockProfiler::Now() : 0;
+#endif
+  const bool contended = !mutex_->TryLock();
+  if (contended) {
     // We did not get the lock and could potentially block, so transition
     // accordingly.
     Thread* thread = Thread::Current();
@@ -56,12 +62,21 @@ SafepointMutexLocker::SafepointMutexLocker(Mutex* mutex) : mutex_(mutex) {
       mutex->Lock();
     }
   }
+#if !defined(PRODUCT)
+  acquired_micros_ =
+      (start == 0) ? 0
+                   : LockProfiler::Acquired(mutex_->name(), start, contended);
+#endif
 }
 
 SafepointMonitorLocker::SafepointMonitorLocker(Monitor* monitor)
     : monitor_(monitor) {
   ASSERT(monitor_ != NULL);
-  if (!monitor_->TryEnter()) {
+#if !defined(PRODUCT)
+  const int64_t start = LockProfiler::enabled() ? LockProfiler::Now() : 0;
+#endif
+  const bool contended = !monitor_->TryEnter();
+  if (contended) {
     // We did not get the lock and could potentially block, so transition
     // accordingly.
     Thread* thread = Thread::Current();
@@ -76,9 +91,27 @@ SafepointMonitorLocker::SafepointMonitorLocker(Monitor* monitor)
       monitor_->Enter();
     }
   }
+#if !defined(PRODUCT)
+  acquired_micros_ =
+      (start == 0) ? 0
+                   : LockProfiler::Acquired(monitor_->name(), start, contended);
+#endif
 }
 
 Monitor::WaitResult SafepointMonitorLocker::Wait(int64_t millis) {
+#if !defined(PRODUCT)
+  // Time spent waiting on the monitor does not count as holding it.
+  LockProfiler::Released(monitor_->name(), acquired_micros_);
+  if (acquired_micros_ != 0) {
+    Monitor::WaitResult result = WaitInternal(millis);
+    acquired_micros_ = LockProfiler::Now();
+    return result;
+  }
+#endif
+  return WaitInternal(millis);
+}
+
+Monitor::WaitResult SafepointMonitorLocker::WaitInternal(int64_t millis) {
   Thread* thread = Thread::Current();
   if (thread != NULL) {
     thread->set_execution_state(Thread::kThreadInBlockedState);
@@ -9,6 +9,7 @@
 #include "vm/allocation.h"
 #include "vm/globals.h"
 #include "vm/isolate.h"
+#include "vm/lock_profiler.h"
 #include "vm/os_thread.h"
 
 namespace dart {
@@ -62,11 +63,11 @@ class MutexLocker : public ValueObject {
       }
     }
 #endif
-    mutex_->Lock();
+    LockMutex();
   }
 
   virtual ~MutexLocker() {
-    mutex_->Unlock();
+    UnlockMutex();
 #if defined(DEBUG)
     if (no_safepoint_scope_) {
       Thread::Current()->DecrementNoSafepointScopeDepth();
@@ -80,10 +81,10 @@ class MutexLocker : public ValueObject {
       Thread::Current()->IncrementNoSafepointScopeDepth();
     }
 #endif
-    mutex_->Lock();
+    LockMutex();
   }
   void Unlock() const {
-    mutex_->Unlock();
+    UnlockMutex();
 #if defined(DEBUG)
     if (no_safepoint_scope_) {
       Thread::Current()->DecrementNoSafepointScopeDepth();
@@ -92,8 +93,24 @@ class MutexLocker : public ValueObject {
   }
 
  private:
+  void LockMutex() const {
+#if !defined(PRODUCT)
+    if (LockProfiler::enabled()) {
+      acquired_micros_ = LockProfiler::Lock(mutex_);
+      return;
+    }
+    acquired_micros_ = 0;
+#endif
+    mutex_->Lock();
+  }
+  void UnlockMutex() const {
+    NOT_IN_PRODUCT(LockProfiler::Released(mutex_->name(), acquired_micros_));
+    mutex_->Unlock();
+  }
+
   DEBUG_ONLY(bool no_safepoint_scope_;)
   Mutex* const mutex_;
+  NOT_IN_PRODUCT(mutable int64_t acquired_micros_;)
 
   DISALLOW_COPY_AND_ASSIGN(MutexLocker);
 };
@@ -140,11 +157,11 @@ class MonitorLocker : public ValueObject {
       }
     }
 #endif
-    monitor_->Enter();
+    EnterMonitor();
   }
 
   virtual ~MonitorLocker() {
-    monitor_->Exit();
+    ExitMonitor();
 #if defined(DEBUG)
     if (no_safepoint_scope_) {
       Thread::Current()->DecrementNoSafepointScopeDepth();
@@ -158,10 +175,10 @@ class MonitorLocker : public ValueObject {
       Thread::Current()->IncrementNoSafepointScopeDepth();
     }
 #endif
-    monitor_->Enter();
+    EnterMonitor();
   }
   void Exit() const {
-    monitor_->Exit();
+    ExitMonitor();
 #if defined(DEBUG)
     if (no_safepoint_scope_) {
       Thread::Current()->DecrementNoSafepointScopeDepth();
@@ -170,7 +187,10 @@ class MonitorLocker : public ValueObject {
   }
 
   Monitor::WaitResult Wait(int64_t millis = Monitor::kNoTimeout) {
-    return monitor_->Wait(millis);
+    NOT_IN_PRODUCT(SuspendHold());
+    Monitor::WaitResult result = monitor_->Wait(millis);
+    NOT_IN_PRODUCT(ResumeHold());
+    return result;
   }
 
   Monitor::WaitResult WaitWithSafepointCheck(
@@ -178,7 +198,10 @@ class MonitorLocker : public ValueObject {
       int64_t millis = Monitor::kNoTimeout);
 
   Monitor::WaitResult WaitMicros(int64_t micros = Monitor::kNoTimeout) {
-    return monitor_->WaitMicros(micros);
+    NOT_IN_PRODUCT(SuspendHold());
+    Monitor::WaitResult result = monitor_->WaitMicros(micros);
+    NOT_IN_PRODUCT(ResumeHold());
+    return result;
   }
 
   void Notify() { monitor_->Notify(); }
@@ -186,8 +209,36 @@ class MonitorLocker : public ValueObject {
   void NotifyAll() { monitor_->NotifyAll(); }
 
  private:
+  void EnterMonitor() const {
+#if !defined(PRODUCT)
+    if (LockProfiler::enabled()) {
+      acquired_micros_ = LockProfiler::Enter(monitor_);
+      return;
+    }
+    acquired_micros_ = 0;
+#endif
+    monitor_->Enter();
+  }
+  void ExitMonitor() const {
+    NOT_IN_PRODUCT(SuspendHold());
+    monitor_->Exit();
+  }
+
+#if !defined(PRODUCT)
+  // Time spent waiting on the monitor does not count as holding it.
+  void SuspendHold() const {
+    LockProfiler::Released(monitor_->name(), acquired_micros_);
+  }
+  void ResumeHold() const {
+    if (acquired_micros_ != 0) {
+      acquired_micros_ = LockProfiler::Now();
+    }
+  }
+#endif
+
   Monitor* const monitor_;
   bool no_safepoint_scope_;
+  NOT_IN_PRODUCT(mutable int64_t acquired_micros_;)
 
   DISALLOW_COPY_AND_ASSIGN(MonitorLocker);
 };
@@ -213,10 +264,14 @@ class MonitorLocker : public ValueObject {
 class SafepointMutexLocker : public ValueObject {
  public:
   explicit SafepointMutexLocker(Mutex* mutex);
-  virtual ~SafepointMutexLocker() { mutex_->Unlock(); }
+  virtual ~SafepointMutexLocker() {
+    NOT_IN_PRODUCT(LockProfiler::Released(mutex_->name(), acquired_micros_));
+    mutex_->Unlock();
+  }
 
  private:
   Mutex* const mutex_;
+  NOT_IN_PRODUCT(int64_t acquired_micros_;)
 
   DISALLOW_COPY_AND_ASSIGN(SafepointMutexLocker);
 };
@@ -242,12 +297,19 @@ class SafepointMutexLocker : public ValueObject {
 class SafepointMonitorLocker : public ValueObject {
  public:
   explicit SafepointMonitorLocker(Monitor* monitor);
-  virtual ~SafepointMonitorLocker() { monitor_->Exit(); }
+  virtual ~SafepointMonitorLocker() {
+    NOT_IN_PRODUCT(
+        LockProfiler::Released(monitor_->name(), acquired_micros_));
+    monitor_->Exit();
+  }
 
   Monitor::WaitResult Wait(int64_t millis = Monitor::kNoTimeout);
 
  private:
+  Monitor::WaitResult WaitInternal(int64_t millis);
+
   Monitor* const monitor_;
+  NOT_IN_PRODUCT(int64_t acquired_micros_;)
 
   DISALLOW_COPY_AND_ASSIGN(SafepointMonitorLocker);
 };
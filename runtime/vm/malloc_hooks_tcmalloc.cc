@@ -8,9 +8,13 @@
 
 #include "vm/malloc_hooks.h"
 
+#include <math.h>  // NOLINT
+
 #include "gperftools/malloc_hook.h"
 
 #include "platform/assert.h"
+#include "platform/atomic.h"
+#include "vm/flags.h"
 #include "vm/hash_map.h"
 #include "vm/json_stream.h"
 #include "vm/os_thread.h"
@@ -18,6 +22,14 @@
 
 namespace dart {
 
+DEFINE_FLAG(int,
+            profiler_native_memory_sample_interval,
+            0,
+            "With --profiler_native_memory, track only the native allocations "
+            "sampled on average every this many bytes, with their stack "
+            "traces, and scale them to estimate the native heap. 0 tracks "
+            "every allocation.");
+
 class AddressMap;
 
 // MallocHooksState contains all of the state related to the configuration of
@@ -66,6 +78,7 @@ class MallocHooksState : public AllStatic {
     ASSERT(malloc_hook_mutex()->IsOwnedByCurrentThread());
     ASSERT(size >= 0);
     heap_allocated_memory_in_bytes_ += size;
+    total_allocated_bytes_ += size;
     ++allocation_count_;
   }
 
@@ -80,6 +93,28 @@ class MallocHooksState : public AllStatic {
 
   static AddressMap* address_map() { return address_map_; }
 
+  static bool IsSampling() { return sample_interval_ > 0; }
+  static intptr_t sample_interval() { return sample_interval_; }
+
+  // Returns the number of bytes an allocation of [size] bytes stands for if
+  // it is sampled, and 0 otherwise. Only called when sampling.
+  static intptr_t SampleWeight(intptr_t size);
+
+  // Whether [ptr] may be a sampled allocation. Lets frees of allocations that
+  // were not sampled skip the lock.
+  static bool MaybeSampled(const void* ptr) {
+    return AtomicOperations::LoadRelaxed(&sampled_filter_[FilterIndex(ptr)]) !=
+           0;
+  }
+  static void AddSampled(const void* ptr) {
+    AtomicOperations::IncrementBy(&sampled_filter_[FilterIndex(ptr)], 1);
+  }
+  static void RemoveSampled(const void* ptr) {
+    AtomicOperations::DecrementBy(&sampled_filter_[FilterIndex(ptr)], 1);
+  }
+
+  static int64_t total_allocated_bytes() { return total_allocated_bytes_; }
+
   static void ResetStats();
   static void TearDown();
 
@@ -92,11 +127,24 @@ class MallocHooksState : public AllStatic {
   static bool stack_trace_collection_enabled_;
   static intptr_t allocation_count_;
   static intptr_t heap_allocated_memory_in_bytes_;
+  static int64_t total_allocated_bytes_;
   static AddressMap* address_map_;
   // End protected variables.
 
   static intptr_t original_pid_;
   static const intptr_t kInvalidPid = -1;
+
+  // Set by Init before the hooks are installed.
+  static intptr_t sample_interval_;
+
+  // Counts of the live sampled allocations by address hash, updated
+  // atomically.
+  static const intptr_t kFilterSize = 4096;
+  static intptr_t sampled_filter_[kFilterSize];
+  static intptr_t FilterIndex(const void* ptr) {
+    // Allocations are at least 8-byte aligned.
+    return (reinterpret_cast<uword>(ptr) >> 3) & (kFilterSize - 1);
+  }
 };
 
 // A locker-type class similar to MutexLocker which tracks which thread
@@ -126,7 +174,7 @@ class MallocLocker : public ValueObject {
 
 // AllocationInfo contains all information related to a given allocation
 // including:
-//   -Allocation size in bytes
+//   -Allocation size in bytes, or the bytes a sampled allocation stands for
 //   -Stack trace corresponding to the location of allocation, if applicable
 class AllocationInfo {
  public:
@@ -231,15 +279,25 @@ ThreadId MallocHooksState::malloc_hook_mutex_owner_ =
 // Memory allocation state information.
 intptr_t MallocHooksState::allocation_count_ = 0;
 intptr_t MallocHooksState::heap_allocated_memory_in_bytes_ = 0;
+int64_t MallocHooksState::total_allocated_bytes_ = 0;
 AddressMap* MallocHooksState::address_map_ = NULL;
 
+// Sampling state.
+intptr_t MallocHooksState::sample_interval_ = 0;
+intptr_t MallocHooksState::sampled_filter_[MallocHooksState::kFilterSize];
+static thread_local intptr_t sample_bytes_left_ = 0;
+static thread_local uint32_t sample_random_state_ = 0;
+
 void MallocHooksState::Init() {
   address_map_ = new AddressMap();
   active_ = true;
+  sample_interval_ =
+      Utils::Maximum(FLAG_profiler_native_memory_sample_interval, 0);
 #if defined(DEBUG)
   stack_trace_collection_enabled_ = true;
 #else
-  stack_trace_collection_enabled_ = false;
+  // Stacks are cheap enough to collect for sampled allocations only.
+  stack_trace_collection_enabled_ = IsSampling();
 #endif  // defined(DEBUG)
   original_pid_ = OS::ProcessId();
 }
@@ -248,7 +306,45 @@ void MallocHooksState::ResetStats() {
   ASSERT(malloc_hook_mutex()->IsOwnedByCurrentThread());
   allocation_count_ = 0;
   heap_allocated_memory_in_bytes_ = 0;
+  total_allocated_bytes_ = 0;
   address_map_->Clear();
+  memset(sampled_filter_, 0, sizeof(sampled_filter_));
+}
+
+// As for heap samples (see Thread::NextHeapSampleInterval), the sampling
+// points are exponentially distributed over the bytes each thread allocates.
+// Hooks cannot call malloc, so the random numbers come from an inline
+// xorshift generator instead of Random.
+static intptr_t NextSampleInterval(intptr_t interval) {
+  if (sample_random_state_ == 0) {
+    sample_random_state_ = static_cast<uint32_t>(OSThread::ThreadIdToIntPtr(
+                               OSThread::GetCurrentThreadId())) |
+                           1;
+  }
+  sample_random_state_ ^= sample_random_state_ << 13;
+  sample_random_state_ ^= sample_random_state_ >> 17;
+  sample_random_state_ ^= sample_random_state_ << 5;
+  const double uniform =
+      (static_cast<double>(sample_random_state_) + 1.0) / 4294967296.0;
+  return Utils::Maximum(static_cast<intptr_t>(-log(uniform) * interval),
+                        kIntptrOne);
+}
+
+intptr_t MallocHooksState::SampleWeight(intptr_t size) {
+  if (sample_bytes_left_ == 0) {
+    sample_bytes_left_ = NextSampleInterval(sample_interval_);
+  }
+  sample_bytes_left_ -= size;
+  if (sample_bytes_left_ > 0) {
+    return 0;
+  }
+  sample_bytes_left_ = NextSampleInterval(sample_interval_);
+  // An allocation of s bytes is sampled with probability 1 - e^(-s/interval),
+  // so it stands for s / (1 - e^(-s/interval)) bytes: about the interval for
+  // small allocations, and the allocation itself for large ones.
+  const double probability =
+      1.0 - exp(-static_cast<double>(size) / sample_interval_);
+  return Utils::Maximum(static_cast<intptr_t>(size / probability), size);
 }
 
 void MallocHooksState::TearDown() {
@@ -339,6 +435,8 @@ void MallocHooks::PrintToJSONObject(JSONObject* jsobj) {
   }
   intptr_t allocated_memory = 0;
   intptr_t allocation_count = 0;
+  int64_t total_allocated = 0;
+  intptr_t sample_interval = 0;
   bool add_usage = false;
   // AddProperty may call malloc which would result in an attempt
   // to acquire the lock recursively so we extract the values first
@@ -349,12 +447,17 @@ void MallocHooks::PrintToJSONObject(JSONObject* jsobj) {
     if (MallocHooksState::Active()) {
       allocated_memory = MallocHooksState::heap_allocated_memory_in_bytes();
       allocation_count = MallocHooksState::allocation_count();
+      total_allocated = MallocHooksState::total_allocated_bytes();
+      sample_interval = MallocHooksState::sample_interval();
       add_usage = true;
     }
   }
   if (add_usage) {
     jsobj->AddProperty("_heapAllocatedMemoryUsage", allocated_memory);
     jsobj->AddProperty("_heapAllocationCount", allocation_count);
+    // The rate of native allocation is the growth of the total over time.
+    jsobj->AddProperty64("_heapAllocatedMemoryTotal", total_allocated);
+    jsobj->AddProperty("_heapAllocationSampleInterval", sample_interval);
   }
 }
 
@@ -393,8 +496,18 @@ Sample* MallocHooks::GetSample(const void* ptr) {
 }
 
 void MallocHooksState::RecordAllocHook(const void* ptr, size_t size) {
-  if (MallocHooksState::IsLockHeldByCurrentThread() ||
-      !MallocHooksState::IsOriginalProcess()) {
+  if (MallocHooksState::IsLockHeldByCurrentThread()) {
+    return;
+  }
+  // Unsampled allocations do not take the lock.
+  intptr_t weight = size;
+  if (MallocHooksState::IsSampling()) {
+    weight = MallocHooksState::SampleWeight(size);
+    if (weight == 0) {
+      return;
+    }
+  }
+  if (!MallocHooksState::IsOriginalProcess()) {
     return;
   }
 
@@ -402,15 +515,23 @@ void MallocHooksState::RecordAllocHook(const void* ptr, size_t size) {
                   MallocHooksState::malloc_hook_mutex_owner());
   // Now that we hold the lock, check to make sure everything is still active.
   if ((ptr != NULL) && MallocHooksState::Active()) {
-    MallocHooksState::IncrementHeapAllocatedMemoryInBytes(size);
+    MallocHooksState::IncrementHeapAllocatedMemoryInBytes(weight);
+    if (MallocHooksState::IsSampling()) {
+      MallocHooksState::AddSampled(ptr);
+    }
     MallocHooksState::address_map()->Insert(
-        ptr, new AllocationInfo(reinterpret_cast<uword>(ptr), size));
+        ptr, new AllocationInfo(reinterpret_cast<uword>(ptr), weight));
   }
 }
 
 void MallocHooksState::RecordFreeHook(const void* ptr) {
-  if (MallocHooksState::IsLockHeldByCurrentThread() ||
-      !MallocHooksState::IsOriginalProcess()) {
+  if (MallocHooksState::IsLockHeldByCurrentThread()) {
+    return;
+  }
+  if (MallocHooksState::IsSampling() && !MallocHooksState::MaybeSampled(ptr)) {
+    return;
+  }
+  if (!MallocHooksState::IsOriginalProcess()) {
     return;
   }
 
@@ -424,6 +545,9 @@ void MallocHooksState::RecordFreeHook(const void* ptr) {
           allocation_info->allocation_size());
       const bool result = MallocHooksState::address_map()->Remove(ptr);
       ASSERT(result);
+      if (MallocHooksState::IsSampling()) {
+        MallocHooksState::RemoveSampled(ptr);
+      }
       delete allocation_info;
     }
   }
@@ -16,6 +16,8 @@
 
 namespace dart {
 
+DECLARE_FLAG(int, profiler_native_memory_sample_interval);
+
 static void MallocHookTestBufferInitializer(volatile char* buffer,
                                             uintptr_t size) {
   // Run through the buffer and do something. If we don't do this and the memory
@@ -112,6 +114,37 @@ UNIT_TEST_CASE(FreeUnseenMemoryMallocHookTest) {
   EXPECT_EQ(0L, MallocHooks::heap_allocated_memory_in_bytes());
 }
 
+UNIT_TEST_CASE(SampledMallocHookTest) {
+  const int saved_interval = FLAG_profiler_native_memory_sample_interval;
+  FLAG_profiler_native_memory_sample_interval = 4 * KB;
+  {
+    EnableMallocHooksScope scope;
+
+    // Only a fraction of the allocations is tracked, but they are scaled to
+    // estimate the bytes allocated.
+    const intptr_t kCount = 10000;
+    const intptr_t kSize = 100;
+    char** buffers = static_cast<char**>(malloc(kCount * sizeof(char*)));
+    for (intptr_t i = 0; i < kCount; i++) {
+      buffers[i] = static_cast<char*>(malloc(kSize));
+      MallocHookTestBufferInitializer(buffers[i], kSize);
+    }
+    EXPECT_LT(0L, MallocHooks::allocation_count());
+    EXPECT_LT(MallocHooks::allocation_count(), kCount / 10);
+    const intptr_t estimate = MallocHooks::heap_allocated_memory_in_bytes();
+    EXPECT_LT(kCount * kSize / 2, estimate);
+    EXPECT_LT(estimate, kCount * kSize * 2);
+
+    for (intptr_t i = 0; i < kCount; i++) {
+      free(buffers[i]);
+    }
+    free(buffers);
+    EXPECT_EQ(0L, MallocHooks::allocation_count());
+    EXPECT_EQ(0L, MallocHooks::heap_allocated_memory_in_bytes());
+  }
+  FLAG_profiler_native_memory_sample_interval = saved_interval;
+}
+
 VM_UNIT_TEST_CASE(StackTraceMallocHookSimpleTest) {
   EnableMallocHooksAndStacksScope scope;
 
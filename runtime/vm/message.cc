@@ -27,7 +27,8 @@ Message::Message(Dart_Port dest_port,
       snapshot_(snapshot),
       snapshot_length_(snapshot_length),
       finalizable_data_(finalizable_data),
-      priority_(priority) {
+      priority_(priority),
+      post_micros_(0) {
   ASSERT((priority == kNormalPriority) ||
          (delivery_failure_port == kIllegalPort));
   ASSERT(!IsRaw());
@@ -43,7 +44,8 @@ Message::Message(Dart_Port dest_port,
       snapshot_(reinterpret_cast<uint8_t*>(raw_obj)),
       snapshot_length_(0),
       finalizable_data_(NULL),
-      priority_(priority) {
+      priority_(priority),
+      post_micros_(0) {
   ASSERT(!raw_obj->IsHeapObject() || raw_obj->InVMIsolateHeap());
   ASSERT((priority == kNormalPriority) ||
          (delivery_failure_port == kIllegalPort));
@@ -141,6 +143,57 @@ void MessageQueue::Enqueue(std::unique_ptr<Message> msg0, bool before_events) {
   }
 }
 
+void MessageQueue::TakeBatch(MessageQueue* batch, intptr_t limit) {
+  Message* last = NULL;
+  intptr_t count = 0;
+  for (Message* current = head_;
+       (current != NULL) && (current->dest_port() != Message::kIllegalPort) &&
+       ((limit < 0) || (count < limit));
+       current = current->next_) {
+    last = current;
+    count++;
+  }
+  if (last == NULL) {
+    return;
+  }
+  Message* first = head_;
+  head_ = last->next_;
+  if (head_ == NULL) {
+    tail_ = NULL;
+  }
+  last->next_ = NULL;
+  if (batch->tail_ == NULL) {
+    batch->head_ = first;
+  } else {
+    batch->tail_->next_ = first;
+  }
+  batch->tail_ = last;
+}
+
+void MessageQueue::PutBack(MessageQueue* batch) {
+  if (batch->head_ == NULL) {
+    return;
+  }
+  // Messages posted before events while the batch was out are at the head.
+  Message* previous = NULL;
+  Message* next = head_;
+  while ((next != NULL) && (next->dest_port() == Message::kIllegalPort)) {
+    previous = next;
+    next = next->next_;
+  }
+  batch->tail_->next_ = next;
+  if (previous == NULL) {
+    head_ = batch->head_;
+  } else {
+    previous->next_ = batch->head_;
+  }
+  if (next == NULL) {
+    tail_ = batch->tail_;
+  }
+  batch->head_ = NULL;
+  batch->tail_ = NULL;
+}
+
 std::unique_ptr<Message> MessageQueue::Dequeue() {
   Message* result = head_;
   if (result != nullptr) {
@@ -93,6 +93,11 @@ class Message {
   }
   Priority priority() const { return priority_; }
 
+  // Monotonic time at which the message was posted to an isolate, for the
+  // message latency metrics.
+  int64_t post_micros() const { return post_micros_; }
+  void set_post_micros(int64_t micros) { post_micros_ = micros; }
+
   bool IsOOB() const { return priority_ == Message::kOOBPriority; }
   bool IsRaw() const { return snapshot_length_ == 0; }
 
@@ -112,6 +117,7 @@ class Message {
   intptr_t snapshot_length_;
   MessageFinalizableData* finalizable_data_;
   Priority priority_;
+  int64_t post_micros_;
 
   DISALLOW_COPY_AND_ASSIGN(Message);
 };
@@ -130,6 +136,16 @@ class MessageQueue {
 
   bool IsEmpty() { return head_ == NULL; }
 
+  // Moves up to [limit] messages (all if [limit] is negative) from the head of
+  // this queue to the tail of [batch]. Stops before the first message without
+  // a destination port, since such messages may be posted before events.
+  void TakeBatch(MessageQueue* batch, intptr_t limit);
+
+  // Moves the messages of [batch] back in front of the pending events of this
+  // queue, behind any messages posted before events since the batch was
+  // taken.
+  void PutBack(MessageQueue* batch);
+
   // Clear all messages from the message queue.
   void Clear();
 
@@ -4,6 +4,7 @@
 
 #include "vm/message_handler.h"
 
+#include "platform/atomic.h"
 #include "vm/dart.h"
 #include "vm/lockers.h"
 #include "vm/object.h"
@@ -16,6 +17,19 @@ namespace dart {
 
 DECLARE_FLAG(bool, trace_service_pause_events);
 
+DEFINE_FLAG(int,
+            message_handler_max_messages,
+            0,
+            "Handle at most this many messages per run of a message handler "
+            "task before yielding its thread to other isolates. 0 means no "
+            "limit.");
+DEFINE_FLAG(int,
+            message_handler_max_micros,
+            0,
+            "Handle messages for at most this many microseconds per run of a "
+            "message handler task before yielding its thread to other "
+            "isolates. 0 means no limit.");
+
 class MessageHandlerTask : public ThreadPool::Task {
  public:
   explicit MessageHandlerTask(MessageHandler* handler) : handler_(handler) {
@@ -63,11 +77,19 @@ MessageHandler::MessageHandler()
       is_paused_on_start_(false),
       is_paused_on_exit_(false),
       paused_timestamp_(-1),
+      latency_histogram_(),
+      rate_window_start_(0),
+      rate_window_messages_(0),
 #endif
       task_running_(false),
       delete_me_(false),
+      handling_batch_(NULL),
       pool_(NULL),
       idle_start_time_(0),
+      batch_breaking_posts_(0),
+      activation_messages_left_(-1),
+      activation_deadline_(0),
+      activation_yielded_(false),
       start_callback_(NULL),
       end_callback_(NULL),
       callback_data_(0) {
@@ -97,6 +119,18 @@ void MessageHandler::MessageNotify(Message::Priority priority) {
   // By default, there is no custom message notification.
 }
 
+bool MessageHandler::StartTask(ThreadPool* pool) {
+  return pool->Run<MessageHandlerTask>(this);
+}
+
+bool MessageHandler::HasMoreMessages() {
+  if ((handling_batch_ != NULL) && !handling_batch_->IsEmpty()) {
+    return true;
+  }
+  MonitorLocker ml(&monitor_);
+  return !queue_->IsEmpty();
+}
+
 void MessageHandler::Run(ThreadPool* pool,
                          StartCallback start_callback,
                          EndCallback end_callback,
@@ -114,7 +148,7 @@ void MessageHandler::Run(ThreadPool* pool,
   start_callback_ = start_callback;
   end_callback_ = end_callback;
   callback_data_ = data;
-  task_running_ = pool_->Run<MessageHandlerTask>(this);
+  task_running_ = StartTask(pool_);
   ASSERT(task_running_);
 }
 
@@ -146,6 +180,12 @@ void MessageHandler::PostMessage(std::unique_ptr<Message> message,
     }
 
     saved_priority = message->priority();
+    if (message->IsOOB() || before_events) {
+      batch_breaking_posts_++;
+    }
+#if !defined(PRODUCT)
+    RecordPostedLocked(message.get());
+#endif
     if (message->IsOOB()) {
       oob_queue_->Enqueue(std::move(message), before_events);
     } else {
@@ -157,7 +197,7 @@ void MessageHandler::PostMessage(std::unique_ptr<Message> message,
 
     if ((pool_ != NULL) && !task_running_) {
       ASSERT(!delete_me_);
-      task_running_ = pool_->Run<MessageHandlerTask>(this);
+      task_running_ = StartTask(pool_);
       ASSERT(task_running_);
     }
   }
@@ -177,9 +217,70 @@ std::unique_ptr<Message> MessageHandler::DequeueMessage(
 }
 
 void MessageHandler::ClearOOBQueue() {
+#if !defined(PRODUCT)
+  RecordDropped(oob_queue_->Length());
+#endif
   oob_queue_->Clear();
 }
 
+#if !defined(PRODUCT)
+void MessageHandler::RecordPostedLocked(Message* message) {
+  Isolate* owner = isolate();
+  if (owner == NULL) {
+    return;
+  }
+  message->set_post_micros(OS::GetCurrentMonotonicMicros());
+  // Posts are serialized by the monitor, but handled messages are counted
+  // without it.
+  owner->GetMessageQueueDepthMetric()->AtomicAdd(1);
+  owner->GetMessageQueueDepthMaxMetric()->SetValue(
+      owner->GetMessageQueueDepthMetric()->value());
+}
+
+void MessageHandler::RecordHandled(const Message& message) {
+  Isolate* owner = isolate();
+  if (owner == NULL) {
+    return;
+  }
+  const int64_t now = OS::GetCurrentMonotonicMicros();
+  const int64_t latency = now - message.post_micros();
+  owner->GetMessageQueueDepthMetric()->AtomicAdd(-1);
+  owner->GetMessagesHandledMetric()->increment();
+  owner->GetMessageLatencyMetric()->set_value(latency);
+  owner->GetMessageLatencyMaxMetric()->SetValue(latency);
+  latency_histogram_.Add(latency);
+
+  // The rate is that of the last whole second in which messages were
+  // handled.
+  rate_window_messages_++;
+  if (rate_window_start_ == 0) {
+    rate_window_start_ = now;
+  } else if ((now - rate_window_start_) >= kMicrosecondsPerSecond) {
+    owner->GetMessagesPerSecondMetric()->set_value(
+        (rate_window_messages_ * kMicrosecondsPerSecond) /
+        (now - rate_window_start_));
+    rate_window_start_ = now;
+    rate_window_messages_ = 0;
+  }
+}
+
+void MessageHandler::RecordDropped(intptr_t count) {
+  Isolate* owner = isolate();
+  if ((owner == NULL) || (count == 0)) {
+    return;
+  }
+  owner->GetMessageQueueDepthMetric()->AtomicAdd(-count);
+}
+#endif  // !defined(PRODUCT)
+
+bool MessageHandler::HasActivationBudget() const {
+  if (activation_messages_left_ == 0) {
+    return false;
+  }
+  return (activation_deadline_ == 0) ||
+         (OS::GetCurrentMonotonicMicros() < activation_deadline_);
+}
+
 MessageHandler::MessageStatus MessageHandler::HandleMessages(
     MonitorLocker* ml,
     bool allow_normal_messages,
@@ -189,12 +290,30 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
   // If isolate() returns NULL StartIsolateScope does nothing.
   StartIsolateScope start_isolate(isolate());
 
+  // When several normal messages may be handled, they are taken out of the
+  // queue in one batch and handled without reacquiring the monitor until an
+  // OOB message or a message before events is posted.
+  MessageQueue batch;
+  uintptr_t batch_breaking_posts = 0;
+  MessageQueue* saved_handling_batch = handling_batch_;
+  handling_batch_ = &batch;
+
   MessageStatus max_status = kOK;
   Message::Priority min_priority =
       ((allow_normal_messages && !paused()) ? Message::kNormalPriority
                                             : Message::kOOBPriority);
   std::unique_ptr<Message> message = DequeueMessage(min_priority);
+  bool locked = true;
   while (message != nullptr) {
+    if (allow_multiple_normal_messages && locked &&
+        (message->priority() == Message::kNormalPriority)) {
+      intptr_t limit = activation_messages_left_;
+      if (limit > 0) {
+        limit--;  // For [message].
+      }
+      queue_->TakeBatch(&batch, limit);
+      batch_breaking_posts = batch_breaking_posts_;
+    }
     intptr_t message_len = message->Size();
     if (FLAG_trace_isolates) {
       OS::PrintErr(
@@ -208,14 +327,19 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
 
     // Release the monitor_ temporarily while we handle the message.
     // The monitor was acquired in MessageHandler::TaskCallback().
-    ml->Exit();
+    if (locked) {
+      ml->Exit();
+      locked = false;
+    }
     Message::Priority saved_priority = message->priority();
     Dart_Port saved_dest_port = message->dest_port();
+#if !defined(PRODUCT)
+    RecordHandled(*message);
+#endif
     MessageStatus status = HandleMessage(std::move(message));
     if (status > max_status) {
       max_status = status;
     }
-    ml->Enter();
     if (FLAG_trace_isolates) {
       OS::PrintErr(
           "[.] Message handled (%s):\n"
@@ -227,6 +351,9 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
     }
     // If we are shutting down, do not process any more messages.
     if (status == kShutdown) {
+      ml->Enter();
+      locked = true;
+      queue_->PutBack(&batch);
       ClearOOBQueue();
       break;
     }
@@ -240,10 +367,20 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
 
     // Some callers want to process only one normal message and then quit. At
     // the same time it is OK to process multiple OOB messages.
-    if ((saved_priority == Message::kNormalPriority) &&
-        !allow_multiple_normal_messages) {
-      // We processed one normal message.  Allow no more.
-      allow_normal_messages = false;
+    if (saved_priority == Message::kNormalPriority) {
+      if (!allow_multiple_normal_messages) {
+        // We processed one normal message.  Allow no more.
+        allow_normal_messages = false;
+      } else {
+        if (activation_messages_left_ > 0) {
+          activation_messages_left_--;
+        }
+        if (!HasActivationBudget()) {
+          // Leave the remaining messages to the next task activation.
+          allow_normal_messages = false;
+          activation_yielded_ = true;
+        }
+      }
     }
 
     // Reevaluate the minimum allowable priority.  The paused state
@@ -255,8 +392,19 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
     min_priority = (((max_status == kOK) && allow_normal_messages && !paused())
                         ? Message::kNormalPriority
                         : Message::kOOBPriority);
+    if ((min_priority == Message::kNormalPriority) && !batch.IsEmpty() &&
+        (AtomicOperations::LoadRelaxed(&batch_breaking_posts_) ==
+         batch_breaking_posts)) {
+      message = batch.Dequeue();
+      continue;
+    }
+    ml->Enter();
+    locked = true;
+    queue_->PutBack(&batch);
     message = DequeueMessage(min_priority);
   }
+  ASSERT(locked && batch.IsEmpty());
+  handling_batch_ = saved_handling_batch;
   return max_status;
 }
 
@@ -404,6 +552,15 @@ void MessageHandler::TaskCallback() {
         ml.Enter();
       }
 
+      activation_messages_left_ = (FLAG_message_handler_max_messages > 0)
+                                      ? FLAG_message_handler_max_messages
+                                      : -1;
+      activation_deadline_ = (FLAG_message_handler_max_micros > 0)
+                                 ? OS::GetCurrentMonotonicMicros() +
+                                       FLAG_message_handler_max_micros
+                                 : 0;
+      activation_yielded_ = false;
+
       bool handle_messages = true;
       while (handle_messages) {
         handle_messages = false;
@@ -413,10 +570,13 @@ void MessageHandler::TaskCallback() {
           status = HandleMessages(&ml, (status == kOK), true);
         }
 
-        if (status == kOK && HasLivePorts()) {
+        if (status == kOK && HasLivePorts() && !activation_yielded_) {
           handle_messages = CheckIfIdleLocked(&ml);
         }
       }
+
+      activation_messages_left_ = -1;
+      activation_deadline_ = 0;
     }
 
     // The isolate exits when it encounters an error or when it no
@@ -469,7 +629,15 @@ void MessageHandler::TaskCallback() {
     // Clear task_running_ last.  This allows other tasks to potentially start
     // for this message handler.
     ASSERT(oob_queue_->IsEmpty());
-    task_running_ = false;
+    if (activation_yielded_ && (pool_ != NULL)) {
+      // Continue with the remaining messages in a new task, behind the tasks
+      // of other message handlers that are waiting for a worker.
+      activation_yielded_ = false;
+      task_running_ = StartTask(pool_);
+    } else {
+      activation_yielded_ = false;
+      task_running_ = false;
+    }
   }
 
   // The handler may have been deleted by another thread here if it is a native
@@ -550,6 +718,9 @@ void MessageHandler::CloseAllPorts() {
         "\thandler:    %s\n",
         name());
   }
+#if !defined(PRODUCT)
+  RecordDropped(queue_->Length() + oob_queue_->Length());
+#endif
   queue_->Clear();
   oob_queue_->Clear();
 }
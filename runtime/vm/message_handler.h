@@ -7,6 +7,7 @@
 
 #include <memory>
 
+#include "vm/heap/pause_histogram.h"
 #include "vm/isolate.h"
 #include "vm/lockers.h"
 #include "vm/message.h"
@@ -116,6 +117,13 @@ class MessageHandler {
   bool ShouldPauseOnExit(MessageStatus status) const;
   void PausedOnStart(bool paused);
   void PausedOnExit(bool paused);
+
+  // Time between the posting and the handling of the messages of an isolate.
+  // Only messages to isolates are recorded. Read by other threads without
+  // synchronization, so the result may be slightly stale.
+  const PauseHistogram& latency_histogram() const {
+    return latency_histogram_;
+  }
 #endif
 
   // Gives temporary ownership of |queue| and |oob_queue|. Using this object
@@ -200,6 +208,17 @@ class MessageHandler {
   // Returns true on success.
   virtual MessageStatus HandleMessage(std::unique_ptr<Message> message) = 0;
 
+  // Starts a task on |pool| that handles the pending messages. Subclasses
+  // may run the task elsewhere, by calling RunTask() from the thread of
+  // their choice. Called with the monitor held. Returns false if the task
+  // could not be started.
+  virtual bool StartTask(ThreadPool* pool);
+  void RunTask() { TaskCallback(); }
+
+  // Whether normal messages are waiting to be handled after the one passed
+  // to HandleMessage(). May only be called from HandleMessage().
+  bool HasMoreMessages();
+
   virtual void NotifyPauseOnStart() {}
   virtual void NotifyPauseOnExit() {}
 
@@ -236,11 +255,22 @@ class MessageHandler {
 
   void ClearOOBQueue();
 
+#if !defined(PRODUCT)
+  // Update the message metrics of the isolate of this handler, if any.
+  void RecordPostedLocked(Message* message);
+  void RecordHandled(const Message& message);
+  void RecordDropped(intptr_t count);
+#endif
+
   // Handles any pending messages.
   MessageStatus HandleMessages(MonitorLocker* ml,
                                bool allow_normal_messages,
                                bool allow_multiple_normal_messages);
 
+  // Whether the budget of the current task activation allows handling
+  // another normal message.
+  bool HasActivationBudget() const;
+
   Monitor monitor_;  // Protects all fields in MessageHandler.
   MessageQueue* queue_;
   MessageQueue* oob_queue_;
@@ -256,11 +286,28 @@ class MessageHandler {
   bool is_paused_on_start_;
   bool is_paused_on_exit_;
   int64_t paused_timestamp_;
+  PauseHistogram latency_histogram_;
+  // Start of the current window of isolate.messages.rate and the number of
+  // messages handled in it so far.
+  int64_t rate_window_start_;
+  int64_t rate_window_messages_;
 #endif
   bool task_running_;
   bool delete_me_;
+  // The normal messages taken out of the queue by HandleMessages() and not
+  // handled yet. Only accessed by the thread handling messages.
+  MessageQueue* handling_batch_;
   ThreadPool* pool_;
   int64_t idle_start_time_;
+  // Counts the OOB messages and the messages posted before events, which
+  // end a batch of normal messages handled without the monitor.
+  uintptr_t batch_breaking_posts_;
+  // Limits on the normal messages handled by the current task activation,
+  // or -1/0 if there are none. Set when the activation ran out of budget
+  // and has to yield to other message handlers.
+  intptr_t activation_messages_left_;
+  int64_t activation_deadline_;
+  bool activation_yielded_;
   StartCallback start_callback_;
   EndCallback end_callback_;
   CallbackData callback_data_;
@@ -118,6 +118,48 @@ TEST_CASE(MessageQueue_BasicOperations) {
   EXPECT(queue.IsEmpty());
 }
 
+TEST_CASE(MessageQueue_TakeBatchAndPutBack) {
+  MessageQueue queue;
+  MessageQueue batch;
+  const char* str1 = "msg1";
+  const char* str2 = "msg2";
+  const char* str3 = "msg3";
+  const char* str4 = "msg4";
+
+  std::unique_ptr<Message> msg;
+  msg = Message::New(1, AllocMsg(str1), strlen(str1) + 1, nullptr,
+                     Message::kNormalPriority);
+  queue.Enqueue(std::move(msg), false);
+  msg = Message::New(1, AllocMsg(str2), strlen(str2) + 1, nullptr,
+                     Message::kNormalPriority);
+  queue.Enqueue(std::move(msg), false);
+  msg = Message::New(1, AllocMsg(str3), strlen(str3) + 1, nullptr,
+                     Message::kNormalPriority);
+  queue.Enqueue(std::move(msg), false);
+
+  // Take two of the three messages.
+  queue.TakeBatch(&batch, 2);
+  msg = batch.Dequeue();
+  EXPECT_STREQ(str1, reinterpret_cast<char*>(msg->snapshot()));
+  EXPECT(!batch.IsEmpty());
+  EXPECT(!queue.IsEmpty());
+
+  // A message posted before events while the batch is out stays in front.
+  msg = Message::New(Message::kIllegalPort, AllocMsg(str4), strlen(str4) + 1,
+                     nullptr, Message::kNormalPriority);
+  queue.Enqueue(std::move(msg), true);
+  queue.PutBack(&batch);
+  EXPECT(batch.IsEmpty());
+
+  msg = queue.Dequeue();
+  EXPECT_STREQ(str4, reinterpret_cast<char*>(msg->snapshot()));
+  msg = queue.Dequeue();
+  EXPECT_STREQ(str2, reinterpret_cast<char*>(msg->snapshot()));
+  msg = queue.Dequeue();
+  EXPECT_STREQ(str3, reinterpret_cast<char*>(msg->snapshot()));
+  EXPECT(queue.IsEmpty());
+}
+
 TEST_CASE(MessageQueue_Clear) {
   MessageQueue queue;
   Dart_Port port1 = 1;
@@ -6,12 +6,14 @@
 
 #include "vm/metrics.h"
 
+#include "vm/dart.h"
 #include "vm/isolate.h"
 #include "vm/json_stream.h"
 #include "vm/log.h"
 #include "vm/native_entry.h"
 #include "vm/object.h"
 #include "vm/runtime_entry.h"
+#include "vm/thread_pool.h"
 
 namespace dart {
 
@@ -255,42 +257,47 @@ void Metric::DeregisterWithVM() {
   UNREACHABLE();
 }
 
+// The heap metrics read the heap without synchronization, so that they can be
+// sampled from any thread (see Dart_IsolateMetricsSnapshot).
 int64_t MetricHeapOldUsed::Value() const {
-  ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->UsedInWords(Heap::kOld) * kWordSize;
 }
 
 int64_t MetricHeapOldCapacity::Value() const {
-  ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->CapacityInWords(Heap::kOld) * kWordSize;
 }
 
 int64_t MetricHeapOldExternal::Value() const {
-  ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->ExternalInWords(Heap::kOld) * kWordSize;
 }
 
 int64_t MetricHeapNewUsed::Value() const {
-  ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->UsedInWords(Heap::kNew) * kWordSize;
 }
 
 int64_t MetricHeapNewCapacity::Value() const {
-  ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->CapacityInWords(Heap::kNew) * kWordSize;
 }
 
 int64_t MetricHeapNewExternal::Value() const {
-  ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->ExternalInWords(Heap::kNew) * kWordSize;
 }
 
 int64_t MetricHeapUsed::Value() const {
-  ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->UsedInWords(Heap::kNew) * kWordSize +
          isolate()->heap()->UsedInWords(Heap::kOld) * kWordSize;
 }
 
+int64_t MetricHeapNewCollections::Value() const {
+  return isolate()->heap()->pause_histogram(Heap::kScavengePause).count();
+}
+
+int64_t MetricHeapOldCollections::Value() const {
+  Heap* heap = isolate()->heap();
+  return heap->pause_histogram(Heap::kMarkSweepPause).count() +
+         heap->pause_histogram(Heap::kMarkCompactPause).count();
+}
+
 int64_t MetricIsolateCount::Value() const {
   return Isolate::IsolateListLength();
 }
@@ -303,6 +310,33 @@ int64_t MetricPeakRSS::Value() const {
   return Service::MaxRSS();
 }
 
+int64_t MetricZoneSegmentCacheHits::Value() const {
+  return Zone::SegmentCacheHits();
+}
+
+int64_t MetricZoneSegmentCacheMisses::Value() const {
+  return Zone::SegmentCacheMisses();
+}
+
+int64_t MetricSubtypeTestCachesFull::Value() const {
+  return SubtypeTestCache::NumFullCaches();
+}
+
+int64_t MetricThreadPoolWorkersRunning::Value() const {
+  ThreadPool* pool = Dart::thread_pool();
+  return (pool == NULL) ? 0 : pool->workers_running();
+}
+
+int64_t MetricThreadPoolWorkersIdle::Value() const {
+  ThreadPool* pool = Dart::thread_pool();
+  return (pool == NULL) ? 0 : pool->workers_idle();
+}
+
+int64_t MetricThreadPoolTasksQueued::Value() const {
+  ThreadPool* pool = Dart::thread_pool();
+  return (pool == NULL) ? 0 : pool->tasks_queued();
+}
+
 #define VM_METRIC_VARIABLE(type, variable, name, unit)                         \
   type vm_metric_##variable;
 VM_METRIC_LIST(VM_METRIC_VARIABLE);
@@ -5,6 +5,7 @@
 #ifndef RUNTIME_VM_METRICS_H_
 #define RUNTIME_VM_METRICS_H_
 
+#include "platform/atomic.h"
 #include "vm/allocation.h"
 
 namespace dart {
@@ -26,13 +27,45 @@ class JSONStream;
   V(MetricHeapNewExternal, HeapNewExternal, "heap.new.external", kByte)        \
   V(MetricHeapUsed, HeapGlobalUsed, "heap.global.used", kByte)                 \
   V(MaxMetric, HeapGlobalUsedMax, "heap.global.used.max", kByte)               \
+  V(MetricHeapNewCollections, HeapNewCollections, "heap.new.collections",      \
+    kCounter)                                                                  \
+  V(MetricHeapOldCollections, HeapOldCollections, "heap.old.collections",      \
+    kCounter)                                                                  \
   V(Metric, RunnableLatency, "isolate.runnable.latency", kMicrosecond)         \
-  V(Metric, RunnableHeapSize, "isolate.runnable.heap", kByte)
+  V(Metric, RunnableHeapSize, "isolate.runnable.heap", kByte)                  \
+  V(Metric, SafepointReachTime, "isolate.safepoint.reach", kMicrosecond)       \
+  V(MaxMetric, SafepointReachTimeMax, "isolate.safepoint.reach.max",           \
+    kMicrosecond)                                                              \
+  V(Metric, MessageQueueDepth, "isolate.messages.depth", kCounter)             \
+  V(MaxMetric, MessageQueueDepthMax, "isolate.messages.depth.max", kCounter)   \
+  V(Metric, MessagesHandled, "isolate.messages.handled", kCounter)             \
+  V(Metric, MessagesPerSecond, "isolate.messages.rate", kCounter)              \
+  V(Metric, MessageLatency, "isolate.messages.latency", kMicrosecond)          \
+  V(MaxMetric, MessageLatencyMax, "isolate.messages.latency.max",              \
+    kMicrosecond)                                                              \
+  V(Metric, CodeCacheSize, "isolate.code_cache.size", kByte)                   \
+  V(Metric, CodeCacheEvictions, "isolate.code_cache.evictions", kCounter)      \
+  V(Metric, CodeCacheEvicted, "isolate.code_cache.evicted", kByte)             \
+  V(Metric, UnoptimizedCompilations, "isolate.compilations.unoptimized",       \
+    kCounter)                                                                  \
+  V(Metric, OptimizedCompilations, "isolate.compilations.optimized", kCounter)
 
 #define VM_METRIC_LIST(V)                                                      \
   V(MetricIsolateCount, IsolateCount, "vm.isolate.count", kCounter)            \
   V(MetricCurrentRSS, CurrentRSS, "vm.memory.current", kByte)                  \
-  V(MetricPeakRSS, PeakRSS, "vm.memory.max", kByte)
+  V(MetricPeakRSS, PeakRSS, "vm.memory.max", kByte)                            \
+  V(MetricZoneSegmentCacheHits, ZoneSegmentCacheHits,                          \
+    "vm.zone.segment_cache.hits", kCounter)                                    \
+  V(MetricZoneSegmentCacheMisses, ZoneSegmentCacheMisses,                      \
+    "vm.zone.segment_cache.misses", kCounter)                                  \
+  V(MetricSubtypeTestCachesFull, SubtypeTestCachesFull,                        \
+    "vm.type_check.subtype_test_caches.full", kCounter)                        \
+  V(MetricThreadPoolWorkersRunning, ThreadPoolWorkersRunning,                  \
+    "vm.thread_pool.workers.running", kCounter)                                \
+  V(MetricThreadPoolWorkersIdle, ThreadPoolWorkersIdle,                        \
+    "vm.thread_pool.workers.idle", kCounter)                                   \
+  V(MetricThreadPoolTasksQueued, ThreadPoolTasksQueued,                        \
+    "vm.thread_pool.tasks.queued", kCounter)
 
 class Metric {
  public:
@@ -72,10 +105,19 @@ class Metric {
   char* ToString();
 
   int64_t value() const { return value_; }
+
+  // Returns the value, computing it for metrics that produce their value on
+  // demand. May be called from any thread.
+  int64_t CurrentValue() const { return Value(); }
   void set_value(int64_t value) { value_ = value; }
 
   void increment() { value_++; }
 
+  // Adds |delta| to the value. May be called from several threads at once.
+  void AtomicAdd(int64_t delta) {
+    AtomicOperations::IncrementInt64By(&value_, delta);
+  }
+
   Metric* next() const { return next_; }
   void set_next(Metric* next) { next_ = next; }
 
@@ -175,11 +217,51 @@ class MetricPeakRSS : public Metric {
   virtual int64_t Value() const;
 };
 
+class MetricZoneSegmentCacheHits : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
+class MetricZoneSegmentCacheMisses : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
+class MetricSubtypeTestCachesFull : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
 class MetricHeapUsed : public Metric {
  protected:
   virtual int64_t Value() const;
 };
 
+class MetricHeapNewCollections : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
+class MetricHeapOldCollections : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
+class MetricThreadPoolWorkersRunning : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
+class MetricThreadPoolWorkersIdle : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
+class MetricThreadPoolTasksQueued : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
 #if !defined(PRODUCT)
 #define VM_METRIC_VARIABLE(type, variable, name, unit)                         \
   extern type vm_metric_##variable;
@@ -4,6 +4,7 @@
 
 #include "platform/assert.h"
 
+#include "include/dart_tools_api.h"
 #include "vm/dart_api_impl.h"
 #include "vm/dart_api_state.h"
 #include "vm/globals.h"
@@ -73,6 +74,52 @@ VM_UNIT_TEST_CASE(Metric_OnDemand) {
   Dart_ShutdownIsolate();
 }
 
+static int64_t SnapshotValue(const Dart_MetricValue* metrics,
+                             intptr_t length,
+                             const char* name) {
+  for (intptr_t i = 0; i < length; i++) {
+    if (strcmp(metrics[i].name, name) == 0) {
+      return metrics[i].value;
+    }
+  }
+  FATAL1("No metric %s", name);
+  return -1;
+}
+
+VM_UNIT_TEST_CASE(Metric_Snapshot) {
+  TestCase::CreateTestIsolate();
+  {
+    const intptr_t vm_length = Dart_VMMetricsSnapshot(NULL, 0);
+    EXPECT(vm_length > 0);
+    Dart_MetricValue* vm_metrics = new Dart_MetricValue[vm_length];
+    EXPECT_EQ(vm_length, Dart_VMMetricsSnapshot(vm_metrics, vm_length));
+    EXPECT(SnapshotValue(vm_metrics, vm_length, "vm.isolate.count") >= 1);
+    delete[] vm_metrics;
+
+    Dart_Isolate isolate = Dart_CurrentIsolate();
+    const intptr_t length = Dart_IsolateMetricsSnapshot(isolate, NULL, 0);
+    EXPECT(length > 1);
+    Dart_MetricValue* metrics = new Dart_MetricValue[length];
+    // Only as many metrics as requested are filled in.
+    metrics[1].name = NULL;
+    EXPECT_EQ(length, Dart_IsolateMetricsSnapshot(isolate, metrics, 1));
+    EXPECT(metrics[1].name == NULL);
+    EXPECT_EQ(length, Dart_IsolateMetricsSnapshot(isolate, metrics, length));
+    EXPECT(SnapshotValue(metrics, length, "heap.old.capacity") > 0);
+    const int64_t collections =
+        SnapshotValue(metrics, length, "heap.new.collections");
+    {
+      TransitionNativeToVM transition(Thread::Current());
+      Isolate::Current()->heap()->CollectGarbage(Heap::kNew);
+    }
+    EXPECT_EQ(length, Dart_IsolateMetricsSnapshot(isolate, metrics, length));
+    EXPECT_EQ(collections + 1,
+              SnapshotValue(metrics, length, "heap.new.collections"));
+    delete[] metrics;
+  }
+  Dart_ShutdownIsolate();
+}
+
 #endif  // !PRODUCT
 
 }  // namespace dart
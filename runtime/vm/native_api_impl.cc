@@ -8,6 +8,8 @@
 #include "vm/dart_api_impl.h"
 #include "vm/dart_api_message.h"
 #include "vm/dart_api_state.h"
+#include "vm/ffi_callback_queue.h"
+#include "vm/lockers.h"
 #include "vm/message.h"
 #include "vm/native_message_handler.h"
 #include "vm/port.h"
@@ -67,6 +69,169 @@ DART_EXPORT bool Dart_PostInteger(Dart_Port port_id, int64_t message) {
   return PostCObjectHelper(port_id, &cobj);
 }
 
+class NativeBufferPool;
+
+// Buffers handed out by a NativeBufferPool are preceded by this header, which
+// is the peer of the external typed data they back.
+struct NativeBuffer {
+  NativeBufferPool* pool;
+  NativeBuffer* next;
+};
+
+static const intptr_t kNativeBufferHeaderSize =
+    Utils::RoundUp(sizeof(NativeBuffer), 2 * kWordSize);
+
+class NativeBufferPool {
+ public:
+  NativeBufferPool(intptr_t buffer_size, intptr_t max_free_buffers)
+      : mutex_(NOT_IN_PRODUCT("NativeBufferPool::mutex_")),
+        buffer_size_(buffer_size),
+        max_free_buffers_(max_free_buffers),
+        free_list_(nullptr),
+        num_free_(0),
+        num_acquired_(0),
+        deleted_(false) {}
+
+  ~NativeBufferPool() {
+    while (free_list_ != nullptr) {
+      NativeBuffer* next = free_list_->next;
+      free(free_list_);
+      free_list_ = next;
+    }
+  }
+
+  static uint8_t* DataOf(NativeBuffer* buffer) {
+    return reinterpret_cast<uint8_t*>(buffer) + kNativeBufferHeaderSize;
+  }
+
+  static NativeBuffer* BufferOf(uint8_t* data) {
+    return reinterpret_cast<NativeBuffer*>(data - kNativeBufferHeaderSize);
+  }
+
+  uint8_t* Acquire() {
+    NativeBuffer* buffer = nullptr;
+    {
+      MutexLocker ml(&mutex_);
+      num_acquired_++;
+      if (free_list_ != nullptr) {
+        buffer = free_list_;
+        free_list_ = buffer->next;
+        num_free_--;
+      }
+    }
+    if (buffer == nullptr) {
+      buffer = reinterpret_cast<NativeBuffer*>(
+          malloc(kNativeBufferHeaderSize + buffer_size_));
+      if (buffer == nullptr) {
+        MutexLocker ml(&mutex_);
+        num_acquired_--;
+        return nullptr;
+      }
+      buffer->pool = this;
+    }
+    buffer->next = nullptr;
+    return DataOf(buffer);
+  }
+
+  // Also called by the finalizer of the external typed data backed by the
+  // buffer, on any thread.
+  static void Release(NativeBuffer* buffer) {
+    NativeBufferPool* pool = buffer->pool;
+    bool delete_pool;
+    {
+      MutexLocker ml(&pool->mutex_);
+      pool->num_acquired_--;
+      if (!pool->deleted_ && (pool->num_free_ < pool->max_free_buffers_)) {
+        buffer->next = pool->free_list_;
+        pool->free_list_ = buffer;
+        pool->num_free_++;
+        buffer = nullptr;
+      }
+      delete_pool = pool->deleted_ && (pool->num_acquired_ == 0);
+    }
+    free(buffer);
+    if (delete_pool) {
+      delete pool;
+    }
+  }
+
+  static void Finalizer(void* isolate_callback_data,
+                        Dart_WeakPersistentHandle handle,
+                        void* peer) {
+    Release(reinterpret_cast<NativeBuffer*>(peer));
+  }
+
+  void Delete() {
+    bool delete_pool;
+    {
+      MutexLocker ml(&mutex_);
+      deleted_ = true;
+      delete_pool = (num_acquired_ == 0);
+    }
+    if (delete_pool) {
+      delete this;
+    }
+  }
+
+  intptr_t buffer_size() const { return buffer_size_; }
+
+ private:
+  Mutex mutex_;
+  const intptr_t buffer_size_;
+  const intptr_t max_free_buffers_;
+  NativeBuffer* free_list_;
+  intptr_t num_free_;
+  // Buffers held by the sender or by Dart.
+  intptr_t num_acquired_;
+  bool deleted_;
+
+  DISALLOW_COPY_AND_ASSIGN(NativeBufferPool);
+};
+
+DART_EXPORT Dart_NativeBufferPool
+Dart_NewNativeBufferPool(intptr_t buffer_size, intptr_t max_free_buffers) {
+  if ((buffer_size < 0) || (max_free_buffers < 0) ||
+      (buffer_size >
+       ExternalTypedData::MaxElements(kExternalTypedDataUint8ArrayCid))) {
+    return NULL;
+  }
+  return reinterpret_cast<Dart_NativeBufferPool>(
+      new NativeBufferPool(buffer_size, max_free_buffers));
+}
+
+DART_EXPORT void Dart_DeleteNativeBufferPool(Dart_NativeBufferPool pool) {
+  reinterpret_cast<NativeBufferPool*>(pool)->Delete();
+}
+
+DART_EXPORT uint8_t* Dart_NativeBufferPoolAcquire(Dart_NativeBufferPool pool) {
+  return reinterpret_cast<NativeBufferPool*>(pool)->Acquire();
+}
+
+DART_EXPORT void Dart_NativeBufferPoolRelease(uint8_t* buffer) {
+  NativeBufferPool::Release(NativeBufferPool::BufferOf(buffer));
+}
+
+DART_EXPORT void Dart_NativeBufferPoolMakeCObject(uint8_t* buffer,
+                                                  intptr_t length,
+                                                  Dart_CObject* object) {
+  NativeBuffer* header = NativeBufferPool::BufferOf(buffer);
+  if ((length < 0) || (length > header->pool->buffer_size())) {
+    FATAL1("%s expects argument 'length' to be within the buffer size.",
+           CURRENT_FUNC);
+  }
+  object->type = Dart_CObject_kExternalTypedData;
+  object->value.as_external_typed_data.type = Dart_TypedData_kUint8;
+  object->value.as_external_typed_data.length = length;
+  object->value.as_external_typed_data.data = buffer;
+  object->value.as_external_typed_data.peer = header;
+  object->value.as_external_typed_data.callback = &NativeBufferPool::Finalizer;
+}
+
+DART_EXPORT bool Dart_PostAsyncCallback(Dart_AsyncCallbackQueue queue,
+                                        const void* record) {
+  return reinterpret_cast<FfiCallbackQueue*>(queue)->Post(record);
+}
+
 DART_EXPORT Dart_Port Dart_NewNativePort(const char* name,
                                          Dart_NativeMessageHandler handler,
                                          bool handle_concurrently) {
@@ -88,6 +253,63 @@ DART_EXPORT Dart_Port Dart_NewNativePort(const char* name,
   return port_id;
 }
 
+DART_EXPORT Dart_Port
+Dart_NewNativePortWithOptions(const char* name,
+                              Dart_NativeMessageHandler handler,
+                              const Dart_NativePortOptions* options) {
+  if (name == NULL) {
+    name = "<UnnamedNativePort>";
+  }
+  if (options == NULL) {
+    OS::PrintErr("%s expects argument 'options' to be non-null.\n",
+                 CURRENT_FUNC);
+    return ILLEGAL_PORT;
+  }
+  if ((handler == NULL) && (options->batch_handler == NULL)) {
+    OS::PrintErr(
+        "%s expects argument 'handler' or 'options->batch_handler' to be "
+        "non-null.\n",
+        CURRENT_FUNC);
+    return ILLEGAL_PORT;
+  }
+  if (options->max_batch_size < 0) {
+    OS::PrintErr("%s expects 'options->max_batch_size' to be non-negative.\n",
+                 CURRENT_FUNC);
+    return ILLEGAL_PORT;
+  }
+  switch (options->threading) {
+    case Dart_NativePortThreading_ThreadPool:
+      break;
+    case Dart_NativePortThreading_DedicatedThread:
+      if (options->handle_concurrently) {
+        OS::PrintErr(
+            "%s: a port with a dedicated thread cannot handle messages "
+            "concurrently.\n",
+            CURRENT_FUNC);
+        return ILLEGAL_PORT;
+      }
+      break;
+    case Dart_NativePortThreading_Executor:
+      if (options->executor == NULL) {
+        OS::PrintErr("%s expects 'options->executor' to be non-null.\n",
+                     CURRENT_FUNC);
+        return ILLEGAL_PORT;
+      }
+      break;
+    default:
+      OS::PrintErr("%s: invalid 'options->threading'.\n", CURRENT_FUNC);
+      return ILLEGAL_PORT;
+  }
+  // Start the native port without a current isolate.
+  IsolateLeaveScope saver(Isolate::Current());
+
+  NativeMessageHandler* nmh = new NativeMessageHandler(name, handler, *options);
+  Dart_Port port_id = PortMap::CreatePort(nmh);
+  PortMap::SetPortState(port_id, PortMap::kLivePort);
+  nmh->Run(nmh->pool(), NULL, NULL, 0);
+  return port_id;
+}
+
 DART_EXPORT bool Dart_CloseNativePort(Dart_Port native_port_id) {
   // Close the native port without a current isolate.
   IsolateLeaveScope saver(Isolate::Current());
@@ -4,19 +4,153 @@
 
 #include "vm/native_message_handler.h"
 
+#include "vm/dart.h"
 #include "vm/dart_api_message.h"
 #include "vm/isolate.h"
 #include "vm/message.h"
 #include "vm/snapshot.h"
+#include "vm/thread_pool.h"
 
 namespace dart {
 
+// Decodes |messages| and passes them to |batch_func|, or one by one to
+// |func| if there is no batch handler.
+static void DeliverMessages(Dart_NativeMessageHandler func,
+                            Dart_NativeMessageBatchHandler batch_func,
+                            MessageQueue* messages,
+                            intptr_t count) {
+  // We create a native scope for handling the messages.
+  // All allocation of objects for decoding the messages is done in the
+  // zone associated with this scope.
+  ApiNativeScope scope;
+  if (batch_func == NULL) {
+    for (std::unique_ptr<Message> message = messages->Dequeue();
+         message != nullptr; message = messages->Dequeue()) {
+      ApiMessageReader reader(message.get());
+      Dart_CObject* object = reader.ReadMessage();
+      (*func)(message->dest_port(), object);
+    }
+    return;
+  }
+  Dart_CObject** objects =
+      ApiNativeScope::Current()->zone()->Alloc<Dart_CObject*>(count);
+  Dart_Port dest_port = ILLEGAL_PORT;
+  intptr_t i = 0;
+  for (std::unique_ptr<Message> message = messages->Dequeue();
+       message != nullptr; message = messages->Dequeue()) {
+    ASSERT(i < count);
+    ApiMessageReader reader(message.get());
+    objects[i++] = reader.ReadMessage();
+    dest_port = message->dest_port();
+  }
+  ASSERT(i == count);
+  (*batch_func)(dest_port, objects, count);
+}
+
+// Delivers messages of a port that handles them concurrently. It does not
+// refer to the handler, which may be deleted before the task runs.
+class NativeMessageDeliveryTask : public ThreadPool::Task {
+ public:
+  NativeMessageDeliveryTask(Dart_NativeMessageHandler func,
+                            Dart_NativeMessageBatchHandler batch_func,
+                            MessageQueue* messages,
+                            intptr_t count)
+      : func_(func), batch_func_(batch_func), messages_(), count_(count) {
+    messages->TakeBatch(&messages_, -1);
+  }
+
+  virtual void Run() {
+    DeliverMessages(func_, batch_func_, &messages_, count_);
+  }
+
+  static void RunOnExecutor(void* task) {
+    NativeMessageDeliveryTask* delivery =
+        reinterpret_cast<NativeMessageDeliveryTask*>(task);
+    delivery->Run();
+    delete delivery;
+  }
+
+ private:
+  Dart_NativeMessageHandler func_;
+  Dart_NativeMessageBatchHandler batch_func_;
+  MessageQueue messages_;
+  intptr_t count_;
+
+  DISALLOW_COPY_AND_ASSIGN(NativeMessageDeliveryTask);
+};
+
+// Deletes the pool of a port with a dedicated thread. A pool cannot be shut
+// down from one of its own workers, which is where the handler is usually
+// deleted.
+class DeleteThreadPoolTask : public ThreadPool::Task {
+ public:
+  explicit DeleteThreadPoolTask(ThreadPool* pool) : pool_(pool) {}
+
+  virtual void Run() { delete pool_; }
+
+ private:
+  ThreadPool* pool_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeleteThreadPoolTask);
+};
+
 NativeMessageHandler::NativeMessageHandler(const char* name,
                                            Dart_NativeMessageHandler func)
-    : name_(strdup(name)), func_(func) {}
+    : name_(strdup(name)),
+      func_(func),
+      batch_func_(NULL),
+      max_batch_size_(0),
+      handle_concurrently_(false),
+      executor_(NULL),
+      executor_data_(NULL),
+      dedicated_pool_(NULL),
+      pending_(),
+      pending_count_(0) {}
+
+NativeMessageHandler::NativeMessageHandler(
+    const char* name,
+    Dart_NativeMessageHandler func,
+    const Dart_NativePortOptions& options)
+    : name_(strdup(name)),
+      func_(func),
+      batch_func_(options.batch_handler),
+      max_batch_size_(options.max_batch_size),
+      handle_concurrently_(options.handle_concurrently),
+      executor_(NULL),
+      executor_data_(NULL),
+      dedicated_pool_(NULL),
+      pending_(),
+      pending_count_(0) {
+  switch (options.threading) {
+    case Dart_NativePortThreading_ThreadPool:
+      break;
+    case Dart_NativePortThreading_DedicatedThread:
+      ASSERT(!handle_concurrently_);
+      dedicated_pool_ = new ThreadPool(1, /*release_idle_workers=*/false);
+      break;
+    case Dart_NativePortThreading_Executor:
+      ASSERT(options.executor != NULL);
+      executor_ = options.executor;
+      executor_data_ = options.executor_data;
+      break;
+  }
+}
 
 NativeMessageHandler::~NativeMessageHandler() {
   free(name_);
+  if (dedicated_pool_ != NULL) {
+    // If the VM is shutting down, the dedicated thread stays idle until the
+    // process exits.
+    ThreadPool* vm_pool = Dart::thread_pool();
+    if (vm_pool != NULL) {
+      vm_pool->Run<DeleteThreadPoolTask>(dedicated_pool_);
+    }
+    dedicated_pool_ = NULL;
+  }
+}
+
+ThreadPool* NativeMessageHandler::pool() const {
+  return (dedicated_pool_ != NULL) ? dedicated_pool_ : Dart::thread_pool();
 }
 
 #if defined(DEBUG)
@@ -25,21 +159,54 @@ void NativeMessageHandler::CheckAccess() {
 }
 #endif
 
+bool NativeMessageHandler::StartTask(ThreadPool* pool) {
+  if (executor_ == NULL) {
+    return MessageHandler::StartTask(pool);
+  }
+  // The handler is not deleted while its task is pending.
+  (*executor_)(&RunTaskOnExecutor, this, executor_data_);
+  return true;
+}
+
+void NativeMessageHandler::RunTaskOnExecutor(void* handler) {
+  reinterpret_cast<NativeMessageHandler*>(handler)->RunTask();
+}
+
 MessageHandler::MessageStatus NativeMessageHandler::HandleMessage(
     std::unique_ptr<Message> message) {
   if (message->IsOOB()) {
     // We currently do not use OOB messages for native ports.
     UNREACHABLE();
   }
-  // We create a native scope for handling the message.
-  // All allocation of objects for decoding the message is done in the
-  // zone associated with this scope.
-  ApiNativeScope scope;
-  Dart_CObject* object;
-  ApiMessageReader reader(message.get());
-  object = reader.ReadMessage();
-  (*func())(message->dest_port(), object);
+  pending_.Enqueue(std::move(message), false);
+  pending_count_++;
+  // A batch ends when it is full or when no more messages are waiting.
+  // Messages posted after that are delivered in the next batch.
+  if ((batch_func_ == NULL) ||
+      ((max_batch_size_ > 0) && (pending_count_ >= max_batch_size_)) ||
+      !HasMoreMessages()) {
+    DeliverPending();
+  }
   return kOK;
 }
 
+void NativeMessageHandler::DeliverPending() {
+  const intptr_t count = pending_count_;
+  pending_count_ = 0;
+  if (!handle_concurrently_) {
+    DeliverMessages(func_, batch_func_, &pending_, count);
+    return;
+  }
+  if (executor_ != NULL) {
+    NativeMessageDeliveryTask* task =
+        new NativeMessageDeliveryTask(func_, batch_func_, &pending_, count);
+    (*executor_)(&NativeMessageDeliveryTask::RunOnExecutor, task,
+                 executor_data_);
+    return;
+  }
+  // The messages are dropped if the VM is shutting down.
+  Dart::thread_pool()->Run<NativeMessageDeliveryTask>(func_, batch_func_,
+                                                      &pending_, count);
+}
+
 }  // namespace dart
@@ -16,11 +16,18 @@ namespace dart {
 class NativeMessageHandler : public MessageHandler {
  public:
   NativeMessageHandler(const char* name, Dart_NativeMessageHandler func);
+  NativeMessageHandler(const char* name,
+                       Dart_NativeMessageHandler func,
+                       const Dart_NativePortOptions& options);
   ~NativeMessageHandler();
 
   const char* name() const { return name_; }
   Dart_NativeMessageHandler func() const { return func_; }
 
+  // The pool to run this handler on: the VM's thread pool, or the
+  // single-thread pool of a port with a dedicated thread.
+  ThreadPool* pool() const;
+
   MessageStatus HandleMessage(std::unique_ptr<Message> message);
 
 #if defined(DEBUG)
@@ -31,9 +38,31 @@ class NativeMessageHandler : public MessageHandler {
   // Delete this handlers when its last live port is closed.
   virtual bool OwnedByPortMap() const { return true; }
 
+ protected:
+  virtual bool StartTask(ThreadPool* pool);
+
  private:
+  static void RunTaskOnExecutor(void* handler);
+
+  // Hands the messages in |pending_| to the handler, on this thread or, if
+  // the port handles messages concurrently, in a task of their own.
+  void DeliverPending();
+
   char* name_;
   Dart_NativeMessageHandler func_;
+  Dart_NativeMessageBatchHandler batch_func_;
+  intptr_t max_batch_size_;
+  bool handle_concurrently_;
+  Dart_NativePortExecutor executor_;
+  void* executor_data_;
+  ThreadPool* dedicated_pool_;
+
+  // Messages received for the batch being collected. Only accessed by the
+  // thread handling messages.
+  MessageQueue pending_;
+  intptr_t pending_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(NativeMessageHandler);
 };
 
 }  // namespace dart
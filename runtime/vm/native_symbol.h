@@ -18,6 +18,9 @@ class NativeSymbolResolver : public AllStatic {
   static void Cleanup();
   static char* LookupSymbolName(uintptr_t pc, uintptr_t* start);
   static bool LookupSharedObject(uword pc, uword* dso_base, char** dso_name);
+  // Returns the GNU build ID of the shared object containing [pc] in
+  // hexadecimal, or NULL if it has none. Free it with FreeSymbolName.
+  static char* LookupBuildId(uword pc);
   static void FreeSymbolName(char* name);
   static void AddSymbols(const char* dso_name, void* buffer, size_t size);
 };
@@ -5,11 +5,18 @@
 #include "platform/globals.h"
 #if defined(HOST_OS_ANDROID)
 
+#include "platform/utils.h"
 #include "vm/native_symbol.h"
 #include "vm/os.h"
 
 #include <cxxabi.h>  // NOLINT
 #include <dlfcn.h>   // NOLINT
+#include <elf.h>     // NOLINT
+#include <link.h>    // NOLINT
+
+#if !defined(NT_GNU_BUILD_ID)
+#define NT_GNU_BUILD_ID 3
+#endif
 
 namespace dart {
 
@@ -56,6 +63,67 @@ bool NativeSymbolResolver::LookupSharedObject(uword pc,
   return true;
 }
 
+struct BuildIdSearch {
+  uword pc;
+  char* build_id;
+};
+
+static char* ToHex(const uint8_t* bytes, intptr_t length) {
+  static const char kHexDigits[] = "0123456789abcdef";
+  char* hex = reinterpret_cast<char*>(malloc(2 * length + 1));
+  for (intptr_t i = 0; i < length; i++) {
+    hex[2 * i] = kHexDigits[bytes[i] >> 4];
+    hex[2 * i + 1] = kHexDigits[bytes[i] & 0xf];
+  }
+  hex[2 * length] = '\0';
+  return hex;
+}
+
+static int FindBuildId(struct dl_phdr_info* info, size_t size, void* data) {
+  BuildIdSearch* search = reinterpret_cast<BuildIdSearch*>(data);
+  bool contains_pc = false;
+  for (intptr_t i = 0; i < info->dlpi_phnum; i++) {
+    const ElfW(Phdr)& phdr = info->dlpi_phdr[i];
+    const uword start = info->dlpi_addr + phdr.p_vaddr;
+    if ((phdr.p_type == PT_LOAD) && (search->pc >= start) &&
+        (search->pc < start + phdr.p_memsz)) {
+      contains_pc = true;
+      break;
+    }
+  }
+  if (!contains_pc) {
+    return 0;  // Continue with the next shared object.
+  }
+  for (intptr_t i = 0; i < info->dlpi_phnum; i++) {
+    const ElfW(Phdr)& phdr = info->dlpi_phdr[i];
+    if (phdr.p_type != PT_NOTE) {
+      continue;
+    }
+    uword note = info->dlpi_addr + phdr.p_vaddr;
+    const uword end = note + phdr.p_memsz;
+    while (note + sizeof(ElfW(Nhdr)) <= end) {
+      const ElfW(Nhdr)* header = reinterpret_cast<const ElfW(Nhdr)*>(note);
+      const uword name = note + sizeof(ElfW(Nhdr));
+      const uword desc = name + Utils::RoundUp(header->n_namesz, 4);
+      note = desc + Utils::RoundUp(header->n_descsz, 4);
+      if ((header->n_type == NT_GNU_BUILD_ID) && (header->n_namesz == 4) &&
+          (note <= end) &&
+          (memcmp(reinterpret_cast<const void*>(name), "GNU", 4) == 0)) {
+        search->build_id = ToHex(reinterpret_cast<const uint8_t*>(desc),
+                                 header->n_descsz);
+        return 1;
+      }
+    }
+  }
+  return 1;  // The shared object has no build ID.
+}
+
+char* NativeSymbolResolver::LookupBuildId(uword pc) {
+  BuildIdSearch search = {pc, NULL};
+  dl_iterate_phdr(FindBuildId, &search);
+  return search.build_id;
+}
+
 void NativeSymbolResolver::AddSymbols(const char* dso_name,
                                       void* buffer,
                                       size_t size) {
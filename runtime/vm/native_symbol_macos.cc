@@ -54,6 +54,10 @@ bool NativeSymbolResolver::LookupSharedObject(uword pc,
   return true;
 }
 
+char* NativeSymbolResolver::LookupBuildId(uword pc) {
+  return NULL;
+}
+
 void NativeSymbolResolver::AddSymbols(const char* dso_name,
                                       void* buffer,
                                       size_t size) {
@@ -9,6 +9,7 @@
 #include "include/dart_api.h"
 #include "platform/assert.h"
 #include "platform/unicode.h"
+#include "vm/base64.h"
 #include "vm/bit_vector.h"
 #include "vm/bootstrap.h"
 #include "vm/class_finalizer.h"
@@ -48,6 +49,7 @@
 #include "vm/profiler.h"
 #include "vm/resolver.h"
 #include "vm/reusable_handles.h"
+#include "vm/reverse_pc_lookup_cache.h"
 #include "vm/runtime_entry.h"
 #include "vm/scopes.h"
 #include "vm/stack_frame.h"
@@ -74,6 +76,11 @@ DEFINE_FLAG(
     "instead of showing the corresponding interface names (e.g. \"String\")");
 DEFINE_FLAG(bool, use_lib_cache, false, "Use library name cache");
 DEFINE_FLAG(bool, use_exp_cache, false, "Use library exported name cache");
+DEFINE_FLAG(bool,
+            inline_unboxed_fields,
+            false,
+            "In AOT, store non-nullable double and int instance fields "
+            "unboxed inside of the instance.");
 
 DEFINE_FLAG(bool,
             remove_script_timestamps_for_test,
@@ -542,6 +549,7 @@ void Object::Init(Isolate* isolate) {
     cls.set_type_arguments_field_offset_in_words(Class::kNoTypeArguments);
     cls.set_num_type_arguments(0);
     cls.set_num_native_fields(0);
+    cls.set_unboxed_fields_bitmap(0);
     cls.InitEmptyFields();
     isolate->RegisterClass(cls);
   }
@@ -1899,6 +1907,13 @@ RawError* Object::Init(Isolate* isolate,
     pending_classes.Add(cls);
     RegisterClass(cls, Symbols::FfiNativeFunction(), lib);
 
+    cls = Class::New<Instance>(kFfiByValueCid);
+    cls.set_type_arguments_field_offset(Pointer::type_arguments_offset());
+    cls.set_num_type_arguments(1);
+    cls.set_is_prefinalized();
+    pending_classes.Add(cls);
+    RegisterClass(cls, Symbols::FfiByValue(), lib);
+
     cls = Class::NewPointerClass(kFfiPointerCid);
     object_store->set_ffi_pointer_class(cls);
     pending_classes.Add(cls);
@@ -2004,6 +2019,8 @@ RawError* Object::Init(Isolate* isolate,
 
     cls = Class::New<Instance>(kFfiNativeFunctionCid);
 
+    cls = Class::New<Instance>(kFfiByValueCid);
+
     cls = Class::NewPointerClass(kFfiPointerCid);
     object_store->set_ffi_pointer_class(cls);
 
@@ -2178,13 +2195,24 @@ RawObject* Object::Allocate(intptr_t cls_id, intptr_t size, Heap::Space space) {
   InitializeObject(address, cls_id, size);
   RawObject* raw_obj = reinterpret_cast<RawObject*>(address + kHeapObjectTag);
   ASSERT(cls_id == RawObject::ClassIdTag::decode(raw_obj->ptr()->tags_));
+#ifndef PRODUCT
+  // New-space bytes are counted when the TLAB is refilled, so that inline
+  // allocation in compiled code never has to check for sampling.
+  if (raw_obj->IsOldObject()) {
+    thread->CountHeapSampleBytes(size);
+  }
+  if (UNLIKELY(thread->TakeHeapSample())) {
+    Profiler::SampleAllocation(thread, cls_id);
+    heap->RecordHeapSample(raw_obj, size);
+  }
+#endif  // !PRODUCT
   if (raw_obj->IsOldObject() && thread->is_marking()) {
     // Black allocation. Prevents a data race between the mutator and concurrent
     // marker on ARM and ARM64 (the marker may observe a publishing store of
     // this object before the stores that initialize its slots), and helps the
     // collection to finish sooner.
     raw_obj->SetMarkBitUnsynchronized();
-    heap->old_space()->AllocateBlack(size);
+    heap->old_space()->AllocateBlack(raw_obj, size);
   }
   return raw_obj;
 }
@@ -2302,6 +2330,7 @@ RawClass* Class::New() {
   result.set_id(FakeObject::kClassId);
   result.set_num_type_arguments(0);
   result.set_num_native_fields(0);
+  result.set_unboxed_fields_bitmap(0);
   result.set_state_bits(0);
   if ((FakeObject::kClassId < kInstanceCid) ||
       (FakeObject::kClassId == kTypeArgumentsCid)) {
@@ -2753,17 +2782,48 @@ RawTypeParameter* Class::LookupTypeParameter(const String& type_name) const {
   return TypeParameter::null();
 }
 
+// Tests if the value of the instance field can be stored unboxed inside of
+// the instance. This needs the type flow analysis of the precompiler to prove
+// that the field never holds null, and code generation support for unboxed
+// field accesses. Only 64-bit targets are handled, where both double and int
+// values take exactly one word.
+static bool ShouldUnboxField(const Class& cls, const Field& field) {
+#if defined(DART_PRECOMPILER) &&                                               \
+    (defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64))
+  if (!FLAG_precompiled_mode || !FLAG_inline_unboxed_fields) {
+    return false;
+  }
+  // Instances of VM recognized library classes may be accessed in the
+  // runtime at known offsets.
+  if (Library::Handle(cls.library()).is_dart_scheme() ||
+      (cls.num_native_fields() > 0)) {
+    return false;
+  }
+  if ((field.guarded_cid() == kIllegalCid) || field.is_nullable()) {
+    return false;
+  }
+  if (field.guarded_cid() == kDoubleCid) {
+    return true;
+  }
+  return AbstractType::Handle(field.type()).IsIntType();
+#else
+  return false;
+#endif
+}
+
 void Class::CalculateFieldOffsets() const {
   Array& flds = Array::Handle(fields());
   const Class& super = Class::Handle(SuperClass());
   intptr_t offset = 0;
   intptr_t type_args_field_offset = kNoTypeArguments;
+  uint32_t unboxed_fields_bitmap = 0;
   if (super.IsNull()) {
     offset = Instance::NextFieldOffset();
     ASSERT(offset > 0);
   } else {
     ASSERT(super.is_finalized() || super.is_prefinalized());
     type_args_field_offset = super.type_arguments_field_offset();
+    unboxed_fields_bitmap = super.unboxed_fields_bitmap();
     offset = super.next_field_offset();
     ASSERT(offset > 0);
     // We should never call CalculateFieldOffsets for native wrapper
@@ -2793,11 +2853,19 @@ void Class::CalculateFieldOffsets() const {
     if (!field.is_static()) {
       ASSERT(field.Offset() == 0);
       field.SetOffset(offset);
+      const intptr_t index = offset / kWordSize;
+      if ((index < kBitsPerInt32) && ShouldUnboxField(*this, field)) {
+        // The field is no longer a candidate for a mutable box.
+        field.set_is_unboxing_candidate(false);
+        field.set_is_unboxed(true);
+        unboxed_fields_bitmap |= 1u << index;
+      }
       offset += kWordSize;
     }
   }
   set_instance_size(RoundedAllocationSize(offset));
   set_next_field_offset(offset);
+  set_unboxed_fields_bitmap(unboxed_fields_bitmap);
 }
 
 void Class::AddInvocationDispatcher(const String& target_name,
@@ -2826,6 +2894,15 @@ void Class::AddInvocationDispatcher(const String& target_name,
   entry.Set<Class::kInvocationDispatcherFunction>(dispatcher);
 }
 
+// Dispatchers, forwarders and implicit closures are created lazily, and only
+// by the mutator thread. A background compilation that needs one that does
+// not exist yet gives up, and the function is compiled again later.
+static void BailoutIfBackgroundCompilation(const char* reason) {
+  if (Compiler::IsBackgroundCompilation()) {
+    Compiler::AbortBackgroundCompilation(DeoptId::kNone, reason);
+  }
+}
+
 RawFunction* Class::GetInvocationDispatcher(const String& target_name,
                                             const Array& args_desc,
                                             RawFunction::Kind kind,
@@ -2854,6 +2931,7 @@ RawFunction* Class::GetInvocationDispatcher(const String& target_name,
   }
 
   if (function.IsNull() && create_if_absent) {
+    BailoutIfBackgroundCompilation("Dispatcher creation while compiling");
     function = CreateInvocationDispatcher(target_name, args_desc, kind);
     AddInvocationDispatcher(target_name, args_desc, function);
   }
@@ -2926,6 +3004,7 @@ RawFunction* Class::CreateInvocationDispatcher(const String& target_name,
 // is created and injected as a getter (under the name get:M) into the class
 // owning method M.
 RawFunction* Function::CreateMethodExtractor(const String& getter_name) const {
+  BailoutIfBackgroundCompilation("Method extractor creation while compiling");
   Thread* thread = Thread::Current();
   Zone* zone = thread->zone();
   ASSERT(Field::IsGetterName(getter_name));
@@ -3104,6 +3183,10 @@ RawFunction* Function::GetDynamicInvocationForwarder(
     return result.raw();
   }
 
+  if (allow_add) {
+    BailoutIfBackgroundCompilation("Forwarder creation while compiling");
+  }
+
   // Check if function actually needs a dynamic invocation forwarder.
   if (!kernel::NeedsDynamicInvocationForwarder(*this)) {
     result = raw();
@@ -3172,10 +3255,33 @@ void Class::Finalize() const {
   set_is_finalized();
 }
 
+// Returns the member name 'selector' refers to, without the prefix of a
+// getter, setter or dynamic invocation forwarder.
+static RawString* SelectorMemberName(const String& selector) {
+  Zone* zone = Thread::Current()->zone();
+  String& name = String::Handle(zone, selector.raw());
+  if (Function::IsDynamicInvocationForwarderName(name)) {
+    name = Function::DemangleDynamicInvocationForwarderName(name);
+  }
+  if (Field::IsGetterName(name)) {
+    name = Field::NameFromGetter(name);
+  } else if (Field::IsSetterName(name)) {
+    name = Field::NameFromSetter(name);
+  }
+  return name.raw();
+}
+
 class CHACodeArray : public WeakCodeReferences {
  public:
   explicit CHACodeArray(const Class& cls)
-      : WeakCodeReferences(Array::Handle(cls.dependent_code())), cls_(cls) {}
+      : WeakCodeReferences(Array::Handle(cls.dependent_code())),
+        cls_(cls),
+        subclass_(Class::Handle()) {}
+
+  CHACodeArray(const Class& cls, const Class& subclass)
+      : WeakCodeReferences(Array::Handle(cls.dependent_code())),
+        cls_(cls),
+        subclass_(subclass) {}
 
   virtual void UpdateArrayTo(const Array& value) {
     // TODO(fschneider): Fails for classes in the VM isolate.
@@ -3200,8 +3306,18 @@ class CHACodeArray : public WeakCodeReferences {
     }
   }
 
+  // Code that only relies on a selector not being overridden survives a
+  // new subclass that does not declare it.
+  virtual bool IsAffected(const Object& dependency) const {
+    if (subclass_.IsNull() || dependency.IsNull()) {
+      return true;
+    }
+    return subclass_.DeclaresSelector(String::Cast(dependency));
+  }
+
  private:
   const Class& cls_;
+  const Class& subclass_;
   DISALLOW_COPY_AND_ASSIGN(CHACodeArray);
 };
 
@@ -3212,21 +3328,57 @@ static bool IsMutatorOrAtSafepoint() {
 }
 #endif
 
+bool Class::DeclaresSelector(const String& selector) const {
+  Zone* zone = Thread::Current()->zone();
+  const String& name = String::Handle(zone, SelectorMemberName(selector));
+  String& member_name = String::Handle(zone);
+  const Array& funcs = Array::Handle(zone, functions());
+  Function& function = Function::Handle(zone);
+  for (intptr_t i = 0; i < funcs.Length(); i++) {
+    function ^= funcs.At(i);
+    member_name = function.name();
+    member_name = SelectorMemberName(member_name);
+    if (member_name.Equals(name)) {
+      return true;
+    }
+  }
+  const Array& field_array = Array::Handle(zone, fields());
+  Field& field = Field::Handle(zone);
+  for (intptr_t i = 0; i < field_array.Length(); i++) {
+    field ^= field_array.At(i);
+    member_name = field.name();
+    if (member_name.Equals(name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void Class::RegisterCHACode(const Code& code) {
+  RegisterCHACode(code, String::Handle());
+}
+
+void Class::RegisterCHACode(const Code& code, const String& selector) {
   if (FLAG_trace_cha) {
-    THR_Print("RegisterCHACode '%s' depends on class '%s'\n",
-              Function::Handle(code.function()).ToQualifiedCString(),
-              ToCString());
+    if (selector.IsNull()) {
+      THR_Print("RegisterCHACode '%s' depends on class '%s'\n",
+                Function::Handle(code.function()).ToQualifiedCString(),
+                ToCString());
+    } else {
+      THR_Print("RegisterCHACode '%s' depends on '%s' of class '%s'\n",
+                Function::Handle(code.function()).ToQualifiedCString(),
+                selector.ToCString(), ToCString());
+    }
   }
   DEBUG_ASSERT(IsMutatorOrAtSafepoint());
   ASSERT(code.is_optimized());
   CHACodeArray a(*this);
-  a.Register(code);
+  a.Register(code, selector);
 }
 
 void Class::DisableCHAOptimizedCode(const Class& subclass) {
   ASSERT(Thread::Current()->IsMutatorThread());
-  CHACodeArray a(*this);
+  CHACodeArray a(*this, subclass);
   if (FLAG_trace_deoptimization && a.HasCodes()) {
     if (subclass.IsNull()) {
       THR_Print("Deopt for CHA (all)\n");
@@ -3670,6 +3822,7 @@ RawClass* Class::NewCommon(intptr_t index) {
   result.set_id(index);
   result.set_num_type_arguments(kUnknownNumTypeArguments);
   result.set_num_native_fields(0);
+  result.set_unboxed_fields_bitmap(0);
   result.set_state_bits(0);
   NOT_IN_PRECOMPILED(result.set_is_declared_in_bytecode(false));
   NOT_IN_PRECOMPILED(result.set_binary_declaration_offset(0));
@@ -4758,7 +4911,8 @@ RawDouble* Class::LookupCanonicalDouble(Zone* zone, double value) const {
   Double& canonical_value = Double::Handle(zone);
   CanonicalDoubleSet constants(zone, this->constants());
   canonical_value ^= constants.GetOrNull(CanonicalDoubleKey(value));
-  this->set_constants(constants.Release());
+  // Not stored back, since this may run without the canonicalization mutex.
+  constants.Release();
   return canonical_value.raw();
 }
 
@@ -4770,7 +4924,8 @@ RawMint* Class::LookupCanonicalMint(Zone* zone, int64_t value) const {
   Mint& canonical_value = Mint::Handle(zone);
   CanonicalMintSet constants(zone, this->constants());
   canonical_value ^= constants.GetOrNull(CanonicalMintKey(value));
-  this->set_constants(constants.Release());
+  // Not stored back, since this may run without the canonicalization mutex.
+  constants.Release();
   return canonical_value.raw();
 }
 
@@ -4829,7 +4984,8 @@ RawInstance* Class::LookupCanonicalInstance(Zone* zone,
   if (this->constants() != Object::empty_array().raw()) {
     CanonicalInstancesSet constants(zone, this->constants());
     canonical_value ^= constants.GetOrNull(CanonicalInstanceKey(value));
-    this->set_constants(constants.Release());
+    // Not stored back, since this may run without the canonicalization mutex.
+    constants.Release();
   }
   return canonical_value.raw();
 }
@@ -5077,6 +5233,10 @@ bool TypeArguments::HasInstantiations() const {
 intptr_t TypeArguments::NumInstantiations() const {
   const Array& prior_instantiations = Array::Handle(instantiations());
   ASSERT(prior_instantiations.Length() > 0);  // Always at least a sentinel.
+  if (IsHashedInstantiations(prior_instantiations)) {
+    return Smi::Value(
+        Smi::RawCast(prior_instantiations.At(kHashedInstantiationsUsedIndex)));
+  }
   intptr_t num = 0;
   intptr_t i = 0;
   while (prior_instantiations.At(i) != Smi::New(StubCode::kNoInstantiator)) {
@@ -5327,6 +5487,138 @@ RawTypeArguments* TypeArguments::InstantiateFrom(
   return instantiated_array.raw();
 }
 
+bool TypeArguments::IsHashedInstantiations(const Array& instantiations) {
+  // Linear caches only start with kNoInstantiator while they are empty,
+  // i.e. Object::zero_array().
+  return (instantiations.Length() > 1) &&
+         (instantiations.At(0) == Smi::New(StubCode::kNoInstantiator));
+}
+
+RawObject** TypeArguments::InstantiationsProbeStart(
+    RawArray* instantiations,
+    RawObject* instantiator_type_args,
+    RawObject* function_type_args) {
+  RawObject** data = instantiations->ptr()->data();
+  if ((data[0] != Smi::New(StubCode::kNoInstantiator)) ||
+      (Smi::Value(instantiations->ptr()->length_) == 1)) {
+    return data;
+  }
+  intptr_t instantiator_hash = 0;
+  if (instantiator_type_args != Object::null()) {
+    instantiator_hash = Smi::Value(
+        static_cast<RawTypeArguments*>(instantiator_type_args)->ptr()->hash_);
+  }
+  intptr_t function_hash = 0;
+  if (function_type_args != Object::null()) {
+    function_hash = Smi::Value(
+        static_cast<RawTypeArguments*>(function_type_args)->ptr()->hash_);
+  }
+  const intptr_t mask =
+      Smi::Value(Smi::RawCast(data[kHashedInstantiationsMaskIndex]));
+  const intptr_t start =
+      HashedInstantiationsProbeStart(instantiator_hash, function_hash, mask);
+  return data + start * StubCode::kInstantiationSizeInWords;
+}
+
+static intptr_t HashedInstantiationsMask(const Array& instantiations) {
+  return Smi::Value(Smi::RawCast(
+      instantiations.At(TypeArguments::kHashedInstantiationsMaskIndex)));
+}
+
+// Returns the index of the entry for the given instantiators in a hashed
+// instantiations cache, or of the unused entry where it belongs. Like in the
+// fast paths, the probe goes on linearly up to an unused entry, which always
+// comes before the end of the table. Hash() computes the hashes the fast
+// paths find in the instantiators once they are canonical.
+static intptr_t FindHashedInstantiation(
+    const Array& instantiations,
+    const TypeArguments& instantiator_type_arguments,
+    const TypeArguments& function_type_arguments) {
+  const intptr_t mask = HashedInstantiationsMask(instantiations);
+  for (intptr_t index = TypeArguments::HashedInstantiationsProbeStart(
+                            instantiator_type_arguments.Hash(),
+                            function_type_arguments.Hash(), mask) *
+                        StubCode::kInstantiationSizeInWords;
+       ; index += StubCode::kInstantiationSizeInWords) {
+    ASSERT(index < instantiations.Length());
+    RawObject* key = instantiations.At(index);
+    if ((key == Smi::New(StubCode::kNoInstantiator)) ||
+        ((key == instantiator_type_arguments.raw()) &&
+         (instantiations.At(index + 1) == function_type_arguments.raw()))) {
+      return index;
+    }
+  }
+}
+
+static void AddHashedInstantiation(
+    const Array& instantiations,
+    const TypeArguments& instantiator_type_arguments,
+    const TypeArguments& function_type_arguments,
+    const TypeArguments& instantiated_type_arguments) {
+  const intptr_t index =
+      FindHashedInstantiation(instantiations, instantiator_type_arguments,
+                              function_type_arguments);
+  ASSERT(instantiations.At(index) == Smi::New(StubCode::kNoInstantiator));
+  instantiations.SetAt(index + 0, instantiator_type_arguments);
+  instantiations.SetAt(index + 1, function_type_arguments);
+  instantiations.SetAt(index + 2, instantiated_type_arguments);
+  const intptr_t used =
+      Smi::Value(Smi::RawCast(instantiations.At(
+          TypeArguments::kHashedInstantiationsUsedIndex))) +
+      1;
+  // Keep the load factor at most 1/2, so probes stay short.
+  ASSERT(2 * used <= HashedInstantiationsMask(instantiations) + 1);
+  instantiations.SetAt(TypeArguments::kHashedInstantiationsUsedIndex,
+                       Smi::Handle(Smi::New(used)));
+}
+
+// Copies the 'entries' entries of 'old_instantiations', a linear or hashed
+// cache, into a new hashed cache with room for at least 'new_entries' more.
+static RawArray* RehashInstantiations(const Array& old_instantiations,
+                                      intptr_t entries,
+                                      intptr_t new_entries) {
+  const intptr_t capacity =
+      Utils::RoundUpToPowerOfTwo(2 * (entries + new_entries));
+  // A run of used entries starts at most at the last of the 'capacity'
+  // probe starts and holds at most 'capacity / 2' entries.
+  const intptr_t length = 1 + capacity + capacity / 2;
+  const Array& instantiations = Array::Handle(Array::New(
+      length * StubCode::kInstantiationSizeInWords, Heap::kOld));
+  const Smi& no_instantiator =
+      Smi::Handle(Smi::New(StubCode::kNoInstantiator));
+  for (intptr_t i = 0; i < length; i++) {
+    instantiations.SetAt(i * StubCode::kInstantiationSizeInWords,
+                         no_instantiator);
+  }
+  instantiations.SetAt(TypeArguments::kHashedInstantiationsUsedIndex,
+                       Smi::Handle(Smi::New(0)));
+  instantiations.SetAt(TypeArguments::kHashedInstantiationsMaskIndex,
+                       Smi::Handle(Smi::New(capacity - 1)));
+  TypeArguments& instantiator_type_arguments = TypeArguments::Handle();
+  TypeArguments& function_type_arguments = TypeArguments::Handle();
+  TypeArguments& instantiated_type_arguments = TypeArguments::Handle();
+  const bool is_hashed =
+      TypeArguments::IsHashedInstantiations(old_instantiations);
+  // Skip the header of a hashed cache.
+  intptr_t index = is_hashed ? StubCode::kInstantiationSizeInWords : 0;
+  for (; index < old_instantiations.Length();
+       index += StubCode::kInstantiationSizeInWords) {
+    if (old_instantiations.At(index) == Smi::New(StubCode::kNoInstantiator)) {
+      if (!is_hashed) break;  // End of a linear cache.
+      continue;
+    }
+    instantiator_type_arguments ^= old_instantiations.At(index + 0);
+    function_type_arguments ^= old_instantiations.At(index + 1);
+    instantiated_type_arguments ^= old_instantiations.At(index + 2);
+    AddHashedInstantiation(instantiations, instantiator_type_arguments,
+                           function_type_arguments,
+                           instantiated_type_arguments);
+  }
+  ASSERT(Smi::Value(Smi::RawCast(instantiations.At(
+             TypeArguments::kHashedInstantiationsUsedIndex))) == entries);
+  return instantiations.raw();
+}
+
 RawTypeArguments* TypeArguments::InstantiateAndCanonicalizeFrom(
     const TypeArguments& instantiator_type_arguments,
     const TypeArguments& function_type_arguments) const {
@@ -5341,16 +5633,30 @@ RawTypeArguments* TypeArguments::InstantiateAndCanonicalizeFrom(
   // The instantiations cache is initialized with Object::zero_array() and is
   // therefore guaranteed to contain kNoInstantiator. No length check needed.
   ASSERT(prior_instantiations.Length() > 0);  // Always at least a sentinel.
+  const bool is_hashed = IsHashedInstantiations(prior_instantiations);
   intptr_t index = 0;
-  while (true) {
-    if ((prior_instantiations.At(index) == instantiator_type_arguments.raw()) &&
-        (prior_instantiations.At(index + 1) == function_type_arguments.raw())) {
+  if (is_hashed) {
+    index = FindHashedInstantiation(prior_instantiations,
+                                    instantiator_type_arguments,
+                                    function_type_arguments);
+    if (prior_instantiations.At(index) !=
+        Smi::New(StubCode::kNoInstantiator)) {
       return TypeArguments::RawCast(prior_instantiations.At(index + 2));
     }
-    if (prior_instantiations.At(index) == Smi::New(StubCode::kNoInstantiator)) {
-      break;
+  } else {
+    while (true) {
+      if ((prior_instantiations.At(index) ==
+           instantiator_type_arguments.raw()) &&
+          (prior_instantiations.At(index + 1) ==
+           function_type_arguments.raw())) {
+        return TypeArguments::RawCast(prior_instantiations.At(index + 2));
+      }
+      if (prior_instantiations.At(index) ==
+          Smi::New(StubCode::kNoInstantiator)) {
+        break;
+      }
+      index += StubCode::kInstantiationSizeInWords;
     }
-    index += StubCode::kInstantiationSizeInWords;
   }
   // Cache lookup failed. Instantiate the type arguments.
   TypeArguments& result = TypeArguments::Handle();
@@ -5361,6 +5667,21 @@ RawTypeArguments* TypeArguments::InstantiateAndCanonicalizeFrom(
   // InstantiateAndCanonicalizeFrom is not reentrant. It cannot have been called
   // indirectly, so the prior_instantiations array cannot have grown.
   ASSERT(prior_instantiations.raw() == instantiations());
+  const intptr_t entries =
+      is_hashed ? NumInstantiations()
+                : (index / StubCode::kInstantiationSizeInWords);
+  if (is_hashed || (entries >= kMaxLinearInstantiations)) {
+    if (!is_hashed ||
+        (2 * (entries + 1) >
+         HashedInstantiationsMask(prior_instantiations) + 1)) {
+      prior_instantiations =
+          RehashInstantiations(prior_instantiations, entries, entries + 1);
+      set_instantiations(prior_instantiations);
+    }
+    AddHashedInstantiation(prior_instantiations, instantiator_type_arguments,
+                           function_type_arguments, result);
+    return result.raw();
+  }
   // Add instantiator and function type args and result to instantiations array.
   intptr_t length = prior_instantiations.Length();
   if ((index + StubCode::kInstantiationSizeInWords) >= length) {
@@ -5432,11 +5753,12 @@ RawTypeArguments* TypeArguments::Canonicalize(TrailPtr trail) const {
   ObjectStore* object_store = isolate->object_store();
   TypeArguments& result = TypeArguments::Handle(zone);
   {
-    SafepointMutexLocker ml(isolate->type_canonicalization_mutex());
+    // Look up without the mutex (see type_table.h). A vector inserted
+    // meanwhile is found by the lookup under the mutex below.
     CanonicalTypeArgumentsSet table(zone,
                                     object_store->canonical_type_arguments());
     result ^= table.GetOrNull(CanonicalTypeArgumentsKey(*this));
-    object_store->set_canonical_type_arguments(table.Release());
+    table.Release();
   }
   if (result.IsNull()) {
     // Canonicalize each type argument.
@@ -6027,6 +6349,20 @@ void Function::SetFfiCallbackTarget(const Function& target) const {
   FfiTrampolineData::Cast(obj).set_callback_target(target);
 }
 
+bool Function::FfiIsLeaf() const {
+  ASSERT(IsFfiTrampoline());
+  const Object& obj = Object::Handle(raw_ptr()->data_);
+  ASSERT(!obj.IsNull());
+  return FfiTrampolineData::Cast(obj).is_leaf();
+}
+
+void Function::SetFfiIsLeaf(bool value) const {
+  ASSERT(IsFfiTrampoline());
+  const Object& obj = Object::Handle(raw_ptr()->data_);
+  ASSERT(!obj.IsNull());
+  FfiTrampolineData::Cast(obj).set_is_leaf(value);
+}
+
 RawType* Function::SignatureType() const {
   Type& type = Type::Handle(ExistingSignatureType());
   if (type.IsNull()) {
@@ -7360,6 +7696,7 @@ RawFunction* Function::ImplicitClosureFunction() const {
   return Function::null();
 #else
   ASSERT(!IsSignatureFunction() && !IsClosureFunction());
+  BailoutIfBackgroundCompilation("Closure creation while compiling");
   Thread* thread = Thread::Current();
   Zone* zone = thread->zone();
   // Create closure function.
@@ -7517,6 +7854,7 @@ void Function::BuildSignatureParameters(
 RawInstance* Function::ImplicitStaticClosure() const {
   ASSERT(IsImplicitStaticClosureFunction());
   if (implicit_static_closure() == Instance::null()) {
+    BailoutIfBackgroundCompilation("Closure creation while compiling");
     Zone* zone = Thread::Current()->zone();
     const Context& context = Context::Handle(zone);
     Instance& closure =
@@ -7906,25 +8244,26 @@ int32_t Function::SourceFingerprint() const {
 
 void Function::SaveICDataMap(
     const ZoneGrowableArray<const ICData*>& deopt_id_to_ic_data,
-    const Array& edge_counters_array) const {
+    const Array& edge_counters_array,
+    const Array& coverage_array) const {
 #if !defined(DART_PRECOMPILED_RUNTIME)
   // Compute number of ICData objects to save.
-  // Store edge counter array in the first slot.
-  intptr_t count = 1;
+  intptr_t count = kFirstICDataIndex;
   for (intptr_t i = 0; i < deopt_id_to_ic_data.length(); i++) {
     if (deopt_id_to_ic_data[i] != NULL) {
       count++;
     }
   }
   const Array& array = Array::Handle(Array::New(count, Heap::kOld));
-  count = 1;
+  count = kFirstICDataIndex;
   for (intptr_t i = 0; i < deopt_id_to_ic_data.length(); i++) {
     if (deopt_id_to_ic_data[i] != NULL) {
       ASSERT(i == deopt_id_to_ic_data[i]->deopt_id());
       array.SetAt(count++, *deopt_id_to_ic_data[i]);
     }
   }
-  array.SetAt(0, edge_counters_array);
+  array.SetAt(kEdgeCountersIndex, edge_counters_array);
+  array.SetAt(kCoverageArrayIndex, coverage_array);
   set_ic_data_array(array);
 #else   // DART_PRECOMPILED_RUNTIME
   UNREACHABLE();
@@ -7946,8 +8285,8 @@ void Function::RestoreICDataMap(
     return;
   }
   const intptr_t saved_length = saved_ic_data.Length();
-  ASSERT(saved_length > 0);
-  if (saved_length > 1) {
+  ASSERT(saved_length >= kFirstICDataIndex);
+  if (saved_length > kFirstICDataIndex) {
     const intptr_t restored_length =
         ICData::Cast(Object::Handle(zone, saved_ic_data.At(saved_length - 1)))
             .deopt_id() +
@@ -7956,7 +8295,7 @@ void Function::RestoreICDataMap(
     for (intptr_t i = 0; i < restored_length; i++) {
       (*deopt_id_to_ic_data)[i] = NULL;
     }
-    for (intptr_t i = 1; i < saved_length; i++) {
+    for (intptr_t i = kFirstICDataIndex; i < saved_length; i++) {
       ICData& ic_data = ICData::ZoneHandle(zone);
       ic_data ^= saved_ic_data.At(i);
       if (clone_ic_data) {
@@ -7989,7 +8328,7 @@ void Function::ClearICDataArray() const {
 RawICData* Function::FindICData(intptr_t deopt_id) const {
   const Array& array = Array::Handle(ic_data_array());
   ICData& ic_data = ICData::Handle();
-  for (intptr_t i = 1; i < array.Length(); i++) {
+  for (intptr_t i = kFirstICDataIndex; i < array.Length(); i++) {
     ic_data ^= array.At(i);
     if (ic_data.deopt_id() == deopt_id) {
       return ic_data.raw();
@@ -7998,11 +8337,19 @@ RawICData* Function::FindICData(intptr_t deopt_id) const {
   return ICData::null();
 }
 
+RawArray* Function::GetCoverageArray() const {
+  const Array& array = Array::Handle(ic_data_array());
+  if (array.IsNull()) {
+    return Array::null();
+  }
+  return Array::RawCast(array.At(kCoverageArrayIndex));
+}
+
 void Function::SetDeoptReasonForAll(intptr_t deopt_id,
                                     ICData::DeoptReasonId reason) {
   const Array& array = Array::Handle(ic_data_array());
   ICData& ic_data = ICData::Handle();
-  for (intptr_t i = 1; i < array.Length(); i++) {
+  for (intptr_t i = kFirstICDataIndex; i < array.Length(); i++) {
     ic_data ^= array.At(i);
     if (ic_data.deopt_id() == deopt_id) {
       ic_data.AddDeoptReason(reason);
@@ -8243,6 +8590,10 @@ void FfiTrampolineData::set_callback_id(int32_t callback_id) const {
   StoreNonPointer(&raw_ptr()->callback_id_, callback_id);
 }
 
+void FfiTrampolineData::set_is_leaf(bool is_leaf) const {
+  StoreNonPointer(&raw_ptr()->is_leaf_, is_leaf);
+}
+
 RawFfiTrampolineData* FfiTrampolineData::New() {
   ASSERT(Object::ffi_trampoline_data_class() != Class::null());
   RawObject* raw =
@@ -8250,6 +8601,7 @@ RawFfiTrampolineData* FfiTrampolineData::New() {
                        FfiTrampolineData::InstanceSize(), Heap::kOld);
   RawFfiTrampolineData* data = reinterpret_cast<RawFfiTrampolineData*>(raw);
   data->ptr()->callback_id_ = 0;
+  data->ptr()->is_leaf_ = false;
   return data;
 }
 
@@ -10941,6 +11293,7 @@ RawLibrary* Library::NewLibraryHelper(const String& url, bool import_core_lib) {
   result.StorePointer(&result.raw_ptr()->load_error_, Instance::null());
   result.set_native_entry_resolver(NULL);
   result.set_native_entry_symbol_resolver(NULL);
+  result.set_ffi_native_resolver(NULL);
   result.set_is_in_fullsnapshot(false);
   if (dart_private_scheme) {
     // Never debug dart:_ libraries.
@@ -12557,6 +12910,7 @@ RawObjectPool* ObjectPool::New(intptr_t len) {
 #if !defined(DART_PRECOMPILED_RUNTIME)
 RawObjectPool* ObjectPool::NewFromBuilder(
     const compiler::ObjectPoolBuilder& builder) {
+  ASSERT(builder.base() == 0);
   const intptr_t len = builder.CurrentLength();
   if (len == 0) {
     return Object::empty_object_pool().raw();
@@ -14747,6 +15101,79 @@ class CodeCommentsWrapper final : public CodeComments {
   String& string_;
 };
 
+// Collects the source lines of a code object from its CodeSourceMap.
+class CodeLineInfoWrapper final : public CodeLineInfo {
+ public:
+  CodeLineInfoWrapper() = default;
+
+  void Collect(const Code& code);
+
+  intptr_t Length() const override { return pc_offsets_.length(); }
+  intptr_t PCOffsetAt(intptr_t i) const override { return pc_offsets_[i]; }
+  const char* FileAt(intptr_t i) const override { return files_[i]; }
+  intptr_t LineAt(intptr_t i) const override { return lines_[i]; }
+
+ private:
+  GrowableArray<intptr_t> pc_offsets_;
+  GrowableArray<const char*> files_;
+  GrowableArray<intptr_t> lines_;
+};
+
+void CodeLineInfoWrapper::Collect(const Code& code) {
+  Zone* zone = Thread::Current()->zone();
+  const auto& map = CodeSourceMap::Handle(zone, code.code_source_map());
+  const auto& owner = Object::Handle(zone, code.owner());
+  if (map.IsNull() || !owner.IsFunction()) {
+    return;
+  }
+  const auto& inlined = Array::Handle(zone, code.inlined_id_to_function());
+  CodeSourceMapReader reader(map, inlined, Function::Cast(owner));
+  GrowableArray<int32_t> pc_offsets;
+  GrowableArray<const Function*> functions;
+  GrowableArray<TokenPosition> positions;
+  reader.GetSourcePositions(&pc_offsets, &functions, &positions);
+
+  auto& script = Script::Handle(zone);
+  auto& url = String::Handle(zone);
+  RawFunction* current = Function::null();
+  const char* file = nullptr;
+  for (intptr_t i = 0; i < pc_offsets.length(); i++) {
+    if (!positions[i].IsReal()) {
+      continue;
+    }
+    if (functions[i]->raw() != current) {
+      current = functions[i]->raw();
+      script = functions[i]->script();
+      file = nullptr;
+      if (!script.IsNull()) {
+        url = script.url();
+        file = url.ToCString();
+        const char* kFileScheme = "file://";
+        if (strncmp(file, kFileScheme, strlen(kFileScheme)) == 0) {
+          file += strlen(kFileScheme);
+        }
+      }
+    }
+    if (file == nullptr) {
+      continue;
+    }
+    intptr_t line = -1;
+    intptr_t column = -1;
+    script.GetTokenLocation(positions[i], &line, &column);
+    if (line <= 0) {
+      continue;
+    }
+    const intptr_t last = lines_.length() - 1;
+    if ((last >= 0) && (lines_[last] == line) &&
+        (strcmp(files_[last], file) == 0)) {
+      continue;
+    }
+    pc_offsets_.Add(pc_offsets[i]);
+    files_.Add(file);
+    lines_.Add(line);
+  }
+}
+
 static const Code::Comments& CreateCommentsFrom(
     compiler::Assembler* assembler) {
   const auto& comments = assembler->comments();
@@ -14875,6 +15302,8 @@ RawCode* Code::FinalizeCode(FlowGraphCompiler* compiler,
     code.SetActiveInstructions(instrs);
     code.set_instructions(instrs);
     code.set_is_alive(true);
+    NOT_IN_PRECOMPILED(
+        Isolate::Current()->jit_pc_lookup_table()->Add(code.raw()));
 
     // Set object pool in Instructions object.
     if (pool_attachment == PoolAttachment::kAttachPool) {
@@ -14941,9 +15370,15 @@ void Code::NotifyCodeObservers(const char* name,
   if (CodeObservers::AreActive()) {
     const auto& instrs = Instructions::Handle(code.instructions());
     CodeCommentsWrapper comments_wrapper(code.comments());
+    CodeLineInfoWrapper lines_wrapper;
+    const bool want_lines = CodeObservers::WantLineInfo();
+    if (want_lines) {
+      lines_wrapper.Collect(code);
+    }
     CodeObservers::NotifyAll(name, instrs.PayloadStart(),
                              code.GetPrologueOffset(), instrs.Size(), optimized,
-                             &comments_wrapper);
+                             &comments_wrapper,
+                             want_lines ? &lines_wrapper : nullptr);
   }
 #endif
 }
@@ -14959,6 +15394,13 @@ RawCode* Code::LookupCodeInIsolate(Isolate* isolate, uword pc) {
   if (isolate->heap() == NULL) {
     return Code::null();
   }
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  RawCode* code = isolate->jit_pc_lookup_table()->Lookup(pc);
+  if (code != Code::null()) {
+    return code;
+  }
+#endif
+  // Not indexed, e.g. it is not JIT compiled code.
   HeapIterationScope heap_iteration_scope(Thread::Current());
   SlowFindRawCodeVisitor visitor(pc);
   RawObject* needle = isolate->heap()->FindOldObject(&visitor);
@@ -15642,6 +16084,17 @@ void MegamorphicCache::set_arguments_descriptor(const Array& value) const {
   StorePointer(&raw_ptr()->args_descriptor_, value.raw());
 }
 
+intptr_t MegamorphicCache::dispatch_table_row() const {
+  ASSERT(dispatch_table() != Array::null());
+  return Smi::Value(raw_ptr()->dispatch_table_row_);
+}
+
+void MegamorphicCache::SetDispatchTableRow(const Array& table,
+                                           intptr_t row) const {
+  StorePointer(&raw_ptr()->dispatch_table_, table.raw());
+  StoreSmi(&raw_ptr()->dispatch_table_row_, Smi::New(row));
+}
+
 RawMegamorphicCache* MegamorphicCache::New() {
   MegamorphicCache& result = MegamorphicCache::Handle();
   {
@@ -15783,10 +16236,150 @@ void SubtypeTestCache::set_cache(const Array& value) const {
   StorePointer(&raw_ptr()->cache_, value.raw());
 }
 
+int64_t SubtypeTestCache::num_full_caches_ = 0;
+
+int64_t SubtypeTestCache::NumFullCaches() {
+  return AtomicOperations::LoadRelaxed(&num_full_caches_);
+}
+
+void SubtypeTestCache::IncrementNumFullCaches() {
+  AtomicOperations::IncrementInt64By(&num_full_caches_, 1);
+}
+
+static bool IsHashedSubtypeTestCache(const Array& data) {
+  // Linear caches only start with a sentinel while they are empty.
+  return (data.Length() > SubtypeTestCache::kTestEntryLength) &&
+         (data.At(SubtypeTestCache::kInstanceClassIdOrFunction) ==
+          Object::null());
+}
+
+RawObject** SubtypeTestCache::ProbeStart(RawObject** data,
+                                         intptr_t instance_cid) {
+  if ((data[kInstanceClassIdOrFunction] != Object::null()) ||
+      (data[kHashedMask] == Object::null())) {
+    return data;
+  }
+  const intptr_t mask = Smi::Value(Smi::RawCast(data[kHashedMask]));
+  return data + HashedProbeStart(instance_cid, mask) * kTestEntryLength;
+}
+
+bool SubtypeTestCache::IsHashed() const {
+  return IsHashedSubtypeTestCache(Array::Handle(cache()));
+}
+
 intptr_t SubtypeTestCache::NumberOfChecks() const {
   NoSafepointScope no_safepoint;
+  RawArray* data = cache();
+  if ((Smi::Value(data->ptr()->length_) > kTestEntryLength) &&
+      (data->ptr()->data()[kInstanceClassIdOrFunction] == Object::null())) {
+    return Smi::Value(
+        static_cast<RawSmi*>(data->ptr()->data()[kHashedNumChecks]));
+  }
   // Do not count the sentinel;
-  return (Smi::Value(cache()->ptr()->length_) / kTestEntryLength) - 1;
+  return (Smi::Value(data->ptr()->length_) / kTestEntryLength) - 1;
+}
+
+// Returns the index of the entry for the given check in a hashed cache, or
+// of the unused entry where it belongs. Like in the stubs, the probe starts
+// at the entry for the class id of the instance and goes on linearly up to an
+// unused entry, which always comes before the end of the table.
+static intptr_t FindHashedSubtypeCheck(
+    const Array& data,
+    const Object& instance_class_id_or_function,
+    const TypeArguments& instance_type_arguments,
+    const TypeArguments& instantiator_type_arguments,
+    const TypeArguments& function_type_arguments,
+    const TypeArguments& instance_parent_function_type_arguments,
+    const TypeArguments& instance_delayed_type_arguments) {
+  const intptr_t mask =
+      Smi::Value(Smi::RawCast(data.At(SubtypeTestCache::kHashedMask)));
+  intptr_t instance_cid;
+  if (instance_class_id_or_function.IsSmi()) {
+    instance_cid = Smi::Cast(instance_class_id_or_function).Value();
+  } else {
+    instance_cid = kClosureCid;
+  }
+  SubtypeTestCacheTable entries(data);
+  for (intptr_t index = SubtypeTestCache::HashedProbeStart(instance_cid, mask);
+       ; index++) {
+    ASSERT(index < entries.Length());
+    auto entry = entries[index];
+    RawObject* key =
+        entry.Get<SubtypeTestCache::kInstanceClassIdOrFunction>();
+    if ((key == Object::null()) ||
+        ((key == instance_class_id_or_function.raw()) &&
+         (entry.Get<SubtypeTestCache::kInstanceTypeArguments>() ==
+          instance_type_arguments.raw()) &&
+         (entry.Get<SubtypeTestCache::kInstantiatorTypeArguments>() ==
+          instantiator_type_arguments.raw()) &&
+         (entry.Get<SubtypeTestCache::kFunctionTypeArguments>() ==
+          function_type_arguments.raw()) &&
+         (entry.Get<SubtypeTestCache::kInstanceParentFunctionTypeArguments>() ==
+          instance_parent_function_type_arguments.raw()) &&
+         (entry.Get<
+              SubtypeTestCache::kInstanceDelayedFunctionTypeArguments>() ==
+          instance_delayed_type_arguments.raw()))) {
+      return index;
+    }
+  }
+}
+
+// Copies the checks of 'old_data', a linear or hashed cache, into a new
+// hashed cache which stays at most half full with 'num_checks' checks.
+static RawArray* RehashSubtypeTestCache(const Array& old_data,
+                                        intptr_t num_checks) {
+  const intptr_t capacity = Utils::RoundUpToPowerOfTwo(4 * num_checks);
+  // A run of used entries starts at most at the last of the 'capacity'
+  // probe starts and holds at most 'capacity / 2' checks.
+  const intptr_t length = 1 + capacity + capacity / 2;
+  const Array& data = Array::Handle(
+      Array::New(length * SubtypeTestCache::kTestEntryLength, Heap::kOld));
+  data.SetAt(SubtypeTestCache::kHashedMask,
+             Smi::Handle(Smi::New(capacity - 1)));
+  data.SetAt(SubtypeTestCache::kHashedNumChecks, Smi::Handle(Smi::New(0)));
+  const bool is_hashed = IsHashedSubtypeTestCache(old_data);
+  SubtypeTestCacheTable old_entries(old_data);
+  SubtypeTestCacheTable entries(data);
+  Object& instance_class_id_or_function = Object::Handle();
+  TypeArguments& instance_type_arguments = TypeArguments::Handle();
+  TypeArguments& instantiator_type_arguments = TypeArguments::Handle();
+  TypeArguments& function_type_arguments = TypeArguments::Handle();
+  TypeArguments& instance_parent_function_type_arguments =
+      TypeArguments::Handle();
+  TypeArguments& instance_delayed_type_arguments = TypeArguments::Handle();
+  Object& value = Object::Handle();
+  intptr_t used = 0;
+  for (intptr_t i = is_hashed ? 1 : 0; i < old_entries.Length(); i++) {
+    auto old_entry = old_entries[i];
+    instance_class_id_or_function =
+        old_entry.Get<SubtypeTestCache::kInstanceClassIdOrFunction>();
+    if (instance_class_id_or_function.IsNull()) {
+      if (!is_hashed) break;  // The sentinel of a linear cache.
+      continue;
+    }
+    instance_type_arguments =
+        old_entry.Get<SubtypeTestCache::kInstanceTypeArguments>();
+    instantiator_type_arguments =
+        old_entry.Get<SubtypeTestCache::kInstantiatorTypeArguments>();
+    function_type_arguments =
+        old_entry.Get<SubtypeTestCache::kFunctionTypeArguments>();
+    instance_parent_function_type_arguments =
+        old_entry.Get<SubtypeTestCache::kInstanceParentFunctionTypeArguments>();
+    instance_delayed_type_arguments = old_entry.Get<
+        SubtypeTestCache::kInstanceDelayedFunctionTypeArguments>();
+    const intptr_t index = FindHashedSubtypeCheck(
+        data, instance_class_id_or_function, instance_type_arguments,
+        instantiator_type_arguments, function_type_arguments,
+        instance_parent_function_type_arguments,
+        instance_delayed_type_arguments);
+    for (intptr_t j = 0; j < SubtypeTestCache::kTestEntryLength; j++) {
+      value = old_data.At(i * SubtypeTestCache::kTestEntryLength + j);
+      data.SetAt(index * SubtypeTestCache::kTestEntryLength + j, value);
+    }
+    used++;
+  }
+  data.SetAt(SubtypeTestCache::kHashedNumChecks, Smi::Handle(Smi::New(used)));
+  return data.raw();
 }
 
 void SubtypeTestCache::AddCheck(
@@ -15797,8 +16390,38 @@ void SubtypeTestCache::AddCheck(
     const TypeArguments& instance_parent_function_type_arguments,
     const TypeArguments& instance_delayed_type_arguments,
     const Bool& test_result) const {
+  ASSERT(!instance_class_id_or_function.IsNull());
   intptr_t old_num = NumberOfChecks();
   Array& data = Array::Handle(cache());
+  const bool is_hashed = IsHashedSubtypeTestCache(data);
+  if (is_hashed || (old_num >= kMaxLinearChecks)) {
+    if (!is_hashed ||
+        (2 * (old_num + 1) >
+         Smi::Value(Smi::RawCast(data.At(kHashedMask))) + 1)) {
+      // Keep the load factor at most 1/2, so probes stay short.
+      data = RehashSubtypeTestCache(data, old_num + 1);
+      set_cache(data);
+    }
+    const intptr_t index = FindHashedSubtypeCheck(
+        data, instance_class_id_or_function, instance_type_arguments,
+        instantiator_type_arguments, function_type_arguments,
+        instance_parent_function_type_arguments,
+        instance_delayed_type_arguments);
+    SubtypeTestCacheTable entries(data);
+    auto entry = entries[index];
+    ASSERT(entry.Get<kInstanceClassIdOrFunction>() == Object::null());
+    entry.Set<kInstanceClassIdOrFunction>(instance_class_id_or_function);
+    entry.Set<kInstanceTypeArguments>(instance_type_arguments);
+    entry.Set<kInstantiatorTypeArguments>(instantiator_type_arguments);
+    entry.Set<kFunctionTypeArguments>(function_type_arguments);
+    entry.Set<kInstanceParentFunctionTypeArguments>(
+        instance_parent_function_type_arguments);
+    entry.Set<kInstanceDelayedFunctionTypeArguments>(
+        instance_delayed_type_arguments);
+    entry.Set<kTestResult>(test_result);
+    data.SetAt(kHashedNumChecks, Smi::Handle(Smi::New(old_num + 1)));
+    return;
+  }
   intptr_t new_len = data.Length() + kTestEntryLength;
   data = Array::Grow(data, new_len);
   set_cache(data);
@@ -15827,6 +16450,18 @@ void SubtypeTestCache::GetCheck(
     Bool* test_result) const {
   Array& data = Array::Handle(cache());
   SubtypeTestCacheTable entries(data);
+  if (IsHashedSubtypeTestCache(data)) {
+    // Find the ix-th used entry.
+    ASSERT(ix < NumberOfChecks());
+    intptr_t index = 1;
+    for (;; index++) {
+      if (entries[index].Get<kInstanceClassIdOrFunction>() != Object::null()) {
+        if (ix == 0) break;
+        ix--;
+      }
+    }
+    ix = index;
+  }
   auto entry = entries[ix];
   *instance_class_id_or_function = entry.Get<kInstanceClassIdOrFunction>();
   *instance_type_arguments = entry.Get<kInstanceTypeArguments>();
@@ -15839,6 +16474,53 @@ void SubtypeTestCache::GetCheck(
   *test_result ^= entry.Get<kTestResult>();
 }
 
+bool SubtypeTestCache::LookupCheck(
+    const Object& instance_class_id_or_function,
+    const TypeArguments& instance_type_arguments,
+    const TypeArguments& instantiator_type_arguments,
+    const TypeArguments& function_type_arguments,
+    const TypeArguments& instance_parent_function_type_arguments,
+    const TypeArguments& instance_delayed_type_arguments,
+    Bool* test_result) const {
+  const Array& data = Array::Handle(cache());
+  SubtypeTestCacheTable entries(data);
+  if (IsHashedSubtypeTestCache(data)) {
+    const intptr_t index = FindHashedSubtypeCheck(
+        data, instance_class_id_or_function, instance_type_arguments,
+        instantiator_type_arguments, function_type_arguments,
+        instance_parent_function_type_arguments,
+        instance_delayed_type_arguments);
+    auto entry = entries[index];
+    if (entry.Get<kInstanceClassIdOrFunction>() == Object::null()) {
+      return false;
+    }
+    *test_result ^= entry.Get<kTestResult>();
+    return true;
+  }
+  for (intptr_t i = 0; i < entries.Length(); i++) {
+    auto entry = entries[i];
+    if (entry.Get<kInstanceClassIdOrFunction>() == Object::null()) {
+      break;
+    }
+    if ((entry.Get<kInstanceClassIdOrFunction>() ==
+         instance_class_id_or_function.raw()) &&
+        (entry.Get<kInstanceTypeArguments>() ==
+         instance_type_arguments.raw()) &&
+        (entry.Get<kInstantiatorTypeArguments>() ==
+         instantiator_type_arguments.raw()) &&
+        (entry.Get<kFunctionTypeArguments>() ==
+         function_type_arguments.raw()) &&
+        (entry.Get<kInstanceParentFunctionTypeArguments>() ==
+         instance_parent_function_type_arguments.raw()) &&
+        (entry.Get<kInstanceDelayedFunctionTypeArguments>() ==
+         instance_delayed_type_arguments.raw())) {
+      *test_result ^= entry.Get<kTestResult>();
+      return true;
+    }
+  }
+  return false;
+}
+
 const char* SubtypeTestCache::ToCString() const {
   return "SubtypeTestCache";
 }
@@ -16356,6 +17038,13 @@ bool Instance::CanonicalizeEquals(const Instance& other) const {
   return true;
 }
 
+// Tests if the word at [offset] of an instance holds an unboxed field,
+// given the bitmap of unboxed fields of its class.
+static bool IsUnboxedFieldOffset(uint32_t unboxed_fields, intptr_t offset) {
+  const intptr_t index = offset / kWordSize;
+  return (index < kBitsPerInt32) && (((unboxed_fields >> index) & 1) != 0);
+}
+
 uint32_t Instance::CanonicalizeHash() const {
   if (IsNull()) {
     return 2011;
@@ -16365,9 +17054,17 @@ uint32_t Instance::CanonicalizeHash() const {
   ASSERT(instance_size != 0);
   uint32_t hash = instance_size / kWordSize;
   uword this_addr = reinterpret_cast<uword>(this->raw_ptr());
+  const uint32_t unboxed_fields =
+      Isolate::Current()->class_table()->UnboxedFieldsBitmapAt(GetClassId());
   Instance& member = Instance::Handle();
   for (intptr_t offset = Instance::NextFieldOffset(); offset < instance_size;
        offset += kWordSize) {
+    if (IsUnboxedFieldOffset(unboxed_fields, offset)) {
+      const uint64_t bits = *reinterpret_cast<uint64_t*>(this_addr + offset);
+      hash = CombineHashes(hash, static_cast<uint32_t>(bits));
+      hash = CombineHashes(hash, static_cast<uint32_t>(bits >> 32));
+      continue;
+    }
     member ^= *reinterpret_cast<RawObject**>(this_addr + offset);
     hash = CombineHashes(hash, member.CanonicalizeHash());
   }
@@ -16406,8 +17103,13 @@ bool Instance::CheckAndCanonicalizeFields(Thread* thread,
     Object& obj = Object::Handle(zone);
     const intptr_t instance_size = SizeFromClass();
     ASSERT(instance_size != 0);
+    const uint32_t unboxed_fields =
+        thread->isolate()->class_table()->UnboxedFieldsBitmapAt(GetClassId());
     for (intptr_t offset = Instance::NextFieldOffset(); offset < instance_size;
          offset += kWordSize) {
+      if (IsUnboxedFieldOffset(unboxed_fields, offset)) {
+        continue;
+      }
       obj = *this->FieldAddrAtOffset(offset);
       if (obj.IsInstance() && !obj.IsSmi() && !obj.IsCanonical()) {
         if (obj.IsNumber() || obj.IsString()) {
@@ -16451,8 +17153,15 @@ RawInstance* Instance::CheckAndCanonicalize(Thread* thread,
   Isolate* isolate = thread->isolate();
   Instance& result = Instance::Handle(zone);
   const Class& cls = Class::Handle(zone, this->clazz());
+  // Most constants are already canonical, so look them up without the mutex
+  // first (see type_table.h).
+  result = cls.LookupCanonicalInstance(zone, *this);
+  if (!result.IsNull()) {
+    return result.raw();
+  }
   {
     SafepointMutexLocker ml(isolate->constant_canonicalization_mutex());
+    // Retry lookup.
     result = cls.LookupCanonicalInstance(zone, *this);
     if (!result.IsNull()) {
       return result.raw();
@@ -17849,10 +18558,11 @@ RawAbstractType* Type::Canonicalize(TrailPtr trail) const {
   AbstractType& type = Type::Handle(zone);
   ObjectStore* object_store = isolate->object_store();
   {
-    SafepointMutexLocker ml(isolate->type_canonicalization_mutex());
+    // Look up without the mutex (see type_table.h). A type inserted
+    // meanwhile is found by the lookup under the mutex below.
     CanonicalTypeSet table(zone, object_store->canonical_types());
     type ^= table.GetOrNull(CanonicalTypeKey(*this));
-    ASSERT(object_store->canonical_types() == table.Release().raw());
+    table.Release();
   }
   if (type.IsNull()) {
     // The type was not found in the table. It is not canonical yet.
@@ -19047,6 +19757,8 @@ class StringHasher : ValueObject {
   StringHasher() : hash_(0) {}
   void Add(int32_t ch) { hash_ = CombineHashes(hash_, ch); }
   void Add(const String& str, intptr_t begin_index, intptr_t len);
+  void AddLatin1(const uint8_t* chars, intptr_t len);
+  void AddUTF16(const uint16_t* chars, intptr_t len);
 
   // Return a non-zero hash of at most 'bits' bits.
   intptr_t Finalize(int bits) {
@@ -19067,17 +19779,42 @@ void StringHasher::Add(const String& str, intptr_t begin_index, intptr_t len) {
   if (len == 0) {
     return;
   }
-  if (str.IsOneByteString()) {
-    NoSafepointScope no_safepoint;
-    uint8_t* str_addr = OneByteString::CharAddr(str, begin_index);
-    for (intptr_t i = 0; i < len; i++) {
-      Add(*str_addr);
-      str_addr++;
-    }
-  } else {
-    String::CodePointIterator it(str, begin_index, len);
-    while (it.Next()) {
-      Add(it.Current());
+  NoSafepointScope no_safepoint;
+  switch (str.GetClassId()) {
+    case kOneByteStringCid:
+      AddLatin1(OneByteString::CharAddr(str, begin_index), len);
+      break;
+    case kExternalOneByteStringCid:
+      AddLatin1(ExternalOneByteString::CharAddr(str, begin_index), len);
+      break;
+    case kTwoByteStringCid:
+      AddUTF16(TwoByteString::CharAddr(str, begin_index), len);
+      break;
+    case kExternalTwoByteStringCid:
+      AddUTF16(ExternalTwoByteString::CharAddr(str, begin_index), len);
+      break;
+    default:
+      UNREACHABLE();
+  }
+}
+
+void StringHasher::AddLatin1(const uint8_t* chars, intptr_t len) {
+  for (intptr_t i = 0; i < len; i++) {
+    Add(chars[i]);
+  }
+}
+
+void StringHasher::AddUTF16(const uint16_t* chars, intptr_t len) {
+  // Hashes code points like String::CodePointIterator, without going
+  // through String::CharAt for every code unit.
+  for (intptr_t i = 0; i < len; i++) {
+    const int32_t ch = chars[i];
+    if (Utf16::IsLeadSurrogate(ch) && (i + 1 < len) &&
+        Utf16::IsTrailSurrogate(chars[i + 1])) {
+      Add(Utf16::Decode(ch, chars[i + 1]));
+      i++;
+    } else {
+      Add(ch);
     }
   }
 }
@@ -19336,6 +20073,131 @@ bool String::StartsWith(const String& other) const {
   return true;
 }
 
+// Returns the index of the first 'code_unit' in [from, to), or -1.
+static intptr_t FindCodeUnit(const uint8_t* chars,
+                             intptr_t from,
+                             intptr_t to,
+                             uint16_t code_unit) {
+  if ((code_unit > 0xFF) || (from >= to)) {
+    return -1;
+  }
+  const void* found = memchr(chars + from, code_unit, to - from);
+  return (found == NULL) ? -1 : static_cast<const uint8_t*>(found) - chars;
+}
+
+static intptr_t FindCodeUnit(const uint16_t* chars,
+                             intptr_t from,
+                             intptr_t to,
+                             uint16_t code_unit) {
+  // Compares a word of code units at a time. A code unit equal to
+  // 'code_unit' becomes a zero lane after the xor, and the lowest zero lane
+  // of a word is the lowest lane with its top bit set after the subtraction.
+  const intptr_t kUnitsPerWord = kWordSize / sizeof(uint16_t);
+  const uword kLaneOnes = kUwordMax / 0xFFFF;
+  const uword kLaneTops = kLaneOnes << 15;
+  const uword pattern = kLaneOnes * code_unit;
+  intptr_t i = from;
+  for (; i + kUnitsPerWord <= to; i += kUnitsPerWord) {
+    const uword word = ReadUnaligned(reinterpret_cast<const uword*>(chars + i));
+    const uword diff = word ^ pattern;
+    if (((diff - kLaneOnes) & ~diff & kLaneTops) != 0) {
+      break;
+    }
+  }
+  for (; i < to; i++) {
+    if (chars[i] == code_unit) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+template <typename S, typename P>
+static intptr_t IndexOfImpl(const S* chars,
+                            intptr_t length,
+                            const P* pattern,
+                            intptr_t pattern_length,
+                            intptr_t start) {
+  // Candidates are found by searching for the first code unit of the
+  // pattern, which skips over most of the string a word at a time.
+  const intptr_t last = length - pattern_length;
+  intptr_t i = start;
+  while (i <= last) {
+    i = FindCodeUnit(chars, i, last + 1, pattern[0]);
+    if (i < 0) {
+      return -1;
+    }
+    intptr_t j = 1;
+    while ((j < pattern_length) && (chars[i + j] == pattern[j])) {
+      j++;
+    }
+    if (j == pattern_length) {
+      return i;
+    }
+    i++;
+  }
+  return -1;
+}
+
+template <typename PatternType>
+intptr_t String::IndexOf(const String& str,
+                         const PatternType* pattern,
+                         intptr_t pattern_length,
+                         intptr_t start) {
+  const intptr_t length = str.Length();
+  switch (str.GetClassId()) {
+    case kOneByteStringCid:
+      return IndexOfImpl(OneByteString::DataStart(str), length, pattern,
+                         pattern_length, start);
+    case kTwoByteStringCid:
+      return IndexOfImpl(TwoByteString::DataStart(str), length, pattern,
+                         pattern_length, start);
+    case kExternalOneByteStringCid:
+      return IndexOfImpl(ExternalOneByteString::DataStart(str), length,
+                         pattern, pattern_length, start);
+    case kExternalTwoByteStringCid:
+      return IndexOfImpl(ExternalTwoByteString::DataStart(str), length,
+                         pattern, pattern_length, start);
+  }
+  UNREACHABLE();
+  return -1;
+}
+
+intptr_t String::IndexOf(const String& str,
+                         uint16_t code_unit,
+                         intptr_t start) {
+  ASSERT((start >= 0) && (start <= str.Length()));
+  NoSafepointScope no_safepoint;
+  return IndexOf(str, &code_unit, 1, start);
+}
+
+intptr_t String::IndexOf(const String& str,
+                         const String& pattern,
+                         intptr_t start) {
+  ASSERT((start >= 0) && (start <= str.Length()));
+  const intptr_t pattern_length = pattern.Length();
+  if (pattern_length == 0) {
+    return start;
+  }
+  NoSafepointScope no_safepoint;
+  switch (pattern.GetClassId()) {
+    case kOneByteStringCid:
+      return IndexOf(str, OneByteString::DataStart(pattern), pattern_length,
+                     start);
+    case kTwoByteStringCid:
+      return IndexOf(str, TwoByteString::DataStart(pattern), pattern_length,
+                     start);
+    case kExternalOneByteStringCid:
+      return IndexOf(str, ExternalOneByteString::DataStart(pattern),
+                     pattern_length, start);
+    case kExternalTwoByteStringCid:
+      return IndexOf(str, ExternalTwoByteString::DataStart(pattern),
+                     pattern_length, start);
+  }
+  UNREACHABLE();
+  return -1;
+}
+
 bool String::EndsWith(const String& other) const {
   if (other.IsNull()) {
     return false;
@@ -19406,6 +20268,107 @@ RawString* String::FromUTF8(const uint8_t* utf8_array,
   return strobj.raw();
 }
 
+RawString* String::FromUTF8(const TypedDataBase& utf8_data,
+                            intptr_t start,
+                            intptr_t end,
+                            Heap::Space space) {
+  ASSERT((0 <= start) && (start <= end) && (end <= utf8_data.LengthInBytes()));
+  const intptr_t array_len = end - start;
+  Utf8::Type type;
+  intptr_t len;
+  {
+    NoSafepointScope no_safepoint;
+    const uint8_t* utf8_array =
+        reinterpret_cast<const uint8_t*>(utf8_data.DataAddr(0)) + start;
+    ASSERT(Utf8::IsValid(utf8_array, array_len));
+    len = Utf8::CodeUnitCount(utf8_array, array_len, &type);
+  }
+  if (len == 0) {
+    return Symbols::Empty().raw();
+  }
+  if (type == Utf8::kLatin1) {
+    const String& strobj = String::Handle(OneByteString::New(len, space));
+    NoSafepointScope no_safepoint;
+    const uint8_t* utf8_array =
+        reinterpret_cast<const uint8_t*>(utf8_data.DataAddr(0)) + start;
+    Utf8::DecodeToLatin1(utf8_array, array_len,
+                         OneByteString::DataStart(strobj), len);
+    return strobj.raw();
+  }
+  ASSERT((type == Utf8::kBMP) || (type == Utf8::kSupplementary));
+  const String& strobj = String::Handle(TwoByteString::New(len, space));
+  NoSafepointScope no_safepoint;
+  const uint8_t* utf8_array =
+      reinterpret_cast<const uint8_t*>(utf8_data.DataAddr(0)) + start;
+  Utf8::DecodeToUTF16(utf8_array, array_len, TwoByteString::DataStart(strobj),
+                      len);
+  return strobj.raw();
+}
+
+RawString* String::EncodeBase64(const TypedDataBase& data,
+                                intptr_t start,
+                                intptr_t end,
+                                bool url_safe,
+                                Heap::Space space) {
+  ASSERT(data.ElementSizeInBytes() == 1);
+  ASSERT((0 <= start) && (start <= end) && (end <= data.LengthInBytes()));
+  const intptr_t len = Base64EncodedLength(end - start);
+  if (len == 0) {
+    return Symbols::Empty().raw();
+  }
+  if (len > OneByteString::kMaxElements) {
+    return String::null();
+  }
+  const String& result = String::Handle(OneByteString::New(len, space));
+  NoSafepointScope no_safepoint;
+  const uint8_t* bytes =
+      reinterpret_cast<const uint8_t*>(data.DataAddr(0)) + start;
+  ::dart::EncodeBase64(bytes, end - start, url_safe,
+                       OneByteString::DataStart(result));
+  return result.raw();
+}
+
+RawTypedData* String::DecodeBase64(const String& str,
+                                   intptr_t start,
+                                   intptr_t end,
+                                   Heap::Space space) {
+  ASSERT((0 <= start) && (start <= end) && (end <= str.Length()));
+  if (!str.IsOneByteString() && !str.IsExternalOneByteString()) {
+    return TypedData::null();
+  }
+  intptr_t len;
+  {
+    NoSafepointScope no_safepoint;
+    const uint8_t* chars = str.IsOneByteString()
+                               ? OneByteString::DataStart(str)
+                               : ExternalOneByteString::DataStart(str);
+    len = Base64DecodedLength(chars + start, end - start);
+  }
+  if (len < 0) {
+    return TypedData::null();
+  }
+  const TypedData& result = TypedData::Handle(
+      TypedData::New(kTypedDataUint8ArrayCid, len, space));
+  NoSafepointScope no_safepoint;
+  const uint8_t* chars = str.IsOneByteString()
+                             ? OneByteString::DataStart(str)
+                             : ExternalOneByteString::DataStart(str);
+  if (!DecodeBase64Padded(chars + start, end - start,
+                          reinterpret_cast<uint8_t*>(result.DataAddr(0)))) {
+    return TypedData::null();
+  }
+  return result.raw();
+}
+
+void String::ToLatin1(const String& str, uint8_t* latin1_array) {
+  ASSERT(str.IsOneByteString() || str.IsExternalOneByteString());
+  NoSafepointScope no_safepoint;
+  const uint8_t* chars = str.IsOneByteString()
+                             ? OneByteString::DataStart(str)
+                             : ExternalOneByteString::DataStart(str);
+  memmove(latin1_array, chars, str.Length());
+}
+
 RawString* String::FromLatin1(const uint8_t* latin1_array,
                               intptr_t array_len,
                               Heap::Space space) {
@@ -21486,6 +22449,80 @@ const char* SendPort::ToCString() const {
   return "SendPort";
 }
 
+TransferableTypedDataPeer::TransferableTypedDataPeer(uint8_t* data,
+                                                     intptr_t length)
+    : chunks_(&single_chunk_),
+      num_chunks_(1),
+      length_(length),
+      handle_(nullptr) {
+  single_chunk_.data = data;
+  single_chunk_.length = length;
+}
+
+TransferableTypedDataPeer::TransferableTypedDataPeer(
+    uint8_t* const* chunks,
+    const intptr_t* chunk_lengths,
+    intptr_t num_chunks)
+    : chunks_(&single_chunk_),
+      num_chunks_(num_chunks),
+      length_(0),
+      handle_(nullptr) {
+  ASSERT(num_chunks > 0);
+  if (num_chunks > 1) {
+    chunks_ = reinterpret_cast<Chunk*>(malloc(num_chunks * sizeof(Chunk)));
+    if (chunks_ == nullptr) {
+      OUT_OF_MEMORY();
+    }
+  }
+  for (intptr_t i = 0; i < num_chunks; i++) {
+    chunks_[i].data = chunks[i];
+    chunks_[i].length = chunk_lengths[i];
+    length_ += chunk_lengths[i];
+  }
+}
+
+TransferableTypedDataPeer::~TransferableTypedDataPeer() {
+  if (chunks_ != nullptr) {
+    for (intptr_t i = 0; i < num_chunks_; i++) {
+      free(chunks_[i].data);
+    }
+  }
+  ClearData();
+}
+
+bool TransferableTypedDataPeer::TakeContiguousData(uint8_t** data) {
+  ASSERT(HasData());
+  if (num_chunks_ == 1) {
+    *data = chunks_[0].data;
+  } else {
+    // Only materialization needs the content in one piece, so scattered
+    // content is not concatenated before the receiver asks for it.
+    uint8_t* result = reinterpret_cast<uint8_t*>(malloc(length_));
+    if ((result == nullptr) && (length_ != 0)) {
+      return false;
+    }
+    intptr_t offset = 0;
+    for (intptr_t i = 0; i < num_chunks_; i++) {
+      memmove(result + offset, chunks_[i].data, chunks_[i].length);
+      offset += chunks_[i].length;
+      free(chunks_[i].data);
+    }
+    *data = result;
+  }
+  ClearData();
+  return true;
+}
+
+void TransferableTypedDataPeer::ClearData() {
+  if (chunks_ != &single_chunk_) {
+    free(chunks_);
+  }
+  chunks_ = nullptr;
+  num_chunks_ = 0;
+  length_ = 0;
+  handle_ = nullptr;
+}
+
 static void TransferableTypedDataFinalizer(void* isolate_callback_data,
                                            Dart_WeakPersistentHandle handle,
                                            void* peer) {
@@ -21495,8 +22532,12 @@ static void TransferableTypedDataFinalizer(void* isolate_callback_data,
 RawTransferableTypedData* TransferableTypedData::New(uint8_t* data,
                                                      intptr_t length,
                                                      Heap::Space space) {
-  TransferableTypedDataPeer* peer = new TransferableTypedDataPeer(data, length);
+  return New(new TransferableTypedDataPeer(data, length), space);
+}
 
+RawTransferableTypedData* TransferableTypedData::New(
+    TransferableTypedDataPeer* peer,
+    Heap::Space space) {
   Thread* thread = Thread::Current();
   TransferableTypedData& result = TransferableTypedData::Handle();
   {
@@ -21511,7 +22552,7 @@ RawTransferableTypedData* TransferableTypedData::New(uint8_t* data,
   // garbage-collected.
   peer->set_handle(FinalizablePersistentHandle::New(
       thread->isolate(), result, peer, &TransferableTypedDataFinalizer,
-      length));
+      peer->length()));
 
   return result.raw();
 }
@@ -21894,9 +22935,17 @@ const char* StackTrace::ToDwarfCString(const StackTrace& stack_trace_in) {
         if (NativeSymbolResolver::LookupSharedObject(call_addr, &dso_base,
                                                      &dso_name)) {
           uword dso_offset = call_addr - dso_base;
-          buffer.Printf("    #%02" Pd " pc %" Pp "  %s\n", frame_index,
+          buffer.Printf("    #%02" Pd " pc %" Pp "  %s", frame_index,
                         dso_offset, dso_name);
           NativeSymbolResolver::FreeSymbolName(dso_name);
+          // Identifies the snapshot for symbolization with its DWARF
+          // information, e.g. by runtime/tools/dwarf_symbolize.py.
+          char* build_id = NativeSymbolResolver::LookupBuildId(call_addr);
+          if (build_id != NULL) {
+            buffer.Printf(" (BuildId: %s)", build_id);
+            NativeSymbolResolver::FreeSymbolName(build_id);
+          }
+          buffer.AddString("\n");
         } else {
           buffer.Printf("    #%02" Pd " pc %" Pp "  <unknown>\n", frame_index,
                         call_addr);
@@ -21928,6 +22977,10 @@ void RegExp::set_pattern(const String& pattern) const {
   StorePointer(&raw_ptr()->pattern_, pattern.raw());
 }
 
+void RegExp::set_literal_prefix(const String& prefix) const {
+  StorePointer(&raw_ptr()->literal_prefix_, prefix.raw());
+}
+
 void RegExp::set_function(intptr_t cid,
                           bool sticky,
                           const Function& value) const {
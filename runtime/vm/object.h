@@ -836,6 +836,17 @@ class Class : public Object {
     StoreNonPointer(&raw_ptr()->next_field_offset_in_words_, value);
   }
 
+  // Bit i is set if word i of the instances holds an unboxed field.
+  uint32_t unboxed_fields_bitmap() const {
+    return raw_ptr()->unboxed_fields_bitmap_;
+  }
+  static uint32_t unboxed_fields_bitmap(RawClass* clazz) {
+    return clazz->ptr()->unboxed_fields_bitmap_;
+  }
+  void set_unboxed_fields_bitmap(uint32_t value) const {
+    StoreNonPointer(&raw_ptr()->unboxed_fields_bitmap_, value);
+  }
+
   cpp_vtable handle_vtable() const { return raw_ptr()->handle_vtable_; }
   void set_handle_vtable(cpp_vtable value) const {
     StoreNonPointer(&raw_ptr()->handle_vtable_, value);
@@ -1340,11 +1351,19 @@ class Class : public Object {
   // Allocate the raw Pointer classes.
   static RawClass* NewPointerClass(intptr_t class_id);
 
-  // Register code that has used CHA for optimization.
-  // TODO(srdjan): Also register kind of CHA optimization (e.g.: leaf class,
-  // leaf method, ...).
+  // Register code that has used CHA for optimization. The code relies on
+  // this class getting no new subclasses, or only on none of them overriding
+  // 'selector' if it is not null.
   void RegisterCHACode(const Code& code);
+  void RegisterCHACode(const Code& code, const String& selector);
+
+  // Whether this class declares a method, getter, setter or field that
+  // overrides 'selector'. All members of a name are treated alike, since
+  // the getter of a method's name tears off the method.
+  bool DeclaresSelector(const String& selector) const;
 
+  // Disables the code that relied on 'subclass' not being added, or all CHA
+  // optimized code if 'subclass' is null.
   void DisableCHAOptimizedCode(const Class& subclass);
 
   void DisableAllCHAOptimizedCode();
@@ -2121,6 +2140,14 @@ class Function : public Object {
   // Can only be called on FFI trampolines.
   void SetFfiCallbackTarget(const Function& target) const;
 
+  // Can only be called on FFI trampolines.
+  // True for Dart -> native calls which skip the transition out of generated
+  // code, see 'Pointer.asFunction(isLeaf: true)'.
+  bool FfiIsLeaf() const;
+
+  // Can only be called on FFI trampolines.
+  void SetFfiIsLeaf(bool value) const;
+
   // Return a new function with instantiated result and parameter types.
   RawFunction* InstantiateSignatureFrom(
       const TypeArguments& instantiator_type_arguments,
@@ -2934,10 +2961,17 @@ class Function : public Object {
   // Return false and report an error if the fingerprint does not match.
   bool CheckSourceFingerprint(const char* prefix, int32_t fp) const;
 
+  // Layout of 'ic_data_array': the edge counters, the coverage array (see
+  // GetCoverageArray), then the ICData objects sorted by deopt id.
+  static const intptr_t kEdgeCountersIndex = 0;
+  static const intptr_t kCoverageArrayIndex = 1;
+  static const intptr_t kFirstICDataIndex = 2;
+
   // Works with map [deopt-id] -> ICData.
   void SaveICDataMap(
       const ZoneGrowableArray<const ICData*>& deopt_id_to_ic_data,
-      const Array& edge_counters_array) const;
+      const Array& edge_counters_array,
+      const Array& coverage_array) const;
   // Uses 'ic_data_array' to populate the table 'deopt_id_to_ic_data'. Clone
   // ic_data (array and descriptor) if 'clone_ic_data' is true.
   void RestoreICDataMap(ZoneGrowableArray<const ICData*>* deopt_id_to_ic_data,
@@ -2947,6 +2981,10 @@ class Function : public Object {
   void ClearICDataArray() const;
   RawICData* FindICData(intptr_t deopt_id) const;
 
+  // Returns the array of [token position, reached] pairs that the function's
+  // code updates when compiled with --block_coverage, or null.
+  RawArray* GetCoverageArray() const;
+
   // Sets deopt reason in all ICData-s with given deopt_id.
   void SetDeoptReasonForAll(intptr_t deopt_id, ICData::DeoptReasonId reason);
 
@@ -3263,6 +3301,9 @@ class FfiTrampolineData : public Object {
   int32_t callback_id() const { return raw_ptr()->callback_id_; }
   void set_callback_id(int32_t value) const;
 
+  bool is_leaf() const { return raw_ptr()->is_leaf_; }
+  void set_is_leaf(bool value) const;
+
   static RawFfiTrampolineData* New();
 
   FINAL_HEAP_OBJECT_IMPLEMENTATION(FfiTrampolineData, Object);
@@ -3516,10 +3557,10 @@ class Field : public Object {
     // This assertion ensures that the cid seen by the background compiler is
     // consistent. So the assertion passes if the field is a clone. It also
     // passes if the field is static, because we don't use field guards on
-    // static fields.
+    // static fields, and in AOT, where field guards do not change anymore.
     Thread* thread = Thread::Current();
-    ASSERT(!IsOriginal() || is_static() || thread->IsMutatorThread() ||
-           thread->IsAtSafepoint());
+    ASSERT(!IsOriginal() || is_static() || FLAG_precompiled_mode ||
+           thread->IsMutatorThread() || thread->IsAtSafepoint());
 #endif
     return raw_ptr()->guarded_cid_;
   }
@@ -3570,6 +3611,14 @@ class Field : public Object {
     set_kind_bits(UnboxingCandidateBit::update(b, raw_ptr()->kind_bits_));
   }
 
+  // True if the value of this instance field is stored unboxed inside of the
+  // instance rather than as a pointer to a Double or Mint. Only set in AOT,
+  // see Class::CalculateFieldOffsets.
+  bool is_unboxed() const { return UnboxedBit::decode(raw_ptr()->kind_bits_); }
+  void set_is_unboxed(bool b) const {
+    set_kind_bits(UnboxedBit::update(b, raw_ptr()->kind_bits_));
+  }
+
   enum {
     kUnknownLengthOffset = -1,
     kUnknownFixedLength = -1,
@@ -3685,6 +3734,7 @@ class Field : public Object {
     kHasPragmaBit,
     kCovariantBit,
     kGenericCovariantImplBit,
+    kUnboxedBit,
   };
   class ConstBit : public BitField<uint16_t, bool, kConstBit, 1> {};
   class StaticBit : public BitField<uint16_t, bool, kStaticBit, 1> {};
@@ -3705,6 +3755,7 @@ class Field : public Object {
   class CovariantBit : public BitField<uint16_t, bool, kCovariantBit, 1> {};
   class GenericCovariantImplBit
       : public BitField<uint16_t, bool, kGenericCovariantImplBit, 1> {};
+  class UnboxedBit : public BitField<uint16_t, bool, kUnboxedBit, 1> {};
 
   // Update guarded cid and guarded length for this field. Returns true, if
   // deoptimization of dependent code is required.
@@ -4089,6 +4140,13 @@ class Library : public Object {
     StoreNonPointer(&raw_ptr()->native_entry_symbol_resolver_,
                     native_symbol_resolver);
   }
+  // Resolving the C functions of 'vm:ffi-native' natives.
+  Dart_FfiNativeResolver ffi_native_resolver() const {
+    return raw_ptr()->ffi_native_resolver_;
+  }
+  void set_ffi_native_resolver(Dart_FfiNativeResolver value) const {
+    StoreNonPointer(&raw_ptr()->ffi_native_resolver_, value);
+  }
 
   bool is_in_fullsnapshot() const { return raw_ptr()->is_in_fullsnapshot_; }
   void set_is_in_fullsnapshot(bool value) const {
@@ -5651,6 +5709,7 @@ class Code : public Object {
   friend class CodeSerializationCluster;
   friend class StubCode;               // for set_object_pool
   friend class MegamorphicCacheTable;  // for set_object_pool
+  friend class GlobalObjectPool;       // for set_object_pool
   friend class CodePatcher;     // for set_instructions
   friend class ProgramVisitor;  // for set_instructions
   // So that the RawFunction pointer visitor can determine whether code the
@@ -5968,6 +6027,13 @@ class MegamorphicCache : public Object {
   intptr_t filled_entry_count() const;
   void set_filled_entry_count(intptr_t num) const;
 
+  // In AOT, megamorphic calls to selectors which have a row in the global
+  // dispatch table look up their target in the table before probing
+  // [buckets] (see DispatchTableGenerator).
+  RawArray* dispatch_table() const { return raw_ptr()->dispatch_table_; }
+  intptr_t dispatch_table_row() const;
+  void SetDispatchTableRow(const Array& table, intptr_t row) const;
+
   static intptr_t buckets_offset() {
     return OFFSET_OF(RawMegamorphicCache, buckets_);
   }
@@ -5977,6 +6043,12 @@ class MegamorphicCache : public Object {
   static intptr_t arguments_descriptor_offset() {
     return OFFSET_OF(RawMegamorphicCache, args_descriptor_);
   }
+  static intptr_t dispatch_table_offset() {
+    return OFFSET_OF(RawMegamorphicCache, dispatch_table_);
+  }
+  static intptr_t dispatch_table_row_offset() {
+    return OFFSET_OF(RawMegamorphicCache, dispatch_table_row_);
+  }
 
   static RawMegamorphicCache* New(const String& target_name,
                                   const Array& arguments_descriptor);
@@ -6045,6 +6117,45 @@ class SubtypeTestCache : public Object {
                 TypeArguments* instance_delayed_type_arguments,
                 Bool* test_result) const;
 
+  // Returns whether the cache has an entry for the given check and, if so,
+  // sets 'test_result' to its result.
+  bool LookupCheck(const Object& instance_class_id_or_function,
+                   const TypeArguments& instance_type_arguments,
+                   const TypeArguments& instantiator_type_arguments,
+                   const TypeArguments& function_type_arguments,
+                   const TypeArguments& instance_parent_function_type_arguments,
+                   const TypeArguments& instance_delayed_type_arguments,
+                   Bool* test_result) const;
+
+  // Checks are kept in an array of entries ending with a sentinel entry,
+  // which the stubs and interpreters probe linearly. Past kMaxLinearChecks
+  // checks, the cache becomes an open addressing hash table, which they probe
+  // linearly from HashedProbeStart up to an unused entry. Its first entry
+  // has a null instance class id like an empty cache, and holds the number
+  // of checks and the mask of the hash in its kHashedNumChecks and
+  // kHashedMask slots. Unused entries have a null instance class id. The
+  // table is at most half full and has mask + 1 probe starts, followed by
+  // half as many entries again, so a probe never runs past its end.
+  static const intptr_t kMaxLinearChecks = 16;
+  static const intptr_t kHashedNumChecks = kInstanceTypeArguments;
+  static const intptr_t kHashedMask = kInstantiatorTypeArguments;
+  bool IsHashed() const;
+
+  // The index of the entry where a probe for a check starts in a hashed cache,
+  // from the class id of the instance (kClosureCid for closures).
+  static intptr_t HashedProbeStart(intptr_t instance_cid, intptr_t mask) {
+    return 1 + (instance_cid & mask);
+  }
+
+  // The first entry to probe for a check in the entries [data] of a cache,
+  // linear or hashed, for the interpreters.
+  static RawObject** ProbeStart(RawObject** data, intptr_t instance_cid);
+
+  // The number of caches that reached --max_subtype_cache_entries checks,
+  // after which no more checks are added to them.
+  static int64_t NumFullCaches();
+  static void IncrementNumFullCaches();
+
   static RawSubtypeTestCache* New();
 
   static intptr_t InstanceSize() {
@@ -6062,6 +6173,8 @@ class SubtypeTestCache : public Object {
 
   intptr_t TestEntryLength() const;
 
+  static int64_t num_full_caches_;
+
   FINAL_HEAP_OBJECT_IMPLEMENTATION(SubtypeTestCache, Object);
   friend class Class;
 };
@@ -6259,12 +6372,10 @@ class Instance : public Object {
   virtual bool CheckIsCanonical(Thread* thread) const;
 #endif  // DEBUG
 
-  RawObject* GetField(const Field& field) const { return *FieldAddr(field); }
+  // Fields stored unboxed are boxed again when read.
+  inline RawObject* GetField(const Field& field) const;
 
-  void SetField(const Field& field, const Object& value) const {
-    field.RecordStore(value);
-    StorePointer(FieldAddr(field), value.raw());
-  }
+  inline void SetField(const Field& field, const Object& value) const;
 
   RawAbstractType* GetType(Heap::Space space) const;
 
@@ -6596,9 +6707,42 @@ class TypeArguments : public Instance {
   // Return the number of cached instantiations for this type argument vector.
   intptr_t NumInstantiations() const;
 
+  // Instantiations are cached in an array of (instantiator type arguments,
+  // function type arguments, instantiated type arguments) entries ending
+  // with kNoInstantiator, which the InstantiateTypeArguments fast paths
+  // probe linearly. Past kMaxLinearInstantiations entries, the cache becomes
+  // an open addressing hash table, which they probe linearly from
+  // HashedInstantiationsProbeStart up to an unused entry. Its first entry
+  // starts with kNoInstantiator like an empty cache, and holds the number of
+  // used entries and the mask of the hash. Unused entries start with
+  // kNoInstantiator. The table is at most half full and has mask + 1 probe
+  // starts, followed by half as many entries again, so a probe never runs
+  // past its end.
+  static const intptr_t kMaxLinearInstantiations = 16;
+  static const intptr_t kHashedInstantiationsUsedIndex = 1;
+  static const intptr_t kHashedInstantiationsMaskIndex = 2;
+  static bool IsHashedInstantiations(const Array& instantiations);
+
+  // The index of the entry where a probe for the given instantiators starts
+  // in a hashed cache, from the hash_ fields of the instantiators (0 for
+  // null), as the fast paths read them.
+  static intptr_t HashedInstantiationsProbeStart(intptr_t instantiator_hash,
+                                                 intptr_t function_hash,
+                                                 intptr_t mask) {
+    return 1 + ((instantiator_hash ^ function_hash) & mask);
+  }
+
+  // The first word to probe for the given instantiators in the raw
+  // instantiations cache [instantiations], linear or hashed, for the
+  // interpreters.
+  static RawObject** InstantiationsProbeStart(RawArray* instantiations,
+                                              RawObject* instantiator_type_args,
+                                              RawObject* function_type_args);
+
   static intptr_t instantiations_offset() {
     return OFFSET_OF(RawTypeArguments, instantiations_);
   }
+  static intptr_t hash_offset() { return OFFSET_OF(RawTypeArguments, hash_); }
 
   static const intptr_t kBytesPerElement = kWordSize;
   static const intptr_t kMaxElements = kSmiMax / kBytesPerElement;
@@ -7404,6 +7548,10 @@ class Double : public Number {
  public:
   double value() const { return raw_ptr()->value_; }
 
+  static double GetDoubleValue(const RawDouble* obj) {
+    return obj->ptr()->value_;
+  }
+
   bool BitwiseEqualsToDouble(double value) const;
   virtual bool OperatorEquals(const Instance& other) const;
   virtual bool CanonicalizeEquals(const Instance& other) const;
@@ -7563,6 +7711,15 @@ class String : public Instance {
   bool StartsWith(const String& other) const;
   bool EndsWith(const String& other) const;
 
+  // Returns the index of the first occurrence of 'code_unit' or 'pattern' in
+  // 'str' at or after 'start', or -1 if there is none.
+  static intptr_t IndexOf(const String& str,
+                          uint16_t code_unit,
+                          intptr_t start);
+  static intptr_t IndexOf(const String& str,
+                          const String& pattern,
+                          intptr_t start);
+
   // Strings are canonicalized using the symbol table.
   virtual RawInstance* CheckAndCanonicalize(Thread* thread,
                                             const char** error_str) const;
@@ -7609,6 +7766,34 @@ class String : public Instance {
                              intptr_t array_len,
                              Heap::Space space = Heap::kNew);
 
+  // Creates a new String object from the valid UTF-8 encoded bytes
+  // [start, end) of 'utf8_data'. The bytes are looked up again after the
+  // string is allocated, so they may be in the Dart heap.
+  static RawString* FromUTF8(const TypedDataBase& utf8_data,
+                             intptr_t start,
+                             intptr_t end,
+                             Heap::Space space = Heap::kNew);
+
+  // Returns the padded base64 encoding of the bytes [start, end) of 'data',
+  // which has one-byte elements, or null if it would be too long.
+  static RawString* EncodeBase64(const TypedDataBase& data,
+                                 intptr_t start,
+                                 intptr_t end,
+                                 bool url_safe,
+                                 Heap::Space space = Heap::kNew);
+
+  // Returns a Uint8List of the bytes encoded by the characters [start, end)
+  // of 'str', or null unless 'str' is a one-byte string and the range is
+  // padded base64 (see DecodeBase64Padded).
+  static RawTypedData* DecodeBase64(const String& str,
+                                    intptr_t start,
+                                    intptr_t end,
+                                    Heap::Space space = Heap::kNew);
+
+  // Copies the code units of 'str', which must be a one-byte string, to
+  // 'latin1_array', which must have room for str.Length() elements.
+  static void ToLatin1(const String& str, uint8_t* latin1_array);
+
   // Creates a new String object from an array of Latin-1 encoded characters.
   static RawString* FromLatin1(const uint8_t* latin1_array,
                                intptr_t array_len,
@@ -7745,6 +7930,12 @@ class String : public Instance {
 
   void SetHash(intptr_t value) const { SetCachedHash(raw(), value); }
 
+  template <typename PatternType>
+  static intptr_t IndexOf(const String& str,
+                          const PatternType* pattern,
+                          intptr_t pattern_length,
+                          intptr_t start);
+
   template <typename HandleType, typename ElementType, typename CallbackType>
   static void ReadFromImpl(SnapshotReader* reader,
                            String* str_obj,
@@ -7906,6 +8097,8 @@ class OneByteString : public AllStatic {
   friend class String;
   friend class Symbols;
   friend class ExternalOneByteString;
+  friend class JSONWriter;
+  friend class RegExpEngine;
   friend class SnapshotReader;
   friend class StringHasher;
   friend class Utf8;
@@ -8029,7 +8222,9 @@ class TwoByteString : public AllStatic {
 
   friend class Class;
   friend class String;
+  friend class RegExpEngine;
   friend class SnapshotReader;
+  friend class StringHasher;
   friend class Symbols;
 };
 
@@ -8119,7 +8314,9 @@ class ExternalOneByteString : public AllStatic {
 
   friend class Class;
   friend class String;
+  friend class RegExpEngine;
   friend class SnapshotReader;
+  friend class StringHasher;
   friend class Symbols;
   friend class Utf8;
 };
@@ -8206,7 +8403,9 @@ class ExternalTwoByteString : public AllStatic {
 
   friend class Class;
   friend class String;
+  friend class RegExpEngine;
   friend class SnapshotReader;
+  friend class StringHasher;
   friend class Symbols;
 };
 
@@ -9148,6 +9347,10 @@ class LinkedHashMap : public Instance {
     return RoundedAllocationSize(sizeof(RawLinkedHashMap));
   }
 
+  // Keep this in sync with Dart implementation (lib/compact_hash.dart).
+  static const intptr_t kInitialIndexBits = 3;
+  static const intptr_t kInitialIndexSize = 1 << (kInitialIndexBits + 1);
+
   // Allocates a map with some default capacity, just like "new Map()".
   static RawLinkedHashMap* NewDefault(Heap::Space space = Heap::kNew);
   static RawLinkedHashMap* New(const Array& data,
@@ -9260,10 +9463,6 @@ class LinkedHashMap : public Instance {
  private:
   FINAL_HEAP_OBJECT_IMPLEMENTATION(LinkedHashMap, Instance);
 
-  // Keep this in sync with Dart implementation (lib/compact_hash.dart).
-  static const intptr_t kInitialIndexBits = 3;
-  static const intptr_t kInitialIndexSize = 1 << (kInitialIndexBits + 1);
-
   // Allocate a map, but leave all fields set to null.
   // Used during deserialization (since map might contain itself as key/value).
   static RawLinkedHashMap* NewUninitialized(Heap::Space space = Heap::kNew);
@@ -9403,25 +9602,48 @@ class SendPort : public Instance {
 class TransferableTypedDataPeer {
  public:
   // [data] backing store should be malloc'ed, not new'ed.
-  TransferableTypedDataPeer(uint8_t* data, intptr_t length)
-      : data_(data), length_(length), handle_(nullptr) {}
+  TransferableTypedDataPeer(uint8_t* data, intptr_t length);
 
-  ~TransferableTypedDataPeer() { free(data_); }
+  // Takes ownership of the [num_chunks] malloc'ed buffers in [chunks], whose
+  // concatenation is the content. The arrays themselves are not retained.
+  TransferableTypedDataPeer(uint8_t* const* chunks,
+                            const intptr_t* chunk_lengths,
+                            intptr_t num_chunks);
 
-  uint8_t* data() const { return data_; }
+  ~TransferableTypedDataPeer();
+
+  // Whether the content is still owned by this peer, i.e. it has not been
+  // transferred or materialized.
+  bool HasData() const { return chunks_ != nullptr; }
+
+  // Total length in bytes.
   intptr_t length() const { return length_; }
+
+  intptr_t num_chunks() const { return num_chunks_; }
+  uint8_t* chunk_data(intptr_t i) const { return chunks_[i].data; }
+  intptr_t chunk_length(intptr_t i) const { return chunks_[i].length; }
+
   FinalizablePersistentHandle* handle() const { return handle_; }
   void set_handle(FinalizablePersistentHandle* handle) { handle_ = handle; }
 
-  void ClearData() {
-    data_ = nullptr;
-    length_ = 0;
-    handle_ = nullptr;
-  }
+  // Passes ownership of the content to the caller as a single malloc'ed
+  // buffer, concatenating the chunks if there are several. Returns false and
+  // keeps the content if the buffer cannot be allocated.
+  bool TakeContiguousData(uint8_t** data);
+
+  void ClearData();
 
  private:
-  uint8_t* data_;
+  struct Chunk {
+    uint8_t* data;
+    intptr_t length;
+  };
+
+  // Points to [single_chunk_] unless there are several chunks.
+  Chunk* chunks_;
+  intptr_t num_chunks_;
   intptr_t length_;
+  Chunk single_chunk_;
   FinalizablePersistentHandle* handle_;
 
   DISALLOW_COPY_AND_ASSIGN(TransferableTypedDataPeer);
@@ -9433,6 +9655,10 @@ class TransferableTypedData : public Instance {
                                        intptr_t len,
                                        Heap::Space space = Heap::kNew);
 
+  // Takes ownership of [peer].
+  static RawTransferableTypedData* New(TransferableTypedDataPeer* peer,
+                                       Heap::Space space = Heap::kNew);
+
   static intptr_t InstanceSize() {
     return RoundedAllocationSize(sizeof(RawTransferableTypedData));
   }
@@ -9572,6 +9798,10 @@ class RegExp : public Instance {
     return raw_ptr()->num_bracket_expressions_;
   }
   RawArray* capture_name_map() const { return raw_ptr()->capture_name_map_; }
+  RawString* literal_prefix() const { return raw_ptr()->literal_prefix_; }
+  static intptr_t literal_prefix_offset() {
+    return OFFSET_OF(RawRegExp, literal_prefix_);
+  }
 
   RawTypedData* bytecode(bool is_one_byte, bool sticky) const {
     if (sticky) {
@@ -9629,6 +9859,7 @@ class RegExp : public Instance {
 
   void set_num_bracket_expressions(intptr_t value) const;
   void set_capture_name_map(const Array& array) const;
+  void set_literal_prefix(const String& prefix) const;
   void set_is_global() const {
     RegExpFlags f = flags();
     f.SetGlobal();
@@ -9877,6 +10108,31 @@ void Context::SetAt(intptr_t index, const Object& value) const {
   StorePointer(ObjectAddr(index), value.raw());
 }
 
+RawObject* Instance::GetField(const Field& field) const {
+  if (field.is_unboxed()) {
+    if (field.UnboxedFieldCid() == kDoubleCid) {
+      return Double::New(*reinterpret_cast<double*>(FieldAddr(field)));
+    }
+    return Integer::New(*reinterpret_cast<int64_t*>(FieldAddr(field)));
+  }
+  return *FieldAddr(field);
+}
+
+void Instance::SetField(const Field& field, const Object& value) const {
+  field.RecordStore(value);
+  if (field.is_unboxed()) {
+    if (field.UnboxedFieldCid() == kDoubleCid) {
+      StoreNonPointer(reinterpret_cast<double*>(FieldAddr(field)),
+                      Double::Cast(value).value());
+    } else {
+      StoreNonPointer(reinterpret_cast<int64_t*>(FieldAddr(field)),
+                      Integer::Cast(value).AsInt64Value());
+    }
+    return;
+  }
+  StorePointer(FieldAddr(field), value.raw());
+}
+
 intptr_t Instance::GetNativeField(int index) const {
   ASSERT(IsValidNativeIndex(index));
   NoSafepointScope no_safepoint;
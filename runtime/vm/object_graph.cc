@@ -490,7 +490,52 @@ intptr_t ObjectGraph::InboundReferences(Object* obj, const Array& references) {
   return visitor.length();
 }
 
-static void WritePtr(RawObject* raw, WriteStream* stream) {
+static uint8_t* SnapshotChunkAllocator(uint8_t* ptr,
+                                       intptr_t old_size,
+                                       intptr_t new_size) {
+  void* new_ptr = realloc(reinterpret_cast<void*>(ptr), new_size);
+  if (new_ptr == NULL) {
+    OUT_OF_MEMORY();
+  }
+  return reinterpret_cast<uint8_t*>(new_ptr);
+}
+
+// The buffer only grows past the chunk size by the last value written, which
+// takes at most kMaxUnsignedLength bytes.
+static const intptr_t kMaxUnsignedLength = 10;
+
+HeapSnapshotWriter::HeapSnapshotWriter(intptr_t chunk_size)
+    : buffer_(NULL),
+      stream_(&buffer_,
+              SnapshotChunkAllocator,
+              chunk_size + kMaxUnsignedLength),
+      chunk_size_(chunk_size),
+      chunk_index_(0),
+      node_count_(-1) {
+  ASSERT(chunk_size > 0);
+}
+
+HeapSnapshotWriter::~HeapSnapshotWriter() {
+  free(buffer_);
+}
+
+void HeapSnapshotWriter::Finish(intptr_t node_count) {
+  node_count_ = node_count;
+  Flush(true);
+}
+
+void HeapSnapshotWriter::Flush(bool is_last) {
+  uint8_t* buffer = stream_.buffer();
+  const intptr_t size = stream_.bytes_written();
+  const intptr_t chunk_size = is_last ? size : chunk_size_;
+  WriteChunk(buffer, chunk_size, chunk_index_++, is_last);
+  // Readers expect all chunks but the last to be full, so the rest of the
+  // last value written starts the next chunk.
+  memmove(buffer, buffer + chunk_size, size - chunk_size);
+  stream_.SetPosition(size - chunk_size);
+}
+
+static void WritePtr(RawObject* raw, HeapSnapshotWriter* writer) {
   ASSERT(raw->IsHeapObject());
   ASSERT(raw->IsOldObject());
   uword addr = RawObject::ToAddr(raw);
@@ -498,16 +543,16 @@ static void WritePtr(RawObject* raw, WriteStream* stream) {
   // Using units of kObjectAlignment makes the ids fit into Smis when parsed
   // in the Dart code of the Observatory.
   // TODO(koda): Use delta-encoding/back-references to further compress this.
-  stream->WriteUnsigned(addr / kObjectAlignment);
+  writer->WriteUnsigned(addr / kObjectAlignment);
 }
 
 class WritePointerVisitor : public ObjectPointerVisitor {
  public:
   WritePointerVisitor(Isolate* isolate,
-                      WriteStream* stream,
+                      HeapSnapshotWriter* writer,
                       bool only_instances)
       : ObjectPointerVisitor(isolate),
-        stream_(stream),
+        writer_(writer),
         only_instances_(only_instances),
         count_(0) {}
   virtual void VisitPointers(RawObject** first, RawObject** last) {
@@ -522,7 +567,7 @@ class WritePointerVisitor : public ObjectPointerVisitor {
       if (only_instances_ && !IsUserClass(object->GetClassId())) {
         continue;
       }
-      WritePtr(object, stream_);
+      WritePtr(object, writer_);
       ++count_;
     }
   }
@@ -530,7 +575,7 @@ class WritePointerVisitor : public ObjectPointerVisitor {
   intptr_t count() const { return count_; }
 
  private:
-  WriteStream* stream_;
+  HeapSnapshotWriter* writer_;
   bool only_instances_;
   intptr_t count_;
 };
@@ -538,20 +583,20 @@ class WritePointerVisitor : public ObjectPointerVisitor {
 static void WriteHeader(RawObject* raw,
                         intptr_t size,
                         intptr_t cid,
-                        WriteStream* stream) {
-  WritePtr(raw, stream);
+                        HeapSnapshotWriter* writer) {
+  WritePtr(raw, writer);
   ASSERT(Utils::IsAligned(size, kObjectAlignment));
-  stream->WriteUnsigned(size);
-  stream->WriteUnsigned(cid);
+  writer->WriteUnsigned(size);
+  writer->WriteUnsigned(cid);
 }
 
 class WriteGraphVisitor : public ObjectGraph::Visitor {
  public:
   WriteGraphVisitor(Isolate* isolate,
-                    WriteStream* stream,
+                    HeapSnapshotWriter* writer,
                     ObjectGraph::SnapshotRoots roots)
-      : stream_(stream),
-        ptr_writer_(isolate, stream, roots == ObjectGraph::kUser),
+      : writer_(writer),
+        ptr_writer_(isolate, writer, roots == ObjectGraph::kUser),
         roots_(roots),
         count_(0) {}
 
@@ -564,9 +609,9 @@ class WriteGraphVisitor : public ObjectGraph::Visitor {
     if ((roots_ == ObjectGraph::kVM) || obj.IsField() || obj.IsInstance() ||
         obj.IsContext()) {
       // Each object is a header + a zero-terminated list of its neighbors.
-      WriteHeader(raw_obj, raw_obj->HeapSize(), obj.GetClassId(), stream_);
+      WriteHeader(raw_obj, raw_obj->HeapSize(), obj.GetClassId(), writer_);
       raw_obj->VisitPointers(&ptr_writer_);
-      stream_->WriteUnsigned(0);
+      writer_->WriteUnsigned(0);
       ++count_;
     }
     return kProceed;
@@ -575,7 +620,7 @@ class WriteGraphVisitor : public ObjectGraph::Visitor {
   intptr_t count() const { return count_; }
 
  private:
-  WriteStream* stream_;
+  HeapSnapshotWriter* writer_;
   WritePointerVisitor ptr_writer_;
   ObjectGraph::SnapshotRoots roots_;
   intptr_t count_;
@@ -583,8 +628,8 @@ class WriteGraphVisitor : public ObjectGraph::Visitor {
 
 class WriteGraphExternalSizesVisitor : public HandleVisitor {
  public:
-  WriteGraphExternalSizesVisitor(Thread* thread, WriteStream* stream)
-      : HandleVisitor(thread), stream_(stream) {}
+  WriteGraphExternalSizesVisitor(Thread* thread, HeapSnapshotWriter* writer)
+      : HandleVisitor(thread), writer_(writer) {}
 
   void VisitHandle(uword addr) {
     FinalizablePersistentHandle* weak_persistent_handle =
@@ -593,15 +638,15 @@ class WriteGraphExternalSizesVisitor : public HandleVisitor {
       return;  // Free handle.
     }
 
-    WritePtr(weak_persistent_handle->raw(), stream_);
-    stream_->WriteUnsigned(weak_persistent_handle->external_size());
+    WritePtr(weak_persistent_handle->raw(), writer_);
+    writer_->WriteUnsigned(weak_persistent_handle->external_size());
   }
 
  private:
-  WriteStream* stream_;
+  HeapSnapshotWriter* writer_;
 };
 
-intptr_t ObjectGraph::Serialize(WriteStream* stream,
+intptr_t ObjectGraph::Serialize(HeapSnapshotWriter* writer,
                                 SnapshotRoots roots,
                                 bool collect_garbage) {
   if (collect_garbage) {
@@ -616,45 +661,45 @@ intptr_t ObjectGraph::Serialize(WriteStream* stream,
   RawObject* kStackAddress =
       reinterpret_cast<RawObject*>(kObjectAlignment + kHeapObjectTag);
 
-  stream->WriteUnsigned(kObjectAlignment);
-  stream->WriteUnsigned(kStackCid);
-  stream->WriteUnsigned(kFieldCid);
-  stream->WriteUnsigned(isolate()->class_table()->NumCids());
+  writer->WriteUnsigned(kObjectAlignment);
+  writer->WriteUnsigned(kStackCid);
+  writer->WriteUnsigned(kFieldCid);
+  writer->WriteUnsigned(isolate()->class_table()->NumCids());
 
   if (roots == kVM) {
     // Write root "object".
-    WriteHeader(kRootAddress, 0, kRootCid, stream);
-    WritePointerVisitor ptr_writer(isolate(), stream, false);
+    WriteHeader(kRootAddress, 0, kRootCid, writer);
+    WritePointerVisitor ptr_writer(isolate(), writer, false);
     isolate()->VisitObjectPointers(&ptr_writer,
                                    ValidationPolicy::kDontValidateFrames);
-    stream->WriteUnsigned(0);
+    writer->WriteUnsigned(0);
   } else {
     {
       // Write root "object".
-      WriteHeader(kRootAddress, 0, kRootCid, stream);
-      WritePointerVisitor ptr_writer(isolate(), stream, false);
+      WriteHeader(kRootAddress, 0, kRootCid, writer);
+      WritePointerVisitor ptr_writer(isolate(), writer, false);
       IterateUserFields(&ptr_writer);
-      WritePtr(kStackAddress, stream);
-      stream->WriteUnsigned(0);
+      WritePtr(kStackAddress, writer);
+      writer->WriteUnsigned(0);
     }
 
     {
       // Write stack "object".
-      WriteHeader(kStackAddress, 0, kStackCid, stream);
-      WritePointerVisitor ptr_writer(isolate(), stream, true);
+      WriteHeader(kStackAddress, 0, kStackCid, writer);
+      WritePointerVisitor ptr_writer(isolate(), writer, true);
       isolate()->VisitStackPointers(&ptr_writer,
                                     ValidationPolicy::kDontValidateFrames);
-      stream->WriteUnsigned(0);
+      writer->WriteUnsigned(0);
     }
   }
 
-  WriteGraphVisitor visitor(isolate(), stream, roots);
+  WriteGraphVisitor visitor(isolate(), writer, roots);
   IterateObjects(&visitor);
-  stream->WriteUnsigned(0);
+  writer->WriteUnsigned(0);
 
-  WriteGraphExternalSizesVisitor external_visitor(Thread::Current(), stream);
+  WriteGraphExternalSizesVisitor external_visitor(Thread::Current(), writer);
   isolate()->VisitWeakPersistentHandles(&external_visitor);
-  stream->WriteUnsigned(0);
+  writer->WriteUnsigned(0);
 
   intptr_t object_count = visitor.count();
   if (roots == kVM) {
@@ -662,6 +707,7 @@ intptr_t ObjectGraph::Serialize(WriteStream* stream,
   } else {
     object_count += 2;  // root and stack
   }
+  writer->Finish(object_count);
   return object_count;
 }
 
@@ -6,6 +6,7 @@
 #define RUNTIME_VM_OBJECT_GRAPH_H_
 
 #include "vm/allocation.h"
+#include "vm/datastream.h"
 #include "vm/thread_stack_resource.h"
 
 namespace dart {
@@ -14,7 +15,52 @@ class Array;
 class Isolate;
 class Object;
 class RawObject;
-class WriteStream;
+
+// Receives a heap snapshot from ObjectGraph::Serialize in chunks while the
+// heap is walked, so that the whole snapshot is never held in memory. The
+// snapshot is a sequence of variable-length unsigned values. Every chunk but
+// the last has exactly the chunk size, so chunks may end in the middle of a
+// value.
+class HeapSnapshotWriter {
+ public:
+  static const intptr_t kDefaultChunkSize = 1 * MB;
+
+  explicit HeapSnapshotWriter(intptr_t chunk_size = kDefaultChunkSize);
+  virtual ~HeapSnapshotWriter();
+
+  void WriteUnsigned(intptr_t value) {
+    stream_.WriteUnsigned(value);
+    if (stream_.bytes_written() >= chunk_size_) {
+      Flush(false);
+    }
+  }
+
+  // Writes the last chunk, which may be empty.
+  void Finish(intptr_t node_count);
+
+ protected:
+  // Called with each chunk in order. The chunk is only valid during the call.
+  // The heap is being walked, so this must not allocate in the Dart heap.
+  virtual void WriteChunk(uint8_t* chunk,
+                          intptr_t size,
+                          intptr_t chunk_index,
+                          bool is_last) = 0;
+
+  // The number of nodes in the snapshot, which is only known for the last
+  // chunk.
+  intptr_t node_count() const { return node_count_; }
+
+ private:
+  void Flush(bool is_last);
+
+  uint8_t* buffer_;
+  WriteStream stream_;
+  const intptr_t chunk_size_;
+  intptr_t chunk_index_;
+  intptr_t node_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapSnapshotWriter);
+};
 
 // Utility to traverse the object graph in an ordered fashion.
 // Example uses:
@@ -100,12 +146,13 @@ class ObjectGraph : public ThreadStackResource {
 
   enum SnapshotRoots { kVM, kUser };
 
-  // Write the isolate's object graph to 'stream'. Smis and nulls are omitted.
+  // Write the isolate's object graph to 'writer', which receives it in chunks
+  // as it is written, and finish the writer. Smis and nulls are omitted.
   // Returns the number of nodes in the stream, including the root.
   // If collect_garbage is false, the graph will include weakly-reachable
-  // objects.
-  // TODO(koda): Document format; support streaming/chunking.
-  intptr_t Serialize(WriteStream* stream,
+  // objects. Dominators and retained sizes are left to the reader.
+  // TODO(koda): Document format.
+  intptr_t Serialize(HeapSnapshotWriter* writer,
                      SnapshotRoots roots,
                      bool collect_garbage);
 
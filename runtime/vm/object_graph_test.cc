@@ -4,6 +4,7 @@
 
 #include "vm/object_graph.h"
 #include "platform/assert.h"
+#include "vm/growable_array.h"
 #include "vm/unit_test.h"
 
 namespace dart {
@@ -138,4 +139,64 @@ ISOLATE_UNIT_TEST_CASE(ObjectGraph) {
   }
 }
 
+class CollectingHeapSnapshotWriter : public HeapSnapshotWriter {
+ public:
+  static const intptr_t kChunkSize = 4 * KB;
+
+  CollectingHeapSnapshotWriter()
+      : HeapSnapshotWriter(kChunkSize),
+        chunk_count_(0),
+        last_node_count_(-1),
+        last_seen_(false) {}
+
+  GrowableArray<uint8_t>* bytes() { return &bytes_; }
+  intptr_t chunk_count() const { return chunk_count_; }
+  intptr_t last_node_count() const { return last_node_count_; }
+
+ protected:
+  virtual void WriteChunk(uint8_t* chunk,
+                          intptr_t size,
+                          intptr_t chunk_index,
+                          bool is_last) {
+    EXPECT(!last_seen_);
+    EXPECT_EQ(chunk_count_, chunk_index);
+    if (is_last) {
+      EXPECT_LE(size, kChunkSize);
+      last_seen_ = true;
+      last_node_count_ = node_count();
+    } else {
+      EXPECT_EQ(kChunkSize, size);
+      EXPECT_EQ(-1, node_count());
+    }
+    for (intptr_t i = 0; i < size; i++) {
+      bytes_.Add(chunk[i]);
+    }
+    chunk_count_++;
+  }
+
+ private:
+  GrowableArray<uint8_t> bytes_;
+  intptr_t chunk_count_;
+  intptr_t last_node_count_;
+  bool last_seen_;
+};
+
+ISOLATE_UNIT_TEST_CASE(ObjectGraph_SerializeInChunks) {
+  CollectingHeapSnapshotWriter writer;
+  ObjectGraph graph(thread);
+  const intptr_t node_count =
+      graph.Serialize(&writer, ObjectGraph::kVM, /*collect_garbage=*/false);
+  EXPECT_LT(1, writer.chunk_count());
+  EXPECT_EQ(node_count, writer.last_node_count());
+
+  // The chunks read back as one stream.
+  GrowableArray<uint8_t>* bytes = writer.bytes();
+  ReadStream stream(bytes->data(), bytes->length());
+  EXPECT_EQ(kObjectAlignment, stream.ReadUnsigned());
+  EXPECT_EQ(kStackCid, stream.ReadUnsigned());
+  EXPECT_EQ(kFieldCid, stream.ReadUnsigned());
+  EXPECT_EQ(thread->isolate()->class_table()->NumCids(),
+            stream.ReadUnsigned());
+}
+
 }  // namespace dart
@@ -45,9 +45,9 @@ void Function::ZeroEdgeCounters() const {
     return;
   }
   const intptr_t saved_ic_datalength = saved_ic_data.Length();
-  ASSERT(saved_ic_datalength > 0);
+  ASSERT(saved_ic_datalength >= kFirstICDataIndex);
   const Array& edge_counters_array =
-      Array::Handle(Array::RawCast(saved_ic_data.At(0)));
+      Array::Handle(Array::RawCast(saved_ic_data.At(kEdgeCountersIndex)));
   if (edge_counters_array.IsNull()) {
     return;
   }
@@ -121,7 +121,8 @@ void Code::ResetSwitchableCalls(Zone* zone) const {
   }
   ICData& ic_data = ICData::Handle(zone);
   Object& data = Object::Handle(zone);
-  for (intptr_t i = 1; i < ic_data_array.Length(); i++) {
+  for (intptr_t i = Function::kFirstICDataIndex; i < ic_data_array.Length();
+       i++) {
     ic_data ^= ic_data_array.At(i);
     if (ic_data.rebind_rule() != ICData::kInstance) {
       continue;
@@ -210,8 +210,15 @@ void TypeArguments::PrintJSONImpl(JSONStream* stream, bool ref) const {
     Array& prior_instantiations = Array::Handle(instantiations());
     ASSERT(prior_instantiations.Length() > 0);  // Always at least a sentinel.
     TypeArguments& type_args = TypeArguments::Handle();
-    intptr_t i = 0;
-    while (prior_instantiations.At(i) != Smi::New(StubCode::kNoInstantiator)) {
+    const bool is_hashed = IsHashedInstantiations(prior_instantiations);
+    // Skip the header of a hashed cache.
+    for (intptr_t i = is_hashed ? StubCode::kInstantiationSizeInWords : 0;
+         i < prior_instantiations.Length();
+         i += StubCode::kInstantiationSizeInWords) {
+      if (prior_instantiations.At(i) == Smi::New(StubCode::kNoInstantiator)) {
+        if (!is_hashed) break;
+        continue;
+      }
       JSONObject instantiation(&jsarr);
       type_args ^= prior_instantiations.At(i);
       instantiation.AddProperty("instantiatorTypeArguments", type_args, true);
@@ -219,7 +226,6 @@ void TypeArguments::PrintJSONImpl(JSONStream* stream, bool ref) const {
       instantiation.AddProperty("functionTypeArguments", type_args, true);
       type_args ^= prior_instantiations.At(i + 2);
       instantiation.AddProperty("instantiated", type_args, true);
-      i += StubCode::kInstantiationSizeInWords;
     }
   }
 }
@@ -136,13 +136,26 @@ class ObjectPointerVisitor;
   RW(Code, stack_overflow_stub_without_fpu_regs_stub)                          \
   RW(Code, write_barrier_wrappers_stub)                                        \
   RW(Code, array_write_barrier_stub)                                           \
+  RW(Code, allocate_array_stub)                                                \
+  RW(Code, allocate_context_stub)                                              \
+  RW(Code, call_bootstrap_native_stub)                                         \
+  RW(Code, call_auto_scope_native_stub)                                        \
+  RW(Code, call_no_scope_native_stub)                                          \
+  RW(Code, subtype1_test_cache_stub)                                           \
+  RW(Code, subtype2_test_cache_stub)                                           \
+  RW(Code, subtype4_test_cache_stub)                                           \
+  RW(Code, subtype6_test_cache_stub)                                           \
   R_(Code, megamorphic_miss_code)                                              \
   R_(Function, megamorphic_miss_function)                                      \
+  RW(Array, read_only_symbol_table)                                            \
   RW(Array, code_order_table)                                                  \
   RW(Array, obfuscation_map)                                                   \
+  RW(Array, deferred_libraries)                                                \
+  RW(GrowableObjectArray, type_feedback)                                       \
   RW(GrowableObjectArray, changed_in_last_reload)                              \
   RW(Class, ffi_pointer_class)                                                 \
   RW(Class, ffi_native_type_class)                                             \
+  RW(StackTrace, last_async_function_stack_trace)                              \
 // Please remember the last entry must be referred in the 'to' function below.
 
 // The object store is a per isolate instance which stores references to
@@ -235,7 +248,7 @@ class ObjectStore {
                           DECLARE_OBJECT_STORE_FIELD)
 #undef DECLARE_OBJECT_STORE_FIELD
   RawObject** to() {
-    return reinterpret_cast<RawObject**>(&ffi_pointer_class_);
+    return reinterpret_cast<RawObject**>(&last_async_function_stack_trace_);
   }
   RawObject** to_snapshot(Snapshot::Kind kind) {
     switch (kind) {
@@ -17,6 +17,7 @@
 #include "vm/malloc_hooks.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
+#include "vm/reverse_pc_lookup_cache.h"
 #include "vm/simulator.h"
 #include "vm/symbols.h"
 #include "vm/unit_test.h"
@@ -1257,6 +1258,34 @@ ISOLATE_UNIT_TEST_CASE(StringHashConcat) {
                         String::Handle(String::FromUTF16(clef_utf16 + 1, 1))));
 }
 
+ISOLATE_UNIT_TEST_CASE(StringIndexOf) {
+  const String& one = String::Handle(
+      String::New("GET /index.html HTTP/1.1 GET /favicon.ico HTTP/1.1"));
+  EXPECT(one.IsOneByteString());
+  EXPECT_EQ(0, String::IndexOf(one, String::Handle(String::New("GET")), 0));
+  EXPECT_EQ(25, String::IndexOf(one, String::Handle(String::New("GET")), 1));
+  EXPECT_EQ(-1, String::IndexOf(one, String::Handle(String::New("POST")), 0));
+  EXPECT_EQ(7, String::IndexOf(one, String::Handle(String::New("")), 7));
+  EXPECT_EQ(3, String::IndexOf(one, ' ', 0));
+  EXPECT_EQ(-1, String::IndexOf(one, 0x100, 0));
+
+  // The search for the first code unit handles code units whose low bytes
+  // match, and matches in the last word of the string.
+  uint16_t two_utf16[] = {0x1F4, 0xF4, 0x1F5, 0x1F4, 0x61, 0x62, 0x1F4, 0x63,
+                          0x1F4, 0x64, 0x65, 0x66, 0x1F4, 0x67, 0x1F4, 0x68};
+  const String& two = String::Handle(String::FromUTF16(two_utf16, 16));
+  EXPECT(two.IsTwoByteString());
+  EXPECT_EQ(1, String::IndexOf(two, 0xF4, 0));
+  EXPECT_EQ(2, String::IndexOf(two, 0x1F5, 0));
+  EXPECT_EQ(15, String::IndexOf(two, 0x68, 0));
+  EXPECT_EQ(-1, String::IndexOf(two, 0x69, 0));
+  uint16_t pattern_utf16[] = {0x1F4, 0x67};
+  const String& pattern = String::Handle(String::FromUTF16(pattern_utf16, 2));
+  EXPECT_EQ(12, String::IndexOf(two, pattern, 0));
+  EXPECT_EQ(4, String::IndexOf(two, String::Handle(String::New("ab")), 0));
+  EXPECT_EQ(-1, String::IndexOf(one, pattern, 0));
+}
+
 ISOLATE_UNIT_TEST_CASE(StringSubStringDifferentWidth) {
   // Create 1-byte substring from a 1-byte source string.
   const char* onechars = "\xC3\xB6\xC3\xB1\xC3\xA9";
@@ -2489,6 +2518,47 @@ ISOLATE_UNIT_TEST_CASE(Code) {
   EXPECT_EQ(1, Smi::Cast(result).Value());
 }
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+ISOLATE_UNIT_TEST_CASE(JitReversePcLookupTable) {
+  extern void GenerateIncrement(Assembler * assembler);
+  const Function& function = Function::Handle(CreateFunction("Test_Code"));
+  // More code than fits in the unsorted part of the index.
+  const intptr_t kCount = 200;
+  const Array& live = Array::Handle(Array::New(kCount, Heap::kOld));
+  uword dead_pcs[kCount];
+  Code& code = Code::Handle();
+  for (intptr_t i = 0; i < kCount; i++) {
+    ObjectPoolBuilder object_pool_builder;
+    Assembler assembler(&object_pool_builder);
+    GenerateIncrement(&assembler);
+    code = Code::FinalizeCodeAndNotify(function, nullptr, &assembler,
+                                       Code::PoolAttachment::kAttachPool);
+    EXPECT_EQ(code.raw(), Code::LookupCode(code.PayloadStart()));
+    EXPECT_EQ(code.raw(),
+              Code::LookupCode(code.PayloadStart() + code.Size() - 1));
+    dead_pcs[i] = 0;
+    if ((i % 2) == 0) {
+      live.SetAt(i, code);
+    } else {
+      dead_pcs[i] = code.PayloadStart();
+    }
+  }
+  code = Code::null();
+
+  // Collected code leaves the index, and moved code is still found.
+  Isolate::Current()->heap()->CollectAllGarbage();
+  JitReversePcLookupTable* table = Isolate::Current()->jit_pc_lookup_table();
+  for (intptr_t i = 0; i < kCount; i++) {
+    if ((i % 2) == 0) {
+      code ^= live.At(i);
+      EXPECT_EQ(code.raw(), table->Lookup(code.PayloadStart() + 1));
+    } else {
+      EXPECT_EQ(Code::null(), table->Lookup(dead_pcs[i]));
+    }
+  }
+}
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 // Test for immutability of generated instructions. The test crashes with a
 // segmentation fault when writing into it.
 ISOLATE_UNIT_TEST_CASE_WITH_EXPECTATION(CodeImmutability, "Crash") {
@@ -3914,6 +3984,47 @@ TEST_CASE(FunctionWithBreakpointNotInlined) {
   }
 }
 
+TEST_CASE(BreakpointKeepsUnrelatedOptimizedCode) {
+  SetFlagScope<int> sfs(&FLAG_optimization_counter_threshold, 5);
+  SetFlagScope<bool> sfs2(&FLAG_background_compilation, false);
+  const char* kScriptChars =
+      "foo(x) => x + 1;\n"
+      "bar(x) {\n"
+      "  return x * 2;\n"  // This is line 3.
+      "}\n"
+      "test() {\n"
+      "  var sum = 0;\n"
+      "  for (var i = 0; i < 20; i++) {\n"
+      "    sum += foo(i) + bar(i);\n"
+      "  }\n"
+      "  return sum;\n"
+      "}";
+  const int kBreakpointLine = 3;
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  Dart_Handle result = Dart_Invoke(lib, NewString("test"), 0, NULL);
+  EXPECT_VALID(result);
+
+  // Both functions have been optimized; setting a breakpoint in 'bar' only
+  // deoptimizes the code that can run 'bar'.
+  result = Dart_SetBreakpoint(NewString(TestCase::url()), kBreakpointLine);
+  EXPECT_VALID(result);
+
+  {
+    TransitionNativeToVM transition(thread);
+    const String& name = String::Handle(String::New(TestCase::url()));
+    const Library& vmlib =
+        Library::Handle(Library::LookupLibrary(thread, name));
+    EXPECT(!vmlib.IsNull());
+    const Function& foo = Function::Handle(
+        vmlib.LookupLocalFunction(String::Handle(String::New("foo"))));
+    const Function& bar = Function::Handle(
+        vmlib.LookupLocalFunction(String::Handle(String::New("bar"))));
+    EXPECT(foo.HasOptimizedCode());
+    EXPECT(!bar.HasOptimizedCode());
+  }
+}
+
 ISOLATE_UNIT_TEST_CASE(SpecialClassesHaveEmptyArrays) {
   ObjectStore* object_store = Isolate::Current()->object_store();
   Class& cls = Class::Handle();
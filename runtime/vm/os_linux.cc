@@ -46,6 +46,12 @@ DEFINE_FLAG(bool,
             "Generate jitdump file to use with perf-inject (disables dual code "
             "mapping)");
 
+DEFINE_FLAG(bool,
+            perf_jitdump_source_lines,
+            false,
+            "Map JIT generated code to Dart source lines instead of code "
+            "comments in the jitdump file");
+
 DECLARE_FLAG(bool, write_protect_code);
 DECLARE_FLAG(bool, write_protect_vm_isolate);
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -90,7 +96,8 @@ class PerfCodeObserver : public CodeObserver {
                       uword prologue_offset,
                       uword size,
                       bool optimized,
-                      const CodeComments* comments) {
+                      const CodeComments* comments,
+                      const CodeLineInfo* lines) {
     Dart_FileWriteCallback file_write = Dart::file_write_callback();
     if ((file_write == NULL) || (out_file_ == NULL)) {
       return;
@@ -121,6 +128,15 @@ class PerfCodeObserver : public CodeObserver {
 //   $ perf inject -j -i perf.data -o perf.data.jitted
 //   $ perf report -i perf.data.jitted
 //
+// By default perf-annotate shows the code comments of each code object. With
+// --perf-jitdump-source-lines it shows the Dart source lines instead, taken
+// from the code's source map, where inlined code has the lines of the inlined
+// function.
+//
+// Instructions are never moved by the GC, so there are no move records. Code
+// that is collected needs no record either: perf attributes samples to the
+// latest code loaded at an address.
+//
 // [1] see linux/tools/perf/Documentation/jitdump-specification.txt for
 //     JITDUMP binary format.
 class JitDumpCodeObserver : public CodeObserver {
@@ -191,19 +207,26 @@ class JitDumpCodeObserver : public CodeObserver {
     return FLAG_generate_perf_jitdump && (out_file_ != nullptr);
   }
 
+  virtual bool WantsLineInfo() const { return FLAG_perf_jitdump_source_lines; }
+
   virtual void Notify(const char* name,
                       uword base,
                       uword prologue_offset,
                       uword size,
                       bool optimized,
-                      const CodeComments* comments) {
+                      const CodeComments* comments,
+                      const CodeLineInfo* lines) {
     MutexLocker ml(CodeObservers::mutex());
 
     const char* marker = optimized ? "*" : "";
     char* buffer = OS::SCreate(Thread::Current()->zone(), "%s%s", marker, name);
     const size_t name_length = strlen(buffer);
 
-    WriteDebugInfo(base, comments);
+    if ((lines != nullptr) && (lines->Length() > 0)) {
+      WriteDebugInfo(base, lines);
+    } else {
+      WriteDebugInfo(base, comments);
+    }
 
     CodeLoadEvent ev;
     ev.event = BaseEvent::kLoad;
@@ -359,6 +382,35 @@ class JitDumpCodeObserver : public CodeObserver {
     free(comments_file_name);
   }
 
+  void WriteDebugInfo(uword base, const CodeLineInfo* lines) {
+    const intptr_t entry_count = lines->Length();
+    DebugInfoEvent info;
+    info.event = BaseEvent::kDebugInfo;
+    info.time_stamp = OS::GetCurrentMonotonicTicks();
+    info.address = base;
+    info.entry_count = entry_count;
+    info.size = sizeof(info) + entry_count * sizeof(DebugInfoEntry);
+    for (intptr_t i = 0; i < entry_count; i++) {
+      info.size += strlen(lines->FileAt(i)) + 1;
+    }
+    const int32_t padding = Utils::RoundUp(info.size, 8) - info.size;
+    info.size += padding;
+
+    WriteFully(&info, sizeof(info));
+    for (intptr_t i = 0; i < entry_count; i++) {
+      DebugInfoEntry entry;
+      entry.address = base + lines->PCOffsetAt(i) + kElfHeaderSize;
+      entry.line_number = lines->LineAt(i);
+      entry.column = 0;
+      WriteFully(&entry, sizeof(entry));
+      const char* file = lines->FileAt(i);
+      WriteFully(file, strlen(file) + 1);
+    }
+
+    const char padding_bytes[8] = {0};
+    WriteFully(padding_bytes, padding);
+  }
+
   void WriteHeader() {
     Header header;
     header.elf_mach_target = GetElfMachineArchitecture();
@@ -375,6 +427,7 @@ class JitDumpCodeObserver : public CodeObserver {
     intptr_t line_count = 1;
     while ((comment = strstr(comment, "\n")) != nullptr) {
       line_count++;
+      comment++;
     }
     return line_count;
   }
@@ -37,6 +37,10 @@ OSThread::OSThread()
       timeline_block_(NULL),
       thread_list_next_(NULL),
       thread_interrupt_disabled_(1),  // Thread interrupts disabled by default.
+#if !defined(PRODUCT) && defined(HOST_OS_LINUX)
+      profile_counter_fd_(-1),
+      profile_counter_value_(0),
+#endif
       log_(new class Log()),
       stack_base_(0),
       stack_limit_(0),
@@ -77,6 +81,9 @@ OSThread::~OSThread() {
     FATAL("Thread exited without calling Dart_ExitIsolate");
   }
   RemoveThreadFromList(this);
+#if !defined(PRODUCT) && defined(HOST_OS_LINUX)
+  ThreadInterrupter::ReleaseCounter(this);
+#endif
   delete log_;
   log_ = NULL;
 #if defined(SUPPORT_TIMELINE)
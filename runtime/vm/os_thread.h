@@ -46,6 +46,10 @@ class Mutex {
 
   bool IsOwnedByCurrentThread() const;
 
+#if !defined(PRODUCT)
+  const char* name() const { return name_; }
+#endif
+
  private:
   void Lock();
   bool TryLock();  // Returns false if lock is busy and locking failed.
@@ -57,6 +61,7 @@ class Mutex {
   ThreadId owner_;
 #endif  // defined(DEBUG)
 
+  friend class LockProfiler;
   friend class MallocLocker;
   friend class MutexLocker;
   friend class SafepointMutexLocker;
@@ -296,6 +301,12 @@ class OSThread : public BaseThread {
   OSThread* thread_list_next_;
 
   uintptr_t thread_interrupt_disabled_;
+#if !defined(PRODUCT) && defined(HOST_OS_LINUX)
+  // The perf_event counter driving profiler samples on this thread when
+  // --profile_counter is set, and its value at the previous sample.
+  intptr_t profile_counter_fd_;
+  uint64_t profile_counter_value_;
+#endif
   Log* log_;
   uword stack_base_;
   uword stack_limit_;
@@ -317,6 +328,7 @@ class OSThread : public BaseThread {
 
   friend class Isolate;  // to access set_thread(Thread*).
   friend class OSThreadIterator;
+  friend class ThreadInterrupterLinux;
   friend class ThreadInterrupterWin;
   friend class ThreadInterrupterFuchsia;
 };
@@ -344,9 +356,13 @@ class Monitor {
 
   static const int64_t kNoTimeout = 0;
 
-  Monitor();
+  explicit Monitor(NOT_IN_PRODUCT(const char* name = "anonymous monitor"));
   ~Monitor();
 
+#if !defined(PRODUCT)
+  const char* name() const { return name_; }
+#endif
+
 #if defined(DEBUG)
   bool IsOwnedByCurrentThread() const {
     return owner_ == OSThread::GetCurrentThreadId();
@@ -372,10 +388,12 @@ class Monitor {
   void NotifyAll();
 
   MonitorData data_;  // OS-specific data.
+  NOT_IN_PRODUCT(const char* name_);
 #if defined(DEBUG)
   ThreadId owner_;
 #endif  // defined(DEBUG)
 
+  friend class LockProfiler;
   friend class MonitorLocker;
   friend class SafepointMonitorLocker;
   friend void Dart_TestMonitor();
@@ -361,7 +361,11 @@ void Mutex::Unlock() {
   ASSERT_PTHREAD_SUCCESS(result);  // Verify no other errors.
 }
 
-Monitor::Monitor() {
+Monitor::Monitor(NOT_IN_PRODUCT(const char* name))
+#if !defined(PRODUCT)
+    : name_(name)
+#endif
+{
   pthread_mutexattr_t mutex_attr;
   int result = pthread_mutexattr_init(&mutex_attr);
   VALIDATE_PTHREAD_RESULT(result);
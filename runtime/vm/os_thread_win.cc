@@ -257,7 +257,11 @@ void Mutex::Unlock() {
   ReleaseSRWLockExclusive(&data_.lock_);
 }
 
-Monitor::Monitor() {
+Monitor::Monitor(NOT_IN_PRODUCT(const char* name))
+#if !defined(PRODUCT)
+    : name_(name)
+#endif
+{
   InitializeSRWLock(&data_.lock_);
   InitializeConditionVariable(&data_.cond_);
 #if defined(DEBUG)
@@ -16,15 +16,18 @@
 
 namespace dart {
 
-Mutex* PortMap::mutex_ = NULL;
-PortMap::Entry* PortMap::map_ = NULL;
+PortMap::Shard PortMap::shards_[PortMap::kNumShards];
 MessageHandler* PortMap::deleted_entry_ = reinterpret_cast<MessageHandler*>(1);
-intptr_t PortMap::capacity_ = 0;
-intptr_t PortMap::used_ = 0;
-intptr_t PortMap::deleted_ = 0;
+Mutex* PortMap::prng_mutex_ = NULL;
 Random* PortMap::prng_ = NULL;
 
-intptr_t PortMap::FindPort(Dart_Port port) {
+// The two lowest bits of port ids are always set (see AllocatePort), so they
+// are not used to pick a slot.
+static intptr_t PortHash(Dart_Port port, intptr_t capacity) {
+  return (port >> 2) % capacity;
+}
+
+intptr_t PortMap::FindPort(Shard* shard, Dart_Port port) {
   // ILLEGAL_PORT (0) is used as a sentinel value in Entry.port. The loop below
   // could return the index to a deleted port when we are searching for
   // port id ILLEGAL_PORT. Return -1 immediately to indicate the port
@@ -33,40 +36,43 @@ intptr_t PortMap::FindPort(Dart_Port port) {
     return -1;
   }
   ASSERT(port != ILLEGAL_PORT);
-  intptr_t index = port % capacity_;
+  ASSERT(shard == ShardOf(port));
+  ASSERT(shard->mutex->IsOwnedByCurrentThread());
+  const intptr_t capacity = shard->capacity;
+  intptr_t index = PortHash(port, capacity);
   intptr_t start_index = index;
-  Entry entry = map_[index];
+  Entry entry = shard->map[index];
   while (entry.handler != NULL) {
     if (entry.port == port) {
       return index;
     }
-    index = (index + 1) % capacity_;
+    index = (index + 1) % capacity;
     // Prevent endless loops.
     ASSERT(index != start_index);
-    entry = map_[index];
+    entry = shard->map[index];
   }
   return -1;
 }
 
-void PortMap::Rehash(intptr_t new_capacity) {
+void PortMap::Rehash(Shard* shard, intptr_t new_capacity) {
   Entry* new_ports = new Entry[new_capacity];
   memset(new_ports, 0, new_capacity * sizeof(Entry));
 
-  for (intptr_t i = 0; i < capacity_; i++) {
-    Entry entry = map_[i];
+  for (intptr_t i = 0; i < shard->capacity; i++) {
+    Entry entry = shard->map[i];
     // Skip free and deleted entries.
     if (entry.port != 0) {
-      intptr_t new_index = entry.port % new_capacity;
+      intptr_t new_index = PortHash(entry.port, new_capacity);
       while (new_ports[new_index].port != 0) {
         new_index = (new_index + 1) % new_capacity;
       }
       new_ports[new_index] = entry;
     }
   }
-  delete[] map_;
-  map_ = new_ports;
-  capacity_ = new_capacity;
-  deleted_ = 0;
+  delete[] shard->map;
+  shard->map = new_ports;
+  shard->capacity = new_capacity;
+  shard->deleted = 0;
 }
 
 const char* PortMap::PortStateString(PortState kind) {
@@ -84,35 +90,30 @@ const char* PortMap::PortStateString(PortState kind) {
 }
 
 Dart_Port PortMap::AllocatePort() {
-  Dart_Port result;
-
-  // Keep getting new values while we have an illegal port number or the port
-  // number is already in use.
-  do {
-    // Ensure port ids are representable in JavaScript for the benefit of
-    // vm-service clients such as Observatory.
-    const Dart_Port kMask1 = 0xFFFFFFFFFFFFF;
-    // Ensure port ids are never valid object pointers so that reinterpreting
-    // an object pointer as a port id never produces a used port id.
-    const Dart_Port kMask2 = 0x3;
-    result = (prng_->NextUInt64() & kMask1) | kMask2;
-    ASSERT(!reinterpret_cast<RawObject*>(result)->IsWellFormed());
-  } while (FindPort(result) >= 0);
-
+  MutexLocker ml(prng_mutex_);
+  // Ensure port ids are representable in JavaScript for the benefit of
+  // vm-service clients such as Observatory.
+  const Dart_Port kMask1 = 0xFFFFFFFFFFFFF;
+  // Ensure port ids are never valid object pointers so that reinterpreting
+  // an object pointer as a port id never produces a used port id.
+  const Dart_Port kMask2 = 0x3;
+  Dart_Port result = (prng_->NextUInt64() & kMask1) | kMask2;
+  ASSERT(!reinterpret_cast<RawObject*>(result)->IsWellFormed());
   ASSERT(result != 0);
-  ASSERT(FindPort(result) < 0);
   return result;
 }
 
 void PortMap::SetPortState(Dart_Port port, PortState state) {
-  MutexLocker ml(mutex_);
-  intptr_t index = FindPort(port);
+  Shard* shard = ShardOf(port);
+  MutexLocker ml(shard->mutex);
+  intptr_t index = FindPort(shard, port);
   ASSERT(index >= 0);
-  PortState old_state = map_[index].state;
+  Entry* entry = &shard->map[index];
+  PortState old_state = entry->state;
   ASSERT(old_state == kNewPort);
-  map_[index].state = state;
+  entry->state = state;
   if (state == kLivePort) {
-    map_[index].handler->increment_live_ports();
+    entry->handler->increment_live_ports();
   }
   if (FLAG_trace_isolates) {
     OS::PrintErr(
@@ -120,101 +121,110 @@ void PortMap::SetPortState(Dart_Port port, PortState state) {
         "\thandler:    %s\n"
         "\tport:       %" Pd64 "\n",
         PortStateString(old_state), PortStateString(state),
-        map_[index].handler->name(), port);
+        entry->handler->name(), port);
   }
 }
 
-void PortMap::MaintainInvariants() {
-  intptr_t empty = capacity_ - used_ - deleted_;
-  if (used_ > ((capacity_ / 4) * 3)) {
+void PortMap::MaintainInvariants(Shard* shard) {
+  intptr_t empty = shard->capacity - shard->used - shard->deleted;
+  if (shard->used > ((shard->capacity / 4) * 3)) {
     // Grow the port map.
-    Rehash(capacity_ * 2);
-  } else if (empty < deleted_) {
+    Rehash(shard, shard->capacity * 2);
+  } else if (empty < shard->deleted) {
     // Rehash without growing the table to flush the deleted slots out of the
     // map.
-    Rehash(capacity_);
+    Rehash(shard, shard->capacity);
   }
 }
 
 Dart_Port PortMap::CreatePort(MessageHandler* handler) {
   ASSERT(handler != NULL);
-  MutexLocker ml(mutex_);
 #if defined(DEBUG)
   handler->CheckAccess();
 #endif
 
   Entry entry;
-  entry.port = AllocatePort();
   entry.handler = handler;
   entry.state = kNewPort;
 
-  // Search for the first unused slot. Make use of the knowledge that here is
-  // currently no port with this id in the port map.
-  ASSERT(FindPort(entry.port) < 0);
-  intptr_t index = entry.port % capacity_;
-  Entry cur = map_[index];
-  // Stop the search at the first found unused (free or deleted) slot.
-  while (cur.port != 0) {
-    index = (index + 1) % capacity_;
-    cur = map_[index];
-  }
+  // Keep getting new values while the port number is already in use.
+  while (true) {
+    entry.port = AllocatePort();
+    Shard* shard = ShardOf(entry.port);
+    MutexLocker ml(shard->mutex);
+    if (FindPort(shard, entry.port) >= 0) {
+      continue;
+    }
 
-  // Insert the newly created port at the index.
-  ASSERT(index >= 0);
-  ASSERT(index < capacity_);
-  ASSERT(map_[index].port == 0);
-  ASSERT((map_[index].handler == NULL) ||
-         (map_[index].handler == deleted_entry_));
-  if (map_[index].handler == deleted_entry_) {
-    // Consuming a deleted entry.
-    deleted_--;
-  }
-  map_[index] = entry;
+    // Search for the first unused slot. Make use of the knowledge that here is
+    // currently no port with this id in the port map.
+    intptr_t index = PortHash(entry.port, shard->capacity);
+    Entry cur = shard->map[index];
+    // Stop the search at the first found unused (free or deleted) slot.
+    while (cur.port != 0) {
+      index = (index + 1) % shard->capacity;
+      cur = shard->map[index];
+    }
 
-  // Increment number of used slots and grow if necessary.
-  used_++;
-  MaintainInvariants();
+    // Insert the newly created port at the index.
+    ASSERT(index >= 0);
+    ASSERT(index < shard->capacity);
+    ASSERT(shard->map[index].port == 0);
+    ASSERT((shard->map[index].handler == NULL) ||
+           (shard->map[index].handler == deleted_entry_));
+    if (shard->map[index].handler == deleted_entry_) {
+      // Consuming a deleted entry.
+      shard->deleted--;
+    }
+    shard->map[index] = entry;
+
+    // Increment number of used slots and grow if necessary.
+    shard->used++;
+    MaintainInvariants(shard);
+
+    if (FLAG_trace_isolates) {
+      OS::PrintErr(
+          "[+] Opening port: \n"
+          "\thandler:    %s\n"
+          "\tport:       %" Pd64 "\n",
+          handler->name(), entry.port);
+    }
 
-  if (FLAG_trace_isolates) {
-    OS::PrintErr(
-        "[+] Opening port: \n"
-        "\thandler:    %s\n"
-        "\tport:       %" Pd64 "\n",
-        handler->name(), entry.port);
+    return entry.port;
   }
-
-  return entry.port;
 }
 
 bool PortMap::ClosePort(Dart_Port port) {
   MessageHandler* handler = NULL;
   {
-    MutexLocker ml(mutex_);
-    intptr_t index = FindPort(port);
+    Shard* shard = ShardOf(port);
+    MutexLocker ml(shard->mutex);
+    intptr_t index = FindPort(shard, port);
     if (index < 0) {
       return false;
     }
-    ASSERT(index < capacity_);
-    ASSERT(map_[index].port != 0);
-    ASSERT(map_[index].handler != deleted_entry_);
-    ASSERT(map_[index].handler != NULL);
+    ASSERT(index < shard->capacity);
+    Entry* entry = &shard->map[index];
+    ASSERT(entry->port != 0);
+    ASSERT(entry->handler != deleted_entry_);
+    ASSERT(entry->handler != NULL);
 
-    handler = map_[index].handler;
+    handler = entry->handler;
 #if defined(DEBUG)
     handler->CheckAccess();
 #endif
     // Before releasing the lock mark the slot in the map as deleted. This makes
     // it possible to release the port map lock before flushing all of its
     // pending messages below.
-    map_[index].port = 0;
-    map_[index].handler = deleted_entry_;
-    if (map_[index].state == kLivePort) {
+    entry->port = 0;
+    entry->handler = deleted_entry_;
+    if (entry->state == kLivePort) {
       handler->decrement_live_ports();
     }
 
-    used_--;
-    deleted_++;
-    MaintainInvariants();
+    shard->used--;
+    shard->deleted++;
+    MaintainInvariants(shard);
   }
   handler->ClosePort(port);
   if (!handler->HasLivePorts() && handler->OwnedByPortMap()) {
@@ -225,100 +235,112 @@ bool PortMap::ClosePort(Dart_Port port) {
 }
 
 void PortMap::ClosePorts(MessageHandler* handler) {
-  {
-    MutexLocker ml(mutex_);
-    for (intptr_t i = 0; i < capacity_; i++) {
-      if (map_[i].handler == handler) {
+  for (intptr_t s = 0; s < kNumShards; s++) {
+    Shard* shard = &shards_[s];
+    MutexLocker ml(shard->mutex);
+    for (intptr_t i = 0; i < shard->capacity; i++) {
+      Entry* entry = &shard->map[i];
+      if (entry->handler == handler) {
         // Mark the slot as deleted.
-        map_[i].port = 0;
-        map_[i].handler = deleted_entry_;
-        if (map_[i].state == kLivePort) {
+        entry->port = 0;
+        entry->handler = deleted_entry_;
+        if (entry->state == kLivePort) {
           handler->decrement_live_ports();
         }
-        used_--;
-        deleted_++;
+        shard->used--;
+        shard->deleted++;
       }
     }
-    MaintainInvariants();
+    MaintainInvariants(shard);
   }
   handler->CloseAllPorts();
 }
 
 bool PortMap::PostMessage(std::unique_ptr<Message> message,
                           bool before_events) {
-  MutexLocker ml(mutex_);
-  intptr_t index = FindPort(message->dest_port());
+  Shard* shard = ShardOf(message->dest_port());
+  MutexLocker ml(shard->mutex);
+  intptr_t index = FindPort(shard, message->dest_port());
   if (index < 0) {
     return false;
   }
   ASSERT(index >= 0);
-  ASSERT(index < capacity_);
-  MessageHandler* handler = map_[index].handler;
-  ASSERT(map_[index].port != 0);
+  ASSERT(index < shard->capacity);
+  MessageHandler* handler = shard->map[index].handler;
+  ASSERT(shard->map[index].port != 0);
   ASSERT((handler != NULL) && (handler != deleted_entry_));
   handler->PostMessage(std::move(message), before_events);
   return true;
 }
 
 bool PortMap::IsLocalPort(Dart_Port id) {
-  MutexLocker ml(mutex_);
-  intptr_t index = FindPort(id);
+  Shard* shard = ShardOf(id);
+  MutexLocker ml(shard->mutex);
+  intptr_t index = FindPort(shard, id);
   if (index < 0) {
     // Port does not exist.
     return false;
   }
 
-  MessageHandler* handler = map_[index].handler;
+  MessageHandler* handler = shard->map[index].handler;
   return handler->IsCurrentIsolate();
 }
 
 Isolate* PortMap::GetIsolate(Dart_Port id) {
-  MutexLocker ml(mutex_);
-  intptr_t index = FindPort(id);
+  Shard* shard = ShardOf(id);
+  MutexLocker ml(shard->mutex);
+  intptr_t index = FindPort(shard, id);
   if (index < 0) {
     // Port does not exist.
     return NULL;
   }
 
-  MessageHandler* handler = map_[index].handler;
+  MessageHandler* handler = shard->map[index].handler;
   return handler->isolate();
 }
 
 void PortMap::Init() {
-  if (mutex_ == NULL) {
-    mutex_ = new Mutex();
+  if (prng_mutex_ == NULL) {
+    prng_mutex_ = new Mutex(NOT_IN_PRODUCT("PortMap::prng_mutex_"));
   }
-  ASSERT(mutex_ != NULL);
+  ASSERT(prng_mutex_ != NULL);
   prng_ = new Random();
 
   static const intptr_t kInitialCapacity = 8;
   // TODO(iposva): Verify whether we want to keep exponentially growing.
   ASSERT(Utils::IsPowerOfTwo(kInitialCapacity));
-  if (map_ == NULL) {
-    // TODO(bkonyi): don't keep map_ after Dart_Cleanup.
-    map_ = new Entry[kInitialCapacity];
-    capacity_ = kInitialCapacity;
+  for (intptr_t s = 0; s < kNumShards; s++) {
+    Shard* shard = &shards_[s];
+    if (shard->mutex == NULL) {
+      shard->mutex = new Mutex(NOT_IN_PRODUCT("PortMap::shard_mutex_"));
+    }
+    if (shard->map == NULL) {
+      // TODO(bkonyi): don't keep map after Dart_Cleanup.
+      shard->map = new Entry[kInitialCapacity];
+      shard->capacity = kInitialCapacity;
+    }
+    memset(shard->map, 0, shard->capacity * sizeof(Entry));
+    shard->used = 0;
+    shard->deleted = 0;
   }
-  memset(map_, 0, capacity_ * sizeof(Entry));
-  used_ = 0;
-  deleted_ = 0;
 }
 
 void PortMap::Cleanup() {
-  ASSERT(map_ != NULL);
   ASSERT(prng_ != NULL);
-  for (intptr_t i = 0; i < capacity_; ++i) {
-    auto handler = map_[i].handler;
-    if (handler != NULL && handler != deleted_entry_) {
-      ClosePorts(handler);
-      delete handler;
+  for (intptr_t s = 0; s < kNumShards; s++) {
+    Shard* shard = &shards_[s];
+    ASSERT(shard->map != NULL);
+    for (intptr_t i = 0; i < shard->capacity; ++i) {
+      auto handler = shard->map[i].handler;
+      if (handler != NULL && handler != deleted_entry_) {
+        ClosePorts(handler);
+        delete handler;
+      }
     }
   }
   delete prng_;
   prng_ = NULL;
-  // TODO(bkonyi): find out why deleting map_ sometimes causes crashes.
-  // delete[] map_;
-  // map_ = NULL;
+  // TODO(bkonyi): find out why deleting the maps sometimes causes crashes.
 }
 
 void PortMap::PrintPortsForMessageHandler(MessageHandler* handler,
@@ -332,14 +354,16 @@ void PortMap::PrintPortsForMessageHandler(MessageHandler* handler,
   Object& msg_handler = Object::Handle();
   {
     JSONArray ports(&jsobj, "ports");
-    SafepointMutexLocker ml(mutex_);
-    for (intptr_t i = 0; i < capacity_; i++) {
-      if (map_[i].handler == handler) {
-        if (map_[i].state == kLivePort) {
+    for (intptr_t s = 0; s < kNumShards; s++) {
+      Shard* shard = &shards_[s];
+      SafepointMutexLocker ml(shard->mutex);
+      for (intptr_t i = 0; i < shard->capacity; i++) {
+        const Entry& entry = shard->map[i];
+        if ((entry.handler == handler) && (entry.state == kLivePort)) {
           JSONObject port(&ports);
           port.AddProperty("type", "_Port");
-          port.AddPropertyF("name", "Isolate Port (%" Pd64 ")", map_[i].port);
-          msg_handler = DartLibraryCalls::LookupHandler(map_[i].port);
+          port.AddPropertyF("name", "Isolate Port (%" Pd64 ")", entry.port);
+          msg_handler = DartLibraryCalls::LookupHandler(entry.port);
           port.AddProperty("handler", msg_handler);
         }
       }
@@ -349,13 +373,15 @@ void PortMap::PrintPortsForMessageHandler(MessageHandler* handler,
 }
 
 void PortMap::DebugDumpForMessageHandler(MessageHandler* handler) {
-  SafepointMutexLocker ml(mutex_);
   Object& msg_handler = Object::Handle();
-  for (intptr_t i = 0; i < capacity_; i++) {
-    if (map_[i].handler == handler) {
-      if (map_[i].state == kLivePort) {
-        OS::PrintErr("Live Port = %" Pd64 "\n", map_[i].port);
-        msg_handler = DartLibraryCalls::LookupHandler(map_[i].port);
+  for (intptr_t s = 0; s < kNumShards; s++) {
+    Shard* shard = &shards_[s];
+    SafepointMutexLocker ml(shard->mutex);
+    for (intptr_t i = 0; i < shard->capacity; i++) {
+      const Entry& entry = shard->map[i];
+      if ((entry.handler == handler) && (entry.state == kLivePort)) {
+        OS::PrintErr("Live Port = %" Pd64 "\n", entry.port);
+        msg_handler = DartLibraryCalls::LookupHandler(entry.port);
         OS::PrintErr("Handler = %s\n", msg_handler.ToCString());
       }
     }
@@ -78,29 +78,47 @@ class PortMap : public AllStatic {
     PortState state;
   } Entry;
 
+  // The ports are spread over independently locked hash maps, so that
+  // operations on different ports rarely contend for the same lock.
+  //
+  // A port always lives in the shard selected by its id, and all operations
+  // on a port hold that shard's lock.
+  typedef struct {
+    // Lock protecting access to this shard.
+    Mutex* mutex;
+    // Hashmap of ports.
+    Entry* map;
+    intptr_t capacity;
+    intptr_t used;
+    intptr_t deleted;
+  } Shard;
+
+  static const intptr_t kNumShards = 16;
+
+  static Shard* ShardOf(Dart_Port port) {
+    // Port ids are random in their low 52 bits (see AllocatePort). Use the
+    // top ones for the shard, and the bottom ones for the slot in the shard.
+    return &shards_[(port >> 48) & (kNumShards - 1)];
+  }
+
   static const char* PortStateString(PortState state);
 
-  // Allocate a new unique port.
+  // Allocate a new random port id. The caller must check that it is unused.
   static Dart_Port AllocatePort();
 
   static bool IsActivePort(Dart_Port id);
   static bool IsLivePort(Dart_Port id);
 
-  static intptr_t FindPort(Dart_Port port);
-  static void Rehash(intptr_t new_capacity);
-
-  static void MaintainInvariants();
+  static intptr_t FindPort(Shard* shard, Dart_Port port);
+  static void Rehash(Shard* shard, intptr_t new_capacity);
 
-  // Lock protecting access to the port map.
-  static Mutex* mutex_;
+  static void MaintainInvariants(Shard* shard);
 
-  // Hashmap of ports.
-  static Entry* map_;
+  static Shard shards_[kNumShards];
   static MessageHandler* deleted_entry_;
-  static intptr_t capacity_;
-  static intptr_t used_;
-  static intptr_t deleted_;
 
+  // Lock protecting prng_.
+  static Mutex* prng_mutex_;
   static Random* prng_;
 };
 
@@ -15,17 +15,19 @@ namespace dart {
 class PortMapTestPeer {
  public:
   static bool IsActivePort(Dart_Port port) {
-    MutexLocker ml(PortMap::mutex_);
-    return (PortMap::FindPort(port) >= 0);
+    PortMap::Shard* shard = PortMap::ShardOf(port);
+    MutexLocker ml(shard->mutex);
+    return (PortMap::FindPort(shard, port) >= 0);
   }
 
   static bool IsLivePort(Dart_Port port) {
-    MutexLocker ml(PortMap::mutex_);
-    intptr_t index = PortMap::FindPort(port);
+    PortMap::Shard* shard = PortMap::ShardOf(port);
+    MutexLocker ml(shard->mutex);
+    intptr_t index = PortMap::FindPort(shard, port);
     if (index < 0) {
       return false;
     }
-    return PortMap::map_[index].state == PortMap::kLivePort;
+    return shard->map[index].state == PortMap::kLivePort;
   }
 };
 
@@ -92,6 +94,31 @@ TEST_CASE(PortMap_CreateManyPorts) {
   }
 }
 
+TEST_CASE(PortMap_CreateAndCloseManyPorts) {
+  // Enough ports to populate every shard and make each of them grow.
+  const intptr_t kNumPorts = 1000;
+  PortTestMessageHandler handler;
+  Dart_Port ports[kNumPorts];
+  for (intptr_t i = 0; i < kNumPorts; i++) {
+    ports[i] = PortMap::CreatePort(&handler);
+  }
+  for (intptr_t i = 0; i < kNumPorts; i++) {
+    EXPECT(PortMapTestPeer::IsActivePort(ports[i]));
+  }
+
+  // Close every other port individually, then the rest at once.
+  for (intptr_t i = 0; i < kNumPorts; i += 2) {
+    EXPECT(PortMap::ClosePort(ports[i]));
+  }
+  for (intptr_t i = 0; i < kNumPorts; i++) {
+    EXPECT_EQ((i % 2) != 0, PortMapTestPeer::IsActivePort(ports[i]));
+  }
+  PortMap::ClosePorts(&handler);
+  for (intptr_t i = 0; i < kNumPorts; i++) {
+    EXPECT(!PortMapTestPeer::IsActivePort(ports[i]));
+  }
+}
+
 TEST_CASE(PortMap_SetPortState) {
   PortTestMessageHandler handler;
 
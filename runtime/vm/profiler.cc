@@ -20,6 +20,7 @@
 #include "vm/os.h"
 #include "vm/profiler.h"
 #include "vm/reusable_handles.h"
+#include "vm/reverse_pc_lookup_cache.h"
 #include "vm/signal_handler.h"
 #include "vm/simulator.h"
 #include "vm/stack_frame.h"
@@ -56,6 +57,17 @@ DEFINE_FLAG(bool,
             profile_vm_allocation,
             false,
             "Collect native stack traces when tracing Dart allocations.");
+DEFINE_FLAG(charp,
+            profile_counter,
+            NULL,
+            "Drive profiler samples from a hardware performance counter "
+            "instead of a timer (Linux only): cycles, instructions, "
+            "cache-misses or branch-misses.");
+DEFINE_FLAG(int,
+            profile_counter_period,
+            0,
+            "Counter events between profiler samples when --profile_counter "
+            "is set. 0 picks a default for the selected counter.");
 
 #ifndef PRODUCT
 
@@ -146,6 +158,21 @@ uword* Sample::GetPCArray() const {
 SampleBuffer::SampleBuffer(intptr_t capacity) {
   ASSERT(Sample::instance_size() > 0);
 
+  // Small buffers, as used in tests, keep single sample blocks.
+  samples_per_block_ = (capacity >= kSamplesPerBlock) ? kSamplesPerBlock : 1;
+  capacity = Utils::RoundDown(capacity, samples_per_block_);
+  num_blocks_ = capacity / samples_per_block_;
+  block_cursor_ = 0;
+  block_ports_ = reinterpret_cast<Dart_Port*>(
+      calloc(num_blocks_, sizeof(*block_ports_)));
+  block_owners_ =
+      reinterpret_cast<Thread**>(calloc(num_blocks_, sizeof(*block_owners_)));
+  if ((block_ports_ == NULL) || (block_owners_ == NULL)) {
+    OUT_OF_MEMORY();
+  }
+  shared_cursor_ = 0;
+  shared_end_ = 0;
+
   const intptr_t size = Utils::RoundUp(capacity * Sample::instance_size(),
                                        VirtualMemory::PageSize());
   const bool kNotExecutable = false;
@@ -170,6 +197,8 @@ AllocationSampleBuffer::AllocationSampleBuffer(intptr_t capacity)
 
 SampleBuffer::~SampleBuffer() {
   delete memory_;
+  free(block_ports_);
+  free(block_owners_);
 }
 
 AllocationSampleBuffer::~AllocationSampleBuffer() {
@@ -183,21 +212,62 @@ Sample* SampleBuffer::At(intptr_t idx) const {
   return reinterpret_cast<Sample*>(samples + offset);
 }
 
-intptr_t SampleBuffer::ReserveSampleSlot() {
+intptr_t SampleBuffer::ReserveSlotInBlock(uintptr_t* cursor,
+                                          uintptr_t* end,
+                                          Dart_Port port,
+                                          Thread* owner) {
   ASSERT(samples_ != NULL);
-  uintptr_t cursor = AtomicOperations::FetchAndIncrement(&cursor_);
+  // The cursor is bumped atomically because a thread can be interrupted for
+  // a CPU sample while it is reserving an allocation sample.
+  uintptr_t slot = AtomicOperations::FetchAndIncrement(cursor);
+  // A thread also moves on when the ring has wrapped around and handed its
+  // block to someone else, or when its block belongs to another buffer.
+  if ((slot >= *end) ||
+      ((owner != NULL) &&
+       (block_owners_[(slot % capacity_) / samples_per_block_] != owner))) {
+    const uintptr_t block =
+        AtomicOperations::FetchAndIncrement(&block_cursor_);
+    const intptr_t block_index = block % num_blocks_;
+    block_ports_[block_index] = port;
+    block_owners_[block_index] = owner;
+    slot = block * samples_per_block_;
+    // Publish the cursor before the end, so that a reservation interrupting
+    // this one never sees the new end together with a stale cursor.
+    *cursor = slot + 1;
+    *end = slot + samples_per_block_;
+  }
   // Map back into sample buffer range.
-  cursor = cursor % capacity_;
-  return cursor;
+  return slot % capacity_;
+}
+
+intptr_t SampleBuffer::ReserveSampleSlot() {
+  return ReserveSlotInBlock(&shared_cursor_, &shared_end_, ILLEGAL_PORT, NULL);
 }
 
 Sample* SampleBuffer::ReserveSample() {
   return At(ReserveSampleSlot());
 }
 
+Sample* SampleBuffer::ReserveSampleForThread(Thread* thread) {
+  ASSERT(thread != NULL);
+  ASSERT(thread->isolate() != NULL);
+  return At(ReserveSlotInBlock(&thread->sample_cursor_, &thread->sample_end_,
+                               thread->isolate()->main_port(), thread));
+}
+
 Sample* SampleBuffer::ReserveSampleAndLink(Sample* previous) {
   ASSERT(previous != NULL);
-  intptr_t next_index = ReserveSampleSlot();
+  // Continue in the block of the thread that reserved |previous|.
+  const intptr_t previous_index =
+      (reinterpret_cast<uint8_t*>(previous) -
+       reinterpret_cast<uint8_t*>(samples_)) /
+      Sample::instance_size();
+  Thread* owner = block_owners_[previous_index / samples_per_block_];
+  intptr_t next_index =
+      (owner != NULL)
+          ? ReserveSlotInBlock(&owner->sample_cursor_, &owner->sample_end_,
+                               previous->port(), owner)
+          : ReserveSampleSlot();
   Sample* next = At(next_index);
   next->Init(previous->port(), previous->timestamp(), previous->tid());
   next->set_head_sample(false);
@@ -1032,7 +1102,7 @@ static Sample* SetupSample(Thread* thread,
   ASSERT(thread != NULL);
   Isolate* isolate = thread->isolate();
   ASSERT(sample_buffer != NULL);
-  Sample* sample = sample_buffer->ReserveSample();
+  Sample* sample = sample_buffer->ReserveSampleForThread(thread);
   sample->Init(isolate->main_port(), OS::GetCurrentMonotonicMicros(), tid);
   uword vm_tag = thread->vm_tag();
 #if defined(USING_SIMULATOR) && !defined(TARGET_ARCH_DBC)
@@ -1271,7 +1341,9 @@ Sample* Profiler::SampleNativeAllocation(intptr_t skip_count,
   return sample;
 }
 
-void Profiler::SampleThreadSingleFrame(Thread* thread, uintptr_t pc) {
+void Profiler::SampleThreadSingleFrame(Thread* thread,
+                                       uintptr_t pc,
+                                       uint64_t counter_value) {
   ASSERT(thread != NULL);
   OSThread* os_thread = thread->os_thread();
   ASSERT(os_thread != NULL);
@@ -1292,6 +1364,8 @@ void Profiler::SampleThreadSingleFrame(Thread* thread, uintptr_t pc) {
     counters->Increment(sample->vm_tag());
   }
 
+  sample->set_counter_value(counter_value);
+
   // Write the single pc value.
   sample->SetAt(0, pc);
 }
@@ -1356,12 +1430,12 @@ void Profiler::SampleThread(Thread* thread,
     if (isolate->IsDeoptimizing()) {
       AtomicOperations::IncrementInt64By(
           &counters_.single_frame_sample_deoptimizing, 1);
-      SampleThreadSingleFrame(thread, pc);
+      SampleThreadSingleFrame(thread, pc, state.counter);
       return;
     }
     if (isolate->compaction_in_progress()) {
       // The Dart stack isn't fully walkable.
-      SampleThreadSingleFrame(thread, pc);
+      SampleThreadSingleFrame(thread, pc, state.counter);
       return;
     }
   }
@@ -1369,7 +1443,7 @@ void Profiler::SampleThread(Thread* thread,
   if (!InitialRegisterCheck(pc, fp, sp)) {
     AtomicOperations::IncrementInt64By(
         &counters_.single_frame_sample_register_check, 1);
-    SampleThreadSingleFrame(thread, pc);
+    SampleThreadSingleFrame(thread, pc, state.counter);
     return;
   }
 
@@ -1380,7 +1454,7 @@ void Profiler::SampleThread(Thread* thread,
     AtomicOperations::IncrementInt64By(
         &counters_.single_frame_sample_get_and_validate_stack_bounds, 1);
     // Could not get stack boundary.
-    SampleThreadSingleFrame(thread, pc);
+    SampleThreadSingleFrame(thread, pc, state.counter);
     return;
   }
 
@@ -1394,6 +1468,7 @@ void Profiler::SampleThread(Thread* thread,
 
   // Setup sample.
   Sample* sample = SetupSample(thread, sample_buffer, os_thread->trace_id());
+  sample->set_counter_value(state.counter);
   // Increment counter for vm tag.
   VMTagCounters* counters = isolate->vm_tag_counters();
   ASSERT(counters != NULL);
@@ -1452,6 +1527,22 @@ class CodeLookupTableBuilder : public ObjectVisitor {
   CodeLookupTable* table_;
 };
 
+// Visits the code of the JIT index, if all code is there, and returns whether
+// it did.
+static bool VisitIndexedCode(Isolate* isolate,
+                             Isolate* vm_isolate,
+                             ObjectVisitor* visitor) {
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  // Bytecode is not indexed.
+  if (!FLAG_enable_interpreter) {
+    vm_isolate->jit_pc_lookup_table()->VisitCode(visitor);
+    isolate->jit_pc_lookup_table()->VisitCode(visitor);
+    return true;
+  }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+  return false;
+}
+
 void CodeLookupTable::Build(Thread* thread) {
   ASSERT(thread != NULL);
   Isolate* isolate = thread->isolate();
@@ -1463,9 +1554,9 @@ void CodeLookupTable::Build(Thread* thread) {
   code_objects_.Clear();
 
   // Add all found Code objects.
-  {
+  CodeLookupTableBuilder cltb(this);
+  if (!VisitIndexedCode(isolate, vm_isolate, &cltb)) {
     HeapIterationScope iteration(thread);
-    CodeLookupTableBuilder cltb(this);
     iteration.IterateVMIsolateObjects(&cltb);
     iteration.IterateOldObjects(&cltb);
   }
@@ -1540,6 +1631,11 @@ ProcessedSampleBuffer* SampleBuffer::BuildProcessedSampleBuffer(
 
   const intptr_t length = capacity();
   for (intptr_t i = 0; i < length; i++) {
+    if (!BlockMayContain(i, filter->port())) {
+      // Another isolate's block.
+      i += samples_per_block_ - 1;
+      continue;
+    }
     Sample* sample = At(i);
     if (sample->ignore_sample()) {
       // Bad sample.
@@ -1591,6 +1687,7 @@ ProcessedSample* SampleBuffer::BuildProcessedSample(
   // Copy state bits from sample.
   processed_sample->set_native_allocation_size_bytes(
       sample->native_allocation_size_bytes());
+  processed_sample->set_counter_value(sample->counter_value());
   processed_sample->set_timestamp(sample->timestamp());
   processed_sample->set_tid(sample->tid());
   processed_sample->set_vm_tag(sample->vm_tag());
@@ -1649,6 +1746,7 @@ ProcessedSample::ProcessedSample()
       user_tag_(0),
       allocation_cid_(-1),
       truncated_(false),
+      counter_value_(0),
       timeline_code_trie_(nullptr),
       timeline_function_trie_(nullptr) {}
 
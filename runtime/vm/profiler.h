@@ -96,7 +96,9 @@ class Profiler : public AllStatic {
   static void DumpStackTrace(uword sp, uword fp, uword pc, bool for_crash);
 
   // Does not walk the thread's stack.
-  static void SampleThreadSingleFrame(Thread* thread, uintptr_t pc);
+  static void SampleThreadSingleFrame(Thread* thread,
+                                      uintptr_t pc,
+                                      uint64_t counter_value);
   static bool initialized_;
 
   static SampleBuffer* sample_buffer_;
@@ -199,6 +201,7 @@ class Sample {
     state_ = 0;
     native_allocation_address_ = 0;
     native_allocation_size_bytes_ = 0;
+    counter_value_ = 0;
     continuation_index_ = -1;
     next_free_ = NULL;
     uword* pcs = GetPCArray();
@@ -316,6 +319,11 @@ class Sample {
     native_allocation_size_bytes_ = size;
   }
 
+  // Hardware counter events on this thread since its previous sample, or 0
+  // when samples are driven by the timer (see --profile_counter).
+  uint64_t counter_value() const { return counter_value_; }
+  void set_counter_value(uint64_t value) { counter_value_ = value; }
+
   Sample* next_free() const { return next_free_; }
   void set_next_free(Sample* next_free) { next_free_ = next_free; }
 
@@ -412,6 +420,7 @@ class Sample {
   uword state_;
   uword native_allocation_address_;
   uintptr_t native_allocation_size_bytes_;
+  uint64_t counter_value_;
   intptr_t continuation_index_;
   Sample* next_free_;
 
@@ -583,10 +592,17 @@ class CodeLookupTable : public ZoneAllocated {
 };
 
 // Ring buffer of Samples that is (usually) shared by many isolates.
+// The buffer is a ring of blocks of consecutive samples. Each thread that
+// takes samples owns a block until it is full, reserving slots in it with an
+// atomic cursor that no other core touches, so the shared cursor is only
+// advanced once per block. Samples reserved without a thread share a block.
+// As all samples in a thread's block come from the same isolate, building a
+// profile for one isolate skips the blocks of the others wholesale.
 class SampleBuffer {
  public:
   // Up to 1 minute @ 1000Hz, less if samples are deep.
   static const intptr_t kDefaultBufferCapacity = 60000;
+  static const intptr_t kSamplesPerBlock = 64;
 
   explicit SampleBuffer(intptr_t capacity = kDefaultBufferCapacity);
   virtual ~SampleBuffer();
@@ -597,11 +613,24 @@ class SampleBuffer {
   intptr_t ReserveSampleSlot();
   virtual Sample* ReserveSample();
   virtual Sample* ReserveSampleAndLink(Sample* previous);
+  // Reserves a sample in |thread|'s own block.
+  Sample* ReserveSampleForThread(Thread* thread);
+
+  // Whether the block holding sample |idx| may have samples for |port|.
+  bool BlockMayContain(intptr_t idx, Dart_Port port) const {
+    const Dart_Port block_port = block_ports_[idx / samples_per_block_];
+    return (block_port == ILLEGAL_PORT) || (block_port == port);
+  }
 
   void VisitSamples(SampleVisitor* visitor) {
     ASSERT(visitor != NULL);
     const intptr_t length = capacity();
     for (intptr_t i = 0; i < length; i++) {
+      if (!BlockMayContain(i, visitor->port())) {
+        // Another isolate's block.
+        i += samples_per_block_ - 1;
+        continue;
+      }
       Sample* sample = At(i);
       if (!sample->head_sample()) {
         // An inner sample in a chain of samples.
@@ -635,11 +664,30 @@ class SampleBuffer {
                                         const CodeLookupTable& clt);
   Sample* Next(Sample* sample);
 
+  // Reserves the next slot of the block tracked by |cursor| and |end|,
+  // moving on to a fresh block for |port| and |owner| when it is full.
+  intptr_t ReserveSlotInBlock(uintptr_t* cursor,
+                              uintptr_t* end,
+                              Dart_Port port,
+                              Thread* owner);
+
   VirtualMemory* memory_;
   Sample* samples_;
   intptr_t capacity_;
   uintptr_t cursor_;
 
+  intptr_t samples_per_block_;
+  intptr_t num_blocks_;
+  // Number of blocks handed out so far.
+  uintptr_t block_cursor_;
+  // The isolate and thread each block was last handed to. ILLEGAL_PORT marks
+  // blocks shared by samples reserved without a thread.
+  Dart_Port* block_ports_;
+  Thread** block_owners_;
+  // The block shared by samples reserved without a thread.
+  uintptr_t shared_cursor_;
+  uintptr_t shared_end_;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(SampleBuffer);
 };
@@ -716,6 +764,9 @@ class ProcessedSample : public ZoneAllocated {
     native_allocation_size_bytes_ = allocation_size;
   }
 
+  uint64_t counter_value() const { return counter_value_; }
+  void set_counter_value(uint64_t value) { counter_value_ = value; }
+
   // Was the stack trace truncated?
   bool truncated() const { return truncated_; }
   void set_truncated(bool truncated) { truncated_ = truncated; }
@@ -760,6 +811,7 @@ class ProcessedSample : public ZoneAllocated {
   bool first_frame_executing_;
   uword native_allocation_address_;
   uintptr_t native_allocation_size_bytes_;
+  uint64_t counter_value_;
   ProfileTrieNode* timeline_code_trie_;
   ProfileTrieNode* timeline_function_trie_;
 
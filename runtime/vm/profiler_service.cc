@@ -21,6 +21,7 @@ namespace dart {
 
 DECLARE_FLAG(int, max_profile_depth);
 DECLARE_FLAG(int, profile_period);
+DECLARE_FLAG(charp, profile_counter);
 DECLARE_FLAG(bool, show_invisible_frames);
 DECLARE_FLAG(bool, profile_vm);
 
@@ -117,7 +118,9 @@ ProfileFunction::ProfileFunction(Kind kind,
       source_position_ticks_(0),
       exclusive_ticks_(0),
       inclusive_ticks_(0),
-      inclusive_serial_(-1) {
+      inclusive_serial_(-1),
+      exclusive_counter_(0),
+      inclusive_counter_(0) {
   ASSERT((kind_ != kDartFunction) || !function_.IsNull());
   ASSERT((kind_ != kDartFunction) || (table_index_ >= 0));
   ASSERT(profile_codes_.length() == 0);
@@ -155,9 +158,11 @@ bool ProfileFunction::is_visible() const {
 
 void ProfileFunction::Tick(bool exclusive,
                            intptr_t inclusive_serial,
-                           TokenPosition token_position) {
+                           TokenPosition token_position,
+                           uint64_t counter_value) {
   if (exclusive) {
     exclusive_ticks_++;
+    exclusive_counter_ += counter_value;
     TickSourcePosition(token_position, exclusive);
   }
   // Fall through and tick inclusive count too.
@@ -167,6 +172,7 @@ void ProfileFunction::Tick(bool exclusive,
   }
   inclusive_serial_ = inclusive_serial;
   inclusive_ticks_++;
+  inclusive_counter_ += counter_value;
   TickSourcePosition(token_position, false);
 }
 
@@ -235,6 +241,10 @@ void ProfileFunction::PrintToJSONArray(JSONArray* functions) {
   obj.AddProperty("kind", KindToCString(kind()));
   obj.AddProperty("inclusiveTicks", inclusive_ticks());
   obj.AddProperty("exclusiveTicks", exclusive_ticks());
+  if (FLAG_profile_counter != NULL) {
+    obj.AddProperty64("_inclusiveCounter", inclusive_counter_);
+    obj.AddProperty64("_exclusiveCounter", exclusive_counter_);
+  }
   if (kind() == kDartFunction) {
     ASSERT(!function_.IsNull());
     obj.AddProperty("function", function_);
@@ -1595,7 +1605,8 @@ class ProfileBuilder : public ValueObject {
         current = ProcessFrame(current, sample_index, sample, frame_index);
       }
 
-      TickExitFrameFunction(sample->vm_tag(), sample_index);
+      TickExitFrameFunction(sample->vm_tag(), sample_index,
+                            sample->counter_value());
 
       // Truncated tag.
       if (sample->truncated()) {
@@ -1750,7 +1761,7 @@ class ProfileBuilder : public ValueObject {
                   sample->At(frame_index));
       }
       function->Tick(IsExecutingFrame(sample, frame_index), sample_index,
-                     token_position);
+                     token_position, sample->counter_value());
     }
     function->AddProfileCode(code_index);
     current = current->GetChild(function->table_index());
@@ -1907,7 +1918,9 @@ class ProfileBuilder : public ValueObject {
     code->Tick(vm_tag, true, serial);
   }
 
-  void TickExitFrameFunction(uword vm_tag, intptr_t serial) {
+  void TickExitFrameFunction(uword vm_tag,
+                             intptr_t serial,
+                             uint64_t counter_value) {
     if (FLAG_profile_vm) {
       return;
     }
@@ -1919,7 +1932,7 @@ class ProfileBuilder : public ValueObject {
     ASSERT(code != NULL);
     ProfileFunction* function = code->function();
     ASSERT(function != NULL);
-    function->Tick(true, serial, TokenPosition::kNoSource);
+    function->Tick(true, serial, TokenPosition::kNoSource, counter_value);
   }
 
   ProfileCodeTrieNode* AppendExitFrame(uword vm_tag,
@@ -2386,6 +2399,9 @@ ProfileTrieNode* Profile::GetTrieRoot(TrieKind trie_kind) {
 
 void Profile::PrintHeaderJSON(JSONObject* obj) {
   obj->AddProperty("samplePeriod", static_cast<intptr_t>(FLAG_profile_period));
+  if (FLAG_profile_counter != NULL) {
+    obj->AddProperty("_counter", FLAG_profile_counter);
+  }
   obj->AddProperty("stackDepth", static_cast<intptr_t>(FLAG_max_profile_depth));
   obj->AddProperty("sampleCount", sample_count());
   obj->AddProperty("timeSpan", MicrosecondsToSeconds(GetTimeSpan()));
@@ -92,9 +92,14 @@ class ProfileFunction : public ZoneAllocated {
 
   void IncInclusiveTicks() { inclusive_ticks_++; }
 
+  uint64_t exclusive_counter() const { return exclusive_counter_; }
+  uint64_t inclusive_counter() const { return inclusive_counter_; }
+
+  // |counter_value| is the sample's hardware counter delta, if any.
   void Tick(bool exclusive,
             intptr_t inclusive_serial,
-            TokenPosition token_position);
+            TokenPosition token_position,
+            uint64_t counter_value);
 
   static const char* KindToCString(Kind kind);
 
@@ -124,6 +129,8 @@ class ProfileFunction : public ZoneAllocated {
   intptr_t exclusive_ticks_;
   intptr_t inclusive_ticks_;
   intptr_t inclusive_serial_;
+  uint64_t exclusive_counter_;
+  uint64_t inclusive_counter_;
 
   void PrintToJSONObject(JSONObject* func);
   // A |ProfileCode| that contains this function.
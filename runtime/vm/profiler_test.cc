@@ -145,6 +145,37 @@ TEST_CASE(Profiler_SampleBufferIterateTest) {
   delete sample_buffer;
 }
 
+TEST_CASE(Profiler_SampleBufferThreadBlocks) {
+  SampleBuffer* sample_buffer =
+      new SampleBuffer(SampleBuffer::kSamplesPerBlock * 4);
+  Dart_Port port = thread->isolate()->main_port();
+  Dart_Port other_port = port + 1;
+
+  // A thread's samples are consecutive in its own block.
+  Sample* first = sample_buffer->ReserveSampleForThread(thread);
+  Sample* second = sample_buffer->ReserveSampleForThread(thread);
+  EXPECT_EQ(Sample::instance_size(), reinterpret_cast<uword>(second) -
+                                         reinterpret_cast<uword>(first));
+  EXPECT(sample_buffer->BlockMayContain(0, port));
+  EXPECT(!sample_buffer->BlockMayContain(0, other_port));
+
+  // Samples reserved without a thread go to a shared block.
+  Sample* shared = sample_buffer->ReserveSample();
+  EXPECT_EQ(SampleBuffer::kSamplesPerBlock * Sample::instance_size(),
+            reinterpret_cast<uword>(shared) - reinterpret_cast<uword>(first));
+  EXPECT(sample_buffer->BlockMayContain(SampleBuffer::kSamplesPerBlock,
+                                        other_port));
+
+  // A full block is replaced by a fresh one.
+  for (intptr_t i = 2; i < SampleBuffer::kSamplesPerBlock; i++) {
+    sample_buffer->ReserveSampleForThread(thread);
+  }
+  Sample* next = sample_buffer->ReserveSampleForThread(thread);
+  EXPECT_EQ(2 * SampleBuffer::kSamplesPerBlock * Sample::instance_size(),
+            reinterpret_cast<uword>(next) - reinterpret_cast<uword>(first));
+  delete sample_buffer;
+}
+
 TEST_CASE(Profiler_AllocationSampleTest) {
   Isolate* isolate = Isolate::Current();
   SampleBuffer* sample_buffer = new SampleBuffer(3);
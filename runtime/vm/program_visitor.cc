@@ -576,6 +576,104 @@ void ProgramVisitor::DedupCodeSourceMaps() {
   ProgramVisitor::VisitFunctions(&visitor);
 }
 
+class ExceptionHandlersKeyValueTrait {
+ public:
+  // Typedefs needed for the DirectChainedHashMap template.
+  typedef const ExceptionHandlers* Key;
+  typedef const ExceptionHandlers* Value;
+  typedef const ExceptionHandlers* Pair;
+
+  static Key KeyOf(Pair kv) { return kv; }
+
+  static Value ValueOf(Pair kv) { return kv; }
+
+  static inline intptr_t Hashcode(Key key) {
+    if (key->num_entries() == 0) return 0;
+    ExceptionHandlerInfo info;
+    key->GetHandlerInfo(0, &info);
+    return key->num_entries() * 31 + info.handler_pc_offset;
+  }
+
+  static inline bool IsKeyEqual(Pair pair, Key key) {
+    if (pair->num_entries() != key->num_entries()) {
+      return false;
+    }
+    ExceptionHandlerInfo pair_info;
+    ExceptionHandlerInfo key_info;
+    for (intptr_t i = 0; i < pair->num_entries(); i++) {
+      pair->GetHandlerInfo(i, &pair_info);
+      key->GetHandlerInfo(i, &key_info);
+      if ((pair_info.handler_pc_offset != key_info.handler_pc_offset) ||
+          (pair_info.outer_try_index != key_info.outer_try_index) ||
+          (pair_info.needs_stacktrace != key_info.needs_stacktrace) ||
+          (pair_info.has_catch_all != key_info.has_catch_all) ||
+          (pair_info.is_generated != key_info.is_generated)) {
+        return false;
+      }
+      // Handled types are canonical, so the lists are compared element-wise
+      // by identity.
+      const Array& pair_types = Array::Handle(pair->GetHandledTypes(i));
+      const Array& key_types = Array::Handle(key->GetHandledTypes(i));
+      if (pair_types.Length() != key_types.Length()) {
+        return false;
+      }
+      for (intptr_t j = 0; j < pair_types.Length(); j++) {
+        if (pair_types.At(j) != key_types.At(j)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+};
+
+typedef DirectChainedHashMap<ExceptionHandlersKeyValueTrait>
+    ExceptionHandlersSet;
+
+void ProgramVisitor::DedupExceptionHandlers() {
+  class DedupExceptionHandlersVisitor : public FunctionVisitor {
+   public:
+    explicit DedupExceptionHandlersVisitor(Zone* zone)
+        : zone_(zone),
+          canonical_handlers_(),
+          code_(Code::Handle(zone)),
+          handlers_(ExceptionHandlers::Handle(zone)) {}
+
+    void Visit(const Function& function) {
+      if (!function.HasCode()) {
+        return;
+      }
+      code_ = function.CurrentCode();
+      handlers_ = code_.exception_handlers();
+      if (handlers_.IsNull() || handlers_.InVMIsolateHeap()) return;
+      handlers_ = DedupExceptionHandler(handlers_);
+      code_.set_exception_handlers(handlers_);
+    }
+
+    RawExceptionHandlers* DedupExceptionHandler(
+        const ExceptionHandlers& handlers) {
+      const ExceptionHandlers* canonical_handlers =
+          canonical_handlers_.LookupValue(&handlers);
+      if (canonical_handlers == NULL) {
+        canonical_handlers_.Insert(
+            &ExceptionHandlers::ZoneHandle(zone_, handlers.raw()));
+        return handlers.raw();
+      } else {
+        return canonical_handlers->raw();
+      }
+    }
+
+   private:
+    Zone* zone_;
+    ExceptionHandlersSet canonical_handlers_;
+    Code& code_;
+    ExceptionHandlers& handlers_;
+  };
+
+  DedupExceptionHandlersVisitor visitor(Thread::Current()->zone());
+  ProgramVisitor::VisitFunctions(&visitor);
+}
+
 class ArrayKeyValueTrait {
  public:
   // Typedefs needed for the DirectChainedHashMap template.
@@ -733,6 +831,7 @@ typedef DirectChainedHashMap<InstructionsKeyValueTrait> InstructionsSet;
 //   * their [RawInstruction]s are bit-wise equal
 //   * their [RawPcDescriptor]s are the same
 //   * their [RawStackMaps]s are the same
+//   * their [RawExceptionHandlers]s are the same
 //   * their static call targets are the same
 #if defined(DART_PRECOMPILER)
 class CodeKeyValueTrait {
@@ -756,13 +855,16 @@ class CodeKeyValueTrait {
     if (pair->static_calls_target_table() != key->static_calls_target_table()) {
       return false;
     }
-    if (pair->pc_descriptors() == key->pc_descriptors()) {
+    if (pair->pc_descriptors() != key->pc_descriptors()) {
+      return false;
+    }
+    if (pair->stackmaps() != key->stackmaps()) {
       return false;
     }
-    if (pair->stackmaps() == key->stackmaps()) {
+    if (pair->exception_handlers() != key->exception_handlers()) {
       return false;
     }
-    if (pair->catch_entry_moves_maps() == key->catch_entry_moves_maps()) {
+    if (pair->catch_entry_moves_maps() != key->catch_entry_moves_maps()) {
       return false;
     }
     return Instructions::Equals(pair->instructions(), key->instructions());
@@ -897,6 +999,7 @@ void ProgramVisitor::Dedup() {
   DedupCatchEntryMovesMaps();
 #endif
   DedupCodeSourceMaps();
+  DedupExceptionHandlers();
   DedupLists();
 
 #if defined(PRODUCT)
@@ -40,6 +40,7 @@ class ProgramVisitor : public AllStatic {
   static void DedupCatchEntryMovesMaps();
 #endif
   static void DedupCodeSourceMaps();
+  static void DedupExceptionHandlers();
   static void DedupLists();
   static void DedupInstructions();
   static void DedupInstructionsWithSameMetadata();
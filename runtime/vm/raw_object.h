@@ -387,6 +387,20 @@ class RawObject {
     return result;
   }
 
+  // Like HeapSize(), but computes the size from a previously loaded header.
+  // The parallel scavenger uses this because the header of a from-space
+  // object may be replaced by a forwarding pointer concurrently.
+  intptr_t HeapSize(uint32_t tags) const {
+    ASSERT(IsHeapObject());
+    intptr_t result = SizeTag::decode(tags);
+    if (result != 0) {
+      return result;
+    }
+    result = HeapSizeFromClass(tags);
+    ASSERT(result > SizeTag::kMaxSizeTag);
+    return result;
+  }
+
   bool Contains(uword addr) const {
     intptr_t this_size = HeapSize();
     uword this_addr = RawObject::ToAddr(this);
@@ -412,6 +426,18 @@ class RawObject {
     uword from = obj_addr + sizeof(RawObject);
     uword to = obj_addr + instance_size - kWordSize;
 
+#if defined(ARCH_IS_64_BIT)
+    if (has_unboxed_fields_) {
+      const uint32_t unboxed_fields_bitmap =
+          UnboxedFieldsBitmapAt(visitor->isolate(), class_id);
+      if (unboxed_fields_bitmap != 0) {
+        VisitPointersSkippingUnboxedFields(visitor, obj_addr, to,
+                                           unboxed_fields_bitmap);
+        return instance_size;
+      }
+    }
+#endif
+
     // Call visitor function virtually
     visitor->VisitPointers(reinterpret_cast<RawObject**>(from),
                            reinterpret_cast<RawObject**>(to));
@@ -433,6 +459,18 @@ class RawObject {
     uword from = obj_addr + sizeof(RawObject);
     uword to = obj_addr + instance_size - kWordSize;
 
+#if defined(ARCH_IS_64_BIT)
+    if (has_unboxed_fields_) {
+      const uint32_t unboxed_fields_bitmap =
+          UnboxedFieldsBitmapAt(visitor->isolate(), class_id);
+      if (unboxed_fields_bitmap != 0) {
+        VisitPointersSkippingUnboxedFields(visitor, obj_addr, to,
+                                           unboxed_fields_bitmap);
+        return instance_size;
+      }
+    }
+#endif
+
     // Call visitor function non-virtually
     visitor->V::VisitPointers(reinterpret_cast<RawObject**>(from),
                               reinterpret_cast<RawObject**>(to));
@@ -454,6 +492,10 @@ class RawObject {
     return CanonicalBit::decode(value);
   }
 
+  // Called once a class with unboxed fields is added to a class table. Until
+  // then the pointer visitors need not look up which words to skip.
+  static void set_has_unboxed_fields() { has_unboxed_fields_ = true; }
+
   // Class Id predicates.
   static bool IsErrorClassId(intptr_t index);
   static bool IsNumberClassId(intptr_t index);
@@ -473,6 +515,7 @@ class RawObject {
   static bool IsFfiTypeDoubleClassId(intptr_t index);
   static bool IsFfiTypeVoidClassId(intptr_t index);
   static bool IsFfiTypeNativeFunctionClassId(intptr_t index);
+  static bool IsFfiTypeByValueClassId(intptr_t index);
   static bool IsFfiDynamicLibraryClassId(intptr_t index);
   static bool IsFfiClassId(intptr_t index);
   static bool IsInternalVMdefinedClassId(intptr_t index);
@@ -499,10 +542,39 @@ class RawObject {
                                         kHeapObjectTag);
   }
 
+  static bool has_unboxed_fields_;
+  static uint32_t UnboxedFieldsBitmapAt(Isolate* isolate, intptr_t class_id);
+
+  // Visits the pointers of the instance at [obj_addr] up to [to], skipping
+  // the words which the bitmap marks as holding unboxed fields.
+  template <class V>
+  static void VisitPointersSkippingUnboxedFields(V* visitor,
+                                                 uword obj_addr,
+                                                 uword to,
+                                                 uint32_t unboxed_fields) {
+    RawObject** first =
+        reinterpret_cast<RawObject**>(obj_addr + sizeof(RawObject));
+    RawObject** last = reinterpret_cast<RawObject**>(to);
+    intptr_t index = sizeof(RawObject) / kWordSize;
+    RawObject** run = first;
+    for (RawObject** p = first; p <= last; ++p, ++index) {
+      if ((index < kBitsPerInt32) && ((unboxed_fields >> index) & 1) != 0) {
+        if (run < p) {
+          visitor->VisitPointers(run, p - 1);
+        }
+        run = p + 1;
+      }
+    }
+    if (run <= last) {
+      visitor->VisitPointers(run, last);
+    }
+  }
+
   intptr_t VisitPointersPredefined(ObjectPointerVisitor* visitor,
                                    intptr_t class_id);
 
-  intptr_t HeapSizeFromClass() const;
+  intptr_t HeapSizeFromClass() const { return HeapSizeFromClass(ptr()->tags_); }
+  intptr_t HeapSizeFromClass(uint32_t tags) const;
 
   intptr_t GetClassId() const {
     uint32_t tags = ptr()->tags_;
@@ -696,7 +768,8 @@ class RawObject {
   friend class RawTypedData;
   friend class RawTypedDataView;
   friend class Scavenger;
-  friend class ScavengerVisitor;
+  template <bool>
+  friend class ScavengerVisitorBase;
   friend class SizeExcludingClassVisitor;  // GetClassId
   friend class InstanceAccumulator;        // GetClassId
   friend class RetainingPathVisitor;       // GetClassId
@@ -808,6 +881,7 @@ class RawClass : public RawObject {
   int16_t num_type_arguments_;  // Number of type arguments in flattened vector.
   uint16_t num_native_fields_;
   uint32_t state_bits_;
+  uint32_t unboxed_fields_bitmap_;  // Words holding unboxed fields.
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
   typedef BitField<uint32_t, bool, 0, 1> IsDeclaredInBytecode;
@@ -1052,6 +1126,10 @@ class RawFfiTrampolineData : public RawObject {
   // Will be 0 for non-callbacks. Check 'callback_target_' to determine if this
   // is a callback or not.
   uint32_t callback_id_;
+
+  // Whether Dart -> native calls skip the safepoint transition and the exit
+  // frame. Always false for callbacks.
+  bool is_leaf_;
 };
 
 class RawField : public RawObject {
@@ -1215,6 +1293,7 @@ class RawLibrary : public RawObject {
 
   Dart_NativeEntryResolver native_entry_resolver_;  // Resolves natives.
   Dart_NativeEntrySymbol native_entry_symbol_resolver_;
+  Dart_FfiNativeResolver ffi_native_resolver_;  // Resolves leaf natives.
   classid_t index_;       // Library id number.
   uint16_t num_imports_;  // Number of entries in imports_.
   int8_t load_state_;     // Of type LibraryState.
@@ -1792,7 +1871,10 @@ class RawMegamorphicCache : public RawObject {
   RawSmi* mask_;
   RawString* target_name_;     // Name of target function.
   RawArray* args_descriptor_;  // Arguments descriptor.
-  VISIT_TO(RawObject*, args_descriptor_)
+  // In AOT, the global dispatch table if it has a row for this selector.
+  RawArray* dispatch_table_;
+  RawSmi* dispatch_table_row_;  // Offset of the selector's row in the table.
+  VISIT_TO(RawObject*, dispatch_table_row_)
   RawObject** to_snapshot(Snapshot::Kind kind) { return to(); }
 
   int32_t filled_entry_count_;
@@ -1892,10 +1974,8 @@ class RawTypeArguments : public RawInstance {
 
   VISIT_FROM(RawObject*, instantiations_)
   // The instantiations_ array remains empty for instantiated type arguments.
-  RawArray* instantiations_;  // Array of paired canonical vectors:
-                              // Even index: instantiator.
-                              // Odd index: instantiated (without bound error).
-  // Instantiations leading to bound errors do not get cached.
+  // See TypeArguments::kMaxLinearInstantiations for its layout.
+  RawArray* instantiations_;
   RawSmi* length_;
   RawSmi* hash_;
 
@@ -2244,7 +2324,8 @@ class RawTypedDataView : public RawTypedDataBase {
   friend class ObjectPoolSerializationCluster;
   friend class RawObjectPool;
   friend class GCCompactor;
-  friend class ScavengerVisitor;
+  template <bool>
+  friend class ScavengerVisitorBase;
   friend class SnapshotReader;
 };
 
@@ -2297,6 +2378,7 @@ class RawArray : public RawInstance {
   friend class Object;
   friend class ICData;            // For high performance access.
   friend class SubtypeTestCache;  // For high performance access.
+  friend class TypeArguments;     // For high performance access.
 
   friend class HeapPage;
 };
@@ -2496,7 +2578,10 @@ class RawRegExp : public RawInstance {
   } two_byte_sticky_;
   RawFunction* external_one_byte_sticky_function_;
   RawFunction* external_two_byte_sticky_function_;
-  VISIT_TO(RawObject*, external_two_byte_sticky_function_)
+  // Literal text every match starts with, or null. See
+  // RegExpEngine::LiteralPrefix.
+  RawString* literal_prefix_;
+  VISIT_TO(RawObject*, literal_prefix_)
   RawObject** to_snapshot(Snapshot::Kind kind) { return to(); }
 
   // The same pattern may use different amount of registers if compiled
@@ -2530,7 +2615,8 @@ class RawWeakProperty : public RawInstance {
   template <bool>
   friend class MarkingVisitorBase;
   friend class Scavenger;
-  friend class ScavengerVisitor;
+  template <bool>
+  friend class ScavengerVisitorBase;
 };
 
 // MirrorReferences are used by mirrors to hold reflectees that are VM
@@ -2706,6 +2792,10 @@ inline bool RawObject::IsFfiTypeNativeFunctionClassId(intptr_t index) {
   return index == kFfiNativeFunctionCid;
 }
 
+inline bool RawObject::IsFfiTypeByValueClassId(intptr_t index) {
+  return index == kFfiByValueCid;
+}
+
 inline bool RawObject::IsFfiClassId(intptr_t index) {
   return (index >= kFfiPointerCid && index <= kFfiVoidCid);
 }
@@ -128,6 +128,8 @@ namespace dart {
   F(MegamorphicCache, mask_)                                                   \
   F(MegamorphicCache, target_name_)                                            \
   F(MegamorphicCache, args_descriptor_)                                        \
+  F(MegamorphicCache, dispatch_table_)                                         \
+  F(MegamorphicCache, dispatch_table_row_)                                     \
   F(SubtypeTestCache, cache_)                                                  \
   F(ApiError, message_)                                                        \
   F(LanguageError, previous_error_)                                            \
@@ -190,6 +192,7 @@ namespace dart {
   F(RegExp, external_two_byte_function_)                                       \
   F(RegExp, external_one_byte_sticky_function_)                                \
   F(RegExp, external_two_byte_sticky_function_)                                \
+  F(RegExp, literal_prefix_)                                                   \
   F(WeakProperty, key_)                                                        \
   F(WeakProperty, value_)                                                      \
   F(MirrorReference, referent_)                                                \
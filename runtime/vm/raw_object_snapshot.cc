@@ -863,6 +863,14 @@ RawTwoByteString* TwoByteString::ReadFrom(SnapshotReader* reader,
   return raw(str_obj);
 }
 
+// This function's name can appear in Observatory.
+static void IsolateMessageExternalStringFinalizer(
+    void* isolate_callback_data,
+    Dart_WeakPersistentHandle handle,
+    void* buffer) {
+  free(buffer);
+}
+
 template <typename T>
 static void StringWriteTo(SnapshotWriter* writer,
                           intptr_t object_id,
@@ -877,6 +885,28 @@ static void StringWriteTo(SnapshotWriter* writer,
   // Write out the serialization header value for this object.
   writer->WriteInlinedObjectHeader(object_id);
 
+  const intptr_t bytes = len * sizeof(T);
+  if ((kind == Snapshot::kMessage) && !RawObject::IsCanonical(tags) &&
+      (bytes >= kMinMessageExternalStringBytes)) {
+    // Write as external.
+    writer->WriteIndexedObject(class_id == kOneByteStringCid
+                                   ? kExternalOneByteStringCid
+                                   : kExternalTwoByteStringCid);
+    writer->WriteTags(tags);
+    writer->Write<RawObject*>(length);
+    void* passed_data = malloc(bytes);
+    if (passed_data == NULL) {
+      OUT_OF_MEMORY();
+    }
+    memmove(passed_data, data, bytes);
+    static_cast<MessageWriter*>(writer)->finalizable_data()->Put(
+        bytes,
+        passed_data,  // data
+        passed_data,  // peer,
+        IsolateMessageExternalStringFinalizer);
+    return;
+  }
+
   // Write out the class and tags information.
   writer->WriteIndexedObject(class_id);
   writer->WriteTags(tags);
@@ -918,8 +948,20 @@ RawExternalOneByteString* ExternalOneByteString::ReadFrom(
     intptr_t tags,
     Snapshot::Kind kind,
     bool as_reference) {
-  UNREACHABLE();
-  return ExternalOneByteString::null();
+  // Only large strings in isolate messages are written as external.
+  ASSERT(kind == Snapshot::kMessage);
+  intptr_t len = reader->ReadSmiValue();
+
+  FinalizableData finalizable_data =
+      static_cast<MessageSnapshotReader*>(reader)->finalizable_data()->Take();
+  const uint8_t* data = reinterpret_cast<uint8_t*>(finalizable_data.data);
+  String& str_obj = String::ZoneHandle(
+      reader->zone(),
+      ExternalOneByteString::New(data, len, finalizable_data.peer,
+                                 len * sizeof(uint8_t),
+                                 finalizable_data.callback, Heap::kNew));
+  reader->AddBackRef(object_id, &str_obj, kIsDeserialized);
+  return reinterpret_cast<RawExternalOneByteString*>(str_obj.raw());
 }
 
 RawExternalTwoByteString* ExternalTwoByteString::ReadFrom(
@@ -928,15 +970,28 @@ RawExternalTwoByteString* ExternalTwoByteString::ReadFrom(
     intptr_t tags,
     Snapshot::Kind kind,
     bool as_reference) {
-  UNREACHABLE();
-  return ExternalTwoByteString::null();
+  // Only large strings in isolate messages are written as external.
+  ASSERT(kind == Snapshot::kMessage);
+  intptr_t len = reader->ReadSmiValue();
+
+  FinalizableData finalizable_data =
+      static_cast<MessageSnapshotReader*>(reader)->finalizable_data()->Take();
+  const uint16_t* data = reinterpret_cast<uint16_t*>(finalizable_data.data);
+  String& str_obj = String::ZoneHandle(
+      reader->zone(),
+      ExternalTwoByteString::New(data, len, finalizable_data.peer,
+                                 len * sizeof(uint16_t),
+                                 finalizable_data.callback, Heap::kNew));
+  reader->AddBackRef(object_id, &str_obj, kIsDeserialized);
+  return reinterpret_cast<RawExternalTwoByteString*>(str_obj.raw());
 }
 
 void RawExternalOneByteString::WriteTo(SnapshotWriter* writer,
                                        intptr_t object_id,
                                        Snapshot::Kind kind,
                                        bool as_reference) {
-  // Serialize as a non-external one byte string.
+  // Serialize as a one byte string, which is only external in messages if
+  // it is large.
   StringWriteTo(writer, object_id, kind, kOneByteStringCid,
                 writer->GetObjectTags(this), ptr()->length_,
                 ptr()->external_data_);
@@ -946,7 +1001,8 @@ void RawExternalTwoByteString::WriteTo(SnapshotWriter* writer,
                                        intptr_t object_id,
                                        Snapshot::Kind kind,
                                        bool as_reference) {
-  // Serialize as a non-external two byte string.
+  // Serialize as a two byte string, which is only external in messages if
+  // it is large.
   StringWriteTo(writer, object_id, kind, kTwoByteStringCid,
                 writer->GetObjectTags(this), ptr()->length_,
                 ptr()->external_data_);
@@ -1643,17 +1699,35 @@ RawTransferableTypedData* TransferableTypedData::ReadFrom(
   ASSERT(reader != nullptr);
 
   ASSERT(!Snapshot::IsFull(kind));
-  const intptr_t length = reader->Read<int32_t>();
-
-  const FinalizableData finalizable_data =
-      static_cast<MessageSnapshotReader*>(reader)->finalizable_data()->Take();
-  uint8_t* data = reinterpret_cast<uint8_t*>(finalizable_data.data);
+  const intptr_t num_chunks = reader->Read<int32_t>();
+  ASSERT(num_chunks > 0);
+
+  MessageFinalizableData* finalizable_data =
+      static_cast<MessageSnapshotReader*>(reader)->finalizable_data();
+  uint8_t** chunks = reader->zone()->Alloc<uint8_t*>(num_chunks);
+  intptr_t* chunk_lengths = reader->zone()->Alloc<intptr_t>(num_chunks);
+  for (intptr_t i = 0; i < num_chunks; i++) {
+    chunk_lengths[i] = reader->Read<int32_t>();
+    chunks[i] = reinterpret_cast<uint8_t*>(finalizable_data->Take().data);
+  }
   auto& transferableTypedData = TransferableTypedData::ZoneHandle(
-      reader->zone(), TransferableTypedData::New(data, length));
+      reader->zone(),
+      TransferableTypedData::New(
+          new TransferableTypedDataPeer(chunks, chunk_lengths, num_chunks)));
   reader->AddBackRef(object_id, &transferableTypedData, kIsDeserialized);
   return transferableTypedData.raw();
 }
 
+// Invoked on successful serialization of the message.
+static void TransferableTypedDataWritten(void* data,
+                                         Dart_WeakPersistentHandle handle,
+                                         void* peer) {
+  TransferableTypedDataPeer* tpeer =
+      reinterpret_cast<TransferableTypedDataPeer*>(peer);
+  tpeer->handle()->EnsureFreeExternal(Isolate::Current());
+  tpeer->ClearData();
+}
+
 void RawTransferableTypedData::WriteTo(SnapshotWriter* writer,
                                        intptr_t object_id,
                                        Snapshot::Kind kind,
@@ -1665,9 +1739,7 @@ void RawTransferableTypedData::WriteTo(SnapshotWriter* writer,
   ASSERT(peer != nullptr);
   TransferableTypedDataPeer* tpeer =
       reinterpret_cast<TransferableTypedDataPeer*>(peer);
-  intptr_t length = tpeer->length();  // In bytes.
-  void* data = tpeer->data();
-  if (data == nullptr) {
+  if (!tpeer->HasData()) {
     writer->SetWriteException(
         Exceptions::kArgument,
         "Illegal argument in isolate message"
@@ -1680,20 +1752,20 @@ void RawTransferableTypedData::WriteTo(SnapshotWriter* writer,
 
   writer->WriteIndexedObject(GetClassId());
   writer->WriteTags(writer->GetObjectTags(this));
-  writer->Write<int32_t>(length);
-
-  static_cast<MessageWriter*>(writer)->finalizable_data()->Put(
-      length, data, tpeer,
-      // Finalizer does nothing - in case of failure to serialize,
-      // [data] remains wrapped in sender's [TransferableTypedData].
-      [](void* data, Dart_WeakPersistentHandle handle, void* peer) {},
-      // This is invoked on successful serialization of the message
-      [](void* data, Dart_WeakPersistentHandle handle, void* peer) {
-        TransferableTypedDataPeer* tpeer =
-            reinterpret_cast<TransferableTypedDataPeer*>(peer);
-        tpeer->handle()->EnsureFreeExternal(Isolate::Current());
-        tpeer->ClearData();
-      });
+  // Scattered content is passed on as is, one finalizable record per chunk.
+  const intptr_t num_chunks = tpeer->num_chunks();
+  writer->Write<int32_t>(num_chunks);
+  for (intptr_t i = 0; i < num_chunks; i++) {
+    const intptr_t length = tpeer->chunk_length(i);  // In bytes.
+    writer->Write<int32_t>(length);
+    static_cast<MessageWriter*>(writer)->finalizable_data()->Put(
+        length, tpeer->chunk_data(i), tpeer,
+        // Finalizer does nothing - in case of failure to serialize,
+        // [data] remains wrapped in sender's [TransferableTypedData].
+        [](void* data, Dart_WeakPersistentHandle handle, void* peer) {},
+        // The peer gives up its content once, with the first chunk.
+        (i == 0) ? &TransferableTypedDataWritten : nullptr);
+  }
 }
 
 RawRegExp* RegExp::ReadFrom(SnapshotReader* reader,
@@ -1715,6 +1787,8 @@ RawRegExp* RegExp::ReadFrom(SnapshotReader* reader,
   regex.set_capture_name_map(*reader->ArrayHandle());
   *reader->StringHandle() ^= reader->ReadObjectImpl(kAsInlinedObject);
   regex.set_pattern(*reader->StringHandle());
+  *reader->StringHandle() ^= reader->ReadObjectImpl(kAsInlinedObject);
+  regex.set_literal_prefix(*reader->StringHandle());
 
   regex.StoreNonPointer(&regex.raw_ptr()->num_one_byte_registers_,
                         reader->Read<int32_t>());
@@ -1747,7 +1821,9 @@ void RawRegExp::WriteTo(SnapshotWriter* writer,
 
   // Write out all the other fields.
   writer->Write<RawObject*>(ptr()->num_bracket_expressions_);
+  writer->WriteObjectImpl(ptr()->capture_name_map_, kAsInlinedObject);
   writer->WriteObjectImpl(ptr()->pattern_, kAsInlinedObject);
+  writer->WriteObjectImpl(ptr()->literal_prefix_, kAsInlinedObject);
   writer->Write<int32_t>(ptr()->num_one_byte_registers_);
   writer->Write<int32_t>(ptr()->num_two_byte_registers_);
   writer->Write<int8_t>(ptr()->type_flags_);
@@ -5549,6 +5549,112 @@ static void CreateSpecializedFunction(Thread* thread,
   // The function is compiled lazily during the first call.
 }
 
+// Appends the characters of [atom] to [prefix]. Returns false if the atom
+// cannot be part of a literal prefix.
+static bool AppendLiteralAtom(RegExpAtom* atom,
+                              GrowableArray<uint16_t>* prefix) {
+  if (atom->ignore_case()) return false;
+  for (intptr_t i = 0; i < atom->length(); i++) {
+    const uint16_t c = atom->data()->At(i);
+    // In unicode mode a match must not start inside a surrogate pair.
+    if (Utf16::IsLeadSurrogate(c) || Utf16::IsTrailSurrogate(c)) return false;
+    prefix->Add(c);
+  }
+  return true;
+}
+
+RawString* RegExpEngine::LiteralPrefix(RegExpCompileData* data,
+                                       RegExpFlags flags) {
+  if (flags.IgnoreCase() || data->tree == NULL) {
+    return String::null();
+  }
+  GrowableArray<RegExpTree*> terms;
+  if (data->tree->IsAlternative()) {
+    ZoneGrowableArray<RegExpTree*>* nodes = data->tree->AsAlternative()->nodes();
+    for (intptr_t i = 0; i < nodes->length(); i++) {
+      terms.Add(nodes->At(i));
+    }
+  } else {
+    terms.Add(data->tree);
+  }
+
+  // Collect the atoms at the start of the pattern, up to the first term which
+  // is not a literal.
+  GrowableArray<uint16_t> prefix;
+  for (intptr_t i = 0; i < terms.length(); i++) {
+    RegExpTree* term = terms[i];
+    bool is_literal = true;
+    if (term->IsAtom()) {
+      is_literal = AppendLiteralAtom(term->AsAtom(), &prefix);
+    } else if (term->IsText()) {
+      GrowableArray<TextElement>* elements = term->AsText()->elements();
+      for (intptr_t j = 0; is_literal && j < elements->length(); j++) {
+        const TextElement& element = elements->At(j);
+        is_literal = element.text_type() == TextElement::ATOM &&
+                     AppendLiteralAtom(element.atom(), &prefix);
+      }
+    } else {
+      is_literal = false;
+    }
+    if (!is_literal) break;
+  }
+
+  if (prefix.length() < kMinLiteralPrefixLength) {
+    return String::null();
+  }
+  return String::FromUTF16(prefix.data(), prefix.length(), Heap::kOld);
+}
+
+template <typename Char>
+static intptr_t FindLiteralPrefixIn(const Char* subject,
+                                    intptr_t subject_length,
+                                    const String& prefix,
+                                    intptr_t start_index) {
+  const intptr_t prefix_length = prefix.Length();
+  const uint16_t first = prefix.CharAt(0);
+  const intptr_t last_start = subject_length - prefix_length;
+  for (intptr_t i = start_index; i <= last_start; i++) {
+    if (sizeof(Char) == 1) {
+      // memchr is vectorized by the C library, so it skips long stretches
+      // without a candidate much faster than comparing each character.
+      if (first > 0xff) return -1;
+      const void* found =
+          memchr(subject + i, first, last_start - i + 1);
+      if (found == NULL) return -1;
+      i = reinterpret_cast<const Char*>(found) - subject;
+    } else if (subject[i] != first) {
+      continue;
+    }
+    intptr_t j = 1;
+    while (j < prefix_length && subject[i + j] == prefix.CharAt(j)) {
+      j++;
+    }
+    if (j == prefix_length) return i;
+  }
+  return -1;
+}
+
+intptr_t RegExpEngine::FindLiteralPrefix(const String& subject,
+                                         const String& prefix,
+                                         intptr_t start_index) {
+  NoSafepointScope no_safepoint;
+  const intptr_t length = subject.Length();
+  if (subject.IsOneByteString()) {
+    return FindLiteralPrefixIn(OneByteString::DataStart(subject), length,
+                               prefix, start_index);
+  } else if (subject.IsExternalOneByteString()) {
+    return FindLiteralPrefixIn(ExternalOneByteString::DataStart(subject),
+                               length, prefix, start_index);
+  } else if (subject.IsTwoByteString()) {
+    return FindLiteralPrefixIn(TwoByteString::DataStart(subject), length,
+                               prefix, start_index);
+  } else {
+    ASSERT(subject.IsExternalTwoByteString());
+    return FindLiteralPrefixIn(ExternalTwoByteString::DataStart(subject),
+                               length, prefix, start_index);
+  }
+}
+
 RawRegExp* RegExpEngine::CreateRegExp(Thread* thread,
                                       const String& pattern,
                                       RegExpFlags flags) {
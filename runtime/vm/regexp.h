@@ -1517,6 +1517,19 @@ class RegExpEngine : public AllStatic {
                                  const String& pattern,
                                  RegExpFlags flags);
 
+  // Returns the literal text every match of the parsed pattern starts with,
+  // or null if it is shorter than kMinLiteralPrefixLength.
+  static RawString* LiteralPrefix(RegExpCompileData* data, RegExpFlags flags);
+
+  // Returns the first index at or after [start_index] at which [subject]
+  // contains [prefix], or -1 if there is none.
+  static intptr_t FindLiteralPrefix(const String& subject,
+                                    const String& prefix,
+                                    intptr_t start_index);
+
+  // Shorter prefixes are too frequent to make scanning for them worthwhile.
+  static const intptr_t kMinLiteralPrefixLength = 2;
+
   static void DotPrint(const char* label, RegExpNode* node, bool ignore_case);
 };
 
@@ -9,6 +9,7 @@
 #include "vm/regexp.h"
 #include "vm/regexp_assembler.h"
 #include "vm/regexp_assembler_bytecode_inl.h"
+#include "vm/regexp_bytecode_cache.h"
 #include "vm/regexp_bytecodes.h"
 #include "vm/regexp_interpreter.h"
 #include "vm/regexp_parser.h"
@@ -450,13 +451,34 @@ static intptr_t Prepare(const RegExp& regexp,
       regexp.set_is_complex();
     }
 
-    RegExpEngine::CompilationResult result = RegExpEngine::CompileBytecode(
-        compile_data, regexp, is_one_byte, sticky, zone);
-    ASSERT(result.bytecode != NULL);
+    // Other isolates of the group may have compiled the same pattern already.
+    IsolateGroupSource* source = Isolate::Current()->source();
+    RegExpBytecodeCache* cache =
+        source != nullptr ? &source->regexp_bytecode_cache : nullptr;
+    const int flags = regexp.flags().value();
+    intptr_t num_registers = -1;
+    TypedData& bytecode = TypedData::Handle(zone);
+    if (cache != nullptr) {
+      bytecode =
+          cache->Lookup(pattern, flags, is_one_byte, sticky, &num_registers);
+    }
+    if (bytecode.IsNull()) {
+      RegExpEngine::CompilationResult result = RegExpEngine::CompileBytecode(
+          compile_data, regexp, is_one_byte, sticky, zone);
+      ASSERT(result.bytecode != NULL);
+      bytecode = result.bytecode->raw();
+      num_registers = result.num_registers;
+      if (cache != nullptr) {
+        NoSafepointScope no_safepoint;
+        cache->Insert(pattern, flags, is_one_byte, sticky,
+                      reinterpret_cast<uint8_t*>(bytecode.DataAddr(0)),
+                      bytecode.LengthInBytes(), num_registers);
+      }
+    }
     ASSERT(regexp.num_registers(is_one_byte) == -1 ||
-           regexp.num_registers(is_one_byte) == result.num_registers);
-    regexp.set_num_registers(is_one_byte, result.num_registers);
-    regexp.set_bytecode(is_one_byte, sticky, *(result.bytecode));
+           regexp.num_registers(is_one_byte) == num_registers);
+    regexp.set_num_registers(is_one_byte, num_registers);
+    regexp.set_bytecode(is_one_byte, sticky, bytecode);
   }
 
   ASSERT(regexp.num_registers(is_one_byte) != -1);
@@ -500,6 +522,12 @@ static IrregexpInterpreter::IrregexpResult ExecRaw(const RegExp& regexp,
     // Copy capture results to the start of the registers array.
     memmove(output, raw_output, number_of_capture_registers * sizeof(int32_t));
   }
+  if (result == IrregexpInterpreter::RE_BACKTRACK_LIMIT) {
+    Exceptions::ThrowUnsupportedError(
+        "Regular expression exceeded the backtracking limit "
+        "(--regexp_backtrack_limit).");
+    UNREACHABLE();
+  }
   if (result == IrregexpInterpreter::RE_EXCEPTION) {
     Thread* thread = Thread::Current();
     Isolate* isolate = thread->isolate();
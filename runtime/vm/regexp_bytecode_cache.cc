@@ -0,0 +1,105 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/regexp_bytecode_cache.h"
+
+#include "vm/flags.h"
+#include "vm/lockers.h"
+#include "vm/object.h"
+
+namespace dart {
+
+DEFINE_FLAG(int,
+            regexp_bytecode_cache_size,
+            256,
+            "Maximum number of compiled regexps shared between the isolates "
+            "of an isolate group (0 disables sharing).");
+
+RegExpBytecodeCache::RegExpBytecodeCache()
+    : mutex_(NOT_IN_PRODUCT("RegExpBytecodeCache::mutex_")), entries_() {}
+
+RegExpBytecodeCache::~RegExpBytecodeCache() {
+  for (intptr_t i = 0; i < entries_.length(); i++) {
+    free(entries_[i]->pattern);
+    free(entries_[i]->bytecode);
+    delete entries_[i];
+  }
+}
+
+RegExpBytecodeCache::Entry* RegExpBytecodeCache::FindLocked(
+    const String& pattern,
+    int flags,
+    bool is_one_byte,
+    bool sticky) const {
+  const intptr_t hash = pattern.Hash();
+  for (intptr_t i = 0; i < entries_.length(); i++) {
+    Entry* entry = entries_[i];
+    if (entry->hash == hash && entry->flags == flags &&
+        entry->is_one_byte == is_one_byte && entry->sticky == sticky &&
+        pattern.Equals(entry->pattern, entry->pattern_length)) {
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+RawTypedData* RegExpBytecodeCache::Lookup(const String& pattern,
+                                          int flags,
+                                          bool is_one_byte,
+                                          bool sticky,
+                                          intptr_t* num_registers) {
+  if (FLAG_regexp_bytecode_cache_size <= 0) {
+    return TypedData::null();
+  }
+  Entry* entry;
+  {
+    MutexLocker ml(&mutex_);
+    entry = FindLocked(pattern, flags, is_one_byte, sticky);
+  }
+  if (entry == nullptr) {
+    return TypedData::null();
+  }
+  // Entries are never changed or freed while isolates of the group are alive,
+  // so the copy can be made without holding the lock.
+  const TypedData& bytecode = TypedData::Handle(
+      TypedData::New(kTypedDataUint8ArrayCid, entry->bytecode_length));
+  {
+    NoSafepointScope no_safepoint;
+    memmove(bytecode.DataAddr(0), entry->bytecode, entry->bytecode_length);
+  }
+  *num_registers = entry->num_registers;
+  return bytecode.raw();
+}
+
+void RegExpBytecodeCache::Insert(const String& pattern,
+                                 int flags,
+                                 bool is_one_byte,
+                                 bool sticky,
+                                 const uint8_t* bytecode,
+                                 intptr_t bytecode_length,
+                                 intptr_t num_registers) {
+  MutexLocker ml(&mutex_);
+  if (entries_.length() >= FLAG_regexp_bytecode_cache_size ||
+      FindLocked(pattern, flags, is_one_byte, sticky) != nullptr) {
+    return;
+  }
+  Entry* entry = new Entry();
+  entry->hash = pattern.Hash();
+  entry->pattern_length = pattern.Length();
+  entry->pattern = reinterpret_cast<uint16_t*>(
+      malloc(entry->pattern_length * sizeof(uint16_t)));
+  for (intptr_t i = 0; i < entry->pattern_length; i++) {
+    entry->pattern[i] = pattern.CharAt(i);
+  }
+  entry->flags = flags;
+  entry->is_one_byte = is_one_byte;
+  entry->sticky = sticky;
+  entry->bytecode = reinterpret_cast<uint8_t*>(malloc(bytecode_length));
+  memmove(entry->bytecode, bytecode, bytecode_length);
+  entry->bytecode_length = bytecode_length;
+  entry->num_registers = num_registers;
+  entries_.Add(entry);
+}
+
+}  // namespace dart
@@ -0,0 +1,73 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_REGEXP_BYTECODE_CACHE_H_
+#define RUNTIME_VM_REGEXP_BYTECODE_CACHE_H_
+
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+#include "vm/os_thread.h"
+
+namespace dart {
+
+class RawTypedData;
+class String;
+
+// Caches the irregexp bytecode compiled by one isolate of an isolate group, so
+// that other isolates of the group compiling the same pattern can copy the
+// bytecode instead of compiling it again.
+//
+// Entries are keyed by pattern, flags, subject width and stickiness. They are
+// immutable and are only freed when the cache is deleted together with its
+// [IsolateGroupSource].
+class RegExpBytecodeCache {
+ public:
+  RegExpBytecodeCache();
+  ~RegExpBytecodeCache();
+
+  // Returns a copy of the cached bytecode in the current isolate's heap and
+  // sets [num_registers], or returns null if the bytecode is not cached.
+  RawTypedData* Lookup(const String& pattern,
+                       int flags,
+                       bool is_one_byte,
+                       bool sticky,
+                       intptr_t* num_registers);
+
+  // Adds [bytecode] to the cache unless it is full or already has an entry
+  // for the same key.
+  void Insert(const String& pattern,
+              int flags,
+              bool is_one_byte,
+              bool sticky,
+              const uint8_t* bytecode,
+              intptr_t bytecode_length,
+              intptr_t num_registers);
+
+ private:
+  struct Entry {
+    intptr_t hash;
+    uint16_t* pattern;
+    intptr_t pattern_length;
+    int flags;
+    bool is_one_byte;
+    bool sticky;
+    uint8_t* bytecode;
+    intptr_t bytecode_length;
+    intptr_t num_registers;
+  };
+
+  Entry* FindLocked(const String& pattern,
+                    int flags,
+                    bool is_one_byte,
+                    bool sticky) const;
+
+  Mutex mutex_;
+  MallocGrowableArray<Entry*> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(RegExpBytecodeCache);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_REGEXP_BYTECODE_CACHE_H_
@@ -16,6 +16,11 @@
 namespace dart {
 
 DEFINE_FLAG(bool, trace_regexp_bytecodes, false, "trace_regexp_bytecodes");
+DEFINE_FLAG(int,
+            regexp_backtrack_limit,
+            0,
+            "Maximum number of backtracks of a single interpreted regexp match "
+            "before it is aborted with an UnsupportedError (0 is unlimited).");
 
 typedef unibrow::Mapping<unibrow::Ecma262Canonicalize> Canonicalize;
 
@@ -158,6 +163,10 @@ static IrregexpInterpreter::IrregexpResult RawMatch(const uint8_t* code_base,
   intptr_t* backtrack_stack_base = backtrack_stack.data();
   intptr_t* backtrack_sp = backtrack_stack_base;
   intptr_t backtrack_stack_space = backtrack_stack.max_size();
+  // Counts down to zero when a backtrack limit is set, stays negative if not.
+  intptr_t backtracks_left = FLAG_regexp_backtrack_limit > 0
+                                 ? FLAG_regexp_backtrack_limit
+                                 : -1;
 
   // TODO(zerny): Optimize as single instance. V8 has this as an
   // isolate member.
@@ -232,6 +241,10 @@ static IrregexpInterpreter::IrregexpResult RawMatch(const uint8_t* code_base,
       pc += BC_POP_CP_LENGTH;
       break;
       BYTECODE(POP_BT)
+      if (backtracks_left == 0) {
+        return IrregexpInterpreter::RE_BACKTRACK_LIMIT;
+      }
+      backtracks_left--;
       backtrack_stack_space++;
       --backtrack_sp;
       pc = code_base + *backtrack_sp;
@@ -15,7 +15,13 @@ namespace dart {
 
 class IrregexpInterpreter : public AllStatic {
  public:
-  enum IrregexpResult { RE_FAILURE = 0, RE_SUCCESS = 1, RE_EXCEPTION = -1 };
+  enum IrregexpResult {
+    RE_FAILURE = 0,
+    RE_SUCCESS = 1,
+    RE_EXCEPTION = -1,
+    // The match backtracked more often than --regexp_backtrack_limit allows.
+    RE_BACKTRACK_LIMIT = -2,
+  };
 
   static IrregexpResult Match(const TypedData& bytecode,
                               const String& subject,
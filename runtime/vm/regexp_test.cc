@@ -8,6 +8,8 @@
 #include "vm/object.h"
 #include "vm/regexp.h"
 #include "vm/regexp_assembler_ir.h"
+#include "vm/regexp_bytecode_cache.h"
+#include "vm/regexp_parser.h"
 #include "vm/unit_test.h"
 
 namespace dart {
@@ -110,4 +112,72 @@ ISOLATE_UNIT_TEST_CASE(RegExp_ExternalTwoByteString) {
   EXPECT_EQ(3, smi_2.Value());
 }
 
+ISOLATE_UNIT_TEST_CASE(RegExp_BytecodeCache) {
+  RegExpBytecodeCache cache;
+  const String& pat = String::Handle(String::New("a+b"));
+  const String& other = String::Handle(String::New("a+c"));
+  const uint8_t bytecode[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  intptr_t num_registers = -1;
+
+  EXPECT(cache.Lookup(pat, 0, true, false, &num_registers) ==
+         TypedData::null());
+  cache.Insert(pat, 0, true, false, bytecode, ARRAY_SIZE(bytecode), 3);
+
+  const TypedData& copy = TypedData::Handle(
+      cache.Lookup(pat, 0, true, false, &num_registers));
+  EXPECT(!copy.IsNull());
+  EXPECT_EQ(3, num_registers);
+  EXPECT_EQ(static_cast<intptr_t>(ARRAY_SIZE(bytecode)), copy.LengthInBytes());
+  EXPECT_EQ(8, copy.GetUint8(7));
+
+  // The key includes the flags, the subject width and stickiness.
+  EXPECT(cache.Lookup(other, 0, true, false, &num_registers) ==
+         TypedData::null());
+  EXPECT(cache.Lookup(pat, 1, true, false, &num_registers) ==
+         TypedData::null());
+  EXPECT(cache.Lookup(pat, 0, false, false, &num_registers) ==
+         TypedData::null());
+  EXPECT(cache.Lookup(pat, 0, true, true, &num_registers) ==
+         TypedData::null());
+}
+
+static RawString* LiteralPrefix(const char* pattern, RegExpFlags flags) {
+  RegExpCompileData data;
+  RegExpParser::ParseRegExp(String::Handle(String::New(pattern)), flags,
+                            &data);
+  return RegExpEngine::LiteralPrefix(&data, flags);
+}
+
+ISOLATE_UNIT_TEST_CASE(RegExp_LiteralPrefix) {
+  String& prefix = String::Handle();
+  prefix = LiteralPrefix("ERROR: (\\d+)", RegExpFlags());
+  EXPECT(!prefix.IsNull());
+  EXPECT(prefix.Equals("ERROR: "));
+  prefix = LiteralPrefix("abc", RegExpFlags());
+  EXPECT(prefix.Equals("abc"));
+
+  // Too short, not at the start, case insensitive or anchored.
+  EXPECT(LiteralPrefix("a[bc]", RegExpFlags()) == String::null());
+  EXPECT(LiteralPrefix("(abc)", RegExpFlags()) == String::null());
+  EXPECT(LiteralPrefix("abc|def", RegExpFlags()) == String::null());
+  EXPECT(LiteralPrefix("^abc", RegExpFlags()) == String::null());
+  RegExpFlags ignore_case;
+  ignore_case.SetIgnoreCase();
+  EXPECT(LiteralPrefix("abc", ignore_case) == String::null());
+
+  const String& subject =
+      String::Handle(String::New("xx ERROR; ERROR: 42 ERROR: 7"));
+  prefix = String::New("ERROR: ");
+  EXPECT_EQ(10, RegExpEngine::FindLiteralPrefix(subject, prefix, 0));
+  EXPECT_EQ(10, RegExpEngine::FindLiteralPrefix(subject, prefix, 10));
+  EXPECT_EQ(20, RegExpEngine::FindLiteralPrefix(subject, prefix, 11));
+  EXPECT_EQ(-1, RegExpEngine::FindLiteralPrefix(subject, prefix, 21));
+
+  const uint16_t two_byte_chars[] = {0x1234, 'a', 'b', 0x1234, 'a', 'b', 'c'};
+  const String& two_byte = String::Handle(String::FromUTF16(
+      two_byte_chars, ARRAY_SIZE(two_byte_chars)));
+  prefix = String::New("abc");
+  EXPECT_EQ(4, RegExpEngine::FindLiteralPrefix(two_byte, prefix, 0));
+}
+
 }  // namespace dart
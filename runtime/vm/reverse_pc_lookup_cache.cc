@@ -4,7 +4,9 @@
 
 #include "vm/reverse_pc_lookup_cache.h"
 
+#include "platform/atomic.h"
 #include "vm/isolate.h"
+#include "vm/visitor.h"
 
 namespace dart {
 
@@ -53,4 +55,130 @@ void ReversePcLookupCache::BuildAndAttachToIsolate(Isolate* isolate) {
 
 #endif  // defined(DART_PRECOMPILED_RUNTIME)
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+JitReversePcLookupTable::JitReversePcLookupTable()
+    : mutex_(NOT_IN_PRODUCT("JitReversePcLookupTable::mutex_")),
+      sorted_(NewEntries(0)),
+      recent_(NewEntries(kRecentCapacity)),
+      retired_() {}
+
+JitReversePcLookupTable::~JitReversePcLookupTable() {
+  free(sorted_);
+  free(recent_);
+  for (intptr_t i = 0; i < retired_.length(); i++) {
+    free(retired_[i]);
+  }
+}
+
+JitReversePcLookupTable::Entries* JitReversePcLookupTable::NewEntries(
+    intptr_t capacity) {
+  Entries* entries = reinterpret_cast<Entries*>(
+      malloc(sizeof(Entries) + capacity * sizeof(Entry)));
+  entries->length = 0;
+  return entries;
+}
+
+int JitReversePcLookupTable::CompareEntries(const Entry* a, const Entry* b) {
+  return (a->start < b->start) ? -1 : ((a->start > b->start) ? 1 : 0);
+}
+
+void JitReversePcLookupTable::Add(RawCode* code) {
+  RawInstructions* instructions = Code::InstructionsOf(code);
+  Entry entry;
+  entry.start = Instructions::PayloadStart(instructions);
+  entry.end = entry.start + Instructions::Size(instructions);
+  entry.code = code;
+
+  MutexLocker ml(&mutex_);
+  intptr_t length = recent_->length;
+  if (length == kRecentCapacity) {
+    const intptr_t sorted_length = sorted_->length;
+    Entries* sorted = NewEntries(sorted_length + length);
+    memmove(sorted->entries, sorted_->entries, sorted_length * sizeof(Entry));
+    memmove(sorted->entries + sorted_length, recent_->entries,
+            length * sizeof(Entry));
+    sorted->length = sorted_length + length;
+    qsort(sorted->entries, sorted->length, sizeof(Entry),
+          reinterpret_cast<int (*)(const void*, const void*)>(CompareEntries));
+    retired_.Add(sorted_);
+    retired_.Add(recent_);
+    AtomicOperations::StoreRelease(&sorted_, sorted);
+    AtomicOperations::StoreRelease(&recent_, NewEntries(kRecentCapacity));
+    length = 0;
+  }
+  recent_->entries[length] = entry;
+  AtomicOperations::StoreRelease(&recent_->length, length + 1);
+}
+
+RawCode* JitReversePcLookupTable::Lookup(uword pc) const {
+  Entries* recent = AtomicOperations::LoadAcquire(&recent_);
+  const intptr_t recent_length = AtomicOperations::LoadAcquire(&recent->length);
+  for (intptr_t i = 0; i < recent_length; i++) {
+    const Entry& entry = recent->entries[i];
+    if ((entry.start <= pc) && (pc < entry.end)) {
+      return entry.code;
+    }
+  }
+
+  // Find the last entry starting at or before pc.
+  Entries* sorted = AtomicOperations::LoadAcquire(&sorted_);
+  intptr_t first = 0;
+  intptr_t count = sorted->length;
+  while (count > 0) {
+    const intptr_t step = count / 2;
+    if (sorted->entries[first + step].start <= pc) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  if ((first > 0) && (pc < sorted->entries[first - 1].end)) {
+    return sorted->entries[first - 1].code;
+  }
+  return Code::null();
+}
+
+void JitReversePcLookupTable::VisitCode(ObjectVisitor* visitor) {
+  MutexLocker ml(&mutex_);
+  for (intptr_t i = 0; i < sorted_->length; i++) {
+    visitor->VisitObject(sorted_->entries[i].code);
+  }
+  for (intptr_t i = 0; i < recent_->length; i++) {
+    visitor->VisitObject(recent_->entries[i].code);
+  }
+}
+
+void JitReversePcLookupTable::VisitPointers(ObjectPointerVisitor* visitor) {
+  for (intptr_t i = 0; i < sorted_->length; i++) {
+    visitor->VisitPointer(
+        reinterpret_cast<RawObject**>(&sorted_->entries[i].code));
+  }
+  for (intptr_t i = 0; i < recent_->length; i++) {
+    visitor->VisitPointer(
+        reinterpret_cast<RawObject**>(&recent_->entries[i].code));
+  }
+}
+
+void JitReversePcLookupTable::RemoveCleared() {
+  // No lookups run at a safepoint, so the arrays can be changed in place.
+  Entries* arrays[] = {sorted_, recent_};
+  for (Entries* entries : arrays) {
+    intptr_t length = 0;
+    for (intptr_t i = 0; i < entries->length; i++) {
+      if (entries->entries[i].code != Code::null()) {
+        entries->entries[length++] = entries->entries[i];
+      }
+    }
+    entries->length = length;
+  }
+  for (intptr_t i = 0; i < retired_.length(); i++) {
+    free(retired_[i]);
+  }
+  retired_.Clear();
+}
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 }  // namespace dart
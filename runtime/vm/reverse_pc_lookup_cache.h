@@ -9,10 +9,13 @@
 #include "vm/growable_array.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
+#include "vm/os_thread.h"
 
 namespace dart {
 
 class Isolate;
+class ObjectPointerVisitor;
+class ObjectVisitor;
 
 #if defined(DART_PRECOMPILED_RUNTIME)
 
@@ -121,6 +124,72 @@ class ReversePcLookupCache {
 
 #endif  // defined(DART_PRECOMPILED_RUNTIME
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+// An index from pcs to the JIT compiled [Code] objects of an isolate, kept up
+// to date as code is installed and collected, so that looking up the code of
+// a pc does not need to walk the heap.
+//
+// Lookups take no lock. The entries are split between a sorted array and a
+// small array of the entries added since it was built, which additions fill
+// in place and merge into a new sorted array once full. Both arrays are
+// published with release stores, the sorted one first, so a lookup that
+// reads the recent array first always sees an entry in one of them.
+//
+// The [Code] objects are weakly referenced: the marker drops the entries of
+// dead code and the compactor forwards the others (instructions are never
+// moved). Replaced arrays are freed then, as no lookup can be running while
+// the GC holds all threads at a safepoint; callers must therefore not be at
+// a safepoint themselves.
+class JitReversePcLookupTable {
+ public:
+  JitReversePcLookupTable();
+  ~JitReversePcLookupTable();
+
+  // Indexes the instructions of [code], which must not be moved anymore.
+  void Add(RawCode* code);
+
+  // Returns the [Code] whose instructions contain [pc], or null if there is
+  // none in the index.
+  RawCode* Lookup(uword pc) const;
+
+  // Calls [visitor] with the [Code] objects in the index.
+  void VisitCode(ObjectVisitor* visitor);
+
+  // Visits the [Code] pointers of the index for the GC, which may clear or
+  // forward them. Must be followed by [RemoveCleared] at the same safepoint.
+  void VisitPointers(ObjectPointerVisitor* visitor);
+  void RemoveCleared();
+
+ private:
+  struct Entry {
+    uword start;
+    uword end;
+    RawCode* code;
+  };
+
+  struct Entries {
+    intptr_t length;
+    Entry entries[1];
+  };
+
+  static const intptr_t kRecentCapacity = 64;
+
+  static Entries* NewEntries(intptr_t capacity);
+  static int CompareEntries(const Entry* a, const Entry* b);
+
+  // Protects additions.
+  Mutex mutex_;
+  Entries* sorted_;
+  Entries* recent_;
+  // Arrays replaced since the last GC.
+  MallocGrowableArray<Entries*> retired_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitReversePcLookupTable);
+};
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_REVERSE_PC_LOOKUP_CACHE_H_
@@ -79,6 +79,10 @@ DEFINE_FLAG(bool,
             unopt_monomorphic_calls,
             true,
             "Enable specializing monomorphic calls from unoptimized code.");
+DEFINE_FLAG(bool,
+            opt_monomorphic_calls,
+            false,
+            "Enable specializing monomorphic calls from optimized code.");
 DEFINE_FLAG(bool,
             unopt_megamorphic_calls,
             false,
@@ -640,43 +644,28 @@ static void UpdateTypeTestCache(
          instance_parent_function_type_arguments.IsCanonical());
   ASSERT(instance_delayed_type_arguments.IsNull() ||
          instance_delayed_type_arguments.IsCanonical());
-  auto& last_instance_class_id_or_function = Object::Handle(zone);
-  auto& last_instance_type_arguments = TypeArguments::Handle(zone);
-  auto& last_instantiator_type_arguments = TypeArguments::Handle(zone);
-  auto& last_function_type_arguments = TypeArguments::Handle(zone);
-  auto& last_instance_parent_function_type_arguments =
-      TypeArguments::Handle(zone);
-  auto& last_instance_delayed_type_arguments = TypeArguments::Handle(zone);
   Bool& last_result = Bool::Handle(zone);
-  for (intptr_t i = 0; i < len; ++i) {
-    new_cache.GetCheck(
-        i, &last_instance_class_id_or_function, &last_instance_type_arguments,
-        &last_instantiator_type_arguments, &last_function_type_arguments,
-        &last_instance_parent_function_type_arguments,
-        &last_instance_delayed_type_arguments, &last_result);
-    if ((last_instance_class_id_or_function.raw() ==
-         instance_class_id_or_function.raw()) &&
-        (last_instance_type_arguments.raw() == instance_type_arguments.raw()) &&
-        (last_instantiator_type_arguments.raw() ==
-         instantiator_type_arguments.raw()) &&
-        (last_function_type_arguments.raw() == function_type_arguments.raw()) &&
-        (last_instance_parent_function_type_arguments.raw() ==
-         instance_parent_function_type_arguments.raw()) &&
-        (last_instance_delayed_type_arguments.raw() ==
-         instance_delayed_type_arguments.raw())) {
-      OS::PrintErr("  Error in test cache %p ix: %" Pd ",", new_cache.raw(), i);
-      PrintTypeCheck(" duplicate cache entry", instance, type,
-                     instantiator_type_arguments, function_type_arguments,
-                     result);
-      UNREACHABLE();
-      return;
-    }
+  if (new_cache.LookupCheck(instance_class_id_or_function,
+                            instance_type_arguments,
+                            instantiator_type_arguments,
+                            function_type_arguments,
+                            instance_parent_function_type_arguments,
+                            instance_delayed_type_arguments, &last_result)) {
+    OS::PrintErr("  Error in test cache %p,", new_cache.raw());
+    PrintTypeCheck(" duplicate cache entry", instance, type,
+                   instantiator_type_arguments, function_type_arguments,
+                   result);
+    UNREACHABLE();
+    return;
   }
 #endif
   new_cache.AddCheck(instance_class_id_or_function, instance_type_arguments,
                      instantiator_type_arguments, function_type_arguments,
                      instance_parent_function_type_arguments,
                      instance_delayed_type_arguments, result);
+  if (len + 1 == FLAG_max_subtype_cache_entries) {
+    SubtypeTestCache::IncrementNumFullCaches();
+  }
   if (FLAG_trace_type_checks) {
     AbstractType& test_type = AbstractType::Handle(zone, type.raw());
     if (!test_type.IsInstantiated()) {
@@ -787,6 +776,11 @@ DEFINE_RUNTIME_ENTRY(TypeCheck, 7) {
                    instantiator_type_arguments, function_type_arguments,
                    Bool::Get(is_instance_of));
   }
+#if !defined(PRODUCT)
+  if (FLAG_dump_type_check_stats) {
+    isolate->type_check_stats()->Record(dst_type);
+  }
+#endif  // !defined(PRODUCT)
   if (!is_instance_of) {
     // Throw a dynamic type error.
     const TokenPosition location = GetCallerLocation();
@@ -1084,6 +1078,41 @@ RawFunction* InlineCacheMissHelper(const Instance& receiver,
   return result.raw();
 }
 
+#if !defined(DART_PRECOMPILED_RUNTIME) && !defined(TARGET_ARCH_DBC)
+static RawICData* FindICDataForInstanceCall(Zone* zone,
+                                            const Code& code,
+                                            uword pc) {
+  uword pc_offset = pc - code.PayloadStart();
+  const PcDescriptors& descriptors =
+      PcDescriptors::Handle(zone, code.pc_descriptors());
+  PcDescriptors::Iterator iter(descriptors, RawPcDescriptors::kIcCall);
+  intptr_t deopt_id = -1;
+  while (iter.MoveNext()) {
+    if (iter.PcOffset() == pc_offset) {
+      deopt_id = iter.DeoptId();
+      break;
+    }
+  }
+  ASSERT(deopt_id != -1);
+  Function& function = Function::Handle(zone, code.function());
+  if (code.is_optimized()) {
+    // The ICData of a call inlined into optimized code belongs to the
+    // function it was inlined from.
+    GrowableArray<const Function*> functions;
+    GrowableArray<TokenPosition> token_positions;
+    code.GetInlinedFunctionsAtReturnAddress(pc_offset, &functions,
+                                            &token_positions);
+    if (functions.length() > 0) {
+      function = functions.Last()->raw();
+    }
+    if (function.ic_data_array() == Array::null()) {
+      return ICData::null();
+    }
+  }
+  return function.FindICData(deopt_id);
+}
+#endif  // !defined(DART_PRECOMPILED_RUNTIME) && !defined(TARGET_ARCH_DBC)
+
 static void TrySwitchInstanceCall(const ICData& ic_data,
                                   const Function& target_function) {
 #if !defined(TARGET_ARCH_DBC) && !defined(DART_PRECOMPILED_RUNTIME)
@@ -1106,11 +1135,18 @@ static void TrySwitchInstanceCall(const ICData& ic_data,
   StackFrame* caller_frame = iterator.NextFrame();
   ASSERT(caller_frame->IsDartFrame());
 
-  // Monomorphic/megamorphic calls are only for unoptimized code.
+  // Monomorphic/megamorphic calls are only for unoptimized code, and
+  // monomorphic calls for optimized code with --opt_monomorphic_calls.
   if (caller_frame->is_interpreted()) return;
   Zone* zone = thread->zone();
   const Code& caller_code = Code::Handle(zone, caller_frame->LookupDartCode());
-  if (caller_code.is_optimized()) return;
+  const bool is_optimized = caller_code.is_optimized();
+  if (is_optimized && !FLAG_opt_monomorphic_calls) return;
+
+#if !defined(PRODUCT)
+  // Breakpoints are patched into IC calls, which switching would overwrite.
+  if (caller_code.HasBreakpoint()) return;
+#endif
 
   // Code is detached from its function. This will prevent us from resetting
   // the switchable call later because resets are function based and because
@@ -1119,7 +1155,14 @@ static void TrySwitchInstanceCall(const ICData& ic_data,
   // probably through a race between foreground and background compilation.
   const Function& caller_function =
       Function::Handle(zone, caller_code.function());
-  if (caller_function.unoptimized_code() != caller_code.raw()) {
+  if (is_optimized) {
+    // Optimized code is not reset, but a miss in the monomorphic state must
+    // find the ICData of the call again.
+    if (FindICDataForInstanceCall(zone, caller_code, caller_frame->pc()) !=
+        ic_data.raw()) {
+      return;
+    }
+  } else if (caller_function.unoptimized_code() != caller_code.raw()) {
     return;
   }
 
@@ -1147,8 +1190,9 @@ static void TrySwitchInstanceCall(const ICData& ic_data,
     return;  // Success.
   }
 
-  // Megamorphic call.
-  if (FLAG_unopt_megamorphic_calls &&
+  // Megamorphic call. Optimized code calls megamorphic sites through the
+  // megamorphic cache already.
+  if (FLAG_unopt_megamorphic_calls && !is_optimized &&
       (num_checks > FLAG_max_polymorphic_checks)) {
     const MegamorphicCache& cache =
         MegamorphicCache::Handle(zone, ic_data.AsMegamorphicCache());
@@ -1547,26 +1591,6 @@ DEFINE_RUNTIME_ENTRY(UnlinkedCall, 3) {
 #endif  // !DBC
 }
 
-#if !defined(DART_PRECOMPILED_RUNTIME) && !defined(TARGET_ARCH_DBC)
-static RawICData* FindICDataForInstanceCall(Zone* zone,
-                                            const Code& code,
-                                            uword pc) {
-  uword pc_offset = pc - code.PayloadStart();
-  const PcDescriptors& descriptors =
-      PcDescriptors::Handle(zone, code.pc_descriptors());
-  PcDescriptors::Iterator iter(descriptors, RawPcDescriptors::kIcCall);
-  intptr_t deopt_id = -1;
-  while (iter.MoveNext()) {
-    if (iter.PcOffset() == pc_offset) {
-      deopt_id = iter.DeoptId();
-      break;
-    }
-  }
-  ASSERT(deopt_id != -1);
-  return Function::Handle(zone, code.function()).FindICData(deopt_id);
-}
-#endif  // !defined(DART_PRECOMPILED_RUNTIME) && !defined(TARGET_ARCH_DBC)
-
 // Handle a miss of a megamorphic cache.
 //   Arg1: Receiver.
 //   Arg0: continuation Code (out parameter).
@@ -1669,13 +1693,37 @@ DEFINE_RUNTIME_ENTRY(MonomorphicMiss, 2) {
   ASSERT(caller_frame->IsDartFrame());
   ASSERT(!caller_frame->is_interpreted());
   const Code& caller_code = Code::Handle(zone, caller_frame->LookupDartCode());
-  ASSERT(!caller_code.is_optimized());
+  ASSERT(!caller_code.is_optimized() || FLAG_opt_monomorphic_calls);
 
-  const ICData& ic_data = ICData::Handle(
+  ICData& ic_data = ICData::Handle(
       zone, FindICDataForInstanceCall(zone, caller_code, caller_frame->pc()));
+  if (ic_data.IsNull() && caller_code.is_optimized()) {
+    // The unoptimized code of the function the call was inlined from has
+    // been dropped with its ICData. Start over from the monomorphic target.
+    Object& data = Object::Handle(zone);
+    const Code& old_target_code = Code::Handle(
+        zone, CodePatcher::GetInstanceCallAt(caller_frame->pc(), caller_code,
+                                             &data));
+    const Function& old_target =
+        Function::Handle(zone, old_target_code.function());
+    const String& name = String::Handle(zone, old_target.name());
+    const Array& descriptor =
+        Array::Handle(zone, ArgumentsDescriptor::New(
+                                /*type_args_len=*/0,
+                                old_target.num_fixed_parameters()));
+    ic_data = ICData::New(Function::Handle(zone, caller_code.function()), name,
+                          descriptor, DeoptId::kNone, 1, /* args_tested */
+                          ICData::kInstance);
+    const Smi& old_expected_cid =
+        Smi::Handle(zone, Smi::RawCast(Array::Cast(data).At(0)));
+    ic_data.AddReceiverCheck(old_expected_cid.Value(), old_target);
+  }
   RELEASE_ASSERT(!ic_data.IsNull());
 
   ASSERT(ic_data.NumArgsTested() == 1);
+  // Optimized callers continue through the unoptimized IC stubs too, since
+  // the optimized ones expect the function to count in a register the miss
+  // stub does not preserve.
   const Code& stub = ic_data.is_tracking_exactness()
                          ? StubCode::OneArgCheckInlineCacheWithExactnessCheck()
                          : StubCode::OneArgCheckInlineCache();
@@ -2407,7 +2455,8 @@ DEFINE_RUNTIME_ENTRY(FixCallersTarget, 0) {
 #endif
 }
 
-// The caller must be a monomorphic call from unoptimized code.
+// The caller must be a monomorphic call from unoptimized code, or from
+// optimized code with --opt_monomorphic_calls.
 // Patch call to point to new target.
 DEFINE_RUNTIME_ENTRY(FixCallersTargetMonomorphic, 0) {
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -2426,7 +2475,7 @@ DEFINE_RUNTIME_ENTRY(FixCallersTargetMonomorphic, 0) {
   }
   ASSERT(frame->IsDartFrame());
   const Code& caller_code = Code::Handle(zone, frame->LookupDartCode());
-  RELEASE_ASSERT(!caller_code.is_optimized());
+  RELEASE_ASSERT(!caller_code.is_optimized() || FLAG_opt_monomorphic_calls);
 
   Object& cache = Object::Handle(zone);
   const Code& old_target_code = Code::Handle(
@@ -3020,4 +3069,23 @@ DEFINE_RAW_LEAF_RUNTIME_ENTRY(
     false /* is_float */,
     reinterpret_cast<RuntimeFunction>(&DLRT_VerifyCallbackIsolate));
 
+// Called from the intrinsics of _getTraceClock and _getThreadCpuClock.
+extern "C" int64_t DLRT_TimelineGetTraceClock() {
+  return OS::GetCurrentMonotonicMicros();
+}
+DEFINE_RAW_LEAF_RUNTIME_ENTRY(
+    TimelineGetTraceClock,
+    0,
+    false /* is_float */,
+    reinterpret_cast<RuntimeFunction>(&DLRT_TimelineGetTraceClock));
+
+extern "C" int64_t DLRT_TimelineGetThreadCpuClock() {
+  return OS::GetCurrentThreadCPUMicros();
+}
+DEFINE_RAW_LEAF_RUNTIME_ENTRY(
+    TimelineGetThreadCpuClock,
+    0,
+    false /* is_float */,
+    reinterpret_cast<RuntimeFunction>(&DLRT_TimelineGetThreadCpuClock));
+
 }  // namespace dart
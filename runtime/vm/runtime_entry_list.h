@@ -86,7 +86,9 @@ namespace dart {
     RawSmi*)                                                                   \
   V(void, EnterSafepoint)                                                      \
   V(void, ExitSafepoint)                                                       \
-  V(void, VerifyCallbackIsolate, int32_t, uword)
+  V(void, VerifyCallbackIsolate, int32_t, uword)                               \
+  V(int64_t, TimelineGetTraceClock)                                            \
+  V(int64_t, TimelineGetThreadCpuClock)
 
 }  // namespace dart
 
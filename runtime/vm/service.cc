@@ -13,6 +13,7 @@
 
 #include "platform/unicode.h"
 #include "vm/base64.h"
+#include "vm/compiler/compiler_pass.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/cpu.h"
 #include "vm/dart_api_impl.h"
@@ -20,9 +21,11 @@
 #include "vm/dart_api_state.h"
 #include "vm/dart_entry.h"
 #include "vm/debugger.h"
+#include "vm/deopt_instructions.h"
 #include "vm/heap/safepoint.h"
 #include "vm/isolate.h"
 #include "vm/kernel_isolate.h"
+#include "vm/lock_profiler.h"
 #include "vm/lockers.h"
 #include "vm/malloc_hooks.h"
 #include "vm/message.h"
@@ -47,6 +50,7 @@
 #include "vm/timeline.h"
 #include "vm/type_table.h"
 #include "vm/version.h"
+#include "vm/virtual_memory.h"
 
 namespace dart {
 
@@ -3938,6 +3942,74 @@ static bool GetAllocationSamples(Thread* thread, JSONStream* js) {
   return true;
 }
 
+static const MethodParameter* get_heap_sample_profile_params[] = {
+    RUNNABLE_ISOLATE_PARAMETER,
+    NULL,
+};
+
+static bool GetHeapSampleProfile(Thread* thread, JSONStream* js) {
+  thread->isolate()->heap()->PrintHeapSampleProfileJSON(js);
+  return true;
+}
+
+static const MethodParameter* get_gc_pause_histograms_params[] = {
+    ISOLATE_PARAMETER,
+    NULL,
+};
+
+static bool GetGCPauseHistograms(Thread* thread, JSONStream* js) {
+  thread->isolate()->heap()->PrintPauseHistogramsJSON(js);
+  return true;
+}
+
+static const MethodParameter* get_compiler_pass_stats_params[] = {
+    ISOLATE_PARAMETER,
+    NULL,
+};
+
+static bool GetCompilerPassStats(Thread* thread, JSONStream* js) {
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  CompilerPassStats* stats = thread->isolate()->compiler_pass_stats();
+  if (stats != NULL) {
+    stats->PrintJSON(js);
+    return true;
+  }
+#endif
+  js->PrintError(kFeatureDisabled,
+                 "Compiler pass statistics are only collected with "
+                 "--dump_compiler_pass_stats.");
+  return true;
+}
+
+static const MethodParameter* get_deoptimization_stats_params[] = {
+    ISOLATE_PARAMETER,
+    NULL,
+};
+
+static bool GetDeoptimizationStats(Thread* thread, JSONStream* js) {
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  thread->isolate()->deopt_stats()->PrintJSON(js);
+#else
+  js->PrintError(kFeatureDisabled,
+                 "Deoptimization is not supported in precompiled mode.");
+#endif
+  return true;
+}
+
+static const MethodParameter* get_lock_contention_profile_params[] = {
+    NO_ISOLATE_PARAMETER,
+    new BoolParameter("reset", false),
+    NULL,
+};
+
+static bool GetLockContentionProfile(Thread* thread, JSONStream* js) {
+  LockProfiler::PrintJSON(js);
+  if (BoolParameter::Parse(js->LookupParam("reset"), false)) {
+    LockProfiler::Reset();
+  }
+  return true;
+}
+
 static const MethodParameter* get_native_allocation_samples_params[] = {
     NO_ISOLATE_PARAMETER,
     new EnumParameter("tags", true, tags_enum_names),
@@ -4081,20 +4153,19 @@ static bool RequestHeapSnapshot(Thread* thread, JSONStream* js) {
   return true;
 }
 
-void Service::SendGraphEvent(Thread* thread,
-                             ObjectGraph::SnapshotRoots roots,
-                             bool collect_garbage) {
-  uint8_t* buffer = NULL;
-  WriteStream stream(&buffer, &allocator, 1 * MB);
-  ObjectGraph graph(thread);
-  intptr_t node_count = graph.Serialize(&stream, roots, collect_garbage);
-
-  // Chrome crashes receiving a single tens-of-megabytes blob, so send the
-  // snapshot in megabyte-sized chunks instead.
-  const intptr_t kChunkSize = 1 * MB;
-  intptr_t num_chunks =
-      (stream.bytes_written() + (kChunkSize - 1)) / kChunkSize;
-  for (intptr_t i = 0; i < num_chunks; i++) {
+// Sends each chunk of a heap snapshot as a _Graph event as soon as it is
+// written. Chrome crashes receiving a single tens-of-megabytes blob, and
+// holding the whole snapshot would double the memory used by large heaps.
+// The count of chunks and nodes is only known for the last chunk.
+class ServiceHeapSnapshotWriter : public HeapSnapshotWriter {
+ public:
+  explicit ServiceHeapSnapshotWriter(Thread* thread) : thread_(thread) {}
+
+ protected:
+  virtual void WriteChunk(uint8_t* chunk,
+                          intptr_t size,
+                          intptr_t chunk_index,
+                          bool is_last) {
     JSONStream js;
     {
       JSONObject jsobj(&js);
@@ -4102,29 +4173,39 @@ void Service::SendGraphEvent(Thread* thread,
       jsobj.AddProperty("method", "streamNotify");
       {
         JSONObject params(&jsobj, "params");
-        params.AddProperty("streamId", graph_stream.id());
+        params.AddProperty("streamId", Service::graph_stream.id());
         {
           JSONObject event(&params, "event");
           event.AddProperty("type", "Event");
           event.AddProperty("kind", "_Graph");
-          event.AddProperty("isolate", thread->isolate());
+          event.AddProperty("isolate", thread_->isolate());
           event.AddPropertyTimeMillis("timestamp", OS::GetCurrentTimeMillis());
 
-          event.AddProperty("chunkIndex", i);
-          event.AddProperty("chunkCount", num_chunks);
-          event.AddProperty("nodeCount", node_count);
+          event.AddProperty("chunkIndex", chunk_index);
+          if (is_last) {
+            event.AddProperty("chunkCount", chunk_index + 1);
+            event.AddProperty("nodeCount", node_count());
+          }
         }
       }
     }
+    Service::SendEventWithData(Service::graph_stream.id(), "_Graph",
+                               js.buffer()->buf(), js.buffer()->length(),
+                               chunk, size);
+  }
 
-    uint8_t* chunk_start = buffer + (i * kChunkSize);
-    intptr_t chunk_size = (i + 1 == num_chunks)
-                              ? stream.bytes_written() - (i * kChunkSize)
-                              : kChunkSize;
+ private:
+  Thread* thread_;
 
-    SendEventWithData(graph_stream.id(), "_Graph", js.buffer()->buf(),
-                      js.buffer()->length(), chunk_start, chunk_size);
-  }
+  DISALLOW_COPY_AND_ASSIGN(ServiceHeapSnapshotWriter);
+};
+
+void Service::SendGraphEvent(Thread* thread,
+                             ObjectGraph::SnapshotRoots roots,
+                             bool collect_garbage) {
+  ServiceHeapSnapshotWriter writer(thread);
+  ObjectGraph graph(thread);
+  graph.Serialize(&writer, roots, collect_garbage);
 }
 
 void Service::SendInspectEvent(Isolate* isolate, const Object& inspectee) {
@@ -4576,6 +4657,10 @@ void Service::PrintJSONForVM(JSONStream* js, bool ref) {
   jsobj.AddProperty("_profilerMode", FLAG_profile_vm ? "VM" : "Dart");
   jsobj.AddProperty64("_nativeZoneMemoryUsage",
                       ApiNativeScope::current_memory_usage());
+  intptr_t huge_page_reserved, huge_page_backed;
+  VirtualMemory::HugePageUsage(&huge_page_reserved, &huge_page_backed);
+  jsobj.AddProperty64("_hugePageReservedMemory", huge_page_reserved);
+  jsobj.AddProperty64("_hugePageBackedMemory", huge_page_backed);
   jsobj.AddProperty64("pid", OS::ProcessId());
   jsobj.AddPropertyTimeMillis(
       "startTime", OS::GetCurrentTimeMillis() - Dart::UptimeMillis());
@@ -4910,6 +4995,16 @@ static const ServiceMethodDescriptor service_methods_[] = {
     get_allocation_profile_params },
   { "_getAllocationSamples", GetAllocationSamples,
       get_allocation_samples_params },
+  { "_getCompilerPassStats", GetCompilerPassStats,
+    get_compiler_pass_stats_params },
+  { "_getDeoptimizationStats", GetDeoptimizationStats,
+    get_deoptimization_stats_params },
+  { "_getGCPauseHistograms", GetGCPauseHistograms,
+    get_gc_pause_histograms_params },
+  { "_getHeapSampleProfile", GetHeapSampleProfile,
+      get_heap_sample_profile_params },
+  { "_getLockContentionProfile", GetLockContentionProfile,
+    get_lock_contention_profile_params },
   { "_getNativeAllocationSamples", GetNativeAllocationSamples,
       get_native_allocation_samples_params },
   { "getClassList", GetClassList,
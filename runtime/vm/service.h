@@ -242,6 +242,8 @@ class Service : public AllStatic {
 
   static const uint8_t* dart_library_kernel_;
   static intptr_t dart_library_kernel_len_;
+
+  friend class ServiceHeapSnapshotWriter;
 };
 
 }  // namespace dart
@@ -18,6 +18,7 @@
 #include "vm/object_store.h"
 #include "vm/port.h"
 #include "vm/service.h"
+#include "vm/startup_phases.h"
 #include "vm/symbols.h"
 #include "vm/thread_pool.h"
 #include "vm/timeline.h"
@@ -144,8 +145,15 @@ Dart_Port ServiceIsolate::Port() {
 Dart_Port ServiceIsolate::WaitForLoadPort() {
   VMTagScope tagScope(Thread::Current(), VMTag::kLoadWaitTagId);
   MonitorLocker ml(monitor_);
-  while (state_ == kStarting && (load_port_ == ILLEGAL_PORT)) {
-    ml.Wait();
+  if (state_ == kStarting && (load_port_ == ILLEGAL_PORT)) {
+#if defined(SUPPORT_TIMELINE)
+    // Startup of the service isolate that the caller is serialized behind.
+    TimelineDurationScope tds(Timeline::GetVMStream(), "WaitForServiceIsolate");
+#endif  // SUPPORT_TIMELINE
+    STARTUP_PHASE("WaitForServiceIsolate");
+    while (state_ == kStarting && (load_port_ == ILLEGAL_PORT)) {
+      ml.Wait();
+    }
   }
   return load_port_;
 }
@@ -735,6 +735,11 @@ Simulator::Simulator() : exclusive_access_addr_(0), exclusive_access_value_(0) {
   break_instr_ = 0;
   last_setjmp_buffer_ = NULL;
 
+  for (intptr_t i = 0; i < kDecodeCacheSize; i++) {
+    decode_cache_[i].instruction_bits = 0;
+    decode_cache_[i].decode = NULL;
+  }
+
   // Setup architecture state.
   // All registers are initialized to zero to start with.
   for (int i = 0; i < kNumberOfCpuRegisters; i++) {
@@ -1415,19 +1420,19 @@ void Simulator::DecodePCRel(Instr* instr) {
   }
 }
 
-void Simulator::DecodeDPImmediate(Instr* instr) {
+Simulator::DecodeFunction Simulator::LookupDPImmediate(Instr* instr) {
   if (instr->IsMoveWideOp()) {
-    DecodeMoveWide(instr);
+    return &Simulator::DecodeMoveWide;
   } else if (instr->IsAddSubImmOp()) {
-    DecodeAddSubImm(instr);
+    return &Simulator::DecodeAddSubImm;
   } else if (instr->IsBitfieldOp()) {
-    DecodeBitfield(instr);
+    return &Simulator::DecodeBitfield;
   } else if (instr->IsLogicalImmOp()) {
-    DecodeLogicalImm(instr);
+    return &Simulator::DecodeLogicalImm;
   } else if (instr->IsPCRelOp()) {
-    DecodePCRel(instr);
+    return &Simulator::DecodePCRel;
   } else {
-    UnimplementedInstruction(instr);
+    return &Simulator::UnimplementedInstruction;
   }
 }
 
@@ -1755,23 +1760,23 @@ void Simulator::DecodeUnconditionalBranchReg(Instr* instr) {
   }
 }
 
-void Simulator::DecodeCompareBranch(Instr* instr) {
+Simulator::DecodeFunction Simulator::LookupCompareBranch(Instr* instr) {
   if (instr->IsCompareAndBranchOp()) {
-    DecodeCompareAndBranch(instr);
+    return &Simulator::DecodeCompareAndBranch;
   } else if (instr->IsConditionalBranchOp()) {
-    DecodeConditionalBranch(instr);
+    return &Simulator::DecodeConditionalBranch;
   } else if (instr->IsExceptionGenOp()) {
-    DecodeExceptionGen(instr);
+    return &Simulator::DecodeExceptionGen;
   } else if (instr->IsSystemOp()) {
-    DecodeSystem(instr);
+    return &Simulator::DecodeSystem;
   } else if (instr->IsTestAndBranchOp()) {
-    DecodeTestAndBranch(instr);
+    return &Simulator::DecodeTestAndBranch;
   } else if (instr->IsUnconditionalBranchOp()) {
-    DecodeUnconditionalBranch(instr);
+    return &Simulator::DecodeUnconditionalBranch;
   } else if (instr->IsUnconditionalBranchRegOp()) {
-    DecodeUnconditionalBranchReg(instr);
+    return &Simulator::DecodeUnconditionalBranchReg;
   } else {
-    UnimplementedInstruction(instr);
+    return &Simulator::UnimplementedInstruction;
   }
 }
 
@@ -2122,17 +2127,17 @@ void Simulator::DecodeLoadStoreExclusive(Instr* instr) {
   }
 }
 
-void Simulator::DecodeLoadStore(Instr* instr) {
+Simulator::DecodeFunction Simulator::LookupLoadStore(Instr* instr) {
   if (instr->IsLoadStoreRegOp()) {
-    DecodeLoadStoreReg(instr);
+    return &Simulator::DecodeLoadStoreReg;
   } else if (instr->IsLoadStoreRegPairOp()) {
-    DecodeLoadStoreRegPair(instr);
+    return &Simulator::DecodeLoadStoreRegPair;
   } else if (instr->IsLoadRegLiteralOp()) {
-    DecodeLoadRegLiteral(instr);
+    return &Simulator::DecodeLoadRegLiteral;
   } else if (instr->IsLoadStoreExclusiveOp()) {
-    DecodeLoadStoreExclusive(instr);
+    return &Simulator::DecodeLoadStoreExclusive;
   } else {
-    UnimplementedInstruction(instr);
+    return &Simulator::UnimplementedInstruction;
   }
 }
 
@@ -2650,23 +2655,23 @@ void Simulator::DecodeConditionalSelect(Instr* instr) {
   }
 }
 
-void Simulator::DecodeDPRegister(Instr* instr) {
+Simulator::DecodeFunction Simulator::LookupDPRegister(Instr* instr) {
   if (instr->IsAddSubShiftExtOp()) {
-    DecodeAddSubShiftExt(instr);
+    return &Simulator::DecodeAddSubShiftExt;
   } else if (instr->IsAddSubWithCarryOp()) {
-    DecodeAddSubWithCarry(instr);
+    return &Simulator::DecodeAddSubWithCarry;
   } else if (instr->IsLogicalShiftOp()) {
-    DecodeLogicalShift(instr);
+    return &Simulator::DecodeLogicalShift;
   } else if (instr->IsMiscDP1SourceOp()) {
-    DecodeMiscDP1Source(instr);
+    return &Simulator::DecodeMiscDP1Source;
   } else if (instr->IsMiscDP2SourceOp()) {
-    DecodeMiscDP2Source(instr);
+    return &Simulator::DecodeMiscDP2Source;
   } else if (instr->IsMiscDP3SourceOp()) {
-    DecodeMiscDP3Source(instr);
+    return &Simulator::DecodeMiscDP3Source;
   } else if (instr->IsConditionalSelectOp()) {
-    DecodeConditionalSelect(instr);
+    return &Simulator::DecodeConditionalSelect;
   } else {
-    UnimplementedInstruction(instr);
+    return &Simulator::UnimplementedInstruction;
   }
 }
 
@@ -3111,15 +3116,15 @@ void Simulator::DecodeSIMDTwoReg(Instr* instr) {
   }
 }
 
-void Simulator::DecodeDPSimd1(Instr* instr) {
+Simulator::DecodeFunction Simulator::LookupDPSimd1(Instr* instr) {
   if (instr->IsSIMDCopyOp()) {
-    DecodeSIMDCopy(instr);
+    return &Simulator::DecodeSIMDCopy;
   } else if (instr->IsSIMDThreeSameOp()) {
-    DecodeSIMDThreeSame(instr);
+    return &Simulator::DecodeSIMDThreeSame;
   } else if (instr->IsSIMDTwoRegOp()) {
-    DecodeSIMDTwoReg(instr);
+    return &Simulator::DecodeSIMDTwoReg;
   } else {
-    UnimplementedInstruction(instr);
+    return &Simulator::UnimplementedInstruction;
   }
 }
 
@@ -3338,27 +3343,45 @@ void Simulator::DecodeFPCompare(Instr* instr) {
   }
 }
 
-void Simulator::DecodeFP(Instr* instr) {
+Simulator::DecodeFunction Simulator::LookupFP(Instr* instr) {
   if (instr->IsFPImmOp()) {
-    DecodeFPImm(instr);
+    return &Simulator::DecodeFPImm;
   } else if (instr->IsFPIntCvtOp()) {
-    DecodeFPIntCvt(instr);
+    return &Simulator::DecodeFPIntCvt;
   } else if (instr->IsFPOneSourceOp()) {
-    DecodeFPOneSource(instr);
+    return &Simulator::DecodeFPOneSource;
   } else if (instr->IsFPTwoSourceOp()) {
-    DecodeFPTwoSource(instr);
+    return &Simulator::DecodeFPTwoSource;
   } else if (instr->IsFPCompareOp()) {
-    DecodeFPCompare(instr);
+    return &Simulator::DecodeFPCompare;
   } else {
-    UnimplementedInstruction(instr);
+    return &Simulator::UnimplementedInstruction;
   }
 }
 
-void Simulator::DecodeDPSimd2(Instr* instr) {
+Simulator::DecodeFunction Simulator::LookupDPSimd2(Instr* instr) {
   if (instr->IsFPOp()) {
-    DecodeFP(instr);
+    return LookupFP(instr);
   } else {
-    UnimplementedInstruction(instr);
+    return &Simulator::UnimplementedInstruction;
+  }
+}
+
+Simulator::DecodeFunction Simulator::LookupDecodeFunction(Instr* instr) {
+  if (instr->IsDPImmediateOp()) {
+    return LookupDPImmediate(instr);
+  } else if (instr->IsCompareBranchOp()) {
+    return LookupCompareBranch(instr);
+  } else if (instr->IsLoadStoreOp()) {
+    return LookupLoadStore(instr);
+  } else if (instr->IsDPRegisterOp()) {
+    return LookupDPRegister(instr);
+  } else if (instr->IsDPSimd1Op()) {
+    return LookupDPSimd1(instr);
+  } else if (instr->IsDPSimd2Op()) {
+    return LookupDPSimd2(instr);
+  } else {
+    return &Simulator::UnimplementedInstruction;
   }
 }
 
@@ -3376,21 +3399,17 @@ void Simulator::InstructionDecode(Instr* instr) {
     }
   }
 
-  if (instr->IsDPImmediateOp()) {
-    DecodeDPImmediate(instr);
-  } else if (instr->IsCompareBranchOp()) {
-    DecodeCompareBranch(instr);
-  } else if (instr->IsLoadStoreOp()) {
-    DecodeLoadStore(instr);
-  } else if (instr->IsDPRegisterOp()) {
-    DecodeDPRegister(instr);
-  } else if (instr->IsDPSimd1Op()) {
-    DecodeDPSimd1(instr);
-  } else if (instr->IsDPSimd2Op()) {
-    DecodeDPSimd2(instr);
-  } else {
-    UnimplementedInstruction(instr);
+  // The decode function only depends on the encoding, so entries are keyed
+  // by the instruction bits and stay valid when code is patched or freed.
+  const int32_t bits = instr->InstructionBits();
+  DecodeCacheEntry* entry =
+      &decode_cache_[(static_cast<uint32_t>(bits) * 0x9E3779B1u) >>
+                     (32 - kDecodeCacheSizeLog2)];
+  if ((entry->decode == NULL) || (entry->instruction_bits != bits)) {
+    entry->instruction_bits = bits;
+    entry->decode = LookupDecodeFunction(instr);
   }
+  (this->*entry->decode)(instr);
 
   if (!pc_modified_) {
     set_pc(reinterpret_cast<int64_t>(instr) + Instr::kInstrSize);
@@ -225,11 +225,31 @@ class Simulator {
   void DoRedirectedCall(Instr* instr);
 
   // Decode instructions.
+  typedef void (Simulator::*DecodeFunction)(Instr* instr);
   void InstructionDecode(Instr* instr);
+  DecodeFunction LookupDecodeFunction(Instr* instr);
+  DecodeFunction LookupDPImmediate(Instr* instr);
+  DecodeFunction LookupCompareBranch(Instr* instr);
+  DecodeFunction LookupLoadStore(Instr* instr);
+  DecodeFunction LookupDPRegister(Instr* instr);
+  DecodeFunction LookupDPSimd1(Instr* instr);
+  DecodeFunction LookupDPSimd2(Instr* instr);
+  DecodeFunction LookupFP(Instr* instr);
 #define DECODE_OP(op) void Decode##op(Instr* instr);
   APPLY_OP_LIST(DECODE_OP)
 #undef DECODE_OP
 
+  // Caches the decode function of recently executed instructions, so that
+  // the decode tree is walked once per distinct encoding rather than once
+  // per executed instruction.
+  struct DecodeCacheEntry {
+    int32_t instruction_bits;
+    DecodeFunction decode;
+  };
+  static const intptr_t kDecodeCacheSizeLog2 = 12;
+  static const intptr_t kDecodeCacheSize = 1 << kDecodeCacheSizeLog2;
+  DecodeCacheEntry decode_cache_[kDecodeCacheSize];
+
   // Executes ARM64 instructions until the PC reaches kEndSimulatingPC.
   void Execute();
 
@@ -1542,14 +1542,15 @@ SwitchDispatch:
     if ((rA == 0) || (null_value != instantiator_type_args) ||
         (null_value != function_type_args)) {
       // First lookup in the cache.
-      RawArray* instantiations = type_arguments->ptr()->instantiations_;
-      for (intptr_t i = 0;
-           instantiations->ptr()->data()[i] != NULL;  // kNoInstantiator
-           i += 3) {  // kInstantiationSizeInWords
-        if ((instantiations->ptr()->data()[i] == instantiator_type_args) &&
-            (instantiations->ptr()->data()[i + 1] == function_type_args)) {
+      RawObject** entries = TypeArguments::InstantiationsProbeStart(
+          type_arguments->ptr()->instantiations_, instantiator_type_args,
+          function_type_args);
+      for (intptr_t i = 0; entries[i] != NULL;  // kNoInstantiator
+           i += 3) {                            // kInstantiationSizeInWords
+        if ((entries[i] == instantiator_type_args) &&
+            (entries[i + 1] == function_type_args)) {
           // Found in the cache.
-          SP[-1] = instantiations->ptr()->data()[i + 2];
+          SP[-1] = entries[i + 2];
           goto InstantiateTypeArgumentsTOSDone;
         }
       }
@@ -3110,7 +3111,8 @@ SwitchDispatch:
             static_cast<RawTypeArguments*>(null_value);
       }
 
-      for (RawObject** entries = cache->ptr()->cache_->ptr()->data();
+      for (RawObject** entries = SubtypeTestCache::ProbeStart(
+               cache->ptr()->cache_->ptr()->data(), cid);
            entries[0] != null_value;
            entries += SubtypeTestCache::kTestEntryLength) {
         if ((entries[SubtypeTestCache::kInstanceClassIdOrFunction] ==
@@ -3227,7 +3229,8 @@ SwitchDispatch:
               static_cast<RawTypeArguments*>(null_value);
         }
 
-        for (RawObject** entries = cache->ptr()->cache_->ptr()->data();
+        for (RawObject** entries = SubtypeTestCache::ProbeStart(
+                 cache->ptr()->cache_->ptr()->data(), cid);
              entries[0] != null_value;
              entries += SubtypeTestCache::kTestEntryLength) {
           if ((entries[SubtypeTestCache::kInstanceClassIdOrFunction] ==
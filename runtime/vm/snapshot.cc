@@ -28,6 +28,8 @@
 
 namespace dart {
 
+DECLARE_FLAG(uint64_t, externalize_typed_data_threshold);
+
 static const int kNumInitialReferences = 32;
 
 static bool IsSingletonClassId(intptr_t class_id) {
@@ -241,6 +243,9 @@ RawObject* SnapshotReader::ReadObject() {
   // Setup for long jump in case there is an exception while reading.
   LongJumpScope jump;
   if (setjmp(*jump.Set()) == 0) {
+    if (IsFastMessage()) {
+      return ReadFastMessage();
+    }
     objects_to_rehash_ = GrowableObjectArray::New();
     types_to_postprocess_ = GrowableObjectArray::New();
 
@@ -271,6 +276,98 @@ RawObject* SnapshotReader::ReadObject() {
   }
 }
 
+bool SnapshotReader::IsFastMessage() {
+  if ((kind_ != Snapshot::kMessage) || (PendingBytes() == 0)) {
+    return false;
+  }
+  const intptr_t position = Position();
+  const int64_t header_value = Read<int64_t>();
+  if (((header_value & kSmiTagMask) != kSmiTag) &&
+      IsVMIsolateObject(header_value) &&
+      (GetVMIsolateObjectId(header_value) == kFastMessageObject)) {
+    return true;
+  }
+  SetPosition(position);
+  return false;
+}
+
+RawObject* SnapshotReader::ReadFastMessage() {
+  const intptr_t tag = Read<int8_t>();
+  switch (tag) {
+    case kFastTypedData: {
+      const intptr_t cid = ReadClassIDValue();
+      const intptr_t length = Read<int64_t>();
+      *TypedDataHandle() = TypedData::New(cid, length);
+      if (length > 0) {
+        NoSafepointScope no_safepoint;
+        ReadBytes(reinterpret_cast<uint8_t*>(TypedDataHandle()->DataAddr(0)),
+                  length * TypedData::ElementSizeInBytes(cid));
+      }
+      return TypedDataHandle()->raw();
+    }
+    case kFastArray:
+    case kFastGrowableObjectArray: {
+      const intptr_t type_arguments_index = Read<int32_t>();
+      const intptr_t length = Read<int64_t>();
+      const Array& array = Array::Handle(zone(), Array::New(length));
+      for (intptr_t i = 0; i < length; i++) {
+        *PassiveObjectHandle() = ReadFastMessageValue(Read<int8_t>());
+        array.SetAt(i, *PassiveObjectHandle());
+      }
+      *TypeArgumentsHandle() = TypeArguments::null();
+      if (type_arguments_index != kNullObject) {
+        *TypeArgumentsHandle() ^=
+            GetType(object_store(), type_arguments_index);
+      }
+      if (tag == kFastArray) {
+        array.SetTypeArguments(*TypeArgumentsHandle());
+        return array.raw();
+      }
+      const GrowableObjectArray& list =
+          GrowableObjectArray::Handle(zone(), GrowableObjectArray::New(array));
+      list.SetTypeArguments(*TypeArgumentsHandle());
+      return list.raw();
+    }
+    default:
+      return ReadFastMessageValue(tag);
+  }
+}
+
+RawObject* SnapshotReader::ReadFastMessageValue(intptr_t tag) {
+  switch (tag) {
+    case kFastNull:
+      return Object::null();
+    case kFastTrue:
+      return Bool::True().raw();
+    case kFastFalse:
+      return Bool::False().raw();
+    case kFastSmi:
+      return Smi::New(Read<int64_t>());
+    case kFastOneByteString:
+    case kFastTwoByteString: {
+      const bool is_canonical = Read<int8_t>() != 0;
+      const intptr_t length = Read<int64_t>();
+      if (tag == kFastOneByteString) {
+        *StringHandle() = OneByteString::New(length, Heap::kNew);
+        NoSafepointScope no_safepoint;
+        ReadBytes(OneByteString::DataStart(*StringHandle()), length);
+      } else {
+        *StringHandle() = TwoByteString::New(length, Heap::kNew);
+        NoSafepointScope no_safepoint;
+        uint16_t* data = TwoByteString::DataStart(*StringHandle());
+        ReadBytes(reinterpret_cast<uint8_t*>(data), length * sizeof(uint16_t));
+      }
+      if (is_canonical) {
+        *StringHandle() = Symbols::New(thread(), *StringHandle());
+      }
+      return StringHandle()->raw();
+    }
+    default:
+      UNREACHABLE();
+      return Object::null();
+  }
+}
+
 void SnapshotReader::EnqueueTypePostprocessing(const AbstractType& type) {
   types_to_postprocess_.Add(type);
 }
@@ -549,7 +646,16 @@ RawObject* SnapshotReader::ReadInstance(intptr_t object_id,
     bool read_as_reference = RawObject::IsCanonical(tags) ? false : true;
     intptr_t offset = Instance::NextFieldOffset();
     intptr_t result_cid = result->GetClassId();
+    const uint32_t unboxed_fields = cls_.unboxed_fields_bitmap();
     while (offset < next_field_offset) {
+      const intptr_t index = offset >> kWordSizeLog2;
+      if ((index < kBitsPerInt32) && (((unboxed_fields >> index) & 1) != 0)) {
+        // Unboxed fields are written as raw bits.
+        *reinterpret_cast<int64_t*>(result->FieldAddrAtOffset(offset)) =
+            Read<int64_t>();
+        offset += kWordSize;
+        continue;
+      }
       pobj_ = ReadObjectImpl(read_as_reference);
       result->SetFieldAtOffset(offset, pobj_);
       if ((offset != type_argument_field_offset) &&
@@ -962,7 +1068,10 @@ ForwardList::ForwardList(Thread* thread, intptr_t first_object_id)
 }
 
 ForwardList::~ForwardList() {
-  heap()->ResetObjectIdTable();
+  // Messages written without tracing the object graph leave the table empty.
+  if (!nodes_.is_empty()) {
+    heap()->ResetObjectIdTable();
+  }
 }
 
 intptr_t ForwardList::AddObject(Zone* zone,
@@ -1372,10 +1481,17 @@ void SnapshotWriter::WriteInstance(RawObject* raw,
     // a Dart object.
     bool write_as_reference = RawObject::IsCanonical(tags) ? false : true;
     intptr_t offset = Instance::NextFieldOffset();
+    const uint32_t unboxed_fields = Class::unboxed_fields_bitmap(cls);
     while (offset < next_field_offset) {
-      RawObject* raw_obj = *reinterpret_cast<RawObject**>(
-          reinterpret_cast<uword>(raw->ptr()) + offset);
-      WriteObjectImpl(raw_obj, write_as_reference);
+      const intptr_t index = offset >> kWordSizeLog2;
+      if ((index < kBitsPerInt32) && (((unboxed_fields >> index) & 1) != 0)) {
+        Write<int64_t>(*reinterpret_cast<int64_t*>(
+            reinterpret_cast<uword>(raw->ptr()) + offset));
+      } else {
+        RawObject* raw_obj = *reinterpret_cast<RawObject**>(
+            reinterpret_cast<uword>(raw->ptr()) + offset);
+        WriteObjectImpl(raw_obj, write_as_reference);
+      }
       offset += kWordSize;
     }
   }
@@ -1477,7 +1593,7 @@ std::unique_ptr<Message> MessageWriter::WriteMessage(
   // Setup for long jump in case there is an exception while writing
   // the message.
   volatile bool has_exception = false;
-  {
+  if (!WriteFastMessage(obj.raw())) {
     LongJumpScope jump;
     if (setjmp(*jump.Set()) == 0) {
       NoSafepointScope no_safepoint;
@@ -1499,4 +1615,123 @@ std::unique_ptr<Message> MessageWriter::WriteMessage(
                       priority);
 }
 
+bool SnapshotWriter::HasFastMessageValueShape(RawObject* raw) {
+  if (!raw->IsHeapObject() || (raw == Object::null()) ||
+      (raw == Bool::True().raw()) || (raw == Bool::False().raw())) {
+    return true;
+  }
+  // Large strings are handed over outside of the snapshot buffer instead.
+  const intptr_t cid = raw->GetClassId();
+  if (cid == kOneByteStringCid) {
+    RawOneByteString* str = reinterpret_cast<RawOneByteString*>(raw);
+    return Smi::Value(str->ptr()->length_) < kMinMessageExternalStringBytes;
+  }
+  if (cid == kTwoByteStringCid) {
+    RawTwoByteString* str = reinterpret_cast<RawTwoByteString*>(raw);
+    return (Smi::Value(str->ptr()->length_) * sizeof(uint16_t)) <
+           static_cast<uintptr_t>(kMinMessageExternalStringBytes);
+  }
+  return false;
+}
+
+bool SnapshotWriter::WriteFastMessage(RawObject* raw) {
+  NoSafepointScope no_safepoint;
+  if (HasFastMessageValueShape(raw)) {
+    WriteVMIsolateObject(kFastMessageObject);
+    WriteFastMessageValue(raw);
+    return true;
+  }
+
+  const intptr_t cid = raw->GetClassId();
+  if (RawObject::IsTypedDataClassId(cid)) {
+    // SIMD lists have no Dart_CObject representation, and large lists are
+    // externalized instead of copied into the message.
+    if ((cid == kTypedDataInt32x4ArrayCid) ||
+        (cid == kTypedDataFloat32x4ArrayCid) ||
+        (cid == kTypedDataFloat64x2ArrayCid)) {
+      return false;
+    }
+    RawTypedData* data = reinterpret_cast<RawTypedData*>(raw);
+    const intptr_t length = Smi::Value(data->ptr()->length_);
+    const intptr_t bytes = length * TypedData::ElementSizeInBytes(cid);
+    if (static_cast<uint64_t>(bytes) >=
+        FLAG_externalize_typed_data_threshold) {
+      return false;
+    }
+    WriteVMIsolateObject(kFastMessageObject);
+    Write<int8_t>(kFastTypedData);
+    WriteClassIDValue(cid);
+    Write<int64_t>(length);
+    WriteBytes(data->ptr()->data(), bytes);
+    return true;
+  }
+
+  RawTypeArguments* type_arguments;
+  RawArray* array;
+  intptr_t length;
+  if ((cid == kArrayCid) && !raw->IsCanonical()) {
+    array = reinterpret_cast<RawArray*>(raw);
+    type_arguments = array->ptr()->type_arguments_;
+    length = Smi::Value(array->ptr()->length_);
+  } else if (cid == kGrowableObjectArrayCid) {
+    RawGrowableObjectArray* list =
+        reinterpret_cast<RawGrowableObjectArray*>(raw);
+    array = list->ptr()->data_;
+    type_arguments = list->ptr()->type_arguments_;
+    length = Smi::Value(list->ptr()->length_);
+  } else {
+    return false;
+  }
+  // Only the type arguments predefined in message snapshots are written.
+  intptr_t type_arguments_index = kNullObject;
+  if (type_arguments != TypeArguments::null()) {
+    type_arguments_index = GetTypeIndex(object_store(), type_arguments);
+    if (type_arguments_index == kInvalidIndex) {
+      return false;
+    }
+  }
+  for (intptr_t i = 0; i < length; i++) {
+    if (!HasFastMessageValueShape(array->ptr()->data()[i])) {
+      return false;
+    }
+  }
+  WriteVMIsolateObject(kFastMessageObject);
+  Write<int8_t>((cid == kArrayCid) ? kFastArray : kFastGrowableObjectArray);
+  Write<int32_t>(type_arguments_index);
+  Write<int64_t>(length);
+  for (intptr_t i = 0; i < length; i++) {
+    WriteFastMessageValue(array->ptr()->data()[i]);
+  }
+  return true;
+}
+
+void SnapshotWriter::WriteFastMessageValue(RawObject* raw) {
+  if (!raw->IsHeapObject()) {
+    Write<int8_t>(kFastSmi);
+    Write<int64_t>(Smi::Value(reinterpret_cast<RawSmi*>(raw)));
+  } else if (raw == Object::null()) {
+    Write<int8_t>(kFastNull);
+  } else if (raw == Bool::True().raw()) {
+    Write<int8_t>(kFastTrue);
+  } else if (raw == Bool::False().raw()) {
+    Write<int8_t>(kFastFalse);
+  } else if (raw->GetClassId() == kOneByteStringCid) {
+    RawOneByteString* str = reinterpret_cast<RawOneByteString*>(raw);
+    const intptr_t length = Smi::Value(str->ptr()->length_);
+    Write<int8_t>(kFastOneByteString);
+    Write<int8_t>(raw->IsCanonical() ? 1 : 0);
+    Write<int64_t>(length);
+    WriteBytes(str->ptr()->data(), length);
+  } else {
+    ASSERT(raw->GetClassId() == kTwoByteStringCid);
+    RawTwoByteString* str = reinterpret_cast<RawTwoByteString*>(raw);
+    const intptr_t length = Smi::Value(str->ptr()->length_);
+    Write<int8_t>(kFastTwoByteString);
+    Write<int8_t>(raw->IsCanonical() ? 1 : 0);
+    Write<int64_t>(length);
+    WriteBytes(reinterpret_cast<const uint8_t*>(str->ptr()->data()),
+               length * sizeof(uint16_t));
+  }
+}
+
 }  // namespace dart
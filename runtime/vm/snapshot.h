@@ -130,6 +130,30 @@ class SerializedHeaderTag
 class SerializedHeaderData
     : public BitField<intptr_t, intptr_t, kHeaderTagBits, kObjectIdBits> {};
 
+// Compact encodings of the most common message payloads: a string, a typed
+// data object, or a list of Smis, nulls, booleans and strings. These are
+// written after a kFastMessageObject header, with a tag byte per value and
+// the contents of strings and typed data copied as is. They are written
+// without tracing the object graph, so a string that occurs several times in
+// a list is received as several strings.
+enum FastMessageTag {
+  kFastNull = 0,
+  kFastTrue,
+  kFastFalse,
+  kFastSmi,
+  kFastOneByteString,
+  kFastTwoByteString,
+  // Only at the top level.
+  kFastTypedData,
+  kFastArray,
+  kFastGrowableObjectArray,
+};
+
+// Strings in isolate messages with at least this many bytes of character
+// data are handed over outside of the snapshot buffer, so that the receiver
+// can wrap them in an external string instead of copying them again.
+const intptr_t kMinMessageExternalStringBytes = 64 * KB;
+
 enum DeserializeState {
   kIsDeserialized = 0,
   kIsNotDeserialized = 1,
@@ -259,6 +283,9 @@ class BaseReader {
 
   intptr_t PendingBytes() const { return stream_.PendingBytes(); }
 
+  intptr_t Position() const { return stream_.Position(); }
+  void SetPosition(intptr_t value) { stream_.SetPosition(value); }
+
   RawSmi* ReadAsSmi();
   intptr_t ReadSmiValue();
 
@@ -359,6 +386,11 @@ class SnapshotReader : public BaseReader {
   RawClass* ReadClassId(intptr_t object_id);
   RawObject* ReadStaticImplicitClosure(intptr_t object_id, intptr_t cls_header);
 
+  // Read a message written with one of the FastMessageTag encodings.
+  bool IsFastMessage();
+  RawObject* ReadFastMessage();
+  RawObject* ReadFastMessageValue(intptr_t tag);
+
   // Implementation to read an object.
   RawObject* ReadObjectImpl(bool as_reference);
   RawObject* ReadObjectImpl(intptr_t header, bool as_reference);
@@ -686,6 +718,12 @@ class SnapshotWriter : public BaseWriter {
   bool AllowObjectsInDartLibrary(RawLibrary* library);
   intptr_t FindVmSnapshotObject(RawObject* rawobj);
 
+  // Writes |raw| with one of the FastMessageTag encodings if it has one of
+  // their shapes. Returns false otherwise, without writing anything.
+  bool WriteFastMessage(RawObject* raw);
+  void WriteFastMessageValue(RawObject* raw);
+  static bool HasFastMessageValueShape(RawObject* raw);
+
   ObjectStore* object_store() const { return object_store_; }
 
  private:
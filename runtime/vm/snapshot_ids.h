@@ -21,6 +21,8 @@ enum {
   kFalseValue,
   // Marker for special encoding of double objects in message snapshots.
   kDoubleObject,
+  // Marker for the compact encodings of simple message payloads.
+  kFastMessageObject,
   // Object id has been optimized away; reader should use next available id.
   kOmittedObjectId,
 
@@ -434,6 +434,56 @@ ISOLATE_UNIT_TEST_CASE(SerializeString) {
   // TODO(sgjesse): Add tests with non-BMP characters.
 }
 
+ISOLATE_UNIT_TEST_CASE(SerializeLargeString) {
+  // Large enough to be passed outside of the snapshot buffer.
+  const intptr_t kLength = 100 * KB;
+  uint16_t* utf16 = thread->zone()->Alloc<uint16_t>(kLength);
+  for (intptr_t i = 0; i < kLength; i++) {
+    utf16[i] = 'a' + (i % 26);
+  }
+  String& str = String::Handle(String::FromUTF16(utf16, kLength));
+  EXPECT(str.IsOneByteString());
+  utf16[kLength / 2] = 0x1234;
+  String& two_byte_str = String::Handle(String::FromUTF16(utf16, kLength));
+  EXPECT(two_byte_str.IsTwoByteString());
+
+  {
+    MessageWriter writer(true);
+    std::unique_ptr<Message> message =
+        writer.WriteMessage(str, ILLEGAL_PORT, Message::kNormalPriority);
+    EXPECT_GE(message->finalizable_data()->external_size(), kLength);
+
+    // Read object back from the snapshot.
+    MessageSnapshotReader reader(message.get(), thread);
+    String& serialized_str = String::Handle();
+    serialized_str ^= reader.ReadObject();
+    EXPECT(serialized_str.IsExternalOneByteString());
+    EXPECT(str.Equals(serialized_str));
+  }
+  {
+    MessageWriter writer(true);
+    std::unique_ptr<Message> message = writer.WriteMessage(
+        two_byte_str, ILLEGAL_PORT, Message::kNormalPriority);
+    MessageSnapshotReader reader(message.get(), thread);
+    String& serialized_str = String::Handle();
+    serialized_str ^= reader.ReadObject();
+    EXPECT(serialized_str.IsExternalTwoByteString());
+    EXPECT(two_byte_str.Equals(serialized_str));
+  }
+  {
+    // Read object back from the snapshot into a C structure.
+    MessageWriter writer(true);
+    std::unique_ptr<Message> message =
+        writer.WriteMessage(str, ILLEGAL_PORT, Message::kNormalPriority);
+    ApiNativeScope scope;
+    ApiMessageReader api_reader(message.get());
+    Dart_CObject* root = api_reader.ReadMessage();
+    EXPECT_EQ(Dart_CObject_kString, root->type);
+    EXPECT_EQ(kLength, static_cast<intptr_t>(strlen(root->value.as_string)));
+    EXPECT_STREQ(str.ToCString(), root->value.as_string);
+  }
+}
+
 ISOLATE_UNIT_TEST_CASE(SerializeArray) {
   // Write snapshot with object content.
   const int kArrayLength = 10;
@@ -698,6 +748,59 @@ ISOLATE_UNIT_TEST_CASE(SerializeEmptyByteArray) {
   CheckEncodeDecodeMessage(root);
 }
 
+ISOLATE_UNIT_TEST_CASE(SerializeMixedList) {
+  // A growable list of Smis, strings, booleans and null takes the compact
+  // message encoding.
+  const GrowableObjectArray& list =
+      GrowableObjectArray::Handle(GrowableObjectArray::New());
+  list.Add(Smi::Handle(Smi::New(42)));
+  list.Add(String::Handle(String::New("one byte")));
+  list.Add(String::Handle(String::New("\xE2\x82\xAC")));  // U+20AC
+  list.Add(Symbols::Empty());
+  list.Add(Bool::True());
+  list.Add(Object::null_object());
+  MessageWriter writer(true);
+  std::unique_ptr<Message> message =
+      writer.WriteMessage(list, ILLEGAL_PORT, Message::kNormalPriority);
+
+  // Read object back from the snapshot.
+  MessageSnapshotReader reader(message.get(), thread);
+  GrowableObjectArray& serialized_list = GrowableObjectArray::Handle();
+  serialized_list ^= reader.ReadObject();
+  EXPECT_EQ(list.Length(), serialized_list.Length());
+  EXPECT_EQ(42, Smi::Cast(Object::Handle(serialized_list.At(0))).Value());
+  String& str = String::Handle();
+  str ^= serialized_list.At(1);
+  EXPECT(str.IsOneByteString());
+  EXPECT(str.Equals("one byte"));
+  str ^= serialized_list.At(2);
+  EXPECT(str.IsTwoByteString());
+  EXPECT_EQ(0x20AC, str.CharAt(0));
+  EXPECT(serialized_list.At(3) == Symbols::Empty().raw());
+  EXPECT(serialized_list.At(4) == Bool::True().raw());
+  EXPECT(serialized_list.At(5) == Object::null());
+
+  // Read object back from the snapshot into a C structure.
+  ApiNativeScope scope;
+  ApiMessageReader api_reader(message.get());
+  Dart_CObject* root = api_reader.ReadMessage();
+  EXPECT_EQ(Dart_CObject_kArray, root->type);
+  EXPECT_EQ(6, root->value.as_array.length);
+  Dart_CObject** values = root->value.as_array.values;
+  EXPECT_EQ(Dart_CObject_kInt32, values[0]->type);
+  EXPECT_EQ(42, values[0]->value.as_int32);
+  EXPECT_EQ(Dart_CObject_kString, values[1]->type);
+  EXPECT_STREQ("one byte", values[1]->value.as_string);
+  EXPECT_EQ(Dart_CObject_kString, values[2]->type);
+  EXPECT_STREQ("\xE2\x82\xAC", values[2]->value.as_string);
+  EXPECT_EQ(Dart_CObject_kString, values[3]->type);
+  EXPECT_STREQ("", values[3]->value.as_string);
+  EXPECT_EQ(Dart_CObject_kBool, values[4]->type);
+  EXPECT(values[4]->value.as_bool);
+  EXPECT_EQ(Dart_CObject_kNull, values[5]->type);
+  CheckEncodeDecodeMessage(root);
+}
+
 VM_UNIT_TEST_CASE(FullSnapshot) {
   const char* kScriptChars =
       "class Fields  {\n"
@@ -775,6 +878,109 @@ VM_UNIT_TEST_CASE(FullSnapshot) {
   free(isolate_snapshot_data_buffer);
 }
 
+VM_UNIT_TEST_CASE(FullSnapshotParallelFill) {
+  const char* kScriptChars =
+      "class Point {\n"
+      "  Point(this.x, this.y);\n"
+      "  final int x;\n"
+      "  final int y;\n"
+      "}\n"
+      "final map = {'a': new Point(1, 2), 'b': new Point(3, 4)};\n"
+      "int testMain() => map['a'].x + map['b'].y + map.length;\n";
+  uint8_t* isolate_snapshot_data_buffer;
+
+  {
+    TestIsolateScope __test_isolate__;
+    TestCase::LoadTestScript(kScriptChars, NULL);
+
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    StackZone zone(thread);
+    HandleScope scope(thread);
+
+    Dart_Handle result = Api::CheckAndFinalizePendingClasses(thread);
+    {
+      TransitionVMToNative to_native(thread);
+      EXPECT_VALID(result);
+    }
+
+    FullSnapshotWriter writer(Snapshot::kFull, NULL,
+                              &isolate_snapshot_data_buffer, &malloc_allocator,
+                              NULL, /*image_writer*/ nullptr);
+    writer.WriteFullSnapshot();
+  }
+
+  {
+    SetFlagScope<int> sfs(&FLAG_deserializer_tasks, 4);
+    TestCase::CreateTestIsolateFromSnapshot(isolate_snapshot_data_buffer);
+  }
+  {
+    Dart_EnterScope();
+    Dart_Handle result =
+        Dart_Invoke(TestCase::lib(), NewString("testMain"), 0, NULL);
+    EXPECT_VALID(result);
+    int64_t value = 0;
+    EXPECT_VALID(Dart_IntegerToInt64(result, &value));
+    EXPECT_EQ(7, value);
+    Dart_ExitScope();
+  }
+  Dart_ShutdownIsolate();
+  free(isolate_snapshot_data_buffer);
+}
+
+VM_UNIT_TEST_CASE(FullSnapshotParallelWrite) {
+  const char* kScriptChars =
+      "class Point {\n"
+      "  Point(this.x, this.y);\n"
+      "  final int x;\n"
+      "  final int y;\n"
+      "}\n"
+      "final map = {'a': new Point(1, 2), 'b': new Point(3, 4)};\n"
+      "final names = <String>['x', 'y', 'z'];\n"
+      "int testMain() => map['a'].x + map['b'].y + names.length;\n";
+  uint8_t* serial_buffer;
+  uint8_t* parallel_buffer;
+  intptr_t serial_size;
+  intptr_t parallel_size;
+
+  TestIsolateScope __test_isolate__;
+  TestCase::LoadTestScript(kScriptChars, NULL);
+
+  Thread* thread = Thread::Current();
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HandleScope scope(thread);
+
+  Dart_Handle result = Api::CheckAndFinalizePendingClasses(thread);
+  {
+    TransitionVMToNative to_native(thread);
+    EXPECT_VALID(result);
+  }
+
+  {
+    FullSnapshotWriter writer(Snapshot::kFull, NULL, &serial_buffer,
+                              &malloc_allocator, NULL,
+                              /*image_writer*/ nullptr);
+    writer.WriteFullSnapshot();
+    serial_size = writer.IsolateSnapshotSize();
+  }
+  {
+    SetFlagScope<int> sfs(&FLAG_serializer_tasks, 4);
+    FullSnapshotWriter writer(Snapshot::kFull, NULL, &parallel_buffer,
+                              &malloc_allocator, NULL,
+                              /*image_writer*/ nullptr);
+    writer.WriteFullSnapshot();
+    parallel_size = writer.IsolateSnapshotSize();
+  }
+
+  // Writing the fills in parallel does not change the snapshot.
+  EXPECT_EQ(serial_size, parallel_size);
+  EXPECT(memcmp(serial_buffer, parallel_buffer,
+                Utils::Minimum(serial_size, parallel_size)) == 0);
+  free(serial_buffer);
+  free(parallel_buffer);
+}
+
 // Helper function to call a top level Dart function and serialize the result.
 static std::unique_ptr<Message> GetSerialized(Dart_Handle lib,
                                               const char* dart_function) {
@@ -1975,6 +2181,54 @@ VM_UNIT_TEST_CASE(PostCObject) {
   Dart_ExitScope();
 }
 
+VM_UNIT_TEST_CASE(PostCObject_NativeBufferPool) {
+  TestIsolateScope __test_isolate__;
+  const char* kScriptChars =
+      "import 'dart:isolate';\n"
+      "import 'dart:typed_data';\n"
+      "main() {\n"
+      "  var port = new RawReceivePort();\n"
+      "  port.handler = (message) {\n"
+      "    throw new Exception(\n"
+      "        '${message is Uint8List} ${message.length} ${message[0]}');\n"
+      "  };\n"
+      "  return port.sendPort;\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  Dart_EnterScope();
+
+  Dart_Handle send_port = Dart_Invoke(lib, NewString("main"), 0, NULL);
+  EXPECT_VALID(send_port);
+  Dart_Port port_id;
+  EXPECT_VALID(Dart_SendPortGetId(send_port, &port_id));
+
+  Dart_NativeBufferPool pool = Dart_NewNativeBufferPool(16, 1);
+  EXPECT(pool != NULL);
+  uint8_t* buffer = Dart_NativeBufferPoolAcquire(pool);
+  EXPECT(buffer != NULL);
+  buffer[0] = 42;
+  Dart_CObject object;
+  Dart_NativeBufferPoolMakeCObject(buffer, 4, &object);
+  EXPECT(Dart_PostCObject(port_id, &object));
+
+  Dart_Handle result = Dart_RunLoop();
+  EXPECT(Dart_IsError(result));
+  EXPECT_SUBSTRING("Exception: true 4 42", Dart_GetError(result));
+
+  // A message which is not delivered returns its buffer to the pool.
+  uint8_t* other = Dart_NativeBufferPoolAcquire(pool);
+  EXPECT(other != buffer);
+  Dart_NativeBufferPoolMakeCObject(other, 1, &object);
+  EXPECT(!Dart_PostCObject(ILLEGAL_PORT, &object));
+  EXPECT(Dart_NativeBufferPoolAcquire(pool) == other);
+  Dart_NativeBufferPoolRelease(other);
+
+  // The first buffer is still referenced from the Dart heap; the pool is
+  // freed when its finalizer runs.
+  Dart_DeleteNativeBufferPool(pool);
+  Dart_ExitScope();
+}
+
 ISOLATE_UNIT_TEST_CASE(OmittedObjectEncodingLength) {
   StackZone zone(Thread::Current());
   MessageWriter writer(true);
@@ -248,12 +248,6 @@ void SourceReport::PrintCoverageData(JSONObject* jsobj,
   const TokenPosition begin_pos = function.token_pos();
   const TokenPosition end_pos = function.end_token_pos();
 
-  ZoneGrowableArray<const ICData*>* ic_data_array =
-      new (zone()) ZoneGrowableArray<const ICData*>();
-  function.RestoreICDataMap(ic_data_array, false /* clone ic-data */);
-  const PcDescriptors& descriptors =
-      PcDescriptors::Handle(zone(), code.pc_descriptors());
-
   const int kCoverageNone = 0;
   const int kCoverageMiss = 1;
   const int kCoverageHit = 2;
@@ -271,33 +265,62 @@ void SourceReport::PrintCoverageData(JSONObject* jsobj,
     coverage[0] = kCoverageMiss;
   }
 
-  PcDescriptors::Iterator iter(
-      descriptors,
-      RawPcDescriptors::kIcCall | RawPcDescriptors::kUnoptStaticCall);
-  while (iter.MoveNext()) {
-    HANDLESCOPE(thread());
-// TODO(zra): Remove this bailout once DBC has reliable ICData.
-#if defined(TARGET_ARCH_DBC)
-    if (iter.DeoptId() >= ic_data_array->length()) {
-      continue;
-    }
-#else
-    ASSERT(iter.DeoptId() < ic_data_array->length());
-#endif
-    const ICData* ic_data = (*ic_data_array)[iter.DeoptId()];
-    if (ic_data != NULL) {
-      const TokenPosition token_pos = iter.TokenPos();
+  const Array& coverage_array =
+      Array::Handle(zone(), function.GetCoverageArray());
+  if (!coverage_array.IsNull()) {
+    // Code compiled with --block_coverage marks the branches it reaches, in
+    // optimized code as well, so the call counts are not used.
+    Smi& value = Smi::Handle(zone());
+    for (intptr_t i = 0; i < coverage_array.Length(); i += 2) {
+      value ^= coverage_array.At(i);
+      const TokenPosition token_pos = TokenPosition(value.Value());
       if ((token_pos < begin_pos) || (token_pos > end_pos)) {
         // Does not correspond to a valid source position.
         continue;
       }
-      intptr_t count = ic_data->AggregateCount();
       intptr_t token_offset = token_pos.Pos() - begin_pos.Pos();
-      if (count > 0) {
+      value ^= coverage_array.At(i + 1);
+      if (value.Value() != 0) {
         coverage[token_offset] = kCoverageHit;
-      } else {
-        if (coverage[token_offset] == kCoverageNone) {
-          coverage[token_offset] = kCoverageMiss;
+      } else if (coverage[token_offset] == kCoverageNone) {
+        coverage[token_offset] = kCoverageMiss;
+      }
+    }
+  } else {
+    ZoneGrowableArray<const ICData*>* ic_data_array =
+        new (zone()) ZoneGrowableArray<const ICData*>();
+    function.RestoreICDataMap(ic_data_array, false /* clone ic-data */);
+    const PcDescriptors& descriptors =
+        PcDescriptors::Handle(zone(), code.pc_descriptors());
+
+    PcDescriptors::Iterator iter(
+        descriptors,
+        RawPcDescriptors::kIcCall | RawPcDescriptors::kUnoptStaticCall);
+    while (iter.MoveNext()) {
+      HANDLESCOPE(thread());
+// TODO(zra): Remove this bailout once DBC has reliable ICData.
+#if defined(TARGET_ARCH_DBC)
+      if (iter.DeoptId() >= ic_data_array->length()) {
+        continue;
+      }
+#else
+      ASSERT(iter.DeoptId() < ic_data_array->length());
+#endif
+      const ICData* ic_data = (*ic_data_array)[iter.DeoptId()];
+      if (ic_data != NULL) {
+        const TokenPosition token_pos = iter.TokenPos();
+        if ((token_pos < begin_pos) || (token_pos > end_pos)) {
+          // Does not correspond to a valid source position.
+          continue;
+        }
+        intptr_t count = ic_data->AggregateCount();
+        intptr_t token_offset = token_pos.Pos() - begin_pos.Pos();
+        if (count > 0) {
+          coverage[token_offset] = kCoverageHit;
+        } else {
+          if (coverage[token_offset] == kCoverageNone) {
+            coverage[token_offset] = kCoverageMiss;
+          }
         }
       }
     }
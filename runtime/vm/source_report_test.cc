@@ -98,6 +98,98 @@ ISOLATE_UNIT_TEST_CASE(SourceReport_Coverage_SimpleCall) {
       buffer);
 }
 
+ISOLATE_UNIT_TEST_CASE(SourceReport_BlockCoverage_SimpleCall) {
+  SetFlagScope<bool> sfs(&FLAG_block_coverage, true);
+  char buffer[1024];
+  const char* kScript =
+      "helper0() {}\n"
+      "helper1() {}\n"
+      "main() {\n"
+      "  if (true) {\n"
+      "    helper0();\n"
+      "  } else {\n"
+      "    helper1();\n"
+      "  }\n"
+      "}";
+
+  Library& lib = Library::Handle();
+  lib ^= ExecuteScript(kScript);
+  ASSERT(!lib.IsNull());
+  const Script& script =
+      Script::Handle(lib.LookupScript(String::Handle(String::New("test-lib"))));
+  const Function& main = Function::Handle(
+      lib.LookupLocalFunction(String::Handle(String::New("main"))));
+  EXPECT(main.GetCoverageArray() != Array::null());
+
+  SourceReport report(SourceReport::kCoverage);
+  JSONStream js;
+  report.PrintJSON(&js, script);
+  ElideJSONSubstring("classes", js.ToCString(), buffer);
+  ElideJSONSubstring("libraries", buffer, buffer);
+  EXPECT_STREQ(
+      "{\"type\":\"SourceReport\",\"ranges\":["
+
+      // One range compiled with one hit at function declaration (helper0).
+      "{\"scriptIndex\":0,\"startPos\":0,\"endPos\":11,\"compiled\":true,"
+      "\"coverage\":{\"hits\":[0],\"misses\":[]}},"
+
+      // One range not compiled (helper1).
+      "{\"scriptIndex\":0,\"startPos\":13,\"endPos\":24,\"compiled\":false},"
+
+      // The branch taken is a hit and the other one a miss (main).
+      "{\"scriptIndex\":0,\"startPos\":26,\"endPos\":94,\"compiled\":true,"
+      "\"coverage\":{\"hits\":[26,53],\"misses\":[79]}}],"
+
+      // Only one script in the script table.
+      "\"scripts\":[{\"type\":\"@Script\",\"fixedId\":true,\"id\":\"\","
+      "\"uri\":\"file:\\/\\/\\/test-lib\",\"_kind\":\"kernel\"}]}",
+      buffer);
+}
+
+ISOLATE_UNIT_TEST_CASE(SourceReport_BlockCoverage_OptimizedCode) {
+  SetFlagScope<bool> sfs_coverage(&FLAG_block_coverage, true);
+  SetFlagScope<bool> sfs_background(&FLAG_background_compilation, false);
+  SetFlagScope<int> sfs_threshold(&FLAG_optimization_counter_threshold, 10);
+  const char* kScript =
+      "int count = 0;\n"
+      "inc() { count++; }\n"
+      "helper(bool b) {\n"
+      "  if (b) {\n"
+      "    inc();\n"
+      "  }\n"
+      "}\n"
+      "main() {\n"
+      "  for (int i = 0; i < 20; i++) helper(false);\n"
+      "}\n"
+      "takeBranch() {\n"
+      "  helper(true);\n"
+      "}";
+
+  Library& lib = Library::Handle();
+  lib ^= ExecuteScript(kScript);
+  ASSERT(!lib.IsNull());
+  const Function& helper = Function::Handle(
+      lib.LookupLocalFunction(String::Handle(String::New("helper"))));
+  EXPECT(helper.HasOptimizedCode());
+
+  // Only the branch of the 'if' is recorded, and it was not taken.
+  Array& coverage = Array::Handle(helper.GetCoverageArray());
+  EXPECT(!coverage.IsNull());
+  EXPECT_EQ(2, coverage.Length());
+  EXPECT_EQ(0, Smi::Value(Smi::RawCast(coverage.At(1))));
+
+  // The optimized code marks the branch when it is taken.
+  Dart_Handle lib_handle = Api::NewHandle(thread, lib.raw());
+  {
+    TransitionVMToNative transition(thread);
+    Dart_Handle result =
+        Dart_Invoke(lib_handle, NewString("takeBranch"), 0, NULL);
+    EXPECT_VALID(result);
+  }
+  coverage = helper.GetCoverageArray();
+  EXPECT_EQ(1, Smi::Value(Smi::RawCast(coverage.At(1))));
+}
+
 ISOLATE_UNIT_TEST_CASE(SourceReport_Coverage_ForceCompile) {
   char buffer[1024];
   const char* kScript =
@@ -50,24 +50,20 @@ intptr_t StackTraceUtils::CountFrames(Thread* thread,
   return frame_count;
 }
 
-intptr_t StackTraceUtils::CollectFrames(Thread* thread,
-                                        const Array& code_array,
-                                        const Array& pc_offset_array,
-                                        intptr_t array_offset,
-                                        intptr_t count,
-                                        int skip_frames) {
+bool StackTraceUtils::CollectFrames(Thread* thread,
+                                    int skip_frames,
+                                    const Function& async_function,
+                                    intptr_t max_frames,
+                                    GrowableArray<const Object*>* code_list,
+                                    GrowableArray<intptr_t>* pc_offset_list) {
   Zone* zone = thread->zone();
   StackFrameIterator frames(ValidationPolicy::kDontValidateFrames, thread,
                             StackFrameIterator::kNoCrossThreadIteration);
   StackFrame* frame = frames.NextFrame();
   ASSERT(frame != NULL);  // We expect to find a dart invocation frame.
   Function& function = Function::Handle(zone);
-  Code& code = Code::Handle(zone);
-  Bytecode& bytecode = Bytecode::Handle(zone);
-  Smi& offset = Smi::Handle(zone);
-  intptr_t collected_frames_count = 0;
-  for (; (frame != NULL) && (collected_frames_count < count);
-       frame = frames.NextFrame()) {
+  const bool async_function_is_null = async_function.IsNull();
+  for (; frame != NULL; frame = frames.NextFrame()) {
     if (!frame->IsDartFrame()) {
       continue;
     }
@@ -75,25 +71,32 @@ intptr_t StackTraceUtils::CollectFrames(Thread* thread,
       skip_frames--;
       continue;
     }
+    if ((max_frames > 0) && (code_list->length() == max_frames)) {
+      return false;
+    }
     if (frame->is_interpreted()) {
-      bytecode = frame->LookupDartBytecode();
+      const Bytecode& bytecode =
+          Bytecode::ZoneHandle(zone, frame->LookupDartBytecode());
       function = bytecode.function();
       if (function.IsNull()) {
         continue;
       }
-      offset = Smi::New(frame->pc() - bytecode.PayloadStart());
-      code_array.SetAt(array_offset, bytecode);
+      code_list->Add(&bytecode);
+      pc_offset_list->Add(frame->pc() - bytecode.PayloadStart());
     } else {
-      code = frame->LookupDartCode();
+      const Code& code = Code::ZoneHandle(zone, frame->LookupDartCode());
       function = code.function();
-      offset = Smi::New(frame->pc() - code.PayloadStart());
-      code_array.SetAt(array_offset, code);
+      code_list->Add(&code);
+      pc_offset_list->Add(frame->pc() - code.PayloadStart());
+    }
+    if (!async_function_is_null &&
+        (async_function.raw() == function.parent_function())) {
+      return true;
     }
-    pc_offset_array.SetAt(array_offset, offset);
-    array_offset++;
-    collected_frames_count++;
   }
-  return collected_frames_count;
+  // We hit the sentinel.
+  ASSERT(async_function_is_null);
+  return true;
 }
 
 intptr_t StackTraceUtils::ExtractAsyncStackTraceInfo(
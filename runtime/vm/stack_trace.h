@@ -23,16 +23,19 @@ class StackTraceUtils : public AllStatic {
                               int skip_frames,
                               const Function& async_function);
 
-  /// Collects |count| frames into |code_array| and |pc_offset_array|.
-  /// Writing begins at |array_offset|.
+  /// Collects the code and pc offset of the stack frames in a single walk.
   /// Skips over the first |skip_frames|.
-  /// Returns the number of frames collected.
-  static intptr_t CollectFrames(Thread* thread,
-                                const Array& code_array,
-                                const Array& pc_offset_array,
-                                intptr_t array_offset,
-                                intptr_t count,
-                                int skip_frames);
+  /// If |async_function| is not null, stops at the function that has
+  /// |async_function| as its parent.
+  /// Collects at most |max_frames| frames if it is positive.
+  /// Returns false if the walk stopped at |max_frames| before it got to the
+  /// end of the stack or to |async_function|.
+  static bool CollectFrames(Thread* thread,
+                            int skip_frames,
+                            const Function& async_function,
+                            intptr_t max_frames,
+                            GrowableArray<const Object*>* code_list,
+                            GrowableArray<intptr_t>* pc_offset_list);
 
   /// If |thread| has no async_stack_trace, does nothing.
   /// Populates |async_function| with the top function of the async stack
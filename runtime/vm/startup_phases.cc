@@ -0,0 +1,144 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/startup_phases.h"
+
+#include "platform/atomic.h"
+#include "vm/class_id.h"
+#include "vm/json_writer.h"
+
+namespace dart {
+
+#if !defined(PRODUCT)
+
+DEFINE_FLAG(bool,
+            print_startup_phases,
+            false,
+            "Print the time spent in each phase of VM and isolate startup as "
+            "JSON when the VM shuts down.");
+
+bool StartupPhases::enabled_ = false;
+
+static const intptr_t kMaxPhases = 32;
+
+struct PhaseStats {
+  const char* name;
+  int64_t micros;
+  int64_t count;
+};
+
+struct ClusterStats {
+  const char* name;
+  int64_t alloc_micros;
+  int64_t fill_micros;
+  int64_t count;
+};
+
+static PhaseStats phase_stats_[kMaxPhases];
+static ClusterStats cluster_stats_[kNumPredefinedCids];
+
+void StartupPhases::Enable() {
+  Reset();
+  enabled_ = true;
+}
+
+void StartupPhases::Reset() {
+  for (intptr_t i = 0; i < kMaxPhases; i++) {
+    phase_stats_[i].micros = 0;
+    phase_stats_[i].count = 0;
+  }
+  for (intptr_t i = 0; i < kNumPredefinedCids; i++) {
+    cluster_stats_[i].alloc_micros = 0;
+    cluster_stats_[i].fill_micros = 0;
+    cluster_stats_[i].count = 0;
+  }
+}
+
+void StartupPhases::Record(const char* name, int64_t micros) {
+  // Phases are few, so a linear search keyed by the literal's address is
+  // enough. Slots are claimed in order and never released.
+  for (intptr_t i = 0; i < kMaxPhases; i++) {
+    PhaseStats* stats = &phase_stats_[i];
+    const char* current = AtomicOperations::LoadRelaxed(&stats->name);
+    if (current == NULL) {
+      current = AtomicOperations::CompareAndSwapPointer(
+          &stats->name, static_cast<const char*>(NULL), name);
+      if (current == NULL) {
+        current = name;
+      }
+    }
+    if (current == name) {
+      AtomicOperations::IncrementInt64By(&stats->micros, micros);
+      AtomicOperations::IncrementInt64By(&stats->count, 1);
+      return;
+    }
+  }
+}
+
+void StartupPhases::RecordCluster(intptr_t cid,
+                                  const char* name,
+                                  int64_t alloc_micros,
+                                  int64_t fill_micros) {
+  if (cid >= kNumPredefinedCids) {
+    // Instances of program classes share one cluster kind.
+    cid = kInstanceCid;
+    name = "Instance";
+  }
+  ClusterStats* stats = &cluster_stats_[cid];
+  if (AtomicOperations::LoadRelaxed(&stats->name) == NULL) {
+    char* copy = strdup(name);
+    if (AtomicOperations::CompareAndSwapPointer(
+            &stats->name, static_cast<const char*>(NULL),
+            static_cast<const char*>(copy)) != NULL) {
+      free(copy);
+    }
+  }
+  AtomicOperations::IncrementInt64By(&stats->alloc_micros, alloc_micros);
+  AtomicOperations::IncrementInt64By(&stats->fill_micros, fill_micros);
+  AtomicOperations::IncrementInt64By(&stats->count, 1);
+}
+
+void StartupPhases::PrintJSON(JSONWriter* writer) {
+  writer->OpenObject();
+  writer->PrintProperty("type", "StartupPhases");
+  writer->OpenArray("phases");
+  for (intptr_t i = 0; i < kMaxPhases; i++) {
+    const PhaseStats& stats = phase_stats_[i];
+    if ((stats.name == NULL) || (stats.count == 0)) {
+      continue;
+    }
+    writer->OpenObject();
+    writer->PrintProperty("name", stats.name);
+    writer->PrintProperty64("micros", stats.micros);
+    writer->PrintProperty64("count", stats.count);
+    writer->CloseObject();
+  }
+  writer->CloseArray();
+  writer->OpenArray("clusters");
+  for (intptr_t i = 0; i < kNumPredefinedCids; i++) {
+    const ClusterStats& stats = cluster_stats_[i];
+    if (stats.count == 0) {
+      continue;
+    }
+    writer->OpenObject();
+    writer->PrintProperty("name", stats.name);
+    writer->PrintProperty("cid", i);
+    writer->PrintProperty64("allocMicros", stats.alloc_micros);
+    writer->PrintProperty64("fillMicros", stats.fill_micros);
+    writer->PrintProperty64("count", stats.count);
+    writer->CloseObject();
+  }
+  writer->CloseArray();
+  writer->CloseObject();
+}
+
+void StartupPhases::Print() {
+  JSONWriter writer;
+  PrintJSON(&writer);
+  OS::Print("%s\n", writer.buffer()->buf());
+}
+
+#endif  // !defined(PRODUCT)
+
+}  // namespace dart
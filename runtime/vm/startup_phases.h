@@ -0,0 +1,83 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_STARTUP_PHASES_H_
+#define RUNTIME_VM_STARTUP_PHASES_H_
+
+#include "vm/allocation.h"
+#include "vm/flags.h"
+#include "vm/globals.h"
+#include "vm/os.h"
+
+namespace dart {
+
+#if !defined(PRODUCT)
+
+DECLARE_FLAG(bool, print_startup_phases);
+
+class JSONWriter;
+
+// Accumulates the time spent in the phases of VM and isolate startup: VM
+// initialization, snapshot reading broken down by cluster, kernel loading,
+// class finalization, compilation and waiting for the service and kernel
+// isolates. Recording is on with --print_startup_phases, which prints the
+// phases as JSON when the VM shuts down, or while a benchmark has called
+// Enable().
+class StartupPhases : public AllStatic {
+ public:
+  static bool enabled() { return FLAG_print_startup_phases || enabled_; }
+  static void Enable();
+  static void Disable() { enabled_ = false; }
+  static void Reset();
+
+  // Adds |micros| to the phase called |name|, which must be a string literal.
+  static void Record(const char* name, int64_t micros);
+
+  // Adds the time spent allocating and filling a snapshot cluster of class
+  // |cid|, whose name is |name|.
+  static void RecordCluster(intptr_t cid,
+                            const char* name,
+                            int64_t alloc_micros,
+                            int64_t fill_micros);
+
+  // Writes {"type":"StartupPhases","phases":[...],"clusters":[...]}.
+  static void PrintJSON(JSONWriter* writer);
+
+  // Prints the JSON written by PrintJSON on a single line.
+  static void Print();
+
+ private:
+  static bool enabled_;
+};
+
+class StartupPhaseScope : public ValueObject {
+ public:
+  explicit StartupPhaseScope(const char* name)
+      : name_(name),
+        start_(StartupPhases::enabled() ? OS::GetCurrentMonotonicMicros()
+                                        : -1) {}
+  ~StartupPhaseScope() {
+    if (start_ >= 0) {
+      StartupPhases::Record(name_, OS::GetCurrentMonotonicMicros() - start_);
+    }
+  }
+
+ private:
+  const char* name_;
+  const int64_t start_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupPhaseScope);
+};
+
+#define STARTUP_PHASE(name) StartupPhaseScope startup_phase_scope(name)
+
+#else  // !defined(PRODUCT)
+
+#define STARTUP_PHASE(name)
+
+#endif  // !defined(PRODUCT)
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_STARTUP_PHASES_H_
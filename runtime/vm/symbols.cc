@@ -312,6 +312,7 @@ void Symbols::Compact() {
 
   // 1. Drop the tables and do a full garbage collection.
   object_store->set_symbol_table(Object::empty_array());
+  object_store->set_read_only_symbol_table(Array::Handle(zone));
   object_store->set_canonical_types(Object::empty_array());
   object_store->set_canonical_type_arguments(Object::empty_array());
   thread->heap()->CollectAllGarbage();
@@ -403,12 +404,49 @@ void Symbols::Compact() {
   }
 }
 
+void Symbols::FreezeSnapshotTable(Isolate* isolate) {
+  ASSERT(isolate != Dart::vm_isolate());
+  ObjectStore* object_store = isolate->object_store();
+  ASSERT(object_store->read_only_symbol_table() == Array::null());
+  object_store->set_read_only_symbol_table(
+      Array::Handle(object_store->symbol_table()));
+  SetupSymbolTable(isolate);
+}
+
+void Symbols::UnfreezeSnapshotTable(Isolate* isolate) {
+  Thread* thread = Thread::Current();
+  ObjectStore* object_store = isolate->object_store();
+  if (object_store->read_only_symbol_table() == Array::null()) {
+    return;
+  }
+  Zone* zone = thread->zone();
+  String& symbol = String::Handle(zone);
+  SafepointMutexLocker ml(isolate->symbols_mutex());
+  SymbolTable frozen(zone, object_store->read_only_symbol_table());
+  SymbolTable table(zone, object_store->symbol_table());
+  SymbolTable::Iterator it(&frozen);
+  while (it.MoveNext()) {
+    symbol ^= frozen.GetKey(it.Current());
+    table.Insert(symbol);
+  }
+  frozen.Release();
+  object_store->set_symbol_table(table.Release());
+  // Lock-free readers that still see the frozen table find the same symbols.
+  object_store->set_read_only_symbol_table(Array::Handle(zone));
+}
+
 void Symbols::GetStats(Isolate* isolate, intptr_t* size, intptr_t* capacity) {
   ASSERT(isolate != NULL);
   SymbolTable table(isolate->object_store()->symbol_table());
   *size = table.NumOccupied();
   *capacity = table.NumEntries();
   table.Release();
+  if (isolate->object_store()->read_only_symbol_table() != Array::null()) {
+    SymbolTable frozen(isolate->object_store()->read_only_symbol_table());
+    *size += frozen.NumOccupied();
+    *capacity += frozen.NumEntries();
+    frozen.Release();
+  }
 }
 
 RawString* Symbols::New(Thread* thread, const char* cstr, intptr_t len) {
@@ -578,6 +616,15 @@ RawString* Symbols::NewSymbol(Thread* thread, const StringType& str) {
     symbol ^= table.GetOrNull(str);
     table.Release();
   }
+  if (symbol.IsNull()) {
+    // The table read from the snapshot is never mutated: no lock needed.
+    data = thread->isolate()->object_store()->read_only_symbol_table();
+    if (!data.IsNull()) {
+      SymbolTable table(&key, &value, &data);
+      symbol ^= table.GetOrNull(str);
+      table.Release();
+    }
+  }
   if (symbol.IsNull()) {
     Isolate* isolate = thread->isolate();
     SafepointMutexLocker ml(isolate->symbols_mutex());
@@ -607,6 +654,14 @@ RawString* Symbols::Lookup(Thread* thread, const StringType& str) {
     symbol ^= table.GetOrNull(str);
     table.Release();
   }
+  if (symbol.IsNull()) {
+    data = thread->isolate()->object_store()->read_only_symbol_table();
+    if (!data.IsNull()) {
+      SymbolTable table(&key, &value, &data);
+      symbol ^= table.GetOrNull(str);
+      table.Release();
+    }
+  }
   if (symbol.IsNull()) {
     Isolate* isolate = thread->isolate();
     SafepointMutexLocker ml(isolate->symbols_mutex());
@@ -709,6 +764,12 @@ void Symbols::DumpTable(Isolate* isolate) {
   SymbolTable table(isolate->object_store()->symbol_table());
   table.Dump();
   table.Release();
+  if (isolate->object_store()->read_only_symbol_table() != Array::null()) {
+    OS::PrintErr("snapshot symbols:\n");
+    SymbolTable frozen(isolate->object_store()->read_only_symbol_table());
+    frozen.Dump();
+    frozen.Release();
+  }
 }
 
 intptr_t Symbols::LookupPredefinedSymbol(RawObject* obj) {
@@ -20,6 +20,7 @@ class ObjectPointerVisitor;
   V(AbstractClassInstantiationError, "AbstractClassInstantiationError")        \
   V(AllocateInvocationMirror, "_allocateInvocationMirror")                     \
   V(AllocateInvocationMirrorForClosure, "_allocateInvocationMirrorForClosure") \
+  V(AllocateStructResult, "_allocateStructResult")                             \
   V(AnonymousClosure, "<anonymous closure>")                                   \
   V(AnonymousSignature, "<anonymous signature>")                               \
   V(ApiError, "ApiError")                                                      \
@@ -112,6 +113,7 @@ class ObjectPointerVisitor;
   V(ExternalTwoByteString, "_ExternalTwoByteString")                           \
   V(FactoryResult, "factory result")                                           \
   V(FallThroughError, "FallThroughError")                                      \
+  V(FfiByValue, "ByValue")                                                     \
   V(FfiDouble, "Double")                                                       \
   V(FfiDynamicLibrary, "DynamicLibrary")                                       \
   V(FfiFloat, "Float")                                                         \
@@ -177,6 +179,7 @@ class ObjectPointerVisitor;
   V(IntegerDivisionByZeroException, "IntegerDivisionByZeroException")          \
   V(Interpolate, "_interpolate")                                               \
   V(InterpolateSingle, "_interpolateSingle")                                   \
+  V(InterpolateKnownParts, "_interpolateKnownParts")                           \
   V(InvocationMirror, "_InvocationMirror")                                     \
   V(IsolateSpawnException, "IsolateSpawnException")                            \
   V(Iterator, "iterator")                                                      \
@@ -263,6 +266,7 @@ class ObjectPointerVisitor;
   V(TypeArguments, "TypeArguments")                                            \
   V(TypeArgumentsParameter, ":type_arguments")                                 \
   V(TypeError, "_TypeError")                                                   \
+  V(TypedData, "TypedData")                                                    \
   V(TypeQuote, "type '")                                                       \
   V(Uint16List, "Uint16List")                                                  \
   V(Uint32List, "Uint32List")                                                  \
@@ -449,8 +453,11 @@ class ObjectPointerVisitor;
   V(toString, "toString")                                                      \
   V(vm_entry_point, "vm:entry-point")                                          \
   V(vm_exact_result_type, "vm:exact-result-type")                              \
+  V(vm_ffi_native, "vm:ffi-native")                                           \
+  V(vm_ffi_struct_fields, "vm:ffi:struct-fields")                              \
   V(vm_non_nullable_result_type, "vm:non-nullable-result-type")                \
-  V(vm_trace_entrypoints, "vm:testing.unsafe.trace-entrypoints-fn")
+  V(vm_trace_entrypoints, "vm:testing.unsafe.trace-entrypoints-fn")            \
+  V(vm_unroll, "vm:unroll")
 
 // Contains a list of frequently used strings in a canonicalized form. This
 // list is kept in the vm_isolate in order to share the copy across isolates
@@ -600,6 +607,15 @@ class Symbols : public AllStatic {
   // Treat the symbol table as weak and collect garbage.
   static void Compact();
 
+  // Freeze the symbol table read from an isolate snapshot. Lookups probe the
+  // frozen table without taking the symbols mutex; symbols created at runtime
+  // go into a new, mutable table.
+  static void FreezeSnapshotTable(Isolate* isolate);
+
+  // Merge the frozen table back into the mutable one, so that the symbol
+  // table is complete again, e.g. before writing a snapshot.
+  static void UnfreezeSnapshotTable(Isolate* isolate);
+
   // Creates a Symbol given a C string that is assumed to contain
   // UTF-8 encoded characters and '\0' is considered a termination character.
   // TODO(7123) - Rename this to FromCString(....).
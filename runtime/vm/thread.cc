@@ -4,6 +4,7 @@
 
 #include "vm/thread.h"
 
+#include "vm/compiler/jit/code_cache.h"
 #include "vm/dart_api_state.h"
 #include "vm/growable_array.h"
 #include "vm/heap/safepoint.h"
@@ -26,6 +27,7 @@
 
 namespace dart {
 
+DECLARE_FLAG(int, heap_sample_interval);
 DECLARE_FLAG(bool, trace_service);
 DECLARE_FLAG(bool, trace_service_verbose);
 
@@ -282,6 +284,12 @@ const char* Thread::TaskKindToCString(TaskKind kind) {
       return "kSweeperTask";
     case kMarkerTask:
       return "kMarkerTask";
+    case kCompactorTask:
+      return "kCompactorTask";
+    case kScavengerTask:
+      return "kScavengerTask";
+    case kBecomeTask:
+      return "kBecomeTask";
     default:
       UNREACHABLE();
       return "";
@@ -513,6 +521,12 @@ RawError* Thread::HandleInterrupts() {
       heap()->CollectGarbage(Heap::kNew);
     }
     heap()->CheckFinishConcurrentMarking(this);
+#if !defined(DART_PRECOMPILED_RUNTIME)
+    CodeCache* code_cache = isolate()->jit_code_cache();
+    if (CodeCache::IsEnabled() && (code_cache != nullptr)) {
+      code_cache->AgeIfScheduled(this);
+    }
+#endif
   }
   if ((interrupt_bits & kMessageInterrupt) != 0) {
     MessageHandler::MessageStatus status =
@@ -618,6 +632,32 @@ void Thread::DeferredMarkingStackAcquire() {
       isolate()->deferred_marking_stack()->PopEmptyBlock();
 }
 
+#ifndef PRODUCT
+void Thread::CountHeapSampleBytes(intptr_t bytes) {
+  // Weak table updates are only safe on the mutator.
+  if ((FLAG_heap_sample_interval <= 0) || !IsMutatorThread()) {
+    return;
+  }
+  if (heap_sample_bytes_left_ == 0) {
+    heap_sample_bytes_left_ = NextHeapSampleInterval();
+  }
+  heap_sample_bytes_left_ -= bytes;
+  if (heap_sample_bytes_left_ <= 0) {
+    heap_sample_pending_ = true;
+    heap_sample_bytes_left_ = NextHeapSampleInterval();
+  }
+}
+
+intptr_t Thread::NextHeapSampleInterval() {
+  // Exponentially distributed gaps make the sampling points a Poisson
+  // process, so allocation patterns cannot line up with a fixed stride.
+  const double uniform =
+      (static_cast<double>(thread_random_.NextUInt32()) + 1.0) / 4294967296.0;
+  const double interval = -log(uniform) * FLAG_heap_sample_interval;
+  return Utils::Maximum(static_cast<intptr_t>(interval), kIntptrOne);
+}
+#endif  // !PRODUCT
+
 bool Thread::IsMutatorThread() const {
   return ((isolate_ != NULL) && (isolate_->mutator_thread() == this));
 }
@@ -218,6 +218,8 @@ class Thread : public ThreadState {
     kMarkerTask = 0x4,
     kSweeperTask = 0x8,
     kCompactorTask = 0x10,
+    kScavengerTask = 0x20,
+    kBecomeTask = 0x40,
   };
   // Converts a TaskKind to its corresponding C-String name.
   static const char* TaskKindToCString(TaskKind kind);
@@ -795,6 +797,19 @@ class Thread : public ThreadState {
 
   uint64_t GetRandomUInt64() { return thread_random_.NextUInt64(); }
 
+#ifndef PRODUCT
+  // Counts |bytes| claimed by a slow-path allocation (a TLAB refill or an
+  // old-space allocation) towards the next heap sample. The allocation that
+  // crosses the sampling point is picked up by TakeHeapSample.
+  void CountHeapSampleBytes(intptr_t bytes);
+
+  bool TakeHeapSample() {
+    const bool result = heap_sample_pending_;
+    heap_sample_pending_ = false;
+    return result;
+  }
+#endif
+
   uint64_t* GetFfiMarshalledArguments(intptr_t size) {
     if (ffi_marshalled_arguments_size_ < size) {
       if (ffi_marshalled_arguments_size_ > 0) {
@@ -908,6 +923,15 @@ class Thread : public ThreadState {
 
   Random thread_random_;
 
+#ifndef PRODUCT
+  intptr_t heap_sample_bytes_left_ = 0;
+  bool heap_sample_pending_ = false;
+#endif
+
+  // The block of the profiler's sample buffer this thread's samples go to.
+  uintptr_t sample_cursor_ = 0;
+  uintptr_t sample_end_ = 0;
+
   intptr_t ffi_marshalled_arguments_size_ = 0;
   uint64_t* ffi_marshalled_arguments_;
 
@@ -950,6 +974,9 @@ class Thread : public ThreadState {
   void DeferredMarkingStackAcquire();
 
   void set_safepoint_state(uint32_t value) { safepoint_state_ = value; }
+#ifndef PRODUCT
+  intptr_t NextHeapSampleInterval();
+#endif
   void EnterSafepointUsingLock();
   void ExitSafepointUsingLock();
   void BlockForSafepoint();
@@ -970,6 +997,7 @@ class Thread : public ThreadState {
   friend class Isolate;
   friend class IsolateTestHelper;
   friend class NoOOBMessageScope;
+  friend class SampleBuffer;
   friend class Simulator;
   friend class StackZone;
   friend class ThreadRegistry;
@@ -18,6 +18,9 @@ struct InterruptedThreadState {
   uintptr_t dsp;
   uintptr_t fp;
   uintptr_t lr;
+  // Hardware counter events since the thread's previous sample. Always 0
+  // unless samples are driven by --profile_counter.
+  uint64_t counter;
 };
 
 class ThreadInterrupter : public AllStatic {
@@ -36,6 +39,12 @@ class ThreadInterrupter : public AllStatic {
   // Interrupt a thread.
   static void InterruptThread(OSThread* thread);
 
+#if defined(HOST_OS_LINUX)
+  // Close the hardware counter opened for |thread|, if any. Called once the
+  // thread has been removed from the thread list.
+  static void ReleaseCounter(OSThread* thread);
+#endif
+
  private:
   static const intptr_t kMaxThreads = 4096;
   static bool initialized_;
@@ -153,6 +153,7 @@ class ThreadInterrupterFuchsia : public AllStatic {
 
     // Grab the target thread's registers.
     InterruptedThreadState its;
+    its.counter = 0;
     if (!GrabRegisters(target_thread_handle, &its)) {
       return;
     }
@@ -5,7 +5,12 @@
 #include "platform/globals.h"
 #if defined(HOST_OS_LINUX)
 
-#include <errno.h>  // NOLINT
+#include <errno.h>             // NOLINT
+#include <fcntl.h>             // NOLINT
+#include <linux/perf_event.h>  // NOLINT
+#include <sys/ioctl.h>         // NOLINT
+#include <sys/syscall.h>       // NOLINT
+#include <unistd.h>            // NOLINT
 
 #include "vm/flags.h"
 #include "vm/os.h"
@@ -18,9 +23,14 @@ namespace dart {
 #ifndef PRODUCT
 
 DECLARE_FLAG(bool, trace_thread_interrupter);
+DECLARE_FLAG(charp, profile_counter);
+DECLARE_FLAG(int, profile_counter_period);
 
 class ThreadInterrupterLinux : public AllStatic {
  public:
+  // Values of OSThread::profile_counter_fd_ other than open descriptors.
+  static const intptr_t kNoCounter = -1;
+  static const intptr_t kCounterUnavailable = -2;
   static void ThreadInterruptSignalHandler(int signal,
                                            siginfo_t* info,
                                            void* context_) {
@@ -31,6 +41,12 @@ class ThreadInterrupterLinux : public AllStatic {
     if (thread == NULL) {
       return;
     }
+    OSThread* os_thread = thread->os_thread();
+    if ((os_thread == NULL) || !os_thread->ThreadInterruptsEnabled()) {
+      // Counter overflows arrive regardless of whether the thread interrupter
+      // has chosen this thread.
+      return;
+    }
     // Extract thread state.
     ucontext_t* context = reinterpret_cast<ucontext_t*>(context_);
     mcontext_t mcontext = context->uc_mcontext;
@@ -40,8 +56,113 @@ class ThreadInterrupterLinux : public AllStatic {
     its.csp = SignalHandler::GetCStackPointer(mcontext);
     its.dsp = SignalHandler::GetDartStackPointer(mcontext);
     its.lr = SignalHandler::GetLinkRegister(mcontext);
+    its.counter = ReadCounterDelta(os_thread);
     Profiler::SampleThread(thread, its);
   }
+
+  // Returns the perf_event config for --profile_counter, or false if sampling
+  // is timer driven.
+  static bool CounterConfig(uint64_t* config, uint64_t* period) {
+    const char* name = FLAG_profile_counter;
+    if ((name == NULL) || (name[0] == '\0')) {
+      return false;
+    }
+    if (strcmp(name, "cycles") == 0) {
+      *config = PERF_COUNT_HW_CPU_CYCLES;
+      *period = 1000000;
+    } else if (strcmp(name, "instructions") == 0) {
+      *config = PERF_COUNT_HW_INSTRUCTIONS;
+      *period = 1000000;
+    } else if (strcmp(name, "cache-misses") == 0) {
+      *config = PERF_COUNT_HW_CACHE_MISSES;
+      *period = 10000;
+    } else if (strcmp(name, "branch-misses") == 0) {
+      *config = PERF_COUNT_HW_BRANCH_MISSES;
+      *period = 10000;
+    } else {
+      return false;
+    }
+    if (FLAG_profile_counter_period > 0) {
+      *period = FLAG_profile_counter_period;
+    }
+    return true;
+  }
+
+  // Opens a counter on |thread| whose overflows raise SIGPROF on that thread.
+  // Returns false if the thread should keep being interrupted by the timer.
+  static bool EnsureCounter(OSThread* thread) {
+    if (thread->profile_counter_fd_ >= 0) {
+      return true;
+    }
+    if (thread->profile_counter_fd_ == kCounterUnavailable) {
+      return false;
+    }
+    uint64_t config = 0;
+    uint64_t period = 0;
+    if (!CounterConfig(&config, &period)) {
+      return false;
+    }
+    const pid_t tid = static_cast<pid_t>(thread->trace_id());
+
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.sample_period = period;
+    attr.wakeup_events = 1;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    int fd = syscall(__NR_perf_event_open, &attr, tid, -1, -1,
+                     PERF_FLAG_FD_CLOEXEC);
+    if (fd < 0) {
+      if (FLAG_trace_thread_interrupter) {
+        OS::PrintErr("ThreadInterrupter cannot open counter %s for %d: %s\n",
+                     FLAG_profile_counter, tid, strerror(errno));
+      }
+      thread->profile_counter_fd_ = kCounterUnavailable;
+      return false;
+    }
+    struct f_owner_ex owner;
+    owner.type = F_OWNER_TID;
+    owner.pid = tid;
+    if ((fcntl(fd, F_SETOWN_EX, &owner) != 0) ||
+        (fcntl(fd, F_SETSIG, SIGPROF) != 0) ||
+        (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_ASYNC) != 0)) {
+      close(fd);
+      thread->profile_counter_fd_ = kCounterUnavailable;
+      return false;
+    }
+    // Publish the descriptor before the first overflow can reach the handler.
+    thread->profile_counter_value_ = 0;
+    thread->profile_counter_fd_ = fd;
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    return true;
+  }
+
+  static uint64_t ReadCounterDelta(OSThread* thread) {
+    const intptr_t fd = thread->profile_counter_fd_;
+    if (fd < 0) {
+      return 0;
+    }
+    uint64_t value = 0;
+    if (read(fd, &value, sizeof(value)) != sizeof(value)) {
+      return 0;
+    }
+    const uint64_t delta = value - thread->profile_counter_value_;
+    thread->profile_counter_value_ = value;
+    return delta;
+  }
+
+  static void ReleaseCounter(OSThread* thread) {
+    const intptr_t fd = thread->profile_counter_fd_;
+    thread->profile_counter_fd_ = kNoCounter;
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      close(fd);
+    }
+  }
 };
 
 bool ThreadInterrupter::IsDebuggerAttached() {
@@ -53,6 +174,10 @@ void ThreadInterrupter::InterruptThread(OSThread* thread) {
     OS::PrintErr("ThreadInterrupter interrupting %p\n",
                  reinterpret_cast<void*>(thread->id()));
   }
+  if (ThreadInterrupterLinux::EnsureCounter(thread)) {
+    // The counter raises SIGPROF on the thread itself.
+    return;
+  }
   int result = pthread_kill(thread->id(), SIGPROF);
   ASSERT((result == 0) || (result == ESRCH));
 }
@@ -62,7 +187,18 @@ void ThreadInterrupter::InstallSignalHandler() {
       ThreadInterrupterLinux::ThreadInterruptSignalHandler>();
 }
 
+void ThreadInterrupter::ReleaseCounter(OSThread* thread) {
+  ThreadInterrupterLinux::ReleaseCounter(thread);
+}
+
 void ThreadInterrupter::RemoveSignalHandler() {
+  {
+    // Counters would otherwise keep raising SIGPROF with no handler.
+    OSThreadIterator it;
+    while (it.HasNext()) {
+      ThreadInterrupterLinux::ReleaseCounter(it.Next());
+    }
+  }
   SignalHandler::Remove();
 }
 
@@ -66,6 +66,7 @@ class ThreadInterrupterMacOS : public AllStatic {
     its.csp = SignalHandler::GetCStackPointer(mcontext);
     its.dsp = SignalHandler::GetDartStackPointer(mcontext);
     its.lr = SignalHandler::GetLinkRegister(mcontext);
+    its.counter = 0;
     Profiler::SampleThread(thread, its);
   }
 };
@@ -68,6 +68,7 @@ class ThreadInterrupterWin : public AllStatic {
       return;
     }
     InterruptedThreadState its;
+    its.counter = 0;
     if (!GrabRegisters(handle, &its)) {
       // Failed to get thread registers.
       ResumeThread(handle);
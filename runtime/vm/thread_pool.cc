@@ -14,8 +14,16 @@ DEFINE_FLAG(int,
             worker_timeout_millis,
             5000,
             "Free workers when they have been idle for this amount of time.");
-
-ThreadPool::ThreadPool()
+DEFINE_FLAG(int,
+            thread_pool_max_workers,
+            0,
+            "The maximum number of workers the VM's thread pool starts for "
+            "tasks other than GC helpers; further tasks wait in a queue. 0 "
+            "means no limit. Tasks that wait for other tasks, such as "
+            "isolates waiting for the kernel isolate, can deadlock if the "
+            "limit is too small.");
+
+ThreadPool::ThreadPool(intptr_t max_workers, bool release_idle_workers)
     : shutting_down_(false),
       all_workers_(NULL),
       idle_workers_(NULL),
@@ -23,8 +31,16 @@ ThreadPool::ThreadPool()
       count_stopped_(0),
       count_running_(0),
       count_idle_(0),
+      count_queued_(0),
+      max_workers_(max_workers),
+      release_idle_workers_(release_idle_workers),
       shutting_down_workers_(NULL),
-      join_list_(NULL) {}
+      join_list_(NULL) {
+  for (intptr_t i = 0; i < kNumPriorities; i++) {
+    queue_heads_[i] = NULL;
+    queue_tails_[i] = NULL;
+  }
+}
 
 ThreadPool::~ThreadPool() {
   Shutdown();
@@ -40,6 +56,15 @@ bool ThreadPool::RunImpl(std::unique_ptr<Task> task) {
     if (shutting_down_) {
       return false;
     }
+    if ((idle_workers_ == NULL) && (max_workers_ > 0) &&
+        (task->priority() != kHighPriority) &&
+        (count_running_ >= static_cast<uint64_t>(max_workers_))) {
+      // A worker that finishes its task takes the next queued task before it
+      // becomes idle, so tasks are only queued while there are no idle
+      // workers.
+      EnqueueLocked(std::move(task));
+      return true;
+    }
     if (idle_workers_ == NULL) {
       worker = new Worker(this);
       ASSERT(worker != NULL);
@@ -92,6 +117,10 @@ void ThreadPool::Shutdown() {
     count_idle_ = 0;
     count_running_ = 0;
     ASSERT(count_started_ == count_stopped_);
+
+    // Queued tasks never run.
+    while (DequeueLocked() != nullptr) {
+    }
   }
   // Release ThreadPool::mutex_ before calling Worker functions.
 
@@ -141,6 +170,38 @@ void ThreadPool::Shutdown() {
 #endif
 }
 
+void ThreadPool::EnqueueLocked(std::unique_ptr<Task> task) {
+  ASSERT(mutex_.IsOwnedByCurrentThread());
+  const intptr_t priority = task->priority();
+  ASSERT((priority >= 0) && (priority < kNumPriorities));
+  Task* raw_task = task.release();
+  raw_task->next_ = NULL;
+  if (queue_tails_[priority] == NULL) {
+    queue_heads_[priority] = raw_task;
+  } else {
+    queue_tails_[priority]->next_ = raw_task;
+  }
+  queue_tails_[priority] = raw_task;
+  count_queued_++;
+}
+
+std::unique_ptr<ThreadPool::Task> ThreadPool::DequeueLocked() {
+  ASSERT(mutex_.IsOwnedByCurrentThread());
+  for (intptr_t priority = 0; priority < kNumPriorities; priority++) {
+    Task* task = queue_heads_[priority];
+    if (task != NULL) {
+      queue_heads_[priority] = task->next_;
+      if (queue_heads_[priority] == NULL) {
+        queue_tails_[priority] = NULL;
+      }
+      task->next_ = NULL;
+      count_queued_--;
+      return std::unique_ptr<Task>(task);
+    }
+  }
+  return nullptr;
+}
+
 bool ThreadPool::IsIdle(Worker* worker) {
   ASSERT(worker != NULL && worker->owned_);
   for (Worker* current = idle_workers_; current != NULL;
@@ -212,17 +273,23 @@ void ThreadPool::SetIdleLocked(Worker* worker) {
   count_running_--;
 }
 
-void ThreadPool::SetIdleAndReapExited(Worker* worker) {
+std::unique_ptr<ThreadPool::Task> ThreadPool::TakeQueuedTaskOrSetIdle(
+    Worker* worker) {
   JoinList* list = NULL;
   {
     MutexLocker ml(&mutex_);
     if (shutting_down_) {
-      return;
+      return nullptr;
+    }
+    std::unique_ptr<Task> task = DequeueLocked();
+    if (task != nullptr) {
+      // The worker stays running. Exited threads are joined later.
+      return task;
     }
     if (join_list_ == NULL) {
       // Nothing to join, add to the idle list and return.
       SetIdleLocked(worker);
-      return;
+      return nullptr;
     }
     // There is something to join. Grab the join list, drop the lock, do the
     // join, then grab the lock again and add to the idle list.
@@ -234,10 +301,15 @@ void ThreadPool::SetIdleAndReapExited(Worker* worker) {
   {
     MutexLocker ml(&mutex_);
     if (shutting_down_) {
-      return;
+      return nullptr;
+    }
+    std::unique_ptr<Task> task = DequeueLocked();
+    if (task != nullptr) {
+      return task;
     }
     SetIdleLocked(worker);
   }
+  return nullptr;
 }
 
 bool ThreadPool::ReleaseIdleWorker(Worker* worker) {
@@ -308,7 +380,7 @@ void ThreadPool::JoinList::Join(JoinList** list) {
   }
 }
 
-ThreadPool::Task::Task() {}
+ThreadPool::Task::Task() : next_(NULL) {}
 
 ThreadPool::Task::~Task() {}
 
@@ -349,10 +421,10 @@ void ThreadPool::Worker::SetTask(std::unique_ptr<Task> task) {
   ml.Notify();
 }
 
-static int64_t ComputeTimeout(int64_t idle_start) {
+static int64_t ComputeTimeout(int64_t idle_start, bool release_idle_workers) {
   int64_t worker_timeout_micros =
       FLAG_worker_timeout_millis * kMicrosecondsPerMillisecond;
-  if (worker_timeout_micros <= 0) {
+  if (!release_idle_workers || (worker_timeout_micros <= 0)) {
     // No timeout.
     return 0;
   } else {
@@ -387,10 +459,15 @@ bool ThreadPool::Worker::Loop() {
       return false;
     }
     ASSERT(!done_);
-    pool_->SetIdleAndReapExited(this);
+    std::unique_ptr<Task> queued_task = pool_->TakeQueuedTaskOrSetIdle(this);
+    if (queued_task != nullptr) {
+      task_ = std::move(queued_task);
+      continue;
+    }
     idle_start = OS::GetCurrentMonotonicMicros();
     while (true) {
-      Monitor::WaitResult result = ml.WaitMicros(ComputeTimeout(idle_start));
+      Monitor::WaitResult result = ml.WaitMicros(
+          ComputeTimeout(idle_start, pool_->release_idle_workers_));
       if (task_ != nullptr) {
         // We've found a task.  Process it, regardless of whether the
         // worker is done_.
@@ -16,6 +16,17 @@ namespace dart {
 
 class ThreadPool {
  public:
+  // When the pool has reached its worker limit, new tasks are queued and
+  // started in priority order as workers become free. High priority tasks
+  // never wait for a worker: helpers such as those of the GC run in lockstep
+  // with each other and would deadlock if only some of them were started.
+  enum Priority {
+    kHighPriority,    // GC helpers and tasks that wait for each other.
+    kNormalPriority,  // Message handlers and everything else.
+    kLowPriority,     // Background compilation.
+    kNumPriorities,
+  };
+
   // Subclasses of Task are able to run on a ThreadPool.
   class Task {
    protected:
@@ -27,11 +38,23 @@ class ThreadPool {
     // Override this to provide task-specific behavior.
     virtual void Run() = 0;
 
+    // Override this to change when the task starts if it has to be queued.
+    virtual Priority priority() const { return kNormalPriority; }
+
    private:
+    friend class ThreadPool;
+
+    Task* next_;  // Protected by ThreadPool::mutex_ while queued.
+
     DISALLOW_COPY_AND_ASSIGN(Task);
   };
 
-  ThreadPool();
+  // Creates a pool that starts at most [max_workers] threads for tasks that
+  // are not high priority, or any number of threads if [max_workers] is 0.
+  // Unless [release_idle_workers] is false, workers exit after being idle
+  // for --worker_timeout_millis.
+  explicit ThreadPool(intptr_t max_workers = 0,
+                      bool release_idle_workers = true);
 
   // Shuts down this thread pool. Causes workers to terminate
   // themselves when they are active again.
@@ -48,6 +71,7 @@ class ThreadPool {
   uint64_t workers_idle() const { return count_idle_; }
   uint64_t workers_started() const { return count_started_; }
   uint64_t workers_stopped() const { return count_stopped_; }
+  uint64_t tasks_queued() const { return count_queued_; }
 
  private:
   class Worker {
@@ -119,6 +143,10 @@ class ThreadPool {
   bool RunImpl(std::unique_ptr<Task> task);
   void Shutdown();
 
+  // Task queue operations. Assume mutex_ is held.
+  void EnqueueLocked(std::unique_ptr<Task> task);
+  std::unique_ptr<Task> DequeueLocked();
+
   // Expensive.  Use only in assertions.
   bool IsIdle(Worker* worker);
 
@@ -132,7 +160,9 @@ class ThreadPool {
 
   // Worker operations.
   void SetIdleLocked(Worker* worker);  // Assumes mutex_ is held.
-  void SetIdleAndReapExited(Worker* worker);
+  // Returns the next queued task for [worker] to run, or adds it to the idle
+  // list if there is none.
+  std::unique_ptr<Task> TakeQueuedTaskOrSetIdle(Worker* worker);
   bool ReleaseIdleWorker(Worker* worker);
 
   Mutex mutex_;
@@ -143,6 +173,12 @@ class ThreadPool {
   uint64_t count_stopped_;
   uint64_t count_running_;
   uint64_t count_idle_;
+  uint64_t count_queued_;
+
+  const intptr_t max_workers_;
+  const bool release_idle_workers_;
+  Task* queue_heads_[kNumPriorities];
+  Task* queue_tails_[kNumPriorities];
 
   Monitor exit_monitor_;
   Worker* shutting_down_workers_;
@@ -81,6 +81,106 @@ VM_UNIT_TEST_CASE(ThreadPool_RunMany) {
   }
 }
 
+VM_UNIT_TEST_CASE(ThreadPool_MaxWorkers) {
+  const int kTaskCount = 4;
+  ThreadPool thread_pool(2);
+  Monitor sync[kTaskCount];
+  bool done[kTaskCount];
+
+  for (int i = 0; i < kTaskCount; i++) {
+    done[i] = true;
+    EXPECT(thread_pool.Run<TestTask>(&sync[i], &done[i]));
+  }
+  // The first two tasks block their workers, so the others are queued.
+  EXPECT_EQ(2U, thread_pool.workers_started());
+  EXPECT_EQ(2U, thread_pool.tasks_queued());
+
+  for (int i = 0; i < kTaskCount; i++) {
+    MonitorLocker ml(&sync[i]);
+    done[i] = false;
+    ml.Notify();
+    while (!done[i]) {
+      ml.Wait();
+    }
+  }
+  EXPECT_EQ(2U, thread_pool.workers_started());
+  EXPECT_EQ(0U, thread_pool.tasks_queued());
+}
+
+class OrderTask : public ThreadPool::Task {
+ public:
+  OrderTask(Monitor* sync,
+            ThreadPool::Priority priority,
+            int id,
+            int* order,
+            int* count)
+      : sync_(sync),
+        priority_(priority),
+        id_(id),
+        order_(order),
+        count_(count) {}
+
+  virtual void Run() {
+    MonitorLocker ml(sync_);
+    order_[(*count_)++] = id_;
+    ml.Notify();
+  }
+
+  virtual ThreadPool::Priority priority() const { return priority_; }
+
+ private:
+  Monitor* sync_;
+  ThreadPool::Priority priority_;
+  int id_;
+  int* order_;
+  int* count_;
+};
+
+VM_UNIT_TEST_CASE(ThreadPool_Priorities) {
+  ThreadPool thread_pool(1);
+  Monitor blocker_sync;
+  bool blocker_done = true;
+  EXPECT(thread_pool.Run<TestTask>(&blocker_sync, &blocker_done));
+
+  Monitor sync;
+  int order[3];
+  int count = 0;
+  EXPECT(thread_pool.Run<OrderTask>(&sync, ThreadPool::kLowPriority, 0, order,
+                                    &count));
+  EXPECT(thread_pool.Run<OrderTask>(&sync, ThreadPool::kNormalPriority, 1,
+                                    order, &count));
+  EXPECT_EQ(2U, thread_pool.tasks_queued());
+
+  // High priority tasks do not wait for the busy worker.
+  EXPECT(thread_pool.Run<OrderTask>(&sync, ThreadPool::kHighPriority, 2, order,
+                                    &count));
+  {
+    MonitorLocker ml(&sync);
+    while (count < 1) {
+      ml.Wait();
+    }
+    EXPECT_EQ(2, order[0]);
+  }
+
+  {
+    MonitorLocker ml(&blocker_sync);
+    blocker_done = false;
+    ml.Notify();
+    while (!blocker_done) {
+      ml.Wait();
+    }
+  }
+  {
+    MonitorLocker ml(&sync);
+    while (count < 3) {
+      ml.Wait();
+    }
+  }
+  // Queued tasks ran by priority.
+  EXPECT_EQ(1, order[1]);
+  EXPECT_EQ(0, order[2]);
+}
+
 class SleepTask : public ThreadPool::Task {
  public:
   SleepTask(Monitor* sync, int* started_count, int* slept_count, int millis)
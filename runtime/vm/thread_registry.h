@@ -23,7 +23,7 @@ class JSONArray;
 class ThreadRegistry {
  public:
   ThreadRegistry()
-      : threads_lock_(),
+      : threads_lock_(NOT_IN_PRODUCT("ThreadRegistry::threads_lock_")),
         active_list_(NULL),
         free_list_(NULL),
         mutator_thread_(NULL) {}
@@ -5,6 +5,7 @@
 #include "platform/assert.h"
 #include "vm/heap/safepoint.h"
 #include "vm/isolate.h"
+#include "vm/json_stream.h"
 #include "vm/lockers.h"
 #include "vm/profiler.h"
 #include "vm/stack_frame.h"
@@ -80,6 +81,38 @@ VM_UNIT_TEST_CASE(Monitor) {
   delete monitor;
 }
 
+#ifndef PRODUCT
+ISOLATE_UNIT_TEST_CASE(LockContentionProfile) {
+  const bool saved = FLAG_profile_lock_contention;
+  FLAG_profile_lock_contention = true;
+  LockProfiler::Reset();
+  Mutex mutex("LockContentionProfileTest::mutex");
+  Monitor monitor("LockContentionProfileTest::monitor");
+  for (intptr_t i = 0; i < 3; i++) {
+    MutexLocker ml(&mutex);
+  }
+  {
+    MonitorLocker ml(&monitor);
+    ml.WaitMicros(10);
+  }
+  FLAG_profile_lock_contention = saved;
+
+  JSONStream js;
+  LockProfiler::PrintJSON(&js);
+  const char* json = js.ToCString();
+  EXPECT_SUBSTRING("\"type\":\"_LockContentionProfile\"", json);
+  EXPECT_SUBSTRING(
+      "\"name\":\"LockContentionProfileTest::mutex\","
+      "\"acquisitions\":3,\"contentions\":0",
+      json);
+  EXPECT_SUBSTRING(
+      "\"name\":\"LockContentionProfileTest::monitor\","
+      "\"acquisitions\":1,\"contentions\":0",
+      json);
+  LockProfiler::Reset();
+}
+#endif  // !PRODUCT
+
 class ObjectCounter : public ObjectPointerVisitor {
  public:
   explicit ObjectCounter(Isolate* isolate, const Object* obj)
@@ -824,6 +857,16 @@ ISOLATE_UNIT_TEST_CASE(SafepointTestVM2) {
   }
 }
 
+#ifndef PRODUCT
+ISOLATE_UNIT_TEST_CASE(SafepointReachTimeMetric) {
+  Isolate* isolate = thread->isolate();
+  { SafepointOperationScope safepoint_scope(thread); }
+  const int64_t last = isolate->GetSafepointReachTimeMetric()->value();
+  EXPECT_LE(0, last);
+  EXPECT_LE(last, isolate->GetSafepointReachTimeMaxMetric()->value());
+}
+#endif  // !PRODUCT
+
 // Test recursive safepoint operation scopes with other threads trying
 // to also start a safepoint operation scope.
 ISOLATE_UNIT_TEST_CASE(RecursiveSafepointTest2) {
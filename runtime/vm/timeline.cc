@@ -12,11 +12,13 @@
 #include <cstdlib>
 
 #include "platform/atomic.h"
+#include "vm/hash_map.h"
 #include "vm/isolate.h"
 #include "vm/json_stream.h"
 #include "vm/lockers.h"
 #include "vm/log.h"
 #include "vm/object.h"
+#include "vm/object_store.h"
 #include "vm/service.h"
 #include "vm/service_event.h"
 #include "vm/thread.h"
@@ -54,7 +56,13 @@ DEFINE_FLAG(charp,
             timeline_recorder,
             "ring",
             "Select the timeline recorder used. "
-            "Valid values: ring, endless, startup, and systrace.")
+            "Valid values: ring, endless, startup, systrace, and "
+            "perfettofile.")
+DEFINE_FLAG(charp,
+            timeline_perfetto_file,
+            NULL,
+            "Path written by the perfettofile timeline recorder. Defaults to "
+            "dart-timeline-<pid>.pftrace in the current directory.");
 
 // Implementation notes:
 //
@@ -136,6 +144,22 @@ static TimelineEventRecorder* CreateTimelineRecorder() {
     }
   }
 
+  if ((flag != NULL) && (strcmp("perfettofile", flag) == 0)) {
+    if (FLAG_trace_timeline) {
+      THR_Print("Using the perfetto file timeline recorder.\n");
+    }
+    if (FLAG_timeline_perfetto_file != NULL) {
+      return new TimelineEventPerfettoFileRecorder(
+          FLAG_timeline_perfetto_file);
+    }
+    char* path = OS::SCreate(NULL, "dart-timeline-%" Pd ".pftrace",
+                             OS::ProcessId());
+    TimelineEventRecorder* recorder =
+        new TimelineEventPerfettoFileRecorder(path);
+    free(path);
+    return recorder;
+  }
+
   if (use_startup_recorder || (flag != NULL)) {
     if (use_startup_recorder || (strcmp("startup", flag) == 0)) {
       if (FLAG_trace_timeline) {
@@ -993,7 +1017,7 @@ TimelineEvent* TimelineEventRecorder::ThreadBlockStartEvent() {
     MutexLocker ml(&lock_);
     // Thread has a block and it is full:
     // 1) Mark it as finished.
-    thread_block->Finish();
+    FinishBlockLocked(thread_block);
     // 2) Allocate a new block.
     thread_block = GetNewBlockLocked();
     thread->set_timeline_block(thread_block);
@@ -1123,7 +1147,7 @@ void TimelineEventRecorder::FinishBlock(TimelineEventBlock* block) {
     return;
   }
   MutexLocker ml(&lock_);
-  block->Finish();
+  FinishBlockLocked(block);
 }
 
 TimelineEventBlock* TimelineEventRecorder::GetNewBlock() {
@@ -1494,6 +1518,609 @@ void TimelineEventEndlessRecorder::Clear() {
   thread->set_timeline_block(NULL);
 }
 
+// Field numbers from the Perfetto trace protos (protos/perfetto/trace/ in the
+// Perfetto repository).
+enum PerfettoField {
+  // Trace.
+  kTracePacket = 1,
+  // TracePacket.
+  kPacketTimestamp = 8,
+  kPacketSequenceId = 10,
+  kPacketTrackEvent = 11,
+  kPacketInternedData = 12,
+  kPacketSequenceFlags = 13,
+  kPacketTrackDescriptor = 60,
+  // TrackDescriptor.
+  kTrackUuid = 1,
+  kTrackName = 2,
+  kTrackProcess = 3,
+  kTrackThread = 4,
+  kTrackParentUuid = 5,
+  // ProcessDescriptor and ThreadDescriptor.
+  kDescriptorPid = 1,
+  kDescriptorTid = 2,
+  // TrackEvent.
+  kEventCategoryIids = 3,
+  kEventDebugAnnotations = 4,
+  kEventType = 9,
+  kEventNameIid = 10,
+  kEventTrackUuid = 11,
+  kEventFlowIds = 47,
+  kEventTerminatingFlowIds = 48,
+  // DebugAnnotation.
+  kAnnotationStringValue = 6,
+  kAnnotationLegacyJsonValue = 9,
+  kAnnotationName = 10,
+  // InternedData.
+  kInternedEventCategories = 1,
+  kInternedEventNames = 2,
+  // EventCategory and EventName.
+  kInternedIid = 1,
+  kInternedName = 2,
+};
+
+enum PerfettoTrackEventType {
+  kSliceBegin = 1,
+  kSliceEnd = 2,
+  kInstant = 3,
+};
+
+enum PerfettoSequenceFlags {
+  kIncrementalStateCleared = 1,
+  kNeedsIncrementalState = 2,
+};
+
+// All packets are written by the flush thread, so they share one sequence.
+static const uint64_t kPerfettoSequenceId = 1;
+static const uint64_t kProcessTrackUuid = 1;
+
+static uint64_t ThreadTrackUuid(ThreadId tid) {
+  return (static_cast<uint64_t>(OSThread::ThreadIdToIntPtr(tid)) << 2) | 2;
+}
+
+static uint64_t AsyncTrackUuid(int64_t async_id) {
+  return (static_cast<uint64_t>(async_id) << 2) | 3;
+}
+
+class InternedStringTrait {
+ public:
+  typedef const char* Key;
+  typedef uint64_t Value;
+
+  struct Pair {
+    Key key;
+    Value value;
+    Pair() : key(NULL), value(0) {}
+    Pair(const Key key, const Value& value) : key(key), value(value) {}
+    Pair(const Pair& other) : key(other.key), value(other.value) {}
+  };
+
+  static Key KeyOf(Pair kv) { return kv.key; }
+  static Value ValueOf(Pair kv) { return kv.value; }
+  static intptr_t Hashcode(Key key) {
+    return Utils::StringHash(key, strlen(key));
+  }
+  static bool IsKeyEqual(Pair kv, Key key) { return strcmp(kv.key, key) == 0; }
+};
+
+// Maps strings to the interning ids used in a Perfetto sequence.
+class StringInterner {
+ public:
+  StringInterner() {}
+  ~StringInterner() {
+    for (intptr_t i = 0; i < strings_.length(); i++) {
+      free(strings_[i]);
+    }
+  }
+
+  // Sets |*added| if |string| had not been seen before and so has to be
+  // emitted in the packet's interned data.
+  uint64_t Intern(const char* string, bool* added) {
+    InternedStringTrait::Pair* pair = map_.Lookup(string);
+    if (pair != NULL) {
+      *added = false;
+      return pair->value;
+    }
+    char* copy = strdup(string);
+    strings_.Add(copy);
+    const uint64_t iid = strings_.length();
+    map_.Insert(InternedStringTrait::Pair(copy, iid));
+    *added = true;
+    return iid;
+  }
+
+ private:
+  MallocDirectChainedHashMap<InternedStringTrait> map_;
+  MallocGrowableArray<char*> strings_;
+
+  DISALLOW_COPY_AND_ASSIGN(StringInterner);
+};
+
+// Serializes blocks of events into TracePackets and writes them out.
+class TimelineEventPerfettoFileRecorder::Writer {
+ public:
+  explicit Writer(const char* path)
+      : file_(NULL),
+        buffer_(NULL),
+        length_(0),
+        capacity_(0),
+        state_cleared_(false),
+        last_tid_(OSThread::kInvalidThreadId) {
+    Dart_FileOpenCallback file_open = Dart::file_open_callback();
+    if ((path != NULL) && (file_open != NULL) &&
+        (Dart::file_write_callback() != NULL) &&
+        (Dart::file_close_callback() != NULL)) {
+      file_ = (*file_open)(path, true);
+    }
+    if ((path != NULL) && (file_ == NULL)) {
+      OS::PrintErr("Warning: Failed to open timeline file: %s\n", path);
+    }
+    intptr_t packet = BeginMessage(kTracePacket);
+    WriteUInt(kPacketSequenceId, kPerfettoSequenceId);
+    intptr_t track = BeginMessage(kPacketTrackDescriptor);
+    WriteUInt(kTrackUuid, kProcessTrackUuid);
+    intptr_t process = BeginMessage(kTrackProcess);
+    WriteUInt(kDescriptorPid, OS::ProcessId());
+    EndMessage(process);
+    EndMessage(track);
+    EndMessage(packet);
+  }
+
+  ~Writer() {
+    Flush();
+    if (file_ != NULL) {
+      (*Dart::file_close_callback())(file_);
+    }
+    free(buffer_);
+  }
+
+  void WriteBlock(TimelineEventBlock* block) {
+    for (intptr_t i = 0; i < block->length(); i++) {
+      TimelineEvent* event = block->At(i);
+      if (event->IsValid()) {
+        WriteEvent(event);
+      }
+    }
+    if (length_ >= kFlushThreshold) {
+      Flush();
+    }
+  }
+
+  void Flush() {
+    if ((file_ != NULL) && (length_ > 0)) {
+      (*Dart::file_write_callback())(buffer_, length_, file_);
+    }
+    length_ = 0;
+  }
+
+ private:
+  static const intptr_t kFlushThreshold = 64 * KB;
+
+  void WriteEvent(TimelineEvent* event) {
+    if (event->thread() != last_tid_) {
+      WriteThreadDescriptor(event->thread());
+      last_tid_ = event->thread();
+    }
+    const uint64_t thread_track = ThreadTrackUuid(event->thread());
+    switch (event->event_type()) {
+      case TimelineEvent::kDuration:
+        if (event->IsFinishedDuration()) {
+          WriteTrackEvent(event, event->TimeOrigin(), thread_track,
+                          kSliceBegin);
+          WriteTrackEvent(event, event->TimeEnd(), thread_track, kSliceEnd);
+        } else {
+          WriteTrackEvent(event, event->TimeOrigin(), thread_track, kInstant);
+        }
+        break;
+      case TimelineEvent::kBegin:
+        WriteTrackEvent(event, event->TimeOrigin(), thread_track, kSliceBegin);
+        break;
+      case TimelineEvent::kEnd:
+        WriteTrackEvent(event, event->TimeOrigin(), thread_track, kSliceEnd);
+        break;
+      case TimelineEvent::kAsyncBegin:
+        WriteAsyncDescriptor(event);
+        WriteTrackEvent(event, event->TimeOrigin(),
+                        AsyncTrackUuid(event->AsyncId()), kSliceBegin);
+        break;
+      case TimelineEvent::kAsyncInstant:
+        WriteTrackEvent(event, event->TimeOrigin(),
+                        AsyncTrackUuid(event->AsyncId()), kInstant);
+        break;
+      case TimelineEvent::kAsyncEnd:
+        WriteTrackEvent(event, event->TimeOrigin(),
+                        AsyncTrackUuid(event->AsyncId()), kSliceEnd);
+        break;
+      case TimelineEvent::kInstant:
+      case TimelineEvent::kCounter:
+      case TimelineEvent::kFlowBegin:
+      case TimelineEvent::kFlowStep:
+      case TimelineEvent::kFlowEnd:
+        // Counters are kept as instants with their values as arguments so
+        // that no per-counter track state is needed.
+        WriteTrackEvent(event, event->TimeOrigin(), thread_track, kInstant);
+        break;
+      default:
+        // Metadata has no equivalent in a track event.
+        break;
+    }
+  }
+
+  void WriteTrackEvent(TimelineEvent* event,
+                       int64_t micros,
+                       uint64_t track_uuid,
+                       PerfettoTrackEventType type) {
+    const char* category =
+        (event->stream_ != NULL) ? event->stream_->name() : NULL;
+    const char* label = (type != kSliceEnd) ? event->label() : NULL;
+    bool new_category = false;
+    bool new_name = false;
+    const uint64_t category_iid =
+        (category != NULL) ? categories_.Intern(category, &new_category) : 0;
+    const uint64_t name_iid =
+        (label != NULL) ? names_.Intern(label, &new_name) : 0;
+
+    intptr_t packet = BeginMessage(kTracePacket);
+    WriteUInt(kPacketTimestamp, static_cast<uint64_t>(micros) * 1000);
+    WriteUInt(kPacketSequenceId, kPerfettoSequenceId);
+    uint64_t flags = kNeedsIncrementalState;
+    if (!state_cleared_) {
+      flags |= kIncrementalStateCleared;
+      state_cleared_ = true;
+    }
+    WriteUInt(kPacketSequenceFlags, flags);
+    if (new_category || new_name) {
+      intptr_t interned = BeginMessage(kPacketInternedData);
+      if (new_category) {
+        WriteInternedString(kInternedEventCategories, category_iid, category);
+      }
+      if (new_name) {
+        WriteInternedString(kInternedEventNames, name_iid, label);
+      }
+      EndMessage(interned);
+    }
+    intptr_t track_event = BeginMessage(kPacketTrackEvent);
+    WriteUInt(kEventType, type);
+    WriteUInt(kEventTrackUuid, track_uuid);
+    if (category_iid != 0) {
+      WriteUInt(kEventCategoryIids, category_iid);
+    }
+    if (name_iid != 0) {
+      WriteUInt(kEventNameIid, name_iid);
+    }
+    switch (event->event_type()) {
+      case TimelineEvent::kFlowBegin:
+      case TimelineEvent::kFlowStep:
+        WriteFixed64(kEventFlowIds, event->AsyncId());
+        break;
+      case TimelineEvent::kFlowEnd:
+        WriteFixed64(kEventTerminatingFlowIds, event->AsyncId());
+        break;
+      default:
+        break;
+    }
+    if (type != kSliceEnd) {
+      WriteArguments(event);
+    }
+    EndMessage(track_event);
+    EndMessage(packet);
+  }
+
+  void WriteArguments(TimelineEvent* event) {
+    const intptr_t field = event->pre_serialized_args()
+                               ? kAnnotationLegacyJsonValue
+                               : kAnnotationStringValue;
+    for (intptr_t i = 0; i < event->arguments_length(); i++) {
+      const TimelineEventArgument& argument = event->arguments()[i];
+      intptr_t annotation = BeginMessage(kEventDebugAnnotations);
+      WriteString(kAnnotationName, argument.name);
+      WriteString(field, argument.value);
+      EndMessage(annotation);
+    }
+  }
+
+  void WriteThreadDescriptor(ThreadId tid) {
+    for (intptr_t i = 0; i < threads_.length(); i++) {
+      if (threads_[i] == tid) {
+        return;
+      }
+    }
+    threads_.Add(tid);
+    intptr_t packet = BeginMessage(kTracePacket);
+    WriteUInt(kPacketSequenceId, kPerfettoSequenceId);
+    intptr_t track = BeginMessage(kPacketTrackDescriptor);
+    WriteUInt(kTrackUuid, ThreadTrackUuid(tid));
+    WriteUInt(kTrackParentUuid, kProcessTrackUuid);
+    intptr_t thread = BeginMessage(kTrackThread);
+    WriteUInt(kDescriptorPid, OS::ProcessId());
+    WriteUInt(kDescriptorTid, OSThread::ThreadIdToIntPtr(tid));
+    EndMessage(thread);
+    EndMessage(track);
+    EndMessage(packet);
+  }
+
+  // Async ids are not reused, so the descriptor is sent with each begin
+  // instead of remembering every track.
+  void WriteAsyncDescriptor(TimelineEvent* event) {
+    intptr_t packet = BeginMessage(kTracePacket);
+    WriteUInt(kPacketSequenceId, kPerfettoSequenceId);
+    intptr_t track = BeginMessage(kPacketTrackDescriptor);
+    WriteUInt(kTrackUuid, AsyncTrackUuid(event->AsyncId()));
+    WriteUInt(kTrackParentUuid, kProcessTrackUuid);
+    WriteString(kTrackName, event->label());
+    EndMessage(track);
+    EndMessage(packet);
+  }
+
+  void WriteInternedString(intptr_t field, uint64_t iid, const char* string) {
+    intptr_t entry = BeginMessage(field);
+    WriteUInt(kInternedIid, iid);
+    WriteString(kInternedName, string);
+    EndMessage(entry);
+  }
+
+  void Reserve(intptr_t size) {
+    if (length_ + size <= capacity_) {
+      return;
+    }
+    capacity_ = Utils::Maximum(2 * capacity_, length_ + size + kFlushThreshold);
+    buffer_ = reinterpret_cast<uint8_t*>(realloc(buffer_, capacity_));
+    if (buffer_ == NULL) {
+      OUT_OF_MEMORY();
+    }
+  }
+
+  void WriteVarInt(uint64_t value) {
+    Reserve(10);
+    while (value >= 0x80) {
+      buffer_[length_++] = static_cast<uint8_t>(value | 0x80);
+      value >>= 7;
+    }
+    buffer_[length_++] = static_cast<uint8_t>(value);
+  }
+
+  void WriteTag(intptr_t field, intptr_t wire_type) {
+    WriteVarInt((static_cast<uint64_t>(field) << 3) | wire_type);
+  }
+
+  void WriteUInt(intptr_t field, uint64_t value) {
+    WriteTag(field, 0);
+    WriteVarInt(value);
+  }
+
+  void WriteFixed64(intptr_t field, uint64_t value) {
+    WriteTag(field, 1);
+    Reserve(8);
+    for (intptr_t i = 0; i < 8; i++) {
+      buffer_[length_++] = static_cast<uint8_t>(value >> (8 * i));
+    }
+  }
+
+  void WriteString(intptr_t field, const char* value) {
+    if (value == NULL) {
+      return;
+    }
+    const intptr_t length = strlen(value);
+    WriteTag(field, 2);
+    WriteVarInt(length);
+    Reserve(length);
+    memmove(&buffer_[length_], value, length);
+    length_ += length;
+  }
+
+  // Nested messages reserve a fixed four byte length, which is patched by
+  // EndMessage with a redundantly encoded varint as Perfetto itself does.
+  intptr_t BeginMessage(intptr_t field) {
+    WriteTag(field, 2);
+    Reserve(kMessageLengthSize);
+    const intptr_t offset = length_;
+    length_ += kMessageLengthSize;
+    return offset;
+  }
+
+  void EndMessage(intptr_t offset) {
+    const intptr_t size = length_ - offset - kMessageLengthSize;
+    ASSERT(size < (1 << (7 * kMessageLengthSize)));
+    for (intptr_t i = 0; i < kMessageLengthSize; i++) {
+      uint8_t byte = static_cast<uint8_t>((size >> (7 * i)) & 0x7F);
+      if (i < kMessageLengthSize - 1) {
+        byte |= 0x80;
+      }
+      buffer_[offset + i] = byte;
+    }
+  }
+
+  static const intptr_t kMessageLengthSize = 4;
+
+  void* file_;
+  uint8_t* buffer_;
+  intptr_t length_;
+  intptr_t capacity_;
+  bool state_cleared_;
+  ThreadId last_tid_;
+  MallocGrowableArray<ThreadId> threads_;
+  StringInterner categories_;
+  StringInterner names_;
+
+  DISALLOW_COPY_AND_ASSIGN(Writer);
+};
+
+TimelineEventPerfettoFileRecorder::TimelineEventPerfettoFileRecorder(
+    const char* path)
+    : pending_head_(NULL),
+      pending_tail_(NULL),
+      pending_count_(0),
+      free_list_(NULL),
+      dropped_blocks_(0),
+      writing_(false),
+      shutting_down_(false),
+      flush_thread_join_id_(OSThread::kInvalidThreadJoinId),
+      writer_(new Writer(path)) {
+  int result = OSThread::Start("Dart Timeline Flush", &FlushThreadMain,
+                               reinterpret_cast<uword>(this));
+  if (result != 0) {
+    FATAL1("Could not start timeline flush thread: result = %d.", result);
+  }
+}
+
+TimelineEventPerfettoFileRecorder::~TimelineEventPerfettoFileRecorder() {
+  // Hand over the partially filled blocks cached by threads.
+  if (Timeline::recorder() == this) {
+    Timeline::ReclaimCachedBlocksFromThreads();
+  }
+  {
+    MonitorLocker ml(&monitor_);
+    shutting_down_ = true;
+    ml.NotifyAll();
+    while (flush_thread_join_id_ == OSThread::kInvalidThreadJoinId) {
+      ml.Wait();
+    }
+  }
+  OSThread::Join(flush_thread_join_id_);
+  delete writer_;
+  if (FLAG_trace_timeline && (dropped_blocks_ > 0)) {
+    OS::PrintErr("Dropped %" Pd " timeline blocks\n", dropped_blocks_);
+  }
+  for (intptr_t i = 0; i < blocks_.length(); i++) {
+    delete blocks_[i];
+  }
+}
+
+#ifndef PRODUCT
+void TimelineEventPerfettoFileRecorder::PrintJSON(JSONStream* js,
+                                                  TimelineEventFilter* filter) {
+  if (!FLAG_support_service) {
+    return;
+  }
+  JSONObject topLevel(js);
+  topLevel.AddProperty("type", "Timeline");
+  {
+    JSONArray events(&topLevel, "traceEvents");
+    PrintJSONMeta(&events);
+  }
+  topLevel.AddPropertyTimeMicros("timeOriginMicros", TimeOriginMicros());
+  topLevel.AddPropertyTimeMicros("timeExtentMicros", TimeExtentMicros());
+}
+
+void TimelineEventPerfettoFileRecorder::PrintTraceEvent(
+    JSONStream* js,
+    TimelineEventFilter* filter) {
+  if (!FLAG_support_service) {
+    return;
+  }
+  JSONArray events(js);
+}
+#endif
+
+void TimelineEventPerfettoFileRecorder::Flush() {
+  MonitorLocker ml(&monitor_);
+  while ((pending_head_ != NULL) || writing_) {
+    ml.Wait();
+  }
+}
+
+TimelineEvent* TimelineEventPerfettoFileRecorder::StartEvent() {
+  return ThreadBlockStartEvent();
+}
+
+void TimelineEventPerfettoFileRecorder::CompleteEvent(TimelineEvent* event) {
+  if (event == NULL) {
+    return;
+  }
+  ThreadBlockCompleteEvent(event);
+}
+
+TimelineEventBlock* TimelineEventPerfettoFileRecorder::GetNewBlockLocked() {
+  TimelineEventBlock* block = NULL;
+  {
+    MonitorLocker ml(&monitor_);
+    block = free_list_;
+    if (block != NULL) {
+      free_list_ = block->next();
+    }
+  }
+  if (block == NULL) {
+    block = new TimelineEventBlock(blocks_.length());
+    blocks_.Add(block);
+    if (FLAG_trace_timeline) {
+      OS::PrintErr("Created new block %p\n", block);
+    }
+  }
+  block->set_next(NULL);
+  block->Open();
+  return block;
+}
+
+void TimelineEventPerfettoFileRecorder::FinishBlockLocked(
+    TimelineEventBlock* block) {
+  block->Finish();
+  MonitorLocker ml(&monitor_);
+  if (block->IsEmpty() || (pending_count_ >= kMaxPendingBlocks)) {
+    // Nothing to write, or the flush thread is too far behind: recycle the
+    // block straight away rather than grow without bound.
+    if (!block->IsEmpty()) {
+      dropped_blocks_++;
+    }
+    block->Reset();
+    block->set_next(free_list_);
+    free_list_ = block;
+    return;
+  }
+  block->set_next(NULL);
+  if (pending_tail_ == NULL) {
+    pending_head_ = block;
+  } else {
+    pending_tail_->set_next(block);
+  }
+  pending_tail_ = block;
+  pending_count_++;
+  ml.NotifyAll();
+}
+
+void TimelineEventPerfettoFileRecorder::FlushThreadMain(uword parameters) {
+  TimelineEventPerfettoFileRecorder* recorder =
+      reinterpret_cast<TimelineEventPerfettoFileRecorder*>(parameters);
+  recorder->FlushLoop();
+}
+
+void TimelineEventPerfettoFileRecorder::FlushLoop() {
+  MonitorLocker ml(&monitor_);
+  flush_thread_join_id_ = OSThread::GetCurrentThreadJoinId(OSThread::Current());
+  ml.NotifyAll();
+  while (true) {
+    while ((pending_head_ == NULL) && !shutting_down_) {
+      ml.Wait();
+    }
+    if (pending_head_ == NULL) {
+      // Shutting down and everything has been written.
+      break;
+    }
+    TimelineEventBlock* head = pending_head_;
+    pending_head_ = NULL;
+    pending_tail_ = NULL;
+    pending_count_ = 0;
+    writing_ = true;
+
+    // Serialize without holding the monitor so threads can keep handing
+    // over blocks.
+    ml.Exit();
+    TimelineEventBlock* tail = NULL;
+    for (TimelineEventBlock* block = head; block != NULL;
+         block = block->next()) {
+      writer_->WriteBlock(block);
+      block->Reset();
+      tail = block;
+    }
+    writer_->Flush();
+    ml.Enter();
+
+    tail->set_next(free_list_);
+    free_list_ = head;
+    writing_ = false;
+    ml.NotifyAll();
+  }
+}
+
 TimelineEventBlock::TimelineEventBlock(intptr_t block_index)
     : next_(NULL),
       length_(0),
@@ -1659,11 +2286,11 @@ void DartTimelineEventHelpers::ReportCompleteEvent(Thread* thread,
                                                    TimelineEvent* event,
                                                    int64_t start,
                                                    int64_t start_cpu,
+                                                   int64_t end,
+                                                   int64_t end_cpu,
                                                    const char* category,
                                                    char* name,
                                                    char* args) {
-  const int64_t end = OS::GetCurrentMonotonicMicros();
-  const int64_t end_cpu = OS::GetCurrentThreadCPUMicros();
   event->Duration(name, start, end, start_cpu, end_cpu);
   event->set_owns_label(true);
   event->CompleteWithPreSerializedArgs(args);
@@ -1709,6 +2336,124 @@ void DartTimelineEventHelpers::ReportInstantEvent(Thread* thread,
   event->CompleteWithPreSerializedArgs(args);
 }
 
+// The kinds of events buffered by _TimelineBuffer in timeline.dart.
+enum BufferedEventKind {
+  kCompleteEvent = 0,
+  kInstantEvent = 1,
+  kFlowEvent = 2,
+  kTaskEvent = 3,
+};
+
+// The layout of an event in the buffers of _TimelineBuffer.
+static const intptr_t kNumbersPerEvent = 5;
+static const intptr_t kStringsPerEvent = 3;
+
+void DartTimelineEventHelpers::ReportBufferedEvents(Thread* thread,
+                                                    const TypedData& numbers,
+                                                    const Array& strings,
+                                                    intptr_t length) {
+  ASSERT(numbers.Length() >= length * kNumbersPerEvent);
+  ASSERT(strings.Length() >= length * kStringsPerEvent);
+
+  TimelineEventRecorder* recorder = Timeline::recorder();
+  if (recorder == NULL) {
+    return;
+  }
+
+  Zone* zone = thread->zone();
+  String& category = String::Handle(zone);
+  String& name = String::Handle(zone);
+  String& args = String::Handle(zone);
+  for (intptr_t i = 0; i < length; i++) {
+    // The kind of the event followed by its timestamps and ids.
+    int64_t values[kNumbersPerEvent];
+    const intptr_t offset = i * kNumbersPerEvent * sizeof(int64_t);
+    for (intptr_t j = 0; j < kNumbersPerEvent; j++) {
+      values[j] = numbers.GetInt64(offset + j * sizeof(int64_t));
+    }
+    category ^= strings.At(i * kStringsPerEvent);
+    name ^= strings.At(i * kStringsPerEvent + 1);
+    args ^= strings.At(i * kStringsPerEvent + 2);
+
+    TimelineEvent* event = Timeline::GetDartStream()->StartEvent();
+    if (event == NULL) {
+      // Stream was turned off.
+      break;
+    }
+
+    switch (values[0]) {
+      case kCompleteEvent:
+        ReportCompleteEvent(thread, event, values[1], values[2], values[3],
+                            values[4], category.ToCString(),
+                            name.ToMallocCString(), args.ToMallocCString());
+        break;
+      case kInstantEvent:
+        ReportInstantEvent(thread, event, values[1], category.ToCString(),
+                           name.ToMallocCString(), args.ToMallocCString());
+        break;
+      case kFlowEvent:
+        ReportFlowEvent(thread, event, values[1], values[2],
+                        category.ToCString(), name.ToMallocCString(), values[3],
+                        values[4], args.ToMallocCString());
+        break;
+      case kTaskEvent: {
+        const char phase[] = {static_cast<char>(values[3]), '\0'};
+        ReportTaskEvent(thread, event, values[1], values[2], phase,
+                        category.ToCString(), name.ToMallocCString(),
+                        args.ToMallocCString());
+        break;
+      }
+      default:
+        UNREACHABLE();
+    }
+  }
+}
+
+void DartTimelineEventHelpers::FlushBufferedEvents(Thread* thread) {
+  ObjectStore* object_store = thread->isolate()->object_store();
+  if (object_store == NULL) {
+    return;
+  }
+  Zone* zone = thread->zone();
+  const Library& lib =
+      Library::Handle(zone, object_store->developer_library());
+  if (lib.IsNull()) {
+    return;
+  }
+  const Class& cls = Class::Handle(
+      zone, lib.LookupClassAllowPrivate(
+                String::Handle(zone, String::New("_TimelineBuffer"))));
+  if (cls.IsNull() || !cls.is_finalized()) {
+    return;  // No event was ever buffered.
+  }
+  const Field& length_field =
+      Field::Handle(zone, cls.LookupStaticFieldAllowPrivate(
+                              String::Handle(zone, String::New("_length"))));
+  const Field& numbers_field =
+      Field::Handle(zone, cls.LookupStaticFieldAllowPrivate(
+                              String::Handle(zone, String::New("_numbers"))));
+  const Field& strings_field =
+      Field::Handle(zone, cls.LookupStaticFieldAllowPrivate(
+                              String::Handle(zone, String::New("_strings"))));
+  if (length_field.IsNull() || numbers_field.IsNull() ||
+      strings_field.IsNull()) {
+    return;
+  }
+  // Fields that were never initialized hold a sentinel.
+  const Instance& length = Instance::Handle(zone, length_field.StaticValue());
+  const Instance& numbers =
+      Instance::Handle(zone, numbers_field.StaticValue());
+  const Instance& strings =
+      Instance::Handle(zone, strings_field.StaticValue());
+  if (!length.IsSmi() || (Smi::Cast(length).Value() == 0) ||
+      !numbers.IsTypedData() || !strings.IsArray()) {
+    return;
+  }
+  ReportBufferedEvents(thread, TypedData::Cast(numbers), Array::Cast(strings),
+                       Smi::Cast(length).Value());
+  length_field.SetStaticValue(Smi::Handle(zone, Smi::New(0)));
+}
+
 }  // namespace dart
 
 #endif  // defined(SUPPORT_TIMELINE)
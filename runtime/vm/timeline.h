@@ -21,6 +21,7 @@
 
 namespace dart {
 
+class Array;
 class JSONArray;
 class JSONObject;
 class JSONStream;
@@ -33,12 +34,14 @@ class TimelineEvent;
 class TimelineEventBlock;
 class TimelineEventRecorder;
 class TimelineStream;
+class TypedData;
 class VirtualMemory;
 class Zone;
 
 #define CALLBACK_RECORDER_NAME "Callback"
 #define ENDLESS_RECORDER_NAME "Endless"
 #define FUCHSIA_RECORDER_NAME "Fuchsia"
+#define PERFETTO_FILE_RECORDER_NAME "PerfettoFile"
 #define RING_RECORDER_NAME "Ring"
 #define STARTUP_RECORDER_NAME "Startup"
 #define SYSTRACE_RECORDER_NAME "Systrace"
@@ -456,6 +459,7 @@ class TimelineEvent {
   friend class TimelineEventStartupRecorder;
   friend class TimelineEventPlatformRecorder;
   friend class TimelineEventFuchsiaRecorder;
+  friend class TimelineEventPerfettoFileRecorder;
   friend class TimelineStream;
   friend class TimelineTestHelper;
   DISALLOW_COPY_AND_ASSIGN(TimelineEvent);
@@ -638,6 +642,7 @@ class TimelineEventBlock {
   friend class TimelineEventRingRecorder;
   friend class TimelineEventStartupRecorder;
   friend class TimelineEventPlatformRecorder;
+  friend class TimelineEventPerfettoFileRecorder;
   friend class TimelineTestHelper;
   friend class JSONStream;
 
@@ -728,6 +733,11 @@ class TimelineEventRecorder {
   virtual TimelineEventBlock* GetNewBlockLocked() = 0;
   virtual void Clear() = 0;
 
+  // Called with |lock_| held once a thread is done writing to |block|.
+  virtual void FinishBlockLocked(TimelineEventBlock* block) {
+    block->Finish();
+  }
+
   // Utility method(s).
 #ifndef PRODUCT
   void PrintJSONMeta(JSONArray* array) const;
@@ -872,6 +882,64 @@ class TimelineEventEndlessRecorder : public TimelineEventRecorder {
   friend class TimelineTestHelper;
 };
 
+// A recorder that streams events to a file in the Perfetto protobuf trace
+// format (https://perfetto.dev/docs/reference/trace-packet-proto). Threads
+// fill blocks as with the endless recorder, but finished blocks are handed to
+// a background thread that serializes them, interning event names and
+// categories, and then recycles them. Nothing is kept in memory for the
+// service protocol.
+class TimelineEventPerfettoFileRecorder : public TimelineEventRecorder {
+ public:
+  // Finished blocks are dropped while this many are waiting to be written.
+  static const intptr_t kMaxPendingBlocks = 1024;
+
+  // Writes to |path| using the embedder's file callbacks. If |path| is NULL
+  // or cannot be opened, events are recorded and discarded.
+  explicit TimelineEventPerfettoFileRecorder(const char* path);
+  virtual ~TimelineEventPerfettoFileRecorder();
+
+#ifndef PRODUCT
+  void PrintJSON(JSONStream* js, TimelineEventFilter* filter);
+  void PrintTraceEvent(JSONStream* js, TimelineEventFilter* filter);
+#endif
+
+  const char* name() const { return PERFETTO_FILE_RECORDER_NAME; }
+
+  // Blocks until all finished blocks have been written out.
+  void Flush();
+
+ protected:
+  TimelineEvent* StartEvent();
+  void CompleteEvent(TimelineEvent* event);
+  TimelineEventBlock* GetNewBlockLocked();
+  TimelineEventBlock* GetHeadBlockLocked() { return NULL; }
+  void FinishBlockLocked(TimelineEventBlock* block);
+  void Clear() {}
+
+ private:
+  class Writer;
+
+  static void FlushThreadMain(uword parameters);
+  void FlushLoop();
+
+  // Guarded by |lock_|.
+  MallocGrowableArray<TimelineEventBlock*> blocks_;
+
+  // Guarded by |monitor_|.
+  Monitor monitor_;
+  TimelineEventBlock* pending_head_;
+  TimelineEventBlock* pending_tail_;
+  intptr_t pending_count_;
+  TimelineEventBlock* free_list_;
+  intptr_t dropped_blocks_;
+  bool writing_;
+  bool shutting_down_;
+  ThreadJoinId flush_thread_join_id_;
+
+  // Only used by the flush thread.
+  Writer* writer_;
+};
+
 // An iterator for blocks.
 class TimelineEventBlockIterator {
  public:
@@ -970,6 +1038,8 @@ class DartTimelineEventHelpers : public AllStatic {
                                   TimelineEvent* event,
                                   int64_t start,
                                   int64_t start_cpu,
+                                  int64_t end,
+                                  int64_t end_cpu,
                                   const char* category,
                                   char* name,
                                   char* args);
@@ -990,6 +1060,17 @@ class DartTimelineEventHelpers : public AllStatic {
                                  const char* category,
                                  char* name,
                                  char* args);
+
+  // Reports the events buffered by _TimelineBuffer in dart:developer, see
+  // runtime/lib/timeline.dart.
+  static void ReportBufferedEvents(Thread* thread,
+                                   const TypedData& numbers,
+                                   const Array& strings,
+                                   intptr_t length);
+
+  // Reports the events still in the buffer of _TimelineBuffer, e.g. when the
+  // isolate shuts down.
+  static void FlushBufferedEvents(Thread* thread);
 };
 
 }  // namespace dart
@@ -497,6 +497,29 @@ TEST_CASE(TimelineRingRecorderJSONOrder) {
   delete recorder;
 }
 
+TEST_CASE(TimelinePerfettoFileRecorderRecyclesBlocks) {
+  TimelineStream stream("testStream", "testStream", true);
+
+  // Without a file the events are serialized and discarded.
+  TimelineEventPerfettoFileRecorder* recorder =
+      new TimelineEventPerfettoFileRecorder(NULL);
+
+  TimelineEventBlock* block = recorder->GetNewBlock();
+  EXPECT(block != NULL);
+  TimelineTestHelper::FakeThreadEvent(block, 2, "Alpha", &stream);
+  TimelineTestHelper::FakeThreadEvent(block, 2, "Beta", &stream);
+  EXPECT_EQ(2, block->length());
+  recorder->FinishBlock(block);
+
+  // Once written, the block is reset and handed out again.
+  recorder->Flush();
+  EXPECT(block == recorder->GetNewBlock());
+  EXPECT(block->IsEmpty());
+  recorder->FinishBlock(block);
+
+  delete recorder;
+}
+
 TEST_CASE(TimelinePauses_Basic) {
   TimelineEventEndlessRecorder* recorder = new TimelineEventEndlessRecorder();
   ASSERT(recorder != NULL);
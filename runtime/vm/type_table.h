@@ -11,6 +11,14 @@
 
 namespace dart {
 
+// The canonical tables of types, type arguments and constants are looked up
+// without the canonicalization mutexes, so that background compilers
+// canonicalize in parallel; only insertions take the mutexes. Insertions
+// only fill unused entries and growing a table replaces its array, so a
+// concurrent lookup either finds an entry or misses it and retries under the
+// mutex. Lookups therefore must not store the table back. Entries are only
+// removed at safepoints.
+
 class CanonicalTypeKey {
  public:
   explicit CanonicalTypeKey(const Type& key) : key_(key) {}
@@ -303,6 +303,146 @@ void TypeTestingStubGenerator::BuildOptimizedSubtypeRangeCheck(
   __ Bind(&cid_range_failed);
 }
 
+// Returns the type arguments of [type_class] when seen as a supertype of
+// [cls], expressed in terms of the type parameters of [cls], or null if
+// [type_class] is not a supertype of [cls] (or its type arguments are raw).
+static RawTypeArguments* SupertypeArgumentsFor(Zone* zone,
+                                               const Class& cls,
+                                               const Class& type_class) {
+  AbstractType& supertype = AbstractType::Handle(zone, cls.super_type());
+  const Array& interfaces = Array::Handle(zone, cls.interfaces());
+  const intptr_t num_interfaces = interfaces.IsNull() ? 0 : interfaces.Length();
+  Class& supertype_class = Class::Handle(zone);
+  TypeArguments& supertype_args = TypeArguments::Handle(zone);
+  TypeArguments& result = TypeArguments::Handle(zone);
+  for (intptr_t i = -1; i < num_interfaces; ++i) {
+    if (i >= 0) {
+      supertype ^= interfaces.At(i);
+    }
+    if (supertype.IsNull() || !supertype.IsType() ||
+        !supertype.IsFinalized()) {
+      continue;
+    }
+    supertype_class = supertype.type_class();
+    supertype_args = supertype.arguments();
+    if (supertype_class.raw() == type_class.raw()) {
+      return supertype_args.raw();
+    }
+    result = SupertypeArgumentsFor(zone, supertype_class, type_class);
+    if (!result.IsNull()) {
+      if (!result.IsInstantiated()) {
+        result = result.InstantiateFrom(supertype_args,
+                                        Object::null_type_arguments(),
+                                        kAllFree, nullptr, Heap::kOld);
+      }
+      return result.raw();
+    }
+  }
+  return TypeArguments::null();
+}
+
+static void AddCidToRanges(CidRangeVector* ranges, intptr_t cid) {
+  if (ranges->length() > 0 && ranges->Last().cid_end == cid - 1) {
+    ranges->Last().cid_end = cid;
+  } else {
+    ranges->Add(CidRange(cid, cid));
+  }
+}
+
+// Splits the concrete subtypes of the implemented class [type_class] into
+//
+//   * [nongeneric_ranges]: classes without type arguments which are known to
+//     be subtypes of `type_class<ta>`, and
+//   * [generic_ranges]: classes which store their type argument vector at
+//     [*type_arguments_field_offset] and have the type arguments of
+//     [type_class] at the same positions in it as [type_class] itself.
+//
+// All remaining subtypes have to be checked on the slow path.
+static void BuildImplementorRanges(HierarchyInfo* hi,
+                                   const Class& type_class,
+                                   const TypeArguments& ta,
+                                   CidRangeVector* nongeneric_ranges,
+                                   CidRangeVector* generic_ranges,
+                                   intptr_t* type_arguments_field_offset) {
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+  ClassTable* table = thread->isolate()->class_table();
+
+  const intptr_t num_type_parameters = type_class.NumTypeParameters();
+  const intptr_t num_type_arguments = type_class.NumTypeArguments();
+  const intptr_t first_type_param_value =
+      num_type_arguments - num_type_parameters;
+  const bool ta_is_instantiated = ta.IsInstantiated();
+  intptr_t field_offset = Class::kNoTypeArguments;
+
+  const CidRangeVector& ranges =
+      hi->SubtypeRangesForClass(type_class,
+                                /*include_abstract=*/false,
+                                /*exclude_null=*/false);
+  Class& cls = Class::Handle(zone);
+  TypeArguments& args = TypeArguments::Handle(zone);
+  AbstractType& arg = AbstractType::Handle(zone);
+  AbstractType& expected = AbstractType::Handle(zone);
+  for (intptr_t i = 0; i < ranges.length(); ++i) {
+    const CidRange& range = ranges[i];
+    if (range.IsIllegalRange()) continue;
+    for (intptr_t cid = range.cid_start; cid <= range.cid_end; ++cid) {
+      if (!table->HasValidClassAt(cid)) continue;
+      cls = table->At(cid);
+      if (cls.is_abstract() || !cls.is_finalized()) continue;
+
+      if (cls.NumTypeArguments() == 0) {
+        if (!ta_is_instantiated) continue;
+        args = SupertypeArgumentsFor(zone, cls, type_class);
+        if (args.IsNull() || args.Length() != num_type_arguments) continue;
+        bool is_subtype = true;
+        for (intptr_t j = first_type_param_value; j < num_type_arguments;
+             ++j) {
+          arg = args.TypeAt(j);
+          expected = ta.TypeAt(j);
+          if (!arg.IsSubtypeOf(expected, Heap::kOld)) {
+            is_subtype = false;
+            break;
+          }
+        }
+        if (is_subtype) {
+          AddCidToRanges(nongeneric_ranges, cid);
+        }
+        continue;
+      }
+
+      const intptr_t cls_field_offset = cls.type_arguments_field_offset();
+      if (cls_field_offset == Class::kNoTypeArguments) continue;
+      if (field_offset != Class::kNoTypeArguments &&
+          field_offset != cls_field_offset) {
+        continue;
+      }
+      if (cls.raw() != type_class.raw()) {
+        args = SupertypeArgumentsFor(zone, cls, type_class);
+        if (args.IsNull() || args.Length() != num_type_arguments) continue;
+        bool is_compatible = true;
+        for (intptr_t j = first_type_param_value; j < num_type_arguments;
+             ++j) {
+          arg = args.TypeAt(j);
+          if (!arg.IsTypeParameter() ||
+              !TypeParameter::Cast(arg).IsClassTypeParameter() ||
+              TypeParameter::Cast(arg).index() != j) {
+            is_compatible = false;
+            break;
+          }
+        }
+        if (!is_compatible) continue;
+      }
+      if (field_offset == Class::kNoTypeArguments) {
+        field_offset = cls_field_offset;
+        *type_arguments_field_offset =
+            compiler::target::Class::TypeArgumentsFieldOffset(cls);
+      }
+      AddCidToRanges(generic_ranges, cid);
+    }
+  }
+}
+
 void TypeTestingStubGenerator::
     BuildOptimizedSubclassRangeCheckWithTypeArguments(
         Assembler* assembler,
@@ -315,17 +455,44 @@ void TypeTestingStubGenerator::
         const Register instance_type_args_reg) {
   // a) First we make a quick sub*class* cid-range check.
   Label check_failed;
-  ASSERT(!type_class.is_implemented());
-  const CidRangeVector& ranges = hi->SubclassRangesForClass(type_class);
-  BuildOptimizedSubclassRangeCheck(assembler, ranges, class_id_reg,
-                                   instance_reg, &check_failed);
+  intptr_t type_arguments_field_offset =
+      compiler::target::Class::TypeArgumentsFieldOffset(type_class);
+  if (!type_class.is_implemented()) {
+    const CidRangeVector& ranges = hi->SubclassRangesForClass(type_class);
+    BuildOptimizedSubclassRangeCheck(assembler, ranges, class_id_reg,
+                                     instance_reg, &check_failed);
+  } else {
+    // The implementations of [type_class] can store its type arguments in
+    // different ways, so we only handle those which are known to be subtypes
+    // without looking at the type arguments and those which agree on where
+    // the type arguments are.  Everything else goes to the slow path.
+    CidRangeVector nongeneric_ranges;
+    CidRangeVector generic_ranges;
+    BuildImplementorRanges(hi, type_class, ta, &nongeneric_ranges,
+                           &generic_ranges, &type_arguments_field_offset);
+    if (nongeneric_ranges.length() > 0) {
+      Label is_subtype, not_subtype;
+      __ LoadClassIdMayBeSmi(class_id_reg, instance_reg);
+      FlowGraphCompiler::GenerateCidRangesCheck(assembler, class_id_reg,
+                                                nongeneric_ranges, &is_subtype,
+                                                &not_subtype, true);
+      __ Bind(&is_subtype);
+      __ Ret();
+      __ Bind(&not_subtype);
+    }
+    if (generic_ranges.length() == 0) {
+      __ Jump(&check_failed);
+    } else {
+      BuildOptimizedSubclassRangeCheck(assembler, generic_ranges,
+                                       class_id_reg, instance_reg,
+                                       &check_failed);
+    }
+  }
   // fall through to continue
 
   // b) Then we'll load the values for the type parameters.
   __ LoadField(instance_type_args_reg,
-               FieldAddress(instance_reg,
-                            compiler::target::Class::TypeArgumentsFieldOffset(
-                                type_class)));
+               FieldAddress(instance_reg, type_arguments_field_offset));
 
   // The kernel frontend should fill in any non-assigned type parameters on
   // construction with dynamic/Object, so we should never get the null type
@@ -857,6 +1024,53 @@ bool TypeUsageInfo::IsUsedInTypeTest(const AbstractType& type) {
   return false;
 }
 
+#if !defined(PRODUCT)
+
+TypeCheckStats::~TypeCheckStats() {
+  auto it = entries_.GetIterator();
+  for (Entry** entry = it.Next(); entry != nullptr; entry = it.Next()) {
+    free((*entry)->name);
+    delete *entry;
+  }
+}
+
+void TypeCheckStats::Record(const AbstractType& type) {
+  const char* name = type.ToCString();
+  Entry** entry = entries_.Lookup(name);
+  if (entry != nullptr) {
+    (*entry)->count++;
+    return;
+  }
+  entries_.Insert(new Entry{strdup(name), 1});
+}
+
+int TypeCheckStats::CompareByCount(Entry* const* a, Entry* const* b) {
+  if ((*a)->count != (*b)->count) {
+    return (*a)->count > (*b)->count ? -1 : 1;
+  }
+  return strcmp((*a)->name, (*b)->name);
+}
+
+void TypeCheckStats::Print() const {
+  MallocGrowableArray<Entry*> sorted(entries_.Length());
+  intptr_t total = 0;
+  auto it = entries_.GetIterator();
+  for (Entry** entry = it.Next(); entry != nullptr; entry = it.Next()) {
+    sorted.Add(*entry);
+    total += (*entry)->count;
+  }
+  sorted.Sort(CompareByCount);
+
+  OS::PrintErr("%" Pd " type checks against %" Pd
+               " types were done in the runtime:\n",
+               total, sorted.length());
+  for (intptr_t i = 0; i < sorted.length(); i++) {
+    OS::PrintErr("  %10" Pd "  %s\n", sorted[i]->count, sorted[i]->name);
+  }
+}
+
+#endif  // !defined(PRODUCT)
+
 #if !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
 
 void DeoptimizeTypeTestingStubs() {
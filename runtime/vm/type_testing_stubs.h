@@ -7,6 +7,7 @@
 
 #include "vm/compiler/assembler/assembler.h"
 #include "vm/compiler/backend/il.h"
+#include "vm/hash_map.h"
 
 namespace dart {
 
@@ -390,6 +391,52 @@ void RegisterTypeArgumentsUse(const Function& function,
                               const Class& klass,
                               Definition* type_arguments);
 
+#if !defined(PRODUCT)
+
+// Counts the type checks which had to be done in the runtime because neither
+// inlined code nor a type testing stub could decide them, grouped by the
+// destination type (see --dump_type_check_stats).
+class TypeCheckStats {
+ public:
+  TypeCheckStats() {}
+  ~TypeCheckStats();
+
+  void Record(const AbstractType& type);
+
+  // Prints the destination types in order of decreasing number of checks.
+  void Print() const;
+
+ private:
+  struct Entry {
+    char* name;
+    intptr_t count;
+  };
+
+  static int CompareByCount(Entry* const* a, Entry* const* b);
+
+  class EntryTrait {
+   public:
+    typedef Entry* Value;
+    typedef const char* Key;
+    typedef Entry* Pair;
+
+    static Key KeyOf(Pair kv) { return kv->name; }
+    static Value ValueOf(Pair kv) { return kv; }
+    static intptr_t Hashcode(Key key) {
+      return Utils::StringHash(key, strlen(key));
+    }
+    static bool IsKeyEqual(Pair kv, Key key) {
+      return strcmp(kv->name, key) == 0;
+    }
+  };
+
+  MallocDirectChainedHashMap<EntryTrait> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(TypeCheckStats);
+};
+
+#endif  // !defined(PRODUCT)
+
 #if !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
 
 void DeoptimizeTypeTestingStubs();
@@ -17,6 +17,11 @@ bool VirtualMemory::InSamePage(uword address0, uword address1) {
 void VirtualMemory::Truncate(intptr_t new_size) {
   ASSERT(Utils::IsAligned(new_size, PageSize()));
   ASSERT(new_size <= size());
+  if (in_huge_page_chunk_ || in_heap_cage_) {
+    // Parts of a chunk slot or of a cage range are not given back on their
+    // own.
+    return;
+  }
   if (reserved_.size() ==
       region_.size()) {  // Don't create holes in reservation.
     FreeSubSegment(reinterpret_cast<void*>(start() + new_size),
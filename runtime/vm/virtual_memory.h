@@ -41,6 +41,11 @@ class VirtualMemory {
   static void Protect(void* address, intptr_t size, Protection mode);
   void Protect(Protection mode) { return Protect(address(), size(), mode); }
 
+  // Tells the OS that the contents of the page aligned range are no longer
+  // needed, so it can reclaim the memory backing it. The range stays
+  // accessible; its contents are undefined until written again.
+  static void DontNeed(void* address, intptr_t size);
+
   // Reserves and commits a virtual memory segment with size. If a segment of
   // the requested size cannot be allocated, NULL is returned.
   static VirtualMemory* Allocate(intptr_t size,
@@ -53,6 +58,31 @@ class VirtualMemory {
                                         bool is_executable,
                                         const char* name);
 
+  // Allocates a [size] slot of a 2MB chunk which the OS is asked to back with
+  // huge pages (see --use_huge_pages). Returns NULL if huge pages are not
+  // enabled or not supported for this kind of memory, or if [size] is not the
+  // slot size of the chunks.
+  static VirtualMemory* AllocateInHugePageChunk(intptr_t size,
+                                                bool is_executable,
+                                                const char* name);
+
+  // Reports the memory reserved in huge page chunks and how much of it is
+  // currently backed by huge pages.
+  static void HugePageUsage(intptr_t* reserved_in_bytes,
+                            intptr_t* backed_in_bytes);
+
+  // Allocates a heap page aligned segment of at least [size] bytes in the
+  // heap cage, a 4GB aligned 4GB reservation holding all of the Dart heap in
+  // DART_HEAP_CAGE builds. Heap pointers are not compressed; the cage only
+  // guarantees every heap address lies within 4GB of HeapCageBase(). Returns
+  // NULL in other builds or if the cage is full.
+  static VirtualMemory* AllocateInHeapCage(intptr_t size,
+                                           bool is_executable,
+                                           const char* name);
+
+  // The base of the heap cage, or 0 if there is none.
+  static uword HeapCageBase();
+
   static intptr_t PageSize() {
     ASSERT(page_size_ != 0);
     ASSERT(Utils::IsPowerOfTwo(page_size_));
@@ -81,10 +111,18 @@ class VirtualMemory {
   VirtualMemory(const MemoryRegion& region,
                 const MemoryRegion& alias,
                 const MemoryRegion& reserved)
-      : region_(region), alias_(alias), reserved_(reserved) {}
+      : region_(region),
+        alias_(alias),
+        reserved_(reserved),
+        in_huge_page_chunk_(false),
+        in_heap_cage_(false) {}
 
   VirtualMemory(const MemoryRegion& region, const MemoryRegion& reserved)
-      : region_(region), alias_(region), reserved_(reserved) {}
+      : region_(region),
+        alias_(region),
+        reserved_(reserved),
+        in_huge_page_chunk_(false),
+        in_heap_cage_(false) {}
 
   MemoryRegion region_;
 
@@ -97,6 +135,14 @@ class VirtualMemory {
   // Its size might disagree with region_ due to Truncate.
   MemoryRegion reserved_;
 
+  // True if region_ is a slot of a huge page chunk, which is returned to the
+  // chunk instead of being unmapped. Such regions are never truncated.
+  bool in_huge_page_chunk_;
+
+  // True if reserved_ is a range of the heap cage, which is returned to the
+  // cage instead of being unmapped. Such regions are never truncated.
+  bool in_heap_cage_;
+
   static uword page_size_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(VirtualMemory);
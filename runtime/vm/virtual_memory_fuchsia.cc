@@ -140,6 +140,30 @@ VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
   return result;
 }
 
+VirtualMemory* VirtualMemory::AllocateInHugePageChunk(intptr_t size,
+                                                      bool is_executable,
+                                                      const char* name) {
+  // Huge page chunks are only implemented for Linux and Android.
+  return NULL;
+}
+
+void VirtualMemory::HugePageUsage(intptr_t* reserved_in_bytes,
+                                  intptr_t* backed_in_bytes) {
+  *reserved_in_bytes = 0;
+  *backed_in_bytes = 0;
+}
+
+VirtualMemory* VirtualMemory::AllocateInHeapCage(intptr_t size,
+                                                 bool is_executable,
+                                                 const char* name) {
+  // The heap cage is only implemented for POSIX hosts.
+  return NULL;
+}
+
+uword VirtualMemory::HeapCageBase() {
+  return 0;
+}
+
 VirtualMemory::~VirtualMemory() {
   // Reserved region may be empty due to VirtualMemory::Truncate.
   if (vm_owns_region() && reserved_.size() != 0) {
@@ -163,6 +187,13 @@ void VirtualMemory::FreeSubSegment(void* address, intptr_t size) {
   LOG_INFO("zx_vmar_unmap(0x%p, 0x%lx) success\n", address, size);
 }
 
+void VirtualMemory::DontNeed(void* address, intptr_t size) {
+  ASSERT(Utils::IsAligned(address, PageSize()));
+  ASSERT(Utils::IsAligned(size, PageSize()));
+  // The VMOs backing the mappings are not kept, so their pages cannot be
+  // decommitted.
+}
+
 void VirtualMemory::Protect(void* address, intptr_t size, Protection mode) {
 #if defined(DEBUG)
   Thread* thread = Thread::Current();
@@ -17,6 +17,7 @@
 #include "platform/assert.h"
 #include "platform/utils.h"
 #include "vm/isolate.h"
+#include "vm/lockers.h"
 
 // #define VIRTUAL_MEMORY_LOGGING 1
 #if defined(VIRTUAL_MEMORY_LOGGING)
@@ -40,11 +41,133 @@ DECLARE_FLAG(bool, generate_perf_events_symbols);
 DECLARE_FLAG(bool, generate_perf_jitdump);
 #endif
 
+#if defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID)
+#define HUGE_PAGE_CHUNKS_SUPPORTED
+DEFINE_FLAG(bool,
+            use_huge_pages,
+            false,
+            "Allocate old space pages in 2MB chunks which are backed by "
+            "transparent huge pages.");
+DEFINE_FLAG(bool,
+            use_hugetlb_pages,
+            false,
+            "Back huge page chunks with MAP_HUGETLB pages when the system has "
+            "them reserved (requires --use_huge_pages).");
+DEFINE_FLAG(bool,
+            use_huge_pages_for_code,
+            false,
+            "Also allocate code pages in huge page chunks (requires "
+            "--use_huge_pages and --no_write_protect_code).");
+#endif  // defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID)
+
 uword VirtualMemory::page_size_ = 0;
 
+#if defined(HUGE_PAGE_CHUNKS_SUPPORTED)
+static const intptr_t kHugePageSize = 2 * MB;
+static const intptr_t kHugePageChunkSlotSize = 256 * KB;
+static const intptr_t kHugePageChunkSlots =
+    kHugePageSize / kHugePageChunkSlotSize;
+
+// A 2MB aligned mapping carved into slots for heap pages. Grouping the pages
+// lets the kernel back them with a single huge page and TLB entry.
+struct HugePageChunk {
+  uword start;
+  bool is_executable;
+  bool is_hugetlb;
+  uint32_t used_slots;  // Bit i is set if slot i is allocated.
+  HugePageChunk* next;
+};
+
+static Mutex* huge_page_chunks_mutex = nullptr;
+static HugePageChunk* huge_page_chunks = nullptr;
+#endif  // defined(HUGE_PAGE_CHUNKS_SUPPORTED)
+
+#if defined(DART_HEAP_CAGE)
+static const intptr_t kHeapCageSize = 4 * GB;
+static const intptr_t kHeapCageGranuleSize = 256 * KB;
+static const intptr_t kHeapCageGranules = kHeapCageSize / kHeapCageGranuleSize;
+
+// The heap cage is reserved without access when the VM starts. Ranges of
+// whole granules are made accessible when allocated and dropped again when
+// freed, keeping the reservation.
+static Mutex* heap_cage_mutex = nullptr;
+static uword heap_cage_base = 0;
+static bool* heap_cage_used_granules = nullptr;
+// No granule below this one is free.
+static intptr_t heap_cage_first_free = 0;
+#endif  // defined(DART_HEAP_CAGE)
+
+static void unmap(uword start, uword end) {
+  ASSERT(start <= end);
+  uword size = end - start;
+  if (size == 0) {
+    return;
+  }
+
+  if (munmap(reinterpret_cast<void*>(start), size) != 0) {
+    int error = errno;
+    const int kBufferSize = 1024;
+    char error_buf[kBufferSize];
+    FATAL2("munmap error: %d (%s)", error,
+           Utils::StrError(error, error_buf, kBufferSize));
+  }
+}
+
+#if defined(DART_HEAP_CAGE)
+static void ReserveHeapCage() {
+  const intptr_t allocated_size = 2 * kHeapCageSize;
+  void* address = mmap(NULL, allocated_size, PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  LOG_INFO("mmap(NULL, 0x%" Px ", PROT_NONE, ...): %p\n", allocated_size,
+           address);
+  if (address == MAP_FAILED) {
+    FATAL("Failed to reserve the heap cage.");
+  }
+  const uword base = reinterpret_cast<uword>(address);
+  heap_cage_base = Utils::RoundUp(base, kHeapCageSize);
+  unmap(base, heap_cage_base);
+  unmap(heap_cage_base + kHeapCageSize, base + allocated_size);
+  heap_cage_used_granules = new bool[kHeapCageGranules]();
+  heap_cage_mutex = new Mutex(NOT_IN_PRODUCT("heap_cage"));
+}
+
+// Gives the range at [start] back to the heap cage.
+static void FreeInHeapCage(uword start, intptr_t size) {
+  // Mapping fresh inaccessible pages over the range drops its contents.
+  void* address =
+      mmap(reinterpret_cast<void*>(start), size, PROT_NONE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+  if (address == MAP_FAILED) {
+    FATAL1("Failed to free heap cage range at 0x%" Px, start);
+  }
+  MutexLocker ml(heap_cage_mutex);
+  const intptr_t first = (start - heap_cage_base) / kHeapCageGranuleSize;
+  const intptr_t count = size / kHeapCageGranuleSize;
+  for (intptr_t i = first; i < first + count; i++) {
+    ASSERT(heap_cage_used_granules[i]);
+    heap_cage_used_granules[i] = false;
+  }
+  heap_cage_first_free = Utils::Minimum(heap_cage_first_free, first);
+}
+#endif  // defined(DART_HEAP_CAGE)
+
 void VirtualMemory::Init() {
   page_size_ = getpagesize();
 
+#if defined(DART_HEAP_CAGE)
+  if (heap_cage_base == 0) {
+    ReserveHeapCage();
+  }
+  // Code pages are allocated in the cage, which is not dual mapped.
+  FLAG_dual_map_code = false;
+#endif
+
+#if defined(HUGE_PAGE_CHUNKS_SUPPORTED)
+  if (huge_page_chunks_mutex == nullptr) {
+    huge_page_chunks_mutex = new Mutex(NOT_IN_PRODUCT("huge_page_chunks"));
+  }
+#endif
+
 #if defined(DUAL_MAPPING_SUPPORTED)
 // Perf is Linux-specific and the flags aren't defined in Product.
 #if defined(TARGET_OS_LINUX) && !defined(PRODUCT)
@@ -83,22 +206,6 @@ void VirtualMemory::Init() {
 #endif  // defined(DUAL_MAPPING_SUPPORTED)
 }
 
-static void unmap(uword start, uword end) {
-  ASSERT(start <= end);
-  uword size = end - start;
-  if (size == 0) {
-    return;
-  }
-
-  if (munmap(reinterpret_cast<void*>(start), size) != 0) {
-    int error = errno;
-    const int kBufferSize = 1024;
-    char error_buf[kBufferSize];
-    FATAL2("munmap error: %d (%s)", error,
-           Utils::StrError(error, error_buf, kBufferSize));
-  }
-}
-
 #if defined(DUAL_MAPPING_SUPPORTED)
 // Do not leak file descriptors to child processes.
 #if !defined(MFD_CLOEXEC)
@@ -221,7 +328,257 @@ VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
   return new VirtualMemory(region, region);
 }
 
+#if defined(HUGE_PAGE_CHUNKS_SUPPORTED)
+static HugePageChunk* NewHugePageChunk(bool is_executable) {
+  const int prot = PROT_READ | PROT_WRITE | (is_executable ? PROT_EXEC : 0);
+  void* address = MAP_FAILED;
+  bool is_hugetlb = false;
+#if defined(MAP_HUGETLB)
+  if (FLAG_use_hugetlb_pages) {
+    // Huge TLB pages are always aligned to their size.
+    address = mmap(NULL, kHugePageSize, prot,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    LOG_INFO("mmap(NULL, 0x%" Px ", %u, MAP_HUGETLB): %p\n", kHugePageSize,
+             prot, address);
+    is_hugetlb = address != MAP_FAILED;
+  }
+#endif  // defined(MAP_HUGETLB)
+  if (address == MAP_FAILED) {
+    const intptr_t allocated_size = 2 * kHugePageSize;
+    address =
+        mmap(NULL, allocated_size, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (address == MAP_FAILED) {
+      return nullptr;
+    }
+    const uword base = reinterpret_cast<uword>(address);
+    const uword aligned_base = Utils::RoundUp(base, kHugePageSize);
+    unmap(base, aligned_base);
+    unmap(aligned_base + kHugePageSize, base + allocated_size);
+    address = reinterpret_cast<void*>(aligned_base);
+#if defined(MADV_HUGEPAGE)
+    if (madvise(address, kHugePageSize, MADV_HUGEPAGE) != 0) {
+      LOG_INFO("madvise(%p, MADV_HUGEPAGE) failed: %d\n", address, errno);
+    }
+#endif  // defined(MADV_HUGEPAGE)
+  }
+
+  HugePageChunk* chunk = new HugePageChunk();
+  chunk->start = reinterpret_cast<uword>(address);
+  chunk->is_executable = is_executable;
+  chunk->is_hugetlb = is_hugetlb;
+  chunk->used_slots = 0;
+  chunk->next = huge_page_chunks;
+  huge_page_chunks = chunk;
+  return chunk;
+}
+
+// Returns the slot at [start] to its chunk, which must be a live huge page
+// chunk.
+static void FreeHugePageChunkSlot(uword start) {
+  MutexLocker ml(huge_page_chunks_mutex);
+  HugePageChunk* previous = nullptr;
+  for (HugePageChunk* chunk = huge_page_chunks; chunk != nullptr;
+       previous = chunk, chunk = chunk->next) {
+    if (start < chunk->start || start >= chunk->start + kHugePageSize) {
+      continue;
+    }
+    const intptr_t slot = (start - chunk->start) / kHugePageChunkSlotSize;
+    ASSERT((chunk->used_slots & (1u << slot)) != 0);
+    chunk->used_slots &= ~(1u << slot);
+    if (chunk->used_slots == 0) {
+      // Give empty chunks back to the OS.
+      if (previous == nullptr) {
+        huge_page_chunks = chunk->next;
+      } else {
+        previous->next = chunk->next;
+      }
+      unmap(chunk->start, chunk->start + kHugePageSize);
+      delete chunk;
+    } else {
+#if defined(MADV_DONTNEED)
+      // Drop the contents of the slot without splitting the mapping.
+      if (!chunk->is_hugetlb) {
+        madvise(reinterpret_cast<void*>(start), kHugePageChunkSlotSize,
+                MADV_DONTNEED);
+      }
+#endif
+    }
+    return;
+  }
+  UNREACHABLE();
+}
+#endif  // defined(HUGE_PAGE_CHUNKS_SUPPORTED)
+
+VirtualMemory* VirtualMemory::AllocateInHugePageChunk(intptr_t size,
+                                                      bool is_executable,
+                                                      const char* name) {
+#if defined(HUGE_PAGE_CHUNKS_SUPPORTED)
+  if (!FLAG_use_huge_pages || size != kHugePageChunkSlotSize) {
+    return NULL;
+  }
+  if (is_executable && (!FLAG_use_huge_pages_for_code ||
+                        FLAG_write_protect_code || FLAG_dual_map_code)) {
+    // Changing the protection of single code pages would split the chunk.
+    return NULL;
+  }
+  MutexLocker ml(huge_page_chunks_mutex);
+  HugePageChunk* chunk = huge_page_chunks;
+  while (chunk != nullptr &&
+         (chunk->is_executable != is_executable ||
+          chunk->used_slots == (1u << kHugePageChunkSlots) - 1)) {
+    chunk = chunk->next;
+  }
+  if (chunk == nullptr) {
+    chunk = NewHugePageChunk(is_executable);
+    if (chunk == nullptr) {
+      return NULL;
+    }
+  }
+  intptr_t slot = 0;
+  while ((chunk->used_slots & (1u << slot)) != 0) {
+    slot++;
+  }
+  chunk->used_slots |= 1u << slot;
+
+  MemoryRegion region(
+      reinterpret_cast<void*>(chunk->start + slot * kHugePageChunkSlotSize),
+      size);
+  VirtualMemory* memory = new VirtualMemory(region, region, region);
+  memory->in_huge_page_chunk_ = true;
+  return memory;
+#else
+  return NULL;
+#endif  // defined(HUGE_PAGE_CHUNKS_SUPPORTED)
+}
+
+VirtualMemory* VirtualMemory::AllocateInHeapCage(intptr_t size,
+                                                 bool is_executable,
+                                                 const char* name) {
+#if defined(DART_HEAP_CAGE)
+  const intptr_t count =
+      Utils::RoundUp(size, kHeapCageGranuleSize) / kHeapCageGranuleSize;
+  intptr_t first;
+  {
+    MutexLocker ml(heap_cage_mutex);
+    // First fit, which keeps the heap packed at the bottom of the cage.
+    first = heap_cage_first_free;
+    intptr_t run = 0;
+    for (intptr_t i = first; (run < count) && (i < kHeapCageGranules); i++) {
+      if (heap_cage_used_granules[i]) {
+        first = i + 1;
+        run = 0;
+      } else {
+        run++;
+      }
+    }
+    if (run < count) {
+      return NULL;
+    }
+    for (intptr_t i = first; i < first + count; i++) {
+      heap_cage_used_granules[i] = true;
+    }
+    while ((heap_cage_first_free < kHeapCageGranules) &&
+           heap_cage_used_granules[heap_cage_first_free]) {
+      heap_cage_first_free++;
+    }
+  }
+
+  const uword start = heap_cage_base + first * kHeapCageGranuleSize;
+  const intptr_t reserved_size = count * kHeapCageGranuleSize;
+  const int prot =
+      PROT_READ | PROT_WRITE |
+      ((is_executable && !FLAG_write_protect_code) ? PROT_EXEC : 0);
+  if (mprotect(reinterpret_cast<void*>(start), reserved_size, prot) != 0) {
+    LOG_INFO("mprotect(0x%" Px ", 0x%" Px ", %u) failed\n", start,
+             reserved_size, prot);
+    FreeInHeapCage(start, reserved_size);
+    return NULL;
+  }
+  MemoryRegion region(reinterpret_cast<void*>(start), size);
+  MemoryRegion reserved(reinterpret_cast<void*>(start), reserved_size);
+  VirtualMemory* memory = new VirtualMemory(region, reserved);
+  memory->in_heap_cage_ = true;
+  return memory;
+#else
+  return NULL;
+#endif  // defined(DART_HEAP_CAGE)
+}
+
+uword VirtualMemory::HeapCageBase() {
+#if defined(DART_HEAP_CAGE)
+  return heap_cage_base;
+#else
+  return 0;
+#endif
+}
+
+void VirtualMemory::HugePageUsage(intptr_t* reserved_in_bytes,
+                                  intptr_t* backed_in_bytes) {
+  *reserved_in_bytes = 0;
+  *backed_in_bytes = 0;
+#if defined(HUGE_PAGE_CHUNKS_SUPPORTED)
+  if (huge_page_chunks_mutex == nullptr) {
+    return;
+  }
+  MutexLocker ml(huge_page_chunks_mutex);
+  bool has_transparent_chunks = false;
+  for (HugePageChunk* chunk = huge_page_chunks; chunk != nullptr;
+       chunk = chunk->next) {
+    *reserved_in_bytes += kHugePageSize;
+    if (chunk->is_hugetlb) {
+      *backed_in_bytes += kHugePageSize;
+    } else {
+      has_transparent_chunks = true;
+    }
+  }
+  if (!has_transparent_chunks) {
+    return;
+  }
+
+  // Whether transparent huge pages back a chunk is only visible in the
+  // AnonHugePages field of the mapping which contains it.
+  FILE* smaps = fopen("/proc/self/smaps", "r");
+  if (smaps == NULL) {
+    return;
+  }
+  char line[256];
+  intptr_t overlap = 0;
+  while (fgets(line, sizeof(line), smaps) != NULL) {
+    uword start, end;
+    intptr_t kb;
+    if (sscanf(line, "%" Px "-%" Px " ", &start, &end) == 2) {
+      overlap = 0;
+      for (HugePageChunk* chunk = huge_page_chunks; chunk != nullptr;
+           chunk = chunk->next) {
+        if (chunk->is_hugetlb) continue;
+        const uword chunk_end = chunk->start + kHugePageSize;
+        if (chunk->start < end && start < chunk_end) {
+          overlap += Utils::Minimum(end, chunk_end) -
+                     Utils::Maximum(start, chunk->start);
+        }
+      }
+    } else if (overlap > 0 &&
+               sscanf(line, "AnonHugePages: %" Pd " kB", &kb) == 1) {
+      *backed_in_bytes += Utils::Minimum(overlap, kb * KB);
+    }
+  }
+  fclose(smaps);
+#endif  // defined(HUGE_PAGE_CHUNKS_SUPPORTED)
+}
+
 VirtualMemory::~VirtualMemory() {
+#if defined(HUGE_PAGE_CHUNKS_SUPPORTED)
+  if (in_huge_page_chunk_) {
+    FreeHugePageChunkSlot(start());
+    return;
+  }
+#endif
+#if defined(DART_HEAP_CAGE)
+  if (in_heap_cage_) {
+    FreeInHeapCage(reserved_.start(), reserved_.size());
+    return;
+  }
+#endif
   if (vm_owns_region()) {
     unmap(reserved_.start(), reserved_.end());
     const intptr_t alias_offset = AliasOffset();
@@ -237,6 +594,16 @@ void VirtualMemory::FreeSubSegment(void* address,
   unmap(start, start + size);
 }
 
+void VirtualMemory::DontNeed(void* address, intptr_t size) {
+  ASSERT(Utils::IsAligned(address, PageSize()));
+  ASSERT(Utils::IsAligned(size, PageSize()));
+#if defined(MADV_DONTNEED)
+  if (madvise(address, size, MADV_DONTNEED) != 0) {
+    LOG_INFO("madvise(%p, MADV_DONTNEED) failed: %d\n", address, errno);
+  }
+#endif  // defined(MADV_DONTNEED)
+}
+
 void VirtualMemory::Protect(void* address, intptr_t size, Protection mode) {
 #if defined(TARGET_ARCH_DBC)
   RELEASE_ASSERT((mode != kReadExecute) && (mode != kReadWriteExecute));
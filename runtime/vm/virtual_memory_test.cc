@@ -88,4 +88,85 @@ VM_UNIT_TEST_CASE(FreeVirtualMemory) {
   }
 }
 
+#if defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID)
+DECLARE_FLAG(bool, use_huge_pages);
+
+VM_UNIT_TEST_CASE(AllocateInHugePageChunk) {
+  SetFlagScope<bool> sfs(&FLAG_use_huge_pages, true);
+  const intptr_t kSlots = 8;  // 2MB chunks of 256KB slots.
+  VirtualMemory* slots[kSlots + 1];
+  for (intptr_t i = 0; i <= kSlots; i++) {
+    slots[i] = VirtualMemory::AllocateInHugePageChunk(kPageSize, false, NULL);
+    EXPECT(slots[i] != NULL);
+    EXPECT(Utils::IsAligned(slots[i]->start(), kPageSize));
+    EXPECT_EQ(kPageSize, slots[i]->size());
+    char* buf = reinterpret_cast<char*>(slots[i]->address());
+    EXPECT(IsZero(buf, buf + slots[i]->size()));
+    buf[0] = 'a';
+  }
+  // The slots of the first chunk are adjacent.
+  for (intptr_t i = 1; i < kSlots; i++) {
+    EXPECT_EQ(slots[0]->start() / (2 * MB), slots[i]->start() / (2 * MB));
+  }
+
+  intptr_t reserved, backed;
+  VirtualMemory::HugePageUsage(&reserved, &backed);
+  EXPECT_EQ(4 * MB, reserved);
+  EXPECT_LE(backed, reserved);
+
+  // Slots which are handed back are reused and cleared.
+  const uword freed = slots[3]->start();
+  delete slots[3];
+  slots[3] = VirtualMemory::AllocateInHugePageChunk(kPageSize, false, NULL);
+  EXPECT_EQ(freed, slots[3]->start());
+  EXPECT_EQ(0, reinterpret_cast<char*>(slots[3]->address())[0]);
+
+  // Only heap page sized slots are handed out.
+  EXPECT(VirtualMemory::AllocateInHugePageChunk(2 * kPageSize, false, NULL) ==
+         NULL);
+
+  for (intptr_t i = 0; i <= kSlots; i++) {
+    delete slots[i];
+  }
+  VirtualMemory::HugePageUsage(&reserved, &backed);
+  EXPECT_EQ(0, reserved);
+  EXPECT_EQ(0, backed);
+}
+#endif  // defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID)
+
+#if defined(DART_HEAP_CAGE)
+VM_UNIT_TEST_CASE(AllocateInHeapCage) {
+  const uword base = VirtualMemory::HeapCageBase();
+  EXPECT(Utils::IsAligned(base, 4 * GB));
+  VirtualMemory* small =
+      VirtualMemory::AllocateInHeapCage(kPageSize, false, NULL);
+  VirtualMemory* large =
+      VirtualMemory::AllocateInHeapCage(3 * kPageSize + 1, false, NULL);
+  EXPECT(small != NULL);
+  EXPECT(large != NULL);
+  EXPECT(Utils::IsAligned(large->start(), kPageSize));
+  EXPECT_EQ(3 * kPageSize + 1, large->size());
+  EXPECT((small->start() >= base) && (small->end() <= base + 4 * GB));
+  EXPECT((large->start() >= base) && (large->end() <= base + 4 * GB));
+  EXPECT(small->end() <= large->start() || large->end() <= small->start());
+  char* buf = reinterpret_cast<char*>(large->address());
+  EXPECT(IsZero(buf, buf + large->size()));
+  buf[large->size() - 1] = 'a';
+
+  // Ranges which are handed back are reused and cleared.
+  const uword freed = large->start();
+  delete large;
+  large = VirtualMemory::AllocateInHeapCage(2 * kPageSize, false, NULL);
+  EXPECT_EQ(freed, large->start());
+  buf = reinterpret_cast<char*>(large->address());
+  EXPECT(IsZero(buf, buf + large->size()));
+
+  // Truncation keeps the range.
+  large->Truncate(kPageSize);
+  EXPECT_EQ(2 * kPageSize, large->size());
+  delete small;
+  delete large;
+}
+#endif  // defined(DART_HEAP_CAGE)
+
 }  // namespace dart
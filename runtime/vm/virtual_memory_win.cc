@@ -56,6 +56,30 @@ VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
   return new VirtualMemory(region, reserved);
 }
 
+VirtualMemory* VirtualMemory::AllocateInHugePageChunk(intptr_t size,
+                                                      bool is_executable,
+                                                      const char* name) {
+  // Huge page chunks are only implemented for Linux and Android.
+  return NULL;
+}
+
+void VirtualMemory::HugePageUsage(intptr_t* reserved_in_bytes,
+                                  intptr_t* backed_in_bytes) {
+  *reserved_in_bytes = 0;
+  *backed_in_bytes = 0;
+}
+
+VirtualMemory* VirtualMemory::AllocateInHeapCage(intptr_t size,
+                                                 bool is_executable,
+                                                 const char* name) {
+  // The heap cage is only implemented for POSIX hosts.
+  return NULL;
+}
+
+uword VirtualMemory::HeapCageBase() {
+  return 0;
+}
+
 VirtualMemory::~VirtualMemory() {
   // Note that the size of the reserved region might be set to 0 by
   // Truncate(0, true) but that does not actually release the mapping
@@ -76,6 +100,13 @@ void VirtualMemory::FreeSubSegment(void* address,
   }
 }
 
+void VirtualMemory::DontNeed(void* address, intptr_t size) {
+  ASSERT(Utils::IsAligned(address, PageSize()));
+  ASSERT(Utils::IsAligned(size, PageSize()));
+  // The pages stay committed, but are no longer written to the page file.
+  VirtualAlloc(address, size, MEM_RESET, PAGE_READWRITE);
+}
+
 void VirtualMemory::Protect(void* address, intptr_t size, Protection mode) {
 #if defined(DEBUG)
   Thread* thread = Thread::Current();
@@ -4,7 +4,9 @@
 
 #include "vm/zone.h"
 
+#include "platform/address_sanitizer.h"
 #include "platform/assert.h"
+#include "platform/atomic.h"
 #include "platform/utils.h"
 #include "vm/dart_api_state.h"
 #include "vm/flags.h"
@@ -15,6 +17,18 @@
 
 namespace dart {
 
+DEFINE_FLAG(int,
+            zone_segment_cache_size,
+            4,
+            "Maximum number of freed zone segments each thread keeps for "
+            "reuse by its next zones.");
+
+// Reusing segments would hide zone memory used after its zone is deleted
+// from the address sanitizer.
+#if defined(HAS_C11_THREAD_LOCAL) && !defined(USING_ADDRESS_SANITIZER)
+#define USING_ZONE_SEGMENT_CACHE
+#endif
+
 // Zone segments represent chunks of memory: They have starting
 // address encoded in the this pointer and a size in bytes. They are
 // chained together to form the backing storage for an expanding zone.
@@ -27,15 +41,29 @@ class Zone::Segment {
   uword start() { return address(sizeof(Segment)); }
   uword end() { return address(size_); }
 
-  // Allocate or delete individual segments.
-  static Segment* New(intptr_t size, Segment* next);
-  static Segment* NewLarge(intptr_t size, Segment* next);
-  static void DeleteSegmentList(Segment* segment);
-  static void DeleteLargeSegmentList(Segment* segment);
-  static void IncrementMemoryCapacity(uintptr_t size);
-  static void DecrementMemoryCapacity(uintptr_t size);
+  // Allocate or delete individual segments. The memory of arena zones is
+  // counted as native zone memory rather than the current thread's.
+  static Segment* New(intptr_t size, Segment* next, bool is_arena);
+  static Segment* NewLarge(intptr_t size, Segment* next, bool is_arena);
+  static void DeleteSegmentList(Segment* segment, bool is_arena);
+  static void DeleteLargeSegmentList(Segment* segment, bool is_arena);
+  static void IncrementMemoryCapacity(uintptr_t size, bool is_arena);
+  static void DecrementMemoryCapacity(uintptr_t size, bool is_arena);
+
+  static void TrimCache();
+  static int64_t cache_hits() {
+    return AtomicOperations::LoadRelaxed(&cache_hits_);
+  }
+  static int64_t cache_misses() {
+    return AtomicOperations::LoadRelaxed(&cache_misses_);
+  }
 
  private:
+  class Cache;
+
+  static int64_t cache_hits_;
+  static int64_t cache_misses_;
+
   Segment* next_;
   intptr_t size_;
   VirtualMemory* memory_;
@@ -47,11 +75,112 @@ class Zone::Segment {
   DISALLOW_IMPLICIT_CONSTRUCTORS(Segment);
 };
 
-Zone::Segment* Zone::Segment::New(intptr_t size, Zone::Segment* next) {
+int64_t Zone::Segment::cache_hits_ = 0;
+int64_t Zone::Segment::cache_misses_ = 0;
+
+// Short-lived zones, e.g. the StackZone of a native call or of a message,
+// would otherwise malloc and free a default-size segment each time they
+// expand. Each thread keeps up to FLAG_zone_segment_cache_size freed
+// default-size segments for its next zones instead.
+//
+// Trimming bumps a global epoch. A thread frees its cached segments the
+// next time it uses its cache with an older epoch, so caches are never
+// touched by other threads.
+class Zone::Segment::Cache {
+ public:
+  Cache() : head_(NULL), length_(0), epoch_(0), is_exiting_(false) {}
+  ~Cache() {
+    Release();
+    // Zones deleted later during thread exit free their segments.
+    is_exiting_ = true;
+  }
+
+#if defined(USING_ZONE_SEGMENT_CACHE)
+  static Cache* Current() {
+    static thread_local Cache cache;
+    return &cache;
+  }
+#else
+  static Cache* Current() { return NULL; }
+#endif
+
+  // Returns a cached segment, or NULL if there is none.
+  Segment* Take() {
+    Sync();
+    Segment* result = head_;
+    if (result != NULL) {
+      head_ = result->next_;
+      length_--;
+    }
+    return result;
+  }
+
+  // Returns false if the cache is full.
+  bool Put(Segment* segment) {
+    Sync();
+    if (is_exiting_ || (length_ >= FLAG_zone_segment_cache_size)) {
+      return false;
+    }
+    segment->next_ = head_;
+    head_ = segment;
+    length_++;
+    return true;
+  }
+
+  void Release() {
+    while (head_ != NULL) {
+      Segment* next = head_->next_;
+      free(head_);
+      head_ = next;
+    }
+    length_ = 0;
+  }
+
+  static void Trim() {
+    AtomicOperations::FetchAndIncrement(&global_epoch_);
+    Cache* cache = Current();
+    if (cache != NULL) {
+      cache->Sync();
+    }
+  }
+
+ private:
+  void Sync() {
+    const intptr_t current = AtomicOperations::LoadRelaxed(&global_epoch_);
+    if (epoch_ != current) {
+      Release();
+      epoch_ = current;
+    }
+  }
+
+  static intptr_t global_epoch_;
+
+  Segment* head_;
+  intptr_t length_;
+  intptr_t epoch_;
+  bool is_exiting_;
+
+  DISALLOW_COPY_AND_ASSIGN(Cache);
+};
+
+intptr_t Zone::Segment::Cache::global_epoch_ = 0;
+
+Zone::Segment* Zone::Segment::New(intptr_t size,
+                                  Zone::Segment* next,
+                                  bool is_arena) {
   ASSERT(size >= 0);
-  Segment* result = reinterpret_cast<Segment*>(malloc(size));
+  Segment* result = NULL;
+  Cache* cache = (size == kSegmentSize) ? Cache::Current() : NULL;
+  if (cache != NULL) {
+    result = cache->Take();
+    AtomicOperations::IncrementInt64By(
+        (result != NULL) ? &cache_hits_ : &cache_misses_, 1);
+  }
   if (result == NULL) {
-    OUT_OF_MEMORY();
+    result = reinterpret_cast<Segment*>(malloc(size));
+    if (result == NULL) {
+      OUT_OF_MEMORY();
+    }
   }
 #ifdef DEBUG
   // Zap the entire allocated segment (including the header).
@@ -61,11 +190,13 @@ Zone::Segment* Zone::Segment::New(intptr_t size, Zone::Segment* next) {
   result->size_ = size;
   result->memory_ = nullptr;
   result->alignment_ = nullptr;  // Avoid unused variable warnings.
-  IncrementMemoryCapacity(size);
+  IncrementMemoryCapacity(size, is_arena);
   return result;
 }
 
-Zone::Segment* Zone::Segment::NewLarge(intptr_t size, Zone::Segment* next) {
+Zone::Segment* Zone::Segment::NewLarge(intptr_t size,
+                                       Zone::Segment* next,
+                                       bool is_arena) {
   size = Utils::RoundUp(size, VirtualMemory::PageSize());
   VirtualMemory* memory = VirtualMemory::Allocate(size, false, "dart-zone");
   if (memory == NULL) {
@@ -83,28 +214,32 @@ Zone::Segment* Zone::Segment::NewLarge(intptr_t size, Zone::Segment* next) {
 
   LSAN_REGISTER_ROOT_REGION(result, sizeof(*result));
 
-  IncrementMemoryCapacity(size);
+  IncrementMemoryCapacity(size, is_arena);
   return result;
 }
 
-void Zone::Segment::DeleteSegmentList(Segment* head) {
+void Zone::Segment::DeleteSegmentList(Segment* head, bool is_arena) {
   Segment* current = head;
   while (current != NULL) {
-    DecrementMemoryCapacity(current->size());
+    DecrementMemoryCapacity(current->size(), is_arena);
     Segment* next = current->next();
 #ifdef DEBUG
     // Zap the entire current segment (including the header).
     memset(current, kZapDeletedByte, current->size());
 #endif
-    free(current);
+    Cache* cache =
+        (current->size() == kSegmentSize) ? Cache::Current() : NULL;
+    if ((cache == NULL) || !cache->Put(current)) {
+      free(current);
+    }
     current = next;
   }
 }
 
-void Zone::Segment::DeleteLargeSegmentList(Segment* head) {
+void Zone::Segment::DeleteLargeSegmentList(Segment* head, bool is_arena) {
   Segment* current = head;
   while (current != NULL) {
-    DecrementMemoryCapacity(current->size());
+    DecrementMemoryCapacity(current->size(), is_arena);
     Segment* next = current->next();
     VirtualMemory* memory = current->memory();
 #ifdef DEBUG
@@ -117,7 +252,12 @@ void Zone::Segment::DeleteLargeSegmentList(Segment* head) {
   }
 }
 
-void Zone::Segment::IncrementMemoryCapacity(uintptr_t size) {
+void Zone::Segment::IncrementMemoryCapacity(uintptr_t size, bool is_arena) {
+  if (is_arena) {
+    // Arenas outlive the threads and native scopes they are used from.
+    ApiNativeScope::IncrementNativeScopeMemoryCapacity(size);
+    return;
+  }
   ThreadState* current_thread = ThreadState::Current();
   if (current_thread != NULL) {
     current_thread->IncrementMemoryCapacity(size);
@@ -127,7 +267,11 @@ void Zone::Segment::IncrementMemoryCapacity(uintptr_t size) {
   }
 }
 
-void Zone::Segment::DecrementMemoryCapacity(uintptr_t size) {
+void Zone::Segment::DecrementMemoryCapacity(uintptr_t size, bool is_arena) {
+  if (is_arena) {
+    ApiNativeScope::DecrementNativeScopeMemoryCapacity(size);
+    return;
+  }
   ThreadState* current_thread = ThreadState::Current();
   if (current_thread != NULL) {
     current_thread->DecrementMemoryCapacity(size);
@@ -137,19 +281,24 @@ void Zone::Segment::DecrementMemoryCapacity(uintptr_t size) {
   }
 }
 
+void Zone::Segment::TrimCache() {
+  Cache::Trim();
+}
+
 // TODO(bkonyi): We need to account for the initial chunk size when a new zone
 // is created within a new thread or ApiNativeScope when calculating high
 // watermarks or memory consumption.
-Zone::Zone()
+Zone::Zone(bool is_arena)
     : initial_buffer_(buffer_, kInitialChunkSize),
       position_(initial_buffer_.start()),
       limit_(initial_buffer_.end()),
       head_(NULL),
       large_segments_(NULL),
       handles_(),
-      previous_(NULL) {
+      previous_(NULL),
+      is_arena_(is_arena) {
   ASSERT(Utils::IsAligned(position_, kAlignment));
-  Segment::IncrementMemoryCapacity(kInitialChunkSize);
+  Segment::IncrementMemoryCapacity(kInitialChunkSize, is_arena_);
 #ifdef DEBUG
   // Zap the entire initial buffer.
   memset(initial_buffer_.pointer(), kZapUninitializedByte,
@@ -162,17 +311,29 @@ Zone::~Zone() {
     DumpZoneSizes();
   }
   DeleteAll();
-  Segment::DecrementMemoryCapacity(kInitialChunkSize);
+  Segment::DecrementMemoryCapacity(kInitialChunkSize, is_arena_);
+}
+
+void Zone::TrimSegmentCaches() {
+  Segment::TrimCache();
+}
+
+int64_t Zone::SegmentCacheHits() {
+  return Segment::cache_hits();
+}
+
+int64_t Zone::SegmentCacheMisses() {
+  return Segment::cache_misses();
 }
 
 void Zone::DeleteAll() {
   // Traverse the chained list of segments, zapping (in debug mode)
   // and freeing every zone segment.
   if (head_ != NULL) {
-    Segment::DeleteSegmentList(head_);
+    Segment::DeleteSegmentList(head_, is_arena_);
   }
   if (large_segments_ != NULL) {
-    Segment::DeleteLargeSegmentList(large_segments_);
+    Segment::DeleteLargeSegmentList(large_segments_, is_arena_);
   }
 // Reset zone state.
 #ifdef DEBUG
@@ -238,7 +399,7 @@ uword Zone::AllocateExpand(intptr_t size) {
   }
 
   // Allocate another segment and chain it up.
-  head_ = Segment::New(kSegmentSize, head_);
+  head_ = Segment::New(kSegmentSize, head_, is_arena_);
 
   // Recompute 'position' and 'limit' based on the new head segment.
   uword result = Utils::RoundUp(head_->start(), kAlignment);
@@ -259,7 +420,7 @@ uword Zone::AllocateLargeSegment(intptr_t size) {
   // Create a new large segment and chain it up.
   // Account for book keeping fields in size.
   size += Utils::RoundUp(sizeof(Segment), kAlignment);
-  large_segments_ = Segment::NewLarge(size, large_segments_);
+  large_segments_ = Segment::NewLarge(size, large_segments_, is_arena_);
 
   uword result = Utils::RoundUp(large_segments_->start(), kAlignment);
   return result;
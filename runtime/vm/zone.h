@@ -74,6 +74,16 @@ class Zone {
 
   Zone* previous() const { return previous_; }
 
+  // Frees the segments that threads keep for reuse by their next zones,
+  // e.g. when the embedder reports low memory. Other threads free theirs
+  // the next time they create or delete a zone segment.
+  static void TrimSegmentCaches();
+
+  // The number of default-size segments that were and were not found in
+  // the current thread's cache when a zone expanded.
+  static int64_t SegmentCacheHits();
+  static int64_t SegmentCacheMisses();
+
   bool ContainsNestedZone(Zone* other) const {
     while (other != NULL) {
       if (this == other) return true;
@@ -83,7 +93,9 @@ class Zone {
   }
 
  private:
-  Zone();
+  // Arena zones back Dart_Arena. They are not tied to a thread, so their
+  // memory is counted with the native zone memory.
+  explicit Zone(bool is_arena = false);
   ~Zone();  // Delete all memory associated with the zone.
 
   // All pointers returned from AllocateUnsafe() and New() have this alignment.
@@ -162,8 +174,11 @@ class Zone {
   // Used for chaining zones in order to allow unwinding of stacks.
   Zone* previous_;
 
+  const bool is_arena_;
+
   friend class StackZone;
   friend class ApiZone;
+  friend class ApiArena;
   template <typename T, typename B, typename Allocator>
   friend class BaseGrowableArray;
   template <typename T, typename B, typename Allocator>
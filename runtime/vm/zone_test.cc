@@ -3,6 +3,7 @@
 // BSD-style license that can be found in the LICENSE file.
 
 #include "vm/zone.h"
+#include "platform/address_sanitizer.h"
 #include "platform/assert.h"
 #include "vm/dart.h"
 #include "vm/isolate.h"
@@ -180,6 +181,31 @@ VM_UNIT_TEST_CASE(NativeScopeZoneAllocation) {
   EXPECT_EQ(0UL, ApiNativeScope::current_memory_usage());
 }
 
+VM_UNIT_TEST_CASE(ArenaAllocation) {
+  ASSERT(Thread::Current() == NULL);
+  EXPECT_EQ(0UL, ApiNativeScope::current_memory_usage());
+  Dart_Arena arena = Dart_NewArena();
+  const uintptr_t initial_usage = ApiNativeScope::current_memory_usage();
+  EXPECT(initial_usage > 0);
+  uint8_t* small = Dart_ArenaAllocate(arena, 16);
+  memset(small, 1, 16);
+  uint8_t* large = Dart_ArenaAllocate(arena, 1 * MB);
+  memset(large, 2, 1 * MB);
+  EXPECT(ApiNativeScope::current_memory_usage() > initial_usage + 1 * MB);
+  EXPECT_EQ(1, small[15]);
+
+  // Resetting frees everything but the arena itself, which can be reused.
+  Dart_ResetArena(arena);
+  EXPECT_EQ(initial_usage, ApiNativeScope::current_memory_usage());
+  for (intptr_t i = 0; i < 10; i++) {
+    EXPECT(Dart_ArenaAllocate(arena, 32 * KB) != NULL);
+  }
+  EXPECT(ApiNativeScope::current_memory_usage() > initial_usage);
+
+  Dart_DeleteArena(arena);
+  EXPECT_EQ(0UL, ApiNativeScope::current_memory_usage());
+}
+
 #if !defined(PRODUCT)
 // Allow for pooling in the malloc implementation.
 static const int64_t kRssSlack = 20 * MB;
@@ -202,6 +228,32 @@ static const size_t kSizes[] = {
 };
 // clang-format on
 
+static void AllocateSegments(Thread* thread, intptr_t count) {
+  StackZone stack_zone(thread);
+  Zone* zone = stack_zone.GetZone();
+  // Each allocation needs a segment of its own.
+  for (intptr_t i = 0; i < count; i++) {
+    zone->Alloc<uint8_t>(48 * KB);
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(ZoneSegmentCache) {
+#if defined(HAS_C11_THREAD_LOCAL) && !defined(USING_ADDRESS_SANITIZER)
+  // Other threads may use the cache too, so only lower bounds are checked.
+  Zone::TrimSegmentCaches();
+  AllocateSegments(thread, 2);
+  const int64_t hits = Zone::SegmentCacheHits();
+  AllocateSegments(thread, 2);
+  EXPECT_LE(hits + 2, Zone::SegmentCacheHits());
+
+  // Trimmed segments are allocated again.
+  Zone::TrimSegmentCaches();
+  const int64_t misses = Zone::SegmentCacheMisses();
+  AllocateSegments(thread, 2);
+  EXPECT_LE(misses + 2, Zone::SegmentCacheMisses());
+#endif
+}
+
 TEST_CASE(StressMallocDirectly) {
 #if !defined(PRODUCT)
   int64_t start_rss = Service::CurrentRSS();
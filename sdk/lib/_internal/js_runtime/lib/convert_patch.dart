@@ -10,6 +10,7 @@ import 'dart:_interceptors' show JSArray, JSExtendableArray;
 import 'dart:_internal' show MappedIterable, ListIterable;
 import 'dart:collection' show LinkedHashMap, MapBase;
 import 'dart:_native_typed_data' show NativeUint8List;
+import 'dart:typed_data' show Uint8List;
 
 /// Parses [json] and builds the corresponding parsed JSON value.
 ///
@@ -500,3 +501,9 @@ int _scanOneByteCharacters(List<int> units, int from, int endIndex) {
   }
   return to - from;
 }
+
+@patch
+String _encodeBase64Fast(List<int> bytes, bool urlSafe) => null;
+
+@patch
+Uint8List _decodeBase64Fast(String input, int start, int end) => null;
@@ -404,7 +404,7 @@ class InternetAddress {
   }
 
   @patch
-  factory InternetAddress(String address) {
+  factory InternetAddress(String address, {InternetAddressType type}) {
     throw new UnsupportedError("InternetAddress");
   }
   @patch
@@ -230,6 +230,8 @@ class Base64Encoder extends Converter<List<int>, String> {
 
   String convert(List<int> input) {
     if (input.isEmpty) return "";
+    var result = _encodeBase64Fast(input, _urlSafe);
+    if (result != null) return result;
     var encoder = _Base64Encoder(_urlSafe);
     var buffer = encoder.encode(input, 0, input.length, true);
     return String.fromCharCodes(buffer);
@@ -481,6 +483,8 @@ class Base64Decoder extends Converter<String, List<int>> {
   Uint8List convert(String input, [int start = 0, int end]) {
     end = RangeError.checkValidRange(start, end, input.length);
     if (start == end) return Uint8List(0);
+    var result = _decodeBase64Fast(input, start, end);
+    if (result != null) return result;
     var decoder = _Base64Decoder();
     var buffer = decoder.decode(input, start, end);
     decoder.close(input, end);
@@ -852,3 +856,16 @@ class _Base64DecoderSink extends StringConversionSinkBase {
     }
   }
 }
+
+// Returns the padded base64 encoding of [bytes], or null to leave it to
+// [_Base64Encoder].
+//
+// The VM encodes typed data natively, which is why this is external.
+external String _encodeBase64Fast(List<int> bytes, bool urlSafe);
+
+// Returns the bytes encoded by [input] from [start] to [end], or null to leave
+// them to [_Base64Decoder]. Must return null for input that [_Base64Decoder]
+// rejects, so that it reports the error.
+//
+// The VM decodes one-byte strings natively, which is why this is external.
+external Uint8List _decodeBase64Fast(String input, int start, int end);
@@ -837,7 +837,8 @@ class _JsonStringStringifier extends _JsonStringifier {
   String get _partialResult => _sink is StringBuffer ? _sink.toString() : null;
 
   void writeNumber(num number) {
-    _sink.write(number.toString());
+    // A StringBuffer can write the number without creating a string for it.
+    _sink.write(number);
   }
 
   void writeString(String string) {
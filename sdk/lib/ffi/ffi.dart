@@ -36,6 +36,30 @@ external int sizeOf<T extends NativeType>();
 external Pointer<NativeFunction<T>> fromFunction<T extends Function>(
     @DartRepresentationOf("T") Function f);
 
+/// A queue through which native threads call back into Dart asynchronously.
+///
+/// Unlike the function pointers returned by [fromFunction], which may only be
+/// called on the thread running the isolate, the queue can be posted to from
+/// any thread with `Dart_PostAsyncCallback` from `dart_native_api.h`, passing
+/// [handle] and the address of a record of [recordSize] bytes which is
+/// copied. The records are handed to the callback on this isolate's event
+/// loop in batches of [count] records, laid out one after the other at
+/// [records] in the order they were posted. The memory of a batch is only
+/// valid during the call.
+///
+/// The queue must be closed with [close] once native code has stopped posting
+/// to it.
+abstract class AsyncCallbackQueue {
+  external factory AsyncCallbackQueue(int recordSize,
+      void callback(Pointer<Uint8> records, int count));
+
+  /// The address to pass to `Dart_PostAsyncCallback`.
+  Pointer<Void> get handle;
+
+  /// Stops handing records to the callback and frees the queue.
+  void close();
+}
+
 /*
 /// TODO(dacoharkes): Implement this feature.
 /// https://github.com/dart-lang/sdk/issues/35770
@@ -84,7 +108,14 @@ class Pointer<T extends NativeType> extends NativeType {
   /// and return value.
   ///
   /// Can only be called on [Pointer]<[NativeFunction]>.
-  external R asFunction<@DartRepresentationOf("T") R extends Function>();
+  ///
+  /// If [isLeaf] is true, the native function is called without leaving the
+  /// Dart state of the isolate, which makes the call considerably cheaper. The
+  /// native function must then not call back into Dart, use the Dart C API,
+  /// or block (e.g. on I/O or a lock), because the isolate cannot reach a
+  /// safepoint (e.g. for garbage collection) while it runs.
+  external R asFunction<@DartRepresentationOf("T") R extends Function>(
+      {bool isLeaf: false});
 
   /// Free memory on the C heap pointed to by this pointer with free().
   ///
@@ -131,3 +131,20 @@ class Void extends NativeType {
 /// marker in type signatures.
 @unsized
 class NativeFunction<T extends Function> extends NativeType {}
+
+/// Represents a struct of type [T] which is passed to or returned from a C
+/// function by value, rather than by reference.
+///
+/// [T] must be a class annotated with `@struct`. In Dart, `ByValue<T>`
+/// corresponds to [T]: a struct passed by value is copied from the memory of
+/// the [T] argument into the registers and stack slots the C calling
+/// convention prescribes, and a struct returned by value is copied into newly
+/// allocated C memory which the caller is responsible for freeing.
+///
+/// Structs can only be passed by value on x64 (except on Windows) and arm64,
+/// and not to or from callbacks created by [fromFunction].
+///
+/// [ByValue] is not constructible in the Dart code and serves purely as marker
+/// in type signatures.
+@unsized
+class ByValue<T extends Pointer> extends NativeType {}
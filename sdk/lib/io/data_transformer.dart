@@ -529,6 +529,37 @@ abstract class RawZLibFilter {
    */
   List<int> processed({bool flush: true, bool end: false});
 
+  /**
+   * Processes the bytes of [input] from [inputStart] to [inputEnd] directly
+   * into [output] from [outputStart] to [outputEnd], without copying them to
+   * intermediate buffers.
+   *
+   * Returns the number of bytes written to [output]. Afterwards, [consumed]
+   * is the number of bytes of [input] that were used. Call [processInto]
+   * again with the remaining input, and also while it fills the whole range
+   * of [output], as [flush] and [end] may need more room to complete.
+   *
+   * Must not be called while data passed to [process] is still being
+   * processed.
+   */
+  int processInto(Uint8List input, int inputStart, int inputEnd,
+      Uint8List output, int outputStart, int outputEnd,
+      {bool flush: true, bool end: false});
+
+  /**
+   * The number of input bytes used by the last call to [processInto].
+   */
+  int get consumed;
+
+  /**
+   * Discards the state of the current stream, so the filter can be reused
+   * for a new stream with the same options.
+   *
+   * A deflate filter can switch to another compression [level] and
+   * [strategy] for the new stream. Inflate filters do not accept them.
+   */
+  void reset({int level, int strategy});
+
   external static RawZLibFilter _makeZLibDeflateFilter(
       bool gzip,
       int level,
@@ -290,6 +290,7 @@ class _AsyncDirectoryLister {
   static const int listLink = 2;
   static const int listError = 3;
   static const int listDone = 4;
+  static const int listPacked = 5;
 
   static const int responseType = 0;
   static const int responsePath = 1;
@@ -392,6 +393,9 @@ class _AsyncDirectoryLister {
             case listDone:
               canceled = true;
               return;
+            case listPacked:
+              addPacked(result[i]);
+              break;
           }
         }
       } else {
@@ -400,6 +404,30 @@ class _AsyncDirectoryLister {
     });
   }
 
+  // Adds the entries of a listPacked response. Each is a type byte followed
+  // by a NUL-terminated path.
+  void addPacked(Uint8List packed) {
+    int i = 0;
+    while (i < packed.length) {
+      int type = packed[i++];
+      int end = packed.indexOf(0, i);
+      // Keep the terminator, so fromRawPath does not copy the path again.
+      var path = packed.sublist(i, end + 1);
+      switch (type) {
+        case listFile:
+          controller.add(new File.fromRawPath(path));
+          break;
+        case listDirectory:
+          controller.add(new Directory.fromRawPath(path));
+          break;
+        case listLink:
+          controller.add(new Link.fromRawPath(path));
+          break;
+      }
+      i = end + 1;
+    }
+  }
+
   void _cleanup() {
     controller.close();
     closeCompleter.complete();
@@ -97,6 +97,26 @@ class FileLock {
   const FileLock._internal(this._type);
 }
 
+/// How the bytes returned by [RandomAccessFile.mapSync] will be accessed.
+///
+/// The operating system uses the hint to decide how much of the file to read
+/// ahead of the accessed bytes.
+class FileMapAccess {
+  /// No particular access pattern.
+  static const normal = const FileMapAccess._internal(0);
+
+  /// The bytes are accessed in order.
+  static const sequential = const FileMapAccess._internal(1);
+
+  /// The bytes are accessed in no particular order, so reading ahead of them
+  /// does not help.
+  static const random = const FileMapAccess._internal(2);
+
+  final int _type;
+
+  const FileMapAccess._internal(this._type);
+}
+
 /**
  * A reference to a file on the file system.
  *
@@ -943,6 +963,27 @@ abstract class RandomAccessFile {
    */
   void unlockSync([int start = 0, int end = -1]);
 
+  /**
+   * Synchronously maps the bytes from [start] to [end] of the file into
+   * memory and returns them as a [Uint8List].
+   *
+   * If [end] is omitted, the bytes up to the end of the file are mapped.
+   * Instead of being read into the heap up front, the bytes are read from the
+   * file when they are first accessed. The mapping is released when the
+   * returned list is garbage collected, and closing the file does not release
+   * it. [access] hints how the bytes will be accessed.
+   *
+   * Changes made to the list are not written to the file. Whether changes
+   * made to the file show up in the list is platform dependent, and
+   * truncating the file while it is mapped can crash the process when the
+   * bytes past its new end are accessed. On Windows the bytes are read into
+   * memory when they are mapped.
+   *
+   * Throws a [FileSystemException] if the operation fails.
+   */
+  Uint8List mapSync(
+      [int start = 0, int end, FileMapAccess access = FileMapAccess.normal]);
+
   /**
    * Returns a human-readable string for this RandomAccessFile instance.
    */
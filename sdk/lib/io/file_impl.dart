@@ -514,32 +514,13 @@ class _File extends FileSystemEntity implements File {
   }
 
   Future<Uint8List> readAsBytes() {
-    Future<Uint8List> readDataChunked(RandomAccessFile file) {
-      var builder = new BytesBuilder(copy: false);
-      var completer = new Completer<Uint8List>();
-      void read() {
-        file.read(_blockSize).then((data) {
-          if (data.length > 0) {
-            builder.add(data);
-            read();
-          } else {
-            completer.complete(builder.takeBytes());
-          }
-        }, onError: completer.completeError);
+    // Opens, reads and closes the file in a single request.
+    return _dispatchWithNamespace(_IOService.fileReadWhole, [null, _rawPath])
+        .then<Uint8List>((response) {
+      if (_isErrorResponse(response)) {
+        throw _exceptionFromResponse(response, "Cannot open file", path);
       }
-
-      read();
-      return completer.future;
-    }
-
-    return open().then((file) {
-      return file.length().then((length) {
-        if (length == 0) {
-          // May be character device, try to read it in chunks.
-          return readDataChunked(file);
-        }
-        return file.read(length);
-      }).whenComplete(file.close);
+      return response[1];
     });
   }
 
@@ -599,11 +580,35 @@ class _File extends FileSystemEntity implements File {
 
   Future<File> writeAsBytes(List<int> bytes,
       {FileMode mode: FileMode.write, bool flush: false}) {
-    return open(mode: mode).then((file) {
-      return file.writeFrom(bytes, 0, bytes.length).then<File>((_) {
-        if (flush) return file.flush().then((_) => this);
-        return this;
-      }).whenComplete(file.close);
+    if (mode != FileMode.read &&
+        mode != FileMode.write &&
+        mode != FileMode.append &&
+        mode != FileMode.writeOnly &&
+        mode != FileMode.writeOnlyAppend) {
+      return new Future.error(
+          new ArgumentError('Invalid file mode for this operation'));
+    }
+    _BufferAndStart result;
+    try {
+      result = _ensureFastAndSerializableByteData(bytes, 0, bytes.length);
+    } catch (e) {
+      return new Future.error(e);
+    }
+    // Opens, writes, optionally flushes and closes the file in a single
+    // request.
+    return _dispatchWithNamespace(_IOService.fileWriteWhole, [
+      null,
+      _rawPath,
+      mode._mode,
+      result.buffer,
+      result.start,
+      result.start + bytes.length,
+      flush
+    ]).then<File>((response) {
+      if (_isErrorResponse(response)) {
+        throw _exceptionFromResponse(response, "Cannot open file", path);
+      }
+      return this;
     });
   }
 
@@ -661,6 +666,7 @@ abstract class _RandomAccessFileOps {
   length();
   flush();
   lock(int lock, int start, int end);
+  map(int start, int end, int access);
 }
 
 class _RandomAccessFile implements RandomAccessFile {
@@ -1054,6 +1060,22 @@ class _RandomAccessFile implements RandomAccessFile {
     }
   }
 
+  Uint8List mapSync(
+      [int start = 0, int end, FileMapAccess access = FileMapAccess.normal]) {
+    _checkAvailable();
+    if ((start is! int) || (access is! FileMapAccess)) {
+      throw new ArgumentError();
+    }
+    int length = lengthSync();
+    end = RangeError.checkValidRange(start, end, length);
+    if (start == end) return new Uint8List(0);
+    var result = _ops.map(start, end, access._type);
+    if (result is OSError) {
+      throw new FileSystemException('map failed', path, result);
+    }
+    return result;
+  }
+
   bool closed = false;
 
   // WARNING:
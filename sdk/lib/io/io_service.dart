@@ -49,6 +49,8 @@ class _IOService {
   static const int directoryListStop = 40;
   static const int directoryRename = 41;
   static const int sslProcessFilter = 42;
+  static const int fileReadWhole = 43;
+  static const int fileWriteWhole = 44;
 
   external static Future _dispatch(int request, List data);
 }
@@ -459,6 +459,10 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
   bool _connectPending = true;
   bool _filterPending = false;
   bool _filterActive = false;
+  // Whether the kernel encrypts what is sent, so the write plaintext buffer
+  // goes straight to the socket. Tried once, after the handshake.
+  bool _kernelTls = false;
+  bool _kernelTlsTried = false;
 
   _SecureFilter _secureFilter = new _SecureFilter();
   String _selectedProtocol;
@@ -715,6 +719,7 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
     if (written > 0) {
       _filterStatus.writeEmpty = false;
     }
+    if (_kernelTls) _writeSocket();
     _scheduleFilter();
     return written;
   }
@@ -765,6 +770,7 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
 
   void _writeHandler() {
     _writeSocket();
+    if (_kernelTls) _sendWriteEvent();
     _scheduleFilter();
   }
 
@@ -833,6 +839,10 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
       throw new HandshakeException(
           "Called renegotiate on a non-connected socket");
     }
+    if (_kernelTls) {
+      throw new HandshakeException(
+          "Called renegotiate on a socket encrypted by the kernel");
+    }
     _secureFilter.renegotiate(
         useSessionCache, requestClientCertificate, requireClientCertificate);
     _status = handshakeStatus;
@@ -921,6 +931,13 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
         if (_status == closedStatus) {
           return;
         }
+        if (!_kernelTlsTried &&
+            _status == connectedStatus &&
+            _filterStatus.writeEmpty) {
+          // Everything encrypted so far has been written to the socket.
+          _kernelTlsTried = true;
+          _kernelTls = _secureFilter.enableKernelTls(_socket);
+        }
         if (_filterStatus.progress) {
           _filterPending = true;
           if (_filterStatus.writeEncryptedNoLongerEmpty) {
@@ -966,7 +983,18 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
   void _readSocket() {
     if (_status == closedStatus) return;
     var buffer = _secureFilter.buffers[readEncryptedId];
-    if (buffer.writeFromSource(_readSocketOrBufferedData) > 0) {
+    int written;
+    var socket = _socket;
+    if (_bufferedData == null &&
+        !_socketClosedRead &&
+        socket is _ReadIntoRawSocket) {
+      // Read straight into the filter's buffer instead of allocating a list
+      // for every read and copying it over.
+      written = buffer.writeFromReader(socket._readInto);
+    } else {
+      written = buffer.writeFromSource(_readSocketOrBufferedData);
+    }
+    if (written > 0) {
       _filterStatus.readEmpty = false;
     } else {
       _socket.readEventsEnabled = false;
@@ -975,7 +1003,8 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
 
   void _writeSocket() {
     if (_socketClosedWrite) return;
-    var buffer = _secureFilter.buffers[writeEncryptedId];
+    var buffer =
+        _secureFilter.buffers[_kernelTls ? writePlaintextId : writeEncryptedId];
     if (buffer.readToSocket(_socket)) {
       // Returns true if blocked
       _socket.writeEventsEnabled = true;
@@ -1020,17 +1049,28 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
 
   Future<_FilterStatus> _pushAllFilterStages() {
     bool wasInHandshake = _status != connectedStatus;
-    List args = new List(2 + bufferCount * 2);
-    args[0] = _secureFilter._pointer();
-    args[1] = wasInHandshake;
     var bufs = _secureFilter.buffers;
-    for (var i = 0; i < bufferCount; ++i) {
-      args[2 * i + 2] = bufs[i].start;
-      args[2 * i + 3] = bufs[i].end;
+    Future filtered;
+    if (_secureFilter.processesSynchronously) {
+      List<int> positions = new List<int>(bufferCount * 2);
+      for (var i = 0; i < bufferCount; ++i) {
+        positions[2 * i] = bufs[i].start;
+        positions[2 * i + 1] = bufs[i].end;
+      }
+      filtered = new Future.value(
+          _secureFilter.processBuffers(wasInHandshake, positions));
+    } else {
+      List args = new List(2 + bufferCount * 2);
+      args[0] = _secureFilter._pointer();
+      args[1] = wasInHandshake;
+      for (var i = 0; i < bufferCount; ++i) {
+        args[2 * i + 2] = bufs[i].start;
+        args[2 * i + 3] = bufs[i].end;
+      }
+      filtered = _IOService._dispatch(_IOService.sslProcessFilter, args);
     }
 
-    return _IOService._dispatch(_IOService.sslProcessFilter, args)
-        .then((response) {
+    return filtered.then((response) {
       if (response.length == 2) {
         if (wasInHandshake) {
           // If we're in handshake, throw a handshake error.
@@ -1193,6 +1233,22 @@ class _ExternalBuffer {
     return written;
   }
 
+  // Like writeFromSource, but lets [readInto] fill [data] directly.
+  // [readInto] returns the number of bytes it stored, 0 when it is empty.
+  int writeFromReader(int readInto(List<int> data, int start, int end)) {
+    int written = 0;
+    int toWrite = linearFree;
+    // Loop over zero, one, or two linear data ranges.
+    while (toWrite > 0) {
+      var len = readInto(data, end, end + toWrite);
+      if (len == 0) break;
+      advanceEnd(len);
+      written += len;
+      toWrite = linearFree;
+    }
+    return written;
+  }
+
   int writeFromSource(List<int> getData(int requested)) {
     int written = 0;
     int toWrite = linearFree;
@@ -1244,9 +1300,22 @@ abstract class _SecureFilter {
   void init();
   X509Certificate get peerCertificate;
   int processBuffer(int bufferIndex);
+
+  // Whether processBuffers should be used instead of dispatching the buffers
+  // to the IO service.
+  bool get processesSynchronously;
+
+  // Processes all buffers on the current thread. Takes and returns the start
+  // and end of each buffer, or returns an error code and message.
+  List processBuffers(bool inHandshake, List<int> positions);
   void registerBadCertificateCallback(Function callback);
   void registerHandshakeCompleteCallback(Function handshakeCompleteHandler);
 
+  // Lets the kernel encrypt what is written to 'socket' from now on, so
+  // that the write plaintext buffer is written to it directly. Returns false
+  // if that is disabled or not supported for this connection.
+  bool enableKernelTls(RawSocket socket);
+
   // This call may cause a reference counted pointer in the native
   // implementation to be retained. It should only be called when the resulting
   // value is passed to the IO service through a call to dispatch().
@@ -11,6 +11,7 @@ part of dart.io;
 class InternetAddressType {
   static const InternetAddressType IPv4 = const InternetAddressType._(0);
   static const InternetAddressType IPv6 = const InternetAddressType._(1);
+  static const InternetAddressType unix = const InternetAddressType._(2);
   static const InternetAddressType any = const InternetAddressType._(-1);
 
   @Deprecated("Use IPv4 instead")
@@ -27,11 +28,12 @@ class InternetAddressType {
   factory InternetAddressType._from(int value) {
     if (value == 0) return IPv4;
     if (value == 1) return IPv6;
+    if (value == 2) return unix;
     throw new ArgumentError("Invalid type: $value");
   }
 
   /**
-   * Get the name of the type, e.g. "IPv4" or "IPv6".
+   * Get the name of the type, e.g. "IPv4", "IPv6" or "Unix".
    */
   String get name {
     switch (_value) {
@@ -41,6 +43,8 @@ class InternetAddressType {
         return "IPv4";
       case 1:
         return "IPv6";
+      case 2:
+        return "Unix";
       default:
         throw new ArgumentError("Invalid InternetAddress");
     }
@@ -112,7 +116,8 @@ abstract class InternetAddress {
 
   /**
    * Get the raw address of this [InternetAddress]. The result is either a
-   * 4 or 16 byte long list. The returned list is a copy, making it possible
+   * 4 or 16 byte long list, or the UTF-8 encoded path of a Unix domain
+   * address. The returned list is a copy, making it possible
    * to change the list without modifying the [InternetAddress].
    */
   Uint8List get rawAddress;
@@ -133,13 +138,20 @@ abstract class InternetAddress {
   bool get isMulticast;
 
   /**
-   * Creates a new [InternetAddress] from a numeric address.
+   * Creates a new [InternetAddress] from a numeric address or a file path.
    *
-   * If the address in [address] is not a numeric IPv4
-   * (dotted-decimal notation) or IPv6 (hexadecimal representation).
-   * address [ArgumentError] is thrown.
+   * If [type] is [InternetAddressType.unix], [address] is the path of a
+   * Unix domain socket, and the address has no port. On Linux and Android a
+   * path starting with '@' names a socket in the abstract namespace, which
+   * has no file. Binding a path creates its file, which is not removed when
+   * the socket is closed. Unix domain sockets are not supported on Windows.
+   *
+   * Otherwise, if the address in [address] is not a numeric IPv4
+   * (dotted-decimal notation) or IPv6 (hexadecimal representation)
+   * address, or not of the given [type], [ArgumentError] is thrown.
    */
-  external factory InternetAddress(String address);
+  external factory InternetAddress(String address,
+      {InternetAddressType type});
 
   /**
    * Perform a reverse dns lookup on the [address], creating a new
@@ -704,6 +716,14 @@ abstract class RawSocket implements Stream<RawSocketEvent> {
   void setRawOption(RawSocketOption option);
 }
 
+// Implemented by the [RawSocket] of the native implementation. Lets the rest
+// of dart:io read into an existing buffer instead of receiving a new list.
+abstract class _ReadIntoRawSocket implements RawSocket {
+  // Reads at most `end - start` bytes into [buffer] starting at [start] and
+  // returns how many were read, 0 if no data was available.
+  int _readInto(List<int> buffer, int start, int end);
+}
+
 /**
  * A high-level class for communicating over a TCP socket.
  *
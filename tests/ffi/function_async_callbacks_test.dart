@@ -0,0 +1,64 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Dart test program for testing dart:ffi async callbacks posted by native
+// threads.
+//
+// SharedObjects=ffi_test_functions
+
+library FfiTest;
+
+import 'dart:async';
+import 'dart:ffi';
+
+import 'dylib_utils.dart';
+
+import "package:expect/expect.dart";
+
+typedef NativePostAsyncCallbacks = Int32 Function(Pointer<Void>, Int64, Int64);
+typedef PostAsyncCallbacks = int Function(Pointer<Void>, int, int);
+
+final DynamicLibrary testLibrary = dlopenPlatformSpecific("ffi_test_functions");
+
+const int kNumThreads = 4;
+const int kCount = 1000;
+
+// Matches AsyncCallbackRecord in ffi_test_functions.cc.
+const int kRecordSize = 16;
+
+void main() async {
+  final PostAsyncCallbacks post =
+      testLibrary.lookupFunction<NativePostAsyncCallbacks, PostAsyncCallbacks>(
+          "TestPostAsyncCallbacks");
+
+  final List<int> next = new List<int>.filled(kNumThreads, 0);
+  int received = 0;
+  int batches = 0;
+  final Completer done = new Completer();
+  final AsyncCallbackQueue queue =
+      new AsyncCallbackQueue(kRecordSize, (Pointer<Uint8> records, int count) {
+    batches++;
+    final Pointer<Int64> fields = records.cast<Pointer<Int64>>();
+    for (int i = 0; i < count; i++) {
+      final int thread = fields.elementAt(2 * i).load<int>();
+      final int index = fields.elementAt(2 * i + 1).load<int>();
+      // The records of each thread arrive in the order they were posted.
+      Expect.equals(next[thread], index);
+      next[thread]++;
+    }
+    received += count;
+    if (received == kNumThreads * kCount) {
+      done.complete();
+    }
+  });
+
+  Expect.equals(0, post(queue.handle, kNumThreads, kCount));
+  await done.future;
+  queue.close();
+
+  Expect.listEquals(new List<int>.filled(kNumThreads, kCount), next);
+  // The records were posted while the isolate was blocked in the call, so
+  // they are delivered in far fewer batches than there are records.
+  Expect.isTrue(batches < received);
+}
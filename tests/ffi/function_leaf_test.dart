@@ -0,0 +1,106 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Dart test program for testing dart:ffi leaf calls.
+//
+// VMOptions=
+// VMOptions=--deterministic --optimization-counter-threshold=10
+// SharedObjects=ffi_test_functions
+
+library FfiTest;
+
+import 'dart:ffi' as ffi;
+
+import 'dylib_utils.dart';
+
+import "package:expect/expect.dart";
+
+void main() {
+  for (int i = 0; i < 100; ++i) {
+    testLeafIntegers();
+    testLeafDoubles();
+    testLeafFloats();
+    testLeafManyArguments();
+    testLeafPointer();
+    testLeafFromPointer();
+  }
+}
+
+ffi.DynamicLibrary ffiTestFunctions =
+    dlopenPlatformSpecific("ffi_test_functions");
+
+typedef NativeBinaryOp = ffi.Int32 Function(ffi.Int32, ffi.Int32);
+typedef BinaryOp = int Function(int, int);
+
+void testLeafIntegers() {
+  BinaryOp sumPlus42 = ffiTestFunctions
+      .lookupFunction<NativeBinaryOp, BinaryOp>("SumPlus42", isLeaf: true);
+  Expect.equals(49, sumPlus42(3, 4));
+  Expect.equals(42, sumPlus42(0x7fffffff, -0x7fffffff));
+}
+
+typedef NativeDoubleUnaryOp = ffi.Double Function(ffi.Double);
+typedef NativeFloatUnaryOp = ffi.Float Function(ffi.Float);
+typedef DoubleUnaryOp = double Function(double);
+
+void testLeafDoubles() {
+  DoubleUnaryOp times1_337Double = ffiTestFunctions
+      .lookupFunction<NativeDoubleUnaryOp, DoubleUnaryOp>("Times1_337Double",
+          isLeaf: true);
+  Expect.approxEquals(2.0 * 1.337, times1_337Double(2.0));
+}
+
+void testLeafFloats() {
+  DoubleUnaryOp times1_337Float = ffiTestFunctions
+      .lookupFunction<NativeFloatUnaryOp, DoubleUnaryOp>("Times1_337Float",
+          isLeaf: true);
+  Expect.approxEquals(1337.0, times1_337Float(1000.0));
+}
+
+typedef NativeDecenaryOp = ffi.IntPtr Function(
+    ffi.IntPtr,
+    ffi.IntPtr,
+    ffi.IntPtr,
+    ffi.IntPtr,
+    ffi.IntPtr,
+    ffi.IntPtr,
+    ffi.IntPtr,
+    ffi.IntPtr,
+    ffi.IntPtr,
+    ffi.IntPtr);
+typedef DecenaryOp = int Function(
+    int, int, int, int, int, int, int, int, int, int);
+
+void testLeafManyArguments() {
+  // Some of the arguments are passed on the stack.
+  DecenaryOp sumManyInts = ffiTestFunctions
+      .lookupFunction<NativeDecenaryOp, DecenaryOp>("SumManyInts",
+          isLeaf: true);
+  Expect.equals(55, sumManyInts(1, 2, 3, 4, 5, 6, 7, 8, 9, 10));
+}
+
+typedef Int64PointerUnOp = ffi.Pointer<ffi.Int64> Function(
+    ffi.Pointer<ffi.Int64>);
+
+void testLeafPointer() {
+  Int64PointerUnOp assign1337Index1 = ffiTestFunctions
+      .lookupFunction<Int64PointerUnOp, Int64PointerUnOp>("Assign1337Index1",
+          isLeaf: true);
+  ffi.Pointer<ffi.Int64> p = ffi.allocate(count: 2);
+  p.store(42);
+  p.elementAt(1).store(1000);
+  ffi.Pointer<ffi.Int64> result = assign1337Index1(p);
+  Expect.equals(1337, result.load<int>());
+  Expect.equals(1337, p.elementAt(1).load<int>());
+  Expect.equals(p.elementAt(1).address, result.address);
+  p.free();
+}
+
+void testLeafFromPointer() {
+  ffi.Pointer<ffi.NativeFunction<NativeBinaryOp>> p =
+      ffiTestFunctions.lookup("SumPlus42");
+  BinaryOp leaf = p.asFunction(isLeaf: true);
+  BinaryOp nonLeaf = p.asFunction();
+  Expect.equals(nonLeaf(10, 20), leaf(10, 20));
+}
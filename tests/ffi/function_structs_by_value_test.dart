@@ -0,0 +1,202 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Dart test program for testing dart:ffi function pointers with struct
+// arguments and results passed by value.
+//
+// VMOptions=
+// VMOptions=--deterministic --optimization-counter-threshold=10
+// SharedObjects=ffi_test_functions
+
+library FfiTest;
+
+import 'dart:ffi' as ffi;
+
+import 'dylib_utils.dart';
+
+import "package:expect/expect.dart";
+
+import 'coordinate.dart';
+
+@ffi.struct
+class Vector2 extends ffi.Pointer<ffi.Void> {
+  @ffi.Double()
+  double x;
+
+  @ffi.Double()
+  double y;
+
+  external static int sizeOf();
+
+  static Vector2 allocate() =>
+      ffi.allocate<ffi.Uint8>(count: sizeOf()).cast();
+
+  factory Vector2(double x, double y) => Vector2.allocate()
+    ..x = x
+    ..y = y;
+}
+
+@ffi.struct
+class IntAndFloat extends ffi.Pointer<ffi.Void> {
+  @ffi.Int32()
+  int a;
+
+  @ffi.Float()
+  double b;
+
+  external static int sizeOf();
+
+  static IntAndFloat allocate() =>
+      ffi.allocate<ffi.Uint8>(count: sizeOf()).cast();
+}
+
+@ffi.struct
+class ThreeBytes extends ffi.Pointer<ffi.Void> {
+  @ffi.Int8()
+  int a;
+
+  @ffi.Int8()
+  int b;
+
+  @ffi.Int8()
+  int c;
+
+  external static int sizeOf();
+
+  static ThreeBytes allocate() =>
+      ffi.allocate<ffi.Uint8>(count: sizeOf()).cast();
+}
+
+void main() {
+  for (int i = 0; i < 100; ++i) {
+    testStructInFpuRegisters();
+    testStructResultInFpuRegisters();
+    testStructInCpuRegisters();
+    testStructWithOddSize();
+    testStructInMemory();
+    testManyStructs();
+    testNullStruct();
+  }
+}
+
+ffi.DynamicLibrary ffiTestFunctions =
+    dlopenPlatformSpecific("ffi_test_functions");
+
+typedef NativeVector2Sum = ffi.Double Function(ffi.ByValue<Vector2>);
+typedef Vector2Sum = double Function(Vector2);
+
+void testStructInFpuRegisters() {
+  Vector2Sum sum =
+      ffiTestFunctions.lookupFunction<NativeVector2Sum, Vector2Sum>(
+          "SumVector2");
+  Vector2 v = Vector2(1.5, 2.0);
+  Expect.approxEquals(3.5, sum(v));
+  v.free();
+}
+
+typedef NativeVector2Scale = ffi.ByValue<Vector2> Function(
+    ffi.ByValue<Vector2>, ffi.Double);
+typedef Vector2Scale = Vector2 Function(Vector2, double);
+
+void testStructResultInFpuRegisters() {
+  Vector2Scale scale =
+      ffiTestFunctions.lookupFunction<NativeVector2Scale, Vector2Scale>(
+          "ScaleVector2");
+  Vector2 v = Vector2(1.5, 2.0);
+  Vector2 result = scale(v, 2.0);
+  Expect.notEquals(v.address, result.address);
+  Expect.approxEquals(3.0, result.x);
+  Expect.approxEquals(4.0, result.y);
+  Expect.approxEquals(1.5, v.x);
+  v.free();
+  result.free();
+}
+
+typedef NativeIntAndFloatOp = ffi.ByValue<IntAndFloat> Function(
+    ffi.ByValue<IntAndFloat>);
+typedef IntAndFloatOp = IntAndFloat Function(IntAndFloat);
+
+void testStructInCpuRegisters() {
+  IntAndFloatOp increment =
+      ffiTestFunctions.lookupFunction<NativeIntAndFloatOp, IntAndFloatOp>(
+          "IncrementIntAndFloat");
+  IntAndFloat s = IntAndFloat.allocate()
+    ..a = -2
+    ..b = 0.5;
+  IntAndFloat result = increment(s);
+  Expect.equals(-1, result.a);
+  Expect.approxEquals(1.5, result.b);
+  s.free();
+  result.free();
+}
+
+typedef NativeThreeBytesOp = ffi.ByValue<ThreeBytes> Function(
+    ffi.ByValue<ThreeBytes>);
+typedef ThreeBytesOp = ThreeBytes Function(ThreeBytes);
+
+void testStructWithOddSize() {
+  ThreeBytesOp reverse =
+      ffiTestFunctions.lookupFunction<NativeThreeBytesOp, ThreeBytesOp>(
+          "ReverseThreeBytes");
+  ThreeBytes s = ThreeBytes.allocate()
+    ..a = 1
+    ..b = -2
+    ..c = 3;
+  ThreeBytes result = reverse(s);
+  Expect.equals(3, result.a);
+  Expect.equals(-2, result.b);
+  Expect.equals(1, result.c);
+  s.free();
+  result.free();
+}
+
+typedef NativeCoordinateOp = ffi.ByValue<Coordinate> Function(
+    ffi.ByValue<Coordinate>);
+typedef CoordinateOp = Coordinate Function(Coordinate);
+
+void testStructInMemory() {
+  CoordinateOp transpose =
+      ffiTestFunctions.lookupFunction<NativeCoordinateOp, CoordinateOp>(
+          "TransposeCoordinateByValue");
+  Coordinate c1 = Coordinate(10.0, 20.0, null);
+  Coordinate c2 = Coordinate(42.0, 84.0, c1);
+  Coordinate result = transpose(c2);
+  Expect.approxEquals(52.0, result.x);
+  Expect.approxEquals(94.0, result.y);
+  Expect.equals(c1.address, result.next.address);
+  // The argument is passed as a copy.
+  Expect.approxEquals(42.0, c2.x);
+  c1.free();
+  c2.free();
+  result.free();
+}
+
+typedef NativeManyVector2Sum = ffi.Double Function(
+    ffi.ByValue<Vector2>,
+    ffi.ByValue<Vector2>,
+    ffi.ByValue<Vector2>,
+    ffi.ByValue<Vector2>,
+    ffi.ByValue<Vector2>,
+    ffi.ByValue<Vector2>);
+typedef ManyVector2Sum = double Function(
+    Vector2, Vector2, Vector2, Vector2, Vector2, Vector2);
+
+void testManyStructs() {
+  // Some of the structs are passed on the stack.
+  ManyVector2Sum sum =
+      ffiTestFunctions.lookupFunction<NativeManyVector2Sum, ManyVector2Sum>(
+          "SumManyVector2");
+  Vector2 v = Vector2(1.0, 2.0);
+  Vector2 w = Vector2(3.0, 4.0);
+  Expect.approxEquals(30.0, sum(v, w, v, w, v, w));
+  v.free();
+  w.free();
+}
+
+void testNullStruct() {
+  Vector2Sum sum =
+      ffiTestFunctions.lookupFunction<NativeVector2Sum, Vector2Sum>(
+          "SumVector2");
+  Expect.throws(() => sum(null));
+}
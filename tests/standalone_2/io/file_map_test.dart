@@ -0,0 +1,76 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Dart test program for mapping files into memory.
+
+import 'dart:io';
+import 'dart:typed_data';
+
+import "package:expect/expect.dart";
+
+// Larger than the alignment of mappings, so that ranges start inside them.
+const int LENGTH = 200000;
+
+void expectBytes(Uint8List bytes, int start, int end) {
+  Expect.equals(end - start, bytes.length);
+  for (int i = 0; i < bytes.length; i++) {
+    Expect.equals((start + i) & 0xff, bytes[i]);
+  }
+}
+
+void testMap(File file) {
+  RandomAccessFile raf = file.openSync();
+  expectBytes(raf.mapSync(), 0, LENGTH);
+  expectBytes(raf.mapSync(70001), 70001, LENGTH);
+  expectBytes(raf.mapSync(65535, 131073), 65535, 131073);
+  expectBytes(raf.mapSync(1, 2, FileMapAccess.random), 1, 2);
+  expectBytes(raf.mapSync(0, LENGTH, FileMapAccess.sequential), 0, LENGTH);
+  Expect.equals(0, raf.mapSync(LENGTH).length);
+  // Mapping does not move the file position.
+  Expect.equals(0, raf.positionSync());
+  raf.closeSync();
+}
+
+void testMapOutlivesFile(File file) {
+  RandomAccessFile raf = file.openSync();
+  Uint8List bytes = raf.mapSync(100, 200);
+  raf.closeSync();
+  expectBytes(bytes, 100, 200);
+}
+
+void testWritesAreNotWrittenToFile(File file) {
+  RandomAccessFile raf = file.openSync();
+  Uint8List bytes = raf.mapSync();
+  bytes[0] = 42;
+  Expect.equals(42, bytes[0]);
+  Expect.equals(0, raf.readByteSync());
+  raf.closeSync();
+  expectBytes(file.readAsBytesSync(), 0, LENGTH);
+}
+
+void testInvalidArguments(File file) {
+  RandomAccessFile raf = file.openSync();
+  Expect.throwsRangeError(() => raf.mapSync(-1));
+  Expect.throwsRangeError(() => raf.mapSync(10, 5));
+  Expect.throwsRangeError(() => raf.mapSync(0, LENGTH + 1));
+  Expect.throwsArgumentError(() => raf.mapSync(0, 1, null));
+  raf.closeSync();
+  Expect.throws(() => raf.mapSync(), (e) => e is FileSystemException);
+}
+
+main() {
+  Directory temp = Directory.systemTemp.createTempSync('dart_file_map');
+  File file = new File("${temp.path}/test");
+  Uint8List content = new Uint8List(LENGTH);
+  for (int i = 0; i < LENGTH; i++) content[i] = i & 0xff;
+  file.writeAsBytesSync(content);
+  try {
+    testMap(file);
+    testMapOutlivesFile(file);
+    testWritesAreNotWrittenToFile(file);
+    testInvalidArguments(file);
+  } finally {
+    temp.deleteSync(recursive: true);
+  }
+}
@@ -221,10 +221,6 @@ void testMultipleEvents() {
 
 void testWatchRecursive() {
   var dir = Directory.systemTemp.createTempSync('dart_file_system_watcher');
-  if (Platform.isLinux) {
-    Expect.throws(() => dir.watch(recursive: true));
-    return;
-  }
   var dir2 = new Directory(join(dir.path, 'dir'));
   dir2.createSync();
   var file = new File(join(dir.path, 'dir/file'));
@@ -247,6 +243,36 @@ void testWatchRecursive() {
   file.createSync();
 }
 
+void testWatchRecursiveNewDirectory() {
+  // The inotify watcher adds watches for new directories itself.
+  if (!Platform.isLinux) return;
+  var dir = Directory.systemTemp.createTempSync('dart_file_system_watcher');
+  var dir2 = new Directory(join(dir.path, 'dir'));
+  var dir3 = new Directory(join(dir.path, 'dir', 'sub'));
+  var file = new File(join(dir.path, 'dir', 'sub', 'file'));
+
+  var watcher = dir.watch(recursive: true);
+
+  asyncStart();
+  var sub;
+  sub = watcher.listen((event) {
+    if (event is FileSystemCreateEvent && event.path == dir2.path) {
+      dir3.createSync();
+    } else if (event is FileSystemCreateEvent && event.path == dir3.path) {
+      file.createSync();
+    } else if (event.path == file.path) {
+      sub.cancel();
+      asyncEnd();
+      dir.deleteSync(recursive: true);
+    }
+  }, onError: (e) {
+    dir.deleteSync(recursive: true);
+    throw e;
+  });
+
+  dir2.createSync();
+}
+
 void testWatchNonRecursive() {
   var dir = Directory.systemTemp.createTempSync('dart_file_system_watcher');
   var dir2 = new Directory(join(dir.path, 'dir'));
@@ -323,6 +349,7 @@ void main() {
   testWatchDeleteDir();
   testWatchOnlyModifyFile();
   testMultipleEvents();
+  testWatchRecursiveNewDirectory();
   testWatchNonRecursive();
   testWatchNonExisting();
   testWatchMoveSelf();
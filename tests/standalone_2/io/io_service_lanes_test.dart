@@ -0,0 +1,57 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// VMOptions=--io_service_file_ports=1 --io_service_lookup_ports=1
+
+// Verify that IO service requests of one lane do not wait behind a blocked
+// request of another lane. With one port per lane, the only file port is
+// stuck opening a FIFO without a writer, and host lookups still complete.
+
+import 'dart:async';
+import 'dart:io';
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+Future<void> testLookupsNotStarvedByBlockedFileRequest() async {
+  final Directory temp =
+      await Directory.systemTemp.createTemp('io_service_lanes');
+  final String fifo = '${temp.path}/fifo';
+  final ProcessResult made = await Process.run('mkfifo', [fifo]);
+  Expect.equals(0, made.exitCode);
+
+  // Opening a FIFO for reading blocks until it is opened for writing.
+  bool opened = false;
+  final Future<RandomAccessFile> blocked = new File(fifo).open().then((file) {
+    opened = true;
+    return file;
+  });
+  // Other file system requests queue behind it on the same port.
+  bool exists;
+  final Future<void> queued = temp.exists().then((result) => exists = result);
+
+  final addresses = await InternetAddress.lookup('localhost')
+      .timeout(const Duration(seconds: 30));
+  Expect.isTrue(addresses.isNotEmpty);
+  await NetworkInterface.list().timeout(const Duration(seconds: 30));
+  Expect.isFalse(opened);
+  Expect.isNull(exists);
+
+  // Processes are not started through the IO service.
+  final ProcessResult written =
+      await Process.run('sh', ['-c', 'echo > "\$0"', fifo]);
+  Expect.equals(0, written.exitCode);
+  final RandomAccessFile file = await blocked;
+  await queued;
+  Expect.isTrue(exists);
+  await file.close();
+  await temp.delete(recursive: true);
+}
+
+main() async {
+  if (Platform.isWindows) return;
+  asyncStart();
+  await testLookupsNotStarvedByBlockedFileRequest();
+  asyncEnd();
+}
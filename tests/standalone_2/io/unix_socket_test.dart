@@ -0,0 +1,85 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:async';
+import 'dart:io';
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+Future testEcho(InternetAddress address) async {
+  final server = await ServerSocket.bind(address, 0);
+  Expect.equals(0, server.port);
+  Expect.equals(InternetAddressType.unix, server.address.type);
+  server.listen((socket) {
+    socket.listen(socket.add, onDone: () => socket.close());
+  });
+  final client = await Socket.connect(address, 0);
+  Expect.equals(0, client.port);
+  Expect.equals(InternetAddressType.unix, client.remoteAddress.type);
+  Expect.equals(address.address, client.remoteAddress.address);
+  Expect.isTrue(client.setOption(SocketOption.tcpNoDelay, true));
+  final received = <int>[];
+  client.add([1, 2, 3]);
+  await client.close();
+  await client.listen(received.addAll).asFuture();
+  Expect.listEquals([1, 2, 3], received);
+  await server.close();
+}
+
+Future testDatagram(Directory dir) async {
+  final serverAddress = new InternetAddress('${dir.path}/datagram',
+      type: InternetAddressType.unix);
+  final clientAddress = new InternetAddress('${dir.path}/datagram_client',
+      type: InternetAddressType.unix);
+  final server = await RawDatagramSocket.bind(serverAddress, 0);
+  final client = await RawDatagramSocket.bind(clientAddress, 0);
+  final completer = new Completer<Datagram>();
+  server.listen((event) {
+    if (event != RawSocketEvent.read) return;
+    final datagram = server.receive();
+    if (datagram != null) completer.complete(datagram);
+  });
+  Expect.equals(3, client.send([4, 5, 6], serverAddress, 0));
+  final datagram = await completer.future;
+  Expect.listEquals([4, 5, 6], datagram.data);
+  Expect.equals(clientAddress, datagram.address);
+  Expect.equals(0, datagram.port);
+  server.close();
+  client.close();
+}
+
+void testAddress() {
+  final address =
+      new InternetAddress('/tmp/socket', type: InternetAddressType.unix);
+  Expect.equals('/tmp/socket', address.host);
+  Expect.listEquals('/tmp/socket'.codeUnits, address.rawAddress);
+  Expect.isFalse(address.isLoopback);
+  Expect.equals(address,
+      new InternetAddress('/tmp/socket', type: InternetAddressType.unix));
+  Expect.notEquals(address, InternetAddress.loopbackIPv4);
+  Expect.throwsArgumentError(
+      () => new InternetAddress('', type: InternetAddressType.unix));
+  Expect.throwsArgumentError(
+      () => new InternetAddress('::1', type: InternetAddressType.IPv4));
+}
+
+main() async {
+  if (Platform.isWindows) return;
+  asyncStart();
+  testAddress();
+  final dir = await Directory.systemTemp.createTemp('unix_socket_test');
+  try {
+    await testEcho(new InternetAddress('${dir.path}/stream',
+        type: InternetAddressType.unix));
+    if (Platform.isLinux || Platform.isAndroid) {
+      await testEcho(new InternetAddress('@unix_socket_test_$pid',
+          type: InternetAddressType.unix));
+    }
+    await testDatagram(dir);
+  } finally {
+    await dir.delete(recursive: true);
+  }
+  asyncEnd();
+}
@@ -244,6 +244,44 @@ void testZlibWithDictionary() {
   });
 }
 
+// Runs [filter] over [input] with processInto, using a small output buffer
+// so that every call fills it.
+List<int> filterInto(RawZLibFilter filter, Uint8List input) {
+  var result = <int>[];
+  var output = new Uint8List(7);
+  var start = 0;
+  while (true) {
+    var written = filter.processInto(input, start, input.length, output, 0,
+        output.length,
+        end: true);
+    start += filter.consumed;
+    result.addAll(output.sublist(0, written));
+    if (start == input.length && written < output.length) break;
+  }
+  return result;
+}
+
+void testZlibProcessInto() {
+  var data = new Uint8List.fromList(
+      new List<int>.generate(1000, (i) => "abcdefgh".codeUnitAt(i % 8)));
+  var dict = [97, 98, 99, 100];
+  var deflater = new RawZLibFilter.deflateFilter(dictionary: dict);
+  var inflater = new RawZLibFilter.inflateFilter(dictionary: dict);
+  for (var level in [1, 9, 6]) {
+    deflater.reset(level: level, strategy: ZLibOption.strategyDefault);
+    var encoded = filterInto(deflater, data);
+    Expect.listEquals(
+        data, new ZLibDecoder(dictionary: dict).convert(encoded));
+    inflater.reset();
+    Expect.listEquals(
+        data, filterInto(inflater, new Uint8List.fromList(encoded)));
+  }
+  Expect.throwsRangeError(() => deflater.processInto(
+      data, 0, data.length + 1, new Uint8List(10), 0, 10));
+  Expect.throwsRangeError(() => deflater.reset(level: 10));
+  Expect.throws(() => inflater.reset(level: 1));
+}
+
 var generateListTypes = [
   (list) => list,
   (list) => new Uint8List.fromList(list),
@@ -286,5 +324,6 @@ void main() {
   testZlibInflateThrowsWithSmallerWindow();
   testZlibInflateWithLargerWindow();
   testZlibWithDictionary();
+  testZlibProcessInto();
   asyncEnd();
 }